@@ -21,8 +21,13 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <cerrno>
+#include <cstdio>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <sstream>
+#include <thread>
 
 #include "paddle/cinn/backends/cuda_util.h"
 #include "paddle/cinn/backends/nvrtc/header_generator.h"
@@ -33,11 +38,109 @@
 PD_DECLARE_string(cinn_nvcc_cmd_path);
 PD_DECLARE_bool(nvrtc_compile_to_cubin);
 PD_DECLARE_bool(cinn_nvrtc_cubin_with_fmad);
+PD_DECLARE_string(cinn_kernel_cache_dir);
 
 namespace cinn {
 namespace backends {
 namespace nvrtc {
 
+namespace {
+
+constexpr char kKernelCacheMagic[] = "cinn_nvrtc_kernel_cache_v1";
+
+// The source code, the options and the versions of nvrtc and the jit safe
+// headers decide the compiled code.
+std::string KernelCacheKey(const std::string& code,
+                           const std::vector<std::string>& compile_options) {
+  int nvrtc_major = 0, nvrtc_minor = 0;
+  NVRTC_CALL(nvrtcVersion(&nvrtc_major, &nvrtc_minor));
+  const auto& header_gen = JitSafeHeaderGenerator::GetInstance();
+  size_t headers_hash = 0;
+  for (size_t i = 0; i < header_gen.size(); ++i) {
+    headers_hash ^= std::hash<std::string>()(header_gen.headers()[i]) +
+                    0x9e3779b9 + (headers_hash << 6) + (headers_hash >> 2);
+  }
+  std::stringstream ss;
+  ss << "nvrtc " << nvrtc_major << "." << nvrtc_minor << ", headers "
+     << headers_hash << ", options " << utils::Join(compile_options, " ")
+     << "\n"
+     << code;
+  return ss.str();
+}
+
+std::string KernelCachePath(const std::string& key, bool compile_to_cubin) {
+  std::stringstream ss;
+  ss << FLAGS_cinn_kernel_cache_dir << "/" << std::hex
+     << std::hash<std::string>()(key) << (compile_to_cubin ? ".cubin" : ".ptx");
+  return ss.str();
+}
+
+// The file holds the whole key, so a key sharing the hash of another one
+// misses instead of loading the code of the other.
+std::string LoadKernelCache(const std::string& path, const std::string& key) {
+  std::ifstream ifs(path, std::ios::in | std::ios::binary);
+  if (!ifs.is_open()) {
+    return "";
+  }
+  std::string magic;
+  size_t key_size = 0, data_size = 0;
+  if (!std::getline(ifs, magic) || magic != kKernelCacheMagic ||
+      !(ifs >> key_size >> data_size) || ifs.get() != '\n') {
+    LOG(WARNING) << "Ignore the broken kernel cache file " << path;
+    return "";
+  }
+  std::string file_key(key_size, '\0');
+  if (!ifs.read(&file_key[0], key_size) || file_key != key) {
+    return "";
+  }
+  std::string data(data_size, '\0');
+  if (!ifs.read(&data[0], data_size)) {
+    LOG(WARNING) << "Ignore the broken kernel cache file " << path;
+    return "";
+  }
+  return data;
+}
+
+// The file is written to a temporary file first and renamed, so the
+// processes sharing the directory never read a partial file.
+void SaveKernelCache(const std::string& path,
+                     const std::string& key,
+                     const std::string& data) {
+  if (mkdir(FLAGS_cinn_kernel_cache_dir.c_str(),
+            S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH) != 0 &&
+      errno != EEXIST) {
+    LOG(WARNING) << "Failed to make the kernel cache directory "
+                 << FLAGS_cinn_kernel_cache_dir;
+    return;
+  }
+  char host_name[256] = {0};
+  gethostname(host_name, sizeof(host_name) - 1);
+  std::stringstream tmp_path;
+  tmp_path << path << ".tmp." << host_name << "." << getpid() << "."
+           << std::hash<std::thread::id>()(std::this_thread::get_id());
+  {
+    std::ofstream ofs(tmp_path.str(),
+                      std::ios::out | std::ios::binary | std::ios::trunc);
+    ofs << kKernelCacheMagic << "\n" << key.size() << " " << data.size()
+        << "\n";
+    ofs.write(key.data(), key.size());
+    ofs.write(data.data(), data.size());
+    if (!ofs.good()) {
+      LOG(WARNING) << "Failed to write the kernel cache file "
+                   << tmp_path.str();
+      ofs.close();
+      std::remove(tmp_path.str().c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Failed to write the kernel cache file " << path;
+    std::remove(tmp_path.str().c_str());
+  }
+}
+
+}  // namespace
+
 std::string Compiler::operator()(const std::string& code,
                                  bool include_headers) {
   if (runtime::CanUseNvccCompiler()) {
@@ -134,6 +237,17 @@ std::string Compiler::CompileCudaSource(const std::string& code,
     param_cstrings.push_back(option.c_str());
   }
   VLOG(3) << "compile options: " << utils::Join(compile_options, " ");
+  std::string cache_key;
+  std::string cache_path;
+  if (!FLAGS_cinn_kernel_cache_dir.empty()) {
+    cache_key = KernelCacheKey(code, compile_options);
+    cache_path = KernelCachePath(cache_key, compile_to_cubin_);
+    std::string data = LoadKernelCache(cache_path, cache_key);
+    if (!data.empty()) {
+      VLOG(3) << "Load the compiled code from " << cache_path;
+      return data;
+    }
+  }
   NVRTC_CALL(nvrtcCreateProgram(&prog,
                                 code.c_str(),
                                 nullptr,
@@ -165,6 +279,9 @@ std::string Compiler::CompileCudaSource(const std::string& code,
   }
 
   NVRTC_CALL(nvrtcDestroyProgram(&prog));
+  if (!cache_path.empty()) {
+    SaveKernelCache(cache_path, cache_key, data);
+  }
   return data;
 }
 
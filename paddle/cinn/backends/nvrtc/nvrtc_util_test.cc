@@ -14,7 +14,13 @@
 
 #include "paddle/cinn/backends/nvrtc/nvrtc_util.h"
 
+#include <dirent.h>
 #include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include "paddle/cinn/runtime/flags.h"
+
+PD_DECLARE_string(cinn_kernel_cache_dir);
 
 namespace cinn {
 namespace backends {
@@ -85,6 +91,41 @@ void cast_fp32_to_bf16_cuda_kernel(const float* input, const int num, bfloat16*
   LOG(INFO) << "ptx:\n" << ptx;
 }
 
+TEST(Compiler, kernel_cache) {
+  char cache_dir[] = "/tmp/cinn_kernel_cache_XXXXXX";
+  ASSERT_NE(mkdtemp(cache_dir), nullptr);
+  FLAGS_cinn_kernel_cache_dir = cache_dir;
+
+  std::string source_code = R"ROC(
+extern "C" __global__
+void scale(float a, float *x, float *out, size_t n)
+{
+  size_t tid = blockIdx.x * blockDim.x + threadIdx.x;
+  if (tid < n) {
+    out[tid] = a * x[tid];
+  }
+}
+)ROC";
+
+  Compiler compiler;
+  auto ptx = compiler(source_code);
+  ASSERT_FALSE(ptx.empty());
+  int num_files = 0;
+  DIR* dir = opendir(cache_dir);
+  ASSERT_NE(dir, nullptr);
+  while (struct dirent* entry = readdir(dir)) {
+    if (std::string(entry->d_name).find(".ptx") != std::string::npos) {
+      ++num_files;
+    }
+  }
+  closedir(dir);
+  EXPECT_EQ(num_files, 1);
+  // the second compiler loads the code written by the first one
+  Compiler cached_compiler;
+  EXPECT_EQ(cached_compiler(source_code), ptx);
+  FLAGS_cinn_kernel_cache_dir = "";
+}
+
 }  // namespace nvrtc
 }  // namespace backends
 }  // namespace cinn
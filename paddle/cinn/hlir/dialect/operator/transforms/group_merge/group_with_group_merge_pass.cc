@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <map>
 #include <set>
 #include <unordered_map>
@@ -32,6 +33,8 @@
 #include "paddle/cinn/common/is_reachable_predicator.h"
 
 PD_DECLARE_bool(enhance_vertical_fusion_with_recompute);
+PD_DECLARE_bool(cinn_fuse_independent_groups);
+PD_DECLARE_int64(cinn_independent_fuse_max_numel);
 
 namespace cinn {
 namespace dialect {
@@ -1142,9 +1145,60 @@ class GeneralFusionMergePassHelper {
 
     while (DoGeneralRecomputeAndVerticalFusion()) {
     }
+    if (FLAGS_cinn_fuse_independent_groups) {
+      DoIndependentHorizontalFusion();
+    }
     DoPrologueGenerateShapeOpGroupFustion();
   }
 
+  // The small injective groups of the same static loop size are fused into
+  // one kernel even if they share no input, like the branches of the
+  // embedding slots. The groups reachable from each other are left by the
+  // input fuse passes, and a fused group has at most
+  // kMaxIndependentFuseGroups groups so that the kernel stays small.
+  void DoIndependentHorizontalFusion() {
+    VLOG(3) << "DoIndependentHorizontalFusion...!";
+    constexpr size_t kMaxIndependentFuseGroups = 32;
+    std::map<int64_t, GroupList> numel_to_groups;
+    for (const auto& group : fusion_groups_) {
+      if (group->belong_groups.size()) {
+        continue;
+      }
+      if (group->op_pattern_kind != OpPatternKind::kElementWise &&
+          group->op_pattern_kind != OpPatternKind::kBroadcast &&
+          group->op_pattern_kind != OpPatternKind::kInjective) {
+        continue;
+      }
+      const auto& shape =
+          GetMasterNode(ir::OpGroup(group)).outputs()[0].shape();
+      int64_t numel = 1;
+      for (int i = 0; i < shape.size(); ++i) {
+        // the dynamic dims are -1
+        numel = shape[i] > 0 ? numel * shape[i] : -1;
+        if (numel < 0) break;
+      }
+      if (numel <= 0 || numel > FLAGS_cinn_independent_fuse_max_numel) {
+        continue;
+      }
+      numel_to_groups[numel].push_back(group);
+    }
+
+    bool updated = false;
+    for (const auto& iter : numel_to_groups) {
+      const GroupList& groups = iter.second;
+      for (size_t begin = 0; begin + 1 < groups.size();
+           begin += kMaxIndependentFuseGroups) {
+        size_t end = std::min(groups.size(), begin + kMaxIndependentFuseGroups);
+        std::unordered_set<GroupPtr, Hasher, Comparator> candidates(
+            groups.begin() + begin, groups.begin() + end);
+        updated |= CallGeneralInputFusePass(candidates);
+      }
+    }
+    if (updated) {
+      UpdateFusionGroup();
+    }
+  }
+
   void DoPrologueGenerateShapeOpGroupFustion() {
     VLOG(3) << "DoPrologueGenerateShapeOpGroupFustion...!";
     bool updated = false;
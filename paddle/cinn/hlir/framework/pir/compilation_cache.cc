@@ -0,0 +1,222 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/hlir/framework/pir/compilation_cache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <sstream>
+#include <unordered_set>
+
+#include "paddle/cinn/utils/string.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+namespace pir {
+
+namespace {
+
+// The attributes which do not change the kernel.
+const std::unordered_set<std::string>& IgnoredAttrs() {
+  static const std::unordered_set<std::string> ignored_attrs = {
+      "op_callstack",
+      "op_device",
+      "op_namescope",
+      "op_role",
+      "op_role_var",
+      "with_quant_attr"};
+  return ignored_attrs;
+}
+
+// Renames the symbols of the printed ShapeOrDataDimExprs in the order they
+// appear, the other identifiers are the names of the printed DimExprs.
+std::string CanonicalizeSymbols(const std::string& shapes) {
+  static const std::unordered_set<std::string> keywords = {
+      "shape", "data", "NULL", "Add", "Mul", "Max", "Min", "Broadcast"};
+  std::unordered_map<std::string, std::string> symbols;
+  std::string result;
+  result.reserve(shapes.size());
+  size_t i = 0;
+  while (i < shapes.size()) {
+    if (!std::isalpha(shapes[i]) && shapes[i] != '_') {
+      result += shapes[i++];
+      continue;
+    }
+    size_t end = i;
+    while (end < shapes.size() &&
+           (std::isalnum(shapes[end]) || shapes[end] == '_')) {
+      ++end;
+    }
+    std::string name = shapes.substr(i, end - i);
+    if (keywords.count(name) == 0) {
+      auto iter = symbols.find(name);
+      if (iter == symbols.end()) {
+        iter = symbols.emplace(name, "s" + std::to_string(symbols.size()))
+                   .first;
+      }
+      name = iter->second;
+    }
+    result += name;
+    i = end;
+  }
+  return result;
+}
+
+}  // namespace
+
+GroupSignature BuildGroupSignature(const GroupPtr& group) {
+  GroupSignature signature;
+  std::unordered_map<::pir::Value, size_t> value_ids;
+  auto ValueId = [&](const ::pir::Value& value) {
+    auto iter = value_ids.find(value);
+    if (iter == value_ids.end()) {
+      iter = value_ids.emplace(value, signature.values.size()).first;
+      signature.values.push_back(value);
+    }
+    return iter->second;
+  };
+
+  std::stringstream structure;
+  structure << "kind " << static_cast<int>(group->op_pattern_kind);
+  for (auto* op : group->ops) {
+    structure << "; " << op->name() << "(";
+    for (size_t i = 0; i < op->num_operands(); ++i) {
+      auto value = op->operand_source(i);
+      if (value) {
+        structure << "%" << ValueId(value) << ", ";
+      } else {
+        structure << "null, ";
+      }
+    }
+    structure << ") -> (";
+    for (size_t i = 0; i < op->num_results(); ++i) {
+      structure << "%" << ValueId(op->result(i)) << ", ";
+    }
+    structure << ")";
+    std::map<std::string, ::pir::Attribute> attrs(op->attributes().begin(),
+                                                   op->attributes().end());
+    for (const auto& [name, attr] : attrs) {
+      if (IgnoredAttrs().count(name) == 0) {
+        structure << " " << name << ": " << attr;
+      }
+    }
+  }
+  std::stringstream shapes;
+  for (size_t i = 0; i < signature.values.size(); ++i) {
+    const auto& value = signature.values[i];
+    auto dense_type = value.type().dyn_cast<paddle::dialect::DenseTensorType>();
+    if (dense_type) {
+      structure << "; %" << i << ": " << dense_type.dtype();
+    } else {
+      structure << "; %" << i << ": " << value.type();
+    }
+    shapes << "%" << i << ": ";
+    if (group->HasShapeOrDataExprs(value)) {
+      shapes << group->GetShapeOrDataExprs(value) << "; ";
+    } else if (dense_type) {
+      shapes << dense_type.dims() << "; ";
+    }
+  }
+  signature.structure = structure.str();
+  signature.shapes = CanonicalizeSymbols(shapes.str());
+  return signature;
+}
+
+CompilationCache& CompilationCache::Instance() {
+  static CompilationCache instance;
+  return instance;
+}
+
+bool CompilationCache::Find(const GroupSignature& signature, Entry* entry) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = entries_.find(signature.Key());
+  if (iter == entries_.end()) {
+    return false;
+  }
+  *entry = iter->second;
+  ++num_reused_;
+  return true;
+}
+
+void CompilationCache::Insert(
+    const GroupSignature& signature,
+    const GroupPtr& group,
+    const CINNKernelInfo& kernel_info,
+    const std::shared_ptr<backends::Compiler>& backend_compiler) {
+  Entry entry;
+  entry.kernel_info = kernel_info;
+  entry.backend_compiler = backend_compiler;
+  for (const auto& value : group->output_values) {
+    auto iter =
+        std::find(signature.values.begin(), signature.values.end(), value);
+    if (iter == signature.values.end()) {
+      VLOG(4) << "The output of group " << group->FuncName()
+              << " is out of the group, the kernel is not cached.";
+      return;
+    }
+    entry.output_value_ids.push_back(iter - signature.values.begin());
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!entries_.emplace(signature.Key(), std::move(entry)).second) {
+    return;
+  }
+  ++num_compiled_;
+  auto& shapes = structure_shapes_[signature.structure];
+  if (!shapes.empty()) {
+    ++num_recompiled_;
+    VLOG(1) << "Group " << group->FuncName() << " is compiled again for the "
+            << "shapes " << signature.shapes << " after the shapes "
+            << utils::Join(shapes, " and ");
+  }
+  shapes.push_back(signature.shapes);
+}
+
+CINNKernelInfo CompilationCache::Apply(const GroupSignature& signature,
+                                       const Entry& entry,
+                                       const GroupPtr& group) {
+  group->output_values.clear();
+  for (size_t id : entry.output_value_ids) {
+    group->output_values.push_back(signature.values.at(id));
+  }
+  group->int_args_map = entry.kernel_info.int_args_map;
+  return entry.kernel_info;
+}
+
+std::string CompilationCache::Summary() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::stringstream ss;
+  ss << "CINN compiled " << num_compiled_ << " group kernels for "
+     << structure_shapes_.size() << " group structures, " << num_recompiled_
+     << " of them are compiled again for new shapes, and reused the kernels "
+     << num_reused_ << " times.";
+  return ss.str();
+}
+
+void CompilationCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  structure_shapes_.clear();
+  num_compiled_ = 0;
+  num_reused_ = 0;
+  num_recompiled_ = 0;
+}
+
+}  // namespace pir
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
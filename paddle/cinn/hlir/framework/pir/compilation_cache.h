@@ -0,0 +1,95 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/cinn/backends/compiler.h"
+#include "paddle/cinn/hlir/framework/pir/group.h"
+#include "paddle/cinn/hlir/framework/pir/utils.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+namespace pir {
+
+// The structure of a group, up to the names of its values and symbols.
+struct GroupSignature {
+  // the ops, their attributes and the dtypes of the values
+  std::string structure;
+  // the symbolic shapes of the values
+  std::string shapes;
+  // the values in the order they are numbered in the signature
+  std::vector<::pir::Value> values;
+
+  std::string Key() const { return structure + "|" + shapes; }
+};
+
+GroupSignature BuildGroupSignature(const GroupPtr& group);
+
+// The kernels compiled by the bucket compile of PirCompiler. The groups of
+// the same signature, like the groups of the repeated layers of a model,
+// share a kernel, which BucketLower keeps generic over the symbolic dims.
+// It also counts the compilations, and logs why a group is compiled again
+// for new shapes.
+class CompilationCache {
+ public:
+  struct Entry {
+    CINNKernelInfo kernel_info;
+    // the output values of the kernel, as indices of GroupSignature::values
+    std::vector<size_t> output_value_ids;
+    // keeps the compiled code alive
+    std::shared_ptr<backends::Compiler> backend_compiler;
+  };
+
+  static CompilationCache& Instance();
+
+  bool Find(const GroupSignature& signature, Entry* entry);
+
+  void Insert(const GroupSignature& signature,
+              const GroupPtr& group,
+              const CINNKernelInfo& kernel_info,
+              const std::shared_ptr<backends::Compiler>& backend_compiler);
+
+  // Sets the output values and the int args of the group to the ones of the
+  // kernel of the entry, and returns its kernel info.
+  static CINNKernelInfo Apply(const GroupSignature& signature,
+                              const Entry& entry,
+                              const GroupPtr& group);
+
+  std::string Summary() const;
+
+  void Clear();
+
+ private:
+  CompilationCache() = default;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  // the shapes of the groups compiled for every structure
+  std::unordered_map<std::string, std::vector<std::string>> structure_shapes_;
+  size_t num_compiled_{0};
+  size_t num_reused_{0};
+  size_t num_recompiled_{0};
+};
+
+}  // namespace pir
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -17,12 +17,40 @@
 #include "paddle/cinn/hlir/framework/pir/compilation_task.h"
 #include "paddle/cinn/common/target.h"
 #include "paddle/cinn/hlir/framework/op_lowering.h"
+#include "paddle/cinn/ir/ir_analyzer/ir_analyzer.h"
 #include "paddle/cinn/ir/module.h"
+#include "paddle/cinn/utils/string.h"
 
 namespace cinn {
 namespace hlir {
 namespace framework {
 
+void SetKernelProfileInfo(const pir::GroupPtr& group,
+                          const std::vector<ir::LoweredFunc>& funcs,
+                          pir::CINNKernelInfo* kernel_info) {
+  kernel_info->fn_name = group->FuncName();
+  std::vector<std::string> op_names;
+  for (::pir::Operation* op : group->ops) {
+    op_names.push_back(op->name());
+  }
+  kernel_info->op_names = utils::Join(op_names, ",");
+  if (funcs.empty()) return;
+  std::vector<ir::Expr> bodies;
+  for (const ir::LoweredFunc& func : funcs) {
+    bodies.push_back(func->body);
+  }
+  ir::analyzer::KernelCost cost = ir::analyzer::AnalyzeKernelCost(bodies);
+  kernel_info->flops = cost.flops;
+  kernel_info->bytes_accessed = cost.bytes_accessed;
+  if (cost.bytes_accessed > 0) {
+    VLOG(1) << "Roofline of " << kernel_info->fn_name << " ["
+            << kernel_info->op_names << "]: " << cost.flops << " flops, "
+            << cost.bytes_accessed << " bytes, "
+            << static_cast<double>(cost.flops) / cost.bytes_accessed
+            << " flops/byte.";
+  }
+}
+
 void GroupCompilationContext::SetLoweredFuncs(
     BucketLoweredFuncsWrapper&& funcs) {
   for (std::pair<ir::SymbolicPredicate, ir::LoweredFunc>& predicate2func :
@@ -110,6 +138,12 @@ pir::CINNKernelInfo CompilationTask::BuildPirCINNKernelInfo() {
   cinn_kernel_info.fn_ptr = fn_ptr;
   cinn_kernel_info.infer_shape_fn_ptr = infer_shape_fn_ptr;
   cinn_kernel_info.int_args_map = context_->group_->int_args_map;
+  // the bucket funcs are alternatives, only a single func has a known cost
+  SetKernelProfileInfo(context_->group_,
+                       context_->func_size_ == 1
+                           ? context_->lowered_funcs_
+                           : std::vector<ir::LoweredFunc>{},
+                       &cinn_kernel_info);
   return cinn_kernel_info;
 }
 
@@ -53,6 +53,12 @@ class GroupCompilationContext {
   std::shared_ptr<backends::Compiler> backend_compiler_;
 };
 
+// Set the name, the ops and the static cost of the lowered funcs of a group
+// to its kernel info, and log the roofline numbers.
+void SetKernelProfileInfo(const pir::GroupPtr& group,
+                          const std::vector<ir::LoweredFunc>& funcs,
+                          pir::CINNKernelInfo* kernel_info);
+
 class CompilationTask {
  public:
   explicit CompilationTask(GroupCompilationContext* context)
@@ -18,6 +18,7 @@
 
 #include "paddle/cinn/adt/map_expr_ctx.h"
 #include "paddle/cinn/ast_gen_ius/tensor_group.h"
+#include "paddle/cinn/auto_schedule/database/database.h"
 #include "paddle/cinn/backends/codegen_cuda_util.h"
 #include "paddle/cinn/hlir/framework/compile_error.h"
 #include "paddle/cinn/hlir/framework/pir/op_lowering_util.h"
@@ -28,8 +29,10 @@
 #include "paddle/cinn/ir/group_schedule/base_group_scheduler.h"
 #include "paddle/cinn/ir/group_schedule/st_shape_group_scheduler.h"
 #include "paddle/cinn/ir/schedule/ir_schedule.h"
+#include "paddle/cinn/ir/schedule/schedule_desc.h"
 #include "paddle/cinn/lang/placeholder.h"
 #include "paddle/cinn/optim/transform_gpu_forloop.h"
+#include "paddle/cinn/utils/string.h"
 #include "paddle/common/ddim.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
 
@@ -38,6 +41,7 @@ PD_DECLARE_bool(cinn_enable_map_expr);
 PD_DECLARE_bool(cinn_enable_map_expr_schedule);
 PD_DECLARE_bool(cinn_bucket_compile);
 PD_DECLARE_bool(cinn_new_group_scheduler);
+PD_DECLARE_string(cinn_tuning_database);
 
 namespace cinn {
 namespace hlir {
@@ -61,6 +65,18 @@ NodeAttr CollectAttrs(const ::pir::Operation& op) {
   return node_attrs;
 }
 
+// the tuning records are loaded once and only read by the compilation
+auto_schedule::Database* TuningDatabase() {
+  static std::unique_ptr<auto_schedule::Database> database = [] {
+    auto_schedule::DatabaseConfig config;
+    config.type = auto_schedule::DatabaseType::kJSONFile;
+    config.capacity_per_task = 1;
+    config.record_file_path = FLAGS_cinn_tuning_database;
+    return auto_schedule::Database::Make(config);
+  }();
+  return database.get();
+}
+
 }  // namespace details
 
 OpLowererImpl::OpLowererImpl(const Target& target) : target_(target) {
@@ -345,7 +361,9 @@ std::vector<ir::LoweredFunc> OpLowererImpl::LowerGroup(
   ir_sch.MergeExprs();
   VLOG(3) << "After lower, ir is: \n" << ir_sch.GetModule().GetExprs().at(0);
   if (apply_group_schedule) {
-    DoGroupSchedule(ir_sch, group, tensor_map, tmp_tensor_info);
+    if (!ApplyTunedSchedule(&ir_sch)) {
+      DoGroupSchedule(ir_sch, group, tensor_map, tmp_tensor_info);
+    }
     VLOG(3) << "After group schedule, ir is: \n"
             << ir_sch.GetModule().GetExprs().at(0);
   }
@@ -698,6 +716,26 @@ ir::Expr OpLowererImpl::DoOpSchedule(
   return expr_pack[0].operator ir::Expr();
 }
 
+bool OpLowererImpl::ApplyTunedSchedule(ir::IRSchedule* ir_sch) {
+  if (FLAGS_cinn_tuning_database.empty()) {
+    return false;
+  }
+  // the unscheduled bodies name the blocks the trace refers to, so a record
+  // of the same key can always be replayed
+  std::string task_key =
+      cinn::utils::Join(ir_sch->GetModule().GetExprs(), "\n");
+  std::vector<auto_schedule::TuningRecord> records =
+      details::TuningDatabase()->GetTopK(task_key, 1);
+  if (records.empty()) {
+    VLOG(4) << "No tuning record of the group, use the group schedule.";
+    return false;
+  }
+  VLOG(3) << "Replay the tuning record of execution cost "
+          << records[0].execution_cost << "us.";
+  ir::ScheduleDesc::ReplayWithProto(records[0].trace, ir_sch);
+  return true;
+}
+
 ir::Expr OpLowererImpl::DoGroupSchedule(
     ir::IRSchedule& ir_sch,
     const GroupPtr& group,
@@ -201,6 +201,16 @@ class OpLowererImpl : public OpLowererImplBase<GroupPtr> {
                         const std::vector<ir::Tensor>& op_func_arg_tensors,
                         const std::vector<ir::LoweredFunc>& lowered_funcs);
 
+  /**
+   * @brief Replay the best tuning record of FLAGS_cinn_tuning_database on a
+   * group, the record is looked up by the group's lowered func bodies before
+   * schedule.
+   * @param ir_sch The IRSchedule containing the entire group's lowered func
+   * bodies.
+   * @return True if a record is found and replayed.
+   */
+  bool ApplyTunedSchedule(ir::IRSchedule* ir_sch);
+
   /**
    * @brief Apply schedule on a group.
    * @param ir_sch The IRSchedule containing the entire group's lowered func
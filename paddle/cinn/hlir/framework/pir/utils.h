@@ -50,6 +50,12 @@ struct CINNKernelInfo {
   //     3: {1, 2}
   //   }
   std::map<int, ArgDimIdx> int_args_map;
+
+  // the profiling info of the kernel, the costs are -1 if unknown
+  std::string fn_name;
+  std::string op_names;
+  int64_t flops = -1;
+  int64_t bytes_accessed = -1;
 };
 
 struct CompatibleInfo {
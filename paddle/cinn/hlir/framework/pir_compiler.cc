@@ -15,6 +15,10 @@
 #include "paddle/cinn/hlir/framework/pir_compiler.h"
 
 #include <absl/types/variant.h>
+#include <numeric>
+#include <unordered_set>
+
+#include "paddle/cinn/hlir/framework/pir/compilation_cache.h"
 #include "paddle/cinn/hlir/framework/pir/compilation_task.h"
 #include "paddle/cinn/hlir/framework/pir/utils.h"
 #include "paddle/cinn/utils/multi_threading.h"
@@ -22,6 +26,7 @@
 #include "paddle/pir/core/builtin_type.h"
 
 PD_DECLARE_bool(cinn_bucket_compile);
+PD_DECLARE_bool(cinn_reuse_group_kernel);
 
 namespace cinn {
 namespace hlir {
@@ -47,16 +52,64 @@ std::vector<pir::CINNKernelInfo> PirCompiler::BuildCUDAJITInfo(
   std::vector<pir::CINNKernelInfo> cinn_kernel_info_vecs(groups.size());
 
   if (FLAGS_cinn_bucket_compile) {
-    for (int i = 0; i < groups.size(); ++i) {
-      group_compilation_contexts_.emplace_back(target_, groups[i], scope_);
+    auto& cache = pir::CompilationCache::Instance();
+    std::vector<pir::GroupSignature> signatures;
+    if (FLAGS_cinn_reuse_group_kernel) {
+      for (const auto& group : groups) {
+        signatures.push_back(pir::BuildGroupSignature(group));
+      }
+    }
+    // Every round compiles the first group of every signature not in the
+    // cache, the other groups of the signature reuse its kernel next round.
+    std::vector<int> pending(groups.size());
+    std::iota(pending.begin(), pending.end(), 0);
+    while (!pending.empty()) {
+      std::vector<int> compile_indices;
+      std::vector<int> next_pending;
+      std::unordered_set<std::string> compiling_keys;
+      for (int i : pending) {
+        pir::CompilationCache::Entry entry;
+        if (FLAGS_cinn_reuse_group_kernel) {
+          if (cache.Find(signatures[i], &entry)) {
+            VLOG(4) << "Group " << groups[i]->FuncName() << " reuses a kernel";
+            cinn_kernel_info_vecs[i] =
+                pir::CompilationCache::Apply(signatures[i], entry, groups[i]);
+            continue;
+          }
+          if (!compiling_keys.insert(signatures[i].Key()).second) {
+            next_pending.push_back(i);
+            continue;
+          }
+        }
+        compile_indices.push_back(i);
+      }
+      const size_t context_offset = group_compilation_contexts_.size();
+      for (int i : compile_indices) {
+        group_compilation_contexts_.emplace_back(target_, groups[i], scope_);
+      }
+      auto worker_fn = [&](int index) {
+        auto& context = group_compilation_contexts_[context_offset + index];
+        const int group_idx = compile_indices[index];
+        CompilationTask task(&context);
+        task();
+        cinn_kernel_info_vecs[group_idx] = task.BuildPirCINNKernelInfo();
+        if (FLAGS_cinn_reuse_group_kernel) {
+          cache.Insert(signatures[group_idx],
+                       groups[group_idx],
+                       cinn_kernel_info_vecs[group_idx],
+                       context.BackendCompiler());
+        }
+      };
+      const int num_tasks = compile_indices.size();
+      if (num_tasks > 0) {
+        utils::parallel_run(
+            worker_fn, utils::SequenceDispatcher(0, num_tasks), -1);
+      }
+      pending = std::move(next_pending);
+    }
+    if (FLAGS_cinn_reuse_group_kernel) {
+      VLOG(1) << cache.Summary();
     }
-    auto worker_fn = [&](int index) {
-      CompilationTask task(&group_compilation_contexts_[index]);
-      task();
-      cinn_kernel_info_vecs[index] = task.BuildPirCINNKernelInfo();
-    };
-    utils::parallel_run(
-        worker_fn, utils::SequenceDispatcher(0, groups.size()), -1);
   } else {
     auto op_lowerer = CreateOpLowerer<pir::GroupPtr>(target_);
 
@@ -80,6 +133,7 @@ std::vector<pir::CINNKernelInfo> PirCompiler::BuildCUDAJITInfo(
       auto fn_ptr = compiler_->Lookup(fn_name);
       cinn_kernel_info.fn_ptr = fn_ptr;
       cinn_kernel_info.int_args_map = groups[idx]->int_args_map;
+      SetKernelProfileInfo(groups[idx], lowered_funcs[idx], &cinn_kernel_info);
 
       cinn_kernel_info_vecs[idx] = cinn_kernel_info;
     }
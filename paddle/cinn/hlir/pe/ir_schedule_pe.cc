@@ -38,6 +38,8 @@
 #include "paddle/cinn/utils/string.h"
 
 PD_DECLARE_bool(cinn_new_group_scheduler);
+PD_DECLARE_bool(cinn_cuda_vectorize_injective);
+PD_DECLARE_bool(cinn_x86_parallel_loops);
 namespace cinn {
 namespace hlir {
 namespace pe {
@@ -140,6 +142,14 @@ void IRScheduleInjectiveCPU(ir::IRSchedule &ir_sch,  // NOLINT
     fused = ir_sch.Fuse({loops[0], loops[1]});
     dims = dims - 1;
   }
+  // the small kernels cost less than waking the threads up
+  constexpr int kMinParallelSize = 1 << 14;
+  int prod_size = std::accumulate(
+      output_shape.begin(), output_shape.end(), 1, std::multiplies<int>());
+  if (FLAGS_cinn_x86_parallel_loops && prod_size >= kMinParallelSize &&
+      ir::GetLoopExtent(fused) > 1) {
+    ir_sch.Parallel(fused);
+  }
   // This part needs to be fixed. @Haoze
   /*   ir_sch.Parallel(fused);
     if (vectorizable) {
@@ -169,7 +179,27 @@ void IRCudaScheduleInjective(ir::IRSchedule &ir_sch,  // NOLINT
   int vector_width = 1;
   int prod_size = std::accumulate(
       output_shape.begin(), output_shape.end(), 1, std::multiplies<int>());
-  if (prod_size > num_thread) {
+  if (FLAGS_cinn_cuda_vectorize_injective && !output_shape.empty()) {
+    // a thread accesses up to 16 bytes, the width should divide the last dim
+    // so that the vectors are contiguous and aligned
+    int bits = GetTensor(all_blocks[0])->type().bits();
+    if (bits == 16 || bits == 32) {
+      vector_width = 128 / bits;
+      while (vector_width > 1 && output_shape.back() % vector_width != 0) {
+        vector_width /= 2;
+      }
+    }
+  }
+  if (vector_width > 1 && prod_size % (num_thread * vector_width) == 0) {
+    auto splited = ir_sch.Split(fused, {-1, num_thread, vector_width});
+    ir_sch.Bind(splited[0], "blockIdx.x");
+    ir_sch.Bind(splited[1], "threadIdx.x");
+    ir_sch.Vectorize(splited[2], vector_width);
+  } else if (vector_width > 1 && prod_size <= num_thread * vector_width) {
+    auto splited = ir_sch.Split(fused, {-1, vector_width});
+    ir_sch.Bind(splited[0], "threadIdx.x");
+    ir_sch.Vectorize(splited[1], vector_width);
+  } else if (prod_size > num_thread) {
     auto splited = ir_sch.Split(fused, {-1, num_thread});
     ir_sch.Bind(splited[0], "blockIdx.x");
     ir_sch.Bind(splited[1], "threadIdx.x");
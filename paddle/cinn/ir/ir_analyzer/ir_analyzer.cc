@@ -510,6 +510,96 @@ std::string GetBlockName(const ir::Expr block) {
   return block_node->name;
 }
 
+namespace {
+
+class KernelCostAnalyzer : public ir::IRMutator<const Expr*> {
+ public:
+  void operator()(const Expr* expr) { IRMutator::Visit(expr, expr); }
+
+  KernelCost cost() const {
+    if (is_dynamic_) return KernelCost{-1, -1};
+    return cost_;
+  }
+
+ private:
+  void Visit(const ir::For* op, const Expr* expr) override {
+    const ir::IntImm* extent = op->extent.As<ir::IntImm>();
+    if (extent == nullptr) {
+      is_dynamic_ = true;
+      return;
+    }
+    int64_t outer_count = count_;
+    count_ *= extent->value;
+    IRMutator::Visit(&op->body, &op->body);
+    count_ = outer_count;
+  }
+
+  void Visit(const ir::Store* op, const Expr* expr) override {
+    AddAccess(op->tensor);
+    IRMutator::Visit(&op->value, &op->value);
+    for (const Expr& index : op->indices) {
+      IRMutator::Visit(&index, &index);
+    }
+  }
+
+  void Visit(const ir::Load* op, const Expr* expr) override {
+    AddAccess(op->tensor);
+    for (const Expr& index : op->indices) {
+      IRMutator::Visit(&index, &index);
+    }
+  }
+
+  // the math functions count one operation like the arithmetic ops
+  void Visit(const ir::Call* op, const Expr* expr) override {
+    AddFlop(op->type());
+    IRMutator::Visit(op, expr);
+  }
+
+#define __(op__)                                              \
+  void Visit(const ir::op__* op, const Expr* expr) override { \
+    AddFlop(op->type());                                      \
+    IRMutator::Visit(op, expr);                               \
+  }
+  __(Add)
+  __(Sub)
+  __(Mul)
+  __(Div)
+  __(Mod)
+  __(Min)
+  __(Max)
+  __(Minus)
+#undef __
+
+  void AddFlop(const Type& type) {
+    if (type.is_float()) {
+      cost_.flops += count_;
+    }
+  }
+
+  void AddAccess(const Expr& tensor_expr) {
+    const ir::_Tensor_* tensor = tensor_expr.As<ir::_Tensor_>();
+    if (tensor == nullptr || !tensor->buffer.defined() ||
+        tensor->buffer->is_on_gpu()) {
+      return;
+    }
+    cost_.bytes_accessed += count_ * tensor->type().ElementOf().bytes();
+  }
+
+  KernelCost cost_;
+  int64_t count_ = 1;
+  bool is_dynamic_ = false;
+};
+
+}  // namespace
+
+KernelCost AnalyzeKernelCost(const std::vector<Expr>& exprs) {
+  KernelCostAnalyzer analyzer;
+  for (const Expr& expr : exprs) {
+    analyzer(&expr);
+  }
+  return analyzer.cost();
+}
+
 }  // namespace analyzer
 }  // namespace ir
 }  // namespace cinn
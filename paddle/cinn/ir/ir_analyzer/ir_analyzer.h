@@ -79,6 +79,16 @@ void AnalyzeScheduleBlockReadWriteBuffer(ir::ScheduleBlock* sche_block);
 
 std::string GetBlockName(const ir::Expr block);
 
+// The static cost of lowered func bodies: the floating point operations and
+// the bytes of the global buffers the loads and stores access. A cost is -1 if
+// it depends on a loop of dynamic extent.
+struct KernelCost {
+  int64_t flops = 0;
+  int64_t bytes_accessed = 0;
+};
+
+KernelCost AnalyzeKernelCost(const std::vector<Expr>& exprs);
+
 }  // namespace analyzer
 }  // namespace ir
 }  // namespace cinn
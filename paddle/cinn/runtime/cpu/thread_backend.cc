@@ -15,6 +15,10 @@
 #include "paddle/cinn/runtime/cpu/thread_backend.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
 #include <vector>
 
 #ifdef CINN_USE_OPENMP
@@ -25,6 +29,9 @@
 #include "paddle/cinn/backends/llvm/runtime_symbol_registry.h"
 #include "paddle/cinn/common/cas.h"
 #include "paddle/cinn/runtime/intrinsic.h"
+#ifndef CINN_WITH_ONLY
+#include "paddle/phi/core/threadpool.h"
+#endif  // CINN_WITH_ONLY
 
 int max_concurrency() {
   int max_concurrency = 1;
@@ -43,12 +50,56 @@ int max_concurrency() {
   return std::max(max_concurrency, 1);
 }
 
+#ifndef CINN_WITH_ONLY
+namespace {
+
+// The tasks of a launch are claimed with an atomic counter by the caller and
+// the jobs in the thread pool, the caller only waits for the claimed tasks, so
+// a launch from a thread of the pool never waits for its queued jobs.
+struct ParallelLaunchState {
+  FCINNParallelLambda flambda;
+  void* datas;
+  int num_task;
+  std::atomic<int> next_task{0};
+  std::atomic<int> finished_task{0};
+  std::mutex mutex;
+  std::condition_variable finished;
+};
+
+void RunParallelTasks(const std::shared_ptr<ParallelLaunchState>& state) {
+  int task_id;
+  while ((task_id = state->next_task.fetch_add(1)) < state->num_task) {
+    (*state->flambda)(task_id, state->num_task, state->datas);
+    if (state->finished_task.fetch_add(1) + 1 == state->num_task) {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      state->finished.notify_all();
+    }
+  }
+}
+
+}  // namespace
+#endif  // CINN_WITH_ONLY
+
 int cinn_backend_parallel_launch(FCINNParallelLambda flambda,
                                  void* datas,
                                  int num_task) {
   int num_workers = max_concurrency();
   if (num_task == 0) num_task = num_workers;
-#ifdef CINN_USE_OPENMP
+#ifndef CINN_WITH_ONLY
+  // share the thread pool of phi to not oversubscribe the cores
+  auto state = std::make_shared<ParallelLaunchState>();
+  state->flambda = flambda;
+  state->datas = datas;
+  state->num_task = num_task;
+  int num_jobs = std::min(num_task, num_workers) - 1;
+  for (int i = 0; i < num_jobs; ++i) {
+    phi::ThreadPool::GetInstance()->Run([state] { RunParallelTasks(state); });
+  }
+  RunParallelTasks(state);
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->finished.wait(
+      lock, [&state] { return state->finished_task.load() == num_task; });
+#elif defined(CINN_USE_OPENMP)
   omp_set_num_threads(num_task);
 #pragma omp parallel num_threads(num_task)
   {
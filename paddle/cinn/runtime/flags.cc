@@ -65,10 +65,25 @@ PD_DEFINE_bool(cinn_new_group_scheduler,
                BoolFromEnv("FLAGS_cinn_new_group_scheduler", false),
                "Whether to use new group scheduler.");
 
+PD_DEFINE_bool(cinn_x86_parallel_loops,
+               BoolFromEnv("FLAGS_cinn_x86_parallel_loops", false),
+               "Whether the x86 injective schedule runs the outer loops of the "
+               "large kernels in parallel on the host threads.");
+
+PD_DEFINE_bool(cinn_cuda_vectorize_injective,
+               BoolFromEnv("FLAGS_cinn_cuda_vectorize_injective", true),
+               "Whether the CUDA injective schedule accesses the contiguous "
+               "elements of a thread with the vector types, like float4.");
+
 PD_DEFINE_bool(cinn_bucket_compile,
                BoolFromEnv("FLAGS_cinn_bucket_compile", false),
                "Whether to enable bucket compile for dynamic shape.");
 
+PD_DEFINE_bool(cinn_reuse_group_kernel,
+               BoolFromEnv("FLAGS_cinn_reuse_group_kernel", true),
+               "Whether the bucket compile reuses the kernel of the groups of "
+               "the same ops, attributes and symbolic shapes.");
+
 PD_DEFINE_bool(cinn_use_common_subexpression_elimination,
                BoolFromEnv("FLAGS_cinn_use_common_subexpression_elimination",
                            false),
@@ -144,6 +159,21 @@ PD_DEFINE_bool(
     "technique which contract fp mulitplication and addition/subtraction into "
     "multiply-add operation. It may result in different fp precision.");
 
+PD_DEFINE_string(
+    cinn_tuning_database,
+    StringFromEnv("FLAGS_cinn_tuning_database", ""),
+    "Specify the JSON file of the auto-schedule tuning records. The PIR "
+    "compilation looks the schedule of a static shape group up in it and "
+    "replays the best one instead of the default group schedule.");
+
+PD_DEFINE_string(
+    cinn_kernel_cache_dir,
+    StringFromEnv("FLAGS_cinn_kernel_cache_dir", ""),
+    "Specify the directory to cache the PTX or CUBIN compiled by nvrtc, so "
+    "that the kernels are not compiled again in later runs. The directory can "
+    "be shared by the processes of a cluster, it should be cleared after "
+    "upgrading CUDA or CINN.");
+
 // FLAGS for performance analysis and accuracy debug
 PD_DEFINE_bool(cinn_sync_run,
                BoolFromEnv("FLAGS_cinn_sync_run", false),
@@ -214,6 +244,18 @@ PD_DEFINE_bool(
     BoolFromEnv("FLAGS_enhance_vertical_fusion_with_recompute", true),
     "Whether to enhance check logic on vertical fusion with recompute");
 
+PD_DEFINE_bool(
+    cinn_fuse_independent_groups,
+    BoolFromEnv("FLAGS_cinn_fuse_independent_groups", false),
+    "Whether to fuse the small injective groups of the same loop size that do "
+    "not depend on each other into one kernel, to save kernel launches.");
+
+PD_DEFINE_int64(
+    cinn_independent_fuse_max_numel,
+    Int64FromEnv("FLAGS_cinn_independent_fuse_max_numel", 65536L),
+    "The max loop size of the groups fused by "
+    "FLAGS_cinn_fuse_independent_groups, larger groups fill the device alone.");
+
 PD_DEFINE_bool(verbose_function_register,
                BoolFromEnv("FLAGS_verbose_function_register", false),
                "Whether to verbose function regist log. This will only work if "
@@ -0,0 +1,227 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/collective/param_prefetcher.h"
+
+#include <algorithm>
+
+#include "paddle/fluid/eager/api/utils/hook_utils.h"
+#include "paddle/fluid/eager/autograd_meta.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace paddle {
+namespace distributed {
+
+static phi::DenseTensor *GetDenseTensor(const Tensor &tensor) {
+  auto *dense_tensor = dynamic_cast<phi::DenseTensor *>(tensor.impl().get());
+  PADDLE_ENFORCE_NOT_NULL(
+      dense_tensor,
+      phi::errors::InvalidArgument(
+          "The sharded parameter %s must be a DenseTensor.", tensor.name()));
+  return dense_tensor;
+}
+
+EagerParamPrefetcher::EagerParamPrefetcher(
+    const std::vector<std::vector<Tensor>> &layer_params,
+    const std::vector<std::vector<Tensor>> &layer_shards,
+    std::shared_ptr<distributed::ProcessGroup> process_group,
+    int prefetch_layers)
+    : process_group_(process_group), prefetch_layers_(prefetch_layers) {
+  PADDLE_ENFORCE_EQ(layer_params.size(),
+                    layer_shards.size(),
+                    phi::errors::InvalidArgument(
+                        "The layers of the params (%d) and the shards (%d) of "
+                        "EagerParamPrefetcher should be the same.",
+                        layer_params.size(),
+                        layer_shards.size()));
+  PADDLE_ENFORCE_GE(prefetch_layers_,
+                    0,
+                    phi::errors::InvalidArgument(
+                        "The prefetch_layers of EagerParamPrefetcher should "
+                        "not be negative, but got %d.",
+                        prefetch_layers_));
+  nranks_ = process_group_->GetSize();
+
+  layers_.resize(layer_params.size());
+  for (size_t layer = 0; layer < layer_params.size(); ++layer) {
+    PADDLE_ENFORCE_EQ(layer_params[layer].size(),
+                      layer_shards[layer].size(),
+                      phi::errors::InvalidArgument(
+                          "The layer %d has %d params but %d shards.",
+                          layer,
+                          layer_params[layer].size(),
+                          layer_shards[layer].size()));
+    for (size_t i = 0; i < layer_params[layer].size(); ++i) {
+      const auto &param = layer_params[layer][i];
+      const auto &shard = layer_shards[layer][i];
+      PADDLE_ENFORCE_EQ(
+          param.dtype() == shard.dtype() &&
+              param.numel() <= shard.numel() * nranks_,
+          true,
+          phi::errors::InvalidArgument(
+              "The shard of the param %s should have its dtype, and "
+              "nranks * the numel of the shard (%d) should cover the "
+              "numel of the param (%d).",
+              param.name(),
+              shard.numel() * nranks_,
+              param.numel()));
+      place_ = GetDenseTensor(shard)->place();
+
+      const size_t param_index = params_.size();
+      params_.push_back(param);
+      shards_.push_back(shard);
+      layers_[layer].param_indices.push_back(param_index);
+      // the reduce hook runs once the grad of the param is accumulated
+      egr::egr_utils_api::RegisterReduceHookForTensor(
+          param, [=]() { this->OnGradReady(layer); });
+    }
+  }
+}
+
+void EagerParamPrefetcher::PreForward(size_t layer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const size_t end = std::min(layer + prefetch_layers_ + 1, layers_.size());
+  for (size_t next = layer; next < end; ++next) {
+    Gather(next);
+  }
+  WaitGathered(layer);
+}
+
+void EagerParamPrefetcher::PostForward(size_t layer,
+                                       const std::vector<Tensor> &outputs) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto &output : outputs) {
+    if (!output.defined() || output.get_autograd_meta() == nullptr) continue;
+    auto *autograd_meta =
+        static_cast<egr::AutogradMeta *>(output.get_autograd_meta());
+    if (autograd_meta->StopGradient() ||
+        autograd_meta->GetMutableGradNode() == nullptr) {
+      continue;
+    }
+    egr::egr_utils_api::RegisterGradientHookForTensor(
+        output, [=](const Tensor &grad) -> Tensor {
+          this->PreBackward(layer);
+          return grad;
+        });
+  }
+  layers_[layer].pending_grads = layers_[layer].param_indices.size();
+  // the backward starts with the last layer, so it is kept
+  if (layer + 1 < layers_.size()) {
+    Release(layer);
+  }
+}
+
+void EagerParamPrefetcher::PreBackward(size_t layer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const size_t begin =
+      layer > static_cast<size_t>(prefetch_layers_) ? layer - prefetch_layers_
+                                                    : 0;
+  for (size_t next = layer + 1; next-- > begin;) {
+    Gather(next);
+  }
+  WaitGathered(layer);
+}
+
+void EagerParamPrefetcher::PostBackward(size_t layer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Release(layer);
+}
+
+void EagerParamPrefetcher::ReleaseAll() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t layer = 0; layer < layers_.size(); ++layer) {
+    Release(layer);
+  }
+}
+
+void EagerParamPrefetcher::OnGradReady(size_t layer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto &state = layers_[layer];
+  if (state.pending_grads == 0) return;
+  if (--state.pending_grads == 0) {
+    VLOG(3) << "The grads of layer " << layer << " are ready, release it.";
+    Release(layer);
+  }
+}
+
+void EagerParamPrefetcher::Gather(size_t layer) {
+  auto &state = layers_[layer];
+  if (state.state != LayerState::kReleased) return;
+  VLOG(3) << "Gather the params of layer " << layer;
+  for (const auto param_index : state.param_indices) {
+    auto *shard = GetDenseTensor(shards_[param_index]);
+    auto *param = GetDenseTensor(params_[param_index]);
+    phi::DenseTensor buffer =
+        AcquireBuffer(shard->dtype(), shard->numel() * nranks_);
+    // the comm stream waits for the calc stream before the gather, so the
+    // kernels reading the reused buffer finish first
+    state.tasks.push_back(process_group_->AllGather(
+        &buffer, *shard, /*offset=*/0, /*numel=*/-1, /*sync_op=*/false));
+    // the padding of the last shard is after the numel of the param
+    param->ShareBufferWith(buffer);
+    state.buffers.push_back(std::move(buffer));
+  }
+  state.state = LayerState::kGathering;
+}
+
+void EagerParamPrefetcher::WaitGathered(size_t layer) {
+  auto &state = layers_[layer];
+  PADDLE_ENFORCE_NE(state.state,
+                    LayerState::kReleased,
+                    phi::errors::PreconditionNotMet(
+                        "The params of layer %d are not gathered.", layer));
+  if (state.state == LayerState::kReady) return;
+  // the calc stream waits for the gathers
+  for (auto &task : state.tasks) {
+    task->Wait();
+  }
+  state.tasks.clear();
+  state.state = LayerState::kReady;
+}
+
+void EagerParamPrefetcher::Release(size_t layer) {
+  auto &state = layers_[layer];
+  if (state.state == LayerState::kReleased) return;
+  if (state.state == LayerState::kGathering) {
+    WaitGathered(layer);
+  }
+  VLOG(3) << "Release the params of layer " << layer;
+  for (const auto param_index : state.param_indices) {
+    GetDenseTensor(params_[param_index])->clear();
+  }
+  for (auto &buffer : state.buffers) {
+    auto key = std::make_pair(buffer.dtype(), buffer.numel());
+    free_buffers_[key].push_back(std::move(buffer));
+  }
+  state.buffers.clear();
+  state.state = LayerState::kReleased;
+}
+
+phi::DenseTensor EagerParamPrefetcher::AcquireBuffer(phi::DataType dtype,
+                                                     int64_t numel) {
+  auto &buffers = free_buffers_[std::make_pair(dtype, numel)];
+  if (!buffers.empty()) {
+    phi::DenseTensor buffer = std::move(buffers.back());
+    buffers.pop_back();
+    return buffer;
+  }
+  phi::DenseTensor buffer;
+  buffer.Resize({numel});
+  platform::DeviceContextPool::Instance().Get(place_)->Alloc(&buffer, dtype);
+  return buffer;
+}
+
+}  //  namespace distributed
+}  //  namespace paddle
@@ -0,0 +1,94 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "paddle/fluid/distributed/collective/process_group.h"
+#include "paddle/phi/api/include/tensor.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace paddle {
+namespace distributed {
+using Tensor = paddle::Tensor;
+
+// EagerParamPrefetcher gathers the sharded parameters of the layers of a
+// stage 3 sharded model ahead of their use. Each rank keeps a shard of every
+// parameter, the flattened parameter padded to nranks * shard numel, and the
+// full parameter only lives between the use of its layer.
+//
+// PreForward(i) issues the all-gathers of the layers [i, i + prefetch_layers]
+// on the communication stream and waits for the layer i, so the gathers of
+// the next layers overlap the computation of the layer i. PostForward(i)
+// releases the parameters of the layer i, and hooks the grads of its outputs
+// to run PreBackward(i), which prefetches the layers [i - prefetch_layers, i]
+// in the backward. The parameters of a layer are released again once their
+// grads are all accumulated. The released buffers are reused by the next
+// gathers of the same size.
+class EagerParamPrefetcher {
+ public:
+  EagerParamPrefetcher(const std::vector<std::vector<Tensor>> &layer_params,
+                       const std::vector<std::vector<Tensor>> &layer_shards,
+                       std::shared_ptr<distributed::ProcessGroup> process_group,
+                       int prefetch_layers);
+
+  virtual ~EagerParamPrefetcher() {}
+
+  void PreForward(size_t layer);
+  void PostForward(size_t layer, const std::vector<Tensor> &outputs);
+  void PreBackward(size_t layer);
+  void PostBackward(size_t layer);
+  // release the parameters of all the layers, e.g. after the step
+  void ReleaseAll();
+
+ private:
+  enum class LayerState { kReleased, kGathering, kReady };
+
+  struct EagerLayer {
+    std::vector<size_t> param_indices;
+    std::vector<std::shared_ptr<ProcessGroup::Task>> tasks;
+    std::vector<phi::DenseTensor> buffers;
+    LayerState state{LayerState::kReleased};
+    // the number of params whose grads are not accumulated in the backward
+    size_t pending_grads{0};
+  };
+
+  void Gather(size_t layer);
+  void WaitGathered(size_t layer);
+  void Release(size_t layer);
+  phi::DenseTensor AcquireBuffer(phi::DataType dtype, int64_t numel);
+  void OnGradReady(size_t layer);
+
+  std::vector<Tensor> params_;
+  std::vector<Tensor> shards_;
+  std::vector<EagerLayer> layers_;
+  std::shared_ptr<distributed::ProcessGroup> process_group_;
+  int prefetch_layers_;
+  int64_t nranks_;
+  platform::Place place_;
+
+  // the released buffers by dtype and numel
+  std::map<std::pair<phi::DataType, int64_t>, std::vector<phi::DenseTensor>>
+      free_buffers_;
+  // the grad hooks may run on the threads of the backward
+  std::mutex mutex_;
+};
+
+}  //  namespace distributed
+}  //  namespace paddle
@@ -29,6 +29,7 @@
 #include "paddle/phi/core/distributed/utils.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/phi/core/flags.h"
+#include "paddle/phi/core/kernel_factory.h"
 #include "paddle/phi/core/utils/data_type.h"
 
 PHI_DECLARE_bool(benchmark);
@@ -233,6 +234,11 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::AllReduce(
     bool use_calc_stream) {
   auto tensor_tmp =
       paddle::experimental::CheckAndTrans2NewContiguousTensor(in_tensor);
+  const bool hierarchical = local_size_ > 1 && local_size_ < size_;
+  const bool compress =
+      compress_dtype_ != phi::DataType::UNDEFINED &&
+      tensor_tmp.dtype() == phi::DataType::FLOAT32 &&
+      (opts.reduce_op == ReduceOp::SUM || opts.reduce_op == ReduceOp::AVG);
   return Collective(
       [&](phi::distributed::NCCLCommContext* comm_context, gpuStream_t stream) {
         VLOG(3) << "[ncclAllReduce] "
@@ -246,10 +252,25 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::AllReduce(
                 << ", stream: " << stream << ", rank_in_group: " << rank_
                 << ", nranks: " << size_ << ", sync_op: " << sync_op
                 << ", use_calc_stream: " << use_calc_stream
-                << GetGroupMessage();
+                << ", hierarchical: " << hierarchical
+                << ", compress: " << compress << GetGroupMessage();
 
-        comm_context->AllReduce(
-            out_tensor, tensor_tmp, ToNCCLRedType(opts.reduce_op), stream);
+        if (!hierarchical && !compress) {
+          comm_context->AllReduce(
+              out_tensor, tensor_tmp, ToNCCLRedType(opts.reduce_op), stream);
+          return;
+        }
+        auto* ctx = static_cast<phi::GPUContext*>(
+            GetDeviceContext(tensor_tmp.place(), use_calc_stream));
+        std::string buffer_key = GetKeyFromPlace(tensor_tmp.place()) +
+                                 (use_calc_stream ? "/calc" : "/comm");
+        AllReduceWithAlgorithm(comm_context,
+                               ctx,
+                               buffer_key,
+                               tensor_tmp,
+                               ToNCCLRedType(opts.reduce_op),
+                               compress,
+                               out_tensor);
       },
       tensor_tmp,
       CommType::ALLREDUCE,
@@ -257,6 +278,157 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::AllReduce(
       use_calc_stream);
 }
 
+void ProcessGroupNCCL::SetAllReduceAlgorithm(int local_size,
+                                             phi::DataType compress_dtype) {
+  PADDLE_ENFORCE_EQ(
+      local_size >= 1 && size_ % local_size == 0,
+      true,
+      phi::errors::InvalidArgument(
+          "The local_size (%d) of the hierarchical allreduce should divide "
+          "the size (%d) of the group.",
+          local_size,
+          size_));
+  PADDLE_ENFORCE_EQ(compress_dtype == phi::DataType::UNDEFINED ||
+                        compress_dtype == phi::DataType::FLOAT16 ||
+                        compress_dtype == phi::DataType::BFLOAT16,
+                    true,
+                    phi::errors::InvalidArgument(
+                        "The allreduce can only be compressed to FLOAT16 or "
+                        "BFLOAT16, but got %s.",
+                        compress_dtype));
+  local_size_ = local_size;
+  compress_dtype_ = compress_dtype;
+}
+
+bool ProcessGroupNCCL::SplitCommContext(int gid, int rank, int size) {
+  const auto place = phi::GPUPlace(phi::backends::gpu::GetCurrentDeviceId());
+  const auto& key = GetKeyFromPlace(place);
+  platform::CUDADeviceGuard cuda_guard(place);
+
+  std::string store_key;
+  GetStoreKey(key, CommType::ALLREDUCE, &store_key);
+  if (place_to_comm_ctx_.find(key) == place_to_comm_ctx_.end()) {
+    CreateNCCLEnvCache(place, key, store_key, CommType::ALLREDUCE);
+  }
+  // The same key as GetStoreKey of the collectives of the new group.
+  return phi::distributed::CommContextManager::SplitNCCLCommContext(
+      store_key, "nccl_ids/" + std::to_string(gid) + "/0", rank, size);
+}
+
+static void CastTensor(const phi::GPUContext& ctx,
+                       const phi::DenseTensor& in_tensor,
+                       phi::DataType dtype,
+                       phi::DenseTensor* out_tensor) {
+  auto kernel_result = phi::KernelFactory::Instance().SelectKernelOrThrowError(
+      "cast",
+      phi::KernelKey(
+          phi::Backend::GPU, phi::DataLayout::ALL_LAYOUT, in_tensor.dtype()));
+  using kernel_signature = void (*)(const phi::DeviceContext&,
+                                    const phi::DenseTensor&,
+                                    phi::DataType,
+                                    phi::DenseTensor*);
+  auto* kernel_fn =
+      kernel_result.kernel.GetVariadicKernelFn<kernel_signature>();
+  (*kernel_fn)(ctx, in_tensor, dtype, out_tensor);
+}
+
+void ProcessGroupNCCL::AllReduceWithAlgorithm(
+    phi::distributed::NCCLCommContext* comm_context,
+    phi::GPUContext* ctx,
+    const std::string& buffer_key,
+    const phi::DenseTensor& in_tensor,
+    ncclRedOp_t reduce_type,
+    bool compress,
+    phi::DenseTensor* out_tensor) {
+  const int64_t numel = in_tensor.numel();
+  const bool hierarchical = local_size_ > 1 && local_size_ < size_;
+  const int64_t chunks = hierarchical ? local_size_ : 1;
+  const int64_t padded_numel = (numel + chunks - 1) / chunks * chunks;
+  const auto& place = in_tensor.place();
+
+  // the flat tensor being reduced, a copy if compressed or padded
+  phi::DenseTensor flat_in = in_tensor;
+  flat_in.Resize({numel});
+  phi::DenseTensor flat_out = *out_tensor;
+  flat_out.Resize({numel});
+  phi::DenseTensor* buffer = &flat_out;
+  if (compress || padded_numel != numel) {
+    buffer = &allreduce_buffers_[buffer_key];
+    const phi::DataType dtype = compress ? compress_dtype_ : in_tensor.dtype();
+    buffer->Resize({padded_numel});
+    ctx->Alloc(buffer, dtype);
+    phi::DenseTensor head = buffer->Slice(0, numel);
+    if (compress) {
+      CastTensor(*ctx, flat_in, dtype, &head);
+    } else {
+      phi::memory_utils::Copy(place,
+                              head.data(),
+                              place,
+                              flat_in.data(),
+                              numel * phi::SizeOf(dtype),
+                              ctx->stream());
+    }
+    if (padded_numel != numel) {
+      void* tail = static_cast<char*>(buffer->data()) +
+                   numel * phi::SizeOf(dtype);
+      size_t tail_size = (padded_numel - numel) * phi::SizeOf(dtype);
+#ifdef PADDLE_WITH_HIP
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          hipMemsetAsync(tail, 0, tail_size, ctx->stream()));
+#else
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaMemsetAsync(tail, 0, tail_size, ctx->stream()));
+#endif
+    }
+    flat_in = *buffer;
+  }
+
+  if (!hierarchical) {
+    comm_context->AllReduce(buffer, flat_in, reduce_type, ctx->stream());
+  } else {
+    // the sub communicators of the nodes and across the nodes are created by
+    // the first hierarchical allreduce of all the ranks
+    const int node = rank_ / local_size_;
+    const int local_rank = rank_ % local_size_;
+    const std::string prefix = "nccl_ids/" + std::to_string(gid_);
+    const std::string intra_key = prefix + "/intra_" + std::to_string(node);
+    const std::string inter_key =
+        prefix + "/inter_" + std::to_string(local_rank);
+    phi::distributed::CommContextManager::CreateNCCLCommContext(
+        store_, intra_key, local_rank, local_size_);
+    phi::distributed::CommContextManager::CreateNCCLCommContext(
+        store_, inter_key, node, size_ / local_size_);
+    auto& comm_context_manager =
+        phi::distributed::CommContextManager::GetInstance();
+    auto* intra_comm = static_cast<phi::distributed::NCCLCommContext*>(
+        comm_context_manager.Get(intra_key));
+    auto* inter_comm = static_cast<phi::distributed::NCCLCommContext*>(
+        comm_context_manager.Get(inter_key));
+
+    // all in place on the shard of the local rank
+    const int64_t shard_numel = padded_numel / local_size_;
+    phi::DenseTensor shard =
+        buffer->Slice(local_rank * shard_numel, (local_rank + 1) * shard_numel);
+    intra_comm->ReduceScatter(&shard, flat_in, reduce_type, ctx->stream());
+    inter_comm->AllReduce(&shard, shard, reduce_type, ctx->stream());
+    intra_comm->AllGather(buffer, shard, ctx->stream());
+  }
+
+  if (buffer != &flat_out) {
+    phi::DenseTensor head = buffer->Slice(0, numel);
+    if (compress) {
+      CastTensor(*ctx, head, in_tensor.dtype(), &flat_out);
+    } else {
+      phi::memory_utils::Copy(place,
+                              flat_out.data(),
+                              place,
+                              head.data(),
+                              numel * phi::SizeOf(in_tensor.dtype()),
+                              ctx->stream());
+    }
+  }
+}
+
 std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::AllToAll(
     phi::DenseTensor* out_tensor,
     const phi::DenseTensor& in_tensor,
@@ -728,6 +900,9 @@ void ProcessGroupNCCL::CreateNCCLEnvCache(const Place& place,
 
   auto comm_ctx = std::make_unique<phi::GPUContext>(place);
   comm_ctx->set_nccl_comm(nccl_comm_ctx->GetNcclComm());
+  // the allreduce algorithms run the cast kernels on the comm stream
+  comm_ctx->SetAllocator(
+      phi::memory_utils::GetAllocator(place.GetDeviceId(), comm_ctx->stream()));
 
   if (FLAGS_enable_async_trace) {
     // gather global ranks in current group
@@ -849,6 +1024,8 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Collective(
                                                          nccl_stream,
                                                          comm_type,
                                                          pg_timeout_);
+    comm_task->SetBytes(tensor_tmp.numel() *
+                        phi::SizeOf(tensor_tmp.dtype()));
     comm_task->StartRecord();
     fn(nccl_comm_ctx, nccl_stream);
     comm_task->EndRecord();
@@ -964,6 +1141,8 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Point2Point(
   if (!FLAGS_enable_async_trace) {
     fn(nccl_comm_ctx, nccl_stream, p2p_target_rank);
   } else {
+    comm_task->SetBytes(tensor_tmp.numel() *
+                        phi::SizeOf(tensor_tmp.dtype()));
     comm_task->StartRecord();
     fn(nccl_comm_ctx, nccl_stream, p2p_target_rank);
     comm_task->EndRecord();
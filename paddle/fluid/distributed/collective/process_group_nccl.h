@@ -177,6 +177,22 @@ class ProcessGroupNCCL final : public ProcessGroupWithStream {
 
   ncclComm_t NCCLComm(const Place& place) const;
 
+  // Select the allreduce algorithm of the group. With local_size > 1 the
+  // allreduce is hierarchical: a reduce scatter in the nodes of local_size
+  // ranks, an allreduce of the shards across the nodes, and an all gather in
+  // the nodes, so only 1 / local_size of the data crosses the nodes. The
+  // ranks of a node should be consecutive. With compress_dtype FLOAT16 or
+  // BFLOAT16 the FLOAT32 tensors of the SUM and AVG allreduce are sent in it.
+  void SetAllReduceAlgorithm(
+      int local_size, phi::DataType compress_dtype = phi::DataType::UNDEFINED);
+
+  // Derives the communicator of the new group gid by splitting the one of
+  // this group on the current device, so that the group skips the
+  // ncclCommInitRank by the store at its first collective. It is collective
+  // over all the ranks of this group, and rank is -1 for those out of the new
+  // group. Returns false if the NCCL can not split the communicator.
+  bool SplitCommContext(int gid, int rank, int size);
+
  private:
   std::shared_ptr<ProcessGroupNCCL::NCCLTask> CreateTask(const Place& place,
                                                          int rank,
@@ -216,6 +232,14 @@ class ProcessGroupNCCL final : public ProcessGroupWithStream {
   phi::distributed::NCCLCommContext* GetCommContext(
       const std::string* key = nullptr);
 
+  void AllReduceWithAlgorithm(phi::distributed::NCCLCommContext* comm_context,
+                              phi::GPUContext* ctx,
+                              const std::string& buffer_key,
+                              const phi::DenseTensor& in_tensor,
+                              ncclRedOp_t reduce_type,
+                              bool compress,
+                              phi::DenseTensor* out_tensor);
+
   void EraseTensorHolders() {
     for (const auto& allocation_stream : allocation_stream_pairs) {
       auto holder_ptr = allocation_stream.first.lock();
@@ -251,6 +275,12 @@ class ProcessGroupNCCL final : public ProcessGroupWithStream {
   // optimize memory for process_group
   std::vector<std::pair<std::weak_ptr<phi::Allocation>, gpuStream_t>>
       allocation_stream_pairs;
+
+  // the allreduce algorithm, see SetAllReduceAlgorithm
+  int local_size_{1};
+  phi::DataType compress_dtype_{phi::DataType::UNDEFINED};
+  // the padded or compressed copies of the allreduce, used on a single stream
+  std::unordered_map<std::string, phi::DenseTensor> allreduce_buffers_;
 };
 
 }  //  namespace distributed
@@ -20,6 +20,7 @@
 
 PD_DECLARE_bool(use_stream_safe_cuda_allocator);
 PHI_DECLARE_string(allocator_strategy);
+PHI_DECLARE_bool(eager_reducer_adaptive_groups);
 
 namespace paddle {
 namespace distributed {
@@ -367,7 +368,29 @@ void SplitTensorsWithType<platform::XPUDeviceContext>(
 }
 #endif
 
+bool EagerGroup::IsBucketView() const {
+  if (!dense_contents_.initialized()) return false;
+  const auto *contents = static_cast<const char *>(
+      std::dynamic_pointer_cast<phi::DenseTensor>(dense_contents_.impl())
+          ->data());
+  const size_t elem_size = phi::SizeOf(dtype_);
+  int64_t offset = 0;
+  for (size_t i = 0; i < dense_tensors_.size(); ++i) {
+    const auto &tensor = dense_tensors_[i];
+    if (!tensor.initialized() ||
+        tensor.data() != contents + offset * elem_size) {
+      return false;
+    }
+    offset += length_[i];
+  }
+  return true;
+}
+
 void EagerGroup::ConcatTensors(const platform::Place &place) {
+  if (keep_contents_ && IsBucketView()) {
+    VLOG(3) << "The grads are already in the fused buffer, skip concat.";
+    return;
+  }
   dense_contents_ =
       paddle::experimental::empty(IntArray({all_length_}), dtype_, place);
 
@@ -486,6 +509,7 @@ EagerReducer::EagerReducer(
   VLOG(3) << "Start construct the Reducer ...";
 
   nranks_ = process_group_->GetSize();
+  has_rebuilt_group_ = !FLAGS_eager_reducer_adaptive_groups;
 
   // initialize groups
   InitializeGroups(group_indices);
@@ -561,6 +585,7 @@ void EagerReducer::InitializeGroups(
     } else {
       // process the dense gradient.
       InitializeDenseGroups(tensor_indices_, &group);
+      group.keep_contents_ = FLAGS_eager_reducer_adaptive_groups;
     }
 
     // map tensors to this group by VariableLocator
@@ -818,6 +843,10 @@ void EagerReducer::MarkVarReady(const size_t var_index,
                       platform::errors::PreconditionNotMet(error_info));
   } else {
     vars_marked_ready_[var_index] = true;
+    // record the order the grads are ready in for rebuilding the groups
+    if (NeedRebuildGroup()) {
+      rebuild_var_indices_.push_back(var_index);
+    }
   }
   groups_need_finalize_ = true;
 
@@ -1046,7 +1075,9 @@ void EagerReducer::FinalizeBackward() {
   for (auto &group : groups_) {
     if (!group.is_sparse_) {
       group.task->Synchronize();
-      if (!IsStreamSafeAllocator()) {
+      if (group.keep_contents_) {
+        SetGradsAsBucketViews(&group);
+      } else if (!IsStreamSafeAllocator()) {
         auto *default_ctx =
             platform::DeviceContextPool::Instance().Get(inner_place_);
         group.SplitTensors(*default_ctx);
@@ -1061,9 +1092,82 @@ void EagerReducer::FinalizeBackward() {
     VLOG(3) << "ProcessUnusedDenseVars is finished.";
   }
 
+  if (NeedRebuildGroup()) {
+    VLOG(3) << "Start rebuilding the groups";
+    RebuildGroups();
+  }
+
   VLOG(3) << "In the batch, Reducer is finished.";
 }
 
+void EagerReducer::SetGradsAsBucketViews(EagerGroup *group) {
+  // the split is replaced by sharing the slices of the fused buffer, the grads
+  // accumulated in place in the next step are in the buffer already
+  auto *contents =
+      std::dynamic_pointer_cast<phi::DenseTensor>(group->dense_contents_.impl())
+          .get();
+  int64_t offset = 0;
+  for (size_t i = 0; i < group->tensor_indices_.size(); ++i) {
+    const auto var_index = group->tensor_indices_[i];
+    const auto length = group->length_[i];
+    auto &group_tensor = group->dense_tensors_[i];
+    group_tensor.ShareDataWith(contents->Slice(offset, offset + length));
+    offset += length;
+
+    if (!HasGrad(var_index)) continue;
+    auto grad_tensor = egr::EagerUtils::mutable_grad(tensors_[var_index]);
+    if (!grad_tensor->is_dense_tensor()) continue;
+    auto grad_view = std::make_shared<phi::DenseTensor>(group_tensor);
+    grad_view->Resize(common::make_ddim(group->origin_shapes_[i].GetData()));
+    grad_tensor->set_impl(grad_view);
+  }
+}
+
+void EagerReducer::RebuildGroups() {
+  has_rebuilt_group_ = true;
+  VLOG(3) << "The order of parameter arrival: "
+          << string::join_strings(rebuild_var_indices_, ',');
+
+  // the groups must be the same on all the ranks, so the ones of rank 0 are
+  // used, the order is padded with -1 if some grads are not ready
+  std::vector<int64_t> order(tensors_.size(), -1);
+  for (size_t i = 0; i < rebuild_var_indices_.size() && i < order.size();
+       ++i) {
+    order[i] = static_cast<int64_t>(rebuild_var_indices_[i]);
+  }
+  rebuild_var_indices_.clear();
+  if (nranks_ > 1) {
+    const auto *dev_ctx =
+        platform::DeviceContextPool::Instance().Get(inner_place_);
+    phi::DenseTensor order_tensor;
+    framework::TensorFromVector<int64_t>(order, *dev_ctx, &order_tensor);
+    distributed::BroadcastOptions opts;
+    opts.source_rank = 0;
+    process_group_->Broadcast(&order_tensor, order_tensor, opts, true)
+        ->Synchronize();
+    framework::TensorToVector<int64_t>(order_tensor, *dev_ctx, &order);
+    dev_ctx->Wait();
+  }
+
+  std::vector<bool> seen(tensors_.size(), false);
+  for (const auto var_index : order) {
+    if (var_index < 0 || var_index >= static_cast<int64_t>(seen.size()) ||
+        seen[var_index]) {
+      VLOG(3) << "Not all the grads are ready once, keep the groups.";
+      return;
+    }
+    seen[var_index] = true;
+  }
+  // like the initial groups, the small first group limit goes to the grads
+  // ready last
+  std::reverse(order.begin(), order.end());
+  auto group_indices = Eager_AssignGroupBySize(
+      tensors_, is_sparse_gradient_, group_size_limits_, order);
+  std::reverse(group_indices.begin(), group_indices.end());
+  group_indices_ = std::move(group_indices);
+  InitializeGroups(group_indices_);
+}
+
 void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
                                           const int curr_group_index) {
   // The overall timeline: concat > div_nranks > allreduce > split
@@ -1090,7 +1194,7 @@ void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
 
   auto *context = process_group_->GetDeviceContext(inner_place_);
 
-  if (IsStreamSafeAllocator()) {
+  if (IsStreamSafeAllocator() && !group->keep_contents_) {
     // NOTE(shenliang03): The best_fit allocator strategy is multi-stream
     // insecure. In the Split operator, additional memory will be applied for
     // calculation, and if it is asynchronous, an illegal memory access may be
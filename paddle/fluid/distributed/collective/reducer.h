@@ -69,6 +69,12 @@ class EagerGroup {
   // help to sync
   std::shared_ptr<ProcessGroup::Task> task;
 
+  // the grads are kept as the views of dense_contents_ after the allreduce
+  bool keep_contents_ = false;
+
+  // whether the dense tensors are the views of dense_contents_ in order
+  bool IsBucketView() const;
+
   // context is used to select the stream for concat
   void ConcatTensors(const platform::Place &);
 
@@ -112,6 +118,12 @@ class EagerReducer {
   void TraverseBackwardGraph(const std::vector<Tensor> &outputs);
   void ProcessUnusedDenseVars();
   bool HasGrad(size_t var_index);
+  void SetGradsAsBucketViews(EagerGroup *group);
+  void RebuildGroups();
+
+  inline bool NeedRebuildGroup() {
+    return !has_rebuilt_group_ && !find_unused_vars_each_step_;
+  }
 
  private:
   std::vector<Tensor> tensors_;
@@ -139,6 +151,10 @@ class EagerReducer {
   bool find_unused_vars_once_{true};
   bool groups_need_finalize_{false};
   Tensor global_used_vars_;
+
+  // Following variables are to help rebuild group
+  bool has_rebuilt_group_{true};
+  std::vector<size_t> rebuild_var_indices_;
 };
 
 }  //  namespace distributed
@@ -241,7 +241,8 @@ bool Carrier::Send(const InterceptorMessage& msg) {
   if (src_rank == dst_rank) {
     VLOG(3) << "Send a message from interceptor " << src_id
             << " to interceptor " << dst_id << ", which are in the same ranks.";
-    return EnqueueInterceptorMessage(msg);
+    GetInterceptor(dst_id)->EnqueueLocalInterceptorMessage(msg);
+    return true;
   }
   VLOG(3) << "Send a message from interceptor " << src_id << " to interceptor "
           << dst_id << ", which are in different ranks.";
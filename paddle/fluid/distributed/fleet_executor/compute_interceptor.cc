@@ -19,6 +19,7 @@
 #include "paddle/fluid/distributed/fleet_executor/task_node.h"
 #include "paddle/fluid/framework/executor_gc_helper.h"
 #include "paddle/fluid/framework/operator.h"
+#include "paddle/fluid/memory/allocation/lifetime_pool_allocator.h"
 #include "paddle/fluid/jit/serializer.h"
 
 namespace paddle {
@@ -303,6 +304,12 @@ void ComputeInterceptor::RunOps() {
                           cur_scope_id_));
   }
 
+  // The nodes run once in several micro-batches, e.g. the optimizer through
+  // the amplifier, allocate for the step.
+  memory::allocation::AllocationLifetimeGuard lifetime_guard(
+      node_->run_per_steps() > 1
+          ? memory::allocation::AllocationLifetime::kStep
+          : memory::allocation::AllocationLifetime::kMicroBatch);
   if (!cores_.empty()) {
     cores_[cur_scope_id_]->Run(/*feed_names=*/{}, /*need_fetch=*/false);
   } else {
@@ -22,6 +22,8 @@
 #include "paddle/fluid/distributed/fleet_executor/task_node.h"
 #include "paddle/fluid/framework/block_desc.h"
 #include "paddle/fluid/framework/feed_fetch_method.h"
+#include "paddle/fluid/framework/ir/graph.h"
+#include "paddle/fluid/framework/ir/pass.h"
 #include "paddle/fluid/framework/naive_executor.h"
 #include "paddle/fluid/framework/op_proto_maker.h"
 #include "paddle/fluid/framework/program_desc.h"
@@ -202,6 +204,10 @@ bool DistModel::Init() {
     program_.reset(config_.program_desc);
     scope_.reset(config_.scope);
   }
+  if (config_.comm_overlap_chunks > 0 && config_.place == "GPU" &&
+      !ApplyCommOverlap()) {
+    return false;
+  }
   if (!PrepareFeedAndFetch()) {
     return false;
   }
@@ -214,6 +220,26 @@ bool DistModel::Init() {
   return true;
 }
 
+bool DistModel::ApplyCommOverlap() {
+  VLOG(3) << "Overlap the allreduce with the matmul in "
+          << config_.comm_overlap_chunks << " chunks.";
+  framework::ir::Graph graph(*program_);
+  auto fuse_pass = framework::ir::PassRegistry::Instance().Get(
+      "matmul_allreduce_fuse_pass");
+  fuse_pass->Set("num_chunks", new int(config_.comm_overlap_chunks));
+  fuse_pass->Apply(&graph);
+
+  auto to_program_pass =
+      framework::ir::PassRegistry::Instance().Get("graph_to_program_pass");
+  framework::ProgramDesc desc;
+  desc.CopyFrom(*program_->Proto());
+  to_program_pass->SetNotOwned("program", &desc);
+  to_program_pass->Apply(&graph);
+  // the program may be owned by the caller, so it is updated in place
+  program_->CopyFrom(*desc.Proto());
+  return true;
+}
+
 bool DistModel::PreparePlace() {
   if (config_.place == "GPU") {
     place_ = paddle::platform::CUDAPlace(config_.device_id);
@@ -707,3 +733,6 @@ bool DistModel::Run(const std::vector<DistModelTensor> &input_data,
 
 }  // namespace distributed
 }  // namespace paddle
+
+USE_PASS(matmul_allreduce_fuse_pass);
+USE_PASS(graph_to_program_pass);
@@ -50,6 +50,9 @@ struct DistModelConfig {
   int64_t nranks{1};
   int64_t local_rank{0};
   bool enable_timer{false};
+  // the number of chunks of the matmuls overlapping with the allreduce, 0
+  // disables the overlap
+  int comm_overlap_chunks{0};
   std::map<int64_t, std::vector<int64_t>> ring_id_to_ranks_{};
   std::map<int64_t, std::vector<int64_t>> rank_to_ring_ids_{};
 };
@@ -67,6 +70,7 @@ class DistModel {
 
   bool PrepareScope();
   bool PrepareProgram();
+  bool ApplyCommOverlap();
   bool LoadProgram();
   bool LoadParameters();
   bool PreparePlace();
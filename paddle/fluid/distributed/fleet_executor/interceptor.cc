@@ -86,6 +86,24 @@ void Interceptor::EnqueueRemoteInterceptorMessage(
   }
 }
 
+void Interceptor::EnqueueLocalInterceptorMessage(
+    const InterceptorMessage& message) {
+  if (TaskLoop::GetTaskLoopOfCurrentThread() == nullptr) {
+    EnqueueRemoteInterceptorMessage(message);
+    return;
+  }
+  VLOG(3) << "Enqueue message: " << message.message_type() << " into "
+          << interceptor_id_ << "'s task loop.";
+  // the messages of a source interceptor are sent in its loop, so they keep
+  // their order
+  loop_->QueueInLoop([this, message]() {
+    VLOG(3) << "Interceptor " << interceptor_id_ << " has received a message"
+            << " from interceptor " << message.src_id()
+            << " with message: " << message.message_type() << ".";
+    Handle(message);
+  });
+}
+
 bool Interceptor::Send(int64_t dst_id, InterceptorMessage& msg) {
   PADDLE_ENFORCE_NOT_NULL(
       carrier_,
@@ -71,6 +71,12 @@ class Interceptor {
   void EnqueueRemoteInterceptorMessage(
       const InterceptorMessage& interceptor_message);
 
+  // Called by Carrier in a task loop, hand an InterceptorMessage from an
+  // interceptor of the same carrier to the loop of this one, which takes no
+  // lock if the loops are of the same pool
+  void EnqueueLocalInterceptorMessage(
+      const InterceptorMessage& interceptor_message);
+
   bool Send(int64_t dst_id, InterceptorMessage& msg);  // NOLINT
 
   void SetPlace(const platform::Place& place) { place_ = place; }
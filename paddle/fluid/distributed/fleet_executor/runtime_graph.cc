@@ -14,7 +14,10 @@
 
 #include "paddle/fluid/distributed/fleet_executor/runtime_graph.h"
 
+#include <algorithm>
+
 #include "paddle/fluid/distributed/fleet_executor/task_node.h"
+#include "paddle/fluid/platform/enforce.h"
 
 namespace paddle {
 namespace distributed {
@@ -29,5 +32,118 @@ std::string RuntimeGraph::DebugString() const {
   return os.str();
 }
 
+int64_t RuntimeGraph::PipelineTasksPerRank(PipelineSchedule schedule,
+                                           int64_t num_chunks) {
+  int64_t chunk_tasks = schedule == PipelineSchedule::kZeroBubble ? 3 : 2;
+  return 2 + chunk_tasks * num_chunks;
+}
+
+void RuntimeGraph::BuildPipelineSchedule(PipelineSchedule schedule,
+                                         const std::vector<int64_t>& pp_ranks,
+                                         int64_t pp_idx,
+                                         int64_t num_micro_batches,
+                                         PipelineStageTasks* tasks) {
+  const int64_t pp_degree = static_cast<int64_t>(pp_ranks.size());
+  const int64_t num_chunks = static_cast<int64_t>(tasks->fwd.size());
+  const bool zero_bubble = schedule == PipelineSchedule::kZeroBubble;
+  PADDLE_ENFORCE_EQ(
+      pp_idx >= 0 && pp_idx < pp_degree,
+      true,
+      platform::errors::InvalidArgument(
+          "The pp_idx (%d) should be in [0, %d).", pp_idx, pp_degree));
+  const int64_t num_bwd_weight = zero_bubble ? num_chunks : 0;
+  PADDLE_ENFORCE_EQ(
+      num_chunks >= 1 &&
+          static_cast<int64_t>(tasks->bwd.size()) == num_chunks &&
+          static_cast<int64_t>(tasks->bwd_weight.size()) == num_bwd_weight,
+      true,
+      platform::errors::InvalidArgument(
+          "The stage should have a fwd and a bwd task for each of its chunks, "
+          "and a bwd_weight task for each chunk only in the zero bubble "
+          "schedule."));
+  PADDLE_ENFORCE_EQ(
+      schedule == PipelineSchedule::kInterleaved1F1B || num_chunks == 1,
+      true,
+      platform::errors::InvalidArgument(
+          "Only the interleaved 1F1B schedule runs several chunks on a "
+          "stage, but got %d chunks.",
+          num_chunks));
+  PADDLE_ENFORCE_EQ(tasks->lr != nullptr && tasks->opt != nullptr,
+                    true,
+                    platform::errors::InvalidArgument(
+                        "The stage should have the lr and the opt task."));
+
+  const int64_t tasks_per_rank = PipelineTasksPerRank(schedule, num_chunks);
+  auto TaskId = [&](int64_t stage, int64_t offset) {
+    return pp_ranks[stage] * tasks_per_rank + offset;
+  };
+  auto FwdId = [&](int64_t stage, int64_t chunk) {
+    return TaskId(stage, 1 + chunk);
+  };
+  auto BwdId = [&](int64_t stage, int64_t chunk) {
+    return TaskId(stage, 1 + num_chunks + chunk);
+  };
+  auto CheckTaskId = [&](TaskNode* task, int64_t task_id) {
+    PADDLE_ENFORCE_EQ(task->task_id(),
+                      task_id,
+                      platform::errors::InvalidArgument(
+                          "The task id of the pipeline task should be %d, "
+                          "but got %d.",
+                          task_id,
+                          task->task_id()));
+  };
+  CheckTaskId(tasks->lr, TaskId(pp_idx, 0));
+  CheckTaskId(tasks->opt, TaskId(pp_idx, tasks_per_rank - 1));
+
+  // the buffer size of the edges of the lr, the opt and across the stages
+  constexpr int64_t kBuffSize = 2;
+  const int64_t num_virtual_stages = num_chunks * pp_degree;
+  for (int64_t chunk = 0; chunk < num_chunks; ++chunk) {
+    TaskNode* fwd = tasks->fwd[chunk];
+    TaskNode* bwd = tasks->bwd[chunk];
+    CheckTaskId(fwd, FwdId(pp_idx, chunk));
+    CheckTaskId(bwd, BwdId(pp_idx, chunk));
+    const int64_t virtual_stage = chunk * pp_degree + pp_idx;
+    // the activations kept by the virtual stage, the forwards run ahead of
+    // the backwards by the depth of the pipeline after it
+    const int64_t in_flight =
+        std::min(num_micro_batches, num_virtual_stages - virtual_stage);
+
+    tasks->lr->AddDownstreamTask(fwd->task_id(), kBuffSize);
+    fwd->AddUpstreamTask(tasks->lr->task_id(), kBuffSize);
+    fwd->AddDownstreamTask(bwd->task_id(), in_flight);
+    bwd->AddUpstreamTask(fwd->task_id(), in_flight);
+    TaskNode* last = bwd;
+    if (zero_bubble) {
+      // the weight grads are deferred up to the warmup depth of the stage,
+      // to fill the bubbles of the input grads in the critical path
+      TaskNode* bwd_weight = tasks->bwd_weight[chunk];
+      CheckTaskId(bwd_weight, TaskId(pp_idx, 1 + 2 * num_chunks + chunk));
+      const int64_t deferred =
+          std::min(num_micro_batches, pp_degree - pp_idx);
+      bwd->AddDownstreamTask(bwd_weight->task_id(), deferred);
+      bwd_weight->AddUpstreamTask(bwd->task_id(), deferred);
+      last = bwd_weight;
+    }
+    last->AddDownstreamTask(tasks->opt->task_id(), kBuffSize);
+    tasks->opt->AddUpstreamTask(last->task_id(), kBuffSize);
+
+    // the virtual stage before runs on the stage before, or on the last
+    // stage with the chunk before
+    if (virtual_stage > 0) {
+      int64_t prev_stage = pp_idx > 0 ? pp_idx - 1 : pp_degree - 1;
+      int64_t prev_chunk = pp_idx > 0 ? chunk : chunk - 1;
+      fwd->AddUpstreamTask(FwdId(prev_stage, prev_chunk), kBuffSize);
+      bwd->AddDownstreamTask(BwdId(prev_stage, prev_chunk), kBuffSize);
+    }
+    if (virtual_stage + 1 < num_virtual_stages) {
+      int64_t next_stage = pp_idx + 1 < pp_degree ? pp_idx + 1 : 0;
+      int64_t next_chunk = pp_idx + 1 < pp_degree ? chunk : chunk + 1;
+      fwd->AddDownstreamTask(FwdId(next_stage, next_chunk), kBuffSize);
+      bwd->AddUpstreamTask(BwdId(next_stage, next_chunk), kBuffSize);
+    }
+  }
+}
+
 }  // namespace distributed
 }  // namespace paddle
@@ -26,6 +26,20 @@ namespace paddle {
 namespace distributed {
 class TaskNode;
 
+enum class PipelineSchedule { k1F1B, kInterleaved1F1B, kZeroBubble };
+
+// The task nodes of a pipeline stage: the lr, the forward and the backward
+// of each model chunk, and the optimizer. The zero bubble schedule splits the
+// backward of a chunk into the input grad (bwd) and the weight grad
+// (bwd_weight) tasks.
+struct PipelineStageTasks {
+  TaskNode* lr{nullptr};
+  std::vector<TaskNode*> fwd;
+  std::vector<TaskNode*> bwd;
+  std::vector<TaskNode*> bwd_weight;
+  TaskNode* opt{nullptr};
+};
+
 class RuntimeGraph final {
  public:
   RuntimeGraph() = default;
@@ -46,6 +60,20 @@ class RuntimeGraph final {
   }
   std::string DebugString() const;
 
+  // The tasks of a rank in a pipeline schedule, the task ids of the rank are
+  // rank * PipelineTasksPerRank() + [lr, fwd..., bwd..., bwd_weight..., opt].
+  static int64_t PipelineTasksPerRank(PipelineSchedule schedule,
+                                      int64_t num_chunks);
+  // Links the tasks of the stage pp_idx of a pipeline, whose stages run on
+  // pp_ranks. The chunk c of the stage pp_idx is the virtual stage
+  // c * pp_ranks.size() + pp_idx, the micro batches in flight of a virtual
+  // stage are bounded by the number of the virtual stages after it.
+  static void BuildPipelineSchedule(PipelineSchedule schedule,
+                                    const std::vector<int64_t>& pp_ranks,
+                                    int64_t pp_idx,
+                                    int64_t num_micro_batches,
+                                    PipelineStageTasks* tasks);
+
  private:
   DISABLE_COPY_AND_ASSIGN(RuntimeGraph);
   std::unordered_map<int64_t, TaskNode*> interceptor_id_to_node_;
@@ -0,0 +1,109 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include "paddle/fluid/platform/macros.h"
+
+namespace paddle {
+namespace distributed {
+
+// A lock-free unbounded queue for a single producer thread and a single
+// consumer thread. The items are kept in a chain of fixed size blocks, the
+// producer fills the tail block and links a new one when it is full, and the
+// consumer frees a block once it has read all of it. So Push never blocks or
+// fails, and the items keep the order they are pushed in.
+template <typename T, size_t BlockSize = 256>
+class SPSCQueue {
+ public:
+  SPSCQueue() : head_(new Block()), tail_(head_) {}
+
+  ~SPSCQueue() {
+    while (head_ != nullptr) {
+      Block* next = head_->next.load(std::memory_order_relaxed);
+      delete head_;
+      head_ = next;
+    }
+  }
+
+  // only called by the producer thread
+  void Push(T&& item) {
+    Block* block = tail_;
+    size_t write = block->write.load(std::memory_order_relaxed);
+    if (write == BlockSize) {
+      block = new Block();
+      write = 0;
+    }
+    block->items[write] = std::move(item);
+    block->write.store(write + 1, std::memory_order_release);
+    if (block != tail_) {
+      // the consumer only moves to the new block after the item is visible
+      tail_->next.store(block, std::memory_order_release);
+      tail_ = block;
+    }
+  }
+
+  // only called by the consumer thread
+  bool Pop(T* item) {
+    while (true) {
+      Block* block = head_;
+      if (block->read < block->write.load(std::memory_order_acquire)) {
+        *item = std::move(block->items[block->read]);
+        ++block->read;
+        return true;
+      }
+      if (block->read < BlockSize) return false;
+      Block* next = block->next.load(std::memory_order_acquire);
+      if (next == nullptr) return false;
+      // the producer has moved to the next block, so this one is not used
+      head_ = next;
+      delete block;
+    }
+  }
+
+  // only called by the consumer thread
+  bool Empty() const {
+    Block* block = head_;
+    if (block->read < block->write.load(std::memory_order_acquire)) {
+      return false;
+    }
+    if (block->read < BlockSize) return true;
+    // a linked block always has an item
+    return block->next.load(std::memory_order_acquire) == nullptr;
+  }
+
+ private:
+  DISABLE_COPY_AND_ASSIGN(SPSCQueue);
+
+  struct Block {
+    std::array<T, BlockSize> items;
+    // the producer and the consumer indices are kept on different lines
+    alignas(64) std::atomic<size_t> write{0};
+    alignas(64) size_t read{0};
+    std::atomic<Block*> next{nullptr};
+  };
+
+  // owned by the consumer
+  alignas(64) Block* head_;
+  // owned by the producer
+  alignas(64) Block* tail_;
+};
+
+}  // namespace distributed
+}  // namespace paddle
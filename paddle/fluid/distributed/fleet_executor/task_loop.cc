@@ -46,7 +46,21 @@ void TaskLoop::Loop() {
   quit_ = false;
 
   while (!quit_) {
+    size_t num_run = RunPeerTasks();
+    if (num_run > 0 && num_tasks_.load(std::memory_order_relaxed) == 0) {
+      continue;
+    }
+    if (num_run == 0) {
+      sleeping_.store(true);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (!PeerTasksEmpty()) {
+        sleeping_.store(false);
+        continue;
+      }
+    }
     auto tasks = tasks_.PopAll();
+    sleeping_.store(false);
+    num_tasks_.fetch_sub(tasks.size());
     for (auto& task : tasks) {
       task();
     }
@@ -54,6 +68,54 @@ void TaskLoop::Loop() {
   looping_ = false;
 }
 
+size_t TaskLoop::RunPeerTasks() {
+  size_t num_run = 0;
+  if (peer_queues_ != nullptr) {
+    Functor task;
+    for (int src = 0; src < num_loops_; ++src) {
+      auto& queue = (*peer_queues_)[src * num_loops_ + index_];
+      while (queue->Pop(&task)) {
+        task();
+        ++num_run;
+      }
+    }
+  }
+  std::deque<Functor> local_tasks;
+  local_tasks.swap(local_tasks_);
+  for (auto& task : local_tasks) {
+    task();
+  }
+  return num_run + local_tasks.size();
+}
+
+bool TaskLoop::PeerTasksEmpty() const {
+  if (!local_tasks_.empty()) return false;
+  if (peer_queues_ == nullptr) return true;
+  for (int src = 0; src < num_loops_; ++src) {
+    if (!(*peer_queues_)[src * num_loops_ + index_]->Empty()) return false;
+  }
+  return true;
+}
+
+void TaskLoop::SetPeerQueues(int index, int num_loops, PeerQueues* queues) {
+  AssertInLoopThread();
+  PADDLE_ENFORCE_EQ(
+      looping_,
+      false,
+      platform::errors::PreconditionNotMet(
+          "The peer queues should be set before the loop runs."));
+  PADDLE_ENFORCE_EQ(queues->size(),
+                    static_cast<size_t>(num_loops * num_loops),
+                    platform::errors::InvalidArgument(
+                        "The peer queues of %d loops should be %d, but got %d.",
+                        num_loops,
+                        num_loops * num_loops,
+                        queues->size()));
+  index_ = index;
+  num_loops_ = num_loops;
+  peer_queues_ = queues;
+}
+
 void TaskLoop::Quit() {
   quit_ = true;
   if (!IsInLoopThread()) WakeUp();
@@ -67,7 +129,26 @@ void TaskLoop::RunInLoop(Functor cb) {
   }
 }
 
-void TaskLoop::QueueInLoop(Functor cb) { tasks_.Push(cb); }
+void TaskLoop::QueueInLoop(Functor cb) {
+  TaskLoop* loop = thread_local_loop_;
+  if (loop == this) {
+    local_tasks_.emplace_back(std::move(cb));
+    return;
+  }
+  if (loop != nullptr && IsPeerLoop(loop)) {
+    (*peer_queues_)[loop->index_ * num_loops_ + index_]->Push(std::move(cb));
+    // pairs with the fence in Loop, either the loop sees the callback before
+    // it waits, or the peer sees it waiting
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load() && sleeping_.exchange(false)) {
+      ++num_tasks_;
+      tasks_.Push([] {});
+    }
+    return;
+  }
+  ++num_tasks_;
+  tasks_.Push(std::move(cb));
+}
 
 void TaskLoop::WakeUp() {
   Functor task([] {});
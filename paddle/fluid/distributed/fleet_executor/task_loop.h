@@ -14,23 +14,33 @@
 
 #pragma once
 
+#include <atomic>
+#include <deque>
 #include <functional>
 #include <future>
 #include <map>
+#include <memory>
 #include <thread>
 #include <vector>
 
+#include "paddle/fluid/distributed/fleet_executor/spsc_queue.h"
 #include "paddle/fluid/framework/blocking_queue.h"
 #include "paddle/fluid/platform/macros.h"
 
 namespace paddle {
 namespace distributed {
 
+// The callbacks queued by a thread outside the loop go through the tasks_
+// queue. The loops of a TaskLoopThreadPool also share a SPSCQueue for each
+// pair of them, so the callbacks queued by a peer loop, e.g. the messages
+// between the interceptors of a carrier, take no lock, and the callbacks
+// queued by the loop itself go to a local deque.
 class TaskLoop {
  public:
   static TaskLoop* GetTaskLoopOfCurrentThread();
 
   using Functor = std::function<void()>;
+  using PeerQueues = std::vector<std::unique_ptr<SPSCQueue<Functor>>>;
 
   TaskLoop();
   ~TaskLoop();
@@ -50,12 +60,16 @@ class TaskLoop {
         std::bind(std::forward<F>(f), std::forward<Args>(args)...));
     std::future<return_type> task_future = task->get_future();
 
-    tasks_.Push([task]() { (*task)(); });
+    QueueInLoop([task]() { (*task)(); });
     return task_future;
   }
 
   void WakeUp();
 
+  // called in the loop thread before Loop, the queue from the peer loop i to
+  // the peer loop j is (*queues)[i * num_loops + j]
+  void SetPeerQueues(int index, int num_loops, PeerQueues* queues);
+
   bool IsInLoopThread() const {
     return thread_id_ == std::this_thread::get_id();
   }
@@ -71,6 +85,14 @@ class TaskLoop {
 
   void AbortNotInLoopThread();
 
+  bool IsPeerLoop(const TaskLoop* loop) const {
+    return peer_queues_ != nullptr && loop->peer_queues_ == peer_queues_;
+  }
+  // runs the callbacks of the peer loops and the local ones, returns the
+  // number of them
+  size_t RunPeerTasks();
+  bool PeerTasksEmpty() const;
+
   static thread_local TaskLoop* thread_local_loop_;
 
   bool looping_;
@@ -78,6 +100,15 @@ class TaskLoop {
   std::thread::id thread_id_;
 
   framework::BlockingQueue<Functor> tasks_;
+  // the number of the callbacks pushed to tasks_ but not run
+  std::atomic<size_t> num_tasks_{0};
+
+  int index_{-1};
+  int num_loops_{0};
+  PeerQueues* peer_queues_{nullptr};
+  std::deque<Functor> local_tasks_;
+  // set when the loop waits on tasks_, a peer wakes it up after a push
+  std::atomic<bool> sleeping_{false};
 };
 
 }  // namespace distributed
@@ -45,6 +45,9 @@ TaskLoop* TaskLoopThread::StartLoop() {
 
 void TaskLoopThread::Loop() {
   TaskLoop loop;
+  if (peer_queues_ != nullptr) {
+    loop.SetPeerQueues(index_, num_loops_, peer_queues_);
+  }
   {
     std::unique_lock<std::mutex> lock(mutex_);
     loop_ = &loop;
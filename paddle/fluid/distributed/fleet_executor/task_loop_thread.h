@@ -16,20 +16,30 @@
 
 #include <condition_variable>
 #include <mutex>
+#include <memory>
 #include <thread>
+#include <vector>
 
+#include "paddle/fluid/distributed/fleet_executor/task_loop.h"
 #include "paddle/fluid/platform/macros.h"
 
 namespace paddle {
 namespace distributed {
 
-class TaskLoop;
-
 class TaskLoopThread {
  public:
   TaskLoopThread();
   ~TaskLoopThread();
 
+  // the loop takes the peer queues of a TaskLoopThreadPool, see TaskLoop
+  void SetPeerQueues(int index,
+                     int num_loops,
+                     TaskLoop::PeerQueues* peer_queues) {
+    index_ = index;
+    num_loops_ = num_loops;
+    peer_queues_ = peer_queues;
+  }
+
   TaskLoop* StartLoop();
 
  private:
@@ -39,6 +49,9 @@ class TaskLoopThread {
 
   bool start_;
   TaskLoop* loop_;
+  int index_{-1};
+  int num_loops_{0};
+  TaskLoop::PeerQueues* peer_queues_{nullptr};
   std::thread thread_;
   std::mutex mutex_;
   std::condition_variable cv_;
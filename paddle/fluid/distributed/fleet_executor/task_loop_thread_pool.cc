@@ -41,8 +41,12 @@ void TaskLoopThreadPool::Start() {
           "thread num must greater than 0, but now is %d", thread_num_));
 
   start_ = true;
+  for (int i = 0; i < thread_num_ * thread_num_; ++i) {
+    peer_queues_.emplace_back(new SPSCQueue<TaskLoop::Functor>());
+  }
   for (int i = 0; i < thread_num_; ++i) {
     threads_.emplace_back(new TaskLoopThread());
+    threads_[i]->SetPeerQueues(i, thread_num_, &peer_queues_);
     loops_.push_back(threads_[i]->StartLoop());
   }
 }
@@ -17,12 +17,12 @@
 #include <memory>
 #include <vector>
 
+#include "paddle/fluid/distributed/fleet_executor/task_loop.h"
 #include "paddle/fluid/platform/macros.h"
 
 namespace paddle {
 namespace distributed {
 
-class TaskLoop;
 class TaskLoopThread;
 
 class TaskLoopThreadPool {
@@ -43,6 +43,8 @@ class TaskLoopThreadPool {
 
   bool start_;
   int thread_num_;
+  // outlives the threads, which are joined before it is destroyed
+  TaskLoop::PeerQueues peer_queues_;
   std::vector<std::unique_ptr<TaskLoopThread>> threads_;
   std::vector<TaskLoop*> loops_;
 };
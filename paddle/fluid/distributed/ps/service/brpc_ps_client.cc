@@ -14,16 +14,24 @@
 
 #include "paddle/fluid/distributed/ps/service/brpc_ps_client.h"
 
+#include <algorithm>
 #include <memory>
+#include <numeric>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "paddle/fluid/distributed/ps/service/coordinator_client.h"
+#include "paddle/fluid/distributed/ps/service/sparse_wire_format.h"
 #include "paddle/fluid/framework/archive.h"
 #include "paddle/fluid/string/split.h"
+#include "paddle/phi/core/flags.h"
+#include "paddle/phi/core/metrics.h"
 
 static const int max_port = 65535;
 
+PHI_DECLARE_bool(enable_runtime_metrics);
+
 namespace paddle {
 namespace framework {
 class Scope;
@@ -34,6 +42,23 @@ class Variable;
 namespace paddle {
 namespace distributed {
 
+// The requests and the keys of the pulls and the pushes, whose rates are the
+// QPS of the client.
+static void RecordPsClientMetrics(const std::string &op, size_t num_keys) {
+  if (!FLAGS_enable_runtime_metrics) return;
+  auto &registry = phi::metrics::MetricsRegistry::Instance();
+  registry
+      .GetCounter("paddle_ps_client_requests_total",
+                  "The number of the requests of the ps client.",
+                  {{"op", op}})
+      ->Add();
+  registry
+      .GetCounter("paddle_ps_client_keys_total",
+                  "The number of the keys of the requests of the ps client.",
+                  {{"op", op}})
+      ->Add(num_keys);
+}
+
 PD_DEFINE_int32(pserver_push_dense_merge_limit,
                 12,
                 "limit max push_dense local merge requests");
@@ -78,6 +103,25 @@ PD_DEFINE_int32(pserver_sparse_merge_thread,
                 1,
                 "pserver sparse merge thread num");
 
+PD_DEFINE_bool(pserver_sparse_wire_compress,
+               false,
+               "send the keys of pull/push sparse as varint deltas, and the "
+               "values of push sparse in attachment");
+
+PD_DEFINE_int32(pserver_sparse_push_quant_type,
+                0,
+                "quantize the gradients of push sparse, none:0 fp16:1 int8:2, "
+                "only used with pserver_sparse_wire_compress");
+
+PD_DEFINE_int32(pserver_sparse_push_quant_skip_dim,
+                3,
+                "the leading floats of a push value not quantized, "
+                "slot/show/click of ctr accessors");
+
+PD_DEFINE_bool(pserver_sparse_push_error_feedback,
+               true,
+               "add the quantization error of a feature to its next push");
+
 PD_DEFINE_int32(pserver_sparse_table_shard_num,
                 1000,
                 "sparse table shard for save & load");
@@ -345,6 +389,7 @@ int32_t BrpcPsClient::Initialize() {
       _push_sparse_task_queue_map[table_id] =
           ::paddle::framework::MakeChannel<SparseAsyncTask *>();
       _push_sparse_merge_count_map[table_id] = 0;
+      _push_sparse_residual_map[table_id].resize(_server_channels.size());
     }
   }
 
@@ -849,6 +894,7 @@ std::future<int32_t> BrpcPsClient::PullDense(Region *regions,
                                              size_t region_num,
                                              size_t table_id) {
   auto timer = std::make_shared<CostTimer>("pserver_client_pull_dense");
+  RecordPsClientMetrics("pull_dense", 0);
   auto *accessor = GetTableAccessor(table_id);
   auto fea_dim = accessor->GetAccessorInfo().fea_dim;
   size_t request_call_num = _server_channels.size();
@@ -1141,6 +1187,7 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
                                               size_t num,
                                               bool is_training) {
   auto timer = std::make_shared<CostTimer>("pserver_client_pull_sparse");
+  RecordPsClientMetrics("pull_sparse", num);
   auto local_timer =
       std::make_shared<CostTimer>("pserver_client_pull_sparse_local");
   size_t request_call_num = _server_channels.size();
@@ -1224,15 +1271,16 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
     auto &request_buffer = closure->cntl(i)->request_attachment();
 
     request_buffer.append(reinterpret_cast<void *>(&is_training), sizeof(bool));
+    std::vector<uint64_t> request_keys;
     std::vector<uint32_t> keys_counter;
+    request_keys.reserve(sorted_kv_size);
     keys_counter.reserve(sorted_kv_size);
 
     for (size_t kv_idx = 0; kv_idx < sorted_kv_size; ++kv_idx) {
       ++kv_request_count;
       uint32_t keys = 1;
       last_key = sorted_kvs[kv_idx].first;
-      request_buffer.append(reinterpret_cast<void *>(&last_key),
-                            sizeof(uint64_t));
+      request_keys.push_back(last_key);
       while (kv_idx < sorted_kv_size - 1 &&
              last_key == sorted_kvs[kv_idx + 1].first) {
         ++kv_idx;
@@ -1241,8 +1289,17 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
       keys_counter.push_back(keys);
     }
 
-    request_buffer.append(reinterpret_cast<void *>(keys_counter.data()),
-                          sizeof(uint32_t) * keys_counter.size());
+    if (FLAGS_pserver_sparse_wire_compress) {
+      std::string encoded;
+      EncodeSortedKeys(request_keys.data(), request_keys.size(), &encoded);
+      EncodeVarint32(keys_counter.data(), keys_counter.size(), &encoded);
+      request_buffer.append(encoded);
+    } else {
+      request_buffer.append(reinterpret_cast<void *>(request_keys.data()),
+                            sizeof(uint64_t) * request_keys.size());
+      request_buffer.append(reinterpret_cast<void *>(keys_counter.data()),
+                            sizeof(uint32_t) * keys_counter.size());
+    }
 
     if (kv_request_count == 0) {
       closure->Run();
@@ -1252,6 +1309,11 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
       closure->request(i)->set_client_id(_client_id);
       closure->request(i)->add_params((char *)&kv_request_count,  // NOLINT
                                       sizeof(uint32_t));
+      if (FLAGS_pserver_sparse_wire_compress) {
+        uint32_t wire_flags = kSparseWireDeltaKeys;
+        closure->request(i)->add_params(reinterpret_cast<char *>(&wire_flags),
+                                        sizeof(uint32_t));
+      }
       PsService_Stub rpc_stub(GetCmdChannel(i));
       closure->cntl(i)->set_log_id(butil::gettimeofday_ms());
       rpc_stub.service(
@@ -1339,15 +1401,16 @@ std::future<int32_t> BrpcPsClient::PullSparseParam(float **select_values,
     auto &request_buffer = closure->cntl(i)->request_attachment();
 
     request_buffer.append(reinterpret_cast<void *>(&is_training), sizeof(bool));
+    std::vector<uint64_t> request_keys;
     std::vector<uint32_t> keys_counter;
+    request_keys.reserve(sorted_kv_size);
     keys_counter.reserve(sorted_kv_size);
 
     for (size_t kv_idx = 0; kv_idx < sorted_kv_size; ++kv_idx) {
       ++kv_request_count;
       uint32_t keys = 1;
       last_key = sorted_kvs[kv_idx].first;
-      request_buffer.append(reinterpret_cast<void *>(&last_key),
-                            sizeof(uint64_t));
+      request_keys.push_back(last_key);
       while (kv_idx < sorted_kv_size - 1 &&
              last_key == sorted_kvs[kv_idx + 1].first) {
         ++kv_idx;
@@ -1356,8 +1419,17 @@ std::future<int32_t> BrpcPsClient::PullSparseParam(float **select_values,
       keys_counter.push_back(keys);
     }
 
-    request_buffer.append(reinterpret_cast<void *>(keys_counter.data()),
-                          sizeof(uint32_t) * keys_counter.size());
+    if (FLAGS_pserver_sparse_wire_compress) {
+      std::string encoded;
+      EncodeSortedKeys(request_keys.data(), request_keys.size(), &encoded);
+      EncodeVarint32(keys_counter.data(), keys_counter.size(), &encoded);
+      request_buffer.append(encoded);
+    } else {
+      request_buffer.append(reinterpret_cast<void *>(request_keys.data()),
+                            sizeof(uint64_t) * request_keys.size());
+      request_buffer.append(reinterpret_cast<void *>(keys_counter.data()),
+                            sizeof(uint32_t) * keys_counter.size());
+    }
 
     if (kv_request_count == 0) {
       closure->Run();
@@ -1367,6 +1439,11 @@ std::future<int32_t> BrpcPsClient::PullSparseParam(float **select_values,
       closure->request(i)->set_client_id(_client_id);
       closure->request(i)->add_params((char *)&kv_request_count,  // NOLINT
                                       sizeof(uint32_t));
+      if (FLAGS_pserver_sparse_wire_compress) {
+        uint32_t wire_flags = kSparseWireDeltaKeys;
+        closure->request(i)->add_params(reinterpret_cast<char *>(&wire_flags),
+                                        sizeof(uint32_t));
+      }
       PsService_Stub rpc_stub(GetCmdChannel(i));
       closure->cntl(i)->set_log_id(butil::gettimeofday_ms());
       rpc_stub.service(
@@ -1422,14 +1499,38 @@ std::future<int32_t> BrpcPsClient::PushSparseRawGradientPartial(
   push_request->set_table_id(table_id);
   push_request->set_client_id(_client_id);
   push_request->add_params((char *)&num, sizeof(uint32_t));  // NOLINT
-  auto *push_data = push_request->mutable_data();
-  push_data->resize(num * (sizeof(uint64_t) + value_size));
-  char *push_data_ptr = const_cast<char *>(push_data->data());
-  memcpy(push_data_ptr, keys, num * sizeof(uint64_t));
-  push_data_ptr += num * sizeof(uint64_t);
-  for (uint32_t i = 0; i < num; ++i) {
-    memcpy(push_data_ptr, update_values[i], value_size);
-    push_data_ptr += value_size;
+  if (FLAGS_pserver_sparse_wire_compress) {
+    // the geo deltas are quantized with the residuals of the pserver, and
+    // the compact format needs the keys sorted
+    std::vector<uint32_t> order(num);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [keys](uint32_t a, uint32_t b) {
+      return keys[a] < keys[b];
+    });
+    std::vector<uint64_t> sorted_keys(num);
+    std::vector<const float *> sorted_values(num);
+    for (uint32_t i = 0; i < num; ++i) {
+      sorted_keys[i] = keys[order[i]];
+      sorted_values[i] = update_values[order[i]];
+    }
+    PushSparseCompactShard(sorted_keys.data(),
+                           sorted_values.data(),
+                           num,
+                           table_id,
+                           pserver_idx,
+                           0,
+                           closure,
+                           accessor);
+  } else {
+    auto *push_data = push_request->mutable_data();
+    push_data->resize(num * (sizeof(uint64_t) + value_size));
+    char *push_data_ptr = const_cast<char *>(push_data->data());
+    memcpy(push_data_ptr, keys, num * sizeof(uint64_t));
+    push_data_ptr += num * sizeof(uint64_t);
+    for (uint32_t i = 0; i < num; ++i) {
+      memcpy(push_data_ptr, update_values[i], value_size);
+      push_data_ptr += value_size;
+    }
   }
   PsService_Stub rpc_stub(GetSparseChannel(pserver_idx));
   closure->cntl(0)->set_request_compress_type(
@@ -1531,6 +1632,7 @@ std::future<int32_t> BrpcPsClient::PushSparse(size_t table_id,
                                               size_t num) {
   auto push_timer = std::make_shared<CostTimer>("pserver_client_push_sparse");
   CostTimer parse_timer("pserver_client_push_sparse_parse");
+  RecordPsClientMetrics("push_sparse", num);
   int push_sparse_async_num = _push_sparse_task_queue_map[table_id]->Size();
   while (push_sparse_async_num > FLAGS_pserver_max_async_call_num) {
     //    LOG(INFO) << "PushSparse Waiting for async_call_num comsume,
@@ -1858,21 +1960,37 @@ int BrpcPsClient::PushSparseAsyncShardPush(
   push_request->set_client_id(_client_id);
   push_request->add_params(reinterpret_cast<char *>(&merged_kv_count),
                            sizeof(uint32_t));  // NOLINT
-  auto *push_data = push_request->mutable_data();
-  int update_size = accessor->GetAccessorInfo().update_size;
-  push_data->resize(merged_kv_count * (sizeof(uint64_t) + update_size));
-  char *push_data_ptr = const_cast<char *>(push_data->data());
-  memcpy(push_data_ptr,
-         merged_key_list.data(),
-         merged_kv_count * sizeof(uint64_t));
-  push_data_ptr += merged_kv_count * sizeof(uint64_t);
-  for (size_t i = 0; i < merged_kv_count; ++i) {
-    const char *task_data_ptr = merged_value_list[i].data();
-
+  if (FLAGS_pserver_sparse_wire_compress) {
+    std::vector<const float *> merged_values(merged_kv_count);
+    for (size_t i = 0; i < merged_kv_count; ++i) {
+      merged_values[i] =
+          reinterpret_cast<const float *>(merged_value_list[i].data());
+    }
+    PushSparseCompactShard(merged_key_list.data(),
+                           merged_values.data(),
+                           merged_kv_count,
+                           table_id,
+                           shard_idx,
+                           shard_idx,
+                           closure,
+                           accessor);
+  } else {
+    auto *push_data = push_request->mutable_data();
+    int update_size = accessor->GetAccessorInfo().update_size;
+    push_data->resize(merged_kv_count * (sizeof(uint64_t) + update_size));
+    char *push_data_ptr = const_cast<char *>(push_data->data());
     memcpy(push_data_ptr,
-           (float *)(task_data_ptr),  // NOLINT
-           update_size);
-    push_data_ptr += update_size;
+           merged_key_list.data(),
+           merged_kv_count * sizeof(uint64_t));
+    push_data_ptr += merged_kv_count * sizeof(uint64_t);
+    for (size_t i = 0; i < merged_kv_count; ++i) {
+      const char *task_data_ptr = merged_value_list[i].data();
+
+      memcpy(push_data_ptr,
+             (float *)(task_data_ptr),  // NOLINT
+             update_size);
+      push_data_ptr += update_size;
+    }
   }
   PsService_Stub rpc_stub(GetSparseChannel(shard_idx));
   closure->cntl(shard_idx)->set_request_compress_type(
@@ -1885,6 +2003,71 @@ int BrpcPsClient::PushSparseAsyncShardPush(
   return 0;
 }
 
+void BrpcPsClient::PushSparseCompactShard(const uint64_t *keys,
+                                          const float *const *values,
+                                          size_t num,
+                                          int table_id,
+                                          int shard_idx,
+                                          int request_idx,
+                                          DownpourBrpcClosure *closure,
+                                          ValueAccessor *accessor) {
+  const auto &accessor_info = accessor->GetAccessorInfo();
+  uint32_t wire_flags = kSparseWireDeltaKeys;
+  if (FLAGS_pserver_sparse_push_quant_type == 1) {
+    wire_flags |= kSparseWireFp16Value;
+  } else if (FLAGS_pserver_sparse_push_quant_type == 2) {
+    wire_flags |= kSparseWireInt8Value;
+  }
+  uint32_t skip_dim = std::min<uint32_t>(
+      FLAGS_pserver_sparse_push_quant_skip_dim, accessor_info.update_dim);
+  SparseValueQuantizer quantizer(
+      wire_flags, accessor_info.update_dim, skip_dim);
+
+  auto *push_request = closure->request(request_idx);
+  push_request->add_params(reinterpret_cast<char *>(&wire_flags),
+                           sizeof(uint32_t));
+  push_request->add_params(reinterpret_cast<char *>(&skip_dim),
+                           sizeof(uint32_t));
+
+  thread_local std::string encoded_keys;
+  encoded_keys.clear();
+  EncodeSortedKeys(keys, num, &encoded_keys);
+  uint32_t key_bytes = encoded_keys.size();
+  size_t value_offset =
+      AlignSparseValueOffset(sizeof(uint32_t) + encoded_keys.size());
+  size_t value_size = quantizer.EncodedSize();
+  size_t total_size = value_offset + num * value_size;
+
+  char *buffer = new char[total_size];
+  memcpy(buffer, &key_bytes, sizeof(uint32_t));
+  memcpy(buffer + sizeof(uint32_t), encoded_keys.data(), encoded_keys.size());
+  memset(buffer + sizeof(uint32_t) + encoded_keys.size(),
+         0,
+         value_offset - sizeof(uint32_t) - encoded_keys.size());
+
+  // the shard is pushed by one thread at a time, its residuals are not shared
+  auto *residuals =
+      quantizer.quantized() && FLAGS_pserver_sparse_push_error_feedback
+          ? &_push_sparse_residual_map.at(table_id)[shard_idx]
+          : nullptr;
+  char *value_ptr = buffer + value_offset;
+  for (size_t i = 0; i < num; ++i) {
+    float *residual = nullptr;
+    if (residuals != nullptr) {
+      auto &feature_residual = (*residuals)[keys[i]];
+      feature_residual.resize(quantizer.quant_dim(), 0.0f);
+      residual = feature_residual.data();
+    }
+    quantizer.Encode(values[i], residual, value_ptr);
+    value_ptr += value_size;
+  }
+  // the buffer is owned by the attachment, no copy into the request
+  closure->cntl(request_idx)->request_attachment().append_user_data(
+      buffer, total_size, [](void *data) {
+        delete[] static_cast<char *>(data);
+      });
+}
+
 std::future<int32_t> BrpcPsClient::PushDense(const Region *regions,
                                              size_t region_num,
                                              size_t table_id) {
@@ -1892,6 +2075,7 @@ std::future<int32_t> BrpcPsClient::PushDense(const Region *regions,
   int fea_dim = accessor->GetAccessorInfo().fea_dim;
   int update_dim = accessor->GetAccessorInfo().update_dim;
   auto push_timer = std::make_shared<CostTimer>("pserver_client_push_dense");
+  RecordPsClientMetrics("push_dense", 0);
   auto parse_timer =
       std::make_shared<CostTimer>("pserver_client_push_dense_parse");
   int push_dense_async_num = _push_dense_task_queue_map[table_id]->Size();
@@ -360,6 +360,11 @@ class BrpcPsClient : public PSClient {
   std::unordered_map<uint32_t, paddle::framework::Channel<SparseAsyncTask *>>
       _push_sparse_task_queue_map;
   std::unordered_map<uint32_t, uint32_t> _push_sparse_merge_count_map;
+  // the quantization residuals of push sparse, by table and shard
+  std::unordered_map<
+      uint32_t,
+      std::vector<std::unordered_map<uint64_t, std::vector<float>>>>
+      _push_sparse_residual_map;
 
   std::thread _print_thread;
 
@@ -378,6 +383,17 @@ class BrpcPsClient : public PSClient {
       DownpourBrpcClosure *closure,
       ValueAccessor *accessor);
 
+  // Fill the push request of a shard in the compact wire format, the keys
+  // are sorted. The request of the shard is closure->request(request_idx).
+  void PushSparseCompactShard(const uint64_t *keys,
+                              const float *const *values,
+                              size_t num,
+                              int table_id,
+                              int shard_idx,
+                              int request_idx,
+                              DownpourBrpcClosure *closure,
+                              ValueAccessor *accessor);
+
   SparseTaskPool _sparse_task_pool;
 
   std::vector<std::shared_ptr<brpc::Channel>>
@@ -18,6 +18,7 @@
 
 #include "butil/object_pool.h"
 #include "paddle/fluid/distributed/common/cost_timer.h"
+#include "paddle/fluid/distributed/ps/service/sparse_wire_format.h"
 #include "paddle/fluid/distributed/ps/table/depends/sparse_utils.h"
 #include "paddle/fluid/distributed/ps/table/table.h"
 #include "paddle/fluid/framework/archive.h"
@@ -532,7 +533,38 @@ int32_t BrpcPsService::PullSparse(Table *table,
 
   auto value = PullSparseValue(num, dim);
 
-  value.DeserializeFromBytes(const_cast<void *>(data));
+  uint32_t wire_flags = 0;
+  if (request.params_size() > 1) {
+    wire_flags =
+        *(reinterpret_cast<const uint32_t *>(request.params(1).c_str()));
+  }
+  if (wire_flags & kSparseWireDeltaKeys) {
+    /*
+    |---isTraining---|---varint key deltas---|---varint frequencies---|
+    */
+    thread_local std::vector<uint64_t> feasigns;
+    thread_local std::vector<uint32_t> frequencies;
+    feasigns.resize(num);
+    frequencies.resize(num);
+    const char *begin = reinterpret_cast<const char *>(data);
+    size_t offset = sizeof(bool);
+    size_t key_bytes = DecodeSortedKeys(
+        begin + offset, req_buffer_size - offset, num, feasigns.data());
+    size_t freq_bytes = 0;
+    if (key_bytes > 0) {
+      offset += key_bytes;
+      freq_bytes = DecodeVarint32(
+          begin + offset, req_buffer_size - offset, num, frequencies.data());
+    }
+    if (num > 0 && freq_bytes == 0) {
+      set_response_code(response, -1, "pull sparse keys not in format");
+      return 0;
+    }
+    value = PullSparseValue(feasigns, frequencies, dim);
+    value.is_training_ = reinterpret_cast<const bool *>(begin)[0];
+  } else {
+    value.DeserializeFromBytes(const_cast<void *>(data));
+  }
 
   auto res_data = butil::get_object<std::vector<float>>();
   res_data->resize(num * dim);
@@ -556,6 +588,9 @@ int32_t BrpcPsService::PushSparse(Table *table,
   platform::RecordEvent record_event(
       "PsService->PushSparse", platform::TracerEventType::Communication, 1);
   CHECK_TABLE_EXIST(table, request, response)
+  if (request.params_size() > 1) {
+    return PushSparseCompact(table, request, response, cntl);
+  }
   auto &push_data = request.data();
   if (push_data.empty()) {
     // set_response_code(response, 0, "push sparse data is empty");
@@ -592,6 +627,86 @@ int32_t BrpcPsService::PushSparse(Table *table,
   return 0;
 }
 
+int32_t BrpcPsService::PushSparseCompact(Table *table,
+                                         const PsRequestMessage &request,
+                                         PsResponseMessage &response,
+                                         brpc::Controller *cntl) {
+  CostTimer timer("pserver_server_push_sparse");
+  const uint32_t num =
+      *(reinterpret_cast<const uint32_t *>(request.params(0).c_str()));
+  const uint32_t wire_flags =
+      *(reinterpret_cast<const uint32_t *>(request.params(1).c_str()));
+  uint32_t skip_dim = 0;
+  if (request.params_size() > 2) {
+    skip_dim = *(reinterpret_cast<const uint32_t *>(request.params(2).c_str()));
+  }
+  auto &req_io_buffer = cntl->request_attachment();
+  size_t req_buffer_size = req_io_buffer.size();
+  if (num == 0 || req_buffer_size < sizeof(uint32_t)) {
+    return 0;
+  }
+  size_t dim = table->ValueAccesor()->GetAccessorInfo().update_dim;
+  if (!(wire_flags & kSparseWireDeltaKeys) ||
+      !SparseValueQuantizer::IsValid(wire_flags, dim, skip_dim)) {
+    set_response_code(response, -1, "push sparse wire flags is invalid");
+    return 0;
+  }
+  SparseValueQuantizer quantizer(wire_flags, dim, skip_dim);
+
+  // the attachment is one user-data block of the client usually, fetch
+  // returns it in place without copy
+  thread_local std::string req_buffer;
+  if (req_buffer.size() < req_buffer_size) {
+    req_buffer.resize(req_buffer_size);
+  }
+  const char *data = reinterpret_cast<const char *>(
+      req_io_buffer.fetch(&req_buffer[0], req_buffer_size));
+
+  /*
+  Push Content:
+  |---4B(keyBytes)---|---varint key deltas---|---padding---|---valuesData---|
+  */
+  uint32_t key_bytes = 0;
+  memcpy(&key_bytes, data, sizeof(uint32_t));
+  size_t value_offset = AlignSparseValueOffset(sizeof(uint32_t) + key_bytes);
+  if (req_buffer_size < value_offset ||
+      req_buffer_size - value_offset < num * quantizer.EncodedSize()) {
+    set_response_code(response, -1, "push sparse data is lack");
+    return 0;
+  }
+  thread_local std::vector<uint64_t> keys;
+  keys.resize(num);
+  if (DecodeSortedKeys(data + sizeof(uint32_t), key_bytes, num, keys.data()) ==
+      0) {
+    set_response_code(response, -1, "push sparse keys not in format");
+    return 0;
+  }
+
+  const char *value_data = data + value_offset;
+  const float *values = reinterpret_cast<const float *>(value_data);
+  thread_local std::vector<float> decoded_values;
+  if (quantizer.quantized() ||
+      reinterpret_cast<uintptr_t>(value_data) % alignof(float) != 0) {
+    decoded_values.resize(static_cast<size_t>(num) * dim);
+    size_t value_size = quantizer.EncodedSize();
+    for (size_t i = 0; i < num; ++i) {
+      quantizer.Decode(value_data + i * value_size,
+                       decoded_values.data() + i * dim);
+    }
+    values = decoded_values.data();
+  }
+
+  TableContext table_context;
+  table_context.value_type = Sparse;
+  table_context.push_context.keys = keys.data();
+  table_context.push_context.values = values;
+  table_context.num = num;
+  if (table->Push(table_context) != 0) {
+    set_response_code(response, -1, "PushSparse error");
+  }
+  return 0;
+}
+
 int32_t BrpcPsService::PrintTableStat(Table *table,
                                       const PsRequestMessage &request,
                                       PsResponseMessage &response,
@@ -16,6 +16,9 @@ limitations under the License. */
 
 #include <google/protobuf/text_format.h>
 
+#include <algorithm>
+#include <cmath>
+
 #include "paddle/fluid/distributed/ps/service/brpc_ps_client.h"
 #include "paddle/fluid/distributed/ps/wrapper/fleet.h"
 #include "paddle/fluid/platform/profiler.h"
@@ -38,6 +41,153 @@ inline double GetCurrentUS() {
   return 1e+6 * time.tv_sec + time.tv_usec;
 }
 
+PD_DEFINE_bool(pserver_coalesce_sparse_pull,
+               false,
+               "merge the concurrent sparse pulls of the worker threads");
+
+PD_DEFINE_int32(pserver_coalesce_sparse_pull_window_us,
+                200,
+                "the time window of a sparse pull to wait for the others");
+
+PD_DEFINE_int32(pserver_coalesce_sparse_pull_max_keys,
+                1024 * 1024,
+                "the pull is sent immediately when the merged keys reach it");
+
+PD_DEFINE_double(communicator_geo_delta_threshold,
+                 0.0,
+                 "the geo rows whose root mean square of delta is below it "
+                 "are held, with the delta accumulated");
+
+PD_DEFINE_double(communicator_geo_send_ratio,
+                 1.0,
+                 "the max ratio of the changed geo rows sent in a round, the "
+                 "rows of the largest deltas are sent");
+
+PD_DEFINE_int32(communicator_geo_max_staleness,
+                4,
+                "a held geo row is sent after being held for this number of "
+                "rounds, 0 holds the rows without bound");
+
+PD_DEFINE_double(communicator_geo_loss_tolerance,
+                 0.0,
+                 "the geo sync is raised when the reported loss exceeds its "
+                 "moving average by this ratio, 0 disables it");
+
+bool SparsePullCoalescer::Enabled() {
+  return FLAGS_pserver_coalesce_sparse_pull;
+}
+
+SparsePullCoalescer *SparsePullCoalescer::GetInstance() {
+  static SparsePullCoalescer coalescer(
+      FLAGS_pserver_coalesce_sparse_pull_window_us,
+      FLAGS_pserver_coalesce_sparse_pull_max_keys);
+  return &coalescer;
+}
+
+int32_t SparsePullCoalescer::PullSparse(PSClient *client,
+                                        float **select_values,
+                                        size_t table_id,
+                                        const uint64_t *keys,
+                                        size_t num,
+                                        bool is_training) {
+  BatchKey batch_key(client, table_id, is_training);
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto &open_batch = open_batches_[batch_key];
+  bool leader = false;
+  if (!open_batch) {
+    open_batch = std::make_shared<PullBatch>();
+    leader = true;
+  }
+  std::shared_ptr<PullBatch> batch = open_batch;
+  batch->requests.push_back({select_values, keys, num});
+  batch->key_num += num;
+
+  if (!leader) {
+    if (batch->key_num >= max_keys_) {
+      batch->cv.notify_all();
+    }
+    batch->cv.wait(lock, [&batch] { return batch->done; });
+    return batch->ret;
+  }
+
+  batch->cv.wait_for(lock, std::chrono::microseconds(window_us_), [&] {
+    return batch->key_num >= max_keys_;
+  });
+  // close the batch, the later pulls open a new one
+  open_batches_.erase(batch_key);
+  lock.unlock();
+
+  int32_t ret = PullBatchSparse(client, table_id, is_training, *batch);
+
+  lock.lock();
+  batch->ret = ret;
+  batch->done = true;
+  batch->cv.notify_all();
+  return ret;
+}
+
+int32_t SparsePullCoalescer::PullBatchSparse(PSClient *client,
+                                             size_t table_id,
+                                             bool is_training,
+                                             const PullBatch &batch) {
+  platform::RecordEvent record_event("SparsePullCoalescer->PullBatchSparse",
+                                     platform::TracerEventType::Communication,
+                                     1);
+  if (batch.requests.size() == 1) {
+    const PullRequest &request = batch.requests[0];
+    auto status = client->PullSparse(request.select_values,
+                                     table_id,
+                                     request.keys,
+                                     request.num,
+                                     is_training);
+    status.wait();
+    return status.get();
+  }
+
+  size_t value_size =
+      client->GetTableAccessor(table_id)->GetAccessorInfo().select_size;
+  size_t value_dim = value_size / sizeof(float);
+  std::unordered_map<uint64_t, size_t> key_index;
+  std::vector<uint64_t> unique_keys;
+  key_index.reserve(batch.key_num);
+  unique_keys.reserve(batch.key_num);
+  for (const PullRequest &request : batch.requests) {
+    for (size_t i = 0; i < request.num; ++i) {
+      if (key_index.emplace(request.keys[i], unique_keys.size()).second) {
+        unique_keys.push_back(request.keys[i]);
+      }
+    }
+  }
+
+  std::vector<float> values(unique_keys.size() * value_dim);
+  std::vector<float *> value_ptrs(unique_keys.size());
+  for (size_t i = 0; i < unique_keys.size(); ++i) {
+    value_ptrs[i] = values.data() + i * value_dim;
+  }
+  VLOG(3) << "SparsePullCoalescer merges " << batch.requests.size()
+          << " pulls of table " << table_id << ", keys " << batch.key_num
+          << " -> " << unique_keys.size();
+  auto status = client->PullSparse(value_ptrs.data(),
+                                   table_id,
+                                   unique_keys.data(),
+                                   unique_keys.size(),
+                                   is_training);
+  status.wait();
+  int32_t ret = status.get();
+  if (ret != 0) {
+    return ret;
+  }
+
+  for (const PullRequest &request : batch.requests) {
+    for (size_t i = 0; i < request.num; ++i) {
+      memcpy(request.select_values[i],
+             value_ptrs[key_index[request.keys[i]]],
+             value_size);
+    }
+  }
+  return 0;
+}
+
 Communicator::Communicator() = default;
 
 void Communicator::InitGFlag(const std::string &gflags) {
@@ -627,13 +777,23 @@ void AsyncCommunicator::PullSparseToTensorSync(
       pull_result_ptr.push_back(output_data + output_len);
     }
   }
-  auto status = _worker_ptr->PullSparse(pull_result_ptr.data(),
-                                        table_id,
-                                        fea_keys.data(),
-                                        fea_keys.size(),
-                                        is_training);
-  status.wait();
-  auto ret = status.get();
+  int32_t ret = 0;
+  if (SparsePullCoalescer::Enabled()) {
+    ret = SparsePullCoalescer::GetInstance()->PullSparse(_worker_ptr.get(),
+                                                         pull_result_ptr.data(),
+                                                         table_id,
+                                                         fea_keys.data(),
+                                                         fea_keys.size(),
+                                                         is_training);
+  } else {
+    auto status = _worker_ptr->PullSparse(pull_result_ptr.data(),
+                                          table_id,
+                                          fea_keys.data(),
+                                          fea_keys.size(),
+                                          is_training);
+    status.wait();
+    ret = status.get();
+  }
   if (ret != 0) {
     LOG(ERROR) << "fleet pull sparse failed, status[" << ret << "]";
     sleep(sleep_seconds_before_fail_exit_);
@@ -1094,6 +1254,7 @@ void GeoCommunicator::InitImpl(const RpcCtxMap &send_varname_to_ctx,
     }
     for (auto &splited_var : ctx.splited_varnames) {  // embedding_0.w_0.block0
       parallel_task_nums_ += 1;
+      geo_held_rows_[splited_var];
       sparse_id_queues_.insert(
           std::pair<std::string,
                     ::paddle::framework::Channel<
@@ -1292,7 +1453,7 @@ std::vector<int64_t> GeoCommunicator::MergeSparseIds(
   size_t merge_num = 0, wait_times = 0;
   std::unordered_set<int64_t> sparse_ids;
   while (merge_num <
-         static_cast<size_t>(max_merge_var_num_)) {  // -> geo_step: 100
+         static_cast<size_t>(geo_step_.load())) {  // -> geo_step: 100
     VLOG(3) << "Merge Number of " << send_varname << " = " << merge_num;
     if (sparse_id_queues_.at(send_varname)->Size() > 0) {
       wait_times = 0;
@@ -1325,6 +1486,16 @@ void GeoCommunicator::SendSparse(const std::string &varname,
   platform::RecordEvent record_event("GeoCommunicator->SendSparse",
                                      platform::TracerEventType::Communication,
                                      1);
+  // the held rows are sent with their deltas accumulated since the last send
+  auto &held_rows = geo_held_rows_.at(varname);
+  if (!held_rows.empty()) {
+    std::unordered_set<int64_t> ids(sparse_ids.begin(), sparse_ids.end());
+    for (auto &item : held_rows) {
+      if (ids.insert(item.first).second) {
+        sparse_ids.push_back(item.first);
+      }
+    }
+  }
   if (sparse_ids.empty()) {
     return;
   }
@@ -1363,22 +1534,39 @@ void GeoCommunicator::SendSparse(const std::string &varname,
   auto blas = phi::funcs::GetBlas<phi::CPUContext, float>(cpu_ctx);
   float coefficient = 1.0 / static_cast<float>(trainers_);
 
-  std::vector<float *> push_g_vec;
+  std::vector<float> delta_norms(sparse_ids.size());
   for (auto j = 0; j < static_cast<int>(sparse_ids.size()); ++j) {
+    float *delta = t_value + j * dims1;
     blas.VSUB(dims1,
               t_latest.data<float>() + sparse_ids[j] * dims1,
               t_old->data<float>() + sparse_ids[j] * dims1,
-              t_value + j * dims1);
-    blas.SCAL(dims1, coefficient, t_value + j * dims1);
+              delta);
+    blas.SCAL(dims1, coefficient, delta);
+    double square_sum = 0;
+    for (int64_t k = 0; k < dims1; ++k) {
+      square_sum += delta[k] * delta[k];
+    }
+    delta_norms[j] = std::sqrt(square_sum / dims1);
+  }
+
+  // The old params only take the sent deltas, so that the deltas of the held
+  // rows keep accumulating.
+  std::vector<uint64_t> push_keys;
+  std::vector<float *> push_g_vec;
+  for (auto j : SelectGeoRows(varname, sparse_ids, delta_norms)) {
     blas.VADD(dims1,
               t_old->data<float>() + sparse_ids[j] * dims1,
               t_value + j * dims1,
               t_old->data<float>() + sparse_ids[j] * dims1);
+    push_keys.push_back(sparse_ids[j]);
     push_g_vec.push_back(t_value + j * dims1);
 
     VLOG(5) << "DEBUG GeoCommunicator::SendSparse send sparse key "
-            << sparse_ids[j] << " value[0] " << push_g_vec[j][0]
-            << " value[-1] " << push_g_vec[j][dims1 - 1];
+            << sparse_ids[j] << " value[0] " << push_g_vec.back()[0]
+            << " value[-1] " << push_g_vec.back()[dims1 - 1];
+  }
+  if (push_keys.empty()) {
+    return;
   }
 
   ++_async_call_num;
@@ -1393,18 +1581,102 @@ void GeoCommunicator::SendSparse(const std::string &varname,
   });
   auto status = _worker_ptr->PushSparseRawGradientPartial(
       table_id,
-      (const uint64_t *)sparse_ids.data(),
+      push_keys.data(),
       (const float **)push_g_vec.data(),
-      sparse_ids.size(),
+      push_keys.size(),
       closure,
       ep_idx);
   status.wait();
 
   VLOG(1) << "Finish Send Sparse " << varname
-          << ", ids.size = " << sparse_ids.size() << ", table_id: " << table_id;
+          << ", ids.size = " << push_keys.size() << " of "
+          << sparse_ids.size() << ", table_id: " << table_id;
   return;
 }
 
+std::vector<size_t> GeoCommunicator::SelectGeoRows(
+    const std::string &varname,
+    const std::vector<int64_t> &sparse_ids,
+    const std::vector<float> &delta_norms) {
+  auto &held_rows = geo_held_rows_.at(varname);
+  std::vector<size_t> selected;
+  const bool adaptive = !geo_diverging_.load() &&
+                        (FLAGS_communicator_geo_delta_threshold > 0 ||
+                         FLAGS_communicator_geo_send_ratio < 1.0);
+  if (!adaptive) {
+    selected.resize(sparse_ids.size());
+    std::iota(selected.begin(), selected.end(), 0);
+    held_rows.clear();
+    return selected;
+  }
+
+  std::vector<std::pair<float, size_t>> candidates;
+  std::vector<size_t> held;
+  for (size_t j = 0; j < sparse_ids.size(); ++j) {
+    auto iter = held_rows.find(sparse_ids[j]);
+    int staleness = iter == held_rows.end() ? 0 : iter->second;
+    if (FLAGS_communicator_geo_max_staleness > 0 &&
+        staleness >= FLAGS_communicator_geo_max_staleness) {
+      selected.push_back(j);
+    } else if (delta_norms[j] >= FLAGS_communicator_geo_delta_threshold) {
+      candidates.emplace_back(delta_norms[j], j);
+    } else {
+      held.push_back(j);
+    }
+  }
+  // the stale rows take their part of the budget first
+  size_t budget = static_cast<size_t>(
+      std::ceil(FLAGS_communicator_geo_send_ratio * sparse_ids.size()));
+  budget = budget > selected.size() ? budget - selected.size() : 0;
+  if (candidates.size() > budget) {
+    std::nth_element(candidates.begin(),
+                     candidates.begin() + budget,
+                     candidates.end(),
+                     [](const std::pair<float, size_t> &a,
+                        const std::pair<float, size_t> &b) {
+                       return a.first > b.first;
+                     });
+    for (size_t i = budget; i < candidates.size(); ++i) {
+      held.push_back(candidates[i].second);
+    }
+    candidates.resize(budget);
+  }
+  for (auto &candidate : candidates) {
+    selected.push_back(candidate.second);
+  }
+
+  for (auto j : selected) {
+    held_rows.erase(sparse_ids[j]);
+  }
+  for (auto j : held) {
+    ++held_rows[sparse_ids[j]];
+  }
+  return selected;
+}
+
+void GeoCommunicator::ReportLoss(float loss) {
+  if (FLAGS_communicator_geo_loss_tolerance <= 0 || !std::isfinite(loss)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(geo_loss_mutex_);
+  if (geo_loss_average_ < 0) {
+    geo_loss_average_ = loss;
+    return;
+  }
+  if (loss > geo_loss_average_ * (1 + FLAGS_communicator_geo_loss_tolerance)) {
+    if (!geo_diverging_.load()) {
+      VLOG(1) << "GeoCommunicator raises the sync, loss " << loss
+              << " exceeds its average " << geo_loss_average_;
+    }
+    geo_diverging_ = true;
+    geo_step_ = std::max(geo_step_.load() / 2, 1);
+  } else {
+    geo_diverging_ = false;
+    geo_step_ = std::min(geo_step_.load() + 1, max_merge_var_num_);
+  }
+  geo_loss_average_ = 0.9 * geo_loss_average_ + 0.1 * loss;
+}
+
 void GeoCommunicator::RecvSparse(const std::string &varname,
                                  int table_id,
                                  int ep_idx) {
@@ -18,12 +18,16 @@ limitations under the License. */
 #include <stdint.h>
 
 #include <atomic>
+#include <condition_variable>  // NOLINT
 #include <deque>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <numeric>
 #include <set>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -232,6 +236,57 @@ using RpcCtxMap = std::unordered_map<std::string, CommContext>;
 using RecvCtxMap = std::unordered_map<uint64_t, std::vector<std::string>>;
 using SparseValue = std::unordered_map<int64_t, std::vector<float>>;
 
+// SparsePullCoalescer merges the concurrent sparse pulls of the worker
+// threads in one process. The first pull of a table opens a batch and waits
+// for a short window, the pulls of the other threads join the batch in the
+// meantime. The keys of the batch are deduplicated and pulled by one
+// PSClient::PullSparse, which sends one request per pserver shard, and the
+// values are copied back to every caller.
+class SparsePullCoalescer {
+ public:
+  SparsePullCoalescer(int64_t window_us, size_t max_keys)
+      : window_us_(window_us), max_keys_(max_keys) {}
+
+  static bool Enabled();
+  static SparsePullCoalescer *GetInstance();
+
+  // The same as PSClient::PullSparse, but returns after the values are
+  // pulled.
+  int32_t PullSparse(PSClient *client,
+                     float **select_values,
+                     size_t table_id,
+                     const uint64_t *keys,
+                     size_t num,
+                     bool is_training);
+
+ private:
+  struct PullRequest {
+    float **select_values;
+    const uint64_t *keys;
+    size_t num;
+  };
+
+  struct PullBatch {
+    std::vector<PullRequest> requests;
+    size_t key_num = 0;
+    bool done = false;
+    int32_t ret = 0;
+    std::condition_variable cv;
+  };
+
+  using BatchKey = std::tuple<PSClient *, size_t, bool>;
+
+  int32_t PullBatchSparse(PSClient *client,
+                          size_t table_id,
+                          bool is_training,
+                          const PullBatch &batch);
+
+  int64_t window_us_;
+  size_t max_keys_;
+  std::mutex mutex_;
+  std::map<BatchKey, std::shared_ptr<PullBatch>> open_batches_;
+};
+
 class Communicator {
  public:
   Communicator();
@@ -316,12 +371,35 @@ class Communicator {
 
   virtual void RecvNoBarrier() {}
 
+  // The training loss of a step, used by the communicators adapting their
+  // sync to the divergence of the loss.
+  virtual void ReportLoss(float loss UNUSED) {}
+
   virtual void Barrier() {}
 
   virtual void BarrierWithTable(uint32_t barrier_type) {
-    auto rets = _worker_ptr->Barrier(barrier_table_id_, barrier_type);
-    rets.wait();
-    int status = rets.get();
+    BarrierArrive(barrier_type);
+    BarrierWait();
+  }
+
+  // The split-phase barrier with table: the arrive only sends the barrier,
+  // so that the work of the trainer until the wait overlaps the barrier of
+  // the other trainers.
+  virtual void BarrierArrive(uint32_t barrier_type) {
+    PADDLE_ENFORCE_EQ(
+        barrier_future_.valid(),
+        false,
+        platform::errors::PreconditionNotMet(
+            "The barrier should be waited before arriving at another one."));
+    barrier_future_ = _worker_ptr->Barrier(barrier_table_id_, barrier_type);
+  }
+
+  virtual void BarrierWait() {
+    PADDLE_ENFORCE_EQ(barrier_future_.valid(),
+                      true,
+                      platform::errors::PreconditionNotMet(
+                          "The barrier should be arrived before waiting."));
+    int status = barrier_future_.get();
     PADDLE_ENFORCE_EQ(status,
                       0,
                       platform::errors::InvalidArgument(
@@ -416,6 +494,7 @@ class Communicator {
   int trainers_;
   int trainer_id_ = 0;
   int barrier_table_id_ = 0;
+  std::future<int32_t> barrier_future_;
   RpcCtxMap send_varname_to_ctx_;
   RecvCtxMap recv_varname_to_ctx_;
 
@@ -625,9 +704,15 @@ class GeoCommunicator : public AsyncCommunicator {
     // id_queue's size
     max_merge_var_num_ = std::stoi(envs.at("communicator_max_merge_var_num"));
     send_queue_size_ = max_merge_var_num_;
+    geo_step_ = max_merge_var_num_;
     VLOG(1) << "GeoCommunicator Initialized";
   }
 
+  // Halves the geo step and sends every changed row while the loss exceeds
+  // its moving average by FLAGS_communicator_geo_loss_tolerance, and then
+  // increases the step back by one per report.
+  void ReportLoss(float loss) override;
+
   void InitImpl(const RpcCtxMap &send_varname_to_ctx,
                 const RecvCtxMap &recv_varname_to_ctx,
                 Scope *recv_scope) override;
@@ -663,6 +748,23 @@ class GeoCommunicator : public AsyncCommunicator {
       std::string,
       ::paddle::framework::Channel<std::shared_ptr<std::vector<int64_t>>>>
       sparse_id_queues_;
+
+ private:
+  // Selects the rows to send among the changed ones by the norms of their
+  // deltas, the others are held with their deltas accumulated.
+  std::vector<size_t> SelectGeoRows(const std::string &varname,
+                                    const std::vector<int64_t> &sparse_ids,
+                                    const std::vector<float> &delta_norms);
+
+  // The rows held by the adaptive sync of each splited var, with the rounds
+  // they have been held.
+  std::unordered_map<std::string, std::unordered_map<int64_t, int>>
+      geo_held_rows_;
+  // The number of the sends merged in a round, adapted by ReportLoss.
+  std::atomic<int> geo_step_{1};
+  std::atomic<bool> geo_diverging_{false};
+  std::mutex geo_loss_mutex_;
+  double geo_loss_average_ = -1;
 };
 
 class FLCommunicator : public GeoCommunicator {
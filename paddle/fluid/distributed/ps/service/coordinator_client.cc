@@ -30,6 +30,9 @@ namespace distributed {
 
 PD_DEFINE_uint64(total_fl_client_size, 100, "supported total fl client size");
 PD_DEFINE_uint32(coordinator_wait_all_clients_max_time, 60, "uint32: s");
+PD_DEFINE_double(coordinator_min_clients_ratio,
+                 1.0,
+                 "the ratio of the fl clients to report to complete a round");
 
 void CoordinatorService::FLService(
     ::google::protobuf::RpcController* controller,
@@ -15,6 +15,9 @@
 #pragma once
 #include <ThreadPool.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <memory>
 #include <string>
 #include <vector>
@@ -38,6 +41,7 @@ PD_DECLARE_int32(pserver_timeout_ms);
 PD_DECLARE_int32(pserver_connect_timeout_ms);
 PD_DECLARE_uint64(total_fl_client_size);
 PD_DECLARE_uint32(coordinator_wait_all_clients_max_time);
+PD_DECLARE_double(coordinator_min_clients_ratio);
 
 using CoordinatorServiceFunc =
     std::function<int32_t(const CoordinatorReqMessage& request,
@@ -74,7 +78,7 @@ class CoordinatorServiceHandle {
     fl_client_ids.insert(client_id);
     _fl_clients_count++;
     // TODO(ziyoujiyi): how to process when a client loss connection?
-    if (_fl_clients_count.load() == last_round_total_fl_clients_num) {
+    if (_fl_clients_count.load() >= RoundQuorum()) {
       _is_all_clients_info_collected = true;
       _cv.notify_one();
     }
@@ -85,36 +89,35 @@ class CoordinatorServiceHandle {
     return;
   }
 
+  // A round completes once the quorum of the clients report, or at the max
+  // wait time in case that some clients are down. The reports of the
+  // stragglers after that are buffered and counted into the next round, so
+  // that a round is not bounded by the slowest client.
   std::unordered_map<uint32_t, std::string> QueryFLClientsInfo() {
-    platform::Timer timeline;
-    double query_wait_time = 0.0;
-    timeline.Start();
-    auto f = [&]() -> bool {
-      while (query_wait_time <
-             FLAGS_coordinator_wait_all_clients_max_time) {  // in case that
-                                                             // some
-                                                             // clients down
-        if (_is_all_clients_info_collected == true) {
-          // LOG(INFO) << "fl-ps > _is_all_clients_info_collected";
-          return true;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-        timeline.Pause();
-        query_wait_time += timeline.ElapsedSec();
-      }
-      // LOG(WARNNING) << "fl-ps > query_wait_time exceed!";
-      return true;
-    };
-
     std::unique_lock<std::mutex> lck(_mtx);
-    _cv.wait(lck, f);
-    lck.unlock();
-
+    // The clients report under the lock, which is released while waiting.
+    bool collected = _cv.wait_for(
+        lck,
+        std::chrono::seconds(FLAGS_coordinator_wait_all_clients_max_time),
+        [this] { return _is_all_clients_info_collected; });
+    if (!collected) {
+      LOG(WARNING) << "fl-ps > only " << _fl_clients_count.load() << " of "
+                   << RoundQuorum() << " clients reported in the round";
+    }
     _is_all_clients_info_collected = false;
     _fl_clients_count.store(0);
     return _client_info_mp;
   }
 
+  // The number of the clients to report to complete a round.
+  uint32_t RoundQuorum() const {
+    double ratio = std::min(std::max(FLAGS_coordinator_min_clients_ratio, 0.0),
+                            1.0);
+    return std::max(static_cast<uint32_t>(std::ceil(
+                        ratio * last_round_total_fl_clients_num)),
+                    1U);
+  }
+
  public:
   std::unordered_map<uint32_t, std::string> _client_info_mp;
   std::set<uint32_t> fl_client_ids;
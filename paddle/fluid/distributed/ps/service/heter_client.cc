@@ -21,6 +21,10 @@ namespace paddle {
 namespace distributed {
 PD_DEFINE_int32(heter_world_size, 100, "group size");  // group max size
 PD_DEFINE_int32(switch_send_recv_timeout_s, 600, "switch_send_recv_timeout_s");
+PD_DEFINE_bool(heter_adaptive_route,
+               false,
+               "Route the forward mini batches to the heter server with the "
+               "least queued work reported, instead of by the mini batch id.");
 
 std::shared_ptr<HeterClient> HeterClient::s_instance_ = nullptr;
 std::mutex HeterClient::mtx_;
@@ -129,7 +133,15 @@ void HeterClient::SendAndRecvAsync(
   VLOG(3) << "BRPCClient::SendAndRecv Begin, message_name: " << message_name;
   brpc::Channel* channel = nullptr;
   distributed::MultiVarMsg request;
-  OnHeterRpcDone* closure = new OnHeterRpcDone([](void* done) {
+  int micro_id = GetMicroId(ctx, p_scope);  // global
+  auto minibatch_id = micro_id / 10;
+  VLOG(4) << "micro_id: " << micro_id;
+  // the server of an adaptive route, whose costs are updated by the response
+  int route = -1;
+  if (mode == "forward" && FLAGS_heter_adaptive_route) {
+    route = SelectXpuChannel(micro_id);
+  }
+  OnHeterRpcDone* closure = new OnHeterRpcDone([this, route](void* done) {
     auto* closure = reinterpret_cast<OnHeterRpcDone*>(done);
     PADDLE_ENFORCE_NE(
         closure->cntl.Failed(),
@@ -137,6 +149,12 @@ void HeterClient::SendAndRecvAsync(
         platform::errors::Unimplemented(
             "HeterClient::SendAndRecv meets brpc error, error message is %s",
             closure->cntl.ErrorText()));
+    if (route >= 0) {
+      std::lock_guard<std::mutex> lock(route_mutex_);
+      xpu_inflight_[route]--;
+      xpu_pending_us_[route] = closure->response.pending_us();
+      xpu_stage_us_[route] = closure->response.stage_us();
+    }
     VLOG(4) << "call heter_worker success";
   });
   closure->cntl.set_timeout_ms(FLAGS_pserver_timeout_ms);
@@ -149,12 +167,9 @@ void HeterClient::SendAndRecvAsync(
                                               &request,
                                               &request_io_buffer);
 
-  int micro_id = GetMicroId(ctx, p_scope);  // global
-  auto minibatch_id = micro_id / 10;
-  VLOG(4) << "micro_id: " << micro_id;
   // select channel according to micro id
   if (mode == "forward") {
-    int num = minibatch_id % xpu_channels_.size();
+    int num = route >= 0 ? route : minibatch_id % xpu_channels_.size();
     channel = xpu_channels_[num].get();
   } else if (mode == "backward") {
     int num = minibatch_id % previous_xpu_channels_.size();
@@ -178,6 +193,39 @@ void HeterClient::SendAndRecvAsync(
       &closure->cntl, &request, &closure->response, closure);
 }
 
+int HeterClient::SelectXpuChannel(int micro_id) {
+  int minibatch_id = micro_id / 10;
+  int num = xpu_channels_.size();
+  std::lock_guard<std::mutex> lock(route_mutex_);
+  if (xpu_inflight_.size() != xpu_channels_.size()) {
+    xpu_inflight_.assign(num, 0);
+    xpu_pending_us_.assign(num, 0);
+    xpu_stage_us_.assign(num, 0);
+  }
+  auto iter = minibatch_routes_.find(minibatch_id);
+  if (micro_id % 10 != 0 && iter != minibatch_routes_.end()) {
+    xpu_inflight_[iter->second]++;
+    return iter->second;
+  }
+  // the reported wait misses the micro batches still in flight, and the ties
+  // keep the static route
+  int route = minibatch_id % num;
+  int64_t best = -1;
+  for (int k = 0; k < num; ++k) {
+    int i = (minibatch_id + k) % num;
+    int64_t cost = xpu_pending_us_[i] + xpu_inflight_[i] * xpu_stage_us_[i];
+    if (best < 0 || cost < best) {
+      best = cost;
+      route = i;
+    }
+  }
+  VLOG(4) << "route the mini batch " << minibatch_id << " to the heter server "
+          << route << ", expected wait " << best << " us";
+  minibatch_routes_[minibatch_id] = route;
+  xpu_inflight_[route]++;
+  return route;
+}
+
 std::future<int32_t> HeterClient::SendCmd(
     uint32_t table_id, int cmd_id, const std::vector<std::string>& params) {
   size_t request_call_num = xpu_channels_.size();
@@ -17,6 +17,7 @@ limitations under the License. */
 #include <ctime>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <random>
 #include <string>
 #include <unordered_map>
@@ -43,6 +44,7 @@ class Scope;
 namespace paddle {
 namespace distributed {
 PD_DECLARE_int32(pserver_timeout_ms);
+PD_DECLARE_bool(heter_adaptive_route);
 using MultiVarMsg = ::paddle::distributed::MultiVariableMessage;
 using VarMsg = ::paddle::distributed::VariableMessage;
 
@@ -223,6 +225,11 @@ class HeterClient {
 
   void SetTrainerID(const int& trainer_id) { trainer_id_ = trainer_id; }
 
+  // Selects the heter server of the forward micro batch. The first micro
+  // batch of a mini batch goes to the server with the least expected wait,
+  // and the others follow it, since a mini batch lives in one server.
+  int SelectXpuChannel(int micro_id);
+
  public:
   std::vector<std::string> send_switch_list_;
   std::vector<std::string> recv_switch_list_;
@@ -250,6 +257,13 @@ class HeterClient {
   std::vector<std::string> xpu_list_;
   std::vector<std::string> previous_xpu_list_;
 
+  // the states of the adaptive routes, see FLAGS_heter_adaptive_route
+  std::mutex route_mutex_;
+  std::unordered_map<int, int> minibatch_routes_;
+  std::vector<int64_t> xpu_pending_us_;
+  std::vector<int64_t> xpu_stage_us_;
+  std::vector<int> xpu_inflight_;
+
   int trainer_id_;
 };
 
@@ -146,6 +146,16 @@ class SendAndRecvVariableHandler final : public ServiceHandlerBase {
     return (*task_queue_).size();
   }
 
+  // Records the time of a task of the section, in a moving average.
+  void ObserveStageTime(double seconds) {
+    int64_t us = static_cast<int64_t>(seconds * 1e6);
+    int64_t old = stage_us_.load(std::memory_order_relaxed);
+    stage_us_.store(old == 0 ? us : (old * 7 + us) / 8,
+                    std::memory_order_relaxed);
+  }
+
+  int64_t StageTimeUs() { return stage_us_.load(std::memory_order_relaxed); }
+
   int SaveInSwitchWithScope(const MultiVarMsg* request,
                             PsResponseMessage* response,
                             brpc::Controller* cntl);
@@ -294,6 +304,15 @@ class SendAndRecvVariableHandler final : public ServiceHandlerBase {
                                                 &local_scope,
                                                 response,
                                                 &response_io_buffer);
+    size_t queued_tasks = 0;
+    {
+      std::lock_guard<std::mutex> lock(scope_mutex_);
+      for (auto& queue : *task_queue_) {
+        queued_tasks += queue.second->Size();
+      }
+    }
+    response->set_stage_us(StageTimeUs());
+    response->set_pending_us(queued_tasks * StageTimeUs());
     VLOG(4) << "Handle over";
     return 0;
   }
@@ -319,6 +338,8 @@ class SendAndRecvVariableHandler final : public ServiceHandlerBase {
   bool is_last_stage_ = false;
 
   SharedTaskQueue task_queue_;
+  // only updated by the section workers, whose reads and writes may race
+  std::atomic<int64_t> stage_us_{0};
 };
 
 class HeterService : public PsService {
@@ -643,6 +664,10 @@ class HeterServer {
 
   int GetThreadNum() { return request_handler_->GetThreadNum(); }
 
+  void ObserveStageTime(double seconds) {
+    request_handler_->ObserveStageTime(seconds);
+  }
+
   void SetTaskQueue(SharedTaskQueue task_queue) {
     request_handler_->SetTaskQueue(task_queue);
   }
@@ -0,0 +1,204 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/service/sparse_wire_format.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "paddle/phi/common/float16.h"
+
+namespace paddle {
+namespace distributed {
+
+namespace {
+
+inline void AppendVarint(uint64_t value, std::string* out) {
+  char buf[10];
+  size_t len = 0;
+  while (value >= 0x80) {
+    buf[len++] = static_cast<char>((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  buf[len++] = static_cast<char>(value);
+  out->append(buf, len);
+}
+
+// returns the bytes consumed, or 0 if data is truncated or overlong
+inline size_t ReadVarint(const char* data, size_t size, uint64_t* value) {
+  uint64_t result = 0;
+  for (size_t i = 0; i < size && i < 10; ++i) {
+    uint64_t byte = static_cast<uint8_t>(data[i]);
+    result |= (byte & 0x7F) << (7 * i);
+    if (!(byte & 0x80)) {
+      *value = result;
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+void EncodeSortedKeys(const uint64_t* keys, size_t num, std::string* out) {
+  uint64_t last_key = 0;
+  for (size_t i = 0; i < num; ++i) {
+    AppendVarint(keys[i] - last_key, out);
+    last_key = keys[i];
+  }
+}
+
+size_t DecodeSortedKeys(const char* data,
+                        size_t size,
+                        size_t num,
+                        uint64_t* keys) {
+  size_t offset = 0;
+  uint64_t last_key = 0;
+  for (size_t i = 0; i < num; ++i) {
+    uint64_t delta = 0;
+    size_t len = ReadVarint(data + offset, size - offset, &delta);
+    if (len == 0) {
+      return 0;
+    }
+    offset += len;
+    last_key += delta;
+    keys[i] = last_key;
+  }
+  return offset;
+}
+
+void EncodeVarint32(const uint32_t* values, size_t num, std::string* out) {
+  for (size_t i = 0; i < num; ++i) {
+    AppendVarint(values[i], out);
+  }
+}
+
+size_t DecodeVarint32(const char* data,
+                      size_t size,
+                      size_t num,
+                      uint32_t* values) {
+  size_t offset = 0;
+  for (size_t i = 0; i < num; ++i) {
+    uint64_t value = 0;
+    size_t len = ReadVarint(data + offset, size - offset, &value);
+    if (len == 0 || value > UINT32_MAX) {
+      return 0;
+    }
+    offset += len;
+    values[i] = static_cast<uint32_t>(value);
+  }
+  return offset;
+}
+
+SparseValueQuantizer::SparseValueQuantizer(uint32_t flags,
+                                           size_t dim,
+                                           size_t skip_dim)
+    : flags_(flags),
+      dim_(dim),
+      skip_dim_(std::min(skip_dim, dim)),
+      quant_dim_(dim - std::min(skip_dim, dim)) {}
+
+bool SparseValueQuantizer::IsValid(uint32_t flags,
+                                   size_t dim,
+                                   size_t skip_dim) {
+  return !((flags & kSparseWireFp16Value) && (flags & kSparseWireInt8Value)) &&
+         skip_dim <= dim;
+}
+
+size_t SparseValueQuantizer::EncodedSize() const {
+  if (flags_ & kSparseWireFp16Value) {
+    return skip_dim_ * sizeof(float) + quant_dim_ * sizeof(uint16_t);
+  }
+  if (flags_ & kSparseWireInt8Value) {
+    return skip_dim_ * sizeof(float) + sizeof(float) +
+           quant_dim_ * sizeof(int8_t);
+  }
+  return dim_ * sizeof(float);
+}
+
+void SparseValueQuantizer::Encode(const float* value,
+                                  float* residual,
+                                  char* out) const {
+  if (!quantized()) {
+    memcpy(out, value, dim_ * sizeof(float));
+    return;
+  }
+  memcpy(out, value, skip_dim_ * sizeof(float));
+  out += skip_dim_ * sizeof(float);
+  const float* grad = value + skip_dim_;
+
+  if (flags_ & kSparseWireFp16Value) {
+    for (size_t i = 0; i < quant_dim_; ++i) {
+      float x = residual ? grad[i] + residual[i] : grad[i];
+      phi::dtype::float16 q(x);
+      if (residual) {
+        residual[i] = x - static_cast<float>(q);
+      }
+      memcpy(out + i * sizeof(uint16_t), &q.x, sizeof(uint16_t));
+    }
+    return;
+  }
+
+  // int8, symmetric quantization by the max magnitude of the feature
+  float max_abs = 0.0f;
+  for (size_t i = 0; i < quant_dim_; ++i) {
+    float x = residual ? grad[i] + residual[i] : grad[i];
+    max_abs = std::max(max_abs, std::fabs(x));
+  }
+  float scale = max_abs / 127.0f;
+  memcpy(out, &scale, sizeof(float));
+  int8_t* codes = reinterpret_cast<int8_t*>(out + sizeof(float));
+  for (size_t i = 0; i < quant_dim_; ++i) {
+    float x = residual ? grad[i] + residual[i] : grad[i];
+    int code = 0;
+    if (scale > 0.0f) {
+      code = static_cast<int>(std::lround(x / scale));
+      code = std::max(-127, std::min(127, code));
+    }
+    codes[i] = static_cast<int8_t>(code);
+    if (residual) {
+      residual[i] = x - code * scale;
+    }
+  }
+}
+
+void SparseValueQuantizer::Decode(const char* in, float* value) const {
+  if (!quantized()) {
+    memcpy(value, in, dim_ * sizeof(float));
+    return;
+  }
+  memcpy(value, in, skip_dim_ * sizeof(float));
+  in += skip_dim_ * sizeof(float);
+  float* grad = value + skip_dim_;
+
+  if (flags_ & kSparseWireFp16Value) {
+    for (size_t i = 0; i < quant_dim_; ++i) {
+      phi::dtype::float16 q;
+      memcpy(&q.x, in + i * sizeof(uint16_t), sizeof(uint16_t));
+      grad[i] = static_cast<float>(q);
+    }
+    return;
+  }
+
+  float scale = 0.0f;
+  memcpy(&scale, in, sizeof(float));
+  const int8_t* codes = reinterpret_cast<const int8_t*>(in + sizeof(float));
+  for (size_t i = 0; i < quant_dim_; ++i) {
+    grad[i] = codes[i] * scale;
+  }
+}
+
+}  // namespace distributed
+}  // namespace paddle
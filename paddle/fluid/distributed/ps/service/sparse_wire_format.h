@@ -0,0 +1,98 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace paddle {
+namespace distributed {
+
+// The compact wire format of the sparse pull/push requests. It is enabled by
+// the client, and described by the flags sent in PsRequestMessage.params(1),
+// the requests without params(1) are in the original raw format.
+enum SparseWireFlag : uint32_t {
+  // the keys are sorted, and sent as the varint-encoded deltas
+  kSparseWireDeltaKeys = 1,
+  // the gradients are quantized to fp16
+  kSparseWireFp16Value = 2,
+  // the gradients are quantized to int8, with a float scale per feature
+  kSparseWireInt8Value = 4,
+};
+
+// The compact push request is
+// |---4B(bytes of keys)---|---varint keys---|---padding---|---values---|
+// the values start at the 4-byte aligned offset, so that the raw float values
+// can be used in place by the table.
+inline size_t AlignSparseValueOffset(size_t offset) {
+  return (offset + 3) & ~static_cast<size_t>(3);
+}
+
+// Append the varint-encoded deltas of the sorted keys to out.
+void EncodeSortedKeys(const uint64_t* keys, size_t num, std::string* out);
+
+// Decode num keys from data, returns the bytes consumed, or 0 if data is
+// malformed.
+size_t DecodeSortedKeys(const char* data,
+                        size_t size,
+                        size_t num,
+                        uint64_t* keys);
+
+// Varint of the small integers, such as the key frequencies of pull.
+void EncodeVarint32(const uint32_t* values, size_t num, std::string* out);
+size_t DecodeVarint32(const char* data,
+                      size_t size,
+                      size_t num,
+                      uint32_t* values);
+
+// SparseValueQuantizer quantizes a push value of dim floats, the first
+// skip_dim floats (e.g. slot, show and click of CtrCommonPushValue) are kept
+// as they are, and the others (the gradients) are quantized.
+//
+// With error feedback, the quantization error of a feature is saved in its
+// residual, and added to the gradients of the next push of the feature, so
+// that the error does not accumulate in the trained parameters.
+class SparseValueQuantizer {
+ public:
+  SparseValueQuantizer(uint32_t flags, size_t dim, size_t skip_dim);
+
+  // At most one of the quantization flags can be set, and skip_dim is not
+  // greater than dim.
+  static bool IsValid(uint32_t flags, size_t dim, size_t skip_dim);
+
+  bool quantized() const {
+    return flags_ & (kSparseWireFp16Value | kSparseWireInt8Value);
+  }
+
+  // The bytes of an encoded value.
+  size_t EncodedSize() const;
+
+  // residual holds dim - skip_dim floats, or is nullptr without error
+  // feedback.
+  void Encode(const float* value, float* residual, char* out) const;
+  void Decode(const char* in, float* value) const;
+
+  size_t quant_dim() const { return quant_dim_; }
+
+ private:
+  uint32_t flags_;
+  size_t dim_;
+  size_t skip_dim_;
+  size_t quant_dim_;
+};
+
+}  // namespace distributed
+}  // namespace paddle
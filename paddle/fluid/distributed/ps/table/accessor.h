@@ -16,11 +16,13 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
 #include "paddle/fluid/distributed/common/afs_warpper.h"
 #include "paddle/fluid/distributed/common/registerer.h"
+#include "paddle/fluid/distributed/ps/table/feature_policy.h"
 #include "paddle/fluid/distributed/ps/thirdparty/round_robin.h"
 #include "paddle/fluid/distributed/the_one_ps.pb.h"
 
@@ -136,6 +138,17 @@ class ValueAccessor {
   virtual bool CreateValue(int type UNUSED, const float* value UNUSED) {
     return true;
   }
+  // the admission of the new features, called for a push of a missing key
+  bool AdmitValue(uint64_t key) {
+    return !_admission_policy || _admission_policy->Admit(key);
+  }
+  bool HasAdmissionPolicy() const { return _admission_policy != nullptr; }
+  // the continuous eviction, the table checks EvictValue on the features of
+  // the shards larger than the policy allows
+  const FeatureEvictionPolicy* GetEvictionPolicy() const {
+    return _eviction_policy.get();
+  }
+  virtual bool EvictValue(float* value UNUSED) { return false; }
   // 从values中选取到select_values中
   virtual int32_t Select(float** select_values,
                          const float** values,
@@ -191,6 +204,18 @@ class ValueAccessor {
   virtual int get_##field##_index() { return class ::field##_index(); }
 
  protected:
+  // called by the accessors supporting the policies in Initialize
+  void InitFeaturePolicy(const CtrAccessorParameter& param) {
+    if (param.admission_threshold() > 0) {
+      _admission_policy.reset(new SketchAdmissionPolicy(
+          param.admission_sketch_width(), param.admission_threshold()));
+    }
+    if (param.evict_max_feasign_num() > 0) {
+      _eviction_policy.reset(new FeatureEvictionPolicy(
+          param.evict_max_feasign_num(), param.evict_threshold()));
+    }
+  }
+
   size_t _value_size;
   size_t _select_value_size;
   size_t _update_value_size;
@@ -198,6 +223,8 @@ class ValueAccessor {
   std::unordered_map<int, std::shared_ptr<struct DataConverter>>
       _data_converter_map;
   AccessorInfo _accessor_info;
+  std::unique_ptr<FeatureAdmissionPolicy> _admission_policy;
+  std::unique_ptr<FeatureEvictionPolicy> _eviction_policy;
 };
 REGISTER_PSCORE_REGISTERER(ValueAccessor);
 }  // namespace distributed
@@ -53,7 +53,11 @@ int32_t BarrierTable::Barrier(const uint32_t trainer_id,
 
     auto diff = to_string<uint32_t>(diffs);
     VLOG(1) << "still need trainers: " << diff;
-    trainer_wait_.wait(lock, [&] { return trainer_ids_.empty(); });
+    // A trainer released may arrive at the next barrier before the others
+    // wake up, so the waiters are released by the generation of the barrier
+    // instead of the trainer ids.
+    const uint64_t generation = generation_;
+    trainer_wait_.wait(lock, [&] { return generation_ != generation; });
   } else {
     VLOG(1) << "barrier table optimize begin";
     for (auto& x : *table_map_) {
@@ -63,6 +67,7 @@ int32_t BarrierTable::Barrier(const uint32_t trainer_id,
     VLOG(1) << "barrier table optimize done";
 
     trainer_ids_.clear();
+    ++generation_;
     trainer_wait_.notify_all();
   }
   return 0;
@@ -18,6 +18,8 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <fstream>
 #include <set>
 #include <sstream>
 #include <tuple>
@@ -40,6 +42,8 @@ PHI_DECLARE_int32(gpugraph_storage_mode);
 PHI_DECLARE_uint64(gpugraph_slot_feasign_max_num);
 PHI_DECLARE_bool(graph_metapath_split_opt);
 PHI_DECLARE_double(graph_neighbor_size_percent);
+PHI_DECLARE_bool(graph_compact_edges);
+PHI_DECLARE_int32(graph_compact_edge_weight_bits);
 
 PHI_DEFINE_EXPORTED_bool(graph_edges_split_only_by_src_id,
                          false,
@@ -740,6 +744,28 @@ void GraphTable::feature_shrink_to_fit() {
   for (size_t i = 0; i < tasks.size(); i++) tasks[i].get();
 }
 
+void GraphTable::compact_edges(int idx, bool is_weighted) {
+  int weight_bits = FLAGS_graph_compact_edge_weight_bits;
+  PADDLE_ENFORCE_EQ(
+      weight_bits == 32 || weight_bits == 16 || weight_bits == 8,
+      true,
+      paddle::platform::errors::InvalidArgument(
+          "FLAGS_graph_compact_edge_weight_bits should be 32, 16 or 8, but "
+          "got %d.",
+          weight_bits));
+  std::vector<std::future<size_t>> tasks;
+  for (auto &shard : edge_shards[idx]) {
+    tasks.push_back(load_node_edge_task_pool->enqueue(
+        [&shard, is_weighted, weight_bits]() -> size_t {
+          return shard->compact(is_weighted, weight_bits);
+        }));
+  }
+  size_t bytes = 0;
+  for (size_t i = 0; i < tasks.size(); i++) bytes += tasks[i].get();
+  VLOG(0) << "compact edges of edge_type[" << id_to_edge[idx] << "] to "
+          << bytes << " bytes";
+}
+
 void GraphTable::merge_feature_shard() {
   VLOG(0) << "begin merge_feature_shard";
   std::vector<std::future<int>> tasks;
@@ -1794,7 +1820,32 @@ GraphNode *GraphShard::add_graph_node(uint64_t id) {
     node_location[id] = bucket.size();
     bucket.push_back(new GraphNode(id));
   }
-  return reinterpret_cast<GraphNode *>(bucket[node_location[id]]);
+  int pos = node_location[id];
+  auto *compact_node = dynamic_cast<CompactGraphNode *>(bucket[pos]);
+  if (compact_node != nullptr) {
+    // the edges are added to a GraphNode, which is compacted again after the
+    // edges are loaded
+    bucket[pos] = compact_node->to_graph_node();
+    delete compact_node;
+  }
+  return reinterpret_cast<GraphNode *>(bucket[pos]);
+}
+
+size_t GraphShard::compact(bool is_weighted, int weight_bits) {
+  size_t bytes = 0;
+  for (size_t i = 0; i < bucket.size(); i++) {
+    auto *compact_node = dynamic_cast<CompactGraphNode *>(bucket[i]);
+    if (compact_node == nullptr && dynamic_cast<GraphNode *>(bucket[i])) {
+      compact_node = new CompactGraphNode(bucket[i], is_weighted, weight_bits);
+      delete bucket[i];
+      bucket[i] = compact_node;
+    }
+    if (compact_node != nullptr) {
+      bytes += compact_node->get_edge_bytes();
+    }
+  }
+  bucket.shrink_to_fit();
+  return bytes;
 }
 
 GraphNode *GraphShard::add_graph_node(Node *node) {
@@ -2553,6 +2604,184 @@ std::pair<uint64_t, uint64_t> GraphTable::parse_edge_file(
   return {local_count, local_valid_count};
 }
 
+bool GraphTable::is_edge_for_self_rank(uint64_t src_id, uint64_t dst_id) {
+  if (FLAGS_graph_edges_split_mode != "hard" &&
+      FLAGS_graph_edges_split_mode != "HARD") {
+    return true;
+  }
+  // only keep hash(src_id) = hash(dst_id) = node_id edges
+  if (!is_key_for_self_rank(src_id)) return false;
+  return FLAGS_graph_edges_split_only_by_src_id ||
+         is_key_for_self_rank(dst_id);
+}
+
+bool GraphTable::is_binary_edge_file(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  char magic[sizeof(BinaryEdgeFileHeader::magic)];
+  file.read(magic, sizeof(magic));
+  return file.good() &&
+         memcmp(magic, kBinaryEdgeFileMagic, sizeof(magic)) == 0;
+}
+
+std::pair<uint64_t, uint64_t> GraphTable::parse_binary_edge_file(
+    const std::string &path, int idx, bool reverse, bool use_weight) {
+  // The records of a range are read by the blocks.
+  static constexpr uint64_t kBlockEdgeNum = 1 << 16;
+  static constexpr uint64_t kMinTaskEdgeNum = 1 << 20;
+  struct Edge {
+    uint64_t src;
+    uint64_t dst;
+    float weight;
+  };
+  is_weighted_ = use_weight;
+  BinaryEdgeFileHeader header;
+  {
+    std::ifstream file(path, std::ios::binary);
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    PADDLE_ENFORCE_EQ(
+        file.good(),
+        true,
+        paddle::platform::errors::InvalidArgument(
+            "Failed to read the header of the binary edge file %s.", path));
+  }
+  const size_t record_size =
+      2 * sizeof(uint64_t) + (header.weighted ? sizeof(float) : 0);
+  const size_t local_shard_num = shard_end - shard_start;
+  const uint64_t task_num = std::max<uint64_t>(
+      1,
+      std::min<uint64_t>(load_thread_num_,
+                         (header.edge_num + kMinTaskEdgeNum - 1) /
+                             kMinTaskEdgeNum));
+  const uint64_t task_edge_num = (header.edge_num + task_num - 1) / task_num;
+
+  // Each task parses a record range into the edges of the local shards.
+  std::vector<std::vector<std::vector<Edge>>> task_edges(
+      task_num, std::vector<std::vector<Edge>>(local_shard_num));
+  std::vector<std::future<uint64_t>> tasks;
+  for (uint64_t t = 0; t < task_num; ++t) {
+    tasks.push_back(load_node_edge_task_pool->enqueue([&, t]() -> uint64_t {
+      uint64_t begin = std::min(header.edge_num, t * task_edge_num);
+      uint64_t end = std::min(header.edge_num, begin + task_edge_num);
+      std::ifstream file(path, std::ios::binary);
+      file.seekg(sizeof(header) + begin * record_size);
+      std::vector<char> block(kBlockEdgeNum * record_size);
+      auto &edges = task_edges[t];
+      uint64_t valid_count = 0;
+      for (uint64_t pos = begin; pos < end;) {
+        uint64_t len = std::min(kBlockEdgeNum, end - pos);
+        file.read(block.data(), len * record_size);
+        PADDLE_ENFORCE_EQ(
+            file.good(),
+            true,
+            paddle::platform::errors::InvalidArgument(
+                "The binary edge file %s is truncated at the edge %d.",
+                path,
+                pos));
+        for (uint64_t i = 0; i < len; ++i) {
+          const char *record = block.data() + i * record_size;
+          Edge edge{0, 0, 1};
+          memcpy(&edge.src, record, sizeof(uint64_t));
+          memcpy(&edge.dst, record + sizeof(uint64_t), sizeof(uint64_t));
+          if (header.weighted) {
+            memcpy(&edge.weight, record + 2 * sizeof(uint64_t), sizeof(float));
+          }
+          if (reverse) {
+            std::swap(edge.src, edge.dst);
+          }
+          size_t src_shard_id = edge.src % shard_num;
+          if (src_shard_id >= shard_end || src_shard_id < shard_start) {
+            continue;
+          }
+          if (!is_edge_for_self_rank(edge.src, edge.dst)) continue;
+          edges[src_shard_id - shard_start].push_back(edge);
+          valid_count++;
+        }
+        pos += len;
+      }
+      return valid_count;
+    }));
+  }
+  uint64_t local_valid_count = 0;
+  for (auto &task : tasks) local_valid_count += task.get();
+
+  // The edges of a src are adjacent in a sorted file, and share the lookup of
+  // the node.
+  std::vector<std::future<int>> insert_tasks;
+  for (size_t s = 0; s < local_shard_num; ++s) {
+    insert_tasks.push_back(load_node_edge_task_pool->enqueue([&, s]() -> int {
+      GraphNode *node = nullptr;
+      uint64_t node_id = 0;
+      for (auto &edges : task_edges) {
+        for (auto &edge : edges[s]) {
+          if (node == nullptr || edge.src != node_id) {
+            node = edge_shards[idx][s]->add_graph_node(edge.src);
+            node_id = edge.src;
+            if (node == nullptr) continue;
+            node->build_edges(is_weighted_);
+          }
+          node->add_edge(edge.dst, edge.weight);
+        }
+        std::vector<Edge>().swap(edges[s]);
+      }
+      return 0;
+    }));
+  }
+  for (auto &task : insert_tasks) task.get();
+  VLOG(2) << local_valid_count << "/" << header.edge_num
+          << " edges are loaded from binary filepath->" << path;
+  return {header.edge_num, local_valid_count};
+}
+
+int64_t GraphTable::convert_edge_file_to_binary(
+    const std::string &text_path,
+    const std::string &binary_path,
+    bool use_weight) {
+  std::ifstream text_file(text_path);
+  PADDLE_ENFORCE_EQ(text_file.is_open(),
+                    true,
+                    paddle::platform::errors::NotFound(
+                        "Cannot open the edge file %s.", text_path));
+  std::vector<std::tuple<uint64_t, uint64_t, float>> edges;
+  std::string line;
+  while (std::getline(text_file, line)) {
+    size_t start = line.find_first_of('\t');
+    if (start == std::string::npos) continue;
+    float weight = 1;
+    size_t last = line.find_last_of('\t');
+    if (use_weight && start != last) {
+      weight = std::stof(&line[last + 1]);
+    }
+    edges.emplace_back(
+        std::stoull(&line[0]), std::stoull(&line[start + 1]), weight);
+  }
+  std::sort(edges.begin(), edges.end());
+
+  BinaryEdgeFileHeader header;
+  memcpy(header.magic, kBinaryEdgeFileMagic, sizeof(header.magic));
+  header.version = 1;
+  header.weighted = use_weight ? 1 : 0;
+  header.edge_num = edges.size();
+  header.reserved = 0;
+  std::ofstream binary_file(binary_path, std::ios::binary);
+  binary_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  for (auto &edge : edges) {
+    binary_file.write(reinterpret_cast<const char *>(&std::get<0>(edge)),
+                      sizeof(uint64_t));
+    binary_file.write(reinterpret_cast<const char *>(&std::get<1>(edge)),
+                      sizeof(uint64_t));
+    if (use_weight) {
+      binary_file.write(reinterpret_cast<const char *>(&std::get<2>(edge)),
+                        sizeof(float));
+    }
+  }
+  PADDLE_ENFORCE_EQ(binary_file.good(),
+                    true,
+                    paddle::platform::errors::Unavailable(
+                        "Failed to write the binary edge file %s.",
+                        binary_path));
+  return static_cast<int64_t>(edges.size());
+}
+
 int32_t GraphTable::load_edges(const std::string &path,
                                bool reverse_edge,
                                const std::string &edge_type,
@@ -2578,6 +2807,18 @@ int32_t GraphTable::load_edges(const std::string &path,
   uint64_t valid_count = 0;
 
   VLOG(0) << "Begin GraphTable::load_edges() edge_type[" << edge_type << "]";
+  // The binary edge files are loaded one by one, each by all the threads.
+  std::vector<std::string> text_paths;
+  for (auto &path : paths) {
+    if (!is_binary_edge_file(path)) {
+      text_paths.push_back(path);
+      continue;
+    }
+    auto res = parse_binary_edge_file(path, idx, reverse_edge, use_weight);
+    count += res.first;
+    valid_count += res.second;
+  }
+  paths.swap(text_paths);
   if (FLAGS_graph_load_in_parallel) {
     std::vector<std::future<std::pair<uint64_t, uint64_t>>> tasks;
     for (size_t i = 0; i < paths.size(); i++) {
@@ -2615,6 +2856,10 @@ int32_t GraphTable::load_edges(const std::string &path,
   }
 #endif
 
+  if (FLAGS_graph_compact_edges) {
+    compact_edges(idx, use_weight);
+  }
+
   if (!build_sampler_on_cpu) {
     // To reduce memory overhead, CPU samplers won't be created in gpugraph.
     // In order not to affect the sampler function of other scenario,
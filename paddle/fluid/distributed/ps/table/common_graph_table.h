@@ -52,6 +52,19 @@
 #endif
 namespace paddle {
 namespace distributed {
+
+// The binary edge file is the header followed by edge_num packed records of
+// (uint64 src, uint64 dst[, float weight]) sorted by src, so that the file is
+// split into the record ranges at any edge.
+struct BinaryEdgeFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t weighted;
+  uint64_t edge_num;
+  uint64_t reserved;
+};
+static constexpr char kBinaryEdgeFileMagic[] = "PDGEDGE1";
+
 class GraphShard {
  public:
   size_t get_size();
@@ -139,6 +152,9 @@ class GraphShard {
       bucket[i]->shrink_to_fit();
     }
   }
+  // Replace the GraphNodes by CompactGraphNodes, returns the bytes of the
+  // compacted edges.
+  size_t compact(bool is_weighted, int weight_bits);
 
   void merge_shard(GraphShard *&shard) {  // NOLINT
     bucket.reserve(bucket.size() + shard->bucket.size());
@@ -622,6 +638,18 @@ class GraphTable : public Table {
                                                 int idx,
                                                 bool reverse,
                                                 bool use_weight);
+  // Loads the record ranges of a binary edge file in parallel, the edges of a
+  // shard are inserted by one task.
+  std::pair<uint64_t, uint64_t> parse_binary_edge_file(const std::string &path,
+                                                       int idx,
+                                                       bool reverse,
+                                                       bool use_weight);
+  static bool is_binary_edge_file(const std::string &path);
+  // Converts a text edge file of "src\tdst[\tweight]" lines to a binary edge
+  // file, returns the number of the edges.
+  static int64_t convert_edge_file_to_binary(const std::string &text_path,
+                                             const std::string &binary_path,
+                                             bool use_weight);
   std::pair<uint64_t, uint64_t> parse_node_file(const std::string &path,
                                                 const std::string &node_type,
                                                 int idx,
@@ -699,6 +727,8 @@ class GraphTable : public Table {
   void clear_feature_shard();
   void clear_node_shard();
   void feature_shrink_to_fit();
+  // Compact the edges of edge_shards[idx] to CompactGraphNodes.
+  void compact_edges(int idx, bool is_weighted);
   void merge_feature_shard();
   void release_graph();
   void release_graph_edge();
@@ -777,6 +807,8 @@ class GraphTable : public Table {
   void calc_edge_type_limit();
   void build_node_iter_type_keys();
   bool is_key_for_self_rank(const uint64_t &id);
+  // Whether an edge is kept by FLAGS_graph_edges_split_mode on this rank.
+  bool is_edge_for_self_rank(uint64_t src_id, uint64_t dst_id);
   int partition_key_for_rank(const uint64_t &key);
   void fix_feature_node_shards(bool load_slot);
   void stat_graph_edge_info(int type);
@@ -107,6 +107,7 @@ class BarrierTable : public Table {
   std::condition_variable trainer_wait_;
   std::set<uint64_t> trainer_ids_;
   std::set<uint64_t> trainer_all_;
+  uint64_t generation_{0};
   std::atomic<int> trigger_;
   std::atomic<bool> exit_;
   std::unordered_map<uint32_t, std::shared_ptr<Table>> *table_map_;
@@ -14,6 +14,8 @@
 
 #include "paddle/fluid/distributed/ps/table/ctr_accessor.h"
 
+#include <algorithm>
+
 #include "glog/logging.h"
 #include "paddle/fluid/string/string_helper.h"
 #include "paddle/utils/flags.h"
@@ -21,6 +23,11 @@
 namespace paddle {
 namespace distributed {
 
+namespace {
+// the number of features updated by a call of the sgd rules
+constexpr size_t kSGDUpdateGroupSize = 64;
+}  // namespace
+
 int CtrCommonAccessor::Initialize() {
   auto name = _config.embed_sgd_param().name();
   _embed_sgd_rule = CREATE_PSCORE_CLASS(SparseValueSGDRule, name);
@@ -42,6 +49,7 @@ int CtrCommonAccessor::Initialize() {
     _show_scale = true;
   }
 
+  InitFeaturePolicy(_config.ctr_accessor_param());
   InitAccessorInfo();
   return 0;
 }
@@ -246,35 +254,49 @@ int32_t CtrCommonAccessor::Merge(float** update_values,
 int32_t CtrCommonAccessor::Update(float** update_values,
                                   const float** push_values,
                                   size_t num) {
-  for (size_t value_item = 0; value_item < num; ++value_item) {
-    float* update_value = update_values[value_item];
-    const float* push_value = push_values[value_item];
-    float push_show = push_value[CtrCommonPushValue::ShowIndex()];
-    float push_click = push_value[CtrCommonPushValue::ClickIndex()];
-    float slot = push_value[CtrCommonPushValue::SlotIndex()];
-    update_value[common_feature_value.ShowIndex()] += push_show;
-    update_value[common_feature_value.ClickIndex()] += push_click;
-    update_value[common_feature_value.SlotIndex()] = slot;
-    update_value[common_feature_value.DeltaScoreIndex()] +=
-        (push_show - push_click) * _config.ctr_accessor_param().nonclk_coeff() +
-        push_click * _config.ctr_accessor_param().click_coeff();
-    update_value[common_feature_value.UnseenDaysIndex()] = 0;
-    // TODO(zhaocaibei123): add configure show_scale
-    if (!_show_scale) {
-      push_show = 1;
+  // the sgd rules update the features in groups, the slices of a group are
+  // collected first
+  float* embed_w[kSGDUpdateGroupSize];
+  float* embed_sgd[kSGDUpdateGroupSize];
+  const float* embed_g[kSGDUpdateGroupSize];
+  float* embedx_w[kSGDUpdateGroupSize];
+  float* embedx_sgd[kSGDUpdateGroupSize];
+  const float* embedx_g[kSGDUpdateGroupSize];
+  float scales[kSGDUpdateGroupSize];
+  for (size_t begin = 0; begin < num; begin += kSGDUpdateGroupSize) {
+    size_t group_num = std::min(num - begin, kSGDUpdateGroupSize);
+    for (size_t k = 0; k < group_num; ++k) {
+      float* update_value = update_values[begin + k];
+      const float* push_value = push_values[begin + k];
+      float push_show = push_value[CtrCommonPushValue::ShowIndex()];
+      float push_click = push_value[CtrCommonPushValue::ClickIndex()];
+      float slot = push_value[CtrCommonPushValue::SlotIndex()];
+      update_value[common_feature_value.ShowIndex()] += push_show;
+      update_value[common_feature_value.ClickIndex()] += push_click;
+      update_value[common_feature_value.SlotIndex()] = slot;
+      update_value[common_feature_value.DeltaScoreIndex()] +=
+          (push_show - push_click) *
+              _config.ctr_accessor_param().nonclk_coeff() +
+          push_click * _config.ctr_accessor_param().click_coeff();
+      update_value[common_feature_value.UnseenDaysIndex()] = 0;
+      // TODO(zhaocaibei123): add configure show_scale
+      if (!_show_scale) {
+        push_show = 1;
+      }
+      VLOG(3) << "accessor show scale:" << _show_scale
+              << ", push_show:" << push_show;
+      embed_w[k] = update_value + common_feature_value.EmbedWIndex();
+      embed_sgd[k] = update_value + common_feature_value.EmbedG2SumIndex();
+      embed_g[k] = push_value + CtrCommonPushValue::EmbedGIndex();
+      embedx_w[k] = update_value + common_feature_value.EmbedxWIndex();
+      embedx_sgd[k] = update_value + common_feature_value.EmbedxG2SumIndex();
+      embedx_g[k] = push_value + CtrCommonPushValue::EmbedxGIndex();
+      scales[k] = push_show;
     }
-    VLOG(3) << "accessor show scale:" << _show_scale
-            << ", push_show:" << push_show;
-    _embed_sgd_rule->UpdateValue(
-        update_value + common_feature_value.EmbedWIndex(),
-        update_value + common_feature_value.EmbedG2SumIndex(),
-        push_value + CtrCommonPushValue::EmbedGIndex(),
-        push_show);
-    _embedx_sgd_rule->UpdateValue(
-        update_value + common_feature_value.EmbedxWIndex(),
-        update_value + common_feature_value.EmbedxG2SumIndex(),
-        push_value + CtrCommonPushValue::EmbedxGIndex(),
-        push_show);
+    _embed_sgd_rule->UpdateValueBatch(
+        embed_w, embed_sgd, embed_g, scales, group_num);
+    _embedx_sgd_rule->UpdateValueBatch(
+        embedx_w, embedx_sgd, embedx_g, scales, group_num);
   }
   return 0;
 }
@@ -302,6 +324,13 @@ bool CtrCommonAccessor::CreateValue(int stage, const float* value) {
   }
 }
 
+bool CtrCommonAccessor::EvictValue(float* value) {
+  return _eviction_policy &&
+         _eviction_policy->Evict(ShowClickScore(
+             common_feature_value.Show(value),
+             common_feature_value.Click(value)));
+}
+
 float CtrCommonAccessor::ShowClickScore(float show, float click) {
   auto nonclk_coeff = _config.ctr_accessor_param().nonclk_coeff();
   auto click_coeff = _config.ctr_accessor_param().click_coeff();
@@ -177,6 +177,7 @@ class CtrCommonAccessor : public ValueAccessor {
   std::string ParseToString(const float* value, int param) override;
   int32_t ParseFromString(const std::string& str, float* v) override;
   virtual bool CreateValue(int type, const float* value);
+  bool EvictValue(float* value) override;
 
   // 这个接口目前只用来取show
   float GetField(float* value, const std::string& name) override {
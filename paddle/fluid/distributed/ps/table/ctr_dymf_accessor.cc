@@ -59,6 +59,7 @@ int CtrDymfAccessor::Initialize() {
           << common_feature_value.embed_sgd_dim
           << " embedx_dim:" << common_feature_value.embedx_dim
           << "  embedx_sgd_dim:" << common_feature_value.embedx_sgd_dim;
+  InitFeaturePolicy(_config.ctr_accessor_param());
   InitAccessorInfo();
   return 0;
 }
@@ -301,6 +302,13 @@ bool CtrDymfAccessor::CreateValue(int stage, const float* value) {
   }
 }
 
+bool CtrDymfAccessor::EvictValue(float* value) {
+  return _eviction_policy &&
+         _eviction_policy->Evict(ShowClickScore(
+             common_feature_value.Show(value),
+             common_feature_value.Click(value)));
+}
+
 float CtrDymfAccessor::ShowClickScore(float show, float click) {
   auto nonclk_coeff = _config.ctr_accessor_param().nonclk_coeff();
   auto click_coeff = _config.ctr_accessor_param().click_coeff();
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <mutex>  // NOLINT
 #include <vector>
 
 #include <mct/hash-map.hpp>
@@ -84,7 +85,8 @@ struct alignas(64) SparseTableShard {
       return a.it != b.it;
     }
     const KEY& key() const { return it->first; }
-    VALUE& value() const { return *(VALUE*)(void*)it->second; }  // NOLINT
+    VALUE& value() const { return *(VALUE*)(void*)it->second; }     // NOLINT
+    VALUE* value_ptr() const { return (VALUE*)(void*)it->second; }  // NOLINT
     local_iterator& operator++() {
       ++it;
       return *this;
@@ -106,7 +108,7 @@ struct alignas(64) SparseTableShard {
     for (size_t bucket = 0; bucket < CTR_SPARSE_SHARD_BUCKET_NUM; bucket++) {
       map_type& data = _buckets[bucket];
       for (auto it = data.begin(); it != data.end(); ++it) {
-        _alloc.release((VALUE*)(void*)it->second);  // NOLINT
+        release_value((VALUE*)(void*)it->second);  // NOLINT
       }
       data.clear();
     }
@@ -127,6 +129,12 @@ struct alignas(64) SparseTableShard {
   }
   local_iterator begin(size_t bucket) { return {_buckets[bucket].begin()}; }
   local_iterator end(size_t bucket) { return {_buckets[bucket].end()}; }
+  // Only touch the given bucket, unlike find(key) which compares with the end
+  // of the last bucket. Use it with end(bucket) when the shard is accessed
+  // concurrently.
+  local_iterator find(size_t bucket, const KEY& key) {
+    return {_buckets[bucket].find_with_hash(key, _hasher(key))};
+  }
   iterator find(const KEY& key) {
     size_t hash = _hasher(key);
     size_t bucket = compute_bucket(hash);
@@ -150,13 +158,13 @@ struct alignas(64) SparseTableShard {
     auto res = _buckets[bucket].insert_with_hash({key, NULL}, hash);
 
     if (res.second) {
-      res.first->second = _alloc.acquire(std::forward<ARGS>(args)...);
+      res.first->second = acquire_value(std::forward<ARGS>(args)...);
     }
 
     return {{res.first, bucket, _buckets}, res.second};
   }
   iterator erase(iterator it) {
-    _alloc.release((VALUE*)(void*)it.it->second);  // NOLINT
+    release_value((VALUE*)(void*)it.it->second);  // NOLINT
     size_t bucket = it.bucket;
     auto it2 = _buckets[bucket].erase(it.it);
     while (it2 == _buckets[bucket].end() &&
@@ -166,15 +174,15 @@ struct alignas(64) SparseTableShard {
     return {it2, bucket, _buckets};
   }
   void quick_erase(iterator it) {
-    _alloc.release((VALUE*)(void*)it.it->second);  // NOLINT
+    release_value((VALUE*)(void*)it.it->second);  // NOLINT
     _buckets[it.bucket].quick_erase(it.it);
   }
   local_iterator erase(size_t bucket, local_iterator it) {
-    _alloc.release((VALUE*)(void*)it.it->second);  // NOLINT
+    release_value((VALUE*)(void*)it.it->second);  // NOLINT
     return {_buckets[bucket].erase(it.it)};
   }
   void quick_erase(size_t bucket, local_iterator it) {
-    _alloc.release((VALUE*)(void*)it.it->second);  // NOLINT
+    release_value((VALUE*)(void*)it.it->second);  // NOLINT
     _buckets[bucket].quick_erase(it.it);
   }
   size_t erase(const KEY& key) {
@@ -192,11 +200,50 @@ struct alignas(64) SparseTableShard {
       return hash >> (sizeof(size_t) * 8 - CTR_SPARSE_SHARD_BUCKET_NUM_BITS);
     }
   }
+  size_t compute_bucket_by_key(const KEY& key) {
+    return compute_bucket(_hasher(key));
+  }
+
+  // Lock striping over the buckets, to let several threads access one shard.
+  // The callers hold bucket_mutex(bucket) while accessing the keys in the
+  // bucket by the bucket-local methods (find(bucket, key), end(bucket),
+  // operator[] and emplace), and the values are acquired and released under
+  // a shard lock once set_concurrent(true) is called.
+  void set_concurrent(bool concurrent) { _concurrent = concurrent; }
+  bool concurrent() const { return _concurrent; }
+  std::mutex& bucket_mutex(size_t bucket) {
+    return _bucket_mutexes[bucket].mutex;
+  }
 
  private:
+  template <class... ARGS>
+  VALUE* acquire_value(ARGS&&... args) {
+    if (_concurrent) {
+      std::lock_guard<std::mutex> lock(_alloc_mutex);
+      return _alloc.acquire(std::forward<ARGS>(args)...);
+    }
+    return _alloc.acquire(std::forward<ARGS>(args)...);
+  }
+  void release_value(VALUE* value) {
+    if (_concurrent) {
+      std::lock_guard<std::mutex> lock(_alloc_mutex);
+      _alloc.release(value);
+      return;
+    }
+    _alloc.release(value);
+  }
+
+  // padded to avoid false sharing between the buckets
+  struct alignas(64) BucketMutex {
+    std::mutex mutex;
+  };
+
   map_type _buckets[CTR_SPARSE_SHARD_BUCKET_NUM];
   ChunkAllocator<VALUE> _alloc;
   std::hash<KEY> _hasher;
+  bool _concurrent{false};
+  std::mutex _alloc_mutex;
+  BucketMutex _bucket_mutexes[CTR_SPARSE_SHARD_BUCKET_NUM];
 };
 
 }  // namespace distributed
@@ -0,0 +1,101 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace paddle {
+namespace distributed {
+
+// FrequencySketch estimates the recent access frequency of the keys, as the
+// admission filter of TinyLFU. It is a count-min sketch of kDepth rows with
+// saturating 8-bit counters, all the counters are halved after every
+// sample_size increments so that the old accesses fade away.
+//
+// Increment and Estimate can be called concurrently, the results are
+// approximate anyway.
+class FrequencySketch {
+ public:
+  static constexpr int kDepth = 4;
+  static constexpr uint8_t kMaxCount = 15;
+
+  // The width is rounded up to a power of two, the sketch is accurate for
+  // about width distinct hot keys.
+  explicit FrequencySketch(size_t width) {
+    _width = 1;
+    while (_width < width) {
+      _width <<= 1;
+    }
+    _sample_size = _width * 10;
+    _counters.reset(new std::atomic<uint8_t>[_width * kDepth]);
+    for (size_t i = 0; i < _width * kDepth; ++i) {
+      _counters[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  void Increment(uint64_t key) {
+    for (int row = 0; row < kDepth; ++row) {
+      auto& counter = _counters[Index(key, row)];
+      uint8_t count = counter.load(std::memory_order_relaxed);
+      if (count < kMaxCount) {
+        counter.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    if (_additions.fetch_add(1, std::memory_order_relaxed) + 1 ==
+        _sample_size) {
+      Reset();
+    }
+  }
+
+  uint8_t Estimate(uint64_t key) const {
+    uint8_t result = kMaxCount;
+    for (int row = 0; row < kDepth; ++row) {
+      uint8_t count =
+          _counters[Index(key, row)].load(std::memory_order_relaxed);
+      result = count < result ? count : result;
+    }
+    return result;
+  }
+
+  size_t width() const { return _width; }
+
+ private:
+  void Reset() {
+    for (size_t i = 0; i < _width * kDepth; ++i) {
+      uint8_t count = _counters[i].load(std::memory_order_relaxed);
+      _counters[i].store(count >> 1, std::memory_order_relaxed);
+    }
+    _additions.store(0, std::memory_order_relaxed);
+  }
+
+  size_t Index(uint64_t key, int row) const {
+    // splitmix64 finalizer with a different seed for every row
+    uint64_t x = key + 0x9E3779B97F4A7C15ULL * (row + 1);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    x = x ^ (x >> 31);
+    return row * _width + (x & (_width - 1));
+  }
+
+  size_t _width;
+  size_t _sample_size;
+  std::unique_ptr<std::atomic<uint8_t>[]> _counters;
+  std::atomic<size_t> _additions{0};
+};
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,78 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "paddle/fluid/distributed/ps/table/depends/frequency_sketch.h"
+
+namespace paddle {
+namespace distributed {
+
+// FeatureAdmissionPolicy decides whether a key missing in the table creates a
+// feature when it is pushed. The keys not admitted yet take no memory of the
+// table, and are pulled as the zero values.
+class FeatureAdmissionPolicy {
+ public:
+  virtual ~FeatureAdmissionPolicy() {}
+  // Called for every push of a missing key, thread safe.
+  virtual bool Admit(uint64_t key) = 0;
+};
+
+// SketchAdmissionPolicy admits a key once it has been pushed threshold times
+// recently. The pushes are counted by a count-min sketch, which overestimates
+// a little and forgets the old pushes slowly, so the long-tail keys seen only
+// a few times never allocate a feature.
+class SketchAdmissionPolicy : public FeatureAdmissionPolicy {
+ public:
+  SketchAdmissionPolicy(size_t sketch_width, int threshold)
+      : _sketch(sketch_width),
+        _threshold(threshold < FrequencySketch::kMaxCount
+                       ? threshold
+                       : FrequencySketch::kMaxCount) {}
+
+  bool Admit(uint64_t key) override {
+    _sketch.Increment(key);
+    return _sketch.Estimate(key) >= _threshold;
+  }
+
+ private:
+  FrequencySketch _sketch;
+  int _threshold;
+};
+
+// FeatureEvictionPolicy evicts the features continuously instead of waiting
+// for the next Shrink, once a shard holds more than max_feasign_num features.
+// The features whose show click score is below evict_threshold are evicted.
+class FeatureEvictionPolicy {
+ public:
+  FeatureEvictionPolicy(size_t max_feasign_num, float evict_threshold)
+      : _max_feasign_num(max_feasign_num), _evict_threshold(evict_threshold) {}
+
+  bool NeedEvict(size_t feasign_num) const {
+    return feasign_num > _max_feasign_num;
+  }
+  bool Evict(float show_click_score) const {
+    return show_click_score < _evict_threshold;
+  }
+
+ private:
+  size_t _max_feasign_num;
+  float _evict_threshold;
+};
+
+}  // namespace distributed
+}  // namespace paddle
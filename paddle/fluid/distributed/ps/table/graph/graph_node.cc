@@ -14,10 +14,51 @@
 
 #include "paddle/fluid/distributed/ps/table/graph/graph_node.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <limits>
+#include <numeric>
 namespace paddle {
 namespace distributed {
 
+namespace {
+// The bits of [pos, pos + width) of data, the buffer is padded by 8 bytes so
+// that a value is read by two loads at most. Little endian only.
+inline uint64_t unpack_bits(const char *data, uint64_t pos, int width) {
+  const char *p = data + (pos >> 3);
+  int shift = pos & 7;
+  uint64_t value;
+  memcpy(&value, p, sizeof(value));
+  value >>= shift;
+  if (shift + width > 64) {
+    value |= static_cast<uint64_t>(static_cast<uint8_t>(p[8])) << (64 - shift);
+  }
+  return width == 64 ? value : value & ((1ULL << width) - 1);
+}
+
+inline void pack_bits(char *data, uint64_t pos, uint64_t value, int width) {
+  char *p = data + (pos >> 3);
+  int shift = pos & 7;
+  uint64_t word;
+  memcpy(&word, p, sizeof(word));
+  word |= value << shift;
+  memcpy(p, &word, sizeof(word));
+  if (shift + width > 64) {
+    p[8] |= static_cast<char>(value >> (64 - shift));
+  }
+}
+
+inline int bit_width(uint64_t value) {
+  int width = 0;
+  while (value != 0) {
+    ++width;
+    value >>= 1;
+  }
+  return width;
+}
+}  // namespace
+
 GraphNode::~GraphNode() {
   if (sampler != nullptr) {
     delete sampler;
@@ -76,6 +117,222 @@ void GraphNode::build_sampler(std::string sample_type) {
   }
   sampler->build(edges);
 }
+
+CompactGraphNode::CompactGraphNode(Node *node,
+                                   bool is_weighted,
+                                   int weight_bits)
+    : Node(node->get_id()),
+      data(nullptr),
+      data_size(0),
+      degree(0),
+      weight_scale(1.0),
+      weight_bits(is_weighted ? weight_bits : 0),
+      has_alias(false),
+      weighted_sample(false) {
+  PADDLE_ENFORCE_EQ(
+      weight_bits == 32 || weight_bits == 16 || weight_bits == 8,
+      true,
+      paddle::platform::errors::InvalidArgument(
+          "weight_bits of CompactGraphNode should be 32, 16 or 8, but got %d.",
+          weight_bits));
+  this->is_weighted = is_weighted;
+  size_t n = node->get_neighbor_size();
+  std::vector<uint64_t> ids(n);
+  std::vector<float> weights(is_weighted ? n : 0);
+  for (size_t i = 0; i < n; i++) {
+    ids[i] = node->get_neighbor_id(i);
+    if (is_weighted) {
+      weights[i] = static_cast<float>(node->get_neighbor_weight(i));
+    }
+  }
+  encode(ids, weights, false);
+}
+
+CompactGraphNode::~CompactGraphNode() {
+  if (data != nullptr) {
+    delete[] data;
+    data = nullptr;
+  }
+}
+
+CompactGraphNode::Layout CompactGraphNode::get_layout(bool with_alias) const {
+  // the arrays of larger elements first, so that all are aligned
+  size_t n = degree;
+  size_t block_num = (n + kBlockSize - 1) / kBlockSize;
+  Layout layout;
+  size_t size = 0;
+  layout.base = size;
+  size += block_num * sizeof(uint64_t);
+  layout.prob = size;
+  size += with_alias ? n * sizeof(float) : 0;
+  layout.alias = size;
+  size += with_alias ? n * sizeof(uint32_t) : 0;
+  layout.weight = size;
+  size += weight_bits == 32 ? n * sizeof(float) : 0;
+  layout.offset = size;
+  size += block_num * sizeof(uint32_t);
+  if (weight_bits == 16) {
+    layout.weight = size;
+    size += n * sizeof(uint16_t);
+  }
+  layout.width = size;
+  size += block_num;
+  if (weight_bits == 8) {
+    layout.weight = size;
+    size += n;
+  }
+  layout.bits = size;
+  return layout;
+}
+
+void CompactGraphNode::encode(const std::vector<uint64_t> &ids,
+                              const std::vector<float> &weights,
+                              bool with_alias) {
+  size_t n = ids.size();
+  std::vector<uint32_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&ids](uint32_t a, uint32_t b) {
+    return ids[a] < ids[b];
+  });
+  if (data != nullptr) {
+    delete[] data;
+    data = nullptr;
+  }
+  degree = n;
+  has_alias = with_alias && weight_bits > 0;
+  Layout layout = get_layout(has_alias);
+  size_t block_num = (n + kBlockSize - 1) / kBlockSize;
+  std::vector<uint8_t> widths(block_num);
+  uint64_t bits_num = 0;
+  for (size_t b = 0; b < block_num; b++) {
+    size_t end = std::min(n, (b + 1) * kBlockSize);
+    uint64_t base = ids[order[b * kBlockSize]];
+    widths[b] = bit_width(ids[order[end - 1]] - base);
+    bits_num += static_cast<uint64_t>(widths[b]) * (end - b * kBlockSize);
+  }
+  PADDLE_ENFORCE_LE(bits_num,
+                    static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()),
+                    paddle::platform::errors::InvalidArgument(
+                        "node %llu has too many neighbors to compact.", id));
+  // padded for unpack_bits
+  data_size = layout.bits + (bits_num + 7) / 8 + sizeof(uint64_t);
+  data = new char[data_size];
+  memset(data, 0, data_size);
+
+  uint64_t *bases = reinterpret_cast<uint64_t *>(data + layout.base);
+  uint32_t *offsets = reinterpret_cast<uint32_t *>(data + layout.offset);
+  char *bits = data + layout.bits;
+  uint64_t pos = 0;
+  for (size_t b = 0; b < block_num; b++) {
+    size_t begin = b * kBlockSize;
+    size_t end = std::min(n, begin + kBlockSize);
+    bases[b] = ids[order[begin]];
+    offsets[b] = pos;
+    data[layout.width + b] = widths[b];
+    for (size_t i = begin; i < end; i++) {
+      pack_bits(bits, pos, ids[order[i]] - bases[b], widths[b]);
+      pos += widths[b];
+    }
+  }
+  if (weight_bits == 0) {
+    return;
+  }
+  std::vector<float> sorted_weights(n);
+  float max_weight = 0;
+  for (size_t i = 0; i < n; i++) {
+    sorted_weights[i] = std::max(weights[order[i]], 0.0f);
+    max_weight = std::max(max_weight, sorted_weights[i]);
+  }
+  if (weight_bits == 32) {
+    memcpy(data + layout.weight, sorted_weights.data(), n * sizeof(float));
+  } else {
+    float max_code = (1 << weight_bits) - 1;
+    weight_scale = max_weight > 0 ? max_weight / max_code : 1.0;
+    for (size_t i = 0; i < n; i++) {
+      float code = std::min(std::round(sorted_weights[i] / weight_scale),
+                            max_code);
+      if (weight_bits == 16) {
+        reinterpret_cast<uint16_t *>(data + layout.weight)[i] = code;
+      } else {
+        reinterpret_cast<uint8_t *>(data + layout.weight)[i] = code;
+      }
+    }
+  }
+  if (has_alias) {
+    float *prob = reinterpret_cast<float *>(data + layout.prob);
+    uint32_t *alias = reinterpret_cast<uint32_t *>(data + layout.alias);
+    AliasSampler::build_table(sorted_weights.data(), n, prob, alias);
+  }
+}
+
+uint64_t CompactGraphNode::get_neighbor_id(int idx) {
+  Layout layout = get_layout(has_alias);
+  int b = idx / kBlockSize;
+  int width = static_cast<uint8_t>(data[layout.width + b]);
+  uint64_t pos = reinterpret_cast<const uint32_t *>(data + layout.offset)[b] +
+                 static_cast<uint64_t>(idx % kBlockSize) * width;
+  return reinterpret_cast<const uint64_t *>(data + layout.base)[b] +
+         unpack_bits(data + layout.bits, pos, width);
+}
+
+float CompactGraphNode::get_float_weight(int idx) {
+  if (weight_bits == 0) {
+    return 1.0;
+  }
+  const char *weights = data + get_layout(has_alias).weight;
+  if (weight_bits == 32) {
+    return reinterpret_cast<const float *>(weights)[idx];
+  } else if (weight_bits == 16) {
+    return reinterpret_cast<const uint16_t *>(weights)[idx] * weight_scale;
+  }
+  return reinterpret_cast<const uint8_t *>(weights)[idx] * weight_scale;
+}
+
+void CompactGraphNode::build_sampler(std::string sample_type) {
+  weighted_sample = sample_type == "weighted" && weight_bits > 0;
+  if (!weighted_sample || has_alias) {
+    return;
+  }
+  // the alias table is built from the stored weights, which are quantized
+  // unless weight_bits is 32
+  std::vector<uint64_t> ids(degree);
+  std::vector<float> weights(degree);
+  for (uint32_t i = 0; i < degree; i++) {
+    ids[i] = get_neighbor_id(i);
+    weights[i] = get_float_weight(i);
+  }
+  encode(ids, weights, true);
+}
+
+void CompactGraphNode::add_edge(uint64_t id, float weight) {
+  PADDLE_THROW(paddle::platform::errors::Unimplemented(
+      "CompactGraphNode %llu is read only, convert it to a GraphNode to add "
+      "edges.",
+      this->id));
+}
+
+std::vector<int> CompactGraphNode::sample_k(
+    int k, const std::shared_ptr<std::mt19937_64> rng) {
+  if (!weighted_sample) {
+    return RandomSampler::sample_index(degree, k, rng);
+  }
+  Layout layout = get_layout(has_alias);
+  return AliasSampler::sample_table(
+      reinterpret_cast<const float *>(data + layout.prob),
+      reinterpret_cast<const uint32_t *>(data + layout.alias),
+      degree,
+      k,
+      rng);
+}
+
+GraphNode *CompactGraphNode::to_graph_node() {
+  GraphNode *node = new GraphNode(id);
+  node->build_edges(weight_bits > 0);
+  for (uint32_t i = 0; i < degree; i++) {
+    node->add_edge(get_neighbor_id(i), get_float_weight(i));
+  }
+  return node;
+}
 void FeatureNode::to_buffer(char* buffer, bool need_feature) {
   memcpy(buffer, &id, id_size);
   buffer += id_size;
@@ -117,6 +117,57 @@ class GraphNode : public Node {
   GraphEdgeBlob *edges;
 };
 
+// CompactGraphNode keeps the edges of a GraphNode in one buffer, for the graph
+// tables that are loaded once and sampled many times. The neighbor ids are
+// sorted and split into blocks of kBlockSize, an id is stored as the delta to
+// the first id of its block, bit packed in the bits of the largest delta of
+// the block, so an id is still decoded in O(1). The weights are stored in
+// weight_bits (32, 16 or 8) bits, quantized linearly to the max weight of the
+// node. The weighted sampler is an alias table in the same buffer.
+// The neighbor order is by id after compaction, and the compacted node is
+// read only, GraphShard converts it back to a GraphNode to add edges.
+class CompactGraphNode : public Node {
+ public:
+  static constexpr int kBlockSize = 32;
+  CompactGraphNode(Node *node, bool is_weighted, int weight_bits);
+  virtual ~CompactGraphNode();
+  virtual void build_sampler(std::string sample_type);
+  virtual void add_edge(uint64_t id, float weight);
+  virtual std::vector<int> sample_k(
+      int k, const std::shared_ptr<std::mt19937_64> rng);
+  virtual uint64_t get_neighbor_id(int idx);
+#ifdef PADDLE_WITH_CUDA
+  virtual half get_neighbor_weight(int idx) {
+    return (half)(get_float_weight(idx));
+  }
+#else
+  virtual float get_neighbor_weight(int idx) { return get_float_weight(idx); }
+#endif
+  virtual size_t get_neighbor_size() { return degree; }
+  // The bytes of the edges.
+  size_t get_edge_bytes() const { return data_size; }
+  // Decode the edges to a GraphNode, the caller takes the ownership.
+  GraphNode *to_graph_node();
+
+ private:
+  struct Layout {
+    size_t base, prob, alias, weight, offset, width, bits;
+  };
+  Layout get_layout(bool with_alias) const;
+  void encode(const std::vector<uint64_t> &ids,
+              const std::vector<float> &weights,
+              bool with_alias);
+  float get_float_weight(int idx);
+
+  char *data;
+  size_t data_size;
+  uint32_t degree;
+  float weight_scale;
+  uint8_t weight_bits;
+  bool has_alias;
+  bool weighted_sample;
+};
+
 class FeatureNode : public Node {
  public:
   FeatureNode() : Node() {}
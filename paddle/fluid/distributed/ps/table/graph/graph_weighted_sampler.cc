@@ -14,9 +14,11 @@
 
 #include "paddle/fluid/distributed/ps/table/graph/graph_weighted_sampler.h"
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "paddle/phi/core/generator.h"
 namespace paddle {
@@ -26,7 +28,11 @@ void RandomSampler::build(GraphEdgeBlob *edges) { this->edges = edges; }
 
 std::vector<int> RandomSampler::sample_k(
     int k, const std::shared_ptr<std::mt19937_64> rng) {
-  int n = edges->size();
+  return sample_index(edges->size(), k, rng);
+}
+
+std::vector<int> RandomSampler::sample_index(
+    int n, int k, const std::shared_ptr<std::mt19937_64> rng) {
   if (k >= n) {
     k = n;
     std::vector<int> sample_result;
@@ -161,5 +167,125 @@ int WeightedSampler::sample(
   subtract_count_map[this]++;
   return return_idx;
 }
+
+void AliasSampler::build(GraphEdgeBlob *edges) {
+  int n = edges->size();
+  std::vector<float> weights(n);
+  for (int i = 0; i < n; i++) {
+    weights[i] = static_cast<float>(edges->get_weight(i));
+  }
+  prob.resize(n);
+  alias.resize(n);
+  build_table(weights.data(), n, prob.data(), alias.data());
+}
+
+std::vector<int> AliasSampler::sample_k(
+    int k, const std::shared_ptr<std::mt19937_64> rng) {
+  return sample_table(prob.data(), alias.data(), prob.size(), k, rng);
+}
+
+void AliasSampler::build_table(const float *weights,
+                               int n,
+                               float *prob,
+                               uint32_t *alias) {
+  double sum = 0;
+  for (int i = 0; i < n; i++) {
+    sum += std::max(weights[i], 0.0f);
+  }
+  std::vector<double> scaled(n);
+  std::vector<int> small, large;
+  for (int i = 0; i < n; i++) {
+    scaled[i] = sum > 0 ? std::max(weights[i], 0.0f) * n / sum : 1.0;
+    alias[i] = i;
+    if (scaled[i] < 1.0) {
+      small.push_back(i);
+    } else {
+      large.push_back(i);
+    }
+  }
+  while (!small.empty() && !large.empty()) {
+    int s = small.back();
+    int l = large.back();
+    small.pop_back();
+    prob[s] = scaled[s];
+    alias[s] = l;
+    scaled[l] -= 1.0 - scaled[s];
+    if (scaled[l] < 1.0) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // the rest are 1 up to the rounding errors
+  for (int i : small) prob[i] = 1.0f;
+  for (int i : large) prob[i] = 1.0f;
+}
+
+std::vector<int> AliasSampler::sample_table(
+    const float *prob,
+    const uint32_t *alias,
+    int n,
+    int k,
+    const std::shared_ptr<std::mt19937_64> rng) {
+  if (k >= n) {
+    return RandomSampler::sample_index(n, k, rng);
+  }
+  std::vector<int> sample_result;
+  std::unordered_set<int> sampled;
+  std::uniform_int_distribution<int> index_distrib(0, n - 1);
+  std::uniform_real_distribution<float> prob_distrib(0, 1.0);
+  // Rejecting the duplicates is fast unless k is close to n or the weights
+  // are skewed, then the rest are sampled from the remaining weights.
+  int max_try = 4 * k + 32;
+  while (static_cast<int>(sample_result.size()) < k && max_try-- > 0) {
+    int idx = index_distrib(*rng);
+    if (prob_distrib(*rng) >= prob[idx]) {
+      idx = alias[idx];
+    }
+    if (sampled.insert(idx).second) {
+      sample_result.push_back(idx);
+    }
+  }
+  if (static_cast<int>(sample_result.size()) == k) {
+    return sample_result;
+  }
+  // recover the weights (scaled by n) from the alias table
+  std::vector<double> weights(prob, prob + n);
+  for (int i = 0; i < n; i++) {
+    if (alias[i] != static_cast<uint32_t>(i)) {
+      weights[alias[i]] += 1.0 - prob[i];
+    }
+  }
+  double remain = 0;
+  for (int i = 0; i < n; i++) {
+    if (sampled.count(i) > 0) {
+      weights[i] = 0;
+    }
+    remain += weights[i];
+  }
+  std::uniform_real_distribution<double> weight_distrib(0, 1.0);
+  while (static_cast<int>(sample_result.size()) < k) {
+    int idx = -1;
+    if (remain > 0) {
+      double query = weight_distrib(*rng) * remain;
+      for (int i = 0; i < n; i++) {
+        if (weights[i] <= 0) continue;
+        idx = i;
+        query -= weights[i];
+        if (query < 0) break;
+      }
+    }
+    if (idx < 0) {
+      // the remaining edges are of weight 0
+      for (int i = 0; i < n && idx < 0; i++) {
+        if (sampled.count(i) == 0) idx = i;
+      }
+    }
+    remain -= weights[idx];
+    weights[idx] = 0;
+    sampled.insert(idx);
+    sample_result.push_back(idx);
+  }
+  return sample_result;
+}
 }  // namespace distributed
 }  // namespace paddle
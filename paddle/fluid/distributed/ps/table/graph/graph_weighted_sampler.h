@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <cstdint>
 #include <ctime>
 #include <memory>
 #include <random>
@@ -37,6 +38,9 @@ class RandomSampler : public Sampler {
   virtual void build(GraphEdgeBlob *edges);
   virtual std::vector<int> sample_k(int k,
                                     const std::shared_ptr<std::mt19937_64> rng);
+  // Sample k distinct indices of [0, n) uniformly.
+  static std::vector<int> sample_index(
+      int n, int k, const std::shared_ptr<std::mt19937_64> rng);
   GraphEdgeBlob *edges;
 };
 
@@ -62,5 +66,34 @@ class WeightedSampler : public Sampler {
       std::unordered_map<WeightedSampler *, int> &subtract_count_map,  // NOLINT
       float &subtract);                                                // NOLINT
 };
+
+// AliasSampler samples the weighted edges with an alias table, which is 8
+// bytes per edge and samples an edge in O(1), instead of the tree of
+// WeightedSampler. The k distinct edges are drawn one by one with the
+// duplicates rejected, which has the same distribution as WeightedSampler.
+class AliasSampler : public Sampler {
+ public:
+  virtual ~AliasSampler() {}
+  virtual void build(GraphEdgeBlob *edges);
+  virtual std::vector<int> sample_k(int k,
+                                    const std::shared_ptr<std::mt19937_64> rng);
+
+  // Build the alias table of n weights into prob[n] and alias[n], the
+  // weights of sum 0 are sampled uniformly.
+  static void build_table(const float *weights,
+                          int n,
+                          float *prob,
+                          uint32_t *alias);
+  static std::vector<int> sample_table(
+      const float *prob,
+      const uint32_t *alias,
+      int n,
+      int k,
+      const std::shared_ptr<std::mt19937_64> rng);
+
+ private:
+  std::vector<float> prob;
+  std::vector<uint32_t> alias;
+};
 }  // namespace distributed
 }  // namespace paddle
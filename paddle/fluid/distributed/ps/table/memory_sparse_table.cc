@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include <omp.h>
+#include <algorithm>
+#include <deque>
+#include <future>  // NOLINT
 #include <sstream>
 
 #include "glog/logging.h"
@@ -38,10 +41,96 @@ PD_DEFINE_bool(pserver_enable_create_feasign_randomly,
 PD_DEFINE_int32(pserver_table_save_max_retry,
                 3,
                 "pserver_table_save_max_retry");
+PD_DEFINE_bool(pserver_sparse_table_concurrent_shard,
+               false,
+               "split the keys of one shard into several tasks running "
+               "concurrently in pull and push, guarded by bucket locks");
+PD_DEFINE_int32(pserver_sparse_table_min_keys_per_task,
+                4096,
+                "min number of keys of a shard task when "
+                "pserver_sparse_table_concurrent_shard is true");
+PD_DEFINE_bool(pserver_sparse_table_direct_call,
+               false,
+               "run the pull and push in the calling threads instead of the "
+               "task pool, the threads share the shards by the bucket locks, "
+               "for the hogwild threads of the local ps");
+PD_DEFINE_bool(pserver_sparse_table_track_delta,
+               false,
+               "track the features changed since the last checkpoint, which "
+               "are saved and loaded by delta checkpoint (param 6)");
+PD_DEFINE_bool(pserver_sparse_table_pipeline_load,
+               false,
+               "load the text files of sparse table by chunks, parsed by the "
+               "task pool while the file is being read");
+PD_DEFINE_int32(pserver_sparse_table_load_chunk_size,
+                4 * 1024 * 1024,
+                "bytes of a text chunk of the pipelined sparse table load");
+PD_DEFINE_int32(pserver_sparse_table_load_pipeline_depth,
+                8,
+                "max number of chunks being parsed per file in the pipelined "
+                "sparse table load");
+PD_DEFINE_bool(pserver_sparse_table_binary_save,
+               false,
+               "save the checkpoint and batch model (param 0 and 3) of sparse "
+               "table in the binary columnar format, which is always loaded "
+               "by the pipelined load");
 
 namespace paddle {
 namespace distributed {
 
+namespace {
+// Lock the bucket of a key if the shard is accessed concurrently.
+class ShardBucketGuard {
+ public:
+  ShardBucketGuard(MemorySparseTable::shard_type *shard, size_t bucket)
+      : mutex_(shard->concurrent() ? &shard->bucket_mutex(bucket) : nullptr) {
+    if (mutex_ != nullptr) {
+      mutex_->lock();
+    }
+  }
+  ~ShardBucketGuard() {
+    if (mutex_ != nullptr) {
+      mutex_->unlock();
+    }
+  }
+
+ private:
+  std::mutex *mutex_;
+};
+
+// PushUpdateGroup defers the in-place updates of a push task, so that the
+// accessor updates the features in groups. The value pointers are valid until
+// a feature is created in the shard, the group is flushed before that.
+class PushUpdateGroup {
+ public:
+  explicit PushUpdateGroup(ValueAccessor *accessor) : accessor_(accessor) {
+    values_.reserve(kGroupSize);
+    updates_.reserve(kGroupSize);
+  }
+
+  void Add(float *value, const float *update) {
+    values_.push_back(value);
+    updates_.push_back(update);
+    if (values_.size() >= kGroupSize) {
+      Flush();
+    }
+  }
+  void Flush() {
+    if (!values_.empty()) {
+      accessor_->Update(values_.data(), updates_.data(), values_.size());
+      values_.clear();
+      updates_.clear();
+    }
+  }
+
+ private:
+  static constexpr size_t kGroupSize = 64;
+  ValueAccessor *accessor_;
+  std::vector<float *> values_;
+  std::vector<const float *> updates_;
+};
+}  // namespace
+
 int32_t MemorySparseTable::Initialize() {
   auto &profiler = CostProfiler::instance();
   profiler.register_profiler("pserver_sparse_update_all");
@@ -75,7 +164,11 @@ int32_t MemorySparseTable::InitializeValue() {
           << " _real_local_shard_num: " << _real_local_shard_num
           << " _task_pool_size:" << _task_pool_size;
 
-  _local_shards.reset(new shard_type[_real_local_shard_num]);
+  _local_shards = CreateLocalShards();
+  _evict_cursors.reset(new std::atomic<size_t>[_real_local_shard_num]());
+  if (FLAGS_pserver_sparse_table_track_delta) {
+    _delta_keys.reset(new DeltaKeys[_real_local_shard_num]);
+  }
 
   if (_config.enable_revert()) {
     // calculate merged shard number based on config param;
@@ -99,7 +192,7 @@ int32_t MemorySparseTable::InitializeValue() {
     LOG(INFO) << "merged shard info: [" << _m_sparse_table_shard_num << "|"
               << _m_avg_local_shard_num << "|" << _m_real_local_shard_num
               << "]";
-    _local_shards_new.reset(new shard_type[_real_local_shard_num]);  // NOLINT
+    _local_shards_new = CreateLocalShards();
   }
   return 0;
 }
@@ -129,6 +222,9 @@ int32_t MemorySparseTable::Load(const std::string &path,
   if (load_param == 5) {
     return LoadPatch(file_list, load_param);
   }
+  if (load_param == kDeltaSaveParam) {
+    return LoadDelta(file_list);
+  }
 
   size_t file_start_idx = _shard_idx * _avg_local_shard_num;
 
@@ -166,14 +262,23 @@ int32_t MemorySparseTable::Load(const std::string &path,
       auto read_channel = _afs_client.open_r(channel_config, 0, &err_no);
       char *end = NULL;
       auto &shard = _local_shards[i];
+      bool is_binary = IsSparseBinaryFile(channel_config.path);
       try {
-        while (read_channel->read_line(line_data) == 0 &&
-               line_data.size() > 1) {
-          uint64_t key = std::strtoul(line_data.data(), &end, 10);
-          auto &value = shard[key];
-          value.resize(feature_value_size);
-          int parse_size = _value_accesor->ParseFromString(++end, value.data());
-          value.resize(parse_size);
+        if (is_binary || FLAGS_pserver_sparse_table_pipeline_load) {
+          if (0 != LoadShardPipelined(
+                       read_channel.get(), i, is_binary, feature_value_size)) {
+            err_no = -1;
+          }
+        } else {
+          while (read_channel->read_line(line_data) == 0 &&
+                 line_data.size() > 1) {
+            uint64_t key = std::strtoul(line_data.data(), &end, 10);
+            auto &value = shard[key];
+            value.resize(feature_value_size);
+            int parse_size =
+                _value_accesor->ParseFromString(++end, value.data());
+            value.resize(parse_size);
+          }
         }
         read_channel->close();
         if (err_no == -1) {
@@ -195,6 +300,8 @@ int32_t MemorySparseTable::Load(const std::string &path,
       }
     } while (is_read_failed);
   }
+  // the table is the same as the checkpoint now
+  ResetDelta();
   LOG(INFO) << "MemorySparseTable load success, path from "
             << file_list[file_start_idx] << " to "
             << file_list[file_start_idx + _real_local_shard_num - 1];
@@ -300,6 +407,110 @@ int32_t MemorySparseTable::LoadPatch(const std::vector<std::string> &file_list,
   return 0;
 }
 
+int32_t MemorySparseTable::LoadShardPipelined(FsReadChannel *read_channel,
+                                              int shard_id,
+                                              bool is_binary,
+                                              size_t feature_value_size) {
+  auto &shard = _local_shards[shard_id];
+  SparseLineChunkReader line_reader(
+      read_channel, std::max(FLAGS_pserver_sparse_table_load_chunk_size, 1));
+  size_t pipeline_depth =
+      std::max(FLAGS_pserver_sparse_table_load_pipeline_depth, 1);
+  // the chunks are parsed by the task pool, and inserted by this thread in
+  // the order of the file while the following chunks are read and parsed
+  std::deque<std::future<std::unique_ptr<SparseFeatureBlock>>> parsing;
+  bool is_corrupted = false;
+  auto insert_front = [&]() {
+    std::unique_ptr<SparseFeatureBlock> block = parsing.front().get();
+    parsing.pop_front();
+    if (!block) {
+      is_corrupted = true;
+      return;
+    }
+    const float *value_data = block->values.data();
+    for (size_t k = 0; k < block->keys.size(); ++k) {
+      auto &value = shard[block->keys[k]];
+      value.resize(block->sizes[k]);
+      memcpy(value.data(), value_data, block->sizes[k] * sizeof(float));
+      value_data += block->sizes[k];
+    }
+  };
+
+  for (size_t chunk_idx = 0; !is_corrupted; ++chunk_idx) {
+    auto chunk = std::make_shared<std::string>();
+    if (is_binary) {
+      int ret =
+          ReadSparseBinaryChunk(read_channel, chunk_idx == 0, chunk.get());
+      if (ret < 0) {
+        is_corrupted = true;
+      }
+      if (ret <= 0) {
+        break;
+      }
+    } else if (!line_reader.Next(chunk.get())) {
+      break;
+    }
+    parsing.push_back(
+        _shards_task_pool[(shard_id + chunk_idx) % _shards_task_pool.size()]
+            ->enqueue([this, chunk, is_binary, feature_value_size]() {
+              auto block = std::make_unique<SparseFeatureBlock>();
+              bool is_valid =
+                  is_binary ? DecodeSparseBinaryChunk(*chunk, block.get())
+                            : ParseTextChunk(
+                                  chunk.get(), feature_value_size, block.get());
+              if (!is_valid) {
+                block.reset();
+              }
+              return block;
+            }));
+    if (parsing.size() >= pipeline_depth) {
+      insert_front();
+    }
+  }
+  while (!parsing.empty()) {
+    insert_front();
+  }
+  if (is_corrupted) {
+    LOG(ERROR) << "MemorySparseTable load corrupted file into local shard "
+               << shard_id;
+    return -1;
+  }
+  return 0;
+}
+
+bool MemorySparseTable::ParseTextChunk(std::string *chunk,
+                                       size_t feature_value_size,
+                                       SparseFeatureBlock *block) {
+  char *cursor = &(*chunk)[0];
+  char *chunk_end = cursor + chunk->size();
+  while (cursor < chunk_end) {
+    char *line_end =
+        static_cast<char *>(memchr(cursor, '\n', chunk_end - cursor));
+    if (line_end == nullptr) {
+      // the last line without '\n', terminated by the string
+      line_end = chunk_end;
+    } else {
+      *line_end = '\0';
+    }
+    if (line_end - cursor > 1) {
+      char *end = NULL;
+      uint64_t key = ParseSparseKey(cursor, &end);
+      if (end == cursor) {
+        return false;
+      }
+      size_t offset = block->values.size();
+      block->values.resize(offset + feature_value_size);
+      int parse_size =
+          _value_accesor->ParseFromString(++end, block->values.data() + offset);
+      block->values.resize(offset + parse_size);
+      block->keys.push_back(key);
+      block->sizes.push_back(parse_size);
+    }
+    cursor = line_end + 1;
+  }
+  return true;
+}
+
 void MemorySparseTable::Revert() {
   for (int i = 0; i < _real_local_shard_num; ++i) {
     _local_shards_new[i].clear();
@@ -310,6 +521,246 @@ void MemorySparseTable::CheckSavePrePatchDone() {
   _save_patch_model_thread.join();
 }
 
+namespace {
+// the line of a deleted feature in the delta checkpoint is "<key> -"
+const char kDeltaTombstone[] = " -";
+}  // namespace
+
+void MemorySparseTable::ResetDelta() {
+  if (!_delta_keys) {
+    return;
+  }
+  for (int i = 0; i < _real_local_shard_num; ++i) {
+    for (auto &keys : _delta_keys[i].buckets) {
+      keys.clear();
+    }
+  }
+  _delta_save_all = false;
+}
+
+void MemorySparseTable::UpdateDeltaAfterSave(int save_param) {
+  if (save_param == 0) {
+    // the checkpoint is the new base of the delta checkpoints
+    ResetDelta();
+  } else if (save_param == 3 && _delta_keys) {
+    // the unseen days of all the features are increased
+    _delta_save_all = true;
+  }
+}
+
+int32_t MemorySparseTable::SaveDelta(const std::string &dirname) {
+  if (!_delta_keys) {
+    LOG(ERROR) << "MemorySparseTable delta save needs "
+                  "FLAGS_pserver_sparse_table_track_delta";
+    return -1;
+  }
+  if (_real_local_shard_num == 0) {
+    return 0;
+  }
+  std::string table_path = TableDir(dirname);
+  _afs_client.remove(::paddle::string::format_string(
+      "%s/part-%03d-*", table_path.c_str(), _shard_idx));
+  size_t file_start_idx = _avg_local_shard_num * _shard_idx;
+  std::atomic<uint32_t> feasign_size_all{0};
+  std::atomic<uint32_t> tombstone_size_all{0};
+
+  int thread_num = _real_local_shard_num < 20 ? _real_local_shard_num : 20;
+  omp_set_num_threads(thread_num);
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < _real_local_shard_num; ++i) {
+    FsChannelConfig channel_config;
+    channel_config.path = ::paddle::string::format_string("%s/part-%03d-%05d",
+                                                          table_path.c_str(),
+                                                          _shard_idx,
+                                                          file_start_idx + i);
+    channel_config.converter =
+        _value_accesor->Converter(kDeltaSaveParam).converter;
+    channel_config.deconverter =
+        _value_accesor->Converter(kDeltaSaveParam).deconverter;
+    auto &delta_keys = _delta_keys[i];
+    bool is_write_failed = false;
+    int feasign_size = 0;
+    int tombstone_size = 0;
+    int retry_num = 0;
+    int err_no = 0;
+    do {
+      err_no = 0;
+      feasign_size = 0;
+      tombstone_size = 0;
+      is_write_failed = false;
+      auto write_channel =
+          _afs_client.open_w(channel_config, 1024 * 1024 * 40, &err_no);
+      auto write_line = [&](const std::string &line) {
+        if (!is_write_failed && 0 != write_channel->write_line(line)) {
+          is_write_failed = true;
+        }
+        return !is_write_failed;
+      };
+      auto write_value = [&](uint64_t key, const float *value, size_t size) {
+        std::string format_value = _value_accesor->ParseToString(value, size);
+        if (write_line(::paddle::string::format_string(
+                "%lu %s", key, format_value.c_str()))) {
+          ++feasign_size;
+        }
+      };
+
+      // the deleted features are written as the tombstones, the others are
+      // written here unless all the features are written below
+      std::vector<float> value;
+      for (auto &keys : delta_keys.buckets) {
+        for (uint64_t key : keys) {
+          if (FindDeltaValue(i, key, &value)) {
+            if (!_delta_save_all) {
+              write_value(key, value.data(), value.size());
+            }
+          } else if (write_line(::paddle::string::format_string(
+                         "%lu%s", key, kDeltaTombstone))) {
+            ++tombstone_size;
+          }
+          if (is_write_failed) break;
+        }
+        if (is_write_failed) break;
+      }
+      if (_delta_save_all && !is_write_failed) {
+        VisitShardValues(i, write_value);
+      }
+      write_channel->close();
+      if (err_no == -1) {
+        is_write_failed = true;
+      }
+      if (is_write_failed) {
+        ++retry_num;
+        LOG(ERROR) << "MemorySparseTable save delta failed, retry it! path:"
+                   << channel_config.path << " , retry_num=" << retry_num;
+        _afs_client.remove(channel_config.path);
+      }
+      if (retry_num > FLAGS_pserver_table_save_max_retry) {
+        LOG(ERROR) << "MemorySparseTable save delta failed reach max limit!";
+        exit(-1);
+      }
+    } while (is_write_failed);
+    for (auto &keys : delta_keys.buckets) {
+      keys.clear();
+    }
+    feasign_size_all += feasign_size;
+    tombstone_size_all += tombstone_size;
+  }
+  LOG(INFO) << "MemorySparseTable save delta success, path:"
+            << ::paddle::string::format_string("%s/%03d/part-%03d-",
+                                               dirname.c_str(),
+                                               _config.table_id(),
+                                               _shard_idx)
+            << " from " << file_start_idx << " to "
+            << file_start_idx + _real_local_shard_num - 1
+            << ", save all: " << _delta_save_all
+            << ", feasign size: " << feasign_size_all
+            << ", deleted size: " << tombstone_size_all;
+  _delta_save_all = false;
+  return 0;
+}
+
+int32_t MemorySparseTable::LoadDelta(
+    const std::vector<std::string> &origin_file_list) {
+  std::vector<std::string> file_list(origin_file_list);
+  std::sort(file_list.begin(), file_list.end());
+  size_t file_start_idx = _shard_idx * _avg_local_shard_num;
+  if (file_start_idx >= file_list.size()) {
+    return 0;
+  }
+  size_t feature_value_size =
+      _value_accesor->GetAccessorInfo().size / sizeof(float);
+  int thread_num = _real_local_shard_num < 15 ? _real_local_shard_num : 15;
+  omp_set_num_threads(thread_num);
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < _real_local_shard_num; ++i) {
+    FsChannelConfig channel_config;
+    channel_config.path = file_list[file_start_idx + i];
+    channel_config.converter =
+        _value_accesor->Converter(kDeltaSaveParam).converter;
+    channel_config.deconverter =
+        _value_accesor->Converter(kDeltaSaveParam).deconverter;
+    bool is_read_failed = false;
+    int retry_num = 0;
+    int err_no = 0;
+    // applying a delta file again is harmless, so it is retried as a whole
+    do {
+      is_read_failed = false;
+      err_no = 0;
+      std::string line_data;
+      std::vector<float> value(feature_value_size);
+      auto read_channel = _afs_client.open_r(channel_config, 0, &err_no);
+      char *end = NULL;
+      try {
+        while (read_channel->read_line(line_data) == 0 &&
+               line_data.size() > 1) {
+          uint64_t key = std::strtoul(line_data.data(), &end, 10);
+          if (strcmp(end, kDeltaTombstone) == 0) {
+            ApplyDeltaTombstone(i, key);
+            continue;
+          }
+          int parse_size = _value_accesor->ParseFromString(++end, value.data());
+          ApplyDeltaValue(i, key, value.data(), parse_size);
+        }
+        read_channel->close();
+        if (err_no == -1) {
+          ++retry_num;
+          is_read_failed = true;
+          LOG(ERROR) << "MemorySparseTable load delta failed after read, "
+                        "retry it! path:"
+                     << channel_config.path << " , retry_num=" << retry_num;
+        }
+      } catch (...) {
+        ++retry_num;
+        is_read_failed = true;
+        LOG(ERROR) << "MemorySparseTable load delta failed, retry it! path:"
+                   << channel_config.path << " , retry_num=" << retry_num;
+      }
+      if (retry_num > FLAGS_pserver_table_save_max_retry) {
+        LOG(ERROR) << "MemorySparseTable load delta failed reach max limit!";
+        exit(-1);
+      }
+    } while (is_read_failed);
+  }
+  LOG(INFO) << "MemorySparseTable load delta success, path from "
+            << file_list[file_start_idx] << " to "
+            << file_list[file_start_idx + _real_local_shard_num - 1];
+  return 0;
+}
+
+bool MemorySparseTable::FindDeltaValue(int shard_id,
+                                       uint64_t key,
+                                       std::vector<float> *value) {
+  auto &shard = _local_shards[shard_id];
+  auto it = shard.find(key);
+  if (it == shard.end()) {
+    return false;
+  }
+  value->assign(it.value().data(), it.value().data() + it.value().size());
+  return true;
+}
+
+void MemorySparseTable::VisitShardValues(
+    int shard_id,
+    const std::function<void(uint64_t, const float *, size_t)> &visitor) {
+  auto &shard = _local_shards[shard_id];
+  for (auto it = shard.begin(); it != shard.end(); ++it) {
+    visitor(it.key(), it.value().data(), it.value().size());
+  }
+}
+
+void MemorySparseTable::ApplyDeltaValue(int shard_id,
+                                        uint64_t key,
+                                        const float *value,
+                                        size_t size) {
+  auto &feature_value = _local_shards[shard_id][key];
+  feature_value.resize(size);
+  memcpy(feature_value.data(), value, size * sizeof(float));
+}
+
+void MemorySparseTable::ApplyDeltaTombstone(int shard_id, uint64_t key) {
+  _local_shards[shard_id].erase(key);
+}
+
 int32_t MemorySparseTable::Save(const std::string &dirname,
                                 const std::string &param) {
   if (_real_local_shard_num == 0) {
@@ -321,10 +772,14 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
   int save_param =
       atoi(param.c_str());  // checkpoint:0  xbox delta:1  xbox base:2
 
+  if (save_param == kDeltaSaveParam) {
+    return SaveDelta(dirname);
+  }
+
   // patch model
   if (save_param == 5) {
     _local_shards_patch_model.reset(_local_shards_new.release());
-    _local_shards_new.reset(new shard_type[_real_local_shard_num]);  // NOLINT
+    _local_shards_new = CreateLocalShards();
     _save_patch_model_thread = std::thread(std::bind(
         &MemorySparseTable::SavePatch, this, std::string(dirname), save_param));
     return 0;
@@ -350,18 +805,17 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
 #pragma omp parallel for schedule(dynamic)
   for (int i = 0; i < _real_local_shard_num; ++i) {
     FsChannelConfig channel_config;
-    if (_config.compress_in_save() && (save_param == 0 || save_param == 3)) {
-      channel_config.path =
-          ::paddle::string::format_string("%s/part-%03d-%05d.gz",
-                                          table_path.c_str(),
-                                          _shard_idx,
-                                          file_start_idx + i);
-    } else {
-      channel_config.path = ::paddle::string::format_string("%s/part-%03d-%05d",
-                                                            table_path.c_str(),
-                                                            _shard_idx,
-                                                            file_start_idx + i);
-    }
+    // the checkpoint and batch model are loaded by the pserver again
+    bool is_reloaded = save_param == 0 || save_param == 3;
+    bool is_binary = FLAGS_pserver_sparse_table_binary_save && is_reloaded;
+    bool is_compressed = _config.compress_in_save() && is_reloaded;
+    channel_config.path = ::paddle::string::format_string(
+        "%s/part-%03d-%05d%s%s",
+        table_path.c_str(),
+        _shard_idx,
+        file_start_idx + i,
+        is_binary ? kSparseBinarySuffix : "",
+        is_compressed ? ".gz" : "");
     channel_config.converter = _value_accesor->Converter(save_param).converter;
     channel_config.deconverter =
         _value_accesor->Converter(save_param).deconverter;
@@ -384,6 +838,7 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
       is_write_failed = false;
       auto write_channel =
           _afs_client.open_w(channel_config, 1024 * 1024 * 40, &err_no);
+      SparseBinaryWriter binary_writer(write_channel.get(), 10000);
       for (auto it = shard.begin(); it != shard.end(); ++it) {
         if (_config.enable_sparse_table_cache() &&
             (save_param == 1 || save_param == 2) &&
@@ -393,10 +848,17 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
         }
 
         if (_value_accesor->Save(it.value().data(), save_param)) {
-          std::string format_value = _value_accesor->ParseToString(
-              it.value().data(), it.value().size());
-          if (0 != write_channel->write_line(::paddle::string::format_string(
-                       "%lu %s", it.key(), format_value.c_str()))) {
+          int ret = 0;
+          if (is_binary) {
+            ret = binary_writer.Append(
+                it.key(), it.value().data(), it.value().size());
+          } else {
+            std::string format_value = _value_accesor->ParseToString(
+                it.value().data(), it.value().size());
+            ret = write_channel->write_line(::paddle::string::format_string(
+                "%lu %s", it.key(), format_value.c_str()));
+          }
+          if (0 != ret) {
             ++retry_num;
             is_write_failed = true;
             LOG(ERROR)
@@ -407,6 +869,12 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
           ++feasign_size;
         }
       }
+      if (is_binary && !is_write_failed && 0 != binary_writer.Flush()) {
+        ++retry_num;
+        is_write_failed = true;
+        LOG(ERROR) << "MemorySparseTable save prefix failed, retry it! path:"
+                   << channel_config.path << " , retry_num=" << retry_num;
+      }
       write_channel->close();
       if (err_no == -1) {
         ++retry_num;
@@ -438,6 +906,7 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
     LOG(INFO) << "MemorySparseTable save prefix success, path: "
               << channel_config.path << " feasign_size: " << feasign_size;
   }
+  UpdateDeltaAfterSave(save_param);
   _local_show_threshold = tk.top();
   // int32 may overflow need to change return value
   return 0;
@@ -460,10 +929,14 @@ int32_t MemorySparseTable::Save_v2(const std::string &dirname,
   int save_param =
       atoi(param.c_str());  // checkpoint:0  xbox delta:1  xbox base:2
 
+  if (save_param == kDeltaSaveParam) {
+    return SaveDelta(dirname);
+  }
+
   // patch model
   if (save_param == 5) {
     _local_shards_patch_model.reset(_local_shards_new.release());
-    _local_shards_new.reset(new shard_type[_real_local_shard_num]);
+    _local_shards_new = CreateLocalShards();
     _save_patch_model_thread = std::thread(std::bind(
         &MemorySparseTable::SavePatch, this, std::string(dirname), save_param));
     return 0;
@@ -646,6 +1119,7 @@ int32_t MemorySparseTable::Save_v2(const std::string &dirname,
               << ", feature path:" << channel_config_for_slot_feature.path
               << ", feature feasign size:" << feasign_size_for_slot_feature;
   }
+  UpdateDeltaAfterSave(save_param);
   _local_show_threshold = tk.top();
   // int32 may overflow need to change return value
   return 0;
@@ -973,7 +1447,7 @@ int32_t MemorySparseTable::Push(TableContext &context) {
 int32_t MemorySparseTable::PullSparse(float *pull_values,
                                       const PullSparseValue &pull_value) {
   CostTimer timer("pserver_sparse_select_all");
-  std::vector<std::future<int>> tasks(_real_local_shard_num);
+  std::vector<std::future<int>> tasks;
 
   const size_t value_size =
       _value_accesor->GetAccessorInfo().size / sizeof(float);
@@ -992,53 +1466,70 @@ int32_t MemorySparseTable::PullSparse(float *pull_values,
     task_keys[shard_id].push_back({pull_value.feasigns_[i], i});
   }
   for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
-    tasks[shard_id] =
-        _shards_task_pool[shard_id % _shards_task_pool.size()]->enqueue(
-            [this,
-             shard_id,
-             &task_keys,
-             value_size,
-             pull_values,
-             mf_value_size,
-             select_value_size]() -> int {
-              auto &local_shard = _local_shards[shard_id];
-              float data_buffer[value_size];  // NOLINT
-              float *data_buffer_ptr = data_buffer;
-
-              auto &keys = task_keys[shard_id];
-              for (auto &item : keys) {
-                uint64_t key = item.first;
-                auto itr = local_shard.find(key);
-                size_t data_size = value_size - mf_value_size;
-                if (itr == local_shard.end()) {
-                  // ++missed_keys;
-                  if (FLAGS_pserver_create_value_when_push) {
-                    memset(data_buffer, 0, sizeof(float) * data_size);
+    size_t key_num = task_keys[shard_id].size();
+    size_t task_num = ShardTaskNum(key_num);
+    for (size_t task_idx = 0; task_idx < task_num; ++task_idx) {
+      size_t begin = key_num * task_idx / task_num;
+      size_t end = key_num * (task_idx + 1) / task_num;
+      tasks.push_back(
+          RunShardTask(
+              shard_id + task_idx,
+              [this,
+               shard_id,
+               begin,
+               end,
+               &task_keys,
+               value_size,
+               pull_values,
+               mf_value_size,
+               select_value_size]() -> int {
+                auto &local_shard = _local_shards[shard_id];
+                float data_buffer[value_size];  // NOLINT
+                float *data_buffer_ptr = data_buffer;
+
+                auto &keys = task_keys[shard_id];
+                for (size_t i = begin; i < end; ++i) {
+                  auto &item = keys[i];
+                  uint64_t key = item.first;
+                  size_t bucket = local_shard.compute_bucket_by_key(key);
+                  ShardBucketGuard guard(&local_shard, bucket);
+                  auto itr = local_shard.find(bucket, key);
+                  size_t data_size = value_size - mf_value_size;
+                  if (itr == local_shard.end(bucket)) {
+                    // ++missed_keys;
+                    // the features not admitted are created by push
+                    if (FLAGS_pserver_create_value_when_push ||
+                        _value_accesor->HasAdmissionPolicy()) {
+                      memset(data_buffer, 0, sizeof(float) * data_size);
+                    } else {
+                      auto &feature_value = local_shard[key];
+                      feature_value.resize(data_size);
+                      float *data_ptr = feature_value.data();
+                      _value_accesor->Create(&data_buffer_ptr, 1);
+                      memcpy(data_ptr,
+                             data_buffer_ptr,
+                             data_size * sizeof(float));
+                      MarkDelta(shard_id, bucket, key);
+                    }
                   } else {
-                    auto &feature_value = local_shard[key];
-                    feature_value.resize(data_size);
-                    float *data_ptr = feature_value.data();
-                    _value_accesor->Create(&data_buffer_ptr, 1);
-                    memcpy(
-                        data_ptr, data_buffer_ptr, data_size * sizeof(float));
+                    data_size = itr.value().size();
+                    memcpy(data_buffer_ptr,
+                           itr.value().data(),
+                           data_size * sizeof(float));
                   }
-                } else {
-                  data_size = itr.value().size();
-                  memcpy(data_buffer_ptr,
-                         itr.value().data(),
-                         data_size * sizeof(float));
-                }
-                for (size_t mf_idx = data_size; mf_idx < value_size; ++mf_idx) {
-                  data_buffer[mf_idx] = 0.0;
+                  for (size_t mf_idx = data_size; mf_idx < value_size;
+                       ++mf_idx) {
+                    data_buffer[mf_idx] = 0.0;
+                  }
+                  auto offset = item.second;
+                  float *select_data = pull_values + select_value_size * offset;
+                  _value_accesor->Select(
+                      &select_data, (const float **)&data_buffer_ptr, 1);
                 }
-                auto offset = item.second;
-                float *select_data = pull_values + select_value_size * offset;
-                _value_accesor->Select(
-                    &select_data, (const float **)&data_buffer_ptr, 1);
-              }
 
-              return 0;
-            });
+                return 0;
+              }));
+    }
   }
 
   for (auto &task : tasks) {
@@ -1053,11 +1544,12 @@ int32_t MemorySparseTable::PullSparsePtr(int shard_id,  // fake num
                                          size_t num,
                                          uint16_t pass_id) {
   CostTimer timer("pscore_sparse_select_all");
+  _pulled_by_ptr = true;
   size_t value_size = _value_accesor->GetAccessorInfo().size / sizeof(float);
   size_t mf_value_size =
       _value_accesor->GetAccessorInfo().mf_size / sizeof(float);
 
-  std::vector<std::future<int>> tasks(_real_local_shard_num);
+  std::vector<std::future<int>> tasks;
   std::vector<std::vector<std::pair<uint64_t, int>>> task_keys(
       _real_local_shard_num);
   for (size_t i = 0; i < num; ++i) {
@@ -1066,39 +1558,54 @@ int32_t MemorySparseTable::PullSparsePtr(int shard_id,  // fake num
   }
   // std::atomic<uint32_t> missed_keys{0};
   for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
-    tasks[shard_id] =
-        _shards_task_pool[shard_id % _shards_task_pool.size()]->enqueue(
-            [this,
-             shard_id,
-             &task_keys,
-             pull_values,
-             value_size,
-             mf_value_size]() -> int {
-              auto &keys = task_keys[shard_id];
-              auto &local_shard = _local_shards[shard_id];
-              float data_buffer[value_size];  // NOLINT
-              float *data_buffer_ptr = data_buffer;
-              for (auto &item : keys) {
-                uint64_t key = item.first;
-                auto itr = local_shard.find(key);
-                size_t data_size = value_size - mf_value_size;
-                FixedFeatureValue *ret = NULL;
-                if (itr == local_shard.end()) {
-                  // ++missed_keys;
-                  auto &feature_value = local_shard[key];
-                  feature_value.resize(data_size);
-                  float *data_ptr = feature_value.data();
-                  _value_accesor->Create(&data_buffer_ptr, 1);
-                  memcpy(data_ptr, data_buffer_ptr, data_size * sizeof(float));
-                  ret = &feature_value;
-                } else {
-                  ret = itr.value_ptr();
+    size_t key_num = task_keys[shard_id].size();
+    size_t task_num = ShardTaskNum(key_num);
+    for (size_t task_idx = 0; task_idx < task_num; ++task_idx) {
+      size_t begin = key_num * task_idx / task_num;
+      size_t end = key_num * (task_idx + 1) / task_num;
+      tasks.push_back(
+          RunShardTask(
+              shard_id + task_idx,
+              [this,
+               shard_id,
+               begin,
+               end,
+               &task_keys,
+               pull_values,
+               value_size,
+               mf_value_size]() -> int {
+                auto &keys = task_keys[shard_id];
+                auto &local_shard = _local_shards[shard_id];
+                float data_buffer[value_size];  // NOLINT
+                float *data_buffer_ptr = data_buffer;
+                for (size_t i = begin; i < end; ++i) {
+                  auto &item = keys[i];
+                  uint64_t key = item.first;
+                  size_t bucket = local_shard.compute_bucket_by_key(key);
+                  ShardBucketGuard guard(&local_shard, bucket);
+                  auto itr = local_shard.find(bucket, key);
+                  size_t data_size = value_size - mf_value_size;
+                  FixedFeatureValue *ret = NULL;
+                  if (itr == local_shard.end(bucket)) {
+                    // ++missed_keys;
+                    auto &feature_value = local_shard[key];
+                    feature_value.resize(data_size);
+                    float *data_ptr = feature_value.data();
+                    _value_accesor->Create(&data_buffer_ptr, 1);
+                    memcpy(
+                        data_ptr, data_buffer_ptr, data_size * sizeof(float));
+                    ret = &feature_value;
+                  } else {
+                    ret = itr.value_ptr();
+                  }
+                  // the value may be updated through the pointer
+                  MarkDelta(shard_id, bucket, key);
+                  int pull_data_idx = item.second;
+                  pull_values[pull_data_idx] = reinterpret_cast<char *>(ret);
                 }
-                int pull_data_idx = item.second;
-                pull_values[pull_data_idx] = reinterpret_cast<char *>(ret);
-              }
-              return 0;
-            });
+                return 0;
+              }));
+    }
   }
   for (auto &task : tasks) {
     task.wait();
@@ -1110,7 +1617,7 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
                                       const float *values,
                                       size_t num) {
   CostTimer timer("pserver_sparse_update_all");
-  std::vector<std::future<int>> tasks(_real_local_shard_num);
+  std::vector<std::future<int>> tasks;
   std::vector<std::vector<std::pair<uint64_t, int>>> task_keys(
       _real_local_shard_num);
   for (size_t i = 0; i < num; ++i) {
@@ -1126,69 +1633,101 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
       _value_accesor->GetAccessorInfo().update_size / sizeof(float);
 
   for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
-    tasks[shard_id] = _shards_task_pool[shard_id % _task_pool_size]->enqueue(
-        [this,
-         shard_id,
-         value_col,
-         mf_value_col,
-         update_value_col,
-         values,
-         &task_keys]() -> int {
-          auto &keys = task_keys[shard_id];
-          auto &local_shard = _local_shards[shard_id];
-          auto &local_shard_new = _local_shards_new[shard_id];
-          float data_buffer[value_col];  // NOLINT
-          float *data_buffer_ptr = data_buffer;
-          for (auto &item : keys) {
-            uint64_t key = item.first;
-            uint64_t push_data_idx = item.second;
-            const float *update_data =
-                values + push_data_idx * update_value_col;
-            auto itr = local_shard.find(key);
-            if (itr == local_shard.end()) {
-              if (FLAGS_pserver_enable_create_feasign_randomly &&
-                  !_value_accesor->CreateValue(1, update_data)) {
-                continue;
-              }
-              auto value_size = value_col - mf_value_col;
-              auto &feature_value = local_shard[key];
-              feature_value.resize(value_size);
-              _value_accesor->Create(&data_buffer_ptr, 1);
-              memcpy(feature_value.data(),
-                     data_buffer_ptr,
-                     value_size * sizeof(float));
-              itr = local_shard.find(key);
-            }
-
-            auto &feature_value = itr.value();
-            float *value_data = feature_value.data();
-            size_t value_size = feature_value.size();
-
-            if (value_size == value_col) {  // 已拓展到最大size, 则就地update
-              _value_accesor->Update(&value_data, &update_data, 1);
-            } else {
-              // 拷入buffer区进行update，然后再回填，不需要的mf则回填时抛弃了
-              memcpy(data_buffer_ptr, value_data, value_size * sizeof(float));
-              _value_accesor->Update(&data_buffer_ptr, &update_data, 1);
-
-              if (_value_accesor->NeedExtendMF(data_buffer)) {
-                feature_value.resize(value_col);
-                value_data = feature_value.data();
-                _value_accesor->Create(&value_data, 1);
-              }
-              memcpy(value_data, data_buffer_ptr, value_size * sizeof(float));
-            }
-            if (_config.enable_revert()) {
-              FixedFeatureValue *feature_value_new = &(local_shard_new[key]);
-              auto new_size = feature_value.size();
-              feature_value_new->resize(new_size);
-              memcpy(feature_value_new->data(),
-                     value_data,
-                     new_size * sizeof(float));
-            }
-          }
-          return 0;
-        });
+    size_t key_num = task_keys[shard_id].size();
+    size_t task_num = ShardTaskNum(key_num);
+    for (size_t task_idx = 0; task_idx < task_num; ++task_idx) {
+      size_t begin = key_num * task_idx / task_num;
+      size_t end = key_num * (task_idx + 1) / task_num;
+      tasks.push_back(
+          RunShardTask(
+              shard_id + task_idx,
+              [this,
+               shard_id,
+               begin,
+               end,
+               value_col,
+               mf_value_col,
+               update_value_col,
+               values,
+               &task_keys]() -> int {
+                auto &keys = task_keys[shard_id];
+                auto &local_shard = _local_shards[shard_id];
+                auto &local_shard_new = _local_shards_new[shard_id];
+                float data_buffer[value_col];  // NOLINT
+                float *data_buffer_ptr = data_buffer;
+                // the updates are grouped only if no other task updates the
+                // shard, and the values are not copied after the update
+                bool group_update =
+                    !local_shard.concurrent() && !_config.enable_revert();
+                PushUpdateGroup update_group(_value_accesor.get());
+                for (size_t i = begin; i < end; ++i) {
+                  auto &item = keys[i];
+                  uint64_t key = item.first;
+                  uint64_t push_data_idx = item.second;
+                  const float *update_data =
+                      values + push_data_idx * update_value_col;
+                  // the bucket of the key in local_shard_new is the same, so
+                  // it is guarded by the lock too
+                  size_t bucket = local_shard.compute_bucket_by_key(key);
+                  ShardBucketGuard guard(&local_shard, bucket);
+                  auto itr = local_shard.find(bucket, key);
+                  if (itr == local_shard.end(bucket)) {
+                    if ((FLAGS_pserver_enable_create_feasign_randomly &&
+                         !_value_accesor->CreateValue(1, update_data)) ||
+                        !_value_accesor->AdmitValue(key)) {
+                      continue;
+                    }
+                    update_group.Flush();
+                    auto value_size = value_col - mf_value_col;
+                    auto &feature_value = local_shard[key];
+                    feature_value.resize(value_size);
+                    _value_accesor->Create(&data_buffer_ptr, 1);
+                    memcpy(feature_value.data(),
+                           data_buffer_ptr,
+                           value_size * sizeof(float));
+                    itr = local_shard.find(bucket, key);
+                  }
+                  MarkDelta(shard_id, bucket, key);
+                  auto &feature_value = itr.value();
+                  float *value_data = feature_value.data();
+                  size_t value_size = feature_value.size();
+
+                  // 已拓展到最大size, 则就地update
+                  if (value_size == value_col && group_update) {
+                    update_group.Add(value_data, update_data);
+                  } else if (value_size == value_col) {
+                    _value_accesor->Update(&value_data, &update_data, 1);
+                  } else {
+                    // 拷入buffer区进行update，然后再回填，不需要的mf则回填时抛弃了
+                    memcpy(data_buffer_ptr,
+                           value_data,
+                           value_size * sizeof(float));
+                    _value_accesor->Update(&data_buffer_ptr, &update_data, 1);
+
+                    if (_value_accesor->NeedExtendMF(data_buffer)) {
+                      feature_value.resize(value_col);
+                      value_data = feature_value.data();
+                      _value_accesor->Create(&value_data, 1);
+                    }
+                    memcpy(value_data,
+                           data_buffer_ptr,
+                           value_size * sizeof(float));
+                  }
+                  if (_config.enable_revert()) {
+                    FixedFeatureValue *feature_value_new =
+                        &(local_shard_new[key]);
+                    auto new_size = feature_value.size();
+                    feature_value_new->resize(new_size);
+                    memcpy(feature_value_new->data(),
+                           value_data,
+                           new_size * sizeof(float));
+                  }
+                }
+                update_group.Flush();
+                EvictFeatures(shard_id);
+                return 0;
+              }));
+    }
   }
 
   for (auto &task : tasks) {
@@ -1200,7 +1739,7 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
 int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
                                       const float **values,
                                       size_t num) {
-  std::vector<std::future<int>> tasks(_real_local_shard_num);
+  std::vector<std::future<int>> tasks;
   std::vector<std::vector<std::pair<uint64_t, int>>> task_keys(
       _real_local_shard_num);
   for (size_t i = 0; i < num; ++i) {
@@ -1215,56 +1754,85 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
       _value_accesor->GetAccessorInfo().update_size / sizeof(float);
 
   for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
-    tasks[shard_id] = _shards_task_pool[shard_id % _task_pool_size]->enqueue(
-        [this,
-         shard_id,
-         value_col,
-         mf_value_col,
-         update_value_col,
-         values,
-         &task_keys]() -> int {
-          auto &keys = task_keys[shard_id];
-          auto &local_shard = _local_shards[shard_id];
-          float data_buffer[value_col];  // NOLINT
-          float *data_buffer_ptr = data_buffer;
-          for (auto &item : keys) {
-            uint64_t key = item.first;
-            uint64_t push_data_idx = item.second;
-            const float *update_data = values[push_data_idx];
-            auto itr = local_shard.find(key);
-            if (itr == local_shard.end()) {
-              if (FLAGS_pserver_enable_create_feasign_randomly &&
-                  !_value_accesor->CreateValue(1, update_data)) {
-                continue;
-              }
-              auto value_size = value_col - mf_value_col;
-              auto &feature_value = local_shard[key];
-              feature_value.resize(value_size);
-              _value_accesor->Create(&data_buffer_ptr, 1);
-              memcpy(feature_value.data(),
-                     data_buffer_ptr,
-                     value_size * sizeof(float));
-              itr = local_shard.find(key);
-            }
-            auto &feature_value = itr.value();
-            float *value_data = feature_value.data();
-            size_t value_size = feature_value.size();
-            if (value_size == value_col) {  // 已拓展到最大size, 则就地update
-              _value_accesor->Update(&value_data, &update_data, 1);
-            } else {
-              // 拷入buffer区进行update，然后再回填，不需要的mf则回填时抛弃了
-              memcpy(data_buffer_ptr, value_data, value_size * sizeof(float));
-              _value_accesor->Update(&data_buffer_ptr, &update_data, 1);
-              if (_value_accesor->NeedExtendMF(data_buffer)) {
-                feature_value.resize(value_col);
-                value_data = feature_value.data();
-                _value_accesor->Create(&value_data, 1);
-              }
-              memcpy(value_data, data_buffer_ptr, value_size * sizeof(float));
-            }
-          }
-          return 0;
-        });
+    size_t key_num = task_keys[shard_id].size();
+    size_t task_num = ShardTaskNum(key_num);
+    for (size_t task_idx = 0; task_idx < task_num; ++task_idx) {
+      size_t begin = key_num * task_idx / task_num;
+      size_t end = key_num * (task_idx + 1) / task_num;
+      tasks.push_back(
+          RunShardTask(
+              shard_id + task_idx,
+              [this,
+               shard_id,
+               begin,
+               end,
+               value_col,
+               mf_value_col,
+               update_value_col,
+               values,
+               &task_keys]() -> int {
+                auto &keys = task_keys[shard_id];
+                auto &local_shard = _local_shards[shard_id];
+                float data_buffer[value_col];  // NOLINT
+                float *data_buffer_ptr = data_buffer;
+                // the updates are grouped only if no other task updates the
+                // shard
+                bool group_update = !local_shard.concurrent();
+                PushUpdateGroup update_group(_value_accesor.get());
+                for (size_t i = begin; i < end; ++i) {
+                  auto &item = keys[i];
+                  uint64_t key = item.first;
+                  uint64_t push_data_idx = item.second;
+                  const float *update_data = values[push_data_idx];
+                  size_t bucket = local_shard.compute_bucket_by_key(key);
+                  ShardBucketGuard guard(&local_shard, bucket);
+                  auto itr = local_shard.find(bucket, key);
+                  if (itr == local_shard.end(bucket)) {
+                    if ((FLAGS_pserver_enable_create_feasign_randomly &&
+                         !_value_accesor->CreateValue(1, update_data)) ||
+                        !_value_accesor->AdmitValue(key)) {
+                      continue;
+                    }
+                    update_group.Flush();
+                    auto value_size = value_col - mf_value_col;
+                    auto &feature_value = local_shard[key];
+                    feature_value.resize(value_size);
+                    _value_accesor->Create(&data_buffer_ptr, 1);
+                    memcpy(feature_value.data(),
+                           data_buffer_ptr,
+                           value_size * sizeof(float));
+                    itr = local_shard.find(bucket, key);
+                  }
+                  MarkDelta(shard_id, bucket, key);
+                  auto &feature_value = itr.value();
+                  float *value_data = feature_value.data();
+                  size_t value_size = feature_value.size();
+                  // 已拓展到最大size, 则就地update
+                  if (value_size == value_col && group_update) {
+                    update_group.Add(value_data, update_data);
+                  } else if (value_size == value_col) {
+                    _value_accesor->Update(&value_data, &update_data, 1);
+                  } else {
+                    // 拷入buffer区进行update，然后再回填，不需要的mf则回填时抛弃了
+                    memcpy(data_buffer_ptr,
+                           value_data,
+                           value_size * sizeof(float));
+                    _value_accesor->Update(&data_buffer_ptr, &update_data, 1);
+                    if (_value_accesor->NeedExtendMF(data_buffer)) {
+                      feature_value.resize(value_col);
+                      value_data = feature_value.data();
+                      _value_accesor->Create(&value_data, 1);
+                    }
+                    memcpy(value_data,
+                           data_buffer_ptr,
+                           value_size * sizeof(float));
+                  }
+                }
+                update_group.Flush();
+                EvictFeatures(shard_id);
+                return 0;
+              }));
+    }
   }
 
   for (auto &task : tasks) {
@@ -1273,6 +1841,69 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
   return 0;
 }
 
+std::unique_ptr<MemorySparseTable::shard_type[]>
+MemorySparseTable::CreateLocalShards() const {
+  std::unique_ptr<shard_type[]> shards(
+      new shard_type[_real_local_shard_num]);  // NOLINT
+  if (FLAGS_pserver_sparse_table_concurrent_shard ||
+      FLAGS_pserver_sparse_table_direct_call) {
+    for (int i = 0; i < _real_local_shard_num; ++i) {
+      shards[i].set_concurrent(true);
+    }
+  }
+  return shards;
+}
+
+size_t MemorySparseTable::ShardTaskNum(size_t key_num) const {
+  if (!FLAGS_pserver_sparse_table_concurrent_shard ||
+      FLAGS_pserver_sparse_table_direct_call) {
+    return 1;
+  }
+  size_t min_keys_per_task = static_cast<size_t>(
+      std::max(FLAGS_pserver_sparse_table_min_keys_per_task, 1));
+  size_t task_num = (key_num + min_keys_per_task - 1) / min_keys_per_task;
+  return std::min(std::max(task_num, static_cast<size_t>(1)),
+                  _shards_task_pool.size());
+}
+
+std::future<int> MemorySparseTable::RunShardTask(size_t task_idx,
+                                                std::function<int()> task) {
+  if (!FLAGS_pserver_sparse_table_direct_call) {
+    return _shards_task_pool[task_idx % _shards_task_pool.size()]->enqueue(
+        std::move(task));
+  }
+  // no thread hand-off, the callers wait for the futures right away
+  std::promise<int> promise;
+  promise.set_value(task());
+  return promise.get_future();
+}
+
+void MemorySparseTable::EvictFeatures(int shard_id) {
+  const FeatureEvictionPolicy *policy = _value_accesor->GetEvictionPolicy();
+  // the pointers pulled by PullSparsePtr are kept by the callers
+  if (policy == nullptr || _pulled_by_ptr) {
+    return;
+  }
+  auto &shard = _local_shards[shard_id];
+  if (!policy->NeedEvict(shard.size())) {
+    return;
+  }
+  // a bucket is swept after every push task while the shard is oversized
+  size_t bucket = _evict_cursors[shard_id].fetch_add(1) % shard.bucket_count();
+  ShardBucketGuard guard(&shard, bucket);
+  for (auto it = shard.begin(bucket); it != shard.end(bucket);) {
+    if (_value_accesor->EvictValue(it.value().data())) {
+      MarkDelta(shard_id, bucket, it.key());
+      if (_config.enable_revert()) {
+        _local_shards_new[shard_id].erase(it.key());
+      }
+      it = shard.erase(bucket, it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 int32_t MemorySparseTable::Flush() { return 0; }
 
 int32_t MemorySparseTable::Shrink(const std::string &param) {
@@ -1287,6 +1918,7 @@ int32_t MemorySparseTable::Shrink(const std::string &param) {
     auto &shard = _local_shards[shard_id];
     for (auto it = shard.begin(); it != shard.end();) {
       if (_value_accesor->Shrink(it.value().data())) {
+        MarkDelta(shard_id, shard.compute_bucket_by_key(it.key()), it.key());
         it = shard.erase(it);
         ++feasign_size;
       } else {
@@ -1295,6 +1927,10 @@ int32_t MemorySparseTable::Shrink(const std::string &param) {
     }
     shrink_size_all += feasign_size;
   }
+  if (_delta_keys) {
+    // the show and click of all the features are decayed by shrink
+    _delta_save_all = true;
+  }
   VLOG(0) << "MemorySparseTable::Shrink success, shrink size:"
           << shrink_size_all;
   return 0;
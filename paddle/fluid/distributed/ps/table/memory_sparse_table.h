@@ -18,10 +18,13 @@
 #include <assert.h>
 #include <pthread.h>
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -29,6 +32,7 @@
 #include "paddle/fluid/distributed/ps/table/accessor.h"
 #include "paddle/fluid/distributed/ps/table/common_table.h"
 #include "paddle/fluid/distributed/ps/table/depends/feature_value.h"
+#include "paddle/fluid/distributed/ps/table/sparse_table_loader.h"
 #include "paddle/fluid/string/string_helper.h"
 
 #define PSERVER_SAVE_SUFFIX ".shard"
@@ -39,6 +43,9 @@ namespace distributed {
 class MemorySparseTable : public Table {
  public:
   typedef SparseTableShard<uint64_t, FixedFeatureValue> shard_type;
+  // save/load param of the delta checkpoint, the features created, updated or
+  // deleted since the last checkpoint (0) or delta checkpoint (6)
+  static constexpr int kDeltaSaveParam = 6;
   MemorySparseTable() {}
   virtual ~MemorySparseTable() {}
 
@@ -115,10 +122,60 @@ class MemorySparseTable : public Table {
   virtual void CheckSavePrePatchDone();
 
  protected:
+  std::unique_ptr<shard_type[]> CreateLocalShards() const;
+  // number of tasks to process the keys of a shard in pull and push, which is
+  // 1 unless FLAGS_pserver_sparse_table_concurrent_shard is true
+  size_t ShardTaskNum(size_t key_num) const;
+  // Run a task of the pull or the push in the task pool, or in the calling
+  // thread if FLAGS_pserver_sparse_table_direct_call is true.
+  std::future<int> RunShardTask(size_t task_idx, std::function<int()> task);
+
+  // Load a file into the local shard, with the chunks read, parsed and
+  // inserted in a pipeline. Returns -1 if the file is corrupted.
+  int32_t LoadShardPipelined(FsReadChannel* read_channel,
+                             int shard_id,
+                             bool is_binary,
+                             size_t feature_value_size);
+  // Parse the "<key> <values>" lines of a text chunk, the line ends of the
+  // chunk are replaced by '\0'.
+  bool ParseTextChunk(std::string* chunk,
+                      size_t feature_value_size,
+                      SparseFeatureBlock* block);
+
+  // Evict the features of an oversized shard by the eviction policy of the
+  // accessor, called after the push tasks of the shard.
+  void EvictFeatures(int shard_id);
+
   virtual int32_t SavePatch(const std::string& path, int save_param);
   virtual int32_t LoadPatch(const std::vector<std::string>& file_list,
                             int save_param);
 
+  // Record the key changed since the last checkpoint, called with the bucket
+  // of the key guarded.
+  void MarkDelta(int shard_id, size_t bucket, uint64_t key) {
+    if (_delta_keys) {
+      _delta_keys[shard_id].buckets[bucket].insert(key);
+    }
+  }
+  void ResetDelta();
+  void UpdateDeltaAfterSave(int save_param);
+  int32_t SaveDelta(const std::string& path);
+  int32_t LoadDelta(const std::vector<std::string>& file_list);
+  // Get the value of a changed key, returns false if it is deleted.
+  virtual bool FindDeltaValue(int shard_id,
+                              uint64_t key,
+                              std::vector<float>* value);
+  // Visit all the values of a shard, for the delta after the values are
+  // changed by Shrink.
+  virtual void VisitShardValues(
+      int shard_id,
+      const std::function<void(uint64_t, const float*, size_t)>& visitor);
+  virtual void ApplyDeltaValue(int shard_id,
+                               uint64_t key,
+                               const float* value,
+                               size_t size);
+  virtual void ApplyDeltaTombstone(int shard_id, uint64_t key);
+
   int _task_pool_size = 24;
   int _avg_local_shard_num;
   int _real_local_shard_num;
@@ -136,6 +193,20 @@ class MemorySparseTable : public Table {
   std::unique_ptr<shard_type[]> _local_shards_new;
   std::unique_ptr<shard_type[]> _local_shards_patch_model;
   std::thread _save_patch_model_thread;
+
+  // for continuous eviction, the next bucket to sweep of every shard
+  std::unique_ptr<std::atomic<size_t>[]> _evict_cursors;
+  std::atomic<bool> _pulled_by_ptr{false};
+
+  // for delta checkpoint, the keys of a bucket is guarded the same as the
+  // bucket
+  struct DeltaKeys {
+    std::unordered_set<uint64_t> buckets[CTR_SPARSE_SHARD_BUCKET_NUM];
+  };
+  std::unique_ptr<DeltaKeys[]> _delta_keys;
+  // Shrink and the batch model save change all the values, the next delta
+  // saves all the features
+  bool _delta_save_all{false};
 };
 
 }  // namespace distributed
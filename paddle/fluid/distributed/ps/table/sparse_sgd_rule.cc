@@ -16,6 +16,7 @@
 
 #include "glog/logging.h"
 
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
 #include "paddle/utils/flags.h"
 
 PD_DEFINE_bool(enable_show_scale_gradient, true, "enable show scale gradient");
@@ -51,6 +52,21 @@ void SparseNaiveSGDRule::UpdateValueWork(float *w,
   }
 }
 
+void SparseNaiveSGDRule::UpdateValueBatchWork(float **w,
+                                              float **sgd,
+                                              const float **push_values,
+                                              const float *scales,
+                                              size_t num) {
+  for (size_t k = 0; k < num; ++k) {
+    float *w_k = w[k];
+    const float *g_k = push_values[k];
+    for (size_t i = 0; i < _embedding_dim; ++i) {
+      w_k[i] -= learning_rate_ * g_k[i];
+    }
+    BoundValues(w_k, _embedding_dim);
+  }
+}
+
 void SparseNaiveSGDRule::InitValueWork(float *value,
                                        float *sgd,
                                        bool zero_init) {
@@ -106,6 +122,32 @@ void SparseAdaGradSGDRule::UpdateValueWork(float *w,
   g2sum += add_g2sum / _embedding_dim;
 }
 
+void SparseAdaGradSGDRule::UpdateValueBatchWork(float **w,
+                                                float **sgd,
+                                                const float **grads,
+                                                const float *scales,
+                                                size_t num) {
+  for (size_t k = 0; k < num; ++k) {
+    float *w_k = w[k];
+    const float *grad = grads[k];
+    float scale = scales[k];
+    float &g2sum = sgd[k][G2SumIndex()];
+    // the same arithmetic as UpdateValueWork, with the ratio out of the loop
+    auto ratio = sqrt(_initial_g2sum / (_initial_g2sum + g2sum));
+    for (size_t i = 0; i < _embedding_dim; i++) {
+      double scaled_grad = grad[i] / scale;
+      w_k[i] -= learning_rate_ * scaled_grad * ratio;
+    }
+    BoundValues(w_k, _embedding_dim);
+    double add_g2sum = 0;
+    for (size_t i = 0; i < _embedding_dim; i++) {
+      double scaled_grad = grad[i] / scale;
+      add_g2sum += scaled_grad * scaled_grad;
+    }
+    g2sum += add_g2sum / _embedding_dim;
+  }
+}
+
 void SparseAdaGradSGDRule::InitValueWork(float *value,
                                          float *sgd,
                                          bool zero_init) {
@@ -159,6 +201,26 @@ void StdAdaGradSGDRule::UpdateValueWork(float *w,
   }
 }
 
+void StdAdaGradSGDRule::UpdateValueBatchWork(float **w,
+                                             float **sgd,
+                                             const float **grads,
+                                             const float *scales,
+                                             size_t num) {
+  for (size_t k = 0; k < num; ++k) {
+    float *w_k = w[k];
+    float *g2sum = sgd[k] + G2SumIndex();
+    const float *grad = grads[k];
+    float scale = scales[k];
+    for (size_t i = 0; i < _embedding_dim; i++) {
+      double scaled_grad = grad[i] / scale;
+      w_k[i] -= learning_rate_ * scaled_grad *
+                sqrt(_initial_g2sum / (_initial_g2sum + g2sum[i]));
+      g2sum[i] += scaled_grad * scaled_grad;
+    }
+    BoundValues(w_k, _embedding_dim);
+  }
+}
+
 void StdAdaGradSGDRule::InitValueWork(float *value,
                                       float *sgd,
                                       bool zero_init) {
@@ -227,6 +289,42 @@ void SparseAdamSGDRule::UpdateValueWork(float *w,
   (*beta2_pow) *= _beta2_decay_rate;
 }
 
+void SparseAdamSGDRule::UpdateValueBatchWork(float **w,
+                                             float **sgd,
+                                             const float **grads,
+                                             const float *scales,
+                                             size_t num) {
+  // the refer implementation of the jit adam is the same as UpdateValueWork,
+  // and the generated ones are vectorized with AVX/AVX512
+  auto adam =
+      phi::jit::KernelFuncs<phi::jit::AdamTuple<float>, phi::CPUPlace>::Cache()
+          .At(phi::jit::adam_attr_t(_beta1_decay_rate, _beta2_decay_rate));
+  for (size_t k = 0; k < num; ++k) {
+    float *gsum = sgd[k] + GSumIndex();
+    float *g2sum = sgd[k] + G2SumIndex();
+    float *beta1_pow = sgd[k] + Beta1PowIndex();
+    float *beta2_pow = sgd[k] + Beta2PowIndex();
+
+    float lr = learning_rate_;
+    lr *= sqrt(1 - *beta2_pow) / (1 - *beta1_pow);
+    adam(_beta1_decay_rate,
+         _beta2_decay_rate,
+         -lr,
+         _ada_epsilon,
+         _embedding_dim,
+         grads[k],
+         gsum,
+         g2sum,
+         w[k],
+         gsum,
+         g2sum,
+         w[k]);
+    BoundValues(w[k], _embedding_dim);
+    (*beta1_pow) *= _beta1_decay_rate;
+    (*beta2_pow) *= _beta2_decay_rate;
+  }
+}
+
 void SparseAdamSGDRule::InitValueWork(float *value,
                                       float *sgd,
                                       bool zero_init) {
@@ -376,6 +474,33 @@ void SparseAdaGradV2SGDRule::UpdateValueWork(float *w,
   }
 }
 
+void SparseAdaGradV2SGDRule::UpdateValueBatchWork(float **w,
+                                                  float **sgd,
+                                                  const float **grads,
+                                                  const float *scales,
+                                                  size_t num) {
+  float epsilon = 1e-8;
+  for (size_t k = 0; k < num; ++k) {
+    float *w_k = w[k];
+    const float *grad = grads[k];
+    float scale = scales[k];
+    float &g2sum = sgd[k][G2SumIndex()];
+    double add_g2sum = 0;
+    for (size_t i = 0; i < _embedding_dim; i++) {
+      double scaled_grad = grad[i] / scale;
+      add_g2sum += scaled_grad * scaled_grad;
+    }
+    g2sum += add_g2sum / _embedding_dim;
+
+    auto denominator = sqrt(g2sum) + epsilon;
+    for (size_t i = 0; i < _embedding_dim; i++) {
+      double scaled_grad = grad[i] / scale;
+      w_k[i] -= learning_rate_ * scaled_grad / denominator;
+    }
+    BoundValues(w_k, _embedding_dim);
+  }
+}
+
 void SparseAdaGradV2SGDRule::InitValueWork(float *value,
                                            float *sgd,
                                            bool zero_init) {
@@ -51,6 +51,25 @@ class SparseValueSGDRule {
                    float scale = 1) {
     UpdateValueWork(w, sgd, push_value, scale);
   }
+  // The batched UpdateValue of num features, w[i], sgd[i] and push_values[i]
+  // are the slices of the i-th feature, and scales[i] is its scale. The
+  // features are updated in order, so a feature can appear more than once.
+  virtual void UpdateValueBatchWork(float** w,
+                                    float** sgd,
+                                    const float** push_values,
+                                    const float* scales,
+                                    size_t num) {
+    for (size_t i = 0; i < num; ++i) {
+      UpdateValueWork(w[i], sgd[i], push_values[i], scales[i]);
+    }
+  }
+  void UpdateValueBatch(float** w,
+                        float** sgd,
+                        const float** push_values,
+                        const float* scales,
+                        size_t num) {
+    UpdateValueBatchWork(w, sgd, push_values, scales, num);
+  }
   template <class T>
   void BoundValue(T& w) {  // NOLINT
     if (!(w >= _min_bound)) {
@@ -59,6 +78,16 @@ class SparseValueSGDRule {
       w = (T)_max_bound;
     }
   }
+  // BoundValue of num values without the branches, so that it is vectorized.
+  void BoundValues(float* w, size_t num) {
+    float min_bound = _min_bound;
+    float max_bound = _max_bound;
+    for (size_t i = 0; i < num; ++i) {
+      float v = w[i];
+      // NaN is bounded to min_bound as BoundValue
+      w[i] = v >= min_bound ? (v <= max_bound ? v : max_bound) : min_bound;
+    }
+  }
   float& MinBound() { return _min_bound; }
   float& MaxBound() { return _max_bound; }
 
@@ -82,6 +111,11 @@ class SparseNaiveSGDRule : public SparseValueSGDRule {
                                float* sgd,
                                const float* push_value,
                                float scale);
+  virtual void UpdateValueBatchWork(float** w,
+                                    float** sgd,
+                                    const float** push_values,
+                                    const float* scales,
+                                    size_t num);
   virtual void InitValueWork(float* value, float* sgd, bool zero_init);
   virtual size_t Dim() { return 0; }
 
@@ -97,6 +131,11 @@ class SparseAdaGradSGDRule : public SparseValueSGDRule {
                                float* sgd,
                                const float* push_value,
                                float scale);
+  virtual void UpdateValueBatchWork(float** w,
+                                    float** sgd,
+                                    const float** push_values,
+                                    const float* scales,
+                                    size_t num);
   virtual void InitValueWork(float* value, float* sgd, bool zero_init);
   virtual size_t Dim() { return 1; }
   size_t G2SumIndex() { return 0; }
@@ -117,6 +156,11 @@ class SparseAdaGradV2SGDRule : public SparseValueSGDRule {
                                float* sgd,
                                const float* push_value,
                                float scale);
+  virtual void UpdateValueBatchWork(float** w,
+                                    float** sgd,
+                                    const float** push_values,
+                                    const float* scales,
+                                    size_t num);
   virtual void InitValueWork(float* value, float* sgd, bool zero_init);
   virtual size_t Dim() { return 1; }
   size_t G2SumIndex() { return 0; }
@@ -134,6 +178,11 @@ class StdAdaGradSGDRule : public SparseValueSGDRule {
                                float* sgd,
                                const float* push_value,
                                float scale);
+  virtual void UpdateValueBatchWork(float** w,
+                                    float** sgd,
+                                    const float** push_values,
+                                    const float* scales,
+                                    size_t num);
   virtual void InitValueWork(float* value, float* sgd, bool zero_init);
   virtual size_t Dim() { return _embedding_dim; }
   size_t G2SumIndex() { return 0; }
@@ -151,6 +200,11 @@ class SparseAdamSGDRule : public SparseValueSGDRule {
                                float* sgd,
                                const float* push_value,
                                float scale);
+  virtual void UpdateValueBatchWork(float** w,
+                                    float** sgd,
+                                    const float** push_values,
+                                    const float* scales,
+                                    size_t num);
   virtual void InitValueWork(float* value, float* sgd, bool zero_init);
   virtual size_t Dim() { return _embedding_dim * 2 + 2; }
   size_t GSumIndex() { return 0; }
@@ -0,0 +1,181 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/table/sparse_table_loader.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace paddle {
+namespace distributed {
+
+namespace {
+constexpr size_t kBlockHeaderSize = 2 * sizeof(uint32_t);
+// a block is not larger than 1GB, to detect the corrupted headers
+constexpr uint64_t kMaxBlockBytes = 1ULL << 30;
+
+uint64_t BlockPayloadSize(uint32_t num, uint32_t value_num) {
+  return static_cast<uint64_t>(num) * (sizeof(uint64_t) + sizeof(uint32_t)) +
+         static_cast<uint64_t>(value_num) * sizeof(float);
+}
+}  // namespace
+
+bool SparseLineChunkReader::Next(std::string* chunk) {
+  chunk->clear();
+  chunk->swap(_carry);
+  while (!_eof) {
+    size_t begin = chunk->size();
+    chunk->resize(begin + _chunk_size);
+    int read_size = _channel->read(&(*chunk)[begin], _chunk_size);
+    chunk->resize(begin + std::max(read_size, 0));
+    if (read_size < static_cast<int>(_chunk_size)) {
+      _eof = true;
+      break;
+    }
+    size_t last = chunk->rfind('\n');
+    if (last != std::string::npos) {
+      _carry.assign(*chunk, last + 1, std::string::npos);
+      chunk->resize(last + 1);
+      return true;
+    }
+    // the line is longer than the chunk, read more of it
+  }
+  return !chunk->empty();
+}
+
+bool IsSparseBinaryFile(const std::string& path) {
+  size_t slash = path.rfind('/');
+  std::string name =
+      slash == std::string::npos ? path : path.substr(slash + 1);
+  return name.find(kSparseBinarySuffix) != std::string::npos;
+}
+
+int SparseBinaryWriter::Append(uint64_t key, const float* value, size_t size) {
+  _block.keys.push_back(key);
+  _block.sizes.push_back(size);
+  _block.values.insert(_block.values.end(), value, value + size);
+  if (_block.keys.size() >= _block_size) {
+    return WriteBlock();
+  }
+  return 0;
+}
+
+int SparseBinaryWriter::Flush() {
+  // an empty file still has the magic
+  return _block.keys.empty() ? WriteMagic() : WriteBlock();
+}
+
+int SparseBinaryWriter::WriteMagic() {
+  if (_magic_written) {
+    return 0;
+  }
+  uint32_t magic = kSparseBinaryMagic;
+  if (0 != _channel->write(reinterpret_cast<const char*>(&magic),
+                           sizeof(magic))) {
+    return -1;
+  }
+  _magic_written = true;
+  return 0;
+}
+
+int SparseBinaryWriter::WriteBlock() {
+  if (0 != WriteMagic()) {
+    return -1;
+  }
+  uint32_t header[2] = {static_cast<uint32_t>(_block.keys.size()),
+                        static_cast<uint32_t>(_block.values.size())};
+  int ret = 0;
+  if (0 != _channel->write(reinterpret_cast<const char*>(header),
+                           sizeof(header)) ||
+      0 != _channel->write(reinterpret_cast<const char*>(_block.keys.data()),
+                           _block.keys.size() * sizeof(uint64_t)) ||
+      0 != _channel->write(reinterpret_cast<const char*>(_block.sizes.data()),
+                           _block.sizes.size() * sizeof(uint32_t)) ||
+      0 != _channel->write(reinterpret_cast<const char*>(_block.values.data()),
+                           _block.values.size() * sizeof(float))) {
+    ret = -1;
+  }
+  _block.Clear();
+  return ret;
+}
+
+int ReadSparseBinaryChunk(FsReadChannel* channel,
+                          bool first,
+                          std::string* chunk) {
+  if (first) {
+    uint32_t magic = 0;
+    int read_size =
+        channel->read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    if (read_size != sizeof(magic) || magic != kSparseBinaryMagic) {
+      return -1;
+    }
+  }
+  chunk->resize(kBlockHeaderSize);
+  int read_size = channel->read(&(*chunk)[0], kBlockHeaderSize);
+  if (read_size == 0) {
+    return 0;
+  }
+  if (read_size != static_cast<int>(kBlockHeaderSize)) {
+    return -1;
+  }
+  uint32_t header[2];
+  memcpy(header, chunk->data(), sizeof(header));
+  uint64_t payload_size = BlockPayloadSize(header[0], header[1]);
+  if (payload_size > kMaxBlockBytes) {
+    return -1;
+  }
+  chunk->resize(kBlockHeaderSize + payload_size);
+  if (payload_size > 0 &&
+      channel->read(&(*chunk)[kBlockHeaderSize], payload_size) !=
+          static_cast<int>(payload_size)) {
+    return -1;
+  }
+  return 1;
+}
+
+bool DecodeSparseBinaryChunk(const std::string& chunk,
+                             SparseFeatureBlock* block) {
+  block->Clear();
+  if (chunk.size() < kBlockHeaderSize) {
+    return false;
+  }
+  uint32_t header[2];
+  memcpy(header, chunk.data(), sizeof(header));
+  uint32_t num = header[0];
+  uint32_t value_num = header[1];
+  if (chunk.size() != kBlockHeaderSize + BlockPayloadSize(num, value_num)) {
+    return false;
+  }
+  const char* data = chunk.data() + kBlockHeaderSize;
+  block->keys.resize(num);
+  memcpy(block->keys.data(), data, num * sizeof(uint64_t));
+  data += num * sizeof(uint64_t);
+  block->sizes.resize(num);
+  memcpy(block->sizes.data(), data, num * sizeof(uint32_t));
+  data += num * sizeof(uint32_t);
+  uint64_t size_sum = 0;
+  for (uint32_t size : block->sizes) {
+    size_sum += size;
+  }
+  if (size_sum != value_num) {
+    block->Clear();
+    return false;
+  }
+  block->values.resize(value_num);
+  memcpy(block->values.data(), data, value_num * sizeof(float));
+  return true;
+}
+
+}  // namespace distributed
+}  // namespace paddle
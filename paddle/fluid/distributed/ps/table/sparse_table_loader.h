@@ -0,0 +1,122 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/distributed/common/afs_warpper.h"
+
+namespace paddle {
+namespace distributed {
+
+// The features parsed from a chunk of a sparse table file, in columns. The
+// value of keys[i] is sizes[i] floats in values, following the value of
+// keys[i - 1].
+struct SparseFeatureBlock {
+  std::vector<uint64_t> keys;
+  std::vector<uint32_t> sizes;
+  std::vector<float> values;
+
+  void Clear() {
+    keys.clear();
+    sizes.clear();
+    values.clear();
+  }
+};
+
+// SparseLineChunkReader reads a text file as the chunks of whole lines, so that
+// the chunks can be parsed in parallel. The files are read through pipes (the
+// converters and the hadoop client), so the chunks are split from the stream
+// instead of the byte ranges of the file.
+class SparseLineChunkReader {
+ public:
+  SparseLineChunkReader(FsReadChannel* channel, size_t chunk_size)
+      : _channel(channel), _chunk_size(chunk_size) {}
+
+  // Read the next chunk, which ends at a '\n' unless it is the last one.
+  // Returns false at the end of file.
+  bool Next(std::string* chunk);
+
+ private:
+  FsReadChannel* _channel;
+  size_t _chunk_size;
+  // the partial line at the end of the last read
+  std::string _carry;
+  bool _eof{false};
+};
+
+// Parse the decimal key at the start of str, as strtoul without the locale,
+// sign and base handling.
+inline uint64_t ParseSparseKey(const char* str, char** end) {
+  uint64_t key = 0;
+  while (*str >= '0' && *str <= '9') {
+    key = key * 10 + (*str - '0');
+    ++str;
+  }
+  *end = const_cast<char*>(str);
+  return key;
+}
+
+// The binary columnar file of a sparse table shard is
+// |---4B(magic)---|---block---|---block---|...
+// and a block is
+// |---4B(n)---|---4B(m)---|---n x 8B(keys)---|---n x 4B(sizes)---|
+// |---m x 4B(values)---|
+// where m is the sum of the sizes. The values are the in-memory values
+// without the text formatting, so the file is an exact dump of the table.
+constexpr uint32_t kSparseBinaryMagic = 0x31425350;  // "PSB1"
+
+// The suffix of the binary files in the table directory, before the suffix
+// of compression.
+constexpr char kSparseBinarySuffix[] = ".bin";
+
+bool IsSparseBinaryFile(const std::string& path);
+
+class SparseBinaryWriter {
+ public:
+  SparseBinaryWriter(FsWriteChannel* channel, size_t block_size)
+      : _channel(channel), _block_size(block_size) {}
+
+  // Returns 0 on success, -1 if writing fails.
+  int Append(uint64_t key, const float* value, size_t size);
+  int Flush();
+
+ private:
+  int WriteMagic();
+  int WriteBlock();
+
+  FsWriteChannel* _channel;
+  size_t _block_size;
+  bool _magic_written{false};
+  SparseFeatureBlock _block;
+};
+
+// Read the raw bytes of the next block, the magic is checked before the first
+// block. Returns 1 if a block is read, 0 at the end of file, -1 if the file is
+// not a binary file or truncated.
+int ReadSparseBinaryChunk(FsReadChannel* channel,
+                          bool first,
+                          std::string* chunk);
+
+// Decode a chunk of ReadSparseBinaryChunk into block, returns false if the
+// chunk is malformed.
+bool DecodeSparseBinaryChunk(const std::string& chunk,
+                             SparseFeatureBlock* block);
+
+}  // namespace distributed
+}  // namespace paddle
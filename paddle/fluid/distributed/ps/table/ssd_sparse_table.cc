@@ -14,6 +14,8 @@
 
 #include "paddle/fluid/distributed/ps/table/ssd_sparse_table.h"
 
+#include <algorithm>
+
 #include "paddle/fluid/distributed/common/cost_timer.h"
 #include "paddle/fluid/distributed/common/local_random.h"
 #include "paddle/fluid/distributed/common/topk_calculator.h"
@@ -25,6 +27,17 @@ PD_DECLARE_bool(pserver_create_value_when_push);
 PD_DECLARE_bool(pserver_enable_create_feasign_randomly);
 PD_DEFINE_bool(pserver_open_strict_check, false, "pserver_open_strict_check");
 PD_DEFINE_int32(pserver_load_batch_size, 5000, "load batch size for ssd");
+PD_DEFINE_int32(pserver_ssd_keep_hot_num_per_shard,
+                0,
+                "max number of the most frequently pulled features kept in "
+                "memory per shard when caching table to ssd, 0 to disable");
+PD_DEFINE_int32(pserver_ssd_hot_min_frequency,
+                2,
+                "min estimated pull frequency of the features kept in memory "
+                "by pserver_ssd_keep_hot_num_per_shard");
+PD_DEFINE_int32(pserver_ssd_prefetch_thread_num,
+                4,
+                "number of threads reading rocksdb for PrefetchSparse");
 PADDLE_DEFINE_EXPORTED_string(rocksdb_path,
                               "database",
                               "path of sparse table rocksdb file");
@@ -36,6 +49,17 @@ int32_t SSDSparseTable::Initialize() {
   MemorySparseTable::Initialize();
   _db = ::paddle::distributed::RocksDBHandler::GetInstance();
   _db->initialize(FLAGS_rocksdb_path, _real_local_shard_num);
+  if (FLAGS_pserver_ssd_keep_hot_num_per_shard > 0) {
+    size_t width = std::max(
+        static_cast<size_t>(FLAGS_pserver_ssd_keep_hot_num_per_shard) * 4,
+        static_cast<size_t>(1024));
+    for (int i = 0; i < _real_local_shard_num; ++i) {
+      _shard_sketches.emplace_back(new FrequencySketch(width));
+    }
+  }
+  _prefetch_buffers.reset(new PrefetchBuffer[_real_local_shard_num]);
+  _prefetch_pool.reset(
+      new ::ThreadPool(std::max(FLAGS_pserver_ssd_prefetch_thread_num, 1)));
   VLOG(0) << "initialize SSDSparseTable succ";
   VLOG(0) << "SSD FLAGS_pserver_print_missed_key_num_every_push:"
           << FLAGS_pserver_print_missed_key_num_every_push;
@@ -110,17 +134,22 @@ int32_t SSDSparseTable::PullSparse(float* pull_values,
                 float* data_buffer_ptr = data_buffer;
                 for (size_t i = 0; i < keys.size(); ++i) {
                   uint64_t key = keys[i].first;
+                  RecordAccess(shard_id, key);
                   auto itr = local_shard.find(key);
                   size_t data_size = value_size - mf_value_size;
                   if (itr == local_shard.end()) {
                     // pull rocksdb
                     std::string tmp_string("");
-                    if (_db->get(shard_id,
+                    if (!TakePrefetched(shard_id, key, &tmp_string) &&
+                        _db->get(shard_id,
                                  reinterpret_cast<char*>(&key),
                                  sizeof(uint64_t),
                                  tmp_string) > 0) {
                       ++missed_keys;
-                      if (FLAGS_pserver_create_value_when_push) {
+                      ++_miss_num;
+                      // the features not admitted are created by push
+                      if (FLAGS_pserver_create_value_when_push ||
+                          _value_accesor->HasAdmissionPolicy()) {
                         memset(data_buffer, 0, sizeof(float) * data_size);
                       } else {
                         auto& feature_value = local_shard[key];
@@ -131,8 +160,12 @@ int32_t SSDSparseTable::PullSparse(float* pull_values,
                         memcpy(data_ptr,
                                data_buffer_ptr,
                                data_size * sizeof(float));
+                        MarkDelta(shard_id,
+                                  local_shard.compute_bucket_by_key(key),
+                                  key);
                       }
                     } else {
+                      ++_ssd_hit_num;
                       data_size = tmp_string.size() / sizeof(float);
                       memcpy(data_buffer_ptr,
                              ::paddle::string::str_to_float(tmp_string),
@@ -148,6 +181,7 @@ int32_t SSDSparseTable::PullSparse(float* pull_values,
                                     sizeof(uint64_t));
                     }
                   } else {
+                    ++_mem_hit_num;
                     data_size = itr.value().size();
                     memcpy(data_buffer_ptr,
                            itr.value().data(),
@@ -197,10 +231,28 @@ int32_t SSDSparseTable::PullSparsePtr(int shard_id,
     float data_buffer[value_size];  // NOLINT
     float* data_buffer_ptr = data_buffer;
 
+    std::string prefetched;
     for (size_t i = 0; i < num; ++i) {
       uint64_t key = pull_keys[i];
+      RecordAccess(shard_id, key);
       auto itr = local_shard.find(key);
-      if (itr == local_shard.end()) {
+      if (itr == local_shard.end() &&
+          TakePrefetched(shard_id, key, &prefetched)) {
+        ++_ssd_hit_num;
+        // from the prefetch buffer to mem
+        int data_size = prefetched.size() / sizeof(float);
+        auto& feature_value = local_shard[key];
+        feature_value.resize(data_size);
+        memcpy(const_cast<float*>(feature_value.data()),
+               ::paddle::string::str_to_float(prefetched),
+               data_size * sizeof(float));
+        _db->del_data(
+            shard_id, reinterpret_cast<char*>(&key), sizeof(uint64_t));
+        ret = &feature_value;
+        _value_accesor->UpdatePassId(ret->data(), pass_id);
+        pull_values[i] = reinterpret_cast<char*>(ret);
+        MarkDelta(shard_id, local_shard.compute_bucket_by_key(key), key);
+      } else if (itr == local_shard.end()) {
         cur_ctx->batch_index.push_back(i);
         cur_ctx->batch_keys.emplace_back(
             reinterpret_cast<const char*>(&(pull_keys[i])), sizeof(uint64_t));
@@ -224,6 +276,7 @@ int32_t SSDSparseTable::PullSparsePtr(int shard_id,
               uint64_t cur_key = *(reinterpret_cast<uint64_t*>(
                   const_cast<char*>(cur_ctx->batch_keys[idx].data())));
               if (cur_ctx->status[idx].IsNotFound()) {
+                ++_miss_num;
                 auto& feature_value = local_shard[cur_key];
                 int init_size = value_size - mf_value_size;
                 feature_value.resize(init_size);
@@ -233,6 +286,7 @@ int32_t SSDSparseTable::PullSparsePtr(int shard_id,
                        init_size * sizeof(float));
                 ret = &feature_value;
               } else {
+                ++_ssd_hit_num;
                 int data_size =
                     cur_ctx->batch_values[idx].size() / sizeof(float);
                 // from rocksdb to mem
@@ -250,6 +304,9 @@ int32_t SSDSparseTable::PullSparsePtr(int shard_id,
               _value_accesor->UpdatePassId(ret->data(), pass_id);
               int pull_data_idx = cur_ctx->batch_index[idx];
               pull_values[pull_data_idx] = reinterpret_cast<char*>(ret);
+              MarkDelta(shard_id,
+                        local_shard.compute_bucket_by_key(cur_key),
+                        cur_key);
             }
           }
           cur_ctx->reset();
@@ -257,10 +314,12 @@ int32_t SSDSparseTable::PullSparsePtr(int shard_id,
           tasks.push_back(std::move(fut));
         }
       } else {
+        ++_mem_hit_num;
         ret = itr.value_ptr();
         // int pull_data_idx = keys[i].second;
         _value_accesor->UpdatePassId(ret->data(), pass_id);
         pull_values[i] = reinterpret_cast<char*>(ret);
+        MarkDelta(shard_id, local_shard.compute_bucket_by_key(key), key);
       }
     }
     if (!cur_ctx->batch_keys.empty()) {
@@ -287,6 +346,7 @@ int32_t SSDSparseTable::PullSparsePtr(int shard_id,
         uint64_t cur_key = *(reinterpret_cast<uint64_t*>(
             const_cast<char*>(cur_ctx->batch_keys[idx].data())));
         if (cur_ctx->status[idx].IsNotFound()) {
+          ++_miss_num;
           auto& feature_value = local_shard[cur_key];
           int init_size = value_size - mf_value_size;
           feature_value.resize(init_size);
@@ -296,6 +356,7 @@ int32_t SSDSparseTable::PullSparsePtr(int shard_id,
                  init_size * sizeof(float));
           ret = &feature_value;
         } else {
+          ++_ssd_hit_num;
           int data_size = cur_ctx->batch_values[idx].size() / sizeof(float);
           // from rocksdb to mem
           auto& feature_value = local_shard[cur_key];
@@ -311,6 +372,8 @@ int32_t SSDSparseTable::PullSparsePtr(int shard_id,
         _value_accesor->UpdatePassId(ret->data(), pass_id);
         int pull_data_idx = cur_ctx->batch_index[idx];
         pull_values[pull_data_idx] = reinterpret_cast<char*>(ret);
+        MarkDelta(
+            shard_id, local_shard.compute_bucket_by_key(cur_key), cur_key);
       }
       cur_ctx->reset();
     }
@@ -357,8 +420,9 @@ int32_t SSDSparseTable::PushSparse(const uint64_t* keys,
                       values + push_data_idx * update_value_col;
                   auto itr = local_shard.find(key);
                   if (itr == local_shard.end()) {
-                    if (FLAGS_pserver_enable_create_feasign_randomly &&
-                        !_value_accesor->CreateValue(1, update_data)) {
+                    if ((FLAGS_pserver_enable_create_feasign_randomly &&
+                         !_value_accesor->CreateValue(1, update_data)) ||
+                        !_value_accesor->AdmitValue(key)) {
                       continue;
                     }
                     auto value_size = value_col - mf_value_col;
@@ -370,6 +434,8 @@ int32_t SSDSparseTable::PushSparse(const uint64_t* keys,
                            value_size * sizeof(float));
                     itr = local_shard.find(key);
                   }
+                  MarkDelta(
+                      shard_id, local_shard.compute_bucket_by_key(key), key);
                   auto& feature_value = itr.value();
                   float* value_data = const_cast<float*>(feature_value.data());
                   size_t value_size = feature_value.size();
@@ -462,8 +528,9 @@ int32_t SSDSparseTable::PushSparse(const uint64_t* keys,
                   const float* update_data = values[push_data_idx];
                   auto itr = local_shard.find(key);
                   if (itr == local_shard.end()) {
-                    if (FLAGS_pserver_enable_create_feasign_randomly &&
-                        !_value_accesor->CreateValue(1, update_data)) {
+                    if ((FLAGS_pserver_enable_create_feasign_randomly &&
+                         !_value_accesor->CreateValue(1, update_data)) ||
+                        !_value_accesor->AdmitValue(key)) {
                       continue;
                     }
                     auto value_size = value_col - mf_value_col;
@@ -475,6 +542,8 @@ int32_t SSDSparseTable::PushSparse(const uint64_t* keys,
                            value_size * sizeof(float));
                     itr = local_shard.find(key);
                   }
+                  MarkDelta(
+                      shard_id, local_shard.compute_bucket_by_key(key), key);
                   auto& feature_value = itr.value();
                   float* value_data = const_cast<float*>(feature_value.data());
                   size_t value_size = feature_value.size();
@@ -509,6 +578,7 @@ int32_t SSDSparseTable::PushSparse(const uint64_t* keys,
 }
 
 int32_t SSDSparseTable::Shrink(const std::string& param) {
+  ClearPrefetched();
   int thread_num = _real_local_shard_num < 20 ? _real_local_shard_num : 20;
   omp_set_num_threads(thread_num);
 #pragma omp parallel for schedule(dynamic)
@@ -520,6 +590,7 @@ int32_t SSDSparseTable::Shrink(const std::string& param) {
     auto& shard = _local_shards[i];
     for (auto it = shard.begin(); it != shard.end();) {
       if (_value_accesor->Shrink(it.value().data())) {
+        MarkDelta(i, shard.compute_bucket_by_key(it.key()), it.key());
         it = shard.erase(it);
         mem_count++;
       } else {
@@ -531,6 +602,8 @@ int32_t SSDSparseTable::Shrink(const std::string& param) {
       if (_value_accesor->Shrink(
               ::paddle::string::str_to_float(it->value().data()))) {
         _db->del_data(i, it->key().data(), it->key().size());
+        uint64_t key = *(reinterpret_cast<const uint64_t*>(it->key().data()));
+        MarkDelta(i, shard.compute_bucket_by_key(key), key);
         ssd_count++;
       } else {
         _db->put(i,
@@ -545,10 +618,15 @@ int32_t SSDSparseTable::Shrink(const std::string& param) {
               << mem_count << "] SSD[" << ssd_count << "]";
     // _db->flush(i);
   }
+  if (_delta_keys) {
+    // the show and click of all the features are decayed by shrink
+    _delta_save_all = true;
+  }
   return 0;
 }
 
 int32_t SSDSparseTable::UpdateTable() {
+  ClearPrefetched();
   int count = 0;
   for (int i = 0; i < _real_local_shard_num; ++i) {
     auto& shard = _local_shards[i];
@@ -583,19 +661,23 @@ int64_t SSDSparseTable::LocalSize() {
 int32_t SSDSparseTable::Save(const std::string& path,
                              const std::string& param) {
   std::lock_guard<std::mutex> guard(_table_mutex);
-#ifdef PADDLE_WITH_HETERPS
   int save_param = atoi(param.c_str());
+  if (save_param == kDeltaSaveParam) {
+    return SaveDelta(path);
+  }
   int32_t ret = 0;
+#ifdef PADDLE_WITH_HETERPS
   if (save_param > 3) {
     ret = SaveWithStringMultiOutput(path, param);  // batch_model:4  xbox:5
   } else {
     ret = SaveWithBinary(path, param);  // batch_model:0  xbox:1
   }
-  return ret;
 #else
   // CPUPS PSCORE
-  return SaveWithString(path, param);  // batch_model:0  xbox:1
+  ret = SaveWithString(path, param);  // batch_model:0  xbox:1
 #endif
+  UpdateDeltaAfterSave(save_param);
+  return ret;
 }
 
 #ifdef PADDLE_WITH_GPU_GRAPH
@@ -606,19 +688,23 @@ int32_t SSDSparseTable::Save_v2(const std::string& path,
     return Save(path, param);
   }
   std::lock_guard<std::mutex> guard(_table_mutex);
-#ifdef PADDLE_WITH_HETERPS
   int save_param = atoi(param.c_str());
+  if (save_param == kDeltaSaveParam) {
+    return SaveDelta(path);
+  }
   int32_t ret = 0;
+#ifdef PADDLE_WITH_HETERPS
   if (save_param > 3) {
     ret = SaveWithStringMultiOutput_v2(path, param);  // batch_model:4  xbox:5
   } else {
     ret = SaveWithBinary_v2(path, param);  // batch_model:0  xbox:1
   }
-  return ret;
 #else
   // CPUPS PSCORE
-  return SaveWithString(path, param);  // batch_model:0  xbox:1
+  ret = SaveWithString(path, param);  // batch_model:0  xbox:1
 #endif
+  UpdateDeltaAfterSave(save_param);
+  return ret;
 }
 #endif
 
@@ -2512,15 +2598,23 @@ int32_t SSDSparseTable::Load(const std::string& path,
     LOG(WARNING) << "SSDSparseTable load file is empty, path:" << path;
     return -1;
   }
+  if (load_param == kDeltaSaveParam) {
+    ClearPrefetched();
+    return LoadDelta(file_list);
+  }
+  int32_t ret = 0;
   if (load_param > 3) {
     size_t file_start_idx = _shard_idx * _avg_local_shard_num;
-    return LoadWithString(file_start_idx,
-                          file_start_idx + _real_local_shard_num,
-                          file_list,
-                          param);
+    ret = LoadWithString(file_start_idx,
+                         file_start_idx + _real_local_shard_num,
+                         file_list,
+                         param);
   } else {
-    return LoadWithBinary(table_path, load_param);
+    ret = LoadWithBinary(table_path, load_param);
   }
+  // the table is the same as the checkpoint now
+  ResetDelta();
+  return ret;
 }
 
 int32_t SSDSparseTable::LoadWithString(
@@ -2912,12 +3006,180 @@ int32_t SSDSparseTable::LoadWithBinary(const std::string& path, int param) {
 
 std::pair<int64_t, int64_t> SSDSparseTable::PrintTableStat() {
   int64_t feasign_size = LocalSize();
+  VLOG(0) << "SSDSparseTable pull stat: mem_hit " << _mem_hit_num.load()
+          << " ssd_hit " << _ssd_hit_num.load() << " (prefetch_hit "
+          << _prefetch_hit_num.load() << ") miss " << _miss_num.load();
   return {feasign_size, -1};
 }
 
+void SSDSparseTable::RecordAccess(int shard_id, uint64_t key) {
+  if (!_shard_sketches.empty()) {
+    _shard_sketches[shard_id]->Increment(key);
+  }
+}
+
+int32_t SSDSparseTable::PrefetchSparse(const uint64_t* keys, size_t num) {
+  std::vector<std::vector<uint64_t>> task_keys(_real_local_shard_num);
+  for (size_t i = 0; i < num; ++i) {
+    int shard_id = (keys[i] % _sparse_table_shard_num) % _avg_local_shard_num;
+    task_keys[shard_id].push_back(keys[i]);
+  }
+  std::lock_guard<std::mutex> guard(_prefetch_mutex);
+  for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
+    if (task_keys[shard_id].empty()) {
+      continue;
+    }
+    // the keys in memory are not in rocksdb, and cost little to look up by the
+    // bloom filter, so the shard is not touched here
+    _prefetch_tasks.push_back(_prefetch_pool->enqueue(
+        [this, shard_id, shard_keys = std::move(task_keys[shard_id])]() -> int {
+          const size_t batch_size = 1024;
+          std::vector<rocksdb::Slice> batch_keys;
+          std::vector<rocksdb::PinnableSlice> batch_values;
+          std::vector<rocksdb::Status> status;
+          for (size_t begin = 0; begin < shard_keys.size();
+               begin += batch_size) {
+            size_t end = std::min(begin + batch_size, shard_keys.size());
+            batch_keys.clear();
+            for (size_t i = begin; i < end; ++i) {
+              batch_keys.emplace_back(
+                  reinterpret_cast<const char*>(&shard_keys[i]),
+                  sizeof(uint64_t));
+            }
+            batch_values.clear();
+            batch_values.resize(batch_keys.size());
+            status.clear();
+            status.resize(batch_keys.size());
+            _db->multi_get(shard_id,
+                           batch_keys.size(),
+                           batch_keys.data(),
+                           batch_values.data(),
+                           status.data());
+            auto& buffer = _prefetch_buffers[shard_id];
+            std::lock_guard<std::mutex> lock(buffer.mutex);
+            for (size_t i = 0; i < batch_keys.size(); ++i) {
+              if (status[i].ok()) {
+                buffer.values[shard_keys[begin + i]] =
+                    batch_values[i].ToString();
+              }
+            }
+          }
+          return 0;
+        }));
+  }
+  return 0;
+}
+
+void SSDSparseTable::WaitPrefetch() {
+  std::lock_guard<std::mutex> guard(_prefetch_mutex);
+  for (auto& task : _prefetch_tasks) {
+    task.wait();
+  }
+  _prefetch_tasks.clear();
+}
+
+bool SSDSparseTable::TakePrefetched(int shard_id,
+                                    uint64_t key,
+                                    std::string* value) {
+  auto& buffer = _prefetch_buffers[shard_id];
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  auto it = buffer.values.find(key);
+  if (it == buffer.values.end()) {
+    return false;
+  }
+  *value = std::move(it->second);
+  buffer.values.erase(it);
+  ++_prefetch_hit_num;
+  return true;
+}
+
+void SSDSparseTable::ClearPrefetched() {
+  WaitPrefetch();
+  for (int i = 0; i < _real_local_shard_num; ++i) {
+    std::lock_guard<std::mutex> lock(_prefetch_buffers[i].mutex);
+    _prefetch_buffers[i].values.clear();
+  }
+}
+
+bool SSDSparseTable::FindDeltaValue(int shard_id,
+                                    uint64_t key,
+                                    std::vector<float>* value) {
+  if (MemorySparseTable::FindDeltaValue(shard_id, key, value)) {
+    return true;
+  }
+  std::string tmp_string;
+  if (_db->get(shard_id,
+               reinterpret_cast<char*>(&key),
+               sizeof(uint64_t),
+               tmp_string) > 0) {
+    return false;
+  }
+  const float* data = ::paddle::string::str_to_float(tmp_string);
+  value->assign(data, data + tmp_string.size() / sizeof(float));
+  return true;
+}
+
+void SSDSparseTable::VisitShardValues(
+    int shard_id,
+    const std::function<void(uint64_t, const float*, size_t)>& visitor) {
+  MemorySparseTable::VisitShardValues(shard_id, visitor);
+  auto* it = _db->get_iterator(shard_id);
+  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+    uint64_t key = *(reinterpret_cast<const uint64_t*>(it->key().data()));
+    visitor(key,
+            ::paddle::string::str_to_float(it->value().data()),
+            it->value().size() / sizeof(float));
+  }
+  delete it;
+}
+
+void SSDSparseTable::ApplyDeltaValue(int shard_id,
+                                     uint64_t key,
+                                     const float* value,
+                                     size_t size) {
+  // the value in memory is moved to rocksdb again by UpdateTable or
+  // CacheTable, drop the stale one in rocksdb
+  MemorySparseTable::ApplyDeltaValue(shard_id, key, value, size);
+  _db->del_data(shard_id, reinterpret_cast<char*>(&key), sizeof(uint64_t));
+}
+
+void SSDSparseTable::ApplyDeltaTombstone(int shard_id, uint64_t key) {
+  MemorySparseTable::ApplyDeltaTombstone(shard_id, key);
+  _db->del_data(shard_id, reinterpret_cast<char*>(&key), sizeof(uint64_t));
+}
+
+void SSDSparseTable::KeepHotFeatures(
+    size_t shard_id,
+    std::vector<shard_type::map_type::iterator>* datas,
+    std::unordered_set<uint64_t>* hot_keys) {
+  auto& sketch = *_shard_sketches[shard_id];
+  size_t keep_num = std::min(
+      static_cast<size_t>(FLAGS_pserver_ssd_keep_hot_num_per_shard),
+      datas->size());
+  auto hotter = [&sketch](const shard_type::map_type::iterator& a,
+                          const shard_type::map_type::iterator& b) {
+    return sketch.Estimate(a->first) > sketch.Estimate(b->first);
+  };
+  std::nth_element(
+      datas->begin(), datas->begin() + keep_num, datas->end(), hotter);
+  for (size_t i = 0; i < keep_num; ++i) {
+    if (sketch.Estimate((*datas)[i]->first) >=
+        FLAGS_pserver_ssd_hot_min_frequency) {
+      hot_keys->insert((*datas)[i]->first);
+    }
+  }
+  datas->erase(std::remove_if(datas->begin(),
+                              datas->end(),
+                              [hot_keys](const auto& data) {
+                                return hot_keys->count(data->first) > 0;
+                              }),
+               datas->end());
+}
+
 int32_t SSDSparseTable::CacheTable(uint16_t pass_id) {
   std::lock_guard<std::mutex> guard(_table_mutex);
   VLOG(0) << "cache_table";
+  ClearPrefetched();
   std::atomic<uint32_t> count{0};
   std::vector<std::future<int>> tasks;
 
@@ -2983,6 +3245,10 @@ int32_t SSDSparseTable::CacheTable(uint16_t pass_id) {
                 datas.emplace_back(it.it);
               }
             }
+            std::unordered_set<uint64_t> hot_keys;
+            if (!_shard_sketches.empty()) {
+              KeepHotFeatures(shard_id, &datas, &hot_keys);
+            }
             count.fetch_add(datas.size(), std::memory_order_relaxed);
             VLOG(0) << "datas size:  " << datas.size();
             {
@@ -3048,7 +3314,8 @@ int32_t SSDSparseTable::CacheTable(uint16_t pass_id) {
 
             for (auto it = shard.begin(); it != shard.end();) {
               if (!_value_accesor->SaveMemCache(
-                      it.value().data(), 0, show_threshold, pass_id)) {
+                      it.value().data(), 0, show_threshold, pass_id) &&
+                  hot_keys.count(it.key()) == 0) {
                 it = shard.erase(it);
               } else {
                 ++it;
@@ -14,6 +14,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "paddle/fluid/distributed/ps/table/depends/frequency_sketch.h"
 #include "paddle/fluid/distributed/ps/table/depends/rocksdb_warpper.h"
 #include "paddle/fluid/distributed/ps/table/memory_sparse_table.h"
 #include "paddle/utils/flags.h"
@@ -128,12 +133,60 @@ class SSDSparseTable : public MemorySparseTable {
 
   int32_t CacheTable(uint16_t pass_id) override;
 
+  // Read the keys from rocksdb asynchronously into the prefetch buffers, such
+  // as the keys of the next pass. The pulls of these keys missing memory take
+  // the values from the buffers instead of reading rocksdb synchronously.
+  int32_t PrefetchSparse(const uint64_t* keys, size_t num);
+  void WaitPrefetch();
+
  private:
+  struct PrefetchBuffer {
+    std::mutex mutex;
+    std::unordered_map<uint64_t, std::string> values;
+  };
+
+  void RecordAccess(int shard_id, uint64_t key);
+  bool TakePrefetched(int shard_id, uint64_t key, std::string* value);
+  // the prefetched values are stale once the features are moved between
+  // memory and rocksdb
+  void ClearPrefetched();
+  // the features of a shard are either in memory or in rocksdb
+  bool FindDeltaValue(int shard_id,
+                      uint64_t key,
+                      std::vector<float>* value) override;
+  void VisitShardValues(
+      int shard_id,
+      const std::function<void(uint64_t, const float*, size_t)>& visitor)
+      override;
+  void ApplyDeltaValue(int shard_id,
+                       uint64_t key,
+                       const float* value,
+                       size_t size) override;
+  void ApplyDeltaTombstone(int shard_id, uint64_t key) override;
+  // Keep the most frequently accessed features in memory although the
+  // accessor would move them to rocksdb, see
+  // FLAGS_pserver_ssd_keep_hot_num_per_shard.
+  void KeepHotFeatures(size_t shard_id,
+                       std::vector<shard_type::map_type::iterator>* datas,
+                       std::unordered_set<uint64_t>* hot_keys);
+
   RocksDBHandler* _db;
   int64_t _cache_tk_size;
   double _local_show_threshold{0.0};
   std::vector<paddle::framework::Channel<std::string>> _fs_channel;
   std::mutex _table_mutex;
+
+  std::vector<std::unique_ptr<FrequencySketch>> _shard_sketches;
+  std::unique_ptr<PrefetchBuffer[]> _prefetch_buffers;
+  std::unique_ptr<::ThreadPool> _prefetch_pool;
+  std::mutex _prefetch_mutex;
+  std::vector<std::future<int>> _prefetch_tasks;
+  // the source of the pulled features, the prefetch hits are counted in the
+  // ssd hits too
+  std::atomic<uint64_t> _mem_hit_num{0};
+  std::atomic<uint64_t> _prefetch_hit_num{0};
+  std::atomic<uint64_t> _ssd_hit_num{0};
+  std::atomic<uint64_t> _miss_num{0};
 };
 
 }  // namespace distributed
@@ -183,6 +183,16 @@ void FleetWrapper::BarrierWithTable(uint32_t barrier_type) {
   communicator->BarrierWithTable(barrier_type);
 }
 
+void FleetWrapper::BarrierArrive(uint32_t barrier_type) {
+  VLOG(3) << "Going to arrive at the barrier of worker";
+  Communicator::GetInstance()->BarrierArrive(barrier_type);
+}
+
+void FleetWrapper::BarrierWait() {
+  VLOG(3) << "Going to wait for the barrier of worker";
+  Communicator::GetInstance()->BarrierWait();
+}
+
 uint64_t FleetWrapper::RunServer(const std::string& ip, uint32_t port) {
   VLOG(3) << "Going to run server with ip " << ip << " port " << port;
   auto ret = pserver_ptr_->RunServer(ip, port);
@@ -364,13 +374,24 @@ void FleetWrapper::PullSparseToTensorSync(
     }
   }
 
-  auto status = worker_ptr_->PullSparse(pull_result_ptr.data(),
-                                        table_id,
-                                        fea_keys.data(),
-                                        fea_keys.size(),
-                                        is_training);
-  status.wait();
-  auto ret = status.get();
+  int32_t ret = 0;
+  if (SparsePullCoalescer::Enabled()) {
+    // the worker threads of the process pull together
+    ret = SparsePullCoalescer::GetInstance()->PullSparse(worker_ptr_.get(),
+                                                         pull_result_ptr.data(),
+                                                         table_id,
+                                                         fea_keys.data(),
+                                                         fea_keys.size(),
+                                                         is_training);
+  } else {
+    auto status = worker_ptr_->PullSparse(pull_result_ptr.data(),
+                                          table_id,
+                                          fea_keys.data(),
+                                          fea_keys.size(),
+                                          is_training);
+    status.wait();
+    ret = status.get();
+  }
   if (ret != 0) {
     LOG(ERROR) << "fleet pull sparse failed, status[" << ret << "]";
     sleep(sleep_seconds_before_fail_exit_);
@@ -240,6 +240,10 @@ class FleetWrapper {
 
   // barrier with barrier table
   void BarrierWithTable(uint32_t barrier_type);
+  // the split-phase barrier with table, the work between the arrive and the
+  // wait overlaps the barrier
+  void BarrierArrive(uint32_t barrier_type);
+  void BarrierWait();
 
   void PrintTableStat(const uint64_t table_id);
   void SaveCacheTable(const uint64_t table_id,
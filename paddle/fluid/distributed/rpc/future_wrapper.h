@@ -17,6 +17,7 @@
 #include <pybind11/pybind11.h>
 
 #include <cassert>
+#include <chrono>
 #include <future>
 #include <string>
 
@@ -30,7 +31,12 @@ namespace distributed {
 class FutureWrapper {
  public:
   FutureWrapper() {}
-  explicit FutureWrapper(std::future<std::string> fut) : fut_(std::move(fut)) {}
+  explicit FutureWrapper(std::future<RpcPayload> fut) : fut_(std::move(fut)) {}
+  // Whether the response has arrived, so that wait() does not block.
+  bool done() const {
+    return !fut_.valid() || fut_.wait_for(std::chrono::seconds(0)) ==
+                                std::future_status::ready;
+  }
   py::object wait() {
     // GIL must be released, otherwise fut_.get() blocking will cause the
     // service to fail to process RPC requests, leading to deadlock
@@ -41,17 +47,17 @@ class FutureWrapper {
             "GIL must be released before fut.wait(), otherwise fut_.get() "
             "blocking will cause the service to fail to "
             "process RPC requests, leading to deadlock"));
-    auto s = fut_.get();
+    auto payload = fut_.get();
     py::gil_scoped_acquire ag;
     std::shared_ptr<PythonRpcHandler> python_handler =
         PythonRpcHandler::GetInstance();
-    py::object obj = python_handler->Deserialize(py::bytes(s));
+    py::object obj = python_handler->Deserialize(payload);
     return obj;
   }
 
  private:
   DISABLE_COPY_AND_ASSIGN(FutureWrapper);
-  std::future<std::string> fut_;
+  std::future<RpcPayload> fut_;
 };
 }  // namespace distributed
 }  // namespace paddle
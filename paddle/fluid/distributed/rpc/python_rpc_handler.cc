@@ -37,15 +37,26 @@ py::object PythonRpcHandler::RunPythonFunc(const py::object& python_func) {
   return py_run_function_(python_func);
 }
 
-std::string PythonRpcHandler::Serialize(const py::object& obj) {
+RpcPayload PythonRpcHandler::Serialize(const py::object& obj) {
   py::gil_scoped_acquire ag;
-  py::object res = py_serialize_(obj);
-  return res.cast<std::string>();
+  py::tuple res = py_serialize_(obj);
+  RpcPayload payload;
+  payload.message = res[0].cast<std::string>();
+  for (auto item : res[1].cast<py::list>()) {
+    py::buffer_info info = py::reinterpret_borrow<py::buffer>(item).request();
+    payload.buffers.emplace_back(static_cast<const char*>(info.ptr),
+                                 info.size * info.itemsize);
+  }
+  return payload;
 }
 
-py::object PythonRpcHandler::Deserialize(const std::string& obj) {
+py::object PythonRpcHandler::Deserialize(const RpcPayload& payload) {
   py::gil_scoped_acquire ag;
-  return py_deserialize_(py::bytes(obj));
+  py::list buffers;
+  for (auto& buffer : payload.buffers) {
+    buffers.append(py::bytes(buffer));
+  }
+  return py_deserialize_(py::bytes(payload.message), buffers);
 }
 
 std::shared_ptr<PythonRpcHandler> PythonRpcHandler::python_rpc_handler_ =
@@ -19,6 +19,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "paddle/fluid/platform/macros.h"
 
@@ -27,6 +28,13 @@ namespace py = pybind11;
 namespace paddle {
 namespace distributed {
 
+// A pickled Python object. The out-of-band buffers of the pickle, such as the
+// data of the numpy arrays, are sent as the raw attachment of the rpc.
+struct RpcPayload {
+  std::string message;
+  std::vector<std::string> buffers;
+};
+
 class PYBIND11_EXPORT PythonRpcHandler {
  public:
   PythonRpcHandler();
@@ -35,11 +43,11 @@ class PYBIND11_EXPORT PythonRpcHandler {
   // Run a pickled Python function and return the result py::object
   py::object RunPythonFunc(const py::object& python_func);
 
-  // Serialized a py::object into a string
-  std::string Serialize(const py::object& obj);
+  // Serialized a py::object into a pickle and its out-of-band buffers
+  RpcPayload Serialize(const py::object& obj);
 
-  // Deserialize a string into a py::object
-  py::object Deserialize(const std::string& obj);
+  // Deserialize a pickle and its out-of-band buffers into a py::object
+  py::object Deserialize(const RpcPayload& payload);
 
  private:
   DISABLE_COPY_AND_ASSIGN(PythonRpcHandler);
@@ -97,34 +97,74 @@ void OnRpcDone::Run() {
   std::unique_ptr<OnRpcDone> self_guard(this);
   PADDLE_ENFORCE_EQ(
       cntl_.Failed(), false, platform::errors::Fatal(cntl_.ErrorText()));
-  promise_->set_value(response_.message());
+  promise_->set_value(
+      UnpackRpcPayload(response_, &cntl_.response_attachment()));
   VLOG(2) << "Received response from " << cntl_.remote_side() << " to "
           << cntl_.local_side() << " (attached=" << cntl_.response_attachment()
           << ")"
           << " latency=" << cntl_.latency_us() << "us";
 }
 
-std::future<std::string> RpcAgent::InvokeRpc(const std::string &py_func,
-                                             const std::string &to,
-                                             int timeout_ms = kTimeoutMs) {
+void OnRpcBatchDone::Run() {
+  std::unique_ptr<OnRpcBatchDone> self_guard(this);
+  PADDLE_ENFORCE_EQ(
+      cntl_.Failed(), false, platform::errors::Fatal(cntl_.ErrorText()));
+  PADDLE_ENFORCE_EQ(
+      response_.responses_size(),
+      static_cast<int>(promises_.size()),
+      platform::errors::Fatal("Received %d responses of %d requests.",
+                              response_.responses_size(),
+                              promises_.size()));
+  for (size_t i = 0; i < promises_.size(); ++i) {
+    promises_[i].set_value(UnpackRpcPayload(response_.responses(i),
+                                            &cntl_.response_attachment()));
+  }
+  VLOG(2) << "Received " << promises_.size() << " responses from "
+          << cntl_.remote_side() << " latency=" << cntl_.latency_us() << "us";
+}
+
+brpc::Channel *RpcAgent::GetChannel(const std::string &to) {
   auto it = name_to_infos_.find(to);
   PADDLE_ENFORCE_NE(
       it,
       name_to_infos_.end(),
       platform::errors::OutOfRange("Worker %s doesn't exist!", to));
-  uint32_t id = it->second.id_;
-  auto channel = channels_[id];
+  return channels_[it->second.id_].get();
+}
+
+std::future<RpcPayload> RpcAgent::InvokeRpc(const RpcPayload &py_func,
+                                            const std::string &to,
+                                            int timeout_ms = kTimeoutMs) {
+  auto channel = GetChannel(to);
   // `done` must be allocated on the heap because its life cycle is after
   // calling done.Run().
   OnRpcDone *done = new OnRpcDone;
   done->cntl_.set_timeout_ms(timeout_ms);
-  done->request_.set_message(py_func);
-  std::future<std::string> fut = done->GetFuture();
-  RpcBaseService_Stub stub(channel.get());
+  PackRpcPayload(py_func, &done->request_, &done->cntl_.request_attachment());
+  std::future<RpcPayload> fut = done->GetFuture();
+  RpcBaseService_Stub stub(channel);
   stub.InvokeRpc(&done->cntl_, &done->request_, &done->response_, done);
   return fut;
 }
 
+std::vector<std::future<RpcPayload>> RpcAgent::InvokeRpcBatch(
+    const std::vector<RpcPayload> &py_funcs,
+    const std::string &to,
+    int timeout_ms = kTimeoutMs) {
+  auto channel = GetChannel(to);
+  OnRpcBatchDone *done = new OnRpcBatchDone(py_funcs.size());
+  done->cntl_.set_timeout_ms(timeout_ms);
+  for (auto &py_func : py_funcs) {
+    PackRpcPayload(py_func,
+                   done->request_.add_requests(),
+                   &done->cntl_.request_attachment());
+  }
+  auto futures = done->GetFutures();
+  RpcBaseService_Stub stub(channel);
+  stub.InvokeRpcBatch(&done->cntl_, &done->request_, &done->response_, done);
+  return futures;
+}
+
 std::shared_ptr<RpcAgent> RpcAgent::RpcAgentInstance() {
   PADDLE_ENFORCE_NE(rpc_agent_instance_,
                     nullptr,
@@ -47,16 +47,32 @@ struct WorkerInfo {
 
 class OnRpcDone : public google::protobuf::Closure {
  public:
-  OnRpcDone() { promise_ = std::make_shared<std::promise<std::string>>(); }
+  OnRpcDone() { promise_ = std::make_shared<std::promise<RpcPayload>>(); }
   // process callback of response
   void Run();
-  std::future<std::string> GetFuture() {
-    return std::future<std::string>(promise_->get_future());
+  std::future<RpcPayload> GetFuture() {
+    return std::future<RpcPayload>(promise_->get_future());
   }
   RpcResponse response_;
   RpcRequest request_;
   brpc::Controller cntl_;
-  std::shared_ptr<std::promise<std::string>> promise_;
+  std::shared_ptr<std::promise<RpcPayload>> promise_;
+};
+
+// The callback of a batch of rpcs, which completes a future per rpc.
+class OnRpcBatchDone : public google::protobuf::Closure {
+ public:
+  explicit OnRpcBatchDone(size_t size) : promises_(size) {}
+  void Run();
+  std::vector<std::future<RpcPayload>> GetFutures() {
+    std::vector<std::future<RpcPayload>> futures;
+    for (auto &promise : promises_) futures.push_back(promise.get_future());
+    return futures;
+  }
+  RpcBatchResponse response_;
+  RpcBatchRequest request_;
+  brpc::Controller cntl_;
+  std::vector<std::promise<RpcPayload>> promises_;
 };
 
 class RpcAgent {
@@ -91,12 +107,20 @@ class RpcAgent {
   int StartClient();
   int Stop();
 
-  std::future<std::string> InvokeRpc(const std::string &msg,
-                                     const std::string &to,
-                                     int timeout_ms);
+  std::future<RpcPayload> InvokeRpc(const RpcPayload &py_func,
+                                    const std::string &to,
+                                    int timeout_ms);
+
+  // Sends the functions to the worker in one request, the futures are
+  // completed together when the response arrives.
+  std::vector<std::future<RpcPayload>> InvokeRpcBatch(
+      const std::vector<RpcPayload> &py_funcs,
+      const std::string &to,
+      int timeout_ms);
 
  private:
   DISABLE_COPY_AND_ASSIGN(RpcAgent);
+  brpc::Channel *GetChannel(const std::string &to);
   static std::shared_ptr<RpcAgent> rpc_agent_instance_;
   brpc::Server server_;
   std::shared_ptr<RpcService> rpc_service_;
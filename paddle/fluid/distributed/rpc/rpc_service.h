@@ -17,12 +17,40 @@
 #include <brpc/server.h>
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "paddle/fluid/distributed/rpc/python_rpc_handler.h"
 #include "paddle/fluid/distributed/rpc/rpc.pb.h"
 
 namespace paddle {
 namespace distributed {
+// Fills a request or a response by the payload, the buffers are appended to
+// the attachment.
+template <typename Message>
+void PackRpcPayload(const RpcPayload &payload,
+                    Message *message,
+                    butil::IOBuf *attachment) {
+  message->set_message(payload.message);
+  for (auto &buffer : payload.buffers) {
+    message->add_buffer_sizes(buffer.size());
+    attachment->append(buffer);
+  }
+}
+
+// Cuts the buffers of the request or the response from the attachment.
+template <typename Message>
+RpcPayload UnpackRpcPayload(const Message &message, butil::IOBuf *attachment) {
+  RpcPayload payload;
+  payload.message = message.message();
+  for (auto size : message.buffer_sizes()) {
+    std::string buffer;
+    attachment->cutn(&buffer, size);
+    payload.buffers.push_back(std::move(buffer));
+  }
+  return payload;
+}
+
 class RpcService : public RpcBaseService {
  public:
   RpcService() {}
@@ -41,15 +69,44 @@ class RpcService : public RpcBaseService {
             << "] from " << cntl->remote_side() << " to " << cntl->local_side()
             << ": "
             << " (attached=" << cntl->request_attachment() << ")";
-    std::string py_func_str = request->message();
+    RpcPayload py_func =
+        UnpackRpcPayload(*request, &cntl->request_attachment());
     std::shared_ptr<PythonRpcHandler> python_handler =
         PythonRpcHandler::GetInstance();
     // acquire gil, because native Python objects are used
     py::gil_scoped_acquire ag;
-    py::object py_func_obj = python_handler->Deserialize(py_func_str);
+    py::object py_func_obj = python_handler->Deserialize(py_func);
     py::object res = python_handler->RunPythonFunc(py_func_obj);
-    std::string res_str = python_handler->Serialize(res);
-    response->set_message(res_str);
+    PackRpcPayload(python_handler->Serialize(res),
+                   response,
+                   &cntl->response_attachment());
+  }
+
+  // Runs the functions of a batch in order under one acquire of the gil.
+  virtual void InvokeRpcBatch(google::protobuf::RpcController *cntl_base,
+                              const RpcBatchRequest *request,
+                              RpcBatchResponse *response,
+                              google::protobuf::Closure *done) {
+    brpc::ClosureGuard done_guard(done);
+
+    brpc::Controller *cntl = static_cast<brpc::Controller *>(cntl_base);
+    VLOG(2) << "InvokeRpcBatch API: Received " << request->requests_size()
+            << " requests[log_id=" << cntl->log_id() << "] from "
+            << cntl->remote_side() << " to " << cntl->local_side();
+    std::vector<RpcPayload> py_funcs;
+    for (auto &item : request->requests()) {
+      py_funcs.push_back(UnpackRpcPayload(item, &cntl->request_attachment()));
+    }
+    std::shared_ptr<PythonRpcHandler> python_handler =
+        PythonRpcHandler::GetInstance();
+    py::gil_scoped_acquire ag;
+    for (auto &py_func : py_funcs) {
+      py::object py_func_obj = python_handler->Deserialize(py_func);
+      py::object res = python_handler->RunPythonFunc(py_func_obj);
+      PackRpcPayload(python_handler->Serialize(res),
+                     response->add_responses(),
+                     &cntl->response_attachment());
+    }
   }
 };
 }  // namespace distributed
@@ -0,0 +1,54 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/table/feature_policy.h"
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace distributed {
+
+TEST(FeaturePolicy, SketchAdmission) {
+  SketchAdmissionPolicy policy(1 << 16, 3);
+  ASSERT_FALSE(policy.Admit(1));
+  ASSERT_FALSE(policy.Admit(1));
+  ASSERT_TRUE(policy.Admit(1));
+  ASSERT_TRUE(policy.Admit(1));
+
+  // the long-tail keys pushed once are not admitted
+  int admitted = 0;
+  for (uint64_t key = 100; key < 1100; ++key) {
+    admitted += policy.Admit(key);
+  }
+  ASSERT_LT(admitted, 10);
+
+  // the threshold is capped by the max count of the sketch
+  SketchAdmissionPolicy capped(1 << 10, 100);
+  bool is_admitted = false;
+  for (int i = 0; i < FrequencySketch::kMaxCount; ++i) {
+    is_admitted = capped.Admit(7);
+  }
+  ASSERT_TRUE(is_admitted);
+}
+
+TEST(FeaturePolicy, Eviction) {
+  FeatureEvictionPolicy policy(100, 0.5);
+  ASSERT_FALSE(policy.NeedEvict(100));
+  ASSERT_TRUE(policy.NeedEvict(101));
+  ASSERT_TRUE(policy.Evict(0.1));
+  ASSERT_FALSE(policy.Evict(0.5));
+}
+
+}  // namespace distributed
+}  // namespace paddle
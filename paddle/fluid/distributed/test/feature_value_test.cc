@@ -14,6 +14,7 @@ limitations under the License. */
 
 #include "paddle/fluid/distributed/ps/table/depends/feature_value.h"
 
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -46,5 +47,44 @@ TEST(BENCHMARK, LargeScaleKV) {
   ASSERT_FLOAT_EQ(value_data[3], 0.3);
 }
 
+TEST(SparseTableShard, ConcurrentBucketAccess) {
+  typedef SparseTableShard<uint64_t, FixedFeatureValue> shard_type;
+  shard_type shard;
+  shard.set_concurrent(true);
+
+  // every thread adds 1 to the values of all the keys, creating the values
+  // of the missed keys
+  const int thread_num = 8;
+  const uint64_t key_num = 10000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_num; ++t) {
+    threads.emplace_back([&shard, t]() {
+      for (uint64_t i = 0; i < key_num; ++i) {
+        uint64_t key = (i + t * key_num / thread_num) % key_num;
+        size_t bucket = shard.compute_bucket_by_key(key);
+        std::lock_guard<std::mutex> lock(shard.bucket_mutex(bucket));
+        auto itr = shard.find(bucket, key);
+        if (itr == shard.end(bucket)) {
+          auto& feature_value = shard[key];
+          feature_value.resize(1);
+          feature_value.data()[0] = 0.0;
+          itr = shard.find(bucket, key);
+        }
+        itr.value().data()[0] += 1.0;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(shard.size(), key_num);
+  for (uint64_t key = 0; key < key_num; ++key) {
+    auto itr = shard.find(key);
+    ASSERT_TRUE(itr != shard.end());
+    ASSERT_FLOAT_EQ(itr.value().data()[0], thread_num);
+  }
+}
+
 }  // namespace distributed
 }  // namespace paddle
@@ -0,0 +1,50 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/table/depends/frequency_sketch.h"
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace distributed {
+
+TEST(FrequencySketch, HotKeysEstimatedHigher) {
+  FrequencySketch sketch(1024);
+  ASSERT_EQ(sketch.width(), 1024u);
+  for (uint64_t key = 0; key < 500; ++key) {
+    sketch.Increment(key);
+  }
+  for (int i = 0; i < 10; ++i) {
+    sketch.Increment(100000);
+  }
+  EXPECT_GE(sketch.Estimate(100000), 10);
+  EXPECT_LE(sketch.Estimate(1), 2);
+  EXPECT_EQ(sketch.Estimate(200000), 0);
+}
+
+TEST(FrequencySketch, SaturateAndAge) {
+  FrequencySketch sketch(16);
+  for (int i = 0; i < 100; ++i) {
+    sketch.Increment(7);
+  }
+  // saturated at kMaxCount, and halved every 160 increments
+  EXPECT_EQ(sketch.Estimate(7), FrequencySketch::kMaxCount);
+  for (int i = 0; i < 60; ++i) {
+    sketch.Increment(8);
+  }
+  EXPECT_EQ(sketch.Estimate(7), FrequencySketch::kMaxCount / 2);
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,141 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/ps/table/graph/graph_node.h"
+
+namespace paddle {
+namespace distributed {
+
+namespace {
+std::vector<std::pair<uint64_t, float>> GetEdges(Node* node) {
+  std::vector<std::pair<uint64_t, float>> edges;
+  for (size_t i = 0; i < node->get_neighbor_size(); i++) {
+    edges.push_back({node->get_neighbor_id(i),
+                     static_cast<float>(node->get_neighbor_weight(i))});
+  }
+  std::sort(edges.begin(), edges.end());
+  return edges;
+}
+}  // namespace
+
+TEST(CompactGraphNode, Encode) {
+  std::mt19937_64 rng(0);
+  GraphNode node(1);
+  node.build_edges(true);
+  for (int i = 0; i < 1000; i++) {
+    // dense ids, sparse ids and duplicates
+    uint64_t id = i < 300 ? i : i < 900 ? rng() : 7;
+    node.add_edge(id, (i % 17) * 0.25);
+  }
+  node.add_edge(0, 1.0);
+  node.add_edge(UINT64_MAX, 1.0);
+  auto edges = GetEdges(&node);
+
+  CompactGraphNode compact_node(&node, true, 32);
+  ASSERT_EQ(compact_node.get_id(), 1UL);
+  ASSERT_EQ(GetEdges(&compact_node), edges);
+  ASSERT_LT(compact_node.get_edge_bytes(),
+            edges.size() * (sizeof(uint64_t) + sizeof(float)));
+  std::unique_ptr<GraphNode> graph_node(compact_node.to_graph_node());
+  ASSERT_EQ(GetEdges(graph_node.get()), edges);
+
+  CompactGraphNode quantized_node(&node, true, 8);
+  auto quantized_edges = GetEdges(&quantized_node);
+  ASSERT_EQ(quantized_edges.size(), edges.size());
+  for (size_t i = 0; i < edges.size(); i++) {
+    ASSERT_EQ(quantized_edges[i].first, edges[i].first);
+    ASSERT_NEAR(quantized_edges[i].second, edges[i].second, 4.0 / 255);
+  }
+
+  GraphNode empty_node(2);
+  empty_node.build_edges(false);
+  CompactGraphNode compact_empty_node(&empty_node, false, 32);
+  ASSERT_EQ(compact_empty_node.get_neighbor_size(), 0UL);
+  auto rng_ptr = std::make_shared<std::mt19937_64>(0);
+  ASSERT_TRUE(compact_empty_node.sample_k(3, rng_ptr).empty());
+}
+
+TEST(CompactGraphNode, WeightedSample) {
+  GraphNode node(1);
+  node.build_edges(true);
+  node.add_edge(10, 1.0);
+  node.add_edge(20, 0.0);
+  node.add_edge(30, 3.0);
+  node.add_edge(40, 0.0);
+  CompactGraphNode compact_node(&node, true, 32);
+  compact_node.build_sampler("weighted");
+
+  auto rng = std::make_shared<std::mt19937_64>(0);
+  int count[4] = {0, 0, 0, 0};
+  int sample_num = 20000;
+  for (int i = 0; i < sample_num; i++) {
+    auto res = compact_node.sample_k(1, rng);
+    ASSERT_EQ(res.size(), 1UL);
+    count[compact_node.get_neighbor_id(res[0]) / 10 - 1]++;
+  }
+  ASSERT_EQ(count[1] + count[3], 0);
+  ASSERT_NEAR(static_cast<double>(count[2]) / sample_num, 0.75, 0.02);
+
+  // the zero weights are sampled after all the others
+  for (int i = 0; i < 100; i++) {
+    auto res = compact_node.sample_k(3, rng);
+    std::set<uint64_t> ids;
+    for (int idx : res) ids.insert(compact_node.get_neighbor_id(idx));
+    ASSERT_EQ(ids.size(), 3UL);
+    ASSERT_TRUE(ids.count(10) > 0 && ids.count(30) > 0);
+  }
+  ASSERT_EQ(compact_node.sample_k(5, rng).size(), 4UL);
+
+  compact_node.build_sampler("random");
+  int zero_count = 0;
+  for (int i = 0; i < 1000; i++) {
+    auto res = compact_node.sample_k(1, rng);
+    zero_count += compact_node.get_neighbor_weight(res[0]) == 0;
+  }
+  ASSERT_GT(zero_count, 0);
+}
+
+TEST(AliasSampler, SampleTable) {
+  std::vector<float> weights = {0.5, 2.0, 0.0, 1.0, 0.5};
+  std::vector<float> prob(weights.size());
+  std::vector<uint32_t> alias(weights.size());
+  AliasSampler::build_table(
+      weights.data(), weights.size(), prob.data(), alias.data());
+  auto rng = std::make_shared<std::mt19937_64>(0);
+  std::vector<int> count(weights.size());
+  int sample_num = 40000;
+  for (int i = 0; i < sample_num; i++) {
+    auto res = AliasSampler::sample_table(
+        prob.data(), alias.data(), weights.size(), 2, rng);
+    ASSERT_EQ(res.size(), 2UL);
+    ASSERT_NE(res[0], res[1]);
+    count[res[0]]++;
+  }
+  for (size_t i = 0; i < weights.size(); i++) {
+    ASSERT_NEAR(static_cast<double>(count[i]) / sample_num,
+                weights[i] / 4.0,
+                0.02);
+  }
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,467 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+// A load benchmark of the sparse tables of the parameter server. The threads
+// pull and push the keys of a Zipf distribution at a given QPS, against a
+// local MemorySparseTable or SSDSparseTable, or against a BrpcPsServer on
+// this host through a BrpcPsClient. It reports the throughput, the latency
+// percentiles, the CPU time per request and the memory per feature.
+//
+//   ps_table_benchmark --mode=brpc --table_class=MemorySparseTable \
+//       --num_keys=10000000 --zipf_s=1.1 --keys_per_request=1000 \
+//       --embedx_dim=8 --threads=8 --qps=400 --duration_s=60
+//
+// The latency of a request is from the time it is scheduled at, so a table
+// slower than the QPS shows the queueing of the requests behind it.
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/fluid/distributed/ps/service/brpc_ps_client.h"
+#include "paddle/fluid/distributed/ps/service/brpc_ps_server.h"
+#include "paddle/fluid/distributed/ps/service/env.h"
+#include "paddle/fluid/distributed/ps/table/depends/sparse_utils.h"
+#include "paddle/fluid/distributed/ps/table/table.h"
+#include "paddle/fluid/distributed/the_one_ps.pb.h"
+#include "paddle/fluid/framework/program_desc.h"
+#include "paddle/utils/flags.h"
+
+PD_DEFINE_string(mode, "local", "local, or brpc through a server on the host.");
+PD_DEFINE_string(table_class,
+                 "MemorySparseTable",
+                 "MemorySparseTable or SSDSparseTable.");
+PD_DEFINE_int64(num_keys, 1000000, "The number of the distinct keys.");
+PD_DEFINE_double(zipf_s, 1.1, "The exponent of the Zipf distribution.");
+PD_DEFINE_int32(keys_per_request, 1000, "The keys of a pull or push.");
+PD_DEFINE_int32(embedx_dim, 8, "The dim of the embedx of a feature.");
+PD_DEFINE_int32(threads, 4, "The threads sending the requests.");
+PD_DEFINE_double(qps, 0, "The requests per second of all threads, 0 as fast.");
+PD_DEFINE_double(push_ratio, 0.5, "The fraction of the requests of push.");
+PD_DEFINE_int32(duration_s, 10, "The seconds to send the requests for.");
+PD_DEFINE_int32(shard_num, 10, "The shards of the table.");
+PD_DEFINE_int32(server_threads, 12, "The threads of the brpc server.");
+PD_DEFINE_int32(port, 4219, "The port of the brpc server.");
+PD_DEFINE_int64(seed, 0, "The seed of the keys.");
+
+namespace paddle {
+namespace distributed {
+namespace benchmark {
+
+using Clock = std::chrono::steady_clock;
+
+// Samples the ranks of a Zipf distribution by the binary search of its CDF,
+// and scrambles a rank into a key by an odd multiplier, a bijection of the
+// uint64, so that the hot keys are over all the shards.
+class ZipfKeys {
+ public:
+  ZipfKeys(int64_t num_keys, double s) : cdf_(num_keys) {
+    double sum = 0;
+    for (int64_t i = 0; i < num_keys; ++i) {
+      sum += 1.0 / std::pow(static_cast<double>(i + 1), s);
+      cdf_[i] = sum;
+    }
+    for (auto& value : cdf_) {
+      value /= sum;
+    }
+  }
+
+  uint64_t Next(std::mt19937_64* rng) const {
+    const double u = std::uniform_real_distribution<double>(0, 1)(*rng);
+    const int64_t rank =
+        std::min<int64_t>(std::lower_bound(cdf_.begin(), cdf_.end(), u) -
+                              cdf_.begin(),
+                          cdf_.size() - 1);
+    return static_cast<uint64_t>(rank) * 0x9E3779B97F4A7C15ULL;
+  }
+
+ private:
+  std::vector<double> cdf_;
+};
+
+void GetSparseTableProto(TableParameter* table_proto) {
+  table_proto->set_table_id(0);
+  table_proto->set_table_class(FLAGS_table_class);
+  table_proto->set_shard_num(FLAGS_shard_num);
+  TableAccessorParameter* accessor_config = table_proto->mutable_accessor();
+  accessor_config->set_accessor_class("CtrCommonAccessor");
+  accessor_config->set_fea_dim(FLAGS_embedx_dim + 3);
+  accessor_config->set_embedx_dim(FLAGS_embedx_dim);
+  accessor_config->set_embedx_threshold(0);
+  auto* ctr_param = accessor_config->mutable_ctr_accessor_param();
+  ctr_param->set_nonclk_coeff(0.1);
+  ctr_param->set_click_coeff(1);
+  ctr_param->set_base_threshold(0.5);
+  ctr_param->set_delta_threshold(0.2);
+  ctr_param->set_delta_keep_days(16);
+  ctr_param->set_show_click_decay_rate(0.99);
+  for (auto* sgd_param : {accessor_config->mutable_embed_sgd_param(),
+                          accessor_config->mutable_embedx_sgd_param()}) {
+    sgd_param->set_name("SparseAdaGradSGDRule");
+    auto* adagrad_param = sgd_param->mutable_adagrad();
+    adagrad_param->set_learning_rate(0.05);
+    adagrad_param->set_initial_g2sum(3.0);
+    adagrad_param->set_initial_range(0.0001);
+    adagrad_param->add_weight_bounds(-10.0);
+    adagrad_param->add_weight_bounds(10.0);
+  }
+}
+
+// The pulls and pushes of a table, safe to call from the threads.
+class SparseDriver {
+ public:
+  virtual ~SparseDriver() = default;
+  virtual void Pull(std::vector<uint64_t>* keys,
+                    std::vector<float>* values) = 0;
+  virtual void Push(const std::vector<uint64_t>& keys,
+                    const std::vector<float>& grads) = 0;
+  virtual int64_t NumFeatures() = 0;
+
+  size_t select_dim() const { return info_.select_dim; }
+  size_t update_dim() const { return info_.update_dim; }
+
+ protected:
+  AccessorInfo info_;
+};
+
+class LocalDriver : public SparseDriver {
+ public:
+  LocalDriver() {
+    TableParameter table_config;
+    GetSparseTableProto(&table_config);
+    FsClientParameter fs_config;
+    table_.reset(CREATE_PSCORE_CLASS(Table, FLAGS_table_class));
+    PADDLE_ENFORCE_NOT_NULL(
+        table_.get(),
+        phi::errors::InvalidArgument("The table class %s is not registered.",
+                                     FLAGS_table_class));
+    table_->SetShard(0, 1);
+    PADDLE_ENFORCE_EQ(table_->Initialize(table_config, fs_config),
+                      0,
+                      phi::errors::External("Failed to initialize the %s.",
+                                            FLAGS_table_class));
+    info_ = table_->ValueAccesor()->GetAccessorInfo();
+  }
+
+  void Pull(std::vector<uint64_t>* keys, std::vector<float>* values) override {
+    std::vector<uint32_t> frequencies(keys->size(), 1);
+    TableContext context;
+    context.value_type = Sparse;
+    context.pull_context.pull_value =
+        PullSparseValue(*keys, frequencies, FLAGS_embedx_dim);
+    context.pull_context.values = values->data();
+    table_->Pull(context);
+  }
+
+  void Push(const std::vector<uint64_t>& keys,
+            const std::vector<float>& grads) override {
+    TableContext context;
+    context.value_type = Sparse;
+    context.push_context.keys = keys.data();
+    context.push_context.values = grads.data();
+    context.num = keys.size();
+    table_->Push(context);
+  }
+
+  int64_t NumFeatures() override { return table_->PrintTableStat().first; }
+
+ private:
+  std::unique_ptr<Table> table_;
+};
+
+class BrpcDriver : public SparseDriver {
+ public:
+  BrpcDriver() {
+    setenv("http_proxy", "", 1);
+    setenv("https_proxy", "", 1);
+    host_sign_list_.push_back(
+        PSHost("127.0.0.1", FLAGS_port, 0).SerializeToString());
+
+    PSParameter server_proto;
+    auto* server_param = server_proto.mutable_server_param()
+                             ->mutable_downpour_server_param();
+    SetServiceParam(server_param->mutable_service_param());
+    GetSparseTableProto(server_param->add_downpour_table_param());
+    PaddlePSEnvironment server_env;
+    server_env.SetPsServers(&host_sign_list_, 1);
+    server_.reset(PSServerFactory::Create(server_proto));
+    std::vector<framework::ProgramDesc> empty_progs(1);
+    server_->Configure(server_proto, server_env, 0, empty_progs);
+    server_thread_ = std::thread(
+        [this] { server_->Start("127.0.0.1", FLAGS_port); });
+    sleep(1);
+
+    PSParameter worker_proto;
+    GetSparseTableProto(worker_proto.mutable_worker_param()
+                            ->mutable_downpour_worker_param()
+                            ->add_downpour_table_param());
+    auto* worker_server_param = worker_proto.mutable_server_param()
+                                    ->mutable_downpour_server_param();
+    SetServiceParam(worker_server_param->mutable_service_param());
+    GetSparseTableProto(worker_server_param->add_downpour_table_param());
+    PaddlePSEnvironment worker_env;
+    worker_env.SetPsServers(&host_sign_list_, 1);
+    std::map<uint64_t, std::vector<Region>> dense_regions;
+    client_.reset(PSClientFactory::Create(worker_proto));
+    client_->Configure(worker_proto, dense_regions, worker_env, 0);
+    info_ = server_->GetTable(0)->ValueAccesor()->GetAccessorInfo();
+  }
+
+  ~BrpcDriver() override {
+    client_->StopServer();
+    client_->FinalizeWorker();
+    server_thread_.join();
+  }
+
+  void Pull(std::vector<uint64_t>* keys, std::vector<float>* values) override {
+    std::vector<float*> value_ptrs(keys->size());
+    for (size_t i = 0; i < keys->size(); ++i) {
+      value_ptrs[i] = values->data() + i * select_dim();
+    }
+    client_->PullSparse(value_ptrs.data(), 0, keys->data(), keys->size(), true)
+        .wait();
+  }
+
+  void Push(const std::vector<uint64_t>& keys,
+            const std::vector<float>& grads) override {
+    std::vector<const float*> grad_ptrs(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      grad_ptrs[i] = grads.data() + i * update_dim();
+    }
+    auto* closure = new DownpourBrpcClosure(1, [](void* done) {
+      auto* closure = reinterpret_cast<DownpourBrpcClosure*>(done);
+      closure->set_promise_value(
+          closure->check_response(0, PS_PUSH_SPARSE_TABLE) != 0 ? -1 : 0);
+    });
+    client_
+        ->PushSparseRawGradient(
+            0, keys.data(), grad_ptrs.data(), keys.size(), closure)
+        .wait();
+  }
+
+  int64_t NumFeatures() override {
+    return server_->GetTable(0)->PrintTableStat().first;
+  }
+
+ private:
+  static void SetServiceParam(ServerServiceParameter* service_param) {
+    service_param->set_service_class("BrpcPsService");
+    service_param->set_server_class("BrpcPsServer");
+    service_param->set_client_class("BrpcPsClient");
+    service_param->set_start_server_port(0);
+    service_param->set_server_thread_num(FLAGS_server_threads);
+  }
+
+  std::vector<std::string> host_sign_list_;
+  std::unique_ptr<PSServer> server_;
+  std::unique_ptr<PSClient> client_;
+  std::thread server_thread_;
+};
+
+// The latencies in microseconds of the requests of a thread.
+struct ThreadStats {
+  std::vector<double> pull_us;
+  std::vector<double> push_us;
+};
+
+void RunThread(SparseDriver* driver,
+               const ZipfKeys& zipf,
+               int thread_id,
+               Clock::time_point start,
+               ThreadStats* stats) {
+  std::mt19937_64 rng(FLAGS_seed * 7919 + thread_id);
+  std::uniform_real_distribution<double> uniform(0, 1);
+  std::vector<uint64_t> keys(FLAGS_keys_per_request);
+  std::vector<float> values(keys.size() * driver->select_dim());
+  std::vector<float> grads(keys.size() * driver->update_dim());
+  const auto deadline = start + std::chrono::seconds(FLAGS_duration_s);
+  const auto interval =
+      FLAGS_qps > 0 ? std::chrono::duration_cast<Clock::duration>(
+                          std::chrono::duration<double>(FLAGS_threads /
+                                                        FLAGS_qps))
+                    : Clock::duration::zero();
+  // The requests of the threads are staggered over an interval.
+  auto scheduled = start + interval * thread_id / FLAGS_threads;
+  while (scheduled < deadline) {
+    if (interval > Clock::duration::zero()) {
+      std::this_thread::sleep_until(scheduled);
+    } else {
+      scheduled = Clock::now();
+    }
+    for (auto& key : keys) {
+      key = zipf.Next(&rng);
+    }
+    const bool push = uniform(rng) < FLAGS_push_ratio;
+    if (push) {
+      // slot, show, click, embed_g and embedx_g of a key.
+      for (size_t i = 0; i < keys.size(); ++i) {
+        float* grad = grads.data() + i * driver->update_dim();
+        grad[0] = 0;
+        grad[1] = 1;
+        grad[2] = uniform(rng) < 0.05 ? 1 : 0;
+        for (size_t j = 3; j < driver->update_dim(); ++j) {
+          grad[j] = static_cast<float>(uniform(rng) - 0.5) * 0.01f;
+        }
+      }
+      driver->Push(keys, grads);
+    } else {
+      driver->Pull(&keys, &values);
+    }
+    const double us =
+        std::chrono::duration<double, std::micro>(Clock::now() - scheduled)
+            .count();
+    (push ? stats->push_us : stats->pull_us).push_back(us);
+    scheduled += interval;
+  }
+}
+
+double CpuSeconds() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+}
+
+int64_t RssBytes() {
+  std::ifstream statm("/proc/self/statm");
+  int64_t pages = 0, rss_pages = 0;
+  statm >> pages >> rss_pages;
+  return rss_pages * sysconf(_SC_PAGESIZE);
+}
+
+void Report(const char* name, std::vector<double>* us, double seconds) {
+  if (us->empty()) {
+    return;
+  }
+  std::sort(us->begin(), us->end());
+  auto percentile = [us](double p) {
+    return (*us)[std::min<size_t>(us->size() * p, us->size() - 1)];
+  };
+  double sum = 0;
+  for (double value : *us) {
+    sum += value;
+  }
+  std::printf(
+      "%-5s %10zu requests %10.1f qps %12.0f keys/s | latency us: mean "
+      "%9.1f p50 %9.1f p90 %9.1f p99 %9.1f p999 %9.1f max %9.1f\n",
+      name,
+      us->size(),
+      us->size() / seconds,
+      us->size() * FLAGS_keys_per_request / seconds,
+      sum / us->size(),
+      percentile(0.5),
+      percentile(0.9),
+      percentile(0.99),
+      percentile(0.999),
+      us->back());
+}
+
+int Run() {
+  PADDLE_ENFORCE_GT(FLAGS_threads,
+                    0,
+                    phi::errors::InvalidArgument(
+                        "The threads should be positive, but got %d.",
+                        FLAGS_threads));
+  PADDLE_ENFORCE_GT(FLAGS_num_keys,
+                    0,
+                    phi::errors::InvalidArgument(
+                        "The num_keys should be positive, but got %d.",
+                        FLAGS_num_keys));
+  const ZipfKeys zipf(FLAGS_num_keys, FLAGS_zipf_s);
+  const int64_t rss_before = RssBytes();
+  std::unique_ptr<SparseDriver> driver;
+  if (FLAGS_mode == "local") {
+    driver = std::make_unique<LocalDriver>();
+  } else if (FLAGS_mode == "brpc") {
+    driver = std::make_unique<BrpcDriver>();
+  } else {
+    PADDLE_THROW(phi::errors::InvalidArgument(
+        "The mode should be local or brpc, but got %s.", FLAGS_mode));
+  }
+
+  std::vector<ThreadStats> stats(FLAGS_threads);
+  std::vector<std::thread> threads;
+  const double cpu_before = CpuSeconds();
+  const auto start = Clock::now();
+  for (int i = 0; i < FLAGS_threads; ++i) {
+    threads.emplace_back(
+        RunThread, driver.get(), std::cref(zipf), i, start, &stats[i]);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const double seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  const double cpu_seconds = CpuSeconds() - cpu_before;
+
+  ThreadStats total;
+  for (auto& thread_stats : stats) {
+    total.pull_us.insert(total.pull_us.end(),
+                         thread_stats.pull_us.begin(),
+                         thread_stats.pull_us.end());
+    total.push_us.insert(total.push_us.end(),
+                         thread_stats.push_us.begin(),
+                         thread_stats.push_us.end());
+  }
+  const size_t num_requests = total.pull_us.size() + total.push_us.size();
+  const int64_t num_features = driver->NumFeatures();
+  const int64_t rss_bytes = RssBytes() - rss_before;
+
+  std::printf(
+      "%s %s: %ld keys of zipf %.2f, %d keys per request, embedx dim %d, %d "
+      "threads, %.1f s\n",
+      FLAGS_mode.c_str(),
+      FLAGS_table_class.c_str(),
+      static_cast<long>(FLAGS_num_keys),  // NOLINT
+      FLAGS_zipf_s,
+      FLAGS_keys_per_request,
+      FLAGS_embedx_dim,
+      FLAGS_threads,
+      seconds);
+  Report("pull", &total.pull_us, seconds);
+  Report("push", &total.push_us, seconds);
+  // The CPU time and the memory are of the process, with the server and the
+  // client both of the brpc mode.
+  std::printf("cpu   %.1f us per request, %.3f us per key\n",
+              num_requests > 0 ? cpu_seconds * 1e6 / num_requests : 0.0,
+              num_requests > 0 ? cpu_seconds * 1e6 / num_requests /
+                                     FLAGS_keys_per_request
+                               : 0.0);
+  std::printf("mem   %ld features, %.1f bytes per feature\n",
+              static_cast<long>(num_features),  // NOLINT
+              num_features > 0 ? static_cast<double>(rss_bytes) / num_features
+                               : 0.0);
+  return 0;
+}
+
+}  // namespace benchmark
+}  // namespace distributed
+}  // namespace paddle
+
+int main(int argc, char* argv[]) {
+  paddle::flags::ParseCommandLineFlags(&argc, &argv);
+  google::InitGoogleLogging(argv[0]);
+  return paddle::distributed::benchmark::Run();
+}
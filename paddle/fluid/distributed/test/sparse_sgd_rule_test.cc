@@ -16,6 +16,7 @@ limitations under the License. */
 
 #include <cmath>
 #include <iostream>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "paddle/fluid/distributed/the_one_ps.pb.h"
@@ -205,5 +206,91 @@ TEST(downpour_sparse_adam_test, test_init_and_update) {
     ASSERT_FLOAT_EQ(value[i], label[i]) << "i is " << i;
   }
 }
+
+namespace {
+// Update the features one by one and in a batch, and check that the results
+// are the same. The features 0 and 2 are the same feature, so that it is
+// updated twice in the batch.
+void CheckBatchUpdate(SparseValueSGDRule* rule,
+                      size_t embed_dim,
+                      float max_error) {
+  const size_t value_dim = embed_dim + rule->Dim();
+  const size_t kNum = 3;
+  std::vector<float> values(kNum * value_dim);
+  for (size_t k = 0; k < kNum; ++k) {
+    rule->InitValue(&values[k * value_dim],
+                    &values[k * value_dim + embed_dim],
+                    false);
+  }
+  std::vector<float> batch_values = values;
+  std::vector<float> grads(kNum * embed_dim);
+  for (size_t i = 0; i < grads.size(); ++i) {
+    grads[i] = (i % 2 == 0 ? 1.0 : -1.0) * (i + 1) * 0.37;
+  }
+  size_t features[kNum] = {0, 1, 0};
+  float scales[kNum] = {1.0, 2.0, 3.0};
+
+  float* w[kNum];
+  float* sgd[kNum];
+  const float* push_values[kNum];
+  for (size_t k = 0; k < kNum; ++k) {
+    float* value = &values[features[k] * value_dim];
+    rule->UpdateValue(
+        value, value + embed_dim, &grads[k * embed_dim], scales[k]);
+    w[k] = &batch_values[features[k] * value_dim];
+    sgd[k] = w[k] + embed_dim;
+    push_values[k] = &grads[k * embed_dim];
+  }
+  rule->UpdateValueBatch(w, sgd, push_values, scales, kNum);
+
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_NEAR(batch_values[i], values[i], max_error) << "i is " << i;
+  }
+}
+}  // namespace
+
+TEST(sparse_sgd_rule_test, batch_update) {
+  const size_t embed_dim = 10;
+  SparseCommonSGDRuleParameter param;
+  auto* adagrad_param = param.mutable_adagrad();
+  adagrad_param->set_learning_rate(0.1);
+  adagrad_param->set_initial_g2sum(3.0);
+  adagrad_param->set_initial_range(0.5);
+  adagrad_param->add_weight_bounds(-1.0);
+  adagrad_param->add_weight_bounds(1.0);
+  auto* adam_param = param.mutable_adam();
+  adam_param->set_learning_rate(0.1);
+  adam_param->set_initial_range(0.5);
+  adam_param->set_beta1_decay_rate(0.9);
+  adam_param->set_beta2_decay_rate(0.999);
+  adam_param->set_ada_epsilon(1e-08);
+  adam_param->add_weight_bounds(-1.0);
+  adam_param->add_weight_bounds(1.0);
+  auto* naive_param = param.mutable_naive();
+  naive_param->set_learning_rate(0.1);
+  naive_param->set_initial_range(0.5);
+  naive_param->add_weight_bounds(-1.0);
+  naive_param->add_weight_bounds(1.0);
+
+  SparseNaiveSGDRule naive_rule;
+  naive_rule.LoadConfig(param, embed_dim);
+  CheckBatchUpdate(&naive_rule, embed_dim, 0);
+  SparseAdaGradSGDRule adagrad_rule;
+  adagrad_rule.LoadConfig(param, embed_dim);
+  CheckBatchUpdate(&adagrad_rule, embed_dim, 0);
+  SparseAdaGradV2SGDRule adagrad_v2_rule;
+  adagrad_v2_rule.LoadConfig(param, embed_dim);
+  CheckBatchUpdate(&adagrad_v2_rule, embed_dim, 0);
+  StdAdaGradSGDRule std_adagrad_rule;
+  std_adagrad_rule.LoadConfig(param, embed_dim);
+  CheckBatchUpdate(&std_adagrad_rule, embed_dim, 0);
+  // the jit adam kernel may use the fused multiply-add
+  SparseAdamSGDRule adam_rule;
+  adam_rule.LoadConfig(param, embed_dim);
+  CheckBatchUpdate(&adam_rule, embed_dim, 1e-6);
+  SparseSharedAdamSGDRule shared_adam_rule;
+  shared_adam_rule.LoadConfig(param, embed_dim);
+  CheckBatchUpdate(&shared_adam_rule, embed_dim, 0);
+}
 }  // namespace distributed
 }  // namespace paddle
@@ -0,0 +1,115 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/table/sparse_table_loader.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace distributed {
+
+namespace {
+std::shared_ptr<FILE> TempFile(const std::string& content) {
+  std::shared_ptr<FILE> fp(tmpfile(), fclose);
+  fwrite(content.data(), 1, content.size(), fp.get());
+  rewind(fp.get());
+  return fp;
+}
+}  // namespace
+
+TEST(SparseTableLoader, LineChunks) {
+  std::string content;
+  for (int i = 0; i < 100; ++i) {
+    content += std::to_string(i) + " 0.5 " + std::string(i % 7, '1') + "\n";
+  }
+  content += "100 1.5";  // the last line without '\n'
+
+  FsReadChannel channel;
+  channel.open(TempFile(content), FsChannelConfig());
+  // smaller than some lines
+  SparseLineChunkReader reader(&channel, 8);
+  std::string chunk;
+  std::string joined;
+  while (reader.Next(&chunk)) {
+    ASSERT_FALSE(chunk.empty());
+    if (joined.size() + chunk.size() < content.size()) {
+      ASSERT_EQ(chunk.back(), '\n');
+    }
+    joined += chunk;
+  }
+  ASSERT_EQ(joined, content);
+}
+
+TEST(SparseTableLoader, ParseKey) {
+  std::string line = "18446744073709551615 1 2";
+  char* end = nullptr;
+  ASSERT_EQ(ParseSparseKey(line.c_str(), &end), UINT64_MAX);
+  ASSERT_EQ(std::string(end), " 1 2");
+  ASSERT_TRUE(IsSparseBinaryFile("/a/000/part-000-00001.bin.gz"));
+  ASSERT_FALSE(IsSparseBinaryFile("/a.bin/000/part-000-00001.gz"));
+}
+
+TEST(SparseTableLoader, BinaryRoundTrip) {
+  std::shared_ptr<FILE> fp(tmpfile(), fclose);
+  FsWriteChannel write_channel;
+  write_channel.open(fp, FsChannelConfig());
+  SparseBinaryWriter writer(&write_channel, 3);
+  std::vector<float> value = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+  for (uint64_t key = 0; key < 10; ++key) {
+    ASSERT_EQ(writer.Append(key * 1000, value.data(), key % 5 + 1), 0);
+  }
+  ASSERT_EQ(writer.Flush(), 0);
+  fflush(fp.get());
+  rewind(fp.get());
+
+  FsReadChannel read_channel;
+  read_channel.open(fp, FsChannelConfig());
+  std::string chunk;
+  SparseFeatureBlock block;
+  std::vector<uint64_t> keys;
+  bool first = true;
+  int ret = 0;
+  while ((ret = ReadSparseBinaryChunk(&read_channel, first, &chunk)) > 0) {
+    first = false;
+    ASSERT_TRUE(DecodeSparseBinaryChunk(chunk, &block));
+    const float* data = block.values.data();
+    for (size_t i = 0; i < block.keys.size(); ++i) {
+      keys.push_back(block.keys[i]);
+      ASSERT_EQ(block.sizes[i], block.keys[i] / 1000 % 5 + 1);
+      for (size_t j = 0; j < block.sizes[i]; ++j) {
+        ASSERT_EQ(data[j], value[j]);
+      }
+      data += block.sizes[i];
+    }
+  }
+  ASSERT_EQ(ret, 0);
+  ASSERT_EQ(keys.size(), 10UL);
+
+  // truncated block
+  chunk.pop_back();
+  ASSERT_FALSE(DecodeSparseBinaryChunk(chunk, &block));
+
+  // not a binary file
+  FsReadChannel text_channel;
+  text_channel.open(TempFile("1 0.5\n"), FsChannelConfig());
+  ASSERT_EQ(ReadSparseBinaryChunk(&text_channel, true, &chunk), -1);
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,107 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/service/sparse_wire_format.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace distributed {
+
+TEST(SparseWireFormat, SortedKeys) {
+  std::vector<uint64_t> keys = {0, 1, 127, 128, 1 << 20, UINT64_MAX - 1};
+  std::string encoded;
+  EncodeSortedKeys(keys.data(), keys.size(), &encoded);
+  ASSERT_LT(encoded.size(), keys.size() * sizeof(uint64_t));
+
+  std::vector<uint64_t> decoded(keys.size());
+  ASSERT_EQ(DecodeSortedKeys(
+                encoded.data(), encoded.size(), keys.size(), decoded.data()),
+            encoded.size());
+  ASSERT_EQ(decoded, keys);
+
+  // truncated
+  ASSERT_EQ(DecodeSortedKeys(encoded.data(),
+                             encoded.size() - 1,
+                             keys.size(),
+                             decoded.data()),
+            0u);
+}
+
+TEST(SparseWireFormat, Varint32) {
+  std::vector<uint32_t> values = {1, 2, 300, UINT32_MAX};
+  std::string encoded;
+  EncodeVarint32(values.data(), values.size(), &encoded);
+  std::vector<uint32_t> decoded(values.size());
+  ASSERT_EQ(DecodeVarint32(
+                encoded.data(), encoded.size(), values.size(), decoded.data()),
+            encoded.size());
+  ASSERT_EQ(decoded, values);
+}
+
+void CheckQuantizer(uint32_t flags, float tolerance) {
+  const size_t dim = 11, skip_dim = 3;
+  ASSERT_TRUE(SparseValueQuantizer::IsValid(flags, dim, skip_dim));
+  SparseValueQuantizer quantizer(flags, dim, skip_dim);
+  ASSERT_TRUE(quantizer.quantized());
+  ASSERT_LT(quantizer.EncodedSize(), dim * sizeof(float));
+
+  std::vector<float> value(dim);
+  for (size_t i = 0; i < dim; ++i) {
+    value[i] = 0.013f * i - 0.05f;
+  }
+  value[0] = 7.0f;  // slot
+  std::vector<float> residual(quantizer.quant_dim(), 0.0f);
+  std::vector<char> encoded(quantizer.EncodedSize());
+  std::vector<float> decoded(dim);
+  // error feedback, the sum of the decoded gradients tracks the sum of the
+  // pushed gradients
+  std::vector<float> sum(dim, 0.0f);
+  const int rounds = 100;
+  for (int r = 0; r < rounds; ++r) {
+    quantizer.Encode(value.data(), residual.data(), encoded.data());
+    quantizer.Decode(encoded.data(), decoded.data());
+    for (size_t i = 0; i < skip_dim; ++i) {
+      ASSERT_EQ(decoded[i], value[i]);
+    }
+    for (size_t i = skip_dim; i < dim; ++i) {
+      ASSERT_NEAR(decoded[i], value[i], tolerance);
+      sum[i] += decoded[i];
+    }
+  }
+  for (size_t i = skip_dim; i < dim; ++i) {
+    ASSERT_NEAR(sum[i], value[i] * rounds, tolerance);
+  }
+}
+
+TEST(SparseWireFormat, Fp16Value) {
+  CheckQuantizer(kSparseWireFp16Value, 1e-3);
+}
+
+TEST(SparseWireFormat, Int8Value) {
+  CheckQuantizer(kSparseWireInt8Value, 1e-3);
+}
+
+TEST(SparseWireFormat, InvalidFlags) {
+  ASSERT_FALSE(SparseValueQuantizer::IsValid(
+      kSparseWireFp16Value | kSparseWireInt8Value, 8, 3));
+  ASSERT_FALSE(SparseValueQuantizer::IsValid(kSparseWireFp16Value, 2, 3));
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -148,6 +148,46 @@ static void CopyOrAddTensor(paddle::Tensor* tensor,
   }
 }
 
+// Adds the grad into the main grad in place. The float16 and bfloat16 grads
+// are added into a float32 main grad on the GPU by the add kernel of mixed
+// precisions, without a cast of the grad.
+static void AddToMainGrad(paddle::Tensor* main_grad, const paddle::Tensor& t) {
+  VLOG(3) << "Add Tensor ptr: " << t.impl()
+          << " to main grad ptr: " << main_grad->impl();
+  if (t.dtype() == main_grad->dtype()) {
+    paddle::imperative::TensorAdd<paddle::Tensor>(t, main_grad);
+    return;
+  }
+#ifdef PADDLE_WITH_CUDA
+  if (main_grad->is_gpu() && main_grad->dtype() == phi::DataType::FLOAT32 &&
+      (t.dtype() == phi::DataType::FLOAT16 ||
+       t.dtype() == phi::DataType::BFLOAT16)) {
+    auto* dev_ctx = phi::DeviceContextPool::Instance().Get(main_grad->place());
+    auto kernel_result =
+        phi::KernelFactory::Instance().SelectKernelOrThrowError(
+            "add",
+            phi::KernelKey(phi::TransToPhiBackend(main_grad->place()),
+                           phi::DataLayout::ALL_LAYOUT,
+                           main_grad->dtype()));
+    using kernel_signature = void (*)(const phi::DeviceContext&,
+                                      const phi::DenseTensor&,
+                                      const phi::DenseTensor&,
+                                      phi::DenseTensor*);
+    auto* kernel_fn =
+        kernel_result.kernel.GetVariadicKernelFn<kernel_signature>();
+    auto* main_grad_dense =
+        static_cast<phi::DenseTensor*>(main_grad->impl().get());
+    (*kernel_fn)(*dev_ctx,
+                 *main_grad_dense,
+                 *static_cast<phi::DenseTensor*>(t.impl().get()),
+                 main_grad_dense);
+    return;
+  }
+#endif
+  paddle::imperative::TensorAdd<paddle::Tensor>(
+      paddle::experimental::cast(t, main_grad->dtype()), main_grad);
+}
+
 paddle::small_vector<std::vector<paddle::Tensor>, kSlotSmallVectorSize>
 GradNodeAccumulation::operator()(
     paddle::small_vector<std::vector<paddle::Tensor>,
@@ -176,7 +216,14 @@ GradNodeAccumulation::operator()(
     grad_out = grads[0][0];
   }
 
-  if (!weak_grad_.expired() && !is_new_grad) {
+  auto main_grad = main_grad_.lock();
+  if (main_grad && phi::DenseTensor::classof(main_grad.get()) &&
+      main_grad->initialized() && !create_graph && !is_new_grad) {
+    if (grad_out.is_dense_tensor() && grad_out.initialized()) {
+      paddle::Tensor main_grad_tensor(main_grad);
+      AddToMainGrad(&main_grad_tensor, grad_out);
+    }
+  } else if (!weak_grad_.expired() && !is_new_grad) {
     auto grad = weak_grad_.lock();
     if (grad_out.defined() &&
         (grad_out.is_dist_tensor() || grad_out.initialized())) {
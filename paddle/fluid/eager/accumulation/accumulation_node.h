@@ -67,10 +67,22 @@ class TEST_API GradNodeAccumulation : public GradNodeBase {
 
   void SetFakeEmpty(bool is_fake_empty) { is_fake_empty_ = is_fake_empty; }
 
+  /**
+   * Set the main grad, a persistent buffer the grads are added into instead
+   * of the grad of the leaf tensor, such as the float32 grad of a float16 or
+   * bfloat16 parameter in the fused buffer of the communication. The main
+   * grad is not owned, and the grads go to the grad of the leaf tensor again
+   * once it is released. An undefined tensor unsets it.
+   * **/
+  void SetMainGrad(const paddle::Tensor& main_grad) {
+    main_grad_ = main_grad.impl();
+  }
+
  private:
   // TODO(Jiabin): remove this when we make our clear gradient really cleared;
   bool is_fake_empty_ = {false};
   std::weak_ptr<paddle::Tensor> weak_grad_;
+  std::weak_ptr<phi::TensorBase> main_grad_;
   std::vector<std::shared_ptr<VoidHook>> reduce_hooks_;
   std::function<paddle::Tensor(const paddle::Tensor&)> retain_grad_hook_;
 };
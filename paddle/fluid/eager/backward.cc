@@ -14,10 +14,19 @@
 
 #include "paddle/fluid/eager/backward.h"
 
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+
 #include "paddle/fluid/eager/general_grad.h"
 #include "paddle/fluid/memory/stats.h"
+#include "paddle/phi/core/flags.h"
+#include "paddle/phi/core/threadpool.h"
 #include "paddle/phi/kernels/autotune/switch_autotune.h"
 
+PHI_DECLARE_int32(eager_backward_num_threads);
+
 namespace egr {
 
 std::unordered_map<GradNodeBase*, int> getInDegreeMap(
@@ -102,6 +111,228 @@ void DuplicateCheck(const std::vector<paddle::Tensor>& inputs, bool is_input) {
 
 GeneralGrad* GeneralGrad::general_grad_ = new GeneralGrad();
 
+// Sum the grad outputs of node into the GradTensorHolders of its next nodes,
+// ready_func is called with the next nodes whose in_degree becomes 0.
+static void PropagateGradOutputs(
+    GradNodeBase* node,
+    paddle::small_vector<std::vector<paddle::Tensor>, kSlotSmallVectorSize>*
+        grad_output_tensors,
+    bool create_graph,
+    std::unordered_map<GradNodeBase*, std::unique_ptr<GradTensorHolder>>*
+        node_input_buffers_dict,
+    std::unordered_map<GradNodeBase*, int>* node_in_degree_map,
+    const std::function<void(GradNodeBase*)>& ready_func) {
+  auto& grad_outputs = *grad_output_tensors;
+  const paddle::small_vector<std::vector<GradSlotMeta>, kSlotSmallVectorSize>&
+      metas = node->OutputMeta();
+  PADDLE_ENFORCE(metas.size() == grad_outputs.size() || metas.empty(),
+                 paddle::platform::errors::Fatal(
+                     "Number of edges should be either empty ( for leaf node "
+                     ") or the same as number of output grad tensors, but we "
+                     "got edges size is: %d, grad_output size is: %d",
+                     metas.size(),
+                     grad_outputs.size()));
+
+  for (size_t i = 0; i < metas.size(); i++) {
+    for (size_t j = 0; j < metas[i].size(); j++) {
+      const Edge& edge = metas[i][j].GetEdge();
+      if (!edge.IsInitialized()) {
+        continue;
+      }
+      auto edge_rank = edge.GetEdgeRankInfo();
+      // Since we make edge has as same rank as bwd outputs, we indexing them
+      // with the same rank(i, j)
+      auto next_node_shared = edge.GetMutableGradNode();
+      VLOG(3) << "Node: " << node->name() << " addr:" << node
+              << ", Found pending node: " << next_node_shared->name()
+              << " addr: " << next_node_shared.get();
+      // Next node could be nullptr if it is leaf tensor with no
+      // AccumulationNode attached
+      // Or it could also originated from dispensable inputs
+      if (!next_node_shared || !next_node_shared.get() ||
+          grad_outputs[i].empty()) {
+        continue;
+      }
+
+      PADDLE_ENFORCE_LT(
+          j,
+          grad_outputs[i].size(),
+          paddle::platform::errors::Fatal(
+              "Rank of grad_output_tensors should be less than "
+              "grad_output_tensors[i].size(), which is: %d. This error may "
+              "indicate autoprune or autograd api error. ",
+              grad_outputs.size()));
+      paddle::Tensor& grad_output_tensor = grad_outputs[i][j];
+
+      if ((!grad_output_tensor.defined() ||
+           !grad_output_tensor.initialized())) {
+        VLOG(7) << "We get grad_output_tensor with slot: " << i
+                << ", rank: " << j << " as uninitialized or undefined tensor";
+      }
+
+      VLOG(7) << "Get Edge and grad_output_tensor with slot: " << i
+              << ", rank: " << j
+              << " 's name is: " << grad_output_tensor.name();
+
+      auto* next_node = next_node_shared.get();
+      if (!node_input_buffers_dict->count(next_node)) {
+        const auto& input_meta = next_node->InputMeta();
+        auto grad_tensor_holder =
+            std::make_unique<GradTensorHolder>(input_meta);
+        VLOG(7) << "Construct GradTensorHolder for grad node: "
+                << next_node->name();
+        (*node_input_buffers_dict)[next_node] = std::move(grad_tensor_holder);
+      }
+
+      VLOG(3) << "Sum or Move grad inputs for edge slot: " << edge_rank.first
+              << ", rank: " << edge_rank.second;
+
+      (*node_input_buffers_dict)[next_node]->add(edge_rank.first,
+                                                 edge_rank.second,
+                                                 grad_output_tensor,
+                                                 create_graph);
+
+      // Update queue
+      (*node_in_degree_map)[next_node]--;
+      VLOG(7) << next_node->name()
+              << " ref_cnt is: " << (*node_in_degree_map)[next_node];
+
+      PADDLE_ENFORCE(
+          (*node_in_degree_map)[next_node] >= 0,
+          paddle::platform::errors::Fatal(
+              "Detected in-degree value smaller than zero. For Node: %s"
+              "Node's in-degree cannot be negative.",
+              next_node->name()));
+
+      if ((*node_in_degree_map)[next_node] == 0) {
+        ready_func(next_node);
+      }
+    }
+  }
+}
+
+// Whether the thread runs the grad nodes of a parallel backward, the backward
+// called by these nodes runs sequentially, or it waits for the busy pool.
+static thread_local bool in_parallel_backward = false;
+
+// Run the backward graph with the ready nodes on a thread pool. The grad
+// nodes of the leaf tensors run on the calling thread, so the accumulation
+// and the reducer hooks of the parameters stay sequential. The dicts and the
+// GradTensorHolders are only touched under the lock, a node runs without it.
+static void RunBackwardInParallel(
+    const std::deque<GradNodeBase*>& startup_nodes,
+    std::unordered_map<GradNodeBase*, std::unique_ptr<GradTensorHolder>>*
+        node_input_buffers_dict,
+    std::unordered_map<GradNodeBase*, int>* node_in_degree_map,
+    bool retain_graph,
+    const paddle::platform::Place& place) {
+  // sized the first time a parallel backward runs
+  static phi::ThreadPool pool(FLAGS_eager_backward_num_threads);
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<GradNodeBase*> accumulation_queue;
+  int running = 0;
+  std::exception_ptr error;
+  // the tracer and the grad mode are thread local
+  const auto tracer = egr::Controller::Instance().GetCurrentTracer();
+  const bool has_grad = egr::Controller::Instance().HasGrad();
+
+  std::function<void(GradNodeBase*)> schedule;
+  auto run_node = [&](GradNodeBase* node) {
+    std::unique_ptr<GradTensorHolder> node_input_buffer;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto node_input_buffer_iter = node_input_buffers_dict->find(node);
+      PADDLE_ENFORCE_NE(
+          node_input_buffer_iter,
+          node_input_buffers_dict->end(),
+          paddle::platform::errors::Fatal(
+              "Unable to find next node in the GradTensorHolder \n"
+              "Trying to run Node without configuring its GradTensorHolder."));
+      node_input_buffer = std::move(node_input_buffer_iter->second);
+      node_input_buffers_dict->erase(node_input_buffer_iter);
+    }
+    VLOG(3) << "Preparing GradNode:" << node->name() << " addr:" << node;
+    paddle::platform::RecordEvent node_record_event(
+        std::string((*node).name()),
+        paddle::platform::TracerEventType::Operator,
+        1);
+    EnforceGradNodeHasInput(node);
+    paddle::small_vector<std::vector<paddle::Tensor>, kSlotSmallVectorSize>
+        grad_output_tensors = (*node)(node_input_buffer->Buffers(),
+                                      /*create_graph=*/false,
+                                      /*is_new_grad=*/false);
+    if (!retain_graph) {
+      node->ClearTensorWrappers();
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      PropagateGradOutputs(node,
+                           &grad_output_tensors,
+                           /*create_graph=*/false,
+                           node_input_buffers_dict,
+                           node_in_degree_map,
+                           schedule);
+    }
+    paddle::memory::LogDeviceMemoryStats(place, std::string((*node).name()));
+  };
+
+  // called under the lock
+  schedule = [&](GradNodeBase* node) {
+    if (error) return;
+    if (dynamic_cast<egr::GradNodeAccumulation*>(node)) {
+      accumulation_queue.push_back(node);
+      cv.notify_all();
+      return;
+    }
+    pool.Run([&, node]() {
+      egr::Controller::Instance().SetCurrentTracer(tracer);
+      paddle::imperative::SetCurrentTracer(tracer);
+      egr::Controller::Instance().SetHasGrad(has_grad);
+      in_parallel_backward = true;
+      std::exception_ptr node_error;
+      try {
+        run_node(node);
+      } catch (...) {
+        node_error = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      if (node_error && !error) error = node_error;
+      --running;
+      cv.notify_all();
+    });
+    ++running;
+  };
+
+  std::unique_lock<std::mutex> lock(mutex);
+  for (GradNodeBase* node : startup_nodes) {
+    schedule(node);
+  }
+  while (true) {
+    cv.wait(lock, [&] {
+      return error || running == 0 || !accumulation_queue.empty();
+    });
+    if (error || accumulation_queue.empty()) {
+      // the workers reference the locals of this frame
+      cv.wait(lock, [&] { return running == 0; });
+      if (error) std::rethrow_exception(error);
+      break;
+    }
+    GradNodeBase* node = accumulation_queue.front();
+    accumulation_queue.pop_front();
+    lock.unlock();
+    std::exception_ptr node_error;
+    try {
+      run_node(node);
+    } catch (...) {
+      node_error = std::current_exception();
+    }
+    lock.lock();
+    if (node_error && !error) error = node_error;
+  }
+}
+
 std::vector<paddle::Tensor> RunBackward(
     const std::vector<paddle::Tensor>& tensors,  // output
     const std::vector<paddle::Tensor>& grad_tensors,
@@ -243,6 +474,23 @@ std::vector<paddle::Tensor> RunBackward(
 
   VLOG(5) << "Startup_ops's size is " << queue.size();
 
+  bool run_in_parallel = FLAGS_eager_backward_num_threads > 1 &&
+                         !create_graph && !is_general_grad &&
+                         force_sequential_nodes_set.empty() &&
+                         paddle::platform::is_cpu_place(place) &&
+                         !in_parallel_backward;
+  for (GradNodeBase* node : queue) {
+    run_in_parallel = run_in_parallel && node_in_degree_map[node] == 0;
+  }
+  if (run_in_parallel) {
+    RunBackwardInParallel(queue,
+                          &node_input_buffers_dict,
+                          &node_in_degree_map,
+                          retain_graph,
+                          place);
+    queue.clear();
+  }
+
   /* --- Topological Visit --- */
   // 1. Pop queue
   // 2. Run node
@@ -300,118 +548,36 @@ std::vector<paddle::Tensor> RunBackward(
     // TODO(jiabin): Should we erase it or find a more efficient way.
     node_input_buffers_dict.erase(node_input_buffer_iter);
 
-    // Prepare GradTensorHolder for next node
-    const paddle::small_vector<std::vector<GradSlotMeta>, kSlotSmallVectorSize>&
-        metas = node->OutputMeta();
-    PADDLE_ENFORCE(metas.size() == grad_output_tensors.size() || metas.empty(),
-                   paddle::platform::errors::Fatal(
-                       "Number of edges should be either empty ( for leaf node "
-                       ") or the same as number of output grad tensors, but we "
-                       "got edges size is: %d, grad_output size is: %d",
-                       metas.size(),
-                       grad_output_tensors.size()));
-
-    for (size_t i = 0; i < metas.size(); i++) {
-      for (size_t j = 0; j < metas[i].size(); j++) {
-        const Edge& edge = metas[i][j].GetEdge();
-        if (!edge.IsInitialized()) {
-          continue;
-        }
-        auto edge_rank = edge.GetEdgeRankInfo();
-        // Since we make edge has as same rank as bwd outputs, we indexing them
-        // with the same rank(i, j)
-        auto next_node_shared = edge.GetMutableGradNode();
-        VLOG(3) << "Node: " << node->name() << " addr:" << node
-                << ", Found pending node: " << next_node_shared->name()
-                << " addr: " << next_node_shared.get();
-        // Next node could be nullptr if it is leaf tensor with no
-        // AccumulationNode attached
-        // Or it could also originated from dispensable inputs
-        if (!next_node_shared || !next_node_shared.get() ||
-            grad_output_tensors[i].empty()) {
-          continue;
-        }
-
-        PADDLE_ENFORCE_LT(
-            j,
-            grad_output_tensors[i].size(),
-            paddle::platform::errors::Fatal(
-                "Rank of grad_output_tensors should be less than "
-                "grad_output_tensors[i].size(), which is: %d. This error may "
-                "indicate autoprune or autograd api error. ",
-                grad_output_tensors.size()));
-        paddle::Tensor& grad_output_tensor = grad_output_tensors[i][j];
-
-        if ((!grad_output_tensor.defined() ||
-             !grad_output_tensor.initialized())) {
-          VLOG(7) << "We get grad_output_tensor with slot: " << i
-                  << ", rank: " << j << " as uninitialized or undefined tensor";
-        }
-
-        VLOG(7) << "Get Edge and grad_output_tensor with slot: " << i
-                << ", rank: " << j
-                << " 's name is: " << grad_output_tensor.name();
-
-        auto* next_node = next_node_shared.get();
-        if (!node_input_buffers_dict.count(next_node)) {
-          const auto& input_meta = next_node->InputMeta();
-          auto grad_tensor_holder =
-              std::make_unique<GradTensorHolder>(input_meta);
-          VLOG(7) << "Construct GradTensorHolder for grad node: "
-                  << next_node->name();
-          node_input_buffers_dict[next_node] = std::move(grad_tensor_holder);
-        }
-
-        VLOG(3) << "Sum or Move grad inputs for edge slot: " << edge_rank.first
-                << ", rank: " << edge_rank.second;
-
-        node_input_buffers_dict[next_node]->add(edge_rank.first,
-                                                edge_rank.second,
-                                                grad_output_tensor,
-                                                create_graph);
-
-        // Update queue
-        node_in_degree_map[next_node]--;
-        VLOG(7) << next_node->name()
-                << " ref_cnt is: " << node_in_degree_map[next_node];
-
-        PADDLE_ENFORCE(
-            node_in_degree_map[next_node] >= 0,
-            paddle::platform::errors::Fatal(
-                "Detected in-degree value smaller than zero. For Node: %s"
-                "Node's in-degree cannot be negative.",
-                next_node->name()));
-
-        auto add_next_node_func = [&node_in_degree_map,
-                                   &queue](GradNodeBase* next_node) {
-          if (dynamic_cast<egr::GradNodeAccumulation*>(next_node)) {
-            queue.push_front(next_node);
-          } else {
-            queue.push_back(next_node);
-          }
-        };
-        if (node_in_degree_map[next_node] == 0) {
-          if (force_sequential_nodes_set.count(next_node)) {
-            if (force_sequential_nodes_queue.front() == next_node) {
+    auto add_next_node_func = [&queue](GradNodeBase* next_node) {
+      if (dynamic_cast<egr::GradNodeAccumulation*>(next_node)) {
+        queue.push_front(next_node);
+      } else {
+        queue.push_back(next_node);
+      }
+    };
+    PropagateGradOutputs(
+        node,
+        &grad_output_tensors,
+        create_graph,
+        &node_input_buffers_dict,
+        &node_in_degree_map,
+        [&](GradNodeBase* next_node) {
+          if (!force_sequential_nodes_set.count(next_node)) {
+            add_next_node_func(next_node);
+          } else if (force_sequential_nodes_queue.front() == next_node) {
+            force_sequential_nodes_queue.pop_front();
+            add_next_node_func(next_node);
+            while (ready_force_sequential_nodes.count(
+                force_sequential_nodes_queue.front())) {
+              ready_force_sequential_nodes.erase(
+                  force_sequential_nodes_queue.front());
+              add_next_node_func(force_sequential_nodes_queue.front());
               force_sequential_nodes_queue.pop_front();
-              add_next_node_func(next_node);
-              while (ready_force_sequential_nodes.count(
-                  force_sequential_nodes_queue.front())) {
-                ready_force_sequential_nodes.erase(
-                    force_sequential_nodes_queue.front());
-                add_next_node_func(force_sequential_nodes_queue.front());
-                force_sequential_nodes_queue.pop_front();
-              }
-            } else {
-              ready_force_sequential_nodes.insert(next_node);
-              continue;
             }
           } else {
-            add_next_node_func(next_node);
+            ready_force_sequential_nodes.insert(next_node);
           }
-        }
-      }
-    }
+        });
     paddle::memory::LogDeviceMemoryStats(place, std::string((*node).name()));
   }
 
@@ -153,6 +153,22 @@ static void ShareTensorsIntoScope(const std::vector<Tensor> &tensors,
   }
 }
 
+static void ShareTensorIntoVar(const Tensor &tensor,
+                               paddle::framework::Variable *var) {
+  CheckInputVarStatus(tensor);
+  // share tensor
+  auto tensor_base = tensor.impl();
+  if (phi::DenseTensor::classof(tensor_base.get())) {
+    auto *dst_tensor = var->GetMutable<phi::DenseTensor>();
+    auto t = std::dynamic_pointer_cast<phi::DenseTensor>(tensor_base);
+    *dst_tensor = *t;
+  } else if (phi::SelectedRows::classof(tensor_base.get())) {
+    auto *dst_tensor = var->GetMutable<phi::SelectedRows>();
+    auto t = std::dynamic_pointer_cast<phi::SelectedRows>(tensor_base);
+    *dst_tensor = *t;
+  }
+}
+
 static void ShareTensorsIntoScopeWithName(
     const std::vector<Tensor> &tensors,
     const std::vector<std::string> &tensor_names,
@@ -162,19 +178,7 @@ static void ShareTensorsIntoScopeWithName(
     if (name == paddle::framework::kFakeVarName) {
       continue;
     }
-    auto *var = scope->Var(name);
-    CheckInputVarStatus(tensors[i]);
-    // share tensor
-    auto tensor_base = tensors[i].impl();
-    if (phi::DenseTensor::classof(tensor_base.get())) {
-      auto *dst_tensor = var->GetMutable<phi::DenseTensor>();
-      auto t = std::dynamic_pointer_cast<phi::DenseTensor>(tensor_base);
-      *dst_tensor = *t;
-    } else if (phi::SelectedRows::classof(tensor_base.get())) {
-      auto *dst_tensor = var->GetMutable<phi::SelectedRows>();
-      auto t = std::dynamic_pointer_cast<phi::SelectedRows>(tensor_base);
-      *dst_tensor = *t;
-    }
+    ShareTensorIntoVar(tensors[i], scope->Var(name));
   }
 }
 
@@ -281,21 +285,54 @@ static void ShareTensorsIntoScopeByValue(
   ShareTensorsIntoScopeWithName(tensors, names, scope);
 }
 
-static void ShareTensorsFromScopeByValue(
+// Binds the values of a role of the program to the variables of the scope once
+// for the cached interpreter, instead of walking the block for their names on
+// every run. The inputs are created in the scope, while the outputs are found
+// after the run of the interpreter creates them.
+static const paddle::framework::InterpreterCoreInfo::ValueBinding &BindValues(
+    paddle::framework::InterpreterCoreInfo::CacheValue *cached_value,
+    const std::string &role,
     const ::pir::Block *block,
-    const std::vector<Tensor *> &tensors,
     const std::vector<::pir::Value> &values,
+    bool is_input,
     paddle::framework::Scope *scope) {
-  auto names = GetNameFromValue(block, values, false);
+  auto &binding = cached_value->value_bindings_[role];
+  if (binding.names.size() != values.size()) {
+    binding.names = GetNameFromValue(block, values, is_input);
+    binding.vars.assign(values.size(), nullptr);
+  }
+  for (size_t i = 0; i < values.size(); ++i) {
+    const auto &name = binding.names[i];
+    if (binding.vars[i] == nullptr && name != paddle::framework::kFakeVarName) {
+      binding.vars[i] = is_input ? scope->Var(name) : scope->FindVar(name);
+    }
+  }
+  return binding;
+}
+
+static void ShareTensorsIntoBinding(
+    const std::vector<Tensor> &tensors,
+    const paddle::framework::InterpreterCoreInfo::ValueBinding &binding) {
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    if (binding.vars[i] != nullptr) {
+      ShareTensorIntoVar(tensors[i], binding.vars[i]);
+    }
+  }
+}
+
+static void ShareTensorsFromBinding(
+    const std::vector<Tensor *> &tensors,
+    const std::vector<::pir::Value> &values,
+    const paddle::framework::InterpreterCoreInfo::ValueBinding &binding) {
   for (size_t i = 0; i < tensors.size(); ++i) {
-    auto &name = names[i];
+    auto &name = binding.names[i];
     auto &value = values[i];
     VLOG(2) << "share " << name << " from scope";
     if (value.impl() == nullptr) {
       // skip stop_gradient.
       continue;
     }
-    auto *var = scope->FindVar(name);
+    auto *var = binding.vars[i];
     PADDLE_ENFORCE_NOT_NULL(
         var,
         paddle::platform::errors::NotFound("The output tensor %s is not in "
@@ -319,6 +356,19 @@ static void ShareTensorsFromScopeByValue(
   }
 }
 
+static void ShareTensorsFromScopeByValue(
+    const ::pir::Block *block,
+    const std::vector<Tensor *> &tensors,
+    const std::vector<::pir::Value> &values,
+    paddle::framework::Scope *scope) {
+  paddle::framework::InterpreterCoreInfo::ValueBinding binding;
+  binding.names = GetNameFromValue(block, values, false);
+  for (auto &name : binding.names) {
+    binding.vars.push_back(scope->FindVar(name));
+  }
+  ShareTensorsFromBinding(tensors, values, binding);
+}
+
 static void ShareTensorsFromScopeWithPartialBlock(
     const std::vector<Tensor *> &tensors,
     const paddle::framework::BlockDesc &forward_global_block,
@@ -488,6 +538,7 @@ inline void PirRunProgramAPI(
       paddle::framework::InterpreterCoreInfoCache::Instance();
   std::shared_ptr<paddle::framework::InterpreterCore> interpreter_core =
       nullptr;
+  paddle::framework::InterpreterCoreInfo::CacheValue *cached_value = nullptr;
   if (!interpretercore_info_cache.Has(program_id,
                                       global_inner_scope,
                                       place_hash_key,
@@ -521,6 +572,12 @@ inline void PirRunProgramAPI(
         program_id,
         global_inner_scope,
         place_hash_key);
+    cached_value = &interpretercore_info_cache.GetMutable(program_id,
+                                                          global_inner_scope,
+                                                          place_hash_key,
+                                                          /*is_grad=*/false,
+                                                          /*in_pir_mode=*/true);
+    cached_value->value_bindings_.clear();
     // Step 3. get all eager gc vars
     // std::set<std::string> skip_eager_delete_vars =
     // paddle::framework::details::ParseSafeEagerDeletionSkipVarsSet(
@@ -558,18 +615,27 @@ inline void PirRunProgramAPI(
         1);
     VLOG(2) << "Get interpretercore cache by program:" << program_id;
     // Step 1. get cache interpretercore
-    auto &cached_value =
-        interpretercore_info_cache.GetMutable(program_id,
-                                              global_inner_scope,
-                                              place_hash_key,
-                                              /*is_grad=*/false,
-                                              /*in_pir_mode=*/true);
-    interpreter_core = cached_value.core_;
+    cached_value = &interpretercore_info_cache.GetMutable(program_id,
+                                                          global_inner_scope,
+                                                          place_hash_key,
+                                                          /*is_grad=*/false,
+                                                          /*in_pir_mode=*/true);
+    interpreter_core = cached_value->core_;
     // Step 2. update scope for cache interpretercore
-    details::ShareTensorsIntoScopeByValue(
-        forward_global_block, x, input_values, global_inner_scope);
-    details::ShareTensorsIntoScopeByValue(
-        forward_global_block, params, param_values, global_inner_scope);
+    details::ShareTensorsIntoBinding(x,
+                                     details::BindValues(cached_value,
+                                                         "fx",
+                                                         forward_global_block,
+                                                         input_values,
+                                                         /*is_input=*/true,
+                                                         global_inner_scope));
+    details::ShareTensorsIntoBinding(params,
+                                     details::BindValues(cached_value,
+                                                         "fp",
+                                                         forward_global_block,
+                                                         param_values,
+                                                         /*is_input=*/true,
+                                                         global_inner_scope));
     // TODO(xiongkun): new ir how to build scope.
     // if (interpreter_core->GetVariableScope()->GetMutableScope() !=
     // global_inner_scope) {
@@ -592,10 +658,22 @@ inline void PirRunProgramAPI(
     paddle::platform::RecordEvent record_event(
         "fetch_and_gc", paddle::platform::TracerEventType::UserDefined, 1);
     // Get Output, and Middle Outputs
-    details::ShareTensorsFromScopeByValue(
-        forward_global_block, out, output_values, global_inner_scope);
-    details::ShareTensorsFromScopeByValue(
-        forward_global_block, middles, middle_values, global_inner_scope);
+    details::ShareTensorsFromBinding(out,
+                                     output_values,
+                                     details::BindValues(cached_value,
+                                                         "fo",
+                                                         forward_global_block,
+                                                         output_values,
+                                                         /*is_input=*/false,
+                                                         global_inner_scope));
+    details::ShareTensorsFromBinding(middles,
+                                     middle_values,
+                                     details::BindValues(cached_value,
+                                                         "fm",
+                                                         forward_global_block,
+                                                         middle_values,
+                                                         /*is_input=*/false,
+                                                         global_inner_scope));
 
     VLOG(3) << paddle::framework::GenScopeTreeDebugInfo(out_scope_vec->front());
 
@@ -1068,24 +1146,11 @@ inline void PirRunProgramGradAPI(
 
   details::Trans2ContiguousTensorsInplace(out_grad);
 
-  // share x, param, middles, output_grads, out into scope.
-  details::ShareTensorsIntoScopeByValue(
-      backward_global_block, out_grad, output_grad_values, global_inner_scope);
-  details::ShareTensorsIntoScopeByValue(
-      backward_global_block, x, forward_input_values, global_inner_scope);
-  details::ShareTensorsIntoScopeByValue(backward_global_block,
-                                        middles,
-                                        forward_middle_values,
-                                        global_inner_scope);
-  details::ShareTensorsIntoScopeByValue(
-      backward_global_block, out, forward_output_values, global_inner_scope);
-  details::ShareTensorsIntoScopeByValue(
-      backward_global_block, params, parameter_values, global_inner_scope);
-
   auto &interpretercore_info_cache =
       paddle::framework::InterpreterCoreInfoCache::Instance();
   std::shared_ptr<paddle::framework::InterpreterCore> interpreter_core =
       nullptr;
+  paddle::framework::InterpreterCoreInfo::CacheValue *cached_value = nullptr;
   if (!interpretercore_info_cache.Has(program_id,
                                       global_inner_scope,
                                       place_hash_key,
@@ -1096,7 +1161,21 @@ inline void PirRunProgramGradAPI(
         paddle::platform::TracerEventType::UserDefined,
         1);
     VLOG(2) << "No interpretercore cache, so create a new interpretercore";
-    // Step 1. share input_vars & parameters into scope
+    // Step 1. share x, param, middles, output_grads, out into scope.
+    details::ShareTensorsIntoScopeByValue(backward_global_block,
+                                          out_grad,
+                                          output_grad_values,
+                                          global_inner_scope);
+    details::ShareTensorsIntoScopeByValue(
+        backward_global_block, x, forward_input_values, global_inner_scope);
+    details::ShareTensorsIntoScopeByValue(backward_global_block,
+                                          middles,
+                                          forward_middle_values,
+                                          global_inner_scope);
+    details::ShareTensorsIntoScopeByValue(
+        backward_global_block, out, forward_output_values, global_inner_scope);
+    details::ShareTensorsIntoScopeByValue(
+        backward_global_block, params, parameter_values, global_inner_scope);
     auto passed_kernel_program =
         paddle::framework::ApplyIrPass(backward_program, place);
     if (FLAGS_print_ir) {
@@ -1112,6 +1191,12 @@ inline void PirRunProgramGradAPI(
         program_id,
         global_inner_scope,
         place_hash_key);
+    cached_value = &interpretercore_info_cache.GetMutable(program_id,
+                                                          global_inner_scope,
+                                                          place_hash_key,
+                                                          /*is_grad=*/true,
+                                                          /*in_pir_mode=*/true);
+    cached_value->value_bindings_.clear();
     // share threadpool
     // NOTE(zhiqiu): this only works interpreter_core is executed strictly
     // after the related fwd_interpreter_core.
@@ -1156,13 +1241,30 @@ inline void PirRunProgramGradAPI(
         paddle::platform::TracerEventType::UserDefined,
         1);
     VLOG(2) << "Get interpretercore cache by program:" << program_id;
-    auto &cached_value =
-        interpretercore_info_cache.GetMutable(program_id,
-                                              global_inner_scope,
-                                              place_hash_key,
-                                              /*is_grad=*/true,
-                                              /*in_pir_mode=*/true);
-    interpreter_core = cached_value.core_;
+    cached_value = &interpretercore_info_cache.GetMutable(program_id,
+                                                          global_inner_scope,
+                                                          place_hash_key,
+                                                          /*is_grad=*/true,
+                                                          /*in_pir_mode=*/true);
+    interpreter_core = cached_value->core_;
+    // share x, param, middles, output_grads, out into scope.
+    auto share_inputs = [&](const std::vector<paddle::Tensor> &tensors,
+                            const std::string &role,
+                            const std::vector<::pir::Value> &values) {
+      details::ShareTensorsIntoBinding(
+          tensors,
+          details::BindValues(cached_value,
+                              role,
+                              backward_global_block,
+                              values,
+                              /*is_input=*/true,
+                              global_inner_scope));
+    };
+    share_inputs(out_grad, "bo_g", output_grad_values);
+    share_inputs(x, "bx", forward_input_values);
+    share_inputs(middles, "bm", forward_middle_values);
+    share_inputs(out, "bo", forward_output_values);
+    share_inputs(params, "bp", parameter_values);
 
     if (interpreter_core->GetVariableScope()->GetMutableScope() !=
         global_inner_scope) {
@@ -1187,10 +1289,22 @@ inline void PirRunProgramGradAPI(
     paddle::platform::RecordEvent record_event(
         "fetch_and_gc", paddle::platform::TracerEventType::UserDefined, 1);
     // Step 4. get outputs
-    details::ShareTensorsFromScopeByValue(
-        backward_global_block, x_grad, x_grad_values, global_inner_scope);
-    details::ShareTensorsFromScopeByValue(
-        backward_global_block, params_grad, p_grad_values, global_inner_scope);
+    details::ShareTensorsFromBinding(x_grad,
+                                     x_grad_values,
+                                     details::BindValues(cached_value,
+                                                         "bx_g",
+                                                         backward_global_block,
+                                                         x_grad_values,
+                                                         /*is_input=*/false,
+                                                         global_inner_scope));
+    details::ShareTensorsFromBinding(params_grad,
+                                     p_grad_values,
+                                     details::BindValues(cached_value,
+                                                         "bp_g",
+                                                         backward_global_block,
+                                                         p_grad_values,
+                                                         /*is_input=*/false,
+                                                         global_inner_scope));
     VLOG(4) << "after backward gc all vars";
     global_inner_scope->SetCanReused(true);
     details::GcScope(global_inner_scope);
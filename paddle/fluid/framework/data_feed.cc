@@ -24,13 +24,18 @@ limitations under the License. */
 #include <stdio_ext.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #endif
 #include "io/fs.h"
+#include "paddle/fluid/framework/slot_record_file.h"
 #include "paddle/fluid/platform/monitor.h"
 #include "paddle/fluid/platform/timer.h"
 
 USE_INT_STAT(STAT_total_feasign_num_in_mem);
 PHI_DECLARE_bool(enable_ins_parser_file);
+PHI_DECLARE_string(slotrecord_binary_cache_dir);
+PHI_DECLARE_int32(slotrecord_pack_thread_num);
+PHI_DECLARE_int32(hdfs_read_ahead_files);
 namespace paddle {
 namespace framework {
 
@@ -224,14 +229,29 @@ bool DataFeed::PickOneFile(std::string* filename) {
       file_idx_,
       platform::errors::PreconditionNotMet(
           "You should call SetFileListIndex before PickOneFile"));
-  std::unique_lock<std::mutex> lock(*mutex_for_pick_file_);
-  VLOG(4) << "filelist_ size: " << filelist_.size();
-  if (*file_idx_ == filelist_.size()) {
-    VLOG(3) << "DataFeed::PickOneFile no more file to pick";
-    return false;
+  std::vector<std::string> read_ahead_files;
+  {
+    std::unique_lock<std::mutex> lock(*mutex_for_pick_file_);
+    VLOG(4) << "filelist_ size: " << filelist_.size();
+    if (*file_idx_ == filelist_.size()) {
+      VLOG(3) << "DataFeed::PickOneFile no more file to pick";
+      return false;
+    }
+    VLOG(3) << "file_idx_=" << *file_idx_;
+    *filename = filelist_[(*file_idx_)++];
+    for (size_t i = *file_idx_;
+         i < filelist_.size() &&
+         i < *file_idx_ + std::max(FLAGS_hdfs_read_ahead_files, 0);
+         ++i) {
+      read_ahead_files.push_back(filelist_[i]);
+    }
+  }
+  // The pipes of the next files on HDFS are opened out of the lock.
+  for (auto& file : read_ahead_files) {
+    if (fs_select_internal(file) == 1) {
+      hdfs_read_ahead(file, pipe_command_, true);
+    }
   }
-  VLOG(3) << "file_idx_=" << *file_idx_;
-  *filename = filelist_[(*file_idx_)++];
   return true;
 }
 
@@ -2198,6 +2218,15 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByFile() {
   while (this->PickOneFile(&filename)) {
     VLOG(3) << "PickOneFile, filename=" << filename
             << ", thread_id=" << thread_id_;
+    if (IsSlotRecordFile(filename)) {
+      PADDLE_ENFORCE_EQ(LoadIntoMemoryBySlotRecordFile(filename),
+                        true,
+                        platform::errors::InvalidArgument(
+                            "Failed to load the slot record file %s, it must "
+                            "be a local file of the used slots.",
+                            filename));
+      continue;
+    }
     platform::Timer timeline;
     timeline.Start();
 
@@ -2336,6 +2365,18 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByLine() {
 #endif
 }
 
+static bool AppendSlotRecord(SlotRecordFileWriter* writer,
+                             const SlotRecord& rec) {
+  return writer->Append(rec->search_id,
+                        rec->rank,
+                        rec->cmatch,
+                        rec->ins_id_,
+                        rec->slot_uint64_feasigns_.slot_offsets,
+                        rec->slot_uint64_feasigns_.slot_values.data(),
+                        rec->slot_float_feasigns_.slot_offsets,
+                        rec->slot_float_feasigns_.slot_values.data());
+}
+
 void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
 #ifdef _LINUX
   std::string filename;
@@ -2345,6 +2386,36 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
   while (this->PickOneFile(&filename)) {
     VLOG(3) << "PickOneFile, filename=" << filename
             << ", thread_id=" << thread_id_;
+    if (IsSlotRecordFile(filename)) {
+      PADDLE_ENFORCE_EQ(LoadIntoMemoryBySlotRecordFile(filename),
+                        true,
+                        platform::errors::InvalidArgument(
+                            "Failed to load the slot record file %s, it must "
+                            "be a local file of the used slots.",
+                            filename));
+      continue;
+    }
+    std::string cache_path = SlotRecordCachePath(filename);
+    if (!cache_path.empty() && LoadIntoMemoryBySlotRecordFile(cache_path)) {
+      continue;
+    }
+    // write the parsed instances to a temp file, which is renamed to the cache
+    // once the whole file is parsed
+    std::unique_ptr<SlotRecordFileWriter> cache_writer;
+    std::string cache_tmp_path;
+    if (!cache_path.empty()) {
+      cache_tmp_path = cache_path + ".tmp." + std::to_string(getpid()) + "." +
+                       std::to_string(thread_id_);
+      cache_writer = std::make_unique<SlotRecordFileWriter>();
+      if (!cache_writer->Open(cache_tmp_path,
+                              SlotRecordFileSlotNames(),
+                              uint64_use_slot_size_,
+                              float_use_slot_size_)) {
+        LOG(WARNING) << "failed to open the slot record cache "
+                     << cache_tmp_path;
+        cache_writer.reset();
+      }
+    }
     int lines = 0;
     std::vector<SlotRecord> record_vec;
     platform::Timer timeline;
@@ -2360,8 +2431,13 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
 
       lines = line_reader.read_file(
           this->fp_.get(),
-          [this, &record_vec, &offset, &filename](const std::string& line) {
+          [this, &record_vec, &offset, &filename, &cache_writer](
+              const std::string& line) {
             if (ParseOneInstance(line, &record_vec[offset])) {
+              if (cache_writer &&
+                  !AppendSlotRecord(cache_writer.get(), record_vec[offset])) {
+                cache_writer.reset();
+              }
               ++offset;
             } else {
               LOG(WARNING) << "read file:[" << filename
@@ -2389,6 +2465,18 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
     }
     record_vec.clear();
     record_vec.shrink_to_fit();
+    if (!cache_tmp_path.empty()) {
+      if (cache_writer && cache_writer->Close() &&
+          rename(cache_tmp_path.c_str(), cache_path.c_str()) == 0) {
+        VLOG(1) << "cache the slot records of " << filename << " to "
+                << cache_path;
+      } else {
+        LOG(WARNING) << "failed to cache the slot records of " << filename
+                     << " to " << cache_path;
+        cache_writer.reset();
+        unlink(cache_tmp_path.c_str());
+      }
+    }
     timeline.Pause();
     VLOG(3) << "LoadIntoMemory() read all lines, file=" << filename
             << ", lines=" << lines
@@ -2401,6 +2489,104 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
 #endif
 }
 
+bool SlotRecordInMemoryDataFeed::LoadIntoMemoryBySlotRecordFile(
+    const std::string& path) {
+  platform::Timer timeline;
+  timeline.Start();
+  SlotRecordFileReader reader;
+  if (!reader.Open(path)) {
+    return false;
+  }
+  if (reader.slot_names() != SlotRecordFileSlotNames() ||
+      static_cast<int>(reader.uint64_slot_num()) != uint64_use_slot_size_ ||
+      static_cast<int>(reader.float_slot_num()) != float_use_slot_size_) {
+    LOG(WARNING) << "the slots of the slot record file " << path
+                 << " are not the used slots";
+    return false;
+  }
+  // check all the blocks before loading any instance
+  std::vector<SlotRecordBlockView> blocks;
+  SlotRecordBlockView view;
+  int ret = 0;
+  while ((ret = reader.Next(&view)) > 0) {
+    blocks.push_back(view);
+  }
+  if (ret < 0) {
+    LOG(WARNING) << "the slot record file " << path << " is malformed";
+    return false;
+  }
+
+  int lines = 0;
+  std::vector<SlotRecord> record_vec;
+  SlotRecordPool().get(&record_vec, OBJPOOL_BLOCK_SIZE);
+  int offset = 0;
+  for (auto& block : blocks) {
+    for (uint32_t i = 0; i < block.ins_num; ++i) {
+      SlotRecord& rec = record_vec[offset];
+      rec->search_id = block.search_id(i);
+      rec->rank = block.rank(i);
+      rec->cmatch = block.cmatch(i);
+      block.ins_id(i, &rec->ins_id_);
+      block.uint64_feasigns(i,
+                            &rec->slot_uint64_feasigns_.slot_values,
+                            &rec->slot_uint64_feasigns_.slot_offsets);
+      block.float_feasigns(i,
+                           &rec->slot_float_feasigns_.slot_values,
+                           &rec->slot_float_feasigns_.slot_offsets);
+      ++lines;
+      if (++offset >= OBJPOOL_BLOCK_SIZE) {
+        input_channel_->Write(std::move(record_vec));
+        record_vec.clear();
+        SlotRecordPool().get(&record_vec, OBJPOOL_BLOCK_SIZE);
+        offset = 0;
+      }
+    }
+  }
+  if (offset > 0) {
+    input_channel_->WriteMove(offset, &record_vec[0]);
+    if (offset < OBJPOOL_BLOCK_SIZE) {
+      SlotRecordPool().put(&record_vec[offset], (OBJPOOL_BLOCK_SIZE - offset));
+    }
+  } else {
+    SlotRecordPool().put(&record_vec);
+  }
+  timeline.Pause();
+  VLOG(3) << "LoadIntoMemory() read slot record file=" << path
+          << ", lines=" << lines << ", cost time=" << timeline.ElapsedSec()
+          << " seconds, thread_id=" << thread_id_;
+  return true;
+}
+
+std::string SlotRecordInMemoryDataFeed::SlotRecordCachePath(
+    const std::string& filename) const {
+  // the sampled instances differ in every epoch
+  if (FLAGS_slotrecord_binary_cache_dir.empty() || sample_rate_ < 1.0f) {
+    return "";
+  }
+  size_t slash = filename.rfind('/');
+  std::string name =
+      slash == std::string::npos ? filename : filename.substr(slash + 1);
+  // the file is parsed from the output of the pipe command
+  size_t hash = std::hash<std::string>()(filename + "\n" + pipe_command_);
+  std::stringstream ss;
+  ss << FLAGS_slotrecord_binary_cache_dir << "/" << name << "." << std::hex
+     << hash << kSlotRecordFileSuffix;
+  return ss.str();
+}
+
+std::vector<std::string> SlotRecordInMemoryDataFeed::SlotRecordFileSlotNames()
+    const {
+  std::vector<std::string> names(uint64_use_slot_size_ + float_use_slot_size_);
+  for (auto& info : used_slots_info_) {
+    if (info.type[0] == 'u') {
+      names[info.slot_value_idx] = info.slot;
+    } else if (info.type[0] == 'f') {
+      names[uint64_use_slot_size_ + info.slot_value_idx] = info.slot;
+    }
+  }
+  return names;
+}
+
 static void parser_log_key(const std::string& log_key,
                            uint64_t* search_id,
                            uint32_t* cmatch,
@@ -2701,6 +2887,11 @@ bool SlotRecordInMemoryDataFeed::Start() {
   this->finish_start_ = true;
 #if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_HETERPS)
   CHECK(paddle::platform::is_gpu_place(this->place_));
+  // the end of the last pass is left in the queue
+  using_pack_queue_.Clear();
+  pack_thread_num_ =
+      FLAGS_slotrecord_pack_thread_num > 0 ? FLAGS_slotrecord_pack_thread_num
+                                           : 1;
   for (int i = 0; i < pack_thread_num_ + 1; i++) {
     auto pack = BatchGpuPackMgr().get(this->GetPlace(), used_slots_info_);
     pack_vec_.push_back(pack);
@@ -2719,6 +2910,8 @@ bool SlotRecordInMemoryDataFeed::Start() {
           int thread_num = thread_count_.fetch_sub(1);
           if (thread_num == 1) {
             pack_is_end_.store(true);
+            // wake up the consumers blocked on the queue
+            using_pack_queue_.Push(nullptr);
           }
           return;
         }
@@ -2749,25 +2942,19 @@ int SlotRecordInMemoryDataFeed::Next() {
   this->CheckStart();
   if (!gpu_graph_mode_) {
 #if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_HETERPS)
-    while (true) {
-      if (last_pack_ != nullptr) {
-        free_pack_queue_.Push(last_pack_);
-        last_pack_ = nullptr;
-      }
-      if (using_pack_queue_.Size() != 0) {
-        auto* pack = using_pack_queue_.Pop();
-        PackToScope(pack);
-        last_pack_ = pack;
-        return pack->ins_num();
-      }
-      bool is_end = pack_is_end_.load();
-      if (is_end) {
-        if (using_pack_queue_.Size() == 0) {
-          return 0;
-        }
-      }
-      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    if (last_pack_ != nullptr) {
+      free_pack_queue_.Push(last_pack_);
+      last_pack_ = nullptr;
+    }
+    auto* pack = using_pack_queue_.Pop();
+    if (pack == nullptr) {
+      // keep the end for the next call
+      using_pack_queue_.Push(nullptr);
+      return 0;
     }
+    PackToScope(pack);
+    last_pack_ = pack;
+    return pack->ins_num();
 #else
     VLOG(3) << "enable heter next: " << offset_index_
             << " batch_offsets: " << batch_offsets_.size();
@@ -2861,11 +3048,14 @@ void SlotRecordInMemoryDataFeed::BuildSlotBatchGPU(const int ins_num,
   size_t float_zero_slot_index = 0;
   size_t uint64_zero_slot_index = 0;
 
-  // copy index
-  CUDA_CHECK(cudaMemcpy(offsets.data(),
-                        d_slot_offsets,
-                        slot_total_num * sizeof(size_t),
-                        cudaMemcpyDeviceToHost));
+  // copy index, on the stream of the pack so that it does not wait for the
+  // training on the default stream
+  CUDA_CHECK(cudaMemcpyAsync(offsets.data(),
+                             d_slot_offsets,
+                             slot_total_num * sizeof(size_t),
+                             cudaMemcpyDeviceToHost,
+                             pack->get_stream()));
+  CUDA_CHECK(cudaStreamSynchronize(pack->get_stream()));
   auto* dev_ctx = static_cast<phi::GPUContext*>(
       platform::DeviceContextPool::Instance().Get(this->place_));
   for (int j = 0; j < use_slot_size_; ++j) {
@@ -2936,6 +3126,8 @@ void SlotRecordInMemoryDataFeed::BuildSlotBatchGPU(const int ins_num,
                 float_use_slot_size_,
                 used_slot_gpu_types,
                 pack->get_stream());
+  // the batch is complete before it is queued to the training
+  CUDA_CHECK(cudaStreamSynchronize(pack->get_stream()));
 }
 
 void SlotRecordInMemoryDataFeed::PackToScope(MiniBatchGpuPack* pack,
@@ -3019,19 +3211,12 @@ MiniBatchGpuPack* SlotRecordInMemoryDataFeed::get_pack(
   }
 
   std::unique_lock<std::mutex> lock(pack_mutex_);
-  while (true) {
-    if (using_pack_queue_.Size() != 0) {
-      auto* pack = using_pack_queue_.Pop();
-      return pack;
-    }
-    bool is_end = pack_is_end_.load();
-    if (is_end) {
-      if (using_pack_queue_.Size() == 0) {
-        return nullptr;
-      }
-    }
-    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  auto* pack = using_pack_queue_.Pop();
+  if (pack == nullptr) {
+    // keep the end for the other task threads
+    using_pack_queue_.Push(nullptr);
   }
+  return pack;
 }
 
 MiniBatchGpuPack::MiniBatchGpuPack(const paddle::platform::Place& place,
@@ -2397,7 +2397,8 @@ int InsertTable(int gpu_id,
                 std::vector<uint64_t> *host_vec_ptr,                   // Output
                 std::vector<uint32_t> *host_ranks_ptr,                 // output
                 std::shared_ptr<HashTable<uint64_t, uint32_t>> table,  // Output
-                cudaStream_t stream) {
+                cudaStream_t stream,
+                uint64_t *h_uniq_node_bound = nullptr) {
   if (FLAGS_gpugraph_storage_mode == GpuGraphStorageMode::WHOLE_HBM) {
     return 0;
   }
@@ -2406,12 +2407,20 @@ int InsertTable(int gpu_id,
   uint64_t h_uniq_node_num = 0;
   uint64_t *d_uniq_node_num_ptr =
       reinterpret_cast<uint64_t *>((*d_uniq_node_num)->ptr());
-  cudaMemcpyAsync(&h_uniq_node_num,
-                  d_uniq_node_num_ptr,
-                  sizeof(uint64_t),
-                  cudaMemcpyDeviceToHost,
-                  stream);
-  cudaStreamSynchronize(stream);
+  uint64_t table_cap =
+      conf.gpu_graph_training ? conf.train_table_cap : conf.infer_table_cap;
+  // The bound of the unique nodes grows by len at most per insert, the count
+  // is only read back from the device when the bound may reach the capacity.
+  if (h_uniq_node_bound && *h_uniq_node_bound + len < table_cap) {
+    h_uniq_node_num = *h_uniq_node_bound;
+  } else {
+    cudaMemcpyAsync(&h_uniq_node_num,
+                    d_uniq_node_num_ptr,
+                    sizeof(uint64_t),
+                    cudaMemcpyDeviceToHost,
+                    stream);
+    cudaStreamSynchronize(stream);
+  }
 
   if (conf.gpu_graph_training) {
     VLOG(2) << "table capacity: " << conf.train_table_cap << ", "
@@ -2432,6 +2441,7 @@ int InsertTable(int gpu_id,
         *copy_unique_len_ptr += copy_len;
         table->clear(stream);
         cudaMemsetAsync(d_uniq_node_num_ptr, 0, sizeof(uint64_t), stream);
+        h_uniq_node_num = 0;
       }
     }
   } else {
@@ -2448,6 +2458,7 @@ int InsertTable(int gpu_id,
       *copy_unique_len_ptr += copy_len;
       table->clear(stream);
       cudaMemsetAsync(d_uniq_node_num_ptr, 0, sizeof(uint64_t), stream);
+      h_uniq_node_num = 0;
     }
   }
 
@@ -2456,6 +2467,9 @@ int InsertTable(int gpu_id,
   } else {
     table->insert(d_keys, len, d_uniq_node_num_ptr, 0 /*useless*/, stream);
   }
+  if (h_uniq_node_bound) {
+    *h_uniq_node_bound = h_uniq_node_num + len;
+  }
   CUDA_CHECK(cudaStreamSynchronize(stream));
   return 0;
 }
@@ -3104,6 +3118,14 @@ int FillWalkBuf(const std::vector<uint64_t> &h_device_keys_len,
                                         conf.once_sample_startid_len *
                                         conf.walk_len;
   int total_samples = 0;
+  // Starts at the capacity so that the first insert reads the count back.
+  uint64_t uniq_node_bound =
+      conf.gpu_graph_training ? conf.train_table_cap : conf.infer_table_cap;
+  // The ranks of the sampled nodes, reused by all the start batches.
+  auto d_ranks = memory::Alloc(
+      place,
+      conf.once_sample_startid_len * conf.walk_degree * sizeof(uint32_t),
+      phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
 
   // Definition of variables related to multi machine sampling
   int switch_flag = EVENT_NOT_SWTICH;  // Mark whether the local machine needs
@@ -3236,10 +3258,6 @@ int FillWalkBuf(const std::vector<uint64_t> &h_device_keys_len,
 
     // Obtain the dest machine for sample node through cross machine queries
     // Actually, its just filling in d_ranks_ptr.
-    auto d_ranks =
-        memory::Alloc(place,
-                      tmp_len * conf.walk_degree * sizeof(uint32_t),
-                      phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
     uint32_t *d_ranks_ptr = nullptr;
     if (FLAGS_graph_edges_split_mode == "fennel" ||
         FLAGS_query_dest_rank_by_multi_node) {
@@ -3263,7 +3281,8 @@ int FillWalkBuf(const std::vector<uint64_t> &h_device_keys_len,
                     host_vec_ptr,
                     host_ranks_ptr,
                     keys2rank_table,
-                    stream) != 0) {
+                    stream,
+                    &uniq_node_bound) != 0) {
       VLOG(2) << "gpu:" << conf.gpuid
               << " in step 0, insert key stage, table is full";
       update = false;
@@ -3379,7 +3398,8 @@ int FillWalkBuf(const std::vector<uint64_t> &h_device_keys_len,
                       host_vec_ptr,
                       host_ranks_ptr,
                       keys2rank_table,
-                      stream) != 0) {
+                      stream,
+                      &uniq_node_bound) != 0) {
         VLOG(0) << "gpu:" << conf.gpuid << " in step: " << step
                 << ", table is full";
         update = false;
@@ -3436,7 +3456,8 @@ int FillWalkBuf(const std::vector<uint64_t> &h_device_keys_len,
                       host_vec_ptr,
                       host_ranks_ptr,
                       keys2rank_table,
-                      stream) != 0) {
+                      stream,
+                      &uniq_node_bound) != 0) {
         VLOG(0) << "gpu:" << conf.gpuid << " in step: " << step
                 << ", table is full";
         update = false;
@@ -3490,7 +3511,8 @@ int FillWalkBuf(const std::vector<uint64_t> &h_device_keys_len,
                     host_vec_ptr,
                     host_ranks_ptr,
                     keys2rank_table,
-                    stream) != 0) {
+                    stream,
+                    &uniq_node_bound) != 0) {
       VLOG(0) << "gpu:" << conf.gpuid << " insert 0key failed";
       assert(false);
     }
@@ -3600,6 +3622,9 @@ int FillWalkBufMultiPath(
                                         conf.once_sample_startid_len *
                                         conf.walk_len;
   int total_samples = 0;
+  // Starts at the capacity so that the first insert reads the count back.
+  uint64_t uniq_node_bound =
+      conf.gpu_graph_training ? conf.train_table_cap : conf.infer_table_cap;
 
   while (i <= remain_size) {
     size_t start = cur_metapath_start;
@@ -3659,7 +3684,8 @@ int FillWalkBufMultiPath(
                       host_vec_ptr,
                       nullptr,
                       keys2rank_table,
-                      stream) != 0) {
+                      stream,
+                      &uniq_node_bound) != 0) {
         VLOG(2) << "in step 0, insert key stage, table is full";
         update = false;
         break;
@@ -3675,7 +3701,8 @@ int FillWalkBufMultiPath(
                       host_vec_ptr,
                       nullptr,
                       keys2rank_table,
-                      stream) != 0) {
+                      stream,
+                      &uniq_node_bound) != 0) {
         VLOG(2) << "in step 0, insert sample res stage, table is full";
         update = false;
         break;
@@ -3746,7 +3773,8 @@ int FillWalkBufMultiPath(
                         host_vec_ptr,
                         nullptr,
                         keys2rank_table,
-                        stream) != 0) {
+                        stream,
+                        &uniq_node_bound) != 0) {
           VLOG(2) << "in step: " << step << ", table is full";
           update = false;
           break;
@@ -1913,6 +1913,13 @@ class SlotRecordInMemoryDataFeed : public InMemoryDataFeed<SlotRecord> {
   virtual void LoadIntoMemoryByLib(void);
   virtual void LoadIntoMemoryByLine(void);
   virtual void LoadIntoMemoryByFile(void);
+  // Load the instances of a slot record file, returns false without loading
+  // any instance if the file is missing, malformed or of other slots.
+  bool LoadIntoMemoryBySlotRecordFile(const std::string& path);
+  // the binary cache of a text file, empty if the cache is disabled
+  std::string SlotRecordCachePath(const std::string& filename) const;
+  // the used uint64 slots then the used float slots
+  std::vector<std::string> SlotRecordFileSlotNames() const;
   void SetInputChannel(void* channel) override {
     input_channel_ = static_cast<ChannelObject<SlotRecord>*>(channel);
   }
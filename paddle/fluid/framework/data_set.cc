@@ -58,6 +58,8 @@ DatasetImpl<T>::DatasetImpl() {
   cur_channel_ = 0;
   fleet_send_batch_size_ = 1024;
   fleet_send_sleep_seconds_ = 0;
+  streaming_shuffle_ = false;
+  streaming_shuffle_thread_num_ = 1;
   merge_by_insid_ = false;
   merge_by_sid_ = true;
   enable_pv_merge_ = false;
@@ -855,6 +857,32 @@ void MultiSlotDataset::GlobalShuffle(int thread_num) {
   VLOG(3) << "MultiSlotDataset::GlobalShuffle() input_channel_ size "
           << input_channel_->Size();
 
+  std::vector<std::thread> global_shuffle_threads;
+  if (thread_num == -1) {
+    thread_num = thread_num_;
+  }
+  VLOG(3) << "start global shuffle threads, num = " << thread_num;
+  for (int i = 0; i < thread_num; ++i) {
+    global_shuffle_threads.emplace_back(&MultiSlotDataset::GlobalShuffleSend,
+                                        this);
+  }
+  for (std::thread& t : global_shuffle_threads) {
+    t.join();
+  }
+  global_shuffle_threads.clear();
+  global_shuffle_threads.shrink_to_fit();
+  input_channel_->Clear();
+  timeline.Pause();
+  VLOG(3) << "DatasetImpl<T>::GlobalShuffle() end, cost time="
+          << timeline.ElapsedSec() << " seconds";
+}
+
+void MultiSlotDataset::GlobalShuffleSend() {
+#ifdef PADDLE_WITH_PSCORE
+  auto fleet_ptr = distributed::FleetWrapper::GetInstance();
+#else
+  auto fleet_ptr = framework::FleetWrapper::GetInstance();
+#endif
   auto get_client_id = [this, fleet_ptr](const Record& data) -> size_t {
     if (this->merge_by_insid_) {
       return XXH64(data.ins_id_.data(), data.ins_id_.length(), 0) %
@@ -867,69 +895,78 @@ void MultiSlotDataset::GlobalShuffle(int thread_num) {
     }
   };
 
-  auto global_shuffle_func = [this, get_client_id]() {
-#ifdef PADDLE_WITH_PSCORE
-    auto fleet_ptr = distributed::FleetWrapper::GetInstance();
-#else
-    auto fleet_ptr = framework::FleetWrapper::GetInstance();
-#endif
-    // auto fleet_ptr = framework::FleetWrapper::GetInstance();
-    std::vector<Record> data;
-    while (this->input_channel_->Read(data)) {
-      std::vector<paddle::framework::BinaryArchive> ars(this->trainer_num_);
-      for (auto& t : data) {
-        auto client_id = get_client_id(t);
-        ars[client_id] << t;
-      }
-      std::vector<std::future<int32_t>> total_status;
-      std::vector<int> send_index(this->trainer_num_);
-      for (int i = 0; i < this->trainer_num_; ++i) {
-        send_index[i] = i;
-      }
-      std::shuffle(
-          send_index.begin(), send_index.end(), fleet_ptr->LocalRandomEngine());
-      for (int index = 0; index < this->trainer_num_; ++index) {
-        int i = send_index[index];
-        if (ars[i].Length() == 0) {
-          continue;
-        }
-        std::string msg(ars[i].Buffer(), ars[i].Length());
-        auto ret = fleet_ptr->SendClientToClientMsg(0, i, msg);
-        total_status.push_back(std::move(ret));
-      }
-      for (auto& t : total_status) {
-        t.wait();
-      }
-      ars.clear();
-      ars.shrink_to_fit();
-      data.clear();
-      data.shrink_to_fit();
-      // currently we find bottleneck is server not able to handle large data
-      // in time, so we can remove this sleep and set fleet_send_batch_size to
-      // 1024, and set server thread to 24.
-      if (fleet_send_sleep_seconds_ != 0) {
-        sleep(this->fleet_send_sleep_seconds_);
+  std::vector<Record> data;
+  while (this->input_channel_->Read(data)) {
+    std::vector<paddle::framework::BinaryArchive> ars(this->trainer_num_);
+    for (auto& t : data) {
+      auto client_id = get_client_id(t);
+      ars[client_id] << t;
+    }
+    std::vector<std::future<int32_t>> total_status;
+    std::vector<int> send_index(this->trainer_num_);
+    for (int i = 0; i < this->trainer_num_; ++i) {
+      send_index[i] = i;
+    }
+    std::shuffle(
+        send_index.begin(), send_index.end(), fleet_ptr->LocalRandomEngine());
+    for (int index = 0; index < this->trainer_num_; ++index) {
+      int i = send_index[index];
+      if (ars[i].Length() == 0) {
+        continue;
       }
+      std::string msg(ars[i].Buffer(), ars[i].Length());
+      auto ret = fleet_ptr->SendClientToClientMsg(0, i, msg);
+      total_status.push_back(std::move(ret));
     }
-  };
+    for (auto& t : total_status) {
+      t.wait();
+    }
+    ars.clear();
+    ars.shrink_to_fit();
+    data.clear();
+    data.shrink_to_fit();
+    // currently we find bottleneck is server not able to handle large data
+    // in time, so we can remove this sleep and set fleet_send_batch_size to
+    // 1024, and set server thread to 24.
+    if (fleet_send_sleep_seconds_ != 0) {
+      sleep(this->fleet_send_sleep_seconds_);
+    }
+  }
+}
 
-  std::vector<std::thread> global_shuffle_threads;
-  if (thread_num == -1) {
-    thread_num = thread_num_;
+void MultiSlotDataset::LoadIntoMemory() {
+  if (!streaming_shuffle_ || trainer_num_ <= 1 || gpu_graph_mode_) {
+    DatasetImpl<Record>::LoadIntoMemory();
+    return;
   }
-  VLOG(3) << "start global shuffle threads, num = " << thread_num;
-  for (int i = 0; i < thread_num; ++i) {
-    global_shuffle_threads.emplace_back(global_shuffle_func);
+  // The records are sent to the trainers by blocks of fleet_send_batch_size_
+  // while the files are still being read, so the load and the exchange of
+  // global shuffle overlap. The records received are in multi_output_channel_
+  // and GlobalShuffle after the load has nothing left to send.
+  VLOG(3) << "MultiSlotDataset::LoadIntoMemory() streaming shuffle begin";
+  platform::Timer timeline;
+  timeline.Start();
+  input_channel_->SetBlockSize(fleet_send_batch_size_);
+  std::vector<std::thread> load_threads;
+  for (int64_t i = 0; i < thread_num_; ++i) {
+    load_threads.emplace_back(&paddle::framework::DataFeed::LoadIntoMemory,
+                              readers_[i].get());
   }
-  for (std::thread& t : global_shuffle_threads) {
+  std::vector<std::thread> send_threads;
+  for (int i = 0; i < streaming_shuffle_thread_num_; ++i) {
+    send_threads.emplace_back(&MultiSlotDataset::GlobalShuffleSend, this);
+  }
+  for (std::thread& t : load_threads) {
+    t.join();
+  }
+  input_channel_->Close();
+  for (std::thread& t : send_threads) {
     t.join();
   }
-  global_shuffle_threads.clear();
-  global_shuffle_threads.shrink_to_fit();
   input_channel_->Clear();
   timeline.Pause();
-  VLOG(3) << "DatasetImpl<T>::GlobalShuffle() end, cost time="
-          << timeline.ElapsedSec() << " seconds";
+  VLOG(3) << "MultiSlotDataset::LoadIntoMemory() streaming shuffle end"
+          << ", cost time=" << timeline.ElapsedSec() << " seconds";
 }
 
 template <typename T>
@@ -1069,6 +1106,13 @@ void DatasetImpl<T>::SetFleetSendSleepSeconds(int seconds) {
   fleet_send_sleep_seconds_ = seconds;
 }
 
+template <typename T>
+void DatasetImpl<T>::SetStreamingShuffle(bool streaming_shuffle,
+                                         int thread_num) {
+  streaming_shuffle_ = streaming_shuffle;
+  streaming_shuffle_thread_num_ = thread_num > 0 ? thread_num : thread_num_;
+}
+
 template <typename T>
 void DatasetImpl<T>::CreateReaders() {
   VLOG(3) << "Calling CreateReaders()";
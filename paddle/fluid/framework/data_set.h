@@ -164,6 +164,9 @@ class Dataset {
   virtual void DynamicAdjustReadersNum(int thread_num) = 0;
   // set fleet send sleep seconds
   virtual void SetFleetSendSleepSeconds(int seconds) = 0;
+  // send the records to the trainers of global shuffle as they are loaded,
+  // by thread_num threads, instead of in GlobalShuffle after the load
+  virtual void SetStreamingShuffle(bool streaming_shuffle, int thread_num) = 0;
 
   virtual std::vector<std::string> GetSlots() = 0;
 
@@ -275,6 +278,7 @@ class DatasetImpl : public Dataset {
                                        bool discard_remaining_ins = false);
   virtual void DynamicAdjustReadersNum(int thread_num);
   virtual void SetFleetSendSleepSeconds(int seconds);
+  virtual void SetStreamingShuffle(bool streaming_shuffle, int thread_num);
   virtual std::vector<std::string> GetSlots();
   virtual bool GetEpochFinish();
   virtual void ClearSampleState();
@@ -346,6 +350,8 @@ class DatasetImpl : public Dataset {
   std::string fs_ugi_;
   int64_t fleet_send_batch_size_;
   int64_t fleet_send_sleep_seconds_;
+  bool streaming_shuffle_;
+  int streaming_shuffle_thread_num_;
   std::vector<std::thread> preload_threads_;
   std::thread* release_thread_ = nullptr;
   bool merge_by_insid_;
@@ -415,6 +421,7 @@ class MultiSlotDataset : public DatasetImpl<Record> {
       const std::unordered_set<uint16_t>& slots_to_replace,
       std::vector<Record>* result);
   virtual ~MultiSlotDataset() {}
+  virtual void LoadIntoMemory();
   virtual void GlobalShuffle(int thread_num = -1);
   virtual void DynamicAdjustReadersNum(int thread_num);
   virtual void PrepareTrain();
@@ -423,6 +430,8 @@ class MultiSlotDataset : public DatasetImpl<Record> {
   virtual int ReceiveFromClient(int msg_type,
                                 int client_id,
                                 const std::string& msg);
+  // send the records of input_channel_ to the trainers until it is closed
+  void GlobalShuffleSend();
 };
 class SlotRecordDataset : public DatasetImpl<SlotRecord> {
  public:
@@ -109,21 +109,38 @@ void TransformData(const phi::KernelKey &expected_kernel_type,
     PassTensorData(&out, &in);
   }
 
+  bool trans_dtype =
+      NeedTransformDataType(expected_kernel_type, kernel_type_for_var);
+  bool trans_place =
+      kernel_type_for_var.backend() != phi::Backend::ALL_BACKEND &&
+      !platform::is_same_place(in.place(), place);
+  // A host tensor to a GPU is copied first and cast on the GPU, which is much
+  // faster than the cast on the host.
+  bool trans_dtype_after_place =
+      trans_dtype && trans_place &&
+      (platform::is_cpu_place(in.place()) ||
+       platform::is_cuda_pinned_place(in.place())) &&
+      platform::is_gpu_place(place);
+
   // do data type transform
-  if (NeedTransformDataType(expected_kernel_type, kernel_type_for_var)) {
+  if (trans_dtype && !trans_dtype_after_place) {
     TransDataType(kernel_type_for_var, expected_kernel_type, in, &out);
     transformed = true;
     PassTensorData(&out, &in);
   }
 
   // do device transform
-  if (kernel_type_for_var.backend() != phi::Backend::ALL_BACKEND &&
-      !platform::is_same_place(in.place(), place)) {
+  if (trans_place) {
     TransDataDevice(in, place, &out);
     transformed = true;
     PassTensorData(&out, &in);
   }
 
+  if (trans_dtype_after_place) {
+    TransDataType(kernel_type_for_var, expected_kernel_type, in, &out);
+    PassTensorData(&out, &in);
+  }
+
   PADDLE_ENFORCE_EQ(
       transformed,
       true,
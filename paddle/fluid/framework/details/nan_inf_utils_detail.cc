@@ -14,10 +14,14 @@
 
 #include "paddle/fluid/framework/details/nan_inf_utils_detail.h"
 
+#include <limits>
+#include <mutex>
+
 #include "paddle/fluid/framework/details/nan_inf_utils.h"
 #include "paddle/fluid/framework/op_proto_maker.h"
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/common/memory_utils.h"
 
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/phi/core/flags.h"
@@ -52,6 +56,103 @@ void SetNanInfStackLimit(const int& stack_limit) {
 
 int GetNanInfStackLimit() { return debug_nan_inf.stack_limit; }
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+static constexpr int64_t kNoNanInf = std::numeric_limits<int64_t>::max();
+
+// The checked tensors get the ids in order, and the flag of a device holds
+// the least id of its tensors holding NAN/INF, or kNoNanInf.
+struct AsyncNanInfFlags {
+  std::mutex mutex;
+  std::unordered_map<int, phi::Allocator::AllocationPtr> flags;
+  std::unordered_map<int, const phi::GPUContext*> ctxs;
+  // The op and the var of the tensors from first_id.
+  std::vector<std::pair<std::string, std::string>> names;
+  int64_t first_id = 0;
+};
+
+static AsyncNanInfFlags& async_nan_inf_flags() {
+  // Never destroyed, the flags are freed with the allocators.
+  static AsyncNanInfFlags* flags = new AsyncNanInfFlags();
+  return *flags;
+}
+
+static void CheckNanInfFlagsLocked(AsyncNanInfFlags* async) {
+  int64_t found = kNoNanInf;
+  for (auto& item : async->flags) {
+    const phi::GPUContext* ctx = async->ctxs.at(item.first);
+    int64_t value = kNoNanInf;
+    phi::memory_utils::Copy(phi::CPUPlace(),
+                            &value,
+                            item.second->place(),
+                            item.second->ptr(),
+                            sizeof(int64_t),
+                            ctx->stream());
+    ctx->Wait();
+    if (value != kNoNanInf) {
+      found = std::min(found, value);
+      phi::memory_utils::Copy(item.second->place(),
+                              item.second->ptr(),
+                              phi::CPUPlace(),
+                              &kNoNanInf,
+                              sizeof(int64_t),
+                              ctx->stream());
+    }
+  }
+  std::vector<std::pair<std::string, std::string>> names;
+  names.swap(async->names);
+  int64_t first_id = async->first_id;
+  async->first_id += static_cast<int64_t>(names.size());
+  if (found == kNoNanInf) {
+    return;
+  }
+  const auto& name = names.at(found - first_id);
+  std::string info = "There are NAN or INF in the output " + name.second +
+                     " of operator " + name.first +
+                     ", which is the first one of the " +
+                     std::to_string(names.size()) +
+                     " tensors checked since the last read of the flags.";
+  if (FLAGS_check_nan_inf_level == 0) {
+    PADDLE_THROW(platform::errors::PreconditionNotMet("%s", info));
+  }
+  LOG(WARNING) << info;
+}
+
+int64_t* ReserveNanInfFlag(const phi::GPUContext& ctx,
+                           const std::string& op_type,
+                           const std::string& var_name,
+                           int64_t* id) {
+  auto& async = async_nan_inf_flags();
+  std::lock_guard<std::mutex> guard(async.mutex);
+  if (async.names.size() >=
+      static_cast<size_t>(FLAGS_check_nan_inf_async_interval)) {
+    CheckNanInfFlagsLocked(&async);
+  }
+  int dev_id = ctx.GetPlace().GetDeviceId();
+  auto& flag = async.flags[dev_id];
+  if (!flag) {
+    flag = phi::memory_utils::Alloc(ctx.GetPlace(), sizeof(int64_t));
+    phi::memory_utils::Copy(ctx.GetPlace(),
+                            flag->ptr(),
+                            phi::CPUPlace(),
+                            &kNoNanInf,
+                            sizeof(int64_t),
+                            ctx.stream());
+    async.ctxs[dev_id] = &ctx;
+  }
+  *id = async.first_id + static_cast<int64_t>(async.names.size());
+  async.names.emplace_back(op_type, var_name);
+  return reinterpret_cast<int64_t*>(flag->ptr());
+}
+#endif
+
+void CheckNanInfFlags() {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  auto& async = async_nan_inf_flags();
+  std::lock_guard<std::mutex> guard(async.mutex);
+  CheckNanInfFlagsLocked(&async);
+#endif
+}
+
 static std::once_flag white_list_init_flag;
 
 static int op_role_nan_inf_white_list = 0;
@@ -24,6 +24,7 @@
 #include "paddle/phi/kernels/funcs/eigen/extensions.h"
 
 PHI_DECLARE_int32(check_nan_inf_level);
+PHI_DECLARE_int32(check_nan_inf_async_interval);
 
 namespace paddle {
 namespace framework {
@@ -37,6 +38,19 @@ void SetNanInfStackLimit(const int& stack_limit);
 
 int GetNanInfStackLimit();
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+// Returns the flag of the device of ctx to check a tensor asynchronously, and
+// the id of the tensor, by which the op and the var are reported.
+int64_t* ReserveNanInfFlag(const phi::GPUContext& ctx,
+                           const std::string& op_type,
+                           const std::string& var_name,
+                           int64_t* id);
+#endif
+
+// Reads and resets the flags of FLAGS_check_nan_inf_async_interval, the first
+// tensor holding NAN/INF since the last read is reported as the level.
+void CheckNanInfFlags();
+
 template <typename Context>
 struct TensorCheckerVisitor {
   TensorCheckerVisitor(const std::string& o,
@@ -61,6 +75,18 @@ struct TensorCheckerVisitor {
     auto* dev_ctx = reinterpret_cast<Context*>(
         platform::DeviceContextPool::Instance().Get(tensor.place()));
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    if constexpr (std::is_same<Context, phi::GPUContext>::value) {
+      if (FLAGS_check_nan_inf_async_interval > 0 &&
+          FLAGS_check_nan_inf_level <= 1) {
+        int64_t id = 0;
+        int64_t* flag = ReserveNanInfFlag(*dev_ctx, op_type, var_name, &id);
+        phi::CheckNumericsFlagKernel<T, Context>(*dev_ctx, tensor, id, flag);
+        return;
+      }
+    }
+#endif
+
     phi::DenseTensor stats;
     phi::DenseTensor values;
     auto file_path = GetNanPath();
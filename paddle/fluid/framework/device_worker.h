@@ -104,6 +104,11 @@ class PullDenseWorker {
   void ResetThreadVersion(uint64_t table_id);
   void Wait(std::vector<::std::future<int32_t>>* status_vec);
   void PullDense(bool force_update = false);
+  // Binds the dense params of the thread scope to the newest pulled buffer
+  // when the buffers are double, see FLAGS_pull_dense_double_buffer. It takes
+  // no lock, and the thread keeps reading the version it binds until its next
+  // call, so it should be called before the ops of a batch.
+  void AcquireDense(Scope* thread_scope, int thread_id);
   void CreatePinVar();
   void MergeDenseParam();
   int GetThreadIdByScope(const Scope* scope);
@@ -121,6 +126,11 @@ class PullDenseWorker {
   PullDenseWorker() : root_scope_(NULL) {}
   void Run();
   bool CheckUpdateParam(uint64_t table_id);
+  void InitDenseBuffers();
+  // Whether no thread reads the buffer of the version before the current
+  // one, which is going to be filled by the next pull.
+  bool IsBackBufferReleased(uint64_t version) const;
+  void PullDenseToBuffer(bool force_update);
 
  private:
 #if defined(PADDLE_WITH_PSCORE)
@@ -160,6 +170,15 @@ class PullDenseWorker {
 #endif
   std::vector<paddle::platform::Place> places_;
   std::vector<Scope*> thread_scopes_;
+
+  // The dense params are pulled into the back one of the two buffers, which
+  // is published by an increase of dense_version_, the version v lives in
+  // dense_buffers_[v % 2]. A thread records the version it reads, and the
+  // back buffer is filled only once every thread has left it.
+  bool double_buffer_ = false;
+  std::unique_ptr<Scope> dense_buffers_[2];
+  std::atomic<uint64_t> dense_version_{0};
+  std::unique_ptr<std::atomic<uint64_t>[]> thread_dense_versions_;
 };
 
 // should incorporate different type of device
@@ -13,9 +13,15 @@
 // limitations under the License.
 #include "paddle/fluid/framework/dlpack_tensor.h"
 
+#include <map>
+
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/data_type.h"
+#include "paddle/fluid/platform/device_context.h"
 #include "paddle/fluid/platform/place.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/platform/cuda_device_guard.h"
+#endif
 
 namespace paddle {
 namespace framework {
@@ -119,8 +125,80 @@ struct DLDeviceVisitor {
 #endif
   }
 };
+
+static phi::Place GetPlaceFromDLDevice(const ::DLDevice &device) {
+  if (device.device_type == kDLCPU) {
+    return platform::CPUPlace();
+  }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (device.device_type == kDLGPU) {
+    return platform::CUDAPlace(device.device_id);
+  }
+  if (device.device_type == kDLCPUPinned) {
+    return platform::CUDAPinnedPlace();
+  }
+#endif
+  PADDLE_THROW(platform::errors::Unimplemented(
+      "The DLPack device type %d is not supported in this version.",
+      device.device_type));
+}
+
+static phi::DataType GetDataTypeFromDLDataType(const ::DLDataType &type) {
+  // The code 6 is kDLBool of DLPack 1.0.
+  static const std::map<std::pair<int, int>, phi::DataType> types = {
+      {{kDLFloat, 16}, phi::DataType::FLOAT16},
+      {{kDLFloat, 32}, phi::DataType::FLOAT32},
+      {{kDLFloat, 64}, phi::DataType::FLOAT64},
+      {{kDLBfloat, 16}, phi::DataType::BFLOAT16},
+      {{kDLInt, 8}, phi::DataType::INT8},
+      {{kDLInt, 16}, phi::DataType::INT16},
+      {{kDLInt, 32}, phi::DataType::INT32},
+      {{kDLInt, 64}, phi::DataType::INT64},
+      {{kDLUInt, 8}, phi::DataType::UINT8},
+      {{kDLComplex, 64}, phi::DataType::COMPLEX64},
+      {{kDLComplex, 128}, phi::DataType::COMPLEX128},
+      {{6, 8}, phi::DataType::BOOL}};
+  PADDLE_ENFORCE_EQ(type.lanes,
+                    1,
+                    platform::errors::Unimplemented(
+                        "Only the DLPack tensors of 1 lane are supported, "
+                        "but received %d lanes.",
+                        type.lanes));
+  auto it = types.find({type.code, type.bits});
+  PADDLE_ENFORCE_NE(it,
+                    types.end(),
+                    platform::errors::Unimplemented(
+                        "Unsupported DLDataType code %d with %d bits.",
+                        type.code,
+                        type.bits));
+  return it->second;
+}
 }  // namespace internal
 
+// Fills dl by src, on the shape and the strides arrays of the caller.
+static void InitDLTensor(const phi::DenseTensor &src,
+                         int64_t *shape,
+                         int64_t *strides,
+                         ::DLTensor *dl) {
+  dl->data = const_cast<void *>(src.data());
+  using DimType = decltype(dl->ndim);  // int
+  dl->ndim = static_cast<DimType>(src.dims().size());
+  for (DimType i = 0; i < dl->ndim; ++i) {
+    shape[i] = src.dims()[i];
+    strides[i] = 1;
+  }
+  for (DimType i = dl->ndim - 2; i >= 0; --i) {
+    strides[i] = shape[i + 1] * strides[i + 1];
+  }
+  dl->shape = shape;
+  dl->strides = strides;
+  dl->device = paddle::platform::VisitPlace(src.place(),
+                                            internal::DLDeviceVisitor());
+  dl->dtype = internal::GetDLDataTypeFromTypeIndex(
+      framework::TransToProtoVarType(src.dtype()));
+  dl->byte_offset = 0;
+}
+
 struct PaddleDLMTensor {
   phi::DenseTensor handle;
   DLManagedTensor tensor;
@@ -134,43 +212,161 @@ void deleter(DLManagedTensor *arg) {
 
 DLManagedTensor *toDLPack(const phi::DenseTensor &src) {
   PaddleDLMTensor *pdDLMTensor(new PaddleDLMTensor);
-  pdDLMTensor->handle = const_cast<phi::DenseTensor &>(src);
+  pdDLMTensor->handle = src;
   pdDLMTensor->tensor.manager_ctx = pdDLMTensor;
   pdDLMTensor->tensor.deleter = &deleter;
-  pdDLMTensor->tensor.dl_tensor.data = const_cast<void *>(src.data());
+  int ndim = src.dims().size();
+  InitDLTensor(src,
+               new int64_t[ndim],
+               new int64_t[ndim],
+               &pdDLMTensor->tensor.dl_tensor);
+  return &(pdDLMTensor->tensor);
+}
+
+// The shape and the strides live with the handle, so that a versioned tensor
+// is exported by a single allocation.
+struct PaddleDLMTensorVersioned {
+  phi::DenseTensor handle;
+  int64_t shape[phi::DDim::kMaxRank];
+  int64_t strides[phi::DDim::kMaxRank];
+  DLManagedTensorVersioned tensor;
+};
 
-  // init ndim
-  using DimType = decltype(pdDLMTensor->tensor.dl_tensor.ndim);  // int
-  pdDLMTensor->tensor.dl_tensor.ndim = static_cast<DimType>(src.dims().size());
-  DimType ndim = pdDLMTensor->tensor.dl_tensor.ndim;
+DLManagedTensorVersioned *toDLPackVersioned(const phi::DenseTensor &src) {
+  auto *managed = new PaddleDLMTensorVersioned;
+  managed->handle = src;
+  managed->tensor.version.major = kDLPackMajorVersion;
+  managed->tensor.version.minor = kDLPackMinorVersion;
+  managed->tensor.manager_ctx = managed;
+  managed->tensor.deleter = [](DLManagedTensorVersioned *arg) {
+    delete static_cast<PaddleDLMTensorVersioned *>(arg->manager_ctx);
+  };
+  managed->tensor.flags = 0;
+  InitDLTensor(
+      src, managed->shape, managed->strides, &managed->tensor.dl_tensor);
+  return &managed->tensor;
+}
 
-  // init shape
-  auto shape = new int64_t[ndim];
-  for (DimType i = 0; i < ndim; ++i) {
-    shape[i] = src.dims()[i];
+void DLPackWaitProducer(const std::vector<const phi::DenseTensor *> &tensors,
+                        int64_t stream,
+                        const phi::DeviceContext *producer) {
+  if (stream == -1) return;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  const phi::DenseTensor *gpu_tensor = nullptr;
+  for (auto *tensor : tensors) {
+    if (!tensor->initialized() || !platform::is_gpu_place(tensor->place())) {
+      continue;
+    }
+    if (gpu_tensor == nullptr) {
+      gpu_tensor = tensor;
+      continue;
+    }
+    PADDLE_ENFORCE_EQ(tensor->place(),
+                      gpu_tensor->place(),
+                      platform::errors::InvalidArgument(
+                          "The tensors exported on a stream should be on one "
+                          "device, but received %s and %s.",
+                          gpu_tensor->place(),
+                          tensor->place()));
   }
-  pdDLMTensor->tensor.dl_tensor.shape = shape;
-
-  // init stride
-  auto strides = new int64_t[ndim];
-  for (DimType i = 0; i < ndim; ++i) {
-    strides[i] = 1;
+  if (gpu_tensor == nullptr) return;
+  if (producer == nullptr) {
+    producer = platform::DeviceContextPool::Instance().Get(gpu_tensor->place());
   }
-  for (DimType i = ndim - 2; i >= 0; --i) {
-    strides[i] = shape[i + 1] * strides[i + 1];
+  gpuStream_t producer_stream =
+      static_cast<const phi::GPUContext *>(producer)->stream();
+  gpuStream_t consumer_stream = reinterpret_cast<gpuStream_t>(stream);
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_NE(stream,
+                    0,
+                    platform::errors::InvalidArgument(
+                        "The stream 0 is ambiguous for CUDA by the DLPack "
+                        "protocol, use 1 for the legacy default stream."));
+  if (stream == 1) consumer_stream = cudaStreamLegacy;
+  if (stream == 2) consumer_stream = cudaStreamPerThread;
+#endif
+  if (consumer_stream == producer_stream) return;
+
+  platform::CUDADeviceGuard guard(gpu_tensor->place().GetDeviceId());
+  gpuEvent_t event;
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipEventCreateWithFlags(&event, hipEventDisableTiming));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(event, producer_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamWaitEvent(consumer_stream, event, 0));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventDestroy(event));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event, producer_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(consumer_stream, event, 0));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventDestroy(event));
+#endif
+#endif
+}
+
+namespace {
+// Owns a managed tensor of the other frameworks, released by its deleter.
+template <typename ManagedTensor>
+class DLPackAllocation : public phi::Allocation {
+ public:
+  DLPackAllocation(ManagedTensor *src, size_t size, const phi::Place &place)
+      : phi::Allocation(static_cast<char *>(src->dl_tensor.data) +
+                            src->dl_tensor.byte_offset,
+                        size,
+                        place),
+        src_(src) {}
+
+  ~DLPackAllocation() override {
+    if (src_->deleter) src_->deleter(src_);
   }
-  pdDLMTensor->tensor.dl_tensor.strides = strides;
 
-  // init device, DLDevice type with device_type and device_id
-  auto place = src.place();
-  pdDLMTensor->tensor.dl_tensor.device =
-      paddle::platform::VisitPlace(place, internal::DLDeviceVisitor());
+ private:
+  ManagedTensor *src_;
+};
 
-  pdDLMTensor->tensor.dl_tensor.dtype = internal::GetDLDataTypeFromTypeIndex(
-      framework::TransToProtoVarType(src.dtype()));
+template <typename ManagedTensor>
+void TensorFromDLPackNoCopyImpl(ManagedTensor *src, phi::DenseTensor *dst) {
+  const ::DLTensor &dl = src->dl_tensor;
+  phi::Place place = internal::GetPlaceFromDLDevice(dl.device);
+  phi::DataType dtype = internal::GetDataTypeFromDLDataType(dl.dtype);
+  std::vector<int64_t> shape(dl.shape, dl.shape + dl.ndim);
+  if (dl.strides != nullptr) {
+    int64_t expected = 1;
+    for (int i = dl.ndim - 1; i >= 0; --i) {
+      PADDLE_ENFORCE_EQ(
+          shape[i] == 1 || dl.strides[i] == expected,
+          true,
+          platform::errors::Unimplemented(
+              "Only the compact DLPack tensors are shared without a copy, "
+              "but the stride of dim %d is %d rather than %d.",
+              i,
+              dl.strides[i],
+              expected));
+      expected *= shape[i];
+    }
+  }
+  phi::DenseTensorMeta meta(dtype, common::make_ddim(shape));
+  size_t size = common::product(meta.dims) * dl.dtype.bits / 8;
+  *dst = phi::DenseTensor(
+      std::make_shared<DLPackAllocation<ManagedTensor>>(src, size, place),
+      meta);
+}
+}  // namespace
 
-  pdDLMTensor->tensor.dl_tensor.byte_offset = 0;
-  return &(pdDLMTensor->tensor);
+void TensorFromDLPackNoCopy(DLManagedTensor *src, phi::DenseTensor *dst) {
+  TensorFromDLPackNoCopyImpl(src, dst);
+}
+
+void TensorFromDLPackNoCopy(DLManagedTensorVersioned *src,
+                            phi::DenseTensor *dst) {
+  PADDLE_ENFORCE_LE(src->version.major,
+                    kDLPackMajorVersion,
+                    platform::errors::Unimplemented(
+                        "The DLPack major version %d is newer than %d.",
+                        src->version.major,
+                        kDLPackMajorVersion));
+  TensorFromDLPackNoCopyImpl(src, dst);
 }
 
 DLPackTensor::DLPackTensor(const phi::DenseTensor &tensor, LaneType lanes) {
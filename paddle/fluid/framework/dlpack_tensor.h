@@ -16,11 +16,39 @@
 
 #include <dlpack/dlpack.h>
 
+#include <vector>
+
 #include "paddle/fluid/framework/tensor.h"
 
+#ifndef DLPACK_MAJOR_VERSION
+// The versioned managed tensor of DLPack 1.0, laid out by its ABI so that the
+// tensors are exchanged with the newer frameworks while the vendored dlpack
+// is older.
+typedef struct {
+  uint32_t major;
+  uint32_t minor;
+} DLPackVersion;
+
+typedef struct DLManagedTensorVersioned {
+  DLPackVersion version;
+  void* manager_ctx;
+  void (*deleter)(struct DLManagedTensorVersioned* self);
+  uint64_t flags;
+  DLTensor dl_tensor;
+} DLManagedTensorVersioned;
+#endif
+
+namespace phi {
+class DeviceContext;
+}  // namespace phi
+
 namespace paddle {
 namespace framework {
 
+// The version of the versioned managed tensors exported by toDLPackVersioned.
+constexpr uint32_t kDLPackMajorVersion = 1;
+constexpr uint32_t kDLPackMinorVersion = 0;
+
 class DLPackTensor {
  public:
   using LaneType = decltype(::DLTensor::dtype.lanes);  // uint16_t
@@ -46,5 +74,25 @@ class DLPackTensor {
 
 DLManagedTensor* toDLPack(const phi::DenseTensor& src);
 
+DLManagedTensorVersioned* toDLPackVersioned(const phi::DenseTensor& src);
+
+// Makes the stream of a consumer wait for the producer of the tensors, by the
+// stream argument of __dlpack__: -1 asks for no synchronization, and on CUDA
+// 1 and 2 are the legacy and the per-thread default streams while the others
+// are a cudaStream_t. One event is recorded for all the tensors, so that a
+// batch costs a single wait and never a device sync. The producer is the
+// context of the device in the pool if it is not given.
+void DLPackWaitProducer(const std::vector<const phi::DenseTensor*>& tensors,
+                        int64_t stream,
+                        const phi::DeviceContext* producer = nullptr);
+
+// Shares the data of a managed tensor without a copy, the deleter of the
+// managed tensor is called when the last holder of dst is released. Only the
+// compact tensors on the CPU, the pinned memory and the GPU are shared.
+void TensorFromDLPackNoCopy(DLManagedTensor* src, phi::DenseTensor* dst);
+
+void TensorFromDLPackNoCopy(DLManagedTensorVersioned* src,
+                            phi::DenseTensor* dst);
+
 }  // namespace framework
 }  // namespace paddle
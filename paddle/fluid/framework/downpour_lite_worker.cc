@@ -264,6 +264,7 @@ void DownpourLiteWorker::TrainFilesWithProfiler() {
   uint64_t total_inst = 0;
   timeline.Start();
   while ((cur_batch = device_reader_->Next()) > 0) {
+    PullDenseWorker::GetInstance()->AcquireDense(thread_scope_, thread_id_);
     timeline.Pause();
     read_time += timeline.ElapsedSec();
     total_time += timeline.ElapsedSec();
@@ -446,6 +447,7 @@ void DownpourLiteWorker::TrainFiles() {
   int batch_cnt = 0;
   int cur_batch;
   while ((cur_batch = device_reader_->Next()) > 0) {
+    PullDenseWorker::GetInstance()->AcquireDense(thread_scope_, thread_id_);
     if (copy_table_config_.need_copy()) {
       VLOG(3) << "Begin to copy table";
       if (batch_cnt % copy_table_config_.batch_num() == 0) {
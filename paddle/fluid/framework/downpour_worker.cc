@@ -490,6 +490,7 @@ void DownpourWorker::TrainFilesWithProfiler() {
   uint64_t total_inst = 0;
   timeline.Start();
   while ((cur_batch = device_reader_->Next()) > 0) {
+    PullDenseWorker::GetInstance()->AcquireDense(thread_scope_, thread_id_);
     timeline.Pause();
     read_time += timeline.ElapsedSec();
     total_time += timeline.ElapsedSec();
@@ -806,6 +807,7 @@ void DownpourWorker::TrainFiles() {
   int batch_cnt = 0;
   int cur_batch = 0;
   while ((cur_batch = device_reader_->Next()) > 0) {
+    PullDenseWorker::GetInstance()->AcquireDense(thread_scope_, thread_id_);
     if (copy_table_config_.need_copy()) {
       if (batch_cnt % copy_table_config_.batch_num() == 0) {
         CopySparseTable();
@@ -324,6 +324,7 @@ void DownpourWorkerOpt::TrainFiles() {
   }
   // pre-defined for the first op run with async-pulled embedding
   while ((cur_batch = device_reader_->Next()) > 0) {
+    PullDenseWorker::GetInstance()->AcquireDense(thread_scope_, thread_id_);
     if (copy_table_config_.need_copy()) {
       if (copy_table_config_.sparse_copy_by_feasign()) {
         for (auto& copy_sparse_table : copy_sparse_tables_) {
@@ -169,10 +169,20 @@ int64_t hash_with_seed(int64_t value, int64_t seed);
 
 class InterpreterCoreInfo {
  public:
+  // The names and the variables in the scope of the values of a role of the
+  // program, e.g., its inputs.
+  struct ValueBinding {
+    std::vector<std::string> names;
+    std::vector<Variable*> vars;
+  };
+
   struct CacheValue {
     std::shared_ptr<InterpreterCore> core_{nullptr};
     std::set<std::string> skip_eager_delete_vars_;
     std::unique_ptr<::pir::Program> ir_prog_{nullptr};
+    // The bindings of the roles of the program, which are resolved on the
+    // first run, as the scope is a key of the cache and keeps its variables.
+    std::unordered_map<std::string, ValueBinding> value_bindings_;
   };
 
   bool IsAvailable(bool is_grad) {
@@ -33,6 +33,19 @@ AfsManager* BoxWrapper::afs_manager = nullptr;
 int BoxWrapper::embedx_dim_ = 8;
 int BoxWrapper::expand_embed_dim_ = 0;
 
+void* BoxWrapper::GetDeviceBuffer(const paddle::platform::Place& place,
+                                  DeviceBufferType type,
+                                  size_t bytes) {
+  auto& buffer = device_buffers_.at(place.GetDeviceId())[type];
+  if (buffer == nullptr || buffer->size() < bytes) {
+    size_t size =
+        buffer == nullptr ? bytes : std::max(bytes, buffer->size() * 2);
+    buffer.reset();
+    buffer = memory::Alloc(place, size);
+  }
+  return buffer->ptr();
+}
+
 void BasicAucCalculator::compute() {
   double* table[2] = {&_table[0][0], &_table[1][0]};
 
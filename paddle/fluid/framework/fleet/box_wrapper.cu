@@ -154,19 +154,14 @@ void BoxWrapper::CopyForPull(const paddle::platform::Place& place,
   auto stream = dynamic_cast<phi::GPUContext*>(
                     platform::DeviceContextPool::Instance().Get(place))
                     ->stream();
-  auto buf_value = memory::Alloc(place, values.size() * sizeof(float*));
-  float** gpu_values = reinterpret_cast<float**>(buf_value->ptr());
-#ifdef PADDLE_WITH_HIP
-  hipMemcpy(gpu_values,
-            values.data(),
-            values.size() * sizeof(float*),
-            hipMemcpyHostToDevice);
-#else
-  cudaMemcpy(gpu_values,
-             values.data(),
-             values.size() * sizeof(float*),
-             cudaMemcpyHostToDevice);
-#endif
+  float** gpu_values = reinterpret_cast<float**>(
+      GetDeviceBuffer(place, kPullOutputs, values.size() * sizeof(float*)));
+  memory::Copy(place,
+               gpu_values,
+               platform::CPUPlace(),
+               values.data(),
+               values.size() * sizeof(float*),
+               stream);
 #define EMBEDX_CASE(i, ...)                                                  \
   case i: {                                                                  \
     constexpr size_t EmbedxDim = i;                                          \
@@ -224,6 +219,8 @@ void BoxWrapper::CopyForPull(const paddle::platform::Place& place,
       PADDLE_THROW(platform::errors::InvalidArgument(
           "Unsupport this embedding size [%d]", hidden_size - 3));
   }
+  // The buffers of the device are written again by the next pull of BoxPS,
+  // which is not on this stream.
   cudaStreamSynchronize(stream);
 #undef EXPAND_EMBED_PULL_CASE
 #undef EMBEDX_CASE
@@ -272,43 +269,38 @@ void BoxWrapper::CopyForPush(const paddle::platform::Place& place,
   for (int i = 1; i < slot_lengths_lod.size(); i++) {
     slot_lengths_lod[i] += slot_lengths_lod[i - 1];
   }
-  auto buf_grad_value =
-      memory::Alloc(place, grad_values.size() * sizeof(float*));
-  auto buf_length = memory::Alloc(place, slot_lengths.size() * sizeof(int64_t));
-  auto buf_slot_vector =
-      memory::Alloc(place, slot_lengths_lod.size() * sizeof(int));
-
-  float** gpu_values = reinterpret_cast<float**>(buf_grad_value->ptr());
-  int64_t* gpu_len = reinterpret_cast<int64_t*>(buf_length->ptr());
-  int* d_slot_vector = reinterpret_cast<int*>(buf_slot_vector->ptr());
+  // The grad pointers, the slot offsets and the slots are in a buffer,
+  // copied on the stream instead of synchronizing the device.
+  const size_t values_bytes = grad_values.size() * sizeof(float*);
+  const size_t len_bytes = slot_lengths.size() * sizeof(int64_t);
+  char* buf_grad = reinterpret_cast<char*>(
+      GetDeviceBuffer(place,
+                      kPushGrads,
+                      values_bytes + len_bytes +
+                          slot_lengths_lod.size() * sizeof(int)));
+  float** gpu_values = reinterpret_cast<float**>(buf_grad);
+  int64_t* gpu_len = reinterpret_cast<int64_t*>(buf_grad + values_bytes);
+  int* d_slot_vector =
+      reinterpret_cast<int*>(buf_grad + values_bytes + len_bytes);
 
-#ifdef PADDLE_WITH_HIP
-  hipMemcpy(gpu_values,
-            grad_values.data(),
-            grad_values.size() * sizeof(float*),
-            hipMemcpyHostToDevice);
-  hipMemcpy(gpu_len,
-            slot_lengths_lod.data(),
-            slot_lengths.size() * sizeof(int64_t),
-            hipMemcpyHostToDevice);
-  hipMemcpy(d_slot_vector,
-            slot_vector_.data(),
-            slot_lengths_lod.size() * sizeof(int),
-            hipMemcpyHostToDevice);
-#else
-  cudaMemcpy(gpu_values,
-             grad_values.data(),
-             grad_values.size() * sizeof(float*),
-             cudaMemcpyHostToDevice);
-  cudaMemcpy(gpu_len,
-             slot_lengths_lod.data(),
-             slot_lengths.size() * sizeof(int64_t),
-             cudaMemcpyHostToDevice);
-  cudaMemcpy(d_slot_vector,
-             slot_vector_.data(),
-             slot_lengths_lod.size() * sizeof(int),
-             cudaMemcpyHostToDevice);
-#endif
+  memory::Copy(place,
+               gpu_values,
+               platform::CPUPlace(),
+               grad_values.data(),
+               values_bytes,
+               stream);
+  memory::Copy(place,
+               gpu_len,
+               platform::CPUPlace(),
+               slot_lengths_lod.data(),
+               len_bytes,
+               stream);
+  memory::Copy(place,
+               d_slot_vector,
+               platform::CPUPlace(),
+               slot_vector_.data(),
+               slot_lengths_lod.size() * sizeof(int),
+               stream);
 
 #define EMBEDX_CASE(i, ...)                                                  \
   case i: {                                                                  \
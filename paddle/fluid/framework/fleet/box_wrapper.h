@@ -26,6 +26,7 @@ limitations under the License. */
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <ctime>
 #include <deque>
@@ -42,6 +43,8 @@ limitations under the License. */
 #include "paddle/fluid/framework/data_set.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/memory/memcpy.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #include "paddle/fluid/platform/place.h"
 #include "paddle/fluid/platform/timer.h"
@@ -429,6 +432,25 @@ class BoxWrapper {
 
   void CheckEmbedSizeIsValid(int embedx_dim, int expand_embed_dim);
 
+  // The staging buffers of the pulls and the pushes on a device.
+  enum DeviceBufferType {
+    kPullValues = 0,
+    // the key pointers and the slot offsets of a pull
+    kPullKeys,
+    // the pointers of the output values of a pull
+    kPullOutputs,
+    kPushValues,
+    // the grad pointers, the slot offsets and the slots of a push
+    kPushGrads,
+    kNumDeviceBuffers
+  };
+
+  // The buffer of the type on the device of at least bytes, kept over the
+  // batches and grown by twice, instead of allocated by every call.
+  void* GetDeviceBuffer(const paddle::platform::Place& place,
+                        DeviceBufferType type,
+                        size_t bytes);
+
   boxps::PSAgentBase* GetAgent() { return p_agent_; }
   void InitializeGPUAndLoadModel(
       const char* conf_file,
@@ -457,6 +479,7 @@ class BoxWrapper {
       }
       slot_vector_ = slot_vector;
       keys_tensor.resize(platform::GetGPUDeviceCount());
+      device_buffers_.resize(platform::GetGPUDeviceCount());
     }
   }
 
@@ -926,6 +949,8 @@ class BoxWrapper {
   std::vector<std::string> metric_name_list_;
   std::vector<int> slot_vector_;
   std::vector<phi::DenseTensor> keys_tensor;  // Cache for pull_sparse
+  std::vector<std::array<memory::AllocationPtr, kNumDeviceBuffers>>
+      device_buffers_;
   bool use_afs_api_ = false;
 
  public:
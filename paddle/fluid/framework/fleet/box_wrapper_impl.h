@@ -32,13 +32,6 @@ void BoxWrapper::PullSparseCase(const paddle::platform::Place& place,
 
   int64_t total_length =
       std::accumulate(slot_lengths.begin(), slot_lengths.end(), 0UL);
-  auto buf = memory::Alloc(
-      place,
-      total_length *
-          sizeof(boxps::FeatureValueGpu<EMBEDX_DIM, EXPAND_EMBED_DIM>));
-  boxps::FeatureValueGpu<EMBEDX_DIM, EXPAND_EMBED_DIM>* total_values_gpu =
-      reinterpret_cast<boxps::FeatureValueGpu<EMBEDX_DIM, EXPAND_EMBED_DIM>*>(
-          buf->ptr());
 
   if (platform::is_cpu_place(place)) {
     PADDLE_THROW(platform::errors::Unimplemented(
@@ -47,6 +40,12 @@ void BoxWrapper::PullSparseCase(const paddle::platform::Place& place,
 #if (defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)) && !defined(_WIN32)
     VLOG(3) << "Begin copy keys, key_num[" << total_length << "]";
     int device_id = place.GetDeviceId();
+    auto stream = dynamic_cast<phi::GPUContext*>(
+                      platform::DeviceContextPool::Instance().Get(place))
+                      ->stream();
+    using FeatureValue = boxps::FeatureValueGpu<EMBEDX_DIM, EXPAND_EMBED_DIM>;
+    auto* total_values_gpu = reinterpret_cast<FeatureValue*>(GetDeviceBuffer(
+        place, kPullValues, total_length * sizeof(FeatureValue)));
     phi::DenseTensor& total_keys_tensor = keys_tensor[device_id];
     uint64_t* total_keys = reinterpret_cast<uint64_t*>(
         total_keys_tensor.mutable_data<int64_t>({total_length, 1}, place));
@@ -56,30 +55,21 @@ void BoxWrapper::PullSparseCase(const paddle::platform::Place& place,
     for (size_t i = 1; i < slot_lengths_lod.size(); i++) {
       slot_lengths_lod[i] += slot_lengths_lod[i - 1];
     }
-    auto buf_key = memory::Alloc(place, keys.size() * sizeof(uint64_t*));
-    auto buf_length =
-        memory::Alloc(place, slot_lengths.size() * sizeof(int64_t));
-    uint64_t** gpu_keys = reinterpret_cast<uint64_t**>(buf_key->ptr());
-    int64_t* gpu_len = reinterpret_cast<int64_t*>(buf_length->ptr());
-#ifdef PADDLE_WITH_HIP
-    hipMemcpy(gpu_keys,
-              keys.data(),
-              keys.size() * sizeof(uint64_t*),
-              hipMemcpyHostToDevice);
-    hipMemcpy(gpu_len,
-              slot_lengths_lod.data(),
-              slot_lengths.size() * sizeof(int64_t),
-              hipMemcpyHostToDevice);
-#else
-    cudaMemcpy(gpu_keys,
-               keys.data(),
-               keys.size() * sizeof(uint64_t*),
-               cudaMemcpyHostToDevice);
-    cudaMemcpy(gpu_len,
-               slot_lengths_lod.data(),
-               slot_lengths.size() * sizeof(int64_t),
-               cudaMemcpyHostToDevice);
-#endif
+    // The key pointers and the slot offsets are in a buffer, copied on the
+    // stream instead of synchronizing the device.
+    const size_t keys_bytes = keys.size() * sizeof(uint64_t*);
+    char* buf_key = reinterpret_cast<char*>(GetDeviceBuffer(
+        place, kPullKeys, keys_bytes + slot_lengths.size() * sizeof(int64_t)));
+    uint64_t** gpu_keys = reinterpret_cast<uint64_t**>(buf_key);
+    int64_t* gpu_len = reinterpret_cast<int64_t*>(buf_key + keys_bytes);
+    memory::Copy(
+        place, gpu_keys, platform::CPUPlace(), keys.data(), keys_bytes, stream);
+    memory::Copy(place,
+                 gpu_len,
+                 platform::CPUPlace(),
+                 slot_lengths_lod.data(),
+                 slot_lengths.size() * sizeof(int64_t),
+                 stream);
     this->CopyKeys(place,
                    gpu_keys,
                    total_keys,
@@ -141,20 +131,17 @@ void BoxWrapper::PushSparseGradCase(
   all_timer.Start();
   int64_t total_length =
       std::accumulate(slot_lengths.begin(), slot_lengths.end(), 0UL);
-  auto buf = memory::Alloc(
-      place,
-      total_length *
-          sizeof(boxps::FeaturePushValueGpu<EMBEDX_DIM, EXPAND_EMBED_DIM>));
-  boxps::FeaturePushValueGpu<EMBEDX_DIM, EXPAND_EMBED_DIM>*
-      total_grad_values_gpu = reinterpret_cast<
-          boxps::FeaturePushValueGpu<EMBEDX_DIM, EXPAND_EMBED_DIM>*>(
-          buf->ptr());
   if (platform::is_cpu_place(place)) {
     PADDLE_THROW(platform::errors::Unimplemented(
         "Warning:: CPUPlace is not supported in PaddleBox now."));
   } else if (platform::is_gpu_place(place)) {
 #if (defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)) && !defined(_WIN32)
     int device_id = place.GetDeviceId();
+    using FeaturePushValue =
+        boxps::FeaturePushValueGpu<EMBEDX_DIM, EXPAND_EMBED_DIM>;
+    auto* total_grad_values_gpu =
+        reinterpret_cast<FeaturePushValue*>(GetDeviceBuffer(
+            place, kPushValues, total_length * sizeof(FeaturePushValue)));
     phi::DenseTensor& cached_total_keys_tensor = keys_tensor[device_id];
     uint64_t* total_keys =
         reinterpret_cast<uint64_t*>(cached_total_keys_tensor.data<int64_t>());
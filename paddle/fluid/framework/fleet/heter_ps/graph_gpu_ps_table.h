@@ -19,6 +19,7 @@
 
 #include "paddle/fluid/distributed/ps/table/common_graph_table.h"
 #include "paddle/fluid/framework/fleet/heter_ps/gpu_graph_node.h"
+#include "paddle/fluid/framework/fleet/heter_ps/graph_neighbor_cache.h"
 #include "paddle/fluid/framework/fleet/heter_ps/heter_comm.h"
 #include "paddle/fluid/framework/fleet/heter_ps/heter_comm_kernel.h"
 #include "paddle/fluid/framework/fleet/ps_gpu_wrapper.h"
@@ -28,6 +29,8 @@
 
 PHI_DECLARE_double(gpugraph_hbm_table_load_factor);
 PHI_DECLARE_bool(multi_node_sample_use_gpu_table);
+PHI_DECLARE_int64(gpugraph_neighbor_cache_size);
+PHI_DECLARE_int32(gpugraph_neighbor_cache_refill_num);
 
 namespace paddle {
 namespace framework {
@@ -107,8 +110,20 @@ class GpuPsGraphTable
     for (int i = 0; i < gpu_num; i++) {
       device_mutex_[i] = new std::mutex();
     }
+    if (FLAGS_gpugraph_neighbor_cache_size > 0) {
+      for (int i = 0; i < gpu_num * graph_table_num_; i++) {
+        neighbor_caches_.emplace_back(new GpuNeighborCache(
+            FLAGS_gpugraph_neighbor_cache_size));
+      }
+      neighbor_cache_pool_.reset(new ::ThreadPool(1));
+    }
   }
   ~GpuPsGraphTable() {
+    // wait for the refills
+    neighbor_cache_pool_.reset();
+    for (int i = 0; i < static_cast<int>(neighbor_caches_.size()); ++i) {
+      clear_neighbor_cache(i / graph_table_num_, i % graph_table_num_);
+    }
     for (size_t i = 0; i < device_mutex_.size(); ++i) {
       delete device_mutex_[i];
     }
@@ -325,6 +340,23 @@ class GpuPsGraphTable
                                                bool return_weight);
   int init_cpu_table(const paddle::distributed::GraphParameter &graph,
                      int gpu_num = 8);
+  // Sample the neighbors of the num cpu keys (d_cpu_keys, at d_cpu_index of
+  // the query) from the neighbor cache, the results of the hits are filled
+  // into val and actual_sample_size.
+  void sample_from_neighbor_cache(int gpu_id,
+                                  int idx,
+                                  const uint64_t *d_cpu_keys,
+                                  const int *d_cpu_index,
+                                  int num,
+                                  int sample_size,
+                                  int neighbor_size_limit,
+                                  uint64_t *val,
+                                  int *actual_sample_size,
+                                  cudaStream_t stream);
+  void refill_neighbor_cache(int gpu_id, int idx, int neighbor_size_limit);
+  void clear_neighbor_cache(int gpu_id, int idx);
+  // Log the hit rates of the neighbor caches of the pass, and reset them.
+  void report_neighbor_cache_stat();
   gpuStream_t get_local_stream(int gpu_id) {
     return resource_->local_stream(gpu_id, 0);
   }
@@ -360,6 +392,29 @@ class GpuPsGraphTable
   bool infer_mode_ = false;
   using RankTable = HashTable<uint64_t, uint32_t>;
   std::vector<RankTable *> rank_tables_;
+
+  // The neighbors of the hot nodes on cpu, resident on a gpu for an edge
+  // type. It is rebuilt by the refills from cpu_graph_table_ while the
+  // sampling continues, and swapped in under mutex.
+  struct GpuNeighborCache {
+    explicit GpuNeighborCache(size_t capacity)
+        : policy(capacity), capacity(capacity) {}
+    // guards table and graph, it is held while sampling with them
+    std::mutex mutex;
+    // key -> GpuPsNodeInfo in graph
+    Table *table = nullptr;
+    // only neighbor_list and neighbor_size are used
+    GpuPsCommGraph graph;
+    // the neighbors of a node are cached up to the limit of the refill
+    int neighbor_size_limit = 0;
+    NeighborCachePolicy policy;
+    NeighborCacheStat stat;
+    size_t capacity;
+    std::atomic<bool> refilling{false};
+  };
+  // indexed by get_graph_list_offset
+  std::vector<std::unique_ptr<GpuNeighborCache>> neighbor_caches_;
+  std::shared_ptr<::ThreadPool> neighbor_cache_pool_;
 };
 
 };  // namespace framework
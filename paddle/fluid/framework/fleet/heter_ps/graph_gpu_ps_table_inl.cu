@@ -61,6 +61,27 @@ __global__ void get_cpu_id_index(uint64_t* key,
   }
 }
 
+// Fill the samples of the cpu keys hit in the neighbor cache to the final
+// place, the misses are -1 in cache_actual_size.
+__global__ void fill_cached_neighbor_result(const uint64_t* cache_val,
+                                            const int* cache_actual_size,
+                                            const int* index,
+                                            uint64_t* val,
+                                            int* actual_sample_size,
+                                            int n,
+                                            int sample_size) {
+  CUDA_KERNEL_LOOP(i, n) {
+    int size = cache_actual_size[i];
+    if (size != -1) {
+      int pos = index[i];
+      actual_sample_size[pos] = size;
+      for (int j = 0; j < size; j++) {
+        val[pos * sample_size + j] = cache_val[i * sample_size + j];
+      }
+    }
+  }
+}
+
 __global__ void get_actual_gpu_ac(int* gpu_ac, int number_on_cpu) {
   CUDA_KERNEL_LOOP(i, number_on_cpu) { gpu_ac[i] /= sizeof(uint64_t); }
 }
@@ -1592,6 +1613,7 @@ void GpuPsGraphTable::reset_rank_info(int gpu_id,
 
 void GpuPsGraphTable::clear_graph_info(int gpu_id, int idx) {
   if (idx >= graph_table_num_) return;
+  clear_neighbor_cache(gpu_id, idx);
   platform::CUDADeviceGuard guard(resource_->dev_id(gpu_id));
   int offset = get_table_offset(gpu_id, GraphTableType::EDGE_TABLE, idx);
   if (offset < tables_.size()) {
@@ -1611,6 +1633,206 @@ void GpuPsGraphTable::clear_graph_info(int gpu_id, int idx) {
 void GpuPsGraphTable::clear_graph_info(int idx) {
   for (int i = 0; i < gpu_num; i++) clear_graph_info(i, idx);
 }
+
+void GpuPsGraphTable::sample_from_neighbor_cache(int gpu_id,
+                                                 int idx,
+                                                 const uint64_t* d_cpu_keys,
+                                                 const int* d_cpu_index,
+                                                 int num,
+                                                 int sample_size,
+                                                 int neighbor_size_limit,
+                                                 uint64_t* val,
+                                                 int* actual_sample_size,
+                                                 cudaStream_t stream) {
+  auto& cache = *neighbor_caches_[get_graph_list_offset(gpu_id, idx)];
+  platform::CUDAPlace place = platform::CUDAPlace(resource_->dev_id(gpu_id));
+  platform::CUDADeviceGuard guard(resource_->dev_id(gpu_id));
+
+  // the hot nodes are counted by all the queries of the cpu keys
+  std::vector<uint64_t> h_cpu_keys(num);
+  CUDA_CHECK(cudaMemcpyAsync(h_cpu_keys.data(),
+                             d_cpu_keys,
+                             num * sizeof(uint64_t),
+                             cudaMemcpyDeviceToHost,
+                             stream));
+  CUDA_CHECK(cudaStreamSynchronize(stream));
+  cache.policy.Record(h_cpu_keys.data(), num);
+
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    // the cached neighbors are cut by the limit of the refill
+    if (cache.table != nullptr &&
+        neighbor_size_limit <= cache.neighbor_size_limit) {
+      auto d_node_info =
+          memory::Alloc(place,
+                        num * sizeof(GpuPsNodeInfo),
+                        phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
+      auto d_cache_val =
+          memory::Alloc(place,
+                        num * sample_size * sizeof(uint64_t),
+                        phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
+      auto d_cache_actual_size =
+          memory::Alloc(place,
+                        num * sizeof(int),
+                        phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
+      GpuPsNodeInfo* node_info_list =
+          reinterpret_cast<GpuPsNodeInfo*>(d_node_info->ptr());
+      uint64_t* cache_val = reinterpret_cast<uint64_t*>(d_cache_val->ptr());
+      int* cache_actual_size =
+          reinterpret_cast<int*>(d_cache_actual_size->ptr());
+      // the misses have neighbor_size 0, and are sampled as -1
+      CUDA_CHECK(cudaMemsetAsync(
+          node_info_list, 0, num * sizeof(GpuPsNodeInfo), stream));
+      cache.table->get(d_cpu_keys,
+                       reinterpret_cast<uint64_t*>(node_info_list),
+                       static_cast<size_t>(num),
+                       stream);
+
+      constexpr int WARP_SIZE = 32;
+      constexpr int BLOCK_WARPS = 128 / WARP_SIZE;
+      constexpr int TILE_SIZE = BLOCK_WARPS * 16;
+      const dim3 block(WARP_SIZE, BLOCK_WARPS);
+      const dim3 grid((num + TILE_SIZE - 1) / TILE_SIZE);
+      neighbor_sample_kernel_walking<WARP_SIZE, BLOCK_WARPS, TILE_SIZE>
+          <<<grid, block, 0, stream>>>(cache.graph,
+                                       node_info_list,
+                                       cache_actual_size,
+                                       cache_val,
+                                       sample_size,
+                                       num,
+                                       neighbor_size_limit,
+                                       -1);
+      int grid_size = (num - 1) / block_size_ + 1;
+      fill_cached_neighbor_result<<<grid_size, block_size_, 0, stream>>>(
+          cache_val,
+          cache_actual_size,
+          d_cpu_index,
+          val,
+          actual_sample_size,
+          num,
+          sample_size);
+      CUDA_CHECK(cudaStreamSynchronize(stream));
+    }
+  }
+
+  if (cache.policy.RecordedNum() >=
+          static_cast<size_t>(FLAGS_gpugraph_neighbor_cache_refill_num) &&
+      !cache.refilling.exchange(true)) {
+    neighbor_cache_pool_->enqueue([this, gpu_id, idx, neighbor_size_limit]() {
+      refill_neighbor_cache(gpu_id, idx, neighbor_size_limit);
+    });
+  }
+}
+
+void GpuPsGraphTable::refill_neighbor_cache(int gpu_id,
+                                            int idx,
+                                            int neighbor_size_limit) {
+  auto& cache = *neighbor_caches_[get_graph_list_offset(gpu_id, idx)];
+  auto degree_fn = [this, idx, neighbor_size_limit](uint64_t key) -> size_t {
+    auto node =
+        cpu_graph_table_->find_node(GraphTableType::EDGE_TABLE, idx, key);
+    if (node == nullptr) {
+      return 0;
+    }
+    return std::min(node->get_neighbor_size(),
+                    static_cast<size_t>(neighbor_size_limit));
+  };
+  std::vector<uint64_t> keys = cache.policy.Select(cache.capacity, degree_fn);
+
+  // the neighbors within the limit are cached, which are all that
+  // neighbor_sample_kernel_walking samples from
+  std::vector<GpuPsNodeInfo> node_info_list(keys.size());
+  std::vector<uint64_t> neighbor_list;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    auto node =
+        cpu_graph_table_->find_node(GraphTableType::EDGE_TABLE, idx, keys[i]);
+    size_t degree = std::min(node->get_neighbor_size(),
+                             static_cast<size_t>(neighbor_size_limit));
+    node_info_list[i].neighbor_offset = neighbor_list.size();
+    node_info_list[i].neighbor_size = degree;
+    for (size_t j = 0; j < degree; ++j) {
+      neighbor_list.push_back(node->get_neighbor_id(j));
+    }
+  }
+
+  Table* table = nullptr;
+  GpuPsCommGraph graph;
+  if (!keys.empty()) {
+    platform::CUDAPlace place = platform::CUDAPlace(resource_->dev_id(gpu_id));
+    platform::CUDADeviceGuard guard(resource_->dev_id(gpu_id));
+    // a stream of the refill, not to block the sampling
+    cudaStream_t stream;
+    CUDA_CHECK(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+    auto d_keys = memory::Alloc(place, keys.size() * sizeof(uint64_t));
+    auto d_vals = memory::Alloc(place, keys.size() * sizeof(GpuPsNodeInfo));
+    CUDA_CHECK(cudaMemcpyAsync(d_keys->ptr(),
+                               keys.data(),
+                               keys.size() * sizeof(uint64_t),
+                               cudaMemcpyHostToDevice,
+                               stream));
+    CUDA_CHECK(cudaMemcpyAsync(d_vals->ptr(),
+                               node_info_list.data(),
+                               keys.size() * sizeof(GpuPsNodeInfo),
+                               cudaMemcpyHostToDevice,
+                               stream));
+    table = new Table(keys.size() / load_factor_ + 1, stream);
+    table->insert(reinterpret_cast<const uint64_t*>(d_keys->ptr()),
+                  reinterpret_cast<const uint64_t*>(d_vals->ptr()),
+                  keys.size(),
+                  stream);
+    CUDA_CHECK(cudaMalloc(&graph.neighbor_list,
+                          neighbor_list.size() * sizeof(uint64_t)));
+    CUDA_CHECK(cudaMemcpyAsync(graph.neighbor_list,
+                               neighbor_list.data(),
+                               neighbor_list.size() * sizeof(uint64_t),
+                               cudaMemcpyHostToDevice,
+                               stream));
+    graph.neighbor_size = neighbor_list.size();
+    CUDA_CHECK(cudaStreamSynchronize(stream));
+    CUDA_CHECK(cudaStreamDestroy(stream));
+  }
+
+  clear_neighbor_cache(gpu_id, idx);
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.table = table;
+    cache.graph = graph;
+    cache.neighbor_size_limit = neighbor_size_limit;
+  }
+  VLOG(1) << "refill neighbor cache of gpu " << gpu_id << " edge " << idx
+          << ", node_size " << keys.size() << ", neighbor_size "
+          << neighbor_list.size();
+  cache.refilling = false;
+}
+
+void GpuPsGraphTable::clear_neighbor_cache(int gpu_id, int idx) {
+  if (neighbor_caches_.empty()) {
+    return;
+  }
+  auto& cache = *neighbor_caches_[get_graph_list_offset(gpu_id, idx)];
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  platform::CUDADeviceGuard guard(resource_->dev_id(gpu_id));
+  if (cache.table != nullptr) {
+    delete cache.table;
+    cache.table = nullptr;
+  }
+  if (cache.graph.neighbor_list != nullptr) {
+    cudaFree(cache.graph.neighbor_list);
+  }
+  cache.graph = GpuPsCommGraph();
+}
+
+void GpuPsGraphTable::report_neighbor_cache_stat() {
+  for (size_t i = 0; i < neighbor_caches_.size(); ++i) {
+    auto& stat = neighbor_caches_[i]->stat;
+    if (stat.query_num > 0) {
+      VLOG(0) << "neighbor cache of gpu " << i / graph_table_num_ << " edge "
+              << i % graph_table_num_ << ", query " << stat.query_num
+              << ", hit " << stat.hit_num << ", hit rate " << stat.HitRate();
+    }
+    stat.Reset();
+  }
+}
 /*
 the parameter std::vector<GpuPsCommGraph> cpu_graph_list is generated by cpu.
 it saves the graph to be saved on each gpu.
@@ -2443,6 +2665,39 @@ NeighborSampleResult GpuPsGraphTable::graph_neighbor_sample_v2(
                           thrust::raw_pointer_cast(t_index.data()),
                           sizeof(int),
                           cudaMemcpyDeviceToHost));
+    // the weighted samples need the weights, which are not cached
+    if (number_on_cpu > 0 && !neighbor_caches_.empty() && !weighted) {
+      int query_num = number_on_cpu;
+      sample_from_neighbor_cache(
+          gpu_id,
+          idx,
+          thrust::raw_pointer_cast(t_cpu_keys.data()),
+          thrust::raw_pointer_cast(t_index.data()) + 1,
+          number_on_cpu,
+          sample_size,
+          neighbor_size_limit,
+          val,
+          actual_sample_size,
+          stream);
+      // the misses of the cache are sampled on cpu
+      CUDA_CHECK(cudaMemsetAsync(
+          thrust::raw_pointer_cast(t_index.data()), 0, sizeof(int), stream));
+      get_cpu_id_index<<<grid_size, block_size_, 0, stream>>>(
+          key,
+          actual_sample_size,
+          thrust::raw_pointer_cast(t_cpu_keys.data()),
+          thrust::raw_pointer_cast(t_index.data()),
+          thrust::raw_pointer_cast(t_index.data()) + 1,
+          len);
+      CUDA_CHECK(cudaMemcpyAsync(&number_on_cpu,
+                                 thrust::raw_pointer_cast(t_index.data()),
+                                 sizeof(int),
+                                 cudaMemcpyDeviceToHost,
+                                 stream));
+      CUDA_CHECK(cudaStreamSynchronize(stream));
+      neighbor_caches_[get_graph_list_offset(gpu_id, idx)]->stat.Add(
+          query_num, query_num - number_on_cpu);
+    }
     if (number_on_cpu > 0) {
       uint64_t* cpu_keys = new uint64_t[number_on_cpu];
       CUDA_CHECK(cudaMemcpy(cpu_keys,
@@ -1098,6 +1098,11 @@ NeighborSampleResult GraphGpuWrapper::graph_neighbor_sample_v3(
       ->graph_neighbor_sample_v3(q, cpu_switch, compress, weighted);
 }
 
+void GraphGpuWrapper::report_neighbor_cache_stat() {
+  reinterpret_cast<GpuPsGraphTable *>(graph_table)
+      ->report_neighbor_cache_stat();
+}
+
 NeighborSampleResultV2 GraphGpuWrapper::graph_neighbor_sample_sage(
     int gpu_id,
     int edge_type_len,
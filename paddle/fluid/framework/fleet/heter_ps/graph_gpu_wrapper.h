@@ -158,6 +158,9 @@ class GraphGpuWrapper {
                                                 bool cpu_switch,
                                                 bool compress,
                                                 bool weighted);
+  // Log the hit rates of the gpu neighbor caches of the cpu nodes in the
+  // pass, see FLAGS_gpugraph_neighbor_cache_size.
+  void report_neighbor_cache_stat();
   void seek_keys_rank(int gpu_id,
                       const uint64_t* d_in_keys,
                       int len,
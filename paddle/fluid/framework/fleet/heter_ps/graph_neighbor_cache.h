@@ -0,0 +1,143 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace paddle {
+namespace framework {
+
+// The hit stat of a gpu neighbor cache, it is reset at the end of a pass.
+struct NeighborCacheStat {
+  std::atomic<uint64_t> query_num{0};
+  std::atomic<uint64_t> hit_num{0};
+
+  void Add(uint64_t query, uint64_t hit) {
+    query_num += query;
+    hit_num += hit;
+  }
+  double HitRate() const {
+    uint64_t query = query_num;
+    return query == 0 ? 0.0 : static_cast<double>(hit_num) / query;
+  }
+  void Reset() {
+    query_num = 0;
+    hit_num = 0;
+  }
+};
+
+// NeighborCachePolicy selects the nodes on cpu whose neighbors are resident in
+// the gpu neighbor cache. The queries of the nodes not in the gpu graph are
+// counted, and the nodes are selected by the queries per cached neighbor, so
+// that the cache of a fixed number of neighbors gets the most hits. The
+// counts are halved at every selection, so the cache follows the hot nodes of
+// the recent batches.
+class NeighborCachePolicy {
+ public:
+  explicit NeighborCachePolicy(size_t max_tracked_num)
+      : max_tracked_num_(std::max(max_tracked_num, static_cast<size_t>(1))) {}
+
+  // Count the queries of keys, thread safe.
+  void Record(const uint64_t* keys, size_t num) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < num; ++i) {
+      counts_[keys[i]] += 1;
+    }
+    recorded_num_ += num;
+    if (counts_.size() > 2 * max_tracked_num_) {
+      Prune();
+    }
+  }
+
+  // The number of queries recorded since the last selection.
+  size_t RecordedNum() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return recorded_num_;
+  }
+
+  // Select the keys to cache in capacity neighbors. degree_fn(key) returns the
+  // number of neighbors to cache of key, 0 if the key has no neighbors.
+  template <typename DegreeFn>
+  std::vector<uint64_t> Select(size_t capacity, DegreeFn degree_fn) {
+    std::vector<std::pair<uint64_t, float>> counts;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      counts.assign(counts_.begin(), counts_.end());
+      for (auto& item : counts_) {
+        item.second /= 2;
+      }
+      recorded_num_ = 0;
+    }
+    // (score, key, degree)
+    std::vector<std::pair<float, std::pair<uint64_t, size_t>>> candidates;
+    candidates.reserve(counts.size());
+    for (auto& item : counts) {
+      size_t degree = degree_fn(item.first);
+      if (degree == 0) {
+        continue;
+      }
+      candidates.push_back({item.second / degree, {item.first, degree}});
+    }
+    std::sort(candidates.begin(),
+              candidates.end(),
+              [](const auto& a, const auto& b) { return a.first > b.first; });
+    std::vector<uint64_t> keys;
+    size_t used = 0;
+    for (auto& item : candidates) {
+      size_t degree = item.second.second;
+      if (used + degree > capacity) {
+        continue;
+      }
+      used += degree;
+      keys.push_back(item.second.first);
+    }
+    return keys;
+  }
+
+ private:
+  // Keep the max_tracked_num_ keys of the highest counts.
+  void Prune() {
+    std::vector<float> counts;
+    counts.reserve(counts_.size());
+    for (auto& item : counts_) {
+      counts.push_back(item.second);
+    }
+    std::nth_element(counts.begin(),
+                     counts.begin() + max_tracked_num_,
+                     counts.end(),
+                     [](float a, float b) { return a > b; });
+    float threshold = counts[max_tracked_num_];
+    for (auto it = counts_.begin(); it != counts_.end();) {
+      if (it->second <= threshold) {
+        it = counts_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  size_t max_tracked_num_;
+  mutable std::mutex mutex_;
+  std::unordered_map<uint64_t, float> counts_;
+  size_t recorded_num_{0};
+};
+
+}  // namespace framework
+}  // namespace paddle
@@ -194,6 +194,10 @@ class HeterComm {
 
   void end_pass();
 #if defined(PADDLE_WITH_CUDA)
+  // Replicate the pull values of h_keys on every device, the keys must be in
+  // the tables built. The single node pulls of the keys are served by the
+  // local replicas, which are refreshed from the owners periodically.
+  void set_hot_keys(const std::vector<KeyType>& h_keys);
   // dedup
   int dedup_keys_and_fillidx(const int gpu_id,
                              const int total_fea_num,
@@ -513,6 +517,20 @@ class HeterComm {
                           KeyType* d_keys,
                           float* d_vals,
                           size_t len);
+#if defined(PADDLE_WITH_CUDA)
+  bool has_hot_replica(const int gpu_id) const {
+    return static_cast<size_t>(gpu_id) < hot_replicas_.size() &&
+           hot_replicas_[gpu_id].size > 0;
+  }
+  void pull_hot_replica_sparse(const int gpu_id,
+                               KeyType* d_keys,
+                               float* d_vals,
+                               size_t len);
+#endif
+  void pull_local_sparse(const int gpu_id,
+                         KeyType* d_keys,
+                         float* d_vals,
+                         size_t len);
   void pull_one_table(const int gpu_id,
                       KeyType* d_keys,
                       float* d_vals,
@@ -790,6 +808,18 @@ class HeterComm {
   float max_grad_bound_ = 10.0;
 
 #if defined(PADDLE_WITH_CUDA)
+  // the pull values of the hot keys replicated on a device
+  struct HotKeyReplica {
+    std::shared_ptr<HashTable<KeyType, uint32_t>> index;
+    std::shared_ptr<memory::Allocation> keys;
+    std::shared_ptr<memory::Allocation> vals;
+    size_t size = 0;
+    // a hot key pulled in place of the hot keys, so that the keys pulled
+    // from the owners are all in the tables
+    KeyType anchor_key = 0;
+    size_t pull_count = 0;
+  };
+  std::vector<HotKeyReplica> hot_replicas_;
   GpuRDMAChecker* rdma_checker_ = nullptr;
   std::vector<ncclComm_t> nccl_inner_comms_;
   std::vector<ncclComm_t> nccl_inter_comms_;
@@ -15,6 +15,7 @@ limitations under the License. */
 #ifdef PADDLE_WITH_HETERPS
 #include <algorithm>
 #include <memory>
+#include <numeric>
 #include <queue>
 #include <utility>
 #include <vector>
@@ -36,6 +37,7 @@ PHI_DECLARE_bool(enable_tracker_all2all);
 PHI_DECLARE_bool(enable_all2all_use_fp16);
 PHI_DECLARE_bool(enable_sparse_inner_gather);
 PHI_DECLARE_bool(graph_embedding_split_infer_mode);
+PHI_DECLARE_int32(gpups_hot_key_refresh_interval);
 
 namespace paddle {
 namespace framework {
@@ -236,8 +238,20 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::init_path() {
         int to = resource_->dev_id(j);
 
         int transfer_id = i;
+        int relay_devid = -1;
+#if defined(PADDLE_WITH_CUDA)
+        if (rdma_checker_->has_route()) {
+          relay_devid = rdma_checker_->relay_devid(from, to);
+        } else if (need_transfer(from, to)) {
+          relay_devid = get_transfer_devid(from);
+        }
+#else
         if (need_transfer(from, to)) {
-          transfer_id = resource_->get_index_by_devid(get_transfer_devid(from));
+          relay_devid = get_transfer_devid(from);
+        }
+#endif
+        if (relay_devid >= 0) {
+          transfer_id = resource_->get_index_by_devid(relay_devid);
           nodes.push_back(Node());
           Node &node = nodes.back();
           node.in_stream = resource_->remote_stream(i, transfer_id);
@@ -315,6 +329,12 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::reset_table(
     table->set_mode(infer_mode);
   }
   is_infer_mode_ = infer_mode;
+#if defined(PADDLE_WITH_CUDA)
+  // the replicas are of the last tables
+  if (static_cast<size_t>(dev_id) < hot_replicas_.size()) {
+    hot_replicas_[dev_id] = HotKeyReplica();
+  }
+#endif
 }
 template <typename KeyType,
           typename ValType,
@@ -1822,14 +1842,137 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::pull_sparse(
       pull_sparse_all2all(num, d_keys, d_vals, len);
     }
   } else {
-    if (!FLAGS_gpugraph_dedup_pull_push_mode) {
-      pull_merge_sparse(num, d_keys, d_vals, len);
-    } else {
-      pull_normal_sparse(num, d_keys, d_vals, len);
+#if defined(PADDLE_WITH_CUDA)
+    if (has_hot_replica(num)) {
+      pull_hot_replica_sparse(num, d_keys, d_vals, len);
+      return;
+    }
+#endif
+    pull_local_sparse(num, d_keys, d_vals, len);
+  }
+}
+
+template <typename KeyType,
+          typename ValType,
+          typename GradType,
+          typename GPUAccessor>
+void HeterComm<KeyType, ValType, GradType, GPUAccessor>::pull_local_sparse(
+    const int num, KeyType *d_keys, float *d_vals, size_t len) {
+  if (!FLAGS_gpugraph_dedup_pull_push_mode) {
+    pull_merge_sparse(num, d_keys, d_vals, len);
+  } else {
+    pull_normal_sparse(num, d_keys, d_vals, len);
+  }
+}
+
+#if defined(PADDLE_WITH_CUDA)
+template <typename KeyType,
+          typename ValType,
+          typename GradType,
+          typename GPUAccessor>
+void HeterComm<KeyType, ValType, GradType, GPUAccessor>::set_hot_keys(
+    const std::vector<KeyType> &h_keys) {
+  int total_device = resource_->total_device();
+  hot_replicas_.resize(total_device);
+  size_t len = h_keys.size();
+  if (len == 0) {
+    for (auto &replica : hot_replicas_) {
+      replica = HotKeyReplica();
     }
+    return;
   }
+  auto accessor_wrapper_ptr =
+      GlobalAccessorFactory::GetInstance().GetAccessorWrapper();
+  size_t val_type_size = accessor_wrapper_ptr->GetPullValueSize(max_mf_dim_);
+  std::vector<uint32_t> h_idx(len);
+  std::iota(h_idx.begin(), h_idx.end(), 0);
+  for (int i = 0; i < total_device; ++i) {
+    int dev_id = resource_->dev_id(i);
+    DevPlace place = DevPlace(dev_id);
+    AnyDeviceGuard guard(dev_id);
+    auto stream = resource_->local_stream(i, 0);
+    auto &replica = hot_replicas_[i];
+    replica.keys = MemoryAlloc(place, len * sizeof(KeyType));
+    replica.vals = MemoryAlloc(place, len * val_type_size);
+    auto d_idx = MemoryAlloc(place, len * sizeof(uint32_t));
+    KeyType *d_keys_ptr = reinterpret_cast<KeyType *>(replica.keys->ptr());
+    uint32_t *d_idx_ptr = reinterpret_cast<uint32_t *>(d_idx->ptr());
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(d_keys_ptr,
+                                               h_keys.data(),
+                                               len * sizeof(KeyType),
+                                               cudaMemcpyHostToDevice,
+                                               stream));
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(d_idx_ptr,
+                                               h_idx.data(),
+                                               len * sizeof(uint32_t),
+                                               cudaMemcpyHostToDevice,
+                                               stream));
+    replica.index = std::make_shared<HashTable<KeyType, uint32_t>>(
+        len / load_factor_ + 1, stream);
+    replica.index->insert(d_keys_ptr, d_idx_ptr, len, stream);
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
+    replica.size = len;
+    replica.anchor_key = h_keys[0];
+    // the values are pulled at the first pull
+    replica.pull_count = 0;
+  }
+  VLOG(0) << "set hot keys: " << len << " replicated on " << total_device
+          << " devices";
 }
 
+template <typename KeyType,
+          typename ValType,
+          typename GradType,
+          typename GPUAccessor>
+void HeterComm<KeyType, ValType, GradType, GPUAccessor>::
+    pull_hot_replica_sparse(const int num,
+                            KeyType *d_keys,
+                            float *d_vals,
+                            size_t len) {
+  auto &replica = hot_replicas_[num];
+  int dev_id = resource_->dev_id(num);
+  DevPlace place = DevPlace(dev_id);
+  AnyDeviceGuard guard(dev_id);
+  auto stream = resource_->local_stream(num, 0);
+  auto accessor_wrapper_ptr =
+      GlobalAccessorFactory::GetInstance().GetAccessorWrapper();
+  size_t val_type_size = accessor_wrapper_ptr->GetPullValueSize(max_mf_dim_);
+  KeyType *d_replica_keys = reinterpret_cast<KeyType *>(replica.keys->ptr());
+  float *d_replica_vals = reinterpret_cast<float *>(replica.vals->ptr());
+
+  // the pushes of the hot keys update the owners, the replica is refreshed
+  // from them every interval pulls
+  size_t interval = std::max(FLAGS_gpups_hot_key_refresh_interval, 1);
+  if (replica.pull_count++ % interval == 0) {
+    pull_local_sparse(num, d_replica_keys, d_replica_vals, replica.size);
+  }
+
+  auto d_hot_idx = MemoryAlloc(place, len * sizeof(uint32_t));
+  uint32_t *d_hot_idx_ptr = reinterpret_cast<uint32_t *>(d_hot_idx->ptr());
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMemsetAsync(d_hot_idx_ptr, 0xff, len * sizeof(uint32_t), stream));
+  replica.index->get(d_keys, d_hot_idx_ptr, len, stream);
+
+  // the hot keys are pulled as the anchor key, which is merged into one key
+  auto d_cold_keys = MemoryAlloc(place, len * sizeof(KeyType));
+  KeyType *d_cold_keys_ptr = reinterpret_cast<KeyType *>(d_cold_keys->ptr());
+  heter_comm_kernel_->mask_hot_keys(d_keys,
+                                    d_hot_idx_ptr,
+                                    replica.anchor_key,
+                                    d_cold_keys_ptr,
+                                    static_cast<int64_t>(len),
+                                    stream);
+  pull_local_sparse(num, d_cold_keys_ptr, d_vals, len);
+  heter_comm_kernel_->fill_hot_vals(d_hot_idx_ptr,
+                                    d_replica_vals,
+                                    d_vals,
+                                    static_cast<int64_t>(len),
+                                    val_type_size,
+                                    stream);
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
+}
+#endif
+
 #if defined(PADDLE_WITH_CUDA)
 template <typename KeyType,
           typename ValType,
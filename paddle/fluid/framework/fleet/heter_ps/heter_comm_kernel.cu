@@ -288,6 +288,33 @@ __global__ void unpack_merged_vals_kernel(const KeyType* d_keys,
   }
 }
 
+template <typename KeyType>
+__global__ void mask_hot_keys_kernel(const KeyType* d_keys,
+                                     const uint32_t* d_hot_idx,
+                                     const KeyType anchor_key,
+                                     KeyType* d_out_keys,
+                                     size_t len) {
+  const size_t i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i < len) {
+    d_out_keys[i] = (d_hot_idx[i] == UINT32_MAX) ? d_keys[i] : anchor_key;
+  }
+}
+
+__global__ void fill_hot_vals_kernel(const uint32_t* d_hot_idx,
+                                     const float* d_replica_vals,
+                                     float* d_vals,
+                                     size_t len,
+                                     const size_t val_size_unit) {
+  const size_t i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i < len) {
+    uint32_t idx = d_hot_idx[i / val_size_unit];
+    if (idx != UINT32_MAX) {
+      d_vals[i] = d_replica_vals[uint64_t(idx) * val_size_unit +
+                                 (i % val_size_unit)];
+    }
+  }
+}
+
 template <typename TUnit, typename T>
 __global__ void gather_keys_kernel(TUnit* d_dest_vals,
                                    const TUnit* d_src_vals,
@@ -773,6 +800,32 @@ void HeterCommKernel::scatter_vals(const ValType* d_shard_vals,
       d_vals, d_shard_vals, idx, N, val_size_unit);
 }
 
+template <typename KeyType, typename StreamType>
+void HeterCommKernel::mask_hot_keys(const KeyType* d_keys,
+                                    const uint32_t* d_hot_idx,
+                                    const KeyType anchor_key,
+                                    KeyType* d_out_keys,
+                                    int64_t len,
+                                    const StreamType& stream) {
+  size_t N = len;
+  int grid_size = (N - 1) / block_size_ + 1;
+  mask_hot_keys_kernel<<<grid_size, block_size_, 0, stream>>>(
+      d_keys, d_hot_idx, anchor_key, d_out_keys, N);
+}
+template <typename StreamType>
+void HeterCommKernel::fill_hot_vals(const uint32_t* d_hot_idx,
+                                    const float* d_replica_vals,
+                                    float* d_vals,
+                                    int64_t len,
+                                    size_t value_bytes,
+                                    const StreamType& stream) {
+  const size_t val_size_unit = size_t(value_bytes / sizeof(float));
+  size_t N = len * val_size_unit;
+  const int grid_size = (N - 1) / block_size_ + 1;
+  fill_hot_vals_kernel<<<grid_size, block_size_, 0, stream>>>(
+      d_hot_idx, d_replica_vals, d_vals, N, val_size_unit);
+}
+
 template <typename KeyType>
 __global__ void check_valid_values_kernel(const int type,
                                           const size_t N,
@@ -1485,6 +1538,20 @@ template void HeterCommKernel::scatter_vals<uint8_t, cudaStream_t>(
     int64_t len,
     size_t value_bytes,
     const cudaStream_t& stream);
+template void HeterCommKernel::mask_hot_keys<uint64_t, cudaStream_t>(
+    const uint64_t* d_keys,
+    const uint32_t* d_hot_idx,
+    const uint64_t anchor_key,
+    uint64_t* d_out_keys,
+    int64_t len,
+    const cudaStream_t& stream);
+template void HeterCommKernel::fill_hot_vals<cudaStream_t>(
+    const uint32_t* d_hot_idx,
+    const float* d_replica_vals,
+    float* d_vals,
+    int64_t len,
+    size_t value_bytes,
+    const cudaStream_t& stream);
 template void HeterCommKernel::check_valid_values<int32_t, cudaStream_t>(
     const int& type,
     const size_t& N,
@@ -299,6 +299,22 @@ class HeterCommKernel {
                     int64_t len,
                     size_t value_bytes,
                     const StreamType& stream);
+  // replace the hot keys (d_hot_idx[i] != UINT32_MAX) by anchor_key
+  template <typename KeyType, typename StreamType>
+  void mask_hot_keys(const KeyType* d_keys,
+                     const uint32_t* d_hot_idx,
+                     const KeyType anchor_key,
+                     KeyType* d_out_keys,
+                     int64_t len,
+                     const StreamType& stream);
+  // fill the values of the hot keys from their replicas
+  template <typename StreamType>
+  void fill_hot_vals(const uint32_t* d_hot_idx,
+                     const float* d_replica_vals,
+                     float* d_vals,
+                     int64_t len,
+                     size_t value_bytes,
+                     const StreamType& stream);
   // scale grad values
   template <typename StreamType, typename GPUAccessor>
   void scale_grad(const size_t& len,
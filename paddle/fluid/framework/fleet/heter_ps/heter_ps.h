@@ -77,6 +77,9 @@ class HeterPs : public HeterPsBase {
                              uint32_t* d_offset,
                              uint32_t* d_merged_cnts,
                              bool filter_zero);
+  void set_hot_keys(const std::vector<FeatureKey>& h_keys) override {
+    comm_->set_hot_keys(h_keys);
+  }
 #endif
   // reset table
   void reset_table(const int dev_id,
@@ -82,6 +82,8 @@ class HeterPsBase {
                                      uint32_t* d_offset,
                                      uint32_t* d_merged_cnts,
                                      bool filter_zero) = 0;
+  // replicate the pull values of the hot keys on every device
+  virtual void set_hot_keys(const std::vector<FeatureKey>& h_keys) {}
 #endif
   virtual void reset_table(const int dev_id,
                            size_t capacity,
@@ -28,6 +28,7 @@ limitations under the License. */
 
 PHI_DECLARE_bool(enable_auto_detect_gpu_topo);
 PHI_DECLARE_bool(enable_auto_rdma_trans);
+PHI_DECLARE_bool(enable_topo_aware_route);
 
 namespace paddle {
 namespace framework {
@@ -185,12 +186,22 @@ bool GpuRDMAChecker::check_device_status(const int &device_count,
   std::vector<std::string> gpu_mlxs;
   gpu_status->resize(device_count, 0);
   gpu_mlxs.resize(device_count);
+  std::vector<std::vector<std::string>> gpu_links(device_count);
   for (auto line : lines) {
     std::vector<std::string> tags = paddle::string::split_string(line);
     if (tags.size() < static_cast<size_t>(device_count + 1)) {
       continue;
     }
     std::string &card_name = tags[0];
+    if (strncmp(card_name.c_str(), "GPU", 3) == 0 && card_name.size() > 3 &&
+        card_name[3] >= '0' && card_name[3] <= '9') {
+      int gpu = std::stoi(card_name.substr(3));
+      // the header line starts with GPU0 too, a gpu row is X to itself
+      if (gpu < device_count && tags[gpu + 1] == "X") {
+        gpu_links[gpu].assign(tags.begin() + 1,
+                              tags.begin() + 1 + device_count);
+      }
+    }
     if (strncmp(card_name.c_str(), "GPU0", 4) == 0) {
       // check topo_aware
       topo_aware_ = false;
@@ -219,6 +230,13 @@ bool GpuRDMAChecker::check_device_status(const int &device_count,
       gpu_mlxs[j].append(card_name);
     }
   }
+  bool all_links = true;
+  for (auto &links : gpu_links) {
+    all_links = all_links && !links.empty();
+  }
+  if (FLAGS_enable_topo_aware_route && all_links) {
+    build_route(gpu_links);
+  }
   int not_trans_cnt = 0;
   int need_trans_cnt = 0;
   // check all rdma
@@ -240,6 +258,66 @@ bool GpuRDMAChecker::check_device_status(const int &device_count,
   // need trans device all connect to other device
   return (need_trans_cnt > 0 && not_trans_cnt == 0);
 }
+
+namespace {
+// the relative cost of a copy through a link of nvidia-smi topo -m
+int gpu_link_cost(const std::string &tag) {
+  if (strncmp(tag.c_str(), "NV", 2) == 0) {
+    return 1;
+  } else if (tag == "PIX") {
+    return 2;
+  } else if (tag == "PXB") {
+    return 3;
+  } else if (tag == "PHB") {
+    return 8;
+  } else if (tag == "NODE") {
+    return 10;
+  }
+  // SYS
+  return 20;
+}
+}  // namespace
+
+void GpuRDMAChecker::build_route(
+    const std::vector<std::vector<std::string>> &links) {
+  int device_count = links.size();
+  relay_devs_.assign(device_count, std::vector<int>(device_count, -1));
+  // the relays are balanced over the gpus of the same cost
+  std::vector<int> relay_cnt(device_count, 0);
+  int total_relay_cnt = 0;
+  for (int from = 0; from < device_count; ++from) {
+    for (int to = 0; to < device_count; ++to) {
+      if (from == to) {
+        continue;
+      }
+      int relay = -1;
+      int min_cost = gpu_link_cost(links[from][to]);
+      for (int k = 0; k < device_count; ++k) {
+        if (k == from || k == to) {
+          continue;
+        }
+        // one more for the sync at the relay
+        int cost =
+            gpu_link_cost(links[from][k]) + gpu_link_cost(links[k][to]) + 1;
+        bool balanced = cost == min_cost && relay >= 0 &&
+                        relay_cnt[k] < relay_cnt[relay];
+        if (cost < min_cost || balanced) {
+          relay = k;
+          min_cost = cost;
+        }
+      }
+      if (relay >= 0) {
+        relay_devs_[from][to] = relay;
+        ++relay_cnt[relay];
+        ++total_relay_cnt;
+        VLOG(1) << "GPU" << from << " -> GPU" << to << " (" << links[from][to]
+                << ") relayed by GPU" << relay;
+      }
+    }
+  }
+  VLOG(0) << "topo aware route built, " << total_relay_cnt
+          << " copies are relayed";
+}
 #endif
 
 HeterPsResource::HeterPsResource(const std::vector<int> &dev_ids) {
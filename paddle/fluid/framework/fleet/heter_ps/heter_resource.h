@@ -16,6 +16,7 @@ limitations under the License. */
 #include <cstddef>
 #include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #ifdef PADDLE_WITH_CUDA
@@ -111,10 +112,18 @@ class GpuRDMAChecker {
   int device_num(void) { return device_num_; }
   // topo_aware
   bool topo_aware(void) { return topo_aware_; }
+  // topo aware route, the gpu to relay the copy of from -> to, -1 if the copy
+  // is direct. Only set with FLAGS_enable_topo_aware_route.
+  bool has_route(void) { return !relay_devs_.empty(); }
+  int relay_devid(int from, int to) { return relay_devs_[from][to]; }
 
  private:
   bool check_device_status(const int& device_count,
                            std::vector<int>* gpu_status);
+  // route the copies of the links from nvidia-smi topo -m, a copy crossing
+  // the pcie host bridge or the sockets is relayed by the gpu linked to both
+  // ends by nvlink or a pcie switch.
+  void build_route(const std::vector<std::vector<std::string>>& links);
 
  private:
   int device_num_ = 0;
@@ -122,6 +131,7 @@ class GpuRDMAChecker {
   // rdma
   bool rdma_trans_ = false;
   std::vector<int> rdma_status_;
+  std::vector<std::vector<int>> relay_devs_;
 };
 #endif
 
@@ -15,6 +15,7 @@ limitations under the License. */
 #pragma once
 
 #ifdef PADDLE_WITH_HETERPS
+#include <algorithm>
 #include <iostream>
 #ifdef PADDLE_WITH_CUDA
 #include "paddle/fluid/framework/fleet/heter_ps/cudf/managed.cuh"
@@ -98,13 +99,18 @@ class HBMMemoryPoolFix : public managed {
   HBMMemoryPoolFix() {
     capacity_ = 0;
     size_ = 0;
+    hbm_size_ = 0;
     block_size_ = 0;
     max_byte_capacity_ = 0;
+    max_host_byte_capacity_ = 0;
   }
 
   ~HBMMemoryPoolFix() {
     VLOG(3) << "delete hbm memory pool";
     cudaFree(mem_);
+    if (host_mem_ != NULL) {
+      cudaFreeHost(host_mem_);
+    }
   }
 
   size_t block_size() { return block_size_; }
@@ -120,24 +126,91 @@ class HBMMemoryPoolFix : public managed {
       CUDA_CHECK(cudaMalloc(&mem_, max_byte_capacity_));
     }
     size_ = capacity;
+    hbm_size_ = capacity;
     block_size_ = block_size;
     capacity_ = max_byte_capacity_ / block_size;
   }
 
+  // Only the first hbm_size blocks are in hbm, the others are in the pinned
+  // host memory, which the kernels access through the unified address space.
+  void reset(size_t capacity, size_t block_size, size_t hbm_size) {
+    reset(hbm_size, block_size);
+    size_t host_bytes = (capacity - hbm_size) * block_size;
+    if (max_host_byte_capacity_ < host_bytes) {
+      if (host_mem_ != NULL) {
+        cudaFreeHost(host_mem_);
+      }
+      max_host_byte_capacity_ = host_bytes;
+      CUDA_CHECK(cudaHostAlloc(reinterpret_cast<void**>(&host_mem_),
+                               max_host_byte_capacity_,
+                               cudaHostAllocMapped | cudaHostAllocPortable));
+    }
+    size_ = capacity;
+  }
+
+  // Copies num blocks from idx, which may span the hbm and the host blocks.
+  void copy_from_host(size_t idx,
+                      const char* src,
+                      size_t num,
+                      cudaStream_t stream) {
+    size_t hbm_num = idx < hbm_size_ ? std::min(num, hbm_size_ - idx) : 0;
+    if (hbm_num > 0) {
+      CUDA_CHECK(cudaMemcpyAsync(mem_ + idx * block_size_,
+                                 src,
+                                 hbm_num * block_size_,
+                                 cudaMemcpyHostToDevice,
+                                 stream));
+    }
+    if (num > hbm_num) {
+      CUDA_CHECK(cudaMemcpyAsync(host_block(idx + hbm_num),
+                                 src + hbm_num * block_size_,
+                                 (num - hbm_num) * block_size_,
+                                 cudaMemcpyHostToHost,
+                                 stream));
+    }
+  }
+
+  void copy_to_host(size_t idx, char* dst, size_t num, cudaStream_t stream) {
+    size_t hbm_num = idx < hbm_size_ ? std::min(num, hbm_size_ - idx) : 0;
+    if (hbm_num > 0) {
+      CUDA_CHECK(cudaMemcpyAsync(dst,
+                                 mem_ + idx * block_size_,
+                                 hbm_num * block_size_,
+                                 cudaMemcpyDeviceToHost,
+                                 stream));
+    }
+    if (num > hbm_num) {
+      CUDA_CHECK(cudaMemcpyAsync(dst + hbm_num * block_size_,
+                                 host_block(idx + hbm_num),
+                                 (num - hbm_num) * block_size_,
+                                 cudaMemcpyHostToHost,
+                                 stream));
+    }
+  }
+
   char* mem() { return mem_; }
+  char* host_mem() { return host_mem_; }
 
   size_t capacity() { return capacity_; }
   size_t size() { return size_; }
+  size_t hbm_size() { return hbm_size_; }
   __forceinline__ __device__ void* mem_address(const uint32_t& idx) {
     return &mem_[(idx)*block_size_];
   }
 
  private:
+  char* host_block(size_t idx) {
+    return host_mem_ + (idx - hbm_size_) * block_size_;
+  }
+
   char* mem_ = NULL;
+  char* host_mem_ = NULL;
   size_t capacity_;
   size_t size_;
+  size_t hbm_size_;
   size_t block_size_;
   size_t max_byte_capacity_;
+  size_t max_host_byte_capacity_;
 };
 
 }  // end namespace framework
@@ -46,12 +46,30 @@ void BasicAucCalculator::reset() {
   _local_abserr = 0;
   _local_sqrerr = 0;
   _local_pred = 0;
+  _table_merged = false;
+#if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_NCCL)
+  reset_device_tables();
+#endif
+}
+
+bool BasicAucCalculator::need_gloo_merge() const {
+#if defined(PADDLE_WITH_GLOO)
+  return !_table_merged && GlooWrapper::GetInstance()->Size() > 1;
+#else
+  return false;
+#endif
 }
 
 void BasicAucCalculator::add_data(const float* d_pred,
                                   const int64_t* d_label,
                                   int batch_size,
                                   const paddle::platform::Place& place) {
+#if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_NCCL)
+  if (platform::is_gpu_place(place)) {
+    add_device_data(d_pred, d_label, nullptr, batch_size, place);
+    return;
+  }
+#endif
   thread_local std::vector<float> h_pred;
   thread_local std::vector<int64_t> h_label;
   h_pred.resize(batch_size);
@@ -101,6 +119,12 @@ void BasicAucCalculator::add_mask_data(const float* d_pred,
                                        const int64_t* d_mask,
                                        int batch_size,
                                        const paddle::platform::Place& place) {
+#if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_NCCL)
+  if (platform::is_gpu_place(place)) {
+    add_device_data(d_pred, d_label, d_mask, batch_size, place);
+    return;
+  }
+#endif
   thread_local std::vector<float> h_pred;
   thread_local std::vector<int64_t> h_label;
   thread_local std::vector<int64_t> h_mask;
@@ -121,6 +145,9 @@ void BasicAucCalculator::add_mask_data(const float* d_pred,
 }
 
 void BasicAucCalculator::compute() {
+#if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_NCCL)
+  merge_device_tables();
+#endif
 #if defined(PADDLE_WITH_GLOO)
   double area = 0;
   double fp = 0;
@@ -132,7 +159,7 @@ void BasicAucCalculator::compute() {
     gloo_wrapper->Init();
   }
 
-  if (gloo_wrapper->Size() > 1) {
+  if (need_gloo_merge()) {
     auto neg_table = gloo_wrapper->AllReduce(_table[0], "sum");
     auto pos_table = gloo_wrapper->AllReduce(_table[1], "sum");
     for (int i = _table_size - 1; i >= 0; i--) {
@@ -158,7 +185,7 @@ void BasicAucCalculator::compute() {
     _auc = area / (fp * tp);
   }
 
-  if (gloo_wrapper->Size() > 1) {
+  if (need_gloo_merge()) {
     // allreduce sum
     std::vector<double> local_abserr_vec(1, _local_abserr);
     std::vector<double> local_sqrerr_vec(1, _local_sqrerr);
@@ -191,7 +218,7 @@ void BasicAucCalculator::calculate_bucket_error() {
   double error_sum = 0.0;
   double error_count = 0;
   auto gloo_wrapper = paddle::framework::GlooWrapper::GetInstance();
-  if (gloo_wrapper->Size() > 1) {
+  if (need_gloo_merge()) {
     auto neg_table = gloo_wrapper->AllReduce(_table[0], "sum");
     auto pos_table = gloo_wrapper->AllReduce(_table[1], "sum");
     for (int i = 0; i < _table_size; i++) {
@@ -256,6 +283,11 @@ void BasicAucCalculator::reset_records() {
   _size = 0;
   _uauc = 0;
   _wuauc = 0;
+#if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_NCCL)
+  for (auto& item : _device_tables) {
+    item.second.record_num = 0;
+  }
+#endif
 }
 
 // add uid data
@@ -264,6 +296,12 @@ void BasicAucCalculator::add_uid_data(const float* d_pred,
                                       const int64_t* d_uid,
                                       int batch_size,
                                       const paddle::platform::Place& place) {
+#if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_NCCL)
+  if (platform::is_gpu_place(place)) {
+    add_device_uid_data(d_pred, d_label, d_uid, batch_size, place);
+    return;
+  }
+#endif
   thread_local std::vector<float> h_pred;
   thread_local std::vector<int64_t> h_label;
   thread_local std::vector<uint64_t> h_uid;
@@ -306,6 +344,9 @@ void BasicAucCalculator::add_uid_unlock_data(double pred,
 }
 
 void BasicAucCalculator::computeWuAuc() {
+#if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_NCCL)
+  merge_device_records();
+#endif
   std::sort(wuauc_records_.begin(),
             wuauc_records_.end(),
             [](const WuaucRecord& lhs, const WuaucRecord& rhs) {
@@ -0,0 +1,302 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/fleet/metrics.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "cub/cub.cuh"
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/memory/memcpy.h"
+#include "paddle/fluid/platform/collective_helper.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/fluid/platform/dynload/nccl.h"
+#include "paddle/phi/backends/gpu/gpu_primitives.h"
+
+#if (defined(PADDLE_WITH_PSLIB) || defined(PADDLE_WITH_PSCORE)) && \
+    defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_NCCL)
+namespace paddle {
+namespace framework {
+
+static constexpr int kMetricThreads = 256;
+
+static gpuStream_t GetMetricStream(const platform::Place& place) {
+  return static_cast<phi::GPUContext*>(
+             platform::DeviceContextPool::Instance().Get(place))
+      ->stream();
+}
+
+// Bins the predictions by the labels, the errors are reduced in a block to be
+// added by a single atomic of the block. The invalid predictions and labels
+// are counted to be reported at the compute.
+__global__ void AucHistogramKernel(const float* pred,
+                                   const int64_t* label,
+                                   const int64_t* mask,
+                                   int batch_size,
+                                   int table_size,
+                                   double* table) {
+  using BlockReduce = cub::BlockReduce<double, kMetricThreads>;
+  __shared__ typename BlockReduce::TempStorage temp_storage;
+  double local[4] = {0, 0, 0, 0};
+  CUDA_KERNEL_LOOP(i, batch_size) {
+    if (mask != nullptr && mask[i] == 0) continue;
+    double p = pred[i];
+    int64_t l = label[i];
+    if (!(p >= 0.0 && p <= 1.0) || (l != 0 && l != 1)) {
+      local[3] += 1;
+      continue;
+    }
+    int pos = min(static_cast<int>(p * table_size), table_size - 1);
+    phi::CudaAtomicAdd(table + l * table_size + pos, 1.0);
+    local[0] += fabs(p - l);
+    local[1] += (p - l) * (p - l);
+    local[2] += p;
+  }
+  double* scalars = table + 2 * table_size;
+  for (int k = 0; k < 4; ++k) {
+    double sum = BlockReduce(temp_storage).Sum(local[k]);
+    if (threadIdx.x == 0 && sum != 0) {
+      phi::CudaAtomicAdd(scalars + k, sum);
+    }
+    __syncthreads();
+  }
+}
+
+__global__ void AppendWuaucRecordKernel(
+    const float* pred,
+    const int64_t* label,
+    const int64_t* uid,
+    int batch_size,
+    BasicAucCalculator::WuaucRecord* records,
+    unsigned long long* invalid) {  // NOLINT
+  CUDA_KERNEL_LOOP(i, batch_size) {
+    float p = pred[i];
+    int64_t l = label[i];
+    if (!(p >= 0.0f && p <= 1.0f) || (l != 0 && l != 1)) {
+      atomicAdd(invalid, 1ULL);
+    }
+    records[i].uid_ = static_cast<uint64_t>(uid[i]);
+    records[i].label_ = static_cast<int>(l);
+    records[i].pred_ = p;
+  }
+}
+
+static int MetricBlocks(int batch_size) {
+  return std::min((batch_size + kMetricThreads - 1) / kMetricThreads, 1024);
+}
+
+BasicAucCalculator::DeviceTable* BasicAucCalculator::get_device_table(
+    const platform::Place& place) {
+  std::lock_guard<std::mutex> lock(_table_mutex);
+  return &_device_tables[place.GetDeviceId()];
+}
+
+void BasicAucCalculator::add_device_data(const float* d_pred,
+                                         const int64_t* d_label,
+                                         const int64_t* d_mask,
+                                         int batch_size,
+                                         const platform::Place& place) {
+  auto* device_table = get_device_table(place);
+  auto stream = GetMetricStream(place);
+  const size_t table_len = 2 * _table_size + kDeviceScalars;
+  if (device_table->table == nullptr) {
+    device_table->table =
+        memory::AllocShared(place, table_len * sizeof(double));
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaMemsetAsync(
+        device_table->table->ptr(), 0, table_len * sizeof(double), stream));
+  }
+  if (batch_size <= 0) return;
+  AucHistogramKernel<<<MetricBlocks(batch_size), kMetricThreads, 0, stream>>>(
+      d_pred,
+      d_label,
+      d_mask,
+      batch_size,
+      _table_size,
+      reinterpret_cast<double*>(device_table->table->ptr()));
+}
+
+void BasicAucCalculator::add_device_uid_data(const float* d_pred,
+                                             const int64_t* d_label,
+                                             const int64_t* d_uid,
+                                             int batch_size,
+                                             const platform::Place& place) {
+  auto* device_table = get_device_table(place);
+  auto stream = GetMetricStream(place);
+  if (device_table->invalid_records == nullptr) {
+    device_table->invalid_records =
+        memory::AllocShared(place, sizeof(unsigned long long));  // NOLINT
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaMemsetAsync(device_table->invalid_records->ptr(),
+                        0,
+                        sizeof(unsigned long long),  // NOLINT
+                        stream));
+  }
+  if (batch_size <= 0) return;
+  const size_t record_num = device_table->record_num + batch_size;
+  if (record_num > device_table->record_capacity) {
+    size_t capacity = std::max(record_num, 2 * device_table->record_capacity);
+    auto records = memory::AllocShared(place, capacity * sizeof(WuaucRecord));
+    if (device_table->record_num > 0) {
+      memory::Copy(place,
+                   records->ptr(),
+                   place,
+                   device_table->records->ptr(),
+                   device_table->record_num * sizeof(WuaucRecord),
+                   stream);
+    }
+    device_table->records = records;
+    device_table->record_capacity = capacity;
+  }
+  auto* records = reinterpret_cast<WuaucRecord*>(device_table->records->ptr());
+  AppendWuaucRecordKernel<<<MetricBlocks(batch_size),
+                            kMetricThreads,
+                            0,
+                            stream>>>(
+      d_pred,
+      d_label,
+      d_uid,
+      batch_size,
+      records + device_table->record_num,
+      reinterpret_cast<unsigned long long*>(  // NOLINT
+          device_table->invalid_records->ptr()));
+  device_table->record_num = record_num;
+}
+
+void BasicAucCalculator::merge_device_tables() {
+  std::lock_guard<std::mutex> lock(_table_mutex);
+  std::vector<std::pair<platform::Place, double*>> tables;
+  for (auto& item : _device_tables) {
+    if (item.second.table != nullptr) {
+      tables.emplace_back(
+          platform::CUDAPlace(item.first),
+          reinterpret_cast<double*>(item.second.table->ptr()));
+    }
+  }
+  if (tables.empty()) return;
+  const size_t table_len = 2 * _table_size + kDeviceScalars;
+  size_t read_num = tables.size();
+  if (_nccl_ring_id >= 0) {
+    // Every device table holds the sum of the ring after the all reduce, on
+    // the streams of the accumulation, so only one of them is read back.
+    PADDLE_ENFORCE_GPU_SUCCESS(platform::dynload::ncclGroupStart());
+    for (auto& table : tables) {
+      auto* comm = platform::NCCLCommContext::Instance().Get(
+          _nccl_ring_id, table.first.GetDeviceId());
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          platform::dynload::ncclAllReduce(table.second,
+                                           table.second,
+                                           table_len,
+                                           ncclDouble,
+                                           ncclSum,
+                                           comm->comm(),
+                                           GetMetricStream(table.first)));
+    }
+    PADDLE_ENFORCE_GPU_SUCCESS(platform::dynload::ncclGroupEnd());
+    read_num = 1;
+    _table_merged = true;
+  }
+  std::vector<double> h_table(table_len);
+  double invalid_num = 0;
+  for (size_t t = 0; t < read_num; ++t) {
+    auto& table = tables[t];
+    auto stream = GetMetricStream(table.first);
+    memory::Copy(platform::CPUPlace(),
+                 h_table.data(),
+                 table.first,
+                 table.second,
+                 table_len * sizeof(double),
+                 stream);
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
+    for (int i = 0; i < _table_size; ++i) {
+      _table[0][i] += h_table[i];
+      _table[1][i] += h_table[_table_size + i];
+    }
+    const double* scalars = h_table.data() + 2 * _table_size;
+    _local_abserr += scalars[0];
+    _local_sqrerr += scalars[1];
+    _local_pred += scalars[2];
+    invalid_num += scalars[3];
+  }
+  for (auto& table : tables) {
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaMemsetAsync(table.second,
+                                               0,
+                                               table_len * sizeof(double),
+                                               GetMetricStream(table.first)));
+  }
+  PADDLE_ENFORCE_EQ(invalid_num,
+                    0.0,
+                    platform::errors::PreconditionNotMet(
+                        "%d predictions are not in [0, 1], or their labels "
+                        "are not 0 or 1.",
+                        static_cast<int64_t>(invalid_num)));
+}
+
+void BasicAucCalculator::merge_device_records() {
+  std::lock_guard<std::mutex> lock(_table_mutex);
+  for (auto& item : _device_tables) {
+    auto& device_table = item.second;
+    if (device_table.invalid_records == nullptr) continue;
+    platform::CUDAPlace place(item.first);
+    auto stream = GetMetricStream(place);
+    unsigned long long invalid_num = 0;  // NOLINT
+    memory::Copy(platform::CPUPlace(),
+                 &invalid_num,
+                 place,
+                 device_table.invalid_records->ptr(),
+                 sizeof(invalid_num),
+                 stream);
+    size_t offset = wuauc_records_.size();
+    wuauc_records_.resize(offset + device_table.record_num);
+    if (device_table.record_num > 0) {
+      memory::Copy(platform::CPUPlace(),
+                   wuauc_records_.data() + offset,
+                   place,
+                   device_table.records->ptr(),
+                   device_table.record_num * sizeof(WuaucRecord),
+                   stream);
+    }
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaMemsetAsync(device_table.invalid_records->ptr(),
+                        0,
+                        sizeof(invalid_num),
+                        stream));
+    device_table.record_num = 0;
+    PADDLE_ENFORCE_EQ(invalid_num,
+                      0ULL,
+                      platform::errors::PreconditionNotMet(
+                          "%d predictions are not in [0, 1], or their labels "
+                          "are not 0 or 1.",
+                          static_cast<int64_t>(invalid_num)));
+  }
+}
+
+void BasicAucCalculator::reset_device_tables() {
+  const size_t table_len = 2 * _table_size + kDeviceScalars;
+  for (auto& item : _device_tables) {
+    if (item.second.table == nullptr) continue;
+    platform::CUDAPlace place(item.first);
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaMemsetAsync(item.second.table->ptr(),
+                        0,
+                        table_len * sizeof(double),
+                        GetMetricStream(place)));
+  }
+}
+
+}  // namespace framework
+}  // namespace paddle
+#endif
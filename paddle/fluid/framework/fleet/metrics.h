@@ -30,10 +30,15 @@ limitations under the License. */
 #include "paddle/fluid/framework/program_desc.h"
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/framework/tensor.h"
+#include "paddle/fluid/framework/tensor_util.h"
 #include "paddle/fluid/framework/variable_helper.h"
 #include "paddle/fluid/platform/timer.h"
 #include "paddle/fluid/string/string_helper.h"
 
+#if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_NCCL)
+#include "paddle/phi/core/allocator.h"
+#endif
+
 #if defined(PADDLE_WITH_GLOO)
 #include <gloo/allreduce.h>
 
@@ -84,6 +89,12 @@ class BasicAucCalculator {
                     int batch_size,
                     const paddle::platform::Place& place);
 
+  // The ring of the device tables merged by nccl at the compute, it should
+  // cover a device of every trainer that adds the device data, and then the
+  // tables are not merged by gloo again. -1 reads every device table back to
+  // merge them on the host.
+  void set_nccl_ring_id(int ring_id) { _nccl_ring_id = ring_id; }
+
   void compute();
   void computeWuAuc();
   WuaucRocData computeSingelUserAuc(const std::vector<WuaucRecord>& records);
@@ -104,6 +115,7 @@ class BasicAucCalculator {
 
  private:
   void calculate_bucket_error();
+  bool need_gloo_merge() const;
 
  protected:
   double _local_abserr = 0;
@@ -129,6 +141,43 @@ class BasicAucCalculator {
   static constexpr double kRelativeErrorBound = 0.05;
   static constexpr double kMaxSpan = 0.01;
   std::mutex _table_mutex;
+  int _nccl_ring_id = -1;
+  // Whether the tables have been merged over the trainers by nccl.
+  bool _table_merged = false;
+
+#if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_NCCL)
+  // The data on a device is accumulated by the kernels on the stream of the
+  // device, without a copy to the host per batch. The table is laid out as
+  // [neg table, pos table, abserr, sqrerr, pred, invalid num], the records of
+  // wuauc are appended to a buffer growing by doubling.
+  struct DeviceTable {
+    std::shared_ptr<phi::Allocation> table;
+    std::shared_ptr<phi::Allocation> records;
+    std::shared_ptr<phi::Allocation> invalid_records;
+    size_t record_num = 0;
+    size_t record_capacity = 0;
+  };
+  static constexpr int kDeviceScalars = 4;
+
+  DeviceTable* get_device_table(const paddle::platform::Place& place);
+  void add_device_data(const float* d_pred,
+                       const int64_t* d_label,
+                       const int64_t* d_mask,
+                       int batch_size,
+                       const paddle::platform::Place& place);
+  void add_device_uid_data(const float* d_pred,
+                           const int64_t* d_label,
+                           const int64_t* d_uid,
+                           int batch_size,
+                           const paddle::platform::Place& place);
+  // Merges the device tables into the host table by a single readback.
+  void merge_device_tables();
+  // Appends the device records to wuauc_records_.
+  void merge_device_records();
+  void reset_device_tables();
+
+  std::map<int, DeviceTable> _device_tables;
+#endif
 };
 
 class Metric {
@@ -162,30 +211,36 @@ class Metric {
       const int64_t* label_data = NULL;
       int pred_len = 0;
       const float* pred_data = NULL;
+      platform::Place data_place;
       get_data<int64_t>(exe_scope, label_varname_, &label_data, &label_len);
-      get_data<float>(exe_scope, pred_varname_, &pred_data, &pred_len);
+      get_data<float>(
+          exe_scope, pred_varname_, &pred_data, &pred_len, &data_place);
       PADDLE_ENFORCE_EQ(label_len,
                         pred_len,
                         platform::errors::PreconditionNotMet(
                             "the predict data length should be consistent with "
                             "the label data length"));
-      calculator->add_data(pred_data, label_data, label_len, place);
+      calculator->add_data(pred_data, label_data, label_len, data_place);
     }
 
-    // get_data
+    // get_data, the data is kept where it is, on the place of the tensor
     template <class T = float>
     static void get_data(const Scope* exe_scope,
                          const std::string& varname,
                          const T** data,
-                         int* len) {
+                         int* len,
+                         platform::Place* place = nullptr) {
       auto* var = exe_scope->FindVar(varname.c_str());
       PADDLE_ENFORCE_NOT_NULL(
           var,
           platform::errors::NotFound("Error: var %s is not found in scope.",
                                      varname.c_str()));
-      auto& cpu_tensor = var->Get<phi::DenseTensor>();
-      *data = cpu_tensor.data<T>();
-      *len = cpu_tensor.numel();
+      auto& tensor = var->Get<phi::DenseTensor>();
+      *data = tensor.data<T>();
+      *len = tensor.numel();
+      if (place != nullptr) {
+        *place = tensor.place();
+      }
     }
 
     template <class T = float>
@@ -197,9 +252,15 @@ class Metric {
           var,
           platform::errors::NotFound("Error: var %s is not found in scope.",
                                      varname.c_str()));
-      auto& cpu_tensor = var->Get<phi::DenseTensor>();
-      auto* cpu_data = cpu_tensor.data<T>();
-      auto len = cpu_tensor.numel();
+      auto* cpu_tensor = &var->Get<phi::DenseTensor>();
+      phi::DenseTensor host_tensor;
+      if (!platform::is_cpu_place(cpu_tensor->place())) {
+        framework::TensorCopySync(
+            *cpu_tensor, platform::CPUPlace(), &host_tensor);
+        cpu_tensor = &host_tensor;
+      }
+      auto* cpu_data = cpu_tensor->data<T>();
+      auto len = cpu_tensor->numel();
       data->resize(len);
       memcpy(data->data(), cpu_data, sizeof(T) * len);
     }
@@ -242,7 +303,9 @@ class Metric {
 
       int pred_len = 0;
       const float* pred_data = NULL;
-      get_data<float>(exe_scope, pred_varname_, &pred_data, &pred_len);
+      platform::Place data_place;
+      get_data<float>(
+          exe_scope, pred_varname_, &pred_data, &pred_len, &data_place);
 
       int uid_len = 0;
       const int64_t* uid_data = NULL;
@@ -253,7 +316,8 @@ class Metric {
                             "the predict data length should be consistent with "
                             "the label data length"));
       auto cal = GetCalculator();
-      cal->add_uid_data(pred_data, label_data, uid_data, label_len, place);
+      cal->add_uid_data(
+          pred_data, label_data, uid_data, label_len, data_place);
     }
 
    protected:
@@ -448,7 +512,9 @@ class Metric {
 
       int pred_len = 0;
       const float* pred_data = NULL;
-      get_data<float>(exe_scope, pred_varname_, &pred_data, &pred_len);
+      platform::Place data_place;
+      get_data<float>(
+          exe_scope, pred_varname_, &pred_data, &pred_len, &data_place);
 
       int mask_len = 0;
       const int64_t* mask_data = NULL;
@@ -459,7 +525,8 @@ class Metric {
                             "the predict data length should be consistent with "
                             "the label data length"));
       auto cal = GetCalculator();
-      cal->add_mask_data(pred_data, label_data, mask_data, label_len, place);
+      cal->add_mask_data(
+          pred_data, label_data, mask_data, label_len, data_place);
     }
 
    protected:
@@ -685,6 +752,13 @@ class Metric {
     metric_name_list_.emplace_back(name);
   }
 
+  // Merges the device tables of the metrics by nccl on the ring.
+  void SetNcclRingId(int ring_id) {
+    for (auto& item : metric_lists_) {
+      item.second->GetCalculator()->set_nccl_ring_id(ring_id);
+    }
+  }
+
   const std::vector<float> GetMetricMsg(const std::string& name) {
     const auto iter = metric_lists_.find(name);
     PADDLE_ENFORCE_NE(iter,
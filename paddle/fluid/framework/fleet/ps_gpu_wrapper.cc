@@ -30,7 +30,11 @@ limitations under the License. */
 #include "paddle/fluid/framework/fleet/ps_gpu_wrapper.h"
 
 #include <algorithm>
+#include <cmath>
 #include <deque>
+#include <functional>
+#include <numeric>
+#include <queue>
 #include <unordered_set>
 
 #include "paddle/fluid/framework/data_set.h"
@@ -48,6 +52,10 @@ PHI_DECLARE_int32(gpugraph_dedup_pull_push_mode);
 PHI_DECLARE_int32(gpugraph_storage_mode);
 PHI_DECLARE_bool(query_dest_rank_by_multi_node);
 PHI_DECLARE_string(graph_edges_split_mode);
+PHI_DECLARE_bool(gpups_pipelined_pass);
+PHI_DECLARE_int32(gpups_hot_key_num);
+PHI_DECLARE_int32(gpups_device_key_dedup_chunk);
+PHI_DECLARE_double(gpups_hbm_cache_ratio);
 
 namespace paddle {
 namespace framework {
@@ -294,18 +302,22 @@ void PSGPUWrapper::PreBuildTask(std::shared_ptr<HeterContext> gpu_task,
           }
         }
       };
-      for (int i = 0; i < thread_keys_thread_num_; i++) {
-        threads.push_back(
-            std::thread(gen_dynamic_mf_func,
-                        std::ref(vec_data),
-                        begin,
-                        begin + len_per_thread + (i < remain ? 1 : 0),
-                        i));
-
-        begin += len_per_thread + (i < remain ? 1 : 0);
-      }
-      for (std::thread& t : threads) {
-        t.join();
+      if (FLAGS_gpups_device_key_dedup_chunk > 0) {
+        DeviceDedupSlotKeys(gpu_task, vec_data);
+      } else {
+        for (int i = 0; i < thread_keys_thread_num_; i++) {
+          threads.push_back(
+              std::thread(gen_dynamic_mf_func,
+                          std::ref(vec_data),
+                          begin,
+                          begin + len_per_thread + (i < remain ? 1 : 0),
+                          i));
+
+          begin += len_per_thread + (i < remain ? 1 : 0);
+        }
+        for (std::thread& t : threads) {
+          t.join();
+        }
       }
       timeline.Pause();
       VLOG(0) << "GpuPs build task cost " << timeline.ElapsedSec()
@@ -443,6 +455,99 @@ void PSGPUWrapper::PreBuildTask(std::shared_ptr<HeterContext> gpu_task,
   VLOG(0) << "add_key_to_gputask cost" << timeline.ElapsedSec() << " seconds.";
 }
 
+void PSGPUWrapper::DeviceDedupSlotKeys(std::shared_ptr<HeterContext> gpu_task,
+                                       const std::deque<SlotRecord>& records) {
+#ifdef PADDLE_WITH_CUDA
+  // Every device scans a range of the records, and dedups the keys of a dim
+  // whenever a chunk is filled. The locally unique keys are exchanged by
+  // key % device_num, so that the owner deduplicates them over the devices,
+  // and appends them to the shards read by BuildPull.
+  const size_t chunk = static_cast<size_t>(FLAGS_gpups_device_key_dedup_chunk);
+  const int device_num = heter_devices_.size();
+  const int dim_num = multi_mf_dim_;
+  // [src device][dim][owner device]
+  std::vector<std::vector<std::vector<std::vector<uint64_t>>>> local_keys(
+      device_num,
+      std::vector<std::vector<std::vector<uint64_t>>>(
+          dim_num, std::vector<std::vector<uint64_t>>(device_num)));
+  std::vector<std::mutex> shard_mutex(thread_keys_shard_num_);
+  const size_t total_len = records.size();
+  const size_t len_per_device = (total_len + device_num - 1) / device_num;
+
+  auto extract_func = [&](int dev) {
+    size_t begin = std::min(total_len, dev * len_per_device);
+    size_t end = std::min(total_len, begin + len_per_device);
+    std::vector<std::vector<uint64_t>> chunk_keys(dim_num);
+    auto flush = [&](int dim_id) {
+      DeviceUniqueKeys(dev, &chunk_keys[dim_id]);
+      for (auto key : chunk_keys[dim_id]) {
+        local_keys[dev][dim_id][key % device_num].push_back(key);
+      }
+      chunk_keys[dim_id].clear();
+    };
+    for (size_t k = begin; k < end; ++k) {
+      const auto& ins = records[k];
+      const auto& feasign_v = ins->slot_uint64_feasigns_.slot_values;
+      const auto& slot_offset = ins->slot_uint64_feasigns_.slot_offsets;
+      for (size_t slot_idx = 0; slot_idx < slot_offset_vector_.size();
+           slot_idx++) {
+        int dim_id = slot_index_vec_[slot_idx];
+        for (size_t j = slot_offset[slot_offset_vector_[slot_idx]];
+             j < slot_offset[slot_offset_vector_[slot_idx] + 1];
+             j++) {
+          if (feasign_v[j] == 0) continue;
+          chunk_keys[dim_id].push_back(feasign_v[j]);
+          if (chunk_keys[dim_id].size() >= chunk) flush(dim_id);
+        }
+      }
+    }
+    for (int dim_id = 0; dim_id < dim_num; ++dim_id) {
+      flush(dim_id);
+    }
+  };
+  auto merge_func = [&](int dev) {
+    for (int dim_id = 0; dim_id < dim_num; ++dim_id) {
+      std::vector<uint64_t> keys;
+      for (int src = 0; src < device_num; ++src) {
+        auto& src_keys = local_keys[src][dim_id][dev];
+        keys.insert(keys.end(), src_keys.begin(), src_keys.end());
+        std::vector<uint64_t>().swap(src_keys);
+      }
+      DeviceUniqueKeys(dev, &keys);
+      std::vector<std::vector<uint64_t>> shard_keys(thread_keys_shard_num_);
+      for (auto key : keys) {
+        shard_keys[key % thread_keys_shard_num_].push_back(key);
+      }
+      for (int shard = 0; shard < thread_keys_shard_num_; ++shard) {
+        std::lock_guard<std::mutex> lock(shard_mutex[shard]);
+        auto& dst = gpu_task->feature_dim_keys_[shard][dim_id];
+        dst.insert(
+            dst.end(), shard_keys[shard].begin(), shard_keys[shard].end());
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int dev = 0; dev < device_num; ++dev) {
+    threads.emplace_back(extract_func, dev);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  threads.clear();
+  for (int dev = 0; dev < device_num; ++dev) {
+    threads.emplace_back(merge_func, dev);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+#else
+  PADDLE_THROW(platform::errors::Unimplemented(
+      "The keys are only deduped on the cuda devices, please set "
+      "FLAGS_gpups_device_key_dedup_chunk to 0."));
+#endif
+}
+
 void PSGPUWrapper::add_slot_feature(std::shared_ptr<HeterContext> gpu_task) {
   platform::Timer timeline;
   platform::Timer time_stage;
@@ -1697,6 +1802,75 @@ void PSGPUWrapper::PrepareGPUTask(std::shared_ptr<HeterContext> gpu_task) {
           << " seconds.";
 }
 
+size_t PSGPUWrapper::HbmCacheLen(size_t len) {
+  PADDLE_ENFORCE_GT(FLAGS_gpups_hbm_cache_ratio,
+                    0.0,
+                    platform::errors::InvalidArgument(
+                        "FLAGS_gpups_hbm_cache_ratio should be in (0, 1], "
+                        "but got %f.",
+                        FLAGS_gpups_hbm_cache_ratio));
+  if (FLAGS_gpups_hbm_cache_ratio >= 1.0) {
+    return len;
+  }
+  return std::min(
+      len,
+      static_cast<size_t>(std::ceil(len * FLAGS_gpups_hbm_cache_ratio)));
+}
+
+void PSGPUWrapper::OrderKeysByShow(std::shared_ptr<HeterContext> gpu_task) {
+#ifdef PADDLE_WITH_PSCORE
+  platform::Timer timer;
+  timer.Start();
+  int device_num = heter_devices_.size();
+  auto order_func = [this, &gpu_task](int i) {
+    for (int j = 0; j < multi_mf_dim_; j++) {
+      auto& keys = gpu_task->device_dim_keys_[i][j];
+      auto& ptrs = gpu_task->device_dim_ptr_[i][j];
+      std::vector<float> shows(keys.size());
+      for (size_t k = 0; k < keys.size(); k++) {
+        // the key 0 is the padding pulled by every batch
+        shows[k] = keys[k] == 0
+                       ? std::numeric_limits<float>::max()
+                       : cpu_table_accessor_->GetField(ptrs[k]->data(), "show");
+      }
+      std::vector<size_t> order(keys.size());
+      std::iota(order.begin(), order.end(), 0);
+      size_t hbm_len = HbmCacheLen(keys.size());
+      // only the hbm keys need to be ahead of the others, in any order
+      if (hbm_len < keys.size()) {
+        std::nth_element(order.begin(),
+                         order.begin() + hbm_len,
+                         order.end(),
+                         [&shows](size_t a, size_t b) {
+                           return shows[a] > shows[b];
+                         });
+      }
+      std::vector<FeatureKey> ordered_keys(keys.size());
+      std::vector<paddle::distributed::FixedFeatureValue*> ordered_ptrs(
+          ptrs.size());
+      for (size_t k = 0; k < order.size(); k++) {
+        ordered_keys[k] = keys[order[k]];
+        ordered_ptrs[k] = ptrs[order[k]];
+      }
+      keys.swap(ordered_keys);
+      ptrs.swap(ordered_ptrs);
+    }
+  };
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < device_num; i++) {
+    futures.emplace_back(cpu_work_pool_[i]->enqueue(order_func, i));
+  }
+  for (auto& f : futures) {
+    f.wait();
+  }
+  timer.Pause();
+  VLOG(0) << "passid=" << gpu_task->pass_id_
+          << ", OrderKeysByShow for the hbm cache ratio "
+          << FLAGS_gpups_hbm_cache_ratio << ", cost " << timer.ElapsedSec()
+          << " s.";
+#endif
+}
+
 void PSGPUWrapper::BuildGPUTask(std::shared_ptr<HeterContext> gpu_task) {
   int device_num = heter_devices_.size();
   platform::Timer stagetime;
@@ -1725,6 +1899,10 @@ void PSGPUWrapper::BuildGPUTask(std::shared_ptr<HeterContext> gpu_task) {
     return;
   }
 
+  if (FLAGS_gpups_hbm_cache_ratio < 1.0) {
+    OrderKeysByShow(gpu_task);
+  }
+
   auto accessor_wrapper_ptr =
       GlobalAccessorFactory::GetInstance().GetAccessorWrapper();
   if (HeterPs_ == NULL) {
@@ -1818,16 +1996,24 @@ void PSGPUWrapper::BuildGPUTask(std::shared_ptr<HeterContext> gpu_task) {
       int mf_dim = this->index_dim_vec_[j];
       size_t feature_value_size =
           accessor_wrapper_ptr->GetFeatureValueSize(mf_dim);
-      this->hbm_pools_[i * this->multi_mf_dim_ + j]->reset(len,
-                                                           feature_value_size);
-      this->HeterPs_->build_ps(
-          i,
-          device_dim_keys.data(),
-          this->hbm_pools_[i * this->multi_mf_dim_ + j]->mem(),
-          len,
-          feature_value_size,
-          4 * 1024 * 1024,
-          2);
+      auto& hbm_pool = this->hbm_pools_[i * this->multi_mf_dim_ + j];
+      size_t hbm_len = this->HbmCacheLen(len);
+      hbm_pool->reset(len, feature_value_size, hbm_len);
+      this->HeterPs_->build_ps(i,
+                               device_dim_keys.data(),
+                               hbm_pool->mem(),
+                               hbm_len,
+                               feature_value_size,
+                               4 * 1024 * 1024,
+                               2);
+      // the colder keys point to the values in the pinned host memory
+      this->HeterPs_->build_ps(i,
+                               device_dim_keys.data() + hbm_len,
+                               hbm_pool->host_mem(),
+                               len - hbm_len,
+                               feature_value_size,
+                               4 * 1024 * 1024,
+                               2);
       if (device_dim_keys.size() > 0) {
         VLOG(3) << "show table: " << i
                 << " table kv size: " << device_dim_keys.size()
@@ -1874,19 +2060,16 @@ void PSGPUWrapper::BuildGPUTask(std::shared_ptr<HeterContext> gpu_task) {
     struct task_info task;
     auto stream = resource_->local_stream(i, 0);
     while (cpu_reday_channels_[i]->Get(task)) {
-      auto hbm = this->hbm_pools_[task.device_id * this->multi_mf_dim_ +
-                                  task.multi_mf_dim]
-                     ->mem();
+      auto& hbm_pool = this->hbm_pools_[task.device_id * this->multi_mf_dim_ +
+                                        task.multi_mf_dim];
       int mf_dim = this->index_dim_vec_[task.multi_mf_dim];
       size_t feature_value_size =
           accessor_wrapper_ptr->GetFeatureValueSize(mf_dim);
-      auto hbm_start = hbm + task.offset * feature_value_size;
-      CUDA_CHECK(cudaMemcpyAsync(
-          hbm_start,
+      hbm_pool->copy_from_host(
+          task.offset,
           task.build_values.get() + task.start * feature_value_size,
-          (task.end - task.start) * feature_value_size,
-          cudaMemcpyHostToDevice,
-          stream));
+          task.end - task.start,
+          stream);
       total_len += (task.end - task.start);
     }
     PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
@@ -1950,6 +2133,71 @@ void PSGPUWrapper::BuildGPUTask(std::shared_ptr<HeterContext> gpu_task) {
   stagetime.Pause();
   VLOG(1) << "  build_dymf_hbm_pool "
           << " cost " << stagetime.ElapsedSec() << " s.";
+  if (FLAGS_gpups_hot_key_num > 0 && !multi_node_) {
+    BuildHotKeys(gpu_task);
+  }
+}
+
+void PSGPUWrapper::BuildHotKeys(std::shared_ptr<HeterContext> gpu_task) {
+#ifdef PADDLE_WITH_PSCORE
+  platform::Timer timer;
+  timer.Start();
+  int device_num = heter_devices_.size();
+  size_t hot_num = static_cast<size_t>(FLAGS_gpups_hot_key_num);
+  using ShowKey = std::pair<float, FeatureKey>;
+  // the top hot_num keys of a device by show, in a min heap
+  std::vector<std::vector<ShowKey>> device_hot_keys(device_num);
+  auto select_func = [this, &gpu_task, &device_hot_keys, hot_num](int i) {
+    std::priority_queue<ShowKey, std::vector<ShowKey>, std::greater<ShowKey>>
+        heap;
+    for (int j = 0; j < multi_mf_dim_; j++) {
+      auto& keys = gpu_task->device_dim_keys_[i][j];
+      auto& ptrs = gpu_task->device_dim_ptr_[i][j];
+      for (size_t k = 0; k < keys.size(); k++) {
+        // the key 0 is the padding, pulled as zero values
+        if (keys[k] == 0) {
+          continue;
+        }
+        float show = cpu_table_accessor_->GetField(ptrs[k]->data(), "show");
+        if (heap.size() < hot_num) {
+          heap.push({show, keys[k]});
+        } else if (show > heap.top().first) {
+          heap.pop();
+          heap.push({show, keys[k]});
+        }
+      }
+    }
+    auto& hot_keys = device_hot_keys[i];
+    while (!heap.empty()) {
+      hot_keys.push_back(heap.top());
+      heap.pop();
+    }
+  };
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < device_num; i++) {
+    futures.emplace_back(cpu_work_pool_[i]->enqueue(select_func, i));
+  }
+  for (auto& f : futures) {
+    f.wait();
+  }
+  std::vector<ShowKey> candidates;
+  for (auto& hot_keys : device_hot_keys) {
+    candidates.insert(candidates.end(), hot_keys.begin(), hot_keys.end());
+  }
+  size_t len = std::min(hot_num, candidates.size());
+  std::partial_sort(candidates.begin(),
+                    candidates.begin() + len,
+                    candidates.end(),
+                    std::greater<ShowKey>());
+  std::vector<FeatureKey> h_keys(len);
+  for (size_t k = 0; k < len; k++) {
+    h_keys[k] = candidates[k].second;
+  }
+  HeterPs_->set_hot_keys(h_keys);
+  timer.Pause();
+  VLOG(0) << "passid=" << gpu_task->pass_id_ << ", BuildHotKeys " << len
+          << " hot keys, cost " << timer.ElapsedSec() << " s.";
+#endif
 }
 
 void PSGPUWrapper::LoadIntoMemory(bool is_shuffle) {
@@ -2025,6 +2273,20 @@ void PSGPUWrapper::build_pull_thread() {
     VLOG(0) << "passid=" << gpu_task->pass_id_
             << ", thread BuildPull end, cost time: " << timer.ElapsedSec()
             << "s";
+    // the keys of multi node are merged with a barrier in BeginPass first
+    if (FLAGS_gpups_pipelined_pass && !multi_node_) {
+      timer.Start();
+      if (multi_mf_dim_) {
+        divide_to_device(gpu_task);
+      } else {
+        PrepareGPUTask(gpu_task);
+      }
+      gpu_task->device_task_prepared_ = true;
+      timer.Pause();
+      VLOG(0) << "passid=" << gpu_task->pass_id_
+              << ", thread PrepareGPUTask end, cost time: "
+              << timer.ElapsedSec() << "s";
+    }
     buildpull_ready_channel_->Put(gpu_task);
   }
   VLOG(3) << "build cpu thread end";
@@ -2043,11 +2305,16 @@ void PSGPUWrapper::build_task() {
   timer.Start();
   // merge pull
   MergePull(gpu_task);
-  if (multi_mf_dim_) {
-    divide_to_device(gpu_task);
-  } else {
-    PrepareGPUTask(gpu_task);
+  if (!gpu_task->device_task_prepared_) {
+    if (multi_mf_dim_) {
+      divide_to_device(gpu_task);
+    } else {
+      PrepareGPUTask(gpu_task);
+    }
   }
+  // the hbm values are built from the cpu table, which is filled back by the
+  // last EndPass
+  WaitEndPass();
   BuildGPUTask(gpu_task);
   timer.Pause();
   VLOG(1) << "passid=" << gpu_task->pass_id_
@@ -2099,19 +2366,42 @@ void PSGPUWrapper::EndPass() {
   if (current_task_ == nullptr) {
     return;
   }
+  WaitEndPass();
   platform::Timer stagetime;
   stagetime.Start();
-  HbmToSparseTable();
+  HbmToSparseTable(FLAGS_gpups_pipelined_pass);
   stagetime.Pause();
   VLOG(0) << "passid=" << current_task_->pass_id_
           << ", EndPass HbmToSparseTable cost time: " << stagetime.ElapsedSec()
           << "s";
 
-  gpu_task_pool_.Push(current_task_);
+  if (dump_futures_.empty()) {
+    gpu_task_pool_.Push(current_task_);
+  } else {
+    // pushed back to the pool by WaitEndPass
+    dumping_task_ = current_task_;
+  }
   current_task_ = nullptr;
   // fleet_ptr->pslib_ptr_->_worker_ptr->release_table_mutex(this->table_id_);
 }
 
+void PSGPUWrapper::WaitEndPass() {
+  if (dumping_task_ == nullptr) {
+    return;
+  }
+  platform::Timer timer;
+  timer.Start();
+  for (auto& f : dump_futures_) {
+    f.wait();
+  }
+  dump_futures_.clear();
+  timer.Pause();
+  VLOG(0) << "passid=" << dumping_task_->pass_id_
+          << ", WaitEndPass cost time: " << timer.ElapsedSec() << "s";
+  gpu_task_pool_.Push(dumping_task_);
+  dumping_task_ = nullptr;
+}
+
 void PSGPUWrapper::SparseTableToHbm() {
 #if defined(PADDLE_WITH_PSCORE) && defined(PADDLE_WITH_GPU_GRAPH)
   std::shared_ptr<HeterContext> gpu_task = gpu_task_pool_.Get();
@@ -2150,7 +2440,7 @@ void PSGPUWrapper::SparseTableToHbm() {
 #endif
 }
 
-void PSGPUWrapper::HbmToSparseTable() {
+void PSGPUWrapper::HbmToSparseTable(bool async) {
   // hbm no update not need dump
   if (grad_push_count_ == 0) {
     return;
@@ -2161,6 +2451,7 @@ void PSGPUWrapper::HbmToSparseTable() {
     PADDLE_THROW(
         platform::errors::Fatal("[EndPass] current task has been ended."));
   }
+  std::shared_ptr<HeterContext> gpu_task = current_task_;
   size_t keysize_max = 0;
   // in case of feasign_num = 0, skip dump_to_cpu
 
@@ -2176,7 +2467,10 @@ void PSGPUWrapper::HbmToSparseTable() {
   int once_cpu_num = 16 * 1024;
   int once_gpu_copy = 8 * once_cpu_num;
 
-  auto dump_pool_to_cpu_func = [this, &accessor_wrapper_ptr, once_cpu_num](
+  auto dump_pool_to_cpu_func = [this,
+                                &accessor_wrapper_ptr,
+                                &gpu_task,
+                                once_cpu_num](
                                    int i, size_t once_gpu_copy) {
     platform::Timer tm;
     tm.Start();
@@ -2192,7 +2486,7 @@ void PSGPUWrapper::HbmToSparseTable() {
       size_t feature_value_size =
           accessor_wrapper_ptr->GetFeatureValueSize(mf_dim);
 
-      auto& device_keys = this->current_task_->device_dim_keys_[i][j];
+      auto& device_keys = gpu_task->device_dim_keys_[i][j];
       size_t len = device_keys.size();
       size_t start = 0;
       while (start < len) {
@@ -2202,14 +2496,9 @@ void PSGPUWrapper::HbmToSparseTable() {
         std::shared_ptr<char> build_values(
             new char[feature_value_size * real_len],
             [](char* p) { delete[] p; });
-        uint64_t offset = start * feature_value_size;
         char* test_build_values = build_values.get();
 
-        cudaMemcpyAsync(test_build_values,
-                        hbm_pool->mem() + offset,
-                        feature_value_size * real_len,
-                        cudaMemcpyDeviceToHost,
-                        stream);
+        hbm_pool->copy_to_host(start, test_build_values, real_len, stream);
         for (size_t k = 0; k < real_len; k = k + once_cpu_num) {
           struct task_info task;
           task.build_values = build_values;
@@ -2231,12 +2520,12 @@ void PSGPUWrapper::HbmToSparseTable() {
     VLOG(1) << "dump_pool_to_cpu_func i=" << i << ", total len=" << total_len
             << ", span=" << tm.ElapsedSec();
   };
-  auto cpu_func = [this, &accessor_wrapper_ptr](int j) {
+  // captured by value, it runs after return when async
+  auto cpu_func = [this, accessor_wrapper_ptr, gpu_task](int j) {
     struct task_info task;
     while (cpu_reday_channels_[j]->Get(task)) {
       auto& device_keys =
-          this->current_task_
-              ->device_dim_keys_[task.device_id][task.multi_mf_dim];
+          gpu_task->device_dim_keys_[task.device_id][task.multi_mf_dim];
       uint64_t unuse_key = std::numeric_limits<uint64_t>::max();
       for (int i = task.start; i < task.end; ++i) {
         if (device_keys[i + task.offset] == unuse_key) {
@@ -2285,6 +2574,15 @@ void PSGPUWrapper::HbmToSparseTable() {
     cpu_reday_channels_[i]->Close();
   }
   gpu_task_futures.clear();
+  if (async) {
+    // the host copies of hbm are filled to the cpu table in background, the
+    // hbm can be rebuilt for the next pass
+    if (keysize_max != 0) {
+      HeterPs_->end_pass();
+    }
+    dump_futures_ = std::move(cpu_task_futures);
+    return;
+  }
   timer.Start();
   for (auto& f : cpu_task_futures) {
     f.wait();
@@ -15,9 +15,11 @@ limitations under the License. */
 #ifdef PADDLE_WITH_HETERPS
 #include <algorithm>
 #include <ctime>
+#include <limits>
 #include <memory>
 #include <numeric>
 
+#include "cub/cub.cuh"
 #include "paddle/fluid/framework/fleet/heter_ps/optimizer_conf.h"
 #include "paddle/fluid/framework/fleet/ps_gpu_wrapper.h"
 #include "paddle/fluid/framework/lod_tensor.h"
@@ -84,6 +86,54 @@ __global__ void PushCopy(FeaturePushValue* dest,
 
 PSGPUWrapper::~PSGPUWrapper() { delete HeterPs_; }
 
+void PSGPUWrapper::DeviceUniqueKeys(int dev_idx, std::vector<uint64_t>* keys) {
+  if (keys->empty()) return;
+  PADDLE_ENFORCE_LE(keys->size(),
+                    static_cast<size_t>(std::numeric_limits<int>::max()),
+                    platform::errors::InvalidArgument(
+                        "Too many keys to dedup on a device, %d.",
+                        keys->size()));
+  int num = static_cast<int>(keys->size());
+  int dev_id = resource_->dev_id(dev_idx);
+  platform::CUDAPlace place(dev_id);
+  platform::CUDADeviceGuard guard(dev_id);
+  auto stream = resource_->local_stream(dev_idx, 0);
+
+  auto buf = memory::Alloc(place, 2 * num * sizeof(uint64_t) + sizeof(int));
+  uint64_t* d_keys = reinterpret_cast<uint64_t*>(buf->ptr());
+  uint64_t* d_sorted = d_keys + num;
+  int* d_uniq_num = reinterpret_cast<int*>(d_sorted + num);
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(d_keys,
+                                             keys->data(),
+                                             num * sizeof(uint64_t),
+                                             cudaMemcpyHostToDevice,
+                                             stream));
+  size_t sort_bytes = 0;
+  size_t unique_bytes = 0;
+  PADDLE_ENFORCE_GPU_SUCCESS(cub::DeviceRadixSort::SortKeys(
+      nullptr, sort_bytes, d_keys, d_sorted, num, 0, 64, stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cub::DeviceSelect::Unique(
+      nullptr, unique_bytes, d_sorted, d_keys, d_uniq_num, num, stream));
+  size_t temp_bytes = std::max(sort_bytes, unique_bytes);
+  auto temp = memory::Alloc(place, temp_bytes);
+  PADDLE_ENFORCE_GPU_SUCCESS(cub::DeviceRadixSort::SortKeys(
+      temp->ptr(), sort_bytes, d_keys, d_sorted, num, 0, 64, stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cub::DeviceSelect::Unique(
+      temp->ptr(), unique_bytes, d_sorted, d_keys, d_uniq_num, num, stream));
+
+  int uniq_num = 0;
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(
+      &uniq_num, d_uniq_num, sizeof(int), cudaMemcpyDeviceToHost, stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
+  keys->resize(uniq_num);
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(keys->data(),
+                                             d_keys,
+                                             uniq_num * sizeof(uint64_t),
+                                             cudaMemcpyDeviceToHost,
+                                             stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
+}
+
 void PSGPUWrapper::CopyKeys(const paddle::platform::Place& place,
                             uint64_t** origin_keys,
                             uint64_t* total_keys,
@@ -18,6 +18,8 @@ limitations under the License. */
 #include <google/protobuf/text_format.h>
 #include <atomic>
 #include <ctime>
+#include <deque>
+#include <future>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -35,6 +37,7 @@ limitations under the License. */
 #endif
 #include "paddle/fluid/distributed/ps/thirdparty/round_robin.h"
 #include "paddle/fluid/framework/channel.h"
+#include "paddle/fluid/framework/data_feed.h"
 #include "paddle/fluid/framework/fleet/heter_context.h"
 #if defined(PADDLE_WITH_PSCORE) && defined(PADDLE_WITH_GPU_GRAPH)
 #include "paddle/fluid/framework/fleet/heter_ps/graph_gpu_wrapper.h"
@@ -206,19 +209,37 @@ class PSGPUWrapper {
   void divide_to_device(std::shared_ptr<HeterContext> gpu_task);
   void add_slot_feature(std::shared_ptr<HeterContext> gpu_task);
   void BuildGPUTask(std::shared_ptr<HeterContext> gpu_task);
+  // select the hot keys of the pass by show and replicate them on every
+  // device, see FLAGS_gpups_hot_key_num
+  void BuildHotKeys(std::shared_ptr<HeterContext> gpu_task);
+  // the number of the keys of a device held in hbm, the others are ordered
+  // behind them by OrderKeysByShow, see FLAGS_gpups_hbm_cache_ratio
+  size_t HbmCacheLen(size_t len);
+  void OrderKeysByShow(std::shared_ptr<HeterContext> gpu_task);
   void PreBuildTask(std::shared_ptr<HeterContext> gpu_task,
                     Dataset* dataset_for_pull);
+  // extract and dedup the keys of the slot records on the devices into the
+  // shards of the task, see FLAGS_gpups_device_key_dedup_chunk
+  void DeviceDedupSlotKeys(std::shared_ptr<HeterContext> gpu_task,
+                           const std::deque<SlotRecord>& records);
+#ifdef PADDLE_WITH_CUDA
+  // sort and dedup the keys by the device in place
+  void DeviceUniqueKeys(int dev_idx, std::vector<uint64_t>* keys);
+#endif
   void BuildPull(std::shared_ptr<HeterContext> gpu_task);
   void PartitionKey(std::shared_ptr<HeterContext> gpu_task);
   void PrepareGPUTask(std::shared_ptr<HeterContext> gpu_task);
   void LoadIntoMemory(bool is_shuffle);
   void BeginPass();
   void EndPass();
+  // Wait for the cpu table filled back by the last EndPass, which returns
+  // before the fill with FLAGS_gpups_pipelined_pass.
+  void WaitEndPass();
   void add_key_to_local(const std::vector<uint64_t>& keys);
   void add_key_to_gputask(std::shared_ptr<HeterContext> gpu_task);
   void resize_gputask(std::shared_ptr<HeterContext> gpu_task);
   void SparseTableToHbm();
-  void HbmToSparseTable();
+  void HbmToSparseTable(bool async = false);
   void start_build_thread();
   void AddSparseKeys();
   void build_pull_thread();
@@ -257,6 +278,7 @@ class PSGPUWrapper {
       this->EndPass();
     }
 #endif
+    WaitEndPass();
     for (size_t i = 0; i < hbm_pools_.size(); i++) {
       delete hbm_pools_[i];
     }
@@ -1029,6 +1051,9 @@ class PSGPUWrapper {
   std::vector<std::shared_ptr<paddle::framework::ChannelObject<task_info>>>
       cpu_reday_channels_;
   std::shared_ptr<HeterContext> current_task_ = nullptr;
+  // the pass whose cpu table is being filled back after EndPass
+  std::shared_ptr<HeterContext> dumping_task_ = nullptr;
+  std::vector<std::future<void>> dump_futures_;
   std::thread buildpull_threads_;
   bool running_ = false;
   std::vector<std::shared_ptr<::ThreadPool>> pull_thread_pool_;
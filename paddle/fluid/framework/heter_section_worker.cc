@@ -409,6 +409,8 @@ void HeterSectionWorker::Run() {
       VLOG(4) << "got one task from task que in heter worker";
       auto message_name = task.first;
       auto micro_id = task.second;
+      platform::Timer stage_timer;
+      stage_timer.Start();
       if (is_last_stage) {
         PADDLE_ENFORCE_EQ(message_name.find("forward") != std::string::npos,
                           1,
@@ -429,6 +431,9 @@ void HeterSectionWorker::Run() {
           BatchPostProcess();
         }
       }
+      stage_timer.Pause();
+      // reported to the trainers for the routes of the mini batches
+      heter_server->ObserveStageTime(stage_timer.ElapsedSec());
     }
   }
 }
@@ -35,8 +35,15 @@
 #include <cryptopp/modes.h>
 #include <cryptopp/smartptr.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "paddle/fluid/framework/io/crypto/cipher_utils.h"
 #include "paddle/fluid/platform/enforce.h"
@@ -44,9 +51,86 @@
 namespace paddle {
 namespace framework {
 
+// The chunked ciphertext of AES_GCM_NoPadding is
+//
+//   magic | chunk_size | plaintext_size | iv | chunk_0 | tag_0 | chunk_1 ...
+//
+// with the sizes in uint64. The chunk i is encrypted by the iv whose last 4
+// bytes are added by i, and every chunk authenticates the header before the
+// chunks, so that the chunks can be neither reordered nor dropped, and they
+// are decrypted independently.
+static const char kChunkedMagic[8] = {'P', 'D', 'A', 'E', 'S', 'C', 'H', 'K'};
+
+static bool IsChunkedCiphertext(const std::string& ciphertext) {
+  return ciphertext.size() >= sizeof(kChunkedMagic) &&
+         std::memcmp(ciphertext.data(), kChunkedMagic, sizeof(kChunkedMagic)) ==
+             0;
+}
+
+static std::string ChunkIV(const std::string& iv, uint64_t i) {
+  std::string chunk_iv = iv;
+  uint32_t carry = static_cast<uint32_t>(i);
+  for (size_t k = chunk_iv.size(); k-- > chunk_iv.size() - 4 && carry > 0;) {
+    uint32_t sum = static_cast<unsigned char>(chunk_iv[k]) + (carry & 0xff);
+    chunk_iv[k] = static_cast<char>(sum & 0xff);
+    carry = (carry >> 8) + (sum >> 8);
+  }
+  return chunk_iv;
+}
+
+// Run fn(0) ... fn(task_num - 1) by thread_num threads, the first exception
+// thrown by fn is rethrown after all threads are joined.
+template <typename Fn>
+static void ParallelRun(size_t task_num, int thread_num, Fn fn) {
+  if (thread_num <= 0) {
+    thread_num = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  size_t worker_num =
+      std::min(task_num, static_cast<size_t>(std::max(thread_num, 1)));
+  if (worker_num <= 1) {
+    for (size_t i = 0; i < task_num; ++i) {
+      fn(i);
+    }
+    return;
+  }
+  std::atomic<size_t> next{0};
+  std::exception_ptr error = nullptr;
+  std::mutex mutex;
+  auto worker = [&]() {
+    while (true) {
+      size_t i = next.fetch_add(1);
+      if (i >= task_num) {
+        return;
+      }
+      try {
+        fn(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error == nullptr) {
+          error = std::current_exception();
+        }
+        next.store(task_num);
+        return;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < worker_num; ++i) {
+    threads.emplace_back(worker);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
 void AESCipher::Init(const std::string& cipher_name,
                      const int& iv_size,
-                     const int& tag_size) {
+                     const int& tag_size,
+                     int64_t chunk_size,
+                     int num_threads) {
   aes_cipher_name_ = cipher_name;
   iv_size_ = iv_size;
   tag_size_ = tag_size;
@@ -54,6 +138,16 @@ void AESCipher::Init(const std::string& cipher_name,
   if (authented_cipher_set.find(cipher_name) != authented_cipher_set.end()) {
     is_authenticated_cipher_ = true;
   }
+  PADDLE_ENFORCE_EQ(
+      chunk_size <= 0 || (is_authenticated_cipher_ && iv_size_ >= 32),
+      true,
+      paddle::platform::errors::InvalidArgument(
+          "The chunked encryption is of AES_GCM_NoPadding with an iv of at "
+          "least 32 bits, but the cipher is %s with an iv of %d bits.",
+          cipher_name,
+          iv_size_));
+  chunk_size_ = std::max<int64_t>(chunk_size, 0);
+  num_threads_ = num_threads;
 }
 
 std::string AESCipher::EncryptInternal(const std::string& plaintext,
@@ -110,7 +204,11 @@ std::string AESCipher::DecryptInternal(const std::string& ciphertext,
   m_filter->Attach(new CryptoPP::StringSink(plaintext));
   CryptoPP::Redirector* filter_redirector = new CryptoPP::Redirector(*m_filter);
   CryptoPP::StringSource(
-      ciphertext.substr(ciphertext_beg), true, filter_redirector);
+      reinterpret_cast<const unsigned char*>(ciphertext.data()) +
+          ciphertext_beg,
+      ciphertext.size() - ciphertext_beg,
+      true,
+      filter_redirector);
 
   return plaintext;
 }
@@ -169,7 +267,11 @@ std::string AESCipher::AuthenticatedDecryptInternal(
   m_filter->Attach(new CryptoPP::StringSink(plaintext));
   CryptoPP::Redirector* filter_redirector = new CryptoPP::Redirector(*m_filter);
   CryptoPP::StringSource(
-      ciphertext.substr(ciphertext_beg), true, filter_redirector);
+      reinterpret_cast<const unsigned char*>(ciphertext.data()) +
+          ciphertext_beg,
+      ciphertext.size() - ciphertext_beg,
+      true,
+      filter_redirector);
   PADDLE_ENFORCE_EQ(
       m_filter->GetLastResult(),
       true,
@@ -178,6 +280,114 @@ std::string AESCipher::AuthenticatedDecryptInternal(
   return plaintext;
 }
 
+std::string AESCipher::ChunkedEncryptInternal(const std::string& plaintext,
+                                              const std::string& key) {
+  const size_t iv_bytes = iv_size_ / 8;
+  const size_t tag_bytes = tag_size_ / 8;
+  const uint64_t chunk_size = static_cast<uint64_t>(chunk_size_);
+  const uint64_t plaintext_size = plaintext.size();
+  const uint64_t chunk_num = (plaintext_size + chunk_size - 1) / chunk_size;
+  PADDLE_ENFORCE_LE(chunk_num,
+                    UINT32_MAX,
+                    paddle::platform::errors::InvalidArgument(
+                        "Too many chunks to encrypt, %d chunks of %d bytes.",
+                        chunk_num,
+                        chunk_size));
+  const std::string iv = CipherUtils::GenKey(iv_size_);
+  const size_t header_bytes = sizeof(kChunkedMagic) + 16 + iv_bytes;
+  std::string ciphertext(header_bytes + plaintext_size + chunk_num * tag_bytes,
+                         '\0');
+  char* header = &ciphertext.at(0);
+  std::memcpy(header, kChunkedMagic, sizeof(kChunkedMagic));
+  std::memcpy(header + sizeof(kChunkedMagic), &chunk_size, 8);
+  std::memcpy(header + sizeof(kChunkedMagic) + 8, &plaintext_size, 8);
+  std::memcpy(header + sizeof(kChunkedMagic) + 16, iv.data(), iv_bytes);
+
+  const unsigned char* key_char =
+      reinterpret_cast<const unsigned char*>(&(key.at(0)));
+  auto* out = reinterpret_cast<unsigned char*>(header + header_bytes);
+  auto* in = reinterpret_cast<const unsigned char*>(plaintext.data());
+  ParallelRun(chunk_num, num_threads_, [&](size_t i) {
+    const uint64_t beg = i * chunk_size;
+    const size_t len = std::min(chunk_size, plaintext_size - beg);
+    const std::string chunk_iv = ChunkIV(iv, i);
+    const auto* iv_char = reinterpret_cast<const unsigned char*>(&chunk_iv[0]);
+    CryptoPP::GCM<CryptoPP::AES>::Encryption encryption;
+    encryption.SetKeyWithIV(key_char, key.size(), iv_char, iv_bytes);
+    unsigned char* chunk = out + beg + i * tag_bytes;
+    encryption.EncryptAndAuthenticate(
+        chunk,
+        chunk + len,
+        tag_bytes,
+        iv_char,
+        static_cast<int>(iv_bytes),
+        reinterpret_cast<const unsigned char*>(header),
+        header_bytes,
+        in + beg,
+        len);
+  });
+  return ciphertext;
+}
+
+std::string AESCipher::ChunkedDecryptInternal(const std::string& ciphertext,
+                                              const std::string& key) {
+  const size_t iv_bytes = iv_size_ / 8;
+  const size_t tag_bytes = tag_size_ / 8;
+  const size_t header_bytes = sizeof(kChunkedMagic) + 16 + iv_bytes;
+  uint64_t chunk_size = 0;
+  uint64_t plaintext_size = 0;
+  if (ciphertext.size() >= header_bytes) {
+    std::memcpy(&chunk_size, ciphertext.data() + sizeof(kChunkedMagic), 8);
+    std::memcpy(
+        &plaintext_size, ciphertext.data() + sizeof(kChunkedMagic) + 8, 8);
+  }
+  const uint64_t chunk_num =
+      chunk_size == 0 ? 0 : (plaintext_size + chunk_size - 1) / chunk_size;
+  PADDLE_ENFORCE_EQ(
+      chunk_size > 0 && plaintext_size <= ciphertext.size() &&
+          ciphertext.size() ==
+              header_bytes + plaintext_size + chunk_num * tag_bytes,
+      true,
+      paddle::platform::errors::InvalidArgument(
+          "Integrity check failed. Invalid chunked ciphertext input of %d "
+          "bytes.",
+          ciphertext.size()));
+  const std::string iv =
+      ciphertext.substr(sizeof(kChunkedMagic) + 16, iv_bytes);
+
+  std::string plaintext(plaintext_size, '\0');
+  const unsigned char* key_char =
+      reinterpret_cast<const unsigned char*>(&(key.at(0)));
+  const auto* header =
+      reinterpret_cast<const unsigned char*>(ciphertext.data());
+  auto* out = reinterpret_cast<unsigned char*>(&plaintext[0]);
+  ParallelRun(chunk_num, num_threads_, [&](size_t i) {
+    const uint64_t beg = i * chunk_size;
+    const size_t len = std::min(chunk_size, plaintext_size - beg);
+    const std::string chunk_iv = ChunkIV(iv, i);
+    const auto* iv_char = reinterpret_cast<const unsigned char*>(&chunk_iv[0]);
+    CryptoPP::GCM<CryptoPP::AES>::Decryption decryption;
+    decryption.SetKeyWithIV(key_char, key.size(), iv_char, iv_bytes);
+    const unsigned char* chunk = header + header_bytes + beg + i * tag_bytes;
+    bool verified = decryption.DecryptAndVerify(out + beg,
+                                                chunk + len,
+                                                tag_bytes,
+                                                iv_char,
+                                                static_cast<int>(iv_bytes),
+                                                header,
+                                                header_bytes,
+                                                chunk,
+                                                len);
+    PADDLE_ENFORCE_EQ(verified,
+                      true,
+                      paddle::platform::errors::InvalidArgument(
+                          "Integrity check failed. Invalid ciphertext input "
+                          "of the chunk %d.",
+                          i));
+  });
+  return plaintext;
+}
+
 void AESCipher::BuildCipher(
     bool for_encrypt,
     bool* need_iv,
@@ -276,12 +486,19 @@ void AESCipher::BuildAuthDecCipher(
 
 std::string AESCipher::Encrypt(const std::string& plaintext,
                                const std::string& key) {
+  if (chunk_size_ > 0) {
+    return ChunkedEncryptInternal(plaintext, key);
+  }
   return is_authenticated_cipher_ ? AuthenticatedEncryptInternal(plaintext, key)
                                   : EncryptInternal(plaintext, key);
 }
 
 std::string AESCipher::Decrypt(const std::string& ciphertext,
                                const std::string& key) {
+  // The chunked ciphertext is told by its magic, whatever the chunk_size is.
+  if (is_authenticated_cipher_ && IsChunkedCiphertext(ciphertext)) {
+    return ChunkedDecryptInternal(ciphertext, key);
+  }
   return is_authenticated_cipher_
              ? AuthenticatedDecryptInternal(ciphertext, key)
              : DecryptInternal(ciphertext, key);
@@ -27,6 +27,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 #include "paddle/fluid/framework/io/crypto/cipher.h"
@@ -61,9 +62,14 @@ class AESCipher : public Cipher {
   std::string DecryptFromFile(const std::string& key,
                               const std::string& filename) override;
 
+  // With a positive chunk_size, AES_GCM_NoPadding encrypts the plaintext by
+  // chunks of chunk_size bytes, which are decrypted by num_threads threads, or
+  // the cores if num_threads is not positive.
   void Init(const std::string& cipher_name,
             const int& iv_size,
-            const int& tag_size);
+            const int& tag_size,
+            int64_t chunk_size = 0,
+            int num_threads = 0);
 
  private:
   std::string EncryptInternal(const std::string& plaintext,
@@ -76,6 +82,11 @@ class AESCipher : public Cipher {
   std::string AuthenticatedDecryptInternal(const std::string& ciphertext,
                                            const std::string& key);
 
+  std::string ChunkedEncryptInternal(const std::string& plaintext,
+                                     const std::string& key);
+  std::string ChunkedDecryptInternal(const std::string& ciphertext,
+                                     const std::string& key);
+
   void BuildCipher(
       bool for_encrypt,
       bool* need_iv,
@@ -97,6 +108,8 @@ class AESCipher : public Cipher {
   int tag_size_;
   std::string iv_;
   bool is_authenticated_cipher_{false};
+  int64_t chunk_size_{0};
+  int num_threads_{0};
 };
 
 }  // namespace framework
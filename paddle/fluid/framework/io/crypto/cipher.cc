@@ -26,6 +26,8 @@ std::shared_ptr<Cipher> CipherFactory::CreateCipher(
   std::string cipher_name;
   int iv_size = 0;
   int tag_size = 0;
+  int64_t chunk_size = 0;
+  int num_threads = 0;
   std::unordered_map<std::string, std::string> config;
   if (!config_file.empty()) {
     config = CipherUtils::LoadConfig(config_file);
@@ -46,7 +48,12 @@ std::shared_ptr<Cipher> CipherFactory::CreateCipher(
         !CipherUtils::GetValue<int>(config, "tag_size", &tag_size)) {
       tag_size = CipherUtils::AES_DEFAULT_IV_SIZE;
     }
-    ret->Init(cipher_name, iv_size, tag_size);
+    // the chunked encryption is off by default
+    if (!config_file.empty()) {
+      CipherUtils::GetValue<int64_t>(config, "chunk_size", &chunk_size);
+      CipherUtils::GetValue<int>(config, "num_threads", &num_threads);
+    }
+    ret->Init(cipher_name, iv_size, tag_size, chunk_size, num_threads);
     return ret;
   } else {
     PADDLE_THROW(paddle::platform::errors::InvalidArgument(
@@ -16,10 +16,16 @@ limitations under the License. */
 
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include "glog/logging.h"
 #include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_int32(hdfs_read_ahead_files);
 
 namespace paddle {
 namespace framework {
@@ -270,10 +276,7 @@ void set_download_command(const std::string& x) {
   customized_download_cmd_internal() = x;
 }
 
-std::shared_ptr<FILE> hdfs_open_read(std::string path,
-                                     int* err_no,
-                                     const std::string& converter,
-                                     bool read_data) {
+static std::string hdfs_read_command(std::string path, bool read_data) {
   if (!download_cmd().empty()) {  // use customized download command
     path = string::format_string(
         "%s \"%s\"", download_cmd().c_str(), path.c_str());
@@ -296,9 +299,74 @@ std::shared_ptr<FILE> hdfs_open_read(std::string path,
       }
     }
   }
+  return path;
+}
+
+// The pipes opened by hdfs_read_ahead by their commands, with the err_no
+// written when they are closed.
+struct HdfsReadAheadPipe {
+  std::shared_ptr<FILE> fp;
+  std::shared_ptr<int> err_no;
+};
 
+static std::mutex hdfs_read_ahead_mutex;
+
+static std::unordered_map<std::string, HdfsReadAheadPipe>&
+hdfs_read_ahead_pipes() {
+  static std::unordered_map<std::string, HdfsReadAheadPipe> x;
+  return x;
+}
+
+void hdfs_read_ahead(const std::string& path,
+                     const std::string& converter,
+                     bool read_data) {
+  std::string cmd = hdfs_read_command(path, read_data);
+  bool is_pipe = true;
+  fs_add_read_converter_internal(cmd, is_pipe, converter);
+  size_t max_pipes = std::max(FLAGS_hdfs_read_ahead_files, 0);
+  std::lock_guard<std::mutex> lock(hdfs_read_ahead_mutex);
+  auto& pipes = hdfs_read_ahead_pipes();
+  if (pipes.size() >= max_pipes || pipes.count(cmd) > 0) {
+    return;
+  }
+  HdfsReadAheadPipe pipe;
+  pipe.err_no = std::make_shared<int>(0);
+  pipe.fp = fs_open_internal(
+      cmd, is_pipe, "r", hdfs_buffer_size(), pipe.err_no.get());
+  if (pipe.fp != nullptr) {
+    pipes.emplace(cmd, std::move(pipe));
+  }
+}
+
+std::shared_ptr<FILE> hdfs_open_read(std::string path,
+                                     int* err_no,
+                                     const std::string& converter,
+                                     bool read_data) {
+  path = hdfs_read_command(path, read_data);
   bool is_pipe = true;
   fs_add_read_converter_internal(path, is_pipe, converter);
+  if (FLAGS_hdfs_read_ahead_files > 0) {
+    HdfsReadAheadPipe pipe;
+    {
+      std::lock_guard<std::mutex> lock(hdfs_read_ahead_mutex);
+      auto it = hdfs_read_ahead_pipes().find(path);
+      if (it != hdfs_read_ahead_pipes().end()) {
+        pipe = std::move(it->second);
+        hdfs_read_ahead_pipes().erase(it);
+      }
+    }
+    if (pipe.fp != nullptr) {
+      VLOG(3) << "Take the pipe[" << path << "] opened ahead";
+      FILE* fp = pipe.fp.get();
+      return {fp, [pipe, err_no](FILE*) mutable {
+                std::shared_ptr<int> pipe_err_no = pipe.err_no;
+                pipe.fp = nullptr;
+                if (*pipe_err_no != 0) {
+                  *err_no = *pipe_err_no;
+                }
+              }};
+    }
+  }
   return fs_open_internal(path, is_pipe, "r", hdfs_buffer_size(), err_no);
 }
 
@@ -77,6 +77,13 @@ extern std::shared_ptr<FILE> hdfs_open_read(std::string path,
                                             const std::string& converter,
                                             bool read_data);
 
+// Opens the pipe of hdfs_open_read(path, converter, read_data) ahead, which
+// is taken by the hdfs_open_read later, at most
+// FLAGS_hdfs_read_ahead_files pipes are kept.
+extern void hdfs_read_ahead(const std::string& path,
+                            const std::string& converter,
+                            bool read_data);
+
 extern std::shared_ptr<FILE> hdfs_open_write(std::string path,
                                              int* err_no,
                                              const std::string& converter);
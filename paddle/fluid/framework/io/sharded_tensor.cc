@@ -0,0 +1,439 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/framework/io/sharded_tensor.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/fluid/framework/io/fs.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/fluid/string/string_helper.h"
+#include "paddle/phi/common/data_type.h"
+#include "paddle/phi/common/place.h"
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+constexpr char kShardedTensorMagic[] = "PADDLE_SHARDED_TENSOR";
+constexpr int kShardedTensorVersion = 1;
+
+struct ShardedChunkMeta {
+  int64_t begin_row = 0;
+  int64_t end_row = 0;
+  uint64_t raw_bytes = 0;
+  // a chunk is stored raw if it is not smaller after compression
+  uint64_t stored_bytes = 0;
+  uint32_t crc = 0;
+};
+
+struct ShardedTensorMeta {
+  phi::DataType dtype = phi::DataType::UNDEFINED;
+  std::vector<int64_t> dims;
+  phi::LoD lod;
+  int64_t row_num = 0;
+  uint64_t row_bytes = 0;
+  std::vector<ShardedChunkMeta> chunks;
+};
+
+std::string ChunkPath(const std::string& dir, size_t i) {
+  return string::format_string("%s/chunk_%05zu", dir.c_str(), i);
+}
+
+// Run fn(0) ... fn(task_num - 1) by thread_num threads, the first exception
+// thrown by fn is rethrown after all threads are joined.
+template <typename Fn>
+void ParallelRun(size_t task_num, int thread_num, Fn fn) {
+  size_t worker_num =
+      std::min(task_num, static_cast<size_t>(std::max(thread_num, 1)));
+  std::atomic<size_t> next{0};
+  std::exception_ptr error = nullptr;
+  std::mutex mutex;
+  auto worker = [&]() {
+    while (true) {
+      size_t i = next.fetch_add(1);
+      if (i >= task_num) {
+        return;
+      }
+      try {
+        fn(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error == nullptr) {
+          error = std::current_exception();
+        }
+        // the other workers stop at their next task
+        next.store(task_num);
+        return;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < worker_num; ++i) {
+    threads.emplace_back(worker);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+void WriteWholeFile(const std::string& path, const char* data, size_t size) {
+  int err_no = 0;
+  std::shared_ptr<FILE> fp = fs_open_write(path, &err_no, "");
+  PADDLE_ENFORCE_NOT_NULL(
+      fp.get(),
+      phi::errors::Unavailable("Cannot open %s to save the sharded tensor.",
+                               path));
+  size_t write_count = size == 0 ? 0 : fwrite(data, 1, size, fp.get());
+  fp.reset();
+  PADDLE_ENFORCE_EQ(
+      write_count == size && err_no == 0,
+      true,
+      phi::errors::Unavailable(
+          "Failed to write %s, wrote %d of %d bytes, err_no %d.",
+          path,
+          write_count,
+          size,
+          err_no));
+}
+
+std::string ReadWholeFile(const std::string& path, size_t size_hint = 0) {
+  int err_no = 0;
+  std::shared_ptr<FILE> fp = fs_open_read(path, &err_no, "");
+  PADDLE_ENFORCE_NOT_NULL(
+      fp.get(),
+      phi::errors::Unavailable("Cannot open %s to load the sharded tensor.",
+                               path));
+  std::string data;
+  data.resize(std::max(size_hint, static_cast<size_t>(4096)));
+  size_t size = 0;
+  while (true) {
+    if (size == data.size()) {
+      data.resize(data.size() * 2);
+    }
+    size_t read_count = fread(&data[size], 1, data.size() - size, fp.get());
+    if (read_count == 0) {
+      break;
+    }
+    size += read_count;
+  }
+  fp.reset();
+  PADDLE_ENFORCE_EQ(
+      err_no,
+      0,
+      phi::errors::Unavailable("Failed to read %s, err_no %d.", path, err_no));
+  data.resize(size);
+  return data;
+}
+
+std::string SerializeMeta(const ShardedTensorMeta& meta) {
+  std::ostringstream os;
+  os << kShardedTensorMagic << " " << kShardedTensorVersion << "\n";
+  os << "dtype " << static_cast<int>(meta.dtype) << "\n";
+  os << "dims " << meta.dims.size();
+  for (auto dim : meta.dims) {
+    os << " " << dim;
+  }
+  os << "\n";
+  os << "lod " << meta.lod.size() << "\n";
+  for (auto& level : meta.lod) {
+    os << "level " << level.size();
+    for (auto offset : level) {
+      os << " " << offset;
+    }
+    os << "\n";
+  }
+  os << "chunks " << meta.chunks.size() << "\n";
+  for (auto& chunk : meta.chunks) {
+    os << "chunk " << chunk.begin_row << " " << chunk.end_row << " "
+       << chunk.raw_bytes << " " << chunk.stored_bytes << " " << chunk.crc
+       << "\n";
+  }
+  return os.str();
+}
+
+ShardedTensorMeta LoadMeta(const std::string& dir) {
+  std::string path = dir + "/" + kShardedTensorManifest;
+  std::istringstream is(ReadWholeFile(path));
+  auto expect = [&is, &path](const char* key) {
+    std::string name;
+    is >> name;
+    PADDLE_ENFORCE_EQ(
+        static_cast<bool>(is) && name == key,
+        true,
+        phi::errors::InvalidArgument(
+            "The manifest %s is damaged, expect %s but read %s.",
+            path,
+            key,
+            name));
+  };
+
+  ShardedTensorMeta meta;
+  int version = 0;
+  expect(kShardedTensorMagic);
+  is >> version;
+  PADDLE_ENFORCE_EQ(version,
+                    kShardedTensorVersion,
+                    phi::errors::InvalidArgument(
+                        "The sharded tensor version %d of %s is not supported.",
+                        version,
+                        path));
+  int dtype = 0;
+  expect("dtype");
+  is >> dtype;
+  meta.dtype = static_cast<phi::DataType>(dtype);
+  size_t num = 0;
+  expect("dims");
+  is >> num;
+  meta.dims.resize(num);
+  for (auto& dim : meta.dims) {
+    is >> dim;
+  }
+  expect("lod");
+  is >> num;
+  meta.lod.resize(num);
+  for (auto& level : meta.lod) {
+    expect("level");
+    is >> num;
+    level.resize(num);
+    for (auto& offset : level) {
+      is >> offset;
+    }
+  }
+  expect("chunks");
+  is >> num;
+  meta.chunks.resize(num);
+  for (auto& chunk : meta.chunks) {
+    expect("chunk");
+    is >> chunk.begin_row >> chunk.end_row >> chunk.raw_bytes >>
+        chunk.stored_bytes >> chunk.crc;
+  }
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(is),
+      true,
+      phi::errors::InvalidArgument("The manifest %s is damaged.", path));
+
+  int64_t numel = 1;
+  for (auto dim : meta.dims) {
+    numel *= dim;
+  }
+  meta.row_num = meta.dims.empty() ? 1 : meta.dims[0];
+  meta.row_bytes = meta.row_num == 0
+                       ? 0
+                       : numel / meta.row_num * phi::SizeOf(meta.dtype);
+  return meta;
+}
+
+// Read the chunk i and decompress it into dst of chunk.raw_bytes.
+void LoadChunk(const std::string& dir,
+               size_t i,
+               const ShardedChunkMeta& chunk,
+               char* dst) {
+  std::string path = ChunkPath(dir, i);
+  std::string data = ReadWholeFile(path, chunk.stored_bytes);
+  PADDLE_ENFORCE_EQ(data.size(),
+                    chunk.stored_bytes,
+                    phi::errors::InvalidArgument(
+                        "The chunk %s is damaged, expect %d bytes but read %d.",
+                        path,
+                        chunk.stored_bytes,
+                        data.size()));
+  if (chunk.stored_bytes == chunk.raw_bytes) {
+    memcpy(dst, data.data(), data.size());
+  } else {
+    uLongf raw_bytes = chunk.raw_bytes;
+    int ret = uncompress(reinterpret_cast<Bytef*>(dst),
+                         &raw_bytes,
+                         reinterpret_cast<const Bytef*>(data.data()),
+                         data.size());
+    PADDLE_ENFORCE_EQ(
+        ret == Z_OK && raw_bytes == chunk.raw_bytes,
+        true,
+        phi::errors::InvalidArgument(
+            "Failed to decompress the chunk %s, zlib error %d.", path, ret));
+  }
+  uint32_t crc =
+      crc32(0L, reinterpret_cast<const Bytef*>(dst), chunk.raw_bytes);
+  PADDLE_ENFORCE_EQ(crc,
+                    chunk.crc,
+                    phi::errors::InvalidArgument(
+                        "The checksum of the chunk %s mismatches.", path));
+}
+
+}  // namespace
+
+void SaveShardedTensor(const phi::DenseTensor& x,
+                       const std::string& dir,
+                       const ShardedTensorOptions& options) {
+  PADDLE_ENFORCE_EQ(x.IsInitialized() || x.numel() == 0,
+                    true,
+                    phi::errors::InvalidArgument(
+                        "The tensor to save to %s is not initialized.", dir));
+  PADDLE_ENFORCE_EQ(
+      x.numel() == 0 || x.place().GetType() == phi::AllocationType::CPU,
+      true,
+      phi::errors::InvalidArgument(
+          "The sharded tensor saved to %s should be on cpu, but is on %s.",
+          dir,
+          x.place()));
+
+  ShardedTensorMeta meta;
+  meta.dtype = x.dtype();
+  meta.dims = common::vectorize(x.dims());
+  meta.lod = x.lod();
+  meta.row_num = meta.dims.empty() ? 1 : meta.dims[0];
+  size_t total_bytes = x.numel() * phi::SizeOf(meta.dtype);
+  meta.row_bytes = meta.row_num == 0 ? 0 : total_bytes / meta.row_num;
+  uint64_t row_bytes = std::max(meta.row_bytes, static_cast<uint64_t>(1));
+  int64_t rows_per_chunk = std::max(
+      static_cast<int64_t>(options.chunk_bytes / row_bytes),
+      static_cast<int64_t>(1));
+  for (int64_t row = 0; row < meta.row_num; row += rows_per_chunk) {
+    ShardedChunkMeta chunk;
+    chunk.begin_row = row;
+    chunk.end_row = std::min(row + rows_per_chunk, meta.row_num);
+    chunk.raw_bytes = (chunk.end_row - chunk.begin_row) * meta.row_bytes;
+    meta.chunks.push_back(chunk);
+  }
+
+  fs_mkdir(dir);
+  // a stale manifest would describe the chunks being overwritten
+  std::string manifest = dir + "/" + kShardedTensorManifest;
+  if (fs_exists(manifest)) {
+    fs_remove(manifest);
+  }
+
+  const char* base =
+      total_bytes == 0 ? nullptr : reinterpret_cast<const char*>(x.data());
+  VLOG(3) << "save sharded tensor to " << dir << ", " << total_bytes
+          << " bytes in " << meta.chunks.size() << " chunks";
+  ParallelRun(meta.chunks.size(), options.thread_num, [&](size_t i) {
+    auto& chunk = meta.chunks[i];
+    const char* src = base + chunk.begin_row * meta.row_bytes;
+    chunk.crc =
+        crc32(0L, reinterpret_cast<const Bytef*>(src), chunk.raw_bytes);
+    std::string buf;
+    if (options.compress_level > 0) {
+      uLongf stored_bytes = compressBound(chunk.raw_bytes);
+      buf.resize(stored_bytes);
+      int ret = compress2(reinterpret_cast<Bytef*>(&buf[0]),
+                          &stored_bytes,
+                          reinterpret_cast<const Bytef*>(src),
+                          chunk.raw_bytes,
+                          std::min(options.compress_level, 9));
+      PADDLE_ENFORCE_EQ(ret,
+                        Z_OK,
+                        phi::errors::External(
+                            "Failed to compress the chunk %d of %s, zlib "
+                            "error %d.",
+                            i,
+                            dir,
+                            ret));
+      buf.resize(stored_bytes);
+    }
+    if (options.compress_level > 0 && buf.size() < chunk.raw_bytes) {
+      chunk.stored_bytes = buf.size();
+      WriteWholeFile(ChunkPath(dir, i), buf.data(), buf.size());
+    } else {
+      chunk.stored_bytes = chunk.raw_bytes;
+      WriteWholeFile(ChunkPath(dir, i), src, chunk.raw_bytes);
+    }
+  });
+
+  std::string content = SerializeMeta(meta);
+  WriteWholeFile(manifest, content.data(), content.size());
+}
+
+void LoadShardedTensor(const std::string& dir,
+                       phi::DenseTensor* out,
+                       int thread_num) {
+  PADDLE_ENFORCE_NOT_NULL(out,
+                          phi::errors::InvalidArgument(
+                              "The variable to be loaded cannot be found."));
+  ShardedTensorMeta meta = LoadMeta(dir);
+  out->Resize(common::make_ddim(meta.dims));
+  char* base =
+      reinterpret_cast<char*>(out->mutable_data(phi::CPUPlace(), meta.dtype));
+  out->set_lod(meta.lod);
+  ParallelRun(meta.chunks.size(), thread_num, [&](size_t i) {
+    auto& chunk = meta.chunks[i];
+    LoadChunk(dir, i, chunk, base + chunk.begin_row * meta.row_bytes);
+  });
+}
+
+void LoadShardedTensorRows(const std::string& dir,
+                           int64_t begin_row,
+                           int64_t end_row,
+                           phi::DenseTensor* out,
+                           int thread_num) {
+  PADDLE_ENFORCE_NOT_NULL(out,
+                          phi::errors::InvalidArgument(
+                              "The variable to be loaded cannot be found."));
+  ShardedTensorMeta meta = LoadMeta(dir);
+  PADDLE_ENFORCE_EQ(
+      !meta.dims.empty() && begin_row >= 0 && begin_row <= end_row &&
+          end_row <= meta.row_num,
+      true,
+      phi::errors::OutOfRange("The rows [%d, %d) are out of the %d rows of the "
+                              "sharded tensor %s.",
+                              begin_row,
+                              end_row,
+                              meta.row_num,
+                              dir));
+  std::vector<int64_t> dims = meta.dims;
+  dims[0] = end_row - begin_row;
+  out->Resize(common::make_ddim(dims));
+  char* base =
+      reinterpret_cast<char*>(out->mutable_data(phi::CPUPlace(), meta.dtype));
+  out->set_lod({});
+
+  std::vector<size_t> chunk_ids;
+  for (size_t i = 0; i < meta.chunks.size(); ++i) {
+    auto& chunk = meta.chunks[i];
+    if (chunk.end_row > begin_row && chunk.begin_row < end_row) {
+      chunk_ids.push_back(i);
+    }
+  }
+  ParallelRun(chunk_ids.size(), thread_num, [&](size_t k) {
+    size_t i = chunk_ids[k];
+    auto& chunk = meta.chunks[i];
+    int64_t first = std::max(chunk.begin_row, begin_row);
+    int64_t last = std::min(chunk.end_row, end_row);
+    char* dst = base + (first - begin_row) * meta.row_bytes;
+    if (first == chunk.begin_row && last == chunk.end_row) {
+      LoadChunk(dir, i, chunk, dst);
+      return;
+    }
+    std::vector<char> buf(chunk.raw_bytes);
+    LoadChunk(dir, i, chunk, buf.data());
+    memcpy(dst,
+           buf.data() + (first - chunk.begin_row) * meta.row_bytes,
+           (last - first) * meta.row_bytes);
+  });
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,55 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace paddle {
+namespace framework {
+
+// A sharded tensor is a directory of local fs or hdfs, every chunk of rows of
+// dim 0 is a file compressed by zlib, and the manifest file describes the
+// tensor and the chunks. The chunks are compressed and written by several
+// threads, and a range of rows is restored by reading only its chunks.
+constexpr char kShardedTensorManifest[] = "manifest";
+
+struct ShardedTensorOptions {
+  // the raw bytes of a chunk, a chunk has at least one row
+  size_t chunk_bytes = 64UL << 20;
+  int thread_num = 8;
+  // zlib level, 0 to store the chunks uncompressed
+  int compress_level = 1;
+};
+
+// x must be a cpu tensor. The manifest is written after all chunks, so a
+// directory without the manifest is an incomplete checkpoint.
+void SaveShardedTensor(const phi::DenseTensor& x,
+                       const std::string& dir,
+                       const ShardedTensorOptions& options = {});
+
+void LoadShardedTensor(const std::string& dir,
+                       phi::DenseTensor* out,
+                       int thread_num = 8);
+
+// Restore the rows [begin_row, end_row) of dim 0 into a cpu tensor, the lod
+// is not restored.
+void LoadShardedTensorRows(const std::string& dir,
+                           int64_t begin_row,
+                           int64_t end_row,
+                           phi::DenseTensor* out,
+                           int thread_num = 8);
+
+}  // namespace framework
+}  // namespace paddle
@@ -36,6 +36,9 @@ CostData::~CostData() {  // NOLINT
 }
 
 double CostData::GetOpTimeMs(int op_id) const { return op_time_ms_.at(op_id); }
+bool CostData::HasOpTime(int op_id) const {
+  return op_time_ms_.count(op_id) > 0;
+}
 double CostData::GetOpMemoryBytes(int op_id) const {
   return op_memory_bytes_.at(op_id);
 }
@@ -40,6 +40,7 @@ class CostData {
   // Support global block only
   // TODO(zhhsplendid): add support for sub-block
   double GetOpTimeMs(int op_id) const;
+  bool HasOpTime(int op_id) const;
   double GetOpMemoryBytes(int op_id) const;
   double GetWholeTimeMs() const;
   double GetWholeMemoryBytes() const;
@@ -0,0 +1,214 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/ir/embedding_seqpool_concat_fuse_pass.h"
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "paddle/fluid/framework/ir/graph_helper.h"
+#include "paddle/fluid/framework/ir/graph_pattern_detector.h"
+#include "paddle/fluid/framework/ir/pass.h"
+#include "paddle/fluid/framework/op_version_registry.h"
+
+namespace paddle {
+namespace framework {
+namespace ir {
+
+namespace {
+
+// the slot of lookup_table -> sequence_pool -> the input of concat
+struct EmbeddingSlot {
+  Node* ids{nullptr};
+  Node* table{nullptr};
+  Node* lookup_op{nullptr};
+  Node* emb{nullptr};
+  Node* seqpool_op{nullptr};
+  std::vector<Node*> seqpool_outs;
+};
+
+Node* FindVar(const std::vector<Node*>& nodes, const std::string& name) {
+  for (auto* node : nodes) {
+    if (node->IsVar() && node->Name() == name) return node;
+  }
+  return nullptr;
+}
+
+bool IsSingleInput(const OpDesc* op, const std::string& param) {
+  return op->Inputs().count(param) && op->Input(param).size() == 1;
+}
+
+// match the slot whose sum pooled embedding is the concat input var pooled
+bool MatchEmbeddingSlot(Node* pooled, EmbeddingSlot* slot) {
+  if (pooled->inputs.size() != 1 || pooled->outputs.size() != 1) return false;
+  Node* seqpool_op = pooled->inputs[0];
+  if (!seqpool_op->IsOp() || seqpool_op->Op()->Type() != "sequence_pool") {
+    return false;
+  }
+  auto* seqpool = seqpool_op->Op();
+  if (!seqpool->HasAttr("pooltype") ||
+      PADDLE_GET_CONST(std::string, seqpool->GetAttr("pooltype")) != "SUM" ||
+      seqpool->Output("Out") != std::vector<std::string>{pooled->Name()}) {
+    return false;
+  }
+  // the empty sequences are pooled to zeros by the fused op
+  if (seqpool->HasAttr("pad_value") &&
+      PADDLE_GET_CONST(float, seqpool->GetAttr("pad_value")) != 0.0f) {
+    return false;
+  }
+  // the other output (MaxIndex) should be unused
+  for (auto* out : seqpool_op->outputs) {
+    if (out != pooled && !out->outputs.empty()) return false;
+  }
+  if (!IsSingleInput(seqpool, "X")) return false;
+  Node* emb = FindVar(seqpool_op->inputs, seqpool->Input("X")[0]);
+  if (emb == nullptr || emb->inputs.size() != 1 || emb->outputs.size() != 1 ||
+      emb->Var() == nullptr || emb->Var()->GetShape().size() != 2) {
+    return false;
+  }
+
+  Node* lookup_op = emb->inputs[0];
+  if (!lookup_op->IsOp()) return false;
+  auto* lookup = lookup_op->Op();
+  if (lookup->Type() != "lookup_table" && lookup->Type() != "lookup_table_v2") {
+    return false;
+  }
+  for (auto* attr : {"is_distributed", "remote_prefetch"}) {
+    if (lookup->HasAttr(attr) &&
+        PADDLE_GET_CONST(bool, lookup->GetAttr(attr))) {
+      return false;
+    }
+  }
+  if (!IsSingleInput(lookup, "Ids") || !IsSingleInput(lookup, "W")) {
+    return false;
+  }
+  Node* ids = FindVar(lookup_op->inputs, lookup->Input("Ids")[0]);
+  Node* table = FindVar(lookup_op->inputs, lookup->Input("W")[0]);
+  if (ids == nullptr || table == nullptr || ids->Var() == nullptr ||
+      ids->Var()->GetDataType() != proto::VarType::INT64) {
+    return false;
+  }
+
+  slot->ids = ids;
+  slot->table = table;
+  slot->lookup_op = lookup_op;
+  slot->emb = emb;
+  slot->seqpool_op = seqpool_op;
+  slot->seqpool_outs = seqpool_op->outputs;
+  return true;
+}
+
+template <typename T>
+T GetAttrOr(const OpDesc* op, const std::string& name, T value) {
+  return op->HasAttr(name) ? PADDLE_GET_CONST(T, op->GetAttr(name)) : value;
+}
+
+bool FuseConcat(Graph* graph, Node* concat_op) {
+  auto* concat = concat_op->Op();
+  if (concat->Type() != "concat" || concat->Outputs().at("Out").size() != 1 ||
+      GetAttrOr<int>(concat, "axis", 0) != 1) {
+    return false;
+  }
+  if (concat->Inputs().count("AxisTensor") &&
+      !concat->Input("AxisTensor").empty()) {
+    return false;
+  }
+  const auto& input_names = concat->Input("X");
+  if (input_names.size() < 2) return false;
+  std::unordered_set<std::string> unique_names(input_names.begin(),
+                                               input_names.end());
+  if (unique_names.size() != input_names.size()) return false;
+  Node* concat_out = FindVar(concat_op->outputs, concat->Output("Out")[0]);
+  if (concat_out == nullptr) return false;
+
+  std::vector<EmbeddingSlot> slots(input_names.size());
+  for (size_t i = 0; i < input_names.size(); ++i) {
+    Node* pooled = FindVar(concat_op->inputs, input_names[i]);
+    if (pooled == nullptr || !MatchEmbeddingSlot(pooled, &slots[i])) {
+      return false;
+    }
+  }
+  // all the slots look up the same table in the same way
+  auto* lookup0 = slots[0].lookup_op->Op();
+  const int64_t padding_idx = GetAttrOr<int64_t>(lookup0, "padding_idx", -1);
+  const bool is_sparse = GetAttrOr<bool>(lookup0, "is_sparse", false);
+  for (auto& slot : slots) {
+    auto* lookup = slot.lookup_op->Op();
+    if (slot.table != slots[0].table ||
+        GetAttrOr<int64_t>(lookup, "padding_idx", -1) != padding_idx ||
+        GetAttrOr<bool>(lookup, "is_sparse", false) != is_sparse) {
+      return false;
+    }
+  }
+
+  VLOG(4) << "fuse " << slots.size() << " slots of " << slots[0].table->Name()
+          << " into fused_multi_embedding_seq_pool";
+  std::vector<std::string> ids_names;
+  std::unordered_set<Node*> ids_nodes;
+  std::unordered_set<const Node*> marked_nodes{concat_op};
+  for (auto& slot : slots) {
+    ids_names.push_back(slot.ids->Name());
+    ids_nodes.insert(slot.ids);
+    marked_nodes.insert({slot.lookup_op, slot.emb, slot.seqpool_op});
+    marked_nodes.insert(slot.seqpool_outs.begin(), slot.seqpool_outs.end());
+  }
+
+  OpDesc op_desc;
+  op_desc.SetType("fused_multi_embedding_seq_pool");
+  op_desc.SetInput("Ids", ids_names);
+  op_desc.SetInput("W", {slots[0].table->Name()});
+  op_desc.SetOutput("Out", {concat_out->Name()});
+  op_desc.SetAttr("combiner", std::string("sum"));
+  op_desc.SetAttr("padding_idx", padding_idx);
+  op_desc.SetAttr("is_sparse", is_sparse);
+  auto* op = graph->CreateOpNode(&op_desc);
+  for (auto* ids : ids_nodes) {
+    IR_NODE_LINK_TO(ids, op);
+  }
+  IR_NODE_LINK_TO(slots[0].table, op);
+  IR_NODE_LINK_TO(op, concat_out);
+  GraphSafeRemoveNodes(graph, marked_nodes);
+  return true;
+}
+
+}  // namespace
+
+void EmbeddingSeqPoolConcatFusePass::ApplyImpl(ir::Graph* graph) const {
+  PADDLE_ENFORCE_NOT_NULL(
+      graph, platform::errors::InvalidArgument("Graph cannot be nullptr."));
+  FusePassBase::Init(name_scope_, graph);
+  int fusion_count = 0;
+  // the ops of a fused slot are before its concat, and are not visited again
+  for (auto* node : TopologySortOperations(*graph)) {
+    if (FuseConcat(graph, node)) {
+      ++fusion_count;
+    }
+  }
+  AddStatis(fusion_count);
+}
+
+}  // namespace ir
+}  // namespace framework
+}  // namespace paddle
+
+REGISTER_PASS(embedding_seqpool_concat_fuse_pass,
+              paddle::framework::ir::EmbeddingSeqPoolConcatFusePass);
+REGISTER_PASS_CAPABILITY(embedding_seqpool_concat_fuse_pass)
+    .AddCombination(
+        paddle::framework::compatible::OpVersionComparatorCombination()
+            .LE("lookup_table", 1)
+            .EQ("lookup_table_v2", 0)
+            .EQ("sequence_pool", 0)
+            .EQ("concat", 0));
@@ -0,0 +1,58 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+
+#include "paddle/fluid/framework/ir/fuse_pass_base.h"
+#include "paddle/fluid/framework/ir/graph.h"
+
+namespace paddle {
+namespace framework {
+namespace ir {
+
+/**
+ * Fuse the lookup_table, the SequencePool(with sum pooltype) of every slot
+ * and the Concat of the slots, when all the slots look up the same table;
+ *
+ * Before fuse:
+ *     |            |                  |
+ * lookup_table, lookup_table, ... lookup_table
+ *     |            |                  |
+ *  seq_pool,    seq_pool,     ...  seq_pool
+ *      \           |        ...     /
+ *                concat
+ *                  |
+ * After fuse:
+ *      \           |                /
+ *        FusedMultiEmbeddingSeqPool
+ *                  |
+ *
+ * The slots are matched one by one from the inputs of concat, so there is no
+ * limit of the number of slots.
+ */
+class EmbeddingSeqPoolConcatFusePass : public FusePassBase {
+ public:
+  virtual ~EmbeddingSeqPoolConcatFusePass() {}
+
+ protected:
+  void ApplyImpl(ir::Graph* graph) const override;
+
+  const std::string name_scope_{"embedding_seqpool_concat_fuse"};
+};
+
+}  // namespace ir
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,188 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "paddle/fluid/framework/ir/embedding_seqpool_concat_fuse_pass.h"
+#include "paddle/fluid/framework/op_proto_maker.h"
+
+namespace paddle {
+namespace framework {
+namespace ir {
+
+void AddVar(ProgramDesc* prog,
+            const std::string& name,
+            const std::vector<int64_t>& shape,
+            proto::VarType::Type dtype = proto::VarType::FP32) {
+  auto* var = prog->MutableBlock(0)->Var(name);
+  var->SetType(proto::VarType::LOD_TENSOR);
+  var->SetShape(shape);
+  var->SetDataType(dtype);
+}
+
+void AddSlot(ProgramDesc* prog,
+             const std::string& ids,
+             const std::string& table,
+             const std::string& pooled,
+             int64_t padding_idx = -1) {
+  auto* block = prog->MutableBlock(0);
+  AddVar(prog, ids, {-1, 1}, proto::VarType::INT64);
+  AddVar(prog, ids + "_emb", {-1, 8});
+  AddVar(prog, pooled + "_max_index", {-1, 8});
+  AddVar(prog, pooled, {-1, 8});
+
+  auto* lookup = block->AppendOp();
+  lookup->SetType("lookup_table");
+  lookup->SetInput("Ids", {ids});
+  lookup->SetInput("W", {table});
+  lookup->SetOutput("Out", {ids + "_emb"});
+  lookup->SetAttr("padding_idx", padding_idx);
+  lookup->SetAttr("is_sparse", true);
+  lookup->SetAttr(OpProtoAndCheckerMaker::OpRoleAttrName(),
+                  static_cast<int>(OpRole::kForward));
+
+  auto* seqpool = block->AppendOp();
+  seqpool->SetType("sequence_pool");
+  seqpool->SetInput("X", {ids + "_emb"});
+  seqpool->SetAttr("pooltype", std::string("SUM"));
+  seqpool->SetAttr("pad_value", 0.0f);
+  seqpool->SetOutput("MaxIndex", {pooled + "_max_index"});
+  seqpool->SetOutput("Out", {pooled});
+  seqpool->SetAttr(OpProtoAndCheckerMaker::OpRoleAttrName(),
+                   static_cast<int>(OpRole::kForward));
+}
+
+void AddConcat(ProgramDesc* prog,
+               const std::vector<std::string>& inputs,
+               const std::string& output) {
+  AddVar(prog, output, {-1, 8 * static_cast<int64_t>(inputs.size())});
+  auto* op = prog->MutableBlock(0)->AppendOp();
+  op->SetType("concat");
+  op->SetInput("X", inputs);
+  op->SetAttr("axis", 1);
+  op->SetOutput("Out", {output});
+  op->SetAttr(OpProtoAndCheckerMaker::OpRoleAttrName(),
+              static_cast<int>(OpRole::kForward));
+}
+
+int CountOpType(const ir::Graph* graph,
+                const std::string& op_type = "fused_multi_embedding_seq_pool") {
+  int count = 0;
+  for (auto* node : graph->Nodes()) {
+    if (node->IsOp() && node->Op()->Type() == op_type) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+std::unique_ptr<ir::Graph> ApplyPass(std::unique_ptr<ir::Graph> graph,
+                                     int* before,
+                                     int* after) {
+  auto pass =
+      PassRegistry::Instance().Get("embedding_seqpool_concat_fuse_pass");
+  *before = static_cast<int>(graph->Nodes().size());
+  graph.reset(pass->Apply(graph.release()));
+  *after = static_cast<int>(graph->Nodes().size());
+  return graph;
+}
+
+/*
+ * Before fuse, for each of the 300 slots:
+ *   ids_i   w
+ *      \   /
+ *   lookup_table
+ *        |
+ *    ids_i_emb
+ *        |
+ *   sequence_pool
+ *     /      \
+ *  max_index  pooled_i --> concat --> out
+ *
+ * After fuse:
+ *   ids_0 ... ids_299   w
+ *         \     |      /
+ *   fused_multi_embedding_seq_pool
+ *               |
+ *              out
+ */
+TEST(EmbeddingSeqPoolConcatFusePass, many_slots) {
+  constexpr int kSlots = 300;
+  ProgramDesc prog;
+  AddVar(&prog, "w", {1000, 8});
+  std::vector<std::string> pooled;
+  for (int i = 0; i < kSlots; ++i) {
+    pooled.push_back("pooled_" + std::to_string(i));
+    AddSlot(&prog, "ids_" + std::to_string(i), "w", pooled.back());
+  }
+  AddConcat(&prog, pooled, "out");
+
+  std::unique_ptr<ir::Graph> graph(new ir::Graph(prog));
+  int before = 0, after = 0;
+  graph = ApplyPass(std::move(graph), &before, &after);
+  // Remove 5 nodes of each slot: lookup_table, ids_emb, sequence_pool,
+  // max_index, pooled, and the concat op
+  // Add 1 node: fused_multi_embedding_seq_pool
+  EXPECT_EQ(after, before - 5 * kSlots);
+  EXPECT_EQ(CountOpType(graph.get()), 1);
+  EXPECT_EQ(CountOpType(graph.get(), "lookup_table"), 0);
+  for (auto* node : graph->Nodes()) {
+    if (node->IsOp() &&
+        node->Op()->Type() == "fused_multi_embedding_seq_pool") {
+      EXPECT_EQ(node->Op()->Input("Ids").size(), static_cast<size_t>(kSlots));
+      EXPECT_EQ(node->Op()->Input("Ids")[1], "ids_1");
+      EXPECT_EQ(PADDLE_GET_CONST(bool, node->Op()->GetAttr("is_sparse")), true);
+    }
+  }
+}
+
+/*
+ * The slots of two tables, or a used embedding, are not fused:
+ *   ids_0  w   ids_1  v     ids_2  w   ids_3  w
+ *      |          |            |          |
+ *   lookup     lookup       lookup     lookup --> ids_3_emb --> relu
+ *      |          |            |          |
+ *   seqpool    seqpool      seqpool    seqpool
+ *       \        /              \        /
+ *        concat                  concat
+ */
+TEST(EmbeddingSeqPoolConcatFusePass, not_fused) {
+  ProgramDesc prog;
+  AddVar(&prog, "w", {1000, 8});
+  AddVar(&prog, "v", {1000, 8});
+  AddSlot(&prog, "ids_0", "w", "pooled_0");
+  AddSlot(&prog, "ids_1", "v", "pooled_1");
+  AddConcat(&prog, {"pooled_0", "pooled_1"}, "out_0");
+
+  AddSlot(&prog, "ids_2", "w", "pooled_2");
+  AddSlot(&prog, "ids_3", "w", "pooled_3");
+  AddConcat(&prog, {"pooled_2", "pooled_3"}, "out_1");
+  AddVar(&prog, "relu_out", {-1, 8});
+  auto* relu = prog.MutableBlock(0)->AppendOp();
+  relu->SetType("relu");
+  relu->SetInput("X", {"ids_3_emb"});
+  relu->SetOutput("Out", {"relu_out"});
+
+  std::unique_ptr<ir::Graph> graph(new ir::Graph(prog));
+  int before = 0, after = 0;
+  graph = ApplyPass(std::move(graph), &before, &after);
+  EXPECT_EQ(after, before);
+  EXPECT_EQ(CountOpType(graph.get()), 0);
+}
+
+}  // namespace ir
+}  // namespace framework
+}  // namespace paddle
+
+USE_PASS(embedding_seqpool_concat_fuse_pass);
@@ -14,6 +14,9 @@ limitations under the License. */
 
 #include "paddle/fluid/framework/ir/fusion_group/code_generator.h"
 
+#include <functional>
+#include <numeric>
+
 #include "paddle/fluid/framework/ir/fusion_group/code_generator_helper.h"
 #include "paddle/fluid/framework/ir/fusion_group/cuda_resources.h"
 
@@ -53,6 +56,21 @@ CodeGenerator::CodeGenerator() {
 
 std::string CodeGenerator::Generate(SubGraph* subgraph) {
   std::vector<OperationExpression> expressions = ConvertToExpressions(subgraph);
+  // The inputs broadcast along the trailing dims have less elements than the
+  // outputs.
+  broadcast_numels_.clear();
+  auto output_var_nodes = subgraph->GetOutputVarNodes(true);
+  if (!output_var_nodes.empty()) {
+    std::vector<int64_t> out_shape = output_var_nodes[0]->Var()->GetShape();
+    std::unordered_map<Node*, int> var_ids = EncodeVarNodes(subgraph);
+    for (auto* in : subgraph->GetInputVarNodes()) {
+      std::vector<int64_t> shape = in->Var()->GetShape();
+      if (shape != out_shape) {
+        broadcast_numels_[var_ids[in]] = std::accumulate(
+            shape.begin(), shape.end(), 1LL, std::multiplies<int64_t>());
+      }
+    }
+  }
   return Generate(subgraph->GetFuncName(), expressions);
 }
 
@@ -332,7 +350,7 @@ std::string CodeGenerator::EmitComputeBody(
     if (output_ids.find(id) == output_ids.end() &&
         used.find(id) != used.end()) {
       load << dtypes.at(id) << " " << TmpName(id) << " = "
-           << "__ldg(&" << VarName(id) << ")"
+           << "__ldg(&" << LoadName(id) << ")"
            << ";";
     }
   }
@@ -347,6 +365,14 @@ std::string CodeGenerator::EmitComputeBody(
   return load.str() + compute.str() + store.str();
 }
 
+std::string CodeGenerator::LoadName(int id) const {
+  auto iter = broadcast_numels_.find(id);
+  if (iter == broadcast_numels_.end()) {
+    return VarName(id);
+  }
+  return ArgName(id) + "[idx % " + std::to_string(iter->second) + "]";
+}
+
 std::unordered_map<Node*, int> CodeGenerator::EncodeVarNodes(
     SubGraph* subgraph) {
   const auto& input_var_nodes = subgraph->GetInputVarNodes();
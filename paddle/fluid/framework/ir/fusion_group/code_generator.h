@@ -65,11 +65,17 @@ class CodeGenerator {
       const std::set<int>& intermediate_ids,
       const std::unordered_map<int, std::string>& dtypes) const;
 
+  // The name to load an input var, the inputs broadcast along the trailing
+  // dims are read at idx % numel.
+  std::string LoadName(int id) const;
+
   // Encode all var nodes in the subgraph with an unique number.
   std::unordered_map<Node*, int> EncodeVarNodes(SubGraph* subgraph);
 
  private:
   std::vector<CodeTemplate> code_templates_;
+  // The numels of the inputs broadcast along the trailing dims, by the ids.
+  std::unordered_map<int, int64_t> broadcast_numels_;
 };
 
 }  // namespace fusion_group
@@ -14,6 +14,7 @@ limitations under the License. */
 
 #include "paddle/fluid/framework/ir/fusion_group/elementwise_group_detector.h"
 
+#include <algorithm>
 #include <string>
 
 #include "paddle/fluid/framework/ir/fusion_group/operation.h"
@@ -61,6 +62,60 @@ static bool IsEqualAndNotEmpty(const std::vector<int64_t>& l,
   return !l.empty() && !r.empty() && l == r;
 }
 
+static Node* GetInputVar(const Node* n, const std::string& name) {
+  for (auto* in : n->inputs) {
+    if (in && in->IsVar() && in->Var() && in->Name() == name) {
+      return in;
+    }
+  }
+  return nullptr;
+}
+
+// Whether Y of a forward binary op is broadcast to X along the trailing dims,
+// i.e. the shape of Y is static and equals the last dims of X, and Y is read
+// at idx % numel(Y) in the fused kernel. Y should not be produced by an op
+// which may be fused, so that it stays an input of the subgraph.
+static bool IsTrailingBroadcast(const Node* n) {
+  if (IsGradOp(n)) {
+    return false;
+  }
+  const auto& inputs = n->Op()->Inputs();
+  auto x_names = inputs.find("X");
+  auto y_names = inputs.find("Y");
+  if (x_names == inputs.end() || y_names == inputs.end() ||
+      x_names->second.size() != 1U || y_names->second.size() != 1U) {
+    return false;
+  }
+  Node* x = GetInputVar(n, x_names->second[0]);
+  Node* y = GetInputVar(n, y_names->second[0]);
+  if (!x || !y) {
+    return false;
+  }
+  for (auto* producer : y->inputs) {
+    if (IsSpecifiedOp(GetElementwiseOpTypes(), producer)) {
+      return false;
+    }
+  }
+  std::vector<int64_t> x_shape = x->Var()->GetShape();
+  std::vector<int64_t> y_shape = y->Var()->GetShape();
+  if (y_shape.empty() || y_shape.size() >= x_shape.size()) {
+    return false;
+  }
+  for (auto d : y_shape) {
+    if (d <= 0) {
+      return false;
+    }
+  }
+  auto* op = n->Op();
+  int axis = op->HasAttr("axis") ? op->GetAttrIfExists<int>("axis") : -1;
+  int trailing_axis = static_cast<int>(x_shape.size() - y_shape.size());
+  if (axis != -1 && axis != trailing_axis) {
+    return false;
+  }
+  return std::equal(
+      y_shape.begin(), y_shape.end(), x_shape.begin() + trailing_axis);
+}
+
 bool GroupDetector::CheckPrecondition(const Node* n) {
   auto check_data_type = [&](const std::vector<Node*>& nodes) -> bool {
     bool is_first = true;
@@ -111,7 +166,9 @@ bool GroupDetector::CheckPrecondition(const Node* n) {
 
 bool ElementwiseGroupDetector::IsElementwiseOp(const Node* n) {
   if (IsSpecifiedOp(GetElementwiseOpTypes(), n)) {
-    // Check whether all inputs have the same shape.
+    // Check whether all inputs have the same shape, except Y broadcast along
+    // the trailing dims of X.
+    bool is_broadcast = IsTrailingBroadcast(n);
     bool is_first = true;
     std::vector<int64_t> shape_0;
     for (auto* in_i : n->inputs) {
@@ -120,10 +177,8 @@ bool ElementwiseGroupDetector::IsElementwiseOp(const Node* n) {
         if (is_first) {
           shape_0 = shape_i;
           is_first = false;
-        } else {
-          if (!IsEqualAndNotEmpty(shape_0, shape_i)) {
-            return false;
-          }
+        } else if (!is_broadcast && !IsEqualAndNotEmpty(shape_0, shape_i)) {
+          return false;
         }
       }
     }
@@ -64,6 +64,10 @@ class SubGraph {
               << min_subgraph_size;
       return false;
     }
+    if (!CheckBroadcastInputs()) {
+      VLOG(2) << "The broadcast inputs of the subgraph are not supported.";
+      return false;
+    }
 
     return true;
   }
@@ -204,6 +208,41 @@ class SubGraph {
     return is_output_of_internal_op;
   }
 
+  // All the outputs of the operations should have the same shape, and the
+  // inputs of other shapes should be the inputs of the subgraph, which are
+  // only read as Y broadcast along the trailing dims of X.
+  bool CheckBroadcastInputs() {
+    std::vector<int64_t> out_shape;
+    bool is_first = true;
+    for (auto* n : nodes_set_) {
+      if (IsOutputOfInternalOp(n)) {
+        if (is_first) {
+          out_shape = n->Var()->GetShape();
+          is_first = false;
+        } else if (n->Var()->GetShape() != out_shape) {
+          return false;
+        }
+      }
+    }
+    for (auto* n : nodes_set_) {
+      if (n && n->IsOp() && n->Op()) {
+        for (auto* in : n->inputs) {
+          if (!in || !in->IsVar() || !in->Var() ||
+              in->Var()->GetShape() == out_shape) {
+            continue;
+          }
+          const auto& inputs = n->Op()->Inputs();
+          auto y = inputs.find("Y");
+          if (IsOutputOfInternalOp(in) || y == inputs.end() ||
+              y->second.size() != 1U || y->second[0] != in->Name()) {
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
   void TopologicalSort() {
     if (!is_sorted_) {
       std::unordered_map<Node*, std::vector<Node*>> inputs_map;
@@ -14,6 +14,10 @@
 
 #include "paddle/fluid/framework/ir/graph_pattern_detector.h"
 
+#include <algorithm>
+#include <chrono>
+#include <tuple>
+
 #include "paddle/fluid/framework/ir/graph_traits.h"
 #include "paddle/fluid/framework/ir/graph_viz_pass.h"
 #include "paddle/fluid/framework/operator.h"
@@ -87,6 +91,7 @@ void PDPattern::AddEdge(PDNode *a, PDNode *b) {
 
 void GraphPatternDetector::operator()(Graph *graph,
                                       GraphPatternDetector::handle_t handler) {
+  auto start = std::chrono::steady_clock::now();
   if (!MarkPDNodesInGraph(*graph)) {
     return;
   }
@@ -95,6 +100,12 @@ void GraphPatternDetector::operator()(Graph *graph,
   SortSubgraphs(&subgraphs);
   RemoveOverlappedMatch(&subgraphs);
   ValidateByNodeRole(&subgraphs);
+  VLOG(3) << "detected " << subgraphs.size() << " subgraphs of "
+          << pattern_.nodes().size() << " pattern nodes in "
+          << std::chrono::duration<double, std::milli>(
+                 std::chrono::steady_clock::now() - start)
+                 .count()
+          << " ms";
 
   if (subgraphs.empty()) return;
   int id = 0;
@@ -108,13 +119,47 @@ bool GraphPatternDetector::MarkPDNodesInGraph(const ir::Graph &graph) {
   VLOG(3) << "mark pdnodes in graph";
   if (graph.Nodes().empty()) return false;
 
+  // The nodes to mark, and their op nodes by the op types, so that a PDNode
+  // of asserted op types is told only the nodes of or linked to the types.
+  std::vector<Node *> nodes;
+  std::unordered_set<Node *> node_set;
+  std::unordered_map<std::string, std::vector<Node *>> op_nodes;
   for (auto &node : GraphTraits::DFS(graph)) {
     if (node.Name().rfind("__control_var") == 0) continue;
-    for (const auto &pdnode : pattern_.nodes()) {
-      if (pdnode->Tell(&node)) {
-        VLOG(4) << "Node " << node.Name() << "(" << node.id() << ")"
-                << " marked as " << pdnode->name();
-        pdnodes2nodes_[pdnode.get()].insert(&node);
+    nodes.push_back(&node);
+    node_set.insert(&node);
+    if (node.IsOp() && node.Op()) {
+      op_nodes[node.Op()->Type()].push_back(&node);
+    }
+  }
+  for (const auto &pdnode : pattern_.nodes()) {
+    // Looked up once, as PDNodeCompare is not cheap.
+    std::set<Node *, NodeIdCompare> *marked = nullptr;
+    auto tell = [&](Node *node) {
+      if (!node_set.count(node) || !pdnode->Tell(node)) return;
+      VLOG(4) << "Node " << node->Name() << "(" << node->id() << ")"
+              << " marked as " << pdnode->name();
+      if (marked == nullptr) marked = &pdnodes2nodes_[pdnode.get()];
+      marked->insert(node);
+    };
+    auto hint = pdnode->op_types_hint();
+    if (hint == PDNode::OpTypesHint::kNone) {
+      for (auto *node : nodes) tell(node);
+      continue;
+    }
+    for (const auto &op_type : pdnode->hint_op_types()) {
+      auto it = op_nodes.find(op_type);
+      if (it == op_nodes.end()) continue;
+      for (auto *op : it->second) {
+        if (hint == PDNode::OpTypesHint::kIsOp) {
+          tell(op);
+        } else {
+          for (auto *var : hint == PDNode::OpTypesHint::kIsOpInput
+                               ? op->inputs
+                               : op->outputs) {
+            tell(var);
+          }
+        }
       }
     }
   }
@@ -228,26 +273,77 @@ GraphPatternDetector::DetectPatterns() {
     auto &cur_groups = bi_records[1 - (step++ % 2)];
     cur_groups.clear();
     if (pre_groups.empty()) break;
-    // source -> target
-    for (Node *source : pdnodes2nodes_[edge.first]) {
-      for (Node *target : pdnodes2nodes_[edge.second]) {
-        VLOG(8) << "check " << source->Name() << "(" << source->id() << ")"
-                << " -- " << target->Name() << "(" << target->id() << ")";
-        // TODO(Superjomn) add some prune strategies.
-        for (const auto &group : pre_groups) {
-          if (IsNodesLink(source, target)) {
-            HitGroup new_group = group;
-            bool flag = new_group.Match(source, edge.first) &&
-                        new_group.Match(target, edge.second);
-            if (flag) {
-              new_group.Register(source, edge.first);
-              new_group.Register(target, edge.second);
-              cur_groups.push_back(new_group);
-              // TODO(Superjomn) need to unique
+    const auto &sources = pdnodes2nodes_[edge.first];
+    const auto &targets = pdnodes2nodes_[edge.second];
+    // The groups extended by the (source, target, group) in the order of the
+    // ids of the sources and the targets, as they were by the loops over the
+    // marked nodes, so the overlapped matches are removed the same.
+    std::vector<std::tuple<int, int, size_t, HitGroup>> extended;
+    std::vector<std::pair<Node *, Node *>> links;
+    for (size_t i = 0; i < pre_groups.size(); ++i) {
+      const auto &group = pre_groups[i];
+      // source -> target, along the links of a node that the group has
+      // matched already, instead of over all the pairs of the marked nodes.
+      links.clear();
+      auto source_it = group.roles.find(edge.first);
+      auto target_it = group.roles.find(edge.second);
+      if (source_it != group.roles.end()) {
+        Node *source = source_it->second;
+        if (sources.count(source)) {
+          for (auto *target : source->outputs) {
+            if (targets.count(target)) links.emplace_back(source, target);
+          }
+        }
+      } else if (target_it != group.roles.end()) {
+        Node *target = target_it->second;
+        if (targets.count(target)) {
+          for (auto *source : target->inputs) {
+            if (sources.count(source) && IsNodesLink(source, target)) {
+              links.emplace_back(source, target);
+            }
+          }
+        }
+      } else {
+        for (Node *source : sources) {
+          for (Node *target : targets) {
+            if (IsNodesLink(source, target)) {
+              links.emplace_back(source, target);
             }
           }
         }
       }
+      std::sort(links.begin(), links.end());
+      links.erase(std::unique(links.begin(), links.end()), links.end());
+      for (const auto &link : links) {
+        Node *source = link.first;
+        Node *target = link.second;
+        VLOG(8) << "check " << source->Name() << "(" << source->id() << ")"
+                << " -- " << target->Name() << "(" << target->id() << ")";
+        HitGroup new_group = group;
+        bool flag = new_group.Match(source, edge.first) &&
+                    new_group.Match(target, edge.second);
+        if (flag) {
+          new_group.Register(source, edge.first);
+          new_group.Register(target, edge.second);
+          extended.emplace_back(
+              source->id(), target->id(), i, std::move(new_group));
+          // TODO(Superjomn) need to unique
+        }
+      }
+    }
+    using extended_t = std::tuple<int, int, size_t, HitGroup>;
+    auto order = [](const extended_t &item) {
+      return std::make_tuple(
+          std::get<0>(item), std::get<1>(item), std::get<2>(item));
+    };
+    std::sort(extended.begin(),
+              extended.end(),
+              [&](const extended_t &a, const extended_t &b) {
+                return order(a) < order(b);
+              });
+    cur_groups.reserve(extended.size());
+    for (auto &item : extended) {
+      cur_groups.push_back(std::move(std::get<3>(item)));
     }
     VLOG(3) << "step " << step << " get records: " << cur_groups.size();
     for (auto &group : cur_groups) {
@@ -416,6 +512,7 @@ PDNode *PDNode::assert_is_op() {
 }
 
 PDNode *PDNode::assert_is_op(const std::string &op_type) {
+  HintOpTypes(OpTypesHint::kIsOp, {op_type});
   asserts_.emplace_back([op_type](Node *x) {
     return x && x->IsOp() && x->Op()->Type() == op_type;
   });
@@ -479,6 +576,7 @@ PDNode *PDNode::assert_is_op_nth_input(const std::string &op_type,
 PDNode *PDNode::assert_is_op_nth_output(const std::string &op_type,
                                         const std::string &argument,
                                         int nth) {
+  HintOpTypes(OpTypesHint::kIsOpOutput, {op_type});
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->inputs) {
@@ -492,6 +590,7 @@ PDNode *PDNode::assert_is_op_nth_output(const std::string &op_type,
 }
 
 PDNode *PDNode::assert_is_only_input_of_op(const std::string &op_type) {
+  HintOpTypes(OpTypesHint::kIsOpInput, {op_type});
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->outputs) {
@@ -506,6 +605,7 @@ PDNode *PDNode::assert_is_only_input_of_op(const std::string &op_type) {
 }
 
 PDNode *PDNode::assert_is_only_output_of_op(const std::string &op_type) {
+  HintOpTypes(OpTypesHint::kIsOpOutput, {op_type});
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->inputs) {
@@ -520,6 +620,7 @@ PDNode *PDNode::assert_is_only_output_of_op(const std::string &op_type) {
 }
 
 PDNode *PDNode::assert_is_op_output(const std::string &op_type) {
+  HintOpTypes(OpTypesHint::kIsOpOutput, {op_type});
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->inputs) {
@@ -540,6 +641,7 @@ PDNode *PDNode::assert_is_op_output(const std::string &op_type,
 }
 
 PDNode *PDNode::assert_is_op_input(const std::string &op_type) {
+  HintOpTypes(OpTypesHint::kIsOpInput, {op_type});
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->outputs) {
@@ -597,6 +699,7 @@ PDNode *PDNode::assert_more(PDNode::teller_t &&teller) {
 }
 
 PDNode *PDNode::assert_is_ops(const std::unordered_set<std::string> &op_types) {
+  HintOpTypes(OpTypesHint::kIsOp, op_types);
   asserts_.emplace_back([op_types](Node *x) {
     return x && x->IsOp() && op_types.count(x->Op()->Type());
   });
@@ -624,6 +727,7 @@ PDNode *PDNode::assert_is_ops_nth_output(
     const std::unordered_set<std::string> &op_types,
     const std::string &argument,
     int nth) {
+  HintOpTypes(OpTypesHint::kIsOpOutput, op_types);
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->inputs) {
@@ -637,6 +741,7 @@ PDNode *PDNode::assert_is_ops_nth_output(
 }
 PDNode *PDNode::assert_is_ops_output(
     const std::unordered_set<std::string> &op_types) {
+  HintOpTypes(OpTypesHint::kIsOpOutput, op_types);
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->inputs) {
@@ -659,6 +764,7 @@ PDNode *PDNode::assert_is_ops_output(
 
 PDNode *PDNode::assert_is_ops_input(
     const std::unordered_set<std::string> &op_types) {
+  HintOpTypes(OpTypesHint::kIsOpInput, op_types);
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->outputs) {
@@ -681,6 +787,7 @@ PDNode *PDNode::assert_is_ops_input(
 
 PDNode *PDNode::assert_is_only_input_of_ops(
     const std::unordered_set<std::string> &op_types) {
+  HintOpTypes(OpTypesHint::kIsOpInput, op_types);
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->outputs) {
@@ -696,6 +803,7 @@ PDNode *PDNode::assert_is_only_input_of_ops(
 
 PDNode *PDNode::assert_is_only_output_of_ops(
     const std::unordered_set<std::string> &op_types) {
+  HintOpTypes(OpTypesHint::kIsOpOutput, op_types);
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->inputs) {
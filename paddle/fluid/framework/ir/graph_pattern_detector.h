@@ -80,6 +80,17 @@ struct PDNode {
   bool IsOp() const { return type_ == Type::kOp; }
   bool IsVar() const { return type_ == Type::kVar; }
 
+  // The op types asserted by the first assertion on them, which narrow the
+  // candidates of the node to the ops of the types, or to the vars linked to
+  // them, before they are told.
+  enum class OpTypesHint { kNone, kIsOp, kIsOpInput, kIsOpOutput };
+  OpTypesHint op_types_hint() const {
+    return teller_ ? OpTypesHint::kNone : op_types_hint_;
+  }
+  const std::unordered_set<std::string>& hint_op_types() const {
+    return hint_op_types_;
+  }
+
   const std::string& name() const { return name_; }
   const PDPattern* pdpattern() const { return pattern_; }
 
@@ -188,6 +199,14 @@ struct PDNode {
 
   PDNode(PDNode&& other) = default;
 
+  void HintOpTypes(OpTypesHint hint,
+                   const std::unordered_set<std::string>& op_types) {
+    if (op_types_hint_ == OpTypesHint::kNone) {
+      op_types_hint_ = hint;
+      hint_op_types_ = op_types;
+    }
+  }
+
   friend class PDPattern;
 
   // Will removed latter.
@@ -197,6 +216,8 @@ struct PDNode {
   std::string name_;
   Type type_;
   Role role_{Role::kUnknown};
+  OpTypesHint op_types_hint_{OpTypesHint::kNone};
+  std::unordered_set<std::string> hint_op_types_;
 };
 
 /*
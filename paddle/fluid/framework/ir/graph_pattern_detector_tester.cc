@@ -207,6 +207,61 @@ TEST(GraphPatternDetector, IntermediateCheck) {
   ASSERT_EQ(count, 1);
 }
 
+TEST(GraphPatternDetector, OpTypesHint) {
+  ProgramDesc program;
+  Graph graph(program);
+  // x -> relu -> y -> scale -> z
+  // y2 -> relu -> w
+  OpDesc relu_desc, scale_desc;
+  relu_desc.SetType("relu");
+  scale_desc.SetType("scale");
+  VarDesc x_desc("x"), y_desc("y"), z_desc("z"), y2_desc("y2"), w_desc("w");
+  auto link = [](Node* from, Node* to) {
+    from->outputs.push_back(to);
+    to->inputs.push_back(from);
+  };
+  Node* relu = graph.CreateOpNode(&relu_desc);
+  Node* relu2 = graph.CreateOpNode(&relu_desc);
+  Node* scale = graph.CreateOpNode(&scale_desc);
+  Node* x = graph.CreateVarNode(&x_desc);
+  Node* y = graph.CreateVarNode(&y_desc);
+  Node* z = graph.CreateVarNode(&z_desc);
+  Node* y2 = graph.CreateVarNode(&y2_desc);
+  Node* w = graph.CreateVarNode(&w_desc);
+  link(x, relu);
+  link(relu, y);
+  link(y, scale);
+  link(scale, z);
+  link(y2, relu2);
+  link(relu2, w);
+
+  GraphPatternDetector detector;
+  auto* relu_op =
+      detector.mutable_pattern()->NewNode("relu_op")->assert_is_op("relu");
+  auto* relu_out = detector.mutable_pattern()
+                       ->NewNode("relu_out")
+                       ->assert_is_op_output("relu")
+                       ->assert_is_op_input("scale")
+                       ->AsIntermediate();
+  auto* scale_op =
+      detector.mutable_pattern()->NewNode("scale_op")->assert_is_op("scale");
+  relu_out->LinksFrom({relu_op}).LinksTo({scale_op});
+  // The first assertion on the op types narrows the candidates.
+  ASSERT_EQ(relu_op->op_types_hint(), PDNode::OpTypesHint::kIsOp);
+  ASSERT_EQ(relu_out->op_types_hint(), PDNode::OpTypesHint::kIsOpOutput);
+  ASSERT_EQ(relu_out->hint_op_types().count("relu"), 1UL);
+
+  int count = 0;
+  detector(&graph,
+           [&](const GraphPatternDetector::subgraph_t& g, Graph* graph) {
+             ASSERT_EQ(g.at(relu_op), relu);
+             ASSERT_EQ(g.at(relu_out), y);
+             ASSERT_EQ(g.at(scale_op), scale);
+             ++count;
+           });
+  ASSERT_EQ(count, 1);
+}
+
 }  // namespace ir
 }  // namespace framework
 }  // namespace paddle
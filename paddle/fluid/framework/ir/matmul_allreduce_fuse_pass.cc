@@ -0,0 +1,193 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/ir/matmul_allreduce_fuse_pass.h"
+
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "paddle/fluid/framework/ir/graph_pattern_detector.h"
+#include "paddle/fluid/framework/ir/pass.h"
+#include "paddle/fluid/framework/op_version_registry.h"
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace framework {
+namespace ir {
+namespace patterns {
+
+struct MatmulAllReducePattern : public PatternBase {
+  MatmulAllReducePattern(PDPattern* pattern,
+                         const std::string& name_scope,
+                         bool with_bias);
+
+  // declare operator node's name
+  PATTERN_DECL_NODE(matmul);
+  PATTERN_DECL_NODE(allreduce);
+  PATTERN_DECL_NODE(add);
+  // declare variable node's name
+  PATTERN_DECL_NODE(matmul_x);
+  PATTERN_DECL_NODE(matmul_w);
+  PATTERN_DECL_NODE(matmul_out);
+  PATTERN_DECL_NODE(allreduce_out);
+  PATTERN_DECL_NODE(bias);
+  PATTERN_DECL_NODE(add_out);
+};
+
+MatmulAllReducePattern::MatmulAllReducePattern(PDPattern* pattern,
+                                               const std::string& name_scope,
+                                               bool with_bias)
+    : PatternBase(pattern, name_scope, name_scope) {
+  auto* matmul_x =
+      pattern->NewNode(matmul_x_repr())->assert_is_op_input("matmul_v2", "X");
+  auto* matmul_w = pattern->NewNode(matmul_w_repr())
+                       ->assert_is_op_input("matmul_v2", "Y")
+                       ->assert_is_persistable_var();
+  auto* matmul = pattern->NewNode(matmul_repr())
+                     ->assert_is_op("matmul_v2")
+                     ->assert_op_attr<bool>("trans_x", false);
+  auto* matmul_out = pattern->NewNode(matmul_out_repr())
+                         ->assert_is_op_output("matmul_v2", "Out")
+                         ->assert_is_op_input("c_allreduce_sum", "X")
+                         ->assert_has_n_outputs(1)
+                         ->assert_var_not_persistable();
+  auto* allreduce =
+      pattern->NewNode(allreduce_repr())->assert_is_op("c_allreduce_sum");
+  auto* allreduce_out = pattern->NewNode(allreduce_out_repr())
+                            ->assert_is_op_output("c_allreduce_sum", "Out")
+                            ->assert_var_not_persistable();
+
+  matmul->LinksFrom({matmul_x, matmul_w}).LinksTo({matmul_out});
+  allreduce->LinksFrom({matmul_out}).LinksTo({allreduce_out});
+  if (!with_bias) return;
+
+  allreduce_out->assert_is_op_input("elementwise_add", "X")
+      ->assert_has_n_outputs(1);
+  auto* bias = pattern->NewNode(bias_repr())
+                   ->assert_is_op_input("elementwise_add", "Y")
+                   ->assert_is_persistable_var();
+  auto* add = pattern->NewNode(add_repr())->assert_is_op("elementwise_add");
+  auto* add_out = pattern->NewNode(add_out_repr())
+                      ->assert_is_op_output("elementwise_add", "Out")
+                      ->assert_var_not_persistable();
+  add->LinksFrom({allreduce_out, bias}).LinksTo({add_out});
+}
+
+}  // namespace patterns
+
+int MatmulAllReduceFusePass::ApplyWithBias(ir::Graph* graph,
+                                           bool with_bias) const {
+  GraphPatternDetector gpd;
+  patterns::MatmulAllReducePattern pattern(
+      gpd.mutable_pattern(), name_scope_, with_bias);
+  int num_chunks = Has("num_chunks") ? Get<int>("num_chunks") : 4;
+
+  int found_subgraph_count = 0;
+  auto handler = [&](const GraphPatternDetector::subgraph_t& subgraph,
+                     Graph* graph) {
+    VLOG(4) << "handle MatmulAllReduceFusePass fuse";
+#define GET_IR_NODE(node_) GET_IR_NODE_FROM_SUBGRAPH(node_, node_, pattern)
+    GET_IR_NODE(matmul_x);
+    GET_IR_NODE(matmul_w);
+    GET_IR_NODE(matmul);
+    GET_IR_NODE(matmul_out);
+    GET_IR_NODE(allreduce);
+    GET_IR_NODE(allreduce_out);
+#undef GET_IR_NODE
+    std::vector<int64_t> w_shape = matmul_w->Var()->GetShape();
+    if (w_shape.size() != 2) return;
+    bool trans_y = PADDLE_GET_CONST(bool, matmul->Op()->GetAttr("trans_y"));
+    int64_t n = trans_y ? w_shape[0] : w_shape[1];
+    // the allreduce with a condition may be skipped
+    if (!allreduce->Op()->Input("Cond").empty()) return;
+
+    Node* bias = nullptr;
+    Node* add = nullptr;
+    Node* out = allreduce_out;
+    if (with_bias) {
+      bias = subgraph.at(pattern.bias_n());
+      add = subgraph.at(pattern.add_n());
+      out = subgraph.at(pattern.add_out_n());
+      std::vector<int64_t> bias_shape = bias->Var()->GetShape();
+      int64_t bias_numel = 1;
+      for (int64_t dim : bias_shape) bias_numel *= dim;
+      int axis = PADDLE_GET_CONST(int, add->Op()->GetAttr("axis"));
+      int x_rank = static_cast<int>(matmul_x->Var()->GetShape().size());
+      // the bias should be broadcast along the last dim
+      if (bias_shape.empty() || bias_numel != n || bias_shape.back() != n ||
+          (axis != -1 && axis != x_rank - 1)) {
+        return;
+      }
+    }
+
+    framework::OpDesc fused_op_desc(matmul->Op()->Block());
+    fused_op_desc.SetType("c_matmul_allreduce_sum");
+    fused_op_desc.SetInput("X", {matmul_x->Name()});
+    fused_op_desc.SetInput("Y", {matmul_w->Name()});
+    if (bias != nullptr) {
+      fused_op_desc.SetInput("Bias", {bias->Name()});
+    }
+    fused_op_desc.SetOutput("Out", {out->Name()});
+    fused_op_desc.SetAttr("ring_id", allreduce->Op()->GetAttr("ring_id"));
+    fused_op_desc.SetAttr("trans_y", trans_y);
+    fused_op_desc.SetAttr("num_chunks", num_chunks);
+
+    auto* fused_op = graph->CreateOpNode(&fused_op_desc);
+    IR_NODE_LINK_TO(matmul_x, fused_op);
+    IR_NODE_LINK_TO(matmul_w, fused_op);
+    if (bias != nullptr) {
+      IR_NODE_LINK_TO(bias, fused_op);
+    }
+    IR_NODE_LINK_TO(fused_op, out);
+
+    // delete useless node
+    std::unordered_set<const Node*> delete_nodes{
+        matmul, matmul_out, allreduce};
+    if (with_bias) {
+      delete_nodes.insert(allreduce_out);
+      delete_nodes.insert(add);
+    }
+    GraphSafeRemoveNodes(graph, delete_nodes);
+    found_subgraph_count++;
+  };
+
+  gpd(graph, handler);
+  return found_subgraph_count;
+}
+
+void MatmulAllReduceFusePass::ApplyImpl(ir::Graph* graph) const {
+  PADDLE_ENFORCE_NOT_NULL(
+      graph, platform::errors::PreconditionNotMet("graph should not be null."));
+  Init(name_scope_, graph);
+
+  int found_subgraph_count = ApplyWithBias(graph, true);
+  found_subgraph_count += ApplyWithBias(graph, false);
+  AddStatis(found_subgraph_count);
+}
+
+}  // namespace ir
+}  // namespace framework
+}  // namespace paddle
+
+REGISTER_PASS(matmul_allreduce_fuse_pass,
+              paddle::framework::ir::MatmulAllReduceFusePass);
+
+REGISTER_PASS_CAPABILITY(matmul_allreduce_fuse_pass)
+    .AddCombination(
+        paddle::framework::compatible::OpVersionComparatorCombination()
+            .EQ("matmul_v2", 0)
+            .EQ("c_allreduce_sum", 0)
+            .LE("elementwise_add", 1));
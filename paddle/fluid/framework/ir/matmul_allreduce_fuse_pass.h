@@ -0,0 +1,65 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "paddle/fluid/framework/ir/fuse_pass_base.h"
+
+namespace paddle {
+namespace framework {
+namespace ir {
+
+class Graph;
+
+/*
+1. fuse the row parallel linear of tensor parallelism, matmul_v2 +
+c_allreduce_sum (+ elementwise_add), into c_matmul_allreduce_sum, which splits
+the rows into num_chunks chunks and overlaps the allreduce of a chunk with the
+matmul of the next one
+
+Origin subgraph:
+          x       w
+           \     /
+          matmul_v2
+              |
+       c_allreduce_sum
+              |      bias
+              |     /
+        elementwise_add
+              |
+             out
+
+Fused subgraph:
+          x   w   bias
+           \  |  /
+    c_matmul_allreduce_sum
+              |
+             out
+*/
+class MatmulAllReduceFusePass : public FusePassBase {
+ public:
+  MatmulAllReduceFusePass() = default;
+  virtual ~MatmulAllReduceFusePass() {}
+
+ protected:
+  void ApplyImpl(ir::Graph* graph) const override;
+
+ private:
+  int ApplyWithBias(ir::Graph* graph, bool with_bias) const;
+
+  const std::string name_scope_{"matmul_allreduce_fuse_pass"};
+};
+
+}  // namespace ir
+}  // namespace framework
+}  // namespace paddle
@@ -500,7 +500,8 @@ void ComputePropagateScalesMkldnnPass::ApplyImpl(ir::Graph* graph) const {
       "shape",
       "nearest_interp",
       "nearest_interp_v2",
-      "split"};
+      "split",
+      "leaky_relu"};
 
   StringPairMap var_quant_scales{};
 
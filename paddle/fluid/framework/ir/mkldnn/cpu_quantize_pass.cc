@@ -1303,6 +1303,8 @@ void CPUQuantizePass::ApplyImpl(ir::Graph* graph) const {
   QuantizeImmutable(graph, "nearest_interp", "X");
   QuantizeImmutable(graph, "nearest_interp_v2", "X");
   QuantizeImmutable(graph, "split", "X");
+  QuantizeImmutable(graph, "relu", "X");
+  QuantizeImmutable(graph, "leaky_relu", "X");
   QuantizeElementwise(graph, "fused_elementwise_add");
   QuantizeElementwise(graph, "fused_elementwise_mul");
   QuantizeElementwise(graph, "fused_elementwise_sub");
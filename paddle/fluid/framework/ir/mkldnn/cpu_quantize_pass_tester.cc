@@ -61,7 +61,8 @@ void SetOp(ProgramDesc* prog,
     op->SetOutput("Output", {outputs[0]});
   } else if (type == "pool2d" || type == "fused_transpose" ||
              type == "reshape2" || type == "nearest_interp" ||
-             type == "nearest_interp_v2") {
+             type == "nearest_interp_v2" || type == "relu" ||
+             type == "leaky_relu") {
     op->SetInput("X", {inputs[0]});
     op->SetOutput("Out", {outputs[0]});
   } else if (type == "slice") {
@@ -567,7 +568,9 @@ const std::vector<std::string> immutables = {"reshape2",
                                              "slice",
                                              "nearest_interp",
                                              "nearest_interp_v2",
-                                             "split"};
+                                             "split",
+                                             "relu",
+                                             "leaky_relu"};
 
 class TestImmutables : public testing::TestWithParam<std::string> {};
 
@@ -39,12 +39,14 @@ void CPUQuantizePlacementPass::ApplyImpl(ir::Graph* graph) const {
                                        "elementwise_mul",
                                        "elementwise_sub",
                                        "fc",
+                                       "leaky_relu",
                                        "matmul",
                                        "matmul_v2",
                                        "nearest_interp",
                                        "nearest_interp_v2",
                                        "pool2d",
                                        "prior_box",
+                                       "relu",
                                        "reshape2",
                                        "fused_transpose",
                                        "transpose2",
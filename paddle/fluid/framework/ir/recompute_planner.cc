@@ -0,0 +1,278 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/ir/recompute_planner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+
+#include "paddle/fluid/framework/data_type.h"
+#include "paddle/fluid/framework/op_proto_maker.h"
+
+namespace paddle {
+namespace framework {
+
+// The op times estimated by the bytes of the activations, as if they are
+// written at 1TB/s.
+static constexpr double kEstimatedBytesPerMs = 1e9;
+// The number of the bounds of the segments, and the iterations to search
+// lambda for a bound.
+static constexpr int kNumSegmentBounds = 32;
+static constexpr int kNumLambdaIters = 48;
+
+static bool IsForwardOp(const OpDesc* op) {
+  if (op->Type() == "feed" || op->Type() == "fetch") {
+    return false;
+  }
+  if (!op->HasAttr(OpProtoAndCheckerMaker::OpRoleAttrName())) {
+    return true;
+  }
+  int role = PADDLE_GET_CONST(
+      int, op->GetAttr(OpProtoAndCheckerMaker::OpRoleAttrName()));
+  return (role & (static_cast<int>(OpRole::kBackward) |
+                  static_cast<int>(OpRole::kOptimize))) == 0;
+}
+
+static bool IsBackwardOrOptimizeOp(const OpDesc* op) {
+  return op->Type() != "feed" && op->Type() != "fetch" && !IsForwardOp(op);
+}
+
+RecomputePlanner::RecomputePlanner(const ProgramDesc& program,
+                                   const CostData* cost) {
+  // Support global block only
+  const BlockDesc& block = program.Block(0);
+  bool all_measured = cost != nullptr;
+  for (size_t i = 0; i < block.OpSize(); ++i) {
+    const OpDesc* op_desc = block.Op(static_cast<int>(i));
+    if (IsBackwardOrOptimizeOp(op_desc)) {
+      break;
+    }
+    if (!IsForwardOp(op_desc)) {
+      continue;
+    }
+    ForwardOp op;
+    for (auto& name : op_desc->OutputArgumentNames()) {
+      VarDesc* var = block.FindVarRecursive(name);
+      if (var == nullptr || var->Persistable() ||
+          var->GetType() != proto::VarType::LOD_TENSOR) {
+        continue;
+      }
+      double bytes = static_cast<double>(SizeOfType(var->GetDataType()));
+      int num_batch_dims = 0;
+      for (auto d : var->GetShape()) {
+        if (d < 0) {
+          ++num_batch_dims;
+        } else {
+          bytes *= static_cast<double>(d);
+        }
+      }
+      op.outputs.emplace_back(bytes, num_batch_dims);
+      op.checkpoint = name;
+    }
+    if (op.outputs.size() != 1U) {
+      op.checkpoint.clear();
+    }
+    if (all_measured && cost->HasOpTime(static_cast<int>(i))) {
+      op.time_ms = cost->GetOpTimeMs(static_cast<int>(i));
+    } else {
+      all_measured = false;
+    }
+    ops_.push_back(op);
+  }
+  if (!all_measured) {
+    for (auto& op : ops_) {
+      op.time_ms = -1;
+    }
+  }
+}
+
+double RecomputePlanner::ActivationBytes(const ForwardOp& op,
+                                         int64_t batch_size) const {
+  double bytes = 0;
+  for (auto& output : op.outputs) {
+    bytes += output.first *
+             std::pow(static_cast<double>(batch_size), output.second);
+  }
+  return bytes;
+}
+
+RecomputePlan RecomputePlanner::Plan(double memory_budget_bytes,
+                                     int64_t batch_size) const {
+  PADDLE_ENFORCE_GT(
+      batch_size,
+      0,
+      platform::errors::InvalidArgument(
+          "The batch size to plan the recompute should be positive, but "
+          "received %d.",
+          batch_size));
+  const size_t n = ops_.size();
+  // The prefix sums of the bytes and the times of the forward ops.
+  std::vector<double> bytes(n), bytes_sum(n + 1, 0), time_sum(n + 1, 0);
+  double min_bytes = std::numeric_limits<double>::max();
+  for (size_t i = 0; i < n; ++i) {
+    bytes[i] = ActivationBytes(ops_[i], batch_size);
+    double time_ms = ops_[i].time_ms >= 0 ? ops_[i].time_ms
+                                          : bytes[i] / kEstimatedBytesPerMs;
+    bytes_sum[i + 1] = bytes_sum[i] + bytes[i];
+    time_sum[i + 1] = time_sum[i] + time_ms;
+    if (bytes[i] > 0) {
+      min_bytes = std::min(min_bytes, bytes[i]);
+    }
+  }
+
+  RecomputePlan no_recompute;
+  no_recompute.peak_memory_bytes = bytes_sum[n];
+  no_recompute.fits = bytes_sum[n] <= memory_budget_bytes;
+  if (no_recompute.fits || n == 0) {
+    return no_recompute;
+  }
+
+  // The position p of the DP is before the op p - 1 and also the checkpoint
+  // at the op p - 1, where p = 0 is the start of the forward ops.
+  auto can_checkpoint = [&](size_t p) {
+    return p == 0 || !ops_[p - 1].checkpoint.empty();
+  };
+  auto solve = [&](double bound, double lambda) {
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> f(n + 1, inf);
+    std::vector<size_t> parent(n + 1, 0);
+    f[0] = 0;
+    std::deque<size_t> window;
+    for (size_t p = 1; p <= n; ++p) {
+      size_t q = p - 1;
+      if (f[q] < inf) {
+        while (!window.empty() &&
+               f[window.back()] - time_sum[window.back()] >=
+                   f[q] - time_sum[q]) {
+          window.pop_back();
+        }
+        window.push_back(q);
+      }
+      // The segment from the checkpoint at q to the op p - 1 is the ops in
+      // [q, p - 1).
+      while (!window.empty() &&
+             bytes_sum[p - 1] - bytes_sum[window.front()] > bound) {
+        window.pop_front();
+      }
+      if (!window.empty() && can_checkpoint(p)) {
+        size_t from = window.front();
+        f[p] = f[from] - time_sum[from] + time_sum[p - 1] +
+               lambda * bytes[p - 1];
+        parent[p] = from;
+      }
+    }
+    // The ops behind the last checkpoint are not recomputed.
+    size_t tail = 0;
+    double best = inf;
+    for (size_t q = n + 1; q-- > 0 && bytes_sum[n] - bytes_sum[q] <= bound;) {
+      if (f[q] < best) {
+        best = f[q];
+        tail = q;
+      }
+    }
+
+    RecomputePlan plan;
+    if (best == inf) {
+      plan.peak_memory_bytes = inf;
+      return plan;
+    }
+    std::vector<size_t> positions;
+    for (size_t p = tail; p != 0; p = parent[p]) {
+      positions.push_back(p);
+    }
+    std::reverse(positions.begin(), positions.end());
+    double checkpoint_bytes = 0, max_segment = bytes_sum[n] - bytes_sum[tail];
+    size_t last = 0;
+    for (auto p : positions) {
+      plan.checkpoints.push_back(ops_[p - 1].checkpoint);
+      checkpoint_bytes += bytes[p - 1];
+      max_segment = std::max(max_segment, bytes_sum[p - 1] - bytes_sum[last]);
+      plan.recompute_time_ms += time_sum[p - 1] - time_sum[last];
+      last = p;
+    }
+    plan.peak_memory_bytes = checkpoint_bytes + max_segment;
+    plan.fits = plan.peak_memory_bytes <= memory_budget_bytes;
+    return plan;
+  };
+  auto is_better = [](const RecomputePlan& l, const RecomputePlan& r) {
+    if (l.fits != r.fits) return l.fits;
+    if (l.fits) {
+      return l.recompute_time_ms < r.recompute_time_ms ||
+             (l.recompute_time_ms == r.recompute_time_ms &&
+              l.peak_memory_bytes < r.peak_memory_bytes);
+    }
+    return l.peak_memory_bytes < r.peak_memory_bytes;
+  };
+
+  std::vector<double> bounds = {0};
+  if (min_bytes < bytes_sum[n]) {
+    double ratio = std::pow(bytes_sum[n] / min_bytes,
+                            1.0 / static_cast<double>(kNumSegmentBounds - 1));
+    for (int i = 0; i < kNumSegmentBounds; ++i) {
+      bounds.push_back(min_bytes * std::pow(ratio, i));
+    }
+  }
+  // A byte saved by lambda_max outweighs the time of all the forward ops.
+  double lambda_max = (time_sum[n] + 1) / min_bytes;
+  RecomputePlan best = no_recompute;
+  for (double bound : bounds) {
+    RecomputePlan plan = solve(bound, 0);
+    if (std::isinf(plan.peak_memory_bytes)) {
+      continue;
+    }
+    if (!plan.fits) {
+      // Search the least lambda whose plan fits in the budget.
+      double lo = 0, hi = lambda_max;
+      RecomputePlan hi_plan = solve(bound, hi);
+      if (is_better(hi_plan, best)) best = hi_plan;
+      if (!hi_plan.fits) continue;
+      plan = hi_plan;
+      for (int iter = 0; iter < kNumLambdaIters; ++iter) {
+        double mid = (lo + hi) / 2;
+        RecomputePlan mid_plan = solve(bound, mid);
+        if (mid_plan.fits) {
+          hi = mid;
+          if (is_better(mid_plan, plan)) plan = mid_plan;
+        } else {
+          lo = mid;
+        }
+      }
+    }
+    if (is_better(plan, best)) best = plan;
+  }
+  VLOG(3) << "Plan " << best.checkpoints.size()
+          << " checkpoints of the recompute for " << n
+          << " forward ops, the peak bytes " << best.peak_memory_bytes
+          << " in the budget " << memory_budget_bytes << ": " << best.fits;
+  return best;
+}
+
+int64_t RecomputePlanner::MaxBatchSize(double memory_budget_bytes,
+                                       int64_t max_batch_size) const {
+  int64_t lo = 0, hi = max_batch_size;
+  while (lo < hi) {
+    int64_t mid = lo + (hi - lo + 1) / 2;
+    if (Plan(memory_budget_bytes, mid).fits) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return lo;
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,85 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "paddle/fluid/framework/ir/cost_model.h"
+#include "paddle/fluid/framework/program_desc.h"
+
+namespace paddle {
+namespace framework {
+
+struct RecomputePlan {
+  // The names of the checkpoints, in the order of the forward ops.
+  std::vector<std::string> checkpoints;
+  // The peak bytes of the activations, the checkpoints and the largest
+  // segment between two checkpoints.
+  double peak_memory_bytes{0};
+  // The time of the forward ops recomputed in the backward.
+  double recompute_time_ms{0};
+  // Whether the peak bytes are in the memory budget.
+  bool fits{false};
+};
+
+// Plans the checkpoints of the recompute of the forward ops in the global
+// block, before the backward is appended. The activations are the outputs of
+// the forward ops, and an op with a single activation may be a checkpoint.
+// As in "Training Deep Nets with Sublinear Memory Cost", the checkpoints are
+// kept over the backward, and the activations of a segment between two
+// checkpoints are recomputed from the first one, so that
+//
+//   peak = sum(checkpoints) + max(segments),
+//
+// while the ops behind the last checkpoint keep their activations and are not
+// recomputed. For every bound of the segments, a DP over the forward ops
+// selects the checkpoints minimizing recompute_time + lambda * memory, with
+// lambda searched to meet the budget, and the plan of the least recompute
+// time in the budget is chosen.
+class RecomputePlanner {
+ public:
+  // The op times are read from the cost if all the forward ops are measured,
+  // otherwise they are estimated by the bytes of their activations.
+  explicit RecomputePlanner(const ProgramDesc& program,
+                            const CostData* cost = nullptr);
+
+  // The dims of -1 in the shapes of the activations are the batch size.
+  RecomputePlan Plan(double memory_budget_bytes, int64_t batch_size) const;
+
+  // The largest batch size in [1, max_batch_size] whose plan fits, or 0 if
+  // none fits.
+  int64_t MaxBatchSize(double memory_budget_bytes,
+                       int64_t max_batch_size) const;
+
+  size_t NumForwardOps() const { return ops_.size(); }
+
+ private:
+  struct ForwardOp {
+    // The bytes of the activations, by the number of the dims of -1.
+    std::vector<std::pair<double, int>> outputs;
+    // The name of the activation if the op may be a checkpoint.
+    std::string checkpoint;
+    double time_ms{-1};
+  };
+
+  double ActivationBytes(const ForwardOp& op, int64_t batch_size) const;
+
+  std::vector<ForwardOp> ops_;
+};
+
+}  // namespace framework
+}  // namespace paddle
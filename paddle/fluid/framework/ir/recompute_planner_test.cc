@@ -0,0 +1,92 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/ir/recompute_planner.h"
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/op_proto_maker.h"
+#include "paddle/fluid/framework/program_desc.h"
+
+namespace paddle {
+namespace framework {
+
+// A chain of 8 forward ops and a backward op, the activation of every forward
+// op is 1024 bytes for a sample:
+//   out{i} = relu(out{i-1}), out{i} of [-1, 256] in float
+static ProgramDesc CreateChainProgram() {
+  ProgramDesc program;
+  auto* block = program.MutableBlock(0);
+  std::string in = "x";
+  auto* x = block->Var(in);
+  x->SetType(proto::VarType::LOD_TENSOR);
+  x->SetDataType(proto::VarType::FP32);
+  x->SetShape({-1, 256});
+  for (int i = 0; i < 8; ++i) {
+    std::string out = "out" + std::to_string(i);
+    auto* var = block->Var(out);
+    var->SetType(proto::VarType::LOD_TENSOR);
+    var->SetDataType(proto::VarType::FP32);
+    var->SetShape({-1, 256});
+    auto* op = block->AppendOp();
+    op->SetType("relu");
+    op->SetInput("X", {in});
+    op->SetOutput("Out", {out});
+    in = out;
+  }
+  auto* grad = block->Var("out7@GRAD");
+  grad->SetType(proto::VarType::LOD_TENSOR);
+  grad->SetDataType(proto::VarType::FP32);
+  grad->SetShape({-1, 256});
+  auto* op = block->AppendOp();
+  op->SetType("fill_constant");
+  op->SetOutput("Out", {grad->Name()});
+  op->SetAttr(OpProtoAndCheckerMaker::OpRoleAttrName(),
+              static_cast<int>(OpRole::kBackward));
+  return program;
+}
+
+TEST(RecomputePlannerTest, TestNoRecompute) {
+  RecomputePlanner planner(CreateChainProgram());
+  EXPECT_EQ(planner.NumForwardOps(), 8UL);
+
+  RecomputePlan plan = planner.Plan(8192, 1);
+  EXPECT_TRUE(plan.fits);
+  EXPECT_TRUE(plan.checkpoints.empty());
+  EXPECT_EQ(plan.peak_memory_bytes, 8192);
+  EXPECT_EQ(plan.recompute_time_ms, 0);
+}
+
+TEST(RecomputePlannerTest, TestPlan) {
+  RecomputePlanner planner(CreateChainProgram());
+  // Two checkpoints and the segments of two ops is the least peak.
+  RecomputePlan plan = planner.Plan(4096, 1);
+  EXPECT_TRUE(plan.fits);
+  std::vector<std::string> checkpoints = {"out2", "out5"};
+  EXPECT_EQ(plan.checkpoints, checkpoints);
+  EXPECT_EQ(plan.peak_memory_bytes, 4096);
+  EXPECT_GT(plan.recompute_time_ms, 0);
+
+  plan = planner.Plan(3000, 1);
+  EXPECT_FALSE(plan.fits);
+  EXPECT_EQ(plan.peak_memory_bytes, 4096);
+}
+
+TEST(RecomputePlannerTest, TestMaxBatchSize) {
+  RecomputePlanner planner(CreateChainProgram());
+  EXPECT_EQ(planner.MaxBatchSize(8192, 16), 2);
+  EXPECT_EQ(planner.MaxBatchSize(3000, 16), 0);
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -67,15 +67,20 @@ class SubgraphDetector {
 class SubGraphFuser {
  public:
   using NodeInsideSubgraphTeller = SubgraphDetector::NodeInsideSubgraphTeller;
+  // Tell whether a detected sub-graph is worth being replaced, besides the
+  // min_subgraph_size.
+  using SubgraphAcceptor = std::function<bool(const std::vector<Node *> &)>;
 
   SubGraphFuser(Graph *graph,
                 const NodeInsideSubgraphTeller &teller,
                 int min_subgraph_size,
-                std::string name = "tensorrt_engine")
+                std::string name = "tensorrt_engine",
+                const SubgraphAcceptor &acceptor = nullptr)
       : graph_(graph),
         node_inside_subgraph_teller_(teller),
         min_subgraph_size_{min_subgraph_size},
-        name_{name} {}
+        name_{name},
+        subgraph_acceptor_(acceptor) {}
 
   // The main method which run all the logic.
   void operator()();
@@ -89,6 +94,7 @@ class SubGraphFuser {
   NodeInsideSubgraphTeller node_inside_subgraph_teller_;
   int min_subgraph_size_;
   const std::string name_;
+  SubgraphAcceptor subgraph_acceptor_;
 };
 
 struct NodeWrapper {
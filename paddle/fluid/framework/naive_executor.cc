@@ -14,14 +14,17 @@
 
 #include "paddle/fluid/framework/naive_executor.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/framework/variable_helper.h"
+#include "paddle/fluid/memory/malloc.h"
 #include "paddle/fluid/platform/denormal.h"
 #ifdef PADDLE_WITH_DNNL
 #include "paddle/fluid/platform/mkldnn_helper.h"
@@ -273,6 +276,45 @@ void NaiveExecutor::MakeReusePlan(
   }
 }
 
+namespace {
+// A slot of the workspace, whose size bounds the tensor placed in it.
+class WorkspaceSlot : public phi::Allocation {
+ public:
+  WorkspaceSlot(std::shared_ptr<phi::Allocation> workspace,
+                size_t offset,
+                size_t size)
+      : phi::Allocation(static_cast<uint8_t *>(workspace->ptr()) + offset,
+                        size,
+                        workspace->place()),
+        workspace_(std::move(workspace)) {}
+
+ private:
+  std::shared_ptr<phi::Allocation> workspace_;
+};
+}  // namespace
+
+void NaiveExecutor::MakeOffsetReusePlan(
+    const std::unordered_map<std::string, std::pair<size_t, size_t>>
+        &offset_table) {
+  size_t workspace_size = 0;
+  for (auto &it : offset_table) {
+    workspace_size =
+        std::max(workspace_size, it.second.first + it.second.second);
+  }
+  if (workspace_size == 0) return;
+  workspace_ = memory::AllocShared(place_, workspace_size);
+  for (auto &it : offset_table) {
+    auto *var = scope_->FindVar(it.first);
+    if (!var || !var->IsType<phi::DenseTensor>()) continue;
+    auto *tensor = var->GetMutable<phi::DenseTensor>();
+    if (tensor->IsInitialized()) continue;
+    tensor->ResetHolder(std::make_shared<WorkspaceSlot>(
+        workspace_, it.second.first, it.second.second));
+  }
+  VLOG(3) << "Place " << offset_table.size() << " vars in a workspace of "
+          << workspace_size << " bytes";
+}
+
 NaiveExecutor::~NaiveExecutor() {
 #ifdef PADDLE_WITH_DNNL
   // Clear mkl-dnn cache,
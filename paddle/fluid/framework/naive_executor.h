@@ -18,6 +18,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "paddle/fluid/framework/operator.h"
@@ -88,6 +89,13 @@ class NaiveExecutor {
   void MakeReusePlan(
       const std::unordered_map<std::string, std::string>& reuse_table);
 
+  // Places the tensors at the offsets of one workspace by the (offset, size)
+  // of each var. A tensor which outgrows its slot is reallocated by its
+  // kernel as usual.
+  void MakeOffsetReusePlan(
+      const std::unordered_map<std::string, std::pair<size_t, size_t>>&
+          offset_table);
+
   void ResetTrtOps(int num);
 
   void CloneLiteEngine(int num, void* stream);
@@ -111,6 +119,7 @@ class NaiveExecutor {
   std::unordered_map<OperatorBase*, std::unordered_map<phi::DenseTensor*, int>>
       reuse_cache_;
   std::vector<phi::DenseTensor*> cluster_buffer_;
+  std::shared_ptr<phi::Allocation> workspace_;
 
   std::unique_ptr<framework::InterpreterCore> interpreter_core_;
 };
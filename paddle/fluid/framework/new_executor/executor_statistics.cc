@@ -20,6 +20,7 @@
 #include <ostream>
 #include <queue>
 #include <set>
+#include <sstream>
 #include <unordered_map>
 #include <vector>
 
@@ -631,5 +632,24 @@ void StaticGraphExecutorPerfStatistics(
   }
 }
 
+void WorkQueuePerfStatistics(const std::string& queue_name,
+                             const std::vector<WorkerStatistics>& stats) {
+  if (!VLOG_IS_ON(1)) {
+    return;
+  }
+  uint64_t total_executed = 0;
+  uint64_t total_stolen = 0;
+  std::ostringstream oss;
+  for (size_t i = 0; i < stats.size(); ++i) {
+    total_executed += stats[i].executed_tasks;
+    total_stolen += stats[i].stolen_tasks;
+    oss << "\n  worker " << i << ": executed " << stats[i].executed_tasks
+        << ", stolen " << stats[i].stolen_tasks;
+  }
+  VLOG(1) << "WorkQueue(" << queue_name << ") executed " << total_executed
+          << " tasks, " << total_stolen << " of them were stolen"
+          << oss.str();
+}
+
 }  // namespace framework
 }  // namespace paddle
@@ -15,7 +15,10 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "paddle/fluid/framework/new_executor/workqueue/workqueue.h"
 #include "paddle/fluid/platform/profiler/event_node.h"
 
 namespace paddle {
@@ -24,5 +27,10 @@ namespace framework {
 void StaticGraphExecutorPerfStatistics(
     std::shared_ptr<const platform::NodeTrees> profiling_data);
 
+// Log the per-worker scheduling counters of a work queue, used to tune the
+// work-stealing dispatch of the interpreter.
+void WorkQueuePerfStatistics(const std::string& queue_name,
+                             const std::vector<WorkerStatistics>& stats);
+
 }  // namespace framework
 }  // namespace paddle
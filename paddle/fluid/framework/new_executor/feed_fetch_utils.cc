@@ -12,12 +12,20 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstring>
 #include <map>
 #include <vector>
 
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/new_executor/feed_fetch_utils.h"
+#include "paddle/fluid/framework/tensor_util.h"
 #include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/memory/memcpy.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/fluid/platform/profiler/event_tracing.h"
+#endif
 
 namespace paddle {
 namespace framework {
@@ -252,5 +260,247 @@ void MergeTensors(const std::vector<const phi::DenseTensor*>& tensors,
   }
 }
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+AsyncFetcher::AsyncFetcher(const phi::GPUPlace& place, int64_t depth)
+    : place_(place),
+      depth_(depth),
+      copy_stream_(platform::CudaStreamResourcePool::Instance().New(
+          place.GetDeviceId())),
+      slots_(depth + 1) {
+  PADDLE_ENFORCE_GT(
+      depth,
+      0,
+      phi::errors::InvalidArgument(
+          "The depth of the async fetch should be positive, but received %d.",
+          depth));
+  compute_stream_ = static_cast<phi::GPUContext*>(
+                        platform::DeviceContextPool::Instance().Get(place))
+                        ->stream();
+  for (auto& slot : slots_) {
+    slot.event =
+        platform::CudaEventResourcePool::Instance().New(place.GetDeviceId());
+  }
+}
+
+AsyncFetcher::~AsyncFetcher() {
+  // the pinned buffers are released with the slots, wait for the copies
+  // writing them
+#ifdef PADDLE_WITH_HIP
+  hipStreamSynchronize(copy_stream_.get());
+#else
+  cudaStreamSynchronize(copy_stream_.get());
+#endif
+}
+
+void AsyncFetcher::BeginStep(const int64_t micro_batch_num) {
+  Slot& slot = slots_[current_];
+  slot.fetch_list.clear();
+  slot.fetch_list.resize(micro_batch_num);
+  slot.buffers.resize(micro_batch_num);
+}
+
+void AsyncFetcher::Fetch(const std::vector<std::string>& job_fetch_names,
+                         const std::vector<std::string>& fetch_var_names,
+                         const int64_t micro_batch_id,
+                         Scope* scope) {
+  Slot& slot = slots_[current_];
+  PADDLE_ENFORCE_GT(
+      slot.fetch_list.size(),
+      micro_batch_id,
+      phi::errors::Unavailable("The fetch list size (%lld) should be greater "
+                               "than micro_batch_id (%lld)",
+                               slot.fetch_list.size(),
+                               micro_batch_id));
+  platform::RecordEvent record("AsyncFetcher::Fetch",
+                               platform::TracerEventType::UserDefined,
+                               1);
+  // the copies are issued after the job issued on the compute stream
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(slot.event.get(), compute_stream_));
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipStreamWaitEvent(copy_stream_.get(), slot.event.get(), 0));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaEventRecord(slot.event.get(), compute_stream_));
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaStreamWaitEvent(copy_stream_.get(), slot.event.get(), 0));
+#endif
+
+  auto& fetch_list = slot.fetch_list.at(micro_batch_id);
+  auto& buffers = slot.buffers.at(micro_batch_id);
+  fetch_list.resize(fetch_var_names.size());
+  buffers.resize(fetch_var_names.size());
+  for (auto& var_name : job_fetch_names) {
+    int col = find(fetch_var_names.begin(), fetch_var_names.end(), var_name) -
+              fetch_var_names.begin();
+    auto* var = scope->FindVar(var_name);
+    auto& src = var->Get<phi::DenseTensor>();
+    auto* dst = &(PADDLE_GET(phi::DenseTensor, fetch_list[col]));
+    if (!src.IsInitialized()) {
+      VLOG(6) << "Found " << var_name
+              << " is not initialized and skip TensorCopy.";
+      continue;
+    }
+    size_t size = src.numel() * phi::SizeOf(src.dtype());
+    if (!platform::is_gpu_place(src.place()) ||
+        !src.meta().is_contiguous() || size == 0) {
+      TensorCopySync(src, platform::CPUPlace(), dst);
+      continue;
+    }
+    auto& buffer = buffers[col];
+    if (!buffer || buffer->size() < size) {
+      // the buffer of the slot is not in use, since the copies of the last
+      // step of the slot have been waited
+      buffer = memory::AllocShared(phi::GPUPinnedPlace(), size);
+    }
+    phi::DenseTensorMeta meta(src.dtype(), src.dims(), src.layout());
+    meta.lod = src.lod();
+    dst->set_meta(meta);
+    dst->ResetHolder(buffer);
+    memory::Copy(phi::GPUPinnedPlace(),
+                 buffer->ptr(),
+                 place_,
+                 src.data(),
+                 size,
+                 copy_stream_.get());
+    // the device memory is returned to the compute stream after the copy
+    memory::RecordStream(src.Holder(), copy_stream_.get());
+  }
+}
+
+FetchList AsyncFetcher::EndStep() {
+  Slot& slot = slots_[current_];
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipEventRecord(slot.event.get(), copy_stream_.get()));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaEventRecord(slot.event.get(), copy_stream_.get()));
+#endif
+  slot.pending = true;
+  current_ = (current_ + 1) % slots_.size();
+
+  // the next slot is of the step depth before
+  Slot& ready = slots_[current_];
+  framework::FetchList fetch_res;
+  if (!ready.pending) {
+    return fetch_res;
+  }
+  platform::RecordEvent record("AsyncFetcher::Wait",
+                               platform::TracerEventType::UserDefined,
+                               1);
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventSynchronize(ready.event.get()));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(ready.event.get()));
+#endif
+  ready.pending = false;
+  // the pinned buffers are reused by the later steps, so the fetched tensors
+  // are copied out of them on host
+  for (auto& micro_batch : ready.fetch_list) {
+    for (auto& item : micro_batch) {
+      auto& tensor = PADDLE_GET(phi::DenseTensor, item);
+      if (tensor.IsInitialized() &&
+          platform::is_cuda_pinned_place(tensor.place())) {
+        phi::DenseTensor host;
+        TensorCopySync(tensor, platform::CPUPlace(), &host);
+        tensor = std::move(host);
+      }
+    }
+  }
+  MergeFetchTensors(ready.fetch_list,
+                    static_cast<int64_t>(ready.fetch_list.size()),
+                    &fetch_res);
+  ready.fetch_list.clear();
+  return fetch_res;
+}
+
+RunAheadFeeder::RunAheadFeeder(const phi::GPUPlace& place, int64_t depth)
+    : depth_(depth), slots_(depth + 1) {
+  PADDLE_ENFORCE_GT(
+      depth,
+      0,
+      phi::errors::InvalidArgument(
+          "The depth of the run-ahead should be positive, but received %d.",
+          depth));
+  compute_stream_ = static_cast<phi::GPUContext*>(
+                        platform::DeviceContextPool::Instance().Get(place))
+                        ->stream();
+  for (auto& slot : slots_) {
+    slot.event =
+        platform::CudaEventResourcePool::Instance().New(place.GetDeviceId());
+  }
+}
+
+RunAheadFeeder::~RunAheadFeeder() {
+  // the pinned buffers are released with the slots, wait for the copies
+  // reading them
+  for (auto& slot : slots_) {
+    if (slot.pending) {
+#ifdef PADDLE_WITH_HIP
+      hipEventSynchronize(slot.event.get());
+#else
+      cudaEventSynchronize(slot.event.get());
+#endif
+    }
+  }
+}
+
+void RunAheadFeeder::BeginRun(
+    std::vector<std::vector<phi::DenseTensor>>* feeds) {
+  Slot& slot = slots_[current_];
+  if (slot.pending) {
+    platform::RecordEvent record("RunAheadFeeder::Wait",
+                                 platform::TracerEventType::UserDefined,
+                                 1);
+#ifdef PADDLE_WITH_HIP
+    PADDLE_ENFORCE_GPU_SUCCESS(hipEventSynchronize(slot.event.get()));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(slot.event.get()));
+#endif
+    slot.pending = false;
+  }
+
+  slot.buffers.resize(feeds->size());
+  for (size_t micro_batch_id = 0; micro_batch_id < feeds->size();
+       ++micro_batch_id) {
+    auto& tensors = feeds->at(micro_batch_id);
+    auto& buffers = slot.buffers[micro_batch_id];
+    buffers.resize(tensors.size());
+    for (size_t i = 0; i < tensors.size(); ++i) {
+      const phi::DenseTensor& src = tensors[i];
+      if (!src.IsInitialized() || !platform::is_cpu_place(src.place()) ||
+          !src.meta().is_contiguous() || src.numel() == 0) {
+        continue;
+      }
+      size_t size = src.numel() * phi::SizeOf(src.dtype());
+      auto& buffer = buffers[i];
+      if (!buffer || buffer->size() < size) {
+        buffer = memory::AllocShared(phi::GPUPinnedPlace(), size);
+      }
+      std::memcpy(buffer->ptr(), src.data(), size);
+      phi::DenseTensorMeta meta(src.dtype(), src.dims(), src.layout());
+      meta.lod = src.lod();
+      phi::DenseTensor staged;
+      staged.set_meta(meta);
+      staged.ResetHolder(buffer);
+      tensors[i] = std::move(staged);
+    }
+  }
+}
+
+void RunAheadFeeder::EndRun() {
+  Slot& slot = slots_[current_];
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(slot.event.get(), compute_stream_));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaEventRecord(slot.event.get(), compute_stream_));
+#endif
+  slot.pending = true;
+  current_ = (current_ + 1) % slots_.size();
+}
+#endif
+
 }  // namespace framework
 }  // namespace paddle
@@ -14,11 +14,15 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <vector>
 
 #include "paddle/fluid/framework/new_executor/interpreter/plan.h"
 #include "paddle/fluid/framework/program_desc.h"
 #include "paddle/fluid/framework/scope.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/platform/device/gpu/gpu_resource_pool.h"
+#endif
 
 namespace paddle {
 namespace framework {
@@ -46,5 +50,83 @@ void MergeTensors(const std::vector<const phi::DenseTensor*>& tensors,
                   const platform::Place dst_place,
                   phi::DenseTensor* target);
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+// Fetches the GPU tensors without waiting for the device. The tensors of a
+// step are copied to the pinned buffers of a ring of depth + 1 slots on a side
+// stream, after the work issued on the compute stream, and the step returns
+// the fetch list of the step depth before it, whose copies are waited then.
+// The steps before the first depth ones return an empty fetch list.
+class AsyncFetcher {
+ public:
+  AsyncFetcher(const phi::GPUPlace& place, int64_t depth);
+
+  ~AsyncFetcher();
+
+  void BeginStep(const int64_t micro_batch_num);
+
+  // The same as FetchTensors, except that the GPU tensors are copied to the
+  // pinned buffers of the step asynchronously.
+  void Fetch(const std::vector<std::string>& job_fetch_names,
+             const std::vector<std::string>& fetch_var_names,
+             const int64_t micro_batch_id,
+             Scope* scope);
+
+  FetchList EndStep();
+
+  int64_t Depth() const { return depth_; }
+
+ private:
+  struct Slot {
+    FetchUnmergedList fetch_list;
+    // The pinned buffers reused by the steps of the slot, by the micro batch
+    // and the column.
+    std::vector<std::vector<std::shared_ptr<phi::Allocation>>> buffers;
+    std::shared_ptr<platform::CudaEventObject> event;
+    bool pending{false};
+  };
+
+  const phi::GPUPlace place_;
+  const int64_t depth_;
+  gpuStream_t compute_stream_;
+  std::shared_ptr<platform::CudaStreamObject> copy_stream_;
+  std::vector<Slot> slots_;
+  size_t current_{0};
+};
+
+// Lets the host run ahead of the device by up to depth runs. The copies of
+// the CPU feed tensors to the device wait for the kernels issued before if
+// they are from pageable memory, so the feeds of a run are staged in the
+// pinned buffers of a ring of depth + 1 slots. A run reusing a slot waits for
+// the run depth + 1 before it, which staged the slot, to finish on the compute
+// stream, which also bounds how far the host runs ahead.
+class RunAheadFeeder {
+ public:
+  RunAheadFeeder(const phi::GPUPlace& place, int64_t depth);
+
+  ~RunAheadFeeder();
+
+  // Replaces the CPU tensors of the feeds by their copies in the pinned
+  // buffers of the run.
+  void BeginRun(std::vector<std::vector<phi::DenseTensor>>* feeds);
+
+  void EndRun();
+
+  int64_t Depth() const { return depth_; }
+
+ private:
+  struct Slot {
+    // The pinned buffers by the micro batch and the feed.
+    std::vector<std::vector<std::shared_ptr<phi::Allocation>>> buffers;
+    std::shared_ptr<platform::CudaEventObject> event;
+    bool pending{false};
+  };
+
+  const int64_t depth_;
+  gpuStream_t compute_stream_;
+  std::vector<Slot> slots_;
+  size_t current_{0};
+};
+#endif
+
 }  // namespace framework
 }  // namespace paddle
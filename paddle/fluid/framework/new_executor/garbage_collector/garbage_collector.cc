@@ -27,6 +27,39 @@ InterpreterCoreGarbageCollector::InterpreterCoreGarbageCollector() {
   cur_memory_size_ = 0;
 }
 
+// Whether the device ops run on more than one device context.
+static bool IsMultiStream(
+    const std::vector<const platform::DeviceContext*>& dev_ctxs) {
+  const platform::DeviceContext* device_ctx = nullptr;
+  for (auto* dev_ctx : dev_ctxs) {
+    if (platform::is_cpu_place(dev_ctx->GetPlace())) {
+      continue;
+    }
+    if (device_ctx != nullptr && device_ctx != dev_ctx) {
+      return true;
+    }
+    device_ctx = dev_ctx;
+  }
+  return false;
+}
+
+static bool IsMultiStream(
+    const std::vector<std::unique_ptr<InstructionBase>>& vec_instruction) {
+  std::vector<const platform::DeviceContext*> dev_ctxs;
+  for (auto& instr : vec_instruction) {
+    dev_ctxs.push_back(&instr->DeviceContext());
+  }
+  return IsMultiStream(dev_ctxs);
+}
+
+static bool IsMultiStream(const std::vector<Instruction>& vec_instruction) {
+  std::vector<const platform::DeviceContext*> dev_ctxs;
+  for (auto& instr : vec_instruction) {
+    dev_ctxs.push_back(&instr.DeviceContext());
+  }
+  return IsMultiStream(dev_ctxs);
+}
+
 std::unique_ptr<InterpreterCoreGarbageCollector>
 CreateInterpreterCoreGarbageCollector(
     const platform::Place& place,
@@ -40,12 +73,16 @@ CreateInterpreterCoreGarbageCollector(
           new InterpreterCoreEventGarbageCollector(vec_instruction));
     }
   } else if (platform::is_xpu_place(place)) {
-    // Because there is no multi-stream on XPU device, fast GC can
-    // be used.
+    // The fast GC is used if all the ops run on one XPU stream.
     // Previously, XPU used no_event GC. But `Wait` in no_event GC
     // may cause GC delayed, causing no enough memory problem.
-    // TODO(pangyoki): Multi-stream allocator and multi-stream GC
-    // are needed to be adapted for XPU.
+    // The ops with an execution stream run on the other XPU streams, then
+    // the memory may be reused by a stream only after the events of the ops
+    // using it.
+    if (IsMultiStream(vec_instruction)) {
+      return std::unique_ptr<InterpreterCoreGarbageCollector>(
+          new InterpreterCoreEventGarbageCollector(vec_instruction));
+    }
     return std::unique_ptr<InterpreterCoreGarbageCollector>(
         new InterpreterCoreFastGarbageCollector());
   } else if (platform::is_ipu_place(place)) {
@@ -70,12 +107,16 @@ CreateInterpreterCoreGarbageCollector(
           new InterpreterCoreEventGarbageCollector(vec_instruction));
     }
   } else if (platform::is_xpu_place(place)) {
-    // Because there is no multi-stream on XPU device, fast GC can
-    // be used.
+    // The fast GC is used if all the ops run on one XPU stream.
     // Previously, XPU used no_event GC. But `Wait` in no_event GC
     // may cause GC delayed, causing no enough memory problem.
-    // TODO(pangyoki): Multi-stream allocator and multi-stream GC
-    // are needed to be adapted for XPU.
+    // The ops with an execution stream run on the other XPU streams, then
+    // the memory may be reused by a stream only after the events of the ops
+    // using it.
+    if (IsMultiStream(vec_instruction)) {
+      return std::unique_ptr<InterpreterCoreGarbageCollector>(
+          new InterpreterCoreEventGarbageCollector(vec_instruction));
+    }
     return std::unique_ptr<InterpreterCoreGarbageCollector>(
         new InterpreterCoreFastGarbageCollector());
   } else if (platform::is_ipu_place(place)) {
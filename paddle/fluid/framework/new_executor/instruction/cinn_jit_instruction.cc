@@ -21,6 +21,7 @@
 #include "paddle/common/errors.h"
 #include "paddle/fluid/framework/new_executor/pir_adaptor/pir_adaptor_util.h"
 #include "paddle/fluid/framework/paddle2cinn/transform_type.h"
+#include "paddle/phi/api/profiler/supplement_tracing.h"
 #if defined(PADDLE_WITH_CUDA)
 #include "paddle/cinn/runtime/cinn_runtime.h"
 #endif
@@ -67,6 +68,32 @@ class CinnJitInstruction::FnPtrImpl {
         static_cast<void*>(func_args_.data()), func_args_.size(), stream);
   }
 
+  // attach the ops and the cost of the kernel to the cinn_jit event, the
+  // bytes of the arguments are the least traffic of the kernel
+  void RecordProfileInfo(const std::vector<phi::DenseTensor*>& kernel_args) {
+    if (!phi::RecordOpInfoSupplement::IsEnabled()) {
+      return;
+    }
+    std::vector<phi::DDim> arg_shapes;
+    int64_t arg_bytes = 0;
+    for (const auto* tensor : kernel_args) {
+      arg_shapes.push_back(tensor->dims());
+      arg_bytes += tensor->numel() * phi::SizeOf(tensor->dtype());
+    }
+    phi::AttributeMap attrs;
+    attrs["fn_name"] = cinn_kernel_info_.fn_name;
+    attrs["ops"] = cinn_kernel_info_.op_names;
+    attrs["flops"] = cinn_kernel_info_.flops;
+    attrs["bytes_accessed"] = cinn_kernel_info_.bytes_accessed;
+    attrs["arg_bytes"] = arg_bytes;
+    if (cinn_kernel_info_.flops >= 0 && arg_bytes > 0) {
+      attrs["flops_per_byte"] =
+          static_cast<double>(cinn_kernel_info_.flops) / arg_bytes;
+    }
+    phi::RecordOpInfoSupplement(
+        cinn_kernel_info_.fn_name, {{"Args", arg_shapes}}, attrs);
+  }
+
   void InferShape(const std::vector<phi::DenseTensor*>& kernel_args,
                   int32_t input_tensor_size,
                   int32_t output_tensor_size) {
@@ -182,6 +209,7 @@ void CinnJitInstruction::Run() {
   }
 
   // 2. exexute kernel
+  fn_ptr_impl_->RecordProfileInfo(tensor_args_);
   fn_ptr_impl_->Run(tensor_args_, static_cast<void*>(stream));
 #else
   VLOG(phi::FATAL) << "Not Supported: cinn jit instruction currently does not "
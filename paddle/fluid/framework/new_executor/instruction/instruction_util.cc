@@ -41,6 +41,9 @@
 #include "paddle/phi/core/flags.h"
 PHI_DECLARE_bool(dynamic_static_unified_comm);
 #endif
+#ifdef PADDLE_WITH_XPU
+#include "paddle/phi/backends/xpu/xpu_context.h"
+#endif
 
 namespace paddle {
 namespace framework {
@@ -138,6 +141,24 @@ platform::DeviceContext* ParseDeviceContext(
 #endif
   }
 
+#ifdef PADDLE_WITH_XPU
+  // The memcpy kernels of XPU are synchronous, so only the ops with an
+  // execution stream run on the other streams.
+  if (platform::is_xpu_place(place) && execution_stream != kDefaultStream) {
+    VLOG(6) << "Parse DeviceContext for " << op_name
+            << ", execution stream = " << execution_stream;
+    dev_ctx = ctx_manager
+                  .Get(std::string(kCustomStream) + "-" + execution_stream,
+                       place,
+                       stream_priority)
+                  .get()
+                  .get();
+    static_cast<phi::XPUContext*>(dev_ctx)->CreateStream();
+    interpreter::SetDeviceCommContext(op, dev_ctx);
+    return dev_ctx;
+  }
+#endif
+
   if (origin_dev_ctx != nullptr) {
     interpreter::SetDeviceCommContext(op, origin_dev_ctx);
   }
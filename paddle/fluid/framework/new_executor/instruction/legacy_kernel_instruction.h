@@ -57,6 +57,8 @@ class LegacyKernelInstruction : public InstructionBase {
 
   phi::InferMetaContext infer_meta_context_;
 
+  phi::InferMetaCache infer_meta_cache_;
+
   paddle::framework::ExecutionContext* kernel_context_{nullptr};
   std::shared_ptr<framework::RuntimeContext> runtime_context_;
   std::shared_ptr<paddle::framework::OperatorBase> operator_base_;
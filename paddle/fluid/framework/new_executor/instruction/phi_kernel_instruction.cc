@@ -24,6 +24,7 @@
 #include "paddle/fluid/pir/dialect/operator/utils/op_yaml_info_parser.h"
 #include "paddle/fluid/platform/collective_helper.h"
 #include "paddle/fluid/platform/device_context.h"
+#include "paddle/phi/core/flags.h"
 #include "paddle/phi/core/infermeta_utils.h"
 #include "paddle/phi/core/meta_tensor.h"
 #include "paddle/phi/core/type_defs.h"
@@ -33,6 +34,9 @@
 #include "paddle/pir/core/value.h"
 
 #include "paddle/fluid/framework/new_executor/instruction/instruction_util.h"
+
+PHI_DECLARE_bool(new_executor_cache_infer_meta);
+
 namespace paddle {
 namespace framework {
 
@@ -182,7 +186,12 @@ PhiKernelInstruction::~PhiKernelInstruction() {
 void PhiKernelInstruction::Run() {
   VLOG(6) << "Begin run op " << phi_op_name_ << " infer meta.";
   if (infer_meta_interface_) {
-    infer_meta_interface_->infer_meta_(&(infer_meta_context_));
+    if (!FLAGS_new_executor_cache_infer_meta) {
+      infer_meta_interface_->infer_meta_(&(infer_meta_context_));
+    } else if (!infer_meta_cache_.Restore(&infer_meta_context_)) {
+      infer_meta_interface_->infer_meta_(&(infer_meta_context_));
+      infer_meta_cache_.Record(infer_meta_context_);
+    }
   }
   VLOG(6) << "End run op " << phi_op_name_ << " infer meta.";
   VLOG(6) << "Begin run op " << phi_op_name_ << " kernel.";
@@ -58,6 +58,8 @@ class PhiKernelInstruction : public InstructionBase {
 
   phi::InferMetaContext infer_meta_context_;
 
+  phi::InferMetaCache infer_meta_cache_;
+
   phi::KernelContext kernel_context_;
 
   phi::Kernel* phi_kernel_{nullptr};  // not owned
@@ -33,6 +33,9 @@ struct ExecutionConfig {
 
   size_t device_num_threads{0};
   size_t host_num_threads{0};
+  // The number of the streams to run the independent branches of the ops,
+  // including the default stream, 0 or 1 for a single stream.
+  size_t auto_stream_num{0};
 
   std::set<std::string> force_root_scope_vars;
   std::set<std::string> jit_input_vars;
@@ -0,0 +1,266 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/host_offload.h"
+
+#include <algorithm>
+
+#include "glog/logging.h"
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/memory/memcpy.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/fluid/platform/profiler/event_tracing.h"
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+size_t HostOffloadPlanner::PrefetchPosition(size_t prior, size_t next) const {
+  // not earlier than the instruction after the offload
+  return next > prior + 1 + prefetch_distance_ ? next - prefetch_distance_
+                                               : prior + 1;
+}
+
+std::vector<OffloadAction> HostOffloadPlanner::Plan(
+    const std::vector<OffloadCandidate>& candidates,
+    size_t num_positions) const {
+  std::vector<OffloadAction> actions;
+  for (const OffloadCandidate& candidate : candidates) {
+    const std::vector<size_t>& uses = candidate.use_positions;
+    if (uses.empty()) {
+      continue;
+    }
+    PADDLE_ENFORCE_EQ(
+        std::is_sorted(uses.begin(), uses.end()) &&
+            uses.back() < num_positions,
+        true,
+        phi::errors::InvalidArgument(
+            "The use positions of var(id=%d) should be sorted and less than "
+            "the number of positions %d.",
+            candidate.var_id,
+            num_positions));
+
+    for (size_t i = 0; i + 1 < uses.size(); ++i) {
+      size_t prior = uses[i];
+      size_t next = uses[i + 1];
+      if (next - prior - 1 < min_idle_ops_) {
+        continue;
+      }
+      size_t prefetch = PrefetchPosition(prior, next);
+      actions.push_back({candidate.var_id, prior, prefetch, next, false});
+    }
+
+    if (candidate.persistable) {
+      // the gap from the last use in this run to the first use in the next
+      // run, the positions of the next run are shifted by num_positions
+      size_t prior = uses.back();
+      size_t next = uses.front() + num_positions;
+      if (next - prior - 1 < min_idle_ops_) {
+        continue;
+      }
+      size_t prefetch = PrefetchPosition(prior, next);
+      actions.push_back({candidate.var_id,
+                         prior,
+                         prefetch % num_positions,
+                         uses.front(),
+                         true});
+    }
+  }
+  return actions;
+}
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+HostOffloadManager::HostOffloadManager(const phi::GPUPlace& place,
+                                       size_t num_positions,
+                                       size_t min_bytes)
+    : place_(place),
+      min_bytes_(min_bytes),
+      copy_stream_(platform::CudaStreamResourcePool::Instance().New(
+          place.GetDeviceId())),
+      offload_after_(num_positions),
+      prefetch_before_(num_positions),
+      wait_before_(num_positions) {}
+
+void HostOffloadManager::AddAction(const OffloadAction& action,
+                                   phi::DenseTensor* tensor,
+                                   gpuStream_t compute_stream) {
+  actions_.emplace_back(std::make_unique<Slot>());
+  Slot* slot = actions_.back().get();
+  slot->action = action;
+  slot->tensor = tensor;
+  slot->compute_stream = compute_stream;
+  slot->event =
+      platform::CudaEventResourcePool::Instance().New(place_.GetDeviceId());
+  offload_after_.at(action.offload_after).push_back(slot);
+  prefetch_before_.at(action.prefetch_before).push_back(slot);
+  wait_before_.at(action.wait_before).push_back(slot);
+}
+
+void HostOffloadManager::BeforeRun(size_t position) {
+  for (Slot* slot : prefetch_before_[position]) {
+    Prefetch(slot);
+  }
+  for (Slot* slot : wait_before_[position]) {
+    Wait(slot);
+  }
+}
+
+void HostOffloadManager::AfterRun(size_t position) {
+  for (Slot* slot : offload_after_[position]) {
+    Offload(slot);
+  }
+}
+
+void HostOffloadManager::Synchronize() {
+  if (has_pending_offload_) {
+    SynchronizeCopyStream();
+  }
+}
+
+void HostOffloadManager::Restore() {
+  for (auto& slot : actions_) {
+    Wait(slot.get());
+  }
+  // the host buffers are released with the plan, wait for the copies reading
+  // them
+  SynchronizeCopyStream();
+}
+
+void HostOffloadManager::SynchronizeCopyStream() {
+  platform::RecordEvent record("HostOffloadManager::Synchronize",
+                               platform::TracerEventType::UserDefined,
+                               1);
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamSynchronize(copy_stream_.get()));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(copy_stream_.get()));
+#endif
+  has_pending_offload_ = false;
+}
+
+void HostOffloadManager::StreamWaitStream(gpuStream_t waiter,
+                                          gpuStream_t waitee,
+                                          Slot* slot) {
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(slot->event.get(), waitee));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamWaitEvent(waiter, slot->event.get(), 0));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(slot->event.get(), waitee));
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaStreamWaitEvent(waiter, slot->event.get(), 0));
+#endif
+}
+
+void HostOffloadManager::Offload(Slot* slot) {
+  phi::DenseTensor* tensor = slot->tensor;
+  // only the tensors owning the whole holder are offloaded, the holder shared
+  // by other tensors (inplace or view) is not released by the offload
+  if (slot->state != State::kOnDevice || !tensor->initialized() ||
+      !platform::is_gpu_place(tensor->place()) ||
+      tensor->Holder().use_count() != 1 || tensor->meta().offset != 0 ||
+      !tensor->meta().is_contiguous()) {
+    return;
+  }
+  size_t size = tensor->numel() * phi::SizeOf(tensor->dtype());
+  if (size < min_bytes_) {
+    return;
+  }
+  platform::RecordEvent record("HostOffloadManager::Offload",
+                               platform::TracerEventType::UserDefined,
+                               1);
+  if (!slot->host_buffer || slot->host_buffer->size() < size) {
+    if (slot->host_buffer) {
+      // the previous copy to device may be still reading the old buffer
+      SynchronizeCopyStream();
+    }
+    slot->host_buffer = memory::AllocShared(phi::GPUPinnedPlace(), size);
+  }
+  StreamWaitStream(copy_stream_.get(), slot->compute_stream, slot);
+  std::shared_ptr<phi::Allocation> device_holder = tensor->Holder();
+  memory::Copy(phi::GPUPinnedPlace(),
+               slot->host_buffer->ptr(),
+               place_,
+               device_holder->ptr(),
+               size,
+               copy_stream_.get());
+  // the device memory is returned to the compute stream after the copy
+  memory::RecordStream(device_holder, copy_stream_.get());
+  tensor->ResetHolder(slot->host_buffer);
+  slot->state = State::kOnHost;
+  has_pending_offload_ = true;
+  VLOG(6) << "Offload var(id=" << slot->action.var_id << ") of " << size
+          << " bytes to host after position " << slot->action.offload_after;
+}
+
+void HostOffloadManager::Prefetch(Slot* slot) {
+  if (slot->state != State::kOnHost) {
+    return;
+  }
+  phi::DenseTensor* tensor = slot->tensor;
+  // the tensor is reset by others after being offloaded
+  if (tensor->Holder() != slot->host_buffer) {
+    slot->state = State::kOnDevice;
+    return;
+  }
+  platform::RecordEvent record("HostOffloadManager::Prefetch",
+                               platform::TracerEventType::UserDefined,
+                               1);
+  size_t size = tensor->numel() * phi::SizeOf(tensor->dtype());
+  slot->device_buffer = memory::AllocShared(
+      place_,
+      size,
+      phi::Stream(reinterpret_cast<phi::StreamId>(slot->compute_stream)));
+  // the memory allocated from the compute stream may be still in use by the
+  // instructions issued before on it
+  StreamWaitStream(copy_stream_.get(), slot->compute_stream, slot);
+  memory::Copy(place_,
+               slot->device_buffer->ptr(),
+               phi::GPUPinnedPlace(),
+               slot->host_buffer->ptr(),
+               size,
+               copy_stream_.get());
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipEventRecord(slot->event.get(), copy_stream_.get()));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaEventRecord(slot->event.get(), copy_stream_.get()));
+#endif
+  slot->state = State::kPrefetching;
+  VLOG(6) << "Prefetch var(id=" << slot->action.var_id << ") of " << size
+          << " bytes to device before position "
+          << slot->action.prefetch_before;
+}
+
+void HostOffloadManager::Wait(Slot* slot) {
+  Prefetch(slot);
+  if (slot->state != State::kPrefetching) {
+    return;
+  }
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipStreamWaitEvent(slot->compute_stream, slot->event.get(), 0));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaStreamWaitEvent(slot->compute_stream, slot->event.get(), 0));
+#endif
+  slot->tensor->ResetHolder(slot->device_buffer);
+  slot->device_buffer.reset();
+  slot->state = State::kOnDevice;
+}
+#endif
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,133 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/platform/device/gpu/gpu_resource_pool.h"
+#endif
+#include "paddle/phi/core/allocator.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+// The uses of a variable in one run, described by the positions in the
+// execution order of the instructions. A persistable variable is used again
+// by the next run, such as the parameters and the optimizer states.
+struct OffloadCandidate {
+  size_t var_id;
+  std::vector<size_t> use_positions;
+  bool persistable;
+};
+
+// Copy the variable to host after the instruction at offload_after and back to
+// device before the instruction at wait_before. The copy back is issued before
+// the instruction at prefetch_before so that it overlaps with computation. If
+// cross_run is true, wait_before (and possibly prefetch_before) belongs to the
+// next run.
+struct OffloadAction {
+  size_t var_id;
+  size_t offload_after;
+  size_t prefetch_before;
+  size_t wait_before;
+  bool cross_run;
+};
+
+// HostOffloadPlanner finds the gaps between two successive uses of a
+// variable that are long enough to hide a round trip to host memory.
+class HostOffloadPlanner {
+ public:
+  HostOffloadPlanner(size_t min_idle_ops, size_t prefetch_distance)
+      : min_idle_ops_(min_idle_ops), prefetch_distance_(prefetch_distance) {}
+
+  std::vector<OffloadAction> Plan(
+      const std::vector<OffloadCandidate>& candidates,
+      size_t num_positions) const;
+
+ private:
+  size_t PrefetchPosition(size_t prior, size_t next) const;
+
+  size_t min_idle_ops_;
+  size_t prefetch_distance_;
+};
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+// HostOffloadManager executes the offload actions of a program run in a fixed
+// order. The copies are issued on a side stream, ordered with the compute
+// stream by events. An offloaded tensor holds its pinned host buffer, so it is
+// still valid to be read between runs, and the buffer is reused by the
+// following offloads of the same variable.
+class HostOffloadManager {
+ public:
+  HostOffloadManager(const phi::GPUPlace& place,
+                     size_t num_positions,
+                     size_t min_bytes);
+
+  // The tensor and the compute stream of the variable is bound by the caller,
+  // the stream is the one all the uses of the variable run on.
+  void AddAction(const OffloadAction& action,
+                 phi::DenseTensor* tensor,
+                 gpuStream_t compute_stream);
+
+  void BeforeRun(size_t position);
+  void AfterRun(size_t position);
+
+  // Wait for the copies to host issued in this run, so that the offloaded
+  // tensors are safe to be read by host after the run.
+  void Synchronize();
+
+  // Copy all the offloaded tensors back to device, called before the plan is
+  // discarded.
+  void Restore();
+
+  size_t ActionNum() const { return actions_.size(); }
+
+ private:
+  enum class State { kOnDevice, kOnHost, kPrefetching };
+
+  struct Slot {
+    OffloadAction action;
+    phi::DenseTensor* tensor;
+    gpuStream_t compute_stream;
+    State state{State::kOnDevice};
+    std::shared_ptr<phi::Allocation> host_buffer;
+    std::shared_ptr<phi::Allocation> device_buffer;
+    std::shared_ptr<platform::CudaEventObject> event;
+  };
+
+  void Offload(Slot* slot);
+  void Prefetch(Slot* slot);
+  void Wait(Slot* slot);
+  void StreamWaitStream(gpuStream_t waiter, gpuStream_t waitee, Slot* slot);
+  void SynchronizeCopyStream();
+
+  phi::GPUPlace place_;
+  size_t min_bytes_;
+  std::shared_ptr<platform::CudaStreamObject> copy_stream_;
+  std::vector<std::unique_ptr<Slot>> actions_;
+  std::vector<std::vector<Slot*>> offload_after_;
+  std::vector<std::vector<Slot*>> prefetch_before_;
+  std::vector<std::vector<Slot*>> wait_before_;
+  bool has_pending_offload_{false};
+};
+#endif
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
@@ -37,6 +37,7 @@
 #include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
 #include "paddle/fluid/pir/dialect/operator/utils/op_yaml_info_parser.h"
 #include "paddle/fluid/platform/flags.h"
+#include "paddle/phi/backends/cpu/cpu_info.h"
 #include "paddle/phi/core/distributed/comm_context_manager.h"
 #include "paddle/phi/core/kernel_context.h"
 #include "paddle/phi/core/kernel_factory.h"
@@ -111,6 +112,10 @@ const std::vector<WorkQueueOptions> ConstructWorkQueueOptions(
                              /*track_task*/ false,
                              /*detached*/ true,
                              /*events_waiter*/ waiter);
+  // The workers follow the numa node of the thread creating the executor.
+  for (auto& options : group_options) {
+    options.numa_node = phi::backends::cpu::CurrentThreadNumaNode();
+  }
   return group_options;
 }
 
@@ -1465,6 +1470,66 @@ const std::vector<std::string> GetInstructionCallStack(
   }
   return vec_str;
 }
+
+std::vector<double> ComputeCriticalPathRanks(
+    const std::map<size_t, std::set<size_t>>& downstream_map,
+    const std::vector<double>& op_costs) {
+  const size_t op_num = op_costs.size();
+  std::vector<double> ranks(op_num, 0.0);
+  // 0: unvisited, 1: visiting, 2: done
+  std::vector<int> state(op_num, 0);
+  // iterative post-order DFS, the graph of large programs may be too deep for
+  // recursion
+  std::vector<std::pair<size_t, bool>> stack;
+  for (size_t root = 0; root < op_num; ++root) {
+    if (state[root] != 0) {
+      continue;
+    }
+    stack.emplace_back(root, false);
+    while (!stack.empty()) {
+      auto [op_idx, expanded] = stack.back();
+      stack.pop_back();
+      auto iter = downstream_map.find(op_idx);
+      if (expanded) {
+        double max_downstream_rank = 0.0;
+        if (iter != downstream_map.end()) {
+          for (size_t next_idx : iter->second) {
+            max_downstream_rank =
+                std::max(max_downstream_rank, ranks[next_idx]);
+          }
+        }
+        ranks[op_idx] = op_costs[op_idx] + max_downstream_rank;
+        state[op_idx] = 2;
+        continue;
+      }
+      if (state[op_idx] != 0) {
+        continue;
+      }
+      state[op_idx] = 1;
+      stack.emplace_back(op_idx, true);
+      if (iter != downstream_map.end()) {
+        for (size_t next_idx : iter->second) {
+          PADDLE_ENFORCE_LT(next_idx,
+                            op_num,
+                            phi::errors::OutOfRange(
+                                "Downstream op index %d is out of range [0, "
+                                "%d) when computing critical path ranks.",
+                                next_idx,
+                                op_num));
+          PADDLE_ENFORCE_NE(
+              state[next_idx],
+              1,
+              phi::errors::PreconditionNotMet(
+                  "Find a cycle in the dependency graph at op %d.", next_idx));
+          if (state[next_idx] == 0) {
+            stack.emplace_back(next_idx, false);
+          }
+        }
+      }
+    }
+  }
+  return ranks;
+}
 }  // namespace interpreter
 }  // namespace framework
 }  // namespace paddle
@@ -61,6 +61,10 @@ class AsyncWorkQueue {
     return queue_group_->QueueNumThreads(idx);
   }
 
+  std::vector<WorkerStatistics> QueueWorkerStatistics(size_t idx) const {
+    return queue_group_->QueueWorkerStatistics(idx);
+  }
+
  private:
   size_t host_num_thread_;
   std::unique_ptr<WorkQueueGroup> queue_group_;
@@ -142,6 +146,14 @@ void PrintValuesAndVariables(
 
 const std::vector<std::string> GetInstructionCallStack(
     const std::string& type, const pir::AttributeMap& attrs);
+
+// Return the critical-path rank of each instruction, that is the largest
+// accumulated cost over all the paths from the instruction to the end of the
+// dependency graph (including the cost of the instruction itself).
+// op_costs[i] is the estimated cost of the i-th instruction.
+std::vector<double> ComputeCriticalPathRanks(
+    const std::map<size_t, std::set<size_t>>& downstream_map,
+    const std::vector<double>& op_costs);
 }  // namespace interpreter
 }  // namespace framework
 }  // namespace paddle
@@ -0,0 +1,98 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/static_memory_planner.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "paddle/phi/core/enforce.h"
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+bool StaticMemoryPlanner::MayCoexist(
+    const BufferLifetime& lhs,
+    const BufferLifetime& rhs,
+    const HappensBefore& happens_before) const {
+  auto ReleasedBefore = [&happens_before](const BufferLifetime& prior,
+                                          const BufferLifetime& posterior) {
+    for (size_t op_idx : prior.last_live_ops) {
+      if (!happens_before(op_idx, posterior.def_op)) {
+        return false;
+      }
+    }
+    return true;
+  };
+  return !ReleasedBefore(lhs, rhs) && !ReleasedBefore(rhs, lhs);
+}
+
+size_t StaticMemoryPlanner::Plan(const std::vector<BufferLifetime>& buffers,
+                                 const HappensBefore& happens_before,
+                                 std::vector<size_t>* offsets) const {
+  PADDLE_ENFORCE_GT(alignment_,
+                    0,
+                    phi::errors::InvalidArgument(
+                        "The alignment of StaticMemoryPlanner must be "
+                        "greater than 0."));
+  for (const auto& buffer : buffers) {
+    PADDLE_ENFORCE_EQ(buffer.last_live_ops.empty(),
+                      false,
+                      phi::errors::InvalidArgument(
+                          "The buffer defined by op %d is never released, it "
+                          "can not be planned statically.",
+                          buffer.def_op));
+  }
+
+  std::vector<size_t> order(buffers.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&buffers](size_t a, size_t b) {
+    return buffers[a].size > buffers[b].size;
+  });
+
+  offsets->assign(buffers.size(), 0);
+  std::vector<size_t> placed;
+  size_t arena_size = 0;
+  for (size_t idx : order) {
+    size_t aligned_size =
+        (buffers[idx].size + alignment_ - 1) / alignment_ * alignment_;
+    // address ranges of the placed buffers that may coexist with this one
+    std::vector<std::pair<size_t, size_t>> conflicts;
+    for (size_t other : placed) {
+      if (MayCoexist(buffers[idx], buffers[other], happens_before)) {
+        size_t other_size =
+            (buffers[other].size + alignment_ - 1) / alignment_ * alignment_;
+        conflicts.emplace_back((*offsets)[other],
+                               (*offsets)[other] + other_size);
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end());
+    size_t offset = 0;
+    for (const auto& range : conflicts) {
+      if (offset + aligned_size <= range.first) {
+        break;
+      }
+      offset = std::max(offset, range.second);
+    }
+    (*offsets)[idx] = offset;
+    arena_size = std::max(arena_size, offset + aligned_size);
+    placed.push_back(idx);
+  }
+  return arena_size;
+}
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,62 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <set>
+#include <vector>
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+// The lifetime of a buffer in a program, described by instruction ids. The
+// buffer is written by def_op and released after all of last_live_ops.
+struct BufferLifetime {
+  size_t size;
+  size_t def_op;
+  std::set<size_t> last_live_ops;
+};
+
+// StaticMemoryPlanner packs the buffers of a program with static shapes into
+// a single arena ahead of time. Two buffers can share the same address range
+// only if one is released before the other is written in every possible
+// execution order, which is decided by the happens-before relation of the
+// dependency graph since instructions can run concurrently.
+//
+// The buffers are placed from the largest to the smallest, each at the lowest
+// offset that does not overlap with any placed buffer it may coexist with.
+class StaticMemoryPlanner {
+ public:
+  using HappensBefore = std::function<bool(size_t, size_t)>;
+
+  explicit StaticMemoryPlanner(size_t alignment) : alignment_(alignment) {}
+
+  // Fill the offset of each buffer and return the size of the arena.
+  size_t Plan(const std::vector<BufferLifetime>& buffers,
+              const HappensBefore& happens_before,
+              std::vector<size_t>* offsets) const;
+
+ private:
+  bool MayCoexist(const BufferLifetime& lhs,
+                  const BufferLifetime& rhs,
+                  const HappensBefore& happens_before) const;
+
+  size_t alignment_;
+};
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
@@ -14,7 +14,9 @@
 
 #include "paddle/fluid/framework/new_executor/interpreter/stream_analyzer.h"
 
+#include <algorithm>
 #include <future>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
@@ -27,6 +29,9 @@
 #include "paddle/phi/core/flags.h"
 PHI_DECLARE_bool(dynamic_static_unified_comm);
 #endif
+#ifdef PADDLE_WITH_XPU
+#include "paddle/phi/backends/xpu/xpu_context.h"
+#endif
 
 namespace paddle {
 namespace framework {
@@ -35,6 +40,9 @@ namespace interpreter {
 using DeviceContext = platform::DeviceContext;
 using DeviceEvent = platform::DeviceEvent;
 
+// The branches shorter than it are not worth the events of their joins.
+static constexpr size_t kMinAutoStreamChainOps = 2;
+
 inline std::string RunTypeToString(DownstreamRunType run_type) {
   if (run_type == DownstreamRunType::kDirectRun) {
     return "DirectRun";
@@ -259,12 +267,113 @@ DeviceContext* StreamAnalyzer::ParseDeviceContext(
 #endif
   }
 
+#ifdef PADDLE_WITH_XPU
+  // The memcpy kernels of XPU are synchronous, so only the ops with an
+  // execution stream run on the other streams.
+  if (platform::is_xpu_place(place_) && execution_stream != kDefaultStream) {
+    VLOG(6) << "Parse DeviceContext for " << op_type
+            << ", execution stream = " << execution_stream;
+    dev_ctx = ctx_manager
+                  .Get(std::string(kCustomStream) + "-" + execution_stream,
+                       place_,
+                       stream_priority)
+                  .get()
+                  .get();
+    static_cast<phi::XPUContext*>(dev_ctx)->CreateStream();
+    SetDeviceCommContext(op.get(), dev_ctx);
+    return dev_ctx;
+  }
+#endif
+
   if (op != nullptr) {
     SetDeviceCommContext(op.get(), op_func_node.dev_ctx_);
   }
   return op_func_node.dev_ctx_;
 }
 
+void StreamAnalyzer::AssignStreams(std::vector<OpFuncNode>* op_func_nodes,
+                                   size_t stream_num) const {
+  if (stream_num <= 1 ||
+      !(platform::is_gpu_place(place_) || platform::is_xpu_place(place_) ||
+        platform::is_custom_place(place_))) {
+    return;
+  }
+  auto is_candidate = [](const OpFuncNode& node) {
+    auto& op = node.operator_base_;
+    return op != nullptr && node.type_ == OpFuncType::kGpuAsync &&
+           node.execution_stream_ == kDefaultStream &&
+           op->Type() != interpreter::kMemcpyD2H &&
+           op->Type() != interpreter::kMemcpyH2D && !op->HasAttr("ring_id");
+  };
+
+  // The ops are in a topological order, every op continues the chain of its
+  // latest producer which is not continued yet, otherwise it starts a chain.
+  const size_t op_num = op_func_nodes->size();
+  std::vector<int> chain_of(op_num, -1);
+  std::vector<size_t> chain_size;
+  std::vector<bool> continued(op_num, false), has_reader(op_num, false);
+  std::unordered_map<int, size_t> last_writer;
+  for (size_t i = 0; i < op_num; ++i) {
+    const OpFuncNode& node = (*op_func_nodes)[i];
+    int producer = -1;
+    for (auto& item : node.input_index) {
+      for (int var_id : item.second) {
+        auto it = last_writer.find(var_id);
+        if (it == last_writer.end()) {
+          continue;
+        }
+        has_reader[it->second] = true;
+        if (chain_of[it->second] >= 0 && !continued[it->second]) {
+          producer = std::max(producer, static_cast<int>(it->second));
+        }
+      }
+    }
+    for (auto& item : node.output_index) {
+      for (int var_id : item.second) {
+        last_writer[var_id] = i;
+      }
+    }
+    if (!is_candidate(node)) {
+      continue;
+    }
+    if (producer >= 0) {
+      continued[producer] = true;
+      chain_of[i] = chain_of[producer];
+      ++chain_size[chain_of[i]];
+    } else {
+      chain_of[i] = static_cast<int>(chain_size.size());
+      chain_size.push_back(1);
+    }
+  }
+  if (chain_size.size() <= 1) {
+    return;
+  }
+
+  // The longest chain and the short ones stay on the default stream, the
+  // others are the branches shared by the stream_num - 1 streams, and the
+  // events at their joins are built by ConstructEvents.
+  size_t main_chain = std::max_element(chain_size.begin(), chain_size.end()) -
+                      chain_size.begin();
+  std::vector<int> stream_of(chain_size.size(), -1);
+  int next_stream = 0;
+  for (size_t c = 0; c < chain_size.size(); ++c) {
+    if (c != main_chain && chain_size[c] >= kMinAutoStreamChainOps) {
+      stream_of[c] = next_stream;
+      next_stream = (next_stream + 1) % static_cast<int>(stream_num - 1);
+    }
+  }
+  // The outputs of the program are made on the default stream, which is the
+  // one synchronized by the callers.
+  for (size_t i = 0; i < op_num; ++i) {
+    if (chain_of[i] >= 0 && stream_of[chain_of[i]] >= 0 && has_reader[i]) {
+      (*op_func_nodes)[i].execution_stream_ =
+          std::string(kAutoStream) + std::to_string(stream_of[chain_of[i]]);
+      VLOG(4) << "Assign " << (*op_func_nodes)[i].operator_base_->Type()
+              << " to " << (*op_func_nodes)[i].execution_stream_;
+    }
+  }
+}
+
 const std::unordered_set<std::string> no_need_buffer_ins(Instruction* instr) {
   auto* op = instr->OpBase();
   auto& inferer = op->Info().NoNeedBufferVarsInferer();
@@ -334,11 +443,22 @@ template <typename T>
 DownstreamRunType analyse_run_type_for_two_instructions(T* cur_instr,
                                                         T* next_instr,
                                                         const Place& place) {
-  // xpu&ipu memcpy kerenl is synchronous.
-  if (platform::is_ipu_place(place) || platform::is_xpu_place(place)) {
+  // ipu memcpy kerenl is synchronous.
+  if (platform::is_ipu_place(place)) {
     return DownstreamRunType::kDirectRun;
   }
 
+  // xpu memcpy kernel is synchronous too, but the ops with an execution
+  // stream run on the other xpu streams, and wait for the events of their
+  // upstream xpu ops in a different stream.
+  if (platform::is_xpu_place(place)) {
+    return cur_instr->KernelType() == OpFuncType::kGpuAsync &&
+                   next_instr->KernelType() == OpFuncType::kGpuAsync &&
+                   &cur_instr->DeviceContext() != &next_instr->DeviceContext()
+               ? DownstreamRunType::kEventRun
+               : DownstreamRunType::kDirectRun;
+  }
+
   // npu d2h kernel is asynchronous.
   if (platform::is_custom_place(place)) {
     if (platform::is_cpu_place(cur_instr->DeviceContext().GetPlace()) ||
@@ -84,6 +84,12 @@ class StreamAnalyzer {
 
   platform::DeviceType GetWaiterType(const Instruction& instr) const;
 
+  // Assigns the independent branches of the GPU and XPU ops, which are not
+  // annotated by an execution stream, to the pool of stream_num streams
+  // including the default one.
+  void AssignStreams(std::vector<OpFuncNode>* op_func_nodes,
+                     size_t stream_num) const;
+
   void ShareEventInfoFrom(const StreamAnalyzer& src);
 
   void SetForceEventsToWaitInfo(
@@ -47,6 +47,15 @@ PHI_DECLARE_bool(check_nan_inf);
 PD_DECLARE_bool(benchmark);
 PHI_DECLARE_uint64(executor_log_deps_every_microseconds);
 PHI_DECLARE_bool(new_executor_use_cuda_graph);
+PHI_DECLARE_bool(new_executor_use_work_stealing);
+PHI_DECLARE_bool(new_executor_use_critical_path_priority);
+PHI_DECLARE_int32(new_executor_cuda_graph_replay_max_shapes);
+PHI_DECLARE_bool(new_executor_use_static_memory_plan);
+PHI_DECLARE_string(new_executor_dispatch_table_file);
+PHI_DECLARE_bool(new_executor_dependency_aware_gc);
+PHI_DECLARE_bool(new_executor_use_host_offload);
+PHI_DECLARE_uint64(new_executor_host_offload_min_bytes);
+PHI_DECLARE_int32(new_executor_host_offload_prefetch_distance);
 PHI_DECLARE_bool(enable_pir_in_executor);
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 PHI_DECLARE_bool(sync_nccl_allreduce);
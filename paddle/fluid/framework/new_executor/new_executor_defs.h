@@ -53,6 +53,8 @@ constexpr const char* kCustomStream = "CustomStream";
 constexpr const char* kDefaultStream = "DefaultStream";
 constexpr const char* kD2HStream = "D2HStream";
 constexpr const char* kH2DStream = "H2DStream";
+// the prefix of the streams assigned by StreamAnalyzer::AssignStreams
+constexpr const char* kAutoStream = "AutoStream";
 
 constexpr int kEmptyVarIndex = 0;
 
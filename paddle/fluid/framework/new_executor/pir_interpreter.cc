@@ -14,21 +14,29 @@
 
 #include "paddle/fluid/framework/new_executor/pir_interpreter.h"
 
+#include <algorithm>
 #include <chrono>
+#include <fstream>
 #include <unordered_set>
 
 #include "paddle/utils/flags.h"
 
 #include "paddle/fluid/framework/details/nan_inf_utils.h"
 #include "paddle/fluid/framework/details/share_tensor_buffer_functor.h"
+#include "paddle/fluid/framework/new_executor/executor_statistics.h"
 #include "paddle/fluid/framework/new_executor/interpreter/interpreter_util.h"
 #include "paddle/fluid/framework/new_executor/interpreter/static_build.h"
+#include "paddle/fluid/framework/new_executor/interpreter/static_memory_planner.h"
 #include "paddle/fluid/framework/operator.h"
+#include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/fluid/memory/allocation/memory_attribution.h"
+#include "paddle/fluid/memory/malloc.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #include "paddle/fluid/platform/os_info.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
 #include "paddle/fluid/platform/profiler/supplement_tracing.h"
 #include "paddle/phi/common/place.h"
+#include "paddle/phi/core/generator.h"
 #include "paddle/phi/core/kernel_context.h"
 #include "paddle/phi/core/sparse_coo_tensor.h"
 #include "paddle/phi/core/sparse_csr_tensor.h"
@@ -81,6 +89,7 @@ PHI_DECLARE_bool(dynamic_static_unified_comm);
 
 PHI_DECLARE_bool(enable_pir_in_executor);
 PHI_DECLARE_bool(enable_pir_in_executor_trace_run);
+PHI_DECLARE_bool(use_random_substreams);
 
 #define CREATE_INSTR(instr_name)                                   \
   vec_instruction_base_.emplace_back(std::make_unique<instr_name>( \
@@ -131,6 +140,10 @@ PirInterpreter::PirInterpreter(const platform::Place& place,
     SchedulingPriority rhs_scheduling_priority =
         vec_instruction_base_[rhs]->GetSchedulingPriority();
     if (lhs_scheduling_priority == rhs_scheduling_priority) {
+      if (!critical_path_ranks_.empty() &&
+          critical_path_ranks_[lhs] != critical_path_ranks_[rhs]) {
+        return critical_path_ranks_[lhs] < critical_path_ranks_[rhs];
+      }
       return lhs > rhs;
     }
     return lhs_scheduling_priority > rhs_scheduling_priority;
@@ -193,6 +206,10 @@ PirInterpreter::PirInterpreter(
     SchedulingPriority rhs_scheduling_priority =
         vec_instruction_base_[rhs]->GetSchedulingPriority();
     if (lhs_scheduling_priority == rhs_scheduling_priority) {
+      if (!critical_path_ranks_.empty() &&
+          critical_path_ranks_[lhs] != critical_path_ranks_[rhs]) {
+        return critical_path_ranks_[lhs] < critical_path_ranks_[rhs];
+      }
       return lhs > rhs;
     }
     return lhs_scheduling_priority > rhs_scheduling_priority;
@@ -207,6 +224,17 @@ PirInterpreter::PirInterpreter(
 }
 
 PirInterpreter::~PirInterpreter() {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  ResetHostOffloadPlan();
+#endif
+#ifdef PADDLE_WITH_CUSTOM_DEVICE
+  if (!custom_graph_entries_.empty()) {
+    phi::DeviceManager::SynchronizeDevice(place_);
+    for (auto& item : custom_graph_entries_) {
+      phi::DeviceManager::GraphDestroy(place_, item.second.graph);
+    }
+  }
+#endif
   // cancel gc's thread
   gc_.reset(nullptr);
   async_work_queue_.reset();
@@ -360,6 +388,179 @@ void PirInterpreter::PrepareForCUDAGraphCapture() {
 #endif
 }
 
+bool PirInterpreter::CanRunWithCUDAGraphReplay() const {
+#ifdef PADDLE_WITH_CUSTOM_DEVICE
+  if (platform::is_custom_place(place_)) {
+    if (FLAGS_new_executor_cuda_graph_replay_max_shapes <= 0 ||
+        sync_op_num_ != 0 ||
+        !phi::DeviceManager::IsGraphCaptureSupported(place_)) {
+      return false;
+    }
+    auto* default_dev_ctx = platform::DeviceContextPool::Instance().Get(place_);
+    for (auto& instr : vec_instruction_base_) {
+      if (&instr->DeviceContext() != default_dev_ctx) {
+        return false;
+      }
+    }
+    return true;
+  }
+#endif
+#ifdef PADDLE_WITH_CUDA
+  if (FLAGS_new_executor_cuda_graph_replay_max_shapes <= 0 ||
+      FLAGS_new_executor_use_cuda_graph || !platform::is_gpu_place(place_) ||
+      platform::IsCUDAGraphCapturing()) {
+    return false;
+  }
+  // Host kernels can not be captured, and the instructions must launch on
+  // the stream the graph is captured on.
+  if (sync_op_num_ != 0) {
+    return false;
+  }
+  auto* default_dev_ctx = platform::DeviceContextPool::Instance().Get(place_);
+  for (auto& instr : vec_instruction_base_) {
+    if (&instr->DeviceContext() != default_dev_ctx) {
+      return false;
+    }
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool PirInterpreter::RunWithCUDAGraphReplay(
+    const std::vector<std::string>& feed_names,
+    const std::vector<phi::DenseTensor>& feed_tensors) {
+#ifdef PADDLE_WITH_CUSTOM_DEVICE
+  if (platform::is_custom_place(place_)) {
+    return RunWithCustomGraphReplay(feed_names, feed_tensors);
+  }
+#endif
+#ifdef PADDLE_WITH_CUDA
+  std::stringstream ss;
+  for (auto& tensor : feed_tensors) {
+    ss << phi::DataTypeToString(tensor.dtype()) << "[" << tensor.dims()
+       << "];";
+  }
+  std::string key = ss.str();
+
+  auto* dev_ctx = platform::DeviceContextPool::Instance().Get(place_);
+  auto ShareFeedBuffers = [&](std::vector<phi::DenseTensor>* feed_buffers) {
+    for (size_t i = 0; i < feed_names.size(); ++i) {
+      if (!feed_tensors[i].IsSharedWith((*feed_buffers)[i])) {
+        framework::TensorCopy(
+            feed_tensors[i], place_, *dev_ctx, &(*feed_buffers)[i]);
+      }
+      auto* feed_tensor =
+          InnerScope()->FindVar(feed_names[i])->GetMutable<phi::DenseTensor>();
+      feed_tensor->ShareDataWith((*feed_buffers)[i]);
+      feed_tensor->set_lod(feed_tensors[i].lod());
+    }
+  };
+
+  auto iter = cuda_graph_entries_.find(key);
+  if (iter != cuda_graph_entries_.end()) {
+    VLOG(4) << "Replay CUDA Graph for feed shapes " << key;
+    ShareFeedBuffers(&iter->second.feed_buffers);
+    iter->second.graph->Replay();
+    return true;
+  }
+
+  if (cuda_graph_entries_.size() >=
+      static_cast<size_t>(FLAGS_new_executor_cuda_graph_replay_max_shapes)) {
+    VLOG(4) << "CUDA Graph cache is full, run feed shapes " << key
+            << " without replay";
+    return false;
+  }
+
+  VLOG(4) << "Capture CUDA Graph for feed shapes " << key;
+  CUDAGraphReplayEntry entry;
+  entry.feed_buffers.resize(feed_names.size());
+  ShareFeedBuffers(&entry.feed_buffers);
+  // Each graph owns its memory pool, so the intermediate tensors keep their
+  // addresses until the entry is destroyed.
+  platform::BeginCUDAGraphCapture(place_, cudaStreamCaptureModeRelaxed);
+  TraceRunImpl();
+  entry.graph = platform::EndCUDAGraphCapture();
+  entry.graph->Replay();
+  cuda_graph_entries_.emplace(key, std::move(entry));
+  return true;
+#else
+  return false;
+#endif
+}
+
+#ifdef PADDLE_WITH_CUSTOM_DEVICE
+bool PirInterpreter::RunWithCustomGraphReplay(
+    const std::vector<std::string>& feed_names,
+    const std::vector<phi::DenseTensor>& feed_tensors) {
+  std::stringstream ss;
+  for (auto& tensor : feed_tensors) {
+    ss << phi::DataTypeToString(tensor.dtype()) << "[" << tensor.dims()
+       << "];";
+  }
+  std::string key = ss.str();
+
+  auto* dev_ctx = static_cast<phi::CustomContext*>(
+      platform::DeviceContextPool::Instance().Get(place_));
+  auto ShareFeedBuffers = [&](std::vector<phi::DenseTensor>* feed_buffers) {
+    for (size_t i = 0; i < feed_names.size(); ++i) {
+      if (!feed_tensors[i].IsSharedWith((*feed_buffers)[i])) {
+        framework::TensorCopy(
+            feed_tensors[i], place_, *dev_ctx, &(*feed_buffers)[i]);
+      }
+      auto* feed_tensor =
+          InnerScope()->FindVar(feed_names[i])->GetMutable<phi::DenseTensor>();
+      feed_tensor->ShareDataWith((*feed_buffers)[i]);
+      feed_tensor->set_lod(feed_tensors[i].lod());
+    }
+  };
+
+  auto iter = custom_graph_entries_.find(key);
+  if (iter != custom_graph_entries_.end()) {
+    VLOG(4) << "Replay custom device graph for feed shapes " << key;
+    for (auto& var_tensor : iter->second.var_tensors) {
+      var_tensor.first->GetMutable<phi::DenseTensor>()->ShareDataWith(
+          var_tensor.second);
+    }
+    ShareFeedBuffers(&iter->second.feed_buffers);
+    phi::DeviceManager::GraphLaunch(
+        place_, *dev_ctx->GetStream(), iter->second.graph);
+    return true;
+  }
+
+  if (custom_graph_entries_.size() >=
+      static_cast<size_t>(FLAGS_new_executor_cuda_graph_replay_max_shapes)) {
+    VLOG(4) << "Custom device graph cache is full, run feed shapes " << key
+            << " without replay";
+    return false;
+  }
+
+  VLOG(4) << "Capture custom device graph for feed shapes " << key;
+  CustomGraphReplayEntry entry;
+  entry.feed_buffers.resize(feed_names.size());
+  ShareFeedBuffers(&entry.feed_buffers);
+  // The feed buffers are written before the capture, so that the copies are
+  // not recorded into the graph.
+  dev_ctx->Wait();
+  phi::DeviceManager::StreamBeginCapture(place_, *dev_ctx->GetStream());
+  custom_graph_capturing_ = true;
+  TraceRunImpl();
+  custom_graph_capturing_ = false;
+  entry.graph =
+      phi::DeviceManager::StreamEndCapture(place_, *dev_ctx->GetStream());
+  for (auto* var : value_exe_info_->GetVarList()) {
+    if (var != nullptr && var->IsType<phi::DenseTensor>() &&
+        var->Get<phi::DenseTensor>().IsInitialized()) {
+      entry.var_tensors.emplace_back(var, var->Get<phi::DenseTensor>());
+    }
+  }
+  phi::DeviceManager::GraphLaunch(place_, *dev_ctx->GetStream(), entry.graph);
+  custom_graph_entries_.emplace(key, std::move(entry));
+  return true;
+}
+#endif
+
 void PirInterpreter::CheckCUDAGraphBeforeRun(
     const std::vector<std::string>& feed_names) {
 #ifdef PADDLE_WITH_CUDA
@@ -944,6 +1145,22 @@ void PirInterpreter::BuildInstructionDependences() {
       }
     }
   }
+
+  if (FLAGS_new_executor_use_critical_path_priority) {
+    // Rank by the number of instructions on the longest path first, then
+    // refine the ranks with the measured cost after the first run.
+    instr_costs_.assign(instr_num, 1.0);
+    critical_path_ranks_ =
+        interpreter::ComputeCriticalPathRanks(downstream_map, instr_costs_);
+    need_record_instr_costs_ = true;
+  }
+}
+
+void PirInterpreter::UpdateCriticalPathRanks() {
+  critical_path_ranks_ = interpreter::ComputeCriticalPathRanks(
+      ir_dependency_builder_.OpDownstreamMap(), instr_costs_);
+  need_record_instr_costs_ = false;
+  VLOG(4) << "Update critical path ranks with the measured instruction costs";
 }
 
 void PirInterpreter::RecordMemcpyD2H(InstructionBase* instr_node) {
@@ -1106,6 +1323,12 @@ void PirInterpreter::CheckGC(InstructionBase* instr) {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   RecordStreamForGC(instr);
 #endif
+#ifdef PADDLE_WITH_CUSTOM_DEVICE
+  if (custom_graph_capturing_) {
+    instr->ClearEagerGCVars();
+    return;
+  }
+#endif
 
   for (auto var_id : instr->GCCheckVars()) {
     VLOG(4) << "GC:" << value_exe_info_->GetNameById(static_cast<int>(var_id))
@@ -1134,6 +1357,9 @@ void PirInterpreter::CheckGC(InstructionBase* instr) {
 
 void PirInterpreter::CalculateLastLiveOps() {
   VLOG(4) << "PirInterpreter(): " << this << " start CalculateLastLiveOps";
+  // the op defining each var, -1 for the vars not defined by any op (feed,
+  // parameters) and -2 for the vars defined by more than one op (inplace)
+  std::vector<int> def_ops(value_exe_info_->GetVarList().size(), -1);
   // calculate last_live_ops_
   for (size_t op_idx = 0; op_idx < vec_instruction_base_.size(); ++op_idx) {
     InstructionBase* instr = vec_instruction_base_[op_idx].get();
@@ -1143,6 +1369,14 @@ void PirInterpreter::CalculateLastLiveOps() {
         instr->Inputs();
     const std::unordered_map<::pir::Value, std::vector<int>>& outs =
         instr->Outputs();
+    for (auto& item : outs) {
+      for (auto var_id : item.second) {
+        if (var_id >= 0 && static_cast<size_t>(var_id) < def_ops.size()) {
+          def_ops[var_id] =
+              def_ops[var_id] == -1 ? static_cast<int>(op_idx) : -2;
+        }
+      }
+    }
     std::unordered_multimap<::pir::Value, std::vector<int>> ins_and_outs{
         ins.begin(), ins.end()};
 
@@ -1210,25 +1444,18 @@ void PirInterpreter::CalculateLastLiveOps() {
   }
   VLOG(4) << "var_ref_count_.size() : " << var_ref_count_.size();
   for (size_t i = 0; i < last_live_ops_.size(); ++i) {
-    std::set<size_t> minumum_last_live_ops;
-    for (size_t item : last_live_ops_[i]) {
-      bool not_before_any = true;
-      // find the op that is not executed before any
-      for (size_t other_item : last_live_ops_[i]) {
-        if (ir_dependency_builder_.OpHappensBefore(item, other_item)) {
-          VLOG(6) << "happens_before: " << item << "->" << other_item
-                  << ", so skip " << item;
-          not_before_any = false;
-          break;
-        }
-      }
-      if (not_before_any) {
-        VLOG(6) << "last live op of var " << i << " "
-                << value_exe_info_->GetNameById(static_cast<int>(i)) << " : "
-                << item << " " << vec_instruction_base_[item]->Name();
-        minumum_last_live_ops.insert(item);
-        vec_instruction_base_[item]->AddGCCheckVar(i);
-      }
+    std::set<size_t> minumum_last_live_ops =
+        ShrinkLastLiveOps(last_live_ops_[i]);
+    if (FLAGS_new_executor_dependency_aware_gc && i < def_ops.size() &&
+        def_ops[i] >= 0 && !minumum_last_live_ops.empty()) {
+      minumum_last_live_ops = ShrinkLastLiveOps(MoveLastLiveOpsToOwningStream(
+          static_cast<size_t>(def_ops[i]), minumum_last_live_ops));
+    }
+    for (size_t item : minumum_last_live_ops) {
+      VLOG(6) << "last live op of var " << i << " "
+              << value_exe_info_->GetNameById(static_cast<int>(i)) << " : "
+              << item << " " << vec_instruction_base_[item]->Name();
+      vec_instruction_base_[item]->AddGCCheckVar(i);
     }
     last_live_ops_[i] = minumum_last_live_ops;
     var_ref_count_[i] = static_cast<int>(last_live_ops_[i].size());
@@ -1245,6 +1472,68 @@ void PirInterpreter::CalculateLastLiveOps() {
   VLOG(4) << "done CalculateLastLiveOps";
 }
 
+std::set<size_t> PirInterpreter::ShrinkLastLiveOps(
+    const std::set<size_t>& last_live_ops) {
+  std::set<size_t> minumum_last_live_ops;
+  for (size_t item : last_live_ops) {
+    bool not_before_any = true;
+    // find the op that is not executed before any
+    for (size_t other_item : last_live_ops) {
+      if (ir_dependency_builder_.OpHappensBefore(item, other_item)) {
+        VLOG(6) << "happens_before: " << item << "->" << other_item
+                << ", so skip " << item;
+        not_before_any = false;
+        break;
+      }
+    }
+    if (not_before_any) {
+      minumum_last_live_ops.insert(item);
+    }
+  }
+  return minumum_last_live_ops;
+}
+
+// For a var allocated on stream A but last used by an op on stream B, the
+// StreamSafeCUDAAllocator has to record an event on B when the var is
+// released, and query the event before the memory can be reused on A. If an
+// op on A is known to run after the last user by the dependency graph, there
+// is already an event between them inserted by the stream analyzer, so
+// checking the var after that op frees the memory on A directly.
+std::set<size_t> PirInterpreter::MoveLastLiveOpsToOwningStream(
+    size_t def_op, const std::set<size_t>& last_live_ops) {
+  InstructionBase* def_instr = vec_instruction_base_[def_op].get();
+  if (def_instr->KernelType() != OpFuncType::kGpuAsync ||
+      !platform::is_gpu_place(def_instr->DeviceContext().GetPlace())) {
+    return last_live_ops;
+  }
+  const platform::DeviceContext* owning_ctx = &def_instr->DeviceContext();
+  std::set<size_t> result;
+  for (size_t item : last_live_ops) {
+    InstructionBase* instr = vec_instruction_base_[item].get();
+    size_t target = item;
+    if (instr->KernelType() == OpFuncType::kGpuAsync &&
+        &instr->DeviceContext() != owning_ctx) {
+      // the ops are sorted in the topological order, so the first one found
+      // is the earliest op on the owning stream running after item
+      for (size_t next = item + 1; next < vec_instruction_base_.size();
+           ++next) {
+        InstructionBase* next_instr = vec_instruction_base_[next].get();
+        if (next_instr->KernelType() == OpFuncType::kGpuAsync &&
+            &next_instr->DeviceContext() == owning_ctx &&
+            ir_dependency_builder_.OpHappensBefore(item, next)) {
+          VLOG(6) << "move gc check from op " << item << " "
+                  << instr->Name() << " to op " << next << " "
+                  << next_instr->Name() << " on the owning stream";
+          target = next;
+          break;
+        }
+      }
+    }
+    result.insert(target);
+  }
+  return result;
+}
+
 void PirInterpreter::ConstructEventForJitInput() {
   for (size_t i = 0; i < dependency_count_->size(); ++i) {
     if ((*dependency_count_)[i] == 0) {
@@ -1336,17 +1625,25 @@ paddle::framework::FetchList PirInterpreter::Run(
 
     is_build_ = true;
     is_shared_results_build_ = true;
+    if (!FLAGS_new_executor_dispatch_table_file.empty()) {
+      ExportDispatchTable(FLAGS_new_executor_dispatch_table_file);
+    }
   } else {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
     if (switch_stream) {
+      ResetHostOffloadPlan();
       BuildInstruction();
       VLOG(4) << "Done BuildInstruction";
     }
 #endif
-    if (FLAGS_enable_pir_in_executor_trace_run || onednn_op_num_ ||
-        execution_config_.used_for_inference ||
-        ((execution_config_.used_for_jit || execution_config_.used_for_cinn) &&
-         (sync_op_num_ == 0))) {
+    if (CanRunWithCUDAGraphReplay() &&
+        RunWithCUDAGraphReplay(feed_names, feed_tensors)) {
+      VLOG(4) << "Done RunWithCUDAGraphReplay";
+    } else if (FLAGS_enable_pir_in_executor_trace_run || onednn_op_num_ ||
+               execution_config_.used_for_inference ||
+               ((execution_config_.used_for_jit ||
+                 execution_config_.used_for_cinn) &&
+                (sync_op_num_ == 0))) {
       TraceRunImpl();
     } else {
       MultiThreadRunImpl();
@@ -1426,17 +1723,39 @@ FetchList PirInterpreter::Run(const std::vector<std::string>& feed_names,
 
     is_build_ = true;
     is_shared_results_build_ = true;
+    if (!FLAGS_new_executor_dispatch_table_file.empty()) {
+      ExportDispatchTable(FLAGS_new_executor_dispatch_table_file);
+    }
   } else {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
     if (switch_stream) {
+      ResetHostOffloadPlan();
       BuildInstruction();
       VLOG(4) << "Done BuildInstruction";
     }
 #endif
-    if (FLAGS_enable_pir_in_executor_trace_run || onednn_op_num_ ||
-        execution_config_.used_for_inference ||
-        ((execution_config_.used_for_jit || execution_config_.used_for_cinn) &&
-         (sync_op_num_ == 0))) {
+    bool replayed = false;
+    if (CanRunWithCUDAGraphReplay()) {
+      // the feed tensors have been set into the scope by the caller
+      std::vector<phi::DenseTensor> feed_tensors;
+      for (auto& feed_name : feed_names) {
+        auto* feed_var = InnerScope()->FindVar(feed_name);
+        if (feed_var == nullptr || !feed_var->IsType<phi::DenseTensor>()) {
+          break;
+        }
+        feed_tensors.push_back(feed_var->Get<phi::DenseTensor>());
+      }
+      if (feed_tensors.size() == feed_names.size()) {
+        replayed = RunWithCUDAGraphReplay(feed_names, feed_tensors);
+      }
+    }
+    if (replayed) {
+      VLOG(4) << "Done RunWithCUDAGraphReplay";
+    } else if (FLAGS_enable_pir_in_executor_trace_run || onednn_op_num_ ||
+               execution_config_.used_for_inference ||
+               ((execution_config_.used_for_jit ||
+                 execution_config_.used_for_cinn) &&
+                (sync_op_num_ == 0))) {
       TraceRunImpl();
     } else {
       MultiThreadRunImpl();
@@ -1472,8 +1791,26 @@ void PirInterpreter::TraceRunImpl() {
   interpreter::ResetAtomicGuard guard(&deps_, &refs_);
   VLOG(4) << "Tracing Instruction List";
 
+  ApplyStaticMemoryPlan();
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (FLAGS_new_executor_use_host_offload && !host_offload_plan_built_) {
+    BuildHostOffloadPlan();
+  }
+#endif
   TraceRunInstructionList(vec_instruction_base_);
   VLOG(4) << "Done TraceRunInstructionList";
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (host_offload_manager_) {
+    host_offload_manager_->Synchronize();
+  }
+#endif
+
+  if (need_record_instr_costs_) {
+    UpdateCriticalPathRanks();
+  }
+  if (static_memory_plan_recording_) {
+    BuildStaticMemoryPlan();
+  }
 }
 
 void PirInterpreter::MultiThreadRunImpl() {
@@ -1486,8 +1823,21 @@ void PirInterpreter::MultiThreadRunImpl() {
   VLOG(4) << "Multi Thread Run Instruction List";
 
   async_work_queue_ = GetWorkQueue();
+  ApplyStaticMemoryPlan();
   MultiThreadRunInstructionList(vec_instruction_base_);
   VLOG(4) << "Done MultiThreadRunInstructionList";
+
+  if (need_record_instr_costs_) {
+    UpdateCriticalPathRanks();
+  }
+  if (static_memory_plan_recording_) {
+    BuildStaticMemoryPlan();
+  }
+
+  if (FLAGS_new_executor_use_work_stealing) {
+    WorkQueuePerfStatistics("HostTasks",
+                            async_work_queue_->QueueWorkerStatistics(0));
+  }
 }
 
 void PirInterpreter::TraceRunInstructionList(
@@ -1527,12 +1877,22 @@ void PirInterpreter::TraceRunInstructionList(
 
     VLOG(6) << "Run InstructionBase " << instr_node->Name() << "[" << instr_id
             << "]";
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    if (host_offload_manager_) {
+      host_offload_manager_->BeforeRun(idx);
+    }
+#endif
     RunInstructionBase(instr_node);
 
     if (UNLIKELY(exception_holder_.IsCaught())) {
       VLOG(4) << "Exception caught";
       break;
     }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    if (host_offload_manager_) {
+      host_offload_manager_->AfterRun(idx);
+    }
+#endif
   }
 
   if (UNLIKELY(exception_holder_.IsCaught())) {
@@ -1676,11 +2036,30 @@ void PirInterpreter::RunInstructionBaseAsync(size_t instr_id) {
   }
 }
 
+void PirInterpreter::TagOutputMemory(InstructionBase* instr_node) {
+  auto& attribution = memory::allocation::MemoryAttribution::Instance();
+  for (auto& item : instr_node->Outputs()) {
+    auto* var = value_exe_info_->GetVarByValue(item.first);
+    if (var == nullptr || !var->IsType<phi::DenseTensor>()) continue;
+    const auto& holder = var->Get<phi::DenseTensor>().Holder();
+    if (holder) {
+      attribution.TagVariable(holder->ptr(),
+                              value_exe_info_->GetVarName(item.first));
+    }
+  }
+}
+
 void PirInterpreter::RunNextInstructions(InstructionBase* instr,
                                          SchedulingQueue* reserved_next_ops) {
   platform::RecordEvent record(
       "RunNextInstructions", platform::TracerEventType::UserDefined, 10);
 
+  if (FLAGS_new_executor_use_work_stealing && !FLAGS_new_executor_serial_run &&
+      instr->KernelType() != OpFuncType::kGpuAsync) {
+    RunNextInstructionsWorkStealing(instr, reserved_next_ops);
+    return;
+  }
+
   auto IsReady = [this](size_t next_id) {
     VLOG(4) << "op_id: " << next_id
             << ", remain deps: " << deps_[next_id]->DynamicDep();
@@ -1702,6 +2081,54 @@ void PirInterpreter::RunNextInstructions(InstructionBase* instr,
   }
 }
 
+void PirInterpreter::RunNextInstructionsWorkStealing(
+    InstructionBase* instr, SchedulingQueue* reserved_next_ops) {
+  // NOTE: instr runs on a worker of the host queue, so AddTask of a host
+  // instruction pushes it to the front of the worker's own run queue, where
+  // the idle host workers can steal it from the back. Device instructions
+  // still go to the single device launch thread to keep the launch order.
+  std::vector<size_t> ready_host_instrs;
+  auto Dispatch = [this, &ready_host_instrs](size_t next_instr_id) {
+    VLOG(4) << "op_id: " << next_instr_id
+            << ", remain deps: " << deps_[next_instr_id]->DynamicDep();
+    if (!deps_[next_instr_id]->CheckAndDecrease()) {
+      return;
+    }
+    if (vec_instruction_base_[next_instr_id]->KernelType() ==
+        OpFuncType::kGpuAsync) {
+      async_work_queue_->AddTask(
+          OpFuncType::kGpuAsync,
+          [this, next_instr_id]() { RunInstructionBaseAsync(next_instr_id); });
+    } else {
+      ready_host_instrs.push_back(next_instr_id);
+    }
+  };
+
+  for (size_t next_instr_id : instr->NextInstrsInDifferenceThread()) {
+    Dispatch(next_instr_id);
+  }
+  for (size_t next_instr_id : instr->NextInstrsInSameThread()) {
+    Dispatch(next_instr_id);
+  }
+  if (ready_host_instrs.empty()) {
+    return;
+  }
+
+  // Sort by ascending priority: the local queue is LIFO for its owner, so the
+  // instructions pushed last are popped first, and the one with the highest
+  // priority is kept to run right after the current instruction.
+  std::sort(ready_host_instrs.begin(),
+            ready_host_instrs.end(),
+            ir_instruction_scheduling_priority_less);
+  for (size_t i = 0; i + 1 < ready_host_instrs.size(); ++i) {
+    size_t next_instr_id = ready_host_instrs[i];
+    async_work_queue_->AddTask(
+        vec_instruction_base_[next_instr_id]->KernelType(),
+        [this, next_instr_id]() { RunInstructionBaseAsync(next_instr_id); });
+  }
+  reserved_next_ops->push(ready_host_instrs.back());
+}
+
 void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
   platform::RecordEvent instruction_event(
       instr_node->Name(), platform::TracerEventType::Operator, 1);
@@ -1733,7 +2160,29 @@ void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
             << "Before: " << cur_place << " "
             << instr_node->DebugStringEx(scope_, value_exe_info_.get());
     if (!instr_node->IsArtificial()) {
-      instr_node->Run();
+      memory::allocation::MemoryAttributionGuard memory_guard(
+          instr_node->Id(), instr_node->Name());
+      // The random ops draw from the sub-streams by the ids of the ops.
+      std::unique_ptr<phi::Generator::SubStreamGuard> sub_stream_guard;
+      if (FLAGS_use_random_substreams && instr_node->Operation()) {
+        sub_stream_guard = std::make_unique<phi::Generator::SubStreamGuard>(
+            instr_node->Operation()->id());
+      }
+      if (UNLIKELY(need_record_instr_costs_)) {
+        // NOTE: only the host time is recorded, for the async device kernels
+        // it is the launch cost.
+        auto start = std::chrono::steady_clock::now();
+        instr_node->Run();
+        instr_costs_[instr_node->Id()] =
+            std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+      } else {
+        instr_node->Run();
+      }
+      if (UNLIKELY(memory::allocation::MemoryAttribution::IsEnabled())) {
+        TagOutputMemory(instr_node);
+      }
 
       if (FLAGS_benchmark) {
         instr_node->DeviceContext().Wait();
@@ -1743,6 +2192,9 @@ void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
                 << "): context wait and get last error";
 #endif
       }
+      if (UNLIKELY(static_memory_plan_recording_)) {
+        RecordStaticMemoryPlanInfo(instr_node);
+      }
       VLOG(2) << "\ndone: " << __func__ << " OP id:" << instr_node->Id()
               << " name:" << instr_node->Name() << " type:"
               << (instr_node->KernelType() == OpFuncType::kCpuSync
@@ -1780,6 +2232,13 @@ void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
     exception_holder_.Catch(std::make_exception_ptr(std::move(ex)));
   } catch (platform::EOFException&) {
     exception_holder_.Catch(std::current_exception());
+  } catch (memory::allocation::BadAlloc& ex) {
+    LOG(WARNING) << instr_node->Name() << " raises an out of memory exception, "
+                 << ex.what();
+    if (memory::allocation::MemoryAttribution::IsEnabled()) {
+      memory::allocation::MemoryAttribution::Instance().ReportOnError();
+    }
+    exception_holder_.Catch(std::current_exception());
   } catch (std::exception& ex) {
     LOG(WARNING) << instr_node->Name() << " raises an exception "
                  << platform::demangle(typeid(ex).name()) << ", " << ex.what();
@@ -1825,8 +2284,289 @@ void PirInterpreter::PreAnalysis() {
 
   UpdateOneDNNOpNum();
   VLOG(4) << "Done UpdateOneDNNOpNum";
+
+  if (FLAGS_new_executor_use_static_memory_plan) {
+    static_memory_plan_infos_.assign(value_exe_info_->GetVarList().size(),
+                                     StaticMemoryPlanVarInfo());
+    static_memory_plan_recording_ = true;
+  }
+}
+
+void PirInterpreter::RecordStaticMemoryPlanInfo(InstructionBase* instr) {
+  // NOTE: the instructions writing the same variable are ordered by the
+  // dependency graph, so it is safe to record without lock.
+  for (auto& item : instr->Outputs()) {
+    for (auto var_id : item.second) {
+      auto* var = value_exe_info_->GetVarList()[var_id];
+      auto& info = static_memory_plan_infos_[var_id];
+      ++info.def_count;
+      info.def_instr = instr->Id();
+      if (var->IsType<phi::DenseTensor>() &&
+          var->Get<phi::DenseTensor>().IsInitialized()) {
+        const auto& holder = var->Get<phi::DenseTensor>().Holder();
+        info.holder = holder.get();
+        info.size = holder->size();
+      } else {
+        info.holder = nullptr;
+        info.size = 0;
+      }
+    }
+  }
+}
+
+void PirInterpreter::BuildStaticMemoryPlan() {
+  static_memory_plan_recording_ = false;
+  if (exception_holder_.IsCaught()) {
+    return;
+  }
+
+  // A holder shared by several variables (views, buffer sharing, fetch) must
+  // live as long as the longest of them, skip those variables.
+  std::unordered_map<const phi::Allocation*, size_t> holder_ref_count;
+  for (auto& info : static_memory_plan_infos_) {
+    if (info.holder != nullptr) {
+      ++holder_ref_count[info.holder];
+    }
+  }
+
+  std::map<const platform::DeviceContext*, std::vector<size_t>> groups;
+  for (size_t var_id = 0; var_id < static_memory_plan_infos_.size();
+       ++var_id) {
+    const auto& info = static_memory_plan_infos_[var_id];
+    if (info.def_count != 1 || info.holder == nullptr || info.size == 0 ||
+        holder_ref_count[info.holder] != 1 ||
+        last_live_ops_[var_id].empty() ||
+        parameter_var_names_.count(
+            value_exe_info_->GetNameById(static_cast<int>(var_id)))) {
+      continue;
+    }
+    auto* instr = vec_instruction_base_[info.def_instr].get();
+    if (info.holder->place() != instr->DeviceContext().GetPlace()) {
+      continue;
+    }
+    groups[&instr->DeviceContext()].push_back(var_id);
+  }
+
+  auto happens_before = [this](size_t prior, size_t posterior) {
+    return ir_dependency_builder_.OpHappensBefore(prior, posterior);
+  };
+  // 256 bytes matches the alignment of the CUDA allocations
+  interpreter::StaticMemoryPlanner planner(256);
+  size_t total_size = 0;
+  size_t planned_size = 0;
+  for (auto& [dev_ctx, var_ids] : groups) {
+    std::vector<interpreter::BufferLifetime> buffers;
+    for (size_t var_id : var_ids) {
+      const auto& info = static_memory_plan_infos_[var_id];
+      buffers.push_back({info.size,
+                         static_cast<size_t>(info.def_instr),
+                         last_live_ops_[var_id]});
+      total_size += info.size;
+    }
+    std::vector<size_t> offsets;
+    size_t arena_size = planner.Plan(buffers, happens_before, &offsets);
+    planned_size += arena_size;
+
+    static_memory_plan_arenas_.emplace_back(
+        memory::Alloc(dev_ctx->GetPlace(), arena_size));
+    auto* arena = static_memory_plan_arenas_.back().get();
+    for (size_t i = 0; i < var_ids.size(); ++i) {
+      auto* tensor = value_exe_info_->GetVarList()[var_ids[i]]
+                         ->GetMutable<phi::DenseTensor>();
+      // non-owning view of the arena, see ApplyStaticMemoryPlan
+      auto view = std::make_shared<phi::Allocation>(
+          static_cast<uint8_t*>(arena->ptr()) + offsets[i],
+          buffers[i].size,
+          arena->place());
+      static_memory_plan_bindings_.emplace_back(tensor, std::move(view));
+    }
+  }
+  VLOG(1) << "Static memory plan: " << static_memory_plan_bindings_.size()
+          << " variables, " << total_size << " bytes are packed into "
+          << planned_size << " bytes in " << groups.size() << " arena(s)";
+  static_memory_plan_infos_.clear();
+}
+
+void PirInterpreter::ApplyStaticMemoryPlan() {
+  // Kernels reuse the holder of the output tensor if it is large enough, so
+  // binding the views before each run removes the allocator calls. A tensor
+  // that grows (e.g., the shape is not static) just allocates as usual.
+  for (auto& [tensor, view] : static_memory_plan_bindings_) {
+    if (tensor->IsInitialized()) {
+      continue;
+    }
+    size_t bytes = tensor->numel() * phi::SizeOf(tensor->dtype()) +
+                   tensor->meta().offset;
+    if (bytes <= view->size()) {
+      tensor->ResetHolder(view);
+    }
+  }
 }
 
+void PirInterpreter::ExportDispatchTable(const std::string& path) const {
+  std::ofstream fout(path);
+  if (!fout) {
+    LOG(WARNING) << "Failed to write the dispatch table to " << path;
+    return;
+  }
+  auto quote = [](const std::string& str) {
+    std::string quoted = "\"";
+    for (char c : str) {
+      if (c == '"' || c == '\\') quoted += '\\';
+      quoted += c;
+    }
+    return quoted + "\"";
+  };
+
+  fout << "// Generated by PirInterpreter for " << place_
+       << ", do not edit.\n\n#include <cstddef>\n\n"
+       << "struct DispatchEntry {\n  int instr_id;\n  const char* op_name;\n"
+       << "  const char* kernel_name;\n  const char* kernel_key;\n};\n\n"
+       << "// the instructions in the launch order\n"
+       << "static const DispatchEntry kDispatchTable[] = {\n";
+  for (auto instr_id : trace_execute_order_) {
+    auto* instr = vec_instruction_base_[instr_id].get();
+    std::string kernel_name, kernel_key;
+    ::pir::Operation* op = instr->Operation();
+    if (op != nullptr && op->HasAttribute("kernel_name") &&
+        op->HasAttribute("kernel_key")) {
+      kernel_name = op->attribute("kernel_name")
+                        .dyn_cast<pir::StrAttribute>()
+                        .AsString();
+      std::ostringstream os;
+      os << op->attribute("kernel_key")
+                .dyn_cast<paddle::dialect::KernelAttribute>()
+                .data();
+      kernel_key = os.str();
+    }
+    fout << "    {" << instr_id << ", " << quote(instr->Name()) << ", "
+         << quote(kernel_name) << ", " << quote(kernel_key) << "},\n";
+  }
+  fout << "};\n";
+
+  if (static_memory_plan_bindings_.empty()) {
+    return;
+  }
+  std::unordered_map<const phi::DenseTensor*, std::string> tensor_names;
+  const auto& var_list = value_exe_info_->GetVarList();
+  for (size_t var_id = 0; var_id < var_list.size(); ++var_id) {
+    if (var_list[var_id]->IsType<phi::DenseTensor>()) {
+      tensor_names[&var_list[var_id]->Get<phi::DenseTensor>()] =
+          value_exe_info_->GetNameById(static_cast<int>(var_id));
+    }
+  }
+  fout << "\nstatic const size_t kArenaSizes[] = {";
+  for (size_t i = 0; i < static_memory_plan_arenas_.size(); ++i) {
+    fout << (i ? ", " : "") << static_memory_plan_arenas_[i]->size();
+  }
+  fout << "};\n\nstruct BufferEntry {\n  const char* var_name;\n"
+       << "  int arena;\n  size_t offset;\n  size_t size;\n};\n\n"
+       << "// the variables bound to the arenas by the static memory plan\n"
+       << "static const BufferEntry kBufferTable[] = {\n";
+  for (auto& [tensor, view] : static_memory_plan_bindings_) {
+    auto* ptr = static_cast<const uint8_t*>(view->ptr());
+    for (size_t i = 0; i < static_memory_plan_arenas_.size(); ++i) {
+      auto* arena = static_cast<const uint8_t*>(
+          static_memory_plan_arenas_[i]->ptr());
+      if (ptr >= arena && ptr < arena + static_memory_plan_arenas_[i]->size()) {
+        fout << "    {" << quote(tensor_names[tensor]) << ", " << i << ", "
+             << ptr - arena << ", " << view->size() << "},\n";
+        break;
+      }
+    }
+  }
+  fout << "};\n";
+  VLOG(1) << "Write the dispatch table of " << trace_execute_order_.size()
+          << " instructions to " << path;
+}
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+void PirInterpreter::BuildHostOffloadPlan() {
+  host_offload_plan_built_ = true;
+  if (!platform::is_gpu_place(place_) ||
+      FLAGS_new_executor_cuda_graph_replay_max_shapes > 0 ||
+      trace_execute_order_.empty()) {
+    return;
+  }
+
+  // the uses of each variable in the trace order, and the stream of them. The
+  // variables used on more than one stream or by host instructions are not
+  // offloaded, since the copies are only ordered with one compute stream.
+  const size_t kInvalidVar = static_cast<size_t>(-1);
+  size_t var_num = value_exe_info_->GetVarList().size();
+  std::vector<std::vector<size_t>> use_positions(var_num);
+  std::vector<const platform::DeviceContext*> use_ctxs(var_num, nullptr);
+  std::vector<bool> offloadable(var_num, true);
+  for (size_t pos = 0; pos < trace_execute_order_.size(); ++pos) {
+    auto* instr = vec_instruction_base_[trace_execute_order_[pos]].get();
+    bool is_gpu_async = instr->KernelType() == OpFuncType::kGpuAsync;
+    for (const auto* vars : {&instr->Inputs(), &instr->Outputs()}) {
+      for (auto& item : *vars) {
+        for (auto var_id : item.second) {
+          size_t id = var_id < 0 ? kInvalidVar : static_cast<size_t>(var_id);
+          if (id >= var_num) {
+            continue;
+          }
+          if (!is_gpu_async || (use_ctxs[id] != nullptr &&
+                                use_ctxs[id] != &instr->DeviceContext())) {
+            offloadable[id] = false;
+          }
+          use_ctxs[id] = &instr->DeviceContext();
+          if (use_positions[id].empty() || use_positions[id].back() != pos) {
+            use_positions[id].push_back(pos);
+          }
+        }
+      }
+    }
+  }
+
+  std::vector<interpreter::OffloadCandidate> candidates;
+  for (size_t var_id = 0; var_id < var_num; ++var_id) {
+    auto* var = value_exe_info_->GetVarList()[var_id];
+    if (!offloadable[var_id] || use_positions[var_id].empty() ||
+        var == nullptr || !var->IsType<phi::DenseTensor>()) {
+      continue;
+    }
+    bool persistable =
+        parameter_var_names_.count(value_exe_info_->GetNameById(
+            static_cast<int>(var_id))) > 0;
+    candidates.push_back({var_id, std::move(use_positions[var_id]),
+                          persistable});
+  }
+
+  size_t prefetch_distance = static_cast<size_t>(
+      std::max(FLAGS_new_executor_host_offload_prefetch_distance, 1));
+  interpreter::HostOffloadPlanner planner(2 * prefetch_distance,
+                                          prefetch_distance);
+  auto actions = planner.Plan(candidates, trace_execute_order_.size());
+  if (actions.empty()) {
+    return;
+  }
+  host_offload_manager_ = std::make_unique<interpreter::HostOffloadManager>(
+      place_,
+      trace_execute_order_.size(),
+      FLAGS_new_executor_host_offload_min_bytes);
+  for (auto& action : actions) {
+    auto* var = value_exe_info_->GetVarList()[action.var_id];
+    gpuStream_t stream =
+        reinterpret_cast<const phi::GPUContext*>(use_ctxs[action.var_id])
+            ->stream();
+    host_offload_manager_->AddAction(
+        action, var->GetMutable<phi::DenseTensor>(), stream);
+  }
+  VLOG(1) << "Host offload plan: " << host_offload_manager_->ActionNum()
+          << " actions for " << candidates.size() << " candidate variables";
+}
+
+void PirInterpreter::ResetHostOffloadPlan() {
+  if (host_offload_manager_) {
+    host_offload_manager_->Restore();
+    host_offload_manager_.reset();
+  }
+  host_offload_plan_built_ = false;
+}
+#endif
+
 ::pir::Value PirInterpreter::GetValueByName(const std::string& var_name) {
   for (auto kv : value_exe_info_->GetValue2VarName()) {
     if (kv.second == var_name) {
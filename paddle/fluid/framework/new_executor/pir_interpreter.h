@@ -15,10 +15,13 @@
 #pragma once
 #include <memory>
 #include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
+#include "paddle/fluid/framework/new_executor/interpreter/host_offload.h"
 #include "paddle/fluid/framework/new_executor/interpreter_base_impl.h"
+#include "paddle/fluid/memory/allocation/allocator.h"
 #include "paddle/pir/core/value.h"
 
 #if defined(PADDLE_WITH_CUDA)
+#include "paddle/fluid/platform/cuda_graph_with_memory_pool.h"
 #include "paddle/phi/kernels/autotune/gpu_timer.h"
 #endif
 
@@ -130,14 +133,46 @@ class PirInterpreter : public InterpreterBaseImpl {
       InstructionSchedulingPriorityLess compare);
   void ConstructEventForJitInput();
   void CalculateLastLiveOps();
+  std::set<size_t> ShrinkLastLiveOps(const std::set<size_t>& last_live_ops);
+  std::set<size_t> MoveLastLiveOpsToOwningStream(
+      size_t def_op, const std::set<size_t>& last_live_ops);
 
   // gc
   void ClearLoDTensorArrayInLocalScope();
 
+  // static memory plan, see FLAGS_new_executor_use_static_memory_plan
+  void RecordStaticMemoryPlanInfo(InstructionBase* instr);
+  void BuildStaticMemoryPlan();
+  void ApplyStaticMemoryPlan();
+
+  // see FLAGS_new_executor_dispatch_table_file
+  void ExportDispatchTable(const std::string& path) const;
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // host offload, see FLAGS_new_executor_use_host_offload
+  void BuildHostOffloadPlan();
+  void ResetHostOffloadPlan();
+#endif
+
   // cuda graph
   void CheckCUDAGraphBeforeRun(const std::vector<std::string>& feed_names);
   void PrepareForCUDAGraphCapture();
 
+  // Capture the whole program into a CUDA Graph per feed shape signature and
+  // replay it in the following runs, see
+  // FLAGS_new_executor_cuda_graph_replay_max_shapes. Return false when the
+  // program should be run by the instructions as usual. The custom devices
+  // whose plugins implement the graph api are captured in the same way.
+  bool RunWithCUDAGraphReplay(
+      const std::vector<std::string>& feed_names,
+      const std::vector<phi::DenseTensor>& feed_tensors);
+  bool CanRunWithCUDAGraphReplay() const;
+#ifdef PADDLE_WITH_CUSTOM_DEVICE
+  bool RunWithCustomGraphReplay(
+      const std::vector<std::string>& feed_names,
+      const std::vector<phi::DenseTensor>& feed_tensors);
+#endif
+
   void Build(
       const std::vector<std::string>& feed_names,
       std::vector<paddle::framework::OpFuncNode>* op_func_nodes) override;
@@ -183,6 +218,26 @@ class PirInterpreter : public InterpreterBaseImpl {
 
   std::unique_ptr<InterpreterCoreGarbageCollector> gc_;
 
+  struct StaticMemoryPlanVarInfo {
+    size_t def_count{0};
+    int64_t def_instr{-1};
+    // the holder and its size when the variable is written, only used to
+    // detect the holders shared by several variables
+    const phi::Allocation* holder{nullptr};
+    size_t size{0};
+  };
+  // recorded in the first run, indexed by variable id
+  std::vector<StaticMemoryPlanVarInfo> static_memory_plan_infos_;
+  bool static_memory_plan_recording_{false};
+  std::vector<memory::AllocationPtr> static_memory_plan_arenas_;
+  std::vector<std::pair<phi::DenseTensor*, std::shared_ptr<phi::Allocation>>>
+      static_memory_plan_bindings_;
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  std::unique_ptr<interpreter::HostOffloadManager> host_offload_manager_;
+  bool host_offload_plan_built_{false};
+#endif
+
   // last_live_ops_[i] contains the id of operators that last access the i-th
   // var
   std::map<size_t, std::set<size_t>> last_live_ops_;
@@ -220,6 +275,10 @@ class PirInterpreter : public InterpreterBaseImpl {
 
   void BuildInstructionDependences();
 
+  // Recompute the critical path ranks from the instruction costs measured in
+  // the first run.
+  void UpdateCriticalPathRanks();
+
   void TraceRunImpl();
 
   void TraceRunInstructionList(
@@ -235,8 +294,16 @@ class PirInterpreter : public InterpreterBaseImpl {
   void RunNextInstructions(InstructionBase* instr,
                            SchedulingQueue* reserved_next_ops);
 
+  // Used when FLAGS_new_executor_use_work_stealing is set, see
+  // workqueue/nonblocking_threadpool.h for the stealing policy.
+  void RunNextInstructionsWorkStealing(InstructionBase* instr,
+                                       SchedulingQueue* reserved_next_ops);
+
   void RunInstructionBase(InstructionBase* instr_node);
 
+  // Names the blocks of the outputs in the memory attribution.
+  void TagOutputMemory(InstructionBase* instr_node);
+
   void RecordMemcpyD2H(InstructionBase* instr_node);
 
   ::pir::Value GetValueByName(const std::string& var_name);
@@ -253,6 +320,13 @@ class PirInterpreter : public InterpreterBaseImpl {
 
   InstructionSchedulingPriorityLess ir_instruction_scheduling_priority_less;
 
+  // Used when FLAGS_new_executor_use_critical_path_priority is set, ready
+  // instructions with the same scheduling priority are dispatched by the
+  // descending order of their critical path ranks.
+  std::vector<double> critical_path_ranks_;
+  std::vector<double> instr_costs_;
+  bool need_record_instr_costs_{false};
+
   const ::pir::Block* ir_block_{nullptr};
 
   std::unordered_map<::pir::Block*, PirInterpreter*> sub_blocks_;  // Not owned
@@ -276,6 +350,28 @@ class PirInterpreter : public InterpreterBaseImpl {
 
 #if defined(PADDLE_WITH_CUDA)
   std::unique_ptr<phi::CalculateStreamTimer> calculate_stream_timer_;
+
+  struct CUDAGraphReplayEntry {
+    // The captured graph reads the feed data from these tensors, so their
+    // allocations must stay unchanged across replays.
+    std::vector<phi::DenseTensor> feed_buffers;
+    std::unique_ptr<platform::CUDAGraph> graph;
+  };
+  // key is the dtype and shape signature of the feed tensors
+  std::unordered_map<std::string, CUDAGraphReplayEntry> cuda_graph_entries_;
+#endif
+#ifdef PADDLE_WITH_CUSTOM_DEVICE
+  struct CustomGraphReplayEntry {
+    std::vector<phi::DenseTensor> feed_buffers;
+    // The plugin graph keeps the addresses of the tensors captured, so they
+    // are not garbage collected in the capture, and are shared back to the
+    // variables before the replay.
+    std::vector<std::pair<Variable*, phi::DenseTensor>> var_tensors;
+    void* graph{nullptr};
+  };
+  std::unordered_map<std::string, CustomGraphReplayEntry>
+      custom_graph_entries_;
+  bool custom_graph_capturing_{false};
 #endif
   size_t last_calculate_instr_id_;
   bool enable_job_schedule_profiler_;
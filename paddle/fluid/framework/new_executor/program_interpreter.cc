@@ -14,18 +14,24 @@
 
 #include "paddle/fluid/framework/new_executor/program_interpreter.h"
 
+#include <chrono>
+
 #include "paddle/fluid/framework/details/nan_inf_utils.h"
 #include "paddle/fluid/framework/details/share_tensor_buffer_functor.h"
 #include "paddle/fluid/framework/io/save_load_tensor.h"
 #include "paddle/fluid/framework/new_executor/interpreter/interpreter_util.h"
 #include "paddle/fluid/framework/new_executor/interpreter/static_build.h"
 #include "paddle/fluid/framework/operator.h"
+#include "paddle/fluid/memory/allocation/allocator_facade.h"
+#include "paddle/fluid/memory/allocation/memory_attribution.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #include "paddle/fluid/platform/os_info.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
 #include "paddle/fluid/platform/profiler/supplement_tracing.h"
 #include "paddle/phi/common/place.h"
+#include "paddle/phi/core/generator.h"
 #include "paddle/phi/core/kernel_context.h"
+#include "paddle/phi/core/metrics.h"
 #include "paddle/phi/core/sparse_coo_tensor.h"
 #include "paddle/phi/core/sparse_csr_tensor.h"
 #ifdef PADDLE_WITH_DNNL
@@ -43,11 +49,37 @@ PHI_DECLARE_bool(dynamic_static_unified_comm);
 
 PD_DECLARE_bool(enable_host_event_recorder_hook);
 PD_DECLARE_bool(log_memory_stats);
+PHI_DECLARE_bool(enable_runtime_metrics);
 PHI_DECLARE_string(static_runtime_data_save_path);
 PHI_DECLARE_bool(save_static_runtime_data);
+PHI_DECLARE_bool(use_random_substreams);
 namespace paddle {
 namespace framework {
 
+// The id of the random sub-stream of an op, by its type and outputs, which
+// are the same in every run of the program.
+static uint64_t RandomSubStreamId(const OperatorBase& op) {
+  std::hash<std::string> hasher;
+  uint64_t id = hasher(op.Type());
+  for (auto& name : op.OutputVars(true)) {
+    id = id * 31 + hasher(name);
+  }
+  return id;
+}
+
+// The histogram of the latencies of an op type, cached by the threads.
+static phi::metrics::Histogram* OpLatencyHistogram(const std::string& type) {
+  thread_local std::unordered_map<std::string, phi::metrics::Histogram*> cache;
+  auto& histogram = cache[type];
+  if (histogram == nullptr) {
+    histogram = phi::metrics::MetricsRegistry::Instance().GetHistogram(
+        "paddle_op_latency_seconds",
+        "The host latency of running the ops.",
+        {{"op", type}});
+  }
+  return histogram;
+}
+
 ProgramInterpreter::ProgramInterpreter(const platform::Place& place,
                                        const BlockDesc& block,
                                        framework::Scope* scope,
@@ -65,6 +97,11 @@ ProgramInterpreter::ProgramInterpreter(const platform::Place& place,
 
   dependency_count_ = std::make_shared<std::vector<size_t>>();
 
+  if (FLAGS_enable_runtime_metrics) {
+    memory::allocation::RegisterAllocatorMetrics();
+    phi::metrics::StartMetricsExporterFromFlags();
+  }
+
   if (!FLAGS_new_executor_use_local_scope) {
     execution_config_.create_local_scope = false;
   }
@@ -856,6 +893,7 @@ void ProgramInterpreter::BuildOpFuncNode(
     std::vector<paddle::framework::OpFuncNode>* op_func_nodes) {
   auto nodes = *op_func_nodes;
   auto op_nums = nodes.size();
+  stream_analyzer_.AssignStreams(&nodes, execution_config_.auto_stream_num);
   vec_instruction_.clear();
   vec_instruction_.reserve(op_nums);
   for (size_t op_idx = 0; op_idx < op_nums; ++op_idx) {
@@ -1173,7 +1211,26 @@ void ProgramInterpreter::RunInstruction(const Instruction& instr_node) {
 #endif
 
     if (!instr_node.IsArtificial()) {
-      RunOperator(instr_node);
+      memory::allocation::MemoryAttributionGuard memory_guard(instr_node.Id(),
+                                                              op->Type());
+      std::unique_ptr<phi::Generator::SubStreamGuard> sub_stream_guard;
+      if (FLAGS_use_random_substreams) {
+        sub_stream_guard = std::make_unique<phi::Generator::SubStreamGuard>(
+            RandomSubStreamId(*op));
+      }
+      if (FLAGS_enable_runtime_metrics) {
+        auto start = std::chrono::steady_clock::now();
+        RunOperator(instr_node);
+        OpLatencyHistogram(op->Type())
+            ->Observe(std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start)
+                          .count());
+      } else {
+        RunOperator(instr_node);
+      }
+      if (UNLIKELY(memory::allocation::MemoryAttribution::IsEnabled())) {
+        TagOutputMemory(instr_node);
+      }
       CheckGC(instr_node);
       if (FLAGS_log_memory_stats) {
         memory::LogDeviceMemoryStats(place_, instr_node.OpBase()->Type());
@@ -1195,6 +1252,13 @@ void ProgramInterpreter::RunInstruction(const Instruction& instr_node) {
     exception_holder_.Catch(std::make_exception_ptr(ex));
   } catch (platform::EOFException&) {
     exception_holder_.Catch(std::current_exception());
+  } catch (memory::allocation::BadAlloc& ex) {
+    LOG(WARNING) << op->Type() << " raises an out of memory exception, "
+                 << ex.what();
+    if (memory::allocation::MemoryAttribution::IsEnabled()) {
+      memory::allocation::MemoryAttribution::Instance().ReportOnError();
+    }
+    exception_holder_.Catch(std::current_exception());
   } catch (std::exception& ex) {
     LOG(WARNING) << op->Type() << " raises an exception "
                  << platform::demangle(typeid(ex).name()) << ", " << ex.what();
@@ -1205,6 +1269,20 @@ void ProgramInterpreter::RunInstruction(const Instruction& instr_node) {
   }
 }
 
+void ProgramInterpreter::TagOutputMemory(const Instruction& instr_node) {
+  auto& attribution = memory::allocation::MemoryAttribution::Instance();
+  for (auto& item : instr_node.Outputs()) {
+    for (int var_id : item.second) {
+      auto* var = var_scope_.VarRef(var_id);
+      if (var == nullptr || !var->IsType<phi::DenseTensor>()) continue;
+      const auto& holder = var->Get<phi::DenseTensor>().Holder();
+      if (holder) {
+        attribution.TagVariable(holder->ptr(), var_scope_.GetNameById(var_id));
+      }
+    }
+  }
+}
+
 std::string ProgramInterpreter::GetDepsString() const {
   std::stringstream ss;
   auto downstream_map = dependency_builder_.OpDownstreamMap();
@@ -1365,8 +1443,15 @@ void ProgramInterpreter::RunInstructionAsync(size_t instr_id) {
     }
 
     VLOG(4) << "unfinished_op_number_: " << unfinished_op_number_;
-    if (UNLIKELY(unfinished_op_number_.fetch_sub(
-                     1, std::memory_order_relaxed) == 1)) {
+    size_t unfinished_op_number =
+        unfinished_op_number_.fetch_sub(1, std::memory_order_relaxed);
+    if (FLAGS_enable_runtime_metrics) {
+      static auto* gauge = phi::metrics::MetricsRegistry::Instance().GetGauge(
+          "paddle_executor_unfinished_ops",
+          "The number of the ops waiting to run in the executor.");
+      gauge->Set(unfinished_op_number - 1);
+    }
+    if (UNLIKELY(unfinished_op_number == 1)) {
       if (completion_notifier_ != nullptr) {
         completion_notifier_->NotifyEvent();
       }
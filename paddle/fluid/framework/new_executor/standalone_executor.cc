@@ -31,6 +31,8 @@
 PHI_DECLARE_bool(enable_pir_in_executor);
 PHI_DECLARE_bool(enable_pir_api);
 PHI_DECLARE_bool(pir_apply_inplace_pass);
+PHI_DECLARE_int32(new_executor_async_fetch_depth);
+PHI_DECLARE_int32(new_executor_run_ahead_depth);
 
 namespace paddle {
 namespace framework {
@@ -187,6 +189,34 @@ paddle::framework::FetchList StandaloneExecutor::Run(
     SplitFeedTensors(feed_names, plan_.MicroBatchNum(), scope_, &splited_feeds);
   }
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  RunAheadFeeder* run_ahead_feeder = nullptr;
+  const int64_t run_ahead_depth = FLAGS_new_executor_run_ahead_depth;
+  if (FLAGS_enable_pir_in_executor && run_ahead_depth > 0 &&
+      platform::is_gpu_place(place_)) {
+    if (!run_ahead_feeder_ || run_ahead_feeder_->Depth() != run_ahead_depth) {
+      run_ahead_feeder_ = std::make_unique<RunAheadFeeder>(
+          phi::GPUPlace(place_.GetDeviceId()), run_ahead_depth);
+    }
+    run_ahead_feeder = run_ahead_feeder_.get();
+    run_ahead_feeder->BeginRun(&splited_feeds);
+  }
+
+  // the fetch results of the run depth before are returned without waiting
+  // for the device
+  AsyncFetcher* async_fetcher = nullptr;
+  const int64_t fetch_depth = FLAGS_new_executor_async_fetch_depth;
+  if (FLAGS_enable_pir_in_executor && fetch_depth > 0 &&
+      platform::is_gpu_place(place_)) {
+    if (!async_fetcher_ || async_fetcher_->Depth() != fetch_depth) {
+      async_fetcher_ = std::make_unique<AsyncFetcher>(
+          phi::GPUPlace(place_.GetDeviceId()), fetch_depth);
+    }
+    async_fetcher = async_fetcher_.get();
+    async_fetcher->BeginStep(plan_.MicroBatchNum());
+  }
+#endif
+
   fetch_list_.resize(plan_.MicroBatchNum());
   for (size_t job_idx = 0; job_idx < jobs.size(); ++job_idx) {
     const auto& job = jobs[job_idx];
@@ -213,6 +243,15 @@ paddle::framework::FetchList StandaloneExecutor::Run(
                                       /*enable_job_schedule_profiler = */
                                       enable_job_schedule_profiler);
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+      if (async_fetcher) {
+        async_fetcher->Fetch(job->FetchVarNames(),
+                             fetch_var_names_,
+                             job->MicroBatchId(),
+                             micro_batch_scopes_[job->MicroBatchId()]);
+        continue;
+      }
+#endif
       FetchTensors(job->FetchVarNames(),
                    fetch_var_names_,
                    job->MicroBatchId(),
@@ -234,6 +273,12 @@ paddle::framework::FetchList StandaloneExecutor::Run(
     }
   }
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (run_ahead_feeder) {
+    run_ahead_feeder->EndRun();
+  }
+#endif
+
   // record each job's run time
 #if defined(PADDLE_WITH_CUDA)
   if (enable_job_schedule_profiler) {
@@ -259,6 +304,11 @@ paddle::framework::FetchList StandaloneExecutor::Run(
 #endif
 
   // return Fetch Tensors
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (async_fetcher) {
+    return async_fetcher->EndStep();
+  }
+#endif
   if (FLAGS_enable_pir_in_executor) {
     framework::FetchList fetch_res;
     MergeFetchTensors(fetch_list_, plan_.MicroBatchNum(), &fetch_res);
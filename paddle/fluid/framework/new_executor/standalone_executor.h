@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "paddle/fluid/framework/lod_tensor.h"
+#include "paddle/fluid/framework/new_executor/feed_fetch_utils.h"
 #include "paddle/fluid/framework/new_executor/interpreter/plan.h"
 #include "paddle/fluid/framework/new_executor/interpretercore.h"
 #include "paddle/fluid/framework/new_executor/new_executor_defs.h"
@@ -57,6 +58,10 @@ class StandaloneExecutor {
 
   std::vector<std::string> fetch_var_names_;
   FetchUnmergedList fetch_list_;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  std::unique_ptr<AsyncFetcher> async_fetcher_;
+  std::unique_ptr<RunAheadFeeder> run_ahead_feeder_;
+#endif
 
   std::vector<std::unordered_map<std::string, std::shared_ptr<EventInter>>>
       vec_force_events_to_wait_;
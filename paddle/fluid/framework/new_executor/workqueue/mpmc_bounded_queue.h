@@ -0,0 +1,138 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// MpmcBoundedQueue is a fixed-size, lock-free multi-producer multi-consumer
+// FIFO queue, based on the bounded MPMC queue of Dmitry Vyukov
+// (https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue).
+//
+// Each cell carries a sequence number. A producer claims the cell at
+// enqueue_pos_ by a CAS on enqueue_pos_ when the sequence number equals to the
+// position, and publishes the element by storing position + 1 into the
+// sequence number. A consumer claims the cell at dequeue_pos_ when the
+// sequence number equals to position + 1, and releases the cell for the next
+// round by storing position + kSize.
+//
+// It is used by ThreadPoolTempl to receive the tasks submitted from threads
+// outside the pool, which would contend on the SpinLock of RunQueue::PushBack
+// otherwise.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace paddle {
+namespace framework {
+
+template <typename Work, unsigned kSize>
+class MpmcBoundedQueue {
+ public:
+  MpmcBoundedQueue() : enqueue_pos_(0), dequeue_pos_(0) {
+    static_assert((kSize & (kSize - 1)) == 0,
+                  "need to be a power of two for fast masking");
+    static_assert(kSize >= 2, "need to be at least 2");
+    for (size_t i = 0; i < kSize; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpmcBoundedQueue(const MpmcBoundedQueue&) = delete;
+  void operator=(const MpmcBoundedQueue&) = delete;
+
+  // Push inserts w at the tail of the queue.
+  // If queue is full returns w, otherwise returns default-constructed Work.
+  Work Push(Work w) {
+    Cell* cell = nullptr;
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      cell = &cells_[pos & kMask];
+      size_t seq = cell->sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // full
+        return w;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->w = std::move(w);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return Work();
+  }
+
+  // Pop removes and returns the head of the queue.
+  // If the queue was empty returns default-constructed Work.
+  Work Pop() {
+    Cell* cell = nullptr;
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      cell = &cells_[pos & kMask];
+      size_t seq = cell->sequence.load(std::memory_order_acquire);
+      intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // empty, or the producer of this cell has not finished yet
+        return Work();
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    Work w = std::move(cell->w);
+    cell->sequence.store(pos + kMask + 1, std::memory_order_release);
+    return w;
+  }
+
+  // Empty tests whether container is empty. A push in progress is counted as
+  // an element, so it never claims a non-empty queue as empty.
+  // Can be called by any thread at any time.
+  bool Empty() const {
+    size_t dequeue_pos = dequeue_pos_.load(std::memory_order_acquire);
+    size_t enqueue_pos = enqueue_pos_.load(std::memory_order_acquire);
+    return enqueue_pos == dequeue_pos;
+  }
+
+  // Delete all the elements from the queue.
+  void Flush() {
+    while (!Empty()) {
+      Pop();
+    }
+  }
+
+ private:
+  static const size_t kMask = kSize - 1;
+
+  struct alignas(64) Cell {
+    std::atomic<size_t> sequence;
+    Work w;
+  };
+
+  alignas(64) std::atomic<size_t> enqueue_pos_;
+  alignas(64) std::atomic<size_t> dequeue_pos_;
+  Cell cells_[kSize];
+};
+
+}  // namespace framework
+}  // namespace paddle
@@ -11,14 +11,17 @@
 
 #include <atomic>
 #include <cstdlib>
+#include <memory>
 #include <vector>
 
 #include "glog/logging.h"
 #include "paddle/fluid/framework/new_executor/workqueue/event_count.h"
+#include "paddle/fluid/framework/new_executor/workqueue/mpmc_bounded_queue.h"
 #include "paddle/fluid/framework/new_executor/workqueue/run_queue.h"
 #include "paddle/fluid/framework/new_executor/workqueue/thread_environment.h"
 #include "paddle/fluid/platform/os_info.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
+#include "paddle/phi/backends/cpu/cpu_info.h"
 
 namespace paddle {
 namespace framework {
@@ -28,15 +31,20 @@ class ThreadPoolTempl {
  public:
   typedef typename Environment::Task Task;
   typedef RunQueue<Task, 1024> Queue;
+  typedef MpmcBoundedQueue<Task, 1024> SubmissionQueue;
 
   ThreadPoolTempl(const std::string& name,
                   int num_threads,
                   bool allow_spinning,
                   bool always_spinning,
+                  bool lock_free_submission = false,
+                  int numa_node = -1,
                   Environment env = Environment())
       : env_(env),
         allow_spinning_(allow_spinning),
         always_spinning_(always_spinning),
+        submission_queue_(lock_free_submission ? new SubmissionQueue()
+                                               : nullptr),
         global_steal_partition_(EncodePartition(0, num_threads)),
         blocked_(0),
         done_(false),
@@ -44,7 +52,8 @@ class ThreadPoolTempl {
         ec_(num_threads),
         num_threads_(num_threads),
         thread_data_(num_threads),
-        name_(name) {
+        name_(name),
+        numa_node_(numa_node) {
     // Calculate coprimes of all numbers [1, num_threads].
     // Coprimes are used for random walks over all threads in Steal
     // and NonEmptyQueueIndex. Iteration is based on the fact that if we take
@@ -79,6 +88,9 @@ class ThreadPoolTempl {
       for (size_t i = 0; i < thread_data_.size(); i++) {
         thread_data_[i].queue.Flush();
       }
+      if (submission_queue_) {
+        submission_queue_->Flush();
+      }
     }
     // Join threads explicitly (by destroying) to avoid destruction order within
     // this class.
@@ -113,15 +125,21 @@ class ThreadPoolTempl {
       Queue& q = thread_data_[pt->thread_id].queue;
       t = q.PushFront(std::move(t));
     } else {
-      // A free-standing thread (or worker of another pool), push onto a random
-      // queue.
-      assert(start < limit);
-      assert(limit <= num_threads_);
-      int num_queues = limit - start;
-      int rnd = Rand(&pt->rand) % num_queues;
-      assert(start + rnd < limit);
-      Queue& q = thread_data_[start + rnd].queue;
-      t = q.PushBack(std::move(t));
+      // A free-standing thread (or worker of another pool), push onto the
+      // lock-free submission queue shared by all the workers if enabled.
+      if (submission_queue_ && start == 0 && limit == num_threads_) {
+        t = submission_queue_->Push(std::move(t));
+      }
+      // Otherwise (or the submission queue is full) push onto a random queue.
+      if (t.f) {
+        assert(start < limit);
+        assert(limit <= num_threads_);
+        int num_queues = limit - start;
+        int rnd = Rand(&pt->rand) % num_queues;
+        assert(start + rnd < limit);
+        Queue& q = thread_data_[start + rnd].queue;
+        t = q.PushBack(std::move(t));
+      }
     }
 
     // Note: below we touch this after making w available to worker threads.
@@ -156,6 +174,19 @@ class ThreadPoolTempl {
 
   size_t NumThreads() const { return num_threads_; }
 
+  // Number of tasks executed by the worker thread_id, including the stolen
+  // ones.
+  uint64_t NumExecutedTasks(int thread_id) const {
+    return thread_data_[thread_id].num_executed_tasks.load(
+        std::memory_order_relaxed);
+  }
+
+  // Number of tasks the worker thread_id popped from other workers' queues.
+  uint64_t NumStolenTasks(int thread_id) const {
+    return thread_data_[thread_id].num_stolen_tasks.load(
+        std::memory_order_relaxed);
+  }
+
   int CurrentThreadId() const {
     const PerThread* pt = const_cast<ThreadPoolTempl*>(this)->GetPerThread();
     if (pt->pool == this) {
@@ -226,15 +257,26 @@ class ThreadPoolTempl {
   };
 
   struct ThreadData {
-    constexpr ThreadData() : thread(), steal_partition(0), queue() {}
+    constexpr ThreadData()
+        : thread(),
+          steal_partition(0),
+          queue(),
+          num_executed_tasks(0),
+          num_stolen_tasks(0) {}
     std::unique_ptr<Thread> thread;
     std::atomic<unsigned> steal_partition;
     Queue queue;
+    // Scheduling counters, only written by the owner thread.
+    std::atomic<uint64_t> num_executed_tasks;
+    std::atomic<uint64_t> num_stolen_tasks;
   };
 
   Environment env_;
   const bool allow_spinning_;
   const bool always_spinning_;
+  // Receive the tasks from outside the pool without locking, nullptr if the
+  // lock-free submission is disabled.
+  std::unique_ptr<SubmissionQueue> submission_queue_;
   std::vector<std::vector<unsigned>> all_coprimes_;
   unsigned global_steal_partition_;
   std::atomic<unsigned> blocked_;
@@ -244,12 +286,16 @@ class ThreadPoolTempl {
   const int num_threads_;
   std::vector<ThreadData> thread_data_;
   std::string name_;
+  int numa_node_;
 
   // Main worker thread loop.
   void WorkerLoop(int thread_id) {
     std::string thr_name = name_ + "_thread_" + std::to_string(thread_id);
     VLOG(1) << thr_name << " started ";
     platform::SetCurrentThreadName(thr_name);
+    if (numa_node_ >= 0) {
+      phi::backends::cpu::BindCurrentThreadToNumaNode(numa_node_);
+    }
     PerThread* pt = GetPerThread();
     pt->pool = this;
     pt->rand = GlobalThreadIdHash();
@@ -271,9 +317,15 @@ class ThreadPoolTempl {
       // pools tend to be used for.
       while (!cancelled_) {
         Task t = q.PopFront();
+        if (!t.f) {
+          t = PopSubmission();
+        }
         for (int i = 0; i < spin_count && !t.f; i++) {
           if (!cancelled_.load(std::memory_order_relaxed)) {
             t = q.PopFront();
+            if (!t.f) {
+              t = PopSubmission();
+            }
           }
         }
         if (!t.f) {
@@ -282,13 +334,19 @@ class ThreadPoolTempl {
           }
         }
         if (t.f) {
+          CountTask(thread_id, false);
           env_.ExecuteTask(t);
         }
       }
     } else {
       while (!cancelled_) {
         Task t = q.PopFront();
+        bool stolen = false;
+        if (!t.f) {
+          t = PopSubmission();
+        }
         if (!t.f) {
+          stolen = true;
           t = LocalSteal();
           if (!t.f) {
             t = GlobalSteal();
@@ -311,12 +369,26 @@ class ThreadPoolTempl {
           }
         }
         if (t.f) {
+          CountTask(thread_id, stolen);
           env_.ExecuteTask(t);
         }
       }
     }
   }
 
+  inline void CountTask(int thread_id, bool stolen) {
+    ThreadData& td = thread_data_[thread_id];
+    // Only the owner thread writes the counters, so load + store is enough.
+    td.num_executed_tasks.store(
+        td.num_executed_tasks.load(std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed);
+    if (stolen) {
+      td.num_stolen_tasks.store(
+          td.num_stolen_tasks.load(std::memory_order_relaxed) + 1,
+          std::memory_order_relaxed);
+    }
+  }
+
   // Steal tries to steal work from other worker threads in the range [start,
   // limit) in best-effort manner.
   Task Steal(unsigned start, unsigned limit) {
@@ -359,8 +431,26 @@ class ThreadPoolTempl {
     return Steal(start, limit);
   }
 
-  // Steals work from any other thread in the pool.
-  Task GlobalSteal() { return Steal(0, num_threads_); }
+  // Steals work from any other thread in the pool, the submission queue is
+  // checked first since it is shared by all the workers.
+  Task GlobalSteal() {
+    Task t = PopSubmission();
+    if (t.f) {
+      return t;
+    }
+    return Steal(0, num_threads_);
+  }
+
+  inline Task PopSubmission() {
+    if (submission_queue_ == nullptr) {
+      return Task();
+    }
+    return submission_queue_->Pop();
+  }
+
+  inline bool SubmissionQueueEmpty() const {
+    return submission_queue_ == nullptr || submission_queue_->Empty();
+  }
 
   // WaitForWork blocks until new work is available (returns true), or if it is
   // time to exit (returns false). Can optionally return a task to execute in t
@@ -380,6 +470,12 @@ class ThreadPoolTempl {
     blocked_++;
 
     // Now do a reliable emptiness check.
+    if (!SubmissionQueueEmpty()) {
+      ec_.CancelWait();
+      *t = PopSubmission();
+      blocked_--;
+      return true;
+    }
     int victim = NonEmptyQueueIndex();
     if (victim != -1) {
       ec_.CancelWait();
@@ -398,7 +494,7 @@ class ThreadPoolTempl {
       // right after incrementing blocked_ above. Now a free-standing thread
       // submits work and calls destructor (which sets done_). If we don't
       // re-check queues, we will exit leaving the work unexecuted.
-      if (NonEmptyQueueIndex() != -1) {
+      if (NonEmptyQueueIndex() != -1 || !SubmissionQueueEmpty()) {
         // Note: we must not pop from queues before we decrement blocked_,
         // otherwise the following scenario is possible. Consider that instead
         // of checking for emptiness we popped the only element from queues.
@@ -35,6 +35,16 @@ namespace {
 
 using TaskTracker = TaskTracker<EventsWaiter::EventNotifier>;
 
+std::vector<WorkerStatistics> CollectWorkerStatistics(
+    const NonblockingThreadPool& pool) {
+  std::vector<WorkerStatistics> stats(pool.NumThreads());
+  for (size_t i = 0; i < stats.size(); ++i) {
+    stats[i].executed_tasks = pool.NumExecutedTasks(static_cast<int>(i));
+    stats[i].stolen_tasks = pool.NumStolenTasks(static_cast<int>(i));
+  }
+  return stats;
+}
+
 class WorkQueueImpl : public WorkQueue {
  public:
   explicit WorkQueueImpl(const WorkQueueOptions& options) : WorkQueue(options) {
@@ -50,7 +60,9 @@ class WorkQueueImpl : public WorkQueue {
     queue_ = new NonblockingThreadPool(options_.name,
                                        static_cast<int>(options_.num_threads),
                                        options_.allow_spinning,
-                                       options_.always_spinning);
+                                       options_.always_spinning,
+                                       options_.lock_free_submission,
+                                       options_.numa_node);
   }
 
   ~WorkQueueImpl() override {
@@ -82,6 +94,10 @@ class WorkQueueImpl : public WorkQueue {
 
   size_t NumThreads() const override { return queue_->NumThreads(); }
 
+  std::vector<WorkerStatistics> GetWorkerStatistics() const override {
+    return CollectWorkerStatistics(*queue_);
+  }
+
  private:
   NonblockingThreadPool* queue_{nullptr};
   TaskTracker* tracker_{nullptr};
@@ -102,6 +118,9 @@ class WorkQueueGroupImpl : public WorkQueueGroup {
 
   size_t QueueGroupNumThreads() const override;
 
+  std::vector<WorkerStatistics> QueueWorkerStatistics(
+      size_t queue_idx) const override;
+
   void Cancel() override;
 
  private:
@@ -143,7 +162,9 @@ WorkQueueGroupImpl::WorkQueueGroupImpl(
         NonblockingThreadPool(options.name,
                               static_cast<int>(options.num_threads),
                               options.allow_spinning,
-                              options.always_spinning);
+                              options.always_spinning,
+                              options.lock_free_submission,
+                              options.numa_node);
   }
 }
 
@@ -195,6 +216,15 @@ size_t WorkQueueGroupImpl::QueueGroupNumThreads() const {
   return total_num;
 }
 
+std::vector<WorkerStatistics> WorkQueueGroupImpl::QueueWorkerStatistics(
+    size_t queue_idx) const {
+  assert(queue_idx < queues_.size());
+  if (!queues_.at(queue_idx)) {
+    return {};
+  }
+  return CollectWorkerStatistics(*queues_.at(queue_idx));
+}
+
 void WorkQueueGroupImpl::Cancel() {
   for (auto queue : queues_) {
     if (queue) {
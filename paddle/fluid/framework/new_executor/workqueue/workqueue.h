@@ -15,6 +15,7 @@
 #pragma once
 
 #include <functional>
+#include <cstdint>
 #include <future>
 #include <memory>
 #include <string>
@@ -54,6 +55,14 @@ class FakeCopyable {
 
 class EventsWaiter;
 
+// Scheduling counters of a single worker thread. They are sampled with relaxed
+// atomics, so they are only meant for profiling and tuning.
+struct WorkerStatistics {
+  uint64_t executed_tasks{0};
+  // Tasks the worker popped from other workers' queues.
+  uint64_t stolen_tasks{0};
+};
+
 struct WorkQueueOptions {
   WorkQueueOptions(const std::string& name,
                    size_t num_threads,
@@ -102,6 +111,12 @@ struct WorkQueueOptions {
   // false and set events_waiter.
   bool detached{true};
   EventsWaiter* events_waiter{nullptr};  // not owned
+  // Tasks added from threads outside the queue go to a lock-free MPMC queue
+  // shared by all the workers instead of the back of a random worker queue,
+  // which is protected by a lock. Better for many producer threads.
+  bool lock_free_submission{false};
+  // The worker threads are bound to the numa node if it is not negative.
+  int numa_node{-1};
 };
 
 class WorkQueue {
@@ -136,6 +151,8 @@ class WorkQueue {
 
   virtual size_t NumThreads() const = 0;
 
+  virtual std::vector<WorkerStatistics> GetWorkerStatistics() const = 0;
+
   virtual void Cancel() = 0;
 
  protected:
@@ -178,6 +195,9 @@ class WorkQueueGroup {
 
   virtual size_t QueueGroupNumThreads() const = 0;
 
+  virtual std::vector<WorkerStatistics> QueueWorkerStatistics(
+      size_t queue_idx) const = 0;
+
   virtual void Cancel() = 0;
 
  protected:
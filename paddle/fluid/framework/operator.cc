@@ -2035,7 +2035,6 @@ void OperatorWithKernel::RunImpl(const Scope& scope,
                                        platform::EventRole::kInnerOp);
     if (run_phi_kernel_ && phi_kernel_->GetKernelRegisteredType() ==
                                phi::KernelRegisteredType::FUNCTION) {
-      phi::KernelContext phi_kernel_context;
       if (enable_cache_runtime_context_ && !need_prepare_phi_data_ &&
           !need_prepare_data_) {
         // TODO(inference): Now we only suppor dense_tensor cache, we may be
@@ -2066,11 +2065,23 @@ void OperatorWithKernel::RunImpl(const Scope& scope,
         BuildPhiKernelContext(*runtime_ctx, dev_ctx, impl_->getKernelContext());
         (*phi_kernel_)(impl_->getKernelContext());
       } else {
-        phi::KernelContext phi_kernel_context;
+        // Reuse the kernel context of the op to avoid the allocations of its
+        // vectors, unless the op is run by another thread at the same time.
+        std::unique_lock<std::mutex> lock(phi_kernel_context_mutex_,
+                                          std::try_to_lock);
+        phi::KernelContext local_kernel_context;
+        phi::KernelContext* phi_kernel_context = &local_kernel_context;
+        if (lock.owns_lock()) {
+          if (phi_kernel_context_ == nullptr) {
+            phi_kernel_context_ = std::make_unique<phi::KernelContext>();
+          }
+          phi_kernel_context_->Reset();
+          phi_kernel_context = phi_kernel_context_.get();
+        }
         // Do data transform before building KernelContext
         // TODO(zhiqiu): support TransferInplaceVarsBack
-        BuildPhiKernelContext(*runtime_ctx, dev_ctx, &phi_kernel_context);
-        (*phi_kernel_)(&phi_kernel_context);
+        BuildPhiKernelContext(*runtime_ctx, dev_ctx, phi_kernel_context);
+        (*phi_kernel_)(phi_kernel_context);
       }
     } else if (run_phi_kernel_ && phi_kernel_->GetKernelRegisteredType() ==
                                       phi::KernelRegisteredType::STRUCTURE) {
@@ -3212,7 +3223,7 @@ void OperatorWithKernel::BuildPhiKernelContext(
 
       continue;
     }
-    auto ins_vector = it->second;
+    const auto& ins_vector = it->second;
     size_t end_idx = start_idx + ins_vector.size();
     for (auto* var : ins_vector) {
       const phi::TensorBase* tensor_in = nullptr;
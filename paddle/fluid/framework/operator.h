@@ -932,6 +932,10 @@ class OperatorWithKernel : public OperatorBase {
   mutable std::unique_ptr<phi::KernelSignature> kernel_signature_;
   mutable std::unique_ptr<phi::Kernel> phi_kernel_;
   mutable std::unique_ptr<phi::ArgumentMappingFn> arg_map_fn_;
+  // The kernel context rebuilt in place by the runs without the cache of the
+  // runtime context, it is only used by one run at a time.
+  mutable std::unique_ptr<phi::KernelContext> phi_kernel_context_;
+  mutable std::mutex phi_kernel_context_mutex_;
 
  private:
   struct CacheImpl;
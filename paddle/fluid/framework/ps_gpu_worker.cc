@@ -14,6 +14,7 @@ limitations under the License. */
 
 #include "paddle/fluid/framework/device_worker.h"
 #include "paddle/fluid/framework/device_worker_factory.h"
+#include "paddle/fluid/framework/fleet/metrics.h"
 #include "paddle/fluid/operators/isfinite_op.h"
 #include "paddle/fluid/platform/cpu_helper.h"
 #include "paddle/fluid/platform/lodtensor_printer.h"
@@ -34,6 +35,21 @@ limitations under the License. */
 namespace paddle {
 namespace framework {
 
+// Adds the batch to the metrics of the phase, the tensors stay on the gpu of
+// the worker and are accumulated on its stream.
+static void AddGpuAucMonitor(const Scope* scope,
+                             const platform::Place& place) {
+  auto metric_ptr = Metric::GetInstance();
+  auto& metric_list = metric_ptr->GetMetricList();
+  for (auto& item : metric_list) {
+    auto* metric_msg = item.second;
+    if (metric_ptr->Phase() != metric_msg->MetricPhase()) {
+      continue;
+    }
+    metric_msg->add_data(scope, place);
+  }
+}
+
 std::atomic<int> PSGPUWorker::shape_check_count_(16);
 std::atomic<bool> PSGPUWorker::shape_check_flag_(true);
 
@@ -410,6 +426,10 @@ void PSGPUWorker::TrainFiles() {
       }
     }
 
+    if (Metric::GetInstance() != nullptr) {
+      AddGpuAucMonitor(thread_scope, place_);
+    }
+
     if (need_dump_field_) {
       DumpField(*thread_scope, dump_mode_, dump_interval_);
     }
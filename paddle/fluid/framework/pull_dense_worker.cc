@@ -14,6 +14,10 @@ limitations under the License. */
 #include <ctime>
 
 #include "paddle/fluid/framework/device_worker.h"
+#include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_bool(pull_dense_double_buffer);
 
 namespace phi {
 class DenseTensor;
@@ -167,9 +171,128 @@ void PullDenseWorker::Stop() {
     running_ = false;
     t_.join();
   }
+  if (double_buffer_) {
+    // The params of the root scope are saved by the trainer, so the newest
+    // buffer is copied back to them.
+    Scope* front = dense_buffers_[dense_version_.load() % 2].get();
+    for (auto& item : dense_value_names_) {
+      for (auto& name : item.second) {
+        auto* root_tensor =
+            root_scope_->FindVar(name)->GetMutable<phi::DenseTensor>();
+        TensorCopySync(front->FindVar(name)->Get<phi::DenseTensor>(),
+                       root_tensor->place(),
+                       root_tensor);
+      }
+    }
+  }
+}
+
+void PullDenseWorker::InitDenseBuffers() {
+  for (auto& buffer : dense_buffers_) {
+    buffer.reset(new Scope());
+    for (auto& item : dense_value_names_) {
+      for (auto& name : item.second) {
+        const auto& root_tensor =
+            root_scope_->FindVar(name)->Get<phi::DenseTensor>();
+        auto* tensor = buffer->Var(name)->GetMutable<phi::DenseTensor>();
+        TensorCopySync(root_tensor, platform::CPUPlace(), tensor);
+      }
+    }
+  }
+  dense_version_.store(0);
+  thread_dense_versions_.reset(new std::atomic<uint64_t>[thread_num_]);
+  for (int i = 0; i < thread_num_; ++i) {
+    thread_dense_versions_[i].store(0);
+  }
+}
+
+bool PullDenseWorker::IsBackBufferReleased(uint64_t version) const {
+  for (int i = 0; i < thread_num_; ++i) {
+    uint64_t thread_version = thread_dense_versions_[i].load();
+    if (thread_version != 0 && thread_version < version) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void PullDenseWorker::PullDenseToBuffer(bool force_update) {
+  const uint64_t version = dense_version_.load();
+  if (!IsBackBufferReleased(version)) {
+    // Retried by the next round, the threads leave the buffer at their
+    // next batches.
+    return;
+  }
+  Scope* front = dense_buffers_[version % 2].get();
+  Scope* back = dense_buffers_[(version + 1) % 2].get();
+  std::vector<uint64_t> stale_tables;
+  pull_dense_status_.resize(0);
+  for (int i = 0; i < dwp_param_.program_config(0).pull_dense_table_id_size();
+       ++i) {
+    uint64_t tid = static_cast<uint64_t>(
+        dwp_param_.program_config(0).pull_dense_table_id(i));
+    if (force_update || CheckUpdateParam(tid)) {
+      fleet_ptr_->PullDenseVarsAsync(
+          *back, tid, dense_value_names_[tid], &pull_dense_status_, true);
+      ResetThreadVersion(tid);
+    } else {
+      stale_tables.push_back(tid);
+    }
+  }
+  if (pull_dense_status_.empty()) {
+    return;
+  }
+  Wait(&pull_dense_status_);
+  // The back buffer holds the version before the front one, the tables not
+  // pulled in this round are brought up to the front.
+  for (auto tid : stale_tables) {
+    for (auto& name : dense_value_names_[tid]) {
+      TensorCopySync(front->FindVar(name)->Get<phi::DenseTensor>(),
+                     platform::CPUPlace(),
+                     back->FindVar(name)->GetMutable<phi::DenseTensor>());
+    }
+  }
+  dense_version_.store(version + 1);
+}
+
+void PullDenseWorker::AcquireDense(Scope* thread_scope, int thread_id) {
+  if (!double_buffer_) {
+    return;
+  }
+  PADDLE_ENFORCE_LT(thread_id,
+                    thread_num_,
+                    platform::errors::OutOfRange(
+                        "The thread id %d should be less than the thread "
+                        "num %d of the pull dense worker.",
+                        thread_id,
+                        thread_num_));
+  auto& thread_version = thread_dense_versions_[thread_id];
+  uint64_t version = dense_version_.load();
+  if (version == thread_version.load(std::memory_order_relaxed)) {
+    return;
+  }
+  // The version is recorded before it is read again, so the pull thread
+  // either sees the record or has published a newer version seen here.
+  while (true) {
+    thread_version.store(version);
+    uint64_t newest = dense_version_.load();
+    if (newest == version) break;
+    version = newest;
+  }
+  Scope* front = dense_buffers_[version % 2].get();
+  for (auto& item : dense_value_names_) {
+    for (auto& name : item.second) {
+      thread_scope->Var(name)->GetMutable<phi::DenseTensor>()->ShareDataWith(
+          front->FindVar(name)->Get<phi::DenseTensor>());
+    }
+  }
 }
 
 void PullDenseWorker::PullDense(bool force_update) {
+  if (double_buffer_) {
+    PullDenseToBuffer(force_update);
+    return;
+  }
   pull_dense_status_.resize(0);
   for (int i = 0; i < dwp_param_.program_config(0).pull_dense_table_id_size();
        ++i) {
@@ -207,6 +330,11 @@ void PullDenseWorker::PullDense(bool force_update) {
 
 int PullDenseWorker::Start() {
   running_ = true;
+  // The gpu and xpu workers copy the pulled params to their own devices.
+  double_buffer_ = FLAGS_pull_dense_double_buffer && places_.empty();
+  if (double_buffer_) {
+    InitDenseBuffers();
+  }
   // before training, we can pull dense from pserver first.
   PullDense(true);
   t_ = std::thread(&PullDenseWorker::Run, this);
@@ -45,6 +45,7 @@ std::unique_ptr<Scope> Scope::NewTmpScope() const {
 }
 
 Variable* Scope::Var(const std::string& name) {
+  if (IsFrozen()) return VarInternal(name);
   // NOTE(xiongkun03): add {} here to unlock. With {}, scope
   // will do callback after unlock.
   Variable* ret = nullptr;
@@ -60,6 +61,7 @@ Variable* Scope::Var(std::string* name) {
   std::string new_name;
   {
     SCOPE_VARS_WRITER_LOCK
+    CheckNotFrozen();
     new_name = std::to_string(reinterpret_cast<uintptr_t>(this)) + "." +
                std::to_string(vars_.size());
     if (name != nullptr) {
@@ -71,6 +73,7 @@ Variable* Scope::Var(std::string* name) {
 }
 
 Variable* Scope::FindVar(const std::string& name) const {
+  if (IsFrozen()) return FindVarInternal(name);
   SCOPE_VARS_READER_LOCK
   return FindVarInternal(name);
 }
@@ -83,6 +86,7 @@ Variable* Scope::GetVar(const std::string& name) const {
 }
 
 Variable* Scope::FindLocalVar(const std::string& name) const {
+  if (IsFrozen()) return FindFrozenVar(name);
   SCOPE_VARS_READER_LOCK
   return FindVarLocally(name);
 }
@@ -168,6 +172,7 @@ void Scope::EraseVars(const std::vector<std::string>& var_names) {
   {
     std::set<std::string> var_set(var_names.begin(), var_names.end());
     SCOPE_VARS_WRITER_LOCK
+    CheckNotFrozen();
     for (auto it = vars_.begin(); it != vars_.end();) {
       if (var_set.find(it->first) != var_set.end()) {
         it = vars_.erase(it);
@@ -198,6 +203,7 @@ std::string Scope::Rename(const std::string& origin_name) const {
 Variable* Scope::VarInternal(const std::string& name) {
   auto* v = FindVarLocally(name);
   if (v != nullptr) return v;
+  CheckNotFrozen();
   v = new Variable();
   vars_.emplace(name, std::unique_ptr<Variable>(v));
   VLOG(3) << "Create variable " << name;
@@ -222,6 +228,7 @@ const Scope* Scope::FindScopeInternal(const std::string& name) const {
 
 void Scope::RenameInternal(const std::string& origin_name,
                            const std::string& new_name) const {
+  CheckNotFrozen();
   auto origin_it = vars_.find(origin_name);
   PADDLE_ENFORCE_NE(
       origin_it,
@@ -248,6 +255,7 @@ Variable* Scope::FindVarInternal(const std::string& name) const {
 }
 
 Variable* Scope::FindVarLocally(const std::string& name) const {
+  if (IsFrozen()) return FindFrozenVar(name);
   auto it = vars_.find(name);
   if (it != vars_.end()) {
     return it->second.get();
@@ -255,8 +263,45 @@ Variable* Scope::FindVarLocally(const std::string& name) const {
   return nullptr;
 }
 
+Variable* Scope::FindFrozenVar(const std::string& name) const {
+  const size_t mask = frozen_slots_.size() - 1;
+  const size_t hash = KeyHasher()(name);
+  for (size_t i = hash & mask;; i = (i + 1) & mask) {
+    const auto& slot = frozen_slots_[i];
+    if (slot.name == nullptr) return nullptr;
+    if (slot.hash == hash && *slot.name == name) return slot.var;
+  }
+}
+
+void Scope::CheckNotFrozen() const {
+  PADDLE_ENFORCE_EQ(IsFrozen(),
+                    false,
+                    platform::errors::PreconditionNotMet(
+                        "The variables of a frozen scope cannot be created, "
+                        "erased or renamed."));
+}
+
+void Scope::Freeze() {
+  SCOPE_VARS_WRITER_LOCK
+  if (IsFrozen()) return;
+  // At most half of the slots are used, so that a probe is short and always
+  // ends at an empty slot.
+  size_t capacity = 1;
+  while (capacity < vars_.size() * 2) capacity <<= 1;
+  frozen_slots_.assign(capacity, FrozenSlot{0, nullptr, nullptr});
+  const size_t mask = capacity - 1;
+  for (auto& kv : vars_) {
+    const size_t hash = KeyHasher()(kv.first);
+    size_t i = hash & mask;
+    while (frozen_slots_[i].name != nullptr) i = (i + 1) & mask;
+    frozen_slots_[i] = FrozenSlot{hash, &kv.first, kv.second.get()};
+  }
+  frozen_.store(true, std::memory_order_release);
+}
+
 void Scope::EraseVarsExcept(const std::unordered_set<Variable*>& vars) {
   SCOPE_VARS_WRITER_LOCK
+  CheckNotFrozen();
   for (auto iter = vars_.begin(); iter != vars_.end();) {
     if (vars.count(iter->second.get()) != 0) {
       ++iter;
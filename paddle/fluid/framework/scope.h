@@ -18,6 +18,7 @@ extern "C" {
 #include <xxhash.h>
 }
 
+#include <atomic>
 #include <list>
 #include <memory>
 #include <string>
@@ -129,6 +130,14 @@ class TEST_API Scope {
 
   void SetCanReused(bool can_reused) { can_reused_ = can_reused; }
 
+  /// Make the variable names of the scope immutable, the lookups of a frozen
+  /// scope take no lock and probe a flat hash table. The variables may still
+  /// be written, and the kid scopes may still shadow them by Var, but no
+  /// variable may be created in, erased from or renamed in the scope.
+  void Freeze();
+
+  bool IsFrozen() const { return frozen_.load(std::memory_order_acquire); }
+
  protected:
   struct KeyHasher {
     std::size_t operator()(const std::string& key) const {
@@ -162,6 +171,12 @@ class TEST_API Scope {
   // Called by FindVarInternal and Var.
   Variable* FindVarLocally(const std::string& name) const;
 
+  // Called by FindVarLocally on a frozen scope.
+  Variable* FindFrozenVar(const std::string& name) const;
+
+  // Called by the methods changing the variable names.
+  void CheckNotFrozen() const;
+
   // Scope in `kids_` are owned by this class.
   mutable std::list<Scope*> kids_;
   const Scope* parent_{nullptr};
@@ -174,6 +189,16 @@ class TEST_API Scope {
  private:
   mutable phi::RWLock kids_lock_;
   mutable phi::RWLock vars_lock_;
+
+  // The open addressing table of a frozen scope, a slot without name is
+  // empty.
+  struct FrozenSlot {
+    size_t hash;
+    const std::string* name;
+    Variable* var;
+  };
+  std::vector<FrozenSlot> frozen_slots_;
+  std::atomic<bool> frozen_{false};
 };
 
 // Generate some debug string about the inherience structure of scope, quite
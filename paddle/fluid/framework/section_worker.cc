@@ -14,6 +14,7 @@ limitations under the License. */
 
 #include "paddle/fluid/framework/device_worker.h"
 #include "paddle/fluid/framework/executor_gc_helper.h"
+#include "paddle/fluid/memory/allocation/lifetime_pool_allocator.h"
 #include "paddle/fluid/platform/device_context.h"
 
 namespace paddle {
@@ -97,6 +98,8 @@ void SectionWorker::RunForward(
         &unused_vars_) {
   std::vector<OperatorBase *> &forward_tmp =
       micro_id == 0 ? forward_and_lr_ops_ : forward_ops_;
+  memory::allocation::AllocationLifetimeGuard lifetime_guard(
+      memory::allocation::AllocationLifetime::kMicroBatch);
   for (auto &op : forward_tmp) {
     VLOG(3) << "Forward: running op " << op->Type() << " for micro-batch "
             << micro_id;
@@ -113,6 +116,8 @@ void SectionWorker::RunBackward(
     std::unique_ptr<GarbageCollector> &gc,
     std::unordered_map<const OperatorBase *, std::vector<std::string>>
         &unused_vars_) {
+  memory::allocation::AllocationLifetimeGuard lifetime_guard(
+      memory::allocation::AllocationLifetime::kMicroBatch);
   for (auto &op : backward_ops_) {
     VLOG(3) << "Backward: running op " << op->Type() << " for micro-batch "
             << micro_id;
@@ -128,6 +133,8 @@ void SectionWorker::RunUpdate(
     std::unique_ptr<GarbageCollector> &gc,
     std::unordered_map<const OperatorBase *, std::vector<std::string>>
         &unused_vars_) {
+  memory::allocation::AllocationLifetimeGuard lifetime_guard(
+      memory::allocation::AllocationLifetime::kStep);
   for (auto &op : optimizer_ops_) {
     VLOG(3) << "Update: running op " << op->Type();
     op->Run(*microbatch_scopes_[num_microbatches_ - 1], place_);
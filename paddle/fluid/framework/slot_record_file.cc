@@ -0,0 +1,375 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/slot_record_file.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <limits>
+
+namespace paddle {
+namespace framework {
+
+namespace {
+// m, ins id bytes, uint64 value num, float value num
+constexpr size_t kBlockHeaderSize =
+    2 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+template <typename T>
+T ReadAt(const char* data, size_t i) {
+  T value;
+  memcpy(&value, data + i * sizeof(T), sizeof(T));
+  return value;
+}
+
+template <typename T>
+void CopySlotValues(const char* offsets_data,
+                    const char* values_data,
+                    uint32_t slot_num,
+                    uint32_t i,
+                    std::vector<T>* values,
+                    std::vector<uint32_t>* offsets) {
+  offsets->resize(slot_num + 1);
+  memcpy(offsets->data(),
+         offsets_data + static_cast<size_t>(i) * slot_num * sizeof(uint32_t),
+         (slot_num + 1) * sizeof(uint32_t));
+  uint32_t begin = (*offsets)[0];
+  for (auto& offset : *offsets) {
+    offset -= begin;
+  }
+  values->resize(offsets->back());
+  if (!values->empty()) {
+    memcpy(values->data(),
+           values_data + static_cast<size_t>(begin) * sizeof(T),
+           values->size() * sizeof(T));
+  }
+}
+
+template <typename T>
+void AppendSlotValues(const std::vector<uint32_t>& rec_offsets,
+                      const T* rec_values,
+                      uint32_t slot_num,
+                      std::vector<uint32_t>* offsets,
+                      std::vector<T>* values) {
+  uint32_t base = static_cast<uint32_t>(values->size());
+  if (rec_offsets.empty()) {
+    offsets->insert(offsets->end(), slot_num, base);
+    return;
+  }
+  for (uint32_t j = 1; j <= slot_num; ++j) {
+    offsets->push_back(base + rec_offsets[j]);
+  }
+  values->insert(values->end(),
+                 rec_values + rec_offsets[0],
+                 rec_values + rec_offsets[slot_num]);
+}
+}  // namespace
+
+bool IsSlotRecordFile(const std::string& path) {
+  size_t suffix_len = strlen(kSlotRecordFileSuffix);
+  return path.size() >= suffix_len &&
+         path.compare(path.size() - suffix_len,
+                      suffix_len,
+                      kSlotRecordFileSuffix) == 0;
+}
+
+bool SlotRecordFileWriter::Open(const std::string& path,
+                                const std::vector<std::string>& slot_names,
+                                uint32_t uint64_slot_num,
+                                uint32_t float_slot_num,
+                                size_t block_size) {
+  Close();
+  fp_ = fopen(path.c_str(), "wb");
+  if (fp_ == nullptr) {
+    return false;
+  }
+  ok_ = true;
+  block_size_ = block_size > 0 ? block_size : 1;
+  uint64_slot_num_ = uint64_slot_num;
+  float_slot_num_ = float_slot_num;
+  uint32_t header[4] = {kSlotRecordFileMagic,
+                        uint64_slot_num,
+                        float_slot_num,
+                        static_cast<uint32_t>(slot_names.size())};
+  Write(header, sizeof(header));
+  for (auto& name : slot_names) {
+    uint32_t len = static_cast<uint32_t>(name.size());
+    Write(&len, sizeof(len));
+    Write(name.data(), len);
+  }
+  ins_id_offsets_.assign(1, 0);
+  uint64_offsets_.assign(1, 0);
+  float_offsets_.assign(1, 0);
+  return ok_;
+}
+
+bool SlotRecordFileWriter::Append(uint64_t search_id,
+                                  uint32_t rank,
+                                  uint32_t cmatch,
+                                  const std::string& ins_id,
+                                  const std::vector<uint32_t>& uint64_offsets,
+                                  const uint64_t* uint64_values,
+                                  const std::vector<uint32_t>& float_offsets,
+                                  const float* float_values) {
+  if (fp_ == nullptr || !ok_) {
+    return false;
+  }
+  if ((!uint64_offsets.empty() &&
+       uint64_offsets.size() != uint64_slot_num_ + 1) ||
+      (!float_offsets.empty() &&
+       float_offsets.size() != float_slot_num_ + 1)) {
+    ok_ = false;
+    return false;
+  }
+  // the offsets of a block are 32 bits
+  constexpr size_t kMaxNum = std::numeric_limits<uint32_t>::max();
+  size_t uint64_num = uint64_offsets.empty() ? 0 : uint64_offsets.back();
+  size_t float_num = float_offsets.empty() ? 0 : float_offsets.back();
+  if (!search_ids_.empty() &&
+      (uint64_values_.size() + uint64_num > kMaxNum ||
+       float_values_.size() + float_num > kMaxNum ||
+       ins_ids_.size() + ins_id.size() > kMaxNum)) {
+    WriteBlock();
+  }
+  search_ids_.push_back(search_id);
+  ranks_.push_back(rank);
+  cmatchs_.push_back(cmatch);
+  ins_ids_.append(ins_id);
+  ins_id_offsets_.push_back(static_cast<uint32_t>(ins_ids_.size()));
+  AppendSlotValues(uint64_offsets,
+                   uint64_values,
+                   uint64_slot_num_,
+                   &uint64_offsets_,
+                   &uint64_values_);
+  AppendSlotValues(float_offsets,
+                   float_values,
+                   float_slot_num_,
+                   &float_offsets_,
+                   &float_values_);
+  if (search_ids_.size() >= block_size_) {
+    WriteBlock();
+  }
+  return ok_;
+}
+
+bool SlotRecordFileWriter::Close() {
+  if (fp_ == nullptr) {
+    return ok_;
+  }
+  if (!search_ids_.empty()) {
+    WriteBlock();
+  }
+  if (fclose(fp_) != 0) {
+    ok_ = false;
+  }
+  fp_ = nullptr;
+  return ok_;
+}
+
+bool SlotRecordFileWriter::Write(const void* data, size_t size) {
+  if (ok_ && size > 0 && fwrite(data, 1, size, fp_) != size) {
+    ok_ = false;
+  }
+  return ok_;
+}
+
+bool SlotRecordFileWriter::WriteBlock() {
+  uint32_t header[2] = {static_cast<uint32_t>(search_ids_.size()),
+                        static_cast<uint32_t>(ins_ids_.size())};
+  uint64_t value_nums[2] = {uint64_values_.size(), float_values_.size()};
+  Write(header, sizeof(header));
+  Write(value_nums, sizeof(value_nums));
+  Write(search_ids_.data(), search_ids_.size() * sizeof(uint64_t));
+  Write(ranks_.data(), ranks_.size() * sizeof(uint32_t));
+  Write(cmatchs_.data(), cmatchs_.size() * sizeof(uint32_t));
+  Write(ins_id_offsets_.data(), ins_id_offsets_.size() * sizeof(uint32_t));
+  Write(ins_ids_.data(), ins_ids_.size());
+  Write(uint64_offsets_.data(), uint64_offsets_.size() * sizeof(uint32_t));
+  Write(uint64_values_.data(), uint64_values_.size() * sizeof(uint64_t));
+  Write(float_offsets_.data(), float_offsets_.size() * sizeof(uint32_t));
+  Write(float_values_.data(), float_values_.size() * sizeof(float));
+
+  search_ids_.clear();
+  ranks_.clear();
+  cmatchs_.clear();
+  ins_ids_.clear();
+  ins_id_offsets_.assign(1, 0);
+  uint64_offsets_.assign(1, 0);
+  uint64_values_.clear();
+  float_offsets_.assign(1, 0);
+  float_values_.clear();
+  return ok_;
+}
+
+uint64_t SlotRecordBlockView::search_id(uint32_t i) const {
+  return ReadAt<uint64_t>(search_ids, i);
+}
+
+uint32_t SlotRecordBlockView::rank(uint32_t i) const {
+  return ReadAt<uint32_t>(ranks, i);
+}
+
+uint32_t SlotRecordBlockView::cmatch(uint32_t i) const {
+  return ReadAt<uint32_t>(cmatchs, i);
+}
+
+void SlotRecordBlockView::ins_id(uint32_t i, std::string* out) const {
+  uint32_t begin = ReadAt<uint32_t>(ins_id_offsets, i);
+  uint32_t end = ReadAt<uint32_t>(ins_id_offsets, i + 1);
+  out->assign(ins_ids + begin, end - begin);
+}
+
+void SlotRecordBlockView::uint64_feasigns(
+    uint32_t i,
+    std::vector<uint64_t>* values,
+    std::vector<uint32_t>* offsets) const {
+  CopySlotValues(
+      uint64_offsets, uint64_values, uint64_slot_num, i, values, offsets);
+}
+
+void SlotRecordBlockView::float_feasigns(uint32_t i,
+                                         std::vector<float>* values,
+                                         std::vector<uint32_t>* offsets) const {
+  CopySlotValues(
+      float_offsets, float_values, float_slot_num, i, values, offsets);
+}
+
+bool SlotRecordFileReader::Open(const std::string& path) {
+  Close();
+#ifdef _WIN32
+  return false;
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    close(fd);
+    return false;
+  }
+  size_ = static_cast<size_t>(st.st_size);
+  void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    size_ = 0;
+    return false;
+  }
+  data_ = static_cast<const char*>(addr);
+  madvise(addr, size_, MADV_SEQUENTIAL);
+
+  constexpr size_t kHeaderSize = 4 * sizeof(uint32_t);
+  if (size_ < kHeaderSize ||
+      ReadAt<uint32_t>(data_, 0) != kSlotRecordFileMagic) {
+    Close();
+    return false;
+  }
+  uint64_slot_num_ = ReadAt<uint32_t>(data_, 1);
+  float_slot_num_ = ReadAt<uint32_t>(data_, 2);
+  uint32_t name_num = ReadAt<uint32_t>(data_, 3);
+  pos_ = kHeaderSize;
+  for (uint32_t i = 0; i < name_num; ++i) {
+    if (pos_ + sizeof(uint32_t) > size_) {
+      Close();
+      return false;
+    }
+    uint32_t len = ReadAt<uint32_t>(data_ + pos_, 0);
+    pos_ += sizeof(uint32_t);
+    if (pos_ + len > size_) {
+      Close();
+      return false;
+    }
+    slot_names_.emplace_back(data_ + pos_, len);
+    pos_ += len;
+  }
+  return true;
+#endif
+}
+
+void SlotRecordFileReader::Close() {
+#ifndef _WIN32
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+#endif
+  data_ = nullptr;
+  size_ = 0;
+  pos_ = 0;
+  slot_names_.clear();
+}
+
+int SlotRecordFileReader::Next(SlotRecordBlockView* view) {
+  if (data_ == nullptr) {
+    return -1;
+  }
+  if (pos_ == size_) {
+    return 0;
+  }
+  if (pos_ + kBlockHeaderSize > size_) {
+    return -1;
+  }
+  const char* block = data_ + pos_;
+  uint64_t m = ReadAt<uint32_t>(block, 0);
+  uint64_t ins_id_bytes = ReadAt<uint32_t>(block, 1);
+  uint64_t uint64_num = ReadAt<uint64_t>(block + 2 * sizeof(uint32_t), 0);
+  uint64_t float_num = ReadAt<uint64_t>(block + 2 * sizeof(uint32_t), 1);
+  uint64_t block_size =
+      kBlockHeaderSize + m * (sizeof(uint64_t) + 3 * sizeof(uint32_t)) +
+      sizeof(uint32_t) + ins_id_bytes +
+      (m * uint64_slot_num_ + 1) * sizeof(uint32_t) +
+      uint64_num * sizeof(uint64_t) +
+      (m * float_slot_num_ + 1) * sizeof(uint32_t) + float_num * sizeof(float);
+  if (block_size > size_ - pos_) {
+    return -1;
+  }
+  view->ins_num = static_cast<uint32_t>(m);
+  view->uint64_slot_num = uint64_slot_num_;
+  view->float_slot_num = float_slot_num_;
+  const char* p = block + kBlockHeaderSize;
+  view->search_ids = p;
+  p += m * sizeof(uint64_t);
+  view->ranks = p;
+  p += m * sizeof(uint32_t);
+  view->cmatchs = p;
+  p += m * sizeof(uint32_t);
+  view->ins_id_offsets = p;
+  p += (m + 1) * sizeof(uint32_t);
+  view->ins_ids = p;
+  p += ins_id_bytes;
+  view->uint64_offsets = p;
+  p += (m * uint64_slot_num_ + 1) * sizeof(uint32_t);
+  view->uint64_values = p;
+  p += uint64_num * sizeof(uint64_t);
+  view->float_offsets = p;
+  p += (m * float_slot_num_ + 1) * sizeof(uint32_t);
+  view->float_values = p;
+  if (ReadAt<uint32_t>(view->ins_id_offsets, m) != ins_id_bytes ||
+      ReadAt<uint32_t>(view->uint64_offsets, m * uint64_slot_num_) !=
+          uint64_num ||
+      ReadAt<uint32_t>(view->float_offsets, m * float_slot_num_) !=
+          float_num) {
+    return -1;
+  }
+  pos_ += block_size;
+  return 1;
+}
+
+}  // namespace framework
+}  // namespace paddle
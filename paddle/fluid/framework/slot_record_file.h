@@ -0,0 +1,154 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace framework {
+
+// The binary slot record file is the parsed instances of a data file, so the
+// instances are loaded again without parsing the text. The file is
+// |---4B(magic)---|---4B(uint64 slot num)---|---4B(float slot num)---|
+// |---4B(n)---|---n x (4B(len) + len x 1B)(slot names)---|---block---|...
+// and a block of m instances is
+// |---4B(m)---|---4B(ins id bytes)---|---8B(uint64 value num)---|
+// |---8B(float value num)---|---m x 8B(search ids)---|---m x 4B(ranks)---|
+// |---m x 4B(cmatchs)---|---(m + 1) x 4B(ins id offsets)---|---ins ids---|
+// |---(m x s + 1) x 4B(uint64 offsets)---|---uint64 values---|
+// |---(m x f + 1) x 4B(float offsets)---|---float values---|
+// where s and f are the slot nums. The values of the slot j of the instance i
+// are from offsets[i * s + j] to offsets[i * s + j + 1] of the block, in the
+// used slot order of the data feed.
+constexpr uint32_t kSlotRecordFileMagic = 0x31525350;  // "PSR1"
+
+// The suffix of the binary slot record files.
+constexpr char kSlotRecordFileSuffix[] = ".slotbin";
+
+bool IsSlotRecordFile(const std::string& path);
+
+class SlotRecordFileWriter {
+ public:
+  SlotRecordFileWriter() {}
+  ~SlotRecordFileWriter() { Close(); }
+  SlotRecordFileWriter(const SlotRecordFileWriter&) = delete;
+  SlotRecordFileWriter& operator=(const SlotRecordFileWriter&) = delete;
+
+  // slot_names are the uint64 slots then the float slots. Returns false if
+  // the file can not be written.
+  bool Open(const std::string& path,
+            const std::vector<std::string>& slot_names,
+            uint32_t uint64_slot_num,
+            uint32_t float_slot_num,
+            size_t block_size = 4096);
+  // uint64_offsets is uint64_slot_num + 1 offsets of uint64_values, and the
+  // same for float_offsets. Empty offsets mean the slots are all empty.
+  bool Append(uint64_t search_id,
+              uint32_t rank,
+              uint32_t cmatch,
+              const std::string& ins_id,
+              const std::vector<uint32_t>& uint64_offsets,
+              const uint64_t* uint64_values,
+              const std::vector<uint32_t>& float_offsets,
+              const float* float_values);
+  // Flush the last block and close the file, returns false if any write
+  // failed, in which case the file is incomplete.
+  bool Close();
+
+ private:
+  bool WriteBlock();
+  bool Write(const void* data, size_t size);
+
+  FILE* fp_ = nullptr;
+  bool ok_ = true;
+  size_t block_size_ = 0;
+  uint32_t uint64_slot_num_ = 0;
+  uint32_t float_slot_num_ = 0;
+  // the columns of the block being appended
+  std::vector<uint64_t> search_ids_;
+  std::vector<uint32_t> ranks_;
+  std::vector<uint32_t> cmatchs_;
+  std::vector<uint32_t> ins_id_offsets_;
+  std::string ins_ids_;
+  std::vector<uint32_t> uint64_offsets_;
+  std::vector<uint64_t> uint64_values_;
+  std::vector<uint32_t> float_offsets_;
+  std::vector<float> float_values_;
+};
+
+// A block of instances in the mapped file, the columns are not aligned, so
+// they are read by memcpy.
+struct SlotRecordBlockView {
+  uint32_t ins_num = 0;
+  uint32_t uint64_slot_num = 0;
+  uint32_t float_slot_num = 0;
+  const char* search_ids = nullptr;
+  const char* ranks = nullptr;
+  const char* cmatchs = nullptr;
+  const char* ins_id_offsets = nullptr;
+  const char* ins_ids = nullptr;
+  const char* uint64_offsets = nullptr;
+  const char* uint64_values = nullptr;
+  const char* float_offsets = nullptr;
+  const char* float_values = nullptr;
+
+  uint64_t search_id(uint32_t i) const;
+  uint32_t rank(uint32_t i) const;
+  uint32_t cmatch(uint32_t i) const;
+  void ins_id(uint32_t i, std::string* out) const;
+  // Copy the slot values of the instance i, offsets are rebased to 0.
+  void uint64_feasigns(uint32_t i,
+                       std::vector<uint64_t>* values,
+                       std::vector<uint32_t>* offsets) const;
+  void float_feasigns(uint32_t i,
+                      std::vector<float>* values,
+                      std::vector<uint32_t>* offsets) const;
+};
+
+// SlotRecordFileReader maps a local slot record file and reads its blocks in
+// place, the values are copied only into the instances.
+class SlotRecordFileReader {
+ public:
+  SlotRecordFileReader() {}
+  ~SlotRecordFileReader() { Close(); }
+  SlotRecordFileReader(const SlotRecordFileReader&) = delete;
+  SlotRecordFileReader& operator=(const SlotRecordFileReader&) = delete;
+
+  // Returns false if the file can not be mapped or is not a slot record file.
+  bool Open(const std::string& path);
+  void Close();
+
+  const std::vector<std::string>& slot_names() const { return slot_names_; }
+  uint32_t uint64_slot_num() const { return uint64_slot_num_; }
+  uint32_t float_slot_num() const { return float_slot_num_; }
+
+  // Returns 1 if a block is read, 0 at the end of file, -1 if the file is
+  // truncated or malformed.
+  int Next(SlotRecordBlockView* view);
+
+ private:
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  size_t pos_ = 0;
+  uint32_t uint64_slot_num_ = 0;
+  uint32_t float_slot_num_ = 0;
+  std::vector<std::string> slot_names_;
+};
+
+}  // namespace framework
+}  // namespace paddle
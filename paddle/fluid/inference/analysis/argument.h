@@ -164,6 +164,7 @@ struct Argument {
   DECL_ARGUMENT_FIELD(model_program_path, ModelProgramPath, std::string);
   DECL_ARGUMENT_FIELD(model_params_path, ModelParamsPath, std::string);
   DECL_ARGUMENT_FIELD(model_from_memory, ModelFromMemory, bool);
+  DECL_ARGUMENT_FIELD(mmap_params, MmapParams, bool);
   DECL_ARGUMENT_FIELD(save_optimized_model, SaveOptimizedModel, bool);
   DECL_ARGUMENT_FIELD(optim_cache_dir, OptimCacheDir, std::string);
   DECL_ARGUMENT_FIELD(enable_ir_optim, EnableIrOptim, bool);
@@ -280,6 +281,12 @@ struct Argument {
   DECL_ARGUMENT_FIELD(tensorrt_optimization_level,
                       TensorRtOptimizationLevel,
                       int);
+  DECL_ARGUMENT_FIELD(tensorrt_shape_profile_num,
+                      TensorRtShapeProfileNum,
+                      int);
+  DECL_ARGUMENT_FIELD(tensorrt_engine_store_dir,
+                      TensorRtEngineStoreDir,
+                      std::string);
   DECL_ARGUMENT_FIELD(tensorrt_ops_run_float,
                       TensorRtOpsRunFloat,
                       std::unordered_set<std::string>);
@@ -450,6 +457,9 @@ struct Argument {
                       EnableCustomDeviceMixed,
                       bool);
 
+  // the chunks of the matmuls overlapping with the allreduce
+  DECL_ARGUMENT_FIELD(comm_overlap_chunks, CommOverlapChunks, int);
+
  private:
   std::unordered_set<std::string> valid_fields_;
 };
@@ -14,6 +14,7 @@
 
 #include "paddle/fluid/inference/analysis/ir_pass_manager.h"
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
@@ -248,6 +249,10 @@ void IRPassManager::CreatePasses(Argument *argument,
       pass->Set("trt_dla_core", new int(argument->tensorrt_dla_core()));
       pass->Set("optimization_level",
                 new int(argument->tensorrt_optimization_level()));
+      pass->Set("trt_shape_profile_num",
+                new int(argument->tensorrt_shape_profile_num()));
+      pass->Set("trt_engine_store_dir",
+                new std::string(argument->tensorrt_engine_store_dir()));
 
       // Setting the disable_trt_plugin_fp16 to true means that TRT plugin will
       // not run fp16.
@@ -370,6 +375,10 @@ void IRPassManager::CreatePasses(Argument *argument,
         pass->Set("quant_post_dynamic_weight_methods",
                   new std::map<std::string, int>(quant_post_type));
       }
+    } else if (pass_name == "matmul_allreduce_fuse_pass") {
+      if (argument->comm_overlap_chunks_valid()) {
+        pass->Set("num_chunks", new int(argument->comm_overlap_chunks()));
+      }
     } else if (pass_name == "conv2d_xpu_fuse_pass") {
       std::map<std::string, int> quant_post_type =
           argument->xpu_quant_post_dynamic_weight_methods();
@@ -392,7 +401,13 @@ std::unique_ptr<Graph> IRPassManager::Apply(std::unique_ptr<Graph> graph) {
     if (pass->Type() != "graph_viz_pass" && !disable_logs_) {
       PrettyLogEndl(Style::H2(), "--- Running IR pass [%s]", pass->Type());
     }
+    auto start = std::chrono::steady_clock::now();
     graph.reset(pass->Apply(graph.release()));
+    VLOG(1) << "IR pass [" << pass->Type() << "] costs "
+            << std::chrono::duration<double, std::milli>(
+                   std::chrono::steady_clock::now() - start)
+                   .count()
+            << " ms";
   }
   return graph;
 }
@@ -32,6 +32,9 @@
 #include "paddle/fluid/inference/lite/op_teller.h"
 #include "paddle/fluid/inference/utils/singleton.h"
 #include "paddle/fluid/string/pretty_log.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_int32(lite_engine_build_threads);
 
 namespace paddle {
 namespace inference {
@@ -221,9 +224,9 @@ void OrganizeProgram(Node* merged_node,
 void LiteSubgraphPass::SetUpEngine(
     framework::ProgramDesc* program,
     const std::vector<std::string>& repetitive_params,
-    const std::string& unique_key,
+    inference::lite::EngineConfig* engine_config,
     bool dump_model) const {
-  inference::lite::EngineConfig config;
+  auto& config = *engine_config;
   auto* scope = param_scope();
 
   // When the pass is started, only the persistent variables of the
@@ -378,14 +381,13 @@ void LiteSubgraphPass::SetUpEngine(
     lite::StrToBinaryFile("./model.bin", config.model);
     lite::StrToBinaryFile("./param.bin", config.param);
   }
-  inference::Singleton<inference::lite::EngineManager>::Global().Create(
-      unique_key, config);
 }
 
 void LiteSubgraphPass::BuildOperator(
     Node* merged_node,
     framework::ProgramDesc* global_program,
-    std::vector<std::string>* repetitive_params) const {
+    std::vector<std::string>* repetitive_params,
+    inference::lite::EngineConfig* engine_config) const {
   framework::ProgramDesc engine_program;
 
   const std::string id = std::to_string(Get<int>("predictor_id"));
@@ -397,7 +399,7 @@ void LiteSubgraphPass::BuildOperator(
 
   lite::OrganizeProgram(
       merged_node, global_program, &engine_program, repetitive_params);
-  SetUpEngine(&engine_program, *repetitive_params, unique_key);
+  SetUpEngine(&engine_program, *repetitive_params, engine_config);
 
   auto* op_desc = merged_node->Op();
   op_desc->SetInput("Xs", input_names);
@@ -433,9 +435,15 @@ void LiteSubgraphPass::ApplyImpl(framework::ir::Graph* graph) const {
   fuser();
 
   std::vector<std::string> repetitive_params;
+  std::vector<std::string> engine_keys;
+  std::vector<inference::lite::EngineConfig> engine_configs;
   for (auto* node : graph->Nodes()) {
     if (node->IsOp() && !Agent(node).subgraph()->empty()) {
-      BuildOperator(node, global_program, &repetitive_params);
+      engine_configs.emplace_back();
+      BuildOperator(
+          node, global_program, &repetitive_params, &engine_configs.back());
+      engine_keys.push_back(
+          PADDLE_GET_CONST(std::string, node->Op()->GetAttr("engine_key")));
       std::unordered_set<const Node*> nodes2remove(
           Agent(node).subgraph()->begin(), Agent(node).subgraph()->end());
       framework::ir::GraphSafeRemoveNodes(graph, nodes2remove);
@@ -449,6 +457,8 @@ void LiteSubgraphPass::ApplyImpl(framework::ir::Graph* graph) const {
     }
   }
   framework::ir::GraphSafeRemoveNodes(graph, nodes2remove);
+  inference::Singleton<inference::lite::EngineManager>::Global().CreateAll(
+      engine_keys, &engine_configs, FLAGS_lite_engine_build_threads);
   graph->Set(framework::ir::kRepetitiveParamAttr,
              new std::vector<std::string>(repetitive_params));
 }
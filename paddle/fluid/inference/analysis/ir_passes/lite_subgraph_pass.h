@@ -25,6 +25,10 @@
 
 namespace paddle {
 namespace inference {
+namespace lite {
+struct EngineConfig;
+}  // namespace lite
+
 namespace analysis {
 
 class LiteSubgraphPass : public framework::ir::FusePassBase {
@@ -34,11 +38,14 @@ class LiteSubgraphPass : public framework::ir::FusePassBase {
  private:
   void BuildOperator(framework::ir::Node* merged_node,
                      framework::ProgramDesc* global_program,
-                     std::vector<std::string>* repetitive_params) const;
+                     std::vector<std::string>* repetitive_params,
+                     inference::lite::EngineConfig* engine_config) const;
 
+  // Only fills the config of the engine, all the engines are created at the
+  // end of the pass.
   void SetUpEngine(framework::ProgramDesc* program,
                    const std::vector<std::string>& repetitive_params,
-                   const std::string& unique_key,
+                   inference::lite::EngineConfig* config,
                    bool dump_model = false) const;
 };
 
@@ -16,8 +16,11 @@
 #include "paddle/fluid/inference/analysis/ir_passes/tensorrt_subgraph_pass.h"
 
 #include <fcntl.h>
+#include <algorithm>
 #include <cstddef>
+#include <map>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <unordered_set>
 
@@ -33,11 +36,16 @@
 #include "paddle/fluid/inference/api/helper.h"
 #include "paddle/fluid/inference/tensorrt/convert/op_converter.h"
 #include "paddle/fluid/inference/tensorrt/engine.h"
+#include "paddle/fluid/inference/tensorrt/engine_store.h"
 #include "paddle/fluid/inference/tensorrt/op_teller.h"
 #include "paddle/fluid/inference/tensorrt/trt_int8_calibrator.h"
 #include "paddle/fluid/inference/utils/io_utils.h"
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #include "paddle/phi/common/backend.h"
 #include "paddle/phi/common/data_type.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_double(trt_partition_speedup);
 
 namespace paddle {
 namespace inference {
@@ -121,6 +129,54 @@ bool AllNodesLowerToTrtPostProcess(framework::ir::Graph *graph) {
   }
   return all_nodes_offload_to_trt;
 }
+
+// The elements of a variable, with the unknown dims counted as 1.
+double NumElements(const framework::ir::Node *var_node) {
+  if (!var_node->IsVar() || !var_node->Var()) return 0;
+  double numel = 1;
+  for (auto d : var_node->Var()->GetShape()) {
+    numel *= static_cast<double>(std::max<int64_t>(d, 1));
+  }
+  return numel;
+}
+
+// The estimated benefit of replacing a subgraph by an engine, in the elements
+// moved by the kernels. Every op moves the elements of its outputs, which the
+// engine moves speedup times faster, while every non-persistable variable
+// crossing the boundary of the engine costs a copy of its elements, and the
+// engine itself a fixed launch cost.
+double EstimateTrtBenefit(const std::vector<framework::ir::Node *> &subgraph,
+                          double speedup) {
+  // About the elements moved in the time of launching an engine.
+  constexpr double kEngineLaunchElements = 1 << 16;
+  std::unordered_set<const framework::ir::Node *> ops(subgraph.begin(),
+                                                      subgraph.end());
+  std::unordered_set<const framework::ir::Node *> boundary;
+  double op_elements = 0;
+  for (auto *op : subgraph) {
+    for (auto *in : op->inputs) {
+      if (in->IsVar() && in->Var() && !in->Var()->Persistable() &&
+          (in->inputs.empty() || !ops.count(in->inputs[0]))) {
+        boundary.insert(in);
+      }
+    }
+    for (auto *out : op->outputs) {
+      op_elements += NumElements(out);
+      for (auto *user : out->outputs) {
+        if (!ops.count(user)) {
+          boundary.insert(out);
+          break;
+        }
+      }
+    }
+  }
+  double boundary_elements = 0;
+  for (auto *var : boundary) {
+    boundary_elements += NumElements(var);
+  }
+  return op_elements * (1 - 1 / speedup) - boundary_elements -
+         kEngineLaunchElements;
+}
 }  // namespace
 
 using framework::ir::Node;
@@ -179,11 +235,24 @@ void analysis::TensorRtSubgraphPass::ApplyImpl(
     return is_ok;
   };
 
+  // the subgraphs not worth an engine are left to paddle, see
+  // FLAGS_trt_partition_speedup
+  const double speedup = FLAGS_trt_partition_speedup;
+  framework::ir::SubGraphFuser::SubgraphAcceptor acceptor = nullptr;
+  if (speedup > 1) {
+    acceptor = [speedup](const std::vector<framework::ir::Node *> &subgraph) {
+      double benefit = EstimateTrtBenefit(subgraph, speedup);
+      VLOG(3) << "The estimated benefit of the subgraph of " << subgraph.size()
+              << " ops in TensorRT: " << benefit;
+      return benefit > 0;
+    };
+  }
   framework::ir::SubGraphFuser fuser(
       graph,
       teller,
       Get<int>("min_subgraph_size") /*min subgraph size*/,
-      "tensorrt_engine");
+      "tensorrt_engine",
+      acceptor);
   fuser();
 
   std::vector<std::string> graph_param_names =
@@ -289,6 +358,72 @@ std::string GenerateEngineKey(const std::set<std::string> &engine_inputs,
   return engine_key;
 }
 
+namespace {
+
+// The key of an engine in the engine store, a digest of everything the
+// serialized engine depends on.
+std::string GenerateEngineStoreKey(
+    const std::string &engine_key,
+    const framework::BlockDesc &block_desc,
+    const std::vector<std::string> &parameters,
+    const framework::Scope &scope,
+    const tensorrt::TensorRTEngine::ConstructionParams &params) {
+  tensorrt::EngineStoreDigest digest;
+  digest.Update(engine_key);
+  digest.Update(block_desc.Proto()->SerializeAsString());
+  // models of the same structure may have different weights
+  for (auto &name : parameters) {
+    digest.Update(name);
+    auto *var = scope.FindVar(name);
+    if (var == nullptr || !var->IsType<phi::DenseTensor>()) {
+      continue;
+    }
+    auto &tensor = var->Get<phi::DenseTensor>();
+    digest.Update(tensor.dims().to_str());
+    digest.Update(phi::DataTypeToString(tensor.dtype()));
+    if (tensor.initialized() &&
+        tensor.place().GetType() == phi::AllocationType::CPU) {
+      digest.Update(tensor.data(),
+                    tensor.numel() * phi::SizeOf(tensor.dtype()));
+    }
+  }
+  auto update_shapes =
+      [&digest](const std::map<std::string, std::vector<int>> &shapes) {
+        for (auto &item : shapes) {
+          digest.Update(item.first);
+          digest.Update(item.second.data(), item.second.size() * sizeof(int));
+        }
+        digest.Update("#");
+      };
+  update_shapes(params.min_input_shape);
+  update_shapes(params.max_input_shape);
+  update_shapes(params.optim_input_shape);
+  update_shapes(params.min_shape_tensor);
+  update_shapes(params.max_shape_tensor);
+  update_shapes(params.optim_shape_tensor);
+  std::stringstream options;
+  options << params.max_batch_size << "#" << params.max_workspace_size << "#"
+          << static_cast<int>(params.precision) << "#" << params.use_varseqlen
+          << "#" << params.with_interleaved << "#"
+          << params.tensorrt_transformer_posid << "#"
+          << params.tensorrt_transformer_maskid << "#" << params.use_dla << "#"
+          << params.dla_core << "#" << params.disable_trt_plugin_fp16 << "#"
+          << params.enable_low_precision_io << "#"
+          << params.optimization_level << "#"
+          << params.use_explicit_quantization << "#"
+          << params.shape_profile_num;
+  digest.Update(options.str());
+  // the engines are specific to the GPU and the TensorRT version
+  std::stringstream device;
+  device << platform::GetDeviceProperties(params.device_id).name << "#"
+         << platform::GetGPUComputeCapability(params.device_id) << "#"
+         << TRT_VERSION << "#" << tensorrt::GetInferLibVersion();
+  digest.Update(device.str());
+  return digest.HexDigest();
+}
+
+}  // namespace
+
 std::string TensorRtSubgraphPass::CreateTensorRTOp(
     framework::ir::Node *node,
     framework::ir::Graph *graph,
@@ -614,6 +749,9 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   auto workspace_size = Get<int64_t>("workspace_size");
   auto gpu_device_id = Get<int>("gpu_device_id");
   auto optimization_level = Get<int>("optimization_level");
+  // the shape profiles split the range of dynamic shapes
+  auto shape_profile_num =
+      with_dynamic_shape ? Get<int>("trt_shape_profile_num") : 1;
   auto use_explicit_quantization = Get<bool>("use_explicit_quantization");
 
   // Set op's attrs.
@@ -689,11 +827,16 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   // when running in the 'use_serialize' mode, there is a bug.
   // serialization is affected by max_batch_size, but calibration is not.
   // So we use separate engine keys in serialization and calibration.
+  // the serialized engines of different numbers of shape profiles differ
+  std::string engine_batch_key = std::to_string(max_batch_size);
+  if (shape_profile_num > 1) {
+    engine_batch_key += "#" + std::to_string(shape_profile_num);
+  }
   auto engine_key =
       GenerateEngineKey(input_names_with_id,
                         output_names_with_id,
                         std::to_string(0),
-                        std::to_string(max_batch_size),
+                        engine_batch_key,
                         std::to_string(static_cast<int>(precision_mode)),
                         use_cuda_graph,
                         false);
@@ -728,6 +871,13 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   op_desc->SetAttr("dla_core", dla_core);
   op_desc->SetAttr("disable_trt_plugin_fp16", disable_trt_plugin_fp16);
   op_desc->SetAttr("context_memory_sharing", context_memory_sharing);
+  auto engine_store_dir = Get<std::string>("trt_engine_store_dir");
+  std::string timing_cache_path;
+  if (!engine_store_dir.empty()) {
+    timing_cache_path = engine_store_dir + "/" + tensorrt::kTrtTimingCacheFile;
+  }
+  op_desc->SetAttr("timing_cache_path", timing_cache_path);
+  op_desc->SetAttr("shape_profile_num", shape_profile_num);
   std::string trt_engine_serialized_data;
   op_desc->SetAttr("engine_serialized_data", trt_engine_serialized_data);
 
@@ -819,6 +969,16 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   params.enable_low_precision_io = enable_low_precision_io;
   params.optimization_level = optimization_level;
   params.use_explicit_quantization = use_explicit_quantization;
+  params.timing_cache_path = timing_cache_path;
+  params.shape_profile_num = shape_profile_num;
+
+  std::string engine_store_path;
+  if (!engine_store_dir.empty()) {
+    engine_store_path = tensorrt::GetEngineStorePath(
+        engine_store_dir,
+        GenerateEngineStoreKey(
+            engine_key, block_desc, parameters, *scope, params));
+  }
 
   tensorrt::TensorRTEngine *trt_engine =
       inference::Singleton<inference::tensorrt::TRTEngineManager>::Global()
@@ -827,6 +987,22 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   // support force ops to run in FP32 precision
   trt_engine->SetRunFloat(trt_ops_run_float);
 
+  if (!engine_store_path.empty()) {
+    std::string engine_data;
+    if (tensorrt::ReadEngineStoreFile(engine_store_path, &engine_data)) {
+      try {
+        trt_engine->Deserialize(engine_data);
+        LOG(INFO) << "Load TRT engine from the engine store "
+                  << engine_store_path;
+        return engine_key + std::to_string(predictor_id);
+      } catch (const std::exception &exp) {
+        LOG(WARNING) << "Fail to load TRT engine from the engine store "
+                     << engine_store_path << ": " << exp.what()
+                     << ". TRT engine will be rebuilt";
+      }
+    }
+  }
+
   if (use_static_engine) {
     trt_engine_serialized_data = GetTrtEngineSerializedData(
         Get<std::string>("model_opt_cache_dir"), engine_key);
@@ -886,6 +1062,14 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
               << GetTrtEngineSerializedPath(
                      Get<std::string>("model_opt_cache_dir"), engine_key);
   }
+  if (!engine_store_path.empty()) {
+    nvinfer1::IHostMemory *serialized_engine_data = trt_engine->Serialize();
+    tensorrt::WriteEngineStoreFile(
+        engine_store_path,
+        std::string(static_cast<const char *>(serialized_engine_data->data()),
+                    serialized_engine_data->size()));
+    LOG(INFO) << "Save TRT engine to the engine store " << engine_store_path;
+  }
 
   return engine_key + std::to_string(predictor_id);
 }
@@ -29,9 +29,11 @@ namespace analysis {
 class PassResultInfoForRuntime {
  public:
   using PassInfo =
-      paddle::variant<std::string,
-                      std::vector<std::string>,
-                      std::unordered_map<std::string, std::string>>;
+      paddle::variant<
+          std::string,
+          std::vector<std::string>,
+          std::unordered_map<std::string, std::string>,
+          std::unordered_map<std::string, std::pair<size_t, size_t>>>;
 
   static PassResultInfoForRuntime* Instance() {
     static PassResultInfoForRuntime info;
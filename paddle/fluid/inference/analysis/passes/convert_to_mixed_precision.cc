@@ -14,13 +14,23 @@
 
 #include "paddle/fluid/inference/analysis/passes/convert_to_mixed_precision.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+
+#include "paddle/fluid/framework/data_type_transform.h"
 #include "paddle/fluid/framework/executor.h"
 #include "paddle/fluid/framework/ir/auto_mixed_precision_pass.h"
 #include "paddle/fluid/framework/ir/constant_folding_pass.h"
 #include "paddle/fluid/framework/ir/graph_helper.h"
 #include "paddle/fluid/framework/ir/identity_op_clean_pass.h"
+#include "paddle/fluid/framework/op_registry.h"
+#include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/fluid/framework/variable_helper.h"
 #include "paddle/fluid/inference/io.h"
 #include "paddle/phi/common/backend.h"
+#include "paddle/phi/core/compat/convert_utils.h"
 
 namespace paddle {
 namespace inference {
@@ -242,6 +252,170 @@ void ConvertToMixedPrecision(
   pass.Run();
 }
 
+namespace {
+
+phi::DenseTensor ToFloat32OnCPU(const phi::DenseTensor& tensor) {
+  phi::DenseTensor cpu_tensor;
+  framework::TensorCopySync(tensor, platform::CPUPlace(), &cpu_tensor);
+  if (cpu_tensor.dtype() == phi::DataType::FLOAT32) {
+    return cpu_tensor;
+  }
+  phi::DenseTensor fp32_tensor;
+  framework::TransDataType(
+      cpu_tensor, framework::proto::VarType::FP32, &fp32_tensor);
+  return fp32_tensor;
+}
+
+// The max absolute error of the elements relative to the max absolute value of
+// the reference, both in fp32 on CPU.
+double RelativeError(const phi::DenseTensor& out, const phi::DenseTensor& ref) {
+  if (out.numel() != ref.numel()) {
+    return std::numeric_limits<double>::infinity();
+  }
+  const float* out_data = out.data<float>();
+  const float* ref_data = ref.data<float>();
+  double max_error = 0, max_ref = 0;
+  for (int64_t i = 0; i < ref.numel(); ++i) {
+    if (std::isnan(out_data[i]) != std::isnan(ref_data[i])) {
+      return std::numeric_limits<double>::infinity();
+    }
+    max_error = std::max(
+        max_error, std::fabs(static_cast<double>(out_data[i]) - ref_data[i]));
+    max_ref = std::max(max_ref, std::fabs(static_cast<double>(ref_data[i])));
+  }
+  return max_error / std::max(max_ref, 1e-6);
+}
+
+bool IsFloat32Tensor(const framework::Variable* var) {
+  return var != nullptr && var->IsType<phi::DenseTensor>() &&
+         var->Get<phi::DenseTensor>().initialized() &&
+         var->Get<phi::DenseTensor>().dtype() == phi::DataType::FLOAT32;
+}
+
+// Runs the op in the mixed precision on its fp32 inputs cast, and returns its
+// fp32 outputs cast back, or nothing if no input is cast.
+std::unordered_map<std::string, phi::DenseTensor> RunInMixedPrecision(
+    const framework::OperatorBase& op,
+    const framework::Scope& scope,
+    const platform::Place& place,
+    framework::proto::VarType::Type mixed_type) {
+  std::unordered_map<std::string, phi::DenseTensor> outputs;
+  framework::Scope& mixed_scope = scope.NewScope();
+  bool has_cast = false;
+  for (auto& name : op.InputVars()) {
+    auto* var = scope.FindVar(name);
+    if (IsFloat32Tensor(var) && mixed_scope.FindLocalVar(name) == nullptr) {
+      framework::TransDataType(
+          var->Get<phi::DenseTensor>(),
+          mixed_type,
+          mixed_scope.Var(name)->GetMutable<phi::DenseTensor>());
+      has_cast = true;
+    }
+  }
+  if (has_cast) {
+    for (auto& name : op.OutputVars(true)) {
+      auto* var = scope.FindVar(name);
+      if (var != nullptr && var->IsType<phi::DenseTensor>() &&
+          mixed_scope.FindLocalVar(name) == nullptr) {
+        mixed_scope.Var(name)->GetMutable<phi::DenseTensor>();
+      }
+    }
+    try {
+      op.Run(mixed_scope, place);
+      for (auto& name : op.OutputVars(true)) {
+        auto* var = mixed_scope.FindLocalVar(name);
+        if (var != nullptr && var->IsType<phi::DenseTensor>() &&
+            var->Get<phi::DenseTensor>().initialized()) {
+          outputs[name] = ToFloat32OnCPU(var->Get<phi::DenseTensor>());
+        }
+      }
+    } catch (platform::EnforceNotMet& e) {
+      VLOG(3) << op.Type() << " fails to run in the mixed precision: "
+              << e.what();
+      outputs.clear();
+    }
+  }
+  scope.DeleteScope(&mixed_scope);
+  return outputs;
+}
+
+}  // namespace
+
+std::unordered_set<std::string> CalibrateMixedPrecisionBlackList(
+    const std::string& model_file,
+    const std::string& params_file,
+    phi::DataType mixed_precision,
+    phi::Backend backend,
+    const std::vector<std::unordered_map<std::string, phi::DenseTensor>>& feeds,
+    double max_relative_error,
+    const std::unordered_set<std::string>& black_list,
+    const std::unordered_set<std::string>& white_list) {
+  auto place = phi::TransToPhiPlace(backend);
+  auto mixed_type = framework::TransToProtoVarType(mixed_precision);
+  framework::Scope scope;
+  framework::Executor exe(place);
+  bool load_params = !params_file.empty();
+  auto program =
+      inference::Load(&exe, &scope, model_file, params_file, load_params);
+  const auto& block = program->Block(0);
+  std::vector<std::unique_ptr<framework::OperatorBase>> ops;
+  for (auto* op_desc : block.AllOps()) {
+    if (op_desc->Type() != "feed" && op_desc->Type() != "fetch") {
+      ops.emplace_back(framework::OpRegistry::CreateOp(*op_desc));
+    }
+  }
+
+  // the max relative error of every op type over the batches
+  std::map<std::string, double> errors;
+  for (auto& feed : feeds) {
+    framework::Scope& batch_scope = scope.NewScope();
+    for (auto* var : block.AllVars()) {
+      if (!var->Persistable()) {
+        framework::InitializeVariable(batch_scope.Var(var->Name()),
+                                      var->GetType());
+      }
+    }
+    for (auto& item : feed) {
+      batch_scope.Var(item.first)
+          ->GetMutable<phi::DenseTensor>()
+          ->ShareDataWith(item.second);
+    }
+    for (auto& op : ops) {
+      std::unordered_map<std::string, phi::DenseTensor> mixed_outputs;
+      if (OpSupportPrecision(
+              op->Type(), backend, mixed_precision, black_list, white_list) &&
+          !white_list.count(op->Type())) {
+        mixed_outputs =
+            RunInMixedPrecision(*op, batch_scope, place, mixed_type);
+      }
+      op->Run(batch_scope, place);
+      for (auto& item : mixed_outputs) {
+        auto* var = batch_scope.FindVar(item.first);
+        if (!IsFloat32Tensor(var)) {
+          continue;
+        }
+        double error = RelativeError(
+            item.second, ToFloat32OnCPU(var->Get<phi::DenseTensor>()));
+        errors[op->Type()] = std::max(errors[op->Type()], error);
+      }
+    }
+    scope.DeleteScope(&batch_scope);
+  }
+
+  std::unordered_set<std::string> calibrated_black_list = black_list;
+  for (auto& item : errors) {
+    VLOG(3) << "The relative error of " << item.first << " in "
+            << phi::DataTypeToString(mixed_precision) << ": " << item.second;
+    if (item.second > max_relative_error) {
+      LOG(INFO) << "Keep " << item.first << " in fp32 for the relative error "
+                << item.second << " in "
+                << phi::DataTypeToString(mixed_precision);
+      calibrated_black_list.insert(item.first);
+    }
+  }
+  return calibrated_black_list;
+}
+
 }  // namespace analysis
 }  // namespace inference
 }  // namespace paddle
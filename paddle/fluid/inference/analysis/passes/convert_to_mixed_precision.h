@@ -15,7 +15,9 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "paddle/fluid/framework/block_desc.h"
 #include "paddle/fluid/framework/ir/graph.h"
@@ -23,6 +25,7 @@
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/phi/common/backend.h"
 #include "paddle/phi/common/data_type.h"
+#include "paddle/phi/core/dense_tensor.h"
 
 namespace paddle {
 namespace inference {
@@ -88,6 +91,22 @@ void ConvertToMixedPrecision(const std::string& model_file,
                              const std::unordered_set<std::string>& black_list,
                              const std::unordered_set<std::string>& white_list);
 
+// Calibrates the black list of the mixed precision conversion by the feeds of
+// some representative batches. Every op supporting the mixed precision is run
+// in both fp32 and the mixed precision on the same fp32 inputs of the batch,
+// and the op types whose outputs deviate from fp32 by a relative error larger
+// than max_relative_error are added to the black list, which is returned to be
+// passed to ConvertToMixedPrecision.
+std::unordered_set<std::string> CalibrateMixedPrecisionBlackList(
+    const std::string& model_file,
+    const std::string& params_file,
+    phi::DataType mixed_precision,
+    phi::Backend backend,
+    const std::vector<std::unordered_map<std::string, phi::DenseTensor>>& feeds,
+    double max_relative_error,
+    const std::unordered_set<std::string>& black_list,
+    const std::unordered_set<std::string>& white_list);
+
 }  // namespace analysis
 }  // namespace inference
 }  // namespace paddle
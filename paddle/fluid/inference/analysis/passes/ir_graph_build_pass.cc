@@ -56,7 +56,8 @@ void IrGraphBuildPass::RunImpl(Argument *argument) {
         argument->scope_ptr(),
         place,
         argument->model_from_memory_valid() && argument->model_from_memory(),
-        argument->skip_load_params());
+        argument->skip_load_params(),
+        argument->mmap_params_valid() && argument->mmap_params());
     argument->SetMainProgram(program.release());
   } else {
     PADDLE_THROW(platform::errors::PreconditionNotMet(
@@ -119,10 +120,16 @@ std::unique_ptr<framework::ProgramDesc> IrGraphBuildPass::LoadModel(
     framework::Scope *scope,
     const platform::Place &place,
     bool model_from_memory,
-    bool skip_load_params) {
+    bool skip_load_params,
+    bool mmap_params) {
   framework::Executor exe(place);
   if (!model_from_memory) {
-    return Load(&exe, scope, program_path, params_path, !skip_load_params);
+    return Load(&exe,
+                scope,
+                program_path,
+                params_path,
+                !skip_load_params,
+                mmap_params);
   } else {
     return LoadFromMemory(&exe, scope, program_path, params_path);
   }
@@ -14,6 +14,10 @@
 
 #include "paddle/fluid/inference/analysis/passes/memory_optimize_pass.h"
 
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <map>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -22,7 +26,11 @@
 #include "glog/logging.h"
 #include "paddle/fluid/framework/ir/graph_helper.h"
 #include "paddle/fluid/inference/analysis/pass_result_info.h"
+#include "paddle/fluid/inference/utils/io_utils.h"
 #include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_bool(inference_memory_offset_plan);
 
 namespace paddle {
 namespace framework {
@@ -41,6 +49,7 @@ using framework::ir::Graph;
 using framework::ir::Node;
 using framework::ir::TopologyVarientSort;
 using space_table_t = MemoryOptimizePass::space_table_t;
+using offset_table_t = MemoryOptimizePass::offset_table_t;
 
 typedef struct {
   std::string name;
@@ -120,8 +129,21 @@ void MemoryOptimizePass::CollectLifeCycle(
 }
 
 void MemoryOptimizePass::CollectVarMemorySize(
-    Graph* graph, space_table_t* space_table) const {
+    Graph* graph,
+    const std::string& shape_range_info_path,
+    space_table_t* space_table) const {
   const int fake_batch_size = 1;
+  std::map<std::string, std::vector<int32_t>> min_shapes, max_shapes,
+      opt_shapes, min_values, max_values, opt_values;
+  if (!shape_range_info_path.empty()) {
+    DeserializeShapeRangeInfo(shape_range_info_path,
+                              &min_shapes,
+                              &max_shapes,
+                              &opt_shapes,
+                              &min_values,
+                              &max_values,
+                              &opt_values);
+  }
 
   auto valid_var = [&](framework::ir::Node* node) -> bool {
     // lod operator reuse may cause unknown errors.
@@ -179,12 +201,17 @@ void MemoryOptimizePass::CollectVarMemorySize(
       // Parameters will not be reused.
       if (node->Var()->Persistable()) continue;
       auto shape = node->Var()->GetShape();
+      auto max_shape = max_shapes.find(node->Var()->Name());
+      if (max_shape != max_shapes.end() &&
+          max_shape->second.size() == shape.size()) {
+        shape.assign(max_shape->second.begin(), max_shape->second.end());
+      }
       for (auto& v : shape) {
         if (v < 0) v = fake_batch_size;
       }
 
-      int size =
-          std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<>());
+      int64_t size = std::accumulate(
+          shape.begin(), shape.end(), int64_t(1), std::multiplies<>());
       (*space_table)[node->Var()->Name()] =
           size * paddle::framework::SizeOfType(node->Var()->GetDataType());
     }
@@ -248,6 +275,72 @@ void MakeSimpleReusePlan(
   }
 }
 
+// Assigns every var a byte offset of one workspace, so that the vars whose
+// lifetimes overlap never overlap in the workspace. The vars are placed from
+// the largest, each at the lowest offset whose gap between the placed vars of
+// the overlapping lifetimes fits it.
+size_t MakeOffsetReusePlan(
+    const std::unordered_map<std::string, std::pair<int, int>>& lifecycles,
+    const std::unordered_map<std::string, size_t>& space_table,
+    offset_table_t* offset_table) {
+  constexpr size_t kAlignment = 256;
+  struct Block {
+    std::string name;
+    size_t size;
+    std::pair<int, int> lifetime;
+    size_t offset;
+  };
+  std::vector<Block> blocks;
+  for (auto& data : lifecycles) {
+    if (!space_table.count(data.first)) continue;
+    size_t size = (space_table.at(data.first) + kAlignment - 1) / kAlignment *
+                  kAlignment;
+    blocks.push_back({data.first, size, data.second, 0});
+  }
+  std::sort(blocks.begin(), blocks.end(), [](const Block& a, const Block& b) {
+    return a.size != b.size ? a.size > b.size : a.name < b.name;
+  });
+
+  size_t workspace_size = 0;
+  std::vector<const Block*> placed;
+  for (auto& block : blocks) {
+    std::vector<const Block*> overlapped;
+    for (auto* other : placed) {
+      if (other->lifetime.second >= block.lifetime.first &&
+          block.lifetime.second >= other->lifetime.first) {
+        overlapped.push_back(other);
+      }
+    }
+    std::sort(overlapped.begin(),
+              overlapped.end(),
+              [](const Block* a, const Block* b) {
+                return a->offset < b->offset;
+              });
+    // Best fit: the smallest gap that fits, or else the end.
+    size_t offset = 0;
+    size_t best_offset = 0;
+    size_t best_gap = std::numeric_limits<size_t>::max();
+    for (auto* other : overlapped) {
+      if (other->offset >= offset + block.size &&
+          other->offset - offset < best_gap) {
+        best_gap = other->offset - offset;
+        best_offset = offset;
+      }
+      offset = std::max(offset, other->offset + other->size);
+    }
+    block.offset = best_gap == std::numeric_limits<size_t>::max()
+                       ? offset
+                       : best_offset;
+    workspace_size = std::max(workspace_size, block.offset + block.size);
+    placed.push_back(&block);
+    (*offset_table)[block.name] = std::make_pair(block.offset, block.size);
+  }
+  LOG(INFO) << "The offset reuse plan packs " << blocks.size()
+            << " vars into a workspace of "
+            << (static_cast<double>(workspace_size) / (1 << 20)) << "MB";
+  return workspace_size;
+}
+
 std::string MemoryOptimizePass::repr() const { return "memory_optimize_pass"; }
 
 void MemoryOptimizePass::RunImpl(Argument* argument) {
@@ -273,13 +366,27 @@ void MemoryOptimizePass::RunImpl(Argument* argument) {
   std::unordered_map<std::string, std::string> node2cluster;
   std::unordered_map<std::string, int> cluster_size;
 
+  std::string shape_range_info_path;
+  if (argument->tensorrt_shape_range_info_path_valid() &&
+      !argument->tensorrt_shape_range_info_path().empty() &&
+      std::ifstream(argument->tensorrt_shape_range_info_path()).good()) {
+    shape_range_info_path = argument->tensorrt_shape_range_info_path();
+  }
+
   CollectLifeCycle(graph, &lifecycles, sort_kind);
-  CollectVarMemorySize(graph, &space_table);
+  CollectVarMemorySize(graph, shape_range_info_path, &space_table);
   MakeSimpleReusePlan(lifecycles, space_table, &node2cluster, &cluster_size);
 
   auto* pass_res_info = PassResultInfoForRuntime::Instance();
   pass_res_info->Set(
       argument->root_predictor_id(), "memory_optimize_pass", node2cluster);
+  if (FLAGS_inference_memory_offset_plan) {
+    offset_table_t offset_table;
+    MakeOffsetReusePlan(lifecycles, space_table, &offset_table);
+    pass_res_info->Set(argument->root_predictor_id(),
+                       "memory_optimize_pass_offsets",
+                       offset_table);
+  }
 
   return;
 }
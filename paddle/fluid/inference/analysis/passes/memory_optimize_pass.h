@@ -40,11 +40,17 @@ namespace analysis {
  * current name of var.
  * 3. Perform reuse plan: Replace all var's name in the model according to the
  * mapping table.
+ * Under FLAGS_inference_memory_offset_plan, the vars are instead assigned the
+ * byte offsets of one workspace, so that the vars of different sizes are packed
+ * together.
  */
 class MemoryOptimizePass : public AnalysisPass {
  public:
   using space_table_t = std::unordered_map<std::string, size_t>;
   using lifecycle_t = std::pair<int, int>;
+  // The offset and the size of a var in the workspace.
+  using offset_table_t =
+      std::unordered_map<std::string, std::pair<size_t, size_t>>;
 
   virtual ~MemoryOptimizePass() = default;
 
@@ -57,7 +63,10 @@ class MemoryOptimizePass : public AnalysisPass {
       std::unordered_map<std::string, lifecycle_t> *lifecycles,
       int sort_kind) const;
 
+  // The dynamic dims are taken from the max shapes of shape_range_info_path
+  // when it is given, or else taken as 1.
   void CollectVarMemorySize(framework::ir::Graph *graph,
+                            const std::string &shape_range_info_path,
                             space_table_t *space_table) const;
 
  public:
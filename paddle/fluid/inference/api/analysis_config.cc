@@ -434,6 +434,8 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
                                   // params_file_ fields.
   CP_MEMBER(save_optimized_model_);
   CP_MEMBER(opt_cache_dir_);
+  CP_MEMBER(mmap_params_);
+  CP_MEMBER(pir_program_cache_);
   CP_MEMBER(prog_file_);
   CP_MEMBER(params_file_);
 
@@ -483,6 +485,8 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(trt_engine_memory_sharing_);
   CP_MEMBER(trt_engine_memory_sharing_identifier_);
   CP_MEMBER(trt_optimization_level_);
+  CP_MEMBER(trt_engine_store_dir_);
+  CP_MEMBER(trt_shape_profile_num_);
   CP_MEMBER(trt_ops_run_float_);
   // Dlnne related
   CP_MEMBER(use_dlnne_);
@@ -545,6 +549,8 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(specify_input_name_);
 
   CP_MEMBER(cpu_math_library_num_threads_);
+  CP_MEMBER(numa_node_);
+  CP_MEMBER(intra_op_num_threads_);
 
   CP_MEMBER(serialized_info_cache_);
 
@@ -578,6 +584,7 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(skip_load_params_);
 
   CP_MEMBER(use_new_executor_);
+  CP_MEMBER(auto_multi_stream_num_);
 
   if (use_gpu_) {
     PADDLE_ENFORCE_EQ(use_xpu_,
@@ -876,6 +883,25 @@ void AnalysisConfig::SetTensorRtOptimizationLevel(int level) {
   trt_optimization_level_ = level;
 }
 
+void AnalysisConfig::SetTensorRtShapeProfileNum(int num) {
+  PADDLE_ENFORCE_GE(num,
+                    1,
+                    platform::errors::InvalidArgument(
+                        "The number of TensorRT shape profiles should be "
+                        "at least 1, but received %d.",
+                        num));
+  trt_shape_profile_num_ = num;
+}
+
+void AnalysisConfig::EnableTensorRtEngineStore(const std::string &store_dir) {
+  PADDLE_ENFORCE_EQ(store_dir.empty(),
+                    false,
+                    platform::errors::InvalidArgument(
+                        "The store directory of TensorRT engines should not "
+                        "be empty."));
+  trt_engine_store_dir_ = store_dir;
+}
+
 // TODO(Superjomn) refactor this, buggy.
 void AnalysisConfig::Update() {
   auto &&info = SerializeInfoCache();
@@ -1104,6 +1130,8 @@ std::string AnalysisConfig::SerializeInfoCache() {
   ss << prog_file_;
   ss << params_file_;
   ss << save_optimized_model_;
+  ss << mmap_params_;
+  ss << pir_program_cache_;
 
   ss << use_gpu_;
   ss << enable_gpu_mixed_;
@@ -1130,6 +1158,8 @@ std::string AnalysisConfig::SerializeInfoCache() {
 
   ss << enable_memory_optim_;
   ss << trt_engine_memory_sharing_;
+  ss << trt_engine_store_dir_;
+  ss << trt_shape_profile_num_;
 
   ss << use_mkldnn_;
   ss << mkldnn_cache_capacity_;
@@ -1326,6 +1356,8 @@ std::string AnalysisConfig::Summary() {
   // cpu info
   os.InsertRow(
       {"cpu_math_thread", std::to_string(cpu_math_library_num_threads_)});
+  os.InsertRow({"numa_node", std::to_string(numa_node_)});
+  os.InsertRow({"intra_op_num_threads", std::to_string(intra_op_num_threads_)});
   os.InsertRow({"enable_mkldnn", use_mkldnn_ ? "true" : "false"});
   os.InsertRow(
       {"mkldnn_cache_capacity", std::to_string(mkldnn_cache_capacity_)});
@@ -1345,6 +1377,8 @@ std::string AnalysisConfig::Summary() {
         {"use_external_stream", use_external_stream_ ? "true" : "false"});
     os.InsertRow(
         {"thread_local_stream", thread_local_stream_ ? "true" : "false"});
+    os.InsertRow(
+        {"auto_multi_stream_num", std::to_string(auto_multi_stream_num_)});
 
     os.InsertRow({"use_tensorrt", use_tensorrt_ ? "true" : "false"});
     if (use_tensorrt_) {
@@ -1400,6 +1434,13 @@ std::string AnalysisConfig::Summary() {
       os.InsertRow({"trt_engine_memory_sharing",
                     trt_engine_memory_sharing_ ? "true" : "false"});
       os.InsertRow({"trt_mark_output", trt_mark_output_ ? "true" : "false"});
+      if (trt_shape_profile_num_ > 1) {
+        os.InsertRow({"trt_shape_profile_num",
+                      std::to_string(trt_shape_profile_num_)});
+      }
+      if (!trt_engine_store_dir_.empty()) {
+        os.InsertRow({"trt_engine_store_dir", trt_engine_store_dir_});
+      }
 #endif
     }
   }
@@ -1470,6 +1511,8 @@ std::string AnalysisConfig::Summary() {
   os.InsertRow(
       {"save_optimized_model", save_optimized_model_ ? "true" : "false"});
   os.InsertRow({"ir_optim", enable_ir_optim_ ? "true" : "false"});
+  os.InsertRow({"mmap_params", mmap_params_ ? "true" : "false"});
+  os.InsertRow({"pir_program_cache", pir_program_cache_ ? "true" : "false"});
   os.InsertRow({"ir_debug", ir_debug_ ? "true" : "false"});
   os.InsertRow({"memory_optim", enable_memory_optim_ ? "true" : "false"});
   os.InsertRow({"enable_profile", with_profile_ ? "true" : "false"});
@@ -17,10 +17,15 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
 #include <cstdlib>
+#include <exception>
 #include <fstream>
+#include <functional>
 #include <memory>
 #include <set>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -47,6 +52,7 @@
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
 #include "paddle/fluid/inference/api/paddle_inference_pass.h"
 #include "paddle/fluid/inference/api/resource_manager.h"
+#include "paddle/fluid/inference/io.h"
 #include "paddle/fluid/inference/utils/io_utils.h"
 #include "paddle/fluid/inference/utils/model_utils.h"
 #include "paddle/fluid/inference/utils/singleton.h"
@@ -60,6 +66,8 @@
 #include "paddle/fluid/primitive/base/decomp_trans.h"
 #include "paddle/phi/api/include/context_pool.h"
 #include "paddle/phi/api/include/tensor.h"
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/backends/cpu/intra_op_thread_pool.h"
 #include "paddle/phi/common/backend.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/common/place.h"
@@ -106,6 +114,7 @@
 #endif
 
 #include "paddle/fluid/ir_adaptor/translator/translate.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
 #include "paddle/fluid/pir/transforms/constant_folding_pass.h"
 #include "paddle/fluid/pir/transforms/dead_code_elimination_pass.h"
 #include "paddle/fluid/pir/transforms/fusion/conv2d_add_act_fuse_pass.h"
@@ -123,11 +132,15 @@
 #include "paddle/fluid/pir/transforms/params_sync_among_devices_pass.h"
 #include "paddle/fluid/pir/transforms/pd_op_to_kernel_pass.h"
 #include "paddle/fluid/pir/transforms/replace_fetch_with_shadow_output_pass.h"
+#include "paddle/fluid/pir/transforms/transfer_layout_pass.h"
 #include "paddle/phi/core/flags.h"
+#include "paddle/pir/core/builtin_op.h"
 #include "paddle/pir/pass/pass_manager.h"
 
 PHI_DECLARE_bool(enable_pir_in_executor);
 PHI_DECLARE_bool(pir_apply_inplace_pass);
+PHI_DECLARE_bool(inference_freeze_param_scope);
+PHI_DECLARE_bool(inference_memory_offset_plan);
 
 namespace paddle {
 namespace {
@@ -359,6 +372,19 @@ bool PaddleTensorToDenseTensor(const PaddleTensor &pt,
   t->set_lod(lod);
   return true;
 }
+
+// Binds the calling thread to the numa node of the config before the math
+// library creates its threads, which inherit the cpus of the thread.
+void BindThreadToNumaNode(const AnalysisConfig &config) {
+  if (config.numa_node() < 0 ||
+      phi::backends::cpu::CurrentThreadNumaNode() == config.numa_node()) {
+    return;
+  }
+  if (!phi::backends::cpu::BindCurrentThreadToNumaNode(config.numa_node())) {
+    LOG_FIRST_N(WARNING, 1) << "Failed to bind the predictor to numa node "
+                            << config.numa_node();
+  }
+}
 }  // namespace
 
 AnalysisPredictor::AnalysisPredictor(const AnalysisConfig &config)
@@ -412,6 +438,12 @@ bool AnalysisPredictor::Init(
   }
 
   // no matter with or without MKLDNN
+  BindThreadToNumaNode(config_);
+  if (config_.intra_op_num_threads() > 0 && !intra_op_thread_pool_) {
+    intra_op_thread_pool_ = std::make_unique<phi::IntraOpThreadPool>(
+        config_.intra_op_num_threads(), config_.numa_node());
+  }
+  phi::IntraOpThreadPool::SetCurrent(intra_op_thread_pool_.get());
   paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
 
   if (!PrepareScope(parent_scope)) {
@@ -472,6 +504,12 @@ bool AnalysisPredictor::Init(
   }
 #endif
 
+  // The clones share the parameter scope, and frozen, their lookups of the
+  // parameters take no lock.
+  if (!status_is_cloned_ && FLAGS_inference_freeze_param_scope) {
+    scope_->Freeze();
+  }
+
   inference::DisplayMemoryInfo(place_, "Init predictor");
   return true;
 }
@@ -700,7 +738,15 @@ bool AnalysisPredictor::PrepareProgram(
     // not be executed.
     model_precision_ =
         paddle::inference::GetModelPrecision(*inference_program_);
-    OptimizeInferenceProgram();
+    pir_program_cache_prefix_ = GetPirProgramCachePrefix();
+    if (!pir_program_cache_prefix_.empty() && LoadPirProgramCache()) {
+      // The cached pir program is optimized, all the analysis passes are
+      // skipped.
+      pir_program_cache_hit_ = true;
+      config_.PartiallyRelease();
+    } else {
+      OptimizeInferenceProgram();
+    }
   } else {
     // If the program is passed from external, no need to optimize it, this
     // logic is used in the clone scenario.
@@ -781,13 +827,28 @@ bool AnalysisPredictor::PrepareExecutor() {
     framework::interpreter::ExecutionConfig execution_config;
     execution_config.create_local_scope = false;
     execution_config.used_for_inference = true;
+    if ((config_.use_gpu() || config_.use_xpu()) &&
+        config_.auto_multi_stream_num() > 1) {
+      execution_config.auto_stream_num =
+          static_cast<size_t>(config_.auto_multi_stream_num());
+    }
     auto input_names = GetInputNames();
     execution_config.skip_gc_vars.insert(input_names.begin(),
                                          input_names.end());
     auto output_names = GetOutputNames();
     execution_config.skip_gc_vars.insert(output_names.begin(),
                                          output_names.end());
-    if (FLAGS_enable_pir_in_executor) {
+    if (FLAGS_enable_pir_in_executor && pir_program_cache_hit_) {
+      // The params of the cache are loaded on cpu.
+      ::pir::PassManager sync_pm(::pir::IrContext::Instance(), 2);
+      auto params_sync_among_devices_pass =
+          ::pir::CreateParamsSyncAmongDevicesPass();
+      params_sync_among_devices_pass->SetNotOwned(pir::kPlaceAttr, &place_);
+      params_sync_among_devices_pass->SetNotOwned(pir::kParamScopeAttr,
+                                                  sub_scope_);
+      sync_pm.AddPass(std::move(params_sync_among_devices_pass));
+      sync_pm.Run(pir_program_.get());
+    } else if (FLAGS_enable_pir_in_executor) {
       pir_program_ = std::move(
           paddle::TranslateLegacyProgramToProgram(*inference_program_));
 
@@ -818,6 +879,11 @@ bool AnalysisPredictor::PrepareExecutor() {
         gpu_pm.AddPass(::pir::CreateMatmulScaleFusePass());
         //----------------------------------------------------------------------------------------------//
 
+        //----------------------------------------------------------------------------------------------//
+        // Layout pass, the transposes of the params are folded later
+        gpu_pm.AddPass(::pir::CreateTransferLayoutPass());
+        //----------------------------------------------------------------------------------------------//
+
         //----------------------------------------------------------------------------------------------//
         // Basic pass required by the framework
         auto params_sync_among_devices_pass =
@@ -884,6 +950,12 @@ bool AnalysisPredictor::PrepareExecutor() {
         cpu_pm.Run(pir_program_.get());
       }
 
+      if (!pir_program_cache_prefix_.empty()) {
+        SavePirProgramCache();
+      }
+    }
+
+    if (FLAGS_enable_pir_in_executor) {
       pir_program_ = std::move(
           paddle::dialect::PdOpLowerToKernelPass(pir_program_.get(), place_));
 
@@ -909,13 +981,25 @@ bool AnalysisPredictor::PrepareExecutor() {
     }
   }
 
-  if (config_.enable_memory_optim_) {
+  // The reuse table is made by the memory_optimize_pass, which is skipped by
+  // a hit of the pir program cache.
+  if (config_.enable_memory_optim_ && !pir_program_cache_hit_) {
     auto *pass_res_info =
         inference::analysis::PassResultInfoForRuntime::Instance();
-    auto reuse_table =
-        pass_res_info->Get<std::unordered_map<std::string, std::string>>(
-            root_predictor_id_, "memory_optimize_pass");
-    executor_->MakeReusePlan(reuse_table);
+    // The offsets are placed by the naive executor, the new executor frees
+    // the tensors by its own gc.
+    if (FLAGS_inference_memory_offset_plan &&
+        !config_.new_executor_enabled()) {
+      auto offset_table = pass_res_info->Get<
+          std::unordered_map<std::string, std::pair<size_t, size_t>>>(
+          root_predictor_id_, "memory_optimize_pass_offsets");
+      executor_->MakeOffsetReusePlan(offset_table);
+    } else {
+      auto reuse_table =
+          pass_res_info->Get<std::unordered_map<std::string, std::string>>(
+              root_predictor_id_, "memory_optimize_pass");
+      executor_->MakeReusePlan(reuse_table);
+    }
   }
 
   return true;
@@ -1280,6 +1364,8 @@ void AnalysisPredictor::MkldnnPostReset() {
 bool AnalysisPredictor::Run(const std::vector<PaddleTensor> &inputs,
                             std::vector<PaddleTensor> *output_data,
                             int batch_size) {
+  BindThreadToNumaNode(config_);
+  phi::IntraOpThreadPool::SetCurrent(intra_op_thread_pool_.get());
   paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
 #ifdef PADDLE_WITH_DNNL
   if (config_.use_mkldnn_) MkldnnPreSet(inputs);
@@ -1353,6 +1439,8 @@ bool AnalysisPredictor::Run(const std::vector<paddle::Tensor> &inputs,
   if (private_context_) {
     paddle::platform::DeviceContextPool::SetDeviceContexts(&device_contexts_);
   }
+  BindThreadToNumaNode(config_);
+  phi::IntraOpThreadPool::SetCurrent(intra_op_thread_pool_.get());
   paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
 #ifdef PADDLE_WITH_DNNL
   if (config_.use_mkldnn_) MkldnnPreSet(inputs);
@@ -1582,6 +1670,7 @@ void AnalysisPredictor::PrepareArgument() {
   argument_->SetEnableIrOptim(config_.enable_ir_optim_);
   argument_->SetEnableMemoryOptim(config_.enable_memory_optim());
   argument_->SetModelFromMemory(config_.model_from_memory_);
+  argument_->SetMmapParams(config_.mmap_params_);
   // Analyze inference_program
   argument_->SetPredictorID(predictor_id_);
   argument_->SetRootPredictorID(root_predictor_id_);
@@ -1637,6 +1726,8 @@ void AnalysisPredictor::PrepareArgument() {
         config_.trt_use_explicit_quantization_);
     argument_->SetTrtEngineMemorySharing(config_.trt_engine_memory_sharing());
     argument_->SetTensorRtOptimizationLevel(config_.trt_optimization_level_);
+    argument_->SetTensorRtEngineStoreDir(config_.trt_engine_store_dir_);
+    argument_->SetTensorRtShapeProfileNum(config_.trt_shape_profile_num_);
     argument_->SetTensorRtOpsRunFloat(config_.trt_ops_run_float_);
   }
 
@@ -1853,6 +1944,18 @@ void AnalysisPredictor::PrepareArgument() {
     LOG(INFO) << "This model run in Custom Device mixed precision mode.";
   }
 
+  // the row parallel linears are fused before the passes remapping matmul_v2,
+  // the engines of tensorrt can not overlap with the communication
+  if (config_.dist_config().comm_overlap_enabled() && config_.use_gpu() &&
+      config_.ir_optim() && !config_.tensorrt_engine_enabled()) {
+    argument_->SetCommOverlapChunks(
+        config_.dist_config().comm_overlap_chunks());
+    if (pass_builder->GetPassIndex("matmul_allreduce_fuse_pass") ==
+        static_cast<size_t>(-1)) {
+      pass_builder->InsertPass(0, "matmul_allreduce_fuse_pass");
+    }
+  }
+
   argument_->SetDisableLogs(config_.glog_info_disabled());
   argument_->SetIrAnalysisPasses(pass_builder->AllPasses());
   argument_->SetAnalysisPasses(pass_builder->AnalysisPasses());
@@ -2329,6 +2432,8 @@ bool AnalysisPredictor::ZeroCopyRun(bool switch_stream) {
   if (private_context_) {
     paddle::platform::DeviceContextPool::SetDeviceContexts(&device_contexts_);
   }
+  BindThreadToNumaNode(config_);
+  phi::IntraOpThreadPool::SetCurrent(intra_op_thread_pool_.get());
   paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
 #ifdef PADDLE_WITH_DNNL
   if (config_.use_mkldnn_) {
@@ -2376,14 +2481,35 @@ bool AnalysisPredictor::ZeroCopyRun(bool switch_stream) {
                              config_.xpu_config_.l3_ptr,
                              config_.xpu_config_.l3_autotune_size,
                              place_);
+    if (config_.xpu_config_.l3_autotune_size > 0) {
+      // The reads of the inputs of the ops are the lifetimes of the L3
+      // blocks of the autotune.
+      std::call_once(register_xpu_l3_hook_flag_, [this, infer_xpu_ctx] {
+        executor_->RegisterInputHook([infer_xpu_ctx](
+                                         framework::OperatorBase *op,
+                                         framework::Scope *scope) {
+          if (!infer_xpu_ctx->IsL3Recording()) return;
+          for (auto &input : op->Inputs()) {
+            for (auto &var_name : input.second) {
+              auto *var = scope->FindVar(var_name);
+              if (!var || !var->IsType<phi::DenseTensor>()) continue;
+              auto &holder = var->Get<phi::DenseTensor>().Holder();
+              if (holder) infer_xpu_ctx->RecordL3Use(holder.get());
+            }
+          }
+        });
+      });
+    }
   }
 #endif
 
+  if (!bound_buffers_.empty()) PrepareBoundBuffers();
   if (config_.new_executor_enabled()) {
     executor_->RunInterpreterCore({}, false, switch_stream);
   } else {
     executor_->Run();
   }
+  if (!bound_buffers_.empty()) FillBoundOutputs();
   inference::DisplayMemoryInfo(place_, "after run");
 
 #ifdef PADDLE_WITH_XPU
@@ -2581,6 +2707,59 @@ bool AnalysisPredictor::ExpRunWithRuntimeConfig(void *config) {
   return false;
 }
 
+void AnalysisPredictor::CopyKVCacheBlocks(
+    const std::vector<std::string> &cache_names,
+    const std::vector<std::pair<int, int>> &copies) {
+  if (copies.empty()) return;
+  framework::Scope *scope = executor_->GetScope();
+  for (auto &name : cache_names) {
+    auto *var = scope->FindVar(name);
+    PADDLE_ENFORCE_NOT_NULL(
+        var,
+        platform::errors::PreconditionNotMet(
+            "The KV cache named %s is not found in the scope of the executor.",
+            name));
+    auto *cache = var->GetMutable<phi::DenseTensor>();
+    PADDLE_ENFORCE_EQ(
+        cache->initialized() && cache->dims().size() > 0,
+        true,
+        platform::errors::PreconditionNotMet(
+            "The KV cache named %s should be fed before its blocks are copied.",
+            name));
+    int64_t block_num = cache->dims()[0];
+    size_t block_bytes =
+        cache->numel() / block_num * phi::SizeOf(cache->dtype());
+    auto *data = static_cast<uint8_t *>(cache->data());
+    for (auto &copy : copies) {
+      PADDLE_ENFORCE_EQ(
+          copy.first >= 0 && copy.first < block_num && copy.second >= 0 &&
+              copy.second < block_num,
+          true,
+          platform::errors::OutOfRange(
+              "The block copy (%d -> %d) is out of the (%d) blocks of the KV "
+              "cache named %s.",
+              copy.first,
+              copy.second,
+              block_num,
+              name));
+      void *dst = data + block_bytes * copy.second;
+      const void *src = data + block_bytes * copy.first;
+      if (platform::is_gpu_place(cache->place())) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+        memory::Copy(cache->place(),
+                     dst,
+                     cache->place(),
+                     src,
+                     block_bytes,
+                     static_cast<gpuStream_t>(GetExecStream()));
+#endif
+      } else {
+        memory::Copy(cache->place(), dst, cache->place(), src, block_bytes);
+      }
+    }
+  }
+}
+
 void AnalysisPredictor::StatisticShapeRangeInfo() {
   std::map<std::string, std::vector<int32_t>> min_shapes;
   std::map<std::string, std::vector<int32_t>> max_shapes;
@@ -2691,6 +2870,128 @@ bool AnalysisPredictor::LoadProgramDesc() {
   return true;
 }
 
+std::string AnalysisPredictor::GetPirProgramCachePrefix() {
+  if (!config_.pir_program_cache_enabled() ||
+      !config_.new_executor_enabled() || !FLAGS_enable_pir_in_executor ||
+      config_.model_from_memory()) {
+    return "";
+  }
+  std::stringstream key;
+  key << inference_program_->Proto()->SerializeAsString();
+  key << config_.SerializeInfoCache();
+  key << place_;
+  key << paddle::prim::PrimCommonUtils::IsFwdPrimEnabled();
+  // The params are keyed by the size and the modified time of their file, or
+  // of the model directory for the separated params.
+  const std::string &params_path = config_.params_file().empty()
+                                       ? config_.model_dir()
+                                       : config_.params_file();
+  struct stat params_stat;
+  if (stat(params_path.c_str(), &params_stat) == 0) {
+    key << params_stat.st_size << params_stat.st_mtime;
+  }
+
+  std::string cache_dir = config_.opt_cache_dir_;
+  if (cache_dir.empty()) {
+    cache_dir = inference::analysis::GetOrCreateModelOptCacheDir(
+        config_.model_dir().empty()
+            ? inference::analysis::GetDirRoot(config_.prog_file())
+            : config_.model_dir());
+  } else {
+    inference::analysis::MakeDirIfNotExists(cache_dir);
+  }
+  return cache_dir + "/pir_program_" +
+         std::to_string(std::hash<std::string>()(key.str()));
+}
+
+bool AnalysisPredictor::LoadPirProgramCache() {
+  const std::string program_path = pir_program_cache_prefix_ + ".pir";
+  const std::string params_path = pir_program_cache_prefix_ + ".pdiparams";
+  if (!inference::analysis::FileExists(program_path) ||
+      !inference::analysis::FileExists(params_path)) {
+    return false;
+  }
+  try {
+    auto *ctx = pir::IrContext::Instance();
+    ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+    std::ifstream program_file(program_path);
+    auto program = pir::Program::Parse(program_file, ctx);
+
+    std::ifstream params_file(params_path, std::ios::binary);
+    uint64_t num_params = 0;
+    params_file.read(reinterpret_cast<char *>(&num_params), sizeof(uint64_t));
+    for (uint64_t i = 0; i < num_params; ++i) {
+      uint64_t name_size = 0;
+      params_file.read(reinterpret_cast<char *>(&name_size), sizeof(uint64_t));
+      std::string name(name_size, '\0');
+      params_file.read(&name[0], static_cast<std::streamsize>(name_size));
+      auto *var = sub_scope_->FindVar(name);
+      if (var == nullptr) var = sub_scope_->Var(name);
+      framework::DeserializeFromStream(params_file,
+                                       var->GetMutable<phi::DenseTensor>());
+    }
+    PADDLE_ENFORCE_EQ(
+        static_cast<bool>(params_file),
+        true,
+        platform::errors::InvalidArgument("The params file %s is truncated.",
+                                          params_path));
+    pir_program_ = std::move(program);
+  } catch (std::exception &e) {
+    LOG(WARNING) << "Failed to load the pir program cache "
+                 << pir_program_cache_prefix_ << ", it is rebuilt. "
+                 << e.what();
+    return false;
+  }
+  LOG(INFO) << "Load the optimized pir program from " << program_path;
+  return true;
+}
+
+void AnalysisPredictor::SavePirProgramCache() {
+  std::vector<std::string> param_names;
+  for (auto &op : *pir_program_->block()) {
+    if (op.isa<pir::ParameterOp>()) {
+      param_names.push_back(op.dyn_cast<pir::ParameterOp>().param_name());
+    }
+  }
+  // The files are renamed at last, so that a predictor never reads a
+  // partial cache.
+  const std::string program_path = pir_program_cache_prefix_ + ".pir";
+  const std::string params_path = pir_program_cache_prefix_ + ".pdiparams";
+  {
+    std::ofstream params_file(params_path + ".tmp", std::ios::binary);
+    uint64_t num_params = param_names.size();
+    params_file.write(reinterpret_cast<const char *>(&num_params),
+                      sizeof(uint64_t));
+    for (const auto &name : param_names) {
+      auto *var = sub_scope_->FindVar(name);
+      if (var == nullptr || !var->IsType<phi::DenseTensor>()) {
+        LOG(WARNING) << "The parameter " << name << " is not a DenseTensor, "
+                     << "the pir program is not cached.";
+        params_file.close();
+        std::remove((params_path + ".tmp").c_str());
+        return;
+      }
+      uint64_t name_size = name.size();
+      params_file.write(reinterpret_cast<const char *>(&name_size),
+                        sizeof(uint64_t));
+      params_file.write(name.data(), static_cast<std::streamsize>(name_size));
+      framework::SerializeToStream(params_file, var->Get<phi::DenseTensor>());
+    }
+  }
+  {
+    std::ofstream program_file(program_path + ".tmp");
+    pir_program_->Print(program_file);
+  }
+  if (std::rename((params_path + ".tmp").c_str(), params_path.c_str()) != 0 ||
+      std::rename((program_path + ".tmp").c_str(), program_path.c_str()) !=
+          0) {
+    LOG(WARNING) << "Failed to save the pir program cache "
+                 << pir_program_cache_prefix_;
+    return;
+  }
+  LOG(INFO) << "Save the optimized pir program to " << program_path;
+}
+
 bool AnalysisPredictor::LoadParameters() {
   PADDLE_ENFORCE_NOT_NULL(inference_program_.get(),
                           platform::errors::PreconditionNotMet(
@@ -2732,6 +3033,19 @@ bool AnalysisPredictor::LoadParameters() {
   if (!config_.params_file().empty()) {
     // sort paramlist to have consistent ordering
     std::sort(params.begin(), params.end());
+    if (config_.mmap_params_ && platform::is_cpu_place(place_) &&
+        std::all_of(params.begin(),
+                    params.end(),
+                    [&load_block](const std::string &name) {
+                      return load_block->FindVar(name)->GetType() ==
+                             framework::proto::VarType::LOD_TENSOR;
+                    }) &&
+        inference::LoadCombinedParamsByMmap(
+            scope_.get(), params, config_.params_file())) {
+      VLOG(3) << "get " << scope_->LocalVarNames().size()
+              << " vars after load";
+      return true;
+    }
     // append just the load_combine op
     framework::OpDesc *op = load_block->AppendOp();
     op->SetType("load_combine");
@@ -3004,6 +3318,133 @@ void AnalysisPredictor::RegisterOutputHook(
   output_hookfuncs_.push_back(hookfunc);
 }
 
+void AnalysisPredictor::BindBuffer(const std::string &name,
+                                   void *data,
+                                   size_t bytes,
+                                   PaddlePlace place,
+                                   CallbackFunc cb,
+                                   void *cb_params) {
+  bool is_input = feed_names_.count(name) > 0;
+  bool is_output = false;
+  for (auto &item : idx2fetches_) {
+    is_output = is_output || item.second == name;
+  }
+  PADDLE_ENFORCE_EQ(
+      is_input || is_output,
+      true,
+      platform::errors::NotFound(
+          "The buffer is bound to %s, which is neither an input nor an "
+          "output of the predictor.",
+          name));
+  phi::Place buffer_place;
+  if (place == PaddlePlace::kCPU) {
+    buffer_place = platform::CPUPlace();
+  } else if (place == PaddlePlace::kGPU && platform::is_gpu_place(place_)) {
+    buffer_place = place_;
+  } else {
+    PADDLE_THROW(platform::errors::Unimplemented(
+        "Only the host buffers and the buffers on the device of the "
+        "predictor are bound."));
+  }
+  bound_buffers_[name] =
+      BoundBuffer{data, bytes, buffer_place, is_input, cb, cb_params};
+}
+
+void AnalysisPredictor::UnbindBuffer(const std::string &name) {
+  bound_buffers_.erase(name);
+}
+
+void AnalysisPredictor::PrepareBoundBuffers() {
+  auto *scope = executor_->GetScope();
+  for (auto &item : bound_buffers_) {
+    const auto &buffer = item.second;
+    auto *tensor = scope->Var(item.first)->GetMutable<phi::DenseTensor>();
+    phi::DataType dtype = tensor->dtype();
+    if (buffer.is_input) {
+      dtype = framework::TransToPhiDataType(
+          inference_program_->Block(0).FindVar(item.first)->GetDataType());
+      size_t size = tensor->numel() * phi::SizeOf(dtype);
+      PADDLE_ENFORCE_LE(size,
+                        buffer.bytes,
+                        platform::errors::InvalidArgument(
+                            "The input %s of shape [%s] needs %d bytes, more "
+                            "than its bound buffer of %d bytes.",
+                            item.first,
+                            tensor->dims(),
+                            size,
+                            buffer.bytes));
+    } else if (buffer.place != place_) {
+      // A host output is filled by a copy after the run.
+      continue;
+    }
+    if (tensor->Holder() && tensor->Holder()->ptr() == buffer.data &&
+        tensor->Holder()->size() == buffer.bytes) {
+      continue;
+    }
+    auto holder = std::make_shared<phi::Allocation>(
+        buffer.data, buffer.bytes, buffer.place);
+    if (buffer.is_input) {
+      tensor->ResetHolderWithType(holder, dtype);
+    } else if (tensor->numel() * phi::SizeOf(dtype) <= buffer.bytes) {
+      // The kernel writes the output in place if its Alloc fits the buffer.
+      tensor->ResetHolder(holder);
+    }
+  }
+}
+
+void AnalysisPredictor::FillBoundOutputs() {
+  auto *scope = executor_->GetScope();
+  void *stream = nullptr;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (platform::is_gpu_place(place_)) {
+    stream = static_cast<phi::GPUContext *>(
+                 platform::DeviceContextPool::Instance().Get(place_))
+                 ->stream();
+  }
+#endif
+  for (auto &item : bound_buffers_) {
+    const auto &buffer = item.second;
+    if (buffer.is_input) continue;
+    const auto &tensor = scope->FindVar(item.first)->Get<phi::DenseTensor>();
+    size_t size = tensor.numel() * phi::SizeOf(tensor.dtype());
+    PADDLE_ENFORCE_LE(size,
+                      buffer.bytes,
+                      platform::errors::InvalidArgument(
+                          "The output %s of shape [%s] needs %d bytes, more "
+                          "than its bound buffer of %d bytes.",
+                          item.first,
+                          tensor.dims(),
+                          size,
+                          buffer.bytes));
+    if (size > 0 && tensor.data() != buffer.data) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+      memory::Copy(buffer.place,
+                   buffer.data,
+                   tensor.place(),
+                   tensor.data(),
+                   size,
+                   stream);
+#else
+      memory::Copy(
+          buffer.place, buffer.data, tensor.place(), tensor.data(), size);
+#endif
+    }
+    if (buffer.cb == nullptr) continue;
+    if (stream == nullptr) {
+      buffer.cb(buffer.cb_params);
+      continue;
+    }
+#ifdef PADDLE_WITH_HIP
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        hipStreamSynchronize(static_cast<gpuStream_t>(stream)));
+    buffer.cb(buffer.cb_params);
+#elif defined(PADDLE_WITH_CUDA)
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaLaunchHostFunc(
+        static_cast<gpuStream_t>(stream), buffer.cb, buffer.cb_params));
+#endif
+  }
+}
+
 template <>
 std::unique_ptr<PaddlePredictor> CreatePaddlePredictor<AnalysisConfig>(
     const AnalysisConfig &config) {
@@ -3306,6 +3747,19 @@ void Predictor::RegisterInputHook(const OutputTensorHookFunc &hookfunc) {
   predictor_->RegisterInputHook(hookfunc);
 }
 
+void Predictor::BindBuffer(const std::string &name,
+                           void *data,
+                           size_t bytes,
+                           PlaceType place,
+                           CallbackFunc cb,
+                           void *cb_params) {
+  predictor_->BindBuffer(name, data, bytes, place, cb, cb_params);
+}
+
+void Predictor::UnbindBuffer(const std::string &name) {
+  predictor_->UnbindBuffer(name);
+}
+
 void *Predictor::GetExecStream() const { return predictor_->GetExecStream(); }
 
 int GetNumBytesOfDataType(DataType dtype) {
@@ -3377,7 +3831,9 @@ std::shared_ptr<Predictor> CreatePredictor(const Config &config) {  // NOLINT
 }
 
 namespace services {
-PredictorPool::PredictorPool(const Config &config, size_t size) {
+PredictorPool::PredictorPool(const Config &config,
+                             size_t size,
+                             bool share_trt_engine) {
   PADDLE_ENFORCE_GE(
       size,
       1UL,
@@ -3387,13 +3843,17 @@ PredictorPool::PredictorPool(const Config &config, size_t size) {
   Config copy_config(config);
   main_pred_ = std::make_unique<Predictor>(config);
   for (size_t i = 0; i < size - 1; i++) {
-    if (config.tensorrt_engine_enabled()) {
+    if (config.tensorrt_engine_enabled() && !share_trt_engine) {
       Config config_tmp(copy_config);
       preds_.emplace_back(new Predictor(config_tmp));
     } else {
       preds_.emplace_back(main_pred_->Clone());
     }
   }
+  stats_.resize(size);
+  for (size_t i = 0; i < size; ++i) {
+    idle_.push_back(i);
+  }
 }
 
 Predictor *PredictorPool::Retrieve(size_t idx) {
@@ -3409,6 +3869,58 @@ Predictor *PredictorPool::Retrieve(size_t idx) {
   }
   return preds_[idx - 1].get();
 }
+
+bool PredictorPool::Run(const std::function<bool(Predictor *)> &task) {
+  using Clock = std::chrono::steady_clock;
+  auto enqueue_time = Clock::now();
+  size_t idx = 0;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this] { return !idle_.empty(); });
+    // the most recently used predictor first, its buffers are warm
+    idx = idle_.back();
+    idle_.pop_back();
+  }
+  auto start_time = Clock::now();
+  bool ret = false;
+  std::exception_ptr eptr = nullptr;
+  try {
+    ret = task(Retrieve(idx));
+  } catch (...) {
+    eptr = std::current_exception();
+  }
+  auto end_time = Clock::now();
+  double queue_ms =
+      std::chrono::duration<double, std::milli>(start_time - enqueue_time)
+          .count();
+  double run_ms =
+      std::chrono::duration<double, std::milli>(end_time - start_time).count();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &stat = stats_[idx];
+    ++stat.run_num;
+    stat.total_queue_ms += queue_ms;
+    stat.max_queue_ms = std::max(stat.max_queue_ms, queue_ms);
+    stat.total_run_ms += run_ms;
+    stat.max_run_ms = std::max(stat.max_run_ms, run_ms);
+    idle_.push_back(idx);
+  }
+  idle_cv_.notify_one();
+  if (eptr) {
+    std::rethrow_exception(eptr);
+  }
+  return ret;
+}
+
+bool PredictorPool::Run(const std::vector<paddle::Tensor> &inputs,
+                        std::vector<paddle::Tensor> *outputs) {
+  return Run([&](Predictor *pred) { return pred->Run(inputs, outputs); });
+}
+
+std::vector<PredictorStat> PredictorPool::GetStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
 }  // namespace services
 
 namespace experimental {
@@ -3465,6 +3977,19 @@ void InternalUtils::DisableTensorRtHalfOps(
 #endif
 }
 
+void InternalUtils::CopyKVCacheBlocks(
+    paddle_infer::Predictor *p,
+    const std::vector<std::string> &cache_names,
+    const std::vector<std::pair<int, int>> &copies) {
+  auto *pred = dynamic_cast<paddle::AnalysisPredictor *>(p->predictor_.get());
+  pred->CopyKVCacheBlocks(cache_names, copies);
+}
+
+void InternalUtils::BindNumaNode(paddle_infer::Predictor *p, int numa_node) {
+  auto *pred = dynamic_cast<paddle::AnalysisPredictor *>(p->predictor_.get());
+  pred->config_.BindNumaNode(numa_node);
+}
+
 void InternalUtils::SyncStream(paddle_infer::Predictor *p) {
 #ifdef PADDLE_WITH_CUDA
   auto *pred = dynamic_cast<paddle::AnalysisPredictor *>(p->predictor_.get());
@@ -18,6 +18,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "paddle/fluid/framework/naive_executor.h"
@@ -40,6 +41,7 @@
 #include <gtest/gtest_prod.h>
 #endif
 
+#include "paddle/phi/backends/cpu/intra_op_thread_pool.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/pir/core/program.h"
@@ -220,6 +222,17 @@ class AnalysisPredictor : public PaddlePredictor {
   // Note: Can only be used under thread_local semantics.
   bool ExpRunWithRuntimeConfig(void *config);
 
+  ///
+  /// \brief Copy the blocks of the paged KV caches, the dim 0 of every cache
+  /// tensor is the block index. It is used by the copy-on-write blocks of
+  /// paddle_infer::services::KVBlockManager.
+  ///
+  /// \param cache_names The names of the cache inputs.
+  /// \param copies The (src, dst) block pairs.
+  ///
+  void CopyKVCacheBlocks(const std::vector<std::string> &cache_names,
+                         const std::vector<std::pair<int, int>> &copies);
+
   ///
   /// \brief Get the execution stream on devices with a concept of stream,
   /// otherwise returns nullptr.
@@ -320,6 +333,15 @@ class AnalysisPredictor : public PaddlePredictor {
   /// \brief Same as RegisterOutputHook
   void RegisterInputHook(const InputTensorHookFunc &hookfunc) override;
 
+  void BindBuffer(const std::string &name,
+                  void *data,
+                  size_t bytes,
+                  PaddlePlace place,
+                  CallbackFunc cb = nullptr,
+                  void *cb_params = nullptr) override;
+
+  void UnbindBuffer(const std::string &name) override;
+
   ///
   /// \brief Initialize mkldnn quantizer and execute mkldnn quantization pass
   ///
@@ -375,6 +397,24 @@ class AnalysisPredictor : public PaddlePredictor {
   /// \return Whether the function executed successfully
   ///
   bool LoadParameters();
+  ///
+  /// \brief The path prefix of the cached optimized pir program and its
+  /// params, keyed by the model, the config and the place.
+  ///
+  /// \return The prefix, or empty if the pir program cache is disabled
+  ///
+  std::string GetPirProgramCachePrefix();
+  ///
+  /// \brief Load the optimized pir program and its params from the cache.
+  ///
+  /// \return Whether the cache is hit
+  ///
+  bool LoadPirProgramCache();
+  ///
+  /// \brief Save the optimized pir program, before the kernels are
+  /// selected, and its params to the cache.
+  ///
+  void SavePirProgramCache();
 
   ///
   /// \brief Prepare input data, only used in Run()
@@ -554,6 +594,10 @@ class AnalysisPredictor : public PaddlePredictor {
   framework::Scope *sub_scope_{nullptr};
   std::shared_ptr<framework::ProgramDesc> inference_program_;
   std::shared_ptr<pir::Program> pir_program_;
+  std::string pir_program_cache_prefix_;
+  bool pir_program_cache_hit_{false};
+  // The pool of the parallel loops of the CPU kernels run by the predictor.
+  std::unique_ptr<phi::IntraOpThreadPool> intra_op_thread_pool_;
   std::vector<framework::OpDesc *> feeds_;
   std::map<std::string, size_t> feed_names_;
   // Sorted according to the idx.
@@ -586,9 +630,29 @@ class AnalysisPredictor : public PaddlePredictor {
 
  private:
   std::once_flag register_input_hook_flag_;
+#ifdef PADDLE_WITH_XPU
+  std::once_flag register_xpu_l3_hook_flag_;
+#endif
   std::once_flag register_output_hook_flag_;
   std::vector<OutputTensorHookFunc> output_hookfuncs_;
   std::vector<InputTensorHookFunc> input_hookfuncs_;
+
+  // The buffers of the users bound to the inputs and the outputs.
+  struct BoundBuffer {
+    void *data;
+    size_t bytes;
+    phi::Place place;
+    bool is_input;
+    CallbackFunc cb;
+    void *cb_params;
+  };
+  std::map<std::string, BoundBuffer> bound_buffers_;
+
+  // Points the inputs and the device outputs at their buffers, again in each
+  // run since the executor may have reallocated them.
+  void PrepareBoundBuffers();
+  // Fills the outputs that were not written in place into their buffers.
+  void FillBoundOutputs();
   // Some status here that help to determine the status inside the predictor.
   bool status_is_cloned_{false};
 
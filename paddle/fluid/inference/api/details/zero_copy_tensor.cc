@@ -14,6 +14,7 @@
 
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/data_layout_transform.h"
+#include "paddle/fluid/framework/dlpack_tensor.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/framework/string_array.h"
@@ -766,6 +767,30 @@ std::vector<std::vector<size_t>> Tensor::lod() const {
   return res;
 }
 
+void Tensor::FromDLPack(void *dl_managed_tensor) {
+  EAGER_GET_TENSOR(phi::DenseTensor);
+  paddle::framework::TensorFromDLPackNoCopy(
+      static_cast<DLManagedTensor *>(dl_managed_tensor), tensor);
+}
+
+void *Tensor::ToDLPack(void *exec_stream) const {
+  EAGER_GET_TENSOR(phi::DenseTensor);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (exec_stream != nullptr &&
+      paddle::platform::is_gpu_place(tensor->place())) {
+    auto *dev_ctxs = reinterpret_cast<const std::map<
+        phi::Place,
+        std::shared_future<std::unique_ptr<phi::DeviceContext>>> *>(
+        device_contexs_);
+    paddle::framework::DLPackWaitProducer(
+        {tensor},
+        reinterpret_cast<int64_t>(exec_stream),
+        dev_ctxs->at(tensor->place()).get().get());
+  }
+#endif
+  return paddle::framework::toDLPack(*tensor);
+}
+
 void Tensor::SetName(const std::string &name) { name_ = name; }
 
 const std::string &Tensor::name() const { return name_; }
@@ -49,4 +49,8 @@ std::vector<std::vector<size_t>> Tensor::lod() const {
   return std::vector<std::vector<size_t>>();
 }
 
+void Tensor::FromDLPack(void *dl_managed_tensor) {}
+
+void *Tensor::ToDLPack(void *exec_stream) const { return nullptr; }
+
 }  // namespace paddle_infer
@@ -58,6 +58,7 @@ void* InferXPUContext::Alloc(phi::TensorBase* tensor,
       l3_block = holder_l3_blocks_[holder];
     }
     l3_block->Record(size);
+    l3_block->RecordUse(++l3_step_);
     return data_ptr;
   } else if (l3_autotune_size_ > 0 && !holder_map_.empty()) {
     phi::Allocation* holder =
@@ -224,17 +225,38 @@ void InferXPUContext::SetFcAutotuneInfo(std::string fc_autotune_file,
   }
 }
 
+void InferXPUContext::RecordL3Use(phi::Allocation* holder) {
+  if (!IsL3Recording()) return;
+  auto iter = holder_l3_blocks_.find(holder);
+  if (iter != holder_l3_blocks_.end()) {
+    iter->second->RecordUse(++l3_step_);
+    l3_lifetime_recorded_ = true;
+  }
+}
+
 void InferXPUContext::L3CacheAutotune() {
   if (l3_autotune_size_ == 0) return;
   if (holder_map_.empty()) {
-    l3_plan_.RunAutotune(l3_blocks_, l3_size_);
+    // The blocks share L3 by their lifetimes if the reads are recorded,
+    // otherwise every block takes its own range.
+    if (l3_lifetime_recorded_) {
+      l3_plan_.RunLifetimeAutotune(l3_blocks_, l3_size_);
+    } else {
+      l3_plan_.RunAutotune(l3_blocks_, l3_size_);
+    }
     auto* plan = l3_plan_.plan();
+    auto* offsets = l3_plan_.offsets();
     int8_t* cur_l3_ptr = reinterpret_cast<int8_t*>(l3_ptr_);
     for (size_t i = 0; i < l3_blocks_.size(); i++) {
       size_t block_size = plan->at(i);
       if (block_size > 0) {
-        l3_blocks_[i]->Set(cur_l3_ptr, block_size);
-        cur_l3_ptr += block_size;
+        if (l3_lifetime_recorded_) {
+          l3_blocks_[i]->Set(
+              reinterpret_cast<int8_t*>(l3_ptr_) + offsets->at(i), block_size);
+        } else {
+          l3_blocks_[i]->Set(cur_l3_ptr, block_size);
+          cur_l3_ptr += block_size;
+        }
       }
     }
     x_context()->_l3_mgr.set(
@@ -67,6 +67,16 @@ class InferXPUContext : public phi::XPUContext {
                  size_t l3_autotune_size,
                  const phi::Place& place);
 
+  // Whether the sizes and the lifetimes of the L3 blocks are being recorded,
+  // in the first run with the L3 autotune.
+  bool IsL3Recording() const {
+    return l3_autotune_size_ > 0 && holder_map_.empty();
+  }
+
+  // Records a read of the holder by an op in the recording run, so that the
+  // L3 of the blocks whose lifetimes do not overlap is shared.
+  void RecordL3Use(phi::Allocation* holder);
+
   void L3CacheAutotune();
 
   void SetConvAutotuneInfo(std::string conv_autotune_file,
@@ -84,6 +94,9 @@ class InferXPUContext : public phi::XPUContext {
   void* l3_ptr_{nullptr};
   bool l3_owned_{false};
   size_t l3_autotune_size_{0};
+  // The steps of the allocations and the reads in the recording run.
+  mutable size_t l3_step_{0};
+  bool l3_lifetime_recorded_{false};
   mutable std::vector<phi::XPUL3CacheBlock*> l3_blocks_;
   mutable std::unordered_map<phi::Allocation*, phi::XPUL3CacheBlock*>
       holder_l3_blocks_;
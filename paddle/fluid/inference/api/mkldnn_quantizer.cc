@@ -131,7 +131,8 @@ void AnalysisPredictor::MkldnnQuantizer::CalculateScalesForOpOutputs(
       } else if (op->Type() == "transpose2" ||
                  op->Type() == "fused_transpose" || op->Type() == "reshape2" ||
                  op->Type() == "pool2d" || op->Type() == "nearest_interp" ||
-                 op->Type() == "nearest_interp_v2" || op->Type() == "split") {
+                 op->Type() == "nearest_interp_v2" || op->Type() == "split" ||
+                 op->Type() == "leaky_relu") {
         auto input_var_name = op->Input("X")[0];
         PADDLE_ENFORCE_NE(scales_.find(input_var_name),
                           scales_.end(),
@@ -59,6 +59,12 @@ MkldnnQuantizerConfig::MkldnnQuantizerConfig() {
   rules_["split"]["X"] = ScaleAlgo::KL;
   rules_["split"]["Out"] = ScaleAlgo::NONE;
 
+  // The output of relu is unsigned, and leaky_relu keeps the input scale.
+  rules_["relu"]["X"] = ScaleAlgo::KL;
+  rules_["relu"]["Out"] = ScaleAlgo::KL;
+  rules_["leaky_relu"]["X"] = ScaleAlgo::KL;
+  rules_["leaky_relu"]["Out"] = ScaleAlgo::NONE;
+
   rules_["fc"]["Input"] = ScaleAlgo::KL;
   rules_["fc"]["W"] = ScaleAlgo::MAX_CH_T;
   rules_["fc"]["Bias"] = ScaleAlgo::NONE;
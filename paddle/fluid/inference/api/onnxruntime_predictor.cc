@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <utility>
@@ -37,6 +38,9 @@
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #include "paddle/fluid/platform/place.h"
 #include "paddle/fluid/platform/profiler.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_bool(ort_share_allocators);
 
 namespace paddle {
 
@@ -86,6 +90,21 @@ bool CheckConvertToONNX(const AnalysisConfig &config) {
   }
 }
 
+std::shared_ptr<Ort::Env> ONNXRuntimePredictor::SharedEnv() {
+  static std::once_flag once;
+  static std::shared_ptr<Ort::Env> env;
+  std::call_once(once, [] {
+    env = std::make_shared<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "paddle-ort");
+    if (FLAGS_ort_share_allocators) {
+      Ort::MemoryInfo memory_info(
+          "Cpu", OrtArenaAllocator, 0, OrtMemTypeDefault);
+      Ort::ArenaCfg arena_cfg(0, -1, -1, -1);
+      env->CreateAndRegisterAllocator(memory_info, arena_cfg);
+    }
+  });
+  return env;
+}
+
 bool ONNXRuntimePredictor::InitBinding() {
   // Now ONNXRuntime only support CPU
   const char *device_name = config_.use_gpu() ? "Cuda" : "Cpu";
@@ -97,6 +116,7 @@ bool ONNXRuntimePredictor::InitBinding() {
   scope_.reset(new paddle::framework::Scope());
 
   binding_ = std::make_shared<Ort::IoBinding>(*session_);
+  bound_inputs_.clear();
   Ort::MemoryInfo memory_info(
       device_name, OrtDeviceAllocator, place_.GetDeviceId(), OrtMemTypeDefault);
   Ort::Allocator allocator(*session_, memory_info);
@@ -170,6 +190,9 @@ bool ONNXRuntimePredictor::Init() {
   // session_options.EnableMemPattern();
   // session_options.SetInterOpNumThreads(config_.cpu_math_library_num_threads());
   session_options.SetIntraOpNumThreads(config_.cpu_math_library_num_threads());
+  if (FLAGS_ort_share_allocators) {
+    session_options.AddConfigEntry("session.use_env_allocators", "1");
+  }
   VLOG(2) << "ONNXRuntime threads " << config_.cpu_math_library_num_threads();
   if (config_.profile_enabled()) {
     LOG(WARNING) << "ONNXRuntime Profiler is activated, which might affect the "
@@ -336,11 +359,19 @@ bool ONNXRuntimePredictor::Run(const std::vector<PaddleTensor> &inputs,
 bool ONNXRuntimePredictor::ZeroCopyRun(bool switch_stream) {
   try {
     const char *device_name = platform::is_cpu_place(place_) ? "Cpu" : "Cuda";
-    std::vector<Ort::Value> inputs;
-    inputs.reserve(input_desc_.size());
-    for (auto desc : input_desc_) {
-      inputs.push_back(GetOrtValue(desc, device_name));
-      binding_->BindInput(desc.name.c_str(), inputs.back());
+    // The bound values refer to the data of the input tensors, so an input
+    // is only rebound when it is reallocated or reshaped.
+    bound_inputs_.resize(input_desc_.size());
+    for (size_t i = 0; i < input_desc_.size(); ++i) {
+      const auto &desc = input_desc_[i];
+      auto *tensor = scope_->FindVar(desc.name)->GetMutable<phi::DenseTensor>();
+      std::pair<const void *, framework::DDim> bound(tensor->data(),
+                                                     tensor->dims());
+      if (bound_inputs_[i] == bound) {
+        continue;
+      }
+      binding_->BindInput(desc.name.c_str(), GetOrtValue(desc, device_name));
+      bound_inputs_[i] = bound;
     }
     for (auto output : output_desc_) {
       Ort::MemoryInfo out_memory_info(device_name,
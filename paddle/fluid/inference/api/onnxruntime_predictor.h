@@ -17,6 +17,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "onnxruntime_c_api.h"    // NOLINT
@@ -92,8 +93,7 @@ class ONNXRuntimePredictor : public PaddlePredictor {
   /// \param[in] AnalysisConfig config
   ///
   explicit ONNXRuntimePredictor(const AnalysisConfig &config)
-      : env_(std::make_shared<Ort::Env>(ORT_LOGGING_LEVEL_WARNING,
-                                        "paddle-ort")),
+      : env_(SharedEnv()),
         session_(nullptr),
         binding_(nullptr),
         config_(config) {
@@ -224,6 +224,12 @@ class ONNXRuntimePredictor : public PaddlePredictor {
   ///
   Ort::Value GetOrtValue(const ONNXDesc &desc, const char *device_name);
 
+  ///
+  /// \brief The Ort::Env shared by all the predictors in the process, on
+  /// which the CPU arena is registered once if FLAGS_ort_share_allocators.
+  ///
+  static std::shared_ptr<Ort::Env> SharedEnv();
+
  private:
   // ONNXRuntime
   std::shared_ptr<Ort::Env> env_;
@@ -235,6 +241,9 @@ class ONNXRuntimePredictor : public PaddlePredictor {
   platform::Place place_;
   std::vector<ONNXDesc> input_desc_;
   std::vector<ONNXDesc> output_desc_;
+  // The data and dims of the inputs bound to binding_, which are rebound only
+  // if changed.
+  std::vector<std::pair<const void *, framework::DDim>> bound_inputs_;
   int predictor_id_;
 
 // Some more detailed tests, they are made the friends of the predictor, so that
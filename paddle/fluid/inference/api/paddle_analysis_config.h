@@ -188,6 +188,22 @@ struct DistConfig {
 
   std::string carrier_id() const { return carrier_id_; }
 
+  ///
+  /// \brief Overlap the allreduce of the row parallel linears with their
+  /// matmuls. The rows of a matmul are split into num_chunks chunks, and the
+  /// allreduce of a chunk runs on the communication stream while the next
+  /// chunk is computed. GPU only, not applied to the TensorRT subgraphs.
+  ///
+  /// \param num_chunks The number of chunks a matmul is split into.
+  ///
+  void EnableCommOverlap(int num_chunks = 4) {
+    comm_overlap_chunks_ = num_chunks;
+  }
+
+  bool comm_overlap_enabled() const { return comm_overlap_chunks_ > 0; }
+
+  int comm_overlap_chunks() const { return comm_overlap_chunks_; }
+
  protected:
   // DistModel Inference related
   bool use_dist_model_{false};  // whether use DistModel or not
@@ -197,6 +213,7 @@ struct DistConfig {
   int64_t rank_{0};                 // rank
   std::string comm_init_config_{};  // converter config path
   std::string carrier_id_{"inference"};
+  int comm_overlap_chunks_{0};  // 0 disables the comm overlap
 };
 
 ///
@@ -291,6 +308,37 @@ struct PD_INFER_DECL AnalysisConfig {
     opt_cache_dir_ = opt_cache_dir;
   }
   ///
+  /// \brief Memory map the params file of a combined model, the cpu
+  /// parameters share the pages of the file with the other predictors on
+  /// the host, and are read from the file lazily.
+  ///
+  /// \param x whether to memory map the params file.
+  ///
+  void EnableMmapParams(bool x = true) { mmap_params_ = x; }
+  ///
+  /// \brief A boolean state telling whether the params file is memory
+  /// mapped.
+  ///
+  /// \return bool Whether the params file is memory mapped.
+  ///
+  bool mmap_params_enabled() const { return mmap_params_; }
+  ///
+  /// \brief Cache the optimized pir program and its params in the
+  /// optimization cache directory, keyed by the model, the config and the
+  /// place, so that the later predictors of the model skip the analysis
+  /// passes. It only takes effect with the pir executor.
+  ///
+  /// \param x whether to enable the pir program cache.
+  ///
+  void EnablePirProgramCache(bool x = true) { pir_program_cache_ = x; }
+  ///
+  /// \brief A boolean state telling whether the pir program cache is
+  /// enabled.
+  ///
+  /// \return bool Whether the pir program cache is enabled.
+  ///
+  bool pir_program_cache_enabled() const { return pir_program_cache_; }
+  ///
   /// \brief Get the model directory path.
   ///
   /// \return const std::string& The model directory path.
@@ -877,10 +925,66 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   int tensorrt_optimization_level() { return trt_optimization_level_; }
 
+  ///
+  /// \brief Split the dynamic shape range of TensorRT into nested profiles,
+  /// the k-th profile covers the first (k + 1) / num of the range from the min
+  /// shape. Every run picks the tightest profile for its input shapes, so the
+  /// short inputs of a wide range run with the tactics tuned for them. All
+  /// profiles of a predictor share one execution context and its device
+  /// memory.
+  ///
+  /// \param num The number of shape profiles.
+  ///
+  void SetTensorRtShapeProfileNum(int num);
+
+  ///
+  /// \brief The number of TensorRT shape profiles.
+  ///
+  /// \return int The number of shape profiles.
+  ///
+  int tensorrt_shape_profile_num() const { return trt_shape_profile_num_; }
+
+  ///
+  /// \brief Share the TensorRT engines and the TensorRT timing cache among the
+  /// processes of a host through a store directory. An engine is saved to the
+  /// store under a digest of its subgraph, weights, shape profile, precision
+  /// and GPU, and is loaded by any process building the same engine. The
+  /// tactics timed by the builders are merged into the timing cache of the
+  /// store, which speeds up building new engines. It takes precedence over
+  /// the serialized engines of use_static. The timing cache needs TensorRT
+  /// version >= 8.0.
+  ///
+  /// \param store_dir The store directory, it should exist.
+  ///
+  void EnableTensorRtEngineStore(const std::string& store_dir);
+
+  ///
+  /// \brief The store directory of TensorRT engines, empty if disabled.
+  ///
+  /// \return string The store directory.
+  ///
+  const std::string& tensorrt_engine_store_dir() const {
+    return trt_engine_store_dir_;
+  }
+
   void EnableNewExecutor(bool x = true) { use_new_executor_ = x; }
 
   bool new_executor_enabled() const { return use_new_executor_; }
 
+  ///
+  /// \brief Run the independent branches of the program on a pool of GPU or
+  /// XPU streams in the new executor, the branches are found and assigned to
+  /// the streams automatically, and joined by events.
+  ///
+  /// \param stream_num The number of the streams, including the stream of
+  /// the predictor.
+  ///
+  void EnableAutoMultiStream(int stream_num = 2) {
+    auto_multi_stream_num_ = stream_num;
+  }
+
+  int auto_multi_stream_num() const { return auto_multi_stream_num_; }
+
   void EnableDlnne(
       int min_subgraph_size = 3,
       int max_batch_size = 1,
@@ -972,6 +1076,42 @@ struct PD_INFER_DECL AnalysisConfig {
     return cpu_math_library_num_threads_;
   }
 
+  ///
+  /// \brief Bind the threads running the predictor, the math library threads
+  /// and the executor threads they create to the cpus of a numa node, and
+  /// prefer the memory of the node for their allocations. Give the clones
+  /// of a predictor different nodes to serve from every socket.
+  ///
+  /// \param numa_node The numa node, -1 to not bind.
+  ///
+  void BindNumaNode(int numa_node) { numa_node_ = numa_node; }
+  ///
+  /// \brief The numa node the predictor is bound to.
+  ///
+  /// \return int The numa node, -1 if the predictor is not bound.
+  ///
+  int numa_node() const { return numa_node_; }
+
+  ///
+  /// \brief Run the parallel loops of the CPU kernels of the predictor on a
+  /// pool of its own, instead of the threads of each kernel, so that the
+  /// concurrent predictors take a predictable number of cores. The kernels
+  /// without the intra op parallel loops keep using the math library
+  /// threads.
+  ///
+  /// \param num_threads The number of the threads of the pool, the thread
+  /// running the predictor included. 0 to not use the pool.
+  ///
+  void SetIntraOpNumThreads(int num_threads) {
+    intra_op_num_threads_ = num_threads;
+  }
+  ///
+  /// \brief The number of the threads of the intra op pool.
+  ///
+  /// \return int The number of the threads, 0 if the pool is not used.
+  ///
+  int intra_op_num_threads() const { return intra_op_num_threads_; }
+
   ///
   /// \brief Transform the AnalysisConfig to NativeConfig.
   ///
@@ -1279,6 +1419,8 @@ struct PD_INFER_DECL AnalysisConfig {
   bool trt_inspector_serialize_{false};
   bool trt_use_explicit_quantization_{false};
   int trt_optimization_level_{3};
+  std::string trt_engine_store_dir_;
+  int trt_shape_profile_num_{1};
 
   // In CollectShapeInfo mode, we will collect the shape information of
   // all intermediate tensors in the compute graph and calculate the
@@ -1317,10 +1459,13 @@ struct PD_INFER_DECL AnalysisConfig {
   bool ir_debug_{false};
 
   bool use_new_executor_{false};
+  int auto_multi_stream_num_{0};
 
   bool specify_input_name_{false};
 
   int cpu_math_library_num_threads_{1};
+  int numa_node_{-1};
+  int intra_op_num_threads_{0};
 
   bool with_profile_{false};
 
@@ -1402,6 +1547,8 @@ struct PD_INFER_DECL AnalysisConfig {
   mutable bool is_valid_{true};
   bool save_optimized_model_{false};
   std::string opt_cache_dir_;
+  bool mmap_params_{false};
+  bool pir_program_cache_{false};
   friend class paddle_infer::experimental::InternalUtils;
 
   // fleet exe related
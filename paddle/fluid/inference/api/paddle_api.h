@@ -27,6 +27,7 @@
 #include <memory>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "crypto/cipher.h"
@@ -329,6 +330,27 @@ class PD_INFER_DECL PaddlePredictor {
   /// \brief Same as RegisterOutputHook
   virtual void RegisterInputHook(const InputTensorHookFunc& hookfunc) {}
 
+  /// \brief Bind a buffer of the user to an input or an output over the runs.
+  /// ZeroCopyRun reads a bound input from the buffer and writes a bound
+  /// output into it, without CopyFromCpu or CopyToCpu.
+  /// \param name The name of the input or the output.
+  /// \param data The buffer, which outlives the binding.
+  /// \param bytes The size of the buffer.
+  /// \param place kGPU for a buffer on the device of the predictor, kCPU for
+  /// a host buffer. A host output is filled asynchronously on the predictor
+  /// stream, which is only overlapped if it is pinned.
+  /// \param cb Called on the host once a bound output is filled in a run.
+  /// \param cb_params The parameter of cb.
+  virtual void BindBuffer(const std::string& name,
+                          void* data,
+                          size_t bytes,
+                          PaddlePlace place,
+                          CallbackFunc cb = nullptr,
+                          void* cb_params = nullptr) {}
+
+  /// \brief Unbind the buffer of an input or an output.
+  virtual void UnbindBuffer(const std::string& name) {}
+
   /// \brief Clone an existing predictor
   /// When using clone, the same network will be created,
   /// and the parameters between them are shared.
@@ -522,6 +544,15 @@ class PD_INFER_DECL InternalUtils {
   static void DisableTensorRtHalfOps(
       paddle_infer::Config* c, const std::unordered_set<std::string>& ops);
 
+  static void CopyKVCacheBlocks(
+      paddle_infer::Predictor* pred,
+      const std::vector<std::string>& cache_names,
+      const std::vector<std::pair<int, int>>& copies);
+
+  // Binds a predictor, usually a clone, to a numa node, see
+  // Config::BindNumaNode. It takes effect from the next run.
+  static void BindNumaNode(paddle_infer::Predictor* pred, int numa_node);
+
   static void SyncStream(paddle_infer::Predictor* pred);
   static void SyncStream(cudaStream_t stream);
   template <typename T>
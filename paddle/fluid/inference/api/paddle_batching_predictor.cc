@@ -0,0 +1,400 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/paddle_batching_predictor.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <exception>
+#include <future>  // NOLINT
+#include <utility>
+
+#include "paddle/phi/core/enforce.h"
+
+namespace paddle_infer {
+namespace services {
+
+namespace {
+
+template <typename Visitor>
+void VisitDataType(DataType dtype, Visitor visitor) {
+  switch (dtype) {
+    case DataType::FLOAT32:
+      visitor(float());
+      break;
+    case DataType::INT64:
+      visitor(int64_t());
+      break;
+    case DataType::INT32:
+      visitor(int32_t());
+      break;
+    case DataType::UINT8:
+      visitor(uint8_t());
+      break;
+    case DataType::INT8:
+      visitor(int8_t());
+      break;
+    case DataType::BOOL:
+      visitor(bool());
+      break;
+    case DataType::FLOAT64:
+      visitor(double());
+      break;
+    default:
+      PADDLE_THROW(phi::errors::Unimplemented(
+          "The data type (%d) is not supported by BatchingPredictor.",
+          static_cast<int>(dtype)));
+  }
+}
+
+size_t SizeOfDataType(DataType dtype) {
+  size_t size = 0;
+  VisitDataType(dtype, [&size](auto x) { size = sizeof(x); });
+  return size;
+}
+
+// the number of samples of a request input
+int SampleNum(const paddle::PaddleTensor& tensor) {
+  if (!tensor.lod.empty()) {
+    PADDLE_ENFORCE_EQ(tensor.lod.size(),
+                      1UL,
+                      phi::errors::InvalidArgument(
+                          "Only one level of LoD is supported, but the input "
+                          "(%s) has (%d) levels.",
+                          tensor.name,
+                          tensor.lod.size()));
+    return static_cast<int>(tensor.lod[0].size()) - 1;
+  }
+  PADDLE_ENFORCE_GT(tensor.shape.size(),
+                    0UL,
+                    phi::errors::InvalidArgument(
+                        "The input (%s) should have the batch dim.",
+                        tensor.name));
+  return tensor.shape[0];
+}
+
+// the bytes of a row of dim 0
+size_t RowBytes(const std::vector<int>& shape, DataType dtype) {
+  size_t bytes = SizeOfDataType(dtype);
+  for (size_t i = 1; i < shape.size(); ++i) {
+    bytes *= shape[i];
+  }
+  return bytes;
+}
+
+}  // namespace
+
+struct BatchingPredictor::Request {
+  const std::vector<paddle::PaddleTensor>* inputs{nullptr};
+  std::vector<paddle::PaddleTensor>* outputs{nullptr};
+  int sample_num{0};
+  std::chrono::steady_clock::time_point arrive_time;
+  std::promise<bool> done;
+};
+
+BatchingPredictor::BatchingPredictor(const Config& config,
+                                     const BatchingConfig& batching_config)
+    : batching_config_(batching_config) {
+  PADDLE_ENFORCE_GT(batching_config_.max_batch_size,
+                    0,
+                    phi::errors::InvalidArgument(
+                        "The max_batch_size should be greater than 0, but "
+                        "it's (%d).",
+                        batching_config_.max_batch_size));
+  PADDLE_ENFORCE_EQ(std::is_sorted(batching_config_.buckets.begin(),
+                                   batching_config_.buckets.end()),
+                    true,
+                    phi::errors::InvalidArgument(
+                        "The buckets of BatchingPredictor should be sorted."));
+  predictor_ = CreatePredictor(config);
+  batch_thread_ = std::thread([this] { BatchLoop(); });
+}
+
+BatchingPredictor::~BatchingPredictor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  batch_thread_.join();
+}
+
+bool BatchingPredictor::Run(const std::vector<paddle::PaddleTensor>& inputs,
+                            std::vector<paddle::PaddleTensor>* outputs) {
+  PADDLE_ENFORCE_EQ(inputs.empty(),
+                    false,
+                    phi::errors::InvalidArgument(
+                        "The inputs of a request should not be empty."));
+  auto request = std::make_shared<Request>();
+  request->inputs = &inputs;
+  request->outputs = outputs;
+  request->sample_num = SampleNum(inputs[0]);
+  int seq_len = 0;
+  for (auto& input : inputs) {
+    PADDLE_ENFORCE_EQ(SampleNum(input),
+                      request->sample_num,
+                      phi::errors::InvalidArgument(
+                          "The inputs of a request should have the same "
+                          "number of samples, but the input (%s) has (%d) "
+                          "and the input (%s) has (%d).",
+                          input.name,
+                          SampleNum(input),
+                          inputs[0].name,
+                          request->sample_num));
+    auto& padded = batching_config_.padded_inputs;
+    if (std::find(padded.begin(), padded.end(), input.name) != padded.end()) {
+      PADDLE_ENFORCE_GE(input.shape.size(),
+                        2UL,
+                        phi::errors::InvalidArgument(
+                            "The padded input (%s) should have the dim of "
+                            "sequence length.",
+                            input.name));
+      seq_len = std::max(seq_len, input.shape[1]);
+    }
+  }
+  // requests of different buckets are never batched together
+  int bucket = seq_len;
+  auto& buckets = batching_config_.buckets;
+  auto it = std::lower_bound(buckets.begin(), buckets.end(), seq_len);
+  if (it != buckets.end()) {
+    bucket = *it;
+  }
+
+  auto future = request->done.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PADDLE_ENFORCE_EQ(stop_,
+                      false,
+                      phi::errors::Unavailable(
+                          "The BatchingPredictor has been destroyed."));
+    request->arrive_time = std::chrono::steady_clock::now();
+    pending_[bucket].push_back(request);
+  }
+  cv_.notify_all();
+  return future.get();
+}
+
+void BatchingPredictor::BatchLoop() {
+  auto max_wait = std::chrono::microseconds(batching_config_.max_wait_us);
+  while (true) {
+    int bucket = 0;
+    std::vector<std::shared_ptr<Request>> batch;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+      if (pending_.empty()) {
+        return;
+      }
+      // serve the bucket of the oldest request first
+      auto oldest = pending_.begin();
+      for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+        if (it->second.front()->arrive_time <
+            oldest->second.front()->arrive_time) {
+          oldest = it;
+        }
+      }
+      bucket = oldest->first;
+      auto& requests = oldest->second;
+      auto deadline = requests.front()->arrive_time + max_wait;
+      cv_.wait_until(lock, deadline, [&] {
+        int sample_num = 0;
+        for (auto& request : requests) {
+          sample_num += request->sample_num;
+        }
+        return stop_ || sample_num >= batching_config_.max_batch_size;
+      });
+      int sample_num = 0;
+      while (!requests.empty() &&
+             (batch.empty() || sample_num + requests.front()->sample_num <=
+                                   batching_config_.max_batch_size)) {
+        sample_num += requests.front()->sample_num;
+        batch.push_back(std::move(requests.front()));
+        requests.pop_front();
+      }
+      if (requests.empty()) {
+        pending_.erase(bucket);
+      }
+    }
+    RunBatch(batch, bucket);
+  }
+}
+
+void BatchingPredictor::RunBatch(
+    const std::vector<std::shared_ptr<Request>>& batch, int bucket) {
+  bool ret = false;
+  try {
+    auto& padded = batching_config_.padded_inputs;
+    const auto& first_inputs = *batch[0]->inputs;
+    for (size_t i = 0; i < first_inputs.size(); ++i) {
+      const auto& first = first_inputs[i];
+      bool is_padded =
+          std::find(padded.begin(), padded.end(), first.name) != padded.end();
+      std::vector<int> shape = first.shape;
+      shape[0] = 0;
+      if (is_padded) {
+        // the requests of the bucket are padded to its length
+        shape[1] = bucket;
+      }
+      std::vector<size_t> lod;
+      if (!first.lod.empty()) {
+        lod.push_back(0);
+      }
+      for (auto& request : batch) {
+        PADDLE_ENFORCE_GT(request->inputs->size(),
+                          i,
+                          phi::errors::InvalidArgument(
+                              "The batched requests should have the same "
+                              "inputs, the input (%s) is missing.",
+                              first.name));
+        const auto& input = (*request->inputs)[i];
+        PADDLE_ENFORCE_EQ(input.name == first.name &&
+                              input.dtype == first.dtype &&
+                              input.shape.size() == shape.size() &&
+                              input.lod.empty() == first.lod.empty(),
+                          true,
+                          phi::errors::InvalidArgument(
+                              "The input (%s) of the batched requests should "
+                              "have the same name, data type, rank and LoD "
+                              "level.",
+                              first.name));
+        for (size_t d = is_padded ? 2 : 1; d < shape.size(); ++d) {
+          PADDLE_ENFORCE_EQ(input.shape[d],
+                            shape[d],
+                            phi::errors::InvalidArgument(
+                                "The dim (%d) of the input (%s) should be the "
+                                "same for the batched requests, but got (%d) "
+                                "and (%d).",
+                                d,
+                                first.name,
+                                input.shape[d],
+                                shape[d]));
+        }
+        if (!input.lod.empty()) {
+          size_t base = lod.back();
+          for (size_t k = 1; k < input.lod[0].size(); ++k) {
+            lod.push_back(base + input.lod[0][k]);
+          }
+        }
+        shape[0] += input.shape[0];
+      }
+
+      size_t row_bytes = RowBytes(shape, first.dtype);
+      // the padded tail is zero
+      std::vector<char> buffer(shape[0] * row_bytes, 0);
+      char* dst = buffer.data();
+      for (auto& request : batch) {
+        const auto& input = (*request->inputs)[i];
+        size_t src_row_bytes = RowBytes(input.shape, input.dtype);
+        PADDLE_ENFORCE_GE(input.data.length(),
+                          input.shape[0] * src_row_bytes,
+                          phi::errors::InvalidArgument(
+                              "The data of the input (%s) is too short.",
+                              first.name));
+        const char* src = static_cast<const char*>(input.data.data());
+        if (src_row_bytes == row_bytes) {
+          std::memcpy(dst, src, input.shape[0] * row_bytes);
+          dst += input.shape[0] * row_bytes;
+        } else {
+          for (int r = 0; r < input.shape[0]; ++r) {
+            std::memcpy(dst, src + r * src_row_bytes, src_row_bytes);
+            dst += row_bytes;
+          }
+        }
+      }
+
+      auto tensor = predictor_->GetInputHandle(first.name);
+      tensor->Reshape(shape);
+      VisitDataType(first.dtype, [&](auto x) {
+        using T = decltype(x);
+        tensor->CopyFromCpu(reinterpret_cast<const T*>(buffer.data()));
+      });
+      if (!lod.empty()) {
+        tensor->SetLoD({lod});
+      }
+    }
+
+    ret = predictor_->Run();
+    if (ret) {
+      int total_samples = 0;
+      for (auto& request : batch) {
+        request->outputs->clear();
+        total_samples += request->sample_num;
+      }
+      for (auto& name : predictor_->GetOutputNames()) {
+        auto tensor = predictor_->GetOutputHandle(name);
+        auto shape = tensor->shape();
+        auto tensor_lod = tensor->lod();
+        auto dtype = tensor->type();
+        size_t row_bytes = RowBytes(shape, dtype);
+        std::vector<char> buffer(shape.empty() ? 0 : shape[0] * row_bytes);
+        VisitDataType(dtype, [&](auto x) {
+          using T = decltype(x);
+          tensor->CopyToCpu(reinterpret_cast<T*>(buffer.data()));
+        });
+        bool split_by_lod =
+            !tensor_lod.empty() &&
+            tensor_lod[0].size() == static_cast<size_t>(total_samples) + 1;
+        PADDLE_ENFORCE_EQ(split_by_lod || (!shape.empty() &&
+                                           shape[0] == total_samples),
+                          true,
+                          phi::errors::InvalidArgument(
+                              "The output (%s) can not be split to the "
+                              "requests, neither its LoD nor its dim 0 is of "
+                              "the batch size (%d).",
+                              name,
+                              total_samples));
+        int sample = 0;
+        for (auto& request : batch) {
+          size_t begin = sample;
+          size_t end = sample + request->sample_num;
+          paddle::PaddleTensor output;
+          output.name = name;
+          output.dtype = dtype;
+          output.shape = shape;
+          if (split_by_lod) {
+            std::vector<size_t> lod;
+            for (size_t k = begin; k <= end; ++k) {
+              lod.push_back(tensor_lod[0][k] - tensor_lod[0][begin]);
+            }
+            output.lod.push_back(std::move(lod));
+            begin = tensor_lod[0][begin];
+            end = tensor_lod[0][end];
+          }
+          output.shape[0] = static_cast<int>(end - begin);
+          output.data.Resize((end - begin) * row_bytes);
+          if (end > begin) {
+            std::memcpy(output.data.data(),
+                        buffer.data() + begin * row_bytes,
+                        (end - begin) * row_bytes);
+          }
+          request->outputs->push_back(std::move(output));
+          sample += request->sample_num;
+        }
+      }
+    }
+  } catch (...) {
+    auto eptr = std::current_exception();
+    for (auto& request : batch) {
+      request->done.set_exception(eptr);
+    }
+    return;
+  }
+  for (auto& request : batch) {
+    request->done.set_value(ret);
+  }
+}
+
+}  // namespace services
+}  // namespace paddle_infer
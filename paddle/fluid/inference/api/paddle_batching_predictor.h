@@ -0,0 +1,102 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "paddle_inference_api.h"  // NOLINT
+
+namespace paddle_infer {
+namespace services {
+
+///
+/// \brief The options of BatchingPredictor.
+///
+struct PD_INFER_DECL BatchingConfig {
+  /// The max number of samples of a batch, a request with more samples is
+  /// run alone.
+  int max_batch_size{32};
+  /// The max time in microseconds the first request of a batch waits for
+  /// more requests.
+  int max_wait_us{1000};
+  /// The inputs of shape [batch, seq_len, ...] whose seq_len varies between
+  /// requests. They are zero padded in dim 1 to the smallest bucket no shorter
+  /// than the longest one of the request, and only the requests of the same
+  /// bucket are batched together.
+  std::vector<std::string> padded_inputs;
+  /// The ascending bucket lengths. A request longer than the last bucket is
+  /// batched only with the requests of the same length.
+  std::vector<int> buckets;
+};
+
+///
+/// \class BatchingPredictor
+///
+/// \brief BatchingPredictor collects the concurrent requests until
+/// max_batch_size samples or max_wait_us passed, concatenates them along
+/// dim 0 and the level 0 LoD into the inputs of one Predictor, and splits the
+/// outputs back to the requests.
+///
+/// The inputs of a request are named cpu PaddleTensors. The samples of an
+/// input with LoD are its level 0 sequences, only one level of LoD is
+/// supported. An output is split by its level 0 LoD if it has one of the
+/// batch size, otherwise by dim 0 which must be the batch size. The outputs of
+/// padded requests are not unpadded.
+///
+class PD_INFER_DECL BatchingPredictor {
+ public:
+  BatchingPredictor(const Config& config,
+                    const BatchingConfig& batching_config);
+  ~BatchingPredictor();
+
+  BatchingPredictor(const BatchingPredictor&) = delete;
+  BatchingPredictor& operator=(const BatchingPredictor&) = delete;
+
+  /// \brief Run a request, the caller is blocked until its batch is done.
+  /// Thread safe.
+  ///
+  /// \return Whether the batch of the request runs successfully.
+  bool Run(const std::vector<paddle::PaddleTensor>& inputs,
+           std::vector<paddle::PaddleTensor>* outputs);
+
+ private:
+  struct Request;
+
+  void BatchLoop();
+  // the padded inputs of the batch are padded to the length of bucket
+  void RunBatch(const std::vector<std::shared_ptr<Request>>& batch,
+                int bucket);
+
+  BatchingConfig batching_config_;
+  std::shared_ptr<Predictor> predictor_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // the pending requests of every bucket, in order of arrival
+  std::map<int, std::deque<std::shared_ptr<Request>>> pending_;
+  bool stop_{false};
+  std::thread batch_thread_;
+};
+
+}  // namespace services
+}  // namespace paddle_infer
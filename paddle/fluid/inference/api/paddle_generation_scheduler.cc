@@ -0,0 +1,225 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/paddle_generation_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "paddle/phi/core/enforce.h"
+
+namespace paddle_infer {
+namespace services {
+
+GenerationScheduler::GenerationScheduler(
+    KVBlockManager* block_manager, const GenerationSchedulerConfig& config)
+    : block_manager_(block_manager), config_(config) {
+  PADDLE_ENFORCE_NOT_NULL(block_manager_,
+                          phi::errors::InvalidArgument(
+                              "The block manager of GenerationScheduler "
+                              "should not be null."));
+  PADDLE_ENFORCE_GT(config_.max_batch_size,
+                    0,
+                    phi::errors::InvalidArgument(
+                        "The max_batch_size of GenerationScheduler should be "
+                        "greater than 0, but got (%d).",
+                        config_.max_batch_size));
+}
+
+void GenerationScheduler::AddRequest(const GenerationRequest& request) {
+  PADDLE_ENFORCE_GT(request.prompt.size(),
+                    0UL,
+                    phi::errors::InvalidArgument(
+                        "The prompt of the request (%d) is empty.",
+                        request.id));
+  PADDLE_ENFORCE_GT(request.max_new_tokens,
+                    0,
+                    phi::errors::InvalidArgument(
+                        "The max_new_tokens of the request (%d) should be "
+                        "greater than 0, but got (%d).",
+                        request.id,
+                        request.max_new_tokens));
+  // a request running alone always has its blocks, so it is never preempted
+  // forever
+  int64_t max_tokens = static_cast<int64_t>(block_manager_->num_blocks()) *
+                       block_manager_->block_size();
+  PADDLE_ENFORCE_LE(
+      static_cast<int64_t>(request.prompt.size()) + request.max_new_tokens,
+      max_tokens,
+      phi::errors::InvalidArgument(
+          "The request (%d) of (%d) prompt tokens and (%d) new tokens does "
+          "not fit in the (%d) tokens of the KV cache.",
+          request.id,
+          request.prompt.size(),
+          request.max_new_tokens,
+          max_tokens));
+  auto seq = std::make_shared<Sequence>();
+  seq->request = request;
+  std::lock_guard<std::mutex> lock(mutex_);
+  waiting_.push_back(std::move(seq));
+}
+
+bool GenerationScheduler::HasUnfinishedRequests() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !waiting_.empty() || !running_.empty();
+}
+
+GenerationStep GenerationScheduler::Schedule() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  GenerationStep step;
+  scheduled_.clear();
+  int budget = config_.max_num_batched_tokens;
+  int block_size = block_manager_->block_size();
+
+  // the decode phase, the sequences admitted first are preempted last
+  for (size_t i = 0; i < running_.size();) {
+    auto seq = running_[i];
+    if (seq->has_pending_token) {
+      // the pending token starts a new block
+      if (seq->num_tokens % block_size == 0) {
+        while (block_manager_->NumFreeBlocks() == 0 &&
+               running_.size() > i + 1) {
+          PreemptLastRunning();
+        }
+        if (block_manager_->NumFreeBlocks() == 0) {
+          PreemptLastRunning();
+          continue;
+        }
+      }
+      block_manager_->AppendToken(seq->request.id, seq->generated.back());
+      ++seq->num_tokens;
+      seq->has_pending_token = false;
+    }
+    ScheduledSequence scheduled;
+    scheduled.id = seq->request.id;
+    scheduled.tokens = {seq->generated.back()};
+    scheduled.start_pos = seq->num_tokens - 1;
+    step.sequences.push_back(std::move(scheduled));
+    scheduled_.push_back(seq);
+    --budget;
+    ++i;
+  }
+
+  // the prefill phase, in order of arrival
+  while (!waiting_.empty() &&
+         running_.size() < static_cast<size_t>(config_.max_batch_size)) {
+    auto seq = waiting_.front();
+    // a preempted sequence is prefilled with its generated tokens
+    std::vector<int64_t> tokens = seq->request.prompt;
+    tokens.insert(tokens.end(), seq->generated.begin(), seq->generated.end());
+    int token_num = static_cast<int>(tokens.size());
+    int block_num = (token_num + block_size - 1) / block_size;
+    if (block_num > block_manager_->NumFreeBlocks()) break;
+    if (token_num > budget && !step.sequences.empty()) break;
+
+    int cached_num = block_manager_->AddSequence(seq->request.id, tokens);
+    seq->num_tokens = token_num;
+    seq->has_pending_token = false;
+    budget -= token_num - cached_num;
+
+    ScheduledSequence scheduled;
+    scheduled.id = seq->request.id;
+    scheduled.tokens.assign(tokens.begin() + cached_num, tokens.end());
+    scheduled.start_pos = cached_num;
+    scheduled.is_prefill = true;
+    step.sequences.push_back(std::move(scheduled));
+    scheduled_.push_back(seq);
+    running_.push_back(seq);
+    waiting_.pop_front();
+  }
+  return step;
+}
+
+void GenerationScheduler::Update(const std::vector<int64_t>& next_tokens) {
+  std::vector<std::pair<std::shared_ptr<Sequence>, int64_t>> callbacks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PADDLE_ENFORCE_EQ(next_tokens.size(),
+                      scheduled_.size(),
+                      phi::errors::InvalidArgument(
+                          "The step has (%d) sequences, but got (%d) tokens.",
+                          scheduled_.size(),
+                          next_tokens.size()));
+    for (size_t i = 0; i < scheduled_.size(); ++i) {
+      auto& seq = scheduled_[i];
+      int64_t token = next_tokens[i];
+      seq->generated.push_back(token);
+      seq->has_pending_token = true;
+      seq->finished = token == seq->request.eos_token_id ||
+                      static_cast<int>(seq->generated.size()) >=
+                          seq->request.max_new_tokens;
+      if (seq->finished) {
+        block_manager_->RemoveSequence(seq->request.id);
+      }
+      callbacks.emplace_back(seq, token);
+    }
+    running_.erase(
+        std::remove_if(running_.begin(),
+                       running_.end(),
+                       [](const std::shared_ptr<Sequence>& seq) {
+                         return seq->finished;
+                       }),
+        running_.end());
+    scheduled_.clear();
+  }
+  for (auto& callback : callbacks) {
+    auto& request = callback.first->request;
+    if (request.on_token) {
+      request.on_token(request.id, callback.second, callback.first->finished);
+    }
+  }
+}
+
+bool GenerationScheduler::Step(Predictor* predictor, const StepFunction& run) {
+  GenerationStep step = Schedule();
+  if (step.sequences.empty()) return false;
+  std::vector<int64_t> ids;
+  ids.reserve(step.sequences.size());
+  for (auto& seq : step.sequences) {
+    ids.push_back(seq.id);
+  }
+  block_manager_->PrepareRun(predictor, ids);
+  std::vector<int64_t> next_tokens;
+  if (!run(predictor, step, &next_tokens)) {
+    RequeueScheduled();
+    return false;
+  }
+  Update(next_tokens);
+  return true;
+}
+
+bool GenerationScheduler::PreemptLastRunning() {
+  if (running_.empty()) return false;
+  auto seq = running_.back();
+  running_.pop_back();
+  block_manager_->RemoveSequence(seq->request.id);
+  seq->num_tokens = 0;
+  waiting_.push_front(seq);
+  return true;
+}
+
+void GenerationScheduler::RequeueScheduled() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = scheduled_.rbegin(); it != scheduled_.rend(); ++it) {
+    auto& seq = *it;
+    running_.erase(std::find(running_.begin(), running_.end(), seq));
+    block_manager_->RemoveSequence(seq->request.id);
+    seq->num_tokens = 0;
+    waiting_.push_front(seq);
+  }
+  scheduled_.clear();
+}
+
+}  // namespace services
+}  // namespace paddle_infer
@@ -0,0 +1,149 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "paddle_kv_block_manager.h"  // NOLINT
+
+namespace paddle_infer {
+namespace services {
+
+///
+/// \brief A generation request of GenerationScheduler.
+///
+struct PD_INFER_DECL GenerationRequest {
+  /// The unique id of the request, which is the sequence id of the
+  /// KVBlockManager.
+  int64_t id{0};
+  std::vector<int64_t> prompt;
+  int max_new_tokens{1};
+  /// The generation stops at this token, -1 means no eos token.
+  int64_t eos_token_id{-1};
+  /// Called on every generated token, in the thread of GenerationScheduler.
+  std::function<void(int64_t id, int64_t token, bool finished)> on_token;
+};
+
+///
+/// \brief The options of GenerationScheduler.
+///
+struct PD_INFER_DECL GenerationSchedulerConfig {
+  /// The max number of sequences of a step.
+  int max_batch_size{32};
+  /// The max number of tokens a step computes, every decoding sequence
+  /// computes one token and the prefills share the rest. A prompt longer than
+  /// the budget is prefilled alone.
+  int max_num_batched_tokens{2048};
+};
+
+///
+/// \brief A sequence of a step. The step computes the KV and samples the next
+/// token of its tokens, which follow the start_pos tokens in the KV cache.
+///
+struct PD_INFER_DECL ScheduledSequence {
+  int64_t id{0};
+  std::vector<int64_t> tokens;
+  int start_pos{0};
+  bool is_prefill{false};
+};
+
+///
+/// \brief The sequences of a step, the decoding ones first.
+///
+struct PD_INFER_DECL GenerationStep {
+  std::vector<ScheduledSequence> sequences;
+};
+
+///
+/// \class GenerationScheduler
+///
+/// \brief GenerationScheduler batches the generation requests at the level of
+/// decoding steps. Every step decodes one token of every running sequence,
+/// and admits the waiting requests into the prefill phase with the rest of
+/// the token budget, so a finished sequence makes room for a new request at
+/// the next step instead of waiting for the longest sequence of its batch.
+///
+/// The KV caches are allocated by a KVBlockManager, and the requests of the
+/// same prompt prefix reuse its cached blocks. When the blocks run out, the
+/// running sequences admitted last are preempted, their blocks are released
+/// and they are prefilled again with all their tokens later.
+///
+/// AddRequest is thread safe, the steps must be run by one thread.
+///
+class PD_INFER_DECL GenerationScheduler {
+ public:
+  /// \brief The function running a step on the predictor, it sets one
+  /// sampled token of every sequence of the step.
+  using StepFunction = std::function<bool(
+      Predictor*, const GenerationStep&, std::vector<int64_t>*)>;
+
+  GenerationScheduler(KVBlockManager* block_manager,
+                      const GenerationSchedulerConfig& config);
+
+  GenerationScheduler(const GenerationScheduler&) = delete;
+  GenerationScheduler& operator=(const GenerationScheduler&) = delete;
+
+  void AddRequest(const GenerationRequest& request);
+
+  /// \brief Whether any request is waiting or running.
+  bool HasUnfinishedRequests() const;
+
+  /// \brief Schedule the next step, the blocks of its tokens are allocated.
+  GenerationStep Schedule();
+
+  /// \brief Update the sequences of the last step with their sampled tokens,
+  /// the finished ones release their blocks.
+  void Update(const std::vector<int64_t>& next_tokens);
+
+  /// \brief Schedule a step, feed its block tables and run it.
+  ///
+  /// \return False if there is nothing to run or the run fails, the
+  /// sequences of a failed step are prefilled again by the next step.
+  bool Step(Predictor* predictor, const StepFunction& run);
+
+ private:
+  struct Sequence {
+    GenerationRequest request;
+    std::vector<int64_t> generated;
+    // the number of tokens in the KV cache
+    int num_tokens{0};
+    // the last generated token is not in the KV cache yet
+    bool has_pending_token{false};
+    bool finished{false};
+  };
+
+  // the last running sequence is preempted, return false if there is none
+  bool PreemptLastRunning();
+  // the sequences of a failed step are prefilled again
+  void RequeueScheduled();
+
+  KVBlockManager* block_manager_;
+  GenerationSchedulerConfig config_;
+
+  mutable std::mutex mutex_;
+  std::deque<std::shared_ptr<Sequence>> waiting_;
+  // in order of admission
+  std::vector<std::shared_ptr<Sequence>> running_;
+  // the sequences of the last step
+  std::vector<std::shared_ptr<Sequence>> scheduled_;
+};
+
+}  // namespace services
+}  // namespace paddle_infer
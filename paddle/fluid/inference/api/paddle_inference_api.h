@@ -22,8 +22,13 @@ limitations under the License. */
 #pragma once
 
 #include <cassert>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -203,6 +208,21 @@ class PD_INFER_DECL Predictor {
   /// The same as RegisterOutputHook.
   void RegisterInputHook(const InputTensorHookFunc& hookfunc);
 
+  ///
+  /// \brief Bind a buffer of the user to an input or an output over the
+  /// runs, so that Run reads the input from it and writes the output into it
+  /// without a copy. See PaddlePredictor::BindBuffer.
+  ///
+  void BindBuffer(const std::string& name,
+                  void* data,
+                  size_t bytes,
+                  PlaceType place,
+                  CallbackFunc cb = nullptr,
+                  void* cb_params = nullptr);
+
+  /// \brief Unbind the buffer of an input or an output.
+  void UnbindBuffer(const std::string& name);
+
   ///
   /// \brief Get the execution stream on devices with a concept of stream,
   /// otherwise returns nullptr.
@@ -249,13 +269,26 @@ PD_INFER_DECL void ConvertToMixedPrecision(
     std::unordered_set<std::string> white_list = {});
 
 namespace services {
+///
+/// \brief The latency statistics of a predictor instance in the pool, the
+/// times are in milliseconds.
+///
+struct PD_INFER_DECL PredictorStat {
+  uint64_t run_num{0};
+  double total_queue_ms{0.};
+  double max_queue_ms{0.};
+  double total_run_ms{0.};
+  double max_run_ms{0.};
+};
+
 ///
 /// \class PredictorPool
 ///
 /// \brief PredictorPool is a simple encapsulation of Predictor, suitable for
 /// use in multi-threaded situations. According to the thread id, the
 /// corresponding Predictor is taken out from PredictorPool to complete the
-/// prediction.
+/// prediction. Alternatively, the requests of any thread are dispatched to the
+/// idle predictors by Run.
 ///
 class PD_INFER_DECL PredictorPool {
  public:
@@ -264,14 +297,44 @@ class PD_INFER_DECL PredictorPool {
   PredictorPool& operator=(const PredictorPool&) = delete;
 
   /// \brief Construct the predictor pool with \param size predictor instances.
-  explicit PredictorPool(const Config& config, size_t size = 1);
+  /// All instances are clones of the first one and share its weights. With
+  /// TensorRT enabled, every instance is built from the config unless
+  /// \param share_trt_engine is true, then the clones share the TensorRT
+  /// engines of the first instance and each has its own execution context.
+  explicit PredictorPool(const Config& config,
+                         size_t size = 1,
+                         bool share_trt_engine = false);
 
   /// \brief Get \param id-th predictor.
   Predictor* Retrieve(size_t idx);
 
+  /// \brief Run \param task on an idle predictor, the caller is blocked until
+  /// a predictor is idle and the task is done. Thread safe, but the
+  /// predictors should not be used by Retrieve at the same time.
+  ///
+  /// \return the result of \param task.
+  bool Run(const std::function<bool(Predictor*)>& task);
+
+  /// \brief Run the inputs on an idle predictor, see Run(task).
+  bool Run(const std::vector<paddle::Tensor>& inputs,
+           std::vector<paddle::Tensor>* outputs);
+
+  /// \brief Get the latency statistics of the requests dispatched by Run, the
+  /// \param id-th element is of the \param id-th predictor.
+  std::vector<PredictorStat> GetStats();
+
+  /// \brief Get the number of predictors.
+  size_t size() const { return preds_.size() + 1; }
+
  private:
   std::shared_ptr<Predictor> main_pred_;
   std::vector<std::unique_ptr<Predictor>> preds_;
+
+  std::mutex mutex_;
+  std::condition_variable idle_cv_;
+  // ids of predictors waiting for requests
+  std::deque<size_t> idle_;
+  std::vector<PredictorStat> stats_;
 };
 }  // namespace services
 
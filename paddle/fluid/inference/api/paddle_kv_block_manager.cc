@@ -0,0 +1,335 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/paddle_kv_block_manager.h"
+
+#include <algorithm>
+
+#include "paddle/phi/core/enforce.h"
+
+namespace paddle_infer {
+namespace services {
+
+namespace {
+
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+// the hash of a full block chains the hash of the blocks before it
+uint64_t HashBlockTokens(uint64_t parent_hash,
+                         const int64_t* tokens,
+                         size_t size) {
+  uint64_t hash = (1469598103934665603ULL ^ parent_hash) * kFnvPrime;
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ static_cast<uint64_t>(tokens[i])) * kFnvPrime;
+  }
+  return hash;
+}
+
+}  // namespace
+
+KVBlockManager::KVBlockManager(const KVBlockManagerConfig& config)
+    : config_(config) {
+  PADDLE_ENFORCE_GT(config_.num_blocks,
+                    0,
+                    phi::errors::InvalidArgument(
+                        "The num_blocks of KVBlockManager should be greater "
+                        "than 0, but got (%d).",
+                        config_.num_blocks));
+  PADDLE_ENFORCE_GT(config_.block_size,
+                    0,
+                    phi::errors::InvalidArgument(
+                        "The block_size of KVBlockManager should be greater "
+                        "than 0, but got (%d).",
+                        config_.block_size));
+  blocks_.resize(config_.num_blocks);
+  free_blocks_.reserve(config_.num_blocks);
+  // the low blocks are allocated first
+  for (int i = config_.num_blocks - 1; i >= 0; --i) {
+    free_blocks_.push_back(i);
+  }
+}
+
+int KVBlockManager::AddSequence(int64_t seq_id,
+                                const std::vector<int64_t>& tokens) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  PADDLE_ENFORCE_EQ(sequences_.count(seq_id),
+                    0UL,
+                    phi::errors::AlreadyExists(
+                        "The sequence (%d) is already added.", seq_id));
+  PADDLE_ENFORCE_GT(tokens.size(),
+                    0UL,
+                    phi::errors::InvalidArgument(
+                        "The prompt of the sequence (%d) is empty.", seq_id));
+  size_t block_size = config_.block_size;
+  Sequence seq;
+  // the last token is left to the run, which computes its logits
+  while (config_.enable_prefix_sharing &&
+         (seq.blocks.size() + 1) * block_size < tokens.size()) {
+    const int64_t* begin = tokens.data() + seq.blocks.size() * block_size;
+    uint64_t hash = HashBlockTokens(seq.prefix_hash, begin, block_size);
+    auto it = prefix_table_.find(hash);
+    if (it == prefix_table_.end()) break;
+    Block& block = blocks_[it->second];
+    if (block.parent_hash != seq.prefix_hash ||
+        !std::equal(begin, begin + block_size, block.tokens.begin())) {
+      break;
+    }
+    if (block.ref_count == 0) {
+      lru_.erase(block.lru_it);
+    }
+    ++block.ref_count;
+    seq.blocks.push_back(it->second);
+    seq.prefix_hash = hash;
+  }
+  int cached_num = static_cast<int>(seq.blocks.size() * block_size);
+  seq.tokens.assign(tokens.begin(), tokens.begin() + cached_num);
+
+  size_t block_num = (tokens.size() + block_size - 1) / block_size;
+  if (block_num - seq.blocks.size() > free_blocks_.size() + lru_.size()) {
+    for (int block_id : seq.blocks) {
+      ReleaseBlock(block_id);
+    }
+    PADDLE_THROW(phi::errors::ResourceExhausted(
+        "The sequence (%d) needs (%d) blocks, but only (%d) blocks are free.",
+        seq_id,
+        block_num - seq.blocks.size(),
+        free_blocks_.size() + lru_.size()));
+  }
+  for (size_t i = cached_num; i < tokens.size(); ++i) {
+    AppendTokenUnlocked(&seq, tokens[i]);
+  }
+  sequences_.emplace(seq_id, std::move(seq));
+  return cached_num;
+}
+
+void KVBlockManager::AppendToken(int64_t seq_id, int64_t token) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  AppendTokenUnlocked(&GetSequence(seq_id), token);
+}
+
+void KVBlockManager::ForkSequence(int64_t parent_seq_id,
+                                  int64_t child_seq_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  PADDLE_ENFORCE_EQ(sequences_.count(child_seq_id),
+                    0UL,
+                    phi::errors::AlreadyExists(
+                        "The sequence (%d) is already added.", child_seq_id));
+  Sequence child = GetSequence(parent_seq_id);
+  for (int block_id : child.blocks) {
+    ++blocks_[block_id].ref_count;
+  }
+  sequences_.emplace(child_seq_id, std::move(child));
+}
+
+void KVBlockManager::RemoveSequence(int64_t seq_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int block_id : GetSequence(seq_id).blocks) {
+    ReleaseBlock(block_id);
+  }
+  sequences_.erase(seq_id);
+}
+
+void KVBlockManager::TruncateSequence(int64_t seq_id, int num_tokens) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Sequence& seq = GetSequence(seq_id);
+  PADDLE_ENFORCE_EQ(
+      num_tokens >= 0 && static_cast<size_t>(num_tokens) <= seq.tokens.size(),
+      true,
+      phi::errors::OutOfRange(
+          "The sequence (%d) of (%d) tokens can not be truncated to (%d) "
+          "tokens.",
+          seq_id,
+          seq.tokens.size(),
+          num_tokens));
+  size_t block_size = config_.block_size;
+  size_t block_num = (num_tokens + block_size - 1) / block_size;
+  while (seq.blocks.size() > block_num) {
+    ReleaseBlock(seq.blocks.back());
+    seq.blocks.pop_back();
+  }
+  seq.tokens.resize(num_tokens);
+  size_t full_num = num_tokens / block_size;
+  seq.prefix_hash = full_num > 0 ? blocks_[seq.blocks[full_num - 1]].hash : 0;
+  if (full_num == block_num) return;
+
+  // the last block is written on again, a shared one is copied on write by
+  // the next append, and an owned one leaves the prefix table
+  Block& block = blocks_[seq.blocks.back()];
+  if (block.ref_count > 1) return;
+  if (block.hashed) {
+    prefix_table_.erase(block.hash);
+    block.hashed = false;
+  }
+  block.pending = false;
+}
+
+std::vector<int> KVBlockManager::GetBlockTable(int64_t seq_id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = sequences_.find(seq_id);
+  PADDLE_ENFORCE_EQ(
+      it != sequences_.end(),
+      true,
+      phi::errors::NotFound("The sequence (%d) is not added.", seq_id));
+  return it->second.blocks;
+}
+
+int KVBlockManager::NumFreeBlocks() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return static_cast<int>(free_blocks_.size() + lru_.size());
+}
+
+void KVBlockManager::PrepareRun(Predictor* predictor,
+                                const std::vector<int64_t>& seq_ids) {
+  std::vector<std::pair<int, int>> copies;
+  std::vector<int> block_tables;
+  int width = config_.max_blocks_per_seq;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // the blocks filled before the last run are computed now
+    RegisterFilledBlocks();
+    ++step_;
+    copies.swap(copies_);
+    if (width <= 0) {
+      width = 1;
+      for (int64_t seq_id : seq_ids) {
+        width = std::max(width,
+                         static_cast<int>(GetSequence(seq_id).blocks.size()));
+      }
+    }
+    block_tables.resize(seq_ids.size() * width, -1);
+    for (size_t i = 0; i < seq_ids.size(); ++i) {
+      auto& blocks = GetSequence(seq_ids[i]).blocks;
+      PADDLE_ENFORCE_LE(
+          blocks.size(),
+          static_cast<size_t>(width),
+          phi::errors::OutOfRange(
+              "The sequence (%d) has (%d) blocks, more than the "
+              "max_blocks_per_seq (%d).",
+              seq_ids[i],
+              blocks.size(),
+              width));
+      std::copy(blocks.begin(), blocks.end(), block_tables.begin() + i * width);
+    }
+  }
+  experimental::InternalUtils::CopyKVCacheBlocks(
+      predictor, config_.cache_names, copies);
+  auto block_tables_t = predictor->GetInputHandle(config_.block_tables_name);
+  block_tables_t->Reshape({static_cast<int>(seq_ids.size()), width});
+  block_tables_t->CopyFromCpu(block_tables.data());
+}
+
+KVBlockManager::Sequence& KVBlockManager::GetSequence(int64_t seq_id) {
+  auto it = sequences_.find(seq_id);
+  PADDLE_ENFORCE_EQ(
+      it != sequences_.end(),
+      true,
+      phi::errors::NotFound("The sequence (%d) is not added.", seq_id));
+  return it->second;
+}
+
+int KVBlockManager::AllocateBlock() {
+  int block_id = 0;
+  if (!free_blocks_.empty()) {
+    block_id = free_blocks_.back();
+    free_blocks_.pop_back();
+  } else {
+    PADDLE_ENFORCE_EQ(lru_.empty(),
+                      false,
+                      phi::errors::ResourceExhausted(
+                          "All the (%d) blocks of KVBlockManager are used.",
+                          config_.num_blocks));
+    block_id = lru_.front();
+    lru_.pop_front();
+    prefix_table_.erase(blocks_[block_id].hash);
+  }
+  Block& block = blocks_[block_id];
+  block.ref_count = 1;
+  block.hashed = false;
+  block.pending = false;
+  block.tokens.clear();
+  return block_id;
+}
+
+void KVBlockManager::ReleaseBlock(int block_id) {
+  Block& block = blocks_[block_id];
+  if (--block.ref_count > 0) return;
+  if (block.pending) {
+    // a block filled after the last PrepareRun is never computed
+    if (block.filled_step < step_) {
+      RegisterBlock(block_id);
+    } else {
+      block.pending = false;
+    }
+  }
+  if (block.hashed) {
+    block.lru_it = lru_.insert(lru_.end(), block_id);
+  } else {
+    free_blocks_.push_back(block_id);
+  }
+}
+
+void KVBlockManager::AppendTokenUnlocked(Sequence* seq, int64_t token) {
+  size_t block_size = config_.block_size;
+  if (seq->tokens.size() % block_size == 0) {
+    seq->blocks.push_back(AllocateBlock());
+  } else if (blocks_[seq->blocks.back()].ref_count > 1) {
+    // copy on write, the shared block is left to the other sequences
+    int block_id = AllocateBlock();
+    copies_.emplace_back(seq->blocks.back(), block_id);
+    ReleaseBlock(seq->blocks.back());
+    seq->blocks.back() = block_id;
+  }
+  seq->tokens.push_back(token);
+  if (seq->tokens.size() % block_size != 0) return;
+
+  int block_id = seq->blocks.back();
+  Block& block = blocks_[block_id];
+  const int64_t* begin = seq->tokens.data() + seq->tokens.size() - block_size;
+  block.parent_hash = seq->prefix_hash;
+  block.hash = HashBlockTokens(seq->prefix_hash, begin, block_size);
+  seq->prefix_hash = block.hash;
+  if (config_.enable_prefix_sharing) {
+    block.tokens.assign(begin, begin + block_size);
+    block.pending = true;
+    block.filled_step = step_;
+    filled_blocks_.push_back(block_id);
+  }
+}
+
+void KVBlockManager::RegisterBlock(int block_id) {
+  Block& block = blocks_[block_id];
+  block.pending = false;
+  // the same prefix may be computed by several sequences at the same time
+  if (prefix_table_.emplace(block.hash, block_id).second) {
+    block.hashed = true;
+  }
+}
+
+void KVBlockManager::RegisterFilledBlocks() {
+  std::vector<int> waiting;
+  for (int block_id : filled_blocks_) {
+    // a stale entry of a released or reallocated block is not pending
+    Block& block = blocks_[block_id];
+    if (!block.pending) continue;
+    if (block.filled_step < step_) {
+      RegisterBlock(block_id);
+    } else {
+      waiting.push_back(block_id);
+    }
+  }
+  filled_blocks_.swap(waiting);
+}
+
+}  // namespace services
+}  // namespace paddle_infer
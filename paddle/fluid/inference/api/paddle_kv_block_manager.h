@@ -0,0 +1,160 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "paddle_inference_api.h"  // NOLINT
+
+namespace paddle_infer {
+namespace services {
+
+///
+/// \brief The options of KVBlockManager.
+///
+struct PD_INFER_DECL KVBlockManagerConfig {
+  /// The number of blocks of the KV caches, which is dim 0 of the caches.
+  int num_blocks{0};
+  /// The number of tokens of a block, the block_size of
+  /// block_multi_head_attention.
+  int block_size{64};
+  /// The width of block_tables, 0 means the max number of blocks of the
+  /// sequences of a run.
+  int max_blocks_per_seq{0};
+  /// The names of the cache inputs whose blocks are copied on write.
+  std::vector<std::string> cache_names;
+  /// The name of the block_tables input.
+  std::string block_tables_name{"block_tables"};
+  /// Whether the full blocks of the same token prefix are shared.
+  bool enable_prefix_sharing{true};
+};
+
+///
+/// \class KVBlockManager
+///
+/// \brief KVBlockManager allocates the blocks of the paged KV caches of
+/// block_multi_head_attention for the sequences of a Predictor.
+///
+/// A full block is hashed by its tokens and the tokens before it, so the
+/// sequences of the same prefix, like a shared system prompt, reuse its
+/// blocks instead of computing them again. A block is released to a free list
+/// when no sequence uses it, but a hashed one is kept in the cache until its
+/// block is needed by an allocation, least recently used first. The blocks
+/// are reference counted, a sequence forked from another one shares all its
+/// blocks, and the last block is copied when the sequence appends to it while
+/// it is shared.
+///
+/// A block is shared only after the run that computes it, PrepareRun must be
+/// called before every run of the predictor. Thread safe.
+///
+class PD_INFER_DECL KVBlockManager {
+ public:
+  explicit KVBlockManager(const KVBlockManagerConfig& config);
+
+  KVBlockManager(const KVBlockManager&) = delete;
+  KVBlockManager& operator=(const KVBlockManager&) = delete;
+
+  /// \brief Add a sequence and allocate the blocks of its prompt.
+  ///
+  /// \return The number of leading tokens whose KV are cached, the run only
+  /// needs to compute the rest. The last token is never cached.
+  int AddSequence(int64_t seq_id, const std::vector<int64_t>& tokens);
+
+  /// \brief Allocate the slot of a generated token of a sequence.
+  void AppendToken(int64_t seq_id, int64_t token);
+
+  /// \brief Add a sequence that shares all the blocks of another one, like
+  /// the beams of a beam search.
+  void ForkSequence(int64_t parent_seq_id, int64_t child_seq_id);
+
+  /// \brief Release the blocks of a sequence.
+  void RemoveSequence(int64_t seq_id);
+
+  /// \brief Keep the first num_tokens tokens of a sequence and release the
+  /// blocks after them, like the rejected draft tokens of speculative
+  /// decoding.
+  void TruncateSequence(int64_t seq_id, int num_tokens);
+
+  /// \brief The block table of a sequence.
+  std::vector<int> GetBlockTable(int64_t seq_id) const;
+
+  /// \brief The number of blocks an allocation can take, including the
+  /// cached blocks no sequence uses.
+  int NumFreeBlocks() const;
+
+  int num_blocks() const { return config_.num_blocks; }
+  int block_size() const { return config_.block_size; }
+
+  /// \brief Copy the blocks written on since the last call and feed the
+  /// block tables of the sequences of a run to the predictor.
+  /// The sequences must not be removed before the run is done.
+  void PrepareRun(Predictor* predictor, const std::vector<int64_t>& seq_ids);
+
+ private:
+  struct Block {
+    int ref_count{0};
+    // whether the block is in the prefix table
+    bool hashed{false};
+    // whether the block is full and waits for the run computing it
+    bool pending{false};
+    // the PrepareRun count when the block became full
+    int64_t filled_step{0};
+    uint64_t hash{0};
+    uint64_t parent_hash{0};
+    std::vector<int64_t> tokens;
+    // the position in lru_ if the block is cached and unused
+    std::list<int>::iterator lru_it;
+  };
+
+  struct Sequence {
+    std::vector<int> blocks;
+    // the tokens whose slots are allocated
+    std::vector<int64_t> tokens;
+    // the hash of the tokens of the full blocks
+    uint64_t prefix_hash{0};
+  };
+
+  Sequence& GetSequence(int64_t seq_id);
+  int AllocateBlock();
+  void ReleaseBlock(int block_id);
+  void AppendTokenUnlocked(Sequence* seq, int64_t token);
+  void RegisterBlock(int block_id);
+  void RegisterFilledBlocks();
+
+  KVBlockManagerConfig config_;
+
+  mutable std::mutex mutex_;
+  std::vector<Block> blocks_;
+  std::vector<int> free_blocks_;
+  // the cached blocks no sequence uses, least recently used first
+  std::list<int> lru_;
+  // the full block of every prefix hash
+  std::unordered_map<uint64_t, int> prefix_table_;
+  std::unordered_map<int64_t, Sequence> sequences_;
+  // the blocks that may wait for their run
+  std::vector<int> filled_blocks_;
+  // the (src, dst) block copies of copy-on-write
+  std::vector<std::pair<int, int>> copies_;
+  int64_t step_{0};
+};
+
+}  // namespace services
+}  // namespace paddle_infer
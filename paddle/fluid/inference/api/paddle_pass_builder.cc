@@ -237,7 +237,8 @@ const std::vector<std::string> CpuBasicPasses{
     "attention_lstm_fuse_pass",       //
     "seqconv_eltadd_relu_fuse_pass",  //
     // "seqpool_concat_fuse_pass",    //
-    "seqpool_cvm_concat_fuse_pass",  //
+    "embedding_seqpool_concat_fuse_pass",  //
+    "seqpool_cvm_concat_fuse_pass",        //
     // "embedding_fc_lstm_fuse_pass", //
     // TODO(wilber): fix correctness problem.
     // "fc_lstm_fuse_pass",                    //
@@ -0,0 +1,280 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/paddle_speculative_decoder.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "paddle/phi/core/enforce.h"
+
+namespace paddle_infer {
+namespace services {
+
+SpeculativeDecoder::SpeculativeDecoder(Predictor* draft_predictor,
+                                       KVBlockManager* draft_block_manager,
+                                       Predictor* target_predictor,
+                                       KVBlockManager* target_block_manager,
+                                       const SpeculativeDecoderConfig& config)
+    : draft_predictor_(draft_predictor),
+      draft_block_manager_(draft_block_manager),
+      target_predictor_(target_predictor),
+      target_block_manager_(target_block_manager),
+      config_(config),
+      engine_(config.seed) {
+  PADDLE_ENFORCE_EQ(draft_block_manager_ != nullptr &&
+                        target_block_manager_ != nullptr &&
+                        draft_block_manager_ != target_block_manager_,
+                    true,
+                    phi::errors::InvalidArgument(
+                        "SpeculativeDecoder needs a block manager for each "
+                        "of the draft and the target model."));
+  PADDLE_ENFORCE_GT(config_.num_draft_tokens,
+                    0,
+                    phi::errors::InvalidArgument(
+                        "The num_draft_tokens of SpeculativeDecoder should be "
+                        "greater than 0, but got (%d).",
+                        config_.num_draft_tokens));
+  PADDLE_ENFORCE_GT(config_.vocab_size,
+                    0,
+                    phi::errors::InvalidArgument(
+                        "The vocab_size of SpeculativeDecoder should be "
+                        "greater than 0, but got (%d).",
+                        config_.vocab_size));
+}
+
+void SpeculativeDecoder::AddSequence(int64_t seq_id,
+                                     const std::vector<int64_t>& prompt) {
+  PADDLE_ENFORCE_EQ(sequences_.count(seq_id),
+                    0UL,
+                    phi::errors::AlreadyExists(
+                        "The sequence (%d) is already added.", seq_id));
+  Sequence seq;
+  seq.tokens = prompt;
+  seq.target_computed = target_block_manager_->AddSequence(seq_id, prompt);
+  try {
+    seq.draft_computed = draft_block_manager_->AddSequence(seq_id, prompt);
+  } catch (...) {
+    target_block_manager_->RemoveSequence(seq_id);
+    throw;
+  }
+  sequences_.emplace(seq_id, std::move(seq));
+}
+
+void SpeculativeDecoder::RemoveSequence(int64_t seq_id) {
+  GetSequence(seq_id);
+  draft_block_manager_->RemoveSequence(seq_id);
+  target_block_manager_->RemoveSequence(seq_id);
+  sequences_.erase(seq_id);
+}
+
+const std::vector<int64_t>& SpeculativeDecoder::GetTokens(
+    int64_t seq_id) const {
+  auto it = sequences_.find(seq_id);
+  PADDLE_ENFORCE_EQ(
+      it != sequences_.end(),
+      true,
+      phi::errors::NotFound("The sequence (%d) is not added.", seq_id));
+  return it->second.tokens;
+}
+
+bool SpeculativeDecoder::Step(const std::vector<int64_t>& seq_ids,
+                              const ModelFunction& draft,
+                              const ModelFunction& verify,
+                              std::vector<std::vector<int64_t>>* new_tokens) {
+  PADDLE_ENFORCE_NOT_NULL(
+      new_tokens,
+      phi::errors::InvalidArgument("The new_tokens should not be null."));
+  const int k = config_.num_draft_tokens;
+  const size_t vocab_size = config_.vocab_size;
+  const size_t bsz = seq_ids.size();
+  if (bsz == 0) return false;
+  std::vector<Sequence*> seqs;
+  seqs.reserve(bsz);
+  for (int64_t seq_id : seq_ids) {
+    seqs.push_back(&GetSequence(seq_id));
+  }
+  auto CheckProbs = [vocab_size](const std::vector<float>& probs,
+                                 size_t rows) {
+    PADDLE_ENFORCE_EQ(probs.size(),
+                      rows * vocab_size,
+                      phi::errors::InvalidArgument(
+                          "The model should set (%d) probs rows of (%d), but "
+                          "got (%d) probs.",
+                          rows,
+                          vocab_size,
+                          probs.size()));
+  };
+
+  // the draft model decodes k tokens, the first run feeds the tokens not in
+  // its KV cache
+  std::vector<std::vector<int64_t>> draft_tokens(bsz);
+  std::vector<std::vector<float>> draft_probs(bsz);
+  std::vector<float> probs;
+  for (int j = 0; j < k; ++j) {
+    GenerationStep step;
+    for (size_t i = 0; i < bsz; ++i) {
+      Sequence* seq = seqs[i];
+      ScheduledSequence s;
+      s.id = seq_ids[i];
+      if (j == 0) {
+        s.tokens.assign(seq->tokens.begin() + seq->draft_computed,
+                        seq->tokens.end());
+        s.start_pos = seq->draft_computed;
+        s.is_prefill = seq->draft_computed == 0;
+      } else {
+        int64_t token = draft_tokens[i].back();
+        draft_block_manager_->AppendToken(s.id, token);
+        s.tokens = {token};
+        s.start_pos = static_cast<int>(seq->tokens.size()) + j - 1;
+      }
+      step.sequences.push_back(std::move(s));
+    }
+    draft_block_manager_->PrepareRun(draft_predictor_, seq_ids);
+    probs.clear();
+    if (!draft(draft_predictor_, step, &probs)) {
+      Rollback(seq_ids);
+      return false;
+    }
+    CheckProbs(probs, bsz);
+    for (size_t i = 0; i < bsz; ++i) {
+      const float* q = probs.data() + i * vocab_size;
+      draft_tokens[i].push_back(SampleToken(q, nullptr));
+      draft_probs[i].insert(draft_probs[i].end(), q, q + vocab_size);
+    }
+  }
+
+  // the target model verifies the draft tokens in one run
+  GenerationStep step;
+  size_t num_rows = 0;
+  for (size_t i = 0; i < bsz; ++i) {
+    Sequence* seq = seqs[i];
+    ScheduledSequence s;
+    s.id = seq_ids[i];
+    s.tokens.assign(seq->tokens.begin() + seq->target_computed,
+                    seq->tokens.end());
+    s.tokens.insert(
+        s.tokens.end(), draft_tokens[i].begin(), draft_tokens[i].end());
+    s.start_pos = seq->target_computed;
+    s.is_prefill = seq->target_computed == 0;
+    for (int64_t token : draft_tokens[i]) {
+      target_block_manager_->AppendToken(s.id, token);
+    }
+    num_rows += s.tokens.size();
+    step.sequences.push_back(std::move(s));
+  }
+  target_block_manager_->PrepareRun(target_predictor_, seq_ids);
+  probs.clear();
+  if (!verify(target_predictor_, step, &probs)) {
+    Rollback(seq_ids);
+    return false;
+  }
+  CheckProbs(probs, num_rows);
+
+  new_tokens->assign(bsz, {});
+  size_t row_end = 0;
+  for (size_t i = 0; i < bsz; ++i) {
+    Sequence* seq = seqs[i];
+    row_end += step.sequences[i].tokens.size();
+    // the last k + 1 rows verify the draft tokens and give the bonus token,
+    // the last token of the sequence is never in the KV cache
+    const float* p = probs.data() + (row_end - k - 1) * vocab_size;
+    const float* q = draft_probs[i].data();
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    int n = 0;
+    for (; n < k; ++n) {
+      int64_t token = draft_tokens[i][n];
+      float p_token = p[n * vocab_size + token];
+      float q_token = q[n * vocab_size + token];
+      // accepted with the probability min(1, p / q)
+      if (uniform(engine_) * q_token > p_token) break;
+    }
+    int64_t next_token = n < k ? SampleToken(p + n * vocab_size,
+                                             q + n * vocab_size)
+                               : SampleToken(p + k * vocab_size, nullptr);
+    num_proposed_ += k;
+    num_accepted_ += n;
+
+    // roll back the KV of the rejected tokens, the draft model has not run
+    // the last draft token
+    const int old_len = static_cast<int>(seq->tokens.size());
+    seq->target_computed = old_len + n;
+    seq->draft_computed = old_len + std::min(n, k - 1);
+    target_block_manager_->TruncateSequence(seq_ids[i],
+                                            seq->target_computed);
+    draft_block_manager_->TruncateSequence(seq_ids[i], seq->draft_computed);
+
+    auto& accepted = (*new_tokens)[i];
+    accepted.assign(draft_tokens[i].begin(), draft_tokens[i].begin() + n);
+    accepted.push_back(next_token);
+    seq->tokens.insert(seq->tokens.end(), accepted.begin(), accepted.end());
+    target_block_manager_->AppendToken(seq_ids[i], next_token);
+    for (size_t j = seq->draft_computed; j < seq->tokens.size(); ++j) {
+      draft_block_manager_->AppendToken(seq_ids[i], seq->tokens[j]);
+    }
+  }
+  return true;
+}
+
+double SpeculativeDecoder::AcceptanceRate() const {
+  return num_proposed_ == 0
+             ? 0.0
+             : static_cast<double>(num_accepted_) / num_proposed_;
+}
+
+SpeculativeDecoder::Sequence& SpeculativeDecoder::GetSequence(int64_t seq_id) {
+  auto it = sequences_.find(seq_id);
+  PADDLE_ENFORCE_EQ(
+      it != sequences_.end(),
+      true,
+      phi::errors::NotFound("The sequence (%d) is not added.", seq_id));
+  return it->second;
+}
+
+int64_t SpeculativeDecoder::SampleToken(const float* p, const float* q) {
+  const int vocab_size = config_.vocab_size;
+  auto Prob = [p, q](int i) {
+    return q == nullptr ? p[i] : std::max(p[i] - q[i], 0.0f);
+  };
+  double total = 0.0;
+  for (int i = 0; i < vocab_size; ++i) {
+    total += Prob(i);
+  }
+  // p equals q, so the residual has no mass and p is sampled
+  if (total <= 0.0 && q != nullptr) {
+    return SampleToken(p, nullptr);
+  }
+  double target =
+      std::uniform_real_distribution<double>(0.0, total)(engine_);
+  double cumsum = 0.0;
+  int last = 0;
+  for (int i = 0; i < vocab_size; ++i) {
+    if (Prob(i) <= 0.0f) continue;
+    last = i;
+    cumsum += Prob(i);
+    if (target < cumsum) return i;
+  }
+  return last;
+}
+
+void SpeculativeDecoder::Rollback(const std::vector<int64_t>& seq_ids) {
+  for (int64_t seq_id : seq_ids) {
+    int num_tokens = static_cast<int>(GetSequence(seq_id).tokens.size());
+    draft_block_manager_->TruncateSequence(seq_id, num_tokens);
+    target_block_manager_->TruncateSequence(seq_id, num_tokens);
+  }
+}
+
+}  // namespace services
+}  // namespace paddle_infer
@@ -0,0 +1,122 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle_generation_scheduler.h"  // NOLINT
+#include "paddle_kv_block_manager.h"      // NOLINT
+
+namespace paddle_infer {
+namespace services {
+
+///
+/// \brief The options of SpeculativeDecoder.
+///
+struct PD_INFER_DECL SpeculativeDecoderConfig {
+  /// The number of tokens the draft model proposes in a step.
+  int num_draft_tokens{4};
+  /// The width of the probs rows of the models.
+  int vocab_size{0};
+  uint64_t seed{0};
+};
+
+///
+/// \class SpeculativeDecoder
+///
+/// \brief SpeculativeDecoder generates the sequences of a target model with
+/// the proposals of a small draft model, which runs in a second predictor
+/// with its own KV caches. Every step the draft model decodes
+/// num_draft_tokens tokens one by one, and the target model verifies them in
+/// one run, like the block_verify_attention op. The draft tokens are accepted
+/// by the rejection sampling of speculative_sampling, so the tokens follow
+/// the distribution of the target model, and a step generates from 1 to
+/// num_draft_tokens + 1 tokens.
+///
+/// The KV of the rejected tokens are rolled back by truncating the sequences
+/// of the block managers, and are written on again by the next step.
+///
+/// Not thread safe.
+///
+class PD_INFER_DECL SpeculativeDecoder {
+ public:
+  /// \brief The function running a model on the predictor, it sets the probs
+  /// rows of vocab_size. The draft model sets the next token probs of every
+  /// sequence, and the target model sets the next token probs of every
+  /// token of the step.
+  using ModelFunction = std::function<bool(
+      Predictor*, const GenerationStep&, std::vector<float>*)>;
+
+  SpeculativeDecoder(Predictor* draft_predictor,
+                     KVBlockManager* draft_block_manager,
+                     Predictor* target_predictor,
+                     KVBlockManager* target_block_manager,
+                     const SpeculativeDecoderConfig& config);
+
+  SpeculativeDecoder(const SpeculativeDecoder&) = delete;
+  SpeculativeDecoder& operator=(const SpeculativeDecoder&) = delete;
+
+  /// \brief Add a sequence to the block managers of both models.
+  void AddSequence(int64_t seq_id, const std::vector<int64_t>& prompt);
+
+  void RemoveSequence(int64_t seq_id);
+
+  /// \brief The prompt and the generated tokens of a sequence.
+  const std::vector<int64_t>& GetTokens(int64_t seq_id) const;
+
+  /// \brief Decode a step of the sequences.
+  ///
+  /// \param new_tokens The accepted tokens of every sequence.
+  /// \return False if a run fails, the sequences are kept as before the step.
+  bool Step(const std::vector<int64_t>& seq_ids,
+            const ModelFunction& draft,
+            const ModelFunction& verify,
+            std::vector<std::vector<int64_t>>* new_tokens);
+
+  /// \brief The ratio of the accepted draft tokens of all the steps.
+  double AcceptanceRate() const;
+
+ private:
+  struct Sequence {
+    std::vector<int64_t> tokens;
+    // the number of tokens in the KV caches of the models
+    int draft_computed{0};
+    int target_computed{0};
+  };
+
+  Sequence& GetSequence(int64_t seq_id);
+  // sample from the probs row, or the residual max(0, p - q) if q is set
+  int64_t SampleToken(const float* p, const float* q);
+  // roll the block managers back to the tokens of the sequences
+  void Rollback(const std::vector<int64_t>& seq_ids);
+
+  Predictor* draft_predictor_;
+  KVBlockManager* draft_block_manager_;
+  Predictor* target_predictor_;
+  KVBlockManager* target_block_manager_;
+  SpeculativeDecoderConfig config_;
+
+  std::unordered_map<int64_t, Sequence> sequences_;
+  std::mt19937_64 engine_;
+  int64_t num_proposed_{0};
+  int64_t num_accepted_{0};
+};
+
+}  // namespace services
+}  // namespace paddle_infer
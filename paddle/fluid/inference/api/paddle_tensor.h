@@ -129,6 +129,19 @@ class PD_INFER_DECL Tensor {
                          PlaceType place,
                          DataLayout layout = DataLayout::kNCHW);
 
+  /// \brief Share the data of a DLManagedTensor of DLPack without a copy.
+  /// The tensor takes the ownership, and calls the deleter of the
+  /// DLManagedTensor when the data is released.
+  /// \param dl_managed_tensor The DLManagedTensor*, on CPU or GPU.
+  void FromDLPack(void* dl_managed_tensor);
+
+  /// \brief Export the tensor as a DLManagedTensor of DLPack without a copy.
+  /// \param exec_stream The stream of the consumer (Only GPU CUDA stream
+  /// supported now). It waits for the predictor by an event instead of a
+  /// device sync, and nullptr leaves the synchronization to the caller.
+  /// \return The DLManagedTensor*, released by its deleter.
+  void* ToDLPack(void* exec_stream = nullptr) const;
+
   /// \brief Experimental interface.
   /// It's usually used to set the input tensor data with Strings data type.
   /// \param data The pointer of the data, from which the tensor will copy.
@@ -14,6 +14,7 @@
 
 #include "paddle/fluid/inference/api/resource_manager.h"
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -29,6 +30,7 @@
 #include "paddle/phi/backends/gpu/gpu_resources.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/allocator.h"
+#include "paddle/phi/core/flags.h"
 #include "paddle/phi/core/generator.h"
 #include "unsupported/Eigen/CXX11/Tensor"
 
@@ -41,6 +43,8 @@
 #include "paddle/phi/backends/dynload/cusparse.h"
 #endif  // PADDLE_WITH_CUDA
 
+PHI_DECLARE_int32(inference_gpu_handle_pool_size);
+
 namespace paddle {
 namespace internal {
 
@@ -133,6 +137,64 @@ void CPUContextResource::InitCPUResource() {
 CPUContextResource::CPUContextResource() { InitCPUResource(); }
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+GPUHandlePool& GPUHandlePool::Instance() {
+  // Never destroyed, the handles are released by the resources at exit.
+  static GPUHandlePool* pool = new GPUHandlePool();
+  return *pool;
+}
+
+void* GPUHandlePool::Acquire(int device, Kind kind) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = idle_handles_.find(std::make_pair(device, kind));
+  if (it == idle_handles_.end() || it->second.empty()) {
+    return nullptr;
+  }
+  void* handle = it->second.back();
+  it->second.pop_back();
+  return handle;
+}
+
+bool GPUHandlePool::Release(int device, Kind kind, void* handle) {
+  if (handle == nullptr) {
+    return false;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& handles = idle_handles_[std::make_pair(device, kind)];
+  if (handles.size() >=
+      static_cast<size_t>(std::max(FLAGS_inference_gpu_handle_pool_size, 0))) {
+    return false;
+  }
+  handles.push_back(handle);
+  return true;
+}
+
+size_t GPUHandlePool::IdleSize(int device, Kind kind) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = idle_handles_.find(std::make_pair(device, kind));
+  return it == idle_handles_.end() ? 0 : it->second.size();
+}
+
+template <typename T>
+bool GPUContextResource::AcquirePooledHandle(GPUHandlePool::Kind kind,
+                                             T* handle) {
+  void* pooled = GPUHandlePool::Instance().Acquire(place_.device, kind);
+  if (pooled == nullptr) {
+    return false;
+  }
+  *handle = reinterpret_cast<T>(pooled);
+  return true;
+}
+
+template <typename T>
+void GPUContextResource::ReleasePooledHandle(GPUHandlePool::Kind kind,
+                                             T handle,
+                                             void (*destroy)(T)) {
+  if (!GPUHandlePool::Instance().Release(
+          place_.device, kind, reinterpret_cast<void*>(handle))) {
+    destroy(handle);
+  }
+}
+
 GPUContextResource::GPUContextResource(const phi::Place& place, void* stream)
     : place_(place) {
   InitGPUResource(stream);
@@ -155,6 +217,11 @@ void GPUContextResource::InitGPUResource(void* stream) {
 }
 
 void GPUContextResource::DestroyGPUResource() {
+  if (FLAGS_inference_gpu_handle_pool_size > 0) {
+    // The handles may be lent to another stream, after the work of this one.
+    phi::backends::gpu::GPUDeviceGuard guard(place_.device);
+    phi::backends::gpu::GpuStreamSync(stream_);
+  }
   if (owned_stream_) {
 #ifdef PADDLE_WITH_HIP
     PADDLE_ENFORCE_GPU_SUCCESS(hipStreamDestroy(stream_));
@@ -192,41 +259,66 @@ void GPUContextResource::InitGpuEigenDevice() {
 }
 
 void GPUContextResource::InitDnnHanlde() {
-  phi::InitDnnHandle(&dnn_handle_, stream_, place_);
+  if (AcquirePooledHandle(GPUHandlePool::Kind::kDnn, &dnn_handle_)) {
+    phi::SetDnnHandleStream(dnn_handle_, stream_);
+  } else {
+    phi::InitDnnHandle(&dnn_handle_, stream_, place_);
+  }
 }
 
 void GPUContextResource::DestroyDnnHandle() {
-  phi::DestroyDnnHandle(dnn_handle_);
+  ReleasePooledHandle(
+      GPUHandlePool::Kind::kDnn, dnn_handle_, &phi::DestroyDnnHandle);
 }
 
 void GPUContextResource::DestroyBlasHandle() {
-  phi::DestroyBlasHandle(blas_handle_);
-  phi::DestroyBlasHandle(blas_tensor_core_handle_);
-  phi::DestroyBlasHandle(blas_tf32_tensor_core_handle_);
+  ReleasePooledHandle(
+      GPUHandlePool::Kind::kBlas, blas_handle_, &phi::DestroyBlasHandle);
+  ReleasePooledHandle(GPUHandlePool::Kind::kBlasTensorCore,
+                      blas_tensor_core_handle_,
+                      &phi::DestroyBlasHandle);
+  ReleasePooledHandle(GPUHandlePool::Kind::kBlasTF32,
+                      blas_tf32_tensor_core_handle_,
+                      &phi::DestroyBlasHandle);
 }
 
 void GPUContextResource::InitBlasLtHandle() {
-  phi::InitBlasLtHandle(&blaslt_handle_);
+  if (!AcquirePooledHandle(GPUHandlePool::Kind::kBlasLt, &blaslt_handle_)) {
+    phi::InitBlasLtHandle(&blaslt_handle_);
+  }
 }
 
 void GPUContextResource::DestroyBlasLtHandle() {
-  phi::DestroyBlasLtHandle(blaslt_handle_);
+  ReleasePooledHandle(
+      GPUHandlePool::Kind::kBlasLt, blaslt_handle_, &phi::DestroyBlasLtHandle);
 }
 
 void GPUContextResource::InitSolverHandle() {
-  phi::InitSolverHandle(&solver_handle_, stream_);
+  if (AcquirePooledHandle(GPUHandlePool::Kind::kSolver, &solver_handle_)) {
+    phi::SetSolverHandleStream(solver_handle_, stream_);
+  } else {
+    phi::InitSolverHandle(&solver_handle_, stream_);
+  }
 }
 
 void GPUContextResource::DestroySolverHandle() {
-  phi::DestroySolverHandle(solver_handle_);
+  ReleasePooledHandle(GPUHandlePool::Kind::kSolver,
+                      solver_handle_,
+                      &phi::DestroySolverHandle);
 }
 
 void GPUContextResource::InitSparseHandle() {
-  phi::InitSparseHandle(&sparse_handle_, stream_);
+  if (AcquirePooledHandle(GPUHandlePool::Kind::kSparse, &sparse_handle_)) {
+    phi::SetSparseHandleStream(sparse_handle_, stream_);
+  } else {
+    phi::InitSparseHandle(&sparse_handle_, stream_);
+  }
 }
 
 void GPUContextResource::DestroySparseHandle() {
-  phi::DestroySparseHandle(sparse_handle_);
+  ReleasePooledHandle(GPUHandlePool::Kind::kSparse,
+                      sparse_handle_,
+                      &phi::DestroySparseHandle);
 }
 
 phi::Place GPUContextResource::Place() const { return place_; }
@@ -246,7 +338,11 @@ blasHandle_t GPUContextResource::GetBlasHandle() const { return blas_handle_; }
 
 std::function<phi::blasHandle_t()> GPUContextResource::GetBlasHandleCreator() {
   return [&]() -> phi::blasHandle_t {
-    phi::InitBlasHandle(&blas_handle_, stream_);
+    if (AcquirePooledHandle(GPUHandlePool::Kind::kBlas, &blas_handle_)) {
+      phi::SetBlasHandleStream(blas_handle_, stream_);
+    } else {
+      phi::InitBlasHandle(&blas_handle_, stream_);
+    }
     return blas_handle_;
   };
 }
@@ -260,9 +356,14 @@ GPUContextResource::GetBlasTensorCoreHandleCreator() {
   return [&]() -> phi::blasHandle_t {
 #ifdef PADDLE_WITH_CUDA
 #if CUDA_VERSION >= 9000
-    phi::InitBlasHandle(&blas_tensor_core_handle_, stream_);
-    PADDLE_RETRY_CUDA_SUCCESS(phi::dynload::cublasSetMathMode(
-        blas_tensor_core_handle_, CUBLAS_TENSOR_OP_MATH));
+    if (AcquirePooledHandle(GPUHandlePool::Kind::kBlasTensorCore,
+                            &blas_tensor_core_handle_)) {
+      phi::SetBlasHandleStream(blas_tensor_core_handle_, stream_);
+    } else {
+      phi::InitBlasHandle(&blas_tensor_core_handle_, stream_);
+      PADDLE_RETRY_CUDA_SUCCESS(phi::dynload::cublasSetMathMode(
+          blas_tensor_core_handle_, CUBLAS_TENSOR_OP_MATH));
+    }
 #endif
 #endif
     return blas_tensor_core_handle_;
@@ -278,9 +379,14 @@ GPUContextResource::GetBlasTF32TensorCoreHandleCreator() {
   return [&]() -> phi::blasHandle_t {
 #ifdef PADDLE_WITH_CUDA
 #if CUDA_VERSION >= 11000
-    phi::InitBlasHandle(&blas_tf32_tensor_core_handle_, stream_);
-    PADDLE_RETRY_CUDA_SUCCESS(phi::dynload::cublasSetMathMode(
-        blas_tf32_tensor_core_handle_, CUBLAS_TF32_TENSOR_OP_MATH));
+    if (AcquirePooledHandle(GPUHandlePool::Kind::kBlasTF32,
+                            &blas_tf32_tensor_core_handle_)) {
+      phi::SetBlasHandleStream(blas_tf32_tensor_core_handle_, stream_);
+    } else {
+      phi::InitBlasHandle(&blas_tf32_tensor_core_handle_, stream_);
+      PADDLE_RETRY_CUDA_SUCCESS(phi::dynload::cublasSetMathMode(
+          blas_tf32_tensor_core_handle_, CUBLAS_TF32_TENSOR_OP_MATH));
+    }
 #endif
 #endif
     return blas_tf32_tensor_core_handle_;
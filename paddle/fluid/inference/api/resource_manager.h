@@ -18,6 +18,8 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <utility>
+#include <vector>
 
 #include "paddle/fluid/platform/macros.h"
 #include "paddle/phi/api/include/tensor.h"
@@ -51,14 +53,50 @@ class CPUContextResource {
 };
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+// The idle handles of the GPU libraries of every device. The handles of a
+// destroyed GPUContextResource are kept here, and lent to the next resources
+// of the device, which bind them to their own streams. A handle is used by a
+// single resource at a time, and at most FLAGS_inference_gpu_handle_pool_size
+// idle handles of a kind are kept for a device, the others are destroyed.
+class GPUHandlePool {
+ public:
+  enum class Kind {
+    kBlas,
+    kBlasTensorCore,
+    kBlasTF32,
+    kBlasLt,
+    kDnn,
+    kSolver,
+    kSparse,
+  };
+
+  TEST_API static GPUHandlePool& Instance();
+
+  // An idle handle of the kind on the device, or nullptr if none.
+  void* Acquire(int device, Kind kind);
+
+  // Returns false if the pool is full, and the caller destroys the handle.
+  bool Release(int device, Kind kind, void* handle);
+
+  TEST_API size_t IdleSize(int device, Kind kind) const;
+
+ private:
+  GPUHandlePool() = default;
+
+  mutable std::mutex mutex_;
+  std::map<std::pair<int, Kind>, std::vector<void*>> idle_handles_;
+
+  DISABLE_COPY_AND_ASSIGN(GPUHandlePool);
+};
+
 class GPUContextResource {
  public:
-  explicit GPUContextResource(const phi::Place& place, void* stream);
+  TEST_API explicit GPUContextResource(const phi::Place& place, void* stream);
   TEST_API ~GPUContextResource();
   phi::Place Place() const;
 
   std::function<phi::dnnHandle_t()> GetDnnHandleCreator();
-  std::function<phi::blasHandle_t()> GetBlasHandleCreator();
+  TEST_API std::function<phi::blasHandle_t()> GetBlasHandleCreator();
   std::function<phi::blasHandle_t()> GetBlasTensorCoreHandleCreator();
   std::function<phi::blasHandle_t()> GetBlasTF32TensorCoreHandleCreator();
   std::function<phi::blasLtHandle_t()> GetBlasLtHandleCreator();
@@ -98,6 +136,13 @@ class GPUContextResource {
   void InitSparseHandle();
   void DestroySparseHandle();
 
+  template <typename T>
+  bool AcquirePooledHandle(GPUHandlePool::Kind kind, T* handle);
+  template <typename T>
+  void ReleasePooledHandle(GPUHandlePool::Kind kind,
+                           T handle,
+                           void (*destroy)(T));
+
  private:
   phi::Place place_;
 
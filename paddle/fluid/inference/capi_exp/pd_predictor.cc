@@ -29,6 +29,50 @@
           "The pointer of paddle predictor shouldn't be nullptr")); \
   auto& predictor = pd_predictor->predictor
 
+#define CHECK_AND_CONVERT_PD_RUN_REQUEST                              \
+  PADDLE_ENFORCE_NOT_NULL(                                            \
+      pd_request,                                                     \
+      paddle::platform::errors::InvalidArgument(                      \
+          "The pointer of paddle run request shouldn't be nullptr")); \
+  std::unique_lock<std::mutex> lock(pd_request->mutex)
+
+namespace paddle_infer {
+
+AsyncRunner::~AsyncRunner() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+void AsyncRunner::Submit(std::function<void()> task) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  tasks_.push_back(std::move(task));
+  if (!worker_.joinable()) {
+    worker_ = std::thread([this] {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (true) {
+        cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+          return;
+        }
+        auto next = std::move(tasks_.front());
+        tasks_.pop_front();
+        lock.unlock();
+        next();
+        lock.lock();
+      }
+    });
+  }
+  cv_.notify_one();
+}
+
+}  // namespace paddle_infer
+
 extern "C" {
 __pd_give PD_Predictor* PD_PredictorCreate(__pd_take PD_Config* pd_config) {
   PADDLE_ENFORCE_NOT_NULL(
@@ -143,6 +187,58 @@ PD_Bool PD_PredictorRun(__pd_keep PD_Predictor* pd_predictor) {
   return predictor->Run();  // NOLINT
 }
 
+__pd_give PD_RunRequest* PD_PredictorRunAsync(
+    __pd_keep PD_Predictor* pd_predictor,
+    PD_RunCallback callback,
+    void* user_data) {
+  CHECK_AND_CONVERT_PD_PREDICTOR;
+  if (!pd_predictor->async_runner) {
+    pd_predictor->async_runner.reset(new paddle_infer::AsyncRunner());
+  }
+  PD_RunRequest* pd_request = new PD_RunRequest();
+  paddle_infer::Predictor* raw_predictor = predictor.get();
+  pd_predictor->async_runner->Submit(
+      [raw_predictor, pd_request, callback, user_data] {
+        bool success = false;
+        try {
+          success = raw_predictor->Run();
+        } catch (const std::exception& e) {
+          LOG(ERROR) << "The asynchronous run failed: " << e.what();
+        }
+        if (callback != nullptr) {
+          callback(success, user_data);
+        }
+        // The request may be destroyed once it is done.
+        std::lock_guard<std::mutex> guard(pd_request->mutex);
+        pd_request->success = success;
+        pd_request->done = true;
+        pd_request->cv.notify_all();
+      });
+  return pd_request;
+}
+
+PD_Bool PD_RunRequestPoll(__pd_keep PD_RunRequest* pd_request) {
+  CHECK_AND_CONVERT_PD_RUN_REQUEST;
+  return pd_request->done;  // NOLINT
+}
+
+PD_Bool PD_RunRequestWait(__pd_keep PD_RunRequest* pd_request) {
+  CHECK_AND_CONVERT_PD_RUN_REQUEST;
+  pd_request->cv.wait(lock, [pd_request] { return pd_request->done; });
+  return pd_request->success;  // NOLINT
+}
+
+void PD_RunRequestDestroy(__pd_take PD_RunRequest* pd_request) {
+  if (pd_request == nullptr) {
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(pd_request->mutex);
+    pd_request->cv.wait(lock, [pd_request] { return pd_request->done; });
+  }
+  delete pd_request;
+}
+
 void PD_PredictorClearIntermediateTensor(__pd_keep PD_Predictor* pd_predictor) {
   CHECK_AND_CONVERT_PD_PREDICTOR;
   predictor->ClearIntermediateTensor();
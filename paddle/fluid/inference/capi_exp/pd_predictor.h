@@ -31,6 +31,13 @@ typedef struct PD_Config PD_Config;
 typedef struct PD_Tensor PD_Tensor;
 typedef struct PD_OneDimArrayCstr PD_OneDimArrayCstr;
 typedef struct PD_IOInfos PD_IOInfos;
+typedef struct PD_RunRequest PD_RunRequest;
+
+///
+/// \brief The callback of an asynchronous run, called on the worker thread
+/// of the predictor once the run completes.
+///
+typedef void (*PD_RunCallback)(PD_Bool success, void* user_data);
 
 #ifdef __cplusplus
 extern "C" {
@@ -131,6 +138,49 @@ PADDLE_CAPI_EXPORT extern __pd_give PD_Tensor* PD_PredictorGetOutputHandle(
 PADDLE_CAPI_EXPORT extern PD_Bool PD_PredictorRun(
     __pd_keep PD_Predictor* pd_predictor);
 
+///
+/// \brief Submit a run of the prediction engine, which is run on a worker
+/// thread of the predictor in the order of the submits. The input and output
+/// tensors shouldn't be touched until the run completes, and the inputs
+/// shared by PD_TensorShareExternalData* are read without a copy. The
+/// predictor runs on the stream set by PD_ConfigSetExecStream if any.
+///
+/// \param[in] pd_predictor predictor
+/// \param[in] callback The callback once the run completes, may be NULL.
+/// \param[in] user_data The user data passed to the callback.
+/// \return The request to poll or wait for the run.
+///
+PADDLE_CAPI_EXPORT extern __pd_give PD_RunRequest* PD_PredictorRunAsync(
+    __pd_keep PD_Predictor* pd_predictor,
+    PD_RunCallback callback,
+    void* user_data);
+
+///
+/// \brief Whether the run of the request completes, without a block.
+///
+/// \param[in] pd_request request
+/// \return Whether the run completes
+///
+PADDLE_CAPI_EXPORT extern PD_Bool PD_RunRequestPoll(
+    __pd_keep PD_RunRequest* pd_request);
+
+///
+/// \brief Wait for the run of the request to complete.
+///
+/// \param[in] pd_request request
+/// \return Whether the run executed successfully
+///
+PADDLE_CAPI_EXPORT extern PD_Bool PD_RunRequestWait(
+    __pd_keep PD_RunRequest* pd_request);
+
+///
+/// \brief Destroy a request object, after waiting for its run.
+///
+/// \param[in] pd_request request
+///
+PADDLE_CAPI_EXPORT extern void PD_RunRequestDestroy(
+    __pd_take PD_RunRequest* pd_request);
+
 /// \brief Clear the intermediate tensors of the predictor
 ///
 /// \param[in] pd_predictor predictor
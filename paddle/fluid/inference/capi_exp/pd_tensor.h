@@ -206,6 +206,86 @@ PADDLE_CAPI_EXPORT extern void PD_TensorCopyFromCpuUint8(
 PADDLE_CAPI_EXPORT extern void PD_TensorCopyFromCpuInt8(
     __pd_keep PD_Tensor* pd_tensor, const int8_t* data);
 ///
+/// \brief Share the data of the user, without a copy.
+/// It's usually used to set the input tensor data, and the data should be
+/// valid until the run of the predictor completes.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the data, which the tensor will share.
+/// \param[in] shape_size The size of the shape.
+/// \param[in] shape The shape of the data, in NCHW.
+/// \param[in] place The place of the data.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataFloat(
+    __pd_keep PD_Tensor* pd_tensor,
+    const float* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
+/// \brief Share the data of the user, without a copy.
+/// It's usually used to set the input tensor data, and the data should be
+/// valid until the run of the predictor completes.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the data, which the tensor will share.
+/// \param[in] shape_size The size of the shape.
+/// \param[in] shape The shape of the data, in NCHW.
+/// \param[in] place The place of the data.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataInt64(
+    __pd_keep PD_Tensor* pd_tensor,
+    const int64_t* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
+/// \brief Share the data of the user, without a copy.
+/// It's usually used to set the input tensor data, and the data should be
+/// valid until the run of the predictor completes.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the data, which the tensor will share.
+/// \param[in] shape_size The size of the shape.
+/// \param[in] shape The shape of the data, in NCHW.
+/// \param[in] place The place of the data.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataInt32(
+    __pd_keep PD_Tensor* pd_tensor,
+    const int32_t* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
+/// \brief Share the data of the user, without a copy.
+/// It's usually used to set the input tensor data, and the data should be
+/// valid until the run of the predictor completes.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the data, which the tensor will share.
+/// \param[in] shape_size The size of the shape.
+/// \param[in] shape The shape of the data, in NCHW.
+/// \param[in] place The place of the data.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataUint8(
+    __pd_keep PD_Tensor* pd_tensor,
+    const uint8_t* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
+/// \brief Share the data of the user, without a copy.
+/// It's usually used to set the input tensor data, and the data should be
+/// valid until the run of the predictor completes.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the data, which the tensor will share.
+/// \param[in] shape_size The size of the shape.
+/// \param[in] shape The shape of the data, in NCHW.
+/// \param[in] place The place of the data.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataInt8(
+    __pd_keep PD_Tensor* pd_tensor,
+    const int8_t* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
 /// \brief Copy the tensor data to the host memory.
 /// It's usually used to get the output tensor data.
 /// \param[in] pd_tensor tensor.
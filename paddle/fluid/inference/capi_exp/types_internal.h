@@ -14,8 +14,13 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <cstdint>
 #include <cstdio>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
 #include "paddle/fluid/inference/capi_exp/pd_common.h"
@@ -24,6 +29,37 @@ typedef struct PD_Tensor {
   std::unique_ptr<paddle_infer::Tensor> tensor;
 } PD_Tensor;
 
+namespace paddle_infer {
+
+// Runs the asynchronous runs of a predictor on a worker thread, one at a
+// time in the order of the submits, as a predictor is not thread safe. The
+// worker is started by the first submit, and the pending runs are drained
+// before it is joined.
+class AsyncRunner {
+ public:
+  AsyncRunner() = default;
+  ~AsyncRunner();
+
+  void Submit(std::function<void()> task);
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  std::thread worker_;
+  bool stop_{false};
+};
+
+}  // namespace paddle_infer
+
+typedef struct PD_RunRequest {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done{false};
+  bool success{false};
+} PD_RunRequest;
+
 typedef struct PD_Predictor {
   std::shared_ptr<paddle_infer::Predictor> predictor;
+  std::unique_ptr<paddle_infer::AsyncRunner> async_runner;
 } PD_Predictor;
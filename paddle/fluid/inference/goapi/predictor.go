@@ -145,6 +145,44 @@ func (p *Predictor) Run() {
 	C.PD_PredictorRun(p.c)
 }
 
+type RunRequest struct {
+	c *C.PD_RunRequest
+}
+
+///
+/// \brief Submit a run of the prediction engine, which is run on a worker
+/// thread of the predictor in the order of the submits. The input and output
+/// tensors shouldn't be touched until the run completes.
+///
+/// \return The request to poll or wait for the run.
+///
+func (p *Predictor) RunAsync() *RunRequest {
+	cRequest := C.PD_PredictorRunAsync(p.c, nil, nil)
+	request := &RunRequest{c: cRequest}
+	runtime.SetFinalizer(request, func(request *RunRequest) {
+		C.PD_RunRequestDestroy(request.c)
+	})
+	return request
+}
+
+///
+/// \brief Whether the run of the request completes, without a block.
+///
+/// \return Whether the run completes
+///
+func (r *RunRequest) Done() bool {
+	return cvtPDBoolToGo(C.PD_RunRequestPoll(r.c))
+}
+
+///
+/// \brief Wait for the run of the request to complete.
+///
+/// \return Whether the run executed successfully
+///
+func (r *RunRequest) Wait() bool {
+	return cvtPDBoolToGo(C.PD_RunRequestWait(r.c))
+}
+
 ///
 /// \brief Clear the intermediate tensors of the predictor
 ///
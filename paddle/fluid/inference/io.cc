@@ -15,13 +15,19 @@ limitations under the License. */
 #include "paddle/fluid/inference/io.h"
 
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <vector>
 
 #include "paddle/fluid/framework/block_desc.h"
+#include "paddle/fluid/framework/convert_utils.h"
+#include "paddle/fluid/framework/data_type.h"
 #include "paddle/fluid/framework/feed_fetch_type.h"
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/version.h"
+#ifndef _WIN32
+#include "paddle/fluid/memory/allocation/mmap_allocator.h"
+#endif
 #include "paddle/fluid/platform/cpu_helper.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/fluid/pybind/pybind.h"
@@ -76,12 +82,121 @@ bool IsPersistable(const framework::VarDesc* var) {
   return false;
 }
 
+bool LoadCombinedParamsByMmap(framework::Scope* scope,
+                              const std::vector<std::string>& params,
+                              const std::string& param_filename) {
+#ifdef _WIN32
+  return false;
+#else
+  auto file =
+      memory::allocation::AllocateMemoryMapFileAllocation(param_filename);
+  const char* base = static_cast<const char*>(file->ptr());
+  size_t file_size = file->size();
+  size_t offset = 0;
+  auto read = [&](void* dst, size_t size) {
+    PADDLE_ENFORCE_LE(
+        offset + size,
+        file_size,
+        platform::errors::Unavailable(
+            "The params file %s is truncated, please check whether the model "
+            "file is complete or damaged.",
+            param_filename));
+    memcpy(dst, base + offset, size);
+    offset += size;
+  };
+
+  size_t mapped_bytes = 0;
+  size_t copied_bytes = 0;
+  for (auto& name : params) {
+    auto* tensor = scope->Var(name)->GetMutable<phi::DenseTensor>();
+    // the same layout as DeserializeFromStream
+    uint32_t version = 0;
+    read(&version, sizeof(version));
+    PADDLE_ENFORCE_EQ(version,
+                      0U,
+                      platform::errors::InvalidArgument(
+                          "Tensor version %u of %s is not supported.",
+                          version,
+                          name));
+    uint64_t lod_level = 0;
+    read(&lod_level, sizeof(lod_level));
+    framework::LoD lod(lod_level);
+    for (auto& level : lod) {
+      uint64_t size = 0;
+      read(&size, sizeof(size));
+      level.resize(size / sizeof(size_t));
+      read(level.data(), size);
+    }
+    tensor->set_lod(lod);
+
+    read(&version, sizeof(version));
+    PADDLE_ENFORCE_EQ(version,
+                      0U,
+                      platform::errors::InvalidArgument(
+                          "Tensor version %u of %s is not supported.",
+                          version,
+                          name));
+    int32_t desc_size = -1;
+    read(&desc_size, sizeof(desc_size));
+    PADDLE_ENFORCE_EQ(
+        desc_size >= 0 && offset + desc_size <= file_size,
+        true,
+        platform::errors::InvalidArgument("Cannot parse tensor desc of %s.",
+                                          name));
+    framework::proto::VarType::TensorDesc desc;
+    PADDLE_ENFORCE_EQ(
+        desc.ParseFromArray(base + offset, desc_size),
+        true,
+        platform::errors::InvalidArgument("Cannot parse tensor desc of %s.",
+                                          name));
+    offset += desc_size;
+
+    std::vector<int64_t> dims(desc.dims().begin(), desc.dims().end());
+    tensor->Resize(common::make_ddim(dims));
+    auto dtype = framework::TransToPhiDataType(desc.data_type());
+    size_t type_size = framework::SizeOfType(desc.data_type());
+    size_t size = tensor->numel() * type_size;
+    PADDLE_ENFORCE_LE(
+        offset + size,
+        file_size,
+        platform::errors::Unavailable(
+            "The params file %s is truncated, please check whether the model "
+            "file is complete or damaged.",
+            param_filename));
+    const char* data = base + offset;
+    // the data of a tensor is not aligned in the file if the headers before
+    // it are not, such a tensor is copied
+    if (size > 0 && reinterpret_cast<uintptr_t>(data) % type_size == 0) {
+      tensor->ResetHolderWithType(
+          std::make_shared<memory::allocation::MemoryMapFileViewAllocation>(
+              const_cast<char*>(data), size, file),
+          dtype);
+      mapped_bytes += size;
+    } else {
+      memcpy(tensor->mutable_data(platform::CPUPlace(), dtype), data, size);
+      copied_bytes += size;
+    }
+    offset += size;
+  }
+  PADDLE_ENFORCE_EQ(offset,
+                    file_size,
+                    platform::errors::Unavailable(
+                        "Not allowed to load partial data of %s, the params "
+                        "of the program do not match the file.",
+                        param_filename));
+  VLOG(3) << "memory mapped " << mapped_bytes << " bytes and copied "
+          << copied_bytes << " bytes of the params file " << param_filename;
+  return true;
+#endif
+}
+
 void LoadPersistables(framework::Executor* executor,
                       framework::Scope* scope,
                       const framework::ProgramDesc& main_program,
                       const std::string& dirname,
                       const std::string& param_filename,
-                      bool model_from_memory = false) {
+                      bool model_from_memory = false,
+                      bool mmap_params) {
   const framework::BlockDesc& global_block = main_program.Block(0);
 
   framework::ProgramDesc* load_program = new framework::ProgramDesc();
@@ -122,6 +237,18 @@ void LoadPersistables(framework::Executor* executor,
   if (!param_filename.empty()) {
     // sort paramlist to have consistent ordering
     std::sort(paramlist.begin(), paramlist.end());
+    if (mmap_params && !model_from_memory &&
+        platform::is_cpu_place(executor->GetPlace()) &&
+        std::all_of(paramlist.begin(),
+                    paramlist.end(),
+                    [&load_block](const std::string& name) {
+                      return load_block->FindVar(name)->GetType() ==
+                             framework::proto::VarType::LOD_TENSOR;
+                    }) &&
+        LoadCombinedParamsByMmap(scope, paramlist, param_filename)) {
+      delete load_program;
+      return;
+    }
     // append just the load_combine op
     framework::OpDesc* op = load_block->AppendOp();
     op->SetType("load_combine");
@@ -166,7 +293,8 @@ std::unique_ptr<framework::ProgramDesc> Load(framework::Executor* executor,
                                              framework::Scope* scope,
                                              const std::string& prog_filename,
                                              const std::string& param_filename,
-                                             bool load_params) {
+                                             bool load_params,
+                                             bool mmap_params) {
   std::string program_desc_str;
   ReadBinaryFile(prog_filename, &program_desc_str);
 
@@ -183,7 +311,8 @@ std::unique_ptr<framework::ProgramDesc> Load(framework::Executor* executor,
                      *main_program,
                      "",
                      param_filename,
-                     false /* model_from_memory */);
+                     false /* model_from_memory */,
+                     mmap_params);
   }
   return main_program;
 }
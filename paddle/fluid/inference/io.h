@@ -33,7 +33,15 @@ void LoadPersistables(framework::Executor* executor,
                       const framework::ProgramDesc& main_program,
                       const std::string& dirname,
                       const std::string& param_filename,
-                      bool model_from_memory);
+                      bool model_from_memory,
+                      bool mmap_params = false);
+
+// Load the dense tensors params of the combined param_filename into scope,
+// the tensors share the pages of the memory mapped file. Returns false if the
+// file can not be mapped on this platform.
+bool LoadCombinedParamsByMmap(framework::Scope* scope,
+                              const std::vector<std::string>& params,
+                              const std::string& param_filename);
 
 std::unique_ptr<framework::ProgramDesc> Load(framework::Executor* executor,
                                              framework::Scope* scope,
@@ -43,7 +51,8 @@ std::unique_ptr<framework::ProgramDesc> Load(framework::Executor* executor,
                                              framework::Scope* scope,
                                              const std::string& prog_filename,
                                              const std::string& param_filename,
-                                             bool load_params = true);
+                                             bool load_params = true,
+                                             bool mmap_params = false);
 
 std::unique_ptr<framework::ProgramDesc> LoadFromMemory(
     framework::Executor* executor,
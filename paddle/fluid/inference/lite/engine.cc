@@ -22,6 +22,11 @@
 
 #include "paddle/fluid/inference/lite/engine.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
 #include <utility>
 
 #include "glog/logging.h"
@@ -44,8 +49,8 @@ paddle::lite_api::PaddlePredictor* EngineManager::Get(
   return engines_.at(name).get();
 }
 
-paddle::lite_api::PaddlePredictor* EngineManager::Create(
-    const std::string& name, const EngineConfig& cfg) {
+static std::shared_ptr<paddle::lite_api::PaddlePredictor> CreatePredictor(
+    const EngineConfig& cfg) {
   // config info for predictor.
   paddle::lite_api::CxxConfig lite_cxx_config;
   lite_cxx_config.set_model_buffer(
@@ -114,12 +119,54 @@ paddle::lite_api::PaddlePredictor* EngineManager::Create(
   }
 
   // create predictor
-  std::shared_ptr<paddle::lite_api::PaddlePredictor> p =
-      paddle::lite_api::CreatePaddlePredictor(lite_cxx_config);
-  engines_[name] = std::move(p);
+  return paddle::lite_api::CreatePaddlePredictor(lite_cxx_config);
+}
+
+paddle::lite_api::PaddlePredictor* EngineManager::Create(
+    const std::string& name, const EngineConfig& cfg) {
+  engines_[name] = CreatePredictor(cfg);
   return engines_[name].get();
 }
 
+void EngineManager::CreateAll(const std::vector<std::string>& names,
+                              std::vector<EngineConfig>* cfgs,
+                              int num_threads) {
+  CHECK_EQ(names.size(), cfgs->size());
+  std::vector<std::shared_ptr<paddle::lite_api::PaddlePredictor>> predictors(
+      names.size());
+  std::atomic<size_t> next{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto build = [&] {
+    for (size_t i = next++; i < names.size(); i = next++) {
+      try {
+        predictors[i] = CreatePredictor((*cfgs)[i]);
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(error_mutex);
+        if (!error) error = std::current_exception();
+      }
+      std::string().swap((*cfgs)[i].model);
+      std::string().swap((*cfgs)[i].param);
+    }
+  };
+  size_t num_workers =
+      std::min(names.size(), static_cast<size_t>(std::max(num_threads, 1)));
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < num_workers; ++i) {
+    workers.emplace_back(build);
+  }
+  build();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  for (size_t i = 0; i < names.size(); ++i) {
+    engines_[names[i]] = std::move(predictors[i]);
+  }
+}
+
 void EngineManager::Set(const std::string& name,
                         std::shared_ptr<paddle::lite_api::PaddlePredictor> p) {
   engines_[name] = p;
@@ -85,6 +85,12 @@ class EngineManager {
   paddle::lite_api::PaddlePredictor* Get(const std::string& name) const;
   paddle::lite_api::PaddlePredictor* Create(const std::string& name,
                                             const EngineConfig& cfg);
+  // Creates the engines of the names on num_threads threads, as optimizing
+  // the Lite programs takes the most of the load time. The model and params
+  // of a config are released once its engine is created.
+  void CreateAll(const std::vector<std::string>& names,
+                 std::vector<EngineConfig>* cfgs,
+                 int num_threads);
   void Set(const std::string& name,
            std::shared_ptr<paddle::lite_api::PaddlePredictor> p);
   void DeleteAll();
@@ -124,6 +124,31 @@ TEST(EngineManager, engine) {
       << "the engine_0 should be nullptr";
 }
 
+TEST(EngineManager, create_all) {
+  std::vector<std::string> keys = {"engine_1", "engine_2"};
+  std::vector<inference::lite::EngineConfig> configs(keys.size());
+  for (auto& config : configs) {
+    make_fake_model(&(config.model), &(config.param));
+    config.model_from_memory = true;
+    config.valid_places = {
+#if defined(PADDLE_WITH_ARM)
+      paddle::lite_api::Place({TARGET(kARM), PRECISION(kFloat)}),
+#else
+      paddle::lite_api::Place({TARGET(kX86), PRECISION(kFloat)}),
+#endif
+      paddle::lite_api::Place({TARGET(kHost), PRECISION(kAny)}),
+    };
+  }
+  auto& manager =
+      inference::Singleton<inference::lite::EngineManager>::Global();
+  manager.CreateAll(keys, &configs, 2);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    ASSERT_EQ(manager.Has(keys[i]), true);
+    ASSERT_EQ(configs[i].param.empty(), true);
+  }
+  manager.DeleteAll();
+}
+
 }  // namespace lite
 }  // namespace inference
 }  // namespace paddle
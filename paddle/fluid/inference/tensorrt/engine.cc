@@ -15,11 +15,13 @@ limitations under the License. */
 #include "paddle/fluid/inference/tensorrt/engine.h"
 #include <NvInfer.h>
 #include <glog/logging.h>
+#include <algorithm>
 #include <string>
 
 #include "NvInferRuntimeCommon.h"
 #include "cuda_runtime_api.h"  // NOLINT
 
+#include "paddle/fluid/inference/tensorrt/engine_store.h"
 #include "paddle/fluid/inference/tensorrt/helper.h"
 #include "paddle/fluid/inference/tensorrt/trt_int8_calibrator.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
@@ -72,8 +74,8 @@ void TensorRTEngine::InitNetwork() {
   }
 
   infer_builder_config_.reset(infer_builder_->createBuilderConfig());
-  optim_profiles_.resize(max_profile_num_);
-  for (int i = 0; i < max_profile_num_; i++)
+  optim_profiles_.resize(ProfileNum());
+  for (int i = 0; i < ProfileNum(); i++)
     optim_profiles_[i] = infer_builder_->createOptimizationProfile();
 }
 
@@ -99,11 +101,15 @@ nvinfer1::IExecutionContext *TensorRTEngine::context() {
         platform::errors::InvalidArgument(
             "TensorRT engine can not build execution context."));
     if (with_dynamic_shape()) {
+      // every predictor has its own slot of shape profiles, and starts with
+      // the widest one
+      int profile = cur_profile_num_ * shape_profile_num() +
+                    shape_profile_num() - 1;
       // need new profile if it's not the first
-      if (cur_profile_num_ > 0) {
-        infer_context->setOptimizationProfile(cur_profile_num_);
+      if (profile > 0) {
+        infer_context->setOptimizationProfile(profile);
       }
-      profile_index_[predictor_id_per_thread] = cur_profile_num_;
+      profile_index_[predictor_id_per_thread] = profile;
       ++cur_profile_num_;
     }
     infer_context_[predictor_id_per_thread].reset(infer_context);
@@ -111,6 +117,59 @@ nvinfer1::IExecutionContext *TensorRTEngine::context() {
   return infer_context_[predictor_id_per_thread].get();
 }
 
+std::vector<int> TensorRTEngine::ShapeProfileMax(const std::string &name,
+                                                 int k) {
+  auto &min_shape = min_input_shape()[name];
+  std::vector<int> max_shape = max_input_shape()[name];
+  if (k + 1 < shape_profile_num()) {
+    for (size_t d = 0; d < max_shape.size() && d < min_shape.size(); ++d) {
+      int64_t range = max_shape[d] - min_shape[d];
+      int64_t num = shape_profile_num();
+      // round up, so the profiles cover every shape of the range
+      max_shape[d] =
+          min_shape[d] + static_cast<int>((range * (k + 1) + num - 1) / num);
+    }
+  }
+  return max_shape;
+}
+
+void TensorRTEngine::SelectShapeProfile(
+    const std::map<std::string, std::vector<int64_t>> &input_shapes,
+    cudaStream_t stream) {
+  if (shape_profile_num() <= 1) {
+    return;
+  }
+  auto *infer_context = context();
+  int profile = GetProfileIndex();
+  int slot = profile / shape_profile_num();
+  int k = 0;
+  for (; k + 1 < shape_profile_num(); ++k) {
+    bool fit = true;
+    for (auto &input : input_shapes) {
+      if (min_input_shape().count(input.first) == 0) continue;
+      auto max_shape = ShapeProfileMax(input.first, k);
+      for (size_t d = 0; d < max_shape.size() && d < input.second.size();
+           ++d) {
+        fit = fit && input.second[d] <= max_shape[d];
+      }
+    }
+    if (fit) break;
+  }
+  int tightest = slot * shape_profile_num() + k;
+  if (tightest == profile) {
+    return;
+  }
+  VLOG(3) << "Switch the TensorRT profile from " << profile << " to "
+          << tightest;
+#if IS_TRT_VERSION_GE(7200)
+  infer_context->setOptimizationProfileAsync(tightest, stream);
+#else
+  infer_context->setOptimizationProfile(tightest);
+#endif
+  std::unique_lock<std::mutex> lock(mutex_);
+  profile_index_[predictor_id_per_thread] = tightest;
+}
+
 void TensorRTEngine::Execute(int batch_size,
                              std::vector<void *> *buffers,
                              cudaStream_t stream) {
@@ -313,7 +372,8 @@ void TensorRTEngine::FreezeNetwork() {
 
   if (with_dynamic_shape()) {
     LOG(INFO) << "Run Paddle-TRT Dynamic Shape mode.";
-    for (int i = 0; i < max_profile_num_; i++) {
+    for (int i = 0; i < ProfileNum(); i++) {
+      int shape_profile = i % shape_profile_num();
       for (auto &input : min_input_shape()) {
 #if IS_TRT_VERSION_LT(7100)
         // trt6/trt7011 will check all_of input > 0
@@ -329,10 +389,15 @@ void TensorRTEngine::FreezeNetwork() {
           continue;
         }
 #endif
+        auto max_shape = ShapeProfileMax(input.first, shape_profile);
+        auto opt_shape = optim_input_shape()[input.first];
+        for (size_t d = 0; d < opt_shape.size() && d < max_shape.size(); ++d) {
+          opt_shape[d] = std::min(opt_shape[d], max_shape[d]);
+        }
         VLOG(4) << "TRT dynamic_shape set " << input.first
                 << " min: " << Vec2Str(input.second)
-                << ", max: " << Vec2Str(max_input_shape()[input.first])
-                << ", opt: " << Vec2Str(optim_input_shape()[input.first]);
+                << ", max: " << Vec2Str(max_shape)
+                << ", opt: " << Vec2Str(opt_shape);
 
         optim_profiles_[i]->setDimensions(
             input.first.c_str(),
@@ -341,11 +406,11 @@ void TensorRTEngine::FreezeNetwork() {
         optim_profiles_[i]->setDimensions(
             input.first.c_str(),
             nvinfer1::OptProfileSelector::kMAX,
-            Vec2TRT_Dims(max_input_shape()[input.first], input.first, true));
+            Vec2TRT_Dims(max_shape, input.first, true));
         optim_profiles_[i]->setDimensions(
             input.first.c_str(),
             nvinfer1::OptProfileSelector::kOPT,
-            Vec2TRT_Dims(optim_input_shape()[input.first], input.first, true));
+            Vec2TRT_Dims(opt_shape, input.first, true));
       }
 
       for (int input_id = 0; input_id < network()->getNbInputs(); input_id++) {
@@ -408,12 +473,45 @@ void TensorRTEngine::FreezeNetwork() {
   }
 #endif
 
+#if IS_TRT_VERSION_GE(8000)
+  // the tactics timed by the builders of other processes are reused
+  infer_ptr<nvinfer1::ITimingCache> timing_cache;
+  if (!params_.timing_cache_path.empty()) {
+    std::string cache_data;
+    ReadEngineStoreFile(params_.timing_cache_path, &cache_data);
+    timing_cache.reset(infer_builder_config_->createTimingCache(
+        cache_data.data(), cache_data.size()));
+    if (timing_cache == nullptr) {
+      LOG(WARNING) << "Ignore the broken TensorRT timing cache "
+                   << params_.timing_cache_path;
+      timing_cache.reset(infer_builder_config_->createTimingCache(nullptr, 0));
+    }
+    infer_builder_config_->setTimingCache(*timing_cache, false);
+  }
+#endif
+
 #if IS_TRT_VERSION_LT(8000)
   infer_engine_.reset(infer_builder_->buildEngineWithConfig(
       *network(), *infer_builder_config_));
 #else
   ihost_memory_.reset(infer_builder_->buildSerializedNetwork(
       *network(), *infer_builder_config_));
+  if (timing_cache != nullptr) {
+    // merge into the latest cache file, other processes may have updated it
+    auto merge = [this, &timing_cache](const std::string &old) {
+      infer_ptr<nvinfer1::ITimingCache> merged(
+          infer_builder_config_->createTimingCache(old.data(), old.size()));
+      infer_ptr<nvinfer1::IHostMemory> data;
+      if (merged != nullptr && merged->combine(*timing_cache, true)) {
+        data.reset(merged->serialize());
+      } else {
+        data.reset(timing_cache->serialize());
+      }
+      return std::string(static_cast<const char *>(data->data()),
+                         data->size());
+    };
+    UpdateEngineStoreFile(params_.timing_cache_path, merge);
+  }
   infer_runtime_.reset(createInferRuntime(&logger_));
   infer_engine_.reset(infer_runtime_->deserializeCudaEngine(
       ihost_memory_->data(), ihost_memory_->size()));
@@ -427,7 +525,7 @@ void TensorRTEngine::FreezeNetwork() {
 
   binding_num_ = infer_engine_->getNbBindings();
   // reset status for dynamic shape clone
-  if (max_profile_num_ > 1) {
+  if (ProfileNum() > 1) {
     infer_context_.clear();
     cur_profile_num_ = 0;
   }
@@ -152,6 +152,12 @@ class TensorRTEngine {
     ShapeMapType min_shape_tensor;
     ShapeMapType max_shape_tensor;
     ShapeMapType optim_shape_tensor;
+    // The dynamic shape range [min_input_shape, max_input_shape] is split into
+    // shape_profile_num nested profiles, the k-th one covers the first
+    // (k + 1) / shape_profile_num of the range, and every run picks the
+    // tightest profile for its input shapes. All profiles of a predictor
+    // share one execution context and its device memory.
+    int shape_profile_num{1};
 
     bool use_inspector{false};
     std::string engine_info_path{""};
@@ -170,6 +176,9 @@ class TensorRTEngine {
     bool disable_trt_plugin_fp16{false};
     int optimization_level{3};
     bool use_explicit_quantization{false};
+    // The timing cache file shared by the builders of all processes, see
+    // engine_store.h.
+    std::string timing_cache_path;
   };
 
   // Weight is model parameter.
@@ -235,9 +244,18 @@ class TensorRTEngine {
   nvinfer1::IExecutionContext* context();
 
   int GetBindingsOffset() {
-    return (binding_num_ / max_profile_num_) * GetProfileIndex();
+    return (binding_num_ / ProfileNum()) * GetProfileIndex();
   }
 
+  int shape_profile_num() const { return params_.shape_profile_num; }
+
+  // Switch the execution context of the predictor to the tightest shape
+  // profile of the input shapes, it must be called before the inputs are
+  // bound.
+  void SelectShapeProfile(
+      const std::map<std::string, std::vector<int64_t>>& input_shapes,
+      cudaStream_t stream);
+
   int GetNbBindings() { return binding_num_; }
 
   void ResetContext() {
@@ -550,8 +568,14 @@ class TensorRTEngine {
 
   int device_id() { return params_.device_id; }
 
+  // profiles of predictor slots multiply the shape profiles
+  int ProfileNum() const { return max_profile_num_ * shape_profile_num(); }
+
+  // the max shape of the input name in the k-th shape profile
+  std::vector<int> ShapeProfileMax(const std::string& name, int k);
+
   int GetProfileIndex() {
-    if (max_profile_num_ > 1) {
+    if (ProfileNum() > 1) {
       std::unique_lock<std::mutex> lock(mutex_);
       return profile_index_[predictor_id_per_thread];
     } else {
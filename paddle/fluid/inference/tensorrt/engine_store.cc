@@ -0,0 +1,174 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/tensorrt/engine_store.h"
+
+#include <fcntl.h>
+#ifndef _WIN32
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "paddle/phi/core/enforce.h"
+
+namespace paddle {
+namespace inference {
+namespace tensorrt {
+
+namespace {
+
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+// Hold a lock of path + ".lock" in the scope, the lock file is never removed
+// so that all processes lock the same inode.
+class EngineStoreLock {
+ public:
+  EngineStoreLock(const std::string& path, bool exclusive) {
+#ifndef _WIN32
+    std::string lock_path = path + ".lock";
+    fd_ = open(lock_path.c_str(), O_RDWR | O_CREAT, 0644);
+    PADDLE_ENFORCE_GE(
+        fd_,
+        0,
+        phi::errors::Unavailable("Failed to open the lock file (%s) of the "
+                                 "TensorRT engine store: %s.",
+                                 lock_path,
+                                 strerror(errno)));
+    while (flock(fd_, exclusive ? LOCK_EX : LOCK_SH) != 0 && errno == EINTR) {
+    }
+#endif
+  }
+
+  ~EngineStoreLock() {
+#ifndef _WIN32
+    flock(fd_, LOCK_UN);
+    close(fd_);
+#endif
+  }
+
+ private:
+  int fd_{-1};
+};
+
+bool ReadFileUnlocked(const std::string& path, std::string* data) {
+  std::ifstream infile(path, std::ios::binary);
+  if (!infile.is_open()) {
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << infile.rdbuf();
+  *data = buffer.str();
+  return true;
+}
+
+void WriteFileUnlocked(const std::string& path, const std::string& data) {
+  // the pid keeps concurrent writers of different processes apart
+#ifndef _WIN32
+  std::string tmp_path = path + ".tmp." + std::to_string(getpid());
+#else
+  std::string tmp_path = path + ".tmp";
+#endif
+  {
+    std::ofstream outfile(tmp_path, std::ios::binary);
+    PADDLE_ENFORCE_EQ(outfile.is_open(),
+                      true,
+                      phi::errors::Unavailable(
+                          "Failed to open (%s) of the TensorRT engine store.",
+                          tmp_path));
+    outfile.write(data.data(), static_cast<std::streamsize>(data.size()));
+    outfile.close();
+    PADDLE_ENFORCE_EQ(outfile.good(),
+                      true,
+                      phi::errors::Unavailable(
+                          "Failed to write (%s) of the TensorRT engine store.",
+                          tmp_path));
+  }
+#ifdef _WIN32
+  std::remove(path.c_str());
+#endif
+  PADDLE_ENFORCE_EQ(
+      std::rename(tmp_path.c_str(), path.c_str()),
+      0,
+      phi::errors::Unavailable("Failed to rename (%s) to (%s) of the TensorRT "
+                               "engine store.",
+                               tmp_path,
+                               path));
+}
+
+}  // namespace
+
+void EngineStoreDigest::Update(const void* data, size_t size) {
+  const char* bytes = static_cast<const char*>(data);
+  size_t i = 0;
+  // a word at a time, the weights of a subgraph can be large
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word = 0;
+    std::memcpy(&word, bytes + i, sizeof(uint64_t));
+    hash_ = (hash_ ^ word) * kFnvPrime;
+  }
+  for (; i < size; ++i) {
+    hash_ = (hash_ ^ static_cast<unsigned char>(bytes[i])) * kFnvPrime;
+  }
+  // the size separates the updates, so ("ab", "c") differs from ("a", "bc")
+  size_ += size;
+  hash_ = (hash_ ^ size) * kFnvPrime;
+}
+
+void EngineStoreDigest::Update(const std::string& str) {
+  Update(str.data(), str.size());
+}
+
+std::string EngineStoreDigest::HexDigest() const {
+  char buf[40];
+  snprintf(buf,
+           sizeof(buf),
+           "%016llx%08llx",
+           static_cast<unsigned long long>(hash_),  // NOLINT
+           static_cast<unsigned long long>(size_ & 0xffffffffULL));  // NOLINT
+  return buf;
+}
+
+std::string GetEngineStorePath(const std::string& store_dir,
+                               const std::string& key) {
+  return store_dir + "/trt_engine_" + key;
+}
+
+bool ReadEngineStoreFile(const std::string& path, std::string* data) {
+  EngineStoreLock lock(path, false);
+  return ReadFileUnlocked(path, data);
+}
+
+void WriteEngineStoreFile(const std::string& path, const std::string& data) {
+  EngineStoreLock lock(path, true);
+  WriteFileUnlocked(path, data);
+}
+
+void UpdateEngineStoreFile(
+    const std::string& path,
+    const std::function<std::string(const std::string&)>& update) {
+  EngineStoreLock lock(path, true);
+  std::string data;
+  ReadFileUnlocked(path, &data);
+  WriteFileUnlocked(path, update(data));
+}
+
+}  // namespace tensorrt
+}  // namespace inference
+}  // namespace paddle
@@ -0,0 +1,66 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace paddle {
+namespace inference {
+namespace tensorrt {
+
+// An engine store is a directory shared by the processes of a host. The
+// serialized engines are saved as trt_engine_<key> files, where the key is a
+// digest of everything the engine depends on, so an engine is built once for
+// a subgraph, its weights, shape profile, precision and GPU, and reused by all
+// processes. The store also keeps a TensorRT timing cache, which the builders
+// of all processes read and merge their new tactics into.
+constexpr char kTrtTimingCacheFile[] = "trt_timing_cache";
+
+// A stable 64-bit digest that does not change between processes or builds.
+class EngineStoreDigest {
+ public:
+  void Update(const void* data, size_t size);
+  void Update(const std::string& str);
+  // the hex string of the digest
+  std::string HexDigest() const;
+
+ private:
+  uint64_t hash_{1469598103934665603ULL};
+  uint64_t size_{0};
+};
+
+std::string GetEngineStorePath(const std::string& store_dir,
+                               const std::string& key);
+
+// Read a file of the store under a shared lock, return false if the file does
+// not exist.
+bool ReadEngineStoreFile(const std::string& path, std::string* data);
+
+// Replace a file of the store atomically, readers see the old or the new
+// content but never a partial one.
+void WriteEngineStoreFile(const std::string& path, const std::string& data);
+
+// Read-modify-write a file of the store under an exclusive lock, so the
+// updates of concurrent processes are not lost. The old content is empty if
+// the file does not exist.
+void UpdateEngineStoreFile(
+    const std::string& path,
+    const std::function<std::string(const std::string&)>& update);
+
+}  // namespace tensorrt
+}  // namespace inference
+}  // namespace paddle
@@ -201,20 +201,39 @@ int CAllReducePluginDynamic::enqueue(
                       platform::errors::Unavailable(
                           "NCCLCommContext is nullptr, collective op should "
                           "has ring_id attr."));
-    auto stream = comm_ctx->GetStream();
-    ncclRedOp_t nccl_red_type = ncclSum;
-    // comm_ctx->AllReduce(&inputs[0], inputs[0], nccl_red_type, stream);
-    phi::dynload::ncclAllReduce(sendbuff,
-                                recvbuff,
-                                numel,
-                                dtype,
-                                nccl_red_type,
-                                comm_ctx->GetNcclComm(),
-                                stream);
+    cudaStream_t custream = use_calc_stream_ ? stream : comm_ctx->GetStream();
+    // stream-->compute_event-->custream, the inputs are written by the engine
+    if (custream != stream) {
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaEventRecord(comm_ctx->GetComputeEvent(), stream));
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaStreamWaitEvent(custream, comm_ctx->GetComputeEvent(), 0));
+    }
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        phi::dynload::ncclAllReduce(sendbuff,
+                                    recvbuff,
+                                    numel,
+                                    dtype,
+                                    nccl_red_type,
+                                    comm_ctx->GetNcclComm(),
+                                    custream));
+    // custream-->comm_event-->stream, the outputs are read by the engine
+    if (custream != stream) {
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaEventRecord(comm_ctx->GetCommEvent(), custream));
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaStreamWaitEvent(stream, comm_ctx->GetCommEvent(), 0));
+    }
     VLOG(3) << "new NCCLCommContext has ring_id_ " << ring_id_;
   } else {
     auto comm = platform::NCCLCommContext::Instance().Get(ring_id_);
     cudaStream_t custream = use_calc_stream_ ? stream : comm->stream();
+    if (custream != stream) {
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaEventRecord(comm->compute_event(), stream));
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaStreamWaitEvent(custream, comm->compute_event(), 0));
+    }
     PADDLE_ENFORCE_GPU_SUCCESS(platform::dynload::ncclAllReduce(sendbuff,
                                                                 recvbuff,
                                                                 numel,
@@ -222,6 +241,11 @@ int CAllReducePluginDynamic::enqueue(
                                                                 nccl_red_type,
                                                                 comm->comm(),
                                                                 custream));
+    if (custream != stream) {
+      PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(comm->comm_event(), custream));
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaStreamWaitEvent(stream, comm->comm_event(), 0));
+    }
     VLOG(3) << "old NCCLCommContext has ring_id_ " << ring_id_;
   }
 #endif
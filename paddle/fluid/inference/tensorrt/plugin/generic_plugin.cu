@@ -580,15 +580,20 @@ int GenericPlugin::enqueue(const nvinfer1::PluginTensorDesc* input_desc,
   // TODO(inference): generic plugin do not support INT8 precision now.
   auto nvType2PhiType =
       [&](nvinfer1::DataType nv_dtype) -> std::pair<phi::DataType, int> {
-    const std::map<nvinfer1::DataType, std::pair<phi::DataType, int>> _map{
-        {nvinfer1::DataType::kFLOAT, {phi::DataType::FLOAT32, sizeof(float)}},
-        {nvinfer1::DataType::kHALF, {phi::DataType::FLOAT16, sizeof(half)}},
-        {nvinfer1::DataType::kINT32, {phi::DataType::INT32, sizeof(int32_t)}},
-        {nvinfer1::DataType::kBOOL, {phi::DataType::BOOL, sizeof(bool)}},
-    };
-    CHECK(_map.count(nv_dtype))
-        << "dtype [" << static_cast<int>(nv_dtype) << "] is not supported.";
-    return _map.at(nv_dtype);
+    switch (nv_dtype) {
+      case nvinfer1::DataType::kFLOAT:
+        return {phi::DataType::FLOAT32, sizeof(float)};
+      case nvinfer1::DataType::kHALF:
+        return {phi::DataType::FLOAT16, sizeof(half)};
+      case nvinfer1::DataType::kINT32:
+        return {phi::DataType::INT32, sizeof(int32_t)};
+      case nvinfer1::DataType::kBOOL:
+        return {phi::DataType::BOOL, sizeof(bool)};
+      default:
+        LOG(FATAL) << "dtype [" << static_cast<int>(nv_dtype)
+                   << "] is not supported.";
+    }
+    return {phi::DataType::UNDEFINED, 0};
   };
 
   nvinfer1::DataType data_type;
@@ -601,63 +606,106 @@ int GenericPlugin::enqueue(const nvinfer1::PluginTensorDesc* input_desc,
   CHECK((data_type == nvinfer1::DataType::kFLOAT) ||
         (data_type == nvinfer1::DataType::kHALF));
 
-  phi_kernel_contexts_[data_type]->ClearInputOutput();
+  auto* kernel_context = phi_kernel_contexts_[data_type].get();
 
+  enqueue_key_.clear();
+  enqueue_key_.push_back(static_cast<int64_t>(data_type));
+  auto append_desc = [&](const nvinfer1::PluginTensorDesc& desc) {
+    enqueue_key_.push_back(static_cast<int64_t>(desc.type));
+    enqueue_key_.push_back(desc.dims.nbDims);
+    for (int j = 0; j < desc.dims.nbDims; j++) {
+      enqueue_key_.push_back(desc.dims.d[j]);
+    }
+  };
   for (int i = 0; i < getNbInputs(); i++) {
-    if (inputs_data_type_[i] == GeneratePluginDataType::PLUGIN_OPTIONAL) {
-      phi_kernel_contexts_[data_type]->EmplaceBackInput(nullptr);
-      continue;
+    if (inputs_data_type_[i] != GeneratePluginDataType::PLUGIN_OPTIONAL) {
+      append_desc(input_desc[i]);
     }
-    auto const& input_dims = input_desc[i].dims;
-
-    std::vector<int> input_shape;
-    for (int j = 0; j < input_dims.nbDims; j++)
-      input_shape.push_back(input_dims.d[j]);
-
-    int input_numel = 1;
-    for (int k = 0; k < input_shape.size(); k++) input_numel *= input_shape[k];
-    auto data_type_and_size = nvType2PhiType(input_desc[i].type);
-    phi::DenseTensorMeta input_meta(data_type_and_size.first,
-                                    common::make_ddim(input_shape));
-    std::shared_ptr<phi::Allocation> input_alloc(
-        new phi::Allocation((void*)(inputs[i]),  // NOLINT
-                            input_numel * data_type_and_size.second,
-                            place));
-    (*dense_tensor_inputs_)[i] =
-        std::move(phi::DenseTensor(input_alloc, input_meta));
-    phi_kernel_contexts_[data_type]->EmplaceBackInput(
-        &((*dense_tensor_inputs_)[i]));
   }
-  // output
   for (int i = 0; i < getNbOutputs(); i++) {
-    auto const& output_dims = output_desc[i].dims;
+    append_desc(output_desc[i]);
+  }
+
+  if (enqueue_key_ == cached_enqueue_key_) {
+    for (int i = 0; i < getNbInputs(); i++) {
+      if (input_views_[i]) {
+        input_views_[i]->Reset(const_cast<void*>(inputs[i]),
+                               input_views_[i]->size());
+      }
+    }
+    for (int i = 0; i < getNbOutputs(); i++) {
+      output_views_[i]->Reset(outputs[i], output_views_[i]->size());
+    }
+  } else {
+    kernel_context->ClearInputOutput();
+    input_views_.resize(getNbInputs());
+    output_views_.resize(getNbOutputs());
+
+    for (int i = 0; i < getNbInputs(); i++) {
+      if (inputs_data_type_[i] == GeneratePluginDataType::PLUGIN_OPTIONAL) {
+        kernel_context->EmplaceBackInput(nullptr);
+        continue;
+      }
+      auto const& input_dims = input_desc[i].dims;
+
+      std::vector<int> input_shape;
+      for (int j = 0; j < input_dims.nbDims; j++)
+        input_shape.push_back(input_dims.d[j]);
+
+      int input_numel = 1;
+      for (int k = 0; k < input_shape.size(); k++)
+        input_numel *= input_shape[k];
+      auto data_type_and_size = nvType2PhiType(input_desc[i].type);
+      phi::DenseTensorMeta input_meta(data_type_and_size.first,
+                                      common::make_ddim(input_shape));
+      if (!input_views_[i]) {
+        input_views_[i] = std::make_shared<TrtBufferView>(place);
+      }
+      input_views_[i]->Reset(const_cast<void*>(inputs[i]),
+                             input_numel * data_type_and_size.second);
+      (*dense_tensor_inputs_)[i] =
+          std::move(phi::DenseTensor(input_views_[i], input_meta));
+      kernel_context->EmplaceBackInput(&((*dense_tensor_inputs_)[i]));
+    }
+    // output
+    for (int i = 0; i < getNbOutputs(); i++) {
+      auto const& output_dims = output_desc[i].dims;
 
-    std::vector<int> output_shape;
-    for (int j = 0; j < output_dims.nbDims; j++)
-      output_shape.push_back(output_dims.d[j]);
+      std::vector<int> output_shape;
+      for (int j = 0; j < output_dims.nbDims; j++)
+        output_shape.push_back(output_dims.d[j]);
 
-    int output_numel = 1;
-    for (int k = 0; k < output_shape.size(); k++)
-      output_numel *= output_shape[k];
+      int output_numel = 1;
+      for (int k = 0; k < output_shape.size(); k++)
+        output_numel *= output_shape[k];
 
-    auto data_type_and_size = nvType2PhiType(output_desc[i].type);
-    phi::DenseTensorMeta output_meta(data_type_and_size.first,
-                                     common::make_ddim(output_shape));
-    std::shared_ptr<phi::Allocation> output_alloc(
-        new phi::Allocation(reinterpret_cast<void*>(outputs[i]),
-                            output_numel * data_type_and_size.second,
-                            place));
+      auto data_type_and_size = nvType2PhiType(output_desc[i].type);
+      phi::DenseTensorMeta output_meta(data_type_and_size.first,
+                                       common::make_ddim(output_shape));
+      if (!output_views_[i]) {
+        output_views_[i] = std::make_shared<TrtBufferView>(place);
+      }
+      output_views_[i]->Reset(outputs[i],
+                              output_numel * data_type_and_size.second);
 
-    (*dense_tensor_outputs_)[i] =
-        std::move(phi::DenseTensor(output_alloc, output_meta));
+      (*dense_tensor_outputs_)[i] =
+          std::move(phi::DenseTensor(output_views_[i], output_meta));
 
-    phi_kernel_contexts_[data_type]->EmplaceBackOutput(
-        &((*dense_tensor_outputs_)[i]));
+      kernel_context->EmplaceBackOutput(&((*dense_tensor_outputs_)[i]));
+    }
+    cached_enqueue_key_ = enqueue_key_;
   }
 
-  CHECK_EQ(phi_kernel_contexts_[data_type]->InputsSize(), getNbInputs());
-  CHECK_EQ(phi_kernel_contexts_[data_type]->OutputsSize(), getNbOutputs());
-  (*phi_kernels_[data_type])(phi_kernel_contexts_[data_type].get());
+  CHECK_EQ(kernel_context->InputsSize(), getNbInputs());
+  CHECK_EQ(kernel_context->OutputsSize(), getNbOutputs());
+  (*phi_kernels_[data_type])(kernel_context);
+  // the outputs reallocated by the kernel, e.g., of another data type than the
+  // buffers of TensorRT, are rebuilt in the next enqueue
+  for (int i = 0; i < getNbOutputs(); i++) {
+    if ((*dense_tensor_outputs_)[i].Holder() != output_views_[i]) {
+      cached_enqueue_key_.clear();
+    }
+  }
 
   if (op_desc_.Type() == "argsort") {
     for (int i = 0; i < getNbOutputs(); i++) {
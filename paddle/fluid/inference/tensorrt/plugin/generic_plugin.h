@@ -59,6 +59,19 @@ enum class GeneratePluginDataType {
 GeneratePluginDataType ProtoTypeToGeneratePluginDataType(
     framework::proto::VarType_Type proto_type);
 
+// A non-owning view of a device buffer given by TensorRT, reset to the buffer
+// of every enqueue instead of being allocated.
+class TrtBufferView : public phi::Allocation {
+ public:
+  explicit TrtBufferView(const phi::Place& place)
+      : phi::Allocation(nullptr, 0, place) {}
+
+  void Reset(void* ptr, size_t size) {
+    ptr_ = ptr;
+    size_ = size;
+  }
+};
+
 void BuildPhiKernelContextAttr(const framework::OpDesc& op_desc,
                                phi::KernelContext* kernel_context,
                                const phi::KernelSignature& signature,
@@ -168,6 +181,14 @@ class GenericPlugin : public DynamicPluginTensorRT {
   std::vector<phi::DenseTensor>* dense_tensor_inputs_{nullptr};
   std::vector<phi::DenseTensor>* dense_tensor_outputs_{nullptr};
 
+  // The kernel context is only rebuilt when the data types or the dims of the
+  // tensors differ from the last enqueue, otherwise the views of the tensors
+  // are reset to the buffers of TensorRT.
+  std::vector<std::shared_ptr<TrtBufferView>> input_views_;
+  std::vector<std::shared_ptr<TrtBufferView>> output_views_;
+  std::vector<int64_t> enqueue_key_;
+  std::vector<int64_t> cached_enqueue_key_;
+
  private:
   std::vector<GeneratePluginDataType> inputs_data_type_;
   std::vector<GeneratePluginDataType> outputs_data_type_;
@@ -0,0 +1,79 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+
+#include "paddle/fluid/inference/tensorrt/engine_store.h"
+
+namespace paddle {
+namespace inference {
+namespace tensorrt {
+
+TEST(EngineStore, Digest) {
+  EngineStoreDigest a;
+  a.Update("ab");
+  a.Update("c");
+  EngineStoreDigest b;
+  b.Update("a");
+  b.Update("bc");
+  EngineStoreDigest c;
+  c.Update("ab");
+  c.Update("c");
+  ASSERT_NE(a.HexDigest(), b.HexDigest());
+  ASSERT_EQ(a.HexDigest(), c.HexDigest());
+  ASSERT_EQ(a.HexDigest().size(), 24UL);
+}
+
+TEST(EngineStore, ConcurrentUpdate) {
+  std::string path = GetEngineStorePath(
+      ".", "engine_store_test_" + std::to_string(getpid()));
+  std::string data;
+  ASSERT_FALSE(ReadEngineStoreFile(path, &data));
+  WriteEngineStoreFile(path, "x");
+  ASSERT_TRUE(ReadEngineStoreFile(path, &data));
+  ASSERT_EQ(data, "x");
+
+  // every process appends to the file, no update is lost
+  const int process_num = 4;
+  const int update_num = 50;
+  for (int i = 0; i < process_num; ++i) {
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+      for (int j = 0; j < update_num; ++j) {
+        UpdateEngineStoreFile(
+            path, [](const std::string& old) { return old + "y"; });
+      }
+      _exit(0);
+    }
+  }
+  for (int i = 0; i < process_num; ++i) {
+    int status = 0;
+    wait(&status);
+    ASSERT_EQ(status, 0);
+  }
+  ASSERT_TRUE(ReadEngineStoreFile(path, &data));
+  ASSERT_EQ(data.size(), 1UL + process_num * update_num);
+  std::remove(path.c_str());
+  std::remove((path + ".lock").c_str());
+}
+
+}  // namespace tensorrt
+}  // namespace inference
+}  // namespace paddle
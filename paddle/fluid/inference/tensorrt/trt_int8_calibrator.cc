@@ -14,8 +14,15 @@
 
 #include "paddle/fluid/inference/tensorrt/trt_int8_calibrator.h"
 
+#include <fstream>
+#include <map>
+#include <sstream>
+
 #include "glog/logging.h"
 #include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_string(trt_calib_tensor_scales_file);
 
 namespace paddle {
 namespace inference {
@@ -28,35 +35,53 @@ TRTInt8Calibrator::TRTInt8Calibrator(
     const std::unordered_map<std::string, size_t>& buffers,
     int batch_size,
     std::string engine_name,
-    const platform::Place place)
+    const platform::Place place,
+    int num_slots)
     : batch_size_(batch_size), engine_name_(engine_name) {
-  int i = 0;
-  VLOG(4) << "Init a new calibrator: " << engine_name_;
+  PADDLE_ENFORCE_GT(num_slots,
+                    0,
+                    platform::errors::InvalidArgument(
+                        "The slots of the calibrator should be positive, but "
+                        "received %d.",
+                        num_slots));
+  VLOG(4) << "Init a new calibrator: " << engine_name_ << " of " << num_slots
+          << " slots";
+  data_buffers_.resize(num_slots);
+  for (int slot = 0; slot < num_slots; ++slot) {
+    for (const auto& it : buffers) {
+      phi::DenseTensor temp_tensor;
+      std::string input_name = it.first;
+      int data_size = it.second;
+      int num_ele = data_size / sizeof(int16_t);
+      framework::DDim data_shape = common::make_ddim({num_ele});
+      temp_tensor.Resize(data_shape);
+      data_tensors_.push_back(temp_tensor);
+      data_buffers_[slot][input_name] = std::pair<void*, size_t>(
+          static_cast<void*>(temp_tensor.mutable_data<int16_t>(place)),
+          data_size);
+    }
+    free_slots_.push_back(slot);
+  }
+  // the scales calibrated before for the same tensors are reused
+  std::vector<std::string> input_names;
   for (const auto& it : buffers) {
-    phi::DenseTensor temp_tensor;
-    std::string input_name = it.first;
-    int data_size = it.second;
-    int num_ele = data_size / sizeof(int16_t);
-    framework::DDim data_shape = common::make_ddim({num_ele});
-    temp_tensor.Resize(data_shape);
-    data_tensors_.push_back(temp_tensor);
-    data_buffers_[input_name] = std::pair<void*, size_t>(
-        static_cast<void*>(temp_tensor.mutable_data<int16_t>(place)),
-        data_size);
-    i += 1;
+    input_names.push_back(it.first);
+  }
+  calibration_table_ = LoadCalibrationTensorScales(input_names);
+  if (!calibration_table_.empty()) {
+    LOG(INFO) << "Reuse the calibrated tensor scales for " << engine_name_;
+    done_ = true;
   }
 }
 
 TRTInt8Calibrator::TRTInt8Calibrator(const std::string& calib_data)
-    : batch_size_(0),
-      calib_running_(false),
-      data_is_set_(false),
-      done_(true),
-      calibration_table_(calib_data) {}
+    : batch_size_(0), done_(true), calibration_table_(calib_data) {}
 
 void TRTInt8Calibrator::waitAndSetDone() {
   std::unique_lock<std::mutex> lk(mut_);
-  while ((calib_running_ || data_is_set_) && !done_) cond_.wait(lk);
+  while ((!calib_started_ || !filled_slots_.empty() || running_slot_ >= 0) &&
+         !done_)
+    cond_.wait(lk);
   if (!done_) {
     done_ = true;
     cond_.notify_all();
@@ -69,19 +94,22 @@ bool TRTInt8Calibrator::setBatch(
     const std::unordered_map<std::string, void*>& data) {
   VLOG(3) << "set batch: " << engine_name_;
   std::unique_lock<std::mutex> lk(mut_);
-  //  There is a producer and a consumer. The producer set the batch data and
-  //  the consumer get the batch data. The size of the data pool is one.
-  //  So, the producer has to wait for the consumer to finish processing before
-  //  they can set the data.
-  while ((calib_running_ || data_is_set_) && (!done_)) cond_.wait(lk);
+  //  There is a producer and a consumer. The producer set the batch data into
+  //  a free slot and the consumer get the batch data from the filled slots, so
+  //  the producer only waits when all the slots are filled or in use.
+  while (free_slots_.empty() && !done_) cond_.wait(lk);
   // The done_ is set to true using waitAndSetDone, When all calibration data
   // are processed.
   if (done_) return false;
+  int slot = free_slots_.front();
+  free_slots_.pop_front();
+  // the slot is owned by the producer, the copies are issued unlocked
+  lk.unlock();
 
   // Sets the batch.
   for (const auto& it : data) {
-    auto dataptr = data_buffers_.find(it.first);
-    if (dataptr == data_buffers_.end()) {
+    auto dataptr = data_buffers_[slot].find(it.first);
+    if (dataptr == data_buffers_[slot].end()) {
       PADDLE_THROW(platform::errors::Fatal(
           "%s input name '%s' does not match with the buffer names.",
           engine_name_,
@@ -92,7 +120,8 @@ bool TRTInt8Calibrator::setBatch(
         cudaMemcpy(d.first, it.second, d.second, cudaMemcpyDeviceToDevice));
   }
 
-  data_is_set_ = true;
+  lk.lock();
+  filled_slots_.push_back(slot);
   cond_.notify_all();
   return true;
 }
@@ -103,18 +132,24 @@ bool TRTInt8Calibrator::getBatch(void** bindings,
   VLOG(4) << "get batch: " << engine_name_;
   std::unique_lock<std::mutex> lk(mut_);
   // The consumer has just finished processing a data.
-  // The producer can set the data again.
-  calib_running_ = false;
+  // The producer can set the data into its slot again.
+  calib_started_ = true;
+  if (running_slot_ >= 0) {
+    free_slots_.push_back(running_slot_);
+    running_slot_ = -1;
+  }
   cond_.notify_all();
 
   // As long as there is data in the pool, the consumer can get it.
-  while (!data_is_set_ && !done_) cond_.wait(lk);
+  while (filled_slots_.empty() && !done_) cond_.wait(lk);
   if (done_) return false;
+  int slot = filled_slots_.front();
+  filled_slots_.pop_front();
 
   // Gets the batch
   for (int i = 0; i < num_bindings; i++) {
-    auto it = data_buffers_.find(names[i]);
-    if (it == data_buffers_.end()) {
+    auto it = data_buffers_[slot].find(names[i]);
+    if (it == data_buffers_[slot].end()) {
       try {
         PADDLE_THROW(platform::errors::Fatal(
             "Calibration engine asked for unknown tensor "
@@ -127,8 +162,7 @@ bool TRTInt8Calibrator::getBatch(void** bindings,
     bindings[i] = it->second.first;
   }
 
-  data_is_set_ = false;
-  calib_running_ = true;
+  running_slot_ = slot;
   VLOG(4) << "get batch done: " << engine_name_;
   return true;
 }
@@ -151,11 +185,79 @@ void TRTInt8Calibrator::writeCalibrationCache(const void* ptr,
   calibration_table_ = std::string((const char*)ptr, length);
   VLOG(4) << "Got calibration data for " << engine_name_ << " " << ptr
           << " length=" << length;
+  SaveCalibrationTensorScales(calibration_table_);
 }
 TRTInt8Calibrator::~TRTInt8Calibrator() {
   VLOG(4) << "Destroying calibrator for " << engine_name_;
 }
 
+// A calibration table is a header line of the calibrator, followed by a line
+// "name: scale" for every tensor.
+static void ParseCalibrationTable(const std::string& table,
+                                  std::string* header,
+                                  std::map<std::string, std::string>* scales) {
+  std::istringstream is(table);
+  std::string line;
+  while (std::getline(is, line)) {
+    size_t pos = line.rfind(": ");
+    if (pos == std::string::npos) {
+      if (!line.empty()) *header = line;
+      continue;
+    }
+    (*scales)[line.substr(0, pos)] = line.substr(pos + 2);
+  }
+}
+
+static std::mutex& CalibrationTensorScalesMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+static std::string ReadFile(const std::string& path) {
+  std::ifstream fin(path);
+  if (!fin) return "";
+  std::ostringstream os;
+  os << fin.rdbuf();
+  return os.str();
+}
+
+void SaveCalibrationTensorScales(const std::string& calibration_table) {
+  const std::string path = FLAGS_trt_calib_tensor_scales_file;
+  if (path.empty() || calibration_table.empty()) return;
+  std::lock_guard<std::mutex> guard(CalibrationTensorScalesMutex());
+  std::string header;
+  std::map<std::string, std::string> scales;
+  ParseCalibrationTable(ReadFile(path), &header, &scales);
+  // the scales of the new table are of the latest calibration
+  ParseCalibrationTable(calibration_table, &header, &scales);
+  std::ofstream fout(path);
+  if (!fout) {
+    LOG(WARNING) << "Failed to write the calibrated tensor scales to " << path;
+    return;
+  }
+  fout << header << "\n";
+  for (auto& item : scales) {
+    fout << item.first << ": " << item.second << "\n";
+  }
+  VLOG(3) << "Save the scales of " << scales.size() << " tensors to " << path;
+}
+
+std::string LoadCalibrationTensorScales(
+    const std::vector<std::string>& tensor_names) {
+  const std::string path = FLAGS_trt_calib_tensor_scales_file;
+  if (path.empty()) return "";
+  std::lock_guard<std::mutex> guard(CalibrationTensorScalesMutex());
+  std::string table = ReadFile(path);
+  std::string header;
+  std::map<std::string, std::string> scales;
+  ParseCalibrationTable(table, &header, &scales);
+  if (header.empty()) return "";
+  for (auto& name : tensor_names) {
+    if (scales.count(name) == 0) return "";
+  }
+  return table;
+}
+
 }  // namespace tensorrt
 }  // namespace inference
 }  // namespace paddle
@@ -18,6 +18,7 @@
 #include <cuda_runtime_api.h>
 
 #include <atomic>
+#include <deque>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <string>
@@ -35,12 +36,16 @@ namespace tensorrt {
 
 class TensorRTEngine;
 
+// The batches are passed from the predictor to the calibration engine through
+// a pool of num_slots buffers, so that the predictor sets the next batches
+// while the engine is calibrating on the former one.
 class TRTInt8Calibrator : public nvinfer1::IInt8EntropyCalibrator2 {
  public:
   TRTInt8Calibrator(const std::unordered_map<std::string, size_t>& buffers,
                     int batch_size,
                     std::string engine_name,
-                    const platform::Place place);
+                    const platform::Place place,
+                    int num_slots = 2);
 
   explicit TRTInt8Calibrator(const std::string& calibration_data);
   ~TRTInt8Calibrator() override;
@@ -65,20 +70,35 @@ class TRTInt8Calibrator : public nvinfer1::IInt8EntropyCalibrator2 {
  private:
   const int batch_size_;
 
-  bool calib_running_{true};
-  bool data_is_set_{false};
+  // whether the engine has asked for the first batch
+  bool calib_started_{false};
   bool done_{false};
 
   std::mutex mut_;
   std::condition_variable cond_;
 
-  std::unordered_map<std::string, std::pair<void*, size_t>> data_buffers_;
+  // the buffers of every slot, by the input names
+  std::vector<std::unordered_map<std::string, std::pair<void*, size_t>>>
+      data_buffers_;
   std::vector<phi::DenseTensor> data_tensors_;
+  std::deque<int> free_slots_;
+  std::deque<int> filled_slots_;
+  // the slot read by the engine until it asks for the next batch
+  int running_slot_{-1};
 
   std::string engine_name_;
   std::string calibration_table_;
 };
 
+// Merges the scales of the tensors in a calibration table into the table of
+// FLAGS_trt_calib_tensor_scales_file, which outlives the engines.
+void SaveCalibrationTensorScales(const std::string& calibration_table);
+
+// Returns the table of FLAGS_trt_calib_tensor_scales_file if it has the scales
+// of all the tensors, otherwise an empty string.
+std::string LoadCalibrationTensorScales(
+    const std::vector<std::string>& tensor_names);
+
 class TRTCalibratorEngine {
  public:
   TRTCalibratorEngine() {}
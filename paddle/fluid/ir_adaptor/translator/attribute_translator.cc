@@ -267,11 +267,12 @@ pir::Attribute AttributeTranslator::operator()(
 
 pir::Attribute AttributeTranslator::operator()(
     const std::string& target_type, const framework::Attribute& attr) {
-  if (special_visitors.find(target_type) == special_visitors.end()) {
+  auto iter = special_visitors.find(target_type);
+  if (iter == special_visitors.end()) {
     VLOG(10) << "[" << target_type << "] not found";
     return paddle::visit(*general_visitor, attr);
   }
-  return paddle::visit(*(special_visitors.at(target_type)), attr);
+  return paddle::visit(*(iter->second), attr);
 }
 
 }  // namespace translator
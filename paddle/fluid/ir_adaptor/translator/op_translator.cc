@@ -124,13 +124,15 @@ inline bool IsInplace(const OpDesc& op_desc) {
                         output_names.end(),
                         std::back_inserter(name_intersection));
   if (!name_intersection.empty()) {
-    std::string redundant_variables = std::accumulate(
-        std::next(name_intersection.begin()),
-        name_intersection.end(),
-        name_intersection[0],
-        [](std::string a, std::string b) { return a + "," + b; });
-    VLOG(4) << "Following variables occur both in inputs and outputs: "
-            << redundant_variables;
+    if (VLOG_IS_ON(4)) {
+      std::string redundant_variables = std::accumulate(
+          std::next(name_intersection.begin()),
+          name_intersection.end(),
+          name_intersection[0],
+          [](std::string a, std::string b) { return a + "," + b; });
+      VLOG(4) << "Following variables occur both in inputs and outputs: "
+              << redundant_variables;
+    }
     return true;
   }
 
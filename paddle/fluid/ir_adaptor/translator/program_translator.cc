@@ -601,22 +601,16 @@ void ProgramTranslator::GetParameterForSingleBlock(const BlockDesc& block) {
       const auto& input_var_names = n.second;
       for (const auto& var_name : input_var_names) {
         if (no_cast_var_names.count(var_name) != 0) continue;
-        VarDesc* var_desc = nullptr;
-
         bool is_parameter = (parameter_name_mappings_.find(var_name) !=
                              parameter_name_mappings_.end());
         is_parameter &= (parameter_visited_.count(var_name) == 0);
-        if (is_parameter) {
-          var_desc = parameter_name_mappings_[var_name];
-        }
         bool is_unseen_variable =
             (inner_defining_variables.count(var_name) == 0);
-        if (is_unseen_variable) {
-          var_desc = block.FindVarRecursive(var_name);
-        }
 
         bool need_parameter_op = is_parameter && is_unseen_variable;
         if (need_parameter_op) {
+          // Only the parameters are looked up in the block, not every input.
+          VarDesc* var_desc = block.FindVarRecursive(var_name);
           PADDLE_ENFORCE_NOT_NULL(
               var_desc,
               phi::errors::PreconditionNotMet(
@@ -680,14 +674,15 @@ void ProgramTranslator::SetParameterFromSingleBlock(const BlockDesc& block) {
           pir::Operation* op = InsertSetParamaterOp(
               ctx_, defining_op_result, parameter_name_mappings_[var_name]);
 
+          // The defining operation knows its position, so the set
+          // parameter op is inserted after it without searching the block.
           pir::Block* block = program_->block();
-          pir::Block::Iterator insert_pos = std::find(
-              block->begin(), block->end(), *defining_op_result.owner());
-
+          pir::Operation* defining_op = defining_op_result.owner();
           IR_ENFORCE(
-              insert_pos != block->end(),
+              defining_op->GetParent() == block,
               "Parameter %s must have corresponding its defining operation",
               var_name);
+          pir::Block::Iterator insert_pos = *defining_op;
           insert_pos++;
 
           block->insert(insert_pos, op);
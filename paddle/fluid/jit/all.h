@@ -14,7 +14,8 @@
 
 #pragma once
 
-#include "function.h"          //NOLINT
-#include "layer.h"             // NOLINT
-#include "serializer.h"        // NOLINT
-#include "serializer_utils.h"  // NOLINT
+#include "function.h"           //NOLINT
+#include "layer.h"              // NOLINT
+#include "prepared_function.h"  // NOLINT
+#include "serializer.h"         // NOLINT
+#include "serializer_utils.h"   // NOLINT
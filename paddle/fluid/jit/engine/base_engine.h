@@ -29,6 +29,14 @@ class BaseEngine {
 
   virtual std::vector<Tensor> operator()(const std::vector<Tensor> &inputs) = 0;
 
+  // Runs with the allocated outputs as the buffers of the results, which the
+  // kernels write in place when they fit. The engines without it return new
+  // outputs, and PreparedFunction copies them into the buffers.
+  virtual void Run(const std::vector<DenseTensor> &inputs,
+                   std::vector<DenseTensor> *outputs) {
+    *outputs = (*this)(inputs);
+  }
+
   virtual std::unique_ptr<BaseEngine> Clone(void *stream = nullptr) = 0;
 
   virtual ~BaseEngine() {}
@@ -14,6 +14,8 @@
 
 #include "paddle/fluid/jit/engine/interpreter_engine.h"
 
+#include <algorithm>
+
 #include "paddle/fluid/framework/block_desc.h"
 #include "paddle/fluid/framework/ir/graph.h"
 #include "paddle/fluid/framework/ir/graph_helper.h"
@@ -82,18 +84,34 @@ std::vector<Tensor> InterpreterEngine::operator()(
 
 std::vector<DenseTensor> InterpreterEngine::operator()(
     const std::vector<DenseTensor> &inputs) {
-  utils::ShareIntoScope(info_->InputArgNames(), inputs, &scope_);
+  std::vector<DenseTensor> outputs;
+  Run(inputs, &outputs);
+  return outputs;
+}
 
-  // the latter can be moved to python side.
+void InterpreterEngine::Run(const std::vector<DenseTensor> &inputs,
+                            std::vector<DenseTensor> *outputs) {
   auto &feed_names = info_->InputArgNames();
   auto &fetch_names = info_->OutputArgNames();
-  paddle::framework::FetchList outs = inner_interpreter_->Run(feed_names);
-
-  std::vector<DenseTensor> outputs;
-  utils::FetchOuts(info_->OutputArgNames(), scope_, &outputs);
+  utils::ShareIntoScope(feed_names, inputs, &scope_);
+
+  // The outputs keep the buffers of the caller in the scope, so the kernels
+  // allocate nothing once they fit.
+  for (size_t i = 0; i < outputs->size() && i < fetch_names.size(); ++i) {
+    const auto &buffer = (*outputs)[i];
+    if (!buffer.initialized() ||
+        std::find(feed_names.begin(), feed_names.end(), fetch_names[i]) !=
+            feed_names.end()) {
+      continue;
+    }
+    scope_.Var(fetch_names[i])->GetMutable<DenseTensor>()->ShareBufferWith(
+        buffer);
+  }
+  inner_interpreter_->Run(feed_names, /*need_fetch=*/false);
+
+  outputs->clear();
+  utils::FetchOuts(fetch_names, scope_, outputs);
   scope_.DropKids();
-
-  return outputs;
 }
 
 const std::shared_ptr<FunctionInfo> &InterpreterEngine::Info() const {
@@ -48,6 +48,9 @@ class InterpreterEngine : public BaseEngine {
   std::vector<DenseTensor> operator()(
       const std::vector<DenseTensor> &inputs) override;
 
+  void Run(const std::vector<DenseTensor> &inputs,
+           std::vector<DenseTensor> *outputs) override;
+
   const std::shared_ptr<FunctionInfo> &Info() const;
 
   std::unique_ptr<BaseEngine> Clone(void *stream = nullptr) override;
@@ -22,6 +22,7 @@
 #include "paddle/fluid/jit/engine/base_engine.h"
 #include "paddle/fluid/jit/function.h"
 #include "paddle/fluid/jit/function_schema.h"
+#include "paddle/fluid/jit/prepared_function.h"
 
 namespace paddle {
 namespace jit {
@@ -77,6 +78,11 @@ std::vector<std::string> Layer::FunctionNames() const {
   return names;
 }
 
+std::shared_ptr<PreparedFunction> Layer::Prepare(
+    const std::string& name) const {
+  return std::make_shared<PreparedFunction>(unit_->GetEngine(name));
+}
+
 #define PD_SPECIALIZE_ATTRIBUTE_TYPE(T)                               \
   template <>                                                         \
   T Layer::Attribute<T>(const std::string& name) const {              \
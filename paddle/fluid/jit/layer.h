@@ -33,6 +33,7 @@ class Variable;
 namespace jit {
 class CompilationUnit;
 class FunctionInfo;
+class PreparedFunction;
 
 using DenseTensor = phi::DenseTensor;
 using Tensor = paddle::Tensor;
@@ -67,6 +68,10 @@ class Layer {
 
   std::vector<std::string> FunctionNames() const;
 
+  // Prepares the function for the low latency calls from many threads, see
+  // PreparedFunction.
+  std::shared_ptr<PreparedFunction> Prepare(const std::string& name) const;
+
   std::shared_ptr<Layer> Clone(void* stream = nullptr);
 
  private:
@@ -0,0 +1,52 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/jit/prepared_function.h"
+
+#include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/fluid/jit/engine/base_engine.h"
+
+namespace paddle {
+namespace jit {
+
+PreparedFunction::PreparedFunction(const std::shared_ptr<BaseEngine>& engine)
+    : engine_(engine) {}
+
+PreparedFunction::~PreparedFunction() = default;
+
+BaseEngine* PreparedFunction::ThreadEngine() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& engine = engines_[std::this_thread::get_id()];
+  if (!engine) engine = engine_->Clone();
+  return engine.get();
+}
+
+void PreparedFunction::operator()(const std::vector<DenseTensor>& inputs,
+                                  std::vector<DenseTensor>* outputs) {
+  auto* engine = ThreadEngine();
+  std::vector<DenseTensor> buffers = *outputs;
+  engine->Run(inputs, outputs);
+  for (size_t i = 0; i < buffers.size() && i < outputs->size(); ++i) {
+    auto& result = (*outputs)[i];
+    if (!buffers[i].initialized() || !result.initialized() ||
+        result.data() == buffers[i].data()) {
+      continue;
+    }
+    framework::TensorCopy(result, buffers[i].place(), &buffers[i]);
+    result = buffers[i];
+  }
+}
+
+}  // namespace jit
+}  // namespace paddle
@@ -0,0 +1,61 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace paddle {
+namespace jit {
+class BaseEngine;
+using DenseTensor = phi::DenseTensor;
+
+// A function of a Layer prepared for the low latency calls. Every calling
+// thread runs its own clone of the engine, so that the calls on one Layer are
+// concurrent while the scope and the interpreter of a thread stay warm
+// between its calls. The outputs passed in are the buffers of the results:
+//
+//   auto forward = layer.Prepare("forward");
+//   std::vector<DenseTensor> outputs;  // Kept by the caller over the calls.
+//   (*forward)(inputs, &outputs);
+//
+// The kernels write the results into the buffers in place once they fit, and
+// the results are copied into them otherwise, so the steady state calls
+// allocate no tensors.
+class PreparedFunction {
+ public:
+  explicit PreparedFunction(const std::shared_ptr<BaseEngine>& engine);
+
+  ~PreparedFunction();
+
+  void operator()(const std::vector<DenseTensor>& inputs,
+                  std::vector<DenseTensor>* outputs);
+
+ private:
+  BaseEngine* ThreadEngine();
+
+  // The prototype of the clones, which is never run here.
+  std::shared_ptr<BaseEngine> engine_;
+  std::mutex mutex_;
+  std::unordered_map<std::thread::id, std::unique_ptr<BaseEngine>> engines_;
+};
+
+}  // namespace jit
+}  // namespace paddle
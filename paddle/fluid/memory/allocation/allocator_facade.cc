@@ -14,18 +14,25 @@
 
 #include "paddle/fluid/memory/allocation/allocator_facade.h"
 
+#include <mutex>
+#include <sstream>
+
 #include "paddle/common/macros.h"
 #include "paddle/fluid/memory/allocation/aligned_allocator.h"
 #include "paddle/fluid/memory/allocation/allocator.h"
 #include "paddle/fluid/memory/allocation/allocator_strategy.h"
 #include "paddle/fluid/memory/allocation/auto_growth_best_fit_allocator.h"
 #include "paddle/fluid/memory/allocation/cpu_allocator.h"
+#include "paddle/fluid/memory/allocation/lifetime_pool_allocator.h"
 #include "paddle/fluid/memory/allocation/naive_best_fit_allocator.h"
 #include "paddle/fluid/memory/allocation/retry_allocator.h"
 #include "paddle/fluid/memory/allocation/stat_allocator.h"
+#include "paddle/fluid/memory/allocation/thread_cached_allocator.h"
+#include "paddle/fluid/memory/stats.h"
 #include "paddle/fluid/platform/device_context.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/fluid/platform/place.h"
+#include "paddle/phi/core/metrics.h"
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 #include <shared_mutex>
@@ -47,6 +54,10 @@
 #include "paddle/fluid/memory/allocation/virtual_memory_auto_growth_best_fit_allocator.h"
 #include "paddle/fluid/platform/dynload/cuda_driver.h"
 #endif
+
+#if CUDA_VERSION >= 11020
+#include "paddle/fluid/memory/allocation/cuda_malloc_async_allocator.h"
+#endif
 #endif
 
 #ifdef PADDLE_WITH_XPU
@@ -95,6 +106,35 @@ PADDLE_DEFINE_EXPORTED_bool(use_cuda_managed_memory,
                             "managed memory, only available for auto_growth "
                             "strategy");
 
+PADDLE_DEFINE_EXPORTED_bool(
+    use_thread_cached_cpu_allocator,
+    false,
+    "Whether to put a per-thread cache in front of an "
+    "AutoGrowthBestFitAllocator to allocate CPU memory, so that the small "
+    "allocations of different threads do not serialize on one lock. Only "
+    "available for auto_growth strategy");
+
+PADDLE_DEFINE_EXPORTED_uint64(
+    thread_cached_cpu_allocator_max_bytes_per_thread,
+    16ul << 20,
+    "The maximum bytes of free CPU memory cached by each thread when "
+    "FLAGS_use_thread_cached_cpu_allocator is true");
+
+PADDLE_DEFINE_EXPORTED_bool(
+    use_lifetime_memory_pool,
+    false,
+    "Whether to serve the GPU allocations tagged as micro-batch or step "
+    "local by the executor, e.g. in pipeline and gradient accumulation "
+    "training, from an arena of each lifetime, so that they do not fragment "
+    "the chunks of the long-lived blocks. Only available for auto_growth "
+    "strategy");
+
+PADDLE_DEFINE_EXPORTED_uint64(
+    lifetime_memory_pool_chunk_size_in_mb,
+    64,
+    "The size of the chunks of the arenas when "
+    "FLAGS_use_lifetime_memory_pool is true");
+
 PHI_DECLARE_string(allocator_strategy);
 PHI_DECLARE_uint64(auto_growth_chunk_size_in_mb);
 PHI_DECLARE_bool(use_auto_growth_pinned_allocator);
@@ -184,6 +224,12 @@ class AllocatorFacadePrivate {
   explicit AllocatorFacadePrivate(bool allow_free_idle_chunk = true) {
     strategy_ = GetAllocatorStrategy();
     is_stream_safe_cuda_allocator_used_ = false;
+    // The memory pools of CUDA Graph are kept by the auto_growth allocators,
+    // whose chunks are never freed during the capturing.
+    if (!allow_free_idle_chunk &&
+        strategy_ == AllocatorStrategy::kCUDAMallocAsync) {
+      strategy_ = AllocatorStrategy::kAutoGrowth;
+    }
 
     switch (strategy_) {
       case AllocatorStrategy::kNaiveBestFit: {
@@ -218,13 +264,21 @@ class AllocatorFacadePrivate {
       }
 
       case AllocatorStrategy::kAutoGrowth: {
-        InitNaiveBestFitCPUAllocator();
+        if (FLAGS_use_thread_cached_cpu_allocator) {
+          InitThreadCachedCPUAllocator();
+        } else {
+          InitNaiveBestFitCPUAllocator();
+        }
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
         allow_free_idle_chunk_ = allow_free_idle_chunk;
         for (int dev_id = 0; dev_id < platform::GetGPUDeviceCount(); ++dev_id) {
           InitAutoGrowthCUDAAllocator(platform::CUDAPlace(dev_id),
                                       allow_free_idle_chunk_);
         }
+        // The CUDA graph pools keep their own blocks.
+        if (FLAGS_use_lifetime_memory_pool && allow_free_idle_chunk_) {
+          WrapLifetimePoolAllocator();
+        }
 
         // Note(Ruibiao): For GPU multi-stream case without CUDA graph
         // capturing, the 'allocators_' map(place -> Allocator) hold the
@@ -282,6 +336,32 @@ class AllocatorFacadePrivate {
         break;
       }
 
+      case AllocatorStrategy::kCUDAMallocAsync: {
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+        if (FLAGS_use_thread_cached_cpu_allocator) {
+          InitThreadCachedCPUAllocator();
+        } else {
+          InitNaiveBestFitCPUAllocator();
+        }
+        allow_free_idle_chunk_ = allow_free_idle_chunk;
+        for (int dev_id = 0; dev_id < platform::GetGPUDeviceCount(); ++dev_id) {
+          InitCUDAMallocAsyncAllocator(platform::CUDAPlace(dev_id));
+        }
+        if (FLAGS_use_stream_safe_cuda_allocator) {
+          if (LIKELY(!IsCUDAGraphCapturing())) {
+            WrapStreamSafeCUDAAllocatorForDefault();
+          }
+          is_stream_safe_cuda_allocator_used_ = true;
+        }
+        InitNaiveBestFitCUDAPinnedAllocator();
+#else
+        PADDLE_THROW(platform::errors::Unimplemented(
+            "The cuda_malloc_async allocator strategy needs PaddlePaddle "
+            "compiled with CUDA 11.2 or later."));
+#endif
+        break;
+      }
+
       case AllocatorStrategy::kThreadLocal: {
         InitNaiveBestFitCPUAllocator();
 #ifdef PADDLE_WITH_XPU
@@ -437,6 +517,20 @@ class AllocatorFacadePrivate {
             << place;
   }
 
+  // The memory of the default stream is allocated and freed on the stream of
+  // the device context once it is made.
+  void SetCUDAMallocAsyncStream(const platform::CUDAPlace& place,
+                                gpuStream_t stream) {
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+    auto iter = default_cuda_malloc_async_allocators_.find(place);
+    if (iter != default_cuda_malloc_async_allocators_.end()) {
+      iter->second->SetStream(stream);
+      VLOG(8) << "Set stream " << stream << " for CUDAMallocAsyncAllocator in "
+              << place;
+    }
+#endif
+  }
+
   void RecordStream(std::shared_ptr<phi::Allocation> allocation,
                     gpuStream_t stream) {
     std::shared_ptr<StreamSafeCUDAAllocation> stream_safe_cuda_allocation =
@@ -730,6 +824,31 @@ class AllocatorFacadePrivate {
 #endif
   }
 
+  // Label the AutoGrowthBestFitAllocator created for a non-default stream, so
+  // that its FragmentationInfo tells which stream owns the memory.
+  static void SetAutoGrowthAllocatorOwner(
+      const std::shared_ptr<Allocator>& allocator, const void* stream) {
+    auto* auto_growth_allocator =
+        dynamic_cast<AutoGrowthBestFitAllocator*>(allocator.get());
+    if (auto_growth_allocator != nullptr) {
+      std::stringstream ss;
+      ss << "stream " << stream;
+      auto_growth_allocator->SetOwner(ss.str());
+    }
+  }
+
+  void InitThreadCachedCPUAllocator() {
+    auto chunk_size = FLAGS_auto_growth_chunk_size_in_mb << 20;
+    auto auto_growth_allocator = std::make_shared<AutoGrowthBestFitAllocator>(
+        std::make_shared<CPUAllocator>(),
+        /*alignment=*/64,
+        chunk_size,
+        /*allow_free_idle_chunk=*/true);
+    allocators_[platform::CPUPlace()] = std::make_shared<ThreadCachedAllocator>(
+        auto_growth_allocator,
+        FLAGS_thread_cached_cpu_allocator_max_bytes_per_thread);
+  }
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   void InitNaiveBestFitCUDAPinnedAllocator() {
     if (FLAGS_use_auto_growth_pinned_allocator) {
@@ -784,16 +903,29 @@ class AllocatorFacadePrivate {
 
   void InitStreamSafeCUDAAllocator(platform::CUDAPlace p, gpuStream_t stream) {
     PADDLE_ENFORCE_EQ(
-        strategy_,
-        AllocatorStrategy::kAutoGrowth,
+        strategy_ == AllocatorStrategy::kAutoGrowth ||
+            strategy_ == AllocatorStrategy::kCUDAMallocAsync,
+        true,
         platform::errors::Unimplemented(
-            "Only support auto-growth strategey for StreamSafeCUDAAllocator, "
-            "the allocator strategy %d is unsupported for multi-stream",
+            "Only support auto-growth and cuda_malloc_async strategey for "
+            "StreamSafeCUDAAllocator, the allocator strategy %d is "
+            "unsupported for multi-stream",
             static_cast<int>(strategy_)));
     if (LIKELY(!HasCUDAAllocator(p, stream))) {
       VLOG(8) << "Init CUDA allocator for stream " << stream << " in place "
               << p;
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+      if (strategy_ == AllocatorStrategy::kCUDAMallocAsync) {
+        cuda_allocators_[p][stream] =
+            std::make_shared<CUDAMallocAsyncAllocator>(p, stream);
+      } else {
+        InitAutoGrowthCUDAAllocator(p, stream);
+        SetAutoGrowthAllocatorOwner(cuda_allocators_[p][stream], stream);
+      }
+#else
       InitAutoGrowthCUDAAllocator(p, stream);
+      SetAutoGrowthAllocatorOwner(cuda_allocators_[p][stream], stream);
+#endif
       WrapStreamSafeCUDAAllocator(p, stream);
       WrapCUDARetryAllocator(p, stream, FLAGS_gpu_allocator_retry_time);
       WrapStatAllocator(p, stream);
@@ -969,6 +1101,16 @@ class AllocatorFacadePrivate {
 #endif
   }
 
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+  void InitCUDAMallocAsyncAllocator(platform::CUDAPlace p) {
+    // The stream is set by SetCUDAMallocAsyncStream with the default stream.
+    auto allocator = std::make_shared<CUDAMallocAsyncAllocator>(
+        p, /* stream = */ nullptr);
+    default_cuda_malloc_async_allocators_[p] = allocator;
+    allocators_[p] = allocator;
+  }
+#endif
+
   void InitThreadLocalCUDAAllocator(platform::CUDAPlace p) {
     allocators_[p] = std::make_shared<ThreadLocalCUDAAllocator>(p);
   }
@@ -982,6 +1124,18 @@ class AllocatorFacadePrivate {
         /* in_cuda_graph_capturing = */ !allow_free_idle_chunk_);
   }
 
+  void WrapLifetimePoolAllocator() {
+    for (auto& pair : allocators_) {
+      if (platform::is_gpu_place(pair.first)) {
+        pair.second = std::make_shared<LifetimePoolAllocator>(
+            pair.second,
+            platform::GpuMinChunkSize(),
+            FLAGS_lifetime_memory_pool_chunk_size_in_mb << 20);
+        VLOG(8) << "WrapLifetimePoolAllocator for " << pair.first;
+      }
+    }
+  }
+
   void WrapStreamSafeCUDAAllocatorForDefault() {
     for (auto& pair : allocators_) {
       auto& place = pair.first;
@@ -1064,6 +1218,7 @@ class AllocatorFacadePrivate {
       VLOG(8) << "Init XPU allocator for stream " << stream << " in place "
               << p;
       InitAutoGrowthXPUAllocator(p, stream);
+      SetAutoGrowthAllocatorOwner(xpu_allocators_[p][stream], stream);
 
       WrapStreamSafeXPUAllocator(p, stream);
 
@@ -1176,6 +1331,8 @@ class AllocatorFacadePrivate {
       VLOG(8) << "Init StreamSafeCustomDeviceAllocator for stream " << stream
               << " in place " << p;
       InitAutoGrowthCustomDeviceAllocator(p, stream);
+      SetAutoGrowthAllocatorOwner(custom_device_allocators_[p][stream],
+                                  stream);
       WrapStreamSafeCustomDeviceAllocator(p, stream);
     }
   }
@@ -1381,6 +1538,11 @@ class AllocatorFacadePrivate {
   std::shared_timed_mutex custom_device_allocator_mutex_;
 #endif
 
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+  std::map<platform::CUDAPlace, std::shared_ptr<CUDAMallocAsyncAllocator>>
+      default_cuda_malloc_async_allocators_;
+#endif
+
   AllocatorStrategy strategy_;
   AllocatorMap allocators_;
   static AllocatorMap zero_size_allocators_;
@@ -1464,6 +1626,68 @@ uint64_t AllocatorFacade::Release(const platform::Place& place) {
       ->Release(place);
 }
 
+std::vector<FragmentationInfo> AllocatorFacade::GetFragmentationInfo(
+    const platform::Place& place) {
+  return AutoGrowthBestFitAllocator::CollectFragmentationInfo(place);
+}
+
+// The fraction of the free memory of the auto_growth allocators of the place
+// that is not in the largest free blocks, 0 if the free memory is in one
+// block.
+static double MemoryFragmentation(const platform::Place& place) {
+  size_t free_size = 0, largest_free_block = 0;
+  for (const auto& info :
+       AutoGrowthBestFitAllocator::CollectFragmentationInfo(place)) {
+    free_size += info.free_size;
+    largest_free_block += info.largest_free_block;
+  }
+  return free_size == 0 ? 0.0 : 1.0 - static_cast<double>(largest_free_block) /
+                                          static_cast<double>(free_size);
+}
+
+void RegisterAllocatorMetrics() {
+  static std::once_flag once;
+  std::call_once(once, [] {
+    auto& registry = phi::metrics::MetricsRegistry::Instance();
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    for (int dev_id : platform::GetSelectedDevices()) {
+      const phi::metrics::Labels labels = {{"device", std::to_string(dev_id)}};
+      registry.RegisterCallbackGauge(
+          "paddle_allocator_allocated_bytes",
+          "The bytes allocated by the device allocators.",
+          labels,
+          [dev_id] {
+            return DeviceMemoryStatCurrentValue("Allocated", dev_id);
+          });
+      registry.RegisterCallbackGauge(
+          "paddle_allocator_reserved_bytes",
+          "The bytes reserved by the device allocators.",
+          labels,
+          [dev_id] {
+            return DeviceMemoryStatCurrentValue("Reserved", dev_id);
+          });
+      registry.RegisterCallbackGauge(
+          "paddle_allocator_fragmentation",
+          "The fraction of the free memory not in the largest free blocks.",
+          labels,
+          [dev_id] {
+            return MemoryFragmentation(platform::CUDAPlace(dev_id));
+          });
+    }
+#endif
+    registry.RegisterCallbackGauge(
+        "paddle_allocator_allocated_bytes",
+        "The bytes allocated by the device allocators.",
+        {{"device", "cpu"}},
+        [] { return HostMemoryStatCurrentValue("Allocated", 0); });
+    registry.RegisterCallbackGauge(
+        "paddle_allocator_reserved_bytes",
+        "The bytes reserved by the device allocators.",
+        {{"device", "cpu"}},
+        [] { return HostMemoryStatCurrentValue("Reserved", 0); });
+  });
+}
+
 std::shared_ptr<phi::Allocation> AllocatorFacade::AllocShared(
     const platform::Place& place, size_t size, const phi::Stream& stream) {
   return std::shared_ptr<phi::Allocation>(Alloc(place, size, stream));
@@ -1574,6 +1798,7 @@ gpuStream_t AllocatorFacade::GetStream(
 
 void AllocatorFacade::SetDefaultStream(const platform::CUDAPlace& place,
                                        gpuStream_t stream) {
+  m_->SetCUDAMallocAsyncStream(place, stream);
   if (m_->IsStreamSafeCUDAAllocatorUsed()) {
     m_->SetDefaultStream(place, stream);
   }
@@ -1581,11 +1806,14 @@ void AllocatorFacade::SetDefaultStream(const platform::CUDAPlace& place,
 
 #ifdef PADDLE_WITH_CUDA
 void AllocatorFacade::PrepareMemoryPoolForCUDAGraph(int64_t id) {
-  PADDLE_ENFORCE_EQ(GetAllocatorStrategy(),
-                    AllocatorStrategy::kAutoGrowth,
+  PADDLE_ENFORCE_EQ(GetAllocatorStrategy() == AllocatorStrategy::kAutoGrowth ||
+                        GetAllocatorStrategy() ==
+                            AllocatorStrategy::kCUDAMallocAsync,
+                    true,
                     platform::errors::InvalidArgument(
                         "CUDA Graph is only supported when the "
-                        "FLAGS_allocator_strategy=\"auto_growth\", but got "
+                        "FLAGS_allocator_strategy=\"auto_growth\" or "
+                        "\"cuda_malloc_async\", but got "
                         "FLAGS_allocator_strategy=\"%s\"",
                         FLAGS_allocator_strategy));
   auto& allocator = cuda_graph_map_[id];
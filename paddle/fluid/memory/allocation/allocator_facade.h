@@ -14,8 +14,10 @@
 
 #pragma once
 #include <memory>
+#include <vector>
 
 #include "paddle/fluid/memory/allocation/allocator.h"
+#include "paddle/fluid/memory/allocation/auto_growth_best_fit_allocator.h"
 #ifdef PADDLE_WITH_CUDA
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #endif
@@ -67,6 +69,10 @@ class AllocatorFacade {
   AllocationPtr Alloc(const platform::Place& place, size_t size);
   // Release unused memory pool.
   uint64_t Release(const platform::Place& place);
+  // Get the chunks and free blocks of the auto_growth allocators in place,
+  // one for each stream, empty for other allocator strategies.
+  std::vector<FragmentationInfo> GetFragmentationInfo(
+      const platform::Place& place);
 
   std::shared_ptr<Allocation> AllocShared(const platform::Place& place,
                                           size_t size,
@@ -121,6 +127,10 @@ class AllocatorFacade {
 #endif
 };
 
+// Registers the allocated and reserved bytes and the fragmentation of the
+// device allocators to the runtime metrics, only once in a process.
+void RegisterAllocatorMetrics();
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
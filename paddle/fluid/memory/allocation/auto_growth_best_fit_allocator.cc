@@ -16,6 +16,8 @@
 
 #include <algorithm>
 #include <mutex>  // NOLINT
+#include <sstream>
+#include <unordered_set>
 
 #include "paddle/fluid/memory/allocation/aligned_allocator.h"
 #include "paddle/fluid/platform/flags.h"
@@ -45,6 +47,37 @@ namespace paddle {
 namespace memory {
 namespace allocation {
 
+// All the living AutoGrowthBestFitAllocators, for CollectFragmentationInfo.
+// They are never destroyed since allocators may be destroyed at exit.
+static std::mutex *AllocatorsMutex() {
+  static auto *mutex = new std::mutex();
+  return mutex;
+}
+
+static std::unordered_set<AutoGrowthBestFitAllocator *> *LivingAllocators() {
+  static auto *allocators =
+      new std::unordered_set<AutoGrowthBestFitAllocator *>();
+  return allocators;
+}
+
+std::string FragmentationInfo::DebugString() const {
+  std::stringstream ss;
+  ss << "place: " << place << ", owner: " << owner
+     << ", chunks: " << num_chunks << ", reserved: " << reserved_size
+     << ", allocated: " << allocated_size << ", free: " << free_size
+     << ", largest free block: " << largest_free_block << ", free blocks: {";
+  bool first = true;
+  for (size_t i = 0; i < free_block_histogram.size(); ++i) {
+    if (free_block_histogram[i] == 0) {
+      continue;
+    }
+    ss << (first ? "" : ", ") << "2^" << i << ": " << free_block_histogram[i];
+    first = false;
+  }
+  ss << "}";
+  return ss.str();
+}
+
 AutoGrowthBestFitAllocator::AutoGrowthBestFitAllocator(
     const std::shared_ptr<Allocator> &underlying_allocator,
     size_t alignment,
@@ -59,6 +92,19 @@ AutoGrowthBestFitAllocator::AutoGrowthBestFitAllocator(
   total_free_times_ = 0;
   total_free_size_ = 0;
   VLOG(4) << "chunk_size_:" << chunk_size_;
+
+  std::lock_guard<std::mutex> guard(*AllocatorsMutex());
+  LivingAllocators()->insert(this);
+}
+
+AutoGrowthBestFitAllocator::~AutoGrowthBestFitAllocator() {
+  std::lock_guard<std::mutex> guard(*AllocatorsMutex());
+  LivingAllocators()->erase(this);
+}
+
+void AutoGrowthBestFitAllocator::SetOwner(const std::string &owner) {
+  std::lock_guard<SpinLock> guard(spinlock_);
+  owner_ = owner;
 }
 
 phi::Allocation *AutoGrowthBestFitAllocator::AllocateImpl(
@@ -198,6 +244,50 @@ uint64_t AutoGrowthBestFitAllocator::FreeIdleChunks() {
   return bytes;
 }
 
+FragmentationInfo AutoGrowthBestFitAllocator::GetFragmentationInfo() {
+  FragmentationInfo info;
+  std::lock_guard<SpinLock> guard(spinlock_);
+  info.owner = owner_;
+  info.num_chunks = chunks_.size();
+  if (!chunks_.empty()) {
+    info.place = chunks_.begin()->allocation_->place();
+  }
+  for (auto &chunk : chunks_) {
+    info.reserved_size += chunk.allocation_->size();
+    for (auto &block : chunk.blocks_) {
+      if (!block.is_free_) {
+        info.allocated_size += block.size_;
+        continue;
+      }
+      info.free_size += block.size_;
+      info.largest_free_block = std::max(info.largest_free_block, block.size_);
+      size_t bin = 0;
+      for (size_t size = block.size_; size > 1; size >>= 1) {
+        ++bin;
+      }
+      if (info.free_block_histogram.size() <= bin) {
+        info.free_block_histogram.resize(bin + 1, 0);
+      }
+      ++info.free_block_histogram[bin];
+    }
+  }
+  return info;
+}
+
+std::vector<FragmentationInfo>
+AutoGrowthBestFitAllocator::CollectFragmentationInfo(
+    const platform::Place &place) {
+  std::vector<FragmentationInfo> infos;
+  std::lock_guard<std::mutex> guard(*AllocatorsMutex());
+  for (auto *allocator : *LivingAllocators()) {
+    FragmentationInfo info = allocator->GetFragmentationInfo();
+    if (info.num_chunks > 0 && info.place == place) {
+      infos.emplace_back(std::move(info));
+    }
+  }
+  return infos;
+}
+
 void AutoGrowthBestFitAllocator::Trace() const {
   size_t cur_idle_bytes = 0;
   auto it = free_blocks_.begin();
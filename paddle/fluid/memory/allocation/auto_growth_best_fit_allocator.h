@@ -18,7 +18,9 @@
 #include <map>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "paddle/fluid/memory/allocation/allocator.h"
 #include "paddle/fluid/memory/allocation/spin_lock.h"
@@ -27,6 +29,25 @@ namespace paddle {
 namespace memory {
 namespace allocation {
 
+// The snapshot of the chunks and free blocks of an AutoGrowthBestFitAllocator,
+// used to find out why an allocation fails while the reserved memory is large
+// enough.
+struct FragmentationInfo {
+  platform::Place place;
+  // "default", or the stream that the allocator is created for
+  std::string owner{"default"};
+  size_t num_chunks{0};
+  size_t reserved_size{0};
+  size_t allocated_size{0};
+  size_t free_size{0};
+  size_t largest_free_block{0};
+  // free_block_histogram[i] is the number of free blocks whose size is in
+  // [2^i, 2^(i+1))
+  std::vector<size_t> free_block_histogram;
+
+  std::string DebugString() const;
+};
+
 class AutoGrowthBestFitAllocator : public Allocator {
  public:
   AutoGrowthBestFitAllocator(
@@ -35,8 +56,19 @@ class AutoGrowthBestFitAllocator : public Allocator {
       size_t chunk_size = 0,
       bool allow_free_idle_chunk = true);
 
+  ~AutoGrowthBestFitAllocator() override;
+
   bool IsAllocThreadSafe() const override { return true; }
 
+  void SetOwner(const std::string &owner);
+
+  FragmentationInfo GetFragmentationInfo();
+
+  // Collect the fragmentation info of all the living
+  // AutoGrowthBestFitAllocators which have reserved memory in place.
+  static std::vector<FragmentationInfo> CollectFragmentationInfo(
+      const platform::Place &place);
+
  protected:
   phi::Allocation *AllocateImpl(size_t size) override;
 
@@ -93,6 +125,7 @@ class AutoGrowthBestFitAllocator : public Allocator {
   size_t alignment_;
   size_t chunk_size_;
   bool allow_free_idle_chunk_;
+  std::string owner_{"default"};
 
   // stat info
   size_t total_alloc_times_;
@@ -18,6 +18,7 @@
 
 #include "paddle/fluid/memory/stats.h"
 #include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/backends/cpu/cpu_info.h"
 
 namespace paddle {
 namespace memory {
@@ -49,6 +50,12 @@ phi::Allocation *CPUAllocator::AllocateImpl(size_t size) {
       platform::errors::ResourceExhausted(
           "Fail to alloc memory of %ld size, error code is %d.", size, error));
 #endif
+  // The large blocks allocated by a thread bound to a numa node are kept on
+  // the node, whichever thread touches their pages first.
+  int numa_node = phi::backends::cpu::CurrentThreadNumaNode();
+  if (numa_node >= 0 && size >= kNumaBindMinSize) {
+    phi::backends::cpu::BindMemoryToNumaNode(p, size, numa_node);
+  }
   HOST_MEMORY_STAT_UPDATE(Reserved, 0, size);
   return new Allocation(p, size, platform::CPUPlace());
 }
@@ -34,6 +34,8 @@ namespace allocation {
 class CPUAllocator : public Allocator {
  public:
   constexpr static size_t kAlignment = 4096UL;
+  // The blocks bound to the numa node of the allocating thread.
+  constexpr static size_t kNumaBindMinSize = 1UL << 20;
   bool IsAllocThreadSafe() const override;
 
  protected:
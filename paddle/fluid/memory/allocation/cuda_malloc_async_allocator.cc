@@ -0,0 +1,172 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/cuda_malloc_async_allocator.h"
+
+#include <limits>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "paddle/fluid/memory/stats.h"
+#include "paddle/fluid/platform/cuda_device_guard.h"
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/core/flags.h"
+
+#if CUDA_VERSION >= 11020
+
+PHI_DECLARE_int64(cuda_malloc_async_release_threshold_mb);
+PHI_DECLARE_bool(cuda_malloc_async_ipc);
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+static uint64_t GetReservedMemory(cudaMemPool_t pool) {
+  uint64_t reserved = 0;
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemPoolGetAttribute(
+      pool, cudaMemPoolAttrReservedMemCurrent, &reserved));
+  return reserved;
+}
+
+cudaMemPool_t CUDAMallocAsyncAllocator::GetMemPool(int device) {
+  static std::mutex mutex;
+  static std::unordered_map<int, cudaMemPool_t> pools;
+  std::lock_guard<std::mutex> guard(mutex);
+  auto iter = pools.find(device);
+  if (iter != pools.end()) {
+    return iter->second;
+  }
+
+  int supported = 0;
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaDeviceGetAttribute(
+      &supported, cudaDevAttrMemoryPoolsSupported, device));
+  PADDLE_ENFORCE_EQ(
+      supported,
+      1,
+      platform::errors::Unavailable(
+          "The stream-ordered memory pools are not supported by GPU %d, "
+          "please set FLAGS_allocator_strategy to auto_growth.",
+          device));
+
+  cudaMemPool_t pool;
+  if (FLAGS_cuda_malloc_async_ipc) {
+    cudaMemPoolProps props = {};
+    props.allocType = cudaMemAllocationTypePinned;
+    props.handleTypes = cudaMemHandleTypePosixFileDescriptor;
+    props.location.type = cudaMemLocationTypeDevice;
+    props.location.id = device;
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaMemPoolCreate(&pool, &props));
+  } else {
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaDeviceGetDefaultMemPool(&pool, device));
+  }
+
+  // The freed memory is kept in the pool up to the threshold at the
+  // synchronizations, and all of it is kept by default.
+  uint64_t threshold = std::numeric_limits<uint64_t>::max();
+  if (FLAGS_cuda_malloc_async_release_threshold_mb >= 0) {
+    threshold =
+        static_cast<uint64_t>(FLAGS_cuda_malloc_async_release_threshold_mb)
+        << 20;
+  }
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemPoolSetAttribute(
+      pool, cudaMemPoolAttrReleaseThreshold, &threshold));
+  VLOG(1) << "Use the stream-ordered memory pool on GPU " << device
+          << ", release threshold " << threshold
+          << ", ipc: " << FLAGS_cuda_malloc_async_ipc;
+  pools[device] = pool;
+  return pool;
+}
+
+int CUDAMallocAsyncAllocator::ExportMemPool(int device) {
+  PADDLE_ENFORCE_EQ(
+      FLAGS_cuda_malloc_async_ipc,
+      true,
+      platform::errors::PreconditionNotMet(
+          "The memory pool of GPU %d can be exported only if "
+          "FLAGS_cuda_malloc_async_ipc is true.",
+          device));
+  int fd = -1;
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMemPoolExportToShareableHandle(&fd,
+                                         GetMemPool(device),
+                                         cudaMemHandleTypePosixFileDescriptor,
+                                         0));
+  return fd;
+}
+
+CUDAMallocAsyncAllocator::CUDAMallocAsyncAllocator(
+    const platform::CUDAPlace& place, gpuStream_t stream)
+    : place_(place), stream_(stream), pool_(GetMemPool(place.device)) {}
+
+phi::Allocation* CUDAMallocAsyncAllocator::AllocateImpl(size_t size) {
+  platform::CUDADeviceGuard guard(place_.device);
+  gpuStream_t stream = stream_.load();
+  void* ptr = nullptr;
+  auto result = cudaMallocFromPoolAsync(&ptr, size, pool_, stream);
+  if (LIKELY(result == cudaSuccess)) {
+    DEVICE_MEMORY_STAT_UPDATE(Reserved, place_.device, size);
+    return new CUDAMallocAsyncAllocation(
+        ptr, size, platform::Place(place_), stream);
+  }
+  // Clear the sticky error of the failed allocation.
+  cudaGetLastError();
+
+  size_t avail = 0, total = 0;
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemGetInfo(&avail, &total));
+  PADDLE_THROW_BAD_ALLOC(platform::errors::ResourceExhausted(
+      "\n\nOut of memory error on GPU %d. "
+      "Cannot allocate %s memory from the stream-ordered memory pool, %s "
+      "memory is reserved by the pool and available memory is only %s.\n\n"
+      "%s",
+      place_.device,
+      string::HumanReadableSize(size),
+      string::HumanReadableSize(GetReservedMemory(pool_)),
+      string::HumanReadableSize(avail),
+      phi::enforce::build_nvidia_error_msg(result)));
+}
+
+void CUDAMallocAsyncAllocator::FreeImpl(phi::Allocation* allocation) {
+  PADDLE_ENFORCE_EQ(
+      allocation->place(),
+      place_,
+      platform::errors::PermissionDenied(
+          "GPU memory is freed in incorrect device. This may be a bug"));
+  auto* async_allocation =
+      static_cast<CUDAMallocAsyncAllocation*>(allocation);
+  platform::CUDADeviceGuard guard(place_.device);
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaFreeAsync(allocation->ptr(), async_allocation->GetStream()));
+  DEVICE_MEMORY_STAT_UPDATE(Reserved, place_.device, -allocation->size());
+  delete allocation;
+}
+
+uint64_t CUDAMallocAsyncAllocator::ReleaseImpl(const platform::Place& place) {
+  platform::CUDADeviceGuard guard(place_.device);
+  // Only the memory freed by the completed frees goes back to the device.
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream_.load()));
+  uint64_t before = GetReservedMemory(pool_);
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemPoolTrimTo(pool_, 0));
+  uint64_t after = GetReservedMemory(pool_);
+  VLOG(8) << "Release " << before - after << " bytes of the memory pool on "
+          << place;
+  return before > after ? before - after : 0;
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
+
+#endif
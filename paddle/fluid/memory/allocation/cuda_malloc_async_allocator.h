@@ -0,0 +1,91 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#ifdef PADDLE_WITH_CUDA
+#include <cuda.h>
+#include <cuda_runtime.h>
+#endif
+
+#include <atomic>
+
+#include "paddle/fluid/memory/allocation/allocator.h"
+#include "paddle/fluid/platform/place.h"
+
+#if CUDA_VERSION >= 11020
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+class CUDAMallocAsyncAllocation : public Allocation {
+ public:
+  CUDAMallocAsyncAllocation(void* ptr,
+                            size_t size,
+                            const platform::Place& place,
+                            gpuStream_t stream)
+      : Allocation(ptr, size, place), stream_(stream) {}
+
+  gpuStream_t GetStream() const { return stream_; }
+
+ private:
+  gpuStream_t stream_;
+};
+
+// Allocates the GPU memory from a stream-ordered memory pool of the CUDA
+// driver, by cudaMallocAsync and cudaFreeAsync on the stream of the allocator.
+// The memory freed on a stream is reused by the next allocations on it without
+// a synchronization, and by the other streams once the driver knows the free
+// is done. The pool of a device is shared by the allocators of all its
+// streams. As the best fit allocators, it is wrapped by
+// StreamSafeCUDAAllocator, which delays the frees of the allocations used by
+// the other streams.
+class CUDAMallocAsyncAllocator : public Allocator {
+ public:
+  CUDAMallocAsyncAllocator(const platform::CUDAPlace& place,
+                           gpuStream_t stream);
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  // The stream of the allocator of the default stream is set after the device
+  // context is made.
+  void SetStream(gpuStream_t stream) { stream_.store(stream); }
+
+  // The pool of the device, an own pool exportable to the other processes
+  // with FLAGS_cuda_malloc_async_ipc, otherwise the default pool of the
+  // device. The release threshold of the pool is set by
+  // FLAGS_cuda_malloc_async_release_threshold_mb.
+  static cudaMemPool_t GetMemPool(int device);
+
+  // Exports the pool of the device as a POSIX file descriptor, to be imported
+  // by cudaMemPoolImportFromShareableHandle in the other processes.
+  static int ExportMemPool(int device);
+
+ protected:
+  phi::Allocation* AllocateImpl(size_t size) override;
+  void FreeImpl(phi::Allocation* allocation) override;
+  uint64_t ReleaseImpl(const platform::Place& place) override;
+
+ private:
+  platform::CUDAPlace place_;
+  std::atomic<gpuStream_t> stream_;
+  cudaMemPool_t pool_;
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
+
+#endif
@@ -137,17 +137,53 @@ void CUDAVirtualMemAllocator::FreeImpl(phi::Allocation* allocation) {
     cudaSetDevice(prev_id);
   }
 
+  CUdeviceptr ptr = iter->first;
+  size_t size = iter->second.second;
   virtual_2_physical_map_.erase(iter);
 
+  // coalesce with the adjacent free virtual address ranges
+  auto next = free_virtual_ranges_.lower_bound(ptr);
+  if (next != free_virtual_ranges_.end() && ptr + size == next->first) {
+    size += next->second;
+    free_virtual_ranges_.erase(next);
+  }
+  auto prev = free_virtual_ranges_.lower_bound(ptr);
+  if (prev != free_virtual_ranges_.begin() &&
+      std::prev(prev)->first + std::prev(prev)->second == ptr) {
+    --prev;
+    ptr = prev->first;
+    size += prev->second;
+    free_virtual_ranges_.erase(prev);
+  }
+  if (ptr + size == virtual_mem_base_ + virtual_mem_alloced_offset_) {
+    virtual_mem_alloced_offset_ -= size;
+  } else {
+    free_virtual_ranges_.emplace(ptr, size);
+  }
+
   delete allocation;
 }
 
 phi::Allocation* CUDAVirtualMemAllocator::AllocateImpl(size_t size) {
   size = AlignedSize(size, granularity_);
 
-  CUdeviceptr ptr = virtual_mem_base_ + virtual_mem_alloced_offset_;
+  // best fit in the unmapped virtual address ranges, or the end of the
+  // mapped virtual address space
+  auto free_range = free_virtual_ranges_.end();
+  for (auto it = free_virtual_ranges_.begin(); it != free_virtual_ranges_.end();
+       ++it) {
+    if (it->second >= size && (free_range == free_virtual_ranges_.end() ||
+                               it->second < free_range->second)) {
+      free_range = it;
+    }
+  }
+  bool reuse_free_range = free_range != free_virtual_ranges_.end();
+  CUdeviceptr ptr = reuse_free_range
+                        ? free_range->first
+                        : virtual_mem_base_ + virtual_mem_alloced_offset_;
 
-  if (ptr + size > virtual_mem_base_ + virtual_mem_size_) {
+  if (!reuse_free_range &&
+      ptr + size > virtual_mem_base_ + virtual_mem_size_) {
     PADDLE_THROW_BAD_ALLOC(platform::errors::ResourceExhausted(
         "\n\nOut of memory error on GPU Virtual Memory %d. "
         "Cannot allocate %s memory on GPU Virtual Memory %d, %s memory has "
@@ -222,7 +258,15 @@ phi::Allocation* CUDAVirtualMemAllocator::AllocateImpl(size_t size) {
 
   virtual_2_physical_map_.emplace(ptr, std::make_pair(handle, size));
 
-  virtual_mem_alloced_offset_ += size;
+  if (reuse_free_range) {
+    size_t remaining_size = free_range->second - size;
+    free_virtual_ranges_.erase(free_range);
+    if (remaining_size > 0) {
+      free_virtual_ranges_.emplace(ptr + size, remaining_size);
+    }
+  } else {
+    virtual_mem_alloced_offset_ += size;
+  }
 
   return new Allocation(
       reinterpret_cast<void*>(ptr), size, platform::Place(place_));
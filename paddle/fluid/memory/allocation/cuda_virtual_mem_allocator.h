@@ -55,6 +55,10 @@ class CUDAVirtualMemAllocator : public Allocator {
 
   std::map<CUdeviceptr, std::pair<CUmemGenericAllocationHandle, size_t>>
       virtual_2_physical_map_;
+
+  // The virtual address ranges below virtual_mem_alloced_offset_ which have
+  // been unmapped, they are reused by the following allocations.
+  std::map<CUdeviceptr, size_t> free_virtual_ranges_;
 };
 
 }  // namespace allocation
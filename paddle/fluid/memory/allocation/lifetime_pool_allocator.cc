@@ -0,0 +1,165 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/lifetime_pool_allocator.h"
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+namespace {
+
+thread_local AllocationLifetime current_lifetime =
+    AllocationLifetime::kPersistent;
+
+}  // namespace
+
+AllocationLifetime CurrentAllocationLifetime() { return current_lifetime; }
+
+AllocationLifetimeGuard::AllocationLifetimeGuard(AllocationLifetime lifetime)
+    : prev_lifetime_(current_lifetime) {
+  current_lifetime = lifetime;
+}
+
+AllocationLifetimeGuard::~AllocationLifetimeGuard() {
+  current_lifetime = prev_lifetime_;
+}
+
+LifetimePoolAllocator::LifetimePoolAllocator(
+    std::shared_ptr<Allocator> underlying_allocator,
+    size_t alignment,
+    size_t chunk_size)
+    : underlying_allocator_(std::move(underlying_allocator)),
+      alignment_(alignment),
+      chunk_size_(AlignedSize(chunk_size, alignment)) {
+  PADDLE_ENFORCE_GT(alignment,
+                    0,
+                    platform::errors::InvalidArgument(
+                        "The alignment of LifetimePoolAllocator should be "
+                        "positive, but got %d.",
+                        alignment));
+}
+
+LifetimePoolAllocator::Arena* LifetimePoolAllocator::ArenaOf(
+    AllocationLifetime lifetime) {
+  switch (lifetime) {
+    case AllocationLifetime::kStep:
+      return &step_arena_;
+    case AllocationLifetime::kMicroBatch:
+      return &micro_batch_arena_;
+    default:
+      return nullptr;
+  }
+}
+
+phi::Allocation* LifetimePoolAllocator::AllocateImpl(size_t size) {
+  Arena* arena = ArenaOf(CurrentAllocationLifetime());
+  size_t aligned_size = AlignedSize(size, alignment_);
+  if (arena == nullptr || size == 0 || aligned_size > chunk_size_ / 4) {
+    return underlying_allocator_->Allocate(size).release();
+  }
+
+  std::lock_guard<SpinLock> guard(arena->spinlock);
+  Chunk* chunk = arena->current;
+  if (chunk == nullptr || chunk->offset + aligned_size > chunk_size_) {
+    if (!arena->free_chunks.empty()) {
+      chunk = arena->free_chunks.back();
+      arena->free_chunks.pop_back();
+    } else {
+      arena->chunks.emplace_back(new Chunk());
+      chunk = arena->chunks.back().get();
+      chunk->allocation = static_unique_ptr_cast<Allocation>(
+          underlying_allocator_->Allocate(chunk_size_));
+      VLOG(10) << "LifetimePoolAllocator takes the chunk "
+               << arena->chunks.size() << " of " << chunk_size_
+               << " bytes for an arena.";
+    }
+    // The chunk replaced is put to the free chunks by its last block.
+    arena->current = chunk;
+  }
+  void* ptr = static_cast<uint8_t*>(chunk->allocation->ptr()) + chunk->offset;
+  chunk->offset += aligned_size;
+  ++chunk->num_blocks;
+  return new ArenaAllocation(
+      ptr, size, chunk->allocation->place(), arena, chunk);
+}
+
+void LifetimePoolAllocator::FreeImpl(phi::Allocation* allocation) {
+  auto* arena_allocation = dynamic_cast<ArenaAllocation*>(allocation);
+  if (arena_allocation == nullptr) {
+    underlying_allocator_->Free(allocation);
+    return;
+  }
+  Arena* arena = arena_allocation->arena();
+  Chunk* chunk = arena_allocation->chunk();
+  {
+    std::lock_guard<SpinLock> guard(arena->spinlock);
+    if (--chunk->num_blocks == 0) {
+      chunk->offset = 0;
+      if (chunk != arena->current) {
+        arena->free_chunks.push_back(chunk);
+      }
+    }
+  }
+  delete allocation;
+}
+
+uint64_t LifetimePoolAllocator::ReleaseImpl(const platform::Place& place) {
+  for (Arena* arena : {&step_arena_, &micro_batch_arena_}) {
+    std::lock_guard<SpinLock> guard(arena->spinlock);
+    if (arena->current != nullptr && arena->current->num_blocks == 0) {
+      arena->free_chunks.push_back(arena->current);
+      arena->current = nullptr;
+    }
+    for (Chunk* chunk : arena->free_chunks) {
+      auto iter = std::find_if(
+          arena->chunks.begin(),
+          arena->chunks.end(),
+          [chunk](const std::unique_ptr<Chunk>& item) {
+            return item.get() == chunk;
+          });
+      arena->chunks.erase(iter);
+    }
+    arena->free_chunks.clear();
+  }
+  return underlying_allocator_->Release(place);
+}
+
+size_t LifetimePoolAllocator::NumChunks(AllocationLifetime lifetime) {
+  Arena* arena = ArenaOf(lifetime);
+  if (arena == nullptr) {
+    return 0;
+  }
+  std::lock_guard<SpinLock> guard(arena->spinlock);
+  return arena->chunks.size();
+}
+
+size_t LifetimePoolAllocator::NumFreeChunks(AllocationLifetime lifetime) {
+  Arena* arena = ArenaOf(lifetime);
+  if (arena == nullptr) {
+    return 0;
+  }
+  std::lock_guard<SpinLock> guard(arena->spinlock);
+  return arena->free_chunks.size();
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,132 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/fluid/memory/allocation/allocator.h"
+#include "paddle/fluid/memory/allocation/spin_lock.h"
+#include "paddle/utils/test_macros.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+// How long the allocations of a thread live, as tagged by the executor. The
+// blocks of a micro-batch are freed by the end of it, and those of a step,
+// e.g. by the optimizer, by the end of the step.
+enum class AllocationLifetime { kPersistent = 0, kStep = 1, kMicroBatch = 2 };
+
+TEST_API AllocationLifetime CurrentAllocationLifetime();
+
+// Tags the allocations of the current thread in its scope:
+//
+//   {
+//     AllocationLifetimeGuard guard(AllocationLifetime::kMicroBatch);
+//     RunForward(micro_id);
+//   }
+class TEST_API AllocationLifetimeGuard {
+ public:
+  explicit AllocationLifetimeGuard(AllocationLifetime lifetime);
+
+  ~AllocationLifetimeGuard();
+
+ private:
+  AllocationLifetime prev_lifetime_;
+
+  DISABLE_COPY_AND_ASSIGN(AllocationLifetimeGuard);
+};
+
+/**
+ * LifetimePoolAllocator serves the allocations tagged as micro-batch or step
+ * local from an arena of each lifetime, instead of the best fit free list of
+ * the underlying allocator, in which the short-lived blocks of interleaved
+ * micro-batches fragment the chunks holding the long-lived ones.
+ *
+ * An arena takes chunks of chunk_size from the underlying allocator, and a
+ * block is bumped from the current chunk. A chunk counts its live blocks, and
+ * is reset as a whole to be reused once all of them are freed, so the arena
+ * stays as large as the blocks alive at once plus the chunks pinned by the
+ * blocks outliving their lifetime. The persistent allocations, and the blocks
+ * larger than a quarter of a chunk, which bounds the bytes wasted at the end
+ * of a chunk, go to the underlying allocator directly.
+ *
+ * The blocks are freed to the arena after the work of its streams is done,
+ * when it is under the StreamSafeCUDAAllocator.
+ */
+class LifetimePoolAllocator : public Allocator {
+ public:
+  LifetimePoolAllocator(std::shared_ptr<Allocator> underlying_allocator,
+                        size_t alignment,
+                        size_t chunk_size);
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  // The chunks taken by the arena of the lifetime, and those of them reset.
+  size_t NumChunks(AllocationLifetime lifetime);
+  size_t NumFreeChunks(AllocationLifetime lifetime);
+
+ protected:
+  phi::Allocation* AllocateImpl(size_t size) override;
+  void FreeImpl(phi::Allocation* allocation) override;
+  // Frees the reset chunks of the arenas to the underlying allocator, and
+  // releases it.
+  uint64_t ReleaseImpl(const platform::Place& place) override;
+
+ private:
+  struct Chunk {
+    DecoratedAllocationPtr allocation;
+    size_t offset{0};
+    size_t num_blocks{0};
+  };
+
+  struct Arena {
+    SpinLock spinlock;
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    Chunk* current{nullptr};
+    std::vector<Chunk*> free_chunks;
+  };
+
+  class ArenaAllocation : public Allocation {
+   public:
+    ArenaAllocation(void* ptr,
+                    size_t size,
+                    const platform::Place& place,
+                    Arena* arena,
+                    Chunk* chunk)
+        : Allocation(ptr, size, place), arena_(arena), chunk_(chunk) {}
+
+    Arena* arena() const { return arena_; }
+    Chunk* chunk() const { return chunk_; }
+
+   private:
+    Arena* arena_;
+    Chunk* chunk_;
+  };
+
+  Arena* ArenaOf(AllocationLifetime lifetime);
+
+  std::shared_ptr<Allocator> underlying_allocator_;
+  size_t alignment_;
+  size_t chunk_size_;
+  Arena step_arena_;
+  Arena micro_batch_arena_;
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
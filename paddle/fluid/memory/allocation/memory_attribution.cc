@@ -0,0 +1,248 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/memory_attribution.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include "glog/logging.h"
+#include "paddle/fluid/platform/enforce.h"
+
+PHI_DECLARE_string(memory_attribution_dir);
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+// Bounds the timeline, the oldest points are dropped.
+static constexpr size_t kMaxTimelinePoints = 1 << 20;
+
+static thread_local int64_t current_instr_id = -1;
+static thread_local const std::string* current_op_type = nullptr;
+
+MemoryAttribution& MemoryAttribution::Instance() {
+  // Never destroyed, the allocations may be freed by the threads at exit.
+  static MemoryAttribution* attribution = new MemoryAttribution();
+  return *attribution;
+}
+
+void MemoryAttribution::OnAllocate(const void* ptr,
+                                   size_t size,
+                                   const phi::Place& place) {
+  MemoryBlockInfo info{size,
+                       current_instr_id,
+                       current_op_type ? *current_op_type : "",
+                       ""};
+  std::lock_guard<std::mutex> guard(mutex_);
+  live_[ptr] = LiveBlock{place, std::move(info)};
+  auto& state = places_[place];
+  state.current += static_cast<int64_t>(size);
+  state.allocated += static_cast<int64_t>(size);
+  if (state.current > state.peak) {
+    state.peak = state.current;
+    state.at_peak = true;
+  }
+}
+
+void MemoryAttribution::OnFree(const void* ptr) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto iter = live_.find(ptr);
+  if (iter == live_.end()) return;
+  const phi::Place place = iter->second.place;
+  const auto size = static_cast<int64_t>(iter->second.info.size);
+  auto& state = places_[place];
+  // Leaving the peak, the blocks alive at it are taken a snapshot of.
+  if (state.at_peak) {
+    state.peak_blocks = LiveBlocksOf(place);
+    state.at_peak = false;
+  }
+  state.current -= size;
+  state.freed += size;
+  live_.erase(iter);
+}
+
+void MemoryAttribution::TagVariable(const void* ptr,
+                                    const std::string& var_name) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto iter = live_.find(ptr);
+  if (iter != live_.end()) {
+    iter->second.info.var_name = var_name;
+  }
+}
+
+void MemoryAttribution::OnInstructionEnd(int64_t instr_id,
+                                         const std::string& op_type) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& item : places_) {
+    auto& state = item.second;
+    if (state.allocated == 0 && state.freed == 0) continue;
+    std::ostringstream place;
+    place << item.first;
+    timeline_.push_back(MemoryTimelinePoint{instr_id,
+                                            op_type,
+                                            place.str(),
+                                            state.allocated,
+                                            state.freed,
+                                            state.current,
+                                            state.peak});
+    state.allocated = 0;
+    state.freed = 0;
+  }
+  while (timeline_.size() > kMaxTimelinePoints) {
+    timeline_.pop_front();
+  }
+}
+
+std::vector<MemoryBlockInfo> MemoryAttribution::LiveBlocksOf(
+    const phi::Place& place) const {
+  std::vector<MemoryBlockInfo> blocks;
+  for (const auto& item : live_) {
+    if (item.second.place == place) {
+      blocks.push_back(item.second.info);
+    }
+  }
+  std::sort(blocks.begin(),
+            blocks.end(),
+            [](const MemoryBlockInfo& a, const MemoryBlockInfo& b) {
+              return a.size > b.size;
+            });
+  return blocks;
+}
+
+std::vector<MemoryTimelinePoint> MemoryAttribution::Timeline() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return std::vector<MemoryTimelinePoint>(timeline_.begin(), timeline_.end());
+}
+
+int64_t MemoryAttribution::Peak(const phi::Place& place) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto iter = places_.find(place);
+  return iter == places_.end() ? 0 : iter->second.peak;
+}
+
+std::vector<MemoryBlockInfo> MemoryAttribution::AliveAtPeak(
+    const phi::Place& place) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto iter = places_.find(place);
+  if (iter == places_.end()) return {};
+  if (iter->second.at_peak) return LiveBlocksOf(place);
+  return iter->second.peak_blocks;
+}
+
+std::string MemoryAttribution::PeakReport(size_t top_k) const {
+  std::vector<phi::Place> places;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (const auto& item : places_) places.push_back(item.first);
+  }
+  std::ostringstream os;
+  for (const auto& place : places) {
+    auto blocks = AliveAtPeak(place);
+    os << "Place " << place << ", peak " << Peak(place) << " bytes, "
+       << blocks.size() << " blocks alive at the peak\n";
+
+    std::map<std::pair<int64_t, std::string>, std::pair<int64_t, size_t>>
+        by_instr;
+    for (const auto& block : blocks) {
+      auto& total = by_instr[std::make_pair(block.instr_id, block.op_type)];
+      total.first += static_cast<int64_t>(block.size);
+      total.second += 1;
+    }
+    std::vector<std::pair<std::pair<int64_t, std::string>,
+                          std::pair<int64_t, size_t>>>
+        instrs(by_instr.begin(), by_instr.end());
+    std::sort(instrs.begin(), instrs.end(), [](const auto& a, const auto& b) {
+      return a.second.first > b.second.first;
+    });
+    os << "  By instruction:\n";
+    for (size_t i = 0; i < std::min(top_k, instrs.size()); ++i) {
+      const auto& owner = instrs[i].first;
+      const auto& total = instrs[i].second;
+      os << "    instr " << owner.first << " " << owner.second << ": "
+         << total.first << " bytes in " << total.second << " blocks\n";
+    }
+    os << "  Largest blocks:\n";
+    for (size_t i = 0; i < std::min(top_k, blocks.size()); ++i) {
+      os << "    " << blocks[i].size << " bytes, var "
+         << (blocks[i].var_name.empty() ? "<unnamed>" : blocks[i].var_name)
+         << ", instr " << blocks[i].instr_id << " " << blocks[i].op_type
+         << "\n";
+    }
+  }
+  return os.str();
+}
+
+void MemoryAttribution::Save(const std::string& dir) const {
+  const std::string timeline_path = dir + "/memory_timeline.csv";
+  std::ofstream timeline(timeline_path);
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(timeline),
+      true,
+      platform::errors::Unavailable("Failed to open %s.", timeline_path));
+  timeline << "instr_id,op_type,place,allocated,freed,current,peak\n";
+  for (const auto& point : Timeline()) {
+    timeline << point.instr_id << "," << point.op_type << "," << point.place
+             << "," << point.allocated << "," << point.freed << ","
+             << point.current << "," << point.peak << "\n";
+  }
+
+  const std::string report_path = dir + "/memory_peak_report.txt";
+  std::ofstream report(report_path);
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(report),
+      true,
+      platform::errors::Unavailable("Failed to open %s.", report_path));
+  report << PeakReport();
+}
+
+void MemoryAttribution::Reset() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  live_.clear();
+  places_.clear();
+  timeline_.clear();
+}
+
+void MemoryAttribution::ReportOnError() const {
+  LOG(WARNING) << "The memory alive at the peak:\n" << PeakReport();
+  if (!FLAGS_memory_attribution_dir.empty()) {
+    Save(FLAGS_memory_attribution_dir);
+  }
+}
+
+MemoryAttributionGuard::MemoryAttributionGuard(int64_t instr_id,
+                                               const std::string& op_type)
+    : enabled_(MemoryAttribution::IsEnabled()),
+      prev_instr_id_(current_instr_id),
+      prev_op_type_(current_op_type) {
+  if (enabled_) {
+    current_instr_id = instr_id;
+    current_op_type = &op_type;
+  }
+}
+
+MemoryAttributionGuard::~MemoryAttributionGuard() {
+  if (enabled_) {
+    MemoryAttribution::Instance().OnInstructionEnd(current_instr_id,
+                                                   *current_op_type);
+    current_instr_id = prev_instr_id_;
+    current_op_type = prev_op_type_;
+  }
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,152 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/flags.h"
+#include "paddle/utils/test_macros.h"
+
+PHI_DECLARE_bool(enable_memory_attribution);
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+// Attributes the allocations of the StatAllocator to the instructions of the
+// executor and to the variables they produce, when
+// FLAGS_enable_memory_attribution is set:
+//
+//   {
+//     MemoryAttributionGuard guard(instr.Id(), op->Type());
+//     RunOperator(instr);
+//   }
+//   MemoryAttribution::Instance().TagVariable(holder->ptr(), var_name);
+//
+// The allocations out of any guard, e.g. by the feeds, are attributed to the
+// instruction -1. A point is appended to the timeline at the end of each
+// instruction, and the live blocks are taken a snapshot of when a place
+// leaves its peak, so that the report tells what is alive at the peak.
+
+struct MemoryTimelinePoint {
+  int64_t instr_id;
+  std::string op_type;
+  std::string place;
+  // The bytes allocated and freed on the place during the instruction.
+  int64_t allocated;
+  int64_t freed;
+  // The bytes alive on the place after the instruction, and the peak so far.
+  int64_t current;
+  int64_t peak;
+};
+
+struct MemoryBlockInfo {
+  size_t size;
+  int64_t instr_id;
+  std::string op_type;
+  std::string var_name;
+};
+
+class TEST_API MemoryAttribution {
+ public:
+  static MemoryAttribution& Instance();
+
+  static bool IsEnabled() { return FLAGS_enable_memory_attribution; }
+
+  void OnAllocate(const void* ptr, size_t size, const phi::Place& place);
+
+  void OnFree(const void* ptr);
+
+  // Names the block by the variable that holds it, it is a no-op if the
+  // block is not recorded.
+  void TagVariable(const void* ptr, const std::string& var_name);
+
+  void OnInstructionEnd(int64_t instr_id, const std::string& op_type);
+
+  std::vector<MemoryTimelinePoint> Timeline() const;
+
+  int64_t Peak(const phi::Place& place) const;
+
+  // The blocks alive at the peak of the place, the largest first.
+  std::vector<MemoryBlockInfo> AliveAtPeak(const phi::Place& place) const;
+
+  // The peak of each place, and the top_k instructions and blocks alive at
+  // the peak.
+  std::string PeakReport(size_t top_k = 20) const;
+
+  // Writes memory_timeline.csv and memory_peak_report.txt to the directory.
+  void Save(const std::string& dir) const;
+
+  void Reset();
+
+  // Logs the report, and saves it to FLAGS_memory_attribution_dir if set, so
+  // that an out of memory error tells what is alive at the peak.
+  void ReportOnError() const;
+
+ private:
+  struct LiveBlock {
+    phi::Place place;
+    MemoryBlockInfo info;
+  };
+
+  struct PlaceState {
+    int64_t current = 0;
+    int64_t peak = 0;
+    int64_t allocated = 0;
+    int64_t freed = 0;
+    // The peak is reached and the snapshot of it is not taken yet.
+    bool at_peak = false;
+    std::vector<MemoryBlockInfo> peak_blocks;
+  };
+
+  MemoryAttribution() = default;
+
+  std::vector<MemoryBlockInfo> LiveBlocksOf(const phi::Place& place) const;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<const void*, LiveBlock> live_;
+  std::map<phi::Place, PlaceState> places_;
+  std::deque<MemoryTimelinePoint> timeline_;
+
+  DISABLE_COPY_AND_ASSIGN(MemoryAttribution);
+};
+
+// Attributes the allocations of the current thread to the instruction in its
+// scope, and appends a point to the timeline at the end of it.
+class TEST_API MemoryAttributionGuard {
+ public:
+  MemoryAttributionGuard(int64_t instr_id, const std::string& op_type);
+
+  ~MemoryAttributionGuard();
+
+ private:
+  bool enabled_;
+  int64_t prev_instr_id_;
+  const std::string* prev_op_type_;
+
+  DISABLE_COPY_AND_ASSIGN(MemoryAttributionGuard);
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -18,8 +18,10 @@
 
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <cstdlib>
 
+#include <algorithm>
 #include <atomic>
 #include <random>
 #include <string>
@@ -29,6 +31,7 @@
 #include "paddle/phi/core/flags.h"
 
 PHI_DECLARE_bool(use_shm_cache);
+PHI_DECLARE_int64(shm_segment_size_mb);
 
 namespace paddle {
 namespace memory {
@@ -298,6 +301,40 @@ std::shared_ptr<MemoryMapReaderAllocation> RebuildMemoryMapReaderAllocation(
   return std::make_shared<MemoryMapReaderAllocation>(ptr, size, ipc_name);
 }
 
+MemoryMapFileAllocation::~MemoryMapFileAllocation() {
+  if (this->size() > 0 && munmap(this->ptr(), this->size()) == -1) {
+    LOG(WARNING) << "could not unmap the file " << file_name_ << ": "
+                 << strerror(errno);
+  }
+}
+
+std::shared_ptr<MemoryMapFileAllocation> AllocateMemoryMapFileAllocation(
+    const std::string &file_name) {
+  int fd = open(file_name.c_str(), O_RDONLY);
+  PADDLE_ENFORCE_NE(fd,
+                    -1,
+                    platform::errors::Unavailable("Failed to open file %s.",
+                                                  file_name.c_str()));
+  struct stat st;
+  if (fstat(fd, &st) == -1) {
+    close(fd);
+    PADDLE_THROW(platform::errors::Unavailable("Failed to stat file %s.",
+                                               file_name.c_str()));
+  }
+  size_t size = static_cast<size_t>(st.st_size);
+  void *ptr = nullptr;
+  if (size > 0) {
+    // written pages are copied, and never written back to the file
+    ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+  PADDLE_ENFORCE_NE(ptr,
+                    MAP_FAILED,
+                    platform::errors::Unavailable("Memory map file %s failed.",
+                                                  file_name.c_str()));
+  return std::make_shared<MemoryMapFileAllocation>(ptr, size, file_name);
+}
+
 MemoryMapFdSet &MemoryMapFdSet::Instance() {  // NOLINT
   static MemoryMapFdSet set;
   return set;
@@ -394,6 +431,219 @@ void MemoryMapAllocationPool::Clear() {
 
 MemoryMapAllocationPool::~MemoryMapAllocationPool() { Clear(); }  // NOLINT
 
+struct SegmentHeader {
+  std::atomic<int64_t> refcount;
+  std::atomic<int32_t> retired;
+};
+
+static_assert(sizeof(SegmentHeader) <= mmap_alignment,
+              "The header of a shm segment exceeds its alignment.");
+
+SharedMemorySegment::SharedMemorySegment(const std::string &ipc_name,
+                                         size_t size,
+                                         bool create)
+    : ipc_name_(ipc_name), creator_pid_(create ? getpid() : -1) {
+  int fd = shm_open(ipc_name_.c_str(),
+                    create ? O_RDWR | O_CREAT | O_EXCL : O_RDWR,
+                    (mode_t)0600);
+  PADDLE_ENFORCE_NE(fd,
+                    -1,
+                    platform::errors::Unavailable(
+                        "Failed to open the shm segment %s, %s.",
+                        ipc_name_,
+                        strerror(errno)));
+  if (create) {
+    map_size_ = size + mmap_alignment;
+    if (ftruncate(fd, map_size_) != 0) {
+      ::close(fd);
+      shm_unlink(ipc_name_.c_str());
+      PADDLE_THROW(platform::errors::ResourceExhausted(
+          "Failed to truncate the shm segment %s to %d bytes.",
+          ipc_name_,
+          map_size_));
+    }
+  } else {
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+      ::close(fd);
+      PADDLE_THROW(platform::errors::Unavailable(
+          "Failed to stat the shm segment %s.", ipc_name_));
+    }
+    map_size_ = static_cast<size_t>(st.st_size);
+  }
+
+  int map_flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+  // The pages are faulted once here, and then reused by all the tensors
+  // allocated in the segment.
+  map_flags |= MAP_POPULATE;
+#endif
+  map_ptr_ =
+      mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, map_flags, fd, 0);
+  ::close(fd);
+  if (map_ptr_ == MAP_FAILED && create) shm_unlink(ipc_name_.c_str());
+  PADDLE_ENFORCE_NE(map_ptr_,
+                    MAP_FAILED,
+                    platform::errors::Unavailable(
+                        "Memory map failed when map the shm segment %s.",
+                        ipc_name_));
+  if (create) {
+    // The truncated shm is zero filled, only the header is constructed.
+    new (map_ptr_) SegmentHeader();
+  }
+  MemoryMapFdSet::Instance().Insert(ipc_name_);
+  VLOG(4) << (create ? "Create" : "Map") << " a shm segment: " << ipc_name_
+          << ", size: " << map_size_;
+}
+
+SharedMemorySegment::~SharedMemorySegment() {
+  if (munmap(map_ptr_, map_size_) == -1) {
+    LOG(WARNING) << "could not unmap the shm segment " << ipc_name_ << ": "
+                 << strerror(errno);
+  }
+  // Only the creator unlinks the segment, the other processes have it
+  // unlinked at their exit by MemoryMapFdSet if the creator crashed.
+  if (creator_pid_ == getpid()) {
+    shm_unlink(ipc_name_.c_str());
+    MemoryMapFdSet::Instance().Remove(ipc_name_);
+  }
+  VLOG(4) << "Release a shm segment: " << ipc_name_;
+}
+
+void SharedMemorySegment::incref() {
+  static_cast<SegmentHeader *>(map_ptr_)->refcount.fetch_add(1);
+}
+
+void SharedMemorySegment::decref() {
+  static_cast<SegmentHeader *>(map_ptr_)->refcount.fetch_sub(1);
+}
+
+int64_t SharedMemorySegment::refcount() const {
+  return static_cast<SegmentHeader *>(map_ptr_)->refcount.load();
+}
+
+void SharedMemorySegment::retire() {
+  static_cast<SegmentHeader *>(map_ptr_)->retired.store(1);
+}
+
+bool SharedMemorySegment::retired() const {
+  return static_cast<SegmentHeader *>(map_ptr_)->retired.load() != 0;
+}
+
+SharedMemorySegmentAllocation::SharedMemorySegmentAllocation(
+    std::shared_ptr<SharedMemorySegment> segment, size_t offset, size_t size)
+    : Allocation(segment->data() + offset, size, platform::CPUPlace()),
+      segment_(std::move(segment)),
+      offset_(offset) {
+  segment_->incref();
+}
+
+SharedMemorySegmentAllocation::~SharedMemorySegmentAllocation() {
+  segment_->decref();
+}
+
+SharedMemorySegmentPool &SharedMemorySegmentPool::Instance() {
+  // Never destroyed, the allocations may outlive the static objects.
+  static SharedMemorySegmentPool *pool = new SharedMemorySegmentPool();
+  return *pool;
+}
+
+void SharedMemorySegmentPool::ResetAfterFork() {
+  if (pid_ == getpid()) return;
+  pid_ = getpid();
+  segments_.clear();
+  current_ = nullptr;
+  current_offset_ = 0;
+  mapped_.clear();
+}
+
+std::shared_ptr<SharedMemorySegmentAllocation>
+SharedMemorySegmentPool::Allocate(size_t size) {
+  const size_t segment_size =
+      static_cast<size_t>(std::max<int64_t>(FLAGS_shm_segment_size_mb, 0))
+      << 20;
+  const size_t aligned_size =
+      (size + mmap_alignment - 1) / mmap_alignment * mmap_alignment;
+  if (aligned_size == 0 || aligned_size > segment_size) return nullptr;
+
+  std::lock_guard<std::mutex> guard(mtx_);
+  ResetAfterFork();
+  if (current_ != nullptr && current_->refcount() == 0) {
+    current_offset_ = 0;
+  }
+  if (current_ == nullptr ||
+      current_offset_ + aligned_size > current_->size()) {
+    // Reuses a segment whose blocks are dropped by all the processes.
+    current_ = nullptr;
+    for (auto &segment : segments_) {
+      if (segment->refcount() == 0 && segment->size() >= aligned_size) {
+        current_ = segment;
+        break;
+      }
+    }
+    if (current_ == nullptr) {
+      current_ = std::make_shared<SharedMemorySegment>(
+          GetIPCName(), segment_size, true);
+      segments_.push_back(current_);
+    }
+    current_offset_ = 0;
+  }
+  auto allocation = std::make_shared<SharedMemorySegmentAllocation>(
+      current_, current_offset_, size);
+  current_offset_ += aligned_size;
+  return allocation;
+}
+
+std::shared_ptr<SharedMemorySegmentAllocation>
+SharedMemorySegmentPool::Rebuild(const std::string &ipc_name,
+                                 size_t offset,
+                                 size_t size) {
+  std::lock_guard<std::mutex> guard(mtx_);
+  ResetAfterFork();
+  std::shared_ptr<SharedMemorySegment> segment;
+  for (auto &owned : segments_) {
+    if (owned->ipc_name() == ipc_name) segment = owned;
+  }
+  if (segment == nullptr) {
+    auto &mapped = mapped_[ipc_name];
+    if (mapped == nullptr) {
+      // Unmaps the segments retired by their creators before mapping a new
+      // one, which is rare enough to sweep all of them.
+      for (auto it = mapped_.begin(); it != mapped_.end();) {
+        if (it->second != nullptr && it->second.use_count() == 1 &&
+            it->second->retired()) {
+          it = mapped_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+      mapped = std::make_shared<SharedMemorySegment>(ipc_name, 0, false);
+    }
+    segment = mapped;
+  }
+  PADDLE_ENFORCE_LE(offset + size,
+                    segment->size(),
+                    platform::errors::OutOfRange(
+                        "The block [%d, %d) is out of the shm segment %s of "
+                        "%d bytes.",
+                        offset,
+                        offset + size,
+                        ipc_name,
+                        segment->size()));
+  return std::make_shared<SharedMemorySegmentAllocation>(segment, offset, size);
+}
+
+void SharedMemorySegmentPool::Clear() {
+  std::lock_guard<std::mutex> guard(mtx_);
+  for (auto &segment : segments_) {
+    segment->retire();
+  }
+  segments_.clear();
+  current_ = nullptr;
+  current_offset_ = 0;
+  mapped_.clear();
+}
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
@@ -16,12 +16,16 @@
 
 #ifndef _WIN32
 
+#include <sys/types.h>
+
 #include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "paddle/fluid/memory/allocation/allocator.h"
 
@@ -140,6 +144,40 @@ std::shared_ptr<MemoryMapWriterAllocation> AllocateMemoryMapWriterAllocation(
 std::shared_ptr<MemoryMapReaderAllocation> RebuildMemoryMapReaderAllocation(
     const std::string &ipc_name, size_t size);
 
+// MemoryMapFileAllocation maps a regular file privately, so the pages are
+// shared with the other mappings of the file until they are written, and are
+// read from the file lazily.
+class MemoryMapFileAllocation : public Allocation {
+ public:
+  explicit MemoryMapFileAllocation(void *ptr,
+                                   size_t size,
+                                   std::string file_name)
+      : Allocation(ptr, size, platform::CPUPlace()),
+        file_name_(std::move(file_name)) {}
+
+  inline const std::string &file_name() const { return file_name_; }
+
+  ~MemoryMapFileAllocation() override;
+
+ private:
+  std::string file_name_;
+};
+
+// A part of a mapped file, which keeps the whole mapping alive.
+class MemoryMapFileViewAllocation : public Allocation {
+ public:
+  MemoryMapFileViewAllocation(void *ptr,
+                              size_t size,
+                              std::shared_ptr<MemoryMapFileAllocation> file)
+      : Allocation(ptr, size, platform::CPUPlace()), file_(std::move(file)) {}
+
+ private:
+  std::shared_ptr<MemoryMapFileAllocation> file_;
+};
+
+std::shared_ptr<MemoryMapFileAllocation> AllocateMemoryMapFileAllocation(
+    const std::string &file_name);
+
 class MemoryMapFdSet {
  public:
   static MemoryMapFdSet &Instance();  // NOLINT
@@ -221,6 +259,99 @@ class MemoryMapAllocationPool {
   std::mutex mtx_;
 };
 
+// A shm segment mapped by a process, whose first mmap_alignment bytes count
+// the references of all the allocations in it, from all the processes.
+class SharedMemorySegment {
+ public:
+  // Creates and pre-faults a new segment if create, otherwise maps the
+  // existing segment of the name.
+  SharedMemorySegment(const std::string &ipc_name, size_t size, bool create);
+
+  ~SharedMemorySegment();
+
+  const std::string &ipc_name() const { return ipc_name_; }
+
+  // The size of the segment, without the header.
+  size_t size() const { return map_size_ - mmap_alignment; }
+
+  char *data() const { return static_cast<char *>(map_ptr_) + mmap_alignment; }
+
+  void incref();
+  void decref();
+  int64_t refcount() const;
+
+  // Marks the segment as never reused by its creator, so that the other
+  // processes may unmap it once they drop their allocations in it.
+  void retire();
+  bool retired() const;
+
+ private:
+  std::string ipc_name_;
+  void *map_ptr_ = nullptr;
+  size_t map_size_ = 0;
+  pid_t creator_pid_ = -1;
+};
+
+// A block of a SharedMemorySegment, passed to the other processes by the
+// name of the segment and the offset of the block.
+class SharedMemorySegmentAllocation : public Allocation {
+ public:
+  SharedMemorySegmentAllocation(std::shared_ptr<SharedMemorySegment> segment,
+                                size_t offset,
+                                size_t size);
+
+  ~SharedMemorySegmentAllocation() override;
+
+  const std::string &ipc_name() const { return segment_->ipc_name(); }
+
+  size_t offset() const { return offset_; }
+
+  // Keeps the block alive while it is sent to another process.
+  void incref() { segment_->incref(); }
+  void decref() { segment_->decref(); }
+
+ private:
+  std::shared_ptr<SharedMemorySegment> segment_;
+  size_t offset_;
+};
+
+/* SharedMemorySegmentPool allocates the tensors of the DataLoader workers
+from a few recycled and pre-faulted shm segments of
+FLAGS_shm_segment_size_mb, instead of a shm file per tensor. The blocks of a
+segment are allocated by bumping an offset, and the whole segment is reused
+once all the processes drop their blocks in it. The receiver maps a segment
+only once, so that passing a tensor costs no shm_open, mmap or page faults.
+*/
+class SharedMemorySegmentPool {
+ public:
+  static SharedMemorySegmentPool &Instance();
+
+  // Returns null if the pool is disabled or the size exceeds a segment.
+  std::shared_ptr<SharedMemorySegmentAllocation> Allocate(size_t size);
+
+  // Rebuilds a block allocated by another process.
+  std::shared_ptr<SharedMemorySegmentAllocation> Rebuild(
+      const std::string &ipc_name, size_t offset, size_t size);
+
+  // Retires and unlinks the segments created by the process, and unmaps the
+  // segments of the others.
+  void Clear();
+
+ private:
+  SharedMemorySegmentPool() = default;
+
+  // Drops the segments inherited by a forked process.
+  void ResetAfterFork();
+
+  std::mutex mtx_;
+  pid_t pid_ = -1;
+  std::vector<std::shared_ptr<SharedMemorySegment>> segments_;
+  std::shared_ptr<SharedMemorySegment> current_;
+  size_t current_offset_ = 0;
+  std::unordered_map<std::string, std::shared_ptr<SharedMemorySegment>>
+      mapped_;
+};
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "paddle/fluid/memory/allocation/allocator.h"
+#include "paddle/fluid/memory/allocation/memory_attribution.h"
 #include "paddle/fluid/memory/stats.h"
 #include "paddle/fluid/platform/profiler/mem_tracing.h"
 
@@ -43,6 +44,9 @@ class StatAllocator : public Allocator {
                              allocation->place(),
                              allocation->size(),
                              platform::TracerMemEventType::Free);
+    if (UNLIKELY(MemoryAttribution::IsEnabled())) {
+      MemoryAttribution::Instance().OnFree(allocation->ptr());
+    }
     underlying_allocator_->Free(allocation);
   }
 
@@ -63,6 +67,10 @@ class StatAllocator : public Allocator {
                              allocation->place(),
                              allocation->size(),
                              platform::TracerMemEventType::Allocate);
+    if (UNLIKELY(MemoryAttribution::IsEnabled())) {
+      MemoryAttribution::Instance().OnAllocate(
+          allocation->ptr(), allocation->size(), place);
+    }
     return allocation.release();
   }
 
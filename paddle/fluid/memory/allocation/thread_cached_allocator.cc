@@ -0,0 +1,282 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/thread_cached_allocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+// The upper bound of the blocks in one magazine, and of the full magazines
+// of one size class in the depot.
+static constexpr size_t kMaxMagazineSize = 64;
+static constexpr size_t kMagazineBytes = 256 << 10;
+static constexpr size_t kMaxDepotMagazines = 16;
+
+// log2 of kMinCachedSize and kMaxCachedSize
+static constexpr int kMinCachedSizeShift = 8;
+static constexpr int kMaxCachedSizeShift = 20;
+static constexpr int kClassesPerPowerOfTwo = 4;
+
+class ThreadCachedAllocation : public Allocation {
+ public:
+  ThreadCachedAllocation(DecoratedAllocationPtr underlying_allocation,
+                         int size_class)
+      : Allocation(underlying_allocation->ptr(),
+                   underlying_allocation->base_ptr(),
+                   underlying_allocation->size(),
+                   underlying_allocation->place()),
+        underlying_allocation_(std::move(underlying_allocation)),
+        size_class_(size_class) {}
+
+  DecoratedAllocationPtr TakeUnderlyingAllocation() {
+    return std::move(underlying_allocation_);
+  }
+
+  int SizeClass() const { return size_class_; }
+
+ private:
+  DecoratedAllocationPtr underlying_allocation_;
+  int size_class_;
+};
+
+int ThreadCachedAllocator::SizeClassOf(size_t size) {
+  if (size > kMaxCachedSize) {
+    return -1;
+  }
+  if (size <= kMinCachedSize) {
+    return 0;
+  }
+  // size is in (2^shift, 2^(shift+1)]
+  int shift = 0;
+  for (size_t s = size - 1; s > 1; s >>= 1) {
+    ++shift;
+  }
+  size_t step = static_cast<size_t>(1) << (shift - 2);
+  size_t sub_class = (size - (static_cast<size_t>(1) << shift) + step - 1) /
+                     step;  // in [1, 4]
+  return (shift - kMinCachedSizeShift) * kClassesPerPowerOfTwo +
+         static_cast<int>(sub_class);
+}
+
+size_t ThreadCachedAllocator::ClassSize(int size_class) {
+  int shift = kMinCachedSizeShift + size_class / kClassesPerPowerOfTwo;
+  size_t sub_class = size_class % kClassesPerPowerOfTwo;
+  return (kClassesPerPowerOfTwo + sub_class) << (shift - 2);
+}
+
+int ThreadCachedAllocator::NumSizeClasses() {
+  return (kMaxCachedSizeShift - kMinCachedSizeShift) * kClassesPerPowerOfTwo +
+         1;
+}
+
+ThreadCachedAllocator::Depot::Depot(
+    const std::shared_ptr<Allocator>& underlying_allocator)
+    : underlying_allocator_(underlying_allocator),
+      full_magazines_(NumSizeClasses()) {}
+
+bool ThreadCachedAllocator::Depot::PopMagazine(int size_class,
+                                               Magazine* magazine) {
+  std::lock_guard<SpinLock> guard(spinlock_);
+  auto& magazines = full_magazines_[size_class];
+  if (magazines.empty()) {
+    return false;
+  }
+  magazine->swap(magazines.back());
+  magazines.pop_back();
+  return true;
+}
+
+void ThreadCachedAllocator::Depot::PushMagazine(int size_class,
+                                                Magazine&& magazine) {
+  {
+    std::lock_guard<SpinLock> guard(spinlock_);
+    auto& magazines = full_magazines_[size_class];
+    if (magazines.size() < kMaxDepotMagazines) {
+      magazines.emplace_back(std::move(magazine));
+      return;
+    }
+  }
+  // the depot is full, free the blocks outside the lock
+  magazine.clear();
+}
+
+uint64_t ThreadCachedAllocator::Depot::Release() {
+  std::vector<std::vector<Magazine>> released(full_magazines_.size());
+  {
+    std::lock_guard<SpinLock> guard(spinlock_);
+    released.swap(full_magazines_);
+  }
+  uint64_t released_size = 0;
+  for (int size_class = 0; size_class < static_cast<int>(released.size());
+       ++size_class) {
+    for (auto& magazine : released[size_class]) {
+      released_size += magazine.size() * ClassSize(size_class);
+    }
+  }
+  return released_size;
+}
+
+ThreadCachedAllocator::ThreadCache::ThreadCache(std::shared_ptr<Depot> depot,
+                                                size_t max_cached_bytes)
+    : depot_(std::move(depot)),
+      max_cached_bytes_(max_cached_bytes),
+      magazines_(NumSizeClasses()) {}
+
+ThreadCachedAllocator::ThreadCache::~ThreadCache() {
+  // give the blocks to other threads
+  for (int size_class = 0; size_class < static_cast<int>(magazines_.size());
+       ++size_class) {
+    if (!magazines_[size_class].empty()) {
+      depot_->PushMagazine(size_class, std::move(magazines_[size_class]));
+    }
+  }
+}
+
+size_t ThreadCachedAllocator::ThreadCache::MagazineCapacity(int size_class) {
+  size_t capacity = kMagazineBytes / ClassSize(size_class);
+  return std::max<size_t>(2, std::min(capacity, kMaxMagazineSize));
+}
+
+DecoratedAllocationPtr ThreadCachedAllocator::ThreadCache::Get(
+    int size_class) {
+  auto& magazine = magazines_[size_class];
+  if (magazine.empty()) {
+    Magazine full_magazine;
+    if (depot_->PopMagazine(size_class, &full_magazine)) {
+      cached_bytes_ += full_magazine.size() * ClassSize(size_class);
+      magazine.swap(full_magazine);
+    }
+  }
+  if (!magazine.empty()) {
+    DecoratedAllocationPtr block = std::move(magazine.back());
+    magazine.pop_back();
+    cached_bytes_ -= ClassSize(size_class);
+    return block;
+  }
+  return static_unique_ptr_cast<Allocation>(
+      depot_->UnderlyingAllocator()->Allocate(ClassSize(size_class)));
+}
+
+void ThreadCachedAllocator::ThreadCache::Put(int size_class,
+                                             DecoratedAllocationPtr block) {
+  size_t class_size = ClassSize(size_class);
+  auto& magazine = magazines_[size_class];
+  if (magazine.size() >= MagazineCapacity(size_class)) {
+    cached_bytes_ -= magazine.size() * class_size;
+    Magazine full_magazine;
+    full_magazine.swap(magazine);
+    depot_->PushMagazine(size_class, std::move(full_magazine));
+  }
+  if (cached_bytes_ + class_size > max_cached_bytes_) {
+    // free to the underlying allocator
+    block.reset();
+    return;
+  }
+  magazine.emplace_back(std::move(block));
+  cached_bytes_ += class_size;
+}
+
+uint64_t ThreadCachedAllocator::ThreadCache::Release() {
+  uint64_t released_size = cached_bytes_;
+  for (auto& magazine : magazines_) {
+    magazine.clear();
+  }
+  cached_bytes_ = 0;
+  return released_size;
+}
+
+ThreadCachedAllocator::ThreadCachedAllocator(
+    const std::shared_ptr<Allocator>& underlying_allocator,
+    size_t max_cached_bytes_per_thread)
+    : depot_(std::make_shared<Depot>(underlying_allocator)),
+      max_cached_bytes_per_thread_(max_cached_bytes_per_thread) {
+  PADDLE_ENFORCE_NOT_NULL(
+      underlying_allocator,
+      platform::errors::InvalidArgument(
+          "Underlying allocator of ThreadCachedAllocator is NULL"));
+  PADDLE_ENFORCE_EQ(
+      underlying_allocator->IsAllocThreadSafe(),
+      true,
+      platform::errors::PreconditionNotMet(
+          "Underlying allocator of ThreadCachedAllocator is not thread-safe"));
+  static std::atomic<uint64_t> next_id{0};
+  id_ = next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Set when the caches of the current thread are destroyed at thread exit, an
+// allocation freed later (e.g., by another thread local object) bypasses the
+// cache.
+static thread_local bool thread_caches_destroyed = false;
+
+ThreadCachedAllocator::ThreadCache* ThreadCachedAllocator::GetThreadCache() {
+  struct ThreadCaches {
+    ~ThreadCaches() { thread_caches_destroyed = true; }
+    std::unordered_map<uint64_t, std::unique_ptr<ThreadCache>> caches;
+  };
+  static thread_local ThreadCaches thread_caches;
+  if (UNLIKELY(thread_caches_destroyed)) {
+    return nullptr;
+  }
+  auto& cache = thread_caches.caches[id_];
+  if (UNLIKELY(cache == nullptr)) {
+    cache = std::make_unique<ThreadCache>(depot_, max_cached_bytes_per_thread_);
+  }
+  return cache.get();
+}
+
+phi::Allocation* ThreadCachedAllocator::AllocateImpl(size_t size) {
+  int size_class = SizeClassOf(size);
+  ThreadCache* cache = size_class < 0 ? nullptr : GetThreadCache();
+  if (cache == nullptr) {
+    return new ThreadCachedAllocation(
+        static_unique_ptr_cast<Allocation>(
+            depot_->UnderlyingAllocator()->Allocate(size)),
+        -1);
+  }
+  return new ThreadCachedAllocation(cache->Get(size_class), size_class);
+}
+
+void ThreadCachedAllocator::FreeImpl(phi::Allocation* allocation) {
+  auto* cached_allocation = static_cast<ThreadCachedAllocation*>(allocation);
+  int size_class = cached_allocation->SizeClass();
+  DecoratedAllocationPtr block =
+      cached_allocation->TakeUnderlyingAllocation();
+  delete cached_allocation;
+  ThreadCache* cache = size_class < 0 ? nullptr : GetThreadCache();
+  if (cache != nullptr) {
+    cache->Put(size_class, std::move(block));
+  }
+}
+
+uint64_t ThreadCachedAllocator::ReleaseImpl(const platform::Place& place) {
+  uint64_t released_size = depot_->Release();
+  ThreadCache* cache = GetThreadCache();
+  if (cache != nullptr) {
+    released_size += cache->Release();
+  }
+  return released_size + depot_->UnderlyingAllocator()->Release(place);
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
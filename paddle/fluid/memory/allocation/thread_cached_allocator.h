@@ -0,0 +1,120 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "paddle/fluid/memory/allocation/allocator.h"
+#include "paddle/fluid/memory/allocation/spin_lock.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+/**
+ * ThreadCachedAllocator puts a per-thread cache in front of a shared
+ * allocator (e.g., AutoGrowthBestFitAllocator) whose free list is guarded by
+ * a single lock, so that the small allocations of different threads do not
+ * serialize on that lock.
+ *
+ * The requests not larger than kMaxCachedSize are rounded up to one of the
+ * size classes (4 classes per power of two, starting from kMinCachedSize).
+ * Each thread keeps a magazine, i.e., a bounded stack of free blocks, for
+ * each size class. Allocate pops from the magazine of the current thread and
+ * Free pushes to it, both without lock. When a magazine is empty, a full one
+ * is taken from the shared depot. When a magazine is full, it is returned to
+ * the depot as a whole, and the blocks are freed to the underlying allocator
+ * only if the depot is full too. The bytes cached by every thread are bounded
+ * by max_cached_bytes_per_thread.
+ *
+ * The requests larger than kMaxCachedSize go to the underlying allocator
+ * directly.
+ */
+class ThreadCachedAllocator : public Allocator {
+ public:
+  static constexpr size_t kMinCachedSize = 256;
+  static constexpr size_t kMaxCachedSize = 1 << 20;
+
+  ThreadCachedAllocator(const std::shared_ptr<Allocator>& underlying_allocator,
+                        size_t max_cached_bytes_per_thread);
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  // Returns the size class of size, or -1 if size is not cached.
+  static int SizeClassOf(size_t size);
+  static size_t ClassSize(int size_class);
+  static int NumSizeClasses();
+
+ protected:
+  phi::Allocation* AllocateImpl(size_t size) override;
+  void FreeImpl(phi::Allocation* allocation) override;
+  // Free the blocks cached in the depot and in the cache of the calling
+  // thread, the caches of other threads are kept.
+  uint64_t ReleaseImpl(const platform::Place& place) override;
+
+ private:
+  using Magazine = std::vector<DecoratedAllocationPtr>;
+
+  // Shared by the allocator and the caches of all threads, so that a thread
+  // exiting after the allocator is destroyed can still return its blocks.
+  class Depot {
+   public:
+    explicit Depot(const std::shared_ptr<Allocator>& underlying_allocator);
+
+    bool PopMagazine(int size_class, Magazine* magazine);
+    void PushMagazine(int size_class, Magazine&& magazine);
+    uint64_t Release();
+
+    const std::shared_ptr<Allocator>& UnderlyingAllocator() const {
+      return underlying_allocator_;
+    }
+
+   private:
+    std::shared_ptr<Allocator> underlying_allocator_;
+    SpinLock spinlock_;
+    std::vector<std::vector<Magazine>> full_magazines_;
+  };
+
+  class ThreadCache {
+   public:
+    ThreadCache(std::shared_ptr<Depot> depot, size_t max_cached_bytes);
+    ~ThreadCache();
+
+    DecoratedAllocationPtr Get(int size_class);
+    void Put(int size_class, DecoratedAllocationPtr block);
+    uint64_t Release();
+
+   private:
+    static size_t MagazineCapacity(int size_class);
+
+    std::shared_ptr<Depot> depot_;
+    size_t max_cached_bytes_;
+    size_t cached_bytes_{0};
+    std::vector<Magazine> magazines_;
+  };
+
+  ThreadCache* GetThreadCache();
+
+  std::shared_ptr<Depot> depot_;
+  size_t max_cached_bytes_per_thread_;
+  // identifies the allocator in the thread local caches, the address of the
+  // allocator is not used since it may be reused by a later allocator
+  uint64_t id_;
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
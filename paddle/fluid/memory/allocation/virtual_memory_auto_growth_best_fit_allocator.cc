@@ -17,6 +17,16 @@
 #include <mutex>
 
 #include "paddle/fluid/memory/allocation/aligned_allocator.h"
+#include "paddle/fluid/platform/flags.h"
+
+PADDLE_DEFINE_EXPORTED_bool(
+    virtual_memory_defragmentation,
+    false,
+    "Whether to release the physical memory lying entirely in the free blocks "
+    "of VirtualMemoryAutoGrowthBestFitAllocator when the memory is released "
+    "or the allocation fails, so that it can be remapped into a contiguous "
+    "virtual address range. This flag only works when "
+    "FLAGS_use_virtual_memory_auto_growth=true.");
 
 namespace paddle {
 namespace memory {
@@ -44,13 +54,84 @@ phi::Allocation *VirtualMemoryAutoGrowthBestFitAllocator::AllocateImpl(
   auto result = AllocFromFreeBlocks(size);
 
   if (!result) {
-    ExtendAndMerge(size);
+    try {
+      ExtendAndMerge(size);
+    } catch (BadAlloc &ex) {
+      if (!FLAGS_virtual_memory_defragmentation || Compact() == 0) {
+        throw;
+      }
+      VLOG(2) << "Retry to extend " << size << " bytes after compaction";
+      ExtendAndMerge(size);
+    }
     result = AllocFromFreeBlocks(size);
   }
 
   return result;
 }
 
+uint64_t VirtualMemoryAutoGrowthBestFitAllocator::ReleaseImpl(
+    const platform::Place &place) {
+  if (!FLAGS_virtual_memory_defragmentation) {
+    return 0;
+  }
+  std::lock_guard<SpinLock> guard(spinlock_);
+  return Compact();
+}
+
+uint64_t VirtualMemoryAutoGrowthBestFitAllocator::Compact() {
+  std::map<uint8_t *, std::list<AllocationPtr>::iterator> allocations;
+  for (auto it = allocations_.begin(); it != allocations_.end(); ++it) {
+    allocations.emplace(reinterpret_cast<uint8_t *>((*it)->ptr()), it);
+  }
+
+  uint64_t released_size = 0;
+  for (auto block_it = all_blocks_.begin(); block_it != all_blocks_.end();) {
+    if (!block_it->is_free_) {
+      ++block_it;
+      continue;
+    }
+    auto *block_begin = reinterpret_cast<uint8_t *>(block_it->ptr_);
+    auto *block_end = block_begin + block_it->size_;
+    auto *cursor = block_begin;
+    bool released = false;
+    for (auto iter = allocations.lower_bound(block_begin);
+         iter != allocations.end() && iter->first < block_end;) {
+      auto *allocation_end = iter->first + (*iter->second)->size();
+      if (allocation_end > block_end) {
+        break;
+      }
+      if (!released) {
+        free_blocks_.erase(std::make_pair(block_it->size_, block_it->ptr_));
+        released = true;
+      }
+      // keep the free part before the released allocation
+      if (iter->first > cursor) {
+        size_t size = iter->first - cursor;
+        auto remaining =
+            all_blocks_.insert(block_it, Block(cursor, size, true));
+        free_blocks_.emplace(std::make_pair(size, cursor), remaining);
+      }
+      VLOG(2) << "Release " << (*iter->second)->size() << " bytes at "
+              << (*iter->second)->ptr() << " in compaction";
+      released_size += (*iter->second)->size();
+      cursor = allocation_end;
+      allocations_.erase(iter->second);
+      iter = allocations.erase(iter);
+    }
+    if (!released) {
+      ++block_it;
+      continue;
+    }
+    if (cursor < block_end) {
+      size_t size = block_end - cursor;
+      auto remaining = all_blocks_.insert(block_it, Block(cursor, size, true));
+      free_blocks_.emplace(std::make_pair(size, cursor), remaining);
+    }
+    block_it = all_blocks_.erase(block_it);
+  }
+  return released_size;
+}
+
 void VirtualMemoryAutoGrowthBestFitAllocator::FreeImpl(
     phi::Allocation *allocation) {
   std::lock_guard<SpinLock> guard(spinlock_);
@@ -165,7 +246,7 @@ void VirtualMemoryAutoGrowthBestFitAllocator::ExtendAndMerge(size_t size) {
                                block_it);
         } else {
           // do not merge
-          all_blocks_.emplace_back(ptr, size, true);
+          all_blocks_.emplace_front(ptr, size, true);
           free_blocks_.emplace(std::make_pair(size, ptr), all_blocks_.begin());
         }
       } else {
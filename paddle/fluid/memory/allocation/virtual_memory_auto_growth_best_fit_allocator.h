@@ -50,6 +50,12 @@ struct BlockAllocation : public Allocation {
  * address. If the video memory applied for twice is continuous, we can combine
  * the two video memories later. This combination can greatly reduce
  * fragmentation.
+ *
+ * With FLAGS_virtual_memory_defragmentation, the free blocks are compacted in
+ * Release and when the allocation fails: the underlying allocations lying
+ * entirely in the free blocks are freed, i.e., their physical memory is
+ * unmapped and released, so that the following allocation maps it again into
+ * a contiguous virtual address range. The live blocks are never moved.
  */
 class VirtualMemoryAutoGrowthBestFitAllocator : public Allocator {
  public:
@@ -65,7 +71,13 @@ class VirtualMemoryAutoGrowthBestFitAllocator : public Allocator {
 
   void FreeImpl(phi::Allocation *allocation) override;
 
+  uint64_t ReleaseImpl(const platform::Place &place) override;
+
  private:
+  // Free the underlying allocations lying entirely in the free blocks, return
+  // the released size.
+  uint64_t Compact();
+
   phi::Allocation *AllocFromFreeBlocks(size_t size);
   void ExtendAndMerge(size_t size);
   void TryMergeBlock2Blocks(std::list<Block>::iterator iter);
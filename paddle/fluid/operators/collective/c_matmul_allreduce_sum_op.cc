@@ -0,0 +1,125 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/framework/op_registry.h"
+
+namespace paddle {
+namespace operators {
+
+class CMatmulAllReduceSumOp : public framework::OperatorWithKernel {
+ public:
+  using framework::OperatorWithKernel::OperatorWithKernel;
+
+  void InferShape(framework::InferShapeContext* ctx) const override {
+    OP_INOUT_CHECK(ctx->HasInput("X"), "Input", "X", "c_matmul_allreduce_sum");
+    OP_INOUT_CHECK(ctx->HasInput("Y"), "Input", "Y", "c_matmul_allreduce_sum");
+    OP_INOUT_CHECK(
+        ctx->HasOutput("Out"), "Output", "Out", "c_matmul_allreduce_sum");
+    auto x_dims = ctx->GetInputDim("X");
+    auto y_dims = ctx->GetInputDim("Y");
+    bool trans_y = ctx->Attrs().Get<bool>("trans_y");
+    int num_chunks = ctx->Attrs().Get<int>("num_chunks");
+    PADDLE_ENFORCE_GE(x_dims.size(),
+                      2,
+                      platform::errors::InvalidArgument(
+                          "The rank of Input(X) of c_matmul_allreduce_sum "
+                          "should be at least 2, but got %d.",
+                          x_dims.size()));
+    PADDLE_ENFORCE_EQ(y_dims.size(),
+                      2,
+                      platform::errors::InvalidArgument(
+                          "The Input(Y) of c_matmul_allreduce_sum should be "
+                          "a 2-D tensor, but got its rank %d.",
+                          y_dims.size()));
+    PADDLE_ENFORCE_GE(num_chunks,
+                      1,
+                      platform::errors::InvalidArgument(
+                          "The num_chunks (%d) of c_matmul_allreduce_sum "
+                          "should be greater than 0.",
+                          num_chunks));
+    int64_t k = trans_y ? y_dims[1] : y_dims[0];
+    int64_t n = trans_y ? y_dims[0] : y_dims[1];
+    if (ctx->IsRuntime() || (x_dims[x_dims.size() - 1] > 0 && k > 0)) {
+      PADDLE_ENFORCE_EQ(x_dims[x_dims.size() - 1],
+                        k,
+                        platform::errors::InvalidArgument(
+                            "The last dim of Input(X) (%d) of "
+                            "c_matmul_allreduce_sum should be equal to the "
+                            "reduced dim of Input(Y) (%d).",
+                            x_dims[x_dims.size() - 1],
+                            k));
+    }
+    if (ctx->HasInput("Bias")) {
+      auto bias_dims = ctx->GetInputDim("Bias");
+      PADDLE_ENFORCE_EQ(phi::product(bias_dims),
+                        n,
+                        platform::errors::InvalidArgument(
+                            "The size of Input(Bias) (%d) of "
+                            "c_matmul_allreduce_sum should be equal to the "
+                            "output dim of Input(Y) (%d).",
+                            phi::product(bias_dims),
+                            n));
+    }
+    auto out_dims = x_dims;
+    out_dims[out_dims.size() - 1] = n;
+    ctx->SetOutputDim("Out", out_dims);
+    ctx->ShareLoD("X", "Out");
+  }
+
+ protected:
+  phi::KernelKey GetExpectedKernelType(
+      const framework::ExecutionContext& ctx) const override {
+    return phi::KernelKey(OperatorWithKernel::IndicateVarDataType(ctx, "X"),
+                          ctx.GetPlace());
+  }
+};
+
+class CMatmulAllReduceSumOpMaker : public framework::OpProtoAndCheckerMaker {
+ public:
+  void Make() override {
+    AddInput("X", "(Tensor) The input of the row parallel matmul, [*, K].");
+    AddInput("Y",
+             "(Tensor) The weight shard of the row parallel matmul, [K, N], "
+             "or [N, K] if trans_y is set.");
+    AddInput("Bias", "(Tensor) The bias added after the allreduce, [N].")
+        .AsDispensable();
+    AddOutput("Out", "(Tensor) The allreduced result, [*, N].");
+    AddAttr<int>("ring_id", "(int default 0) communication ring id.")
+        .SetDefault(0);
+    AddAttr<bool>("trans_y", "(bool default false) transpose Input(Y).")
+        .SetDefault(false);
+    AddAttr<int>("num_chunks",
+                 "(int default 4) the number of row chunks whose allreduce "
+                 "overlaps the matmul of the next chunk.")
+        .SetDefault(4);
+    AddComment(R"DOC(
+CMatmulAllReduceSum Operator
+
+Computes Out = AllReduceSum(matmul(X, Y)) + Bias, the row parallel linear of
+tensor parallelism. The rows of X are split into num_chunks chunks, the matmul
+of each chunk runs on the calculation stream and its allreduce on the
+communication stream, so the allreduce of a chunk overlaps the matmul of the
+next one.
+)DOC");
+  }
+};
+
+}  // namespace operators
+}  // namespace paddle
+
+namespace ops = paddle::operators;
+
+REGISTER_OP_WITHOUT_GRADIENT(c_matmul_allreduce_sum,
+                             ops::CMatmulAllReduceSumOp,
+                             ops::CMatmulAllReduceSumOpMaker);
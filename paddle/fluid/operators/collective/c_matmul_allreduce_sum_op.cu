@@ -0,0 +1,184 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/framework/op_registry.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/core/distributed/comm_context_manager.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+#include "paddle/fluid/platform/collective_helper.h"
+#include "paddle/fluid/platform/device/gpu/nccl_helper.h"
+#include "paddle/phi/core/distributed/nccl_comm_context.h"
+#include "paddle/phi/core/flags.h"
+PHI_DECLARE_bool(dynamic_static_unified_comm);
+#endif
+
+namespace paddle {
+namespace operators {
+
+template <typename T>
+__global__ void AddBiasKernel(T* out, const T* bias, int64_t rows, int64_t n) {
+  CUDA_KERNEL_LOOP_TYPE(i, rows * n, int64_t) { out[i] += bias[i % n]; }
+}
+
+template <typename T, typename DeviceContext>
+class CMatmulAllReduceSumOpCUDAKernel : public framework::OpKernel<T> {
+ public:
+  void Compute(const framework::ExecutionContext& ctx) const override {
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+    auto* x = ctx.Input<phi::DenseTensor>("X");
+    auto* y = ctx.Input<phi::DenseTensor>("Y");
+    auto* bias = ctx.Input<phi::DenseTensor>("Bias");
+    auto* out = ctx.Output<phi::DenseTensor>("Out");
+    const int rid = ctx.Attr<int>("ring_id");
+    const bool trans_y = ctx.Attr<bool>("trans_y");
+    const int num_chunks = ctx.Attr<int>("num_chunks");
+    auto place = ctx.GetPlace();
+    auto& dev_ctx = ctx.template device_context<phi::GPUContext>();
+
+    const auto& x_dims = x->dims();
+    const int64_t k = x_dims[x_dims.size() - 1];
+    const int64_t m = x->numel() / k;
+    const int64_t n = trans_y ? y->dims()[0] : y->dims()[1];
+    T* out_data = out->mutable_data<T>(place);
+    if (m == 0) return;
+
+    gpuStream_t calc_stream = dev_ctx.stream();
+    gpuStream_t comm_stream = nullptr;
+    gpuEvent_t compute_event = nullptr;
+    gpuEvent_t comm_event = nullptr;
+    platform::NCCLComm* comm = nullptr;
+    phi::distributed::NCCLCommContext* comm_ctx = nullptr;
+    int rank = 0;
+
+    const auto& comm_context_manager =
+        phi::distributed::CommContextManager::GetInstance();
+    if (FLAGS_dynamic_static_unified_comm) {
+      PADDLE_ENFORCE_EQ(comm_context_manager.Has(std::to_string(rid)),
+                        true,
+                        platform::errors::InvalidArgument(
+                            "You choose to use new communication library by "
+                            "setting environment "
+                            "variable FLAGS_dynamic_static_unified_comm True. "
+                            "But ring_id(%d) is "
+                            "not found in comm_context_manager.",
+                            std::to_string(rid)));
+      comm_ctx = static_cast<phi::distributed::NCCLCommContext*>(
+          comm_context_manager.Get(std::to_string(rid)));
+      PADDLE_ENFORCE_NE(comm_ctx,
+                        nullptr,
+                        platform::errors::Unavailable(
+                            "NCCLCommContext is nullptr, collective op should "
+                            "has ring_id attr."));
+      comm_stream = comm_ctx->GetStream();
+      compute_event = comm_ctx->GetComputeEvent();
+      comm_event = comm_ctx->GetCommEvent();
+      rank = comm_ctx->GetRank();
+      VLOG(3) << "new comm_context_manager has rid " << rid;
+    } else {
+      comm = platform::NCCLCommContext::Instance().Get(rid, place);
+      comm_stream = comm->stream();
+      compute_event = comm->compute_event();
+      comm_event = comm->comm_event();
+      rank = comm->rank();
+      VLOG(3) << "old NCCLCommContext has rid " << rid;
+    }
+
+    ncclDataType_t dtype =
+        platform::ToNCCLDataType(framework::TransToProtoVarType(x->dtype()));
+    auto blas = phi::funcs::GetBlas<phi::GPUContext, T>(dev_ctx);
+    const int64_t chunk_rows = (m + num_chunks - 1) / num_chunks;
+    phi::DenseTensor out_2d;
+    out_2d.ShareDataWith(*out).Resize({m, n});
+    for (int64_t row = 0; row < m; row += chunk_rows) {
+      const int64_t rows = std::min(chunk_rows, m - row);
+      T* chunk_out = out_data + row * n;
+      blas.GEMM(CblasNoTrans,
+                trans_y ? CblasTrans : CblasNoTrans,
+                rows,
+                n,
+                k,
+                static_cast<T>(1),
+                x->data<T>() + row * k,
+                y->data<T>(),
+                static_cast<T>(0),
+                chunk_out);
+      // the bias is added once, by rank 0 before the sum
+      if (bias != nullptr && rank == 0) {
+        auto config =
+            phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, rows * n);
+        AddBiasKernel<T><<<config.block_per_grid,
+                           config.thread_per_block,
+                           0,
+                           calc_stream>>>(
+            chunk_out, bias->data<T>(), rows, n);
+      }
+      // calc_stream-->compute_event-->comm_stream, the event is recorded again
+      // by the next chunk after the wait is enqueued
+#ifdef PADDLE_WITH_HIP
+      PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(compute_event, calc_stream));
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          hipStreamWaitEvent(comm_stream, compute_event, 0));
+#else
+      PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(compute_event, calc_stream));
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaStreamWaitEvent(comm_stream, compute_event, 0));
+#endif
+      if (comm_ctx) {
+        phi::DenseTensor chunk = out_2d.Slice(row, row + rows);
+        comm_ctx->AllReduce(&chunk, chunk, ncclSum, comm_stream);
+      } else {
+        PADDLE_ENFORCE_GPU_SUCCESS(
+            platform::dynload::ncclAllReduce(chunk_out,
+                                             chunk_out,
+                                             rows * n,
+                                             dtype,
+                                             ncclSum,
+                                             comm->comm(),
+                                             comm_stream));
+      }
+    }
+    // comm_stream-->comm_event-->calc_stream
+#ifdef PADDLE_WITH_HIP
+    PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(comm_event, comm_stream));
+    PADDLE_ENFORCE_GPU_SUCCESS(hipStreamWaitEvent(calc_stream, comm_event, 0));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(comm_event, comm_stream));
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(calc_stream, comm_event, 0));
+#endif
+#else
+    PADDLE_THROW(platform::errors::PreconditionNotMet(
+        "PaddlePaddle should compile with GPU."));
+#endif
+  }
+};
+
+}  // namespace operators
+}  // namespace paddle
+
+namespace ops = paddle::operators;
+namespace plat = paddle::platform;
+
+PD_REGISTER_STRUCT_KERNEL(c_matmul_allreduce_sum,
+                          GPU,
+                          ALL_LAYOUT,
+                          ops::CMatmulAllReduceSumOpCUDAKernel,
+                          float,
+#if NCCL_VERSION_CODE >= 21000 && CUDA_VERSION >= 11000
+                          plat::bfloat16,
+#endif
+                          plat::float16) {
+}
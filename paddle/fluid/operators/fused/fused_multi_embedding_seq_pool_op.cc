@@ -0,0 +1,220 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/operators/fused/fused_multi_embedding_seq_pool_op.h"
+
+#include <string>
+
+#include "paddle/fluid/framework/var_type_inference.h"
+
+namespace paddle {
+namespace operators {
+
+class FusedMultiEmbeddingSeqPoolOp : public framework::OperatorWithKernel {
+ public:
+  using framework::OperatorWithKernel::OperatorWithKernel;
+
+  void InferShape(framework::InferShapeContext* ctx) const override {
+    OP_INOUT_CHECK(
+        ctx->HasInput("W"), "Input", "W", "FusedMultiEmbeddingSeqPool");
+    OP_INOUT_CHECK(
+        ctx->HasInputs("Ids"), "Input", "Ids", "FusedMultiEmbeddingSeqPool");
+    OP_INOUT_CHECK(
+        ctx->HasOutput("Out"), "Output", "Out", "FusedMultiEmbeddingSeqPool");
+    auto table_dims = ctx->GetInputDim("W");
+    auto ids_dims = ctx->GetInputsDim("Ids");
+    const std::string& combiner = ctx->Attrs().Get<std::string>("combiner");
+
+    PADDLE_ENFORCE_EQ(table_dims.size(),
+                      2,
+                      platform::errors::InvalidArgument(
+                          "The dim size of the input tensor 'W' should be 2. "
+                          "But received W's size = %d.",
+                          table_dims.size()));
+    PADDLE_ENFORCE_GT(ids_dims.size(),
+                      0UL,
+                      platform::errors::InvalidArgument(
+                          "The Input(Ids) of FusedMultiEmbeddingSeqPool "
+                          "should have at least one slot."));
+    for (size_t slot = 0; slot < ids_dims.size(); ++slot) {
+      PADDLE_ENFORCE_EQ(
+          ids_dims[slot].size() == 1 ||
+              (ids_dims[slot].size() == 2 && ids_dims[slot][1] == 1),
+          true,
+          platform::errors::InvalidArgument(
+              "The Input(Ids) of slot %d should be in the shape [-1] or "
+              "[-1, 1]. But received its shape = [%s].",
+              slot,
+              ids_dims[slot]));
+    }
+    // we only support sum now
+    PADDLE_ENFORCE_EQ(combiner,
+                      "sum",
+                      platform::errors::Unimplemented(
+                          "The pooling type of sequence_pool only support sum "
+                          "now. So the 'combiner' must be 'sum'."));
+    if (!ctx->IsRuntime()) {
+      for (auto* ids_var : ctx->GetInputVarPtrs("Ids")) {
+        framework::VarDesc* ids_desc =
+            PADDLE_GET(framework::VarDesc*, ids_var);
+        PADDLE_ENFORCE_EQ(ids_desc->GetLoDLevel(),
+                          1,
+                          platform::errors::InvalidArgument(
+                              "In compile time, the LoD Level of Ids should "
+                              "be 1. But received the LoD Level of Ids %s = "
+                              "%d.",
+                              ids_desc->Name(),
+                              ids_desc->GetLoDLevel()));
+      }
+    }
+
+    // the pooled embeddings of the slots are concatenated in the order of Ids
+    int64_t out_width = table_dims[1] * static_cast<int64_t>(ids_dims.size());
+    ctx->SetOutputDim("Out", common::make_ddim({-1, out_width}));
+  }
+
+ protected:
+  phi::KernelKey GetExpectedKernelType(
+      const framework::ExecutionContext& ctx) const override {
+    auto data_type = OperatorWithKernel::IndicateVarDataType(ctx, "W");
+    return phi::KernelKey(data_type, ctx.GetPlace());
+  }
+};
+
+class FusedMultiEmbeddingSeqPoolOpMaker
+    : public framework::OpProtoAndCheckerMaker {
+ public:
+  void Make() override {
+    AddInput("W",
+             "(Tensor) The embedding table shared by the slots, "
+             "which is a learnable parameter.");
+    AddInput("Ids",
+             "(phi::DenseTensor) The int64 ids of each slot to be looked up "
+             "in W, in the shape [-1] or [-1, 1] with the LoD level 1. All "
+             "the slots should have the same batch size.")
+        .AsDuplicable();
+    AddOutput("Out",
+              "(Tensor) The sum pooled embeddings of the slots concatenated, "
+              "in the shape [batch_size, slot_num * embedding_size].");
+    AddAttr<std::string>("combiner",
+                         "(string, default sum) "
+                         "A string specifying the reduction op. Currently sum "
+                         "are supported.")
+        .SetDefault("sum");
+    AddAttr<int64_t>("padding_idx",
+                     "(int64, default -1) "
+                     "If the value is -1, it makes no effect to lookup. "
+                     "Otherwise the given value indicates the id which is "
+                     "pooled as zeros.")
+        .SetDefault(kMultiEmbNoPadding);
+    AddAttr<bool>("is_sparse",
+                  "(boolean, default false) "
+                  "Sparse update, the grads of all the slots are merged "
+                  "into one SelectedRows.")
+        .SetDefault(false);
+    AddAttr<bool>(framework::kAllKernelsMustComputeRuntimeShape,
+                  "Skip calling InferShape() function in the runtime.")
+        .SetDefault(true);
+    AddComment(R"DOC(
+FusedMultiEmbeddingSeqPool Operator.
+
+Fuses lookup_table, sequence_pool(SUM) of every slot and the concat of the
+slots, for the models with many sparse slots sharing an embedding table.
+
+For every slot s and every sequence i of its ids,
+Out[i, s * D : (s + 1) * D] = sum(W[id] for id in Ids[s][i]),
+with D the width of W, so all the slots are pooled by one kernel launch.
+
+)DOC");
+  }
+};
+
+class FusedMultiEmbeddingSeqPoolOpGrad : public framework::OperatorWithKernel {
+ public:
+  using framework::OperatorWithKernel::OperatorWithKernel;
+
+  void InferShape(framework::InferShapeContext* ctx) const override {
+    auto table_dims = ctx->GetInputDim("W");
+    ctx->SetOutputDim(framework::GradVarName("W"), table_dims);
+  }
+
+ protected:
+  phi::KernelKey GetExpectedKernelType(
+      const framework::ExecutionContext& ctx) const override {
+    auto data_type = OperatorWithKernel::IndicateVarDataType(ctx, "W");
+    return phi::KernelKey(data_type, ctx.GetPlace());
+  }
+};
+
+class FusedMultiEmbeddingSeqPoolOpGradVarTypeInference
+    : public framework::VarTypeInference {
+ public:
+  void operator()(framework::InferVarTypeContext* ctx) const override {
+    auto out_var_name = framework::GradVarName("W");
+    auto attr = ctx->GetAttr("is_sparse");
+    bool is_sparse = PADDLE_GET(bool, attr);
+    if (is_sparse) {
+      ctx->SetOutputType(out_var_name,
+                         framework::proto::VarType::SELECTED_ROWS);
+    } else {
+      ctx->SetOutputType(out_var_name, framework::proto::VarType::LOD_TENSOR);
+    }
+    ctx->SetOutputDataType(out_var_name, ctx->GetInputDataType("W"));
+  }
+};
+
+template <typename T>
+class FusedMultiEmbeddingSeqPoolGradOpMaker
+    : public framework::SingleGradOpMaker<T> {
+ public:
+  using framework::SingleGradOpMaker<T>::SingleGradOpMaker;
+
+ protected:
+  void Apply(GradOpPtr<T> op) const override {
+    op->SetType("fused_multi_embedding_seq_pool_grad");
+    op->SetInput("Ids", this->Input("Ids"));
+    op->SetInput("W", this->Input("W"));
+    op->SetInput(framework::GradVarName("Out"), this->OutputGrad("Out"));
+    op->SetOutput(framework::GradVarName("W"), this->InputGrad("W"));
+    op->SetAttrMap(this->Attrs());
+  }
+};
+
+}  // namespace operators
+}  // namespace paddle
+
+namespace ops = paddle::operators;
+
+REGISTER_OPERATOR(
+    fused_multi_embedding_seq_pool,
+    ops::FusedMultiEmbeddingSeqPoolOp,
+    ops::FusedMultiEmbeddingSeqPoolGradOpMaker<paddle::framework::OpDesc>,
+    ops::FusedMultiEmbeddingSeqPoolGradOpMaker<paddle::imperative::OpBase>,
+    ops::FusedMultiEmbeddingSeqPoolOpMaker);
+REGISTER_OPERATOR(fused_multi_embedding_seq_pool_grad,
+                  ops::FusedMultiEmbeddingSeqPoolOpGrad,
+                  ops::FusedMultiEmbeddingSeqPoolOpGradVarTypeInference);
+
+PD_REGISTER_STRUCT_KERNEL(fused_multi_embedding_seq_pool,
+                          CPU,
+                          ALL_LAYOUT,
+                          ops::FusedMultiEmbeddingSeqPoolKernel,
+                          float,
+                          double) {}
+PD_REGISTER_STRUCT_KERNEL(fused_multi_embedding_seq_pool_grad,
+                          CPU,
+                          ALL_LAYOUT,
+                          ops::FusedMultiEmbeddingSeqPoolGradKernel,
+                          float,
+                          double) {}
@@ -0,0 +1,308 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <memory>
+#include <vector>
+
+#include "paddle/fluid/framework/eigen.h"
+#include "paddle/fluid/memory/memcpy.h"
+#include "paddle/fluid/memory/memory.h"
+#include "paddle/fluid/operators/fused/fused_multi_embedding_seq_pool_op.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/backends/gpu/gpu_primitives.h"
+
+namespace paddle {
+namespace operators {
+
+// The ids, the LoD and the grad row offset of every slot on the device. The
+// LoD of the slot s is lods[s * (batch_size + 1), (s + 1) * (batch_size + 1)).
+struct MultiEmbeddingSlots {
+  const int64_t **ids;
+  const size_t *lods;
+  const int64_t *row_offsets;
+  std::shared_ptr<phi::Allocation> holder;
+};
+
+static MultiEmbeddingSlots CopySlotsToDevice(
+    const phi::GPUContext &dev_ctx,
+    const std::vector<const phi::DenseTensor *> &ids,
+    int64_t batch_size) {
+  const size_t slot_num = ids.size();
+  std::vector<const int64_t *> ids_data(slot_num);
+  std::vector<int64_t> row_offsets(slot_num);
+  std::vector<size_t> lods;
+  lods.reserve(slot_num * (batch_size + 1));
+  int64_t row_offset = 0;
+  for (size_t slot = 0; slot < slot_num; ++slot) {
+    ids_data[slot] = ids[slot]->data<int64_t>();
+    row_offsets[slot] = row_offset;
+    row_offset += ids[slot]->numel();
+    const auto &lod = ids[slot]->lod()[0];
+    lods.insert(lods.end(), lod.begin(), lod.end());
+  }
+
+  // one allocation and three copies for all the slots
+  const size_t ids_bytes = slot_num * sizeof(int64_t *);
+  const size_t offsets_bytes = slot_num * sizeof(int64_t);
+  const size_t lods_bytes = lods.size() * sizeof(size_t);
+  auto place = dev_ctx.GetPlace();
+  auto stream = dev_ctx.stream();
+  MultiEmbeddingSlots slots;
+  // the stream safe allocation is not reused before the kernels finish
+  slots.holder = memory::AllocShared(
+      place,
+      ids_bytes + offsets_bytes + lods_bytes,
+      phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
+  char *ptr = reinterpret_cast<char *>(slots.holder->ptr());
+  slots.ids = reinterpret_cast<const int64_t **>(ptr);
+  slots.row_offsets = reinterpret_cast<const int64_t *>(ptr + ids_bytes);
+  slots.lods =
+      reinterpret_cast<const size_t *>(ptr + ids_bytes + offsets_bytes);
+  memory::Copy(
+      place, ptr, platform::CPUPlace(), ids_data.data(), ids_bytes, stream);
+  memory::Copy(place,
+               ptr + ids_bytes,
+               platform::CPUPlace(),
+               row_offsets.data(),
+               offsets_bytes,
+               stream);
+  memory::Copy(place,
+               ptr + ids_bytes + offsets_bytes,
+               platform::CPUPlace(),
+               lods.data(),
+               lods_bytes,
+               stream);
+  return slots;
+}
+
+// Each thread pools a column of a slot of a row of Out, so the adjacent
+// threads read the adjacent columns of an embedding.
+template <typename T>
+__global__ void FusedMultiEmbeddingSeqPool(T *output,
+                                           const T *table,
+                                           const int64_t **ids,
+                                           const size_t *lods,
+                                           const int64_t slot_num,
+                                           const int64_t batch_size,
+                                           const int64_t width,
+                                           const int64_t padding_idx) {
+  CUDA_KERNEL_LOOP_TYPE(i, batch_size * slot_num * width, int64_t) {
+    const int64_t col = i % width;
+    const int64_t slot = (i / width) % slot_num;
+    const int64_t row = i / (width * slot_num);
+    const size_t *lod = lods + slot * (batch_size + 1);
+    const int64_t *slot_ids = ids[slot];
+    T val = static_cast<T>(0);
+    for (size_t j = lod[row]; j < lod[row + 1]; ++j) {
+      const int64_t id = slot_ids[j];
+      if (id != padding_idx) {
+        val += table[id * width + col];
+      }
+    }
+    output[i] = val;
+  }
+}
+
+template <typename T>
+__global__ void FusedMultiEmbeddingSeqPoolSparseGrad(
+    T *d_table_value,
+    const T *d_output,
+    const int64_t **ids,
+    const size_t *lods,
+    const int64_t *row_offsets,
+    const int64_t slot_num,
+    const int64_t batch_size,
+    const int64_t width,
+    const int64_t padding_idx) {
+  CUDA_KERNEL_LOOP_TYPE(i, batch_size * slot_num * width, int64_t) {
+    const int64_t col = i % width;
+    const int64_t slot = (i / width) % slot_num;
+    const int64_t row = i / (width * slot_num);
+    const size_t *lod = lods + slot * (batch_size + 1);
+    const int64_t *slot_ids = ids[slot];
+    const T grad = d_output[i];
+    T *slot_value = d_table_value + row_offsets[slot] * width;
+    for (size_t j = lod[row]; j < lod[row + 1]; ++j) {
+      slot_value[j * width + col] =
+          slot_ids[j] == padding_idx ? static_cast<T>(0) : grad;
+    }
+  }
+}
+
+template <typename T>
+__global__ void FusedMultiEmbeddingSeqPoolDenseGrad(T *d_table,
+                                                    const T *d_output,
+                                                    const int64_t **ids,
+                                                    const size_t *lods,
+                                                    const int64_t slot_num,
+                                                    const int64_t batch_size,
+                                                    const int64_t width,
+                                                    const int64_t padding_idx) {
+  CUDA_KERNEL_LOOP_TYPE(i, batch_size * slot_num * width, int64_t) {
+    const int64_t col = i % width;
+    const int64_t slot = (i / width) % slot_num;
+    const int64_t row = i / (width * slot_num);
+    const size_t *lod = lods + slot * (batch_size + 1);
+    const int64_t *slot_ids = ids[slot];
+    const T grad = d_output[i];
+    for (size_t j = lod[row]; j < lod[row + 1]; ++j) {
+      const int64_t id = slot_ids[j];
+      if (id != padding_idx) {
+        phi::CudaAtomicAdd(d_table + id * width + col, grad);
+      }
+    }
+  }
+}
+
+template <typename T, typename DeviceContext>
+class FusedMultiEmbeddingSeqPoolCUDAKernel : public framework::OpKernel<T> {
+ public:
+  void Compute(const framework::ExecutionContext &context) const override {
+    auto &dev_ctx = context.template device_context<phi::GPUContext>();
+    auto ids = context.MultiInput<phi::DenseTensor>("Ids");
+    auto *table_t = context.Input<phi::DenseTensor>("W");
+    auto *output_t = context.Output<phi::DenseTensor>("Out");
+    int64_t padding_idx = context.Attr<int64_t>("padding_idx");
+
+    const int64_t slot_num = static_cast<int64_t>(ids.size());
+    const int64_t width = table_t->dims()[1];
+    const int64_t batch_size = MultiEmbeddingSeqPoolBatchSize(ids);
+    output_t->Resize({batch_size, width * slot_num});
+    T *output = output_t->mutable_data<T>(context.GetPlace());
+    const int64_t numel = output_t->numel();
+    if (numel == 0) return;
+
+    auto slots = CopySlotsToDevice(dev_ctx, ids, batch_size);
+    auto config = phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, numel);
+    FusedMultiEmbeddingSeqPool<T><<<config.block_per_grid,
+                                    config.thread_per_block,
+                                    0,
+                                    dev_ctx.stream()>>>(output,
+                                                        table_t->data<T>(),
+                                                        slots.ids,
+                                                        slots.lods,
+                                                        slot_num,
+                                                        batch_size,
+                                                        width,
+                                                        padding_idx);
+  }
+};
+
+template <typename T, typename DeviceContext>
+class FusedMultiEmbeddingSeqPoolGradCUDAKernel
+    : public framework::OpKernel<T> {
+ public:
+  void Compute(const framework::ExecutionContext &context) const override {
+    auto &dev_ctx = context.template device_context<phi::GPUContext>();
+    auto ids = context.MultiInput<phi::DenseTensor>("Ids");
+    auto *table_t = context.Input<phi::DenseTensor>("W");
+    auto *d_output =
+        context.Input<phi::DenseTensor>(framework::GradVarName("Out"));
+    int64_t padding_idx = context.Attr<int64_t>("padding_idx");
+    bool is_sparse = context.Attr<bool>("is_sparse");
+
+    const int64_t slot_num = static_cast<int64_t>(ids.size());
+    const auto table_dim = table_t->dims();
+    const int64_t width = table_dim[1];
+    const int64_t batch_size = MultiEmbeddingSeqPoolBatchSize(ids);
+    const int64_t numel = batch_size * slot_num * width;
+    auto gpu_place = context.GetPlace();
+    auto stream = dev_ctx.stream();
+    auto slots = CopySlotsToDevice(dev_ctx, ids, batch_size);
+    auto config = phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, numel);
+
+    // Since paddings are not trainable and fixed in forward, the gradient of
+    // paddings makes no sense and we don't deal with it in backward.
+    if (is_sparse) {
+      // the grads of all the slots are merged into one SelectedRows, with a
+      // row for each id
+      auto *d_table =
+          context.Output<phi::SelectedRows>(framework::GradVarName("W"));
+      d_table->set_height(table_dim[0]);
+      int64_t ids_num = 0;
+      for (auto *ids_t : ids) {
+        ids_num += ids_t->numel();
+      }
+      phi::Vector<int64_t> new_rows;
+      new_rows.resize(ids_num);
+      phi::MixVector<int64_t> mixv_new_rows(&new_rows);
+      int64_t *rows_data = mixv_new_rows.CUDAMutableData(gpu_place);
+      int64_t row_offset = 0;
+      for (auto *ids_t : ids) {
+        memory::Copy(gpu_place,
+                     rows_data + row_offset,
+                     gpu_place,
+                     ids_t->data<int64_t>(),
+                     ids_t->numel() * sizeof(int64_t),
+                     stream);
+        row_offset += ids_t->numel();
+      }
+      mixv_new_rows.CopyToCPU();
+      d_table->set_rows(new_rows);
+
+      auto *d_table_value = d_table->mutable_value();
+      d_table_value->Resize({ids_num, width});
+      T *d_table_data = d_table_value->mutable_data<T>(gpu_place);
+      if (numel == 0) return;
+      FusedMultiEmbeddingSeqPoolSparseGrad<T>
+          <<<config.block_per_grid, config.thread_per_block, 0, stream>>>(
+              d_table_data,
+              d_output->data<T>(),
+              slots.ids,
+              slots.lods,
+              slots.row_offsets,
+              slot_num,
+              batch_size,
+              width,
+              padding_idx);
+    } else {
+      auto *d_table_t =
+          context.Output<phi::DenseTensor>(framework::GradVarName("W"));
+      d_table_t->Resize(table_dim);
+      T *d_table = d_table_t->mutable_data<T>(gpu_place);
+      auto t = framework::EigenVector<T>::Flatten(*d_table_t);
+      t.device(*dev_ctx.eigen_device()) = t.constant(static_cast<T>(0));
+      if (numel == 0) return;
+      FusedMultiEmbeddingSeqPoolDenseGrad<T>
+          <<<config.block_per_grid, config.thread_per_block, 0, stream>>>(
+              d_table,
+              d_output->data<T>(),
+              slots.ids,
+              slots.lods,
+              slot_num,
+              batch_size,
+              width,
+              padding_idx);
+    }
+  }
+};
+
+}  // namespace operators
+}  // namespace paddle
+
+namespace ops = paddle::operators;
+
+PD_REGISTER_STRUCT_KERNEL(fused_multi_embedding_seq_pool,
+                          GPU,
+                          ALL_LAYOUT,
+                          ops::FusedMultiEmbeddingSeqPoolCUDAKernel,
+                          float,
+                          double) {}
+PD_REGISTER_STRUCT_KERNEL(fused_multi_embedding_seq_pool_grad,
+                          GPU,
+                          ALL_LAYOUT,
+                          ops::FusedMultiEmbeddingSeqPoolGradCUDAKernel,
+                          float,
+                          double) {}
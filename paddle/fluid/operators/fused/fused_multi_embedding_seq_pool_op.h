@@ -0,0 +1,228 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "paddle/fluid/framework/lod_tensor.h"
+#include "paddle/fluid/framework/op_registry.h"
+#include "paddle/fluid/framework/selected_rows_utils.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
+
+namespace paddle {
+namespace operators {
+
+constexpr int64_t kMultiEmbNoPadding = -1;
+
+// check the LoD of the ids of every slot, and return the batch size
+inline int64_t MultiEmbeddingSeqPoolBatchSize(
+    const std::vector<const phi::DenseTensor *> &ids) {
+  int64_t batch_size = -1;
+  for (size_t slot = 0; slot < ids.size(); ++slot) {
+    const auto &lod = ids[slot]->lod();
+    PADDLE_ENFORCE_EQ(lod.size(),
+                      1UL,
+                      platform::errors::InvalidArgument(
+                          "The LoD level of Input(Ids) of slot %d should be "
+                          "1. But received the LoD level = %d.",
+                          slot,
+                          lod.size()));
+    PADDLE_ENFORCE_EQ(
+        static_cast<size_t>(ids[slot]->numel()),
+        lod[0].back(),
+        platform::errors::InvalidArgument(
+            "The Input(Ids) of slot %d should have one id per LoD row, but "
+            "its numel is %d and the LoD covers %d rows.",
+            slot,
+            ids[slot]->numel(),
+            lod[0].back()));
+    int64_t cur_batch_size = static_cast<int64_t>(lod[0].size()) - 1;
+    if (batch_size == -1) {
+      batch_size = cur_batch_size;
+    } else {
+      PADDLE_ENFORCE_EQ(batch_size,
+                        cur_batch_size,
+                        platform::errors::InvalidArgument(
+                            "The batch size of all the slots should be the "
+                            "same, but the slot 0 has %d and the slot %d "
+                            "has %d.",
+                            batch_size,
+                            slot,
+                            cur_batch_size));
+    }
+  }
+  return batch_size;
+}
+
+template <typename T, typename DeviceContext>
+class FusedMultiEmbeddingSeqPoolKernel : public framework::OpKernel<T> {
+ public:
+  void Compute(const framework::ExecutionContext &context) const override {
+    auto ids = context.MultiInput<phi::DenseTensor>("Ids");
+    auto *table_t = context.Input<phi::DenseTensor>("W");
+    auto *output_t = context.Output<phi::DenseTensor>("Out");
+    int64_t padding_idx = context.Attr<int64_t>("padding_idx");
+
+    const int64_t slot_num = static_cast<int64_t>(ids.size());
+    const int64_t table_height = table_t->dims()[0];
+    const int64_t width = table_t->dims()[1];
+    const int64_t out_width = width * slot_num;
+    const int64_t batch_size = MultiEmbeddingSeqPoolBatchSize(ids);
+    output_t->Resize({batch_size, out_width});
+    T *output = output_t->mutable_data<T>(context.GetPlace());
+    const T *table = table_t->data<T>();
+
+    // one sum pooled row of the table per sequence, its index width is 1
+    phi::jit::emb_seq_pool_attr_t attr(
+        table_height, width, 0, 1, width, phi::jit::SeqPoolType::kSum);
+    auto emb_seqpool = phi::jit::KernelFuncs<phi::jit::EmbSeqPoolTuple<T>,
+                                             platform::CPUPlace>::Cache()
+                           .At(attr);
+    auto vadd = phi::jit::KernelFuncs<phi::jit::VAddTuple<T>,
+                                      platform::CPUPlace>::Cache()
+                    .At(static_cast<int>(width));
+    for (int64_t slot = 0; slot < slot_num; ++slot) {
+      const int64_t *ids_data = ids[slot]->data<int64_t>();
+      const auto &lod = ids[slot]->lod()[0];
+      for (int64_t i = 0; i < batch_size; ++i) {
+        T *dst = output + i * out_width + slot * width;
+        attr.index_height = static_cast<int64_t>(lod[i + 1] - lod[i]);
+        if (attr.index_height > 0 && padding_idx == kMultiEmbNoPadding) {
+          emb_seqpool(table, ids_data + lod[i], dst, &attr);
+          continue;
+        }
+        // the paddings and the empty sequences are pooled to zeros
+        std::memset(dst, 0, width * sizeof(T));
+        for (size_t j = lod[i]; j < lod[i + 1]; ++j) {
+          if (ids_data[j] == padding_idx) continue;
+          PADDLE_ENFORCE_EQ(
+              ids_data[j] >= 0 && ids_data[j] < table_height,
+              true,
+              platform::errors::InvalidArgument(
+                  "The id of slot %d should be in [0, %d), but got %d.",
+                  slot,
+                  table_height,
+                  ids_data[j]));
+          vadd(table + ids_data[j] * width, dst, dst, width);
+        }
+      }
+    }
+  }
+};
+
+template <typename T, typename DeviceContext>
+class FusedMultiEmbeddingSeqPoolGradKernel : public framework::OpKernel<T> {
+ public:
+  void Compute(const framework::ExecutionContext &context) const override {
+    auto ids = context.MultiInput<phi::DenseTensor>("Ids");
+    auto *table_var = context.InputVar("W");
+    auto *d_output =
+        context.Input<phi::DenseTensor>(framework::GradVarName("Out"));
+    int64_t padding_idx = context.Attr<int64_t>("padding_idx");
+    bool is_sparse = context.Attr<bool>("is_sparse");
+
+    framework::DDim table_dim;
+    if (table_var->IsType<phi::DenseTensor>()) {
+      table_dim = context.Input<phi::DenseTensor>("W")->dims();
+    } else if (table_var->IsType<phi::SelectedRows>()) {
+      table_dim = context.Input<phi::SelectedRows>("W")->value().dims();
+    } else {
+      PADDLE_THROW(platform::errors::PermissionDenied(
+          "The parameter W of fused_multi_embedding_seq_pool must be either "
+          "phi::DenseTensor or SelectedRows."));
+    }
+
+    const int64_t slot_num = static_cast<int64_t>(ids.size());
+    const int64_t width = table_dim[1];
+    const int64_t out_width = width * slot_num;
+    const int64_t batch_size = MultiEmbeddingSeqPoolBatchSize(ids);
+    const T *d_output_data = d_output->data<T>();
+
+    // Since paddings are not trainable and fixed in forward, the gradient of
+    // paddings makes no sense and we don't deal with it in backward.
+    if (is_sparse) {
+      // the grads of all the slots are merged into one SelectedRows, with a
+      // row for each id
+      auto *d_table =
+          context.Output<phi::SelectedRows>(framework::GradVarName("W"));
+      d_table->set_height(table_dim[0]);
+      int64_t ids_num = 0;
+      for (auto *ids_t : ids) {
+        ids_num += ids_t->numel();
+      }
+      phi::Vector<int64_t> *new_rows = d_table->mutable_rows();
+      new_rows->resize(ids_num);
+      auto *d_table_value = d_table->mutable_value();
+      d_table_value->Resize({ids_num, width});
+      T *d_table_data = d_table_value->mutable_data<T>(context.GetPlace());
+
+      auto vbroadcast = phi::jit::KernelFuncs<phi::jit::VBroadcastTuple<T>,
+                                              platform::CPUPlace>::Cache()
+                            .At(width);
+      int64_t row_offset = 0;
+      for (int64_t slot = 0; slot < slot_num; ++slot) {
+        const int64_t *ids_data = ids[slot]->data<int64_t>();
+        const auto &lod = ids[slot]->lod()[0];
+        if (ids[slot]->numel() == 0) continue;
+        std::memcpy(&(*new_rows)[row_offset],
+                    ids_data,
+                    ids[slot]->numel() * sizeof(int64_t));
+        T *slot_value = d_table_data + row_offset * width;
+        for (int64_t i = 0; i < batch_size; ++i) {
+          int64_t h = static_cast<int64_t>(lod[i + 1] - lod[i]);
+          if (h == 0) continue;
+          vbroadcast(d_output_data + i * out_width + slot * width,
+                     slot_value + lod[i] * width,
+                     h,
+                     width);
+        }
+        if (padding_idx != kMultiEmbNoPadding) {
+          for (int64_t j = 0; j < ids[slot]->numel(); ++j) {
+            if (ids_data[j] == padding_idx) {
+              std::memset(slot_value + j * width, 0, width * sizeof(T));
+            }
+          }
+        }
+        row_offset += ids[slot]->numel();
+      }
+    } else {
+      auto *d_table =
+          context.Output<phi::DenseTensor>(framework::GradVarName("W"));
+      d_table->Resize(table_dim);
+      T *d_table_data = d_table->mutable_data<T>(context.GetPlace());
+      std::memset(d_table_data, 0, d_table->numel() * sizeof(T));
+
+      auto vadd = phi::jit::KernelFuncs<phi::jit::VAddTuple<T>,
+                                        platform::CPUPlace>::Cache()
+                      .At(static_cast<int>(width));
+      for (int64_t slot = 0; slot < slot_num; ++slot) {
+        const int64_t *ids_data = ids[slot]->data<int64_t>();
+        const auto &lod = ids[slot]->lod()[0];
+        for (int64_t i = 0; i < batch_size; ++i) {
+          const T *src = d_output_data + i * out_width + slot * width;
+          for (size_t j = lod[i]; j < lod[i + 1]; ++j) {
+            if (ids_data[j] == padding_idx) continue;
+            T *dst = d_table_data + ids_data[j] * width;
+            vadd(src, dst, dst, width);
+          }
+        }
+      }
+    }
+  }
+};
+
+}  // namespace operators
+}  // namespace paddle
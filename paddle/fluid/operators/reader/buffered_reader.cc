@@ -14,6 +14,8 @@
 
 #include "paddle/fluid/operators/reader/buffered_reader.h"
 
+#include <algorithm>
+
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/platform/device/device_wrapper.h"
 #include "paddle/fluid/platform/profiler.h"
@@ -21,6 +23,9 @@
 
 #include "paddle/phi/backends/device_guard.h"
 #include "paddle/phi/backends/device_manager.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_int64(reader_prefetch_memory_mb);
 
 namespace paddle {
 namespace operators {
@@ -35,6 +40,12 @@ BufferedReader::~BufferedReader() {
     }
     position_.pop();
   }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // The copies are not synced by the reads, the buffers are freed after.
+  if (stream_ != nullptr) {
+    platform::GpuStreamSync(stream_.get());
+  }
+#endif
 }
 
 BufferedReader::BufferedReader(
@@ -46,6 +57,7 @@ BufferedReader::BufferedReader(
       thread_pool_(1),
       place_(place),
       buffer_size_(buffer_size),
+      depth_(buffer_size),
       pin_memory_(pin_memory) {
   VLOG(1) << "BufferedReader";
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -59,6 +71,10 @@ BufferedReader::BufferedReader(
     for (auto &event : events_) {
       event = platform::CudaEventResourcePool::Instance().New(dev_idx);
     }
+    copy_events_.resize(buffer_size);
+    for (auto &event : copy_events_) {
+      event = platform::CudaEventResourcePool::Instance().New(dev_idx);
+    }
     stream_ = platform::CudaStreamResourcePool::Instance().New(dev_idx);
   }
 #endif
@@ -98,20 +114,58 @@ BufferedReader::BufferedReader(
 
   cpu_buffer_.resize(buffer_size);
   cuda_buffer_.resize(buffer_size);
+  pinned_buffer_.resize(buffer_size);
   xpu_buffer_.resize(buffer_size);
   custom_device_buffer_.resize(buffer_size);
   ReadTillBufferFullAsync();
 }
 
 void BufferedReader::ReadTillBufferFullAsync() {
+  free_positions_ = std::queue<size_t>();
   for (size_t i = 0; i < buffer_size_; ++i) {
-    ReadAsync(i);
+    free_positions_.push(i);
+  }
+  ReadTillDepthAsync();
+}
+
+void BufferedReader::ReadTillDepthAsync() {
+  while (position_.size() < depth_ && !free_positions_.empty()) {
+    ReadAsync(free_positions_.front());
+    free_positions_.pop();
+  }
+}
+
+void BufferedReader::TuneDepth(const TensorVec &batch) {
+  depth_tuned_ = true;
+  if (FLAGS_reader_prefetch_memory_mb <= 0) return;
+  size_t batch_bytes = 0;
+  for (auto &tensor : batch) {
+    batch_bytes += tensor.numel() * phi::SizeOf(tensor.dtype());
   }
+  const size_t memory_bytes =
+      static_cast<size_t>(FLAGS_reader_prefetch_memory_mb) << 20;
+  const size_t min_depth = std::min<size_t>(2, buffer_size_);
+  depth_ = batch_bytes > 0 ? memory_bytes / batch_bytes : buffer_size_;
+  depth_ = std::max(min_depth, std::min(depth_, buffer_size_));
+  VLOG(1) << "BufferedReader prefetches " << depth_ << " batches of "
+          << batch_bytes << " bytes";
 }
 
 void BufferedReader::ReadAsync(size_t i) {
   position_.emplace(thread_pool_.enqueue([this, i]() -> size_t {
     TensorVec &cpu = cpu_buffer_[i];
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    // The inputs and the pinned buffer of the previous batch of the position
+    // may still be copied from, though it is almost always done.
+    if (platform::is_gpu_place(place_) && !pin_memory_) {
+      platform::SetDeviceId(place_.device);
+#ifdef PADDLE_WITH_HIP
+      PADDLE_ENFORCE_GPU_SUCCESS(hipEventSynchronize(copy_events_[i].get()));
+#else
+      PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(copy_events_[i].get()));
+#endif
+    }
+#endif
     reader_->ReadNext(&cpu);
 
     if (cpu.empty()) {
@@ -120,6 +174,8 @@ void BufferedReader::ReadAsync(size_t i) {
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)  // @{ Group GPU Place
     if (platform::is_gpu_place(place_)) {
+      // The loops over the tensors below shadow i.
+      const size_t position = i;
       TensorVec &cuda = cuda_buffer_[i];
       if (cuda.empty()) {
         cuda.resize(cpu.size());
@@ -218,11 +274,15 @@ void BufferedReader::ReadAsync(size_t i) {
             memory::Copy(
                 place_, gpu_ptr, cpu_place, cpu_ptr, size, stream_.get());
           } else {
+            // The pageable inputs are staged in the pinned buffer of the
+            // position, which is reused by the later batches, so that the
+            // copy is async and needs no sync of the stream.
             platform::CUDAPinnedPlace cuda_pinned_place;
-            phi::DenseTensor cuda_pinned_tensor;
-            cuda_pinned_tensor.Resize(cpu[i].dims());
-            auto cuda_pinned_ptr = cuda_pinned_tensor.mutable_data(
-                cuda_pinned_place, cpu[i].type());
+            TensorVec &pinned = pinned_buffer_[position];
+            if (pinned.size() < cpu.size()) pinned.resize(cpu.size());
+            pinned[i].Resize(cpu[i].dims());
+            auto cuda_pinned_ptr =
+                pinned[i].mutable_data(cuda_pinned_place, cpu[i].type());
             memory::Copy(
                 cuda_pinned_place, cuda_pinned_ptr, cpu_place, cpu_ptr, size);
             memory::Copy(place_,
@@ -231,12 +291,18 @@ void BufferedReader::ReadAsync(size_t i) {
                          cuda_pinned_ptr,
                          size,
                          stream_.get());
-
-            platform::GpuStreamSync(stream_.get());
           }
           cuda[i].set_lod(cpu[i].lod());
         }
-        platform::GpuStreamSync(stream_.get());
+        // The compute stream waits for the copies when the batch is read,
+        // instead of syncing the copy stream here.
+#ifdef PADDLE_WITH_HIP
+        PADDLE_ENFORCE_GPU_SUCCESS(
+            hipEventRecord(copy_events_[position].get(), stream_.get()));
+#else
+        PADDLE_ENFORCE_GPU_SUCCESS(
+            cudaEventRecord(copy_events_[position].get(), stream_.get()));
+#endif
       }
     }
 #endif
@@ -381,6 +447,17 @@ void BufferedReader::ReadNextImpl(paddle::framework::LoDTensorArray *out) {
   }
 
   if (platform::is_gpu_place(place_)) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    if (!pin_memory_) {
+#ifdef PADDLE_WITH_HIP
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          hipStreamWaitEvent(compute_stream_, copy_events_[i].get(), 0));
+#else
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaStreamWaitEvent(compute_stream_, copy_events_[i].get(), 0));
+#endif
+    }
+#endif
     *out = std::move(cuda_buffer_[i]);
   } else if (platform::is_xpu_place(place_)) {
     *out = std::move(xpu_buffer_[i]);
@@ -390,13 +467,16 @@ void BufferedReader::ReadNextImpl(paddle::framework::LoDTensorArray *out) {
     *out = std::move(cpu_buffer_[i]);
   }
 
+  if (!depth_tuned_) TuneDepth(*out);
+
   // Do not push current position into ReadAsync. Push the previous position
   // Since all computation in fluid are async, change the data of
   // current position may cause data error.
   if (prev_pos_ != -1Ul) {
-    ReadAsync(prev_pos_);
+    free_positions_.push(prev_pos_);
   }
   prev_pos_ = i;
+  ReadTillDepthAsync();
 }
 
 }  // namespace reader
@@ -55,8 +55,15 @@ class BufferedReader : public framework::DecoratedReader {
  private:
   void ReadTillBufferFullAsync();
 
+  // Reads the free positions until depth_ batches are in flight.
+  void ReadTillDepthAsync();
+
   void ReadAsync(size_t i);
 
+  // Limits the batches in flight to FLAGS_reader_prefetch_memory_mb, by the
+  // size of the first batch.
+  void TuneDepth(const TensorVec& batch);
+
  protected:
   void ShutdownImpl() override;
   void StartImpl() override;
@@ -66,9 +73,12 @@ class BufferedReader : public framework::DecoratedReader {
   ThreadPool thread_pool_;
   platform::Place place_;
   const size_t buffer_size_;
+  size_t depth_;
+  bool depth_tuned_{false};
   bool pin_memory_;
 
   std::queue<std::future<size_t>> position_;
+  std::queue<size_t> free_positions_;
 
   // The buffer for reading data.
   // NOTE: the simplest way to implement buffered reader is do not use any
@@ -77,6 +87,8 @@ class BufferedReader : public framework::DecoratedReader {
   // buffers and prevent alloc every time.
   std::vector<TensorVec> cpu_buffer_;
   std::vector<TensorVec> cuda_buffer_;
+  // The pinned staging of the pageable inputs of each position.
+  std::vector<TensorVec> pinned_buffer_;
   std::vector<TensorVec> xpu_buffer_;
   std::vector<TensorVec> custom_device_buffer_;
   size_t prev_pos_{-1UL};
@@ -84,6 +96,8 @@ class BufferedReader : public framework::DecoratedReader {
   gpuStream_t compute_stream_;
   std::shared_ptr<platform::CudaStreamObject> stream_;
   std::vector<std::shared_ptr<platform::CudaEventObject>> events_;
+  // Recorded after the copies of each position, waited by compute_stream_.
+  std::vector<std::shared_ptr<platform::CudaEventObject>> copy_events_;
 #endif
 
 #ifdef PADDLE_WITH_XPU
@@ -0,0 +1,191 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/operators/reader/gds_shard_reader.h"
+#include "paddle/fluid/operators/reader/reader_op_registry.h"
+
+namespace paddle {
+namespace operators {
+namespace reader {
+
+static std::vector<GDSShardReader::Slot> MakeSlots(
+    const framework::AttributeMap& attrs) {
+  const auto& files = PADDLE_GET_CONST(std::vector<std::string>,
+                                       attrs.at("shard_files"));
+  const auto& file_slots =
+      PADDLE_GET_CONST(std::vector<int>, attrs.at("file_slots"));
+  const auto& dtypes = PADDLE_GET_CONST(std::vector<int>, attrs.at("dtypes"));
+  const auto& shape_concat =
+      PADDLE_GET_CONST(std::vector<int>, attrs.at("shape_concat"));
+  const auto& ranks = PADDLE_GET_CONST(std::vector<int>, attrs.at("ranks"));
+  auto shapes = RestoreShapes(shape_concat, ranks);
+  PADDLE_ENFORCE_EQ(dtypes.size(),
+                    shapes.size(),
+                    platform::errors::InvalidArgument(
+                        "The number of 'dtypes'(%d) doesn't match the number "
+                        "of 'shapes'(%d).",
+                        dtypes.size(),
+                        shapes.size()));
+  PADDLE_ENFORCE_EQ(files.size(),
+                    file_slots.size(),
+                    platform::errors::InvalidArgument(
+                        "The number of 'file_slots'(%d) doesn't match the "
+                        "number of 'shard_files'(%d).",
+                        file_slots.size(),
+                        files.size()));
+
+  std::vector<GDSShardReader::Slot> slots(shapes.size());
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    slots[i].sample_shape = shapes[i];
+    slots[i].dtype = static_cast<framework::proto::VarType::Type>(dtypes[i]);
+  }
+  for (size_t i = 0; i < files.size(); ++i) {
+    PADDLE_ENFORCE_EQ(
+        file_slots[i] >= 0 && file_slots[i] < static_cast<int>(slots.size()),
+        true,
+        platform::errors::OutOfRange(
+            "The slot %d of the shard file %s is out of the range [0, %d).",
+            file_slots[i],
+            files[i],
+            slots.size()));
+    slots[file_slots[i]].files.push_back(files[i]);
+  }
+  return slots;
+}
+
+class CreateGDSShardReaderOp : public framework::OperatorBase {
+ public:
+  using framework::OperatorBase::OperatorBase;
+
+ private:
+  void RunImpl(const framework::Scope& scope,
+               const platform::Place& dev_place) const override {
+    auto* out = scope.FindVar(Output("Out"))
+                    ->template GetMutable<framework::ReaderHolder>();
+    const auto& underlying_reader = scope.FindVar(Input("UnderlyingReader"))
+                                        ->Get<framework::ReaderHolder>();
+
+    if (out->Get() != nullptr) {
+      auto* decorated_reader =
+          dynamic_cast<framework::DecoratedReader*>(out->Get().get());
+      PADDLE_ENFORCE_NOT_NULL(
+          decorated_reader,
+          platform::errors::NotFound("The inited reader should be a "
+                                     "DecoratedReader when running "
+                                     "create_gds_shard_reader op."));
+      if (decorated_reader->UnderlyingReader() == underlying_reader.Get()) {
+        return;
+      }
+    }
+
+    auto place_str = Attr<std::string>("place");
+    platform::Place place;
+    if (place_str == "AUTO") {
+      place = dev_place;
+    } else if (place_str == "PLACE(CPU)") {
+      place = platform::CPUPlace();
+    } else {
+      place_str = place_str.substr(0, place_str.length() - 1);
+      std::istringstream sin(place_str);
+      sin.seekg(std::string("PLACE(GPU:").size(), std::ios::beg);  // NOLINT
+      size_t num = 0;
+      sin >> num;
+      place = platform::CUDAPlace(static_cast<int>(num));
+    }
+
+    VLOG(10) << "Create new gds shard reader on " << place;
+
+    out->Clear();
+    out->Reset(framework::MakeDecoratedReader<GDSShardReader>(
+        underlying_reader, place, MakeSlots(Attrs())));
+  }
+};
+
+class CreateGDSShardReaderOpMaker : public DecoratedReaderMakerBase {
+ protected:
+  void Apply() override {
+    AddComment(R"DOC(
+      CreateGDSShardReader Operator
+
+      A gds shard reader takes a reader of the int64 sample indices as its
+      'underlying reader', and reads the samples of the indices from the
+      shard files of fixed size records straight into the GPU memory by
+      GPUDirect Storage. It falls back to a pinned bounce buffer when cuFile
+      is unavailable.
+    )DOC");
+    std::unordered_set<std::string> enum_range;
+    constexpr size_t kMaxCUDADevs = 128;
+    for (size_t i = 0; i < kMaxCUDADevs; ++i) {
+      enum_range.insert(string::Sprintf("PLACE(GPU:%d)", i));
+    }
+    enum_range.insert("CPUPLACE");
+    enum_range.insert("AUTO");
+    AddAttr<std::string>("place", "The place to read the samples into")
+        .SetDefault("AUTO")
+        .InEnum({enum_range});
+    AddAttr<std::vector<std::string>>("shard_files",
+                                      "The paths of all the shard files.");
+    AddAttr<std::vector<int>>("file_slots",
+                              "The slot of each shard file, the files of a "
+                              "slot are concatenated in order.");
+    AddAttr<std::vector<int>>(
+        "shape_concat", "The concat of the sample shapes of all the slots.");
+    AddAttr<std::vector<int>>("ranks",
+                              "The ranks of the sample shape of each slot.");
+    AddAttr<std::vector<int>>(
+        "dtypes", "The int value of enum dtypes of each slot.");
+  }
+};
+
+class CreateGDSShardReaderInferShape : public framework::InferShapeBase {
+ public:
+  void operator()(framework::InferShapeContext* ctx) const override {
+    PADDLE_ENFORCE_NE(
+        ctx->IsRuntime(),
+        true,
+        platform::errors::PreconditionNotMet(
+            "'CreateGDSShardReaderInferShape' should only be invoked during "
+            "compile time."));
+    PADDLE_ENFORCE_EQ(ctx->HasOutput("Out"),
+                      true,
+                      platform::errors::NotFound(
+                          "The output gds shard reader should not be null."));
+    auto shapes =
+        RestoreShapes(ctx->Attrs().Get<std::vector<int>>("shape_concat"),
+                      ctx->Attrs().Get<std::vector<int>>("ranks"));
+    for (auto& shape : shapes) {
+      std::vector<int64_t> dims = {-1};
+      for (int i = 0; i < shape.size(); ++i) dims.push_back(shape[i]);
+      shape = common::make_ddim(dims);
+    }
+    ctx->SetReaderDims("Out", shapes);
+    framework::VarDesc* reader =
+        PADDLE_GET(framework::VarDesc*, ctx->GetOutputVarPtrs("Out")[0]);
+    reader->SetLoDLevels(std::vector<int32_t>(shapes.size(), 0));
+  }
+};
+
+}  // namespace reader
+}  // namespace operators
+}  // namespace paddle
+
+namespace ops = paddle::operators::reader;
+REGISTER_OPERATOR(
+    create_gds_shard_reader,
+    ops::CreateGDSShardReaderOp,
+    ops::CreateGDSShardReaderOpMaker,
+    ops::CreateGDSShardReaderInferShape,
+    paddle::framework::EmptyGradOpMaker<paddle::framework::OpDesc>,
+    paddle::framework::EmptyGradOpMaker<paddle::imperative::OpBase>,
+    paddle::operators::reader::FileReaderInferVarType);
@@ -0,0 +1,328 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/operators/reader/gds_shard_reader.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "paddle/fluid/framework/convert_utils.h"
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/memory/memcpy.h"
+#include "paddle/fluid/platform/profiler/event_tracing.h"
+#include "paddle/phi/backends/dynload/cufile.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/platform/cuda_device_guard.h"
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#endif
+
+namespace paddle {
+namespace operators {
+namespace reader {
+
+#ifdef PADDLE_WITH_CUFILE
+// The cuFile driver is opened once in a process, and kept open until exit.
+static bool OpenCuFileDriver() {
+  static bool opened = []() {
+    if (!phi::dynload::HasCuFile()) {
+      VLOG(1) << "libcufile.so is not found, read by the bounce buffer.";
+      return false;
+    }
+    CUfileError_t status = phi::dynload::cuFileDriverOpen();
+    if (status.err != CU_FILE_SUCCESS) {
+      LOG(WARNING) << "Failed to open the cuFile driver (" << status.err
+                   << "), read by the bounce buffer.";
+      return false;
+    }
+    return true;
+  }();
+  return opened;
+}
+#endif
+
+static void PReadFully(int fd, char* buf, size_t size, off_t offset) {
+  while (size > 0) {
+    ssize_t n = pread(fd, buf, size, offset);
+    PADDLE_ENFORCE_GT(n,
+                      0,
+                      platform::errors::Unavailable(
+                          "Failed to read %d bytes of the shard file at the "
+                          "offset %d, %s.",
+                          size,
+                          offset,
+                          n < 0 ? std::strerror(errno) : "end of file"));
+    buf += n;
+    size -= n;
+    offset += n;
+  }
+}
+
+GDSShardReader::GDSShardReader(
+    const std::shared_ptr<framework::ReaderBase>& reader,
+    const platform::Place& place,
+    const std::vector<Slot>& slots)
+    : framework::DecoratedReader(reader), place_(place) {
+  PADDLE_ENFORCE_EQ(
+      platform::is_cpu_place(place_) || platform::is_gpu_place(place_),
+      true,
+      platform::errors::Unimplemented(
+          "GDSShardReader only reads into the CPU or the GPU, but got %s.",
+          place_));
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (platform::is_gpu_place(place_)) {
+#ifdef PADDLE_WITH_CUFILE
+    cufile_driver_ = OpenCuFileDriver();
+#endif
+    stream_ = platform::CudaStreamResourcePool::Instance().New(place_.device);
+  }
+#endif
+
+  shapes_.clear();
+  var_types_.clear();
+  need_check_feed_.clear();
+  slots_.resize(slots.size());
+  for (size_t i = 0; i < slots.size(); ++i) {
+    OpenSlot(slots[i], &slots_[i]);
+    std::vector<int64_t> dims = {-1};
+    for (int j = 0; j < slots[i].sample_shape.size(); ++j) {
+      dims.push_back(slots[i].sample_shape[j]);
+    }
+    shapes_.push_back(common::make_ddim(dims));
+    var_types_.push_back(slots[i].dtype);
+    need_check_feed_.push_back(false);
+  }
+  VLOG(1) << "Create GDSShardReader of " << slots_.size() << " slots on "
+          << place_ << (UseGDS() ? " by cuFile" : " by the bounce buffer");
+}
+
+GDSShardReader::~GDSShardReader() {
+  for (auto& slot : slots_) {
+    for (auto& file : slot.files) {
+#ifdef PADDLE_WITH_CUFILE
+      if (file.cufile_handle != nullptr) {
+        phi::dynload::cuFileHandleDeregister(file.cufile_handle);
+      }
+#endif
+      if (file.fd >= 0) close(file.fd);
+    }
+  }
+}
+
+bool GDSShardReader::UseGDS() const {
+  if (!cufile_driver_) return false;
+  for (const auto& slot : slots_) {
+    for (const auto& file : slot.files) {
+      if (file.cufile_handle == nullptr) return false;
+    }
+  }
+  return true;
+}
+
+void GDSShardReader::OpenSlot(const Slot& slot, SlotFiles* files) {
+  files->slot = slot;
+  files->record_bytes = static_cast<size_t>(phi::product(slot.sample_shape)) *
+                        framework::SizeOfType(slot.dtype);
+  PADDLE_ENFORCE_GT(files->record_bytes,
+                    0,
+                    platform::errors::InvalidArgument(
+                        "The sample shape [%s] of GDSShardReader is empty.",
+                        slot.sample_shape));
+  files->offsets.assign(1, 0);
+  for (const auto& path : slot.files) {
+    ShardFile file;
+#ifdef PADDLE_WITH_CUFILE
+    // cuFile only reads the files opened by O_DIRECT by DMA.
+    if (cufile_driver_) {
+      file.fd = open(path.c_str(), O_RDONLY | O_DIRECT);
+      if (file.fd >= 0) {
+        CUfileDescr_t descr;
+        std::memset(&descr, 0, sizeof(descr));
+        descr.handle.fd = file.fd;
+        descr.type = CU_FILE_HANDLE_TYPE_OPAQUE_FD;
+        CUfileHandle_t handle;
+        CUfileError_t status =
+            phi::dynload::cuFileHandleRegister(&handle, &descr);
+        if (status.err == CU_FILE_SUCCESS) {
+          file.cufile_handle = handle;
+        } else {
+          VLOG(1) << "cuFile can not register " << path << " (" << status.err
+                  << "), read it by the bounce buffer.";
+          close(file.fd);
+          file.fd = -1;
+        }
+      }
+    }
+#endif
+    if (file.fd < 0) file.fd = open(path.c_str(), O_RDONLY);
+    PADDLE_ENFORCE_GE(
+        file.fd,
+        0,
+        platform::errors::NotFound(
+            "Cannot open the shard file %s, %s.", path, std::strerror(errno)));
+    struct stat st;
+    PADDLE_ENFORCE_EQ(fstat(file.fd, &st),
+                      0,
+                      platform::errors::Unavailable(
+                          "Cannot stat the shard file %s.", path));
+    PADDLE_ENFORCE_EQ(
+        st.st_size % files->record_bytes,
+        0,
+        platform::errors::InvalidArgument(
+            "The size of the shard file %s (%d bytes) is not a multiple of "
+            "the record size (%d bytes).",
+            path,
+            st.st_size,
+            files->record_bytes));
+    file.num_records = st.st_size / files->record_bytes;
+    files->offsets.push_back(files->offsets.back() + file.num_records);
+    files->files.push_back(file);
+  }
+}
+
+void GDSShardReader::ReadSlot(const SlotFiles& files,
+                              const int64_t* indices,
+                              int64_t batch_size,
+                              phi::DenseTensor* out) {
+  const size_t bytes = files.record_bytes;
+  std::vector<int64_t> dims = {batch_size};
+  for (int i = 0; i < files.slot.sample_shape.size(); ++i) {
+    dims.push_back(files.slot.sample_shape[i]);
+  }
+  out->Resize(common::make_ddim(dims));
+  auto* dst = static_cast<char*>(out->mutable_data(
+      place_, framework::TransToPhiDataType(files.slot.dtype)));
+
+  const bool on_gpu = platform::is_gpu_place(place_);
+  char* bounce = nullptr;
+  if (on_gpu) {
+    if (bounce_buffer_ == nullptr ||
+        bounce_buffer_->size() < bytes * batch_size) {
+      bounce_buffer_ = memory::AllocShared(platform::CUDAPinnedPlace(),
+                                           bytes * batch_size);
+    }
+    bounce = static_cast<char*>(bounce_buffer_->ptr());
+  }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  std::unique_ptr<platform::CUDADeviceGuard> guard;
+  if (on_gpu) guard.reset(new platform::CUDADeviceGuard(place_.device));
+#endif
+
+  // The records read by the bounce buffer, to be copied to the device by
+  // the runs of the consecutive samples.
+  std::vector<bool> bounced(batch_size, false);
+  const int64_t total = files.offsets.back();
+  for (int64_t b = 0; b < batch_size; ++b) {
+    const int64_t index = indices[b];
+    PADDLE_ENFORCE_EQ(
+        index >= 0 && index < total,
+        true,
+        platform::errors::OutOfRange(
+            "The sample index %d is out of the range [0, %d) of the shards.",
+            index,
+            total));
+    size_t f = std::upper_bound(
+                   files.offsets.begin(), files.offsets.end(), index) -
+               files.offsets.begin() - 1;
+    const auto& file = files.files[f];
+    const off_t offset = (index - files.offsets[f]) * bytes;
+#ifdef PADDLE_WITH_CUFILE
+    if (file.cufile_handle != nullptr) {
+      ssize_t n = phi::dynload::cuFileRead(
+          file.cufile_handle, dst, bytes, offset, b * bytes);
+      PADDLE_ENFORCE_EQ(n,
+                        static_cast<ssize_t>(bytes),
+                        platform::errors::Unavailable(
+                            "cuFileRead read %d of the %d bytes of the "
+                            "sample %d.",
+                            n,
+                            bytes,
+                            index));
+      continue;
+    }
+#endif
+    if (on_gpu) {
+      PReadFully(file.fd, bounce + b * bytes, bytes, offset);
+      bounced[b] = true;
+    } else {
+      PReadFully(file.fd, dst + b * bytes, bytes, offset);
+    }
+  }
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (on_gpu) {
+    bool copied = false;
+    for (int64_t b = 0; b < batch_size;) {
+      if (!bounced[b]) {
+        ++b;
+        continue;
+      }
+      int64_t end = b;
+      while (end < batch_size && bounced[end]) ++end;
+      memory::Copy(place_,
+                   dst + b * bytes,
+                   platform::CUDAPinnedPlace(),
+                   bounce + b * bytes,
+                   (end - b) * bytes,
+                   stream_.get());
+      copied = true;
+      b = end;
+    }
+    // The bounce buffer is reused by the next slot.
+    if (copied) platform::GpuStreamSync(stream_.get());
+  }
+#endif
+}
+
+void GDSShardReader::ReadNextImpl(paddle::framework::LoDTensorArray* out) {
+  paddle::framework::LoDTensorArray indices;
+  reader_->ReadNext(&indices);
+  out->clear();
+  if (indices.empty()) return;
+
+  PADDLE_ENFORCE_EQ(indices.size(),
+                    1,
+                    platform::errors::InvalidArgument(
+                        "The underlying reader of GDSShardReader should yield "
+                        "only the sample indices, but got %d tensors.",
+                        indices.size()));
+  const auto& index = indices[0];
+  PADDLE_ENFORCE_EQ(index.dtype(),
+                    phi::DataType::INT64,
+                    platform::errors::InvalidArgument(
+                        "The sample indices of GDSShardReader should be int64, "
+                        "but got %s.",
+                        index.dtype()));
+  PADDLE_ENFORCE_EQ(platform::is_cpu_place(index.place()) ||
+                        platform::is_cuda_pinned_place(index.place()),
+                    true,
+                    platform::errors::InvalidArgument(
+                        "The sample indices of GDSShardReader should be on the "
+                        "host, but got %s.",
+                        index.place()));
+
+  platform::RecordEvent record_event(
+      "GDSShardReader:Read", platform::TracerEventType::UserDefined, 1);
+  out->resize(slots_.size());
+  for (size_t i = 0; i < slots_.size(); ++i) {
+    ReadSlot(slots_[i], index.data<int64_t>(), index.numel(), &(*out)[i]);
+  }
+}
+
+}  // namespace reader
+}  // namespace operators
+}  // namespace paddle
@@ -0,0 +1,98 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/framework/reader.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/platform/device/gpu/gpu_resource_pool.h"
+#endif
+
+namespace paddle {
+namespace operators {
+namespace reader {
+
+// Reads the samples of the shard files straight into the device memory by
+// cuFile (GPUDirect Storage), without staging them in the host memory.
+//
+// The underlying reader yields the int64 indices of the samples of a batch.
+// Each slot of the reader is a list of shard files of fixed size records,
+// the i-th sample of a slot is the i-th record of its files concatenated,
+// and it is yielded as a tensor of [batch_size] + sample_shape.
+//
+// When cuFile is unavailable, or can not register a file, the records are
+// read into a pinned bounce buffer and copied to the device instead.
+class GDSShardReader : public framework::DecoratedReader {
+ public:
+  struct Slot {
+    std::vector<std::string> files;
+    framework::DDim sample_shape;
+    framework::proto::VarType::Type dtype;
+  };
+
+  GDSShardReader(const std::shared_ptr<framework::ReaderBase>& reader,
+                 const platform::Place& place,
+                 const std::vector<Slot>& slots);
+
+  ~GDSShardReader() override;
+
+  platform::Place GetPlace() const { return place_; }
+
+  // Whether all the files are read by cuFile.
+  bool UseGDS() const;
+
+ protected:
+  void ReadNextImpl(paddle::framework::LoDTensorArray* out) override;
+
+ private:
+  struct ShardFile {
+    int fd{-1};
+    int64_t num_records{0};
+    // The CUfileHandle_t of the file, null if it is read by the bounce buffer.
+    void* cufile_handle{nullptr};
+  };
+
+  struct SlotFiles {
+    Slot slot;
+    size_t record_bytes{0};
+    std::vector<ShardFile> files;
+    // The index of the first record of each file, and the total at the end.
+    std::vector<int64_t> offsets;
+  };
+
+  void OpenSlot(const Slot& slot, SlotFiles* files);
+
+  void ReadSlot(const SlotFiles& files,
+                const int64_t* indices,
+                int64_t batch_size,
+                phi::DenseTensor* out);
+
+  platform::Place place_;
+  std::vector<SlotFiles> slots_;
+  bool cufile_driver_{false};
+
+  // The pinned bounce buffer, grown to the largest batch of a slot.
+  std::shared_ptr<phi::Allocation> bounce_buffer_;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  std::shared_ptr<platform::CudaStreamObject> stream_;
+#endif
+};
+
+}  // namespace reader
+}  // namespace operators
+}  // namespace paddle
@@ -14,6 +14,7 @@ limitations under the License. */
 
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/funcs/sequence_softmax.cu.h"
 #include "paddle/phi/kernels/funcs/softmax.h"
 
 namespace paddle {
@@ -49,6 +50,16 @@ class SequenceSoftmaxCUDNNKernel : public framework::OpKernel<T> {
                           "SequenceSoftmaxOp should be 1."));
 
     out->mutable_data<T>(ctx.GetPlace());
+    // A ragged batch is a launch of the segmented softmax instead of a cuDNN
+    // softmax for every sequence.
+    if (lod[level].size() > 2) {
+      phi::funcs::SegmentedSoftmax<T>(
+          ctx.template device_context<phi::GPUContext>(),
+          x->data<T>(),
+          lod[level],
+          out->data<T>());
+      return;
+    }
     for (int i = 0; i < static_cast<int>(lod[level].size()) - 1; ++i) {
       int start_pos = static_cast<int>(lod[level][i]);
       int end_pos = static_cast<int>(lod[level][i + 1]);
@@ -82,6 +93,15 @@ class SequenceSoftmaxGradCUDNNKernel : public framework::OpKernel<T> {
     const size_t level = lod.size() - 1;
 
     x_grad->mutable_data<T>(ctx.GetPlace());  // NOLINT
+    if (lod[level].size() > 2) {
+      phi::funcs::SegmentedSoftmaxGrad<T>(
+          ctx.template device_context<phi::GPUContext>(),
+          out_grad->data<T>(),
+          out->data<T>(),
+          lod[level],
+          x_grad->data<T>());
+      return;
+    }
     for (int i = 0; i < static_cast<int>(lod[level].size()) - 1; ++i) {
       int start_pos = static_cast<int>(lod[level][i]);
       int end_pos = static_cast<int>(lod[level][i + 1]);
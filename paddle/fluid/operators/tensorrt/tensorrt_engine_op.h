@@ -514,6 +514,16 @@ class TensorRTEngineOp : public framework::OperatorBase {
     if (engine->with_dynamic_shape()) {
       // Initilize context and get offset by profile index
       trt_context = engine->context();
+      if (engine->shape_profile_num() > 1) {
+        std::map<std::string, std::vector<int64_t>> input_shapes;
+        for (auto &x : runtime_input_names_) {
+          auto &t =
+              inference::analysis::GetFromScope<phi::DenseTensor>(scope, x);
+          input_shapes[x.substr(0, x.find("_cast_auto_mixed.tmp_"))] =
+              common::vectorize<int64_t>(t.dims());
+        }
+        engine->SelectShapeProfile(input_shapes, stream);
+      }
       binding_offset = engine->GetBindingsOffset();
     }
     // Bind input tensor to TRT.
@@ -913,6 +923,12 @@ class TensorRTEngineOp : public framework::OperatorBase {
       if (HasAttr("optimization_level")) {
         params.optimization_level = Attr<int>("optimization_level");
       }
+      if (HasAttr("shape_profile_num")) {
+        params.shape_profile_num = Attr<int>("shape_profile_num");
+      }
+      if (HasAttr("timing_cache_path")) {
+        params.timing_cache_path = Attr<std::string>("timing_cache_path");
+      }
       if (!shape_range_info_path_.empty()) {
         inference::DeserializeShapeRangeInfo(shape_range_info_path_,
                                              &params.min_input_shape,
@@ -0,0 +1,188 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/transforms/fusion/fused_w8a8_linear_pass.h"
+
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/drr/include/drr_pattern_base.h"
+#include "paddle/fluid/pir/transforms/transform_general_functions.h"
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#include "paddle/fluid/platform/place.h"
+
+#include "paddle/pir/pass/pass.h"
+#include "paddle/pir/pass/pass_registry.h"
+
+namespace {
+
+int getSMVersion() {
+  int sm_version = -1;
+#if defined(PADDLE_WITH_CUDA)
+  sm_version = paddle::platform::GetGPUComputeCapability(
+      paddle::platform::GetCurrentDeviceId());
+#else
+  PADDLE_THROW(paddle::platform::errors::Unavailable(
+      "fused_w8a8_linear_pass needs paddle compiled with CUDA."));
+#endif
+  return sm_version;
+}
+
+// The matmul of the x and the parameter w of [k, n] plus the bias.
+void BuildLinearSourcePattern(paddle::drr::SourcePattern *src) {
+  const auto &matmul =
+      src->Op(paddle::dialect::MatmulOp::name(),
+              {{"transpose_x", src->Attr("matmul_transpose_x")},
+               {"transpose_y", src->Attr("matmul_transpose_y")}});
+  const auto &parameter = src->Op(
+      pir::ParameterOp::name(), {{"parameter_name", src->Attr("param_name")}});
+  src->Tensor("w") = parameter();
+  src->Tensor("matmul_out") = matmul(src->Tensor("x"), src->Tensor("w"));
+  const auto &add = src->Op(paddle::dialect::AddOp::name());
+  src->Tensor("add_out") = add(src->Tensor("matmul_out"), src->Tensor("bias"));
+
+  src->RequireNativeCall(
+      [](const paddle::drr::MatchContext &match_ctx) -> bool {
+        bool matmul_trans_x = match_ctx.Attr<bool>("matmul_transpose_x");
+        bool matmul_trans_y = match_ctx.Attr<bool>("matmul_transpose_y");
+        if (matmul_trans_x || matmul_trans_y) return false;
+
+        auto w_dims = pir::GetShapeFromValue(match_ctx.Tensor("w"));
+        auto x_dims = pir::GetShapeFromValue(match_ctx.Tensor("x"));
+        auto bias_dims = pir::GetShapeFromValue(match_ctx.Tensor("bias"));
+        if (!(w_dims.size() == 2 && x_dims.size() >= 2 &&
+              bias_dims.size() == 1)) {
+          return false;
+        }
+
+        if (w_dims.at(0) % 16 != 0 || w_dims.at(1) % 16 != 0) return false;
+
+        auto w_dtype = pir::GetDataTypeFromValue(match_ctx.Tensor("w"));
+        if (!w_dtype.isa<pir::Float16Type>() &&
+            !w_dtype.isa<pir::BFloat16Type>())
+          return false;
+
+        if (x_dims.at(x_dims.size() - 1) != w_dims.at(0)) return false;
+
+        return true;
+      });
+}
+
+// The parameter quantized per channel, and the w8a8_linear of the act.
+void BuildW8A8LinearResultPattern(paddle::drr::ResultPattern *res,
+                                  const std::string &act_method,
+                                  const std::string &out_name) {
+  const auto &weight_quantize =
+      res->Op(paddle::dialect::WeightQuantizeOp::name(),
+              {{"algo", res->StrAttr("llm.int8")},
+               {"arch", res->Int32Attr(getSMVersion())},
+               {"group_size", res->Int32Attr(-1)}});
+  weight_quantize({&res->Tensor("w")},
+                  {&res->Tensor("quanted_weight_tensor"),
+                   &res->Tensor("weight_scale_tensor")});
+
+  const auto &w8a8_linear =
+      res->Op(paddle::dialect::W8a8LinearOp::name(),
+              {{"act_method", res->StrAttr(act_method)}});
+  w8a8_linear({&res->Tensor("x"),
+               &res->Tensor("quanted_weight_tensor"),
+               &res->Tensor("bias"),
+               &res->Tensor("weight_scale_tensor"),
+               &res->NoneTensor()},
+              {&res->Tensor(out_name)});
+}
+
+class FusedW8A8LinearPattern : public paddle::drr::DrrPatternBase {
+ public:
+  void operator()(paddle::drr::DrrPatternContext *ctx) const override {
+    paddle::drr::SourcePattern src = ctx->SourcePattern();
+    BuildLinearSourcePattern(&src);
+    paddle::drr::ResultPattern res = src.ResultPattern();
+    BuildW8A8LinearResultPattern(&res, "", "add_out");
+  }
+
+  std::string name() const override { return "FusedW8A8LinearPattern"; }
+};
+
+class FusedW8A8LinearGeluPattern : public paddle::drr::DrrPatternBase {
+ public:
+  void operator()(paddle::drr::DrrPatternContext *ctx) const override {
+    paddle::drr::SourcePattern src = ctx->SourcePattern();
+    BuildLinearSourcePattern(&src);
+    const auto &gelu = src.Op(paddle::dialect::GeluOp::name(),
+                              {{"approximate", src.Attr("approximate")}});
+    src.Tensor("out") = gelu(src.Tensor("add_out"));
+    src.RequireNativeCall([](const paddle::drr::MatchContext &match_ctx) {
+      return !match_ctx.Attr<bool>("approximate");
+    });
+    paddle::drr::ResultPattern res = src.ResultPattern();
+    BuildW8A8LinearResultPattern(&res, "gelu", "out");
+  }
+
+  std::string name() const override { return "FusedW8A8LinearGeluPattern"; }
+
+  // Matched before the linear without the activation.
+  uint32_t benefit() const override { return 2; }
+};
+
+class FusedW8A8LinearReluPattern : public paddle::drr::DrrPatternBase {
+ public:
+  void operator()(paddle::drr::DrrPatternContext *ctx) const override {
+    paddle::drr::SourcePattern src = ctx->SourcePattern();
+    BuildLinearSourcePattern(&src);
+    const auto &relu = src.Op(paddle::dialect::ReluOp::name());
+    src.Tensor("out") = relu(src.Tensor("add_out"));
+    paddle::drr::ResultPattern res = src.ResultPattern();
+    BuildW8A8LinearResultPattern(&res, "relu", "out");
+  }
+
+  std::string name() const override { return "FusedW8A8LinearReluPattern"; }
+
+  // Matched before the linear without the activation.
+  uint32_t benefit() const override { return 2; }
+};
+
+class FusedW8A8LinearPass : public pir::PatternRewritePass {
+ public:
+  FusedW8A8LinearPass()
+      : pir::PatternRewritePass("fused_w8a8_linear_pass", 4) {}
+
+  pir::RewritePatternSet InitializePatterns(pir::IrContext *context) override {
+    pir::RewritePatternSet ps(context);
+    ps.Add(FusedW8A8LinearGeluPattern().Build(context));
+    ps.Add(FusedW8A8LinearReluPattern().Build(context));
+    ps.Add(FusedW8A8LinearPattern().Build(context));
+    return ps;
+  }
+
+  bool CanApplyOn(pir::Operation *op) const override {
+    // The int8 GEMM of cublasLt and the llm.int8 weight_quantize.
+    int sm_vesion = getSMVersion();
+    if (sm_vesion != 75 && sm_vesion != 80 && sm_vesion != 86) {
+      return false;
+    }
+    return op->num_regions() > 0;
+  }
+
+ private:
+  pir::FrozenRewritePatternSet patterns_;
+};
+
+}  // namespace
+
+namespace pir {
+std::unique_ptr<Pass> CreateFusedW8A8LinearPass() {
+  return std::make_unique<FusedW8A8LinearPass>();
+}
+}  // namespace pir
+
+REGISTER_IR_PASS(fused_w8a8_linear_pass, FusedW8A8LinearPass);
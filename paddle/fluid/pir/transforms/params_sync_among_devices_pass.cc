@@ -13,17 +13,26 @@
 // limitations under the License.
 
 #include "paddle/fluid/pir/transforms/params_sync_among_devices_pass.h"
+
+#include <cstring>
+#include <vector>
+
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/framework/tensor_util.h"
 #include "paddle/fluid/pir/dialect/kernel/ir/kernel_attribute.h"
 #include "paddle/fluid/pir/dialect/kernel/ir/kernel_dialect.h"
 #include "paddle/fluid/pir/transforms/transform_general_functions.h"
+#include "paddle/fluid/platform/device_context.h"
 #include "paddle/fluid/platform/place.h"
 
 #include "paddle/common/errors.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/enforce.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/kernels/funcs/batched_memcpy.h"
+#endif
 
 #include "paddle/pir/core/builtin_attribute.h"
 #include "paddle/pir/core/builtin_op.h"
@@ -67,7 +76,7 @@ class ParamsSyncAmongDevicesPass : public pir::Pass {
         phi::errors::PreconditionNotMet(
             "params_sync_among_devices_pass should run on module op."));
     auto& block = module_op.block();
-    int64_t num_rewrites_{0};
+    std::vector<phi::DenseTensor*> params;
     for (auto& inner_op : block) {
       if (inner_op.isa<pir::ParameterOp>()) {
         std::string param_name = inner_op.attributes()
@@ -80,15 +89,7 @@ class ParamsSyncAmongDevicesPass : public pir::Pass {
             phi::errors::InvalidArgument("Parameter var [%s] not in scope.",
                                          param_name));
         if (param_var->IsType<phi::DenseTensor>()) {
-          auto* param_tensor = param_var->GetMutable<phi::DenseTensor>();
-          paddle::platform::CPUPlace cpu_place;
-          phi::DenseTensor temp_tensor;
-          temp_tensor.Resize(param_tensor->dims());
-          paddle::framework::TensorCopySync(
-              *param_tensor, cpu_place, &temp_tensor);
-          param_tensor->clear();
-          paddle::framework::TensorCopySync(temp_tensor, place_, param_tensor);
-          num_rewrites_++;
+          params.push_back(param_var->GetMutable<phi::DenseTensor>());
         } else {
           PADDLE_THROW(phi::errors::Unimplemented(
               "params_sync_among_devices_pass only support DenseTensor type of "
@@ -96,7 +97,17 @@ class ParamsSyncAmongDevicesPass : public pir::Pass {
         }
       }
     }
-    AddStatistics(num_rewrites_);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    if (paddle::platform::is_gpu_place(place_)) {
+      SyncParamsToGPU(params);
+      AddStatistics(static_cast<int64_t>(params.size()));
+      return;
+    }
+#endif
+    for (auto* param_tensor : params) {
+      SyncParam(param_tensor);
+    }
+    AddStatistics(static_cast<int64_t>(params.size()));
   }
 
   bool CanApplyOn(pir::Operation* op) const override {
@@ -104,6 +115,94 @@ class ParamsSyncAmongDevicesPass : public pir::Pass {
   }
 
  private:
+  void SyncParam(phi::DenseTensor* param_tensor) {
+    paddle::platform::CPUPlace cpu_place;
+    phi::DenseTensor temp_tensor;
+    temp_tensor.Resize(param_tensor->dims());
+    paddle::framework::TensorCopySync(*param_tensor, cpu_place, &temp_tensor);
+    param_tensor->clear();
+    paddle::framework::TensorCopySync(temp_tensor, place_, param_tensor);
+  }
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // Copies the params to the GPU of place_ with one synchronization. The
+  // small params on the host are packed into one pinned buffer copied to the
+  // GPU at once, and then scattered to their tensors by one batched copy with
+  // the params on the other GPUs.
+  void SyncParamsToGPU(const std::vector<phi::DenseTensor*>& params) {
+    auto* dev_ctx = static_cast<phi::GPUContext*>(
+        paddle::platform::DeviceContextPool::Instance().Get(place_));
+    const phi::GPUPlace place(place_.GetDeviceId());
+    constexpr size_t kStagingAlignment = 256;
+    std::vector<phi::DenseTensor> dst_tensors(params.size());
+    std::vector<size_t> param_ids, staged_copies, staging_offsets;
+    std::vector<void*> dsts;
+    std::vector<const void*> srcs;
+    std::vector<size_t> sizes;
+    size_t staging_bytes = 0;
+    for (size_t i = 0; i < params.size(); ++i) {
+      auto* param_tensor = params[i];
+      if (param_tensor->place() == place_) {
+        continue;
+      }
+      if (param_tensor->numel() == 0) {
+        SyncParam(param_tensor);
+        continue;
+      }
+      auto& dst_tensor = dst_tensors[i];
+      dst_tensor.set_meta(param_tensor->meta());
+      dev_ctx->Alloc(&dst_tensor, param_tensor->dtype());
+      const size_t bytes =
+          param_tensor->numel() * phi::SizeOf(param_tensor->dtype());
+      if (paddle::platform::is_cpu_place(param_tensor->place()) &&
+          bytes <= phi::funcs::kBatchedMemcpyMaxKernelBytes) {
+        staged_copies.push_back(dsts.size());
+        staging_offsets.push_back(staging_bytes);
+        staging_bytes += (bytes + kStagingAlignment - 1) / kStagingAlignment *
+                         kStagingAlignment;
+      }
+      param_ids.push_back(i);
+      dsts.push_back(dst_tensor.data());
+      srcs.push_back(param_tensor->data());
+      sizes.push_back(bytes);
+    }
+
+    // The staging buffers are in use until the wait of dev_ctx.
+    phi::Allocator::AllocationPtr host_staging, device_staging;
+    if (staging_bytes > 0) {
+      host_staging =
+          phi::memory_utils::Alloc(phi::GPUPinnedPlace(), staging_bytes);
+      device_staging = phi::memory_utils::Alloc(
+          place,
+          staging_bytes,
+          phi::Stream(reinterpret_cast<phi::StreamId>(dev_ctx->stream())));
+      auto* host_ptr = static_cast<char*>(host_staging->ptr());
+      auto* device_ptr = static_cast<char*>(device_staging->ptr());
+      for (size_t j = 0; j < staged_copies.size(); ++j) {
+        const size_t copy = staged_copies[j];
+        std::memcpy(host_ptr + staging_offsets[j], srcs[copy], sizes[copy]);
+        srcs[copy] = device_ptr + staging_offsets[j];
+      }
+      phi::memory_utils::Copy(place,
+                              device_ptr,
+                              phi::GPUPinnedPlace(),
+                              host_ptr,
+                              staging_bytes,
+                              dev_ctx->stream());
+    }
+    phi::funcs::BatchedMemcpyAsync(
+        place, dev_ctx->stream(), dsts, srcs, sizes);
+    dev_ctx->Wait();
+    VLOG(6) << "Synced " << param_ids.size() << " params to " << place_
+            << ", " << staged_copies.size()
+            << " of them by a staging buffer of " << staging_bytes
+            << " bytes.";
+    for (size_t i : param_ids) {
+      *params[i] = dst_tensors[i];
+    }
+  }
+#endif
+
   phi::Place place_;
   paddle::framework::Scope* scope_{nullptr};
 };
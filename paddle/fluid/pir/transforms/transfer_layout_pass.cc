@@ -0,0 +1,400 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/transforms/transfer_layout_pass.h"
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+
+#include "paddle/common/ddim.h"
+#include "paddle/phi/common/data_type.h"
+
+#include "paddle/pir/core/builder.h"
+#include "paddle/pir/core/builtin_attribute.h"
+#include "paddle/pir/core/ir_context.h"
+#include "paddle/pir/core/operation.h"
+#include "paddle/pir/core/program.h"
+#include "paddle/pir/core/value.h"
+#include "paddle/pir/pass/pass.h"
+#include "paddle/pir/pass/pass_registry.h"
+
+namespace {
+
+// The ops which have a NHWC kernel, with the names of their layout attribute
+// and the indices of their operands in the layout, their result 0 is in the
+// layout too.
+struct LayoutSensitiveOpInfo {
+  std::string layout_attr;
+  std::vector<size_t> layout_operands;
+  // the convolutions which run faster in NHWC on the tensor cores
+  bool prefer_nhwc;
+};
+
+const std::unordered_map<std::string, LayoutSensitiveOpInfo>&
+LayoutSensitiveOps() {
+  static const std::unordered_map<std::string, LayoutSensitiveOpInfo> ops = {
+      {paddle::dialect::Conv2dOp::name(), {"data_format", {0}, true}},
+      {paddle::dialect::DepthwiseConv2dOp::name(), {"data_format", {0}, true}},
+      {paddle::dialect::FusedConv2dAddActOp::name(),
+       {"data_format", {0, 3}, true}},
+      {paddle::dialect::Pool2dOp::name(), {"data_format", {0}, false}},
+      {paddle::dialect::BatchNormOp::name(), {"data_format", {0}, false}},
+      {paddle::dialect::BatchNorm_Op::name(), {"data_format", {0}, false}},
+      {paddle::dialect::GroupNormOp::name(), {"data_format", {0}, false}},
+  };
+  return ops;
+}
+
+// The elementwise ops whose kernels are agnostic to the layout: they compute
+// the same in any layout as long as all the 4-D operands and results are in
+// the same one, since the broadcast of 4-D tensors commutes with transposes.
+const std::unordered_set<std::string>& LayoutAgnosticOps() {
+  static const std::unordered_set<std::string> ops = {
+      paddle::dialect::ReluOp::name(),     paddle::dialect::Relu6Op::name(),
+      paddle::dialect::LeakyReluOp::name(), paddle::dialect::EluOp::name(),
+      paddle::dialect::SigmoidOp::name(),  paddle::dialect::SiluOp::name(),
+      paddle::dialect::SwishOp::name(),    paddle::dialect::HardswishOp::name(),
+      paddle::dialect::GeluOp::name(),     paddle::dialect::TanhOp::name(),
+      paddle::dialect::CastOp::name(),     paddle::dialect::ScaleOp::name(),
+      paddle::dialect::AddOp::name(),      paddle::dialect::SubtractOp::name(),
+      paddle::dialect::MultiplyOp::name(), paddle::dialect::DivideOp::name(),
+      paddle::dialect::MaximumOp::name(),  paddle::dialect::MinimumOp::name(),
+  };
+  return ops;
+}
+
+paddle::dialect::DenseTensorType GetDenseType(pir::Value value) {
+  if (!value || !value.type()) return paddle::dialect::DenseTensorType();
+  return value.type().dyn_cast<paddle::dialect::DenseTensorType>();
+}
+
+bool Is4DTensor(pir::Value value) {
+  auto type = GetDenseType(value);
+  return type && type.dims().size() == 4;
+}
+
+// The number of elements, where the unknown dims count as 1 for all the
+// tensors alike, e.g. the batch size.
+int64_t NumelOf(pir::Value value) {
+  auto dims = common::vectorize(GetDenseType(value).dims());
+  return std::accumulate(
+      dims.begin(), dims.end(), int64_t(1), [](int64_t a, int64_t b) {
+        return b > 0 ? a * b : a;
+      });
+}
+
+// Whether the value broadcasts the same in any layout, e.g. a scalar.
+bool IsScalarLike(pir::Value value) {
+  auto type = GetDenseType(value);
+  if (!type) return false;
+  for (auto d : common::vectorize(type.dims())) {
+    if (d != 1) return false;
+  }
+  return true;
+}
+
+// Assign NHWC to the connected chains of convolutions, pooling, norms and
+// elementwise ops when the cost model says the transposes at the boundaries
+// of a chain are cheaper than the ones saved within, and insert transposes
+// only at these boundaries.
+//
+// The cost is counted in the elements moved: a convolution in NCHW on the
+// tensor cores transposes its input and output internally, which is saved in
+// NHWC, while every value crossing the boundary of a chain costs a transpose.
+class TransferLayoutPass : public pir::Pass {
+ public:
+  TransferLayoutPass() : pir::Pass("transfer_layout_pass", 2) {}
+
+  void Run(pir::Operation* op) override {
+    context_ = pir::IrContext::Instance();
+    int64_t num_transposed = 0;
+    for (size_t i = 0; i < op->num_regions(); ++i) {
+      for (auto& block : op->region(i)) {
+        num_transposed += ProcessBlock(&block);
+      }
+    }
+    AddStatistics(num_transposed);
+  }
+
+  bool CanApplyOn(pir::Operation* op) const override {
+    return op->num_regions() > 0;
+  }
+
+ private:
+  // The operands of op which follow its layout.
+  std::vector<size_t> LayoutOperands(pir::Operation* op) const {
+    std::vector<size_t> operands;
+    auto it = LayoutSensitiveOps().find(op->name());
+    if (it != LayoutSensitiveOps().end()) {
+      // the optional operands may be null
+      for (auto i : it->second.layout_operands) {
+        if (Is4DTensor(op->operand_source(i))) operands.push_back(i);
+      }
+      return operands;
+    }
+    for (size_t i = 0; i < op->num_operands(); ++i) {
+      if (Is4DTensor(op->operand_source(i))) operands.push_back(i);
+    }
+    return operands;
+  }
+
+  std::vector<size_t> LayoutResults(pir::Operation* op) const {
+    if (LayoutSensitiveOps().count(op->name())) return {0};
+    std::vector<size_t> results;
+    for (size_t i = 0; i < op->num_results(); ++i) {
+      if (Is4DTensor(op->result(i))) results.push_back(i);
+    }
+    return results;
+  }
+
+  bool CanBeNHWC(pir::Operation* op) const {
+    auto it = LayoutSensitiveOps().find(op->name());
+    if (it != LayoutSensitiveOps().end()) {
+      auto layout = op->attribute<pir::StrAttribute>(it->second.layout_attr);
+      if (!layout || layout.AsString() != "NCHW" ||
+          !Is4DTensor(op->operand_source(0)) || !Is4DTensor(op->result(0))) {
+        return false;
+      }
+      // the other results in the layout, e.g. the split outputs of the fused
+      // conv, are not transferred
+      for (size_t i = 1; i < op->num_results(); ++i) {
+        auto result = op->result(i);
+        if (!result.use_empty() &&
+            (Is4DTensor(result) || !GetDenseType(result))) {
+          return false;
+        }
+      }
+      return true;
+    }
+    if (!LayoutAgnosticOps().count(op->name())) return false;
+    bool has_4d_operand = false;
+    for (size_t i = 0; i < op->num_operands(); ++i) {
+      auto operand = op->operand_source(i);
+      if (!operand) continue;
+      if (Is4DTensor(operand)) {
+        has_4d_operand = true;
+      } else if (!IsScalarLike(operand)) {
+        // the lower rank operands broadcast to the trailing dims
+        return false;
+      }
+    }
+    for (size_t i = 0; i < op->num_results(); ++i) {
+      if (!Is4DTensor(op->result(i))) return false;
+    }
+    return has_4d_operand;
+  }
+
+  bool PreferNHWC(pir::Operation* op) const {
+    auto it = LayoutSensitiveOps().find(op->name());
+    if (it == LayoutSensitiveOps().end() || !it->second.prefer_nhwc) {
+      return false;
+    }
+    auto dtype = GetDenseType(op->operand_source(0)).dtype();
+    return dtype.isa<pir::Float16Type>() || dtype.isa<pir::BFloat16Type>();
+  }
+
+  pir::Operation* Find(pir::Operation* op) {
+    while (parent_[op] != op) {
+      parent_[op] = parent_[parent_[op]];
+      op = parent_[op];
+    }
+    return op;
+  }
+
+  void Union(pir::Operation* a, pir::Operation* b) {
+    parent_[Find(a)] = Find(b);
+  }
+
+  bool IsLayoutOperand(pir::Operation* op, size_t index) const {
+    auto operands = LayoutOperands(op);
+    return std::find(operands.begin(), operands.end(), index) !=
+           operands.end();
+  }
+
+  // Whether the use is inside the chains of the candidates.
+  bool IsInnerUse(const pir::OpOperand& use,
+                  const std::unordered_set<pir::Operation*>& ops) const {
+    return ops.count(use.owner()) && IsLayoutOperand(use.owner(), use.index());
+  }
+
+  // Whether the value is a result in the layout of a candidate in ops.
+  template <typename Set>
+  bool IsLayoutResultOf(pir::Value value, const Set& ops) const {
+    auto* producer = value.defining_op();
+    if (producer == nullptr || !ops.count(producer)) return false;
+    auto results = LayoutResults(producer);
+    return std::find(results.begin(),
+                     results.end(),
+                     value.dyn_cast<pir::OpResult>().index()) != results.end();
+  }
+
+  int64_t ProcessBlock(pir::Block* block) {
+    parent_.clear();
+    std::vector<pir::Operation*> candidates;
+    for (auto& op : *block) {
+      if (CanBeNHWC(&op)) {
+        parent_[&op] = &op;
+        candidates.push_back(&op);
+      }
+    }
+    // connect the candidates through the values in the layout
+    for (auto* op : candidates) {
+      for (auto index : LayoutOperands(op)) {
+        auto value = op->operand_source(index);
+        if (IsLayoutResultOf(value, parent_)) {
+          Union(op, value.defining_op());
+        }
+      }
+    }
+
+    std::unordered_map<pir::Operation*, int64_t> benefit;
+    std::unordered_map<pir::Operation*, int64_t> cost;
+    std::unordered_map<pir::Operation*, std::unordered_set<pir::Operation*>>
+        chains;
+    for (auto* op : candidates) {
+      chains[Find(op)].insert(op);
+    }
+    for (auto& [root, ops] : chains) {
+      std::unordered_set<pir::Value> boundary_values;
+      for (auto* op : ops) {
+        if (PreferNHWC(op)) {
+          benefit[root] += NumelOf(op->operand_source(0)) +
+                           NumelOf(op->result(0));
+        }
+        for (auto index : LayoutOperands(op)) {
+          auto value = op->operand_source(index);
+          if (!IsLayoutResultOf(value, ops)) {
+            boundary_values.insert(value);
+          }
+        }
+        for (auto index : LayoutResults(op)) {
+          auto value = op->result(index);
+          for (auto it = value.use_begin(); it != value.use_end(); ++it) {
+            if (!IsInnerUse(*it, ops)) {
+              boundary_values.insert(value);
+              break;
+            }
+          }
+        }
+      }
+      for (auto value : boundary_values) {
+        cost[root] += NumelOf(value);
+      }
+    }
+
+    int64_t num_transposed = 0;
+    for (auto& [root, ops] : chains) {
+      VLOG(4) << "The layout chain of " << ops.size() << " ops, benefit "
+              << benefit[root] << ", cost " << cost[root];
+      if (benefit[root] > cost[root]) {
+        TransferToNHWC(block, ops);
+        num_transposed += static_cast<int64_t>(ops.size());
+      }
+    }
+    return num_transposed;
+  }
+
+  pir::Type PermuteType(pir::Type type,
+                        const std::vector<int>& perm,
+                        common::DataLayout layout) const {
+    auto dense_type = type.dyn_cast<paddle::dialect::DenseTensorType>();
+    auto dims = common::vectorize(dense_type.dims());
+    std::vector<int64_t> new_dims(dims.size());
+    for (size_t i = 0; i < perm.size(); ++i) {
+      new_dims[i] = dims[perm[i]];
+    }
+    return paddle::dialect::DenseTensorType::get(context_,
+                                                 dense_type.dtype(),
+                                                 common::make_ddim(new_dims),
+                                                 layout,
+                                                 dense_type.lod(),
+                                                 dense_type.offset());
+  }
+
+  void TransferToNHWC(pir::Block* block,
+                      const std::unordered_set<pir::Operation*>& ops) {
+    static const std::vector<int> kToNHWC = {0, 2, 3, 1};
+    static const std::vector<int> kToNCHW = {0, 3, 1, 2};
+    pir::Builder builder(context_, block);
+    std::unordered_map<pir::Value, pir::Value> transposed;
+    for (auto& op_item : *block) {
+      auto* op = &op_item;
+      if (!ops.count(op)) continue;
+      // transpose the inputs from outside of the chain
+      for (auto index : LayoutOperands(op)) {
+        auto value = op->operand_source(index);
+        if (IsLayoutResultOf(value, ops)) continue;
+        if (!transposed.count(value)) {
+          builder.set_insertion_point(op);
+          auto transpose =
+              builder.Build<paddle::dialect::TransposeOp>(value, kToNHWC);
+          transpose.out().set_type(
+              PermuteType(value.type(), kToNHWC, common::DataLayout::NHWC));
+          transposed[value] = transpose.out();
+        }
+        op->operand(index).set_source(transposed[value]);
+      }
+
+      auto it = LayoutSensitiveOps().find(op->name());
+      if (it != LayoutSensitiveOps().end()) {
+        op->set_attribute(it->second.layout_attr,
+                          pir::StrAttribute::get(context_, "NHWC"));
+      }
+      for (auto index : LayoutResults(op)) {
+        auto result = op->result(index);
+        auto nchw_type = result.type();
+        result.set_type(
+            PermuteType(nchw_type, kToNHWC, common::DataLayout::NHWC));
+        // transpose back for the uses outside of the chain
+        bool used_outside = false;
+        for (auto use = result.use_begin(); use != result.use_end(); ++use) {
+          if (!IsInnerUse(*use, ops)) used_outside = true;
+        }
+        if (!used_outside) continue;
+        builder.SetInsertionPointAfter(op);
+        auto transpose =
+            builder.Build<paddle::dialect::TransposeOp>(result, kToNCHW);
+        transpose.out().set_type(nchw_type);
+        auto* transpose_op = transpose.operation();
+        result.ReplaceUsesWithIf(
+            transpose.out(), [&](pir::OpOperand use) {
+              return use.owner() != transpose_op && !IsInnerUse(use, ops);
+            });
+      }
+    }
+  }
+
+  pir::IrContext* context_{nullptr};
+  std::unordered_map<pir::Operation*, pir::Operation*> parent_;
+};
+
+}  // namespace
+
+namespace pir {
+
+std::unique_ptr<Pass> CreateTransferLayoutPass() {
+  return std::make_unique<TransferLayoutPass>();
+}
+
+}  // namespace pir
+
+REGISTER_IR_PASS(transfer_layout_pass, TransferLayoutPass);
@@ -33,3 +33,10 @@ TEST(CpuMemoryUsage, Print) {
                                        memory_size)
             << std::endl;
 }
+
+TEST(CpuInfo, ParseCpuList) {
+  std::vector<int> cpus = phi::backends::cpu::ParseCpuList("0-2,5,8-9\n");
+  EXPECT_EQ(cpus, std::vector<int>({0, 1, 2, 5, 8, 9}));
+  EXPECT_TRUE(phi::backends::cpu::ParseCpuList("").empty());
+  EXPECT_GE(phi::backends::cpu::NumaNodeCount(), 1);
+}
@@ -241,6 +241,22 @@ void TestCustomCCL(const paddle::platform::Place& place) {
                               stream);
 }
 
+void TestCustomGraph(const paddle::platform::Place& place) {
+  std::cout << "TestCustomGraph on " << place << std::endl;
+  if (paddle::platform::is_custom_place(place) == false) {
+    return;
+  }
+  EXPECT_TRUE(phi::DeviceManager::IsGraphCaptureSupported(place));
+  phi::stream::Stream stream(place, nullptr);
+
+  phi::DeviceManager::StreamBeginCapture(place, stream);
+  void* graph = phi::DeviceManager::StreamEndCapture(place, stream);
+  EXPECT_NE(graph, nullptr);
+  phi::DeviceManager::GraphLaunch(place, stream, graph);
+  phi::DeviceManager::GraphLaunch(place, stream, graph);
+  phi::DeviceManager::GraphDestroy(place, graph);
+}
+
 TEST(CustomDevice, Tensor) {
   paddle::framework::InitMemoryMethod();
   InitDevice();
@@ -256,6 +272,7 @@ TEST(CustomDevice, Tensor) {
     TestTensorShareDataWith(place);
     TestTensorUtils(place);
     TestCustomCCL(place);
+    TestCustomGraph(place);
   }
 }
 
@@ -66,9 +66,9 @@ class DeviceEvent {
                           MaxDeviceTypes,
                           type_id_));
 #ifndef PADDLE_WITH_CUSTOM_DEVICE
-    // TODO(Aurelius84): only support CPU/CUDA.
-    PADDLE_ENFORCE_LT(type_id_,
-                      3,
+    // TODO(Aurelius84): only support CPU/CUDA/XPU.
+    PADDLE_ENFORCE_EQ(type_id_ < 3 || type_id_ == DeviceTypeToId(kXPU),
+                      true,
                       platform::errors::Unavailable(
                           "Currently DeviceEvent do not support %s", place));
 #endif
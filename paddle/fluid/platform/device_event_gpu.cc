@@ -16,11 +16,15 @@
 #include "paddle/fluid/platform/event.h"
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_event_pool.h"
+
 namespace paddle {
 namespace platform {
+// The events are recycled by the pool of the device, since the executors
+// create the events of all the instructions for every program they run.
 struct CUDADeviceEventWrapper {
   CUDADeviceEventWrapper(const platform::Place& place, unsigned int flag)
-      : inner_event_(flag) {
+      : flag_(flag) {
     PADDLE_ENFORCE_EQ(
         platform::is_gpu_place(place),
         true,
@@ -34,9 +38,17 @@ struct CUDADeviceEventWrapper {
         platform::errors::PreconditionNotMet(
             "Required DeviceOption.device_id > -1, but received %d. ",
             device_id_));
+    inner_event_ =
+        phi::backends::gpu::GpuEventPool::Instance().Acquire(device_id_, flag_);
+  }
+
+  ~CUDADeviceEventWrapper() {
+    phi::backends::gpu::GpuEventPool::Instance().Release(
+        device_id_, flag_, inner_event_);
   }
 
-  CudaEvent inner_event_;
+  gpuEvent_t inner_event_;
+  unsigned int flag_;
   int device_id_;
 };
 
@@ -55,7 +67,13 @@ void DeviceEventRecordCUDA(DeviceEvent* event, const DeviceContext* context) {
       platform::errors::PreconditionNotMet(
           "Failed to dynamic_cast context into phi::GPUContext."));
 
-  wrapper->inner_event_.Record(cuda_dev_ctx->stream());
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipEventRecord(wrapper->inner_event_, cuda_dev_ctx->stream()));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaEventRecord(wrapper->inner_event_, cuda_dev_ctx->stream()));
+#endif
 }
 
 bool DeviceEventQueryCUDA(const DeviceEvent* event) {
@@ -65,13 +83,28 @@ bool DeviceEventQueryCUDA(const DeviceEvent* event) {
       platform::errors::PreconditionNotMet(
           "Failed to dynamic_cast event into CUDADeviceEventWrapper."));
 
-  return wrapper->inner_event_.Query();
+#ifdef PADDLE_WITH_HIP
+  gpuError_t err = hipEventQuery(wrapper->inner_event_);
+  if (err == hipErrorNotReady) {
+    return false;
+  }
+#else
+  gpuError_t err = cudaEventQuery(wrapper->inner_event_);
+  if (err == cudaErrorNotReady) {
+    return false;
+  }
+#endif
+  PADDLE_ENFORCE_GPU_SUCCESS(err);
+  return true;
 }
 
 void DeviceEventFinishCUDA(const DeviceEvent* event) {
   auto* wrapper = static_cast<CUDADeviceEventWrapper*>(event->GetEvent().get());
-  // calling cudaEventSynchronize
-  wrapper->inner_event_.Synchronize();
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventSynchronize(wrapper->inner_event_));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(wrapper->inner_event_));
+#endif
 }
 
 void DeviceEventCUDAWaitCUDA(const DeviceEvent* event,
@@ -83,7 +116,7 @@ void DeviceEventCUDAWaitCUDA(const DeviceEvent* event,
       platform::errors::PreconditionNotMet(
           "Failed to dynamic_cast context into phi::GPUContext."));
   // calling cudaStreamWaitEvent(stream, event, 0)
-  cuda_dev_ctx->WaitEvent(wrapper->inner_event_.GetRawCudaEvent());
+  cuda_dev_ctx->WaitEvent(wrapper->inner_event_);
 }
 
 void DeviceEventCPUWaitCUDA(const DeviceEvent* event,
@@ -24,6 +24,7 @@
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #endif
+#include "paddle/fluid/memory/allocation/allocator_facade.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/fluid/platform/flags.h"
 #include "paddle/fluid/platform/profiler/cuda_tracer.h"
@@ -37,6 +38,8 @@
 #include "paddle/phi/backends/device_manager.h"
 #endif
 
+PHI_DECLARE_bool(profile_memory_fragmentation);
+
 namespace paddle {
 namespace platform {
 
@@ -61,6 +64,31 @@ void SynchronizeDevice() {
 #endif
 }
 
+// Add the snapshot of the chunks and free blocks of the auto_growth
+// allocators, one entry for each allocator.
+static void AddMemoryFragmentationInfo(ExtraInfo* extrainfo) {
+  std::vector<phi::Place> places = {phi::CPUPlace()};
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  places.emplace_back(phi::GPUPinnedPlace());
+  for (auto device_id : GetSelectedDevices()) {
+    places.emplace_back(phi::GPUPlace(device_id));
+  }
+#endif
+  for (const auto& place : places) {
+    auto infos =
+        memory::allocation::AllocatorFacade::Instance().GetFragmentationInfo(
+            place);
+    for (size_t i = 0; i < infos.size(); ++i) {
+      extrainfo->AddExtraInfo(
+          string_format(std::string("Memory Fragmentation %s #%d"),
+                        place.DebugString().c_str(),
+                        static_cast<int>(i)),
+          std::string("%s"),
+          infos[i].DebugString().c_str());
+    }
+  }
+}
+
 std::atomic<bool> Profiler::alive_{false};
 
 uint32_t Profiler::span_indx = 0;
@@ -162,6 +190,9 @@ std::unique_ptr<ProfilerResult> Profiler::Stop() {
                            std::string("%s"),
                            kv.second.c_str());
   }
+  if (FLAGS_profile_memory_fragmentation) {
+    AddMemoryFragmentationInfo(&extrainfo);
+  }
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   std::map<uint32_t, gpuDeviceProp> device_property_map;
   std::vector<int32_t> device_ids = GetSelectedDevices();
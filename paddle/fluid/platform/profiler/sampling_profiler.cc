@@ -0,0 +1,162 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/platform/profiler/sampling_profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <fstream>
+
+#include "glog/logging.h"
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace platform {
+
+std::atomic<bool> SamplingProfiler::dump_requested_{false};
+
+static uint64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+#if !defined(_WIN32)
+static void SamplingProfilerSignalHandler(int) {
+  SamplingProfiler::RequestDump();
+}
+#endif
+
+SamplingProfiler::SamplingProfiler(const SamplingProfilerOptions& options)
+    : options_(options) {
+  PADDLE_ENFORCE_GT(options_.sample_every_n,
+                    0,
+                    platform::errors::InvalidArgument(
+                        "The sample_every_n of SamplingProfiler should be "
+                        "greater than 0."));
+  PADDLE_ENFORCE_GT(options_.ring_capacity,
+                    0,
+                    platform::errors::InvalidArgument(
+                        "The ring_capacity of SamplingProfiler should be "
+                        "greater than 0."));
+#if !defined(_WIN32)
+  std::signal(SIGUSR2, SamplingProfilerSignalHandler);
+#endif
+}
+
+SamplingProfiler::~SamplingProfiler() {
+  if (profiler_) {
+    profiler_->Stop();
+  }
+}
+
+void SamplingProfiler::StepBegin() {
+  if (step_ % options_.sample_every_n == 0) {
+    // Skip the step when another Profiler is alive.
+    profiler_ = Profiler::Create(options_.profiler_options);
+    if (profiler_) {
+      profiler_->Prepare();
+      profiler_->Start();
+    }
+  }
+  step_begin_ns_ = NowNs();
+}
+
+void SamplingProfiler::StepEnd() {
+  const double latency_ms = (NowNs() - step_begin_ns_) / 1e6;
+  const bool traced = profiler_ != nullptr;
+  if (traced) {
+    std::unique_ptr<ProfilerResult> result = profiler_->Stop();
+    profiler_.reset();
+    std::lock_guard<std::mutex> guard(mutex_);
+    AccumulateStats(result.get());
+    ring_.emplace_back(step_, std::move(result));
+    if (ring_.size() > options_.ring_capacity) {
+      ring_.pop_front();
+    }
+    ++num_traced_;
+  }
+  ++step_;
+
+  if (options_.latency_threshold_ms > 0 &&
+      latency_ms > options_.latency_threshold_ms) {
+    LOG(WARNING) << "Step " << step_ - 1 << " takes " << latency_ms
+                 << " ms, longer than the threshold "
+                 << options_.latency_threshold_ms << " ms.";
+    Dump("latency");
+  } else if (dump_requested_.exchange(false)) {
+    Dump("signal");
+  }
+  if (traced && options_.stats_every_n > 0 &&
+      num_traced_ % options_.stats_every_n == 0) {
+    ExportStats();
+  }
+}
+
+size_t SamplingProfiler::Dump(const std::string& reason) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  const std::string prefix = options_.dump_dir + "/sampling_" + reason + "_" +
+                             std::to_string(num_dumps_++);
+  for (auto& item : ring_) {
+    item.second->Save(prefix + "_step_" + std::to_string(item.first) + ".json",
+                      "json");
+  }
+  LOG(INFO) << "SamplingProfiler dumps " << ring_.size() << " traces to "
+            << prefix << "_step_*.json for " << reason << ".";
+  return ring_.size();
+}
+
+void SamplingProfiler::AccumulateStats(ProfilerResult* result) {
+  auto tree = result->GetNodeTrees();
+  if (!tree) return;
+  for (const auto& pair : tree->Traverse(true)) {
+    for (const auto* node : pair.second) {
+      if (node->Type() != TracerEventType::Operator) continue;
+      auto& stats = op_stats_[node->Name()];
+      stats.calls += 1;
+      stats.total_ns += node->Duration();
+      stats.max_ns = std::max(stats.max_ns, node->Duration());
+    }
+  }
+}
+
+void SamplingProfiler::ExportStats() {
+  auto op_stats = GetOpStats();
+  const std::string path = options_.dump_dir + "/sampling_op_stats.txt";
+  std::ofstream fout(path);
+  fout << "# " << num_traced_ << " traced steps of " << step_ << " steps\n";
+  fout << "# name calls total_ms avg_us max_us\n";
+  for (const auto& item : op_stats) {
+    const auto& stats = item.second;
+    fout << item.first << " " << stats.calls << " " << stats.total_ns / 1e6
+         << " " << stats.total_ns / 1e3 / stats.calls << " "
+         << stats.max_ns / 1e3 << "\n";
+  }
+  VLOG(3) << "SamplingProfiler exports the stats of " << op_stats.size()
+          << " ops to " << path;
+}
+
+std::map<std::string, SamplingOpStats> SamplingProfiler::GetOpStats() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return op_stats_;
+}
+
+size_t SamplingProfiler::NumBufferedTraces() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return ring_.size();
+}
+
+}  // namespace platform
+}  // namespace paddle
@@ -0,0 +1,106 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "paddle/fluid/platform/macros.h"
+#include "paddle/fluid/platform/profiler/profiler.h"
+
+namespace paddle {
+namespace platform {
+
+struct SamplingProfilerOptions {
+  // The profiler traces 1 of sample_every_n steps.
+  uint32_t sample_every_n = 100;
+  // The number of traced steps kept in the ring buffer.
+  uint32_t ring_capacity = 8;
+  // The buffered traces are dumped when a step takes longer, 0 to disable.
+  double latency_threshold_ms = 0;
+  // The per-op statistics are exported every stats_every_n traced steps.
+  uint32_t stats_every_n = 100;
+  // The directory of the dumped traces and the exported statistics.
+  std::string dump_dir = ".";
+  ProfilerOptions profiler_options;
+};
+
+struct SamplingOpStats {
+  uint64_t calls = 0;
+  uint64_t total_ns = 0;
+  uint64_t max_ns = 0;
+};
+
+// An always-on profiler for serving. Only 1 of N steps is traced by the
+// Profiler, the other steps only read the clock, and the recent traces are
+// kept in a bounded ring buffer. The ring buffer is dumped as chrome traces
+// when a step is slower than the threshold, or after the process receives
+// SIGUSR2, so that a rare latency spike can be diagnosed after the fact.
+//
+//   SamplingProfiler profiler(options);
+//   while (...) {
+//     profiler.StepBegin();
+//     predictor->Run();
+//     profiler.StepEnd();
+//   }
+class SamplingProfiler {
+ public:
+  explicit SamplingProfiler(const SamplingProfilerOptions& options);
+
+  ~SamplingProfiler();
+
+  void StepBegin();
+
+  void StepEnd();
+
+  // Dumps the traces in the ring buffer, returns the number of the traces.
+  size_t Dump(const std::string& reason);
+
+  // Writes the per-op statistics of the traced steps.
+  void ExportStats();
+
+  std::map<std::string, SamplingOpStats> GetOpStats() const;
+
+  size_t NumBufferedTraces() const;
+
+  uint64_t NumSteps() const { return step_; }
+
+  // Requests a dump at the end of the current step, it is async signal safe.
+  static void RequestDump() { dump_requested_.store(true); }
+
+ private:
+  void AccumulateStats(ProfilerResult* result);
+
+  DISABLE_COPY_AND_ASSIGN(SamplingProfiler);
+
+  static std::atomic<bool> dump_requested_;
+  SamplingProfilerOptions options_;
+  uint64_t step_ = 0;
+  uint64_t step_begin_ns_ = 0;
+  uint64_t num_traced_ = 0;
+  uint64_t num_dumps_ = 0;
+  std::unique_ptr<Profiler> profiler_;
+  mutable std::mutex mutex_;
+  std::deque<std::pair<uint64_t, std::unique_ptr<ProfilerResult>>> ring_;
+  std::map<std::string, SamplingOpStats> op_stats_;
+};
+
+}  // namespace platform
+}  // namespace paddle
@@ -0,0 +1,55 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/platform/profiler/sampling_profiler.h"
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/platform/profiler/event_tracing.h"
+
+using paddle::platform::RecordEvent;
+using paddle::platform::SamplingProfiler;
+using paddle::platform::SamplingProfilerOptions;
+using paddle::platform::TracerEventType;
+
+TEST(SamplingProfilerTest, TestRingBufferAndStats) {
+  SamplingProfilerOptions options;
+  options.sample_every_n = 2;
+  options.ring_capacity = 2;
+  options.stats_every_n = 0;
+  options.profiler_options.trace_switch = 1;
+  SamplingProfiler profiler(options);
+  for (int i = 0; i < 7; ++i) {
+    profiler.StepBegin();
+    { RecordEvent event("sampled_op", TracerEventType::Operator, 1); }
+    profiler.StepEnd();
+  }
+  EXPECT_EQ(profiler.NumSteps(), 7u);
+  // The steps 0, 2, 4 and 6 are traced, and the last two are kept.
+  EXPECT_EQ(profiler.NumBufferedTraces(), 2u);
+  auto op_stats = profiler.GetOpStats();
+  ASSERT_EQ(op_stats.count("sampled_op"), 1u);
+  EXPECT_EQ(op_stats["sampled_op"].calls, 4u);
+}
+
+TEST(SamplingProfilerTest, TestDumpOnRequest) {
+  SamplingProfilerOptions options;
+  options.sample_every_n = 1;
+  options.ring_capacity = 4;
+  options.stats_every_n = 0;
+  options.profiler_options.trace_switch = 1;
+  SamplingProfiler profiler(options);
+  profiler.StepBegin();
+  profiler.StepEnd();
+  EXPECT_EQ(profiler.Dump("test"), 1u);
+}
@@ -45,6 +45,15 @@ StreamCallbackManager<Stream>::StreamCallbackManager(const Stream stream)
 template <typename Stream>
 void StreamCallbackManager<Stream>::AddCallback(
     std::function<void()> callback) const {
+  if (phi::backends::gpu::UseStreamCallbackPoller(stream_)) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (poller_ == nullptr) {
+      poller_ = std::make_unique<phi::backends::gpu::StreamCallbackPoller>(
+          platform::GetCurrentDeviceId());
+    }
+    poller_->AddCallback(stream_, std::move(callback));
+    return;
+  }
   auto *callback_func = new std::function<void()>(std::move(callback));
   auto *func = new std::function<void()>([this, callback_func] {
     std::lock_guard<std::mutex> lock(mtx_);
@@ -74,11 +83,16 @@ void StreamCallbackManager<Stream>::Wait() const {
 #if defined(PADDLE_WITH_HIP) || defined(PADDLE_WITH_CUDA)
   platform::GpuStreamSync(stream_);
 #endif
+  phi::backends::gpu::StreamCallbackPoller *poller = nullptr;
   {
     std::lock_guard<std::mutex> lock(mtx_);
     if (last_future_.valid()) {
       last_future_.wait();
     }
+    poller = poller_.get();
+  }
+  if (poller != nullptr) {
+    poller->Wait();
   }
 }
 
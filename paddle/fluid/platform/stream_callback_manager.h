@@ -32,6 +32,7 @@
 
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/phi/backends/gpu/gpu_decls.h"
+#include "paddle/phi/backends/gpu/gpu_event_pool.h"
 
 namespace paddle {
 namespace platform {
@@ -54,6 +55,9 @@ class StreamCallbackManager {
   mutable ::ThreadPool thread_pool_;
   mutable std::mutex mtx_;
   mutable std::future<void> last_future_;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  mutable std::unique_ptr<phi::backends::gpu::StreamCallbackPoller> poller_;
+#endif
 };
 
 }  // namespace platform
@@ -17,12 +17,15 @@
 #include <pybind11/stl.h>
 
 #include "paddle/fluid/framework/ir/cost_model.h"
+#include "paddle/fluid/framework/ir/recompute_planner.h"
 #include "paddle/fluid/framework/program_desc.h"
 
 namespace py = pybind11;
 using paddle::framework::CostData;
 using paddle::framework::CostModel;
 using paddle::framework::ProgramDesc;
+using paddle::framework::RecomputePlan;
+using paddle::framework::RecomputePlanner;
 
 namespace paddle {
 namespace pybind {
@@ -54,6 +57,29 @@ void BindCostModel(py::module* m) {
                                         device,
                                         fetch_cost_list);
            });
+
+  py::class_<RecomputePlan>(*m, "RecomputePlan")
+      .def_readonly("checkpoints", &RecomputePlan::checkpoints)
+      .def_readonly("peak_memory_bytes", &RecomputePlan::peak_memory_bytes)
+      .def_readonly("recompute_time_ms", &RecomputePlan::recompute_time_ms)
+      .def_readonly("fits", &RecomputePlan::fits);
+
+  py::class_<RecomputePlanner>(*m, "RecomputePlanner")
+      .def(py::init([](py::object py_program, const CostData* cost) {
+             py::object py_program_desc = py_program.attr("desc");
+             ProgramDesc* program_desc = py_program_desc.cast<ProgramDesc*>();
+             return new RecomputePlanner(*program_desc, cost);
+           }),
+           py::arg("program"),
+           py::arg("cost_data") = nullptr)
+      .def("plan",
+           &RecomputePlanner::Plan,
+           py::arg("memory_budget_bytes"),
+           py::arg("batch_size"))
+      .def("max_batch_size",
+           &RecomputePlanner::MaxBatchSize,
+           py::arg("memory_budget_bytes"),
+           py::arg("max_batch_size"));
 }
 
 }  // namespace pybind
@@ -23,6 +23,7 @@
 #include "paddle/fluid/distributed/fleet_executor/dist_model.h"
 #include "paddle/fluid/distributed/fleet_executor/dist_model_tensor_wrapper.h"
 #include "paddle/fluid/distributed/fleet_executor/fleet_executor.h"
+#include "paddle/fluid/distributed/fleet_executor/runtime_graph.h"
 #include "paddle/fluid/distributed/fleet_executor/task_node.h"
 #include "paddle/fluid/framework/operator.h"
 #include "paddle/fluid/framework/program_desc.h"
@@ -72,6 +73,9 @@ using paddle::distributed::DistModelDataBuf;
 using paddle::distributed::DistModelDataType;
 using paddle::distributed::DistModelTensor;
 using paddle::distributed::FleetExecutor;
+using paddle::distributed::PipelineSchedule;
+using paddle::distributed::PipelineStageTasks;
+using paddle::distributed::RuntimeGraph;
 using paddle::distributed::TaskNode;
 using paddle::framework::OpDesc;
 using paddle::framework::ProgramDesc;
@@ -190,6 +194,45 @@ void BindFleetExecutor(py::module* m) {
       .def("init", [](TaskNode& self) { self.Init(); })
       .def("set_program", &TaskNode::SetProgram);
 
+  py::enum_<PipelineSchedule>(*m, "PipelineSchedule")
+      .value("STANDARD_1F1B", PipelineSchedule::k1F1B)
+      .value("INTERLEAVED_1F1B", PipelineSchedule::kInterleaved1F1B)
+      .value("ZERO_BUBBLE", PipelineSchedule::kZeroBubble);
+
+  m->def("pipeline_tasks_per_rank",
+         &RuntimeGraph::PipelineTasksPerRank,
+         py::arg("schedule"),
+         py::arg("num_chunks") = 1);
+  m->def(
+      "build_pipeline_schedule",
+      [](PipelineSchedule schedule,
+         const std::vector<int64_t>& pp_ranks,
+         int64_t pp_idx,
+         int64_t num_micro_batches,
+         TaskNode* lr,
+         const std::vector<TaskNode*>& fwd,
+         const std::vector<TaskNode*>& bwd,
+         const std::vector<TaskNode*>& bwd_weight,
+         TaskNode* opt) {
+        PipelineStageTasks tasks;
+        tasks.lr = lr;
+        tasks.fwd = fwd;
+        tasks.bwd = bwd;
+        tasks.bwd_weight = bwd_weight;
+        tasks.opt = opt;
+        RuntimeGraph::BuildPipelineSchedule(
+            schedule, pp_ranks, pp_idx, num_micro_batches, &tasks);
+      },
+      py::arg("schedule"),
+      py::arg("pp_ranks"),
+      py::arg("pp_idx"),
+      py::arg("num_micro_batches"),
+      py::arg("lr"),
+      py::arg("fwd"),
+      py::arg("bwd"),
+      py::arg("bwd_weight"),
+      py::arg("opt"));
+
   py::class_<DistModelConfig>(*m, "DistModelConfig")
       .def(py::init<>())
       .def_readwrite("model_dir", &DistModelConfig::model_dir)
@@ -203,7 +246,9 @@ void BindFleetExecutor(py::module* m) {
       .def_readwrite("local_rank", &DistModelConfig::local_rank)
       .def_readwrite("ring_id_to_ranks", &DistModelConfig::ring_id_to_ranks_)
       .def_readwrite("rank_to_ring_ids", &DistModelConfig::rank_to_ring_ids_)
-      .def_readwrite("enable_timer", &DistModelConfig::enable_timer);
+      .def_readwrite("enable_timer", &DistModelConfig::enable_timer)
+      .def_readwrite("comm_overlap_chunks",
+                     &DistModelConfig::comm_overlap_chunks);
 
   py::class_<DistModel>(*m, "DistModel")
       .def(py::init<const DistModelConfig&>())
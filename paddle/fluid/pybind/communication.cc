@@ -32,6 +32,10 @@ limitations under the License. */
 #include "paddle/phi/core/distributed/store/store_utils.h"
 #include "paddle/phi/core/distributed/store/tcp_store.h"
 
+#if defined(PADDLE_WITH_RCCL) || defined(PADDLE_WITH_NCCL)
+#include "paddle/phi/core/distributed/comm_task_manager.h"
+#endif
+
 namespace py = pybind11;
 
 namespace paddle {
@@ -84,6 +88,16 @@ void BindCommContextManager(py::module *m) {
               py::call_guard<py::gil_scoped_release>())
 #endif
           .def("set_store", &phi::distributed::CommContextManager::SetStore);
+
+#if defined(PADDLE_WITH_RCCL) || defined(PADDLE_WITH_NCCL)
+  m->def(
+      "get_comm_profile_summary",
+      []() {
+        return phi::distributed::CommTaskManager::GetInstance()
+            .GetCommProfileSummary();
+      },
+      py::call_guard<py::gil_scoped_release>());
+#endif
 }
 
 using TCPStore = phi::distributed::TCPStore;
@@ -114,6 +128,37 @@ void BindTCPStore(py::module *m) {
                        },
                        py::arg("key"),
                        py::call_guard<py::gil_scoped_release>())
+                   .def(
+                       "multi_set",
+                       [](phi::distributed::Store &self,
+                          const std::vector<std::string> &keys,
+                          const std::vector<std::string> &values) {
+                         std::vector<std::vector<uint8_t>> data;
+                         data.reserve(values.size());
+                         for (const auto &value : values) {
+                           data.emplace_back(value.begin(), value.end());
+                         }
+                         self.multi_set(keys, data);
+                       },
+                       py::arg("keys"),
+                       py::arg("values"),
+                       py::call_guard<py::gil_scoped_release>())
+                   .def(
+                       "multi_get",
+                       [](phi::distributed::Store &self,
+                          const std::vector<std::string> &keys) {
+                         auto data = self.multi_get(keys);
+                         py::gil_scoped_acquire acquire;
+                         std::vector<py::bytes> values;
+                         values.reserve(data.size());
+                         for (const auto &value : data) {
+                           values.emplace_back(
+                               std::string(value.begin(), value.end()));
+                         }
+                         return values;
+                       },
+                       py::arg("keys"),
+                       py::call_guard<py::gil_scoped_release>())
                    .def("add",
                         &phi::distributed::Store::add,
                         py::call_guard<py::gil_scoped_release>())
@@ -126,15 +171,17 @@ void BindTCPStore(py::module *m) {
                        uint16_t port,
                        bool is_master,
                        size_t world_size,
-                       int timeout) {
+                       int timeout,
+                       int num_shards) {
              return std::make_shared<TCPStore>(
-                 hostname, port, is_master, world_size, timeout);
+                 hostname, port, is_master, world_size, timeout, num_shards);
            }),
            py::arg("hostname"),
            py::arg("port"),
            py::arg("is_master"),
            py::arg("world_size"),
            py::arg("timeout") = 900,
+           py::arg("num_shards") = 1,
            py::call_guard<py::gil_scoped_release>());
 
   m->def("create_or_get_global_tcp_store",
@@ -368,6 +368,9 @@ void BindDataset(py::module *m) {
       .def("set_fleet_send_sleep_seconds",
            &framework::Dataset::SetFleetSendSleepSeconds,
            py::call_guard<py::gil_scoped_release>())
+      .def("set_streaming_shuffle",
+           &framework::Dataset::SetStreamingShuffle,
+           py::call_guard<py::gil_scoped_release>())
       .def("enable_pv_merge",
            &framework::Dataset::EnablePvMerge,
            py::call_guard<py::gil_scoped_release>())
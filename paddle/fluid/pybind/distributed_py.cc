@@ -21,6 +21,7 @@ limitations under the License. */
 #undef _XOPEN_SOURCE
 #endif
 
+#include "paddle/fluid/distributed/collective/param_prefetcher.h"
 #include "paddle/fluid/distributed/collective/process_group.h"
 #include "paddle/fluid/distributed/collective/reducer.h"
 #include "paddle/fluid/framework/lod_tensor.h"
@@ -75,6 +76,27 @@ std::shared_ptr<distributed::EagerReducer> CreateEagerReducer(
                                                      find_unused_parameters);
 }
 
+static std::vector<std::vector<Tensor>> CastPyArg2VectorOfVectorOfTensor(
+    py::handle obj) {
+  std::vector<std::vector<Tensor>> result;
+  for (auto item : py::reinterpret_borrow<py::list>(obj)) {
+    result.push_back(CastPyArg2VectorOfTensor(item.ptr(), 0));
+  }
+  return result;
+}
+
+std::shared_ptr<distributed::EagerParamPrefetcher> CreateEagerParamPrefetcher(
+    py::handle py_layer_params,
+    py::handle py_layer_shards,
+    std::shared_ptr<distributed::ProcessGroup> process_group,
+    int prefetch_layers) {
+  return std::make_shared<distributed::EagerParamPrefetcher>(
+      CastPyArg2VectorOfVectorOfTensor(py_layer_params),
+      CastPyArg2VectorOfVectorOfTensor(py_layer_shards),
+      process_group,
+      prefetch_layers);
+}
+
 #if defined(PADDLE_WITH_GLOO)
 using ProcessGroupGloo = paddle::distributed::ProcessGroupGloo;
 using GlooStore = paddle::distributed::ProcessGroupGloo::GlooStore;
@@ -1237,7 +1259,18 @@ void BindDistributed(py::module *m) {
                   py::arg("timeout") = 30 * 60 * 1000,
                   py::call_guard<py::gil_scoped_release>())
       .def_static("group_start", distributed::ProcessGroupNCCL::GroupStart)
-      .def_static("group_end", distributed::ProcessGroupNCCL::GroupEnd);
+      .def_static("group_end", distributed::ProcessGroupNCCL::GroupEnd)
+      .def("set_allreduce_algorithm",
+           &distributed::ProcessGroupNCCL::SetAllReduceAlgorithm,
+           py::arg("local_size"),
+           py::arg("compress_dtype") = phi::DataType::UNDEFINED,
+           py::call_guard<py::gil_scoped_release>())
+      .def("split_comm_context",
+           &distributed::ProcessGroupNCCL::SplitCommContext,
+           py::arg("group_id"),
+           py::arg("rank"),
+           py::arg("world_size"),
+           py::call_guard<py::gil_scoped_release>());
 
 #endif
 
@@ -1347,6 +1380,33 @@ void BindDistributed(py::module *m) {
           py::arg("tensors"),
           py::call_guard<py::gil_scoped_release>());
 
+  py::class_<distributed::EagerParamPrefetcher,
+             std::shared_ptr<distributed::EagerParamPrefetcher>>(
+      *m, "EagerParamPrefetcher", R"DOC()DOC")
+      .def(py::init(&CreateEagerParamPrefetcher),
+           py::arg("layer_params"),
+           py::arg("layer_shards"),
+           py::arg("process_group"),
+           py::arg("prefetch_layers") = 1)
+      .def("pre_forward",
+           &distributed::EagerParamPrefetcher::PreForward,
+           py::arg("layer"),
+           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "post_forward",
+          [](distributed::EagerParamPrefetcher &self,
+             size_t layer,
+             py::handle py_tensors) {
+            auto outputs = CastPyArg2VectorOfTensor(py_tensors.ptr(), 0);
+            py::gil_scoped_release release;
+            self.PostForward(layer, outputs);
+          },
+          py::arg("layer"),
+          py::arg("outputs"))
+      .def("release_all",
+           &distributed::EagerParamPrefetcher::ReleaseAll,
+           py::call_guard<py::gil_scoped_release>());
+
   py::class_<distributed::ProcessGroupIdMap,
              std::shared_ptr<distributed::ProcessGroupIdMap>>(
       *m, "ProcessGroupIdMap")
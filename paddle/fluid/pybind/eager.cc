@@ -63,12 +63,7 @@ extern PyTypeObject* g_vartype_pytype;
 extern PyTypeObject* g_framework_tensor_pytype;
 
 PyObject* TensorNew(PyTypeObject* type, PyObject* args, PyObject* kwargs) {
-  PyObject* obj = type->tp_alloc(type, 0);
-  if (obj) {
-    auto v = reinterpret_cast<TensorObject*>(obj);
-    new (&(v->tensor)) paddle::Tensor();
-  }
-  return obj;
+  return NewTensorObject(type);
 }
 
 // TODO(jiabin): Overload this once we need more constructor in Python
@@ -1371,12 +1366,7 @@ void AddPyMethodDefs(std::vector<PyMethodDef>* vector, PyMethodDef* methods) {
   }
 }
 
-static void TensorDealloc(TensorObject* self) {
-  if (self->weakrefs != nullptr)
-    PyObject_ClearWeakRefs(reinterpret_cast<PyObject*>(self));
-  self->tensor.~Tensor();
-  Py_TYPE(self)->tp_free(reinterpret_cast<PyObject*>(self));
-}
+static void TensorDealloc(TensorObject* self) { FreeTensorObject(self); }
 
 extern struct PyGetSetDef variable_properties[];                // NOLINT
 extern struct PyGetSetDef string_tensor_variable_properties[];  // NOLINT
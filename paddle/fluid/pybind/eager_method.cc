@@ -1152,10 +1152,9 @@ static PyObject* tensor_method_detach(TensorObject* self,
       platform::errors::InvalidArgument("Tensor %s has not been initialized!",
                                         self->tensor.name()));
 
-  PyObject* obj = p_tensor_type->tp_alloc(p_tensor_type, 0);
+  PyObject* obj = NewTensorObject(p_tensor_type);
   if (obj) {
     auto v = reinterpret_cast<TensorObject*>(obj);
-    new (&(v->tensor)) paddle::Tensor();
     v->tensor.set_impl(self->tensor.impl());
     v->tensor.set_name(egr::Controller::Instance().GenerateUniqueName());
     auto autograd_meta_src = egr::EagerUtils::autograd_meta(&(self->tensor));
@@ -1980,6 +1979,29 @@ static PyObject* tensor_register_reduce_hook(TensorObject* self,
   EAGER_CATCH_AND_THROW_RETURN_NULL
 }
 
+static PyObject* tensor__set_main_grad(TensorObject* self,
+                                       PyObject* args,
+                                       PyObject* kwargs) {
+  EAGER_TRY
+  auto accumulation_grad_node =
+      std::dynamic_pointer_cast<egr::GradNodeAccumulation>(
+          egr::EagerUtils::grad_node(self->tensor));
+  PADDLE_ENFORCE_NOT_NULL(
+      accumulation_grad_node,
+      platform::errors::InvalidArgument(
+          "Only can set the main grad of a leaf Tensor that requires "
+          "gradient, but Tensor %s is not.",
+          self->tensor.name()));
+  PyObject* main_grad = PyTuple_GET_ITEM(args, 0);
+  if (main_grad == Py_None) {
+    accumulation_grad_node->SetMainGrad(paddle::Tensor());
+  } else {
+    accumulation_grad_node->SetMainGrad(CastPyArg2Tensor(main_grad, 0));
+  }
+  RETURN_PY_NONE
+  EAGER_CATCH_AND_THROW_RETURN_NULL
+}
+
 static PyObject* tensor__set_grad_type(TensorObject* self,
                                        PyObject* args,
                                        PyObject* kwargs) {
@@ -3286,6 +3308,10 @@ PyMethodDef variable_methods[] = {  // NOLINT
      (PyCFunction)(void (*)())tensor_register_reduce_hook,
      METH_VARARGS | METH_KEYWORDS,
      tensor_method__register_reduce_hook__doc__},
+    {"_set_main_grad",
+     (PyCFunction)(void (*)())tensor__set_main_grad,
+     METH_VARARGS | METH_KEYWORDS,
+     nullptr},
     {"_set_grad_type",
      (PyCFunction)(void (*)())tensor__set_grad_type,
      METH_VARARGS | METH_KEYWORDS,
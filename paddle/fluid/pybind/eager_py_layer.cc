@@ -113,10 +113,9 @@ PyObject* pylayer_method_name(PyObject* self, PyObject* noargs) {
 }
 
 PyObject* new_tensor_with_impl(paddle::Tensor* tensor) {
-  PyObject* obj = p_tensor_type->tp_alloc(p_tensor_type, 0);
+  PyObject* obj = NewTensorObject(p_tensor_type);
   if (obj) {
     auto v = reinterpret_cast<TensorObject*>(obj);
-    new (&(v->tensor)) paddle::Tensor();
     v->tensor.set_impl(tensor->impl());
     v->tensor.set_name(egr::Controller::Instance().GenerateUniqueName());
   } else {
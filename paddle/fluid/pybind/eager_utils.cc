@@ -1023,10 +1023,9 @@ PyObject* ToPyObject(const std::vector<paddle::Tensor>& value,
       Py_INCREF(Py_None);
       PyList_SET_ITEM(result, static_cast<Py_ssize_t>(i), Py_None);
     } else {
-      PyObject* obj = p_tensor_type->tp_alloc(p_tensor_type, 0);
+      PyObject* obj = NewTensorObject(p_tensor_type);
       if (obj) {
         auto v = reinterpret_cast<TensorObject*>(obj);
-        new (&(v->tensor)) paddle::Tensor();
         v->tensor = value[i];
       } else {
         PADDLE_THROW(platform::errors::Fatal(
@@ -68,6 +68,8 @@ void BindDistFleetWrapper(py::module* m) {
       .def("stop_server", &FleetWrapper::StopServer)
       .def("stop_worker", &FleetWrapper::FinalizeWorker)
       .def("barrier", &FleetWrapper::BarrierWithTable)
+      .def("barrier_arrive", &FleetWrapper::BarrierArrive)
+      .def("barrier_wait", &FleetWrapper::BarrierWait)
       .def("shrink_sparse_table", &FleetWrapper::ShrinkSparseTable)
       .def("set_clients", &FleetWrapper::SetClients)
       .def("get_client_info", &FleetWrapper::GetClientsInfo)
@@ -179,6 +181,7 @@ void BindDistCommunicator(py::module* m) {
       .def("push_sparse_param", &Communicator::RpcSendSparseParam)
       .def("is_running", &Communicator::IsRunning)
       .def("init_params", &Communicator::InitParams)
+      .def("report_loss", &Communicator::ReportLoss)
       .def("pull_dense", &Communicator::PullDense)
       .def("create_client_to_client_connection",
            &Communicator::CreateC2CConnection)
@@ -388,8 +391,13 @@ void BindGraphGpuWrapper(py::module* m) {
                              const std::vector<bool>&,
                              bool>(&GraphGpuWrapper::load_edge_file))
       .def("load_node_and_edge", &GraphGpuWrapper::load_node_and_edge)
+      .def_static(
+          "convert_edge_file_to_binary",
+          &paddle::distributed::GraphTable::convert_edge_file_to_binary)
       .def("calc_edge_type_limit", &GraphGpuWrapper::calc_edge_type_limit)
       .def("show_mem", &GraphGpuWrapper::show_mem)
+      .def("report_neighbor_cache_stat",
+           &GraphGpuWrapper::report_neighbor_cache_stat)
       .def("upload_batch",
            py::overload_cast<int, int, const std::string&>(
                &GraphGpuWrapper::upload_batch))
@@ -609,8 +609,10 @@ void BindImperative(py::module *m_ptr) {
     }
   });
 
-  m.def("_cleanup_mmap_fds",
-        []() { memory::allocation::MemoryMapFdSet::Instance().Clear(); });
+  m.def("_cleanup_mmap_fds", []() {
+    memory::allocation::SharedMemorySegmentPool::Instance().Clear();
+    memory::allocation::MemoryMapFdSet::Instance().Clear();
+  });
 
   m.def("_set_max_memory_map_allocation_pool_size", [](int32_t size) {
     memory::allocation::MemoryMapAllocationPool::Instance().SetMaxPoolSize(
@@ -867,6 +867,10 @@ void BindAnalysisConfig(py::module *m) {
       .def("enable_new_executor",
            &AnalysisConfig::EnableNewExecutor,
            py::arg("x") = true)
+      .def("enable_auto_multi_stream",
+           &AnalysisConfig::EnableAutoMultiStream,
+           py::arg("stream_num") = 2)
+      .def("auto_multi_stream_num", &AnalysisConfig::auto_multi_stream_num)
       .def("enable_profile", &AnalysisConfig::EnableProfile)
       .def("disable_glog_info", &AnalysisConfig::DisableGlogInfo)
       .def("glog_info_disabled", &AnalysisConfig::glog_info_disabled)
@@ -874,6 +878,15 @@ void BindAnalysisConfig(py::module *m) {
            &AnalysisConfig::EnableSaveOptimModel,
            py::arg("save_optimized_model") = false)
       .def("set_optim_cache_dir", &AnalysisConfig::SetOptimCacheDir)
+      .def("enable_mmap_params",
+           &AnalysisConfig::EnableMmapParams,
+           py::arg("x") = true)
+      .def("mmap_params_enabled", &AnalysisConfig::mmap_params_enabled)
+      .def("enable_pir_program_cache",
+           &AnalysisConfig::EnablePirProgramCache,
+           py::arg("x") = true)
+      .def("pir_program_cache_enabled",
+           &AnalysisConfig::pir_program_cache_enabled)
       .def("switch_use_feed_fetch_ops",
            &AnalysisConfig::SwitchUseFeedFetchOps,
            py::arg("x") = true)
@@ -948,6 +961,15 @@ void BindAnalysisConfig(py::module *m) {
            &AnalysisConfig::SetTensorRtOptimizationLevel)
       .def("tensorrt_optimization_level",
            &AnalysisConfig::tensorrt_optimization_level)
+      .def("set_tensorrt_shape_profile_num",
+           &AnalysisConfig::SetTensorRtShapeProfileNum)
+      .def("tensorrt_shape_profile_num",
+           &AnalysisConfig::tensorrt_shape_profile_num)
+      .def("enable_tensorrt_engine_store",
+           &AnalysisConfig::EnableTensorRtEngineStore,
+           py::arg("store_dir"))
+      .def("tensorrt_engine_store_dir",
+           &AnalysisConfig::tensorrt_engine_store_dir)
       .def("enable_dlnne",
            &AnalysisConfig::EnableDlnne,
            py::arg("min_subgraph_size") = 3,
@@ -978,6 +1000,10 @@ void BindAnalysisConfig(py::module *m) {
            &AnalysisConfig::SetCpuMathLibraryNumThreads)
       .def("cpu_math_library_num_threads",
            &AnalysisConfig::cpu_math_library_num_threads)
+      .def("bind_numa_node", &AnalysisConfig::BindNumaNode)
+      .def("numa_node", &AnalysisConfig::numa_node)
+      .def("set_intra_op_num_threads", &AnalysisConfig::SetIntraOpNumThreads)
+      .def("intra_op_num_threads", &AnalysisConfig::intra_op_num_threads)
       .def("to_native_config", &AnalysisConfig::ToNativeConfig)
       .def("enable_quantizer", &AnalysisConfig::EnableMkldnnQuantizer)
       .def("enable_mkldnn_bfloat16", &AnalysisConfig::EnableMkldnnBfloat16)
@@ -1041,7 +1067,12 @@ void BindAnalysisConfig(py::module *m) {
       .def("nranks", &DistConfig::nranks)
       .def("rank", &DistConfig::rank)
       .def("comm_init_config", &DistConfig::comm_init_config)
-      .def("use_dist_model", &DistConfig::use_dist_model);
+      .def("use_dist_model", &DistConfig::use_dist_model)
+      .def("enable_comm_overlap",
+           &DistConfig::EnableCommOverlap,
+           py::arg("num_chunks") = 4)
+      .def("comm_overlap_enabled", &DistConfig::comm_overlap_enabled)
+      .def("comm_overlap_chunks", &DistConfig::comm_overlap_chunks);
 }
 
 void BindLiteNNAdapterConfig(py::module *m) {
@@ -1266,11 +1297,25 @@ void BindPaddleInferTensor(py::module *m) {
 }
 
 void BindPredictorPool(py::module *m) {
+  py::class_<paddle_infer::services::PredictorStat>(*m, "PredictorStat")
+      .def_readonly("run_num", &paddle_infer::services::PredictorStat::run_num)
+      .def_readonly("total_queue_ms",
+                    &paddle_infer::services::PredictorStat::total_queue_ms)
+      .def_readonly("max_queue_ms",
+                    &paddle_infer::services::PredictorStat::max_queue_ms)
+      .def_readonly("total_run_ms",
+                    &paddle_infer::services::PredictorStat::total_run_ms)
+      .def_readonly("max_run_ms",
+                    &paddle_infer::services::PredictorStat::max_run_ms);
+
   py::class_<paddle_infer::services::PredictorPool>(*m, "PredictorPool")
       .def(py::init<const paddle_infer::Config &, size_t>())
+      .def(py::init<const paddle_infer::Config &, size_t, bool>())
       .def("retrieve",
            &paddle_infer::services::PredictorPool::Retrieve,
-           py::return_value_policy::reference);
+           py::return_value_policy::reference)
+      .def("get_stats", &paddle_infer::services::PredictorPool::GetStats)
+      .def("size", &paddle_infer::services::PredictorPool::size);
 }
 
 void BindPaddlePassBuilder(py::module *m) {
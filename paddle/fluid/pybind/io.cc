@@ -15,6 +15,7 @@ limitations under the License. */
 #include "paddle/fluid/pybind/io.h"
 
 #include "paddle/fluid/framework/io/save_load_tensor.h"
+#include "paddle/fluid/framework/io/sharded_tensor.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/selected_rows_utils.h"
 #include "paddle/fluid/platform/enforce.h"
@@ -122,6 +123,53 @@ void BindIO(pybind11::module *m) {
     paddle::framework::LoadTensor(path, &tensor_load);
     return tensor_load;
   });
+
+  m->def(
+      "save_sharded_tensor",
+      [](const phi::DenseTensor &tensor,
+         const std::string &dir,
+         size_t chunk_bytes,
+         int thread_num,
+         int compress_level) {
+        paddle::framework::ShardedTensorOptions options;
+        options.chunk_bytes = chunk_bytes;
+        options.thread_num = thread_num;
+        options.compress_level = compress_level;
+        paddle::framework::SaveShardedTensor(tensor, dir, options);
+      },
+      py::arg("tensor"),
+      py::arg("dir"),
+      py::arg("chunk_bytes") = 64UL << 20,
+      py::arg("thread_num") = 8,
+      py::arg("compress_level") = 1,
+      py::call_guard<py::gil_scoped_release>());
+
+  m->def(
+      "load_sharded_tensor",
+      [](phi::DenseTensor &tensor, const std::string &dir, int thread_num) {
+        paddle::framework::LoadShardedTensor(dir, &tensor, thread_num);
+      },
+      py::arg("tensor"),
+      py::arg("dir"),
+      py::arg("thread_num") = 8,
+      py::call_guard<py::gil_scoped_release>());
+
+  m->def(
+      "load_sharded_tensor_rows",
+      [](phi::DenseTensor &tensor,
+         const std::string &dir,
+         int64_t begin_row,
+         int64_t end_row,
+         int thread_num) {
+        paddle::framework::LoadShardedTensorRows(
+            dir, begin_row, end_row, &tensor, thread_num);
+      },
+      py::arg("tensor"),
+      py::arg("dir"),
+      py::arg("begin_row"),
+      py::arg("end_row"),
+      py::arg("thread_num") = 8,
+      py::call_guard<py::gil_scoped_release>());
 }
 }  // namespace pybind
 }  // namespace paddle
@@ -43,6 +43,9 @@ void BindMetrics(py::module* m) {
       .def("flip_phase",
            &framework::Metric::FlipPhase,
            py::call_guard<py::gil_scoped_release>())
+      .def("set_nccl_ring_id",
+           &framework::Metric::SetNcclRingId,
+           py::call_guard<py::gil_scoped_release>())
       .def("get_metric_msg",
            &framework::Metric::GetMetricMsg,
            py::call_guard<py::gil_scoped_release>())
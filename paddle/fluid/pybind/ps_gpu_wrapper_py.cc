@@ -65,6 +65,9 @@ void BindPSGPUWrapper(py::module* m) {
       .def("begin_pass",
            &framework::PSGPUWrapper::BeginPass,
            py::call_guard<py::gil_scoped_release>())
+      .def("wait_end_pass",
+           &framework::PSGPUWrapper::WaitEndPass,
+           py::call_guard<py::gil_scoped_release>())
       .def("dump_to_mem",
            &framework::PSGPUWrapper::DumpToMem,
            py::call_guard<py::gil_scoped_release>())
@@ -75,6 +75,7 @@ limitations under the License. */
 #include "paddle/fluid/imperative/amp_auto_cast.h"
 #include "paddle/fluid/imperative/layer.h"
 #include "paddle/fluid/memory/allocation/allocator_strategy.h"
+#include "paddle/fluid/memory/allocation/memory_attribution.h"
 #include "paddle/fluid/platform/bfloat16.h"
 #include "paddle/fluid/platform/float16.h"
 #include "paddle/fluid/prim/utils/utils.h"
@@ -127,6 +128,7 @@ limitations under the License. */
 #include "paddle/fluid/pybind/pir.h"
 #include "paddle/fluid/pybind/ps_gpu_wrapper_py.h"
 #include "paddle/fluid/pybind/pybind_variant_caster.h"
+#include "paddle/fluid/pybind/sot/guards.h"
 #include "paddle/fluid/pybind/xpu_streams_py.h"
 #include "paddle/phi/backends/cpu/cpu_info.h"
 #include "paddle/phi/backends/device_manager.h"
@@ -836,6 +838,7 @@ PYBIND11_MODULE(libpaddle, m) {
   BindXpuStream(&m);
   BindJit(&m);
   BindEvalFrame(&m);
+  BindGuard(&m);
   BindCustomDevicePy(&m);
   BindEagerUtils(m.ptr());
 
@@ -991,7 +994,17 @@ PYBIND11_MODULE(libpaddle, m) {
     platform::DeviceContextPool::Instance().Get(place)->Wait();
   });
 
+  // The data of the capsule is shared without a copy, and the capsule is
+  // renamed only once the tensor owns it.
   m.def("from_dlpack", [](py::capsule *dltensor) {
+    phi::DenseTensor tensor;
+    if (PyCapsule_IsValid(dltensor->ptr(), "dltensor_versioned")) {
+      auto *dmt = static_cast<DLManagedTensorVersioned *>(
+          PyCapsule_GetPointer(dltensor->ptr(), "dltensor_versioned"));
+      paddle::framework::TensorFromDLPackNoCopy(dmt, &tensor);
+      PyCapsule_SetName(dltensor->ptr(), "used_dltensor_versioned");
+      return tensor;
+    }
     DLManagedTensor *dmt = reinterpret_cast<DLManagedTensor *>(
         PyCapsule_GetPointer(dltensor->ptr(), "dltensor"));
 
@@ -1001,18 +1014,8 @@ PYBIND11_MODULE(libpaddle, m) {
             "from_dlpack received an invalid capsule. "
             "Note that a DLPack tensor can be consumed only once."));
 
+    paddle::framework::TensorFromDLPackNoCopy(dmt, &tensor);
     PyCapsule_SetName(dltensor->ptr(), "used_dltensor");
-    DLTensor dl = dmt->dl_tensor;
-    phi::DenseTensor tensor;
-
-    if (dl.device.device_type == kDLCPU) {
-      paddle::framework::TensorFromDLPack(dmt, &tensor);
-    }
-#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
-    if (dl.device.device_type == kDLGPU) {
-      paddle::framework::TensorFromDLPack(dmt, &tensor);
-    }
-#endif
     return tensor;
   });
 
@@ -2183,6 +2186,21 @@ All parameter, weight, gradient are variables in Paddle.
   m.def("device_memory_stat_peak_value", memory::DeviceMemoryStatPeakValue);
   m.def("host_memory_stat_current_value", memory::HostMemoryStatCurrentValue);
   m.def("host_memory_stat_peak_value", memory::HostMemoryStatPeakValue);
+  m.def(
+      "memory_attribution_report",
+      [](size_t top_k) {
+        return memory::allocation::MemoryAttribution::Instance().PeakReport(
+            top_k);
+      },
+      py::arg("top_k") = 20);
+  m.def("save_memory_attribution", [](const std::string &dir) {
+    memory::allocation::MemoryAttribution::Instance().Save(dir);
+  });
+  m.def("reset_memory_attribution",
+        [] { memory::allocation::MemoryAttribution::Instance().Reset(); });
+  m.def("numa_node_count", &phi::backends::cpu::NumaNodeCount);
+  m.def("bind_thread_to_numa_node",
+        &phi::backends::cpu::BindCurrentThreadToNumaNode);
   m.def(
       "run_cmd",
       [](const std::string &cmd,
@@ -2936,6 +2954,9 @@ All parameter, weight, gradient are variables in Paddle.
   m.def("set_nan_inf_debug_path",
         &paddle::framework::details::SetNanInfDebugPath);
 
+  // Read the flags of FLAGS_check_nan_inf_async_interval
+  m.def("check_nan_inf_flags", &paddle::framework::details::CheckNanInfFlags);
+
   // Add check op lost
   m.def("set_checked_op_list",
         [](const std::string &op_list) { egr::SetCheckOpList(op_list); });
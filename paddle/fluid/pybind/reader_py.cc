@@ -14,6 +14,7 @@
 
 #include "paddle/fluid/pybind/reader_py.h"
 
+#include <algorithm>
 #include <exception>
 #include <memory>
 #include <string>
@@ -36,6 +37,7 @@
 #include "pybind11/stl.h"
 
 PHI_DECLARE_bool(reader_queue_speed_test_mode);
+PHI_DECLARE_int32(reader_prefetch_depth);
 
 // disable auto conversion to list in Python
 PYBIND11_MAKE_OPAQUE(paddle::framework::LoDTensorArray);
@@ -177,7 +179,10 @@ class MultiDeviceFeedReader {
         VLOG(10) << "Creating " << i << "-th BufferedReader";
         holder->Reset(
             framework::MakeDecoratedReader<operators::reader::BufferedReader>(
-                reader, p, 2, pin_memory_));
+                reader,
+                p,
+                std::max(FLAGS_reader_prefetch_depth, 1),
+                pin_memory_));
       } else {
         if (platform::is_gpu_place(p)) {
           PADDLE_THROW(platform::errors::PermissionDenied(
@@ -40,7 +40,8 @@ void BindFuture(py::module* m) {
       .def(py::init<>())
       .def("wait",
            &FutureWrapper::wait,
-           py::call_guard<py::gil_scoped_release>());
+           py::call_guard<py::gil_scoped_release>())
+      .def("done", &FutureWrapper::done);
 }
 void InitAndSetAgentInstance(py::module* m) {
   m->def(
@@ -56,15 +57,37 @@ void InitAndSetAgentInstance(py::module* m) {
 void InvokeRpc(py::module* m) {
   m->def(
       "invoke_rpc",
-      [](const std::string& name, const std::string& py_func, int timeout_ms) {
+      [](const std::string& name, const py::object& py_func, int timeout_ms) {
         auto instance = RpcAgent::RpcAgentInstance();
+        auto payload = PythonRpcHandler::GetInstance()->Serialize(py_func);
         return std::make_shared<FutureWrapper>(
-            instance->InvokeRpc(py_func, name, timeout_ms));
+            instance->InvokeRpc(payload, name, timeout_ms));
       },
       py::call_guard<py::gil_scoped_release>(),
       py::arg("to"),
       py::arg("py_func"),
       py::arg("timeout_ms"));
+  m->def(
+      "invoke_rpc_batch",
+      [](const std::string& name,
+         const std::vector<py::object>& py_funcs,
+         int timeout_ms) {
+        auto instance = RpcAgent::RpcAgentInstance();
+        auto python_handler = PythonRpcHandler::GetInstance();
+        std::vector<paddle::distributed::RpcPayload> payloads;
+        for (auto& py_func : py_funcs) {
+          payloads.push_back(python_handler->Serialize(py_func));
+        }
+        std::vector<std::shared_ptr<FutureWrapper>> futures;
+        for (auto& fut : instance->InvokeRpcBatch(payloads, name, timeout_ms)) {
+          futures.push_back(std::make_shared<FutureWrapper>(std::move(fut)));
+        }
+        return futures;
+      },
+      py::call_guard<py::gil_scoped_release>(),
+      py::arg("to"),
+      py::arg("py_funcs"),
+      py::arg("timeout_ms"));
 }
 void StartWorker(py::module* m) {
   m->def(
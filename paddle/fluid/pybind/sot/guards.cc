@@ -0,0 +1,102 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pybind/sot/guards.h"
+
+#include "paddle/fluid/eager/eager_tensor.h"
+#include "paddle/fluid/eager/utils.h"
+#include "paddle/fluid/framework/convert_utils.h"
+#include "paddle/fluid/imperative/layout_autotune.h"
+#include "paddle/utils/pybind.h"
+
+namespace py = pybind11;
+
+namespace paddle {
+namespace pybind {
+
+TensorMetaMatchGuard::TensorMetaMatchGuard(
+    const std::vector<int64_t>& shape,
+    framework::proto::VarType::Type dtype,
+    bool stop_gradient,
+    const py::object& fallback)
+    : shape_(shape),
+      dtype_(framework::TransToPhiDataType(dtype)),
+      stop_gradient_(stop_gradient),
+      fallback_(fallback) {}
+
+bool TensorMetaMatchGuard::check_by_fallback(PyObject* value) const {
+  PyObject* result =
+      PyObject_CallFunctionObjArgs(fallback_.ptr(), value, nullptr);
+  if (result == nullptr) {
+    throw py::error_already_set();
+  }
+  int matched = PyObject_IsTrue(result);
+  Py_DECREF(result);
+  if (matched < 0) {
+    throw py::error_already_set();
+  }
+  return matched == 1;
+}
+
+bool TensorMetaMatchGuard::check(PyObject* value) const {
+  if (!PyObject_TypeCheck(value, p_tensor_type)) {
+    return check_by_fallback(value);
+  }
+  const auto& tensor = reinterpret_cast<TensorObject*>(value)->tensor;
+  const auto& autotune = imperative::LayoutAutoTune::Instance();
+  if (!tensor.defined() || egr::IsVariableCompatTensor(tensor) ||
+      tensor.dtype() == phi::DataType::FLOAT16 ||
+      autotune.GetDesiredLayout() != autotune.GetDefaultLayout()) {
+    return check_by_fallback(value);
+  }
+
+  if (tensor.dtype() != dtype_) {
+    return false;
+  }
+  auto* autograd_meta = egr::EagerUtils::nullable_autograd_meta(tensor);
+  bool stop_gradient =
+      autograd_meta == nullptr || autograd_meta->StopGradient();
+  if (stop_gradient != stop_gradient_) {
+    return false;
+  }
+  const auto& dims = tensor.dims();
+  if (static_cast<size_t>(dims.size()) != shape_.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < shape_.size(); ++i) {
+    if (dims[static_cast<int>(i)] != shape_[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void BindGuard(pybind11::module* m) {
+  py::class_<TensorMetaMatchGuard>(
+      *m, "TensorMetaMatchGuard", R"DOC(TensorMetaMatchGuard Class.)DOC")
+      .def(py::init<const std::vector<int64_t>&,
+                    framework::proto::VarType::Type,
+                    bool,
+                    const py::object&>(),
+           py::arg("shape"),
+           py::arg("dtype"),
+           py::arg("stop_gradient"),
+           py::arg("fallback"))
+      .def("__call__", [](const TensorMetaMatchGuard& self, py::handle value) {
+        return self.check(value.ptr());
+      });
+}
+
+}  // namespace pybind
+}  // namespace paddle
@@ -0,0 +1,56 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <Python.h>
+
+#include <vector>
+
+#include "paddle/fluid/framework/framework.pb.h"
+#include "paddle/phi/common/data_type.h"
+#include "pybind11/pybind11.h"
+
+namespace paddle {
+namespace pybind {
+
+// Checks a Tensor of the frame against the shape, dtype and stop_gradient of
+// the translated code in C++, as the guard string of MetaInfo.from_tensor
+// does in Python, but without creating the MetaInfo and formatting it on
+// every frame. The values out of the fast path, i.e. the non eager Tensors,
+// the float16 Tensors whose dtype depends on the AMP state, and the Tensors
+// whose shapes are converted by the layout autotune, are checked by the
+// fallback of Python.
+class TensorMetaMatchGuard {
+ public:
+  TensorMetaMatchGuard(const std::vector<int64_t>& shape,
+                       framework::proto::VarType::Type dtype,
+                       bool stop_gradient,
+                       const pybind11::object& fallback);
+
+  bool check(PyObject* value) const;
+
+ private:
+  bool check_by_fallback(PyObject* value) const;
+
+  std::vector<int64_t> shape_;
+  phi::DataType dtype_;
+  bool stop_gradient_;
+  pybind11::object fallback_;
+};
+
+void BindGuard(pybind11::module* m);
+
+}  // namespace pybind
+}  // namespace paddle
@@ -203,8 +203,54 @@ static void TensorCopyFrom(phi::DenseTensor *dst,
   }
 }
 
+// Wraps the tensor into a capsule by the DLPack protocol, which is renamed by
+// the consumer once the tensor is taken.
+static py::capsule TensorToDLPackCapsule(const phi::DenseTensor &tensor,
+                                         bool versioned) {
+  if (versioned) {
+    DLManagedTensorVersioned *dmt = framework::toDLPackVersioned(tensor);
+    return py::capsule(
+        static_cast<void *>(dmt), "dltensor_versioned", [](PyObject *ptr) {
+          if (!PyCapsule_IsValid(ptr, "dltensor_versioned")) {
+            return;
+          }
+          auto *dmt = static_cast<DLManagedTensorVersioned *>(
+              PyCapsule_GetPointer(ptr, "dltensor_versioned"));
+          dmt->deleter(dmt);
+        });
+  }
+  DLManagedTensor *dmt = framework::toDLPack(tensor);
+  return py::capsule(
+      static_cast<void *>(dmt), "dltensor", [](PyObject *ptr) {
+        if (!PyCapsule_IsValid(ptr, "dltensor")) {
+          return;
+        }
+        DLManagedTensor *dmt = static_cast<DLManagedTensor *>(
+            PyCapsule_GetPointer(ptr, "dltensor"));
+        dmt->deleter(dmt);
+      });
+}
+
 void BindTensor(pybind11::module &m) {  // NOLINT
   using namespace paddle::framework;    // NOLINT
+  m.def(
+      "_to_dlpack_list",
+      [](const std::vector<phi::DenseTensor *> &tensors,
+         int64_t stream,
+         bool versioned) {
+        framework::DLPackWaitProducer(
+            std::vector<const phi::DenseTensor *>(tensors.begin(),
+                                                  tensors.end()),
+            stream);
+        py::list capsules;
+        for (auto *tensor : tensors) {
+          capsules.append(TensorToDLPackCapsule(*tensor, versioned));
+        }
+        return capsules;
+      },
+      py::arg("tensors"),
+      py::arg("stream") = -1,
+      py::arg("versioned") = false);
   py::class_<phi::DenseTensor> framework_tensor(
       m, "Tensor", py::buffer_protocol());
   g_framework_tensor_pytype =
@@ -423,20 +469,14 @@ void BindTensor(pybind11::module &m) {  // NOLINT
                     >>> print(t.shape())
                     [5, 30]
            )DOC")
-      .def("_to_dlpack",
-           [](phi::DenseTensor &self) {
-             DLManagedTensor *dmt = framework::toDLPack(self);
-             auto capsule = pybind11::capsule(
-                 static_cast<void *>(dmt), "dltensor", [](PyObject *ptr) {
-                   if (!PyCapsule_IsValid(ptr, "dltensor")) {
-                     return;
-                   }
-                   DLManagedTensor *dmt = static_cast<DLManagedTensor *>(
-                       PyCapsule_GetPointer(ptr, "dltensor"));
-                   dmt->deleter(dmt);
-                 });
-             return capsule;
-           })
+      .def(
+          "_to_dlpack",
+          [](phi::DenseTensor &self, int64_t stream, bool versioned) {
+            framework::DLPackWaitProducer({&self}, stream);
+            return TensorToDLPackCapsule(self, versioned);
+          },
+          py::arg("stream") = -1,
+          py::arg("versioned") = false)
       .def("_set_float_element", TensorSetElement<float>)
       .def("_get_float_element", TensorGetElement<float>)
       .def("_set_double_element", TensorSetElement<double>)
@@ -877,9 +917,45 @@ void BindTensor(pybind11::module &m) {  // NOLINT
                            "Tensor is not on CPU. share_filename only "
                            "support CPU Tensor."));
 
+             int type_idx = static_cast<int>(self.type());
+             auto *segment_allocation = dynamic_cast<
+                 memory::allocation::SharedMemorySegmentAllocation *>(
+                 holder.get());
              auto *mmap_allocation = dynamic_cast<
                  memory::allocation::RefcountedMemoryMapAllocation *>(
                  holder.get());
+             // The small tensors are copied into the pooled shm segments if
+             // FLAGS_shm_segment_size_mb is set, and passed by the offsets.
+             if (segment_allocation == nullptr && mmap_allocation == nullptr) {
+               void *data_ptr = self.data();
+               size_t data_size =
+                   self.numel() *
+                   framework::SizeOfType(
+                       framework::TransToProtoVarType(self.type()));
+               auto segment_holder =
+                   memory::allocation::SharedMemorySegmentPool::Instance()
+                       .Allocate(data_size);
+               if (segment_holder != nullptr) {
+                 if (platform::is_cuda_pinned_place(holder->place())) {
+#ifdef PADDLE_WITH_CUDA
+                   memory::Copy(platform::CPUPlace(), segment_holder->ptr(),
+                                platform::CUDAPinnedPlace(), data_ptr,
+                                data_size);
+#endif
+                 } else {
+                   memory::Copy(platform::CPUPlace(), segment_holder->ptr(),
+                                platform::CPUPlace(), data_ptr, data_size);
+                 }
+                 self.ResetHolder(segment_holder);
+                 segment_allocation = segment_holder.get();
+               }
+             }
+             if (segment_allocation != nullptr) {
+               return py::make_tuple(segment_allocation->ipc_name(),
+                                     segment_allocation->size(), type_idx,
+                                     common::vectorize(self.dims()),
+                                     self.lod(), segment_allocation->offset());
+             }
              // If the tensor is not shared, allocate memory map allocation.
              if (mmap_allocation == nullptr) {
                void *data_ptr = self.data();
@@ -915,7 +991,6 @@ void BindTensor(pybind11::module &m) {  // NOLINT
                self.ResetHolder(shared_holder);
                mmap_allocation = shared_holder.get();
              }
-             int type_idx = static_cast<int>(self.type());
 
              return py::make_tuple(mmap_allocation->ipc_name(),
                                    mmap_allocation->size(), type_idx,
@@ -927,7 +1002,8 @@ void BindTensor(pybind11::module &m) {  // NOLINT
 
            Returns:
                tuple: contrains ipc name, data size, data type,
-                      tensor dims and lod imformation.
+                      tensor dims and lod imformation, and the offset in
+                      the shm segment if the tensor is in a pooled segment.
 
            Examples:
                 .. code-block:: python
@@ -939,7 +1015,7 @@ void BindTensor(pybind11::module &m) {  // NOLINT
        )DOC")
       .def("_new_shared_filename",
            [](py::tuple t) {  // __setstate__
-             if (t.size() != 5)
+             if (t.size() != 5 && t.size() != 6)
                throw std::runtime_error("Invalid Tensor meta info state!");
 
              phi::DenseTensor tensor;
@@ -947,6 +1023,18 @@ void BindTensor(pybind11::module &m) {  // NOLINT
              // 2. Rebuild Allocation
              const std::string &ipc_name = t[0].cast<std::string>();
              size_t size = t[1].cast<size_t>();
+             if (t.size() == 6) {
+               auto segment_holder =
+                   memory::allocation::SharedMemorySegmentPool::Instance()
+                       .Rebuild(ipc_name, t[5].cast<size_t>(), size);
+               tensor.ResetHolderWithType(
+                   segment_holder,
+                   static_cast<phi::DataType>(t[2].cast<int>()));
+               tensor.Resize(
+                   common::make_ddim(t[3].cast<std::vector<int>>()));
+               tensor.set_lod(t[4].cast<framework::LoD>());
+               return tensor;
+             }
              int flags = memory::allocation::MAPPED_SHAREDMEM |
                          memory::allocation::MAPPED_NOCREATE;
              int find_id = -1;
@@ -990,6 +1078,12 @@ void BindTensor(pybind11::module &m) {  // NOLINT
              if (mmap_allocation) {
                mmap_allocation->incref();
              }
+             auto *segment_allocation = dynamic_cast<
+                 memory::allocation::SharedMemorySegmentAllocation *>(
+                 self.Holder().get());
+             if (segment_allocation) {
+               segment_allocation->incref();
+             }
            },
            R"DOC(
             Increase reference count of share_filename tensor.
@@ -1002,6 +1096,12 @@ void BindTensor(pybind11::module &m) {  // NOLINT
              if (mmap_allocation) {
                mmap_allocation->decref();
              }
+             auto *segment_allocation = dynamic_cast<
+                 memory::allocation::SharedMemorySegmentAllocation *>(
+                 self.Holder().get());
+             if (segment_allocation) {
+               segment_allocation->decref();
+             }
            },
            R"DOC(
             Decrease reference count of share_filename tensor.
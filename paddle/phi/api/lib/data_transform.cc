@@ -70,6 +70,16 @@ inline bool NeedTransform2Contiguous(bool is_stride_kernel,
   return FLAGS_use_stride_kernel && !is_stride_kernel && !is_contiguous;
 }
 
+// A host tensor cast for a GPU kernel is copied to the GPU first and cast
+// there, since the cast on the GPU is much faster than on the host, so that
+// the cast of a host tensor and its copy are one pass over the host memory.
+inline bool NeedTransformDataTypeAfterPlace(const phi::Place& src_place,
+                                            Backend dst_backend) {
+  return (src_place.GetType() == AllocationType::CPU ||
+          src_place.GetType() == AllocationType::GPUPINNED) &&
+         phi::TransToPhiPlace(dst_backend).GetType() == AllocationType::GPU;
+}
+
 inline phi::DenseTensor TransDataLayout(const phi::DenseTensor& tensor,
                                         DataLayout layout) {
   auto& pool = phi::DeviceContextPool::Instance();
@@ -130,6 +140,8 @@ phi::DenseTensor CastDataType(const phi::GPUContext& dev_ctx,
       return phi::Cast<int64_t>(dev_ctx, tensor, dtype);
     case DataType::FLOAT16:
       return phi::Cast<phi::dtype::float16>(dev_ctx, tensor, dtype);
+    case DataType::BFLOAT16:
+      return phi::Cast<phi::dtype::bfloat16>(dev_ctx, tensor, dtype);
     case DataType::BOOL:
       return phi::Cast<bool>(dev_ctx, tensor, dtype);
     case DataType::INT16:
@@ -312,18 +324,26 @@ phi::DenseTensor TransformData(const phi::DenseTensor& tensor,
     trans_layout = true;
   }
 
+  bool trans_place =
+      NeedTransformPlace(out.place(), target_args_def.backend, transform_flag);
   if (NeedTransformDataType(
           tensor.dtype(), target_args_def.dtype, transform_flag)) {
     if (NeedTransform2Contiguous(false, out.meta().is_contiguous())) {
       out = Trans2Contiguous(out);
     }
-    out = TransDataType(out, target_args_def.dtype);
     trans_dtype = true;
+    if (!trans_place ||
+        !NeedTransformDataTypeAfterPlace(out.place(),
+                                         target_args_def.backend)) {
+      out = TransDataType(out, target_args_def.dtype);
+    }
   }
 
-  if (NeedTransformPlace(
-          out.place(), target_args_def.backend, transform_flag)) {
+  if (trans_place) {
     out = TransDataPlace(out, phi::TransToPhiPlace(target_args_def.backend));
+    if (trans_dtype && out.dtype() != target_args_def.dtype) {
+      out = TransDataType(out, target_args_def.dtype);
+    }
     if (!trans_layout && !trans_dtype &&
         tensor.place().GetType() == AllocationType::GPUPINNED) {
       // Sharing buffer on GPUPINNED place is a special case due to historical
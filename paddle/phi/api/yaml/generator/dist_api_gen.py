@@ -98,12 +98,16 @@ OPTIONAL_VECTOR_DIST_META_IN_TEMPLATE = """
         }}
     }}"""
 INFER_SPMD_TEMPLATE = """
-    auto spmd_info = phi::distributed::{}({});
-    DebugInfoForInferSpmd("{}", spmd_info);
+    auto spmd_info = phi::distributed::CachedInferSpmd("{0}", [&]() {{
+        return phi::distributed::{0}({1});
+    }}, {1});
+    DebugInfoForInferSpmd("{2}", spmd_info);
 """
 GENERAL_INFER_SPMD_TEMPLATE = """
-    auto spmd_info = phi::distributed::VariadicReplicatedInferSpmdDynamic({});
-    DebugInfoForInferSpmd("{}", spmd_info);
+    auto spmd_info = phi::distributed::CachedInferSpmd("VariadicReplicatedInferSpmdDynamic", [&]() {{
+        return phi::distributed::VariadicReplicatedInferSpmdDynamic({0});
+    }}, {0});
+    DebugInfoForInferSpmd("{1}", spmd_info);
 """
 UNSUPPORTED_INFER_SPMD_COMMENT_TEMPLATE = """
     // API `{}` does not support InferSpmd now
@@ -269,8 +273,9 @@ INFER_GLOBAL_SHAPE_TEMPLATE = """
 # 4. Select Kernel
 KERNEL_SELECTION_TEMPLATE = """
       VLOG(6) << "{} API dist branch: kernel key: [" << kernel_backend << ", " << kernel_layout << ", "<< kernel_data_type << "]";
-      auto kernel_result = phi::KernelFactory::Instance().SelectKernelOrThrowError(
-          "{}", {{kernel_backend, kernel_layout, kernel_data_type}});
+      static thread_local phi::KernelSelectionCache dist_kernel_selection_cache("{}", false);
+      auto kernel_result = dist_kernel_selection_cache.Select(
+          {{kernel_backend, kernel_layout, kernel_data_type}});
       const auto& kernel = kernel_result.kernel;
       VLOG(6) << "{} kernel: " << kernel;
       dev_ctx = GetDeviceContextByBackend(kernel_result.has_fallback_cpu ? Backend::CPU : kernel_backend);
@@ -14,6 +14,7 @@
 
 #include "paddle/phi/backends/cpu/cpu_context.h"
 
+#include "paddle/phi/backends/cpu/intra_op_thread_pool.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/enforce.h"
 
@@ -50,6 +51,7 @@ struct CPUContext::Impl {
 
   bool owned_{false};
   Eigen::DefaultDevice* eigen_device_{nullptr};
+  IntraOpThreadPool* intra_op_thread_pool_{nullptr};
   Place place_;
 };
 
@@ -79,4 +81,13 @@ void CPUContext::SetEigenDevice(Eigen::DefaultDevice* device) {
   impl_->eigen_device_ = device;
 }
 
+IntraOpThreadPool* CPUContext::intra_op_thread_pool() const {
+  return impl_->intra_op_thread_pool_ ? impl_->intra_op_thread_pool_
+                                      : IntraOpThreadPool::Current();
+}
+
+void CPUContext::SetIntraOpThreadPool(IntraOpThreadPool* pool) {
+  impl_->intra_op_thread_pool_ = pool;
+}
+
 }  // namespace phi
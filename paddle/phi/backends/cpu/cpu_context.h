@@ -24,6 +24,8 @@ limitations under the License. */
 
 namespace phi {
 
+class IntraOpThreadPool;
+
 class PADDLE_API CPUContext : public DeviceContext,
                               public TypeInfoTraits<DeviceContext, CPUContext> {
  public:
@@ -35,6 +37,11 @@ class PADDLE_API CPUContext : public DeviceContext,
   Eigen::DefaultDevice* eigen_device() const;
   const Place& GetPlace() const override;
 
+  // The pool for the parallel loops of the kernels, the pool set to the
+  // context or else the current pool of the thread, null to run serially.
+  IntraOpThreadPool* intra_op_thread_pool() const;
+  void SetIntraOpThreadPool(IntraOpThreadPool* pool);
+
   static const char* name() { return "CPUContext"; }
 
  protected:
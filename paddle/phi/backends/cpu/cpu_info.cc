@@ -27,12 +27,22 @@ limitations under the License. */
 #include <unistd.h>
 #endif  // _WIN32
 
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
 #ifdef PADDLE_WITH_XBYAK
 #include "xbyak/xbyak_util.h"
 #endif
 
 #include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
 
+#include "glog/logging.h"
 #include "paddle/phi/core/flags.h"
 
 PD_DECLARE_double(fraction_of_cpu_memory_to_use);
@@ -199,6 +209,108 @@ bool MayIUse(const cpu_isa_t cpu_isa) {
 }
 #endif
 
+std::vector<int> ParseCpuList(const std::string& list) {
+  std::vector<int> cpus;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    item.erase(std::remove_if(item.begin(),
+                              item.end(),
+                              [](char c) { return std::isspace(c); }),
+               item.end());
+    if (item.empty()) continue;
+    auto dash = item.find('-');
+    int begin = std::stoi(item.substr(0, dash));
+    int end =
+        dash == std::string::npos ? begin : std::stoi(item.substr(dash + 1));
+    for (int cpu = begin; cpu <= end; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+static std::string ReadSysFile(const std::string& path) {
+  std::ifstream fin(path);
+  std::string content;
+  std::getline(fin, content);
+  return content;
+}
+
+int NumaNodeCount() {
+  static const int count = [] {
+    auto nodes = ParseCpuList(ReadSysFile("/sys/devices/system/node/online"));
+    return nodes.empty() ? 1 : nodes.back() + 1;
+  }();
+  return count;
+}
+
+std::vector<int> NumaNodeCpus(int node) {
+  return ParseCpuList(ReadSysFile("/sys/devices/system/node/node" +
+                                  std::to_string(node) + "/cpulist"));
+}
+
+// The numa syscalls are called directly, so that there is no dependency on
+// libnuma.
+static constexpr int kMpolPreferred = 1;
+
+static thread_local int current_thread_numa_node = -1;
+
+int CurrentThreadNumaNode() { return current_thread_numa_node; }
+
+bool BindCurrentThreadToNumaNode(int node) {
+#if defined(__linux__)
+  if (current_thread_numa_node == node) return true;
+  if (node < 0 || node >= 64) return false;
+  auto cpus = NumaNodeCpus(node);
+  if (cpus.empty()) return false;
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for (int cpu : cpus) {
+    if (cpu < CPU_SETSIZE) CPU_SET(cpu, &mask);
+  }
+  if (sched_setaffinity(0, sizeof(mask), &mask) != 0) {
+    LOG(WARNING) << "Failed to bind the thread to the cpus of numa node "
+                 << node;
+    return false;
+  }
+  uint64_t nodemask = uint64_t{1} << node;
+  if (syscall(SYS_set_mempolicy,
+              kMpolPreferred,
+              &nodemask,
+              sizeof(nodemask) * 8 + 1) != 0) {
+    VLOG(1) << "Failed to prefer the memory of numa node " << node;
+  }
+  current_thread_numa_node = node;
+  VLOG(3) << "Bind the thread to numa node " << node;
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool BindMemoryToNumaNode(void* ptr, size_t size, int node) {
+#if defined(__linux__)
+  if (node < 0 || node >= 64) return false;
+  // Only the pages entirely within the range, the pages shared with the
+  // neighbouring blocks are left as is.
+  const uintptr_t page = sysconf(_SC_PAGE_SIZE);
+  uintptr_t begin = (reinterpret_cast<uintptr_t>(ptr) + page - 1) / page * page;
+  uintptr_t end = (reinterpret_cast<uintptr_t>(ptr) + size) / page * page;
+  if (begin >= end) return false;
+  uint64_t nodemask = uint64_t{1} << node;
+  return syscall(SYS_mbind,
+                 reinterpret_cast<void*>(begin),
+                 end - begin,
+                 kMpolPreferred,
+                 &nodemask,
+                 sizeof(nodemask) * 8 + 1,
+                 0) == 0;
+#else
+  return false;
+#endif
+}
+
 }  // namespace cpu
 }  // namespace backends
 }  // namespace phi
@@ -16,6 +16,9 @@
 
 #include <stddef.h>
 
+#include <string>
+#include <vector>
+
 #ifdef _WIN32
 #if defined(__AVX2__)
 #include <immintrin.h>  // avx2
@@ -92,6 +95,25 @@ typedef enum {
 
 // May I use some instruction
 TEST_API bool MayIUse(const cpu_isa_t cpu_isa);
+
+//! Parse a cpu or node list of the sysfs, as "0-3,8,10-11".
+TEST_API std::vector<int> ParseCpuList(const std::string& list);
+
+//! Get the number of the numa nodes, 1 if the topology is unknown.
+TEST_API int NumaNodeCount();
+
+//! Get the cpus of a numa node, empty if the topology is unknown.
+TEST_API std::vector<int> NumaNodeCpus(int node);
+
+//! Pin the current thread to the cpus of a numa node, and prefer the memory
+//! of the node for the pages touched by the thread. Only works on linux.
+TEST_API bool BindCurrentThreadToNumaNode(int node);
+
+//! Get the numa node the current thread is bound to, -1 if it is not bound.
+TEST_API int CurrentThreadNumaNode();
+
+//! Prefer the memory of a numa node for the pages within [ptr, ptr + size).
+bool BindMemoryToNumaNode(void* ptr, size_t size, int node);
 }  // namespace cpu
 }  // namespace backends
 }  // namespace phi
@@ -0,0 +1,205 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "paddle/phi/backends/cpu/intra_op_thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/core/enforce.h"
+#include "unsupported/Eigen/CXX11/ThreadPool"
+
+namespace phi {
+
+static thread_local IntraOpThreadPool* current_pool = nullptr;
+static thread_local int current_thread_id = -1;
+static thread_local bool in_parallel_for = false;
+
+class EigenIntraOpThreadPool : public Eigen::ThreadPoolInterface {
+ public:
+  explicit EigenIntraOpThreadPool(IntraOpThreadPool* pool) : pool_(pool) {}
+
+  void Schedule(std::function<void()> fn) override {
+    pool_->Schedule(std::move(fn));
+  }
+
+  int NumThreads() const override { return pool_->NumThreads() - 1; }
+
+  int CurrentThreadId() const override {
+    return IntraOpThreadPool::CurrentThreadId();
+  }
+
+ private:
+  IntraOpThreadPool* pool_;
+};
+
+IntraOpThreadPool::IntraOpThreadPool(int num_threads, int numa_node) {
+  PADDLE_ENFORCE_GT(num_threads,
+                    0,
+                    phi::errors::InvalidArgument(
+                        "The number of the intra op threads should be "
+                        "greater than 0, but got %d.",
+                        num_threads));
+  // The caller runs a part of every loop, so one thread less is started.
+  for (int i = 0; i + 1 < num_threads; ++i) {
+    threads_.emplace_back([this, i, numa_node] { WorkerLoop(i, numa_node); });
+  }
+  eigen_pool_ = std::make_unique<EigenIntraOpThreadPool>(this);
+}
+
+IntraOpThreadPool::~IntraOpThreadPool() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void IntraOpThreadPool::WorkerLoop(int id, int numa_node) {
+  if (numa_node >= 0) {
+    phi::backends::cpu::BindCurrentThreadToNumaNode(numa_node);
+  }
+  current_thread_id = id;
+  current_pool = this;
+  // The loops of the tasks run serially on the workers, so that a worker
+  // never waits for the tasks queued behind it.
+  in_parallel_for = true;
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) return;
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+void IntraOpThreadPool::Schedule(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    tasks_.emplace_back(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+namespace {
+
+struct alignas(64) LoopPart {
+  std::atomic<int64_t> next{0};
+  int64_t end{0};
+};
+
+// The state of a ParallelFor, which lives on the stack of the caller until
+// all the participants are done.
+struct LoopState {
+  int64_t begin;
+  int64_t end;
+  int64_t grain;
+  const std::function<void(int64_t, int64_t)>* fn;
+  std::unique_ptr<LoopPart[]> parts;
+  int num_parts;
+
+  std::mutex mutex;
+  std::condition_variable done_cv;
+  int pending{0};
+  std::exception_ptr error;
+
+  void Run(int self) {
+    bool old_in_parallel_for = in_parallel_for;
+    in_parallel_for = true;
+    try {
+      for (int k = 0; k < num_parts; ++k) {
+        LoopPart& part = parts[(self + k) % num_parts];
+        int64_t chunk;
+        while ((chunk = part.next.fetch_add(1, std::memory_order_relaxed)) <
+               part.end) {
+          int64_t chunk_begin = begin + chunk * grain;
+          (*fn)(chunk_begin, std::min(end, chunk_begin + grain));
+        }
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> guard(mutex);
+      if (!error) error = std::current_exception();
+    }
+    in_parallel_for = old_in_parallel_for;
+  }
+};
+
+}  // namespace
+
+void IntraOpThreadPool::ParallelFor(
+    int64_t begin,
+    int64_t end,
+    int64_t grain,
+    const std::function<void(int64_t, int64_t)>& fn) {
+  if (begin >= end) return;
+  grain = std::max<int64_t>(grain, 1);
+  const int64_t num_chunks = (end - begin + grain - 1) / grain;
+  const int num_parts =
+      static_cast<int>(std::min<int64_t>(NumThreads(), num_chunks));
+  if (num_parts <= 1 || in_parallel_for) {
+    fn(begin, end);
+    return;
+  }
+
+  LoopState state;
+  state.begin = begin;
+  state.end = end;
+  state.grain = grain;
+  state.fn = &fn;
+  state.num_parts = num_parts;
+  state.parts.reset(new LoopPart[num_parts]);
+  for (int i = 0; i < num_parts; ++i) {
+    state.parts[i].next.store(num_chunks * i / num_parts,
+                              std::memory_order_relaxed);
+    state.parts[i].end = num_chunks * (i + 1) / num_parts;
+  }
+  state.pending = num_parts - 1;
+  for (int i = 1; i < num_parts; ++i) {
+    Schedule([&state, i] {
+      state.Run(i);
+      std::lock_guard<std::mutex> guard(state.mutex);
+      if (--state.pending == 0) state.done_cv.notify_one();
+    });
+  }
+  state.Run(0);
+  {
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.done_cv.wait(lock, [&state] { return state.pending == 0; });
+  }
+  if (state.error) std::rethrow_exception(state.error);
+}
+
+Eigen::ThreadPoolInterface* IntraOpThreadPool::eigen_pool() {
+  return eigen_pool_.get();
+}
+
+int IntraOpThreadPool::CurrentThreadId() { return current_thread_id; }
+
+IntraOpThreadPool* IntraOpThreadPool::Current() { return current_pool; }
+
+void IntraOpThreadPool::SetCurrent(IntraOpThreadPool* pool) {
+  current_pool = pool;
+}
+
+}  // namespace phi
@@ -0,0 +1,93 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/utils/test_macros.h"
+
+namespace Eigen {
+class ThreadPoolInterface;
+}  // namespace Eigen
+
+namespace phi {
+
+// The pool running the parallel loops inside the CPU kernels, shared by the
+// kernels and the Eigen devices of a predictor, so that the concurrent
+// predictors take a bounded number of cores instead of each running its own
+// threads:
+//
+//   IntraOpThreadPool::SetCurrent(&pool);
+//   ...
+//   dev_ctx.intra_op_thread_pool()->ParallelFor(
+//       0, n, 1024, [&](int64_t begin, int64_t end) { ... });
+//
+// A loop is split into the chunks of the grain size. The caller and the
+// workers first take the chunks of their own parts of the loop, then steal
+// the chunks left in the parts of the others. The loops started inside a
+// loop run serially on their thread.
+class TEST_API IntraOpThreadPool {
+ public:
+  // The threads are bound to the numa node if it is not negative.
+  explicit IntraOpThreadPool(int num_threads, int numa_node = -1);
+
+  ~IntraOpThreadPool();
+
+  // The number of the threads running a loop, the caller included.
+  int NumThreads() const { return static_cast<int>(threads_.size()) + 1; }
+
+  // Runs fn(chunk_begin, chunk_end) over [begin, end), and rethrows the
+  // first exception thrown by fn after all the chunks are done.
+  void ParallelFor(int64_t begin,
+                   int64_t end,
+                   int64_t grain,
+                   const std::function<void(int64_t, int64_t)>& fn);
+
+  // Runs the task on a worker, for the Eigen devices.
+  void Schedule(std::function<void()> task);
+
+  // The Eigen view of the pool, for an Eigen::ThreadPoolDevice.
+  Eigen::ThreadPoolInterface* eigen_pool();
+
+  // The index of the worker of the current thread, -1 outside of the pools.
+  static int CurrentThreadId();
+
+  // The pool of the CPU kernels run on the current thread, may be null.
+  static IntraOpThreadPool* Current();
+  static void SetCurrent(IntraOpThreadPool* pool);
+
+ private:
+  void WorkerLoop(int id, int numa_node);
+
+  std::vector<std::thread> threads_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_{false};
+  std::unique_ptr<Eigen::ThreadPoolInterface> eigen_pool_;
+
+  DISABLE_COPY_AND_ASSIGN(IntraOpThreadPool);
+};
+
+}  // namespace phi
@@ -890,6 +890,47 @@ class CustomDevice : public DeviceInterface {
                            y));
   }
 
+  // Graph
+  bool IsGraphCaptureSupported(size_t dev_id) override {
+    return pimpl_->stream_begin_capture && pimpl_->stream_end_capture &&
+           pimpl_->graph_launch && pimpl_->graph_destroy;
+  }
+
+  void StreamBeginCapture(size_t dev_id,
+                          const stream::Stream& stream) override {
+    CHECK_PTR(pimpl_->stream_begin_capture);
+    const auto device = &devices_pool[dev_id];
+    PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(pimpl_->stream_begin_capture(
+        device, reinterpret_cast<C_Stream>(stream.raw_stream())));
+  }
+
+  void* StreamEndCapture(size_t dev_id, const stream::Stream& stream) override {
+    CHECK_PTR(pimpl_->stream_end_capture);
+    const auto device = &devices_pool[dev_id];
+    C_Graph graph = nullptr;
+    PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(pimpl_->stream_end_capture(
+        device, reinterpret_cast<C_Stream>(stream.raw_stream()), &graph));
+    return reinterpret_cast<void*>(graph);
+  }
+
+  void GraphLaunch(size_t dev_id,
+                   const stream::Stream& stream,
+                   void* graph) override {
+    CHECK_PTR(pimpl_->graph_launch);
+    const auto device = &devices_pool[dev_id];
+    PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(
+        pimpl_->graph_launch(device,
+                             reinterpret_cast<C_Stream>(stream.raw_stream()),
+                             reinterpret_cast<C_Graph>(graph)));
+  }
+
+  void GraphDestroy(size_t dev_id, void* graph) override {
+    CHECK_PTR(pimpl_->graph_destroy);
+    const auto device = &devices_pool[dev_id];
+    PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(
+        pimpl_->graph_destroy(device, reinterpret_cast<C_Graph>(graph)));
+  }
+
   // Profiler
   void ProfilerInitialize(phi::TraceEventCollector* collector,
                           void** user_data) override {
@@ -1044,6 +1085,10 @@ bool ValidCustomCustomRuntimeParams(const CustomRuntimeParams* params) {
   CHECK_INTERFACE(xccl_recv, false);
 
   CHECK_INTERFACE(blas_axpby, false);
+  CHECK_INTERFACE(stream_begin_capture, false);
+  CHECK_INTERFACE(stream_end_capture, false);
+  CHECK_INTERFACE(graph_launch, false);
+  CHECK_INTERFACE(graph_destroy, false);
 
   CHECK_INTERFACE(profiler_initialize, false);
   CHECK_INTERFACE(profiler_finalize, false);
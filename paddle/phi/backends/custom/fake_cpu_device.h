@@ -222,6 +222,33 @@ C_Status BlasAXPBY(const C_Device device,
   return C_SUCCESS;
 }
 
+// The tasks are executed at the launch on the fake device, so a graph only
+// counts its launches.
+struct C_Graph_st {
+  size_t launches;
+};
+
+C_Status StreamBeginCapture(const C_Device device, C_Stream stream) {
+  return C_SUCCESS;
+}
+
+C_Status StreamEndCapture(const C_Device device,
+                          C_Stream stream,
+                          C_Graph *graph) {
+  *graph = new C_Graph_st{0};
+  return C_SUCCESS;
+}
+
+C_Status GraphLaunch(const C_Device device, C_Stream stream, C_Graph graph) {
+  graph->launches++;
+  return C_SUCCESS;
+}
+
+C_Status GraphDestroy(const C_Device device, C_Graph graph) {
+  delete graph;
+  return C_SUCCESS;
+}
+
 #define DEVICE_TYPE "FakeCPU"
 #define SUB_DEVICE_TYPE "V100"
 
@@ -292,4 +319,9 @@ void InitFakeCPUDevice(CustomRuntimeParams *params) {
   params->interface->xccl_recv = XcclRecv;
 
   params->interface->blas_axpby = BlasAXPBY;
+
+  params->interface->stream_begin_capture = StreamBeginCapture;
+  params->interface->stream_end_capture = StreamEndCapture;
+  params->interface->graph_launch = GraphLaunch;
+  params->interface->graph_destroy = GraphDestroy;
 }
@@ -378,6 +378,30 @@ void DeviceInterface::BlasAXPBY(size_t dev_id,
   INTERFACE_UNIMPLEMENT;
 }
 
+// graph
+bool DeviceInterface::IsGraphCaptureSupported(size_t dev_id) { return false; }
+
+void DeviceInterface::StreamBeginCapture(size_t dev_id,
+                                         const stream::Stream& stream) {
+  INTERFACE_UNIMPLEMENT;
+}
+
+void* DeviceInterface::StreamEndCapture(size_t dev_id,
+                                        const stream::Stream& stream) {
+  INTERFACE_UNIMPLEMENT;
+  return nullptr;
+}
+
+void DeviceInterface::GraphLaunch(size_t dev_id,
+                                  const stream::Stream& stream,
+                                  void* graph) {
+  INTERFACE_UNIMPLEMENT;
+}
+
+void DeviceInterface::GraphDestroy(size_t dev_id, void* graph) {
+  INTERFACE_UNIMPLEMENT;
+}
+
 // profiler
 void DeviceInterface::ProfilerInitialize(phi::TraceEventCollector* collector,
                                          void** user_data) {
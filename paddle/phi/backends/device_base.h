@@ -248,6 +248,21 @@ class DeviceInterface {  // Driver / Runtime
                          float beta,
                          void* y);
 
+  // graph
+  virtual bool IsGraphCaptureSupported(size_t dev_id);
+
+  virtual void StreamBeginCapture(size_t dev_id, const stream::Stream& stream);
+
+  // Returns the graph of the tasks launched on the stream since the capture
+  // began, which is owned by the caller and destroyed by GraphDestroy.
+  virtual void* StreamEndCapture(size_t dev_id, const stream::Stream& stream);
+
+  virtual void GraphLaunch(size_t dev_id,
+                           const stream::Stream& stream,
+                           void* graph);
+
+  virtual void GraphDestroy(size_t dev_id, void* graph);
+
   // profiler
   virtual void ProfilerInitialize(phi::TraceEventCollector* collector,
                                   void** user_data);
@@ -16,9 +16,17 @@ limitations under the License. */
 
 #include <glog/logging.h>
 #include <sys/stat.h>
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
 
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
 #include <set>
+#include <sstream>
 #include <utility>
 
 #include "paddle/phi/backends/context_pool.h"
@@ -26,6 +34,7 @@ limitations under the License. */
 #include "paddle/phi/core/flags.h"
 
 PHI_DECLARE_string(cuda_dir);
+PHI_DECLARE_string(fusion_group_cache_dir);
 
 namespace phi {
 
@@ -217,6 +226,62 @@ static std::string FindCUDAIncludePath() {
   return "";
 }
 
+#ifndef PADDLE_WITH_HIP
+std::string GPUDeviceCode::PTXCachePath(
+    const std::vector<const char*>& options) const {
+  if (FLAGS_fusion_group_cache_dir.empty()) {
+    return "";
+  }
+  std::string key = kernel_;
+  for (auto* option : options) {
+    key += "\n";
+    key += option;
+  }
+  std::ostringstream os;
+  os << FLAGS_fusion_group_cache_dir << "/" << name_ << "_" << std::hex
+     << std::hash<std::string>()(key) << ".ptx";
+  return os.str();
+}
+
+bool GPUDeviceCode::ReadPTXCache(const std::string& path,
+                                 std::vector<char>* ptx) {
+  std::ifstream fin(path, std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+  ptx->assign(std::istreambuf_iterator<char>(fin),
+              std::istreambuf_iterator<char>());
+  if (ptx->empty() || ptx->back() != '\0') {
+    LOG(WARNING) << "Ignore the broken PTX cache " << path;
+    ptx->clear();
+    return false;
+  }
+  VLOG(3) << "Load the PTX of " << name_ << " from " << path;
+  return true;
+}
+
+void GPUDeviceCode::WritePTXCache(const std::string& path,
+                                  const std::vector<char>& ptx) {
+  // Write to a temporary file and rename, so that the jobs sharing the
+  // directory never read a partial file.
+  std::string tmp_path = path + ".tmp";
+#if !defined(_WIN32)
+  mkdir(FLAGS_fusion_group_cache_dir.c_str(), 0755);
+  tmp_path += std::to_string(getpid());
+#endif
+  {
+    std::ofstream fout(tmp_path, std::ios::binary);
+    if (!fout.write(ptx.data(), ptx.size())) {
+      LOG(WARNING) << "Failed to write the PTX cache " << tmp_path;
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+  }
+}
+#endif
+
 GPUDeviceCode::GPUDeviceCode(const Place& place,
                              const std::string& name,
                              const std::string& kernel) {
@@ -319,18 +384,6 @@ bool GPUDeviceCode::Compile(bool include_path) {
     return false;
   }
 #else
-  nvrtcProgram program;
-  if (!CheckNVRTCResult(dynload::nvrtcCreateProgram(&program,
-                                                    kernel_.c_str(),  // buffer
-                                                    name_.c_str(),    // name
-                                                    0,         // numHeaders
-                                                    nullptr,   // headers
-                                                    nullptr),  // includeNames
-                        "nvrtcCreateProgram")) {
-    return false;
-  }
-
-  // Compile the program for specified compute_capability
   auto* dev_ctx = reinterpret_cast<phi::GPUContext*>(
       DeviceContextPool::Instance().Get(place_));
   int compute_capability = dev_ctx->GetComputeCapability();
@@ -345,45 +398,68 @@ bool GPUDeviceCode::Compile(bool include_path) {
       options.push_back(include_option.c_str());
     }
   }
-  nvrtcResult compile_result =
-      dynload::nvrtcCompileProgram(program,          // program
-                                   options.size(),   // numOptions
-                                   options.data());  // options
-  if (compile_result == NVRTC_ERROR_COMPILATION) {
-    // Obtain compilation log from the program
-    size_t log_size;
-    if (!CheckNVRTCResult(dynload::nvrtcGetProgramLogSize(program, &log_size),
-                          "nvrtcGetProgramLogSize")) {
+  // The PTX is cached by the hash of the kernel source and the options, and
+  // loaded instead of compiling again when the cache directory is set.
+  std::string cache_path = PTXCachePath(options);
+  if (cache_path.empty() || !ReadPTXCache(cache_path, &ptx_)) {
+    nvrtcProgram program;
+    if (!CheckNVRTCResult(
+            dynload::nvrtcCreateProgram(&program,
+                                        kernel_.c_str(),  // buffer
+                                        name_.c_str(),    // name
+                                        0,                // numHeaders
+                                        nullptr,          // headers
+                                        nullptr),         // includeNames
+            "nvrtcCreateProgram")) {
       return false;
     }
-    std::vector<char> log;
-    log.resize(log_size + 1);
-    if (!CheckNVRTCResult(dynload::nvrtcGetProgramLog(program, log.data()),
-                          "nvrtcGetProgramLog")) {
+
+    // Compile the program for specified compute_capability
+    nvrtcResult compile_result =
+        dynload::nvrtcCompileProgram(program,          // program
+                                     options.size(),   // numOptions
+                                     options.data());  // options
+    if (compile_result == NVRTC_ERROR_COMPILATION) {
+      // Obtain compilation log from the program
+      size_t log_size;
+      if (!CheckNVRTCResult(
+              dynload::nvrtcGetProgramLogSize(program, &log_size),
+              "nvrtcGetProgramLogSize")) {
+        return false;
+      }
+      std::vector<char> log;
+      log.resize(log_size + 1);
+      if (!CheckNVRTCResult(dynload::nvrtcGetProgramLog(program, log.data()),
+                            "nvrtcGetProgramLog")) {
+        return false;
+      }
+      LOG(WARNING) << "JIT compiling of CUDA code failed:"
+                   << "\n  Kernel name: " << name_ << "\n  Kernel body:\n"
+                   << kernel_ << "\n  Compiling log: " << log.data();
+
       return false;
     }
-    LOG(WARNING) << "JIT compiling of CUDA code failed:"
-                 << "\n  Kernel name: " << name_ << "\n  Kernel body:\n"
-                 << kernel_ << "\n  Compiling log: " << log.data();
 
-    return false;
-  }
+    // Obtain PTX from the program
+    size_t ptx_size;
+    if (!CheckNVRTCResult(dynload::nvrtcGetPTXSize(program, &ptx_size),
+                          "nvrtcGetPTXSize")) {
+      return false;
+    }
+    ptx_.resize(ptx_size + 1);
+    if (!CheckNVRTCResult(dynload::nvrtcGetPTX(program, ptx_.data()),
+                          "nvrtcGetPTX")) {
+      return false;
+    }
 
-  // Obtain PTX from the program
-  size_t ptx_size;
-  if (!CheckNVRTCResult(dynload::nvrtcGetPTXSize(program, &ptx_size),
-                        "nvrtcGetPTXSize")) {
-    return false;
-  }
-  ptx_.resize(ptx_size + 1);
-  if (!CheckNVRTCResult(dynload::nvrtcGetPTX(program, ptx_.data()),
-                        "nvrtcGetPTX")) {
-    return false;
-  }
+    if (!CheckNVRTCResult(dynload::nvrtcDestroyProgram(&program),
+                          "nvrtcDestroyProgram")) {
+      return false;
+    }
 
-  if (!CheckNVRTCResult(dynload::nvrtcDestroyProgram(&program),
-                        "nvrtcDestroyProgram")) {
-    return false;
+    if (!cache_path.empty()) {
+      WritePTXCache(cache_path, ptx_);
+    }
   }
 
   if (!CheckCUDADriverResult(dynload::cuModuleLoadData(&module_, ptx_.data()),
@@ -70,6 +70,12 @@ class GPUDeviceCode : public DeviceCode {
   bool CheckNVRTCResult(hiprtcResult result, std::string function);
 #else
   bool CheckNVRTCResult(nvrtcResult result, std::string function);
+
+  // The path of the cached PTX, empty if FLAGS_fusion_group_cache_dir is not
+  // set.
+  std::string PTXCachePath(const std::vector<const char*>& options) const;
+  bool ReadPTXCache(const std::string& path, std::vector<char>* ptx);
+  void WritePTXCache(const std::string& path, const std::vector<char>& ptx);
 #endif
 
   static bool available_;
@@ -71,6 +71,8 @@ typedef struct C_Stream_st* C_Stream;
 
 typedef struct C_Event_st* C_Event;
 
+typedef struct C_Graph_st* C_Graph;
+
 typedef void (*C_Callback)(C_Device device,
                            C_Stream stream,
                            void* user_data,
@@ -687,7 +689,50 @@ struct C_DeviceInterface {
                          void* x,
                          float beta,
                          void* y);
-  void* reserved_other_api[7];
+
+  /**
+   * @brief Begin capturing the tasks launched on a stream into a graph,
+   * the tasks are recorded instead of executed until the capture ends.
+   * The graph api is optional, the capture is supported only if all of
+   * stream_begin_capture, stream_end_capture, graph_launch and
+   * graph_destroy are implemented
+   *
+   * @param[C_Device] device     Core fill it with a physical id
+   * @param[C_Stream] stream
+   */
+  C_Status (*stream_begin_capture)(const C_Device device, C_Stream stream);
+
+  /**
+   * @brief End capturing a stream and instantiate the graph of the tasks
+   *
+   * @param[C_Device] device     Core fill it with a physical id
+   * @param[C_Stream] stream
+   * @param[C_Graph*] graph      Plugin create the graph
+   */
+  C_Status (*stream_end_capture)(const C_Device device,
+                                 C_Stream stream,
+                                 C_Graph* graph);
+
+  /**
+   * @brief Launch all the tasks of a graph on a stream
+   *
+   * @param[C_Device] device     Core fill it with a physical id
+   * @param[C_Stream] stream
+   * @param[C_Graph]  graph
+   */
+  C_Status (*graph_launch)(const C_Device device,
+                           C_Stream stream,
+                           C_Graph graph);
+
+  /**
+   * @brief Destroy a graph
+   *
+   * @param[C_Device] device     Core fill it with a physical id
+   * @param[C_Graph]  graph
+   */
+  C_Status (*graph_destroy)(const C_Device device, C_Graph graph);
+
+  void* reserved_other_api[3];
 };
 
 struct CustomRuntimeVersion {
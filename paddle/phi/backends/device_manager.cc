@@ -508,6 +508,45 @@ std::vector<size_t> DeviceManager::GetSelectedDeviceList(
   return device_list_map[device_type];
 }
 
+bool DeviceManager::IsGraphCaptureSupported(const Place& place) {
+  auto device_type = place.GetDeviceType();
+  auto device_id = place.GetDeviceId();
+  auto dev_impl = GetDeviceInterfaceWithType(device_type);
+  return dev_impl->IsGraphCaptureSupported(device_id);
+}
+
+void DeviceManager::StreamBeginCapture(const Place& place,
+                                       const stream::Stream& stream) {
+  auto device_type = place.GetDeviceType();
+  auto device_id = place.GetDeviceId();
+  auto dev_impl = GetDeviceInterfaceWithType(device_type);
+  dev_impl->StreamBeginCapture(device_id, stream);
+}
+
+void* DeviceManager::StreamEndCapture(const Place& place,
+                                      const stream::Stream& stream) {
+  auto device_type = place.GetDeviceType();
+  auto device_id = place.GetDeviceId();
+  auto dev_impl = GetDeviceInterfaceWithType(device_type);
+  return dev_impl->StreamEndCapture(device_id, stream);
+}
+
+void DeviceManager::GraphLaunch(const Place& place,
+                                const stream::Stream& stream,
+                                void* graph) {
+  auto device_type = place.GetDeviceType();
+  auto device_id = place.GetDeviceId();
+  auto dev_impl = GetDeviceInterfaceWithType(device_type);
+  dev_impl->GraphLaunch(device_id, stream, graph);
+}
+
+void DeviceManager::GraphDestroy(const Place& place, void* graph) {
+  auto device_type = place.GetDeviceType();
+  auto device_id = place.GetDeviceId();
+  auto dev_impl = GetDeviceInterfaceWithType(device_type);
+  dev_impl->GraphDestroy(device_id, graph);
+}
+
 void DeviceManager::CCLDestroyComm(const std::string& device_type,
                                    ccl::CCLComm ccl_comm) {
   auto dev_impl = GetDeviceInterfaceWithType(device_type);
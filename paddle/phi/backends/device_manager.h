@@ -177,6 +177,21 @@ class DeviceManager {
   static std::vector<size_t> GetSelectedDeviceList(
       const std::string& device_type);
 
+  // Graph
+  static bool IsGraphCaptureSupported(const Place& place);
+
+  static void StreamBeginCapture(const Place& place,
+                                 const stream::Stream& stream);
+
+  static void* StreamEndCapture(const Place& place,
+                                const stream::Stream& stream);
+
+  static void GraphLaunch(const Place& place,
+                          const stream::Stream& stream,
+                          void* graph);
+
+  static void GraphDestroy(const Place& place, void* graph);
+
   // CCL
   static void CCLDestroyComm(const std::string& device_type,
                              ccl::CCLComm ccl_comm);
@@ -0,0 +1,36 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/backends/dynload/cufile.h"
+
+#ifdef PADDLE_WITH_CUFILE
+namespace phi {
+namespace dynload {
+
+std::once_flag cufile_dso_flag;
+void* cufile_dso_handle = nullptr;
+
+#define DEFINE_WRAP(__name) struct DynLoad__##__name __name
+
+CUFILE_ROUTINE_EACH(DEFINE_WRAP);
+
+bool HasCuFile() {
+  std::call_once(cufile_dso_flag,
+                 []() { cufile_dso_handle = GetCuFileDsoHandle(); });
+  return cufile_dso_handle != nullptr;
+}
+
+}  // namespace dynload
+}  // namespace phi
+#endif
@@ -0,0 +1,68 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// cuFile (GPUDirect Storage) ships with the CUDA toolkit on linux only, and
+// is loaded at runtime so that paddle still runs on the machines without it.
+#if defined(PADDLE_WITH_CUDA) && defined(__linux__) && \
+    defined(__has_include)
+#if __has_include(<cufile.h>)
+#define PADDLE_WITH_CUFILE
+#endif
+#endif
+
+#ifdef PADDLE_WITH_CUFILE
+#include <cufile.h>
+
+#include <mutex>  // NOLINT
+
+#include "paddle/phi/backends/dynload/dynamic_loader.h"
+#include "paddle/phi/backends/dynload/port.h"
+
+namespace phi {
+namespace dynload {
+
+extern std::once_flag cufile_dso_flag;
+extern void* cufile_dso_handle;
+extern bool HasCuFile();
+
+#define DECLARE_DYNAMIC_LOAD_CUFILE_WRAP(__name)                     \
+  struct DynLoad__##__name {                                         \
+    template <typename... Args>                                      \
+    auto operator()(Args... args) -> DECLARE_TYPE(__name, args...) { \
+      using cufile_func = decltype(&::__name);                       \
+      std::call_once(cufile_dso_flag, []() {                         \
+        cufile_dso_handle = phi::dynload::GetCuFileDsoHandle();      \
+      });                                                            \
+      static void* p_##__name = dlsym(cufile_dso_handle, #__name);   \
+      return reinterpret_cast<cufile_func>(p_##__name)(args...);     \
+    }                                                                \
+  };                                                                 \
+  extern struct DynLoad__##__name __name
+
+#define CUFILE_ROUTINE_EACH(__macro) \
+  __macro(cuFileDriverOpen);         \
+  __macro(cuFileHandleRegister);     \
+  __macro(cuFileHandleDeregister);   \
+  __macro(cuFileRead);
+
+CUFILE_ROUTINE_EACH(DECLARE_DYNAMIC_LOAD_CUFILE_WRAP);
+
+#undef DECLARE_DYNAMIC_LOAD_CUFILE_WRAP
+
+}  // namespace dynload
+}  // namespace phi
+
+#endif
@@ -414,6 +414,14 @@ void* GetNvjpegDsoHandle() {
 #endif
 }
 
+void* GetCuFileDsoHandle() {
+#if defined(__linux__) && defined(PADDLE_WITH_CUDA)
+  return GetDsoHandleFromSearchPath(FLAGS_cuda_dir, "libcufile.so", false);
+#else
+  return nullptr;
+#endif
+}
+
 void* GetCusolverDsoHandle() {
 #if defined(__APPLE__) || defined(__OSX__)
   return GetDsoHandleFromSearchPath(FLAGS_cuda_dir, "libcusolver.dylib");
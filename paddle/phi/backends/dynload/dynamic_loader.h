@@ -30,6 +30,7 @@ void* GetCUDNNDsoHandle();
 void* GetCUPTIDsoHandle();
 void* GetCurandDsoHandle();
 void* GetNvjpegDsoHandle();
+void* GetCuFileDsoHandle();
 void* GetCusolverDsoHandle();
 void* GetCusparseDsoHandle();
 void* GetNVRTCDsoHandle();
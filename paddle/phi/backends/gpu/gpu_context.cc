@@ -27,6 +27,7 @@ limitations under the License. */
 #include "paddle/common/exception.h"
 #include "paddle/phi/backends/context_pool.h"
 #include "paddle/phi/backends/gpu/gpu_decls.h"
+#include "paddle/phi/backends/gpu/gpu_event_pool.h"
 #include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/backends/gpu/gpu_resources.h"
 #include "paddle/phi/common/place.h"
@@ -684,6 +685,16 @@ struct GPUContext::Impl {
   }
 
   void AddStreamCallback(const std::function<void()>& callback) const {
+    if (backends::gpu::UseStreamCallbackPoller(stream())) {
+      std::lock_guard<std::mutex> lock(stream_call_back_mtx_);
+      if (callback_poller_ == nullptr) {
+        callback_poller_ =
+            std::make_unique<backends::gpu::StreamCallbackPoller>(
+                place_.device);
+      }
+      callback_poller_->AddCallback(stream(), callback);
+      return;
+    }
     // NOTE(zhiqiu): better use threadpool here, otherwise "std::async" may
     // launch too many threads and result in thread oversubscription.
     auto* callback_func = new std::function<void()>(callback);
@@ -715,11 +726,16 @@ struct GPUContext::Impl {
 #if defined(PADDLE_WITH_HIP) || defined(PADDLE_WITH_CUDA)
     phi::backends::gpu::GpuStreamSync(stream());
 #endif
+    backends::gpu::StreamCallbackPoller* poller = nullptr;
     {
       std::lock_guard<std::mutex> lock(stream_call_back_mtx_);
       if (last_future_.valid()) {
         last_future_.wait();
       }
+      poller = callback_poller_.get();
+    }
+    if (poller != nullptr) {
+      poller->Wait();
     }
   }
 
@@ -801,6 +817,8 @@ struct GPUContext::Impl {
   mutable std::mutex sparse_mtx_;
   mutable std::mutex stream_call_back_mtx_;
   mutable std::future<void> last_future_;
+  mutable std::unique_ptr<backends::gpu::StreamCallbackPoller>
+      callback_poller_;
 
   Allocator* allocator_{nullptr};  // external resource.
   // A internal resouce to initinalize eigen_device.
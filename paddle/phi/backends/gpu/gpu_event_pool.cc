@@ -0,0 +1,174 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/backends/gpu/gpu_event_pool.h"
+
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_bool(gpu_stream_callback_polling);
+
+namespace phi {
+namespace backends {
+namespace gpu {
+
+#ifdef PADDLE_WITH_HIP
+static constexpr unsigned int kCallbackEventFlags = hipEventDisableTiming;
+#else
+static constexpr unsigned int kCallbackEventFlags = cudaEventDisableTiming;
+#endif
+
+static bool IsEventCompleted(gpuEvent_t event) {
+#ifdef PADDLE_WITH_HIP
+  gpuError_t err = hipEventQuery(event);
+  if (err == hipErrorNotReady) {
+    return false;
+  }
+#else
+  gpuError_t err = cudaEventQuery(event);
+  if (err == cudaErrorNotReady) {
+    return false;
+  }
+#endif
+  PADDLE_ENFORCE_GPU_SUCCESS(err);
+  return true;
+}
+
+GpuEventPool& GpuEventPool::Instance() {
+  // Never destroyed, the events may be released by the contexts at exit.
+  static GpuEventPool* pool = new GpuEventPool();
+  return *pool;
+}
+
+gpuEvent_t GpuEventPool::Acquire(int device, unsigned int flags) {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto& events = free_events_[std::make_pair(device, flags)];
+    if (!events.empty()) {
+      gpuEvent_t event = events.back();
+      events.pop_back();
+      return event;
+    }
+  }
+  GPUDeviceGuard guard(device);
+  gpuEvent_t event;
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventCreateWithFlags(&event, flags));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventCreateWithFlags(&event, flags));
+#endif
+  return event;
+}
+
+void GpuEventPool::Release(int device, unsigned int flags, gpuEvent_t event) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  free_events_[std::make_pair(device, flags)].push_back(event);
+}
+
+size_t GpuEventPool::FreeSize(int device, unsigned int flags) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return free_events_[std::make_pair(device, flags)].size();
+}
+
+StreamCallbackPoller::~StreamCallbackPoller() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stop_ = true;
+  }
+  pending_cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void StreamCallbackPoller::AddCallback(gpuStream_t stream,
+                                       std::function<void()> callback) {
+  gpuEvent_t event =
+      GpuEventPool::Instance().Acquire(device_, kCallbackEventFlags);
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(event, stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event, stream));
+#endif
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    pending_.push_back({event, std::move(callback)});
+    ++num_added_;
+    if (!thread_.joinable()) {
+      thread_ = std::thread([this] { Loop(); });
+    }
+  }
+  pending_cv_.notify_one();
+}
+
+void StreamCallbackPoller::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  size_t target = num_added_;
+  done_cv_.wait(lock, [this, target] { return num_done_ >= target; });
+}
+
+void StreamCallbackPoller::Loop() {
+  GPUDeviceGuard device_guard(device_);
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    pending_cv_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+    if (pending_.empty()) {
+      return;
+    }
+    gpuEvent_t earliest = pending_.front().event;
+    lock.unlock();
+#ifdef PADDLE_WITH_HIP
+    PADDLE_ENFORCE_GPU_SUCCESS(hipEventSynchronize(earliest));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(earliest));
+#endif
+    lock.lock();
+    // The callbacks behind the earliest one are run in the same group if
+    // their events are completed too.
+    std::vector<PendingCallback> group;
+    do {
+      group.emplace_back(std::move(pending_.front()));
+      pending_.pop_front();
+    } while (!pending_.empty() && IsEventCompleted(pending_.front().event));
+    lock.unlock();
+    for (auto& item : group) {
+      item.callback();
+      GpuEventPool::Instance().Release(
+          device_, kCallbackEventFlags, item.event);
+    }
+    lock.lock();
+    num_done_ += group.size();
+    done_cv_.notify_all();
+  }
+}
+
+bool UseStreamCallbackPoller(gpuStream_t stream) {
+  if (!FLAGS_gpu_stream_callback_polling) {
+    return false;
+  }
+#ifdef PADDLE_WITH_CUDA
+  cudaStreamCaptureStatus status;
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamIsCapturing(stream, &status));
+  return status == cudaStreamCaptureStatusNone;
+#else
+  hipStreamCaptureStatus status;
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamIsCapturing(stream, &status));
+  return status == hipStreamCaptureStatusNone;
+#endif
+}
+
+}  // namespace gpu
+}  // namespace backends
+}  // namespace phi
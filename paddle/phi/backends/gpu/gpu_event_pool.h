@@ -0,0 +1,103 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/phi/backends/gpu/gpu_decls.h"
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+namespace backends {
+namespace gpu {
+
+// The recycled events of every device and flags, so that the events of short
+// lives are not created and destroyed for every use.
+class TEST_API GpuEventPool {
+ public:
+  static GpuEventPool& Instance();
+
+  gpuEvent_t Acquire(int device, unsigned int flags);
+
+  void Release(int device, unsigned int flags, gpuEvent_t event);
+
+  size_t FreeSize(int device, unsigned int flags);
+
+ private:
+  GpuEventPool() = default;
+
+  std::mutex mutex_;
+  std::map<std::pair<int, unsigned int>, std::vector<gpuEvent_t>> free_events_;
+
+  DISABLE_COPY_AND_ASSIGN(GpuEventPool);
+};
+
+// Runs the host callbacks of the streams of a device context in the order
+// they are added. Instead of a host function launched on the stream for every
+// callback, an event of the pool is recorded on the stream, and a thread waits
+// for the earliest pending event and runs the callbacks of all the completed
+// events as a group.
+class TEST_API StreamCallbackPoller {
+ public:
+  explicit StreamCallbackPoller(int device) : device_(device) {}
+
+  ~StreamCallbackPoller();
+
+  void AddCallback(gpuStream_t stream, std::function<void()> callback);
+
+  // Waits for the callbacks added before, the streams are not synchronized.
+  void Wait();
+
+ private:
+  struct PendingCallback {
+    gpuEvent_t event;
+    std::function<void()> callback;
+  };
+
+  void Loop();
+
+  const int device_;
+  std::mutex mutex_;
+  std::condition_variable pending_cv_;
+  std::condition_variable done_cv_;
+  std::deque<PendingCallback> pending_;
+  size_t num_added_{0};
+  size_t num_done_{0};
+  bool stop_{false};
+  std::thread thread_;
+
+  DISABLE_COPY_AND_ASSIGN(StreamCallbackPoller);
+};
+
+// Whether the callbacks of the stream are run by a StreamCallbackPoller, by
+// FLAGS_gpu_stream_callback_polling, while the stream is not captured by a
+// graph, where the host functions are a part of the graph.
+TEST_API bool UseStreamCallbackPoller(gpuStream_t stream);
+
+}  // namespace gpu
+}  // namespace backends
+}  // namespace phi
+
+#endif
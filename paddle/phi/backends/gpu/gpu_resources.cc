@@ -238,6 +238,14 @@ void InitBlasHandle(blasHandle_t* blas_handle, gpuStream_t stream) {
 #endif  // PADDLE_WITH_HIP
 }
 
+void SetBlasHandleStream(blasHandle_t handle, gpuStream_t stream) {
+#ifdef PADDLE_WITH_HIP
+  phi::dynload::rocblas_set_stream(handle, stream);
+#else   // PADDLE_WITH_CUDA
+  PADDLE_RETRY_CUDA_SUCCESS(phi::dynload::cublasSetStream(handle, stream));
+#endif  // PADDLE_WITH_HIP
+}
+
 void DestroyBlasHandle(blasHandle_t handle) {
 #ifdef PADDLE_WITH_HIP
   if (handle != nullptr) {
@@ -313,6 +321,15 @@ void InitDnnHandle(dnnHandle_t* handle, gpuStream_t stream, Place place) {
   }
 }
 
+void SetDnnHandleStream(dnnHandle_t handle, gpuStream_t stream) {
+  if (handle == nullptr) return;
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(dynload::miopenSetStream(handle, stream));
+#else
+  PADDLE_RETRY_CUDA_SUCCESS(phi::dynload::cudnnSetStream(handle, stream));
+#endif
+}
+
 void DestroyDnnHandle(dnnHandle_t handle) {
 #ifdef PADDLE_WITH_HIP
   if (handle != nullptr) {
@@ -334,6 +351,12 @@ void InitSolverHandle(solverHandle_t* handle, gpuStream_t stream) {
 #endif
 }
 
+void SetSolverHandleStream(solverHandle_t handle, gpuStream_t stream) {
+#ifndef PADDLE_WITH_HIP
+  PADDLE_RETRY_CUDA_SUCCESS(phi::dynload::cusolverDnSetStream(handle, stream));
+#endif
+}
+
 void DestroySolverHandle(solverHandle_t solver_handle) {
 #ifndef PADDLE_WITH_HIP
   if (solver_handle != nullptr) {
@@ -357,6 +380,16 @@ void InitSparseHandle(sparseHandle_t* handle, gpuStream_t stream) {
 #endif
 }
 
+void SetSparseHandleStream(sparseHandle_t handle, gpuStream_t stream) {
+#if defined(PADDLE_WITH_CUDA)
+#if CUDA_VERSION >= 11000
+  PADDLE_RETRY_CUDA_SUCCESS(dynload::cusparseSetStream(handle, stream));
+#endif
+#elif defined(PADDLE_WITH_HIP)
+  phi::dynload::rocsparse_set_stream(handle, stream);
+#endif
+}
+
 void DestroySparseHandle(sparseHandle_t handle) {
 #ifdef PADDLE_WITH_CUDA
 #if CUDA_VERSION >= 11000
@@ -33,18 +33,22 @@ void InitStream(gpuStream_t* stream);
 void DestoryStream(gpuStream_t stream);
 
 void InitBlasHandle(blasHandle_t* blas_handle, gpuStream_t stream);
+void SetBlasHandleStream(blasHandle_t handle, gpuStream_t stream);
 void DestroyBlasHandle(blasHandle_t handle);
 
 void InitBlasLtHandle(blasLtHandle_t* blaslt_handle);
 void DestroyBlasLtHandle(blasLtHandle_t handle);
 
 void InitDnnHandle(dnnHandle_t* handle, gpuStream_t stream, Place place);
+void SetDnnHandleStream(dnnHandle_t handle, gpuStream_t stream);
 void DestroyDnnHandle(dnnHandle_t handle);
 
 void InitSolverHandle(solverHandle_t* handle, gpuStream_t stream);
+void SetSolverHandleStream(solverHandle_t handle, gpuStream_t stream);
 void DestroySolverHandle(solverHandle_t solver_handle);
 
 void InitSparseHandle(sparseHandle_t* handle, gpuStream_t stream);
+void SetSparseHandleStream(sparseHandle_t handle, gpuStream_t stream);
 void DestroySparseHandle(sparseHandle_t handle);
 
 // void InitDnnWorkspace();
@@ -0,0 +1,81 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/backends/onednn/onednn_primitive_cache.h"
+
+#include <algorithm>
+
+#include "glog/logging.h"
+#include "paddle/utils/flags.h"
+
+PD_DECLARE_int64(onednn_primitive_cache_capacity);
+
+namespace phi {
+
+OneDNNPrimitiveCache& OneDNNPrimitiveCache::Instance() {
+  static OneDNNPrimitiveCache cache;
+  return cache;
+}
+
+bool OneDNNPrimitiveCache::Enabled() {
+  return FLAGS_onednn_primitive_cache_capacity > 0;
+}
+
+std::shared_ptr<void> OneDNNPrimitiveCache::Get(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    ++miss_count_;
+    return nullptr;
+  }
+  ++hit_count_;
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->second;
+}
+
+std::shared_ptr<void> OneDNNPrimitiveCache::Set(const std::string& key,
+                                                std::shared_ptr<void> value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->second;
+  }
+  entries_.emplace_front(key, value);
+  index_[key] = entries_.begin();
+  const auto capacity = static_cast<size_t>(
+      std::max<int64_t>(FLAGS_onednn_primitive_cache_capacity, 1));
+  while (entries_.size() > capacity) {
+    VLOG(3) << "Evict the oneDNN primitive " << entries_.back().first
+            << " from the primitive cache";
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  return value;
+}
+
+void OneDNNPrimitiveCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  VLOG(3) << "Clear the oneDNN primitive cache of " << entries_.size()
+          << " entries, hit " << hit_count_ << ", miss " << miss_count_;
+  entries_.clear();
+  index_.clear();
+}
+
+size_t OneDNNPrimitiveCache::Size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+}  // namespace phi
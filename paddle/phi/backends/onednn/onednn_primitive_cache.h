@@ -0,0 +1,71 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace phi {
+
+// The process wide, bounded and LRU cache of the oneDNN primitives and
+// primitive descriptors, shared by all the threads and predictors. They are
+// immutable once created and can be executed by many threads concurrently,
+// so a primitive of a shape class, i.e. the key of the handler without the
+// thread id, is created once for the process instead of once per thread.
+// The memory objects bound to the data of a thread are not cached here.
+//
+// The capacity is FLAGS_onednn_primitive_cache_capacity, and the cache is
+// disabled when it is 0.
+class OneDNNPrimitiveCache {
+ public:
+  static OneDNNPrimitiveCache& Instance();
+
+  static bool Enabled();
+
+  // Return nullptr if the key is not cached.
+  std::shared_ptr<void> Get(const std::string& key);
+
+  // Cache the value and return it, or return the value cached by another
+  // thread in the meantime, so that all the threads share the same one.
+  std::shared_ptr<void> Set(const std::string& key,
+                            std::shared_ptr<void> value);
+
+  void Clear();
+
+  size_t Size();
+
+  int64_t HitCount() const { return hit_count_; }
+  int64_t MissCount() const { return miss_count_; }
+
+ private:
+  OneDNNPrimitiveCache() = default;
+
+  using Entry = std::pair<std::string, std::shared_ptr<void>>;
+
+  std::mutex mutex_;
+  // the most recently used entry is in the front
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+  std::atomic<int64_t> hit_count_{0};
+  std::atomic<int64_t> miss_count_{0};
+};
+
+}  // namespace phi
@@ -24,6 +24,7 @@ limitations under the License. */
 
 #include "paddle/phi/backends/onednn/onednn_context.h"
 #include "paddle/phi/backends/onednn/onednn_helper.h"
+#include "paddle/phi/backends/onednn/onednn_primitive_cache.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/common/int_array.h"
 #include "paddle/phi/common/place.h"
@@ -157,39 +158,37 @@ class OneDNNHandlerT {
   }
 
   std::shared_ptr<TForward> AcquireForwardPrimitive() {
-    const std::string key_p = key_ + "@fwd_p";
     auto forward_p =
-        std::static_pointer_cast<TForward>(dev_ctx_.GetBlob(key_p));
+        std::static_pointer_cast<TForward>(GetPrimitiveBlob("@fwd_p"));
     if (forward_p == nullptr) {
-      forward_p = std::make_shared<TForward>(*fwd_pd_);
-      dev_ctx_.SetBlob(key_p, forward_p);
+      forward_p = std::static_pointer_cast<TForward>(SetPrimitiveBlob(
+          "@fwd_p", std::make_shared<TForward>(*fwd_pd_)));
     }
     return forward_p;
   }
 
   std::shared_ptr<TBackward> AcquireBackwardPrimitive() {
-    const std::string key_p = key_ + "@bwd_p";
     auto backward_p =
-        std::static_pointer_cast<TBackward>(dev_ctx_.GetBlob(key_p));
+        std::static_pointer_cast<TBackward>(GetPrimitiveBlob("@bwd_p"));
     if (backward_p == nullptr) {
-      backward_p = std::make_shared<TBackward>(*bwd_pd_);
-      dev_ctx_.SetBlob(key_p, backward_p);
+      backward_p = std::static_pointer_cast<TBackward>(SetPrimitiveBlob(
+          "@bwd_p", std::make_shared<TBackward>(*bwd_pd_)));
     }
     return backward_p;
   }
 
   std::shared_ptr<TBackward_params> AcquireBackwardWeightsPrimitive() {
-    const std::string key_p = key_ + "@bwd_w_p";
-    auto backward_p =
-        std::static_pointer_cast<TBackward_params>(dev_ctx_.GetBlob(key_p));
+    auto backward_p = std::static_pointer_cast<TBackward_params>(
+        GetPrimitiveBlob("@bwd_w_p"));
     if (backward_p == nullptr) {
       PADDLE_ENFORCE_NOT_NULL(
           bwd_w_pd_,
           errors::Unavailable("BWD_PD should be set when "
                               "getting BWD prim witk key: %s .",
-                              key_p));
-      backward_p = std::make_shared<TBackward_params>(*bwd_w_pd_);
-      dev_ctx_.SetBlob(key_p, backward_p);
+                              key_ + "@bwd_w_p"));
+      backward_p = std::static_pointer_cast<TBackward_params>(
+          SetPrimitiveBlob("@bwd_w_p",
+                           std::make_shared<TBackward_params>(*bwd_w_pd_)));
     }
     return backward_p;
   }
@@ -260,33 +259,29 @@ class OneDNNHandlerT {
 
  protected:
   bool isCached() {
-    const std::string key_pd = key_ + "@fwd_pd";
     fwd_pd_ = std::static_pointer_cast<typename TForward::primitive_desc>(
-        dev_ctx_.GetBlob(key_pd));
+        GetPrimitiveBlob("@fwd_pd"));
 
     return (fwd_pd_ != nullptr);
   }
 
   bool isBwdCached() {
-    const std::string key_pd = key_ + "@bwd_pd";
     bwd_pd_ = std::static_pointer_cast<typename TBackward::primitive_desc>(
-        dev_ctx_.GetBlob(key_pd));
+        GetPrimitiveBlob("@bwd_pd"));
 
     if (bwd_pd_ == nullptr) {
       return false;
     } else {
       if (std::is_same<TBackward_params, onednn_dummy_primitive>::value ==
           false) {
-        const std::string key_bw_w_pd = key_ + "@bwd_w_pd";
         bwd_w_pd_ =
             std::static_pointer_cast<typename TBackward_params::primitive_desc>(
-                dev_ctx_.GetBlob(key_bw_w_pd));
+                GetPrimitiveBlob("@bwd_w_pd"));
       }
 
       // When BWD is cached then still we need to Get FWD PD
-      const std::string key_fpd = key_ + "@fwd_pd";
       fwd_pd_ = std::static_pointer_cast<typename TForward::primitive_desc>(
-          dev_ctx_.GetBlob(key_fpd));
+          GetPrimitiveBlob("@fwd_pd"));
       PADDLE_ENFORCE_NOT_NULL(
           fwd_pd_,
           errors::Unavailable(
@@ -303,12 +298,12 @@ class OneDNNHandlerT {
   void AcquireForwardPrimitiveDescriptor(Arg&& first_arg, Args&&... args) {
     // This is used when we can recreate FWD PD in BWD so
     // we do not need to pass FWD to BWD
-    const std::string key_pd = key_ + "@fwd_pd";
     fwd_pd_ = std::static_pointer_cast<typename TForward::primitive_desc>(
-        dev_ctx_.GetBlob(key_pd));
+        GetPrimitiveBlob("@fwd_pd"));
     if (fwd_pd_ == nullptr) {
       CreateForwardPrimitiveDescriptor(first_arg, std::forward<Args>(args)...);
-      dev_ctx_.SetBlob(key_pd, fwd_pd_);
+      fwd_pd_ = std::static_pointer_cast<typename TForward::primitive_desc>(
+          SetPrimitiveBlob("@fwd_pd", fwd_pd_));
     }
   }
 
@@ -338,13 +333,14 @@ class OneDNNHandlerT {
         fwd_pd_,
         errors::Unavailable("Get OneDNN Forward primitive %s failed.",
                             key_ + "@fwd_pd"));
-    const std::string key_pd = key_ + "@bwd_pd";
     bwd_pd_ = std::static_pointer_cast<typename TBackward::primitive_desc>(
-        dev_ctx_.GetBlob(key_pd));
+        GetPrimitiveBlob("@bwd_pd"));
     if (bwd_pd_ == nullptr) {
-      bwd_pd_ = std::make_shared<typename TBackward::primitive_desc>(
-          engine_, std::forward<Args>(args)..., *fwd_pd_);
-      dev_ctx_.SetBlob(key_pd, bwd_pd_);
+      bwd_pd_ = std::static_pointer_cast<typename TBackward::primitive_desc>(
+          SetPrimitiveBlob(
+              "@bwd_pd",
+              std::make_shared<typename TBackward::primitive_desc>(
+                  engine_, std::forward<Args>(args)..., *fwd_pd_)));
     }
   }
 
@@ -356,15 +352,42 @@ class OneDNNHandlerT {
         fwd_pd_,
         errors::Unavailable("Get OneDNN Forward primitive %s failed.",
                             key_ + "@fwd_pd"));
-    const std::string key_pd = key_ + "@bwd_w_pd";
     bwd_w_pd_ =
         std::static_pointer_cast<typename TBackward_params::primitive_desc>(
-            dev_ctx_.GetBlob(key_pd));
+            GetPrimitiveBlob("@bwd_w_pd"));
     if (bwd_w_pd_ == nullptr) {
-      bwd_w_pd_ = std::make_shared<typename TBackward_params::primitive_desc>(
-          engine_, std::forward<Args>(args)..., *fwd_pd_);
-      dev_ctx_.SetBlob(key_pd, bwd_w_pd_);
+      bwd_w_pd_ =
+          std::static_pointer_cast<typename TBackward_params::primitive_desc>(
+              SetPrimitiveBlob(
+                  "@bwd_w_pd",
+                  std::make_shared<typename TBackward_params::primitive_desc>(
+                      engine_, std::forward<Args>(args)..., *fwd_pd_)));
+    }
+  }
+
+  // The primitives and primitive descriptors are looked up in the blobs of
+  // the thread first, and then in the process wide primitive cache by the
+  // key without the thread id, so that the threads share them.
+  std::shared_ptr<void> GetPrimitiveBlob(const std::string& suffix) {
+    auto blob = dev_ctx_.GetBlob(key_ + suffix);
+    if (blob == nullptr && OneDNNPrimitiveCache::Enabled()) {
+      blob = OneDNNPrimitiveCache::Instance().Get(key_common_ + suffix);
+      if (blob != nullptr) {
+        dev_ctx_.SetBlob(key_ + suffix, blob);
+      }
+    }
+    return blob;
+  }
+
+  // Return the blob shared by the threads, which is the given one unless
+  // another thread has cached one under the same key in the meantime.
+  std::shared_ptr<void> SetPrimitiveBlob(const std::string& suffix,
+                                         std::shared_ptr<void> blob) {
+    if (OneDNNPrimitiveCache::Enabled()) {
+      blob = OneDNNPrimitiveCache::Instance().Set(key_common_ + suffix, blob);
     }
+    dev_ctx_.SetBlob(key_ + suffix, blob);
+    return blob;
   }
 
   std::shared_ptr<dnnl::memory> AcquireMemoryFromPrimitive(
@@ -13,6 +13,9 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #include "paddle/phi/backends/xpu/xpu_l3_strategy.h"
+
+#include <utility>
+
 #include "glog/logging.h"
 
 namespace phi {
@@ -150,4 +153,81 @@ void XPUL3Planner::RunAutotune(
   VLOG(3) << "AutoTune XPU L3 Cache Block End.";
 }
 
+void XPUL3Planner::RunLifetimeAutotune(
+    const std::vector<XPUL3CacheBlock*>& l3_block_dict, size_t l3_size) {
+  if (l3_block_dict.size() == 0 || l3_size <= 0 || !plan_.empty()) {
+    return;
+  }
+  VLOG(3) << "Lifetime AutoTune XPU L3 Cache Block Start.";
+  const size_t alignment = 64;
+  struct candidate {
+    size_t block_idx;
+    size_t size;
+    double density;
+  };
+  std::vector<candidate> candidates;
+  for (size_t block_idx = 0; block_idx < l3_block_dict.size(); block_idx++) {
+    XPUL3CacheBlock* cur_block = l3_block_dict[block_idx];
+    std::vector<size_t>& history = cur_block->history_;
+    if (history.size() <= 1 || !cur_block->HasLifetime()) {
+      continue;
+    }
+    size_t size = *std::max_element(history.begin(), history.end());
+    size = (size + alignment - 1) / alignment * alignment;
+    if (size == 0 || size > l3_size) {
+      continue;
+    }
+    size_t score = std::accumulate(history.begin(), history.end(), size_t(0));
+    candidates.push_back(
+        {block_idx, size, static_cast<double>(score) / size});
+  }
+  std::sort(candidates.begin(),
+            candidates.end(),
+            [](const candidate& a, const candidate& b) {
+              return a.density > b.density ||
+                     (a.density == b.density && a.size < b.size);
+            });
+
+  plan_.resize(l3_block_dict.size() + 1, 0);
+  offsets_.resize(l3_block_dict.size(), 0);
+  std::vector<size_t> placed;
+  size_t peak = 0;
+  for (auto& cur : candidates) {
+    XPUL3CacheBlock* cur_block = l3_block_dict[cur.block_idx];
+    // The ranges taken by the placed blocks living at the same time.
+    std::vector<std::pair<size_t, size_t>> taken;
+    for (size_t idx : placed) {
+      XPUL3CacheBlock* other = l3_block_dict[idx];
+      if (other->first_use_ <= cur_block->last_use_ &&
+          cur_block->first_use_ <= other->last_use_) {
+        taken.emplace_back(offsets_[idx], offsets_[idx] + plan_[idx]);
+      }
+    }
+    std::sort(taken.begin(), taken.end());
+    size_t offset = 0;
+    for (auto& range : taken) {
+      if (offset + cur.size <= range.first) {
+        break;
+      }
+      offset = std::max(offset, range.second);
+    }
+    if (offset + cur.size > l3_size) {
+      continue;
+    }
+    plan_[cur.block_idx] = cur.size;
+    offsets_[cur.block_idx] = offset;
+    placed.push_back(cur.block_idx);
+    peak = std::max(peak, offset + cur.size);
+    VLOG(3) << "BLOCK IDX is " << cur.block_idx << ", Acquired L3 Size is "
+            << cur.size << " at offset " << offset << ", lifetime ["
+            << cur_block->first_use_ << ", " << cur_block->last_use_ << "]";
+  }
+  size_t xdnn_ctx_l3_size = (l3_size - peak) / alignment * alignment;
+  VLOG(3) << "Placed " << placed.size() << " of " << candidates.size()
+          << " blocks, Block L3 Size : " << peak
+          << ", XDNN Ctx L3 Size : " << xdnn_ctx_l3_size;
+  plan_[l3_block_dict.size()] = xdnn_ctx_l3_size;
+  VLOG(3) << "Lifetime AutoTune XPU L3 Cache Block End.";
+}
+
 }  // namespace phi
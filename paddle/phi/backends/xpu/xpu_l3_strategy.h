@@ -14,6 +14,7 @@ limitations under the License. */
 
 #pragma once
 #include <algorithm>
+#include <limits>
 #include <numeric>
 #include <vector>
 
@@ -25,9 +26,18 @@ struct XPUL3CacheBlock {
     addr_ = nullptr;
     size_ = 0;
     history_.clear();
+    first_use_ = std::numeric_limits<size_t>::max();
+    last_use_ = 0;
   }
   void Set(void* addr, size_t size);
   void Record(size_t size) { history_.push_back(size); }
+  // Records a use of the block at the step of a run, the steps between the
+  // first and the last use are the lifetime of the block.
+  void RecordUse(size_t step) {
+    first_use_ = std::min(first_use_, step);
+    last_use_ = std::max(last_use_, step);
+  }
+  bool HasLifetime() const { return first_use_ <= last_use_; }
   void* data() { return addr_; }
   size_t size() { return size_; }
 
@@ -37,6 +47,8 @@ struct XPUL3CacheBlock {
 
  public:
   std::vector<size_t> history_;
+  size_t first_use_{std::numeric_limits<size_t>::max()};
+  size_t last_use_{0};
 };
 
 class XPUL3Planner {
@@ -44,10 +56,23 @@ class XPUL3Planner {
   void RunAutotune(const std::vector<XPUL3CacheBlock*>& l3_block_dict,
                    size_t l3_size);
 
+  // Places the blocks by their lifetimes, the blocks whose lifetimes do not
+  // overlap may share the same range of L3. The reused blocks of the most
+  // bytes for a byte of L3 are placed first, each at the lowest offset free
+  // during its lifetime. The blocks without a lifetime are not placed.
+  void RunLifetimeAutotune(const std::vector<XPUL3CacheBlock*>& l3_block_dict,
+                           size_t l3_size);
+
+  // The sizes of the blocks, and the size of the L3 of the XDNN context at
+  // the back.
   std::vector<size_t>* plan() { return &plan_; }
 
+  // The offsets of the blocks in L3, only planned by RunLifetimeAutotune.
+  std::vector<size_t>* offsets() { return &offsets_; }
+
  private:
   std::vector<size_t> plan_;
+  std::vector<size_t> offsets_;
 };
 
 }  // namespace phi
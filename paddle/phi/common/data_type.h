@@ -18,6 +18,8 @@ limitations under the License. */
 #include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/common/complex.h"
 #include "paddle/phi/common/float16.h"
+#include "paddle/phi/common/float8_e4m3fn.h"
+#include "paddle/phi/common/float8_e5m2.h"
 #include "paddle/utils/test_macros.h"
 
 namespace phi {
@@ -32,6 +34,8 @@ using complex64 = ::phi::dtype::complex<float>;
 using complex128 = ::phi::dtype::complex<double>;
 using float16 = ::phi::dtype::float16;
 using bfloat16 = ::phi::dtype::bfloat16;
+using float8_e4m3fn = ::phi::dtype::float8_e4m3fn;
+using float8_e5m2 = ::phi::dtype::float8_e5m2;
 using pstring = ::phi::dtype::pstring;
 
 // The enum value are consistent with jit/property.proto
@@ -70,6 +74,12 @@ enum class TEST_API DataType {
   // This format has 1 sign bit, 8 exponent bits, and 7 mantissa bits.
   BFLOAT16,
 
+  // The 8 bits floating-point formats of FP8 training and inference.
+  // E4M3 has 1 sign bit, 4 exponent bits, 3 mantissa bits and no infinity.
+  // E5M2 has 1 sign bit, 5 exponent bits and 2 mantissa bits.
+  FLOAT8_E4M3FN,
+  FLOAT8_E5M2,
+
   NUM_DATA_TYPES,
   // See Note [ Why we need ALL in basic kernel key member? ]
   ALL_DTYPE = UNDEFINED,
@@ -80,6 +90,8 @@ inline size_t SizeOf(DataType data_type) {
     case DataType::BOOL:
     case DataType::UINT8:
     case DataType::INT8:
+    case DataType::FLOAT8_E4M3FN:
+    case DataType::FLOAT8_E5M2:
       return 1;
     case DataType::BFLOAT16:
     case DataType::FLOAT16:
@@ -109,22 +121,24 @@ inline size_t SizeOf(DataType data_type) {
   return 0;
 }
 
-#define PD_FOR_EACH_DATA_TYPE(_)      \
-  _(bool, DataType::BOOL)             \
-  _(int8_t, DataType::INT8)           \
-  _(uint8_t, DataType::UINT8)         \
-  _(int16_t, DataType::INT16)         \
-  _(uint16_t, DataType::UINT16)       \
-  _(int32_t, DataType::INT32)         \
-  _(uint32_t, DataType::UINT32)       \
-  _(int64_t, DataType::INT64)         \
-  _(uint64_t, DataType::UINT64)       \
-  _(bfloat16, DataType::BFLOAT16)     \
-  _(float16, DataType::FLOAT16)       \
-  _(float, DataType::FLOAT32)         \
-  _(double, DataType::FLOAT64)        \
-  _(complex64, DataType::COMPLEX64)   \
-  _(complex128, DataType::COMPLEX128) \
+#define PD_FOR_EACH_DATA_TYPE(_)           \
+  _(bool, DataType::BOOL)                  \
+  _(int8_t, DataType::INT8)                \
+  _(uint8_t, DataType::UINT8)              \
+  _(int16_t, DataType::INT16)              \
+  _(uint16_t, DataType::UINT16)            \
+  _(int32_t, DataType::INT32)              \
+  _(uint32_t, DataType::UINT32)            \
+  _(int64_t, DataType::INT64)              \
+  _(uint64_t, DataType::UINT64)            \
+  _(bfloat16, DataType::BFLOAT16)          \
+  _(float16, DataType::FLOAT16)            \
+  _(float8_e4m3fn, DataType::FLOAT8_E4M3FN)\
+  _(float8_e5m2, DataType::FLOAT8_E5M2)    \
+  _(float, DataType::FLOAT32)              \
+  _(double, DataType::FLOAT64)             \
+  _(complex64, DataType::COMPLEX64)        \
+  _(complex128, DataType::COMPLEX128)      \
   _(pstring, DataType::PSTRING)
 
 template <DataType T>
@@ -191,6 +205,12 @@ inline std::ostream& operator<<(std::ostream& os, DataType dtype) {
     case DataType::FLOAT16:
       os << "float16";
       break;
+    case DataType::FLOAT8_E4M3FN:
+      os << "float8_e4m3fn";
+      break;
+    case DataType::FLOAT8_E5M2:
+      os << "float8_e5m2";
+      break;
     case DataType::FLOAT32:
       os << "float32";
       break;
@@ -238,6 +258,10 @@ inline std::string DataTypeToString(const DataType& dtype) {
       return "bfloat16";
     case DataType::FLOAT16:
       return "float16";
+    case DataType::FLOAT8_E4M3FN:
+      return "float8_e4m3fn";
+    case DataType::FLOAT8_E5M2:
+      return "float8_e5m2";
     case DataType::FLOAT32:
       return "float32";
     case DataType::FLOAT64:
@@ -262,6 +286,8 @@ using bfloat16 = phi::bfloat16;
 using complex64 = phi::complex64;
 using complex128 = phi::complex128;
 using float16 = phi::float16;
+using float8_e4m3fn = phi::float8_e4m3fn;
+using float8_e5m2 = phi::float8_e5m2;
 using pstring = phi::pstring;
 
 }  // namespace paddle
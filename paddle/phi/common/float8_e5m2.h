@@ -0,0 +1,369 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include "paddle/common/hostdevice.h"
+
+#ifdef PADDLE_WITH_CUDA
+#include <cuda.h>
+#endif
+
+#if defined(__CUDACC__) && CUDA_VERSION >= 11080
+#define PADDLE_CUDA_FP8
+#include <cuda_fp8.h>
+#endif
+
+#ifndef PADDLE_WITH_HIP
+#if !defined(_WIN32)
+#define PADDLE_ALIGN(x) __attribute__((aligned(x)))
+#else
+#define PADDLE_ALIGN(x) __declspec(align(x))
+#endif
+#else
+#define PADDLE_ALIGN(x)
+#endif
+
+namespace phi {
+namespace dtype {
+
+// The E5M2 format of "FP8 Formats for Deep Learning": 1 sign bit, 5 exponent
+// bits of bias 15 and 2 mantissa bits, the IEEE754 special values included.
+// The largest finite value is 57344, it has the range the gradients need. The
+// overflow saturates to the largest finite value, as the scaled casts of FP8
+// training expect.
+struct PADDLE_ALIGN(1) float8_e5m2 {
+ public:
+  uint8_t x;
+
+  // Constructors
+  float8_e5m2() = default;
+  float8_e5m2(const float8_e5m2& o) = default;
+  float8_e5m2& operator=(const float8_e5m2& o) = default;
+  float8_e5m2(float8_e5m2&& o) = default;
+  float8_e5m2& operator=(float8_e5m2&& o) = default;
+  ~float8_e5m2() = default;
+
+  HOSTDEVICE inline explicit float8_e5m2(float val) {
+#if defined(PADDLE_CUDA_FP8) && defined(__CUDA_ARCH__)
+    __nv_fp8_e5m2 tmp = __nv_fp8_e5m2(val);
+    x = *reinterpret_cast<uint8_t*>(&tmp);
+#else
+    uint32_t bits = 0;
+    std::memcpy(&bits, &val, sizeof(bits));
+    uint8_t sign = (bits >> 24) & 0x80;
+    bits &= 0x7fffffff;
+    if (bits > 0x7f800000) {
+      x = sign | 0x7e;
+    } else if (bits < 0x38800000) {
+      // the subnormals of 2^-16 units, rounded to nearest even
+      int shift = 134 - static_cast<int>(bits >> 23);
+      if (shift > 24) {
+        x = sign;
+      } else {
+        uint32_t mant = (bits & 0x7fffff) | 0x800000;
+        x = sign | static_cast<uint8_t>((mant + (1u << (shift - 1)) - 1 +
+                                         ((mant >> shift) & 1)) >>
+                                        shift);
+      }
+    } else {
+      bits += 0xfffff + ((bits >> 21) & 1);
+      bits = (bits >> 21) - (112 << 2);
+      x = sign | static_cast<uint8_t>(bits > 0x7b ? 0x7b : bits);
+    }
+#endif
+  }
+
+#if defined(PADDLE_CUDA_FP8)
+  HOSTDEVICE inline explicit float8_e5m2(const __nv_fp8_e5m2& val) {
+    x = *reinterpret_cast<const uint8_t*>(&val);
+  }
+#endif
+
+  template <class T>
+  HOSTDEVICE inline explicit float8_e5m2(const T& val)
+      : x(float8_e5m2(static_cast<float>(val)).x) {}
+
+  // Assignment operators
+  HOSTDEVICE inline float8_e5m2& operator=(float val) {
+    x = float8_e5m2(val).x;
+    return *this;
+  }
+
+  HOSTDEVICE inline float8_e5m2& operator=(double val) {
+    x = float8_e5m2(val).x;
+    return *this;
+  }
+
+  // Conversion operators
+  HOSTDEVICE inline operator float() const {
+#if defined(PADDLE_CUDA_FP8) && defined(__CUDA_ARCH__)
+    return static_cast<float>(*reinterpret_cast<const __nv_fp8_e5m2*>(&x));
+#else
+    uint32_t sign = static_cast<uint32_t>(x & 0x80) << 24;
+    int exp = (x >> 2) & 0x1f;
+    uint32_t mant = x & 0x3;
+    uint32_t bits = 0;
+    if (exp == 0x1f) {
+      bits = sign | (mant != 0 ? 0x7fc00000 : 0x7f800000);
+    } else if (exp == 0) {
+      if (mant != 0) {
+        // normalize the subnormal
+        exp = 1;
+        while ((mant & 0x4) == 0) {
+          mant <<= 1;
+          --exp;
+        }
+        bits = sign | (static_cast<uint32_t>(exp + 112) << 23) |
+               ((mant & 0x3) << 21);
+      } else {
+        bits = sign;
+      }
+    } else {
+      bits = sign | (static_cast<uint32_t>(exp + 112) << 23) | (mant << 21);
+    }
+    float val = 0.f;
+    std::memcpy(&val, &bits, sizeof(val));
+    return val;
+#endif
+  }
+
+#if defined(PADDLE_CUDA_FP8)
+  HOSTDEVICE inline __nv_fp8_e5m2 to_nv_fp8_e5m2() const {
+    return *reinterpret_cast<const __nv_fp8_e5m2*>(&x);
+  }
+#endif
+
+  HOSTDEVICE inline explicit operator bool() const { return (x & 0x7f) != 0; }
+
+  HOSTDEVICE inline explicit operator int8_t() const {
+    return static_cast<int8_t>(static_cast<float>(*this));
+  }
+
+  HOSTDEVICE inline explicit operator uint8_t() const {
+    return static_cast<uint8_t>(static_cast<float>(*this));
+  }
+
+  HOSTDEVICE inline explicit operator int16_t() const {
+    return static_cast<int16_t>(static_cast<float>(*this));
+  }
+
+  HOSTDEVICE inline explicit operator uint16_t() const {
+    return static_cast<uint16_t>(static_cast<float>(*this));
+  }
+
+  HOSTDEVICE inline explicit operator int32_t() const {
+    return static_cast<int32_t>(static_cast<float>(*this));
+  }
+
+  HOSTDEVICE inline explicit operator uint32_t() const {
+    return static_cast<uint32_t>(static_cast<float>(*this));
+  }
+
+  HOSTDEVICE inline explicit operator int64_t() const {
+    return static_cast<int64_t>(static_cast<float>(*this));
+  }
+
+  HOSTDEVICE inline explicit operator uint64_t() const {
+    return static_cast<uint64_t>(static_cast<float>(*this));
+  }
+
+  HOSTDEVICE inline operator double() const {
+    return static_cast<double>(static_cast<float>(*this));
+  }
+};
+
+HOSTDEVICE inline float8_e5m2 operator+(const float8_e5m2& a,
+                                          const float8_e5m2& b) {
+  return float8_e5m2(static_cast<float>(a) + static_cast<float>(b));
+}
+
+HOSTDEVICE inline float8_e5m2 operator-(const float8_e5m2& a,
+                                          const float8_e5m2& b) {
+  return float8_e5m2(static_cast<float>(a) - static_cast<float>(b));
+}
+
+HOSTDEVICE inline float8_e5m2 operator*(const float8_e5m2& a,
+                                          const float8_e5m2& b) {
+  return float8_e5m2(static_cast<float>(a) * static_cast<float>(b));
+}
+
+HOSTDEVICE inline float8_e5m2 operator/(const float8_e5m2& a,
+                                          const float8_e5m2& b) {
+  return float8_e5m2(static_cast<float>(a) / static_cast<float>(b));
+}
+
+HOSTDEVICE inline float8_e5m2 operator-(const float8_e5m2& a) {
+  float8_e5m2 res;
+  res.x = a.x ^ 0x80;
+  return res;
+}
+
+HOSTDEVICE inline float8_e5m2 raw_uint8_to_float8_e5m2(uint8_t a) {
+  float8_e5m2 res;
+  res.x = a;
+  return res;
+}
+
+// Comparison operators
+HOSTDEVICE inline bool operator==(const float8_e5m2& a,
+                                  const float8_e5m2& b) {
+  return static_cast<float>(a) == static_cast<float>(b);
+}
+
+HOSTDEVICE inline bool operator!=(const float8_e5m2& a,
+                                  const float8_e5m2& b) {
+  return static_cast<float>(a) != static_cast<float>(b);
+}
+
+HOSTDEVICE inline bool operator<(const float8_e5m2& a,
+                                 const float8_e5m2& b) {
+  return static_cast<float>(a) < static_cast<float>(b);
+}
+
+HOSTDEVICE inline bool operator<=(const float8_e5m2& a,
+                                  const float8_e5m2& b) {
+  return static_cast<float>(a) <= static_cast<float>(b);
+}
+
+HOSTDEVICE inline bool operator>(const float8_e5m2& a,
+                                 const float8_e5m2& b) {
+  return static_cast<float>(a) > static_cast<float>(b);
+}
+
+HOSTDEVICE inline bool operator>=(const float8_e5m2& a,
+                                  const float8_e5m2& b) {
+  return static_cast<float>(a) >= static_cast<float>(b);
+}
+
+HOSTDEVICE inline bool(isnan)(const float8_e5m2& a) {
+  return (a.x & 0x7f) > 0x7c;
+}
+
+HOSTDEVICE inline bool(isinf)(const float8_e5m2& a) {
+  return (a.x & 0x7f) == 0x7c;
+}
+
+HOSTDEVICE inline bool(isfinite)(const float8_e5m2& a) {
+  return !((isnan)(a)) && !((isinf)(a));
+}
+
+HOSTDEVICE inline float8_e5m2(abs)(const float8_e5m2& a) {
+  return raw_uint8_to_float8_e5m2(a.x & 0x7f);
+}
+
+inline std::ostream& operator<<(std::ostream& os, const float8_e5m2& a) {
+  os << static_cast<float>(a);
+  return os;
+}
+
+}  // namespace dtype
+}  // namespace phi
+
+namespace std {
+
+template <>
+struct is_pod<phi::dtype::float8_e5m2> {
+  static const bool value =
+      is_trivial<phi::dtype::float8_e5m2>::value &&
+      is_standard_layout<phi::dtype::float8_e5m2>::value;
+};
+
+template <>
+struct is_floating_point<phi::dtype::float8_e5m2>
+    : std::integral_constant<
+          bool,
+          std::is_same<phi::dtype::float8_e5m2,
+                       typename std::remove_cv<
+                           phi::dtype::float8_e5m2>::type>::value> {};
+template <>
+struct is_signed<phi::dtype::float8_e5m2> {
+  static const bool value = true;
+};
+
+template <>
+struct is_unsigned<phi::dtype::float8_e5m2> {
+  static const bool value = false;
+};
+
+inline bool isnan(const phi::dtype::float8_e5m2& a) {
+  return phi::dtype::isnan(a);
+}
+
+inline bool isinf(const phi::dtype::float8_e5m2& a) {
+  return phi::dtype::isinf(a);
+}
+
+template <>
+struct numeric_limits<phi::dtype::float8_e5m2> {
+  static const bool is_specialized = true;
+  static const bool is_signed = true;
+  static const bool is_integer = false;
+  static const bool is_exact = false;
+  static const bool has_infinity = true;
+  static const bool has_quiet_NaN = true;
+  static const bool has_signaling_NaN = true;
+  static const float_denorm_style has_denorm = denorm_present;
+  static const bool has_denorm_loss = false;
+  static const std::float_round_style round_style = std::round_to_nearest;
+  static const bool is_iec559 = false;
+  static const bool is_bounded = true;
+  static const bool is_modulo = false;
+  static const int digits = 3;
+  static const int digits10 = 0;
+  static const int max_digits10 = 2;
+  static const int radix = 2;
+  static const int min_exponent = -13;
+  static const int min_exponent10 = -4;
+  static const int max_exponent = 16;
+  static const int max_exponent10 = 4;
+  static const bool traps = false;
+  static const bool tinyness_before = false;
+
+  HOSTDEVICE static phi::dtype::float8_e5m2(min)() {
+    return phi::dtype::raw_uint8_to_float8_e5m2(0x04);
+  }
+  HOSTDEVICE static phi::dtype::float8_e5m2 lowest() {
+    return phi::dtype::raw_uint8_to_float8_e5m2(0xfb);
+  }
+  HOSTDEVICE static phi::dtype::float8_e5m2(max)() {
+    return phi::dtype::raw_uint8_to_float8_e5m2(0x7b);
+  }
+  HOSTDEVICE static phi::dtype::float8_e5m2 epsilon() {
+    return phi::dtype::raw_uint8_to_float8_e5m2(0x34);
+  }
+  HOSTDEVICE static phi::dtype::float8_e5m2 round_error() {
+    return phi::dtype::raw_uint8_to_float8_e5m2(0x38);
+  }
+  HOSTDEVICE static phi::dtype::float8_e5m2 infinity() {
+    return phi::dtype::raw_uint8_to_float8_e5m2(0x7c);
+  }
+  HOSTDEVICE static phi::dtype::float8_e5m2 quiet_NaN() {
+    return phi::dtype::raw_uint8_to_float8_e5m2(0x7e);
+  }
+  HOSTDEVICE static phi::dtype::float8_e5m2 signaling_NaN() {
+    return phi::dtype::raw_uint8_to_float8_e5m2(0x7d);
+  }
+  HOSTDEVICE static phi::dtype::float8_e5m2 denorm_min() {
+    return phi::dtype::raw_uint8_to_float8_e5m2(0x01);
+  }
+};
+
+}  // namespace std
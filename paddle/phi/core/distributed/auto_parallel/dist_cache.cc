@@ -0,0 +1,77 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/distributed/auto_parallel/dist_cache.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_int64(auto_parallel_dist_cache_size);
+
+namespace phi {
+namespace distributed {
+
+int64_t DistCacheCapacity() { return FLAGS_auto_parallel_dist_cache_size; }
+
+void DistCacheKey::Append(const DistMetaTensor& tensor) {
+  // An empty optional input is of no tensor and no dtype.
+  Append(tensor.initialized());
+  if (tensor.initialized()) {
+    Append(tensor.dtype());
+  }
+  Append(tensor.dims());
+  Append(tensor.dist_attr());
+}
+
+void DistCacheKey::Append(const TensorDistAttr& dist_attr) {
+  const auto& process_mesh = dist_attr.process_mesh();
+  Append(process_mesh.shape());
+  Append(process_mesh.process_ids());
+  Append(process_mesh.dim_names());
+  Append(dist_attr.dims_mapping());
+  Append(dist_attr.batch_dim());
+  Append(dist_attr.chunk_id());
+  Append(dist_attr.dynamic_dims());
+  // The partial status is a hash map, whose order is not of the dims.
+  std::vector<std::pair<int64_t, ReduceType>> partial_status(
+      dist_attr.partial_status().begin(), dist_attr.partial_status().end());
+  std::sort(partial_status.begin(), partial_status.end());
+  Append(partial_status.size());
+  for (const auto& item : partial_status) {
+    Append(item.first);
+    Append(item.second);
+  }
+}
+
+void DistCacheKey::Append(const DDim& dims) {
+  Append(dims.size());
+  for (int i = 0; i < dims.size(); ++i) {
+    Append(dims[i]);
+  }
+}
+
+void DistCacheKey::Append(const std::string& str) {
+  Append(str.size());
+  key_.append(str);
+}
+
+DistCache<SpmdInfo>& GetInferSpmdCache() {
+  static DistCache<SpmdInfo> cache;
+  return cache;
+}
+
+}  // namespace distributed
+}  // namespace phi
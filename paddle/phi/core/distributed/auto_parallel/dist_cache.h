@@ -0,0 +1,140 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/phi/common/scalar.h"
+#include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
+#include "paddle/phi/core/distributed/auto_parallel/dist_meta_tensor.h"
+#include "paddle/phi/core/distributed/type_defs.h"
+
+namespace phi {
+namespace distributed {
+
+// The max number of the entries of a DistCache, by
+// FLAGS_auto_parallel_dist_cache_size.
+int64_t DistCacheCapacity();
+
+// The bytes of the dims, the dist attrs and the attrs that the InferSpmd
+// rules and the reshard functions decide by. A key of an argument of an
+// unknown type is not cacheable.
+class DistCacheKey {
+ public:
+  DistCacheKey() = default;
+  explicit DistCacheKey(const std::string& name) { Append(name); }
+
+  void Append(const DistMetaTensor& tensor);
+  void Append(const TensorDistAttr& dist_attr);
+  void Append(const DDim& dims);
+  void Append(const std::string& str);
+  void Append(const char* str) { Append(std::string(str)); }
+
+  template <typename T>
+  void Append(const T& value) {
+    if constexpr (std::is_arithmetic<T>::value || std::is_enum<T>::value) {
+      key_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    } else if constexpr (std::is_pointer<T>::value) {
+      Append(value != nullptr);
+      if (value != nullptr) {
+        Append(*value);
+      }
+    } else {
+      cacheable_ = false;
+    }
+  }
+
+  template <typename T>
+  void Append(const paddle::experimental::ScalarBase<T>& scalar) {
+    Append(scalar.dtype());
+    Append(scalar.ToString());
+  }
+
+  template <typename T>
+  void Append(const std::vector<T>& values) {
+    Append(values.size());
+    for (const auto& value : values) {
+      Append(static_cast<const T&>(value));
+    }
+  }
+
+  bool cacheable() const { return cacheable_; }
+  const std::string& str() const { return key_; }
+
+ private:
+  std::string key_;
+  bool cacheable_{true};
+};
+
+// A map of the decisions by the DistCacheKey, cleared once it is full.
+template <typename Value>
+class DistCache {
+ public:
+  bool Get(const DistCacheKey& key, Value* value) const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto iter = cache_.find(key.str());
+    if (iter == cache_.end()) {
+      return false;
+    }
+    *value = iter->second;
+    return true;
+  }
+
+  void Put(const DistCacheKey& key, const Value& value) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (static_cast<int64_t>(cache_.size()) >= DistCacheCapacity()) {
+      cache_.clear();
+    }
+    cache_.emplace(key.str(), value);
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Value> cache_;
+};
+
+DistCache<SpmdInfo>& GetInferSpmdCache();
+
+// Runs the InferSpmd rule by infer_spmd(), or reuses its result of the same
+// rule_name and args, which are the args to the rule. The rules are the pure
+// functions of the dims and the dist attrs of the inputs and of the attrs, so
+// the same placements of every step are inferred only once.
+template <typename InferSpmdFn, typename... Args>
+SpmdInfo CachedInferSpmd(const char* rule_name,
+                         const InferSpmdFn& infer_spmd,
+                         const Args&... args) {
+  if (DistCacheCapacity() <= 0) {
+    return infer_spmd();
+  }
+  DistCacheKey key(rule_name);
+  (key.Append(args), ...);
+  if (!key.cacheable()) {
+    return infer_spmd();
+  }
+  SpmdInfo spmd_info;
+  if (GetInferSpmdCache().Get(key, &spmd_info)) {
+    return spmd_info;
+  }
+  spmd_info = infer_spmd();
+  GetInferSpmdCache().Put(key, spmd_info);
+  return spmd_info;
+}
+
+}  // namespace distributed
+}  // namespace phi
@@ -0,0 +1,290 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/distributed/auto_parallel/reshard/elastic_reshard_function.h"
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <utility>
+
+#include "glog/logging.h"
+#include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
+#include "paddle/phi/core/distributed/auto_parallel/dist_tensor.h"
+#include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_utils.h"
+#include "paddle/phi/core/distributed/store/store_utils.h"
+#include "paddle/phi/kernels/concat_kernel.h"
+#include "paddle/phi/kernels/p_recv_kernel.h"
+#include "paddle/phi/kernels/p_send_kernel.h"
+#include "paddle/phi/kernels/slice_kernel.h"
+
+namespace phi {
+namespace distributed {
+
+namespace {
+
+// The [begin, end) of every dim of a block of the global tensor.
+using Box = std::vector<std::pair<int64_t, int64_t>>;
+
+struct Transfer {
+  int64_t src;
+  int64_t dst;
+  Box box;
+};
+
+// The block of the global tensor held by the index-th process of the mesh.
+Box ShardBox(const DDim& dims,
+             const ProcessMesh& mesh,
+             const std::vector<int64_t>& dims_mapping,
+             int64_t index) {
+  const auto& shape = mesh.shape();
+  std::vector<int64_t> coord(shape.size());
+  for (int64_t i = static_cast<int64_t>(shape.size()) - 1; i >= 0; --i) {
+    coord[i] = index % shape[i];
+    index /= shape[i];
+  }
+  Box box;
+  for (int d = 0; d < dims.size(); ++d) {
+    const int64_t mesh_dim = dims_mapping[d];
+    if (mesh_dim < 0) {
+      box.emplace_back(0, dims[d]);
+      continue;
+    }
+    auto sizes = BalancedSplit(dims[d], shape[mesh_dim]);
+    const int64_t begin = std::accumulate(
+        sizes.begin(), sizes.begin() + coord[mesh_dim], int64_t(0));
+    box.emplace_back(begin, begin + sizes[coord[mesh_dim]]);
+  }
+  return box;
+}
+
+Box Intersect(const Box& a, const Box& b) {
+  Box box;
+  for (size_t d = 0; d < a.size(); ++d) {
+    box.emplace_back(std::max(a[d].first, b[d].first),
+                     std::min(a[d].second, b[d].second));
+  }
+  return box;
+}
+
+int64_t Numel(const Box& box) {
+  int64_t numel = 1;
+  for (const auto& range : box) {
+    numel *= std::max(range.second - range.first, int64_t(0));
+  }
+  return numel;
+}
+
+// Slices the box out of x, which is the block `held` of the global tensor.
+template <typename T, typename Context>
+void SliceBox(const Context& dev_ctx,
+              const DenseTensor& x,
+              const Box& held,
+              const Box& box,
+              DenseTensor* out) {
+  *out = x;
+  for (size_t d = 0; d < box.size(); ++d) {
+    if (box[d] == held[d]) {
+      continue;
+    }
+    std::vector<int64_t> axes = {static_cast<int64_t>(d)};
+    std::vector<int64_t> starts = {box[d].first - held[d].first};
+    std::vector<int64_t> ends = {box[d].second - held[d].first};
+    *out = Slice<T, Context>(dev_ctx, *out, axes, starts, ends);
+  }
+}
+
+// The pieces are a grid partition of a box, and are concatenated from the
+// last dim to the first one.
+DenseTensor Assemble(DeviceContext* dev_ctx,
+                     DataType dtype,
+                     std::vector<std::pair<Box, DenseTensor>>* pieces,
+                     size_t dim) {
+  if (pieces->size() == 1) {
+    return pieces->front().second;
+  }
+  PADDLE_ENFORCE_LT(dim,
+                    pieces->front().first.size(),
+                    phi::errors::InvalidArgument(
+                        "The pieces of the elastic reshard overlap, which "
+                        "is not a partition of the output tensor."));
+  std::map<int64_t, std::vector<std::pair<Box, DenseTensor>>> groups;
+  for (auto& piece : *pieces) {
+    groups[piece.first[dim].first].push_back(std::move(piece));
+  }
+  std::vector<DenseTensor> parts;
+  for (auto& group : groups) {
+    parts.push_back(Assemble(dev_ctx, dtype, &group.second, dim + 1));
+  }
+  if (parts.size() == 1) {
+    return parts.front();
+  }
+  std::vector<const DenseTensor*> concat_input_vec;
+  for (const auto& part : parts) {
+    concat_input_vec.emplace_back(&part);
+  }
+  DenseTensor out;
+  RESHARD_FUNCTOR(
+      dev_ctx, Concat, dtype, concat_input_vec, static_cast<int>(dim), &out);
+  return out;
+}
+
+}  // namespace
+
+bool ElasticReshardFunction::IsSuitable(const DistTensor& in,
+                                        const TensorDistAttr& out_dist_attr) {
+  const auto& in_dist_attr = in.dist_attr();
+
+  RESHARD_SHORTCUT_IF_FALSE(!in_dist_attr.is_partial());
+  RESHARD_SHORTCUT_IF_FALSE(!out_dist_attr.is_partial());
+
+  const auto& in_process_mesh = in_dist_attr.process_mesh();
+  const auto& out_process_mesh = out_dist_attr.process_mesh();
+  RESHARD_SHORTCUT_IF_FALSE(in_process_mesh != out_process_mesh);
+  RESHARD_SHORTCUT_IF_FALSE(in_process_mesh.shape() !=
+                            out_process_mesh.shape());
+
+  return true;
+}
+
+void ElasticReshardFunction::Eval(phi::DeviceContext* dev_ctx,
+                                  const DistTensor& in,
+                                  const TensorDistAttr& out_dist_attr,
+                                  DistTensor* out) {
+  VLOG(3) << "Call ElasticReshardFunction Eval";
+  const auto& in_dist_attr = in.dist_attr();
+  const auto& in_process_mesh = in_dist_attr.process_mesh();
+  const auto& in_process_ids = in_process_mesh.process_ids();
+  const auto& out_process_mesh = out_dist_attr.process_mesh();
+  const auto& out_process_ids = out_process_mesh.process_ids();
+  auto all_process_ids = GetUnionProcessIds(in_process_ids, out_process_ids);
+  auto dtype = in.dtype();
+  const auto& dims = in.dims();
+  bool dynamic_shape = true;
+  int64_t cur_global_rank = GetCurGlobalRank();
+
+  // The input ranks holding the same block, e.g. by replicate.
+  std::map<Box, std::vector<int64_t>> holders;
+  Box cur_in_box;
+  for (size_t i = 0; i < in_process_ids.size(); ++i) {
+    Box box = ShardBox(
+        dims, in_process_mesh, in_dist_attr.dims_mapping(), i);
+    if (in_process_ids[i] == cur_global_rank) {
+      cur_in_box = box;
+    }
+    holders[box].push_back(in_process_ids[i]);
+  }
+
+  // All the ranks plan the same transfers. A piece is taken from the output
+  // rank itself if it holds it, or else from the holder sending the least.
+  std::map<int64_t, int64_t> send_numel;
+  std::vector<Transfer> transfers;
+  Box cur_out_box;
+  bool has_remote = false;
+  for (size_t i = 0; i < out_process_ids.size(); ++i) {
+    const int64_t dst = out_process_ids[i];
+    Box out_box = ShardBox(
+        dims, out_process_mesh, out_dist_attr.dims_mapping(), i);
+    for (const auto& item : holders) {
+      Box piece = Intersect(item.first, out_box);
+      const int64_t numel = Numel(piece);
+      if (numel == 0) {
+        continue;
+      }
+      const auto& ranks = item.second;
+      int64_t src = dst;
+      if (std::find(ranks.begin(), ranks.end(), dst) == ranks.end()) {
+        src = *std::min_element(
+            ranks.begin(), ranks.end(), [&](int64_t a, int64_t b) {
+              return send_numel[a] < send_numel[b];
+            });
+        send_numel[src] += numel;
+        has_remote = true;
+      }
+      transfers.push_back({src, dst, std::move(piece)});
+    }
+    if (dst == cur_global_rank) {
+      cur_out_box = std::move(out_box);
+    }
+  }
+  VLOG(3) << "ElasticReshard: " << transfers.size()
+          << " pieces are moved among " << all_process_ids.size()
+          << " processes.";
+
+  // Creating the communicator is collective over all the processes, even
+  // those of no transfers.
+  if (has_remote && std::find(all_process_ids.begin(),
+                              all_process_ids.end(),
+                              cur_global_rank) != all_process_ids.end()) {
+    dev_ctx->SetCommContext(CreateOrGetCommContext(*dev_ctx, all_process_ids));
+  }
+
+  std::vector<std::pair<Box, DenseTensor>> pieces;
+  for (const auto& transfer : transfers) {
+    if (transfer.src == cur_global_rank) {
+      DenseTensor piece;
+      RESHARD_FUNCTOR(dev_ctx,
+                      SliceBox,
+                      dtype,
+                      in.value(),
+                      cur_in_box,
+                      transfer.box,
+                      &piece);
+      if (transfer.dst == cur_global_rank) {
+        pieces.emplace_back(transfer.box, std::move(piece));
+        continue;
+      }
+      VLOG(3) << "Send from src " << transfer.src << " to dst "
+              << transfer.dst;
+      int64_t dst_local_rank =
+          GetLocalRankInParticipate(all_process_ids, transfer.dst);
+      RESHARD_FUNCTOR(
+          dev_ctx, PSendKernel, dtype, piece, dst_local_rank, dynamic_shape);
+    } else if (transfer.dst == cur_global_rank) {
+      VLOG(3) << "Recv from src " << transfer.src << " to dst "
+              << transfer.dst;
+      int64_t src_local_rank =
+          GetLocalRankInParticipate(all_process_ids, transfer.src);
+      DenseTensor piece;
+      RESHARD_FUNCTOR(
+          dev_ctx, PRecv, dtype, src_local_rank, dynamic_shape, &piece);
+      pieces.emplace_back(transfer.box, std::move(piece));
+    }
+  }
+
+  if (!out_process_mesh.contains(cur_global_rank)) {
+    // As the cross-mesh reshard of the same status, out must be defined on
+    // the ranks out of the output mesh.
+    *(out->unsafe_mutable_value()) =
+        phi::DenseTensor(std::make_shared<phi::Allocation>(
+                             nullptr, 0, phi::distributed::GetDefaultPlace()),
+                         in.value().meta());
+  } else if (pieces.empty()) {
+    // The shard of the current rank is empty.
+    DenseTensor empty;
+    std::vector<int64_t> local_dims;
+    for (const auto& range : cur_out_box) {
+      local_dims.push_back(range.second - range.first);
+    }
+    empty.Resize(common::make_ddim(local_dims));
+    dev_ctx->Alloc(&empty, dtype);
+    SetValue(out, empty);
+  } else {
+    SetValue(out, Assemble(dev_ctx, dtype, &pieces, 0));
+  }
+  SetDistProps(out, in.dims(), out_dist_attr);
+}
+
+}  // namespace distributed
+}  // namespace phi
@@ -14,7 +14,9 @@
 
 #include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_function_registry.h"
 
+#include "paddle/phi/core/distributed/auto_parallel/dist_cache.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_tensor.h"
+#include "paddle/phi/core/distributed/auto_parallel/reshard/elastic_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/nd_mesh_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/p_to_r_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/p_to_s_reshard_function.h"
@@ -30,10 +32,28 @@
 namespace phi {
 namespace distributed {
 
+// The reshard functions are suitable by the dims and the dist attrs of the
+// input and the output dist attr, for the current rank.
 ReshardFunction* ChooseProperReshardFunction(
     const DistTensor& in, const TensorDistAttr& out_dist_attr) {
+  static DistCache<ReshardFunction*> cache;
+  DistCacheKey key;
+  const bool cached = DistCacheCapacity() > 0;
+  if (cached) {
+    key.Append(in.dims());
+    key.Append(in.local_dims());
+    key.Append(in.dist_attr());
+    key.Append(out_dist_attr);
+    ReshardFunction* func = nullptr;
+    if (cache.Get(key, &func)) {
+      return func;
+    }
+  }
   for (const auto& func : GetReshardFunctionList()) {
     if (func->IsSuitable(in, out_dist_attr)) {
+      if (cached) {
+        cache.Put(key, func.get());
+      }
       return func.get();
     }
   }
@@ -70,6 +90,7 @@ REGISTER_RESHARD_FUNC(SToSReshardFunctionCrossMesh);
 REGISTER_RESHARD_FUNC(XToRShrinkReshardFunction);
 REGISTER_RESHARD_FUNC(RToXExpandReshardFunction);
 REGISTER_RESHARD_FUNC(SameStatusReshardFunction);
+REGISTER_RESHARD_FUNC(ElasticReshardFunction);
 REGISTER_RESHARD_FUNC(SameNdMeshReshardFunction);
 REGISTER_RESHARD_FUNC(CrossNdMeshReshardFunction);
 
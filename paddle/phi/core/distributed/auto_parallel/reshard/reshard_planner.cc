@@ -0,0 +1,215 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_planner.h"
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "glog/logging.h"
+#include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace phi {
+namespace distributed {
+
+namespace {
+
+using MeshStatus = std::vector<int64_t>;
+// the communication volume, then the number of steps
+using PlanCost = std::pair<double, int64_t>;
+
+MeshStatus GetMeshStatus(const TensorDistAttr& dist_attr) {
+  MeshStatus status(dist_attr.process_mesh().ndim(), kReshardReplicated);
+  const auto& dims_mapping = dist_attr.dims_mapping();
+  for (int64_t i = 0; i < static_cast<int64_t>(dims_mapping.size()); ++i) {
+    if (dims_mapping[i] != -1) {
+      status[dims_mapping[i]] = i;
+    }
+  }
+  for (const auto& kv : dist_attr.partial_status()) {
+    status[kv.first] = kReshardPartial;
+  }
+  return status;
+}
+
+double LocalNumel(const DDim& dims,
+                  const ProcessMesh& mesh,
+                  const MeshStatus& status) {
+  double numel = static_cast<double>(common::product(dims));
+  for (int64_t axis = 0; axis < static_cast<int64_t>(status.size()); ++axis) {
+    if (status[axis] >= 0) {
+      numel /= mesh.dim_size(axis);
+    }
+  }
+  return numel;
+}
+
+bool IsDimFree(const MeshStatus& status, int64_t dim) {
+  for (auto s : status) {
+    if (s == dim) return false;
+  }
+  return true;
+}
+
+// the next status of the mesh axis and the volume of the step, a rank holds
+// local_numel elements before the step
+void ForEachNextStatus(const DDim& dims,
+                       const MeshStatus& status,
+                       int64_t axis,
+                       int64_t nranks,
+                       double local_numel,
+                       bool in_partial_sum,
+                       bool out_partial,
+                       const std::function<void(int64_t, double)>& fn) {
+  const double n = static_cast<double>(nranks);
+  const int64_t cur = status[axis];
+  if (cur == kReshardPartial) {
+    fn(kReshardReplicated, 2 * (n - 1) / n * local_numel);
+  } else if (cur >= 0) {
+    fn(kReshardReplicated, (n - 1) * local_numel);
+  } else if (out_partial) {
+    fn(kReshardPartial, 0);
+  }
+  for (int64_t dim = 0; dim < dims.size(); ++dim) {
+    if (dim == cur || !IsDimFree(status, dim)) continue;
+    if (cur == kReshardReplicated) {
+      fn(dim, 0);
+    } else if (cur == kReshardPartial) {
+      // the reduce-scatter splits the dim evenly
+      if (in_partial_sum && dims[dim] % nranks == 0) {
+        fn(dim, (n - 1) / n * local_numel);
+      }
+    } else if (dims[cur] % nranks == 0 && dims[dim] % nranks == 0) {
+      fn(dim, (n - 1) / n * local_numel);
+    }
+  }
+}
+
+std::vector<NdMeshReshardStep> SearchPlan(const DDim& dims,
+                                          const TensorDistAttr& in_dist_attr,
+                                          const TensorDistAttr& out_dist_attr) {
+  const auto& mesh = in_dist_attr.process_mesh();
+  const MeshStatus in_status = GetMeshStatus(in_dist_attr);
+  const MeshStatus out_status = GetMeshStatus(out_dist_attr);
+
+  struct Visit {
+    PlanCost cost;
+    MeshStatus prev;
+    NdMeshReshardStep step;
+  };
+  std::map<MeshStatus, Visit> visits;
+  using Item = std::pair<PlanCost, MeshStatus>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+  visits[in_status] = Visit{PlanCost{0.0, 0}, {}, {}};
+  queue.emplace(PlanCost{0.0, 0}, in_status);
+
+  while (!queue.empty()) {
+    const PlanCost cost = queue.top().first;
+    const MeshStatus status = queue.top().second;
+    queue.pop();
+    if (cost > visits[status].cost) continue;
+    if (status == out_status) break;
+    const double local_numel = LocalNumel(dims, mesh, status);
+    for (int64_t axis = 0; axis < static_cast<int64_t>(status.size());
+         ++axis) {
+      // a partial axis is only produced for the output, and the axes the
+      // output keeps partial are not changed
+      if (status[axis] == kReshardPartial &&
+          out_status[axis] == kReshardPartial) {
+        continue;
+      }
+      bool in_partial_sum =
+          in_dist_attr.is_partial(axis) &&
+          in_dist_attr.partial_status().at(axis) == ReduceType::kRedSum;
+      ForEachNextStatus(
+          dims,
+          status,
+          axis,
+          mesh.dim_size(axis),
+          local_numel,
+          in_partial_sum,
+          out_status[axis] == kReshardPartial,
+          [&](int64_t next, double volume) {
+            MeshStatus next_status = status;
+            next_status[axis] = next;
+            PlanCost next_cost{cost.first + volume, cost.second + 1};
+            auto iter = visits.find(next_status);
+            if (iter != visits.end() && iter->second.cost <= next_cost) {
+              return;
+            }
+            visits[next_status] = Visit{
+                next_cost,
+                status,
+                NdMeshReshardStep{axis, status[axis], next, volume}};
+            queue.emplace(next_cost, next_status);
+          });
+    }
+  }
+
+  PADDLE_ENFORCE_NE(
+      visits.find(out_status),
+      visits.end(),
+      phi::errors::Unimplemented(
+          "Can not plan the reshard from in_dist_attr=%s to out_dist_attr=%s.",
+          in_dist_attr.to_string(),
+          out_dist_attr.to_string()));
+  std::vector<NdMeshReshardStep> steps;
+  for (MeshStatus status = out_status; status != in_status;) {
+    const auto& visit = visits.at(status);
+    steps.push_back(visit.step);
+    status = visit.prev;
+  }
+  return {steps.rbegin(), steps.rend()};
+}
+
+}  // namespace
+
+std::vector<NdMeshReshardStep> PlanNdMeshReshard(
+    const DDim& dims,
+    const TensorDistAttr& in_dist_attr,
+    const TensorDistAttr& out_dist_attr) {
+  PADDLE_ENFORCE_EQ(in_dist_attr.process_mesh(),
+                    out_dist_attr.process_mesh(),
+                    phi::errors::InvalidArgument(
+                        "The reshard planner needs the same process mesh, but "
+                        "got %s and %s.",
+                        in_dist_attr.process_mesh().to_string(),
+                        out_dist_attr.process_mesh().to_string()));
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::vector<NdMeshReshardStep>> plans;
+  std::string key = dims.to_str() + in_dist_attr.to_string() + "->" +
+                    out_dist_attr.to_string();
+  std::lock_guard<std::mutex> lock(mutex);
+  auto iter = plans.find(key);
+  if (iter != plans.end()) return iter->second;
+
+  auto steps = SearchPlan(dims, in_dist_attr, out_dist_attr);
+  if (VLOG_IS_ON(3)) {
+    for (const auto& step : steps) {
+      VLOG(3) << "Reshard plan step: mesh axis " << step.mesh_axis << " from "
+              << step.in_status << " to " << step.out_status
+              << ", communication volume " << step.comm_volume;
+    }
+  }
+  return plans.emplace(key, std::move(steps)).first->second;
+}
+
+}  // namespace distributed
+}  // namespace phi
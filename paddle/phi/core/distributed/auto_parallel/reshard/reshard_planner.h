@@ -0,0 +1,54 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+#include "paddle/phi/core/ddim.h"
+
+namespace phi {
+namespace distributed {
+
+class TensorDistAttr;
+
+// The status of a mesh axis in a reshard plan, it is kReshardReplicated,
+// kReshardPartial, or the tensor dim the mesh axis shards
+constexpr int64_t kReshardReplicated = -1;
+constexpr int64_t kReshardPartial = -2;
+
+// A reshard on a single mesh axis, it runs on the sub mesh of the axis
+struct NdMeshReshardStep {
+  int64_t mesh_axis;
+  int64_t in_status;
+  int64_t out_status;
+  // the estimated number of elements a rank communicates
+  double comm_volume;
+};
+
+// Plans the reshard from in_dist_attr to out_dist_attr on the same process
+// mesh as the single mesh axis reshards of the least communication volume.
+// A step runs a p_to_r (allreduce), p_to_s (reduce-scatter), s_to_r
+// (all-gather), s_to_s (all-to-all), r_to_s or r_to_p reshard function on its
+// axis, so e.g. the partial axis to be sharded takes a reduce-scatter, and a
+// mesh axis to shard another tensor dim takes an all-to-all, rather than a
+// replication then a slice. The plans are cached by the dims and the dist
+// attrs.
+std::vector<NdMeshReshardStep> PlanNdMeshReshard(
+    const DDim& dims,
+    const TensorDistAttr& in_dist_attr,
+    const TensorDistAttr& out_dist_attr);
+
+}  // namespace distributed
+}  // namespace phi
@@ -56,6 +56,26 @@ void CommContextManager::SetDeviceId(int dev_id) {
 }
 
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+// The NCCLCommContext runs on a GPUContext of the device set by SetDeviceId.
+static void SetNCCLDevContext(NCCLCommContext* nccl_comm_context,
+                              int device_id) {
+  std::unique_ptr<phi::GPUContext> dev_ctx(
+      new phi::GPUContext(phi::GPUPlace(device_id)));
+  dev_ctx->SetAllocator(
+      phi::memory_utils::GetAllocator(device_id, dev_ctx->stream()));
+  dev_ctx->SetHostAllocator(phi::memory_utils::GetHostAllocator());
+  dev_ctx->SetZeroAllocator(phi::memory_utils::GetZeroAllocator(device_id));
+  dev_ctx->SetHostZeroAllocator(phi::memory_utils::GetHostZeroAllocator());
+  dev_ctx->SetPinnedAllocator(phi::memory_utils::GetPinnedAllocator());
+  dev_ctx->PartialInitWithAllocator();
+  auto compute_event = phi::memory_utils::GetCudaEvent(device_id);
+  auto comm_event = phi::memory_utils::GetCudaEvent(device_id);
+
+  nccl_comm_context->SetDevContext(std::move(dev_ctx));
+  nccl_comm_context->SetComputeEvent(std::move(compute_event));
+  nccl_comm_context->SetCommEvent(std::move(comm_event));
+}
+
 void CommContextManager::CreateNCCLCommContext(
     const std::shared_ptr<Store>& store,
     const std::string& unique_comm_key,
@@ -94,29 +114,51 @@ void CommContextManager::CreateNCCLCommContext(
   auto nccl_comm_context =
       std::make_unique<NCCLCommContext>(rank, size, nccl_id);
   if (CommContextManager::device_id != -1) {
-    std::unique_ptr<phi::GPUContext> dev_ctx(
-        new phi::GPUContext(phi::GPUPlace(CommContextManager::device_id)));
-    dev_ctx->SetAllocator(phi::memory_utils::GetAllocator(
-        CommContextManager::device_id, dev_ctx->stream()));
-    dev_ctx->SetHostAllocator(phi::memory_utils::GetHostAllocator());
-    dev_ctx->SetZeroAllocator(
-        phi::memory_utils::GetZeroAllocator(CommContextManager::device_id));
-    dev_ctx->SetHostZeroAllocator(phi::memory_utils::GetHostZeroAllocator());
-    dev_ctx->SetPinnedAllocator(phi::memory_utils::GetPinnedAllocator());
-    dev_ctx->PartialInitWithAllocator();
-    auto compute_event =
-        phi::memory_utils::GetCudaEvent(CommContextManager::device_id);
-    auto comm_event =
-        phi::memory_utils::GetCudaEvent(CommContextManager::device_id);
-
-    nccl_comm_context->SetDevContext(std::move(dev_ctx));
-    nccl_comm_context->SetComputeEvent(std::move(compute_event));
-    nccl_comm_context->SetCommEvent(std::move(comm_event));
+    SetNCCLDevContext(nccl_comm_context.get(), CommContextManager::device_id);
   }
 
   comm_context_manager.SetStore(store);
   comm_context_manager.Emplace(unique_comm_key, std::move(nccl_comm_context));
 }
+
+bool CommContextManager::SplitNCCLCommContext(
+    const std::string& parent_comm_key,
+    const std::string& unique_comm_key,
+    int rank,
+    int size) {
+#if defined(PADDLE_WITH_NCCL) && NCCL_VERSION_CODE >= 21800
+  auto& comm_context_manager = CommContextManager::GetInstance();
+  int nccl_version = 0;
+  NCCL_CHECK(phi::dynload::ncclGetVersion(&nccl_version));
+  if (nccl_version < 21800 || !comm_context_manager.Has(parent_comm_key)) {
+    return false;
+  }
+  auto* parent = static_cast<NCCLCommContext*>(
+      comm_context_manager.Get(parent_comm_key));
+  // The ranks out of the group are of no color, and get no communicator.
+  ncclComm_t nccl_comm = nullptr;
+  NCCL_CHECK(phi::dynload::ncclCommSplit(parent->GetNcclComm(),
+                                         rank < 0 ? NCCL_SPLIT_NOCOLOR : 0,
+                                         rank < 0 ? 0 : rank,
+                                         &nccl_comm,
+                                         nullptr));
+  VLOG(3) << "split NCCLCommContext rank: " << rank << ", size: " << size
+          << ", unique_comm_key: " << unique_comm_key
+          << " from parent_comm_key: " << parent_comm_key;
+  if (rank < 0 || comm_context_manager.Has(unique_comm_key)) {
+    return true;
+  }
+  auto nccl_comm_context =
+      std::make_unique<NCCLCommContext>(rank, size, nccl_comm);
+  if (CommContextManager::device_id != -1) {
+    SetNCCLDevContext(nccl_comm_context.get(), CommContextManager::device_id);
+  }
+  comm_context_manager.Emplace(unique_comm_key, std::move(nccl_comm_context));
+  return true;
+#else
+  return false;
+#endif
+}
 #endif
 
 #if defined(PADDLE_WITH_GLOO)
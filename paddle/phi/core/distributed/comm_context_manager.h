@@ -78,6 +78,16 @@ class CommContextManager {
                                     int size,
                                     const std::string& hash_key = "",
                                     const P2POption* opt = nullptr);
+
+  // Derives the communicator of unique_comm_key from the one of
+  // parent_comm_key by ncclCommSplit, instead of a new ncclCommInitRank by
+  // the store. It is collective over all the ranks of the parent, and those
+  // out of the group are of the rank -1. Returns false if the NCCL is older
+  // than 2.18 or the parent is not created.
+  static bool SplitNCCLCommContext(const std::string& parent_comm_key,
+                                   const std::string& unique_comm_key,
+                                   int rank,
+                                   int size);
 #endif
 
 #if defined(PADDLE_WITH_GLOO)
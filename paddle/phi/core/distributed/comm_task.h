@@ -79,6 +79,10 @@ class CommTask {
   int GetSize() { return size_; }
   int GetGid() { return gid_; }
   int64_t GetNumel() { return numel_; }
+  int64_t GetBytes() { return bytes_; }
+  void SetBytes(int64_t bytes) { bytes_ = bytes; }
+  // the host time in ns when the task is enqueued to the stream
+  uint64_t GetHostStartNs() { return host_start_ns_; }
   uint64_t GetSeq() { return seq_; }
   CommType GetCommType() { return comm_type_; }
   bool GetTraceUpdated() { return start_trace_updated_; }
@@ -149,6 +153,12 @@ class CommTask {
         phi::errors::Unimplemented("%s is not implemented.", __func__));
     return;
   }
+  // the device time of the completed task, negative if it is not timed
+  virtual float GetElapsedMillis() {
+    PADDLE_THROW(
+        phi::errors::Unimplemented("%s is not implemented.", __func__));
+    return -1.0f;
+  }
 
  protected:
   std::string backend_;
@@ -160,6 +170,8 @@ class CommTask {
   int gid_;
   uint64_t seq_{0};
   int64_t numel_;
+  int64_t bytes_{0};
+  uint64_t host_start_ns_{0};
   ncclComm_t nccl_comm_;
   gpuStream_t nccl_stream_;
   CommType comm_type_;
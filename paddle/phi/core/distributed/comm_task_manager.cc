@@ -22,21 +22,32 @@
 
 #include "paddle/phi/core/distributed/comm_context_manager.h"
 
+#include <algorithm>
 #include <future>
+#include <iomanip>
 #include <memory>
+#include <sstream>
 #include <string>
 
 #include "gflags/gflags.h"
 #include "glog/logging.h"
+#include "paddle/phi/api/profiler/common_event.h"
+#include "paddle/phi/api/profiler/event_tracing.h"
+#include "paddle/phi/api/profiler/host_event_recorder.h"
+#include "paddle/phi/api/profiler/host_tracer.h"
 #include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/core/distributed/store/store.h"
 #include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/flags.h"
 
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
 #include "paddle/phi/core/distributed/comm_task_manager.h"
 #include "paddle/phi/core/distributed/nccl_comm_context.h"
 #endif
 
+PHI_DECLARE_bool(enable_comm_profile);
+PHI_DECLARE_int32(comm_profile_skew_interval);
+
 namespace phi {
 namespace distributed {
 
@@ -62,6 +73,10 @@ std::unordered_map<std::string, std::shared_ptr<CommTask>>
 std::chrono::time_point<std::chrono::steady_clock>
     CommTaskManager::last_update_time_ = std::chrono::steady_clock::now();
 
+std::mutex CommTaskManager::comm_profile_mutex_;
+std::map<std::string, CommProfileStat> CommTaskManager::comm_profile_stats_;
+std::list<CommTaskManager::CommSkewCheck> CommTaskManager::comm_skew_checks_;
+
 CommTaskManager::CommTaskManager() {
   terminated_.store(false);
   comm_task_loop_thread_ = std::thread(&CommTaskManager::CommTaskLoop, this);
@@ -113,6 +128,9 @@ void CommTaskManager::Stop() {
     comm_task_clear_loop_thread_.join();
   }
 
+  if (FLAGS_enable_comm_profile) {
+    LOG(INFO) << "Comm profile summary:\n" << GetCommProfileSummary();
+  }
   LOG(INFO) << "CommTaskManager stopped.";
 }
 
@@ -182,6 +200,7 @@ void CommTaskManager::CommTaskLoop() {
       } else {
         if (task->IsStarted()) {
           if (task->IsCompleted()) {
+            RecordCommProfile(task);
             CommTaskClearEnqueue(task);
             iter = comm_task_list_.erase(iter);
           } else {
@@ -211,6 +230,7 @@ void CommTaskManager::CommTaskLoop() {
          iter != start_comm_task_map_.end();) {
       auto task = iter->second;
       if (task->IsCompleted()) {
+        RecordCommProfile(task);
         CommTaskClearEnqueue(task);
         UpdateLastCommTask(task);
         iter = start_comm_task_map_.erase(iter);
@@ -220,6 +240,8 @@ void CommTaskManager::CommTaskLoop() {
       }
     }
 
+    CheckCommSkew();
+
     if (comm_task_list_.empty() && init_comm_task_map_.empty() &&
         start_comm_task_map_.empty()) {
       done = true;
@@ -276,5 +298,159 @@ bool CommTaskManager::IsTimeout() {
   return std::chrono::duration_cast<std::chrono::milliseconds>(
              current_timepoint - last_update_time_) >= timeout_;
 }
+
+// the bus bandwidth over the algorithm bandwidth, as nccl-tests defines
+static double BusBandwidthFactor(CommType comm_type, int nranks) {
+  if (nranks <= 1) {
+    return 1.0;
+  }
+  switch (comm_type) {
+    case CommType::ALLREDUCE:
+      return 2.0 * (nranks - 1) / nranks;
+    case CommType::ALLGATHER:
+    case CommType::REDUCE_SCATTER:
+    case CommType::ALLTOALL:
+      return static_cast<double>(nranks - 1) / nranks;
+    default:
+      return 1.0;
+  }
+}
+
+void CommTaskManager::RecordCommProfile(std::shared_ptr<CommTask> task) {
+  if (!FLAGS_enable_comm_profile) {
+    return;
+  }
+  float elapsed_ms = task->GetElapsedMillis();
+  if (elapsed_ms < 0.0f) {
+    return;
+  }
+  const int nranks = task->GetSize();
+  const std::string op = CommTypeToString(task->GetCommType());
+  // the tensor of the allgather is the input shard
+  const int64_t bytes = task->GetCommType() == CommType::ALLGATHER
+                            ? task->GetBytes() * nranks
+                            : task->GetBytes();
+  const double algbw = elapsed_ms > 0.0f ? bytes / (elapsed_ms * 1e6) : 0.0;
+  const double busbw = algbw * BusBandwidthFactor(task->GetCommType(), nranks);
+  const std::string stat_key = task->GroupKey() + "/" + op;
+  {
+    std::lock_guard<std::mutex> lock(comm_profile_mutex_);
+    auto& stat = comm_profile_stats_[stat_key];
+    stat.count += 1;
+    stat.bytes += bytes;
+    stat.total_ms += elapsed_ms;
+    stat.max_ms = std::max(stat.max_ms, static_cast<double>(elapsed_ms));
+    stat.total_algbw += algbw;
+    stat.total_busbw += busbw;
+  }
+
+  // the trace event starts when the collective is enqueued on the host, and
+  // lasts the device time of the collective
+  if (HostTraceLevel::GetInstance().NeedTrace(kDefaultTraceLevel)) {
+    std::ostringstream attr;
+    attr << "group_key:" << task->GroupKey() << ",seq:" << task->GetSeq()
+         << ",bytes:" << bytes << ",algbw(GB/s):" << algbw
+         << ",busbw(GB/s):" << busbw;
+    uint64_t start_ns = task->GetHostStartNs();
+    uint64_t end_ns = start_ns + static_cast<uint64_t>(elapsed_ms * 1e6);
+    HostEventRecorder<CommonEvent>::GetInstance().RecordEvent(
+        "comm_" + op,
+        start_ns,
+        end_ns,
+        EventRole::kOrdinary,
+        TracerEventType::Communication,
+        attr.str());
+  }
+
+  // the ranks arriving earlier wait longer in the collective, so the device
+  // times of the ranks show the skew without synchronized clocks
+  auto store = task->GetStore();
+  const int interval = FLAGS_comm_profile_skew_interval;
+  if (store == nullptr || interval <= 0 || IsP2POP(task->GetCommType()) ||
+      task->GetSeq() % interval != 0) {
+    return;
+  }
+  const std::string store_key = "comm_profile/" + stat_key + "/" +
+                                std::to_string(task->GetSeq());
+  const std::string value = std::to_string(elapsed_ms);
+  store->set(store_key + "/" + std::to_string(task->GetRank()),
+             std::vector<uint8_t>(value.begin(), value.end()));
+  if (task->GetRank() == 0) {
+    std::lock_guard<std::mutex> lock(comm_profile_mutex_);
+    comm_skew_checks_.push_back(
+        CommSkewCheck{store, stat_key, store_key, nranks});
+  }
+}
+
+void CommTaskManager::CheckCommSkew() {
+  std::lock_guard<std::mutex> lock(comm_profile_mutex_);
+  for (auto iter = comm_skew_checks_.begin();
+       iter != comm_skew_checks_.end();) {
+    const auto& check = *iter;
+    bool ready = true;
+    for (int rank = 0; rank < check.size && ready; ++rank) {
+      ready = check.store->check(check.store_key + "/" + std::to_string(rank));
+    }
+    if (!ready) {
+      ++iter;
+      continue;
+    }
+    std::vector<std::string> keys;
+    for (int rank = 0; rank < check.size; ++rank) {
+      keys.push_back(check.store_key + "/" + std::to_string(rank));
+    }
+    auto values = check.store->multi_get(keys);
+    double min_ms = 0.0;
+    double max_ms = 0.0;
+    int straggler = 0;
+    for (int rank = 0; rank < check.size; ++rank) {
+      const auto& data = values[rank];
+      double elapsed_ms = std::stod(std::string(data.begin(), data.end()));
+      if (rank == 0 || elapsed_ms < min_ms) {
+        min_ms = elapsed_ms;
+        straggler = rank;
+      }
+      max_ms = rank == 0 ? elapsed_ms : std::max(max_ms, elapsed_ms);
+    }
+    auto& stat = comm_profile_stats_[check.stat_key];
+    const double skew_ms = max_ms - min_ms;
+    stat.skew_count += 1;
+    stat.total_skew_ms += skew_ms;
+    stat.max_skew_ms = std::max(stat.max_skew_ms, skew_ms);
+    stat.straggler_count[straggler] += 1;
+    VLOG(3) << "Comm skew of " << check.store_key << ": " << skew_ms
+            << " ms, straggler rank: " << straggler;
+    iter = comm_skew_checks_.erase(iter);
+  }
+}
+
+std::string CommTaskManager::GetCommProfileSummary() {
+  std::lock_guard<std::mutex> lock(comm_profile_mutex_);
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3);
+  for (const auto& iter : comm_profile_stats_) {
+    const auto& stat = iter.second;
+    if (stat.count == 0) {
+      continue;
+    }
+    os << iter.first << ": count:" << stat.count << ",bytes:" << stat.bytes
+       << ",avg_ms:" << stat.total_ms / stat.count
+       << ",max_ms:" << stat.max_ms
+       << ",avg_algbw(GB/s):" << stat.total_algbw / stat.count
+       << ",avg_busbw(GB/s):" << stat.total_busbw / stat.count;
+    if (stat.skew_count > 0) {
+      auto straggler = std::max_element(
+          stat.straggler_count.begin(),
+          stat.straggler_count.end(),
+          [](const auto& a, const auto& b) { return a.second < b.second; });
+      os << ",avg_skew_ms:" << stat.total_skew_ms / stat.skew_count
+         << ",max_skew_ms:" << stat.max_skew_ms
+         << ",straggler_rank:" << straggler->first << "("
+         << straggler->second << "/" << stat.skew_count << ")";
+    }
+    os << "\n";
+  }
+  return os.str();
+}
 }  // namespace distributed
 }  // namespace phi
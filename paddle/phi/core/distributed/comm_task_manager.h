@@ -18,8 +18,10 @@
 #include <condition_variable>
 #include <iostream>
 #include <list>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <unordered_map>
 
@@ -34,6 +36,23 @@ enum ErrorHandlingMode { NoHandling = 0, TearDown = 1 };
 
 class Store;
 
+// the profile of the collectives of a comm type in a group
+struct CommProfileStat {
+  int64_t count = 0;
+  int64_t bytes = 0;
+  double total_ms = 0.0;
+  double max_ms = 0.0;
+  // in GB/s
+  double total_algbw = 0.0;
+  double total_busbw = 0.0;
+  // the arrival skew found across the ranks
+  int64_t skew_count = 0;
+  double total_skew_ms = 0.0;
+  double max_skew_ms = 0.0;
+  // rank -> the times it arrives last
+  std::map<int, int64_t> straggler_count;
+};
+
 class CommTaskManager {
  public:
   CommTaskManager();
@@ -50,11 +69,24 @@ class CommTaskManager {
   void Stop();
   void UpdateLastCommTask(std::shared_ptr<CommTask> comm_task);
   void SetTimeout(int64_t timeout);
+  // the summary of the collectives profiled with FLAGS_enable_comm_profile
+  std::string GetCommProfileSummary();
 
  private:
+  // the skew check of a collective, run by the rank 0 of the group once the
+  // collective time of all the ranks is in the store
+  struct CommSkewCheck {
+    std::shared_ptr<Store> store;
+    std::string stat_key;
+    std::string store_key;
+    int size;
+  };
+
   void CommTaskLoop();
   void CommTaskClearLoop();
   bool IsTimeout();
+  void RecordCommProfile(std::shared_ptr<CommTask> task);
+  void CheckCommSkew();
 
   static std::thread comm_task_loop_thread_;
   static std::thread comm_task_clear_loop_thread_;
@@ -81,6 +113,11 @@ class CommTaskManager {
   static std::unordered_map<std::string, std::shared_ptr<CommTask>>
       group_last_comm_task_;
   static std::chrono::time_point<std::chrono::steady_clock> last_update_time_;
+
+  static std::mutex comm_profile_mutex_;
+  // group_key/op -> the profile of the collectives
+  static std::map<std::string, CommProfileStat> comm_profile_stats_;
+  static std::list<CommSkewCheck> comm_skew_checks_;
   std::chrono::milliseconds timeout_;
   bool logged_ = false;
 };
@@ -27,7 +27,11 @@
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/distributed/check/static_check.h"
+#include "paddle/phi/core/distributed/gloo_shm_allreduce.h"
 #include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_int64(gloo_shm_allreduce_min_bytes);
 
 namespace phi {
 namespace distributed {
@@ -42,6 +46,8 @@ GlooCommContext::GlooCommContext(
   gloo_context_->connectFullMesh(*store, device);
 }
 
+GlooCommContext::~GlooCommContext() = default;
+
 void GlooCommContext::Broadcast(phi::DenseTensor* out_tensor,
                                 const phi::DenseTensor& in_tensor,
                                 int root,
@@ -81,6 +87,19 @@ void GlooCommContext::AllReduce(phi::DenseTensor* out_tensor,
                                 const phi::DenseTensor& in_tensor,
                                 int reduce_type,
                                 uint32_t tag) {
+  // The sizes are the same on all the ranks, and so are the decisions.
+  const int64_t bytes = in_tensor.numel() * phi::SizeOf(in_tensor.dtype());
+  if (FLAGS_gloo_shm_allreduce_min_bytes > 0 && size_ > 1 &&
+      bytes >= FLAGS_gloo_shm_allreduce_min_bytes) {
+    if (!shm_allreducer_created_) {
+      shm_allreducer_ = GlooShmAllReducer::Create(gloo_context_);
+      shm_allreducer_created_ = true;
+    }
+    if (shm_allreducer_ != nullptr) {
+      shm_allreducer_->AllReduce(out_tensor, in_tensor, reduce_type);
+      return;
+    }
+  }
   gloo::AllreduceOptions opts(gloo_context_);
   opts.setTag(tag);
   const auto& dtype = in_tensor.dtype();
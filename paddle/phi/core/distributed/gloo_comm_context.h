@@ -26,6 +26,8 @@ namespace phi {
 class DenseTensor;
 namespace distributed {
 
+class GlooShmAllReducer;
+
 class GlooCommContext final : public CommContext {
  public:
   GlooCommContext(int rank,
@@ -33,6 +35,8 @@ class GlooCommContext final : public CommContext {
                   std::shared_ptr<gloo::rendezvous::Store> store,
                   std::shared_ptr<gloo::transport::Device> device);
 
+  ~GlooCommContext();
+
   void Broadcast(phi::DenseTensor* out_tensor,
                  const phi::DenseTensor& in_tensor,
                  int root,
@@ -74,6 +78,10 @@ class GlooCommContext final : public CommContext {
   DISABLE_COPY_AND_ASSIGN(GlooCommContext);
 
   std::shared_ptr<gloo::rendezvous::Context> gloo_context_;
+  // Created at the first allreduce of FLAGS_gloo_shm_allreduce_min_bytes,
+  // and nullptr if the ranks are not on the same host.
+  std::unique_ptr<GlooShmAllReducer> shm_allreducer_;
+  bool shm_allreducer_created_{false};
 };
 
 }  // namespace distributed
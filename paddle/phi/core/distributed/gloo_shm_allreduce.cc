@@ -0,0 +1,243 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/distributed/gloo_shm_allreduce.h"
+
+#include <gloo/allgather.h>
+#include <gloo/allreduce.h>
+#include <gloo/broadcast.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/distributed/gloo_utils.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace phi {
+namespace distributed {
+
+namespace {
+
+using ReduceFunc = void (*)(void*, const void*, const void*, size_t);
+
+// Takes the reduce function of gloo by SetReduceFunc.
+struct ReduceFuncHolder {
+  void setReduceFunction(ReduceFunc func) { this->func = func; }
+  ReduceFunc func{nullptr};
+};
+
+// The barrier of the ranks, in its own cache lines.
+struct ShmHeader {
+  alignas(64) std::atomic<int64_t> arrived;
+  alignas(64) std::atomic<int64_t> generation;
+};
+
+static_assert(std::atomic<int64_t>::is_always_lock_free,
+              "The barrier on the shared memory needs lock free atomics.");
+
+constexpr size_t kHeaderBytes = 128;
+static_assert(sizeof(ShmHeader) <= kHeaderBytes,
+              "The header of the shared memory is out of its bytes.");
+constexpr size_t kNameBytes = 64;
+constexpr size_t kHostNameBytes = 256;
+
+}  // namespace
+
+std::unique_ptr<GlooShmAllReducer> GlooShmAllReducer::Create(
+    const std::shared_ptr<gloo::Context>& context) {
+#ifdef _WIN32
+  return nullptr;
+#else
+  const int rank = context->rank;
+  const int size = context->size;
+  std::array<char, kHostNameBytes> hostname{};
+  ::gethostname(hostname.data(), kHostNameBytes - 1);
+  std::vector<char> hostnames(kHostNameBytes * size);
+  gloo::AllgatherOptions gather_opts(context);
+  gather_opts.setInput(hostname.data(), kHostNameBytes);
+  gather_opts.setOutput(hostnames.data(), hostnames.size());
+  gloo::allgather(gather_opts);
+  for (int i = 0; i < size; ++i) {
+    if (std::strncmp(hostname.data(),
+                     hostnames.data() + i * kHostNameBytes,
+                     kHostNameBytes) != 0) {
+      VLOG(3) << "The gloo ranks are not on the same host, and allreduce by "
+                 "the pairs of gloo.";
+      return nullptr;
+    }
+  }
+
+  const size_t bytes = kHeaderBytes + 2 * kSlotBytes * size;
+  std::array<char, kNameBytes> name{}, root_name{};
+  int fd = -1;
+  if (rank == 0) {
+    static std::atomic<int> num_segments{0};
+    std::snprintf(root_name.data(),
+                  kNameBytes,
+                  "/paddle_gloo_shm_%d_%d",
+                  static_cast<int>(::getpid()),
+                  num_segments++);
+    fd = ::shm_open(root_name.data(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0 && ::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+      ::close(fd);
+      ::shm_unlink(root_name.data());
+      fd = -1;
+    }
+    if (fd < 0) {
+      root_name[0] = '\0';
+    }
+  }
+  gloo::BroadcastOptions broadcast_opts(context);
+  if (rank == 0) {
+    broadcast_opts.setInput(root_name.data(), kNameBytes);
+  }
+  broadcast_opts.setOutput(name.data(), kNameBytes);
+  broadcast_opts.setRoot(0);
+  gloo::broadcast(broadcast_opts);
+  if (name[0] == '\0') {
+    LOG(WARNING) << "Failed to create the shared memory of " << bytes
+                 << " bytes for the allreduce of gloo.";
+    return nullptr;
+  }
+
+  if (rank != 0) {
+    fd = ::shm_open(name.data(), O_RDWR, 0600);
+  }
+  void* addr = MAP_FAILED;
+  if (fd >= 0) {
+    addr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+  }
+  int32_t mapped = addr != MAP_FAILED ? 1 : 0, all_mapped = 0;
+  gloo::AllreduceOptions reduce_opts(context);
+  reduce_opts.setInput(&mapped, 1);
+  reduce_opts.setOutput(&all_mapped, 1);
+  reduce_opts.setReduceFunction(static_cast<ReduceFunc>(&gloo::min<int32_t>));
+  gloo::allreduce(reduce_opts);
+  // All the ranks have opened the segment, which is removed at the last
+  // munmap.
+  if (rank == 0) {
+    ::shm_unlink(name.data());
+  }
+  if (!all_mapped) {
+    if (addr != MAP_FAILED) {
+      ::munmap(addr, bytes);
+    }
+    LOG(WARNING) << "Failed to map the shared memory " << name.data()
+                 << " for the allreduce of gloo.";
+    return nullptr;
+  }
+  VLOG(3) << "The " << size << " gloo ranks allreduce by the shared memory "
+          << name.data() << " of " << bytes << " bytes.";
+  return std::unique_ptr<GlooShmAllReducer>(
+      new GlooShmAllReducer(context, addr, bytes));
+#endif
+}
+
+GlooShmAllReducer::GlooShmAllReducer(
+    const std::shared_ptr<gloo::Context>& context, void* addr, size_t bytes)
+    : context_(context), addr_(addr), bytes_(bytes) {}
+
+GlooShmAllReducer::~GlooShmAllReducer() {
+#ifndef _WIN32
+  ::munmap(addr_, bytes_);
+#endif
+}
+
+char* GlooShmAllReducer::Slot(int64_t buffer, int rank) const {
+  return static_cast<char*>(addr_) + kHeaderBytes +
+         (buffer * context_->size + rank) * kSlotBytes;
+}
+
+void GlooShmAllReducer::Barrier() {
+  auto* header = static_cast<ShmHeader*>(addr_);
+  // The generation can not change before this rank arrives.
+  int64_t generation = header->generation.load(std::memory_order_acquire);
+  if (header->arrived.fetch_add(1, std::memory_order_acq_rel) ==
+      context_->size - 1) {
+    header->arrived.store(0, std::memory_order_relaxed);
+    header->generation.fetch_add(1, std::memory_order_release);
+    return;
+  }
+  auto deadline = std::chrono::steady_clock::now() + context_->getTimeout();
+  for (int spin = 0;
+       header->generation.load(std::memory_order_acquire) == generation;
+       ++spin) {
+    if (spin >= 1024) {
+      std::this_thread::yield();
+      if (std::chrono::steady_clock::now() > deadline) {
+        PADDLE_THROW(phi::errors::ExecutionTimeout(
+            "The gloo ranks timed out waiting for each other at the barrier "
+            "of the shared memory."));
+      }
+    }
+  }
+}
+
+void GlooShmAllReducer::AllReduce(phi::DenseTensor* out_tensor,
+                                  const phi::DenseTensor& in_tensor,
+                                  int reduce_type) {
+  ReduceFuncHolder holder;
+  const auto& dtype = in_tensor.dtype();
+  GENERATE_FUNC(dtype, SetReduceFunc, &holder, reduce_type);
+  const int rank = context_->rank;
+  const int size = context_->size;
+  const size_t elem_bytes = phi::SizeOf(dtype);
+  const size_t chunk_numel = kSlotBytes / elem_bytes;
+  const size_t numel = static_cast<size_t>(in_tensor.numel());
+  const char* in = static_cast<const char*>(in_tensor.data());
+  char* out = static_cast<char*>(out_tensor->data());
+
+  for (size_t offset = 0; offset < numel; offset += chunk_numel) {
+    const size_t count = std::min(chunk_numel, numel - offset);
+    const int64_t buffer = num_chunks_++ % 2;
+    std::memcpy(
+        Slot(buffer, rank), in + offset * elem_bytes, count * elem_bytes);
+    Barrier();
+    // Every rank reduces its part of the chunk into the slot of rank 0.
+    const size_t part = (count + size - 1) / size;
+    const size_t begin = std::min(part * rank, count);
+    const size_t end = std::min(begin + part, count);
+    if (begin < end) {
+      char* acc = Slot(buffer, 0) + begin * elem_bytes;
+      for (int i = 1; i < size; ++i) {
+        holder.func(
+            acc, acc, Slot(buffer, i) + begin * elem_bytes, end - begin);
+      }
+    }
+    Barrier();
+    // The buffer is not written again before the next chunk passes its
+    // first barrier, when all the ranks have copied this one out.
+    std::memcpy(
+        out + offset * elem_bytes, Slot(buffer, 0), count * elem_bytes);
+  }
+}
+
+}  // namespace distributed
+}  // namespace phi
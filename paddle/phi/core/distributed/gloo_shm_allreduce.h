@@ -0,0 +1,69 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <gloo/context.h>
+
+#include <memory>
+#include <string>
+
+#include "paddle/common/macros.h"
+
+namespace phi {
+class DenseTensor;
+namespace distributed {
+
+// Allreduces the tensors of the ranks on the same host through a shared
+// memory segment, instead of the TCP pairs of gloo. The tensors are copied by
+// the chunks of kSlotBytes into the slots of the ranks, and every rank
+// reduces its 1/size of a chunk over all the slots, so the reduction is
+// parallel over the ranks. The chunks are in two buffers by turns, so that a
+// chunk is copied in while the last one is still copied out, and a chunk
+// takes two barriers spinning on the shared memory.
+class GlooShmAllReducer {
+ public:
+  static constexpr size_t kSlotBytes = 1 << 20;
+
+  // Collective over the ranks of the context. Returns nullptr on all the
+  // ranks if they are not on the same host, or the shared memory can not be
+  // mapped by any rank.
+  static std::unique_ptr<GlooShmAllReducer> Create(
+      const std::shared_ptr<gloo::Context>& context);
+
+  ~GlooShmAllReducer();
+
+  void AllReduce(phi::DenseTensor* out_tensor,
+                 const phi::DenseTensor& in_tensor,
+                 int reduce_type);
+
+ private:
+  GlooShmAllReducer(const std::shared_ptr<gloo::Context>& context,
+                    void* addr,
+                    size_t bytes);
+
+  void Barrier();
+  char* Slot(int64_t buffer, int rank) const;
+
+  DISABLE_COPY_AND_ASSIGN(GlooShmAllReducer);
+
+  std::shared_ptr<gloo::Context> context_;
+  void* addr_;
+  size_t bytes_;
+  // The number of the chunks reduced, whose parity is the buffer of the next.
+  int64_t num_chunks_{0};
+};
+
+}  // namespace distributed
+}  // namespace phi
@@ -22,14 +22,34 @@
 #include "paddle/phi/core/distributed/nccl_tools.h"
 #include "paddle/phi/core/distributed/utils.h"
 #include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/flags.h"
+#include "paddle/phi/core/metrics.h"
 #include "paddle/phi/core/utils/data_type.h"
 
+PHI_DECLARE_bool(enable_runtime_metrics);
+
 namespace phi {
 namespace distributed {
 
 // set this flag to `true` and recompile to enable dynamic checks
 constexpr bool FLAGS_enable_nccl_dynamic_check = false;
 
+// The calls and the bytes of the collectives, the times of the collectives are
+// on the streams and are not recorded.
+static void RecordNCCLMetrics(const std::string& op, int64_t bytes) {
+  if (!FLAGS_enable_runtime_metrics) return;
+  auto& registry = phi::metrics::MetricsRegistry::Instance();
+  registry
+      .GetCounter(
+          "paddle_nccl_calls_total", "The number of nccl calls.", {{"op", op}})
+      ->Add();
+  registry
+      .GetCounter("paddle_nccl_bytes_total",
+                  "The bytes of the nccl calls.",
+                  {{"op", op}})
+      ->Add(bytes);
+}
+
 NCCLCommContext::NCCLCommContext(int rank, int size, ncclUniqueId nccl_id)
     : CommContext(rank, size) {
   NCCL_CHECK(
@@ -37,6 +57,11 @@ NCCLCommContext::NCCLCommContext(int rank, int size, ncclUniqueId nccl_id)
   NCCL_CHECK(phi::dynload::ncclGetVersion(&nccl_version_));
 }
 
+NCCLCommContext::NCCLCommContext(int rank, int size, ncclComm_t nccl_comm)
+    : CommContext(rank, size), nccl_comm_(nccl_comm) {
+  NCCL_CHECK(phi::dynload::ncclGetVersion(&nccl_version_));
+}
+
 int NCCLCommContext::GetNcclVersion() { return nccl_version_; }
 
 ncclComm_t NCCLCommContext::GetNcclComm() { return nccl_comm_; }
@@ -77,6 +102,7 @@ void NCCLCommContext::Broadcast(phi::DenseTensor* out_tensor,
   if (FLAGS_enable_nccl_dynamic_check) {
     NCCLDynamicCheck::CheckShape(*out_tensor, root, rank_, nccl_comm_);
   }
+  RecordNCCLMetrics("broadcast", in_tensor.numel() * SizeOf(in_tensor.dtype()));
   NCCL_CHECK(phi::dynload::ncclBroadcast(in_tensor.data(),
                                          out_tensor->data(),
                                          in_tensor.numel(),
@@ -100,6 +126,8 @@ void NCCLCommContext::AllGather(phi::DenseTensor* out_tensor,
                                                    rank_,
                                                    nccl_comm_);
   }
+  RecordNCCLMetrics("all_gather",
+                    in_tensor.numel() * SizeOf(in_tensor.dtype()));
   NCCL_CHECK(phi::dynload::ncclAllGather(in_tensor.data(),
                                          out_tensor->data(),
                                          in_tensor.numel(),
@@ -122,6 +150,8 @@ void NCCLCommContext::ReduceScatter(phi::DenseTensor* out_tensor,
                                                    rank_,
                                                    nccl_comm_);
   }
+  RecordNCCLMetrics("reduce_scatter",
+                    in_tensor.numel() * SizeOf(in_tensor.dtype()));
   NCCL_CHECK(phi::dynload::ncclReduceScatter(in_tensor.data(),
                                              out_tensor->data(),
                                              out_tensor->numel(),
@@ -141,6 +171,7 @@ void NCCLCommContext::Send(const phi::DenseTensor& in_tensor,
     NCCLDynamicCheck::CheckShape(in_tensor, rank_, rank_, nccl_comm_);
   }
 
+  RecordNCCLMetrics("send", count * SizeOf(in_tensor.dtype()));
   NCCL_CHECK(phi::dynload::ncclSend(in_tensor.data(),
                                     count,
                                     ToNCCLDataType(in_tensor.dtype()),
@@ -160,6 +191,7 @@ void NCCLCommContext::Recv(phi::DenseTensor* out_tensor,
     NCCLDynamicCheck::CheckShape(*out_tensor, peer, rank_, nccl_comm_);
   }
 
+  RecordNCCLMetrics("recv", count * SizeOf(out_tensor->dtype()));
   NCCL_CHECK(phi::dynload::ncclRecv(out_tensor->data(),
                                     count,
                                     ToNCCLDataType(out_tensor->dtype()),
@@ -185,6 +217,8 @@ void NCCLCommContext::AllReduce(phi::DenseTensor* out_tensor,
                                                    rank_,
                                                    nccl_comm_);
   }
+  RecordNCCLMetrics("all_reduce",
+                    in_tensor.numel() * SizeOf(in_tensor.dtype()));
   NCCL_CHECK(phi::dynload::ncclAllReduce(in_tensor.data(),
                                          out_tensor->data(),
                                          in_tensor.numel(),
@@ -210,6 +244,7 @@ void NCCLCommContext::Reduce(phi::DenseTensor* out_tensor,
                                                    rank_,
                                                    nccl_comm_);
   }
+  RecordNCCLMetrics("reduce", in_tensor.numel() * SizeOf(in_tensor.dtype()));
   NCCL_CHECK(phi::dynload::ncclReduce(in_tensor.data(),
                                       out_tensor->data(),
                                       in_tensor.numel(),
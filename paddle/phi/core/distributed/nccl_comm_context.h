@@ -40,6 +40,8 @@ namespace distributed {
 class NCCLCommContext final : public CommContext {
  public:
   NCCLCommContext(int rank, int size, ncclUniqueId nccl_id);
+  // Takes the communicator created, e.g. by ncclCommSplit.
+  NCCLCommContext(int rank, int size, ncclComm_t nccl_comm);
   ~NCCLCommContext() override = default;
 
   int GetNcclVersion();
@@ -19,8 +19,12 @@
 #include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/core/distributed/comm_context_manager.h"
 #include "paddle/phi/core/distributed/nccl_tools.h"
+#include "paddle/phi/core/flags.h"
+#include "paddle/phi/core/os_info.h"
 #include "paddle/phi/core/utils/data_type.h"
 
+PHI_DECLARE_bool(enable_comm_profile);
+
 namespace phi {
 namespace distributed {
 
@@ -55,6 +59,14 @@ NCCLCommTask::NCCLCommTask(const phi::Place& place,
   end_event_created_ = false;
   start_time_ = std::chrono::steady_clock::now();
   timeout_ = std::chrono::milliseconds(timeout);
+  // the events are timed to profile the collective
+  if (FLAGS_enable_comm_profile) {
+#ifdef PADDLE_WITH_CUDA
+    cuda_event_flags_ = cudaEventDefault;
+#else  // PADDLE_WITH_HIP
+    hip_event_flags_ = hipEventDefault;
+#endif
+  }
 }
 
 void NCCLCommTask::StartRecord() {
@@ -67,6 +79,7 @@ void NCCLCommTask::StartRecord() {
 #endif
     start_event_created_ = true;
   }
+  host_start_ns_ = phi::PosixInNsec();
 #ifdef PADDLE_WITH_CUDA
   CUDA_CHECK(cudaEventRecord(nccl_start_event_, nccl_stream_));
 #else  // PADDLE_WITH_HIP
@@ -226,6 +239,23 @@ bool NCCLCommTask::IsCompleted() {
   return completed_;
 }
 
+float NCCLCommTask::GetElapsedMillis() {
+  if (!FLAGS_enable_comm_profile || !start_event_created_ ||
+      !IsCompleted()) {
+    return -1.0f;
+  }
+  float elapsed_ms = 0.0f;
+  backends::gpu::GPUDeviceGuard guard(place_.device);
+#ifdef PADDLE_WITH_CUDA
+  CUDA_CHECK(
+      cudaEventElapsedTime(&elapsed_ms, nccl_start_event_, nccl_end_event_));
+#else  // PADDLE_WITH_HIP
+  HIP_CHECK(
+      hipEventElapsedTime(&elapsed_ms, nccl_start_event_, nccl_end_event_));
+#endif
+  return elapsed_ms;
+}
+
 void NCCLCommTask::SetUpdated(bool updated) { updated_ = updated; }
 
 bool NCCLCommTask::IsUpdated() { return updated_; }
@@ -14,6 +14,11 @@
 
 #include "paddle/phi/core/distributed/store/tcp_store.h"
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <thread>
@@ -23,12 +28,16 @@
 #include "paddle/phi/core/distributed/store/tcp_utils.h"
 #include "paddle/phi/core/flags.h"
 
+PHI_DECLARE_int32(tcp_store_num_threads);
+
 namespace phi {
 namespace distributed {
 
 namespace detail {
 
 constexpr int INFTIME = 10000;  // 10 seconds
+// the keys of a batched command, bounds the pipelined replies in flight
+constexpr size_t kMaxBatchKeys = 1024;
 
 std::unique_ptr<MasterDaemon> MasterDaemon::start(SocketType socket,
                                                   int nranks,
@@ -51,6 +60,11 @@ MasterDaemon::~MasterDaemon() {  // NOLINT
   for (SocketType socket : _sockets) {
     tcputils::close_socket(socket);
   }
+#ifdef __linux__
+  for (int epoll_fd : _epoll_fds) {
+    ::close(epoll_fd);
+  }
+#endif
   CloseControlFd();
 }
 
@@ -58,22 +72,25 @@ void MasterDaemon::_do_add(SocketType socket) {
   int64_t new_value{};
   std::string key = tcputils::receive_string(socket);
   new_value = tcputils::receive_value<int64_t>(socket);
-  std::vector<uint8_t> old_value;
-  auto it = _store.find(key);
-  if (it != _store.end()) {
-    old_value = it->second;
-    char* buffer = reinterpret_cast<char*>(it->second.data());
-    size_t len = old_value.size();
-    new_value += std::stoll(std::string(buffer, len));
-  }
-
-  std::string new_value_str = std::to_string(new_value);
-  _store[key] =
-      std::vector<uint8_t>(new_value_str.begin(), new_value_str.end());
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::vector<uint8_t> old_value;
+    auto it = _store.find(key);
+    if (it != _store.end()) {
+      old_value = it->second;
+      char* buffer = reinterpret_cast<char*>(it->second.data());
+      size_t len = old_value.size();
+      new_value += std::stoll(std::string(buffer, len));
+    }
+
+    std::string new_value_str = std::to_string(new_value);
+    _store[key] =
+        std::vector<uint8_t>(new_value_str.begin(), new_value_str.end());
+    _notify_waiting_sockets(key);
+  }
   VLOG(8) << "TCPStore: new value (" << new_value << ") for key (" << key
           << ") " << GetSockName(socket);
   tcputils::send_value<int64_t>(socket, new_value);
-  _notify_waiting_sockets(key);
 }
 
 void MasterDaemon::_do_set(SocketType socket) {
@@ -81,10 +98,30 @@ void MasterDaemon::_do_set(SocketType socket) {
   VLOG(8) << "MasterDaemon::_do_set key(" << key << ") " << GetSockName(socket);
 
   auto value = tcputils::receive_vector<uint8_t>(socket);
-  _store[key] = value;
+  std::lock_guard<std::mutex> lock(_mutex);
+  _store[key] = std::move(value);
   _notify_waiting_sockets(key);
 }
 
+void MasterDaemon::_do_multi_set(SocketType socket) {
+  auto num_keys = tcputils::receive_value<size_t>(socket);
+  std::vector<std::string> keys(num_keys);
+  std::vector<std::vector<uint8_t>> values(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    keys[i] = tcputils::receive_string(socket);
+    values[i] = tcputils::receive_vector<uint8_t>(socket);
+  }
+  VLOG(8) << "MasterDaemon::_do_multi_set " << num_keys << " keys "
+          << GetSockName(socket);
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  for (size_t i = 0; i < num_keys; ++i) {
+    _store[keys[i]] = std::move(values[i]);
+    _notify_waiting_sockets(keys[i]);
+  }
+}
+
+// the caller holds _mutex
 void MasterDaemon::_notify_waiting_sockets(const std::string& key) {
   if (_waiting_sockets.find(key) != _waiting_sockets.end()) {
     for (auto waiting_socket : _waiting_sockets.at(key)) {
@@ -101,22 +138,57 @@ void MasterDaemon::_do_get(SocketType socket) {
   std::string key = tcputils::receive_string(socket);
   VLOG(8) << "MasterDaemon::_do_get key(" << key << ") " << GetSockName(socket);
 
-  auto iter = _store.find(key);
-  PADDLE_ENFORCE_NE(
-      iter,
-      _store.end(),
-      phi::errors::InvalidArgument("Key %s not found in TCPStore.", key));
-  std::vector<uint8_t> value = iter->second;
+  std::vector<uint8_t> value;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto iter = _store.find(key);
+    PADDLE_ENFORCE_NE(
+        iter,
+        _store.end(),
+        phi::errors::InvalidArgument("Key %s not found in TCPStore.", key));
+    value = iter->second;
+  }
   tcputils::send_vector<uint8_t>(socket, value);
 }
 
+void MasterDaemon::_do_multi_get(SocketType socket) {
+  auto num_keys = tcputils::receive_value<size_t>(socket);
+  std::vector<std::string> keys(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    keys[i] = tcputils::receive_string(socket);
+  }
+  VLOG(8) << "MasterDaemon::_do_multi_get " << num_keys << " keys "
+          << GetSockName(socket);
+
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(num_keys);
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& key : keys) {
+      auto iter = _store.find(key);
+      PADDLE_ENFORCE_NE(
+          iter,
+          _store.end(),
+          phi::errors::InvalidArgument("Key %s not found in TCPStore.", key));
+      values.push_back(iter->second);
+    }
+  }
+  for (const auto& value : values) {
+    tcputils::send_vector<uint8_t>(socket, value);
+  }
+}
+
 void MasterDaemon::_do_check(SocketType socket) {
   std::string key = tcputils::receive_string(socket);
   VLOG(4) << "MasterDaemon::_do_check key(" << key << ") "
           << GetSockName(socket);
 
-  auto iter = _store.find(key);
-  if (iter != _store.end()) {
+  bool found = false;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    found = _store.find(key) != _store.end();
+  }
+  if (found) {
     tcputils::send_value<ReplyType>(socket, ReplyType::READY);
   } else {
     tcputils::send_value<ReplyType>(socket, ReplyType::NOT_READY);
@@ -165,6 +237,9 @@ void MasterDaemon::_do_wait(SocketType socket) {
   VLOG(8) << "MasterDaemon::_do_wait key(" << key << ") "
           << GetSockName(socket);
 
+  // the reply is sent in the lock, as the notify of the other waits of the
+  // socket may be sent by another thread
+  std::lock_guard<std::mutex> lock(_mutex);
   auto iter = _store.find(key);
   if (iter == _store.end()) {
     // The key can not be found in store currently. Record and check later.
@@ -177,6 +252,165 @@ void MasterDaemon::_do_wait(SocketType socket) {
   }
 }
 
+bool MasterDaemon::ProcessCommand(SocketType socket) {
+  try {
+    VLOG(8) << "Plan to receive command from " << GetSockName(socket);
+    Command command = tcputils::receive_value<Command>(socket);
+    VLOG(7) << "TCPStore: recv command: " << static_cast<int>(command) << ".";
+
+    switch (command) {
+      case Command::ADD:
+        _do_add(socket);
+        break;
+      case Command::GET:
+        _do_get(socket);
+        break;
+      case Command::CHECK:
+        _do_check(socket);
+        break;
+      case Command::SET:
+        _do_set(socket);
+        break;
+      case Command::WAIT:
+        _do_wait(socket);
+        break;
+      case Command::MULTI_GET:
+        _do_multi_get(socket);
+        break;
+      case Command::MULTI_SET:
+        _do_multi_set(socket);
+        break;
+      default:
+        VLOG(8) << "Unknown command: " << static_cast<int>(command)
+                << " from addr info:" << GetSockName(socket);
+    }
+  } catch (const std::exception& ex) {
+    VLOG(5) << "Meet some exceptions during run:" << ex.what();
+    return false;
+  }
+  return true;
+}
+
+void MasterDaemon::RemoveSocket(SocketType socket) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto map_iter = _waiting_sockets.begin();
+  while (map_iter != _waiting_sockets.end()) {
+    auto vec_iter = map_iter->second.begin();
+    while (vec_iter != map_iter->second.end()) {
+      if (*vec_iter == socket) {
+        vec_iter = map_iter->second.erase(vec_iter);
+      } else {
+        ++vec_iter;
+      }
+    }
+    if (map_iter->second.empty()) {
+      map_iter = _waiting_sockets.erase(map_iter);
+    } else {
+      ++map_iter;
+    }
+  }
+
+  tcputils::close_socket(socket);
+  auto iter = std::find(_sockets.begin(), _sockets.end(), socket);
+  if (iter != _sockets.end()) {
+    _sockets.erase(iter);
+  }
+}
+
+#ifdef __linux__
+void MasterDaemon::RunWorker(int epoll_fd) {
+  constexpr int kMaxEvents = 64;
+  std::array<struct epoll_event, kMaxEvents> events;
+  while (true) {
+    int num_events =
+        ::epoll_wait(epoll_fd, events.data(), kMaxEvents, INFTIME);
+    if (num_events < 0) {
+      PADDLE_ENFORCE_EQ(
+          errno,
+          EINTR,
+          phi::errors::Fatal("failed to wait the epoll errno:%d", errno));
+      continue;
+    }
+    for (int i = 0; i < num_events; ++i) {
+      int socket = events[i].data.fd;
+      // The control pipe receive shutdown event
+      if (socket == _control_fd[0]) {
+        return;
+      }
+      if (!ProcessCommand(socket)) {
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, socket, nullptr);
+        RemoveSocket(socket);
+      }
+    }
+  }
+}
+
+void MasterDaemon::run() {
+  const int num_threads = std::max(1, FLAGS_tcp_store_num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    PADDLE_ENFORCE_NE(
+        epoll_fd,
+        -1,
+        phi::errors::Fatal("failed to create epoll errno:%d", errno));
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = _control_fd[0];
+    PADDLE_ENFORCE_NE(
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, _control_fd[0], &event),
+        -1,
+        phi::errors::Fatal("failed to add control pipe errno:%d", errno));
+    _epoll_fds.push_back(epoll_fd);
+  }
+  for (int epoll_fd : _epoll_fds) {
+    _worker_threads.emplace_back(&MasterDaemon::RunWorker, this, epoll_fd);
+  }
+
+  std::vector<struct pollfd> fds;
+  fds.push_back({.fd = _listen_socket, .events = POLLIN, .revents = 0});
+  fds.push_back(
+      {.fd = _control_fd[0], .events = POLLIN | POLLHUP, .revents = 0});
+  size_t next_worker = 0;
+  while (true) {
+    for (auto& item : fds) {
+      item.revents = 0;
+    }
+    ::poll(fds.data(), fds.size(), INFTIME);
+
+    // The control pipe receive shutdown event, and begin to close it.
+    if (fds[1].revents != 0) {
+      if (fds[1].revents & ~(POLLIN | POLLHUP)) {
+        PADDLE_THROW(
+            phi::errors::Fatal("Undefined event type:%d", fds[1].revents));
+      }
+      VLOG(0)
+          << "receive shutdown event and so quit from MasterDaemon run loop";
+      break;
+    }
+
+    // accept connect request, and hand the socket to a worker.
+    if (fds[0].revents != 0) {
+      auto socket = tcputils::tcp_accept(_listen_socket);
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _sockets.emplace_back(socket);
+      }
+      struct epoll_event event = {};
+      event.events = EPOLLIN;
+      event.data.fd = socket;
+      int epoll_fd = _epoll_fds[next_worker++ % _epoll_fds.size()];
+      PADDLE_ENFORCE_NE(
+          ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, socket, &event),
+          -1,
+          phi::errors::Fatal("failed to add socket to epoll errno:%d", errno));
+    }
+  }
+
+  for (auto& worker_thread : _worker_threads) {
+    worker_thread.join();
+  }
+}
+#else
 void MasterDaemon::ProcessCommands(std::vector<struct pollfd>* p_fds) {
   std::vector<struct pollfd>& fds = *p_fds;
   // FIXME(gongwb): Don't loop all fds of set just the fds who have event.
@@ -187,62 +421,12 @@ void MasterDaemon::ProcessCommands(std::vector<struct pollfd>* p_fds) {
   // 0: listen socket, 1:controller pipe, so loop from 2.
   for (uint i = 2; i < fds.size(); i++) {
 #endif
-    try {
-      if (fds[i].revents == 0) {
-        continue;
-      }
-
-      VLOG(8) << "Plan to receive command from " << GetSockName(fds[i].fd);
-      Command command = tcputils::receive_value<Command>(fds[i].fd);
-      VLOG(7) << "TCPStore: recv command: " << static_cast<int>(command) << ".";
-
-      switch (command) {
-        case Command::ADD:
-          _do_add(fds[i].fd);
-          break;
-        case Command::GET:
-          _do_get(fds[i].fd);
-          break;
-        case Command::CHECK:
-          _do_check(fds[i].fd);
-          break;
-        case Command::SET:
-          _do_set(fds[i].fd);
-          break;
-        case Command::WAIT:
-          _do_wait(fds[i].fd);
-          break;
-        default:
-          VLOG(8) << "Unknown command: " << static_cast<int>(command)
-                  << " from addr info:" << GetSockName(fds[i].fd);
-      }
-    } catch (const std::exception& ex) {
-      auto map_iter = _waiting_sockets.begin();
-      while (map_iter != _waiting_sockets.end()) {
-        auto vec_iter = map_iter->second.begin();
-        while (vec_iter != map_iter->second.end()) {
-          if (*vec_iter == fds[i].fd) {
-            vec_iter = map_iter->second.erase(vec_iter);
-          } else {
-            ++vec_iter;
-          }
-        }
-        if (map_iter->second.empty()) {
-          map_iter = _waiting_sockets.erase(map_iter);
-        } else {
-          ++map_iter;
-        }
-      }
-
-      tcputils::close_socket(fds[i].fd);
+    if (fds[i].revents == 0) {
+      continue;
+    }
+    if (!ProcessCommand(fds[i].fd)) {
+      RemoveSocket(fds[i].fd);
       fds.erase(fds.begin() + i);
-#ifdef _WIN32
-      _sockets.erase(_sockets.begin() + i - 1);
-#else
-      _sockets.erase(_sockets.begin() + i - 2);
-#endif
-
-      VLOG(5) << "Meet some exceptions during run:" << ex.what();
     }
   }
 }
@@ -296,7 +480,10 @@ void MasterDaemon::run() {
     // accept connect request.
     if (fds[0].revents != 0) {
       auto socket = tcputils::tcp_accept(_listen_socket);
-      _sockets.emplace_back(socket);
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _sockets.emplace_back(socket);
+      }
 #ifdef _WIN32
       fds.push_back({socket, POLLIN});
 #else
@@ -307,6 +494,7 @@ void MasterDaemon::run() {
     ProcessCommands(&fds);
   }
 }
+#endif
 
 std::unique_ptr<TCPServer> TCPServer::create(uint16_t port,
                                              int nranks,
@@ -332,6 +520,10 @@ void TCPClient::send_command_for_key(Command type, const std::string& key) {
   tcputils::send_string(_socket, key);
 }
 
+void TCPClient::send_string(const std::string& s) {
+  tcputils::send_string(_socket, s);
+}
+
 template <typename T>
 void TCPClient::send_value(const T& value) {
   tcputils::send_bytes<T>(_socket, &value, 1);
@@ -360,23 +552,47 @@ TCPStore::TCPStore(std::string host,
                    uint16_t port,
                    bool is_master,
                    size_t num_workers,
-                   int timeout)
+                   int timeout,
+                   int num_shards)
     : Store(timeout),
       _is_master(is_master),
       _num_workers(static_cast<int>(num_workers)) {
   _timeout = timeout;
   PADDLE_ENFORCE_GT(
       timeout, 0, phi::errors::InvalidArgument("timeout must >= %d", timeout));
+  PADDLE_ENFORCE_GT(
+      num_shards,
+      0,
+      phi::errors::InvalidArgument("num_shards must > 0, but got %d",
+                                   num_shards));
 
-  VLOG(7) << "input timeout" << timeout << ", member timeout:" << _timeout;
+  VLOG(7) << "input timeout" << timeout << ", member timeout:" << _timeout
+          << ", num_shards:" << num_shards;
   if (_is_master) {
-    _server = detail::TCPServer::create(port, this->_num_workers, timeout);
+    for (int i = 0; i < num_shards; ++i) {
+      _servers.emplace_back(
+          detail::TCPServer::create(port + i, this->_num_workers, timeout));
+    }
   }
 
-  _client = detail::TCPClient::connect(host, port);
+  for (int i = 0; i < num_shards; ++i) {
+    _clients.emplace_back(detail::TCPClient::connect(host, port + i));
+  }
   waitWorkers();
 }
 
+size_t TCPStore::GetShard(const std::string& key) {
+  if (_clients.size() == 1) {
+    return 0;
+  }
+  // FNV-1a, the same on all the ranks
+  uint64_t hash = 14695981039346656037ULL;
+  for (char c : key) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+  }
+  return hash % _clients.size();
+}
+
 void TCPStore::waitWorkers() {
   if (_num_workers == 0) {
     return;
@@ -418,28 +634,32 @@ void TCPStore::waitWorkers() {
 
 int64_t TCPStore::add(const std::string& key, int64_t value) {
   VLOG(7) << "TCPStore add.";
-  _client->send_command_for_key(Command::ADD, _key_prefix + key);
-  _client->send_value<std::int64_t>(value);
-  return _client->receive_value<std::int64_t>();
+  auto& client = _clients[GetShard(key)];
+  client->send_command_for_key(Command::ADD, _key_prefix + key);
+  client->send_value<std::int64_t>(value);
+  return client->receive_value<std::int64_t>();
 }
 
 void TCPStore::set(const std::string& key, const std::vector<uint8_t>& value) {
   VLOG(7) << "TCPStore set.";
-  _client->send_command_for_key(Command::SET, _key_prefix + key);
-  _client->send_vector<uint8_t>(value);
+  auto& client = _clients[GetShard(key)];
+  client->send_command_for_key(Command::SET, _key_prefix + key);
+  client->send_vector<uint8_t>(value);
 }
 
 std::vector<uint8_t> TCPStore::get(const std::string& key) {
   wait(key);
-  _client->send_command_for_key(Command::GET, _key_prefix + key);
+  auto& client = _clients[GetShard(key)];
+  client->send_command_for_key(Command::GET, _key_prefix + key);
   VLOG(7) << "TCPStore get.";
-  return _client->receive_vector<uint8_t>();
+  return client->receive_vector<uint8_t>();
 }
 
 bool TCPStore::check(const std::string& key) {
-  _client->send_command_for_key(Command::CHECK, _key_prefix + key);
+  auto& client = _clients[GetShard(key)];
+  client->send_command_for_key(Command::CHECK, _key_prefix + key);
   VLOG(3) << "TCPStore check.";
-  auto response = _client->receive_value<ReplyType>();
+  auto response = client->receive_value<ReplyType>();
   if (response == ReplyType::READY) {
     return true;
   } else {
@@ -450,14 +670,83 @@ bool TCPStore::check(const std::string& key) {
 void TCPStore::wait(const std::string& key) {
   ReplyType reply;  // NOLINT
   VLOG(7) << "TCPStore wait.";
-  _client->send_command_for_key(Command::WAIT, _key_prefix + key);
-  reply = _client->receive_value<ReplyType>();
+  auto& client = _clients[GetShard(key)];
+  client->send_command_for_key(Command::WAIT, _key_prefix + key);
+  reply = client->receive_value<ReplyType>();
   PADDLE_ENFORCE_EQ(
       reply == ReplyType::STOP_WAIT,
       true,
       phi::errors::InvalidArgument("Stop_waiting response is expected"));
 }
 
+std::vector<std::vector<uint8_t>> TCPStore::multi_get(
+    const std::vector<std::string>& keys) {
+  VLOG(7) << "TCPStore multi_get " << keys.size() << " keys.";
+  std::vector<std::vector<size_t>> shard_keys(_clients.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    shard_keys[GetShard(keys[i])].push_back(i);
+  }
+  std::vector<std::vector<uint8_t>> values(keys.size());
+  for (size_t shard = 0; shard < _clients.size(); ++shard) {
+    auto& client = _clients[shard];
+    const auto& indices = shard_keys[shard];
+    for (size_t begin = 0; begin < indices.size();
+         begin += detail::kMaxBatchKeys) {
+      size_t end = std::min(begin + detail::kMaxBatchKeys, indices.size());
+      // the waits are pipelined, so a batch costs two round trips
+      for (size_t j = begin; j < end; ++j) {
+        client->send_command_for_key(Command::WAIT,
+                                     _key_prefix + keys[indices[j]]);
+      }
+      for (size_t j = begin; j < end; ++j) {
+        auto reply = client->receive_value<ReplyType>();
+        PADDLE_ENFORCE_EQ(
+            reply == ReplyType::STOP_WAIT,
+            true,
+            phi::errors::InvalidArgument("Stop_waiting response is expected"));
+      }
+      client->send_command_for_key(Command::MULTI_GET, "");
+      client->send_value<size_t>(end - begin);
+      for (size_t j = begin; j < end; ++j) {
+        client->send_string(_key_prefix + keys[indices[j]]);
+      }
+      for (size_t j = begin; j < end; ++j) {
+        values[indices[j]] = client->receive_vector<uint8_t>();
+      }
+    }
+  }
+  return values;
+}
+
+void TCPStore::multi_set(const std::vector<std::string>& keys,
+                         const std::vector<std::vector<uint8_t>>& values) {
+  PADDLE_ENFORCE_EQ(
+      keys.size(),
+      values.size(),
+      phi::errors::InvalidArgument("The number of keys (%d) and values (%d) "
+                                   "of multi_set should be the same.",
+                                   keys.size(),
+                                   values.size()));
+  VLOG(7) << "TCPStore multi_set " << keys.size() << " keys.";
+  std::vector<std::vector<size_t>> shard_keys(_clients.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    shard_keys[GetShard(keys[i])].push_back(i);
+  }
+  for (size_t shard = 0; shard < _clients.size(); ++shard) {
+    auto& client = _clients[shard];
+    const auto& indices = shard_keys[shard];
+    if (indices.empty()) {
+      continue;
+    }
+    client->send_command_for_key(Command::MULTI_SET, "");
+    client->send_value<size_t>(indices.size());
+    for (size_t i : indices) {
+      client->send_string(_key_prefix + keys[i]);
+      client->send_vector<uint8_t>(values[i]);
+    }
+  }
+}
+
 TCPStore::~TCPStore() { VLOG(7) << "TCPStore destructure"; }
 
 }  // namespace distributed
@@ -27,8 +27,10 @@
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "paddle/phi/core/distributed/store/socket.h"
 #include "paddle/phi/core/distributed/store/store.h"
@@ -38,7 +40,7 @@ namespace phi {
 namespace distributed {
 
 enum class ReplyType { WAITING, STOP_WAIT, READY, NOT_READY };
-enum class Command { ADD, GET, CHECK, SET, WAIT, STOP };
+enum class Command { ADD, GET, CHECK, SET, WAIT, STOP, MULTI_GET, MULTI_SET };
 
 namespace detail {
 
@@ -55,12 +57,19 @@ class MasterDaemon {
 
  private:
   void run();
+#ifndef __linux__
   void ProcessCommands(std::vector<struct pollfd>* p_fds);
+#endif
+  // return false if the socket is broken
+  bool ProcessCommand(SocketType socket);
+  void RemoveSocket(SocketType socket);
   void _do_add(SocketType socket);
   void _do_wait(SocketType socket);
   void _do_get(SocketType socket);
   void _do_check(SocketType socket);
   void _do_set(SocketType socket);
+  void _do_multi_get(SocketType socket);
+  void _do_multi_set(SocketType socket);
   void _notify_waiting_sockets(const std::string&);
   SocketType _listen_socket;
   std::vector<SocketType> _sockets;
@@ -70,6 +79,16 @@ class MasterDaemon {
   int _timeout = 0;
   std::unordered_map<std::string, std::vector<SocketType>>
       _waiting_sockets;  // key -> list of waiting sockets
+  // guards the store, the waiting sockets and the sockets, the commands of
+  // the sockets are received out of the lock
+  std::mutex _mutex;
+
+#ifdef __linux__
+  // the accepted sockets are spread on the epolls of the worker threads
+  void RunWorker(int epoll_fd);
+  std::vector<int> _epoll_fds;
+  std::vector<std::thread> _worker_threads;
+#endif
 
   void InitControlFd();
   void CloseControlFd();
@@ -99,6 +118,7 @@ class TCPClient {
                                             uint16_t port);
   ~TCPClient() { tcputils::close_socket(_socket); }
   void send_command_for_key(Command type, const std::string& key);
+  void send_string(const std::string& s);
 
   template <typename T>
   void send_value(const T& value);
@@ -118,6 +138,8 @@ class TCPClient {
 }  // namespace detail
 
 // TODO(gongwb) :Add IP6 support.
+// The keys are sharded on num_shards masters, served by the master rank on
+// the ports [port, port + num_shards).
 class TCPStore : public Store {
  public:
   static constexpr std::uint16_t kDefaultPort = 6170;
@@ -125,7 +147,8 @@ class TCPStore : public Store {
                     uint16_t port = kDefaultPort,
                     bool is_master = false,
                     size_t num_workers = 1,
-                    int timeout = 900);
+                    int timeout = 900,
+                    int num_shards = 1);
 
   ~TCPStore();
 
@@ -134,11 +157,16 @@ class TCPStore : public Store {
   bool check(const std::string& key) override;
   void wait(const std::string& key) override;
   void set(const std::string& key, const std::vector<uint8_t>& value) override;
+  std::vector<std::vector<uint8_t>> multi_get(
+      const std::vector<std::string>& keys) override;
+  void multi_set(const std::vector<std::string>& keys,
+                 const std::vector<std::vector<uint8_t>>& values) override;
 
  private:
   void waitWorkers();
-  std::unique_ptr<detail::TCPServer> _server;
-  std::unique_ptr<detail::TCPClient> _client;
+  size_t GetShard(const std::string& key);
+  std::vector<std::unique_ptr<detail::TCPServer>> _servers;
+  std::vector<std::unique_ptr<detail::TCPClient>> _clients;
 
   const std::string _init_key = "init/";
   const std::string _key_prefix = "/";
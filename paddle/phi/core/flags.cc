@@ -104,6 +104,24 @@ PHI_DEFINE_EXPORTED_int32(
     0,
     "Setting the check and print level when FLAGS_check_nan_inf is set.");
 
+/**
+ * Operator related FLAG
+ * Name: FLAGS_check_nan_inf_async_interval
+ * Since Version: 2.6.0
+ * Value Range: int32, default=0
+ * Example:
+ * Note: Used to debug. When it is positive and FLAGS_check_nan_inf_level is
+ * 0 or 1, the tensors on GPU are checked by a flag of every device without
+ * synchronizing, and the flags are read after so many tensors are checked or
+ * by paddle.base.core.check_nan_inf_flags(). Only the first tensor holding
+ * NAN/INF since the last read is reported.
+ */
+PHI_DEFINE_EXPORTED_int32(check_nan_inf_async_interval,
+                          0,
+                          "The number of the tensors checked on GPU before "
+                          "the flags of NAN/INF are read, 0 to check every "
+                          "tensor synchronously.");
+
 /**
  * Operator related FLAG
  * Name: FLAGS_check_nan_inf
@@ -215,6 +233,23 @@ PHI_DEFINE_EXPORTED_bool(
     true,
     "Whether enable api kernel fallback to CPU one when not found");
 
+/*
+ * Random related FLAG
+ * Name: FLAGS_use_random_substreams
+ * Since Version: 2.6
+ * Value Range: bool, default=false
+ * Example: FLAGS_use_random_substreams=true would make the random ops run by
+ * the new executor draw from the Philox sub-streams of their own, derived
+ * from (seed, op, step), instead of the shared offset of the generator. The
+ * random numbers of an op then do not depend on the order the other random
+ * ops run in, over the streams and the replays of the CUDA graphs.
+ */
+PHI_DEFINE_EXPORTED_bool(
+    use_random_substreams,
+    false,
+    "Whether the random ops draw from the Philox sub-streams derived from "
+    "(seed, op, step), instead of the shared offset of the generator.");
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 /**
  * CUDNN related FLAG
@@ -250,6 +285,22 @@ PHI_DEFINE_EXPORTED_int64(
     "operator. The deterministic algorithm may be slower. If "
     "it is larger than 0, the algorithm is deterministic.");
 
+/**
+ * CUDA related FLAG
+ * Name: FLAGS_gpu_stream_callback_polling
+ * Since Version: 2.6
+ * Value Range: bool, default=false
+ * Example: FLAGS_gpu_stream_callback_polling=true
+ * Note: Run the host callbacks of the streams, like the ones of the garbage
+ * collectors, by a thread of every device context waiting for the events
+ * recorded for them, instead of a host function launched on the stream and a
+ * thread for every callback. The events are recycled.
+ */
+PHI_DEFINE_EXPORTED_bool(gpu_stream_callback_polling,
+                         false,
+                         "Whether the stream callbacks are run by a thread "
+                         "waiting for the events recorded for them.");
+
 /**
  * CUDNN related FLAG
  * Name: FLAGS_conv_workspace_size_limit
@@ -266,6 +317,22 @@ PHI_DEFINE_EXPORTED_int64(conv_workspace_size_limit,
                           phi::backends::gpu::kDefaultConvWorkspaceSizeLimitMB,
                           "cuDNN convolution workspace limit in MB unit.");
 
+/**
+ * CUDA related FLAG
+ * Name: FLAGS_fft_plan_split_batch
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: If true, the batch of a FFT whose plan is not cached is split by the
+ * powers of 2, and the pieces are executed by the cached plans of their
+ * batches. So the variable batches of the same signal size are executed by
+ * at most 63 plans, instead of a plan created for every batch.
+ */
+PHI_DEFINE_EXPORTED_bool(fft_plan_split_batch,
+                         false,
+                         "Whether to split the batches of the FFTs by the "
+                         "powers of 2 to share the cached plans.");
+
 /**
  * CUDNN related FLAG
  * Name: FLAGS_cudnn_exhaustive_search
@@ -392,6 +459,74 @@ PHI_DEFINE_EXPORTED_int32(dist_threadpool_size,
                           0,
                           "number of threads used for distributed executed.");
 
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_eager_reducer_adaptive_groups
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: Whether the EagerReducer of DataParallel rebuilds its groups by the
+ *       order the grads of the first step are ready in, like the groups of
+ *       rank 0. The grads of the parameters also become the views of the
+ *       fused buffers after the allreduce, so the grads accumulated in place
+ *       skip the concat and the split copies. The groups are not rebuilt
+ *       when find_unused_parameters is set.
+ */
+PHI_DEFINE_EXPORTED_bool(eager_reducer_adaptive_groups,
+                         false,
+                         "Rebuild the groups of the EagerReducer by the ready "
+                         "order of the grads, and keep the grads as the views "
+                         "of the fused buffers.");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_auto_parallel_dist_cache_size
+ * Since Version: 2.6.0
+ * Value Range: int64, default=4096
+ * Example:
+ * Note: The max number of the entries cached of the InferSpmd results and the
+ *       reshard functions chosen of the DistTensor ops in dynamic mode, which
+ *       are keyed by the dims and the dist attrs of the inputs and by the
+ *       attrs. A full cache is cleared, and 0 disables the caches.
+ */
+PHI_DEFINE_EXPORTED_int64(auto_parallel_dist_cache_size,
+                          4096,
+                          "The max number of the cached InferSpmd results "
+                          "and reshard functions, 0 to disable the caches.");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_gloo_shm_allreduce_min_bytes
+ * Since Version: 2.6.0
+ * Value Range: int64, default=0
+ * Example:
+ * Note: If positive, the allreduces of at least so many bytes of the
+ *       GlooCommContext are done by a shared memory of 2MB for every rank,
+ *       instead of the TCP pairs of gloo, when all the ranks are on the same
+ *       host. 0 disables the shared memory.
+ */
+PHI_DEFINE_EXPORTED_int64(gloo_shm_allreduce_min_bytes,
+                          0,
+                          "The min bytes of the allreduces of gloo by the "
+                          "shared memory for the ranks on the same host.");
+
+/**
+ * Eager related FLAG
+ * Name: FLAGS_eager_backward_num_threads
+ * Since Version: 2.6.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_eager_backward_num_threads=4, run the ready grad nodes of
+ *          the eager backward on 4 threads.
+ * Note: The parallel backward only works on CPU, without create_graph and
+ *       the force sequential nodes, and the grad nodes of the leaf tensors
+ *       always run on the thread calling backward. The thread pool is sized
+ *       the first time a parallel backward runs. If it is not greater than
+ *       1, the backward runs sequentially.
+ */
+PHI_DEFINE_EXPORTED_int32(eager_backward_num_threads,
+                          0,
+                          "number of threads used for the eager backward.");
+
 /**
  * Garbage collector related FLAG
  * Name: FLAGS_eager_delete_tensor_gb
@@ -465,10 +600,12 @@ PHI_DEFINE_EXPORTED_double(
  * Allocator related FLAG
  * Name: FLAGS_allocator_strategy
  * Since Version: 1.2
- * Value Range: string, {naive_best_fit, auto_growth, thread_local},
- * default=auto_growth
+ * Value Range: string, {naive_best_fit, auto_growth, thread_local,
+ * cuda_malloc_async}, default=auto_growth
  * Example:
- * Note: For selecting allocator policy of PaddlePaddle.
+ * Note: For selecting allocator policy of PaddlePaddle. cuda_malloc_async
+ * allocates the GPU memory from the stream-ordered pools of the CUDA driver,
+ * which needs CUDA 11.2 or later.
  */
 static constexpr char kDefaultAllocatorStrategy[] = "auto_growth";  // NOLINT
 PHI_DEFINE_EXPORTED_string(
@@ -486,6 +623,37 @@ PHI_DEFINE_EXPORTED_string(
     "on the same GPU card but may lead to more memory fragmentation "
     "(i.e., maximum batch size of models may be smaller).");
 
+/**
+ * Allocator related FLAG
+ * Name: FLAGS_cuda_malloc_async_release_threshold_mb
+ * Since Version: 2.6
+ * Value Range: int64, default=-1
+ * Example: FLAGS_cuda_malloc_async_release_threshold_mb=1024
+ * Note: The memory kept by the pool of a device with the cuda_malloc_async
+ * strategy, the free memory above it is returned to the driver at the
+ * synchronizations of the device. -1 keeps all the free memory.
+ */
+PHI_DEFINE_EXPORTED_int64(
+    cuda_malloc_async_release_threshold_mb,
+    -1,
+    "The free memory in MB kept by the stream-ordered memory pool, -1 keeps "
+    "all of it.");
+
+/**
+ * Allocator related FLAG
+ * Name: FLAGS_cuda_malloc_async_ipc
+ * Since Version: 2.6
+ * Value Range: bool, default=false
+ * Example: FLAGS_cuda_malloc_async_ipc=true
+ * Note: With the cuda_malloc_async strategy, create the pools of the devices
+ * exportable to the other processes by POSIX file descriptors, instead of
+ * using the default pools of the devices.
+ */
+PHI_DEFINE_EXPORTED_bool(cuda_malloc_async_ipc,
+                         false,
+                         "Whether the stream-ordered memory pools are "
+                         "exportable to the other processes.");
+
 /**
  * Memory related FLAG
  * Name: FLAGS_fraction_of_cpu_memory_to_use
@@ -671,6 +839,48 @@ PHI_DEFINE_EXPORTED_bool(
     "If set true, the queue.pop will only get data from queue but not "
     "remove the data from queue for speed testing");
 
+/**
+ * Reader related FLAG
+ * Name: FLAGS_reader_prefetch_depth
+ * Since Version: 2.6.0
+ * Value Range: int32, default=2
+ * Example: FLAGS_reader_prefetch_depth=4 keeps up to 4 batches copied to the
+ * device ahead of the training by the DataLoader.
+ * Note: The most batches in flight of the buffered reader of the DataLoader.
+ */
+PHI_DEFINE_EXPORTED_int32(reader_prefetch_depth,
+                          2,
+                          "The most batches in flight of the DataLoader.");
+
+/**
+ * Reader related FLAG
+ * Name: FLAGS_reader_prefetch_memory_mb
+ * Since Version: 2.6.0
+ * Value Range: int64, default=0
+ * Example:
+ * Note: If positive, the batches in flight of a buffered reader are limited
+ * to the memory in MB by the size of its first batch, but are at least 2 so
+ * that the copies still overlap the training.
+ */
+PHI_DEFINE_EXPORTED_int64(reader_prefetch_memory_mb,
+                          0,
+                          "The memory in MB of the batches in flight.");
+
+/**
+ * Reader related FLAG
+ * Name: FLAGS_hdfs_read_ahead_files
+ * Since Version: 2.6.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_hdfs_read_ahead_files=4 opens the pipes of the next 4 files
+ * on HDFS of a dataset while the former ones are read.
+ * Note: The startup of the hdfs client of a file overlaps the reading of the
+ * former files, 0 to open every file when it is read.
+ */
+PHI_DEFINE_EXPORTED_int32(hdfs_read_ahead_files,
+                          0,
+                          "The number of the files on HDFS of a dataset "
+                          "opened ahead of reading.");
+
 /**
  * MKLDNN related FLAG
  * Name: use_mkldnn
@@ -681,6 +891,20 @@ PHI_DEFINE_EXPORTED_bool(
  */
 PHI_DEFINE_EXPORTED_bool(use_mkldnn, false, "Use MKLDNN to run");
 
+/**
+ * MKLDNN related FLAG
+ * Name: onednn_primitive_cache_capacity
+ * Since Version: 2.6.0
+ * Value Range: int64, default=0
+ * Example: FLAGS_onednn_primitive_cache_capacity=1024
+ * Note: The capacity of the process wide oneDNN primitive cache shared by
+ * all the threads and predictors, the cache is disabled when it is 0.
+ */
+PHI_DEFINE_EXPORTED_int64(onednn_primitive_cache_capacity,
+                          0,
+                          "The capacity of the process wide oneDNN primitive "
+                          "cache, 0 means disabled.");
+
 /**
  * Debug related FLAG
  * Name: FLAGS_call_stack_level
@@ -893,6 +1117,34 @@ PHI_DEFINE_EXPORTED_double(graph_neighbor_size_percent,
                            1.0,
                            "It controls whether precent of neighbor_size.");
 
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_graph_compact_edges
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: Control whether the edges of the cpu graph table are compacted after
+ *       loading, the neighbor ids are bit packed and the weights quantized to
+ *       FLAGS_graph_compact_edge_weight_bits bits.
+ */
+PHI_DEFINE_EXPORTED_bool(graph_compact_edges,
+                         false,
+                         "It controls whether the edges of the cpu graph "
+                         "table are compacted after loading.");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_graph_compact_edge_weight_bits
+ * Since Version: 2.6.0
+ * Value Range: int32, 32, 16 or 8, default=32
+ * Example:
+ * Note: The bits of an edge weight of the compacted edges.
+ */
+PHI_DEFINE_EXPORTED_int32(graph_compact_edge_weight_bits,
+                          32,
+                          "The bits of an edge weight of the compacted edges, "
+                          "32, 16 or 8.");
+
 /**
  * Distributed related FLAG
  * Name: FLAGS_graph_metapath_split_opt
@@ -961,6 +1213,98 @@ PHI_DEFINE_EXPORTED_int32(gpugraph_storage_mode,
                           1,
                           "gpugraph storage mode, default 1");
 
+/**
+ * GPUPS related FLAG
+ * Name: FLAGS_gpups_pipelined_pass
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: Pipeline the pass lifecycle of PSGPUWrapper. The keys of the next pass
+ *       are divided to the devices in the build thread while the current pass
+ *       trains, and EndPass returns once the hbm values are copied to host,
+ *       the cpu table is filled back in background until the next BeginPass
+ *       or WaitEndPass.
+ */
+PHI_DEFINE_EXPORTED_bool(gpups_pipelined_pass,
+                         false,
+                         "Pipeline the pass building and dumping of GPUPS.");
+
+/**
+ * GPUPS related FLAG
+ * Name: FLAGS_gpups_hot_key_num
+ * Since Version: 2.6.0
+ * Value Range: int32, default=0
+ * Example:
+ * Note: The number of the hottest keys of a pass, by show, whose pull values
+ *       are replicated on every device. The pulls of the replicated keys are
+ *       served locally instead of by the owner device, which balances the
+ *       shards skewed by a few hot keys. 0 disables the replication. Only the
+ *       single node pulls use the replicas, the pushes go to the owners.
+ */
+PHI_DEFINE_EXPORTED_int32(gpups_hot_key_num,
+                          0,
+                          "The number of hot keys replicated on every device.");
+
+/**
+ * GPUPS related FLAG
+ * Name: FLAGS_gpups_hot_key_refresh_interval
+ * Since Version: 2.6.0
+ * Value Range: int32, default=8
+ * Example:
+ * Note: The replicas of the hot keys are pulled from the owners every this
+ *       number of pulls of a device, so they are stale for at most this
+ *       number of pulls.
+ */
+PHI_DEFINE_EXPORTED_int32(gpups_hot_key_refresh_interval,
+                          8,
+                          "The pulls between the hot key replica refreshes.");
+
+/**
+ * GPUPS related FLAG
+ * Name: FLAGS_gpups_device_key_dedup_chunk
+ * Since Version: 2.6.0
+ * Value Range: int32, default=0
+ * Example:
+ * Note: Extract the keys of a pass from the slot records and dedup them by
+ *       the radix sort on the devices, in chunks of this number of keys,
+ *       instead of by the hash sets of the cpu threads. 0 dedups the keys on
+ *       the cpu.
+ */
+PHI_DEFINE_EXPORTED_int32(gpups_device_key_dedup_chunk,
+                          0,
+                          "The number of keys deduped by a device at once.");
+
+/**
+ * GPUPS related FLAG
+ * Name: FLAGS_gpups_hbm_cache_ratio
+ * Since Version: 2.6.0
+ * Value Range: double, (0, 1], default=1.0
+ * Example:
+ * Note: The ratio of the keys of a device whose values are held in hbm, the
+ *       hottest by show. The values of the other keys are held in the pinned
+ *       host memory and accessed by the kernels through the unified address
+ *       space, so that a pass is not bounded by the hbm. 1.0 holds all the
+ *       values in hbm.
+ */
+PHI_DEFINE_EXPORTED_double(gpups_hbm_cache_ratio,
+                           1.0,
+                           "The ratio of the values of a pass held in hbm.");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_pull_dense_double_buffer
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: Pull the dense params of the cpu trainers into one of two buffers
+ *       which is then published by a version. The trainer threads bind the
+ *       newest buffer at the start of a batch, so they never read a
+ *       partially pulled param nor wait for a pull.
+ */
+PHI_DEFINE_EXPORTED_bool(pull_dense_double_buffer,
+                         false,
+                         "Double buffer the dense params of PullDenseWorker.");
+
 /**
  * KP kernel related FLAG
  * Name: FLAGS_run_kp_kernel
@@ -1086,6 +1430,21 @@ PHI_DEFINE_EXPORTED_string(cinn_subgraph_graphviz_dir,
 
 #endif
 
+/*
+ * FusionGroup related FLAG
+ * Name: FLAGS_fusion_group_cache_dir
+ * Since Version: 2.6
+ * Value Range: string, default=""
+ * Example: FLAGS_fusion_group_cache_dir="./fusion_group_cache/" will save the
+ * PTX of the JIT compiled kernels into "./fusion_group_cache/", named by the
+ * hash of the kernel source, and the restarted jobs load the PTX instead of
+ * compiling the kernels by NVRTC again.
+ */
+PHI_DEFINE_EXPORTED_string(fusion_group_cache_dir,
+                           "",
+                           "Specify the directory to cache the PTX of the "
+                           "JIT compiled kernels in.");
+
 /*
  * CUDA Graph related FLAG
  * Name: FLAGS_new_executor_use_cuda_graph
@@ -1098,6 +1457,193 @@ PHI_DEFINE_EXPORTED_bool(new_executor_use_cuda_graph,
                          false,
                          "Use CUDA Graph in new executor");
 
+/*
+ * CUDA Graph related FLAG
+ * Name: FLAGS_new_executor_cuda_graph_replay_max_shapes
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_new_executor_cuda_graph_replay_max_shapes=n (n>0) would let
+ * PirInterpreter capture the whole program into a CUDA Graph for each of the
+ * first n feed shape signatures and replay it in the following runs. The
+ * program is run as usual for the other shapes. Only the programs with all
+ * the kernels launched asynchronously on a single stream are captured, and the
+ * fetched tensors are overwritten by the next replay of the same shapes. The
+ * custom devices whose plugins implement the graph api of C_DeviceInterface
+ * are captured by their plugins in the same way.
+ */
+PHI_DEFINE_EXPORTED_int32(new_executor_cuda_graph_replay_max_shapes,
+                          0,
+                          "Max number of feed shapes captured into CUDA Graph "
+                          "by new executor, 0 means disabled");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_use_static_memory_plan
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_new_executor_use_static_memory_plan=true would let
+ * PirInterpreter record the variable sizes in the first run, pack the
+ * variables into one arena per device context by their lifetimes, and bind
+ * the variables to fixed offsets of the arena in the following runs. It is
+ * intended for the programs with static shapes.
+ */
+PHI_DEFINE_EXPORTED_bool(new_executor_use_static_memory_plan,
+                         false,
+                         "Use ahead-of-time static memory plan in new "
+                         "executor");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_dispatch_table_file
+ * Since Version: 3.0.0
+ * Value Range: string, default=""
+ * Example: FLAGS_new_executor_dispatch_table_file=table.cc would let
+ * PirInterpreter write the dispatch table of the program after the first run
+ * to table.cc as C++ source: the kernels with their keys in the launch order,
+ * and the arena offsets of the variables if the static memory plan is used.
+ */
+PHI_DEFINE_EXPORTED_string(new_executor_dispatch_table_file,
+                           "",
+                           "The file to write the dispatch table of the "
+                           "program by new executor");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_dependency_aware_gc
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_new_executor_dependency_aware_gc=true would let
+ * PirInterpreter move the garbage collection of a GPU variable, whose last
+ * user runs on another stream, to the first later instruction on the stream
+ * owning the variable, if the dependency graph guarantees that instruction to
+ * run after the last user. Then the variable is freed on its own stream
+ * without recording and querying a cross-stream event.
+ */
+PHI_DEFINE_EXPORTED_bool(new_executor_dependency_aware_gc,
+                         false,
+                         "Free cross-stream variables on their owning stream "
+                         "by dependency analysis in new executor");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_use_host_offload
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_new_executor_use_host_offload=true would let PirInterpreter
+ * running in trace mode copy the GPU tensors to pinned host memory when they
+ * are not used for a long time, and prefetch them back before their next use,
+ * including the parameters and optimizer states between two runs. The copies
+ * are issued on a side stream.
+ */
+PHI_DEFINE_EXPORTED_bool(new_executor_use_host_offload,
+                         false,
+                         "Offload idle GPU tensors to host memory in new "
+                         "executor");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_async_fetch_depth
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_new_executor_async_fetch_depth=2 would let StandaloneExecutor
+ * running with PIR on GPU copy the fetch tensors to pinned host memory on a
+ * side stream without waiting for the device, and return the fetch results of
+ * the run 2 runs before, or nothing for the first 2 runs. 0 is to fetch
+ * synchronously.
+ */
+PHI_DEFINE_EXPORTED_int32(new_executor_async_fetch_depth,
+                          0,
+                          "The runs by which the fetch results lag behind "
+                          "in new executor, 0 to fetch synchronously");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_run_ahead_depth
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_new_executor_run_ahead_depth=2 would let StandaloneExecutor
+ * running with PIR on GPU stage the CPU feed tensors in pinned host memory, so
+ * that the host issues a run while the kernels of up to 2 runs before are
+ * still running on the device. A synchronous fetch is still a barrier, which
+ * is lifted by FLAGS_new_executor_async_fetch_depth. 0 is to disable it.
+ */
+PHI_DEFINE_EXPORTED_int32(new_executor_run_ahead_depth,
+                          0,
+                          "The runs by which the host may run ahead of the "
+                          "device in new executor, 0 to disable it");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_host_offload_min_bytes
+ * Since Version: 3.0.0
+ * Value Range: uint64, default=1048576 (1MB)
+ * Example: FLAGS_new_executor_host_offload_min_bytes=1048576 would only
+ * offload the tensors not smaller than 1MB.
+ */
+PHI_DEFINE_EXPORTED_uint64(new_executor_host_offload_min_bytes,
+                           1 << 20,
+                           "Min size in bytes of the tensors offloaded to host "
+                           "by new executor");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_host_offload_prefetch_distance
+ * Since Version: 3.0.0
+ * Value Range: int32, default=8
+ * Example: FLAGS_new_executor_host_offload_prefetch_distance=8 would issue the
+ * copy back to device 8 instructions before the next use of an offloaded
+ * tensor. Only the tensors idle for at least twice the distance are offloaded.
+ */
+PHI_DEFINE_EXPORTED_int32(new_executor_host_offload_prefetch_distance,
+                          8,
+                          "Number of instructions to prefetch the offloaded "
+                          "tensors ahead of their use in new executor");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_use_work_stealing
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_new_executor_use_work_stealing=true would let the host
+ * workers of PirInterpreter push all ready successors into their own queues
+ * and let the idle workers steal them, instead of binding the same-thread
+ * successor at build time.
+ */
+PHI_DEFINE_EXPORTED_bool(new_executor_use_work_stealing,
+                         false,
+                         "Use work-stealing dispatch for host instructions in "
+                         "new executor");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_use_critical_path_priority
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_new_executor_use_critical_path_priority=true would let
+ * PirInterpreter dispatch the ready instructions on the longest remaining
+ * dependency chain first. The chain length is measured in instructions before
+ * the first run and in host time after it.
+ */
+PHI_DEFINE_EXPORTED_bool(new_executor_use_critical_path_priority,
+                         false,
+                         "Dispatch instructions by critical path rank in new "
+                         "executor");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_cache_infer_meta
+ * Since Version: 3.0.0
+ * Value Range: bool, default=true
+ * Example: FLAGS_new_executor_cache_infer_meta=false would let the kernel
+ * instructions run the InferMeta on every run. By default the metas of the
+ * outputs are restored from the last run when the metas of the inputs are
+ * unchanged, which skips the InferMeta of the static shape models.
+ */
+PHI_DEFINE_EXPORTED_bool(new_executor_cache_infer_meta,
+                         true,
+                         "Cache the output metas of InferMeta by the input "
+                         "metas in new executor");
+
 /*
  * Executor related FLAG
  * Name: FLAGS_executor_log_deps_every_microseconds
@@ -1125,6 +1671,15 @@ PD_DEFINE_bool(enable_slotrecord_reset_shrink,  // NOLINT
 PD_DEFINE_bool(enable_ins_parser_file,  // NOLINT
                false,
                "enable parser ins file, default false");
+PD_DEFINE_string(slotrecord_binary_cache_dir,  // NOLINT
+                 "",
+                 "the local dir to cache the parsed slot record files in the "
+                 "binary format, the cached files are loaded instead of "
+                 "parsing the text again, default empty to disable");
+PD_DEFINE_int32(slotrecord_pack_thread_num,
+                5,
+                "SlotRecordInMemoryDataFeed threads packing and uploading the "
+                "batches ahead of the training on gpu, default 5");
 PHI_DEFINE_EXPORTED_bool(
     gpugraph_enable_hbm_table_collision_stat,
     false,
@@ -1168,6 +1723,11 @@ PHI_DEFINE_EXPORTED_bool(enable_auto_detect_gpu_topo,
 PHI_DEFINE_EXPORTED_bool(enable_auto_rdma_trans,
                          true,
                          "enable auto gpu rdma trans, default true");
+PHI_DEFINE_EXPORTED_bool(
+    enable_topo_aware_route,
+    false,
+    "route the copies between gpus by the links of nvidia-smi topo -m "
+    "instead of the fixed transfer gpu, default false");
 PHI_DEFINE_EXPORTED_bool(enable_tracker_all2all,
                          false,
                          "enable tracker all2all log, default false");
@@ -1195,6 +1755,16 @@ PHI_DEFINE_EXPORTED_bool(multi_node_sample_use_gpu_table,
                          true,
                          "Control whether to use gpu table in sample multi "
                          "machine in gpu graph mode");
+PHI_DEFINE_EXPORTED_int64(
+    gpugraph_neighbor_cache_size,
+    0,
+    "the max number of neighbors of the cpu nodes cached on a gpu for an edge "
+    "type, which are sampled on gpu instead of cpu, default 0 (disabled)");
+PHI_DEFINE_EXPORTED_int32(
+    gpugraph_neighbor_cache_refill_num,
+    100000,
+    "the neighbor cache is refilled asynchronously after this number of cpu "
+    "node queries, default 100000");
 
 /**
  * ProcessGroupNCCL related FLAG
@@ -1224,6 +1794,21 @@ PHI_DEFINE_EXPORTED_bool(benchmark_nccl,
  */
 PHI_DEFINE_EXPORTED_bool(use_autotune, false, "Whether enable autotune.");
 
+/**
+ * Autotune related FLAG
+ * Name: FLAGS_autotune_cache_file
+ * Since Version: 2.6.0
+ * Value Range: string, default=""
+ * Example: FLAGS_autotune_cache_file=/path/to/autotune_cache
+ * Note: If set, the autotune cache is loaded from the file when autotune is
+ * enabled, and saved to the file when the autotune steps finish, so the
+ * algorithms tuned by a run are reused by the next runs on the same device
+ * and library versions.
+ */
+PHI_DEFINE_EXPORTED_string(autotune_cache_file,
+                           "",
+                           "The file to load and save the autotune cache.");
+
 /**
  * Conv Search cache max number related FLAG
  * Name: FLAGS_search_cache_max_number
@@ -1312,6 +1897,67 @@ PHI_DEFINE_EXPORTED_bool(trt_ibuilder_cache,
                          false,
                          "Add a persistent ibuilder.");
 
+/**
+ * Inference related FLAG
+ * Name: trt_partition_speedup
+ * Since Version: 3.0.0
+ * Value Range: double, default=0.0
+ * Example: FLAGS_trt_partition_speedup=3.0
+ * Note: If greater than 1, tensorrt_subgraph_pass only replaces a subgraph by
+ * an engine when the kernels of its ops, estimated to run this many times
+ * faster in TensorRT, save more than the copies of the variables crossing its
+ * boundary and the launch cost of the engine. Otherwise every subgraph larger
+ * than min_subgraph_size is replaced.
+ */
+PHI_DEFINE_EXPORTED_double(trt_partition_speedup,
+                           0.0,
+                           "The estimated speedup of TensorRT to partition "
+                           "the subgraphs by cost.");
+
+/**
+ * Inference related FLAG
+ * Name: trt_calib_tensor_scales_file
+ * Since Version: 3.0.0
+ * Value Range: string, default=""
+ * Example: FLAGS_trt_calib_tensor_scales_file=scales.txt
+ * Note: If set, the tensor scales of every TensorRT int8 calibration table are
+ * merged into this file, and an engine to calibrate whose input tensors are
+ * all in the file reuses the scales instead of running the calibration, e.g.,
+ * when the subgraphs are re-partitioned or the shape profiles change.
+ */
+PHI_DEFINE_EXPORTED_string(trt_calib_tensor_scales_file,
+                           "",
+                           "The file of the calibrated tensor scales shared "
+                           "by the TensorRT engines.");
+
+/**
+ * Inference related FLAG
+ * Name: ort_share_allocators
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_ort_share_allocators=true
+ * Note: If True, the ONNXRuntime predictors in the process allocate on the CPU
+ * arena registered in their shared Ort::Env, instead of an arena per session.
+ */
+PHI_DEFINE_EXPORTED_bool(ort_share_allocators,
+                         false,
+                         "Share the CPU arena among the ONNXRuntime sessions.");
+
+/**
+ * Inference related FLAG
+ * Name: lite_engine_build_threads
+ * Since Version: 3.0.0
+ * Value Range: int32, default=1
+ * Example: FLAGS_lite_engine_build_threads=4
+ * Note: The number of the threads lite_subgraph_pass creates the Paddle-Lite
+ * engines of the subgraphs on. More threads load a model of many subgraphs
+ * faster, while the programs of more engines are optimized at the same time.
+ */
+PHI_DEFINE_EXPORTED_int32(lite_engine_build_threads,
+                          1,
+                          "The number of the threads to create the Lite "
+                          "engines of the subgraphs.");
+
 /**
  * mmap_allocator related FLAG
  * Name: use_shm_cache
@@ -1325,6 +1971,20 @@ PHI_DEFINE_EXPORTED_bool(use_shm_cache,
                          false,
                          "Use shm cache in mmap_allocator.");
 
+/**
+ * mmap_allocator related FLAG
+ * Name: shm_segment_size_mb
+ * Since Version: 2.6.0
+ * Value Range: int64, default=0
+ * Example:
+ * Note: If positive, the tensors shared by the DataLoader workers are
+ * allocated from the recycled shm segments of the size in MB, instead of a
+ * shm file per tensor. The larger tensors still use their own files.
+ */
+PHI_DEFINE_EXPORTED_int64(shm_segment_size_mb,
+                          0,
+                          "The size in MB of the pooled shm segments.");
+
 /**
  * Tensor operants related FLAG
  * Name: tensor_operants_mode
@@ -1464,12 +2124,121 @@ PHI_DEFINE_EXPORTED_string(pir_onednn_kernel_blacklist,
 
 PHI_DEFINE_EXPORTED_bool(enable_record_memory, false, "Enable memory recorder");
 
+/**
+ * Profiler related FLAG
+ * Name: FLAGS_profile_memory_fragmentation
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_profile_memory_fragmentation=true would add the chunks, the
+ * largest free block and the free block size histogram of each auto_growth
+ * allocator to the ExtraInfo of the profiler result when the profiler stops.
+ */
+PHI_DEFINE_EXPORTED_bool(profile_memory_fragmentation,
+                         false,
+                         "Record the memory fragmentation of the auto_growth "
+                         "allocators in the profiler result");
+
+/**
+ * Memory related FLAG
+ * Name: FLAGS_enable_memory_attribution
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_enable_memory_attribution=true
+ * FLAGS_memory_attribution_dir=./mem
+ * Note: Attribute the allocations to the instructions and the variables of the
+ * new executor, and record the memory timeline and the blocks alive at the
+ * peak. On an out of memory error the report is logged, and saved with the
+ * timeline to FLAGS_memory_attribution_dir if it is set.
+ */
+PHI_DEFINE_EXPORTED_bool(enable_memory_attribution,
+                         false,
+                         "Attribute the allocations to the instructions");
+
+PHI_DEFINE_EXPORTED_string(memory_attribution_dir,
+                           "",
+                           "The directory to save the memory timeline and "
+                           "the peak report to on an out of memory error");
+
 PHI_DEFINE_EXPORTED_bool(
     eager_delete_scope,
     true,
     "Delete local scope eagerly. It will reduce GPU memory usage but "
     "slow down the destruction of variables.(around 1% performance harm)");
 
+/**
+ * Inference related FLAG
+ * Name: FLAGS_inference_freeze_param_scope
+ * Since Version: 2.6
+ * Value Range: bool, default=false
+ * Example: FLAGS_inference_freeze_param_scope=true
+ * Note: Freeze the parameter scope of a predictor after its Init, so that the
+ * lookups of the parameters by the predictor and its clones take no lock. The
+ * variables of a frozen scope may still be written, but no variable may be
+ * created in, erased from or renamed in it.
+ */
+PHI_DEFINE_EXPORTED_bool(inference_freeze_param_scope,
+                         false,
+                         "Freeze the parameter scope of the predictor.");
+
+/**
+ * Inference related FLAG
+ * Name: FLAGS_inference_memory_offset_plan
+ * Since Version: 2.6
+ * Value Range: bool, default=false
+ * Example: FLAGS_inference_memory_offset_plan=true
+ * Note: With enable_memory_optim, place the intermediate tensors of a legacy
+ * predictor at the offsets of one workspace planned by their lifetimes, sized
+ * by the max shapes of the shape range info when it is given. A tensor which
+ * outgrows its slot falls back to its own allocation.
+ */
+PHI_DEFINE_EXPORTED_bool(inference_memory_offset_plan,
+                         false,
+                         "Pack the intermediate tensors of the predictor into "
+                         "one workspace.");
+
+/**
+ * Inference related FLAG
+ * Name: FLAGS_inference_gpu_handle_pool_size
+ * Since Version: 2.6
+ * Value Range: int32, default=0
+ * Example: FLAGS_inference_gpu_handle_pool_size=16
+ * Note: The number of the idle cuBLAS, cuBLASLt, cuDNN, cuSOLVER and cuSPARSE
+ * handles of every kind kept for a device when the predictors are destroyed.
+ * The handles are lent to the next predictors with their own streams and
+ * bound to the streams, instead of being created. 0 disables the pool.
+ */
+PHI_DEFINE_EXPORTED_int32(inference_gpu_handle_pool_size,
+                          0,
+                          "The max number of the idle gpu library handles of "
+                          "a kind kept for a device.");
+
+/**
+ * Debug related FLAG
+ * Name: FLAGS_enable_runtime_metrics
+ * Since Version: 2.6
+ * Value Range: bool, default=false
+ * Example: FLAGS_enable_runtime_metrics=true FLAGS_runtime_metrics_port=9400
+ * Note: Record the runtime metrics of the op latencies, the allocators, the
+ * communication and the parameter server, which are served on
+ * FLAGS_runtime_metrics_port at /metrics in the prometheus text format, and
+ * written to FLAGS_runtime_metrics_file every
+ * FLAGS_runtime_metrics_interval_s seconds.
+ */
+PHI_DEFINE_EXPORTED_bool(enable_runtime_metrics,
+                         false,
+                         "Record the runtime metrics.");
+PHI_DEFINE_EXPORTED_int32(runtime_metrics_port,
+                          0,
+                          "The port serving the runtime metrics, 0 to "
+                          "disable.");
+PHI_DEFINE_EXPORTED_string(runtime_metrics_file,
+                           "",
+                           "The file the runtime metrics are written to, "
+                           "empty to disable.");
+PHI_DEFINE_EXPORTED_int32(runtime_metrics_interval_s,
+                          10,
+                          "The interval of writing the runtime metrics.");
+
 // Used to filter events, works like glog VLOG(level).
 // RecordEvent will works if host_trace_level >= level.
 PHI_DEFINE_EXPORTED_int64(host_trace_level,
@@ -1520,6 +2289,62 @@ PHI_DEFINE_EXPORTED_bool(enable_async_trace,
 
 PHI_DEFINE_EXPORTED_int32(async_trace_count, 5, "collective async trace count");
 
+/**
+ * ProcessGroupNCCL related FLAG
+ * Name: enable_comm_profile
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_enable_async_trace=1 FLAGS_enable_comm_profile=1
+ * Note: profile the collectives traced by enable_async_trace. The time, the
+ * algorithm bandwidth and the bus bandwidth of each collective are recorded
+ * by CommTaskManager, and exported as trace events to the profiler.
+ */
+PHI_DEFINE_EXPORTED_bool(enable_comm_profile,
+                         false,
+                         "profile the traced collectives");
+
+/**
+ * ProcessGroupNCCL related FLAG
+ * Name: comm_profile_skew_interval
+ * Since Version: 2.6.0
+ * Value Range: int32, default=100
+ * Example: FLAGS_comm_profile_skew_interval=10
+ * Note: every comm_profile_skew_interval collectives of a group, the ranks
+ * exchange their collective time through the store to find the arrival skew
+ * and the straggler. 0 disables the exchange.
+ */
+PHI_DEFINE_EXPORTED_int32(comm_profile_skew_interval,
+                          100,
+                          "the interval of the collectives whose arrival skew "
+                          "is found across ranks");
+
+/**
+ * TCPStore related FLAG
+ * Name: tcp_store_num_threads
+ * Since Version: 2.6.0
+ * Value Range: int32, default=4
+ * Example: FLAGS_tcp_store_num_threads=8
+ * Note: the number of the threads serving the sockets of a TCPStore master,
+ * on linux the sockets are spread on the epolls of the threads.
+ */
+PHI_DEFINE_EXPORTED_int32(tcp_store_num_threads,
+                          4,
+                          "the number of threads of a TCPStore master");
+
+/**
+ * TCPStore related FLAG
+ * Name: tcp_store_num_shards
+ * Since Version: 2.6.0
+ * Value Range: int32, default=1
+ * Example: FLAGS_tcp_store_num_shards=4
+ * Note: the number of the masters the keys of the global TCPStore are
+ * sharded on, served by rank 0 on the ports [port, port + num_shards).
+ */
+PHI_DEFINE_EXPORTED_int32(tcp_store_num_shards,
+                          1,
+                          "the number of the key shards of the global "
+                          "TCPStore");
+
 PHI_DEFINE_EXPORTED_bool(
     use_auto_growth_pinned_allocator,
     false,
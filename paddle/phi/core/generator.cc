@@ -274,6 +274,11 @@ std::pair<uint64_t, uint64_t> Generator::IncrementOffset(uint64_t increment) {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP) || \
     defined(PADDLE_WITH_CUSTOM_DEVICE)
   std::lock_guard<std::mutex> lock(mu_);
+  uint64_t stream_id;
+  if (GetActiveSubStream(&stream_id)) {
+    uint64_t step = state().sub_stream_steps[stream_id]++;
+    return std::make_pair(SubStreamSeed(state().seed, stream_id, step), 0);
+  }
   uint64_t offset = state().offset;
   state().offset = offset + increment;
   print_state_info();
@@ -284,4 +289,41 @@ std::pair<uint64_t, uint64_t> Generator::IncrementOffset(uint64_t increment) {
 #endif
 }
 
+// The active sub-stream of the thread.
+static thread_local bool sub_stream_active = false;
+static thread_local uint64_t sub_stream_id = 0;
+
+Generator::SubStreamGuard::SubStreamGuard(uint64_t stream_id)
+    : prev_active_(sub_stream_active), prev_stream_id_(sub_stream_id) {
+  sub_stream_active = true;
+  sub_stream_id = stream_id;
+}
+
+Generator::SubStreamGuard::~SubStreamGuard() {
+  sub_stream_active = prev_active_;
+  sub_stream_id = prev_stream_id_;
+}
+
+bool Generator::GetActiveSubStream(uint64_t* stream_id) {
+  *stream_id = sub_stream_id;
+  return sub_stream_active;
+}
+
+// The finalizer of SplitMix64, which maps the close inputs to the unrelated
+// outputs.
+static inline uint64_t MixBits(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+uint64_t Generator::SubStreamSeed(uint64_t seed,
+                                  uint64_t stream_id,
+                                  uint64_t step) {
+  constexpr uint64_t kGolden = 0x9e3779b97f4a7c15ULL;
+  uint64_t x = MixBits(seed + kGolden);
+  x = MixBits(x ^ (stream_id + kGolden));
+  return MixBits(x ^ (step + kGolden));
+}
+
 }  // namespace phi
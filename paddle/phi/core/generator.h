@@ -21,10 +21,12 @@ limitations under the License. */
 #include <mutex>  // NOLINT
 #include <random>
 #include <typeinfo>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "paddle/phi/common/place.h"
+#include "paddle/utils/test_macros.h"
 
 namespace phi {
 
@@ -36,6 +38,8 @@ class Generator {
     uint64_t seed;
     uint64_t offset;
     std::shared_ptr<std::mt19937_64> cpu_engine;
+    // The steps of the sub-streams, by the stream ids.
+    std::unordered_map<uint64_t, uint64_t> sub_stream_steps;
 
     GeneratorState(int64_t device_ = -1,
                    uint64_t seed_ = MAGIC_RANDOM_SEED,
@@ -46,7 +50,10 @@ class Generator {
     }
 
     GeneratorState(const GeneratorState& state)
-        : device(state.device), seed(state.seed), offset(state.offset) {
+        : device(state.device),
+          seed(state.seed),
+          offset(state.offset),
+          sub_stream_steps(state.sub_stream_steps) {
       if (state.cpu_engine) {
         std::seed_seq seq({state.seed});
         cpu_engine = std::make_shared<std::mt19937_64>(seq);
@@ -60,6 +67,7 @@ class Generator {
         device = state.device;
         seed = state.seed;
         offset = state.offset;
+        sub_stream_steps = state.sub_stream_steps;
 
         if (state.cpu_engine) {
           std::seed_seq seq({state.seed});
@@ -77,6 +85,7 @@ class Generator {
       cpu_engine->seed(seq);
       offset = 0;
       seed = new_seed;
+      sub_stream_steps.clear();
     }
   };
 
@@ -122,9 +131,34 @@ class Generator {
   uint64_t Random64();
 
   // Increments the offset of the current generator state by a specified amount
-  // and returns the new seed and offset.
+  // and returns the new seed and offset. When a sub-stream is active on the
+  // thread, the offset is kept, and the Philox seed of the next step of the
+  // sub-stream is returned with the offset 0.
   std::pair<uint64_t, uint64_t> IncrementOffset(uint64_t increment_offset);
 
+  // Activates a counter-based sub-stream on the thread, e.g. for an op of a
+  // program. The random numbers of the steps of a sub-stream depend only on
+  // the seed, the stream id and the step, not on the order of the other
+  // sub-streams and the callers of the shared offset.
+  class TEST_API SubStreamGuard {
+   public:
+    explicit SubStreamGuard(uint64_t stream_id);
+    ~SubStreamGuard();
+
+   private:
+    bool prev_active_;
+    uint64_t prev_stream_id_;
+  };
+
+  // Returns whether a sub-stream is active on the thread, and its id.
+  TEST_API static bool GetActiveSubStream(uint64_t* stream_id);
+
+  // The Philox seed of a step of a sub-stream, a pure function of the
+  // arguments.
+  TEST_API static uint64_t SubStreamSeed(uint64_t seed,
+                                         uint64_t stream_id,
+                                         uint64_t step);
+
  private:
   // Accesses the current generator state by index.
   inline GeneratorState& state();
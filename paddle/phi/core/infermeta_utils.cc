@@ -14,6 +14,9 @@ limitations under the License. */
 
 #include "paddle/phi/core/infermeta_utils.h"
 
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/tensor_utils.h"
+
 namespace phi {
 
 void InferMetaContext::SetMetaConfig(MetaConfig config) { config_ = config; }
@@ -165,4 +168,83 @@ MetaFnFactory& MetaFnFactory::Instance() {
   return g_meta_fn_map;
 }
 
+bool InferMetaCache::Cacheable(const InferMetaContext& ctx) const {
+  for (const auto& attr : ctx.attrs_) {
+    if (paddle::holds_alternative<TensorRef>(attr) ||
+        paddle::holds_alternative<std::vector<TensorRef>>(attr)) {
+      return false;
+    }
+  }
+  for (const auto& input : ctx.inputs_) {
+    if (input.tensor() && !DenseTensor::classof(input.tensor())) return false;
+  }
+  for (const auto& output : ctx.outputs_) {
+    if (output.tensor() && !DenseTensor::classof(output.tensor())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool SameMeta(const DenseTensorMeta& lhs, const DenseTensorMeta& rhs) {
+  return lhs.dims == rhs.dims && lhs.dtype == rhs.dtype &&
+         lhs.layout == rhs.layout && lhs.lod == rhs.lod &&
+         lhs.strides == rhs.strides;
+}
+
+bool InferMetaCache::Restore(InferMetaContext* ctx) {
+  if (!checked_) {
+    enabled_ = Cacheable(*ctx);
+    checked_ = true;
+  }
+  if (!enabled_) return false;
+
+  const auto& inputs = ctx->inputs_;
+  bool hit = valid_ && inputs_.size() == inputs.size();
+  for (size_t i = 0; hit && i < inputs.size(); ++i) {
+    auto* tensor = static_cast<DenseTensor*>(inputs[i].tensor());
+    hit = inputs_[i].defined == (tensor != nullptr) &&
+          (!tensor || SameMeta(inputs_[i].meta, tensor->meta()));
+  }
+  if (hit) {
+    for (size_t i = 0; i < outputs_.size(); ++i) {
+      auto* tensor = static_cast<DenseTensor*>(ctx->outputs_[i].tensor());
+      if (!tensor || !outputs_[i].defined) continue;
+      // Only the fields set by the InferMetas, the offsets and the holders
+      // are left to the kernels.
+      const auto& cached = outputs_[i].meta;
+      auto* meta = DenseTensorUtils::GetMutableMeta(tensor);
+      meta->dims = cached.dims;
+      meta->dtype = cached.dtype;
+      meta->layout = cached.layout;
+      meta->lod = cached.lod;
+      meta->strides = cached.strides;
+    }
+    return true;
+  }
+
+  // The inplace InferMetas change the metas of the inputs, so the inputs are
+  // kept before the InferMeta.
+  valid_ = false;
+  inputs_.resize(inputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    auto* tensor = static_cast<DenseTensor*>(inputs[i].tensor());
+    inputs_[i].defined = tensor != nullptr;
+    if (tensor) inputs_[i].meta = tensor->meta();
+  }
+  return false;
+}
+
+void InferMetaCache::Record(const InferMetaContext& ctx) {
+  if (!enabled_) return;
+  const auto& outputs = ctx.outputs_;
+  outputs_.resize(outputs.size());
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    auto* tensor = static_cast<DenseTensor*>(outputs[i].tensor());
+    outputs_[i].defined = tensor != nullptr;
+    if (tensor) outputs_[i].meta = tensor->meta();
+  }
+  valid_ = true;
+}
+
 }  // namespace phi
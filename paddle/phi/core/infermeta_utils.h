@@ -18,6 +18,7 @@ limitations under the License. */
 #include <typeindex>
 #include <typeinfo>
 #include <utility>
+#include <vector>
 
 #include "paddle/common/macros.h"
 #include "paddle/phi/common/int_array.h"
@@ -83,6 +84,44 @@ class InferMetaContext {
  private:
   paddle::small_vector<MetaTensor, phi::kInputSmallVectorSize> inputs_;
   paddle::small_vector<MetaTensor, phi::kOutputSmallVectorSize> outputs_;
+
+  friend class InferMetaCache;
+};
+
+// Memoizes the InferMeta of a context whose tensors are reused across the
+// runs, as the contexts of the instructions of the new executor:
+//
+//   if (!cache.Restore(&ctx)) {
+//     infer_meta(&ctx);
+//     cache.Record(ctx);
+//   }
+//
+// The outputs get the metas of the last run when the inputs have the same
+// metas. The cache is disabled for the contexts with the attributes from the
+// tensors, whose values are not keyed, and with the tensors other than the
+// DenseTensors.
+class TEST_API InferMetaCache {
+ public:
+  // Returns true if the metas of the outputs are restored, otherwise the
+  // metas of the inputs are kept to be recorded with the outputs.
+  bool Restore(InferMetaContext* ctx);
+
+  // Records the metas of the outputs after the InferMeta.
+  void Record(const InferMetaContext& ctx);
+
+ private:
+  struct Meta {
+    bool defined{false};
+    DenseTensorMeta meta;
+  };
+
+  bool Cacheable(const InferMetaContext& ctx) const;
+
+  bool checked_{false};
+  bool enabled_{false};
+  bool valid_{false};
+  std::vector<Meta> inputs_;
+  std::vector<Meta> outputs_;
 };
 
 #define PD_INFER_META(...) \
@@ -152,11 +152,18 @@ class KernelContext {
     output_range_.clear();
   }
 
+  // Clears the tensors and the attributes but keeps the storage, for the
+  // contexts reused across the runs.
+  void Reset() {
+    ClearInputOutput();
+    attrs_.clear();
+  }
+
  private:
   DeviceContext* dev_ctx_;
 
-  paddle::small_vector<const TensorBase*> inputs_;
-  paddle::small_vector<TensorBase*> outputs_;
+  paddle::small_vector<const TensorBase*, kInputSmallVectorSize> inputs_;
+  paddle::small_vector<TensorBase*, kOutputSmallVectorSize> outputs_;
   paddle::small_vector<Attribute, kAttrSmallVectorSize> attrs_;
 
   paddle::small_vector<std::pair<int, int>, kInputSmallVectorSize> input_range_;
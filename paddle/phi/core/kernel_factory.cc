@@ -61,7 +61,92 @@ KernelFactory& KernelFactory::Instance() {
   return g_op_kernel_factory;
 }
 
+Kernel KernelFactory::BuildKernel(const LazyKernel& lazy_kernel) {
+  Kernel kernel(lazy_kernel.kernel_fn, lazy_kernel.variadic_kernel_fn);
+  if (kernel.GetKernelRegisteredType() == KernelRegisteredType::FUNCTION) {
+    lazy_kernel.args_parse_fn(lazy_kernel.kernel_key,
+                              kernel.mutable_args_def());
+  }
+  lazy_kernel.args_def_fn(lazy_kernel.kernel_key, &kernel);
+  return kernel;
+}
+
+void KernelFactory::RegisterLazyKernel(const char* kernel_name,
+                                       const KernelKey& kernel_key,
+                                       KernelArgsParseFn args_parse_fn,
+                                       KernelArgsDefFn args_def_fn,
+                                       KernelFn kernel_fn,
+                                       void* variadic_kernel_fn) {
+  LazyKernel lazy_kernel{kernel_name,
+                         kernel_key,
+                         args_parse_fn,
+                         args_def_fn,
+                         std::move(kernel_fn),
+                         variadic_kernel_fn};
+  {
+    std::lock_guard<std::mutex> guard(lazy_mutex_);
+    if (!lazy_indexed_.load(std::memory_order_acquire)) {
+      lazy_kernels_.push_back(std::move(lazy_kernel));
+      return;
+    }
+  }
+  // A library loaded after the first lookup registers its kernels eagerly,
+  // after the lazy ones of the same name, to keep the order of overriding.
+  std::string name(kernel_name);
+  BuildLazyKernels(name);
+  kernels_[name][kernel_key] = BuildKernel(lazy_kernel);
+  generation_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void KernelFactory::IndexLazyKernels() const {
+  std::call_once(lazy_indexed_once_, [this] {
+    std::lock_guard<std::mutex> guard(lazy_mutex_);
+    for (auto& lazy_kernel : lazy_kernels_) {
+      auto& entry = lazy_entries_[lazy_kernel.kernel_name];
+      if (!entry) {
+        entry = std::make_unique<LazyKernelEntry>();
+        kernels_[lazy_kernel.kernel_name];
+      }
+      entry->kernels.push_back(std::move(lazy_kernel));
+    }
+    lazy_kernels_.clear();
+    lazy_kernels_.shrink_to_fit();
+    num_lazy_names_.store(lazy_entries_.size(), std::memory_order_relaxed);
+    lazy_indexed_.store(true, std::memory_order_release);
+  });
+}
+
+void KernelFactory::BuildLazyKernels(const std::string& kernel_name) const {
+  if (UNLIKELY(!lazy_indexed_.load(std::memory_order_acquire))) {
+    IndexLazyKernels();
+  }
+  if (num_lazy_names_.load(std::memory_order_acquire) == 0) return;
+  auto iter = lazy_entries_.find(kernel_name);
+  if (iter == lazy_entries_.end()) return;
+  auto* entry = iter->second.get();
+  std::call_once(entry->built, [this, entry, &kernel_name] {
+    auto& kernel_map = kernels_[kernel_name];
+    for (const auto& lazy_kernel : entry->kernels) {
+      kernel_map[lazy_kernel.kernel_key] = BuildKernel(lazy_kernel);
+    }
+    entry->kernels.clear();
+    entry->kernels.shrink_to_fit();
+    num_lazy_names_.fetch_sub(1, std::memory_order_release);
+  });
+}
+
+void KernelFactory::BuildAllLazyKernels() const {
+  if (UNLIKELY(!lazy_indexed_.load(std::memory_order_acquire))) {
+    IndexLazyKernels();
+  }
+  if (num_lazy_names_.load(std::memory_order_acquire) == 0) return;
+  for (const auto& item : lazy_entries_) {
+    BuildLazyKernels(item.first);
+  }
+}
+
 bool KernelFactory::HasCompatiblePhiKernel(const std::string& op_type) const {
+  IndexLazyKernels();
   if (deprecated_op_names.find(op_type) == deprecated_op_names.end()) {
     if (phi::OpUtilsMap::Instance().Contains(op_type) ||
         (kernels_.find(op_type) != kernels_.end())) {
@@ -73,6 +158,7 @@ bool KernelFactory::HasCompatiblePhiKernel(const std::string& op_type) const {
 
 bool KernelFactory::HasStructuredKernel(const std::string& op_type) const {
   auto phi_kernel_name = phi::OpUtilsMap::Instance().GetBaseKernelName(op_type);
+  BuildLazyKernels(phi_kernel_name);
   auto kernel_iter = kernels_.find(phi_kernel_name);
   if (deprecated_op_names.find(op_type) == deprecated_op_names.end() &&
       kernel_iter != kernels_.end()) {
@@ -88,6 +174,7 @@ bool KernelFactory::HasStructuredKernel(const std::string& op_type) const {
 
 const Kernel& KernelFactory::SelectKernel(const std::string& kernel_name,
                                           const KernelKey& kernel_key) const {
+  BuildLazyKernels(kernel_name);
   auto iter = kernels_.find(kernel_name);
   if (iter == kernels_.end()) {
     return empty_kernel;
@@ -119,6 +206,7 @@ const Kernel& KernelFactory::SelectKernel(const std::string& kernel_name,
 
 const Kernel& KernelFactory::SelectKernelWithGPUDNN(
     const std::string& kernel_name, const KernelKey& const_kernel_key) const {
+  BuildLazyKernels(kernel_name);
   auto iter = kernels_.find(kernel_name);
   if (iter == kernels_.end()) {
     return empty_kernel;
@@ -162,6 +250,7 @@ const Kernel& KernelFactory::SelectKernelWithGPUDNN(
 
 KernelKeyMap KernelFactory::SelectKernelMap(
     const std::string& kernel_name) const {
+  BuildLazyKernels(kernel_name);
   auto iter = kernels_.find(kernel_name);
   if (iter == kernels_.end()) {
     return KernelKeyMap();
@@ -169,8 +258,38 @@ KernelKeyMap KernelFactory::SelectKernelMap(
   return iter->second;
 }
 
+KernelResult KernelSelectionCache::Select(const KernelKey& kernel_key) {
+  auto& factory = KernelFactory::Instance();
+  uint64_t generation = factory.generation();
+  if (generation != generation_) {
+    for (auto& entry : entries_) {
+      entry.kernel = nullptr;
+    }
+    generation_ = generation;
+  }
+  uint8_t flags = (FLAGS_use_stride_kernel ? 1 : 0) |
+                  (FLAGS_enable_api_kernel_fallback ? 2 : 0);
+  for (auto& entry : entries_) {
+    if (entry.kernel && entry.kernel_key == kernel_key &&
+        entry.flags == flags) {
+      return {*entry.kernel, entry.has_fallback_cpu, entry.is_stride_kernel};
+    }
+  }
+  auto result = factory.SelectKernelOrThrowError(
+      kernel_name_, kernel_key, use_strided_kernel_);
+  Entry& entry = entries_[next_entry_];
+  next_entry_ = (next_entry_ + 1) % kNumEntries;
+  entry.kernel_key = kernel_key;
+  entry.flags = flags;
+  entry.kernel = &result.kernel;
+  entry.has_fallback_cpu = result.has_fallback_cpu;
+  entry.is_stride_kernel = result.is_stride_kernel;
+  return result;
+}
+
 bool KernelFactory::HasKernel(const std::string& kernel_name,
                               const KernelKey& kernel_key) const {
+  BuildLazyKernels(kernel_name);
   auto iter = kernels_.find(kernel_name);
   PADDLE_ENFORCE_NE(
       iter,
@@ -217,6 +336,7 @@ KernelResult KernelFactory::SelectKernelOrThrowError(
     const std::string& kernel_name,
     const KernelKey& const_kernel_key,
     bool use_strided_kernel) const {
+  BuildLazyKernels(kernel_name);
   auto iter = kernels_.find(kernel_name);
 
   PADDLE_ENFORCE_NE(
@@ -345,6 +465,7 @@ KernelResult KernelFactory::SelectKernelOrThrowError(
 
 const KernelArgsDef& KernelFactory::GetFirstKernelArgsDef(
     const std::string& kernel_name) const {
+  BuildLazyKernels(kernel_name);
   auto iter = kernels_.find(kernel_name);
   PADDLE_ENFORCE_NE(
       iter,
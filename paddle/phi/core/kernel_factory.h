@@ -14,10 +14,15 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <ostream>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include "paddle/common/layout.h"
 #include "paddle/phi/common/backend.h"
 #include "paddle/phi/common/data_type.h"
@@ -317,7 +322,30 @@ class KernelFactory {
  public:
   static KernelFactory& Instance();
 
-  KernelNameMap& kernels() { return kernels_; }
+  // The kernels may be registered through the returned map, which makes the
+  // kernels cached by the KernelSelectionCache stale. All the lazy kernels
+  // are built before the map is returned.
+  KernelNameMap& kernels() {
+    BuildAllLazyKernels();
+    generation_.fetch_add(1, std::memory_order_relaxed);
+    return kernels_;
+  }
+
+  // Registers a kernel by its registration functions, as PD_REGISTER_KERNEL
+  // does at the load of the library. Only the functions are recorded, and
+  // the Kernel is built at the first lookup of its name, so that the
+  // thousands of kernels never used by a process are never built. The
+  // kernel_name should outlive the factory, e.g. a string literal.
+  void RegisterLazyKernel(const char* kernel_name,
+                          const KernelKey& kernel_key,
+                          KernelArgsParseFn args_parse_fn,
+                          KernelArgsDefFn args_def_fn,
+                          KernelFn kernel_fn,
+                          void* variadic_kernel_fn);
+
+  uint64_t generation() const {
+    return generation_.load(std::memory_order_relaxed);
+  }
 
   bool HasCompatiblePhiKernel(const std::string& op_type) const;
 
@@ -349,14 +377,88 @@ class KernelFactory {
   void ClearLowPrecisionKernelList() { low_precision_kernels_.clear(); }
 
  private:
+  struct LazyKernel {
+    const char* kernel_name;
+    KernelKey kernel_key;
+    KernelArgsParseFn args_parse_fn;
+    KernelArgsDefFn args_def_fn;
+    KernelFn kernel_fn;
+    void* variadic_kernel_fn;
+  };
+
+  struct LazyKernelEntry {
+    // In the order of the registration, a later one overrides an earlier one
+    // of the same key.
+    std::vector<LazyKernel> kernels;
+    std::once_flag built;
+  };
+
   KernelFactory() = default;
 
-  KernelNameMap kernels_;
+  static Kernel BuildKernel(const LazyKernel& lazy_kernel);
+
+  // Groups the lazy kernels by their names, and inserts the names into
+  // kernels_, so that building the kernels of a name never rehashes kernels_
+  // under the concurrent lookups of the other names.
+  void IndexLazyKernels() const;
+
+  // Builds the lazy kernels of the name, it should be called before
+  // kernels_ is looked up by the name.
+  void BuildLazyKernels(const std::string& kernel_name) const;
+
+  void BuildAllLazyKernels() const;
+
+  // The kernels are built into kernels_ by the const lookups.
+  mutable KernelNameMap kernels_;
+
+  mutable std::mutex lazy_mutex_;
+  mutable std::vector<LazyKernel> lazy_kernels_;
+  mutable std::once_flag lazy_indexed_once_;
+  mutable std::atomic<bool> lazy_indexed_{false};
+  mutable paddle::flat_hash_map<std::string, std::unique_ptr<LazyKernelEntry>>
+      lazy_entries_;
+  // The number of the names whose lazy kernels are not built.
+  mutable std::atomic<size_t> num_lazy_names_{0};
+
+  std::atomic<uint64_t> generation_{0};
 
   // Get the low precision kernel list of current module.
   std::map<const std::string, OpCount> low_precision_kernels_;
 };
 
+/**
+ * Note: The inline cache of the kernel selection of a call site, such as a
+ *       generated api function. It remembers the kernels selected for the
+ *       recent kernel keys, so the selection skips the kernel name lookup and
+ *       the fallback checks. The kernels are selected again when new kernels
+ *       are registered or the selection flags change. It is not thread safe,
+ *       the call sites keep a thread local cache.
+ */
+class KernelSelectionCache {
+ public:
+  KernelSelectionCache(const char* kernel_name, bool use_strided_kernel)
+      : kernel_name_(kernel_name), use_strided_kernel_(use_strided_kernel) {}
+
+  KernelResult Select(const KernelKey& kernel_key);
+
+ private:
+  struct Entry {
+    KernelKey kernel_key;
+    uint8_t flags{0};
+    const Kernel* kernel{nullptr};
+    bool has_fallback_cpu{false};
+    bool is_stride_kernel{false};
+  };
+
+  static constexpr size_t kNumEntries = 4;
+
+  std::string kernel_name_;
+  bool use_strided_kernel_;
+  uint64_t generation_{0};
+  std::array<Entry, kNumEntries> entries_;
+  size_t next_entry_{0};
+};
+
 inline std::ostream& operator<<(std::ostream& os, const KernelKey& kernel_key) {
   os << "(" << kernel_key.backend() << ", " << kernel_key.layout() << ", "
      << kernel_key.dtype() << ")";
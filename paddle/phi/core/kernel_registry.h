@@ -136,20 +136,25 @@ struct KernelRegistrar {
                        KernelArgsDefFn args_def_fn,
                        KernelFn kernel_fn,
                        void* variadic_kernel_fn) {
-    std::string kernel_name(kernel_name_cstr);
     KernelKey kernel_key(
         paddle::experimental::StringToBackend(backend_cstr), layout, dtype);
+    if (reg_type == RegType::INNER) {
+      // The Kernel is built at the first lookup of its name.
+      KernelFactory::Instance().RegisterLazyKernel(kernel_name_cstr,
+                                                   kernel_key,
+                                                   args_parse_fn,
+                                                   args_def_fn,
+                                                   std::move(kernel_fn),
+                                                   variadic_kernel_fn);
+      return;
+    }
     Kernel kernel(kernel_fn, variadic_kernel_fn);
     if (kernel.GetKernelRegisteredType() == KernelRegisteredType::FUNCTION) {
       args_parse_fn(kernel_key, kernel.mutable_args_def());
     }
     args_def_fn(kernel_key, &kernel);
-    if (reg_type == RegType::INNER) {
-      KernelFactory::Instance().kernels()[kernel_name][kernel_key] = kernel;
-    } else {
-      CustomKernelMap::Instance().RegisterCustomKernel(
-          kernel_name, kernel_key, kernel);
-    }
+    CustomKernelMap::Instance().RegisterCustomKernel(
+        std::string(kernel_name_cstr), kernel_key, kernel);
   }
 };
 
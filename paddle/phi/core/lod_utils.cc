@@ -14,8 +14,19 @@
 
 #include "paddle/phi/core/lod_utils.h"
 
+#include <list>
+#include <map>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+
 #include "paddle/phi/core/enforce.h"
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/memory_utils.h"
+#endif
+
 namespace phi {
 
 LoD ToAbsOffset(const LoD &in) {
@@ -70,4 +81,77 @@ LoD ConvertToLengthBasedLoD(const LoD &offset_lod) {
   return length_lod;
 }
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+static constexpr size_t kMaxCachedLoDs = 64;
+
+struct LoDOffsetsHash {
+  size_t operator()(const std::vector<size_t>& offsets) const {
+    size_t seed = offsets.size();
+    for (auto offset : offsets) {
+      seed ^= offset + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+    return seed;
+  }
+};
+
+class DeviceLoDOffsetsCache {
+ public:
+  const size_t* Get(const Place& place, const std::vector<size_t>& offsets) {
+    auto iter = entries_.find(offsets);
+    if (iter != entries_.end()) {
+      order_.splice(order_.begin(), order_, iter->second.order);
+      return reinterpret_cast<const size_t*>(iter->second.allocation->ptr());
+    }
+    if (entries_.size() >= kMaxCachedLoDs) {
+      entries_.erase(*order_.back());
+      order_.pop_back();
+    }
+    const size_t bytes = offsets.size() * sizeof(size_t);
+    auto* dev_ctx = static_cast<phi::GPUContext*>(
+        phi::DeviceContextPool::Instance().Get(place));
+    Entry entry;
+    entry.allocation = memory_utils::Alloc(
+        place,
+        bytes,
+        phi::Stream(reinterpret_cast<phi::StreamId>(dev_ctx->stream())));
+    iter = entries_.emplace(offsets, std::move(entry)).first;
+    // The key of the entry is the source of the copy, it outlives the copy.
+    memory_utils::Copy(place,
+                       iter->second.allocation->ptr(),
+                       phi::CPUPlace(),
+                       iter->first.data(),
+                       bytes,
+                       dev_ctx->stream());
+    order_.push_front(&iter->first);
+    iter->second.order = order_.begin();
+    return reinterpret_cast<const size_t*>(iter->second.allocation->ptr());
+  }
+
+ private:
+  struct Entry {
+    Allocator::AllocationPtr allocation;
+    std::list<const std::vector<size_t>*>::iterator order;
+  };
+
+  std::unordered_map<std::vector<size_t>, Entry, LoDOffsetsHash> entries_;
+  // The keys of the entries, the most recently used first.
+  std::list<const std::vector<size_t>*> order_;
+};
+
+const size_t* GetCachedDeviceLoDOffsets(const Place& place,
+                                        const std::vector<size_t>& offsets) {
+  PADDLE_ENFORCE_EQ(place.GetType(),
+                    AllocationType::GPU,
+                    phi::errors::InvalidArgument(
+                        "The device LoD offsets must be on a GPU place, but "
+                        "received %s.",
+                        place));
+  // Never destroyed, the allocations may outlive the allocators at exit.
+  static auto* caches = new std::map<Place, DeviceLoDOffsetsCache>();
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> guard(mutex);
+  return (*caches)[place].Get(place, offsets);
+}
+#endif
+
 }  // namespace phi
@@ -16,6 +16,8 @@
 #include <cstddef>
 #include <vector>
 
+#include "paddle/phi/common/place.h"
+
 namespace phi {
 using LoD = std::vector<std::vector<std::size_t>>;
 
@@ -38,4 +40,17 @@ void AppendLoD(LoD* lod, const LoD& lod_length);
  */
 LoD ConvertToLengthBasedLoD(const LoD& offset_lod);
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+/*
+ * The device copy of the offsets of a LoD level on a GPU place, cached by
+ * the offsets. The sequence ops of a ragged batch share a few LoDs, so their
+ * kernels read the offsets from the cache instead of MixVector::CUDAData,
+ * which allocates, copies and waits for the stream on every call. The copy
+ * is on the stream of the place, and the least recently used offsets are
+ * evicted from a cache of 64 LoDs for a place.
+ */
+const size_t* GetCachedDeviceLoDOffsets(const Place& place,
+                                        const std::vector<size_t>& offsets);
+#endif
+
 }  // namespace  phi
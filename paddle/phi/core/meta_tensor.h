@@ -108,6 +108,8 @@ class TEST_API MetaTensor {
   const LoD& lod(int64_t index) const;
   TensorBase* tensor() const;
 
+  friend class InferMetaCache;
+
   TensorBase* tensor_ = nullptr;
   bool strided_kernel_used_ = false;
 };
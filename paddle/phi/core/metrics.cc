@@ -0,0 +1,325 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/metrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "glog/logging.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_int32(runtime_metrics_port);
+PHI_DECLARE_string(runtime_metrics_file);
+PHI_DECLARE_int32(runtime_metrics_interval_s);
+
+namespace phi {
+namespace metrics {
+
+int CurrentMetricShard() {
+  static std::atomic<int> next_shard{0};
+  thread_local int shard =
+      next_shard.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+  return shard;
+}
+
+static void AtomicAdd(std::atomic<double>* target, double value) {
+  double old = target->load(std::memory_order_relaxed);
+  while (!target->compare_exchange_weak(
+      old, old + value, std::memory_order_relaxed)) {
+  }
+}
+
+int64_t Counter::Value() const {
+  int64_t value = 0;
+  for (const auto& shard : shards_) {
+    value += shard.value.load(std::memory_order_relaxed);
+  }
+  return value;
+}
+
+void Gauge::Add(double value) { AtomicAdd(&value_, value); }
+
+Histogram::Histogram(const std::vector<double>& bounds) : bounds_(bounds) {
+  PADDLE_ENFORCE_EQ(
+      std::is_sorted(bounds_.begin(), bounds_.end()),
+      true,
+      phi::errors::InvalidArgument(
+          "The bounds of the histogram should be in ascending order."));
+  for (auto& shard : shards_) {
+    shard.buckets.reset(new std::atomic<uint64_t>[bounds_.size() + 1]);
+    for (size_t i = 0; i <= bounds_.size(); ++i) {
+      shard.buckets[i].store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+void Histogram::Observe(double value) {
+  size_t bucket = std::lower_bound(bounds_.begin(), bounds_.end(), value) -
+                  bounds_.begin();
+  auto& shard = shards_[CurrentMetricShard()];
+  shard.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  AtomicAdd(&shard.sum, value);
+}
+
+std::vector<uint64_t> Histogram::BucketCounts() const {
+  std::vector<uint64_t> counts(bounds_.size() + 1, 0);
+  for (const auto& shard : shards_) {
+    for (size_t i = 0; i < counts.size(); ++i) {
+      counts[i] += shard.buckets[i].load(std::memory_order_relaxed);
+    }
+  }
+  return counts;
+}
+
+double Histogram::Sum() const {
+  double sum = 0;
+  for (const auto& shard : shards_) {
+    sum += shard.sum.load(std::memory_order_relaxed);
+  }
+  return sum;
+}
+
+uint64_t Histogram::Count() const {
+  auto counts = BucketCounts();
+  uint64_t count = 0;
+  for (auto c : counts) count += c;
+  return count;
+}
+
+const std::vector<double>& LatencyBuckets() {
+  static const std::vector<double> buckets = {1e-5,
+                                              5e-5,
+                                              1e-4,
+                                              5e-4,
+                                              1e-3,
+                                              5e-3,
+                                              1e-2,
+                                              5e-2,
+                                              0.1,
+                                              0.5,
+                                              1,
+                                              10};
+  return buckets;
+}
+
+MetricsRegistry& MetricsRegistry::Instance() {
+  // Never destroyed, the metrics may be updated by the threads at exit.
+  static MetricsRegistry* registry = new MetricsRegistry();
+  return *registry;
+}
+
+static std::string LabelsToString(const Labels& labels) {
+  if (labels.empty()) return "";
+  std::ostringstream os;
+  os << "{";
+  for (size_t i = 0; i < labels.size(); ++i) {
+    os << (i ? "," : "") << labels[i].first << "=\"" << labels[i].second
+       << "\"";
+  }
+  os << "}";
+  return os.str();
+}
+
+MetricsRegistry::Family* MetricsRegistry::GetFamily(const std::string& name,
+                                                    const std::string& help,
+                                                    const std::string& type) {
+  auto& family = families_[name];
+  if (family.type.empty()) {
+    family.help = help;
+    family.type = type;
+  }
+  PADDLE_ENFORCE_EQ(family.type,
+                    type,
+                    phi::errors::AlreadyExists(
+                        "The metric %s is registered as a %s, not a %s.",
+                        name,
+                        family.type,
+                        type));
+  return &family;
+}
+
+Counter* MetricsRegistry::GetCounter(const std::string& name,
+                                     const std::string& help,
+                                     const Labels& labels) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& counter = GetFamily(name, help, "counter")
+                      ->counters[LabelsToString(labels)];
+  if (!counter) counter.reset(new Counter());
+  return counter.get();
+}
+
+Gauge* MetricsRegistry::GetGauge(const std::string& name,
+                                 const std::string& help,
+                                 const Labels& labels) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& gauge = GetFamily(name, help, "gauge")->gauges[LabelsToString(labels)];
+  if (!gauge) gauge.reset(new Gauge());
+  return gauge.get();
+}
+
+Histogram* MetricsRegistry::GetHistogram(const std::string& name,
+                                         const std::string& help,
+                                         const Labels& labels,
+                                         const std::vector<double>& bounds) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& histogram = GetFamily(name, help, "histogram")
+                        ->histograms[LabelsToString(labels)];
+  if (!histogram) histogram.reset(new Histogram(bounds));
+  return histogram.get();
+}
+
+void MetricsRegistry::RegisterCallbackGauge(const std::string& name,
+                                            const std::string& help,
+                                            const Labels& labels,
+                                            std::function<double()> callback) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  GetFamily(name, help, "gauge")->callbacks[LabelsToString(labels)] =
+      std::move(callback);
+}
+
+// Inserts the le label of a bucket into the labels of a histogram.
+static std::string BucketLabels(const std::string& labels,
+                                const std::string& le) {
+  std::string bucket = "le=\"" + le + "\"";
+  if (labels.empty()) return "{" + bucket + "}";
+  return labels.substr(0, labels.size() - 1) + "," + bucket + "}";
+}
+
+std::string MetricsRegistry::ExportPrometheusText() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  std::ostringstream os;
+  for (const auto& item : families_) {
+    const auto& name = item.first;
+    const auto& family = item.second;
+    os << "# HELP " << name << " " << family.help << "\n";
+    os << "# TYPE " << name << " " << family.type << "\n";
+    for (const auto& c : family.counters) {
+      os << name << c.first << " " << c.second->Value() << "\n";
+    }
+    for (const auto& g : family.gauges) {
+      os << name << g.first << " " << g.second->Value() << "\n";
+    }
+    for (const auto& g : family.callbacks) {
+      os << name << g.first << " " << g.second() << "\n";
+    }
+    for (const auto& h : family.histograms) {
+      const auto& bounds = h.second->Bounds();
+      auto counts = h.second->BucketCounts();
+      uint64_t cumulative = 0;
+      for (size_t i = 0; i < counts.size(); ++i) {
+        cumulative += counts[i];
+        std::string le = i < bounds.size() ? std::to_string(bounds[i]) : "+Inf";
+        os << name << "_bucket" << BucketLabels(h.first, le) << " "
+           << cumulative << "\n";
+      }
+      os << name << "_sum" << h.first << " " << h.second->Sum() << "\n";
+      os << name << "_count" << h.first << " " << cumulative << "\n";
+    }
+  }
+  return os.str();
+}
+
+bool WriteMetricsToFile(const std::string& path) {
+  const std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream fout(tmp_path);
+    if (!fout) return false;
+    fout << MetricsRegistry::Instance().ExportPrometheusText();
+  }
+  return std::rename(tmp_path.c_str(), path.c_str()) == 0;
+}
+
+#if !defined(_WIN32)
+static void ServeMetrics(int port) {
+  int server = socket(AF_INET, SOCK_STREAM, 0);
+  int reuse = 1;
+  setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port);
+  if (server < 0 ||
+      bind(server, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+      listen(server, 16) < 0) {
+    LOG(WARNING) << "Failed to serve the runtime metrics on port " << port;
+    return;
+  }
+  LOG(INFO) << "Serve the runtime metrics on port " << port;
+  while (true) {
+    int client = accept(server, nullptr, nullptr);
+    if (client < 0) continue;
+    // Every request is answered by the metrics, the request is only read to
+    // be drained.
+    char request[1024];
+    if (read(client, request, sizeof(request)) < 0) {
+      close(client);
+      continue;
+    }
+    std::string body = MetricsRegistry::Instance().ExportPrometheusText();
+    std::string response =
+        "HTTP/1.0 200 OK\r\n"
+        "Content-Type: text/plain; version=0.0.4\r\n"
+        "Content-Length: " +
+        std::to_string(body.size()) + "\r\n\r\n" + body;
+    size_t written = 0;
+    while (written < response.size()) {
+      ssize_t n =
+          write(client, response.data() + written, response.size() - written);
+      if (n <= 0) break;
+      written += n;
+    }
+    close(client);
+  }
+}
+#endif
+
+void StartMetricsExporterFromFlags() {
+  static std::once_flag once;
+  std::call_once(once, [] {
+    if (FLAGS_runtime_metrics_port > 0) {
+#if !defined(_WIN32)
+      std::thread(ServeMetrics, FLAGS_runtime_metrics_port).detach();
+#else
+      LOG(WARNING) << "The metrics endpoint is not supported on windows.";
+#endif
+    }
+    if (!FLAGS_runtime_metrics_file.empty()) {
+      std::thread([] {
+        const std::string path = FLAGS_runtime_metrics_file;
+        const int interval = std::max(FLAGS_runtime_metrics_interval_s, 1);
+        while (true) {
+          std::this_thread::sleep_for(std::chrono::seconds(interval));
+          if (!WriteMetricsToFile(path)) {
+            LOG(WARNING) << "Failed to write the runtime metrics to " << path;
+          }
+        }
+      }).detach();
+    }
+  });
+}
+
+}  // namespace metrics
+}  // namespace phi
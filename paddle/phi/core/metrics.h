@@ -0,0 +1,176 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+namespace metrics {
+
+// The runtime metrics of the executor, the allocators, the communication and
+// the parameter server, exported in the prometheus text format:
+//
+//   static auto* calls = MetricsRegistry::Instance().GetCounter(
+//       "paddle_nccl_calls_total", "The number of nccl calls.",
+//       {{"op", "all_reduce"}});
+//   calls->Add();
+//
+// The counters and the histograms are sharded by the threads, so that the
+// updates are lock free and rarely contend on a cache line.
+
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+static constexpr int kMetricShards = 16;
+
+int CurrentMetricShard();
+
+class TEST_API Counter {
+ public:
+  Counter() = default;
+
+  void Add(int64_t value = 1) {
+    shards_[CurrentMetricShard()].value.fetch_add(value,
+                                                  std::memory_order_relaxed);
+  }
+
+  int64_t Value() const;
+
+ private:
+  struct alignas(64) Shard {
+    std::atomic<int64_t> value{0};
+  };
+  Shard shards_[kMetricShards];
+
+  DISABLE_COPY_AND_ASSIGN(Counter);
+};
+
+class TEST_API Gauge {
+ public:
+  Gauge() = default;
+
+  void Set(double value) { value_.store(value, std::memory_order_relaxed); }
+
+  void Add(double value);
+
+  double Value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<double> value_{0};
+
+  DISABLE_COPY_AND_ASSIGN(Gauge);
+};
+
+class TEST_API Histogram {
+ public:
+  // The upper bounds of the buckets, in ascending order.
+  explicit Histogram(const std::vector<double>& bounds);
+
+  void Observe(double value);
+
+  const std::vector<double>& Bounds() const { return bounds_; }
+
+  // The counts of the buckets, the last one is the +Inf bucket.
+  std::vector<uint64_t> BucketCounts() const;
+
+  double Sum() const;
+
+  uint64_t Count() const;
+
+ private:
+  struct alignas(64) Shard {
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets;
+    std::atomic<double> sum{0};
+  };
+  std::vector<double> bounds_;
+  Shard shards_[kMetricShards];
+
+  DISABLE_COPY_AND_ASSIGN(Histogram);
+};
+
+// The buckets of the latencies in seconds, from 10us to 10s.
+TEST_API const std::vector<double>& LatencyBuckets();
+
+class TEST_API MetricsRegistry {
+ public:
+  static MetricsRegistry& Instance();
+
+  // The metrics live as long as the process, so that the pointers may be
+  // cached by the callers.
+  Counter* GetCounter(const std::string& name,
+                      const std::string& help,
+                      const Labels& labels = {});
+
+  Gauge* GetGauge(const std::string& name,
+                  const std::string& help,
+                  const Labels& labels = {});
+
+  Histogram* GetHistogram(const std::string& name,
+                          const std::string& help,
+                          const Labels& labels = {},
+                          const std::vector<double>& bounds = LatencyBuckets());
+
+  // A gauge whose value is read from the callback at the export.
+  void RegisterCallbackGauge(const std::string& name,
+                             const std::string& help,
+                             const Labels& labels,
+                             std::function<double()> callback);
+
+  std::string ExportPrometheusText() const;
+
+ private:
+  struct Family {
+    std::string help;
+    std::string type;
+    std::map<std::string, std::unique_ptr<Counter>> counters;
+    std::map<std::string, std::unique_ptr<Gauge>> gauges;
+    std::map<std::string, std::unique_ptr<Histogram>> histograms;
+    std::map<std::string, std::function<double()>> callbacks;
+  };
+
+  MetricsRegistry() = default;
+
+  Family* GetFamily(const std::string& name,
+                    const std::string& help,
+                    const std::string& type);
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Family> families_;
+
+  DISABLE_COPY_AND_ASSIGN(MetricsRegistry);
+};
+
+// Writes the metrics to the file, by a rename so that a reader never sees a
+// partial file.
+TEST_API bool WriteMetricsToFile(const std::string& path);
+
+// Starts the exporters configured by FLAGS_runtime_metrics_port and
+// FLAGS_runtime_metrics_file, only once in a process. The port serves
+// GET /metrics, and the file is rewritten every
+// FLAGS_runtime_metrics_interval_s seconds.
+TEST_API void StartMetricsExporterFromFlags();
+
+}  // namespace metrics
+}  // namespace phi
@@ -14,9 +14,12 @@
 
 #include "paddle/phi/core/threadpool.h"
 
+#include <algorithm>
+#include <map>
 #include <thread>
 
 #include "glog/logging.h"
+#include "paddle/phi/backends/cpu/cpu_info.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/utils/flags.h"
 
@@ -31,6 +34,10 @@ std::unique_ptr<ThreadPool> ThreadPool::threadpool_(nullptr);
 std::once_flag ThreadPool::init_flag_;
 
 ThreadPool* ThreadPool::GetInstance() {
+  int numa_node = phi::backends::cpu::CurrentThreadNumaNode();
+  if (numa_node >= 0) {
+    return GetNumaInstance(numa_node);
+  }
   std::call_once(init_flag_, &ThreadPool::Init);
   return threadpool_.get();
 }
@@ -51,11 +58,31 @@ void ThreadPool::Init() {
   }
 }
 
-ThreadPool::ThreadPool(int num_threads) : running_(true) {
+ThreadPool* ThreadPool::GetNumaInstance(int numa_node) {
+  static std::mutex mutex;
+  static std::map<int, std::unique_ptr<ThreadPool>> pools;
+  std::lock_guard<std::mutex> guard(mutex);
+  auto& pool = pools[numa_node];
+  if (pool == nullptr) {
+    int num_threads =
+        static_cast<int>(phi::backends::cpu::NumaNodeCpus(numa_node).size());
+    if (FLAGS_dist_threadpool_size > 0) {
+      num_threads = FLAGS_dist_threadpool_size;
+    }
+    pool = std::make_unique<ThreadPool>(std::max(num_threads, 1), numa_node);
+  }
+  return pool.get();
+}
+
+ThreadPool::ThreadPool(int num_threads, int numa_node) : running_(true) {
   threads_.resize(num_threads);
   for (auto& thread : threads_) {
-    // TODO(Yancey1989): binding the thread on the specify CPU numberw
-    thread = std::make_unique<std::thread>([this] { ThreadPool::TaskLoop(); });
+    thread = std::make_unique<std::thread>([this, numa_node] {
+      if (numa_node >= 0) {
+        phi::backends::cpu::BindCurrentThreadToNumaNode(numa_node);
+      }
+      ThreadPool::TaskLoop();
+    });
   }
 }
 
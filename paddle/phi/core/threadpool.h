@@ -50,14 +50,19 @@ struct ExceptionHandler {
 // number of threads.
 class ThreadPool {
  public:
-  explicit ThreadPool(int num_threads);
+  // The threads are bound to the numa node if it is not negative.
+  explicit ThreadPool(int num_threads, int numa_node = -1);
 
   using Task =
       std::packaged_task<std::unique_ptr<phi::enforce::EnforceNotMet>()>;
 
-  // Returns the singleton of ThreadPool.
+  // Returns the singleton of ThreadPool, or the pool of the numa node for a
+  // thread bound to a numa node.
   static ThreadPool* GetInstance();
 
+  // Returns the pool whose threads are bound to the numa node.
+  static ThreadPool* GetNumaInstance(int numa_node);
+
   ~ThreadPool();
 
   // Run pushes a function to the task queue and returns a std::future
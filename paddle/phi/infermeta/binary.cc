@@ -2419,6 +2419,53 @@ void MatmulWithFlattenInferMeta(const MetaTensor& x,
   out->share_lod(x);
 }
 
+void MatmulTopkInferMeta(const MetaTensor& x,
+                         const MetaTensor& y,
+                         int k,
+                         bool largest,
+                         MetaTensor* out,
+                         MetaTensor* indices) {
+  auto x_dims = x.dims();
+  auto y_dims = y.dims();
+  PADDLE_ENFORCE_EQ(
+      x_dims.size() == 2 && y_dims.size() == 2,
+      true,
+      phi::errors::InvalidArgument(
+          "The queries and the candidates of matmul_topk should be 2-D, but "
+          "received X's shape = [%s], Y's shape = [%s].",
+          x_dims,
+          y_dims));
+  if (x_dims[1] > 0 && y_dims[1] > 0) {
+    PADDLE_ENFORCE_EQ(
+        x_dims[1],
+        y_dims[1],
+        phi::errors::InvalidArgument(
+            "The queries and the candidates of matmul_topk should have the "
+            "same width, but received X's shape = [%s], Y's shape = [%s].",
+            x_dims,
+            y_dims));
+  }
+  PADDLE_ENFORCE_GE(
+      k,
+      1,
+      phi::errors::InvalidArgument(
+          "The k of matmul_topk should be at least 1, but received %d.", k));
+  if (y_dims[0] > 0) {
+    PADDLE_ENFORCE_LE(
+        k,
+        y_dims[0],
+        phi::errors::InvalidArgument(
+            "The k of matmul_topk should be at most the number of the "
+            "candidates %d, but received %d.",
+            y_dims[0],
+            k));
+  }
+  out->set_dims(common::make_ddim({x_dims[0], k}));
+  out->set_dtype(x.dtype());
+  indices->set_dims(common::make_ddim({x_dims[0], k}));
+  indices->set_dtype(phi::DataType::INT64);
+}
+
 void MatrixNMSInferMeta(const MetaTensor& bboxes,
                         const MetaTensor& scores,
                         float score_threshold,
@@ -400,6 +400,13 @@ void MatmulWithFlattenInferMeta(const MetaTensor& x,
                                 int y_num_col_dims,
                                 MetaTensor* out);
 
+void MatmulTopkInferMeta(const MetaTensor& x,
+                         const MetaTensor& y,
+                         int k,
+                         bool largest,
+                         MetaTensor* out,
+                         MetaTensor* indices);
+
 void MatrixNMSInferMeta(const MetaTensor& bboxes,
                         const MetaTensor& scores,
                         float score_threshold,
@@ -2657,6 +2657,33 @@ void FusedEmbeddingEltWiseLayerNormInferMeta(
   out->set_dtype((*embs[0]).dtype());
 }
 
+void FusedEmbeddingEltWiseLayerNormVarlenInferMeta(
+    const std::vector<const MetaTensor*>& ids,
+    const std::vector<const MetaTensor*>& embs,
+    const MetaTensor& bias,
+    const MetaTensor& scale,
+    const MetaTensor& cu_seqlens,
+    const float epsilon,
+    MetaTensor* out) {
+  FusedEmbeddingEltWiseLayerNormInferMeta(
+      ids, embs, bias, scale, epsilon, out);
+  int64_t batch = ids[0]->dims()[0];
+  PADDLE_ENFORCE_EQ(
+      cu_seqlens.dims().size() == 1 &&
+          (batch < 0 || cu_seqlens.dims()[0] < 0 ||
+           cu_seqlens.dims()[0] == batch + 1),
+      true,
+      phi::errors::InvalidArgument(
+          "The cu_seqlens of EmbeddingEltWiseLayerNormVarlenOp should be of "
+          "the shape [batch + 1], but received the batch %d and the shape "
+          "[%s].",
+          batch,
+          cu_seqlens.dims()));
+  // The tokens of the sequences are packed, the number of which is only
+  // known by the last of cu_seqlens.
+  out->set_dims(common::make_ddim({-1, embs[0]->dims()[1]}));
+}
+
 void FusionTransposeFlattenConcatInferMeta(
     const std::vector<const MetaTensor*>& x,
     const std::vector<int>& trans_axis,
@@ -3503,6 +3530,16 @@ void FCInferMeta(const MetaTensor& input,
   out->set_dtype(input.dtype());
 }
 
+void SparseFCInferMeta(const MetaTensor& input,
+                       const MetaTensor& w,
+                       const MetaTensor& bias,
+                       const int in_num_col_dims,
+                       const std::string& activation_type,
+                       MetaTensor* out) {
+  FCInferMeta(
+      input, w, bias, in_num_col_dims, activation_type, false /*padding*/, out);
+}
+
 void SelfDPAttenInferMeta(const MetaTensor& x,
                           const float alpha,
                           const int head_number,
@@ -3709,4 +3746,255 @@ void SinePosXPUInferMeta(const MetaTensor& x,
   out->set_dtype(x.dtype());
 }
 
+void FusedFp8LinearInferMeta(const MetaTensor& x,
+                             const MetaTensor& weight,
+                             const MetaTensor& bias,
+                             const MetaTensor& x_scale,
+                             const MetaTensor& x_amax_history,
+                             const MetaTensor& weight_scale,
+                             const MetaTensor& weight_amax_history,
+                             float margin,
+                             MetaTensor* out,
+                             MetaTensor* x_scale_out,
+                             MetaTensor* x_amax_history_out,
+                             MetaTensor* weight_scale_out,
+                             MetaTensor* weight_amax_history_out) {
+  auto x_dims = x.dims();
+  auto w_dims = weight.dims();
+  PADDLE_ENFORCE_GE(
+      x_dims.size(),
+      2,
+      phi::errors::InvalidArgument("The input(x) of fused_fp8_linear should "
+                                   "be at least a 2D Tensor, but got %dD.",
+                                   x_dims.size()));
+  PADDLE_ENFORCE_EQ(
+      w_dims.size(),
+      2,
+      phi::errors::InvalidArgument("The input(weight) of fused_fp8_linear "
+                                   "should be a 2D Tensor, but got %dD.",
+                                   w_dims.size()));
+  PADDLE_ENFORCE_EQ(
+      x_dims[x_dims.size() - 1],
+      w_dims[0],
+      phi::errors::InvalidArgument(
+          "The last dim of input(x) should be equal to dim 0 of "
+          "input(weight), but got %d and %d.",
+          x_dims[x_dims.size() - 1],
+          w_dims[0]));
+  // the FP8 GEMM of cublasLt works on the multiples of 16
+  PADDLE_ENFORCE_EQ(
+      w_dims[0] % 16 == 0 && w_dims[1] % 16 == 0,
+      true,
+      phi::errors::InvalidArgument(
+          "The dims of input(weight) of fused_fp8_linear should be multiples "
+          "of 16, but got [%d, %d].",
+          w_dims[0],
+          w_dims[1]));
+  if (bias) {
+    PADDLE_ENFORCE_EQ(
+        bias.dims().size() == 1 && bias.dims()[0] == w_dims[1],
+        true,
+        phi::errors::InvalidArgument(
+            "The input(bias) of fused_fp8_linear should be a 1D Tensor of "
+            "%d elements, but got [%s].",
+            w_dims[1],
+            bias.dims()));
+  }
+  auto CheckScalingState = [](const MetaTensor& scale,
+                              const MetaTensor& amax_history,
+                              const std::string& name) {
+    PADDLE_ENFORCE_EQ(
+        scale.dtype() == phi::DataType::FLOAT32 &&
+            amax_history.dtype() == phi::DataType::FLOAT32,
+        true,
+        phi::errors::InvalidArgument(
+            "The scale and amax_history of %s should be float32.", name));
+    PADDLE_ENFORCE_EQ(
+        common::product(scale.dims()),
+        1,
+        phi::errors::InvalidArgument(
+            "The scale of %s should have 1 element, but got [%s].",
+            name,
+            scale.dims()));
+    PADDLE_ENFORCE_EQ(
+        amax_history.dims().size() == 1 && amax_history.dims()[0] > 0,
+        true,
+        phi::errors::InvalidArgument(
+            "The amax_history of %s should be a non-empty 1D Tensor, but "
+            "got [%s].",
+            name,
+            amax_history.dims()));
+  };
+  CheckScalingState(x_scale, x_amax_history, "input(x)");
+  CheckScalingState(weight_scale, weight_amax_history, "input(weight)");
+
+  auto out_dims = x_dims;
+  out_dims[out_dims.size() - 1] = w_dims[1];
+  out->set_dims(out_dims);
+  out->set_dtype(x.dtype());
+  x_scale_out->share_meta(x_scale);
+  x_amax_history_out->share_meta(x_amax_history);
+  weight_scale_out->share_meta(weight_scale);
+  weight_amax_history_out->share_meta(weight_amax_history);
+}
+
+void BlockVerifyAttentionInferMeta(const MetaTensor& qkv,
+                                   const MetaTensor& key_cache,
+                                   const MetaTensor& value_cache,
+                                   const MetaTensor& seq_lens_decoder,
+                                   const MetaTensor& seq_lens_this_time,
+                                   const MetaTensor& cu_seqlens_q,
+                                   const MetaTensor& block_tables,
+                                   float scale,
+                                   MetaTensor* out,
+                                   MetaTensor* key_cache_out,
+                                   MetaTensor* value_cache_out) {
+  auto qkv_dims = qkv.dims();
+  auto key_cache_dims = key_cache.dims();
+  PADDLE_ENFORCE_EQ(
+      qkv_dims.size(),
+      2UL,
+      errors::InvalidArgument("The input(qkv) must be a 2D Tensor."));
+  PADDLE_ENFORCE_EQ(
+      key_cache_dims.size(),
+      4UL,
+      errors::InvalidArgument("The input(key_cache) must be a 4D Tensor."));
+  PADDLE_ENFORCE_EQ(
+      value_cache.dims(),
+      key_cache_dims,
+      errors::InvalidArgument(
+          "The input(value_cache) must have the dims of input(key_cache), "
+          "but got [%s] and [%s].",
+          value_cache.dims(),
+          key_cache_dims));
+  const int num_head = key_cache_dims[1];
+  const int dim_head = key_cache_dims[3];
+  PADDLE_ENFORCE_EQ(
+      3 * num_head * dim_head,
+      qkv_dims[1],
+      errors::InvalidArgument(
+          "The qkv_dims[1] must be equal to 3 * num_head * dim_head"));
+  PADDLE_ENFORCE_LE(
+      dim_head,
+      128,
+      errors::InvalidArgument(
+          "block_verify_attention supports dim_head <= 128, but got %d.",
+          dim_head));
+  const int64_t bsz = seq_lens_this_time.dims()[0];
+  PADDLE_ENFORCE_EQ(
+      cu_seqlens_q.dims()[0],
+      bsz + 1,
+      errors::InvalidArgument(
+          "The input(cu_seqlens_q) must have bsz + 1 = %d elements, but got "
+          "%d.",
+          bsz + 1,
+          cu_seqlens_q.dims()[0]));
+  PADDLE_ENFORCE_EQ(
+      seq_lens_decoder.dims()[0] == bsz && block_tables.dims()[0] == bsz,
+      true,
+      errors::InvalidArgument(
+          "The inputs(seq_lens_decoder, block_tables) must have bsz = %d "
+          "rows.",
+          bsz));
+
+  out->set_dims({qkv_dims[0], num_head * dim_head});
+  out->set_dtype(qkv.dtype());
+  key_cache_out->share_meta(key_cache);
+  value_cache_out->share_meta(value_cache);
+}
+
+void FusedMoeInferMeta(const MetaTensor& x,
+                       const MetaTensor& topk_ids,
+                       const MetaTensor& topk_weights,
+                       const MetaTensor& ffn1_weight,
+                       const MetaTensor& ffn1_bias,
+                       const MetaTensor& ffn2_weight,
+                       const MetaTensor& ffn2_bias,
+                       const std::string& act_type,
+                       MetaTensor* out) {
+  auto x_dims = x.dims();
+  auto ffn1_dims = ffn1_weight.dims();
+  auto ffn2_dims = ffn2_weight.dims();
+  PADDLE_ENFORCE_EQ(
+      ffn1_dims.size() == 3 && ffn2_dims.size() == 3,
+      true,
+      errors::InvalidArgument(
+          "The inputs(ffn1_weight, ffn2_weight) must be 3D Tensors of "
+          "[num_experts, hidden_size, inter_size] and [num_experts, "
+          "inter_size, hidden_size], but got [%s] and [%s].",
+          ffn1_dims,
+          ffn2_dims));
+  const int64_t num_experts = ffn1_dims[0];
+  const int64_t hidden_size = ffn1_dims[1];
+  const int64_t inter_size = ffn1_dims[2];
+  PADDLE_ENFORCE_EQ(
+      ffn2_dims[0] == num_experts && ffn2_dims[1] == inter_size &&
+          ffn2_dims[2] == hidden_size,
+      true,
+      errors::InvalidArgument(
+          "The input(ffn2_weight) must be of [%d, %d, %d], but got [%s].",
+          num_experts,
+          inter_size,
+          hidden_size,
+          ffn2_dims));
+  PADDLE_ENFORCE_EQ(
+      x_dims[x_dims.size() - 1],
+      hidden_size,
+      errors::InvalidArgument(
+          "The last dim of input(x) must be the hidden_size %d, but got %d.",
+          hidden_size,
+          x_dims[x_dims.size() - 1]));
+  auto ids_dims = topk_ids.dims();
+  PADDLE_ENFORCE_EQ(
+      ids_dims.size() == 2 && ids_dims[0] * hidden_size == x.numel(),
+      true,
+      errors::InvalidArgument(
+          "The input(topk_ids) must be of [num_tokens, k] for the %d tokens "
+          "of input(x), but got [%s].",
+          x.numel() / hidden_size,
+          ids_dims));
+  PADDLE_ENFORCE_EQ(
+      topk_weights.dims(),
+      ids_dims,
+      errors::InvalidArgument(
+          "The input(topk_weights) must have the dims of input(topk_ids), "
+          "but got [%s] and [%s].",
+          topk_weights.dims(),
+          ids_dims));
+  PADDLE_ENFORCE_EQ(topk_ids.dtype(),
+                    DataType::INT64,
+                    errors::InvalidArgument(
+                        "The input(topk_ids) must be of int64, but got %s.",
+                        topk_ids.dtype()));
+  PADDLE_ENFORCE_EQ(
+      ffn1_bias.numel(),
+      num_experts * inter_size,
+      errors::InvalidArgument(
+          "The input(ffn1_bias) must have num_experts * inter_size = %d "
+          "elements, but got %d.",
+          num_experts * inter_size,
+          ffn1_bias.numel()));
+  if (ffn2_bias) {
+    PADDLE_ENFORCE_EQ(
+        ffn2_bias.numel(),
+        num_experts * hidden_size,
+        errors::InvalidArgument(
+            "The input(ffn2_bias) must have num_experts * hidden_size = %d "
+            "elements, but got %d.",
+            num_experts * hidden_size,
+            ffn2_bias.numel()));
+  }
+  PADDLE_ENFORCE_EQ(
+      act_type == "gelu" || act_type == "relu",
+      true,
+      errors::InvalidArgument(
+          "The act_type of fused_moe must be gelu or relu, but got %s.",
+          act_type));
+
+  out->set_dims(x_dims);
+  out->share_lod(x);
+  out->set_dtype(x.dtype());
+  out->set_layout(x.layout());
+}
+
 }  // namespace phi
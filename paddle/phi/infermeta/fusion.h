@@ -647,6 +647,15 @@ void FusedEmbeddingEltWiseLayerNormInferMeta(
     const float epsilon,
     MetaTensor* out);
 
+void FusedEmbeddingEltWiseLayerNormVarlenInferMeta(
+    const std::vector<const MetaTensor*>& ids,
+    const std::vector<const MetaTensor*>& embs,
+    const MetaTensor& bias,
+    const MetaTensor& scale,
+    const MetaTensor& cu_seqlens,
+    const float epsilon,
+    MetaTensor* out);
+
 void FusionTransposeFlattenConcatInferMeta(
     const std::vector<const MetaTensor*>& x,
     const std::vector<int>& trans_axis,
@@ -807,6 +816,13 @@ void FCInferMeta(const MetaTensor& input,
                  const bool padding_weights,
                  MetaTensor* out);
 
+void SparseFCInferMeta(const MetaTensor& input,
+                       const MetaTensor& w,
+                       const MetaTensor& bias,
+                       const int in_num_col_dims,
+                       const std::string& activation_type,
+                       MetaTensor* out);
+
 void VariableLengthMemoryEfficientAttentionInferMeta(
     const MetaTensor& query,
     const MetaTensor& key,
@@ -836,4 +852,40 @@ void SinePosXPUInferMeta(const MetaTensor& x,
                          const MetaTensor& y,
                          MetaTensor* out);
 
+void FusedFp8LinearInferMeta(const MetaTensor& x,
+                             const MetaTensor& weight,
+                             const MetaTensor& bias,
+                             const MetaTensor& x_scale,
+                             const MetaTensor& x_amax_history,
+                             const MetaTensor& weight_scale,
+                             const MetaTensor& weight_amax_history,
+                             float margin,
+                             MetaTensor* out,
+                             MetaTensor* x_scale_out,
+                             MetaTensor* x_amax_history_out,
+                             MetaTensor* weight_scale_out,
+                             MetaTensor* weight_amax_history_out);
+
+void BlockVerifyAttentionInferMeta(const MetaTensor& qkv,
+                                   const MetaTensor& key_cache,
+                                   const MetaTensor& value_cache,
+                                   const MetaTensor& seq_lens_decoder,
+                                   const MetaTensor& seq_lens_this_time,
+                                   const MetaTensor& cu_seqlens_q,
+                                   const MetaTensor& block_tables,
+                                   float scale,
+                                   MetaTensor* out,
+                                   MetaTensor* key_cache_out,
+                                   MetaTensor* value_cache_out);
+
+void FusedMoeInferMeta(const MetaTensor& x,
+                       const MetaTensor& topk_ids,
+                       const MetaTensor& topk_weights,
+                       const MetaTensor& ffn1_weight,
+                       const MetaTensor& ffn1_bias,
+                       const MetaTensor& ffn2_weight,
+                       const MetaTensor& ffn2_bias,
+                       const std::string& act_type,
+                       MetaTensor* out);
+
 }  // namespace phi
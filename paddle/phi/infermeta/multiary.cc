@@ -1852,6 +1852,120 @@ void FusedLayerNormInferMeta(const MetaTensor& x,
   variance->set_layout(x.layout());
 }
 
+void FlashAttnKVCacheInferMeta(const MetaTensor& q,
+                               const MetaTensor& k,
+                               const MetaTensor& v,
+                               const MetaTensor& cache_k,
+                               const MetaTensor& cache_v,
+                               MetaTensor* out,
+                               MetaTensor* cache_k_out,
+                               MetaTensor* cache_v_out) {
+  const auto& q_dims = q.dims();
+  const auto& k_dims = k.dims();
+  const auto& cache_dims = cache_k.dims();
+  PADDLE_ENFORCE_EQ(
+      q_dims.size() == 4 && k_dims.size() == 4 && cache_dims.size() == 4,
+      true,
+      phi::errors::InvalidArgument(
+          "The q, k of flash_attn_kv_cache should be [batch_size, seqlen, "
+          "num_heads, head_dim] and the cache should be [batch_size, "
+          "max_seqlen, num_heads_k, head_dim], but received q of [%s], k of "
+          "[%s] and cache_k of [%s].",
+          q_dims,
+          k_dims,
+          cache_dims));
+  PADDLE_ENFORCE_EQ(
+      cache_v.dims(),
+      cache_dims,
+      phi::errors::InvalidArgument(
+          "The cache_k and cache_v should be of the same shape, but received "
+          "[%s] vs [%s].",
+          cache_dims,
+          cache_v.dims()));
+  if (k_dims[2] > 0 && q_dims[2] > 0) {
+    PADDLE_ENFORCE_EQ(
+        q_dims[2] % k_dims[2],
+        0,
+        phi::errors::InvalidArgument(
+            "The num_heads of q should be a multiple of the num_heads of k "
+            "for the grouped query attention, but received %d vs %d.",
+            q_dims[2],
+            k_dims[2]));
+  }
+  out->set_dims(q_dims);
+  out->set_dtype(q.dtype());
+  out->set_layout(q.layout());
+  cache_k_out->share_meta(cache_k);
+  cache_v_out->share_meta(cache_v);
+}
+
+void FusedLinearCrossEntropyInferMeta(const MetaTensor& x,
+                                      const MetaTensor& weight,
+                                      const MetaTensor& label,
+                                      int64_t ignore_index,
+                                      int64_t chunk_size,
+                                      int64_t start_index,
+                                      int ring_id,
+                                      int nranks,
+                                      MetaTensor* loss,
+                                      MetaTensor* lse) {
+  const auto& x_dims = x.dims();
+  const auto& weight_dims = weight.dims();
+  const auto& label_dims = label.dims();
+  PADDLE_ENFORCE_GE(x_dims.size(),
+                    2,
+                    phi::errors::InvalidArgument(
+                        "The rank of Input(x) of fused_linear_cross_entropy "
+                        "should be at least 2, but received %d.",
+                        x_dims.size()));
+  PADDLE_ENFORCE_EQ(weight_dims.size(),
+                    2,
+                    phi::errors::InvalidArgument(
+                        "The weight of fused_linear_cross_entropy should be "
+                        "[hidden_size, vocab_size], but received %s.",
+                        weight_dims));
+  int rank = x_dims.size();
+  PADDLE_ENFORCE_EQ(x_dims[rank - 1],
+                    weight_dims[0],
+                    phi::errors::InvalidArgument(
+                        "The last dim of Input(x) should be equal to the first "
+                        "dim of Input(weight), but received %s vs %s.",
+                        x_dims,
+                        weight_dims));
+  PADDLE_ENFORCE_GT(chunk_size,
+                    0,
+                    phi::errors::InvalidArgument(
+                        "The chunk_size of fused_linear_cross_entropy should "
+                        "be positive, but received %d.",
+                        chunk_size));
+  PADDLE_ENFORCE_GE(nranks,
+                    1,
+                    phi::errors::InvalidArgument(
+                        "The nranks of fused_linear_cross_entropy should be "
+                        "at least 1, but received %d.",
+                        nranks));
+
+  std::vector<int64_t> token_dims(x_dims.Get(), x_dims.Get() + rank - 1);
+  int64_t label_numel = common::product(label_dims);
+  int64_t token_num = common::product(common::make_ddim(token_dims));
+  if (label_numel > 0 && token_num > 0) {
+    PADDLE_ENFORCE_EQ(label_numel,
+                      token_num,
+                      phi::errors::InvalidArgument(
+                          "Input(label) should have one label for each token "
+                          "of Input(x), but received %s vs %s.",
+                          label_dims,
+                          x_dims));
+  }
+
+  lse->set_dims(common::make_ddim(token_dims));
+  lse->set_dtype(DataType::FLOAT32);
+  token_dims.push_back(1);
+  loss->set_dims(common::make_ddim(token_dims));
+  loss->set_dtype(x.dtype());
+  loss->share_lod(x);
+}
+
 void FusedLinearParamGradAddInferMeta(const MetaTensor& x,
                                       const MetaTensor& dout,
                                       const MetaTensor& dweight,
@@ -1942,26 +2056,41 @@ void FusionGroupInferMeta(const std::vector<const MetaTensor*>& ins,
     x_dims.push_back(ins[i]->dims());
   }
 
+  size_t full = 0;
   if (type == 0) {
+    // The inputs broadcast along the trailing dims have less ranks, and the
+    // outputs have the dims of the full inputs.
     for (size_t i = 1; i < num_ins; ++i) {
-      PADDLE_ENFORCE_EQ(x_dims[0],
-                        x_dims[i],
-                        phi::errors::InvalidArgument(
-                            "All the inputs' dims is expected to be the same. "
-                            "But received [%s] (name: %s) vs [%s] (name: %s).",
-                            x_dims[0],
-                            ins[0],
-                            x_dims[i],
-                            ins[i]));
+      if (x_dims[i].size() > x_dims[full].size()) {
+        full = i;
+      }
+    }
+    for (size_t i = 0; i < num_ins; ++i) {
+      int offset = x_dims[full].size() - x_dims[i].size();
+      bool is_same_or_suffix = x_dims[i].size() > 0;
+      for (int k = 0; k < x_dims[i].size(); ++k) {
+        is_same_or_suffix &= x_dims[i][k] == x_dims[full][offset + k];
+      }
+      PADDLE_ENFORCE_EQ(
+          is_same_or_suffix,
+          true,
+          phi::errors::InvalidArgument(
+              "All the inputs' dims is expected to be the same, or the "
+              "trailing dims of the others. But received [%s] (name: %s) vs "
+              "[%s] (name: %s).",
+              x_dims[full],
+              ins[full],
+              x_dims[i],
+              ins[i]));
     }
     for (size_t j = 0; j < num_outs; ++j) {
-      outs[j]->set_dims(x_dims[0]);
+      outs[j]->set_dims(x_dims[full]);
     }
   }
 
-  // Only lod of Inputs[0] would be shared with Outs.
+  // Only lod of the full input would be shared with Outs.
   for (size_t j = 0; j < num_outs; ++j) {
-    outs[j]->share_lod(*ins[0]);
+    outs[j]->share_lod(*ins[full]);
   }
 
   for (size_t j = 0; j < num_outs; ++j) {
@@ -2621,6 +2750,83 @@ static void Interpolate3DInferShapeCheck(
   output->set_dtype(x.dtype());
 }
 
+// The queries or the new rows match the width of the index.
+static void CheckAnnRows(const std::string& op,
+                         const MetaTensor& rows,
+                         const MetaTensor& index_rows) {
+  PADDLE_ENFORCE_EQ(rows.dims().size(),
+                    2,
+                    phi::errors::InvalidArgument(
+                        "The rows of %s should be 2-D, but received [%s].",
+                        op,
+                        rows.dims()));
+  const int64_t d = rows.dims()[1];
+  const int64_t index_d = index_rows.dims()[index_rows.dims().size() - 1];
+  if (d > 0 && index_d > 0) {
+    PADDLE_ENFORCE_EQ(d,
+                      index_d,
+                      phi::errors::InvalidArgument(
+                          "The rows of %s should be of the width %d of the "
+                          "index, but received %d.",
+                          op,
+                          index_d,
+                          d));
+  }
+}
+
+static void SetAnnSearchOutputs(const std::string& op,
+                                const MetaTensor& query,
+                                int k,
+                                MetaTensor* distances,
+                                MetaTensor* indices) {
+  PADDLE_ENFORCE_GE(
+      k,
+      1,
+      phi::errors::InvalidArgument(
+          "The k of %s should be at least 1, but received %d.", op, k));
+  distances->set_dims(common::make_ddim({query.dims()[0], k}));
+  distances->set_dtype(query.dtype());
+  indices->set_dims(common::make_ddim({query.dims()[0], k}));
+  indices->set_dtype(DataType::INT64);
+}
+
+void HnswAddInferMeta(const MetaTensor& x,
+                      const MetaTensor& neighbors,
+                      const MetaTensor& offsets,
+                      const MetaTensor& meta,
+                      int ef_construction,
+                      int seed,
+                      MetaTensor* neighbors_out,
+                      MetaTensor* offsets_out,
+                      MetaTensor* meta_out) {
+  PADDLE_ENFORCE_EQ(x.dims().size(),
+                    2,
+                    phi::errors::InvalidArgument(
+                        "The rows of hnsw_add should be 2-D, but received "
+                        "X's shape = [%s].",
+                        x.dims()));
+  const int64_t n = x.dims()[0];
+  neighbors_out->set_dims(common::make_ddim({-1}));
+  neighbors_out->set_dtype(DataType::INT32);
+  offsets_out->set_dims(common::make_ddim({n < 0 ? -1 : n + 1}));
+  offsets_out->set_dtype(DataType::INT64);
+  meta_out->set_dims(common::make_ddim({3}));
+  meta_out->set_dtype(DataType::INT64);
+}
+
+void HnswSearchInferMeta(const MetaTensor& query,
+                         const MetaTensor& x,
+                         const MetaTensor& neighbors,
+                         const MetaTensor& offsets,
+                         const MetaTensor& meta,
+                         int k,
+                         int ef_search,
+                         MetaTensor* distances,
+                         MetaTensor* indices) {
+  CheckAnnRows("hnsw_search", query, x);
+  SetAnnSearchOutputs("hnsw_search", query, k, distances, indices);
+}
+
 void InterpolateInferMeta(
     const MetaTensor& x,
     const MetaTensor& out_size,
@@ -2709,6 +2915,50 @@ void IndexPutInferMeta(const MetaTensor& x,
   out->share_meta(x);
 }
 
+void IvfPqAddInferMeta(const MetaTensor& x,
+                       const MetaTensor& centroids,
+                       const MetaTensor& codebooks,
+                       const MetaTensor& codes,
+                       const MetaTensor& list_offsets,
+                       const MetaTensor& ids,
+                       MetaTensor* codes_out,
+                       MetaTensor* list_offsets_out,
+                       MetaTensor* ids_out) {
+  CheckAnnRows("ivf_pq_add", x, centroids);
+  const int64_t n = x.dims()[0];
+  const int64_t old_n = codes.dims()[0];
+  const int64_t total = n < 0 || old_n < 0 ? -1 : n + old_n;
+  codes_out->set_dims(common::make_ddim({total, codes.dims()[1]}));
+  codes_out->set_dtype(DataType::UINT8);
+  list_offsets_out->set_dims(list_offsets.dims());
+  list_offsets_out->set_dtype(DataType::INT64);
+  ids_out->set_dims(common::make_ddim({total}));
+  ids_out->set_dtype(DataType::INT64);
+}
+
+void IvfPqSearchInferMeta(const MetaTensor& query,
+                          const MetaTensor& centroids,
+                          const MetaTensor& codebooks,
+                          const MetaTensor& codes,
+                          const MetaTensor& list_offsets,
+                          const MetaTensor& ids,
+                          int k,
+                          int nprobe,
+                          MetaTensor* distances,
+                          MetaTensor* indices) {
+  CheckAnnRows("ivf_pq_search", query, centroids);
+  const int64_t nlist = centroids.dims()[0];
+  PADDLE_ENFORCE_EQ(
+      nprobe >= 1 && (nlist < 0 || nprobe <= nlist),
+      true,
+      phi::errors::InvalidArgument(
+          "The nprobe of ivf_pq_search should be in [1, %d], but received "
+          "%d.",
+          nlist,
+          nprobe));
+  SetAnnSearchOutputs("ivf_pq_search", query, k, distances, indices);
+}
+
 void LambInferMeta(const MetaTensor& param,
                    const MetaTensor& grad,
                    const MetaTensor& learning_rate,
@@ -4111,6 +4361,81 @@ void UpdateLossScalingInferMeta(const std::vector<const MetaTensor*>& xs,
   out_bad_steps->set_dtype(DataType::INT32);
 }
 
+void W8A8LinearInferMeta(const MetaTensor& x,
+                         const MetaTensor& weight,
+                         const MetaTensor& bias,
+                         const MetaTensor& weight_scale,
+                         const MetaTensor& smooth,
+                         const std::string& act_method,
+                         MetaTensor* out) {
+  auto x_dims = x.dims();
+  auto w_dims = weight.dims();
+  PADDLE_ENFORCE_EQ(
+      w_dims.size(),
+      2UL,
+      errors::InvalidArgument("The input(weight) must be a 2D Tensor."));
+  PADDLE_ENFORCE_EQ(
+      x_dims[x_dims.size() - 1],
+      w_dims[1],
+      errors::InvalidArgument(
+          "Input(X) dim[-1] and Input(Weight) dim[1] should be equal."
+          "But received Input(X) dim[-1](%s) != Input(Weight) dim[1](%s)",
+          x_dims[x_dims.size() - 1],
+          w_dims[1]));
+  PADDLE_ENFORCE_EQ(
+      w_dims[0] % 16,
+      0,
+      phi::errors::InvalidArgument(
+          "The first dimension of input must be divisible by 16, but got[%d]",
+          w_dims[0]));
+  PADDLE_ENFORCE_EQ(
+      w_dims[1] % 16,
+      0,
+      phi::errors::InvalidArgument(
+          "The second dimension of input must be divisible by 16, but got[%d]",
+          w_dims[1]));
+  PADDLE_ENFORCE_EQ(
+      weight_scale.dims()[0],
+      w_dims[0],
+      errors::InvalidArgument(
+          "Input(weight_scale) dim[0] and Input(Weight) dim[0] should be equal."
+          "But received Input(weight_scale) dim[0](%s) != Input(Weight) "
+          "dim[0](%s)",
+          weight_scale.dims()[0],
+          w_dims[0]));
+  if (bias) {
+    PADDLE_ENFORCE_EQ(
+        bias.dims()[0],
+        w_dims[0],
+        errors::InvalidArgument(
+            "Input(bias) dim[0] and Input(Weight) dim[0] should be equal."
+            "But received Input(bias) dim[0](%s) != Input(Weight) dim[0](%s)",
+            bias.dims()[0],
+            w_dims[0]));
+  }
+  if (smooth) {
+    PADDLE_ENFORCE_EQ(
+        smooth.dims()[0],
+        w_dims[1],
+        errors::InvalidArgument(
+            "Input(smooth) dim[0] and Input(Weight) dim[1] should be equal."
+            "But received Input(smooth) dim[0](%s) != Input(Weight) dim[1](%s)",
+            smooth.dims()[0],
+            w_dims[1]));
+  }
+  PADDLE_ENFORCE_EQ(
+      act_method == "" || act_method == "gelu" || act_method == "relu" ||
+          act_method == "swish",
+      true,
+      errors::InvalidArgument("The act_method of w8a8_linear should be one of "
+                              "['', 'gelu', 'relu', 'swish'], but got [%s].",
+                              act_method));
+  auto out_dims = x_dims;
+  out_dims[out_dims.size() - 1] = w_dims[0];
+  out->set_dims(out_dims);
+  out->set_dtype(x.dtype());
+}
+
 void WarpctcInferMeta(const MetaTensor& logits,
                       const MetaTensor& label,
                       const MetaTensor& logits_length,
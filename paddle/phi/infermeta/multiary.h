@@ -376,6 +376,26 @@ void FusedLayerNormInferMeta(const MetaTensor& x,
                              MetaTensor* mean,
                              MetaTensor* variance);
 
+void FlashAttnKVCacheInferMeta(const MetaTensor& q,
+                               const MetaTensor& k,
+                               const MetaTensor& v,
+                               const MetaTensor& cache_k,
+                               const MetaTensor& cache_v,
+                               MetaTensor* out,
+                               MetaTensor* cache_k_out,
+                               MetaTensor* cache_v_out);
+
+void FusedLinearCrossEntropyInferMeta(const MetaTensor& x,
+                                      const MetaTensor& weight,
+                                      const MetaTensor& label,
+                                      int64_t ignore_index,
+                                      int64_t chunk_size,
+                                      int64_t start_index,
+                                      int ring_id,
+                                      int nranks,
+                                      MetaTensor* loss,
+                                      MetaTensor* lse);
+
 void FusedLinearParamGradAddInferMeta(const MetaTensor& x,
                                       const MetaTensor& dout,
                                       const MetaTensor& dweight,
@@ -452,6 +472,26 @@ void HSigmoidLossInferMeta(const MetaTensor& x,
                            MetaTensor* pre_out,
                            MetaTensor* w_out);
 
+void HnswAddInferMeta(const MetaTensor& x,
+                      const MetaTensor& neighbors,
+                      const MetaTensor& offsets,
+                      const MetaTensor& meta,
+                      int ef_construction,
+                      int seed,
+                      MetaTensor* neighbors_out,
+                      MetaTensor* offsets_out,
+                      MetaTensor* meta_out);
+
+void HnswSearchInferMeta(const MetaTensor& query,
+                         const MetaTensor& x,
+                         const MetaTensor& neighbors,
+                         const MetaTensor& offsets,
+                         const MetaTensor& meta,
+                         int k,
+                         int ef_search,
+                         MetaTensor* distances,
+                         MetaTensor* indices);
+
 void InterpolateInferMeta(
     const MetaTensor& x,
     const MetaTensor& out_size,
@@ -474,6 +514,27 @@ void IndexPutInferMeta(const MetaTensor& x,
                        bool accumulate,
                        MetaTensor* out);
 
+void IvfPqAddInferMeta(const MetaTensor& x,
+                       const MetaTensor& centroids,
+                       const MetaTensor& codebooks,
+                       const MetaTensor& codes,
+                       const MetaTensor& list_offsets,
+                       const MetaTensor& ids,
+                       MetaTensor* codes_out,
+                       MetaTensor* list_offsets_out,
+                       MetaTensor* ids_out);
+
+void IvfPqSearchInferMeta(const MetaTensor& query,
+                          const MetaTensor& centroids,
+                          const MetaTensor& codebooks,
+                          const MetaTensor& codes,
+                          const MetaTensor& list_offsets,
+                          const MetaTensor& ids,
+                          int k,
+                          int nprobe,
+                          MetaTensor* distances,
+                          MetaTensor* indices);
+
 void LambInferMeta(const MetaTensor& param,
                    const MetaTensor& grad,
                    const MetaTensor& learning_rate,
@@ -754,6 +815,14 @@ void UpdateLossScalingInferMeta(const std::vector<const MetaTensor*>& xs,
                                 MetaTensor* out_good_steps,
                                 MetaTensor* out_bad_steps);
 
+void W8A8LinearInferMeta(const MetaTensor& x,
+                         const MetaTensor& weight,
+                         const MetaTensor& bias,
+                         const MetaTensor& weight_scale,
+                         const MetaTensor& smooth,
+                         const std::string& act_method,
+                         MetaTensor* out);
+
 void WarpctcInferMeta(const MetaTensor& logits,
                       const MetaTensor& label,
                       const MetaTensor& logits_length,
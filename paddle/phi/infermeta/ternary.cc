@@ -288,6 +288,20 @@ void FlashAttnInferMeta(const MetaTensor& q,
                         MetaTensor* softmax,
                         MetaTensor* softmax_lse,
                         MetaTensor* seed_offset) {
+  const auto& q_dims = q.dims();
+  const auto& k_dims = k.dims();
+  int rank = q_dims.size();
+  if (rank >= 3 && k_dims.size() == rank && k_dims[rank - 2] > 0 &&
+      q_dims[rank - 2] > 0) {
+    PADDLE_ENFORCE_EQ(
+        q_dims[rank - 2] % k_dims[rank - 2],
+        0,
+        phi::errors::InvalidArgument(
+            "The num_heads of q should be a multiple of the num_heads of k "
+            "for the grouped query attention, but received %d vs %d.",
+            q_dims[rank - 2],
+            k_dims[rank - 2]));
+  }
   auto out_dims = q.dims();
   out_dims[3] = v.dims()[3];
   out->set_dims(out_dims);
@@ -295,6 +309,44 @@ void FlashAttnInferMeta(const MetaTensor& q,
   out->set_layout(q.layout());
 }
 
+void FlashAttnLocalInferMeta(const MetaTensor& q,
+                             const MetaTensor& k,
+                             const MetaTensor& v,
+                             MetaTensor* out,
+                             MetaTensor* softmax_lse) {
+  const auto& q_dims = q.dims();
+  const auto& k_dims = k.dims();
+  int rank = q_dims.size();
+  PADDLE_ENFORCE_EQ(
+      (rank == 3 || rank == 4) && k_dims.size() == rank &&
+          v.dims().size() == rank,
+      true,
+      phi::errors::InvalidArgument(
+          "The q, k and v of flash_attn_local should be [batch_size, seqlen, "
+          "num_heads, head_dim] or [total_seqlen, num_heads, head_dim], but "
+          "received q of [%s], k of [%s] and v of [%s].",
+          q_dims,
+          k_dims,
+          v.dims()));
+  if (k_dims[rank - 2] > 0 && q_dims[rank - 2] > 0) {
+    PADDLE_ENFORCE_EQ(
+        q_dims[rank - 2] % k_dims[rank - 2],
+        0,
+        phi::errors::InvalidArgument(
+            "The num_heads of q should be a multiple of the num_heads of k "
+            "for the grouped query attention, but received %d vs %d.",
+            q_dims[rank - 2],
+            k_dims[rank - 2]));
+  }
+  out->set_dims(q_dims);
+  out->set_dtype(q.dtype());
+  out->set_layout(q.layout());
+
+  std::vector<int64_t> lse_dims(q_dims.Get(), q_dims.Get() + rank - 1);
+  softmax_lse->set_dims(common::make_ddim(lse_dims));
+  softmax_lse->set_dtype(DataType::FLOAT32);
+}
+
 void ArangeTensorInferMeta(const MetaTensor& start,
                            const MetaTensor& end,
                            const MetaTensor& step,
@@ -1440,6 +1492,58 @@ void SpectralNormInferMeta(const MetaTensor& weight,
   }
 }
 
+void SpeculativeSamplingInferMeta(const MetaTensor& draft_tokens,
+                                  const MetaTensor& draft_probs,
+                                  const MetaTensor& target_probs,
+                                  int seed,
+                                  MetaTensor* accept_tokens,
+                                  MetaTensor* accept_num) {
+  auto tokens_dims = draft_tokens.dims();
+  auto draft_dims = draft_probs.dims();
+  auto target_dims = target_probs.dims();
+  PADDLE_ENFORCE_EQ(
+      tokens_dims.size(),
+      2,
+      phi::errors::InvalidArgument(
+          "The input(draft_tokens) should be a 2D Tensor of [batch_size, "
+          "num_draft_tokens], but got [%s].",
+          tokens_dims));
+  PADDLE_ENFORCE_EQ(
+      draft_dims.size() == 3 && target_dims.size() == 3,
+      true,
+      phi::errors::InvalidArgument(
+          "The input(draft_probs) and input(target_probs) should be 3D "
+          "Tensors, but got [%s] and [%s].",
+          draft_dims,
+          target_dims));
+  const auto bsz = tokens_dims[0];
+  const auto num_draft = tokens_dims[1];
+  PADDLE_ENFORCE_EQ(
+      draft_dims[0] == bsz && draft_dims[1] == num_draft,
+      true,
+      phi::errors::InvalidArgument(
+          "The input(draft_probs) should be [%d, %d, vocab_size], but got "
+          "[%s].",
+          bsz,
+          num_draft,
+          draft_dims));
+  // the target model also predicts the token after the last draft token
+  PADDLE_ENFORCE_EQ(
+      target_dims[0] == bsz && target_dims[1] == num_draft + 1 &&
+          target_dims[2] == draft_dims[2],
+      true,
+      phi::errors::InvalidArgument(
+          "The input(target_probs) should be [%d, %d, %d], but got [%s].",
+          bsz,
+          num_draft + 1,
+          draft_dims[2],
+          target_dims));
+  accept_tokens->set_dims(common::make_ddim({bsz, num_draft + 1}));
+  accept_tokens->set_dtype(DataType::INT64);
+  accept_num->set_dims(common::make_ddim({bsz}));
+  accept_num->set_dtype(DataType::INT32);
+}
+
 void ViterbiDecodeInferMeta(const MetaTensor& input,
                             const MetaTensor& transition,
                             const MetaTensor& length,
@@ -80,6 +80,12 @@ void FlashAttnInferMeta(const MetaTensor& q,
                         MetaTensor* softmax_lse,
                         MetaTensor* seed_offset);
 
+void FlashAttnLocalInferMeta(const MetaTensor& q,
+                             const MetaTensor& k,
+                             const MetaTensor& v,
+                             MetaTensor* out,
+                             MetaTensor* softmax_lse);
+
 void InstanceNormInferMeta(const MetaTensor& x,
                            const MetaTensor& scale,
                            const MetaTensor& bias,
@@ -225,6 +231,13 @@ void SpectralNormInferMeta(const MetaTensor& weight,
                            MetaTensor* out,
                            MetaConfig config = MetaConfig());
 
+void SpeculativeSamplingInferMeta(const MetaTensor& draft_tokens,
+                                  const MetaTensor& draft_probs,
+                                  const MetaTensor& target_probs,
+                                  int seed,
+                                  MetaTensor* accept_tokens,
+                                  MetaTensor* accept_num);
+
 void ViterbiDecodeInferMeta(const MetaTensor& input,
                             const MetaTensor& transition,
                             const MetaTensor& length,
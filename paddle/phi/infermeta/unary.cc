@@ -1891,6 +1891,39 @@ void HistogramInferMeta(
   out->set_dtype(DataType::INT64);
 }
 
+void HnswBuildInferMeta(const MetaTensor& x,
+                        int m,
+                        int ef_construction,
+                        int seed,
+                        MetaTensor* neighbors,
+                        MetaTensor* offsets,
+                        MetaTensor* meta) {
+  PADDLE_ENFORCE_EQ(x.dims().size(),
+                    2,
+                    phi::errors::InvalidArgument(
+                        "The rows of hnsw_build should be 2-D, but received "
+                        "X's shape = [%s].",
+                        x.dims()));
+  PADDLE_ENFORCE_GE(
+      m,
+      2,
+      phi::errors::InvalidArgument(
+          "The m of hnsw_build should be at least 2, but received %d.", m));
+  PADDLE_ENFORCE_GE(ef_construction,
+                    1,
+                    phi::errors::InvalidArgument(
+                        "The ef_construction of hnsw_build should be at least "
+                        "1, but received %d.",
+                        ef_construction));
+  const int64_t n = x.dims()[0];
+  neighbors->set_dims(common::make_ddim({-1}));
+  neighbors->set_dtype(DataType::INT32);
+  offsets->set_dims(common::make_ddim({n < 0 ? -1 : n + 1}));
+  offsets->set_dtype(DataType::INT64);
+  meta->set_dims(common::make_ddim({3}));
+  meta->set_dtype(DataType::INT64);
+}
+
 void IdentityLossInferMeta(const MetaTensor& x,
                            int reduction,
                            MetaTensor* out) {
@@ -2088,6 +2121,69 @@ void IsfiniteInferMeta(const MetaTensor& x, MetaTensor* out) {
   out->set_dtype(DataType::BOOL);
 }
 
+void IvfPqBuildInferMeta(const MetaTensor& x,
+                         int nlist,
+                         int m,
+                         int ksub,
+                         int iters,
+                         int seed,
+                         MetaTensor* centroids,
+                         MetaTensor* codebooks,
+                         MetaTensor* codes,
+                         MetaTensor* list_offsets,
+                         MetaTensor* ids) {
+  auto x_dims = x.dims();
+  PADDLE_ENFORCE_EQ(x_dims.size(),
+                    2,
+                    phi::errors::InvalidArgument(
+                        "The rows of ivf_pq_build should be 2-D, but received "
+                        "X's shape = [%s].",
+                        x_dims));
+  PADDLE_ENFORCE_GE(nlist,
+                    1,
+                    phi::errors::InvalidArgument(
+                        "The nlist of ivf_pq_build should be at least 1, but "
+                        "received %d.",
+                        nlist));
+  PADDLE_ENFORCE_EQ(
+      ksub >= 1 && ksub <= 256,
+      true,
+      phi::errors::InvalidArgument(
+          "The ksub of ivf_pq_build should be in [1, 256], so that a code "
+          "is a byte, but received %d.",
+          ksub));
+  const int64_t n = x_dims[0];
+  const int64_t d = x_dims[1];
+  PADDLE_ENFORCE_EQ(
+      m >= 1 && d % m == 0,
+      true,
+      phi::errors::InvalidArgument(
+          "The m of ivf_pq_build should divide the width %d of the rows, but "
+          "received %d.",
+          d,
+          m));
+  if (n >= 0) {
+    PADDLE_ENFORCE_GE(
+        n,
+        std::max(nlist, ksub),
+        phi::errors::InvalidArgument(
+            "The ivf_pq_build needs at least max(nlist, ksub) = %d rows to "
+            "train, but received %d.",
+            std::max(nlist, ksub),
+            n));
+  }
+  centroids->set_dims(common::make_ddim({nlist, d}));
+  centroids->set_dtype(x.dtype());
+  codebooks->set_dims(common::make_ddim({m, ksub, d / m}));
+  codebooks->set_dtype(x.dtype());
+  codes->set_dims(common::make_ddim({n, m}));
+  codes->set_dtype(DataType::UINT8);
+  list_offsets->set_dims(common::make_ddim({nlist + 1}));
+  list_offsets->set_dtype(DataType::INT64);
+  ids->set_dims(common::make_ddim({n}));
+  ids->set_dtype(DataType::INT64);
+}
+
 void KthvalueInferMeta(const MetaTensor& x,
                        int k,
                        int axis,
@@ -306,6 +306,14 @@ void GumbelSoftmaxInferMeta(const MetaTensor& x,
 void HistogramInferMeta(
     const MetaTensor& input, int64_t bins, int min, int max, MetaTensor* out);
 
+void HnswBuildInferMeta(const MetaTensor& x,
+                        int m,
+                        int ef_construction,
+                        int seed,
+                        MetaTensor* neighbors,
+                        MetaTensor* offsets,
+                        MetaTensor* meta);
+
 void IdentityLossInferMeta(const MetaTensor& x, int reduction, MetaTensor* out);
 
 void IncrementInferMeta(const MetaTensor& x, float value, MetaTensor* out);
@@ -320,6 +328,18 @@ void IsEmptyInferMeta(const MetaTensor& x, MetaTensor* out);
 
 void IsfiniteInferMeta(const MetaTensor& input, MetaTensor* out);
 
+void IvfPqBuildInferMeta(const MetaTensor& x,
+                         int nlist,
+                         int m,
+                         int ksub,
+                         int iters,
+                         int seed,
+                         MetaTensor* centroids,
+                         MetaTensor* codebooks,
+                         MetaTensor* codes,
+                         MetaTensor* list_offsets,
+                         MetaTensor* ids);
+
 void KthvalueInferMeta(const MetaTensor& x,
                        int k,
                        int axis,
@@ -67,6 +67,19 @@ class AutoTuneBase {
            const AlgorithmType& algo,
            const size_t key,
            Args&&... args) {
+    RunVariants(ctx, algo, key, [](size_t) { return true; }, args...);
+  }
+
+  // Like Run, but only the kernels accepted by is_valid(idx) are timed. The
+  // kernels are the launch variants of a primitive, like its vectorized and
+  // block sizes, and the key should hold what is_valid depends on, so the
+  // cached kernel is valid. kernels_[0] is the default and always valid.
+  template <typename Context, typename ValidFunc, typename... Args>
+  void RunVariants(const Context& ctx,
+                   const AlgorithmType& algo,
+                   const size_t key,
+                   const ValidFunc& is_valid,
+                   Args&&... args) {
     is_init_ = true;
     CheckKernelSize();
     auto& cache = AutoTuneCache::Instance().Get(algo);
@@ -78,7 +91,7 @@ class AutoTuneBase {
       if (use_autotune) {
         // All avaliable kernels have ran while picking the best kernel,
         // so there may be no need for another kernel run.
-        auto best_idx = PickBestKernel(ctx, args...);
+        auto best_idx = PickBestKernel(ctx, is_valid, args...);
         cache.Set(key, best_idx);
       } else {
         kernels_[0].Run(args...);
@@ -99,14 +112,17 @@ class AutoTuneBase {
             "kernel num must be greater than 0, now is %d", kernels_.size()));
   }
 
-  template <typename Context, typename... Args>
-  size_t PickBestKernel(const Context& ctx, Args&&... args) {
+  template <typename Context, typename ValidFunc, typename... Args>
+  size_t PickBestKernel(const Context& ctx,
+                        const ValidFunc& is_valid,
+                        Args&&... args) {
     std::lock_guard<std::mutex> lock(mutex_);
     size_t best_idx = 0;
     float min_time = std::numeric_limits<float>::max();
 
     // Time cost test estabulished in default stream.
     for (size_t i = 0; i < kernels_.size(); ++i) {
+      if (i > 0 && !is_valid(i)) continue;
       auto time = RunAndMeasureKernel<Context>(ctx, i, args...);
       if (time < min_time) {
         min_time = time;
@@ -168,7 +184,8 @@ class MatmulAutoTuner
     } else {
       bool use_autotune = AutoTuneStatus::Instance().UseAutoTune();
       if (use_autotune) {
-        auto best_idx = this->PickBestKernel(ctx, args...);
+        auto best_idx = this->PickBestKernel(
+            ctx, [](size_t) { return true; }, args...);
         cache.Set(key, best_idx);
       } else {
         this->kernels_[0].Run(args...);
@@ -318,6 +335,7 @@ MakeGatherGemmScatterTuner(ReturnType (*func)(T, T, Args...)) {
   DEFINE_AUTOTUNER_FN(name)
 
 DEFINE_AUTOTUNER(Transpose)
+DEFINE_AUTOTUNER(Broadcast)
 DEFINE_AUTOTUNER_FN(Matmul)
 
 #undef DEFINE_AUTOTUNER_COMMON_OBJECT
@@ -14,9 +14,15 @@
 
 #include "paddle/phi/kernels/autotune/cache.h"
 
+#include <cstdio>
+#include <fstream>
 #include <iomanip>
+#include <sstream>
 
 #include "glog/logging.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#endif
 
 namespace phi {
 namespace autotune {
@@ -28,6 +34,52 @@ size_t TransposeKey(const std::vector<int64_t>& x_dims,
   return GenKey(x_dims, perm, rank, static_cast<int>(dtype));
 }
 
+namespace {
+
+constexpr char kCacheFileHeader[] = "paddle_autotune_cache_v3";
+
+// The tuned algorithms are valid for the device, the driver and the
+// libraries they are tuned with, and the keys and the kernel indices are
+// valid for the Paddle version.
+std::string CacheEnvironmentKey() {
+  std::ostringstream os;
+#ifdef PADDLE_VERSION_INTEGER
+  os << "paddle=" << PADDLE_VERSION_INTEGER << ";";
+#endif
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  int id = phi::backends::gpu::GetCurrentDeviceId();
+  os << "arch=" << phi::backends::gpu::GetGPUComputeCapability(id)
+     << ";sm_count=" << phi::backends::gpu::GetGPUMultiProcessors(id)
+     << ";driver=" << phi::backends::gpu::GetGPUDriverVersion(id)
+     << ";runtime=" << phi::backends::gpu::GetGPURuntimeVersion(id)
+     << ";dnn=" << phi::backends::gpu::DnnVersion();
+#else
+  os << "cpu";
+#endif
+  return os.str();
+}
+
+template <typename T>
+void WriteVector(std::ostream& os, const std::vector<T>& vec) {
+  os << " " << vec.size();
+  for (const auto& v : vec) {
+    os << " " << v;
+  }
+}
+
+template <typename T>
+bool ReadVector(std::istream& is, std::vector<T>* vec) {
+  size_t size = 0;
+  if (!(is >> size)) return false;
+  vec->resize(size);
+  for (size_t i = 0; i < size; ++i) {
+    if (!(is >> (*vec)[i])) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
 std::string AlgorithmTypeString(int64_t algo_type) {
   if (algo_type == static_cast<int64_t>(AlgorithmType::kConvForward)) {
     return "conv_forward";
@@ -37,6 +89,8 @@ std::string AlgorithmTypeString(int64_t algo_type) {
   } else if (algo_type ==
              static_cast<int64_t>(AlgorithmType::kConvBackwardFilter)) {
     return "conv_backward_filter";
+  } else if (algo_type == static_cast<int64_t>(AlgorithmType::kBroadcast)) {
+    return "broadcast";
   }
 #ifdef PADDLE_WITH_CUDNN_FRONTEND
   if (algo_type == static_cast<int64_t>(AlgorithmType::kConvForwardV8)) {
@@ -116,5 +170,144 @@ void AutoTuneCache::UpdateStatus() {
   total_cache_misses_ = cache_misses;
 }
 
+bool AutoTuneCache::SaveToFile(const std::string& path) {
+  // the file is replaced after it is written, so the processes loading it
+  // never read a partial file
+  std::string tmp_path = path + ".tmp";
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  tmp_path += std::to_string(phi::backends::gpu::GetCurrentDeviceId());
+#endif
+  std::ofstream fout(tmp_path, std::ios::out | std::ios::trunc);
+  if (!fout.is_open()) {
+    LOG(WARNING) << "Failed to open the autotune cache file " << tmp_path;
+    return false;
+  }
+  fout << kCacheFileHeader << "\n" << CacheEnvironmentKey() << "\n";
+  int64_t num_saved = 0;
+  for (auto& v : auto_tune_map_) {
+    for (const auto& item : v.second.GetAll()) {
+      fout << "algo " << v.first << " " << item.first << " " << item.second
+           << "\n";
+      ++num_saved;
+    }
+  }
+  for (const auto& item : matmul_auto_tune_map_.GetAll()) {
+    fout << "matmul " << item.first << " " << item.second << "\n";
+    ++num_saved;
+  }
+  for (auto& v : conv_auto_tune_map_) {
+    for (const auto& item : v.second.GetAll()) {
+      // the heuristic results are cheap to find again
+      if (!item.second.exhaustive_search) continue;
+      const ConvCacheKey& key = item.first;
+      fout << "conv " << v.first << " " << item.second.algo << " "
+           << item.second.workspace_size;
+      WriteVector(fout, key.x_dims);
+      WriteVector(fout, key.w_dims);
+      WriteVector(fout, key.strides);
+      WriteVector(fout, key.paddings);
+      WriteVector(fout, key.dilations);
+      fout << " " << static_cast<int>(key.dtype) << " " << key.groups << " "
+           << key.data_layout << " " << item.second.candidates.size();
+      for (const auto& candidate : item.second.candidates) {
+        fout << " " << candidate.first << " " << candidate.second;
+      }
+      fout << "\n";
+      ++num_saved;
+    }
+  }
+  fout.close();
+  if (!fout || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Failed to write the autotune cache file " << path;
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  VLOG(3) << "Saved " << num_saved << " autotuned algorithms to " << path;
+  return true;
+}
+
+bool AutoTuneCache::LoadFromFile(const std::string& path) {
+  std::ifstream fin(path, std::ios::in);
+  if (!fin.is_open()) {
+    VLOG(3) << "The autotune cache file " << path << " does not exist.";
+    return false;
+  }
+  std::string header;
+  std::string env_key;
+  std::getline(fin, header);
+  std::getline(fin, env_key);
+  if (header != kCacheFileHeader || env_key != CacheEnvironmentKey()) {
+    LOG(WARNING) << "The autotune cache file " << path
+                 << " is saved in another environment (" << env_key
+                 << "), it is ignored.";
+    return false;
+  }
+
+  // the records are applied after the whole file is parsed
+  std::vector<std::pair<int64_t, std::pair<size_t, int64_t>>> algos;
+  std::vector<std::pair<size_t, int64_t>> matmuls;
+  std::vector<std::pair<int64_t, std::pair<ConvCacheKey, ConvAutoTuneResult>>>
+      convs;
+  std::string line;
+  while (std::getline(fin, line)) {
+    if (line.empty()) continue;
+    std::istringstream is(line);
+    std::string kind;
+    is >> kind;
+    bool ok = false;
+    if (kind == "algo") {
+      int64_t algo_type = 0;
+      size_t key = 0;
+      int64_t algo = 0;
+      ok = static_cast<bool>(is >> algo_type >> key >> algo) &&
+           auto_tune_map_.count(algo_type) > 0;
+      algos.push_back({algo_type, {key, algo}});
+    } else if (kind == "matmul") {
+      size_t key = 0;
+      int64_t algo = 0;
+      ok = static_cast<bool>(is >> key >> algo);
+      matmuls.push_back({key, algo});
+    } else if (kind == "conv") {
+      int64_t algo_type = 0;
+      ConvAutoTuneResult result(0, 0, true);
+      ConvCacheKey key;
+      int dtype = 0;
+      size_t num_candidates = 0;
+      ok = static_cast<bool>(is >> algo_type >> result.algo >>
+                             result.workspace_size) &&
+           ReadVector(is, &key.x_dims) && ReadVector(is, &key.w_dims) &&
+           ReadVector(is, &key.strides) && ReadVector(is, &key.paddings) &&
+           ReadVector(is, &key.dilations) &&
+           static_cast<bool>(is >> dtype >> key.groups >> key.data_layout >>
+                             num_candidates) &&
+           conv_auto_tune_map_.count(algo_type) > 0;
+      result.candidates.resize(ok ? num_candidates : 0);
+      for (auto& candidate : result.candidates) {
+        ok = ok && static_cast<bool>(is >> candidate.first >> candidate.second);
+      }
+      key.dtype = static_cast<phi::DataType>(dtype);
+      convs.push_back({algo_type, {key, result}});
+    }
+    if (!ok) {
+      LOG(WARNING) << "The autotune cache file " << path
+                   << " is broken at: " << line;
+      return false;
+    }
+  }
+
+  for (const auto& v : algos) {
+    auto_tune_map_[v.first].Set(v.second.first, v.second.second);
+  }
+  for (const auto& v : matmuls) {
+    matmul_auto_tune_map_.Set(v.first, v.second);
+  }
+  for (const auto& v : convs) {
+    conv_auto_tune_map_[v.first].Set(v.second.first, v.second.second);
+  }
+  VLOG(3) << "Loaded " << algos.size() + matmuls.size() + convs.size()
+          << " autotuned algorithms from " << path;
+  return true;
+}
+
 }  // namespace autotune
 }  // namespace phi
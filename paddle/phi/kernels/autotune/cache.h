@@ -16,6 +16,9 @@
 
 #include <algorithm>
 #include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/kernels/autotune/cache_base.h"
@@ -33,6 +36,10 @@ struct ConvAutoTuneResult {
   int64_t algo;
   size_t workspace_size = 0;
   bool exhaustive_search = false;
+  // The algorithms found by the search with their workspace sizes, the
+  // fastest first, to fall back to when the workspace of algo does not fit
+  // in the free memory at run time.
+  std::vector<std::pair<int64_t, size_t>> candidates;
 };
 
 size_t TransposeKey(const std::vector<int64_t>& x_dims,
@@ -49,21 +56,22 @@ enum class AlgorithmType {
   kGatherGemmScatterFP32NN = 7,
   kGatherGemmScatterFP32TN = 8,
   kGatherGemmScatterFP32NT = 9,
+  kBroadcast = 10,
 #if !defined(PADDLE_WITH_CUDNN_FRONTEND)
-  kAlgorithmCount = 10
+  kAlgorithmCount = 11
 #else
-  kConvForwardV8 = 10,
-  kConvBackwardDataV8 = 11,
-  kConvBackwardFilterV8 = 12,
-  kScaleBiasReluConvBNstats = 13,
-  kBNFinalize = 14,
-  kScaleBiasAddRelu = 15,
-  kDgradDreluBnBwdWeight = 16,
-  kDbnApply = 17,
-  kBnActWgrad = 18,
-  kPoolingForwardV8 = 19,
-  kPoolingBackwardV8 = 20,
-  kAlgorithmCount = 21
+  kConvForwardV8 = 11,
+  kConvBackwardDataV8 = 12,
+  kConvBackwardFilterV8 = 13,
+  kScaleBiasReluConvBNstats = 14,
+  kBNFinalize = 15,
+  kScaleBiasAddRelu = 16,
+  kDgradDreluBnBwdWeight = 17,
+  kDbnApply = 18,
+  kBnActWgrad = 19,
+  kPoolingForwardV8 = 20,
+  kPoolingBackwardV8 = 21,
+  kAlgorithmCount = 22
 #endif
 };
 
@@ -151,6 +159,15 @@ class AutoTuneCache {
 
   void UpdateStatus();
 
+  // Save the tuned algorithms to a file, which is loaded only by the
+  // processes with the same device, driver, library and Paddle versions. The
+  // cudnn frontend plans and the cublasLt descriptors are not saved.
+  bool SaveToFile(const std::string& path);
+
+  // Load the algorithms saved by SaveToFile into the cache, return false if
+  // the file is missing, broken or saved in another environment.
+  bool LoadFromFile(const std::string& path);
+
   // The number of total config cached
   int64_t Size() const { return total_size_; }
 
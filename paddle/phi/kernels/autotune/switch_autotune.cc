@@ -18,6 +18,7 @@
 #include "paddle/utils/flags.h"
 
 PD_DECLARE_bool(use_autotune);
+PD_DECLARE_string(autotune_cache_file);
 
 namespace phi {
 namespace autotune {
@@ -55,6 +56,9 @@ void AutoTuneStatus::Update() {
             << static_cast<int>(StepHitRate() * 100) << "%";
   } else {
     use_autotune_ = false;
+    if (current_steps_id_ + 1 == stop_step_id_) {
+      SaveCacheFile();
+    }
     // Set a small tolerance to avoid performance degradation
     // due to large cache size under dynamic shape.
     // TODO(limingshu): Currently works for conv op only, this
@@ -71,5 +75,17 @@ void AutoTuneStatus::Update() {
   }
 }
 
+void AutoTuneStatus::LoadCacheFile() {
+  if (FLAGS_use_autotune && !FLAGS_autotune_cache_file.empty()) {
+    AutoTuneCache::Instance().LoadFromFile(FLAGS_autotune_cache_file);
+  }
+}
+
+void AutoTuneStatus::SaveCacheFile() {
+  if (!FLAGS_autotune_cache_file.empty()) {
+    AutoTuneCache::Instance().SaveToFile(FLAGS_autotune_cache_file);
+  }
+}
+
 }  // namespace autotune
 }  // namespace phi
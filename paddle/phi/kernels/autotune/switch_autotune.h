@@ -76,7 +76,7 @@ class AutoTuneStatus {
   }
 
  private:
-  AutoTuneStatus() = default;
+  AutoTuneStatus() { LoadCacheFile(); }
 
   void Init() {
     use_autotune_ = false;
@@ -85,8 +85,13 @@ class AutoTuneStatus {
     previous_misses_ = 0;
     step_hit_rates_.clear();
     AutoTuneCache::Instance().Clean();
+    LoadCacheFile();
   }
 
+  // Warm start from FLAGS_autotune_cache_file if autotune is enabled.
+  void LoadCacheFile();
+  void SaveCacheFile();
+
   bool use_autotune_{false};
   int64_t start_step_id_{1};
   int64_t stop_step_id_{10};
@@ -29,4 +29,14 @@ void CheckNumericsKernel(const Context& ctx,
                          DenseTensor* stats,
                          DenseTensor* values);
 
+// Lowers the int64 in flag to id if the tensor holds NAN or INF. Unlike
+// CheckNumericsKernel, neither the stats are computed nor the stream is
+// synchronized, so that the checks of many tensors are read by one copy of
+// the flag.
+template <typename T, typename Context>
+void CheckNumericsFlagKernel(const Context& ctx,
+                             const DenseTensor& tensor,
+                             int64_t id,
+                             int64_t* flag);
+
 }  // namespace phi
@@ -18,6 +18,7 @@
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 #include "paddle/phi/kernels/funcs/selected_rows_functor.h"
+#include "paddle/phi/kernels/funcs/selected_rows_segments.h"
 #include "paddle/phi/kernels/impl/adagrad_kernel_impl.h"
 
 namespace phi {
@@ -72,30 +73,37 @@ struct SparseAdagradFunctor<phi::CPUContext, T> {
                   T epsilon,
                   DenseTensor* moment,
                   DenseTensor* param) {
-    // 1. g_m.rows = set(g.rows)
+    // 1. group the duplicated grad rows into the sorted segments, the merged
+    // grad g_m of each segment is summed on the fly
     auto grad_width = grad.value().dims()[1];
-    phi::funcs::scatter::MergeAdd<phi::CPUContext, T> merge_func;
-    auto grad_merge = merge_func(context, grad);
-    auto& merge_rows = grad_merge.rows();
-    auto* grad_merge_data = grad_merge.mutable_value()->template data<T>();
+    std::vector<int64_t> grad_rows(grad.rows().begin(), grad.rows().end());
+    phi::funcs::RowSegments segments;
+    phi::funcs::BuildRowSegments(
+        grad_rows.data(), static_cast<int64_t>(grad_rows.size()), &segments);
+    auto* grad_data = grad.value().data<T>();
 
-    // 2. m += g_m * g_m
-    auto grad_square =
-        SquareSelectedRows<phi::CPUContext, T>(context, grad_merge);
-
-    phi::funcs::SelectedRowsAddToTensor<phi::CPUContext, T> functor;
-    functor(context, grad_square, moment);
-
-    // 3. update parameter
+    // 2. m += g_m * g_m and update parameter, row by row
     auto* lr = learning_rate.data<T>();
     auto* param_data = param->data<T>();
     auto* moment_data = moment->data<T>();
-
-    for (size_t i = 0; i < merge_rows.size(); i++) {
+    std::vector<T> grad_merge(grad_width);
+
+    for (size_t i = 0; i < segments.size(); i++) {
+      const T* first =
+          grad_data + segments.order[segments.begin(i)] * grad_width;
+      std::copy(first, first + grad_width, grad_merge.begin());
+      for (int64_t k = segments.begin(i) + 1; k < segments.end(i); ++k) {
+        const T* grad_row = grad_data + segments.order[k] * grad_width;
+        for (int64_t j = 0; j < grad_width; j++) {
+          grad_merge[j] += grad_row[j];
+        }
+      }
+      int64_t offset = segments.rows[i] * grad_width;
       for (int64_t j = 0; j < grad_width; j++) {
-        param_data[merge_rows[i] * grad_width + j] -=
-            lr[0] * grad_merge_data[i * grad_width + j] /
-            (std::sqrt(moment_data[merge_rows[i] * grad_width + j]) + epsilon);
+        moment_data[offset + j] += grad_merge[j] * grad_merge[j];
+        param_data[offset + j] -=
+            lr[0] * grad_merge[j] /
+            (std::sqrt(moment_data[offset + j]) + epsilon);
       }
     }
   }
@@ -19,53 +19,35 @@
 #include "paddle/phi/kernels/funcs/eigen/common.h"
 #include "paddle/phi/kernels/funcs/eigen/eigen_function.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/funcs/top_k_function.h"
 #include "paddle/phi/kernels/transpose_kernel.h"
 
 namespace phi {
 
-template <typename T, typename Type>
-static void FullSort(Type input_height,
-                     Type input_width,
-                     int input_dim,
+template <typename T>
+static void FullSort(const CPUContext& dev_ctx,
+                     int64_t input_height,
+                     int64_t input_width,
                      const DenseTensor* input,
                      T* t_out,
-                     Type* t_indices,
+                     int64_t* t_indices,
                      bool descending) {
-#ifdef PADDLE_WITH_MKLML
-#pragma omp parallel for
-#endif
-  for (Type i = 0; i < input_height; ++i) {
-    std::vector<std::pair<T, Type>> col_vec;
-    col_vec.reserve(input_width);
-    if (input_dim == 1) {
-      auto e_input = EigenVector<T>::Flatten(*input);
-      for (Type j = 0; j < input_width; ++j) {
-        col_vec.push_back(std::pair<T, Type>(e_input(j), j));
-      }
-    } else {
-      auto e_input = EigenMatrix<T>::Reshape(*input, input_dim - 1);
-      for (Type j = 0; j < input_width; ++j) {
-        col_vec.push_back(std::pair<T, Type>(e_input(i, j), j));
-      }
-    }
-    std::sort(col_vec.begin(),
-              col_vec.end(),
-              [&](const std::pair<T, Type>& l, const std::pair<T, Type>& r) {
-                if (descending)
-                  return (std::isnan(static_cast<double>(l.first)) &&
-                          !std::isnan(static_cast<double>(r.first))) ||
-                         (l.first > r.first);
-                else
-                  return (!std::isnan(static_cast<double>(l.first)) &&
-                          std::isnan(static_cast<double>(r.first))) ||
-                         (l.first < r.first);
-              });
-
-    for (Type j = 0; j < input_width; ++j) {
-      t_out[i * input_width + j] = col_vec[j].first;
-      t_indices[i * input_width + j] = col_vec[j].second;
-    }
-  }
+  const T* in_data = input->data<T>();
+  funcs::ParallelForRows(
+      dev_ctx,
+      input_height,
+      funcs::RowGrain<T>(input_width),
+      [&](int64_t begin, int64_t end) {
+        std::vector<std::pair<T, int64_t>> pairs;
+        for (int64_t i = begin; i < end; ++i) {
+          funcs::SortRow<T>(in_data + i * input_width,
+                            input_width,
+                            descending,
+                            &pairs,
+                            t_out + i * input_width,
+                            t_indices + i * input_width);
+        }
+      });
 }
 
 template <typename T, typename Context>
@@ -94,13 +76,13 @@ void ArgsortKernel(const Context& dev_ctx,
         common::product(common::slice_ddim(in_dims, 0, in_dims.size() - 1));
     const int64_t input_width = in_dims[in_dims.size() - 1];
     int64_t* ids_data = dev_ctx.template Alloc<int64_t>(indices);
-    FullSort<T, int64_t>(input_height,
-                         input_width,
-                         in_dims.size(),
-                         &input,
-                         out_data,
-                         ids_data,
-                         descending);
+    FullSort<T>(dev_ctx,
+                input_height,
+                input_width,
+                &input,
+                out_data,
+                ids_data,
+                descending);
   } else {
     // If not full sort do transpose
     std::vector<int> trans;
@@ -135,13 +117,13 @@ void ArgsortKernel(const Context& dev_ctx,
     tmp_indices.Resize(trans_dims);
     auto* t_ind = dev_ctx.template Alloc<int64_t>(&tmp_indices);
 
-    FullSort<T, int64_t>(input_height,
-                         input_width,
-                         in_dims.size(),
-                         &trans_inp,
-                         t_out,
-                         t_ind,
-                         descending);
+    FullSort<T>(dev_ctx,
+                input_height,
+                input_width,
+                &trans_inp,
+                t_out,
+                t_ind,
+                descending);
 
     dev_ctx.template Alloc<int64_t>(indices);
     TransposeKernel<int64_t, Context>(dev_ctx, tmp_indices, trans, indices);
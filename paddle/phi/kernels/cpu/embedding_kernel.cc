@@ -14,7 +14,10 @@
 
 #include "paddle/phi/kernels/embedding_kernel.h"
 
+#include <algorithm>
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/backends/cpu/intra_op_thread_pool.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/utils/data_type.h"
@@ -71,11 +74,7 @@ struct EmbeddingCPUFunctor {
       }
     }
 
-#if defined(_OPENMP) && !defined(PADDLE_WITH_CUDA)
-#pragma omp parallel for
-#endif
-
-    for (int64_t i = 0; i < ids_numel; ++i) {
+    auto copy_row = [&](int64_t i) {
       if (padding_idx_ != kNoPadding && ids[i] == padding_idx_) {
         memset(output + i * row_width, 0, row_width * sizeof(T));
       } else {
@@ -83,6 +82,25 @@ struct EmbeddingCPUFunctor {
                table + ids[i] * row_width,
                row_width * sizeof(T));
       }
+    };
+
+    auto* pool = dev_ctx_.intra_op_thread_pool();
+    if (pool != nullptr) {
+      // About 64KB of rows for a chunk.
+      const int64_t grain = std::max<int64_t>(
+          1, (64 << 10) / std::max<int64_t>(1, row_width * sizeof(T)));
+      pool->ParallelFor(0, ids_numel, grain, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) copy_row(i);
+      });
+      return;
+    }
+
+#if defined(_OPENMP) && !defined(PADDLE_WITH_CUDA)
+#pragma omp parallel for
+#endif
+
+    for (int64_t i = 0; i < ids_numel; ++i) {
+      copy_row(i);
     }
   }
 
@@ -0,0 +1,156 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "paddle/phi/kernels/hnsw_kernel.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/hnsw.h"
+#include "paddle/phi/kernels/funcs/top_k_function.h"
+
+namespace phi {
+
+template <typename Context>
+static void SaveHnswGraph(const Context& dev_ctx,
+                          const funcs::HnswGraph& graph,
+                          DenseTensor* neighbors,
+                          DenseTensor* offsets,
+                          DenseTensor* meta) {
+  std::vector<int32_t> neighbors_vec;
+  std::vector<int64_t> offsets_vec;
+  int64_t meta_vec[3];
+  graph.Save(&neighbors_vec, &offsets_vec, meta_vec);
+  neighbors->Resize({static_cast<int64_t>(neighbors_vec.size())});
+  offsets->Resize({static_cast<int64_t>(offsets_vec.size())});
+  meta->Resize({3});
+  std::copy(neighbors_vec.begin(),
+            neighbors_vec.end(),
+            dev_ctx.template Alloc<int32_t>(neighbors));
+  std::copy(offsets_vec.begin(),
+            offsets_vec.end(),
+            dev_ctx.template Alloc<int64_t>(offsets));
+  std::copy(meta_vec, meta_vec + 3, dev_ctx.template Alloc<int64_t>(meta));
+}
+
+template <typename T, typename Context>
+void HnswBuildKernel(const Context& dev_ctx,
+                     const DenseTensor& x,
+                     int m,
+                     int ef_construction,
+                     int seed,
+                     DenseTensor* neighbors,
+                     DenseTensor* offsets,
+                     DenseTensor* meta) {
+  funcs::HnswGraph graph(x.data<T>(), x.dims()[1], m, ef_construction);
+  graph.Add(0, x.dims()[0], seed);
+  SaveHnswGraph(dev_ctx, graph, neighbors, offsets, meta);
+}
+
+template <typename T, typename Context>
+void HnswAddKernel(const Context& dev_ctx,
+                   const DenseTensor& x,
+                   const DenseTensor& neighbors,
+                   const DenseTensor& offsets,
+                   const DenseTensor& meta,
+                   int ef_construction,
+                   int seed,
+                   DenseTensor* neighbors_out,
+                   DenseTensor* offsets_out,
+                   DenseTensor* meta_out) {
+  const int64_t old_n = offsets.numel() - 1;
+  PADDLE_ENFORCE_LE(
+      old_n,
+      x.dims()[0],
+      errors::InvalidArgument(
+          "The rows of hnsw_add should hold the %d nodes of the graph "
+          "followed by the new rows, but received only %d rows.",
+          old_n,
+          x.dims()[0]));
+  const int64_t* meta_data = meta.data<int64_t>();
+  funcs::HnswGraph graph(x.data<T>(),
+                         x.dims()[1],
+                         static_cast<int>(meta_data[2]),
+                         ef_construction);
+  graph.Load(
+      neighbors.data<int32_t>(), offsets.data<int64_t>(), old_n, meta_data);
+  graph.Add(old_n, x.dims()[0], seed);
+  SaveHnswGraph(dev_ctx, graph, neighbors_out, offsets_out, meta_out);
+}
+
+template <typename T, typename Context>
+void HnswSearchKernel(const Context& dev_ctx,
+                      const DenseTensor& query,
+                      const DenseTensor& x,
+                      const DenseTensor& neighbors,
+                      const DenseTensor& offsets,
+                      const DenseTensor& meta,
+                      int k,
+                      int ef_search,
+                      DenseTensor* distances,
+                      DenseTensor* indices) {
+  const int64_t d = x.dims()[1];
+  const int64_t n = offsets.numel() - 1;
+  const T* query_data = query.data<T>();
+  T* dist_data = dev_ctx.template Alloc<T>(distances);
+  int64_t* indices_data = dev_ctx.template Alloc<int64_t>(indices);
+  funcs::ParallelForRows(
+      dev_ctx, query.dims()[0], 1, [&](int64_t begin, int64_t end) {
+        std::vector<uint32_t> visited(n, 0);
+        uint32_t visit_tag = 0;
+        for (int64_t q = begin; q < end; ++q) {
+          funcs::HnswSearch(x.data<T>(),
+                            d,
+                            neighbors.data<int32_t>(),
+                            offsets.data<int64_t>(),
+                            n,
+                            meta.data<int64_t>(),
+                            query_data + q * d,
+                            k,
+                            ef_search,
+                            &visited,
+                            &visit_tag,
+                            dist_data + q * k,
+                            indices_data + q * k);
+        }
+      });
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(hnsw_build, CPU, ALL_LAYOUT, phi::HnswBuildKernel, float) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::INT32);
+  kernel->OutputAt(1).SetDataType(phi::DataType::INT64);
+  kernel->OutputAt(2).SetDataType(phi::DataType::INT64);
+}
+
+PD_REGISTER_KERNEL(hnsw_add, CPU, ALL_LAYOUT, phi::HnswAddKernel, float) {
+  kernel->InputAt(1).SetDataType(phi::DataType::INT32);
+  kernel->InputAt(2).SetDataType(phi::DataType::INT64);
+  kernel->InputAt(3).SetDataType(phi::DataType::INT64);
+  kernel->OutputAt(0).SetDataType(phi::DataType::INT32);
+  kernel->OutputAt(1).SetDataType(phi::DataType::INT64);
+  kernel->OutputAt(2).SetDataType(phi::DataType::INT64);
+}
+
+PD_REGISTER_KERNEL(
+    hnsw_search, CPU, ALL_LAYOUT, phi::HnswSearchKernel, float) {
+  kernel->InputAt(2).SetDataType(phi::DataType::INT32);
+  kernel->InputAt(3).SetDataType(phi::DataType::INT64);
+  kernel->InputAt(4).SetDataType(phi::DataType::INT64);
+  kernel->OutputAt(1).SetDataType(phi::DataType::INT64);
+}
@@ -0,0 +1,215 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "paddle/phi/kernels/ivf_pq_kernel.h"
+
+#include <limits>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/ivf_pq.h"
+#include "paddle/phi/kernels/funcs/top_k_function.h"
+
+namespace phi {
+
+template <typename T, typename Context>
+void IvfPqBuildKernel(const Context& dev_ctx,
+                      const DenseTensor& x,
+                      int nlist,
+                      int m,
+                      int ksub,
+                      int iters,
+                      int seed,
+                      DenseTensor* centroids,
+                      DenseTensor* codebooks,
+                      DenseTensor* codes,
+                      DenseTensor* list_offsets,
+                      DenseTensor* ids) {
+  const int64_t n = x.dims()[0];
+  const int64_t d = x.dims()[1];
+  const int64_t dsub = d / m;
+  const T* x_data = x.data<T>();
+  T* centroids_data = dev_ctx.template Alloc<T>(centroids);
+  T* codebooks_data = dev_ctx.template Alloc<T>(codebooks);
+
+  funcs::KMeans(x_data, n, d, nlist, iters, seed, centroids_data);
+  std::vector<T> residuals(n * d);
+  for (int64_t i = 0; i < n; ++i) {
+    const int64_t list =
+        funcs::NearestCentroid(x_data + i * d, centroids_data, nlist, d);
+    for (int64_t j = 0; j < d; ++j) {
+      residuals[i * d + j] = x_data[i * d + j] - centroids_data[list * d + j];
+    }
+  }
+  funcs::TrainPQCodebooks(
+      residuals.data(), n, d, m, ksub, iters, seed, codebooks_data);
+  VLOG(4) << "Train the ivf_pq index of " << nlist << " lists and " << m
+          << " codebooks of " << ksub << " codewords of " << dsub
+          << " dims on " << n << " rows.";
+
+  funcs::IvfPqAppend(x_data,
+                     n,
+                     d,
+                     0,
+                     centroids_data,
+                     nlist,
+                     codebooks_data,
+                     m,
+                     ksub,
+                     nullptr,
+                     nullptr,
+                     nullptr,
+                     dev_ctx.template Alloc<uint8_t>(codes),
+                     dev_ctx.template Alloc<int64_t>(list_offsets),
+                     dev_ctx.template Alloc<int64_t>(ids));
+}
+
+template <typename T, typename Context>
+void IvfPqAddKernel(const Context& dev_ctx,
+                    const DenseTensor& x,
+                    const DenseTensor& centroids,
+                    const DenseTensor& codebooks,
+                    const DenseTensor& codes,
+                    const DenseTensor& list_offsets,
+                    const DenseTensor& ids,
+                    DenseTensor* codes_out,
+                    DenseTensor* list_offsets_out,
+                    DenseTensor* ids_out) {
+  funcs::IvfPqAppend(x.data<T>(),
+                     x.dims()[0],
+                     x.dims()[1],
+                     ids.numel(),
+                     centroids.data<T>(),
+                     centroids.dims()[0],
+                     codebooks.data<T>(),
+                     codebooks.dims()[0],
+                     codebooks.dims()[1],
+                     codes.data<uint8_t>(),
+                     list_offsets.data<int64_t>(),
+                     ids.data<int64_t>(),
+                     dev_ctx.template Alloc<uint8_t>(codes_out),
+                     dev_ctx.template Alloc<int64_t>(list_offsets_out),
+                     dev_ctx.template Alloc<int64_t>(ids_out));
+}
+
+template <typename T, typename Context>
+void IvfPqSearchKernel(const Context& dev_ctx,
+                       const DenseTensor& query,
+                       const DenseTensor& centroids,
+                       const DenseTensor& codebooks,
+                       const DenseTensor& codes,
+                       const DenseTensor& list_offsets,
+                       const DenseTensor& ids,
+                       int k,
+                       int nprobe,
+                       DenseTensor* distances,
+                       DenseTensor* indices) {
+  const int64_t num_queries = query.dims()[0];
+  const int64_t d = query.dims()[1];
+  const int64_t nlist = centroids.dims()[0];
+  const int64_t m = codebooks.dims()[0];
+  const int64_t ksub = codebooks.dims()[1];
+  const int64_t dsub = codebooks.dims()[2];
+  const T* query_data = query.data<T>();
+  const T* centroids_data = centroids.data<T>();
+  const T* codebooks_data = codebooks.data<T>();
+  const uint8_t* codes_data = codes.data<uint8_t>();
+  const int64_t* offsets_data = list_offsets.data<int64_t>();
+  const int64_t* ids_data = ids.data<int64_t>();
+  T* dist_data = dev_ctx.template Alloc<T>(distances);
+  int64_t* indices_data = dev_ctx.template Alloc<int64_t>(indices);
+
+  funcs::ParallelForRows(
+      dev_ctx, num_queries, 1, [&](int64_t begin, int64_t end) {
+        std::vector<T> coarse(nlist);
+        std::vector<T> probe_dist(nprobe);
+        std::vector<int64_t> probes(nprobe);
+        std::vector<T> residual(d);
+        std::vector<T> table(m * ksub);
+        std::vector<T> scores;
+        std::vector<int64_t> positions(k);
+        funcs::TopKSelector<T> selector(k, false);
+        for (int64_t q = begin; q < end; ++q) {
+          const T* row = query_data + q * d;
+          for (int64_t l = 0; l < nlist; ++l) {
+            coarse[l] = funcs::L2Sqr(row, centroids_data + l * d, d);
+          }
+          funcs::TopKRow<T>(coarse.data(),
+                            nlist,
+                            nprobe,
+                            false,
+                            probe_dist.data(),
+                            probes.data());
+          selector.Reset();
+          for (int64_t list : probes) {
+            const T* centroid = centroids_data + list * d;
+            for (int64_t j = 0; j < d; ++j) residual[j] = row[j] - centroid[j];
+            funcs::PQDistanceTable(
+                residual.data(), codebooks_data, m, ksub, dsub, table.data());
+            const int64_t list_begin = offsets_data[list];
+            const int64_t size = offsets_data[list + 1] - list_begin;
+            scores.resize(size);
+            for (int64_t i = 0; i < size; ++i) {
+              const uint8_t* code = codes_data + (list_begin + i) * m;
+              T score = 0;
+              for (int64_t j = 0; j < m; ++j) {
+                score += table[j * ksub + code[j]];
+              }
+              scores[i] = score;
+            }
+            selector.Push(scores.data(), size, list_begin);
+          }
+          const int64_t found = selector.size();
+          T* out_dist = dist_data + q * k;
+          int64_t* out_ids = indices_data + q * k;
+          selector.Finish(out_dist, positions.data());
+          for (int64_t i = 0; i < k; ++i) {
+            if (i < found) {
+              out_ids[i] = ids_data[positions[i]];
+            } else {
+              out_dist[i] = std::numeric_limits<T>::infinity();
+              out_ids[i] = -1;
+            }
+          }
+        }
+      });
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(
+    ivf_pq_build, CPU, ALL_LAYOUT, phi::IvfPqBuildKernel, float) {
+  kernel->OutputAt(2).SetDataType(phi::DataType::UINT8);
+  kernel->OutputAt(3).SetDataType(phi::DataType::INT64);
+  kernel->OutputAt(4).SetDataType(phi::DataType::INT64);
+}
+
+PD_REGISTER_KERNEL(ivf_pq_add, CPU, ALL_LAYOUT, phi::IvfPqAddKernel, float) {
+  kernel->InputAt(3).SetDataType(phi::DataType::UINT8);
+  kernel->InputAt(4).SetDataType(phi::DataType::INT64);
+  kernel->InputAt(5).SetDataType(phi::DataType::INT64);
+  kernel->OutputAt(0).SetDataType(phi::DataType::UINT8);
+  kernel->OutputAt(1).SetDataType(phi::DataType::INT64);
+  kernel->OutputAt(2).SetDataType(phi::DataType::INT64);
+}
+
+PD_REGISTER_KERNEL(
+    ivf_pq_search, CPU, ALL_LAYOUT, phi::IvfPqSearchKernel, float) {
+  kernel->InputAt(3).SetDataType(phi::DataType::UINT8);
+  kernel->InputAt(4).SetDataType(phi::DataType::INT64);
+  kernel->InputAt(5).SetDataType(phi::DataType::INT64);
+  kernel->OutputAt(1).SetDataType(phi::DataType::INT64);
+}
@@ -0,0 +1,97 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "paddle/phi/kernels/matmul_topk_kernel.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/top_k_function.h"
+
+namespace phi {
+
+// A tile of 32 queries by 4096 candidates, 512KB of float scores, stays in
+// the L2 cache between the gemm and the selection.
+static constexpr int64_t kQueryTile = 32;
+static constexpr int64_t kCandidateTile = 4096;
+
+template <typename T, typename Context>
+void MatmulTopkKernel(const Context& dev_ctx,
+                      const DenseTensor& x,
+                      const DenseTensor& y,
+                      int k,
+                      bool largest,
+                      DenseTensor* out,
+                      DenseTensor* indices) {
+  const int64_t m = x.dims()[0];
+  const int64_t d = x.dims()[1];
+  const int64_t n = y.dims()[0];
+  PADDLE_ENFORCE_LE(
+      k,
+      n,
+      errors::InvalidArgument(
+          "The k of matmul_topk should be at most the number of the "
+          "candidates %d, but received %d.",
+          n,
+          k));
+  T* out_data = dev_ctx.template Alloc<T>(out);
+  int64_t* indices_data = dev_ctx.template Alloc<int64_t>(indices);
+  if (m == 0) return;
+
+  const T* x_data = x.data<T>();
+  const T* y_data = y.data<T>();
+  auto blas = funcs::GetBlas<Context, T>(dev_ctx);
+  const int64_t tiles = (m + kQueryTile - 1) / kQueryTile;
+  funcs::ParallelForRows(dev_ctx, tiles, 1, [&](int64_t begin, int64_t end) {
+    std::vector<T> scores(kQueryTile * std::min(n, kCandidateTile));
+    std::vector<funcs::TopKSelector<T>> selectors(
+        kQueryTile, funcs::TopKSelector<T>(k, largest));
+    for (int64_t tile = begin; tile < end; ++tile) {
+      const int64_t row_begin = tile * kQueryTile;
+      const int64_t rows = std::min(kQueryTile, m - row_begin);
+      for (int64_t r = 0; r < rows; ++r) selectors[r].Reset();
+      for (int64_t col = 0; col < n; col += kCandidateTile) {
+        const int64_t cols = std::min(kCandidateTile, n - col);
+        blas.GEMM(CblasNoTrans,
+                  CblasTrans,
+                  static_cast<int>(rows),
+                  static_cast<int>(cols),
+                  static_cast<int>(d),
+                  static_cast<T>(1),
+                  x_data + row_begin * d,
+                  y_data + col * d,
+                  static_cast<T>(0),
+                  scores.data());
+        for (int64_t r = 0; r < rows; ++r) {
+          selectors[r].Push(scores.data() + r * cols, cols, col);
+        }
+      }
+      for (int64_t r = 0; r < rows; ++r) {
+        selectors[r].Finish(out_data + (row_begin + r) * k,
+                            indices_data + (row_begin + r) * k);
+      }
+    }
+  });
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(
+    matmul_topk, CPU, ALL_LAYOUT, phi::MatmulTopkKernel, float, double) {
+  kernel->OutputAt(1).SetDataType(phi::DataType::INT64);
+}
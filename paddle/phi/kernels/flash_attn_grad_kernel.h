@@ -56,4 +56,24 @@ void FlashAttnGradKernel(const Context& ctx,
                          DenseTensor* dk,
                          DenseTensor* dv);
 
+template <typename T, typename Context>
+void FlashAttnLocalGradKernel(
+    const Context& ctx,
+    const DenseTensor& q,
+    const DenseTensor& k,
+    const DenseTensor& v,
+    const paddle::optional<DenseTensor>& cu_seqlens_q,
+    const paddle::optional<DenseTensor>& cu_seqlens_k,
+    const paddle::optional<DenseTensor>& alibi_slopes,
+    const DenseTensor& out,
+    const DenseTensor& softmax_lse,
+    const DenseTensor& dout,
+    int window_size_left,
+    int window_size_right,
+    bool causal,
+    float scale,
+    DenseTensor* dq,
+    DenseTensor* dk,
+    DenseTensor* dv);
+
 }  // namespace phi
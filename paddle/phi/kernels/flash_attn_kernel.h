@@ -59,4 +59,41 @@ void FlashAttnKernel(const Context& ctx,
                      DenseTensor* softmax_lse,
                      DenseTensor* seed_offset);
 
+// The local attention of q [batch_size, seqlen_q, num_heads, head_dim], or
+// the packed [total_q, num_heads, head_dim] with cu_seqlens_q/k, over the
+// keys of a sliding window, with the optional ALiBi slopes of [num_heads].
+template <typename T, typename Context>
+void FlashAttnLocalKernel(
+    const Context& ctx,
+    const DenseTensor& q,
+    const DenseTensor& k,
+    const DenseTensor& v,
+    const paddle::optional<DenseTensor>& cu_seqlens_q,
+    const paddle::optional<DenseTensor>& cu_seqlens_k,
+    const paddle::optional<DenseTensor>& alibi_slopes,
+    int window_size_left,
+    int window_size_right,
+    bool causal,
+    float scale,
+    DenseTensor* out,
+    DenseTensor* softmax_lse);
+
+// Append k and v of [batch_size, seqlen, num_heads_k, head_dim] to the kv
+// cache of [batch_size, max_seqlen, num_heads_k, head_dim] after the first
+// seq_lens[b] tokens in place, and attend q to the cached keys causally.
+template <typename T, typename Context>
+void FlashAttnKVCacheKernel(const Context& ctx,
+                            const DenseTensor& q,
+                            const DenseTensor& k,
+                            const DenseTensor& v,
+                            const DenseTensor& cache_k,
+                            const DenseTensor& cache_v,
+                            const DenseTensor& seq_lens,
+                            const paddle::optional<DenseTensor>& alibi_slopes,
+                            int window_size_left,
+                            float scale,
+                            DenseTensor* out,
+                            DenseTensor* cache_k_out,
+                            DenseTensor* cache_v_out);
+
 }  // namespace phi
@@ -15,9 +15,13 @@
 #pragma once
 #include <math.h>  // for sqrt in CPU and CUDA
 
+#include <algorithm>
+#include <vector>
+
 #include <Eigen/Dense>
 
 #include "paddle/phi/kernels/funcs/algorithm.h"
+#include "paddle/phi/kernels/funcs/selected_rows_segments.h"
 
 #ifdef PADDLE_WITH_XPU
 #include "paddle/phi/backends/xpu/enforce_xpu.h"
@@ -512,21 +516,72 @@ class SparseAdamFunctor<T, CPUAdam, T> {
         }
         ++j;
       } else {
+        decay_row(i, lr);
+      }
+    }
+  }
+
+  // The grad is not merged, the grad of the param row segments.rows[j] is
+  // the sum of the grad rows of the segment j, which is summed on the fly
+  // instead of materializing the merged grad. The rows_ of the functor should
+  // be segments.rows.
+  inline void operator()(size_t numel,
+                         const RowSegments& segments,
+                         bool lazy_mode) const {
+    T lr = *lr_;
+    T beta1_pow = *beta1_pow_;
+    T beta2_pow = *beta2_pow_;
+    lr *= sqrt(1 - beta2_pow) / (1 - beta1_pow);
+    int64_t row_count = static_cast<int64_t>(numel / row_numel_);
+    std::vector<T> g(row_numel_);
+
+    auto update_segment = [&](size_t j) {
+      const T* first = grad_ + segments.order[segments.begin(j)] * row_numel_;
+      std::copy(first, first + row_numel_, g.begin());
+      for (int64_t n = segments.begin(j) + 1; n < segments.end(j); ++n) {
+        const T* grad_row = grad_ + segments.order[n] * row_numel_;
         for (int64_t k = 0; k != row_numel_; ++k) {
-          T mom1 = moment1_[i * row_numel_ + k];
-          T mom2 = moment2_[i * row_numel_ + k];
-          T p = param_[i * row_numel_ + k];
-
-          mom1 = beta1_ * mom1;
-          mom2 = beta2_ * mom2;
-
-          p -= lr * (mom1 / (sqrt(mom2) + epsilon_));
-          // Write back to global memory
-          moment1_out_[i * row_numel_ + k] = mom1;
-          moment2_out_[i * row_numel_ + k] = mom2;
-          param_out_[i * row_numel_ + k] = p;
+          g[k] += grad_row[k];
         }
       }
+      int64_t row = segments.rows[j];
+      for (int64_t k = 0; k != row_numel_; ++k) {
+        adam_update(row * row_numel_ + k, g[k]);
+      }
+    };
+
+    if (lazy_mode) {
+      for (size_t j = 0; j < segments.size(); ++j) {
+        update_segment(j);
+      }
+      return;
+    }
+    for (int64_t i = 0, j = 0; i != row_count; ++i) {
+      if (j < static_cast<int64_t>(segments.size()) && i == segments.rows[j]) {
+        update_segment(j);
+        ++j;
+      } else {
+        decay_row(i, lr);
+      }
+    }
+  }
+
+ private:
+  // the update of the param row i without grad, lr is the reused lr
+  inline void decay_row(int64_t i, T lr) const {
+    for (int64_t k = 0; k != row_numel_; ++k) {
+      T mom1 = moment1_[i * row_numel_ + k];
+      T mom2 = moment2_[i * row_numel_ + k];
+      T p = param_[i * row_numel_ + k];
+
+      mom1 = beta1_ * mom1;
+      mom2 = beta2_ * mom2;
+
+      p -= lr * (mom1 / (sqrt(mom2) + epsilon_));
+      // Write back to global memory
+      moment1_out_[i * row_numel_ + k] = mom1;
+      moment2_out_[i * row_numel_ + k] = mom2;
+      param_out_[i * row_numel_ + k] = p;
     }
   }
 };
@@ -0,0 +1,195 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/batched_memcpy.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "glog/logging.h"
+
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/enforce.h"
+#ifdef PADDLE_WITH_CUDA
+#include "paddle/phi/backends/gpu/cuda/cuda_graph_with_memory_pool.h"
+#endif
+
+namespace phi {
+namespace funcs {
+
+#ifdef PADDLE_WITH_CUDA
+namespace {
+
+struct CopyItem {
+  char* dst;
+  const char* src;
+  size_t size;
+};
+
+constexpr int kCopyBlockSize = 256;
+constexpr int kMaxCopyBlocks = 4096;
+
+// A block copies an item, by 16 bytes if both of its addresses are aligned by
+// them.
+__global__ void BatchedMemcpyKernel(const CopyItem* items, int num_items) {
+  for (int i = blockIdx.x; i < num_items; i += gridDim.x) {
+    const CopyItem item = items[i];
+    size_t begin = 0;
+    if (((reinterpret_cast<uintptr_t>(item.dst) |
+          reinterpret_cast<uintptr_t>(item.src)) &
+         (sizeof(uint4) - 1)) == 0) {
+      const size_t num_vecs = item.size / sizeof(uint4);
+      const uint4* src = reinterpret_cast<const uint4*>(item.src);
+      uint4* dst = reinterpret_cast<uint4*>(item.dst);
+      for (size_t j = threadIdx.x; j < num_vecs; j += blockDim.x) {
+        dst[j] = src[j];
+      }
+      begin = num_vecs * sizeof(uint4);
+    }
+    for (size_t j = begin + threadIdx.x; j < item.size; j += blockDim.x) {
+      item.dst[j] = item.src[j];
+    }
+  }
+}
+
+// The device of the memory of ptr, or -1 of the host or managed memory.
+int DeviceOfPointer(const void* ptr) {
+  cudaPointerAttributes attr;
+  if (cudaPointerGetAttributes(&attr, ptr) != cudaSuccess) {
+    // The pageable memory is an error before CUDA 11, cleared here.
+    cudaGetLastError();
+    return -1;
+  }
+  return attr.type == cudaMemoryTypeDevice ? attr.device : -1;
+}
+
+}  // namespace
+#endif
+
+bool CanAccessPeer(int device, int peer) {
+  if (device == peer) {
+    return true;
+  }
+#ifdef PADDLE_WITH_CUDA
+  static std::mutex mutex;
+  static std::map<std::pair<int, int>, bool> can_access;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto iter = can_access.find(std::make_pair(device, peer));
+  if (iter != can_access.end()) {
+    return iter->second;
+  }
+  int access = 0;
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaDeviceCanAccessPeer(&access, device, peer));
+  if (access) {
+    backends::gpu::GPUDeviceGuard guard(device);
+    cudaError_t ret = cudaDeviceEnablePeerAccess(peer, 0);
+    if (ret != cudaSuccess && ret != cudaErrorPeerAccessAlreadyEnabled) {
+      LOG(WARNING) << "Failed to enable the peer access from GPU " << device
+                   << " to GPU " << peer << ": " << cudaGetErrorString(ret);
+      access = 0;
+    }
+    // The error of the peer access enabled already is cleared too.
+    cudaGetLastError();
+  }
+  can_access.emplace(std::make_pair(device, peer), access != 0);
+  return access != 0;
+#else
+  return false;
+#endif
+}
+
+void BatchedMemcpyAsync(const phi::GPUPlace& place,
+                        gpuStream_t stream,
+                        const std::vector<void*>& dsts,
+                        const std::vector<const void*>& srcs,
+                        const std::vector<size_t>& sizes) {
+  PADDLE_ENFORCE_EQ(
+      dsts.size() == srcs.size() && dsts.size() == sizes.size(),
+      true,
+      phi::errors::InvalidArgument(
+          "The numbers of the dsts, srcs and sizes of the batched copies "
+          "should be the same, but got %d, %d and %d.",
+          dsts.size(),
+          srcs.size(),
+          sizes.size()));
+  const int device = place.GetDeviceId();
+  backends::gpu::GPUDeviceGuard guard(device);
+#ifdef PADDLE_WITH_CUDA
+  std::vector<CopyItem> items;
+  std::vector<size_t> engine_copies;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    if (sizes[i] == 0) {
+      continue;
+    }
+    if (sizes[i] <= kBatchedMemcpyMaxKernelBytes) {
+      const int dst_device = DeviceOfPointer(dsts[i]);
+      const int src_device = DeviceOfPointer(srcs[i]);
+      if (dst_device >= 0 && src_device >= 0 &&
+          CanAccessPeer(device, dst_device) &&
+          CanAccessPeer(device, src_device)) {
+        items.push_back({static_cast<char*>(dsts[i]),
+                         static_cast<const char*>(srcs[i]),
+                         sizes[i]});
+        continue;
+      }
+    }
+    engine_copies.push_back(i);
+  }
+  // A single copy is not worth the launch of a kernel and its pointers.
+  if (items.size() == 1) {
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(
+        items[0].dst, items[0].src, items[0].size, cudaMemcpyDefault, stream));
+  } else if (items.size() > 1) {
+    const int num_items = static_cast<int>(items.size());
+    auto items_holder = phi::memory_utils::Alloc(
+        place,
+        num_items * sizeof(CopyItem),
+        phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
+    auto* restored = phi::backends::gpu::RestoreHostMemIfCapturingCUDAGraph(
+        items.data(), items.size());
+    phi::memory_utils::Copy(place,
+                            items_holder->ptr(),
+                            phi::CPUPlace(),
+                            restored,
+                            num_items * sizeof(CopyItem),
+                            stream);
+    BatchedMemcpyKernel<<<std::min(num_items, kMaxCopyBlocks),
+                          kCopyBlockSize,
+                          0,
+                          stream>>>(
+        static_cast<const CopyItem*>(items_holder->ptr()), num_items);
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaGetLastError());
+  }
+  VLOG(6) << "Batched " << items.size() << " copies into a kernel, and "
+          << engine_copies.size() << " copies by the copy engines on GPU "
+          << device;
+  for (size_t i : engine_copies) {
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaMemcpyAsync(dsts[i], srcs[i], sizes[i], cudaMemcpyDefault, stream));
+  }
+#else
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    if (sizes[i] > 0) {
+      PADDLE_ENFORCE_GPU_SUCCESS(hipMemcpyAsync(
+          dsts[i], srcs[i], sizes[i], hipMemcpyDefault, stream));
+    }
+  }
+#endif
+}
+
+}  // namespace funcs
+}  // namespace phi
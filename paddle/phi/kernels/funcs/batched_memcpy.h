@@ -0,0 +1,45 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+#include "paddle/phi/backends/gpu/gpu_decls.h"
+#include "paddle/phi/common/place.h"
+
+namespace phi {
+namespace funcs {
+
+// The copies of more bytes than it are done by the copy engines, which a
+// kernel is not faster than.
+constexpr size_t kBatchedMemcpyMaxKernelBytes = 256 << 10;
+
+// Whether the kernels on device can access the memory of peer, mapping the
+// memory of peer by P2P at the first query.
+bool CanAccessPeer(int device, int peer);
+
+// Copies sizes[i] bytes from srcs[i] to dsts[i] on the stream of place. The
+// small copies between the memories that the device of place can access, its
+// own and those of its P2P peers, are done by one kernel over the lists of
+// the pointers. The other copies, such as those of the host memory, are done
+// by the copy engines one by one.
+void BatchedMemcpyAsync(const phi::GPUPlace& place,
+                        gpuStream_t stream,
+                        const std::vector<void*>& dsts,
+                        const std::vector<const void*>& srcs,
+                        const std::vector<size_t>& sizes);
+
+}  // namespace funcs
+}  // namespace phi
@@ -15,15 +15,26 @@ limitations under the License. */
 #pragma once
 
 #include <sstream>
+#include <utility>
 #include "paddle/phi/kernels/funcs/elementwise_base.h"
 
 #if defined(__NVCC__) || defined(__HIPCC__) || defined(__xpu__)
 #include "paddle/phi/kernels/funcs/dims_simplifier.h"
+#include "paddle/phi/kernels/funcs/rank_dispatch.h"
 
 namespace kps = phi::kps;
 
 #endif
 
+#if defined(__NVCC__) || defined(__HIPCC__)
+#include <typeinfo>
+
+#include "paddle/phi/core/flags.h"
+#include "paddle/phi/kernels/autotune/auto_tune_base.h"
+
+PHI_DECLARE_bool(use_autotune);
+#endif
+
 namespace phi {
 namespace funcs {
 
@@ -287,7 +298,8 @@ template <typename OutT,
           int NumOuts,
           int VecSize,
           bool IsBoundary,
-          int LoadType>
+          int LoadType,
+          int Rank = phi::DDim::kMaxRank>
 __device__ void VectorizedBroadcastKernelImpl(
     const Array<const _ptr_ char *__restrict__, Arity> &ins,
     Array<_ptr_ OutT *, NumOuts> outs,
@@ -316,8 +328,8 @@ __device__ void VectorizedBroadcastKernelImpl(
       uint32_t idx = thread_offset + k;
       if (IsBoundary && idx == numel) break;
 #pragma unroll
-      for (int i = 0; i < phi::DDim::kMaxRank; ++i) {
-        if (i == configs[0].rank) break;
+      for (int i = 0; i < Rank; ++i) {
+        if (Rank == phi::DDim::kMaxRank && i == configs[0].rank) break;
         auto fast_divmoder = configs[0].divmoders[i].Divmod(idx);
         idx = fast_divmoder.val[0];
 #pragma unroll
@@ -347,7 +359,8 @@ template <typename Functor,
           int Arity,
           int NumOuts,
           int VecSize,
-          int LoadType>
+          int LoadType,
+          int Rank = phi::DDim::kMaxRank>
 __global__ void VectorizedBroadcastKernel(
     Array<const _ptr_ char *__restrict__, Arity> ins,
     Array<_ptr_ OutT *, NumOuts> outs,
@@ -405,12 +418,13 @@ __global__ void VectorizedBroadcastKernel(
                                   NumOuts,
                                   VecSize,
                                   false,
-                                  LoadType>(ins,
-                                            outs,
-                                            use_broadcast,
-                                            numel,
-                                            configs,
-                                            BLOCK_NUM_X * VecSize,
+                                  LoadType,
+                                  Rank>(ins,
+                                        outs,
+                                        use_broadcast,
+                                        numel,
+                                        configs,
+                                        BLOCK_NUM_X * VecSize,
                                             block_offset,
                                             read_lens,
                                             func);
@@ -421,12 +435,13 @@ __global__ void VectorizedBroadcastKernel(
                                   NumOuts,
                                   VecSize,
                                   true,
-                                  LoadType>(ins,
-                                            outs,
-                                            use_broadcast,
-                                            numel,
-                                            configs,
-                                            tail_tid,
+                                  LoadType,
+                                  Rank>(ins,
+                                        outs,
+                                        use_broadcast,
+                                        numel,
+                                        configs,
+                                        tail_tid,
                                             block_offset,
                                             read_lens,
                                             func);
@@ -434,37 +449,16 @@ __global__ void VectorizedBroadcastKernel(
 #endif
 }
 
+#ifndef PADDLE_WITH_XPU_KP
 template <typename OutT, typename Functor, int Arity, int NumOuts, int VecSize>
-void LaunchBroadcastKernel(
+void LaunchBroadcastKernelImpl(
     const KPDevice &ctx,
     const BroadcastTypeClassifier<OutT, Functor, Arity, NumOuts> &classifier,
-    Functor func) {
-#ifdef PADDLE_WITH_XPU_KP
-  int numel = classifier.numel;
-  const int threads = 64;
-  const int blocks = 8;
-  int read_lens = configs[0].buf_len;
-  auto stream = ctx.x_context()->xpu_stream;
-  int main_offset = (numel / (read_lens * threads)) * read_lens * threads;
-  int tail_tid = numel % (read_lens * threads);
-
-  VectorizedBroadcastKernel<Functor, OutT, Arity, NumOuts, VecSize, false>
-      <<<blocks, threads, 0, stream>>>(classifier.ins_data,
-                                       classifier.outs_data,
-                                       classifier.use_broadcast,
-                                       numel,
-                                       classifier.configs,
-                                       main_offset,
-                                       tail_tid,
-                                       read_lens,
-                                       func);
-#else
+    Functor func,
+    int threads,
+    int64_t blocks) {
   const auto &numel = classifier.numel;
-  auto gpu_config =
-      phi::backends::gpu::GetGpuLaunchConfig1D(ctx, numel, VecSize);
   auto stream = ctx.stream();
-  auto threads = gpu_config.GetBlockSize();
-  auto blocks = gpu_config.block_per_grid;
   int main_offset = (numel / (VecSize * threads)) * VecSize * threads;
   int tail_tid = numel % (VecSize * threads);
 
@@ -485,17 +479,38 @@ void LaunchBroadcastKernel(
                                          VecSize,
                                          func);
   } else if (classifier.broadcast_num > (Arity >> 1)) {
-    constexpr BroadcastType type_ = (Arity > 1) ? kBroadcast : kMixed;
-    VectorizedBroadcastKernel<Functor, OutT, Arity, NumOuts, VecSize, type_>
-        <<<blocks, threads, 0, stream>>>(classifier.ins_data,
-                                         classifier.outs_data,
-                                         classifier.use_broadcast,
-                                         numel,
-                                         classifier.configs,
-                                         main_offset,
-                                         tail_tid,
-                                         VecSize,
-                                         func);
+    if constexpr (Arity > 1) {
+      // All the indices are calculated by the merged dims, unrolled by rank.
+      DispatchRank(classifier.configs[0].rank, [&](auto rank) {
+        VectorizedBroadcastKernel<Functor,
+                                  OutT,
+                                  Arity,
+                                  NumOuts,
+                                  VecSize,
+                                  kBroadcast,
+                                  decltype(rank)::value>
+            <<<blocks, threads, 0, stream>>>(classifier.ins_data,
+                                             classifier.outs_data,
+                                             classifier.use_broadcast,
+                                             numel,
+                                             classifier.configs,
+                                             main_offset,
+                                             tail_tid,
+                                             VecSize,
+                                             func);
+      });
+    } else {
+      VectorizedBroadcastKernel<Functor, OutT, Arity, NumOuts, VecSize, kMixed>
+          <<<blocks, threads, 0, stream>>>(classifier.ins_data,
+                                           classifier.outs_data,
+                                           classifier.use_broadcast,
+                                           numel,
+                                           classifier.configs,
+                                           main_offset,
+                                           tail_tid,
+                                           VecSize,
+                                           func);
+    }
   } else {
     VectorizedBroadcastKernel<Functor, OutT, Arity, NumOuts, VecSize, kMixed>
         <<<blocks, threads, 0, stream>>>(classifier.ins_data,
@@ -508,9 +523,192 @@ void LaunchBroadcastKernel(
                                          VecSize,
                                          func);
   }
+}
+#endif
+
+template <typename OutT, typename Functor, int Arity, int NumOuts, int VecSize>
+void LaunchBroadcastKernel(
+    const KPDevice &ctx,
+    const BroadcastTypeClassifier<OutT, Functor, Arity, NumOuts> &classifier,
+    Functor func) {
+#ifdef PADDLE_WITH_XPU_KP
+  int numel = classifier.numel;
+  const int threads = 64;
+  const int blocks = 8;
+  int read_lens = configs[0].buf_len;
+  auto stream = ctx.x_context()->xpu_stream;
+  int main_offset = (numel / (read_lens * threads)) * read_lens * threads;
+  int tail_tid = numel % (read_lens * threads);
+
+  VectorizedBroadcastKernel<Functor, OutT, Arity, NumOuts, VecSize, false>
+      <<<blocks, threads, 0, stream>>>(classifier.ins_data,
+                                       classifier.outs_data,
+                                       classifier.use_broadcast,
+                                       numel,
+                                       classifier.configs,
+                                       main_offset,
+                                       tail_tid,
+                                       read_lens,
+                                       func);
+#else
+  auto gpu_config = phi::backends::gpu::GetGpuLaunchConfig1D(
+      ctx, classifier.numel, VecSize);
+  LaunchBroadcastKernelImpl<OutT, Functor, Arity, NumOuts, VecSize>(
+      ctx,
+      classifier,
+      func,
+      gpu_config.GetBlockSize(),
+      gpu_config.block_per_grid);
 #endif
 }
 
+template <typename OutT, typename Functor, int Arity, int NumOuts>
+void LaunchBroadcastKernelWithVecSize(
+    const KPDevice &ctx,
+    const BroadcastTypeClassifier<OutT, Functor, Arity, NumOuts> &classifier,
+    int vec_size,
+    Functor func) {
+  switch (vec_size) {
+    case VecSizeL: {
+      LaunchBroadcastKernel<OutT, Functor, Arity, NumOuts, VecSizeL>(
+          ctx, classifier, func);
+      break;
+    }
+    case VecSizeM: {
+      LaunchBroadcastKernel<OutT, Functor, Arity, NumOuts, VecSizeM>(
+          ctx, classifier, func);
+      break;
+    }
+    case VecSizeS: {
+      LaunchBroadcastKernel<OutT, Functor, Arity, NumOuts, VecSizeS>(
+          ctx, classifier, func);
+      break;
+    }
+    default: {
+      PADDLE_THROW(phi::errors::Unimplemented(
+          "Unsupported vectorized size: %d!", vec_size));
+      break;
+    }
+  }
+}
+
+#ifndef PADDLE_WITH_XPU_KP
+// The launch variants tuned against LaunchBroadcastKernelWithVecSize, they
+// take its arguments and ignore the max vec_size, which is checked before
+// they run.
+template <typename OutT,
+          typename Functor,
+          int Arity,
+          int NumOuts,
+          int VecSize,
+          int BlockSize>
+void LaunchBroadcastKernelWithBlockSize(
+    const KPDevice &ctx,
+    const BroadcastTypeClassifier<OutT, Functor, Arity, NumOuts> &classifier,
+    int vec_size,
+    Functor func) {
+  int64_t blocks = phi::backends::gpu::DivUp<int64_t>(
+      phi::backends::gpu::DivUp<int64_t>(classifier.numel, VecSize),
+      BlockSize);
+  LaunchBroadcastKernelImpl<OutT, Functor, Arity, NumOuts, VecSize>(
+      ctx, classifier, func, BlockSize, blocks);
+}
+
+// The block sizes of the variants of every vectorized size, which are added
+// in this order after the default launch.
+using BroadcastTuneBlockSizes = std::integer_sequence<int, 64, 128, 256, 512>;
+constexpr int kBroadcastTuneBlockSizes[] = {64, 128, 256, 512};
+constexpr int kBroadcastTuneVecSizes[] = {VecSizeL, VecSizeM, VecSizeS};
+
+template <typename OutT,
+          typename Functor,
+          int Arity,
+          int NumOuts,
+          int VecSize,
+          typename TunerT,
+          int... BlockSizes>
+void AddBroadcastLaunches(TunerT *tuner,
+                          std::integer_sequence<int, BlockSizes...>) {
+  (tuner->AddCallBack(LaunchBroadcastKernelWithBlockSize<OutT,
+                                                         Functor,
+                                                         Arity,
+                                                         NumOuts,
+                                                         VecSize,
+                                                         BlockSizes>),
+   ...);
+}
+
+// The timing runs write the outputs repeatedly, which is wrong if an output
+// is also an input.
+template <typename OutT, typename Functor, int Arity, int NumOuts>
+bool IsInplaceBroadcast(
+    const BroadcastTypeClassifier<OutT, Functor, Arity, NumOuts> &classifier) {
+  for (int i = 0; i < NumOuts; ++i) {
+    for (int j = 0; j < Arity; ++j) {
+      if (reinterpret_cast<const void *>(classifier.outs_data[i]) ==
+          reinterpret_cast<const void *>(classifier.ins_data[j])) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Picks the fastest of the default launch and the launches of every
+// vectorized size up to vec_size and every block size of
+// kBroadcastTuneBlockSizes, the vectorized kernels are the ones the default
+// launch instantiates already.
+template <typename OutT, typename Functor, int Arity, int NumOuts>
+void TuneBroadcastKernel(
+    const KPDevice &ctx,
+    const std::vector<const DenseTensor *> &ins,
+    std::vector<DenseTensor *> *outs,
+    int axis,
+    const BroadcastTypeClassifier<OutT, Functor, Arity, NumOuts> &classifier,
+    int vec_size,
+    Functor func) {
+  auto *tuner = phi::autotune::MakeBroadcastTuner<OutT>(
+      LaunchBroadcastKernelWithVecSize<OutT, Functor, Arity, NumOuts>);
+  AddBroadcastLaunches<OutT, Functor, Arity, NumOuts, VecSizeL>(
+      tuner, BroadcastTuneBlockSizes());
+  AddBroadcastLaunches<OutT, Functor, Arity, NumOuts, VecSizeM>(
+      tuner, BroadcastTuneBlockSizes());
+  AddBroadcastLaunches<OutT, Functor, Arity, NumOuts, VecSizeS>(
+      tuner, BroadcastTuneBlockSizes());
+
+  size_t key = phi::autotune::GenKey(common::vectorize((*outs)[0]->dims()),
+                                     axis,
+                                     vec_size,
+                                     sizeof(OutT),
+                                     Arity,
+                                     NumOuts,
+                                     typeid(Functor).hash_code());
+  for (auto *in : ins) {
+    key = phi::autotune::GenKey(key, common::vectorize(in->dims()));
+  }
+  const int64_t max_blocks = ctx.GetCUDAMaxGridDimSize()[0];
+  const int64_t numel = classifier.numel;
+  auto is_valid = [vec_size, max_blocks, numel](size_t idx) {
+    constexpr size_t kNumBlockSizes = BroadcastTuneBlockSizes::size();
+    const int variant_vec_size =
+        kBroadcastTuneVecSizes[(idx - 1) / kNumBlockSizes];
+    const int block_size = kBroadcastTuneBlockSizes[(idx - 1) % kNumBlockSizes];
+    return variant_vec_size <= vec_size &&
+           phi::backends::gpu::DivUp<int64_t>(numel,
+                                              variant_vec_size * block_size) <=
+               max_blocks;
+  };
+  tuner->RunVariants(ctx,
+                     phi::autotune::AlgorithmType::kBroadcast,
+                     key,
+                     is_valid,
+                     ctx,
+                     classifier,
+                     vec_size,
+                     func);
+}
+#endif
+
 template <typename OutT, typename Functor, int Arity, int NumOuts = 1>
 typename std::enable_if<!NeedVectorized<OutT>::value, void>::type
 BroadcastKernelForDifferentVecSize(const KPDevice &ctx,
@@ -542,28 +740,13 @@ BroadcastKernelForDifferentVecSize(const KPDevice &ctx,
 
   auto classifier =
       BroadcastTypeClassifier<OutT, Functor, Arity, NumOuts>(ins, outs, axis);
-  switch (vec_size) {
-    case VecSizeL: {
-      LaunchBroadcastKernel<OutT, Functor, Arity, NumOuts, VecSizeL>(
-          ctx, classifier, func);
-      break;
-    }
-    case VecSizeM: {
-      LaunchBroadcastKernel<OutT, Functor, Arity, NumOuts, VecSizeM>(
-          ctx, classifier, func);
-      break;
-    }
-    case VecSizeS: {
-      LaunchBroadcastKernel<OutT, Functor, Arity, NumOuts, VecSizeS>(
-          ctx, classifier, func);
-      break;
-    }
-    default: {
-      PADDLE_THROW(phi::errors::Unimplemented(
-          "Unsupported vectorized size: %d!", vec_size));
-      break;
-    }
+#ifndef PADDLE_WITH_XPU_KP
+  if (FLAGS_use_autotune && !IsInplaceBroadcast(classifier)) {
+    TuneBroadcastKernel(ctx, ins, outs, axis, classifier, vec_size, func);
+    return;
   }
+#endif
+  LaunchBroadcastKernelWithVecSize(ctx, classifier, vec_size, func);
 }
 
 static void updateStridesDims(std::vector<int64_t> *strides,
@@ -819,6 +1002,13 @@ void BroadcastKernel(const KPDevice &ctx,
     max_rank = std::max(max_rank, (*outs)[0]->dims().size());
   }
   axis = axis == -1 ? max_rank - min_rank : axis;
+#ifndef PADDLE_WITH_XPU_KP
+  if (NeedStridedElementwise(ins, *(*outs)[0])) {
+    LaunchStridedElementwiseKernel<OutT, Functor, kArity, NumOuts>(
+        ctx, ins, outs, axis, func);
+    return;
+  }
+#endif
   BroadcastKernelApply<OutT, Functor, kArity, NumOuts>(
       ctx, ins, outs, axis, func);
 }
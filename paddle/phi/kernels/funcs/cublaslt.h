@@ -18,7 +18,11 @@ limitations under the License. */
 #include <string>
 #include <unordered_map>
 #include "paddle/phi/backends/dynload/cublasLt.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+#include "paddle/phi/common/float8_e4m3fn.h"
 #include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
 
 namespace dyl = phi::dynload;
 
@@ -227,4 +231,159 @@ class CublasLtHelper {
   size_t workspace_size_ = 0;
 };
 
+#if CUDA_VERSION >= 11080
+template <typename T>
+struct CublasLtFp8OutType;
+
+template <>
+struct CublasLtFp8OutType<phi::dtype::float16> {
+  static constexpr cudaDataType_t value = CUDA_R_16F;
+};
+
+template <>
+struct CublasLtFp8OutType<phi::dtype::bfloat16> {
+  static constexpr cudaDataType_t value = CUDA_R_16BF;
+};
+
+// The FP8 GEMM of the tensor cores of sm89 and later,
+// out[m, n] = x_scale * y_scale * x[m, k] * y[n, k]^T + bias[n], where x and y
+// are E4M3 and the scales are the device pointers dequantizing them. The FP8
+// GEMM of cublasLt only takes the TN layout, so y is transposed like the
+// weights of CublasLtHelper. k and n should be multiples of 16.
+template <typename T>
+class CublasLtFp8Helper {
+ public:
+  CublasLtFp8Helper(int m, int k, int n, bool has_bias, cublasLtHandle_t handle)
+      : handle_(handle), has_bias_(has_bias) {
+    PADDLE_ENFORCE_GPU_SUCCESS(dyl::cublasLtMatmulDescCreate(
+        &matmul_desc_, CUBLAS_COMPUTE_32F, CUDA_R_32F));
+    cublasOperation_t op_transpose = CUBLAS_OP_T;
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        dyl::cublasLtMatmulDescSetAttribute(matmul_desc_,
+                                            CUBLASLT_MATMUL_DESC_TRANSA,
+                                            &op_transpose,
+                                            sizeof(op_transpose)));
+    // the forward GEMMs do not lose accuracy by accumulating in the tensor
+    // cores
+    int8_t fast_accum = 1;
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        dyl::cublasLtMatmulDescSetAttribute(matmul_desc_,
+                                            CUBLASLT_MATMUL_DESC_FAST_ACCUM,
+                                            &fast_accum,
+                                            sizeof(fast_accum)));
+    if (has_bias_) {
+      cublasLtEpilogue_t epilogue = CUBLASLT_EPILOGUE_BIAS;
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          dyl::cublasLtMatmulDescSetAttribute(matmul_desc_,
+                                              CUBLASLT_MATMUL_DESC_EPILOGUE,
+                                              &epilogue,
+                                              sizeof(epilogue)));
+    }
+
+    cudaDataType_t out_type = CublasLtFp8OutType<T>::value;
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        dyl::cublasLtMatrixLayoutCreate(&A_desc_, CUDA_R_8F_E4M3, k, n, k));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        dyl::cublasLtMatrixLayoutCreate(&B_desc_, CUDA_R_8F_E4M3, k, m, k));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        dyl::cublasLtMatrixLayoutCreate(&C_desc_, out_type, n, m, n));
+  }
+
+  ~CublasLtFp8Helper() {
+    dyl::cublasLtMatrixLayoutDestroy(C_desc_);
+    dyl::cublasLtMatrixLayoutDestroy(B_desc_);
+    dyl::cublasLtMatrixLayoutDestroy(A_desc_);
+    dyl::cublasLtMatmulDescDestroy(matmul_desc_);
+  }
+
+  CublasLtFp8Helper(const CublasLtFp8Helper&) = delete;
+  CublasLtFp8Helper& operator=(const CublasLtFp8Helper&) = delete;
+
+  void GEMM(const phi::dtype::float8_e4m3fn* x,
+            const phi::dtype::float8_e4m3fn* y,
+            const T* bias,
+            const float* x_scale,
+            const float* y_scale,
+            T* out,
+            void* workspace,
+            size_t workspace_size,
+            cudaStream_t stream) {
+    // A is y and B is x in the column major layout of cublasLt
+    PADDLE_ENFORCE_GPU_SUCCESS(dyl::cublasLtMatmulDescSetAttribute(
+        matmul_desc_,
+        CUBLASLT_MATMUL_DESC_A_SCALE_POINTER,
+        &y_scale,
+        sizeof(y_scale)));
+    PADDLE_ENFORCE_GPU_SUCCESS(dyl::cublasLtMatmulDescSetAttribute(
+        matmul_desc_,
+        CUBLASLT_MATMUL_DESC_B_SCALE_POINTER,
+        &x_scale,
+        sizeof(x_scale)));
+    if (has_bias_) {
+      PADDLE_ENFORCE_GPU_SUCCESS(dyl::cublasLtMatmulDescSetAttribute(
+          matmul_desc_,
+          CUBLASLT_MATMUL_DESC_BIAS_POINTER,
+          &bias,
+          sizeof(bias)));
+    }
+
+    cublasLtMatmulPreference_t preference;
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        dyl::cublasLtMatmulPreferenceCreate(&preference));
+    PADDLE_ENFORCE_GPU_SUCCESS(dyl::cublasLtMatmulPreferenceSetAttribute(
+        preference,
+        CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES,
+        &workspace_size,
+        sizeof(workspace_size)));
+    int returned_results = 0;
+    cublasLtMatmulHeuristicResult_t heuristic_result;
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        dyl::cublasLtMatmulAlgoGetHeuristic(handle_,
+                                            matmul_desc_,
+                                            A_desc_,
+                                            B_desc_,
+                                            C_desc_,
+                                            C_desc_,
+                                            preference,
+                                            1,
+                                            &heuristic_result,
+                                            &returned_results));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        dyl::cublasLtMatmulPreferenceDestroy(preference));
+    PADDLE_ENFORCE_GT(
+        returned_results,
+        0,
+        phi::errors::Unavailable("No cublasLt algorithm supports the FP8 GEMM "
+                                 "of this shape on the device."));
+
+    float alpha = 1.0f;
+    float beta = 0.0f;
+    PADDLE_ENFORCE_GPU_SUCCESS(dyl::cublasLtMatmul(handle_,
+                                                   matmul_desc_,
+                                                   &alpha,
+                                                   y,
+                                                   A_desc_,
+                                                   x,
+                                                   B_desc_,
+                                                   &beta,
+                                                   out,
+                                                   C_desc_,
+                                                   out,
+                                                   C_desc_,
+                                                   &heuristic_result.algo,
+                                                   workspace,
+                                                   workspace_size,
+                                                   stream));
+  }
+
+ private:
+  cublasLtHandle_t handle_;
+  bool has_bias_;
+  cublasLtMatmulDesc_t matmul_desc_;
+  cublasLtMatrixLayout_t A_desc_;
+  cublasLtMatrixLayout_t B_desc_;
+  cublasLtMatrixLayout_t C_desc_;
+};
+#endif
+
 }  // namespace phi
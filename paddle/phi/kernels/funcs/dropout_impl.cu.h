@@ -370,9 +370,18 @@ void DropoutFwGPUKernelDriver(
       const phi::GPUContext* dev_ctx_p = &dev_ctx;
       auto gen_cuda = dev_ctx.GetGenerator();
       auto state_index = gen_cuda->GetStateIndex();
+      // The replays draw from the sub-stream of the op as well, if it is
+      // captured in one.
+      uint64_t stream_id = 0;
+      bool use_sub_stream = phi::Generator::GetActiveSubStream(&stream_id);
 
       phi::backends::gpu::CUDAGraphNodeLauncher::parameterSetter_t
-          parameterSetter = [offset, dev_ctx_p, state_index, is_fix_seed](
+          parameterSetter = [offset,
+                             dev_ctx_p,
+                             state_index,
+                             is_fix_seed,
+                             use_sub_stream,
+                             stream_id](
                                 phi::backends::gpu::CUDAKernelParams& params) {
             if (!is_fix_seed) {
               // we assume seed is null pointer
@@ -384,7 +393,12 @@ void DropoutFwGPUKernelDriver(
               gen_cuda->SetStateIndex(state_index);
 
               uint64_t seed, increment;
-              std::tie(seed, increment) = gen_cuda->IncrementOffset(offset);
+              if (use_sub_stream) {
+                phi::Generator::SubStreamGuard guard(stream_id);
+                std::tie(seed, increment) = gen_cuda->IncrementOffset(offset);
+              } else {
+                std::tie(seed, increment) = gen_cuda->IncrementOffset(offset);
+              }
 
               params.As<uint64_t>(2) = seed;
               params.As<uint64_t>(8) = increment;
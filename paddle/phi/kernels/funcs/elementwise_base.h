@@ -26,6 +26,8 @@ limitations under the License. */
 #include "paddle/phi/backends/gpu/gpu_launch_config.h"
 #include "paddle/phi/kernels/funcs/aligned_vector.h"
 #include "paddle/phi/kernels/funcs/function_traits.h"
+#include "paddle/phi/kernels/funcs/index_calculator.h"
+#include "paddle/phi/kernels/funcs/rank_dispatch.h"
 #include "paddle/phi/kernels/primitive/kernel_primitives.h"
 
 #define HOSTDEVICE __host__ __device__
@@ -763,6 +765,137 @@ void LaunchElementwiseKernel(const KPDevice &ctx,
 #endif
 }
 
+#ifndef PADDLE_WITH_XPU_KP
+template <int Index>
+struct StridedLoader {
+  template <typename Array, typename OffsetT, typename ArgsT>
+  static __device__ __forceinline__ void Apply(const Array &in,
+                                               const OffsetT &offsets,
+                                               ArgsT *args) {
+    using Type = std::tuple_element_t<Index, ArgsT>;
+    std::get<Index>(*args) =
+        reinterpret_cast<const Type *>(in[Index])[offsets[Index]];
+  }
+};
+
+template <typename OutT, typename Functor, int Arity, int NumOuts, int Rank>
+__global__ void StridedElementwiseKernel(
+    Array<const _ptr_ char *__restrict__, Arity> ins,
+    Array<_ptr_ OutT *, NumOuts> outs,
+    uint32_t numel,
+    StridedIndexCalculator<Arity, Rank> calculator,
+    Functor func) {
+  using Traits = phi::funcs::FunctionTraits<Functor>;
+  using ArgsT = typename Traits::ArgsTuple;
+  uint32_t stride = blockDim.x * gridDim.x;
+  for (uint32_t i = blockIdx.x * blockDim.x + threadIdx.x; i < numel;
+       i += stride) {
+    auto offsets = calculator(i);
+    ArgsT args;
+    UnrollerWithoutVecSize<StridedLoader, Arity>::step(ins, offsets, &args);
+    ConditionalT<OutT, NumOuts> result =
+        static_cast<ConditionalT<OutT, NumOuts>>(Apply(func, args));
+    if constexpr (NumOuts == 1) {
+      outs[0][i] = result;
+    } else {
+#pragma unroll
+      for (int j = 0; j < NumOuts; ++j) {
+        outs[j][i] = result[j];
+      }
+    }
+  }
+}
+
+template <typename OutT, typename Functor, int Arity, int NumOuts, int Rank>
+void LaunchStridedElementwiseKernelWithRank(
+    const KPDevice &ctx,
+    const Array<const _ptr_ char *__restrict__, Arity> &ins_data,
+    const Array<_ptr_ OutT *, NumOuts> &outs_data,
+    int64_t numel,
+    const std::vector<int64_t> &dims,
+    const std::vector<std::vector<int64_t>> &strides,
+    Functor func) {
+  StridedIndexCalculator<Arity, Rank> calculator(dims, strides);
+  auto gpu_config = phi::backends::gpu::GetGpuLaunchConfig1D(ctx, numel);
+  StridedElementwiseKernel<OutT, Functor, Arity, NumOuts, Rank>
+      <<<gpu_config.block_per_grid,
+         gpu_config.thread_per_block,
+         0,
+         ctx.stream()>>>(ins_data,
+                         outs_data,
+                         static_cast<uint32_t>(numel),
+                         calculator,
+                         func);
+}
+
+// Whether the inputs should be read by their strides, instead of the
+// contiguous copies of them. The numel is bounded by the 32-bit index of
+// StridedIndexCalculator.
+static inline bool NeedStridedElementwise(
+    const std::vector<const DenseTensor *> &ins, const DenseTensor &out) {
+  if (out.numel() == 0 ||
+      out.numel() > std::numeric_limits<int32_t>::max()) {
+    return false;
+  }
+  for (auto *in : ins) {
+    if (!in->meta().is_contiguous()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Launches the elementwise kernel on the strided inputs and the contiguous
+// outputs. An input of a lower rank is aligned to the dims of the outputs
+// from axis, and the dims of 1 of an input are broadcast, so this also
+// serves the broadcast kernels.
+template <typename OutT, typename Functor, int Arity, int NumOuts>
+void LaunchStridedElementwiseKernel(const KPDevice &ctx,
+                                    const std::vector<const DenseTensor *> &ins,
+                                    std::vector<DenseTensor *> *outs,
+                                    int axis,
+                                    Functor func) {
+  std::vector<int64_t> dims = common::vectorize<int64_t>((*outs)[0]->dims());
+  const int rank = static_cast<int>(dims.size());
+  std::vector<std::vector<int64_t>> strides(ins.size());
+  for (size_t j = 0; j < ins.size(); ++j) {
+    const auto &in_dims = ins[j]->dims();
+    const auto &in_strides = ins[j]->strides();
+    int in_axis = in_dims.size() == rank
+                      ? 0
+                      : std::min(axis < 0 ? rank - in_dims.size() : axis,
+                                 rank - in_dims.size());
+    strides[j].resize(rank, 0);
+    for (int i = 0; i < in_dims.size(); ++i) {
+      if (in_dims[i] != 1 || dims[in_axis + i] == 1) {
+        strides[j][in_axis + i] = in_strides[i];
+      }
+    }
+  }
+  MergeStridedDims(&dims, &strides);
+
+  int64_t numel = (*outs)[0]->numel();
+  Array<const _ptr_ char *__restrict__, Arity> ins_data;
+  Array<_ptr_ OutT *, NumOuts> outs_data;
+  using Traits = phi::funcs::FunctionTraits<Functor>;
+  using ArgsT = typename Traits::ArgsTuple;
+  ArgsT arg;
+  UnrollerWithoutVecSize<InputSetter, Arity>::step(ins, arg, &ins_data);
+  for (int i = 0; i < outs->size(); ++i) {
+    outs_data[i] = (*outs)[i]->data<OutT>();
+  }
+
+  DispatchRank(static_cast<int>(dims.size()), [&](auto rank) {
+    LaunchStridedElementwiseKernelWithRank<OutT,
+                                           Functor,
+                                           Arity,
+                                           NumOuts,
+                                           decltype(rank)::value>(
+        ctx, ins_data, outs_data, numel, dims, strides, func);
+  });
+}
+#endif
+
 template <typename OutT, typename Functor, int Arity, int NumOuts = 1>
 typename std::enable_if<!NeedVectorized<OutT>::value, void>::type
 ElementwiseKernelForDifferentVecSize(
@@ -840,6 +973,19 @@ void ElementwiseKernel(const KPDevice &ctx,
     ctx.template Alloc<OutT>((*outs)[i]);
   }
 
+#ifndef PADDLE_WITH_XPU_KP
+  if constexpr (kArity > 0) {
+    bool same_dims = true;
+    for (auto *in : ins) {
+      same_dims = same_dims && in->dims() == (*outs)[0]->dims();
+    }
+    if (same_dims && NeedStridedElementwise(ins, *(*outs)[0])) {
+      LaunchStridedElementwiseKernel<OutT, Functor, kArity, NumOuts>(
+          ctx, ins, outs, 0, func);
+      return;
+    }
+  }
+#endif
   ElementwiseKernelForDifferentVecSize<OutT, Functor, kArity, NumOuts>(
       ctx, ins, outs, func);
 }
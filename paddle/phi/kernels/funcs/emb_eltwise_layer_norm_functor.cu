@@ -88,7 +88,8 @@ __global__ void EmbEltwiseLayernormKernel(int hidden,
                                           const int64_t* embs,
                                           T* output,
                                           T eps,
-                                          int input_num) {
+                                          int input_num,
+                                          const int* cu_seqlens) {
   cub::Sum pair_sum;
   // blockIdx.x: position in the sequence
   // blockIdx.y: batch
@@ -98,7 +99,14 @@ __global__ void EmbEltwiseLayernormKernel(int hidden,
   extern __shared__ int64_t array_id[];
 
   const T rhidden = T(1.f) / T(hidden);
-  const int64_t seq_pos = blockIdx.y + blockIdx.x * gridDim.y;
+  int64_t seq_pos = blockIdx.y + blockIdx.x * gridDim.y;
+  int64_t out_pos = seq_pos;
+  if (cu_seqlens != nullptr) {
+    const int begin = cu_seqlens[blockIdx.y];
+    if (blockIdx.x >= cu_seqlens[blockIdx.y + 1] - begin) return;
+    seq_pos = static_cast<int64_t>(blockIdx.y) * gridDim.x + blockIdx.x;
+    out_pos = begin + blockIdx.x;
+  }
   if (threadIdx.x == 0) {
     for (int i = 0; i < input_num; ++i) {
       const int64_t* ids_p = reinterpret_cast<const int64_t*>(ids[i]);
@@ -107,7 +115,7 @@ __global__ void EmbEltwiseLayernormKernel(int hidden,
   }
   __syncthreads();
 
-  const int64_t out_offset = seq_pos * hidden;
+  const int64_t out_offset = out_pos * hidden;
 
   phi::funcs::kvp<T> thread_data(0, 0);
 
@@ -136,7 +144,8 @@ __global__ void EmbEltwiseLayernormKernel<half, 256>(int hidden,
                                                      const int64_t* embs,
                                                      half* output,
                                                      half eps,
-                                                     int input_num) {
+                                                     int input_num,
+                                                     const int* cu_seqlens) {
 #if CUDA_ARCH_FP16_SUPPORTED(__CUDA_ARCH__)
   cub::Sum pair_sum;
   // blockIdx.x: position in the sequence
@@ -147,7 +156,14 @@ __global__ void EmbEltwiseLayernormKernel<half, 256>(int hidden,
   extern __shared__ int64_t array_id[];
 
   const half rhidden = half(1.f) / half(hidden);
-  const int64_t seq_pos = blockIdx.y + blockIdx.x * gridDim.y;
+  int64_t seq_pos = blockIdx.y + blockIdx.x * gridDim.y;
+  int64_t out_pos = seq_pos;
+  if (cu_seqlens != nullptr) {
+    const int begin = cu_seqlens[blockIdx.y];
+    if (blockIdx.x >= cu_seqlens[blockIdx.y + 1] - begin) return;
+    seq_pos = static_cast<int64_t>(blockIdx.y) * gridDim.x + blockIdx.x;
+    out_pos = begin + blockIdx.x;
+  }
   if (threadIdx.x == 0) {
     for (int i = 0; i < input_num; ++i) {
       const int64_t* ids_p = reinterpret_cast<const int64_t*>(ids[i]);
@@ -156,7 +172,7 @@ __global__ void EmbEltwiseLayernormKernel<half, 256>(int hidden,
   }
   __syncthreads();
 
-  const int64_t out_offset = seq_pos * hidden;
+  const int64_t out_offset = out_pos * hidden;
 
   phi::funcs::kvp<half> thread_data(0, 0);
 
@@ -189,13 +205,14 @@ void EmbEltwiseLayerNormFunctor<T>::operator()(int batch,
                                                T* output,
                                                float eps,
                                                int input_num,
-                                               gpuStream_t stream) {
+                                               gpuStream_t stream,
+                                               const int* cu_seqlens) {
   const unsigned tpb = 256;
   const dim3 grid(seq_len, batch, 1);
   const dim3 block(tpb, 1, 1);
   int shared_bytes = input_num * sizeof(int64_t);
   EmbEltwiseLayernormKernel<T, tpb><<<grid, block, shared_bytes, stream>>>(
-      hidden, ids, scale, bias, embs, output, eps, input_num);
+      hidden, ids, scale, bias, embs, output, eps, input_num, cu_seqlens);
 }
 
 template class EmbEltwiseLayerNormFunctor<float>;
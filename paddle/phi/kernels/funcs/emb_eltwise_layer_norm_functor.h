@@ -32,6 +32,9 @@ namespace funcs {
 //                     |
 //                elt_out_var
 //
+// If cu_seqlens of [batch + 1] is given, the ids are of [batch, seq_len] with
+// the paddings, and the output is of the tokens of the sequences packed, where
+// the tokens of the sequence i are in [cu_seqlens[i], cu_seqlens[i + 1]).
 template <typename T>
 class EmbEltwiseLayerNormFunctor {
  public:
@@ -45,7 +48,8 @@ class EmbEltwiseLayerNormFunctor {
                   T* output,
                   float eps,
                   int input_num,
-                  gpuStream_t stream);
+                  gpuStream_t stream,
+                  const int* cu_seqlens = nullptr);
 };
 }  // namespace funcs
 }  // namespace phi
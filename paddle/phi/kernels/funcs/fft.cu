@@ -19,12 +19,15 @@
 
 #include "paddle/common/ddim.h"
 #include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/flags.h"
 #include "paddle/phi/kernels/assign_kernel.h"
 #include "paddle/phi/kernels/complex_kernel.h"
 #include "paddle/phi/kernels/empty_kernel.h"
 #include "paddle/phi/kernels/scale_kernel.h"
 #include "paddle/phi/kernels/transpose_kernel.h"
 
+PHI_DECLARE_bool(fft_plan_split_batch);
+
 namespace phi {
 namespace funcs {
 namespace detail {
@@ -92,8 +95,11 @@ bool has_large_prime_factor(int64_t n) {
 #if defined(PADDLE_WITH_CUDA)
 inline bool use_cache(const int64_t* signal_size) {
   bool using_cache = true;
-  int cufft_version;
-  phi::dynload::cufftGetVersion(&cufft_version);
+  static const int cufft_version = [] {
+    int version = 0;
+    phi::dynload::cufftGetVersion(&version);
+    return version;
+  }();
   if (10300 <= cufft_version && cufft_version <= 10400) {
     using_cache = std::none_of(
         signal_size + 1, signal_size + kMaxDataNdim, [](int64_t dim_size) {
@@ -170,47 +176,95 @@ void exec_fft(const phi::GPUContext& ctx,
   FFTConfigKey key =
       create_fft_configkey(collapsed_input, collapsed_output, signal_ndim);
   int64_t device_id = ctx.GetPlace().GetDeviceId();
-  FFTConfig* config = nullptr;
   std::unique_ptr<FFTConfig> config_ = nullptr;
   bool using_cache = use_cache(key.sizes_);
 
+  // The plans of the pieces of the batch, with the batches of the pieces.
+  std::vector<std::pair<int64_t, FFTConfig*>> plans;
+  // The cached plans are locked until they are executed, so that the stream
+  // and the work area of a plan are not reset by the other streams between.
+  std::unique_lock<std::mutex> guard;
   if (using_cache) {
     FFTConfigCache& plan_cache = get_fft_plan_cache(device_id);
-    std::unique_lock<std::mutex> guard(plan_cache.mutex, std::defer_lock);
-    guard.lock();
-    config = &(plan_cache.lookup(key));
+    guard = std::unique_lock<std::mutex>(plan_cache.mutex);
+    // The pieces are at most 63 plans, which are kept in a cache of 64.
+    if (FLAGS_fft_plan_split_batch && (batch_size & (batch_size - 1)) != 0 &&
+        plan_cache.max_size() >= 64 && !plan_cache.contains(key)) {
+      for (int64_t rest = batch_size; rest > 0;) {
+        int64_t piece = 1;
+        while (piece <= rest / 2) {
+          piece *= 2;
+        }
+        FFTConfigKey piece_key = key;
+        piece_key.sizes_[0] = piece;
+        piece_key.input_shape_[0] = piece;
+        piece_key.output_shape_[0] = piece;
+        plans.emplace_back(piece, &(plan_cache.lookup(piece_key)));
+        rest -= piece;
+      }
+    } else {
+      plans.emplace_back(batch_size, &(plan_cache.lookup(key)));
+    }
   } else {
     config_ = std::make_unique<FFTConfig>(key);
-    config = config_.get();
+    plans.emplace_back(batch_size, config_.get());
   }
 
-  const int64_t workspace_size = static_cast<int64_t>(config->workspace_size());
+  // The pieces are executed in order on the stream and share a work area.
+  size_t max_workspace_size = 0;
+  for (auto& plan : plans) {
+    max_workspace_size =
+        std::max(max_workspace_size, plan.second->workspace_size());
+  }
+  const int64_t workspace_size = static_cast<int64_t>(max_workspace_size);
   DenseTensor workspace_tensor = Empty<uint8_t>(ctx, {workspace_size});
 
-  // prepare cufft for execution
+  const int64_t input_batch_bytes =
+      collapsed_input.numel() / std::max<int64_t>(batch_size, 1) *
+      phi::SizeOf(collapsed_input.dtype());
+  const int64_t output_batch_bytes =
+      collapsed_output.numel() / std::max<int64_t>(batch_size, 1) *
+      phi::SizeOf(collapsed_output.dtype());
+  auto exec_plans = [&](bool plan_forward) {
+    int64_t offset = 0;
+    for (auto& plan : plans) {
+      const FFTConfig& config = *plan.second;
+      // prepare cufft for execution
 #if defined(PADDLE_WITH_CUDA)
-  PADDLE_ENFORCE_GPU_SUCCESS(
-      phi::dynload::cufftSetStream(config->plan(), ctx.stream()));
-  PADDLE_ENFORCE_GPU_SUCCESS(
-      phi::dynload::cufftSetWorkArea(config->plan(), workspace_tensor.data()));
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          phi::dynload::cufftSetStream(config.plan(), ctx.stream()));
+      PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cufftSetWorkArea(
+          config.plan(), workspace_tensor.data()));
 #elif defined(PADDLE_WITH_HIP)
-  PADDLE_ENFORCE_GPU_SUCCESS(
-      phi::dynload::hipfftSetStream(config->plan(), ctx.stream()));
-  PADDLE_ENFORCE_GPU_SUCCESS(
-      phi::dynload::hipfftSetWorkArea(config->plan(), workspace_tensor.data()));
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          phi::dynload::hipfftSetStream(config.plan(), ctx.stream()));
+      PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::hipfftSetWorkArea(
+          config.plan(), workspace_tensor.data()));
 #endif
+      exec_plan(
+          config,
+          static_cast<uint8_t*>(collapsed_input.data()) +
+              offset * input_batch_bytes,
+          static_cast<uint8_t*>(collapsed_output.data()) +
+              offset * output_batch_bytes,
+          plan_forward);
+      offset += plan.first;
+    }
+  };
 
   // execution of fft plan
-  const FFTTransformType fft_type = config->transform_type();
+  const FFTTransformType fft_type = plans.front().second->transform_type();
   if (fft_type == FFTTransformType::C2R && forward) {
     ConjKernel<Ti, phi::GPUContext>(ctx, collapsed_input, &collapsed_input);
-    exec_plan(*config, collapsed_input.data(), collapsed_output.data(), false);
+    exec_plans(false);
   } else if (fft_type == FFTTransformType::R2C && !forward) {
-    exec_plan(*config, collapsed_input.data(), collapsed_output.data(), true);
+    exec_plans(true);
     ConjKernel<To, phi::GPUContext>(ctx, collapsed_output, &collapsed_output);
   } else {
-    exec_plan(
-        *config, collapsed_input.data(), collapsed_output.data(), forward);
+    exec_plans(forward);
+  }
+  if (guard.owns_lock()) {
+    guard.unlock();
   }
 
   // resize for the collapsed output
@@ -135,6 +135,10 @@ class FFTConfigCache {
     }
   }
 
+  bool contains(FFTConfigKey params) const {
+    return _cache_map.find(params) != _cache_map.end();
+  }
+
   size_t size() const { return _cache_map.size(); }
 
   size_t max_size() const noexcept { return _max_size; }
@@ -168,10 +172,10 @@ class FFTConfigCache {
   size_t _max_size;
 };
 
-static std::vector<std::unique_ptr<FFTConfigCache>> plan_caches;
-static std::mutex plan_caches_mutex;
-
-static inline FFTConfigCache& get_fft_plan_cache(int64_t device_index) {
+inline FFTConfigCache& get_fft_plan_cache(int64_t device_index) {
+  // The caches of the devices are shared by the translation units.
+  static std::vector<std::unique_ptr<FFTConfigCache>> plan_caches;
+  static std::mutex plan_caches_mutex;
   std::lock_guard<std::mutex> guard(plan_caches_mutex);
 
   if (device_index >= plan_caches.size()) {
@@ -23,6 +23,7 @@ limitations under the License. */
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/funcs/rank_dispatch.h"
 
 namespace phi {
 namespace funcs {
@@ -42,7 +43,9 @@ __global__ void GatherCUDAKernel(const T* params,
   }
 }
 
-template <typename T, typename IndexT = int>
+// EndSize is the last dim of the indices dispatched by DispatchRank, and
+// the indices of DDim::kMaxRank are of the runtime end_size.
+template <typename T, typename IndexT = int, int EndSize = DDim::kMaxRank>
 __global__ void GatherNdCUDAKernel(const T* input,
                                    const Dim<DDim::kMaxRank> input_dims,
                                    const IndexT* indices,
@@ -50,13 +53,18 @@ __global__ void GatherNdCUDAKernel(const T* input,
                                    size_t remain_size,
                                    size_t slice_size,
                                    size_t end_size) {
+  const int depth =
+      EndSize == DDim::kMaxRank ? static_cast<int>(end_size) : EndSize;
   CUDA_KERNEL_LOOP_TYPE(i, remain_size * slice_size, int64_t) {
     int64_t indices_i = i / slice_size;
     int64_t slice_i = i - indices_i * slice_size;  // offset inside the slice
     int64_t gather_i = 0;
     int64_t temp = slice_size;
-    for (int64_t j = end_size - 1; j >= 0; --j) {
-      auto index_value = indices[indices_i * end_size + j];
+#pragma unroll
+    for (int k = 0; k < EndSize; ++k) {
+      if (EndSize == DDim::kMaxRank && k == depth) break;
+      int j = depth - 1 - k;
+      auto index_value = indices[indices_i * depth + j];
       PADDLE_ENFORCE(
           index_value >= 0 && index_value < input_dims[j],
           "The index is out of bounds, "
@@ -153,13 +161,16 @@ void GPUGatherNd(const phi::GPUContext& ctx,
   dim3 grid = dim3((n + block - 1) / block);
   phi::backends::gpu::LimitGridDim(ctx, &grid);
 
-  GatherNdCUDAKernel<T, IndexT><<<grid, block, 0, ctx.stream()>>>(p_input,
-                                                                  g_input_dims,
-                                                                  p_index,
-                                                                  p_output,
-                                                                  remain_numel,
-                                                                  slice_size,
-                                                                  end_size);
+  DispatchRank(static_cast<int>(end_size), [&](auto rank) {
+    GatherNdCUDAKernel<T, IndexT, decltype(rank)::value>
+        <<<grid, block, 0, ctx.stream()>>>(p_input,
+                                           g_input_dims,
+                                           p_index,
+                                           p_output,
+                                           remain_numel,
+                                           slice_size,
+                                           end_size);
+  });
 }
 
 template <typename T, typename U>
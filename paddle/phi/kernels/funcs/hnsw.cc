@@ -0,0 +1,262 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "paddle/phi/kernels/funcs/hnsw.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+#include "paddle/phi/kernels/funcs/ivf_pq.h"
+
+namespace phi {
+namespace funcs {
+
+namespace {
+
+using Candidate = std::pair<float, int64_t>;
+
+// The levels are capped, the level of a node is rarely above 6 for m >= 8.
+constexpr int kMaxLevel = 16;
+
+// The best first search of a level, dist(node) is the distance of a node to
+// the query and for_each_neighbor(node, fn) calls fn on the neighbors of a
+// node at the level.
+template <typename DistFn, typename NeighborFn>
+std::vector<Candidate> SearchLevelImpl(const std::vector<Candidate>& entries,
+                                       int ef,
+                                       const DistFn& dist,
+                                       const NeighborFn& for_each_neighbor,
+                                       std::vector<uint32_t>* visited,
+                                       uint32_t* visit_tag) {
+  if (++*visit_tag == 0) {
+    std::fill(visited->begin(), visited->end(), 0);
+    *visit_tag = 1;
+  }
+  const uint32_t tag = *visit_tag;
+  std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>>
+      candidates;
+  std::priority_queue<Candidate> results;
+  for (const auto& entry : entries) {
+    (*visited)[entry.second] = tag;
+    candidates.push(entry);
+    results.push(entry);
+    if (static_cast<int>(results.size()) > ef) results.pop();
+  }
+  while (!candidates.empty()) {
+    const Candidate current = candidates.top();
+    if (static_cast<int>(results.size()) >= ef &&
+        current.first > results.top().first) {
+      break;
+    }
+    candidates.pop();
+    for_each_neighbor(current.second, [&](int64_t node) {
+      if ((*visited)[node] == tag) return;
+      (*visited)[node] = tag;
+      const float d = dist(node);
+      if (static_cast<int>(results.size()) < ef || d < results.top().first) {
+        candidates.emplace(d, node);
+        results.emplace(d, node);
+        if (static_cast<int>(results.size()) > ef) results.pop();
+      }
+    });
+  }
+  std::vector<Candidate> sorted(results.size());
+  for (size_t i = sorted.size(); i > 0; --i) {
+    sorted[i - 1] = results.top();
+    results.pop();
+  }
+  return sorted;
+}
+
+}  // namespace
+
+HnswGraph::HnswGraph(const float* data, int64_t d, int m, int ef_construction)
+    : data_(data), d_(d), m_(m), ef_construction_(ef_construction) {}
+
+float HnswGraph::Distance(int64_t a, int64_t b) const {
+  return L2Sqr(data_ + a * d_, data_ + b * d_, d_);
+}
+
+std::vector<Candidate> HnswGraph::SearchLevel(
+    int64_t q, const std::vector<Candidate>& entries, int ef, int level) {
+  return SearchLevelImpl(
+      entries,
+      ef,
+      [&](int64_t node) { return Distance(q, node); },
+      [&](int64_t node, const std::function<void(int64_t)>& fn) {
+        for (int64_t neighbor : links_[node][level]) fn(neighbor);
+      },
+      &visited_,
+      &visit_tag_);
+}
+
+std::vector<int64_t> HnswGraph::SelectNeighbors(
+    const std::vector<Candidate>& sorted, int max_neighbors) const {
+  std::vector<int64_t> selected;
+  for (const auto& candidate : sorted) {
+    if (static_cast<int>(selected.size()) >= max_neighbors) break;
+    bool keep = true;
+    for (int64_t kept : selected) {
+      if (Distance(candidate.second, kept) < candidate.first) {
+        keep = false;
+        break;
+      }
+    }
+    if (keep) selected.push_back(candidate.second);
+  }
+  return selected;
+}
+
+void HnswGraph::Load(const int32_t* neighbors,
+                     const int64_t* offsets,
+                     int64_t n,
+                     const int64_t* meta) {
+  links_.assign(n, {});
+  for (int64_t i = 0; i < n; ++i) {
+    const int64_t slots = offsets[i + 1] - offsets[i];
+    const int levels = static_cast<int>((slots - 2 * m_) / m_) + 1;
+    links_[i].resize(levels);
+    const int32_t* slot = neighbors + offsets[i];
+    for (int level = 0; level < levels; ++level) {
+      for (int j = 0; j < MaxNeighbors(level); ++j, ++slot) {
+        if (*slot >= 0) links_[i][level].push_back(*slot);
+      }
+    }
+  }
+  entry_ = n > 0 ? meta[0] : -1;
+  max_level_ = n > 0 ? static_cast<int>(meta[1]) : -1;
+}
+
+void HnswGraph::Add(int64_t begin, int64_t end, uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  const double level_mult = 1.0 / std::log(std::max(m_, 2));
+  links_.resize(end);
+  visited_.resize(end, 0);
+  for (int64_t q = begin; q < end; ++q) {
+    const int level = std::min(
+        static_cast<int>(-std::log(1.0 - uniform(rng)) * level_mult),
+        kMaxLevel);
+    links_[q].assign(level + 1, {});
+    if (entry_ < 0) {
+      entry_ = q;
+      max_level_ = level;
+      continue;
+    }
+    std::vector<Candidate> entries = {{Distance(q, entry_), entry_}};
+    for (int l = max_level_; l > level; --l) {
+      entries = SearchLevel(q, entries, 1, l);
+    }
+    for (int l = std::min(level, max_level_); l >= 0; --l) {
+      std::vector<Candidate> found =
+          SearchLevel(q, entries, ef_construction_, l);
+      links_[q][l] = SelectNeighbors(found, m_);
+      for (int64_t neighbor : links_[q][l]) {
+        auto& list = links_[neighbor][l];
+        list.push_back(q);
+        if (static_cast<int>(list.size()) > MaxNeighbors(l)) {
+          std::vector<Candidate> sorted;
+          sorted.reserve(list.size());
+          for (int64_t node : list) {
+            sorted.emplace_back(Distance(neighbor, node), node);
+          }
+          std::sort(sorted.begin(), sorted.end());
+          list = SelectNeighbors(sorted, MaxNeighbors(l));
+        }
+      }
+      entries = std::move(found);
+    }
+    if (level > max_level_) {
+      entry_ = q;
+      max_level_ = level;
+    }
+  }
+}
+
+void HnswGraph::Save(std::vector<int32_t>* neighbors,
+                     std::vector<int64_t>* offsets,
+                     int64_t* meta) const {
+  const int64_t n = static_cast<int64_t>(links_.size());
+  offsets->assign(n + 1, 0);
+  for (int64_t i = 0; i < n; ++i) {
+    const int64_t levels = static_cast<int64_t>(links_[i].size());
+    (*offsets)[i + 1] = (*offsets)[i] + 2 * m_ + (levels - 1) * m_;
+  }
+  neighbors->assign((*offsets)[n], -1);
+  for (int64_t i = 0; i < n; ++i) {
+    int32_t* slot = neighbors->data() + (*offsets)[i];
+    for (size_t level = 0; level < links_[i].size(); ++level) {
+      const auto& list = links_[i][level];
+      for (size_t j = 0; j < list.size(); ++j) {
+        slot[j] = static_cast<int32_t>(list[j]);
+      }
+      slot += MaxNeighbors(static_cast<int>(level));
+    }
+  }
+  meta[0] = entry_;
+  meta[1] = max_level_;
+  meta[2] = m_;
+}
+
+void HnswSearch(const float* data,
+                int64_t d,
+                const int32_t* neighbors,
+                const int64_t* offsets,
+                int64_t n,
+                const int64_t* meta,
+                const float* query,
+                int k,
+                int ef,
+                std::vector<uint32_t>* visited,
+                uint32_t* visit_tag,
+                float* distances,
+                int64_t* ids) {
+  std::fill(distances, distances + k, std::numeric_limits<float>::infinity());
+  std::fill(ids, ids + k, -1);
+  const int64_t entry = meta[0];
+  if (n == 0 || entry < 0) return;
+  const int64_t m = meta[2];
+  if (static_cast<int64_t>(visited->size()) < n) visited->resize(n, 0);
+
+  auto dist = [&](int64_t node) {
+    return L2Sqr(query, data + node * d, d);
+  };
+  int level = 0;
+  auto for_each_neighbor = [&](int64_t node,
+                               const std::function<void(int64_t)>& fn) {
+    const int32_t* slot =
+        neighbors + offsets[node] + (level == 0 ? 0 : m * (level + 1));
+    const int64_t count = level == 0 ? 2 * m : m;
+    for (int64_t j = 0; j < count && slot[j] >= 0; ++j) fn(slot[j]);
+  };
+  std::vector<Candidate> entries = {{dist(entry), entry}};
+  for (level = static_cast<int>(meta[1]); level > 0; --level) {
+    entries = SearchLevelImpl(
+        entries, 1, dist, for_each_neighbor, visited, visit_tag);
+  }
+  std::vector<Candidate> found = SearchLevelImpl(
+      entries, std::max(ef, k), dist, for_each_neighbor, visited, visit_tag);
+  const int64_t count = std::min<int64_t>(k, found.size());
+  for (int64_t i = 0; i < count; ++i) {
+    distances[i] = found[i].first;
+    ids[i] = found[i].second;
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,102 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace phi {
+namespace funcs {
+
+// An HNSW graph over the rows of a data tensor [n, d] is kept in the dense
+// tensors
+//   neighbors  [total]   int32, the neighbors of the levels of the nodes, 2m
+//                        slots for the level 0 and m for each upper level,
+//                        padded by -1
+//   offsets    [n + 1]   int64, the slots of the node i are in
+//                        [offsets[i], offsets[i + 1])
+//   meta       [3]       int64, the entry node, its level and m
+// so that a graph is saved and loaded as persistable variables. The distances
+// are the squared L2 distances.
+
+class HnswGraph {
+ public:
+  HnswGraph(const float* data, int64_t d, int m, int ef_construction);
+
+  // Loads the graph of the first nodes of the data.
+  void Load(const int32_t* neighbors,
+            const int64_t* offsets,
+            int64_t n,
+            const int64_t* meta);
+
+  // Inserts the nodes [begin, end) of the data, one by one.
+  void Add(int64_t begin, int64_t end, uint64_t seed);
+
+  void Save(std::vector<int32_t>* neighbors,
+            std::vector<int64_t>* offsets,
+            int64_t* meta) const;
+
+ private:
+  using Candidate = std::pair<float, int64_t>;
+
+  int MaxNeighbors(int level) const { return level == 0 ? 2 * m_ : m_; }
+
+  float Distance(int64_t a, int64_t b) const;
+
+  // The ef nearest nodes of the node q at the level, searched from the entry
+  // nodes, in the ascending order of the distances.
+  std::vector<Candidate> SearchLevel(int64_t q,
+                                     const std::vector<Candidate>& entries,
+                                     int ef,
+                                     int level);
+
+  // The heuristic of the HNSW paper, which keeps the candidates closer to q
+  // than to the neighbors kept before them.
+  std::vector<int64_t> SelectNeighbors(const std::vector<Candidate>& sorted,
+                                       int max_neighbors) const;
+
+  const float* data_;
+  int64_t d_;
+  int m_;
+  int ef_construction_;
+  int64_t entry_{-1};
+  int max_level_{-1};
+  // The neighbors of the levels of each node.
+  std::vector<std::vector<std::vector<int64_t>>> links_;
+  std::vector<uint32_t> visited_;
+  uint32_t visit_tag_{0};
+};
+
+// Searches a saved graph for the k nearest rows of the data to the query. The
+// missing results are padded by the distance inf and the id -1.
+void HnswSearch(const float* data,
+                int64_t d,
+                const int32_t* neighbors,
+                const int64_t* offsets,
+                int64_t n,
+                const int64_t* meta,
+                const float* query,
+                int k,
+                int ef,
+                std::vector<uint32_t>* visited,
+                uint32_t* visit_tag,
+                float* distances,
+                int64_t* ids);
+
+}  // namespace funcs
+}  // namespace phi
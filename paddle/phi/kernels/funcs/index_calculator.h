@@ -106,6 +106,104 @@ struct IndexCalculator {
 #endif
 };
 
+#ifndef PADDLE_WITH_XPU_KP
+// Merges the adjacent dims which are contiguous to each other in all the
+// tensors, and drops the dims of 1. strides[j] are the strides of the j-th
+// tensor in the dims, and are merged in place. A transposed or sliced view
+// is usually merged to a rank of no more than 4.
+static inline void MergeStridedDims(
+    std::vector<int64_t>* dims, std::vector<std::vector<int64_t>>* strides) {
+  std::vector<int64_t> merged_dims;
+  std::vector<std::vector<int64_t>> merged_strides(strides->size());
+  for (size_t i = 0; i < dims->size(); ++i) {
+    if ((*dims)[i] == 1) {
+      continue;
+    }
+    bool can_merge = !merged_dims.empty();
+    for (size_t j = 0; j < strides->size() && can_merge; ++j) {
+      can_merge = merged_strides[j].back() == (*strides)[j][i] * (*dims)[i];
+    }
+    if (can_merge) {
+      merged_dims.back() *= (*dims)[i];
+    } else {
+      merged_dims.push_back((*dims)[i]);
+    }
+    for (size_t j = 0; j < strides->size(); ++j) {
+      if (can_merge) {
+        merged_strides[j].back() = (*strides)[j][i];
+      } else {
+        merged_strides[j].push_back((*strides)[j][i]);
+      }
+    }
+  }
+  if (merged_dims.empty()) {
+    merged_dims.push_back(1);
+    for (auto& stride : merged_strides) {
+      stride.push_back(0);
+    }
+  }
+  *dims = std::move(merged_dims);
+  *strides = std::move(merged_strides);
+}
+
+// Calculates the offsets of the elements of NArgs strided tensors from the
+// index of an element in a contiguous tensor of the dims, so that the kernels
+// read the views of the stride kernels without a contiguous copy. Rank is
+// unrolled at compile time for the ranks of no more than 4, and kMaxRank
+// loops over the runtime rank. The index is of 32 bits.
+template <int NArgs, int Rank>
+struct StridedIndexCalculator {
+  // The dims and the strides merged by MergeStridedDims, the strides of the
+  // broadcast dims are 0.
+  StridedIndexCalculator(
+      const std::vector<int64_t>& dims,
+      const std::vector<std::vector<int64_t>>& tensor_strides)
+      : rank(static_cast<int>(dims.size())) {
+    PADDLE_ENFORCE_LE(
+        rank,
+        Rank,
+        phi::errors::InvalidArgument(
+            "The rank %d of the strided tensors is larger than %d.",
+            rank,
+            Rank));
+    // The innermost dim is the first.
+    for (int i = 0; i < rank; ++i) {
+      divmoders[i] =
+          kps::details::FastDivMod(static_cast<uint32_t>(dims[rank - 1 - i]));
+      for (int j = 0; j < NArgs; ++j) {
+        strides[i][j] = tensor_strides[j][rank - 1 - i];
+      }
+    }
+  }
+
+  __device__ __forceinline__ Array<int64_t, NArgs> operator()(
+      uint32_t index) const {
+    Array<int64_t, NArgs> offsets;
+#pragma unroll
+    for (int j = 0; j < NArgs; ++j) {
+      offsets[j] = 0;
+    }
+#pragma unroll
+    for (int i = 0; i < Rank; ++i) {
+      if (Rank == kMaxRank && i == rank) {
+        break;
+      }
+      auto divmod = divmoders[i].Divmod(index);
+      index = divmod.val[0];
+#pragma unroll
+      for (int j = 0; j < NArgs; ++j) {
+        offsets[j] += static_cast<int64_t>(divmod.val[1]) * strides[i][j];
+      }
+    }
+    return offsets;
+  }
+
+  int rank;
+  Array<kps::details::FastDivMod, Rank> divmoders;
+  Array<Array<int64_t, NArgs>, Rank> strides;
+};
+#endif
+
 #endif
 }  // namespace funcs
 }  // namespace phi
@@ -0,0 +1,204 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "paddle/phi/kernels/funcs/ivf_pq.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "paddle/phi/core/enforce.h"
+
+namespace phi {
+namespace funcs {
+
+int64_t NearestCentroid(const float* x,
+                        const float* centroids,
+                        int64_t k,
+                        int64_t d) {
+  int64_t best = 0;
+  float best_dist = std::numeric_limits<float>::max();
+  for (int64_t c = 0; c < k; ++c) {
+    const float dist = L2Sqr(x, centroids + c * d, d);
+    if (dist < best_dist) {
+      best_dist = dist;
+      best = c;
+    }
+  }
+  return best;
+}
+
+void KMeans(const float* data,
+            int64_t n,
+            int64_t d,
+            int64_t k,
+            int iters,
+            uint64_t seed,
+            float* centroids) {
+  PADDLE_ENFORCE_GE(
+      n,
+      k,
+      phi::errors::InvalidArgument(
+          "The k-means of %d clusters needs at least %d points, but "
+          "received %d.",
+          k,
+          k,
+          n));
+  std::mt19937_64 rng(seed);
+  std::vector<int64_t> perm(n);
+  std::iota(perm.begin(), perm.end(), 0);
+  std::shuffle(perm.begin(), perm.end(), rng);
+  for (int64_t c = 0; c < k; ++c) {
+    std::copy(data + perm[c] * d, data + (perm[c] + 1) * d, centroids + c * d);
+  }
+
+  std::vector<int64_t> assign(n);
+  std::vector<double> sums(k * d);
+  std::vector<int64_t> counts(k);
+  for (int it = 0; it < iters; ++it) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int64_t i = 0; i < n; ++i) {
+      assign[i] = NearestCentroid(data + i * d, centroids, k, d);
+    }
+    std::fill(sums.begin(), sums.end(), 0.0);
+    std::fill(counts.begin(), counts.end(), 0);
+    for (int64_t i = 0; i < n; ++i) {
+      double* sum = sums.data() + assign[i] * d;
+      for (int64_t j = 0; j < d; ++j) sum[j] += data[i * d + j];
+      ++counts[assign[i]];
+    }
+    for (int64_t c = 0; c < k; ++c) {
+      float* centroid = centroids + c * d;
+      if (counts[c] == 0) {
+        const int64_t row = static_cast<int64_t>(rng() % n);
+        std::copy(data + row * d, data + (row + 1) * d, centroid);
+        continue;
+      }
+      for (int64_t j = 0; j < d; ++j) {
+        centroid[j] = static_cast<float>(sums[c * d + j] / counts[c]);
+      }
+    }
+  }
+}
+
+void TrainPQCodebooks(const float* residuals,
+                      int64_t n,
+                      int64_t d,
+                      int64_t m,
+                      int64_t ksub,
+                      int iters,
+                      uint64_t seed,
+                      float* codebooks) {
+  const int64_t dsub = d / m;
+  std::vector<float> sub(n * dsub);
+  for (int64_t j = 0; j < m; ++j) {
+    for (int64_t i = 0; i < n; ++i) {
+      std::copy(residuals + i * d + j * dsub,
+                residuals + i * d + (j + 1) * dsub,
+                sub.data() + i * dsub);
+    }
+    KMeans(sub.data(),
+           n,
+           dsub,
+           ksub,
+           iters,
+           seed + j + 1,
+           codebooks + j * ksub * dsub);
+  }
+}
+
+void PQDistanceTable(const float* residual,
+                     const float* codebooks,
+                     int64_t m,
+                     int64_t ksub,
+                     int64_t dsub,
+                     float* table) {
+  for (int64_t j = 0; j < m; ++j) {
+    for (int64_t c = 0; c < ksub; ++c) {
+      table[j * ksub + c] = L2Sqr(
+          residual + j * dsub, codebooks + (j * ksub + c) * dsub, dsub);
+    }
+  }
+}
+
+void IvfPqAppend(const float* x,
+                 int64_t n,
+                 int64_t d,
+                 int64_t first_id,
+                 const float* centroids,
+                 int64_t nlist,
+                 const float* codebooks,
+                 int64_t m,
+                 int64_t ksub,
+                 const uint8_t* old_codes,
+                 const int64_t* old_offsets,
+                 const int64_t* old_ids,
+                 uint8_t* codes,
+                 int64_t* offsets,
+                 int64_t* ids) {
+  const int64_t dsub = d / m;
+  std::vector<int64_t> assign(n);
+  std::vector<uint8_t> new_codes(n * m);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t i = 0; i < n; ++i) {
+    const float* row = x + i * d;
+    assign[i] = NearestCentroid(row, centroids, nlist, d);
+    const float* centroid = centroids + assign[i] * d;
+    std::vector<float> residual(d);
+    for (int64_t j = 0; j < d; ++j) residual[j] = row[j] - centroid[j];
+    for (int64_t j = 0; j < m; ++j) {
+      new_codes[i * m + j] = static_cast<uint8_t>(NearestCentroid(
+          residual.data() + j * dsub, codebooks + j * ksub * dsub, ksub, dsub));
+    }
+  }
+
+  // A counting sort of the new rows by the lists, each after the old codes of
+  // its list.
+  std::vector<int64_t> counts(nlist, 0);
+  for (int64_t i = 0; i < n; ++i) ++counts[assign[i]];
+  offsets[0] = 0;
+  for (int64_t l = 0; l < nlist; ++l) {
+    const int64_t old_size = old_offsets ? old_offsets[l + 1] - old_offsets[l]
+                                         : 0;
+    offsets[l + 1] = offsets[l] + old_size + counts[l];
+  }
+  std::vector<int64_t> next(nlist);
+  for (int64_t l = 0; l < nlist; ++l) {
+    int64_t pos = offsets[l];
+    if (old_offsets) {
+      for (int64_t i = old_offsets[l]; i < old_offsets[l + 1]; ++i, ++pos) {
+        std::copy(old_codes + i * m, old_codes + (i + 1) * m, codes + pos * m);
+        ids[pos] = old_ids[i];
+      }
+    }
+    next[l] = pos;
+  }
+  for (int64_t i = 0; i < n; ++i) {
+    const int64_t pos = next[assign[i]]++;
+    std::copy(new_codes.data() + i * m,
+              new_codes.data() + (i + 1) * m,
+              codes + pos * m);
+    ids[pos] = first_id + i;
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,98 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+
+namespace phi {
+namespace funcs {
+
+// An IVF-PQ index is kept in the dense tensors
+//   centroids     [nlist, d]         float, the coarse centroids
+//   codebooks     [m, ksub, d / m]   float, the codewords of the residuals
+//                                    to the centroids, ksub <= 256
+//   codes         [n, m]             uint8, the codes sorted by the lists
+//   list_offsets  [nlist + 1]        int64, the codes of the list l are in
+//                                    [list_offsets[l], list_offsets[l + 1])
+//   ids           [n]                int64, the ids of the codes
+// so that an index is saved and loaded as persistable variables, and a
+// search is an op of the inference program. The distances are the squared
+// L2 distances to the reconstructions centroid + codewords.
+
+inline float L2Sqr(const float* a, const float* b, int64_t d) {
+  float sum = 0.0f;
+  for (int64_t i = 0; i < d; ++i) {
+    const float diff = a[i] - b[i];
+    sum += diff * diff;
+  }
+  return sum;
+}
+
+int64_t NearestCentroid(const float* x,
+                        const float* centroids,
+                        int64_t k,
+                        int64_t d);
+
+// The Lloyd k-means of the rows of data [n, d], seeded by k distinct rows. An
+// empty cluster is reseeded by a random row.
+void KMeans(const float* data,
+            int64_t n,
+            int64_t d,
+            int64_t k,
+            int iters,
+            uint64_t seed,
+            float* centroids);
+
+// Trains the codebooks on the residuals [n, d], one k-means a subspace.
+void TrainPQCodebooks(const float* residuals,
+                      int64_t n,
+                      int64_t d,
+                      int64_t m,
+                      int64_t ksub,
+                      int iters,
+                      uint64_t seed,
+                      float* codebooks);
+
+// The table [m, ksub] of the squared distances of the residual of a query to
+// the codewords.
+void PQDistanceTable(const float* residual,
+                     const float* codebooks,
+                     int64_t m,
+                     int64_t ksub,
+                     int64_t dsub,
+                     float* table);
+
+// Assigns the rows of x [n, d] to the lists and encodes their residuals, then
+// merges them after the codes of the old lists, if any. The ids of the rows
+// start at first_id.
+void IvfPqAppend(const float* x,
+                 int64_t n,
+                 int64_t d,
+                 int64_t first_id,
+                 const float* centroids,
+                 int64_t nlist,
+                 const float* codebooks,
+                 int64_t m,
+                 int64_t ksub,
+                 const uint8_t* old_codes,
+                 const int64_t* old_offsets,
+                 const int64_t* old_ids,
+                 uint8_t* codes,
+                 int64_t* offsets,
+                 int64_t* ids);
+
+}  // namespace funcs
+}  // namespace phi
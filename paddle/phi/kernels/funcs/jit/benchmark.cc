@@ -13,6 +13,7 @@
  * limitations under the License. */
 
 #include <iostream>
+#include <memory>
 #include <random>
 
 #include "glog/logging.h"
@@ -20,6 +21,7 @@
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/enforce.h"
+#include "paddle/phi/kernels/funcs/jit/kernel_pool.h"
 #include "paddle/phi/kernels/funcs/jit/kernels.h"
 #include "paddle/utils/flags.h"
 
@@ -117,6 +119,29 @@ void BenchAllImpls(const typename KernelTuple::attr_type& attr, Args... args) {
     infos.push_back(std::make_pair(f.first, benchmark(f.second, args...)));
   }
 
+  // the candidates only have the first usable jitcode, bench the jitcode of
+  // every ISA, e.g. the AVX-512 one against the AVX one
+  using Attr = typename KernelTuple::attr_type;
+  using Func = typename KernelTuple::func_type;
+  std::vector<std::unique_ptr<jit::GenBase>> codes;
+  auto& creator_map = jit::JitCodeCreatorPool::Instance().AllCreators();
+  auto iter = creator_map.find(
+      jit::KernelKey(KernelTuple::kernel_type, PlaceType()));
+  if (iter != creator_map.end()) {
+    for (auto& cur : iter->second) {
+      auto i = dynamic_cast<const jit::JitCodeCreator<Attr>*>(cur.get());
+      if (i && i->CanBeUsed(attr)) {
+        codes.emplace_back(i->CreateJitCode(attr));
+      }
+    }
+  }
+  if (codes.size() > 1) {
+    for (auto const& code : codes) {
+      infos.push_back(std::make_pair(
+          code->name(), benchmark(code->template getCode<Func>(), args...)));
+    }
+  }
+
   // Test result from Get function
   auto tgt = jit::KernelFuncs<KernelTuple, PlaceType>::Cache().At(attr);
   if (!tgt) {
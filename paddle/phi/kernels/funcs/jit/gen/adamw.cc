@@ -26,7 +26,7 @@ namespace gen {
 void AdamWJitCode::loadArgs() {
   static constexpr int32_t one_as_float = 0x3f800000;
   static constexpr int32_t mask_all_ones = 0xFFFFFFFF;
-  static constexpr int64_t mask_8_divisible = 0xFFFFFFFFFFFFFFF8;
+  static constexpr int64_t mask_16_divisible = 0xFFFFFFFFFFFFFFF0;
   static constexpr int64_t abi_pushes_offset = num_g_abi_regs * 8;
 
   mov(reg_mom2_out_ptr, ptr[rsp + (abi_pushes_offset + 8)]);
@@ -34,19 +34,19 @@ void AdamWJitCode::loadArgs() {
   mov(eax, one_as_float);
   movd(xmm_one, eax);
 
-  vbroadcastss(ymm_one, xmm_one);                 // 1
-  vbroadcastss(ymm_beta1, xmm_beta1);             // beta1
-  vbroadcastss(ymm_beta2, xmm_beta2);             // beta2
-  vbroadcastss(ymm_lr, xmm_lr);                   // -lr
-  vbroadcastss(ymm_eps, xmm_eps);                 // eps
-  vbroadcastss(ymm_old_lr, xmm_old_lr);           // old lr
-  vbroadcastss(ymm_lr_ratio, xmm_lr_ratio);       // lr_ratio
-  vbroadcastss(ymm_coeff, xmm_coeff);             // coeff
-  vsubps(ymm_one_sub_beta1, ymm_one, ymm_beta1);  // 1 - beta1
-  vsubps(ymm_one_sub_beta2, ymm_one, ymm_beta2);  // 1 - beta2
+  vbroadcastss(zmm_one, xmm_one);                 // 1
+  vbroadcastss(zmm_beta1, xmm_beta1);             // beta1
+  vbroadcastss(zmm_beta2, xmm_beta2);             // beta2
+  vbroadcastss(zmm_lr, xmm_lr);                   // -lr
+  vbroadcastss(zmm_eps, xmm_eps);                 // eps
+  vbroadcastss(zmm_old_lr, xmm_old_lr);           // old lr
+  vbroadcastss(zmm_lr_ratio, xmm_lr_ratio);       // lr_ratio
+  vbroadcastss(zmm_coeff, xmm_coeff);             // coeff
+  vsubps(zmm_one_sub_beta1, zmm_one, zmm_beta1);  // 1 - beta1
+  vsubps(zmm_one_sub_beta2, zmm_one, zmm_beta2);  // 1 - beta2
 
   mov(reg_numel_without_tail, reg_numel);
-  and_(reg_numel_without_tail, mask_8_divisible);  // make it 8-divisible
+  and_(reg_numel_without_tail, mask_16_divisible);  // make it 16-divisible
 
   shl(reg_numel_without_tail, 2);  // * 4 to treat it as float offset
   shl(reg_numel, 2);
@@ -73,47 +73,47 @@ void AdamWJitCode::setTailOpmask() {
 
 void AdamWJitCode::mainCode() {
   // load p
-  vmovups(ymm10 | k1, ptr[reg_param_ptr + reg_offset]);
+  vmovups(zmm10 | k1, ptr[reg_param_ptr + reg_offset]);
 
   // ((lr * lr_ratio) * coeff)
-  vmulps(ymm11 | k1, ymm_old_lr, ymm_lr_ratio);
-  vmulps(ymm11 | k1, ymm11, ymm_coeff);
+  vmulps(zmm11 | k1, zmm_old_lr, zmm_lr_ratio);
+  vmulps(zmm11 | k1, zmm11, zmm_coeff);
 
   // - (lr * lr_ratio) * coeff) * p + p
-  // p is stored in ymm11
-  vfnmadd132ps(ymm11 | k1, ymm10, ymm10);
+  // p is stored in zmm11
+  vfnmadd132ps(zmm11 | k1, zmm10, zmm10);
 
   // load grad
-  vmovups(ymm10 | k1, ptr[reg_grad_ptr + reg_offset]);
+  vmovups(zmm10 | k1, ptr[reg_grad_ptr + reg_offset]);
 
   // beta1 * mom1 + (1 - beta1) * g
-  vmulps(ymm12 | k1, ymm_one_sub_beta1, ymm10);
-  vfmadd231ps(ymm12 | k1, ymm_beta1, ptr[reg_mom1_ptr + reg_offset]);
+  vmulps(zmm12 | k1, zmm_one_sub_beta1, zmm10);
+  vfmadd231ps(zmm12 | k1, zmm_beta1, ptr[reg_mom1_ptr + reg_offset]);
 
   // beta2 * mom2 + (1 - beta2) * g * g
-  vmulps(ymm10 | k1, ymm10, ymm10);
-  vmulps(ymm10 | k1, ymm_one_sub_beta2, ymm10);
-  vfmadd231ps(ymm10 | k1, ymm_beta2, ptr[reg_mom2_ptr + reg_offset]);
+  vmulps(zmm10 | k1, zmm10, zmm10);
+  vmulps(zmm10 | k1, zmm_one_sub_beta2, zmm10);
+  vfmadd231ps(zmm10 | k1, zmm_beta2, ptr[reg_mom2_ptr + reg_offset]);
 
   // store mom1 and mom2
-  vmovups(ptr[reg_mom1_out_ptr + reg_offset] | k1, ymm12);
-  vmovups(ptr[reg_mom2_out_ptr + reg_offset] | k1, ymm10);
+  vmovups(ptr[reg_mom1_out_ptr + reg_offset] | k1, zmm12);
+  vmovups(ptr[reg_mom2_out_ptr + reg_offset] | k1, zmm10);
 
   // sqrt(mom2) + eps
-  vsqrtps(ymm10 | k1, ymm10);
-  vaddps(ymm10 | k1, ymm10, ymm_eps);
+  vsqrtps(zmm10 | k1, zmm10);
+  vaddps(zmm10 | k1, zmm10, zmm_eps);
 
   // p + (-lr) * (mom1 / sqrt(mom2) + eps)
-  vdivps(ymm10 | k1, ymm12, ymm10);
-  vfmadd213ps(ymm10 | k1, ymm_lr, ymm11);
+  vdivps(zmm10 | k1, zmm12, zmm10);
+  vfmadd213ps(zmm10 | k1, zmm_lr, zmm11);
 
   // store p
-  vmovups(ptr[reg_param_out_ptr + reg_offset] | k1, ymm10);
+  vmovups(ptr[reg_param_out_ptr + reg_offset] | k1, zmm10);
 }
 
 void AdamWJitCode::genCode() {
   static constexpr int64_t main_loop_elems_size =
-      8 * sizeof(float);  // 8 floats in YMM
+      16 * sizeof(float);  // 16 floats in ZMM
   static constexpr int64_t offset_increment = main_loop_elems_size;
   preCode();
   loadArgs();
@@ -26,8 +26,9 @@ namespace gen {
 
 void EmbSeqPoolJitCode::genCode() {
   preCode();
-  constexpr int block = YMM_FLOAT_BLOCK;
-  constexpr int max_num_regs = 8;
+  const int block = use_zmm_ ? ZMM_FLOAT_BLOCK : YMM_FLOAT_BLOCK;
+  // two registers of each block
+  const int max_num_regs = use_zmm_ ? 16 : 8;
   const int num_block = tbl_w_ / block;
   const int num_groups = num_block / max_num_regs;
   const size_t block_size = sizeof(float) * block;
@@ -66,7 +67,8 @@ void EmbSeqPoolJitCode::genCode() {
       add(reg_ptr_tbl_i, param_tbl);  // reg is ptr_i now
       size_t w_offset = 0;
       for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-        vmovups(ymm_t(reg_i + num_regs), ptr[reg_ptr_tbl_i + w_offset]);
+        vmovups(vreg(reg_i + num_regs, use_zmm_),
+                ptr[reg_ptr_tbl_i + w_offset]);
         w_offset += block_size;
       }
       add(reg_ptr_idx_i, reg_idx_width_in_byte);
@@ -91,9 +93,10 @@ void EmbSeqPoolJitCode::genCode() {
         add(reg_ptr_tbl_i, param_tbl);
         size_t w_offset = 0;
         for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-          vmovups(ymm_t(reg_i), ptr[reg_ptr_tbl_i + w_offset]);
-          vaddps(
-              ymm_t(reg_i + num_regs), ymm_t(reg_i + num_regs), ymm_t(reg_i));
+          vmovups(vreg(reg_i, use_zmm_), ptr[reg_ptr_tbl_i + w_offset]);
+          vaddps(vreg(reg_i + num_regs, use_zmm_),
+                 vreg(reg_i + num_regs, use_zmm_),
+                 vreg(reg_i, use_zmm_));
           w_offset += block_size;
         }
         add(reg_ptr_idx_i, reg_idx_width_in_byte);
@@ -104,7 +107,8 @@ void EmbSeqPoolJitCode::genCode() {
       // avg or sqrt here, if needed
       w_offset = 0;
       for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-        vmovups(ptr[reg_ptr_dst_i + w_offset], ymm_t(reg_i + num_regs));
+        vmovups(ptr[reg_ptr_dst_i + w_offset],
+                vreg(reg_i + num_regs, use_zmm_));
         w_offset += block_size;
       }
       add(reg_ptr_dst_i, tbl_width_in_byte);
@@ -130,6 +134,12 @@ class EmbSeqPoolCreator : public JitCodeCreator<emb_seq_pool_attr_t> {
   }
   std::unique_ptr<GenBase> CreateJitCode(
       const emb_seq_pool_attr_t& attr) const override {
+    CheckAttr(attr);
+    return make_unique<EmbSeqPoolJitCode>(attr, CodeSize(attr));
+  }
+
+ protected:
+  void CheckAttr(const emb_seq_pool_attr_t& attr) const {
     PADDLE_ENFORCE_GT(attr.table_height,
                       0,
                       phi::errors::InvalidArgument(
@@ -160,7 +170,24 @@ class EmbSeqPoolCreator : public JitCodeCreator<emb_seq_pool_attr_t> {
                           "The attribute out_width of EmbSeqPool should be "
                           "larger than 0. But it is %d.",
                           attr.out_width));
-    return make_unique<EmbSeqPoolJitCode>(attr, CodeSize(attr));
+  }
+};
+
+// the zmm version is registered first to be chosen on AVX-512
+class EmbSeqPoolAVX512Creator : public EmbSeqPoolCreator {
+ public:
+  bool CanBeUsed(const emb_seq_pool_attr_t& attr) const override {
+    return phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f) &&
+           attr.table_width % ZMM_FLOAT_BLOCK == 0;
+  }
+  size_t CodeSize(const emb_seq_pool_attr_t& attr) const override {
+    return 96 + (attr.table_width / ZMM_FLOAT_BLOCK) * 96 * 8;
+  }
+  std::unique_ptr<GenBase> CreateJitCode(
+      const emb_seq_pool_attr_t& attr) const override {
+    CheckAttr(attr);
+    return make_unique<EmbSeqPoolJitCode>(
+        attr, CodeSize(attr), nullptr, /*use_zmm=*/true);
   }
 };
 
@@ -170,4 +197,6 @@ class EmbSeqPoolCreator : public JitCodeCreator<emb_seq_pool_attr_t> {
 
 namespace gen = phi::jit::gen;
 
-REGISTER_JITKERNEL_GEN(kEmbSeqPool, gen::EmbSeqPoolCreator);
+REGISTER_JITKERNEL_GEN(kEmbSeqPool,
+                       gen::EmbSeqPoolAVX512Creator,
+                       gen::EmbSeqPoolCreator);
@@ -28,10 +28,12 @@ class EmbSeqPoolJitCode : public JitCode {
  public:
   explicit EmbSeqPoolJitCode(const emb_seq_pool_attr_t& attr,
                              size_t code_size = 256 * 1024,
-                             void* code_ptr = nullptr)
+                             void* code_ptr = nullptr,
+                             bool use_zmm = false)
       : JitCode(code_size, code_ptr),
         tbl_w_(attr.table_width),
-        type_(attr.pool_type) {
+        type_(attr.pool_type),
+        use_zmm_(use_zmm) {
     if (type_ != SeqPoolType::kSum) {
       PADDLE_THROW(phi::errors::Unimplemented("Only supports sum pool yet."));
     }
@@ -48,6 +50,9 @@ class EmbSeqPoolJitCode : public JitCode {
       base += "_Sqrt";
     }
     base += ("_W" + std::to_string(tbl_w_));
+    if (use_zmm_) {
+      base += "_AVX512";
+    }
     return base;
   }
   void genCode() override;
@@ -55,6 +60,8 @@ class EmbSeqPoolJitCode : public JitCode {
  private:
   int tbl_w_;
   SeqPoolType type_;
+  // use the 32 zmm registers of AVX-512, or the 16 ymm registers of AVX
+  bool use_zmm_;
   reg64_t param_tbl{abi_param1};
   reg64_t param_idx{abi_param2};
   reg64_t param_dst{abi_param3};
@@ -101,6 +101,10 @@ class JitCode : public GenBase, public Xbyak::CodeGenerator {
     }
     ret();
   }
+  // the ymm or the zmm register of the index
+  Xbyak::Xmm vreg(int idx, bool use_zmm) const {
+    return use_zmm ? Xbyak::Xmm(Xbyak::Zmm(idx)) : Xbyak::Xmm(Xbyak::Ymm(idx));
+  }
   void L(const char* label) { Xbyak::CodeGenerator::L(label); }
   void L(Xbyak::Label& label) { Xbyak::CodeGenerator::L(label); }  // NOLINT
   // Enhanced vector extension
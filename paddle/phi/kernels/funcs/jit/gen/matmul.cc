@@ -40,6 +40,11 @@ void MatMulJitCode::genCode() {
   // from packed mov(reg_ptr_wgt, ptr[param_attr + offsetof(matmul_attr_t,
   // packed_weight)]);
   mov(reg_ptr_wgt, param_y);
+  if (rest != 0) {
+    // the last block of a row is loaded and saved with the rest mask
+    mov(eax, (1 << rest) - 1);
+    kmovw(k1, eax);
+  }
   size_t z_offset = 0;
   size_t wgt_offset = 0;
   for (size_t g = 0; g < groups.size(); ++g) {
@@ -58,8 +63,13 @@ void MatMulJitCode::genCode() {
         }
       }
       for (int i = 0; i < groups[g]; ++i) {
-        vmovups(zmm_t(w_reg_idx),
-                ptr[reg_ptr_wgt + wgt_offset + k * n_ * sizeof(float)]);
+        const auto wgt_addr =
+            ptr[reg_ptr_wgt + wgt_offset + k * n_ * sizeof(float)];
+        if (rest != 0 && g == groups.size() - 1 && i == groups[g] - 1) {
+          vmovups(zmm_t(w_reg_idx) | k1 | T_z, wgt_addr);
+        } else {
+          vmovups(zmm_t(w_reg_idx), wgt_addr);
+        }
         vfmadd231ps(zmm_t(i), zmm_t(w_reg_idx), zmm_t(x_reg_idx));
         wgt_offset += block_len;
       }
@@ -68,9 +78,10 @@ void MatMulJitCode::genCode() {
         for (int i = 0; i < groups[g]; ++i) {
           // only rest save should be careful
           if (rest != 0 && g == groups.size() - 1 && i == groups[g] - 1) {
-            break;
+            vmovups(ptr[param_z + z_offset + i * block_len] | k1, zmm_t(i));
+          } else {
+            vmovups(ptr[param_z + z_offset + i * block_len], zmm_t(i));
           }
-          vmovups(ptr[param_z + z_offset + i * block_len], zmm_t(i));
         }
       }
       x_offset += sizeof(float);
@@ -78,40 +89,16 @@ void MatMulJitCode::genCode() {
     z_offset += block_len * groups[g];
   }
 
-  if (rest != 0) {
-    // below should refine with mask
-    int reg_idx = groups.back() - 1;
-    z_offset = (n_ - rest) * sizeof(float);
-    int inner_block = 8;
-    while (rest > 0) {
-      if (rest >= 8) {
-        inner_block = 8;
-        vmovups(ptr[param_z + z_offset], ymm_t(reg_idx));
-        // shift zmm of inner_block, change reg_idx if update
-      } else if (rest >= 4) {
-        inner_block = 4;
-        vmovups(ptr[param_z + z_offset], xmm_t(reg_idx));
-      } else if (rest >= 2) {
-        inner_block = 2;
-        vmovq(ptr[param_z + z_offset], xmm_t(reg_idx));
-      } else {
-        inner_block = 1;
-        vmovss(ptr[param_z + z_offset], xmm_t(reg_idx));
-      }
-      z_offset += inner_block * sizeof(float);
-      rest -= inner_block;
-    }
-  }
-
   postCode();
 }
 
 class MatMulCreator : public JitCodeCreator<matmul_attr_t> {
  public:
   bool CanBeUsed(const matmul_attr_t& attr) const override {
+    // the rest of n is handled with the opmask
     return attr.m == 1 &&
            phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f) &&
-           attr.n % ZMM_FLOAT_BLOCK == 0 && attr.k < 512;
+           attr.k < 512;
   }
   size_t CodeSize(const matmul_attr_t& attr) const override {
     int block = YMM_FLOAT_BLOCK;
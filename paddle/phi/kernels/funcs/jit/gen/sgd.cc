@@ -24,39 +24,44 @@ namespace jit {
 namespace gen {
 
 void SgdJitCode::mainCode(int num_regs) {
-  constexpr size_t block_size = sizeof(float) * YMM_FLOAT_BLOCK;
+  const size_t block_size =
+      sizeof(float) * (use_zmm_ ? ZMM_FLOAT_BLOCK : YMM_FLOAT_BLOCK);
+  const auto reg_lr = vreg(use_zmm_ ? 31 : 15, use_zmm_);
   // load grad
   for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-    vmovups(ymm_t(reg_i), ptr[reg_ptr_grad_i]);
+    vmovups(vreg(reg_i, use_zmm_), ptr[reg_ptr_grad_i]);
     add(reg_ptr_grad_i, block_size);
   }
   // load param
   for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-    vmovups(ymm_t(reg_i + num_regs), ptr[reg_ptr_param_i]);
+    vmovups(vreg(reg_i + num_regs, use_zmm_), ptr[reg_ptr_param_i]);
     add(reg_ptr_param_i, block_size);
   }
   // compute out
   for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-    vmulps(ymm_t(reg_i), ymm_t(reg_i), ymm_lr);
-    vsubps(ymm_t(reg_i + num_regs), ymm_t(reg_i + num_regs), ymm_t(reg_i));
+    vmulps(vreg(reg_i, use_zmm_), vreg(reg_i, use_zmm_), reg_lr);
+    vsubps(vreg(reg_i + num_regs, use_zmm_),
+           vreg(reg_i + num_regs, use_zmm_),
+           vreg(reg_i, use_zmm_));
   }
   // save out
   for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-    vmovups(ptr[reg_ptr_out_i], ymm_t(reg_i + num_regs));
+    vmovups(ptr[reg_ptr_out_i], vreg(reg_i + num_regs, use_zmm_));
     add(reg_ptr_out_i, block_size);
   }
 }
 
 void SgdJitCode::genCode() {
   preCode();
-  constexpr int block = YMM_FLOAT_BLOCK;
-  constexpr int max_num_regs = 7;
+  const int block = use_zmm_ ? ZMM_FLOAT_BLOCK : YMM_FLOAT_BLOCK;
+  // two registers of each block, and one for lr
+  const int max_num_regs = use_zmm_ ? 15 : 7;
   const int num_block = w_ / block;
   const int num_groups = num_block / max_num_regs;
   int rest_num_regs = num_block % max_num_regs;
   const size_t width_size = w_ * sizeof(float);
 
-  vbroadcastss(ymm_lr, ptr[param_lr]);
+  vbroadcastss(vreg(use_zmm_ ? 31 : 15, use_zmm_), ptr[param_lr]);
 
   mov(reg_ptr_grad_i, param_grad);
   mov(reg_ptr_rows_i, param_rows);
@@ -114,6 +119,12 @@ class SgdCreator : public JitCodeCreator<sgd_attr_t> {
   size_t CodeSize(const sgd_attr_t& attr) const override { return 96 + 32 * 8; }
   std::unique_ptr<GenBase> CreateJitCode(
       const sgd_attr_t& attr) const override {
+    CheckAttr(attr);
+    return make_unique<SgdJitCode>(attr, CodeSize(attr));
+  }
+
+ protected:
+  void CheckAttr(const sgd_attr_t& attr) const {
     PADDLE_ENFORCE_EQ(attr.param_width,
                       attr.grad_width,
                       phi::errors::InvalidArgument(
@@ -137,7 +148,24 @@ class SgdCreator : public JitCodeCreator<sgd_attr_t> {
             "The attribute selected_rows_size of Sgd should be "
             "equal to or larger than 0. But selected_rows_size is %d.",
             attr.selected_rows_size));
-    return make_unique<SgdJitCode>(attr, CodeSize(attr));
+  }
+};
+
+// the zmm version is registered first to be chosen on AVX-512
+class SgdAVX512Creator : public SgdCreator {
+ public:
+  bool CanBeUsed(const sgd_attr_t& attr) const override {
+    return phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f) &&
+           attr.grad_width % ZMM_FLOAT_BLOCK == 0;
+  }
+  size_t CodeSize(const sgd_attr_t& attr) const override {
+    return 96 + 64 * 8;
+  }
+  std::unique_ptr<GenBase> CreateJitCode(
+      const sgd_attr_t& attr) const override {
+    CheckAttr(attr);
+    return make_unique<SgdJitCode>(
+        attr, CodeSize(attr), nullptr, /*use_zmm=*/true);
   }
 };
 
@@ -147,4 +175,4 @@ class SgdCreator : public JitCodeCreator<sgd_attr_t> {
 
 namespace gen = phi::jit::gen;
 
-REGISTER_JITKERNEL_GEN(kSgd, gen::SgdCreator);
+REGISTER_JITKERNEL_GEN(kSgd, gen::SgdAVX512Creator, gen::SgdCreator);
@@ -28,17 +28,24 @@ class SgdJitCode : public JitCode {
  public:
   explicit SgdJitCode(const sgd_attr_t& attr,
                       size_t code_size = 256 * 1024,
-                      void* code_ptr = nullptr)
-      : JitCode(code_size, code_ptr), w_(attr.grad_width) {
+                      void* code_ptr = nullptr,
+                      bool use_zmm = false)
+      : JitCode(code_size, code_ptr),
+        w_(attr.grad_width),
+        use_zmm_(use_zmm) {
     this->genCode();
   }
 
-  DECLARE_JIT_CODE(SgdJitCode);
+  std::string name() const override {
+    return use_zmm_ ? "SgdJitCode_AVX512" : "SgdJitCode";
+  }
   void genCode() override;
   void mainCode(int num_regs);
 
  private:
   int w_;
+  // use the 32 zmm registers of AVX-512, or the 16 ymm registers of AVX
+  bool use_zmm_;
   reg64_t param_lr{abi_param1};
   reg64_t param_param{abi_param2};
   reg64_t param_grad{abi_param3};
@@ -46,7 +53,6 @@ class SgdJitCode : public JitCode {
   reg64_t param_out{abi_param5};
   reg64_t param_attr{abi_param6};
 
-  ymm_t ymm_lr = ymm_t(15);
 
   reg64_t reg_ptr_grad_i{r10};
   reg64_t reg_ptr_rows_i{r11};
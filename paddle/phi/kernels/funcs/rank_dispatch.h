@@ -0,0 +1,59 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <type_traits>
+
+#include "paddle/phi/core/ddim.h"
+
+namespace phi {
+namespace funcs {
+
+// The largest rank instantiated by DispatchRank, the dims of a kernel are
+// usually merged to no more than it.
+constexpr int kMaxDispatchedRank = 4;
+
+// Calls func(std::integral_constant<int, Rank>()) with Rank of the runtime
+// rank in [1, kMaxDispatchedRank], and of DDim::kMaxRank for the others, so
+// that a kernel of the template Rank unrolls its index arithmetic at compile
+// time. A kernel of DDim::kMaxRank loops over the runtime rank instead:
+//
+//   for (int i = 0; i < Rank; ++i) {
+//     if (Rank == DDim::kMaxRank && i == rank) break;
+//     ...
+//   }
+template <typename Func>
+inline void DispatchRank(int rank, Func&& func) {
+  switch (rank) {
+    case 1:
+      func(std::integral_constant<int, 1>());
+      break;
+    case 2:
+      func(std::integral_constant<int, 2>());
+      break;
+    case 3:
+      func(std::integral_constant<int, 3>());
+      break;
+    case 4:
+      func(std::integral_constant<int, 4>());
+      break;
+    default:
+      func(std::integral_constant<int, DDim::kMaxRank>());
+      break;
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
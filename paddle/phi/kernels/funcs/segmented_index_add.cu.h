@@ -0,0 +1,154 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <limits>
+
+#ifdef __NVCC__
+#include "cub/cub.cuh"
+#endif
+#ifdef __HIPCC__
+#include <hipcub/hipcub.hpp>
+namespace cub = hipcub;
+#endif
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/backends/gpu/gpu_primitives.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+namespace funcs {
+
+template <typename T>
+__global__ void InitIndexOrderKernel(T* order, T num) {
+  CUDA_KERNEL_LOOP(i, num) { order[i] = i; }
+}
+
+// Each thread of the first position k of a segment of the sorted index sums
+// the values of the segment at its (outer, inner), in the order of the index.
+template <typename T, typename IndexT>
+__global__ void SegmentedIndexAddKernel(const T* value,
+                                        const IndexT* sorted_index,
+                                        const int* order,
+                                        int64_t numel,
+                                        int64_t index_num,
+                                        int64_t inner,
+                                        int64_t out_size,
+                                        T* out) {
+  using MT = typename dtype::MPTypeTrait<T>::Type;
+  CUDA_KERNEL_LOOP_TYPE(idx, numel, int64_t) {
+    int64_t n = idx % inner;
+    int64_t k = idx / inner % index_num;
+    int64_t o = idx / inner / index_num;
+    IndexT dst = sorted_index[k];
+    if (k > 0 && sorted_index[k - 1] == dst) {
+      continue;
+    }
+    MT sum = static_cast<MT>(value[(o * index_num + order[k]) * inner + n]);
+    for (int64_t m = k + 1; m < index_num && sorted_index[m] == dst; ++m) {
+      sum += static_cast<MT>(value[(o * index_num + order[m]) * inner + n]);
+    }
+    T* out_ptr = out + (o * out_size + dst) * inner + n;
+    *out_ptr = static_cast<T>(static_cast<MT>(*out_ptr) + sum);
+  }
+}
+
+// Adds value[o][i][n] to out[o][index[i]][n] deterministically, where value
+// is of [outer, index_num, inner] and out of [outer, out_size, inner]. The
+// index is radix sorted stably with its positions, so that every out[o][j][n]
+// is added by one thread the sum of its values in the order of the index,
+// without atomics, as the sorted rows reduced by MergeAdd of SelectedRows.
+template <typename T, typename IndexT>
+void SegmentedIndexAdd(const GPUContext& ctx,
+                       const IndexT* index,
+                       int64_t index_num,
+                       const T* value,
+                       int64_t outer,
+                       int64_t inner,
+                       int64_t out_size,
+                       T* out) {
+  if (index_num <= 0 || outer <= 0 || inner <= 0) {
+    return;
+  }
+  PADDLE_ENFORCE_LE(
+      index_num,
+      std::numeric_limits<int>::max(),
+      phi::errors::InvalidArgument(
+          "The deterministic index add supports at most %d indices, but "
+          "received %d.",
+          std::numeric_limits<int>::max(),
+          index_num));
+  const int num = static_cast<int>(index_num);
+  auto stream = ctx.stream();
+  auto place = ctx.GetPlace();
+  auto alloc_temp = [&](size_t bytes) {
+    return phi::memory_utils::Alloc(
+        place, bytes, phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
+  };
+
+  DenseTensor sorted_index, order_in, order;
+  sorted_index.Resize({index_num});
+  order_in.Resize({index_num});
+  order.Resize({index_num});
+  IndexT* sorted_index_data = ctx.template Alloc<IndexT>(&sorted_index);
+  int* order_in_data = ctx.template Alloc<int>(&order_in);
+  int* order_data = ctx.template Alloc<int>(&order);
+
+  const int block_size = 256;
+  InitIndexOrderKernel<int>
+      <<<(num + block_size - 1) / block_size, block_size, 0, stream>>>(
+          order_in_data, num);
+  size_t temp_bytes = 0;
+  cub::DeviceRadixSort::SortPairs(nullptr,
+                                  temp_bytes,
+                                  index,
+                                  sorted_index_data,
+                                  order_in_data,
+                                  order_data,
+                                  num,
+                                  0,
+                                  static_cast<int>(sizeof(IndexT) * 8),
+                                  stream);
+  auto sort_temp = alloc_temp(temp_bytes);
+  cub::DeviceRadixSort::SortPairs(sort_temp->ptr(),
+                                  temp_bytes,
+                                  index,
+                                  sorted_index_data,
+                                  order_in_data,
+                                  order_data,
+                                  num,
+                                  0,
+                                  static_cast<int>(sizeof(IndexT) * 8),
+                                  stream);
+
+  const int64_t numel = outer * index_num * inner;
+  dim3 grid_dim = dim3((numel + block_size - 1) / block_size);
+  phi::backends::gpu::LimitGridDim(ctx, &grid_dim);
+  SegmentedIndexAddKernel<T, IndexT>
+      <<<grid_dim, block_size, 0, stream>>>(value,
+                                            sorted_index_data,
+                                            order_data,
+                                            numel,
+                                            index_num,
+                                            inner,
+                                            out_size,
+                                            out);
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -21,6 +21,7 @@ limitations under the License. */
 
 #include "paddle/common/ddim.h"
 #include "paddle/phi/core/mixed_vector.h"
+#include "paddle/phi/kernels/funcs/selected_rows_segments.h"
 
 #ifdef PADDLE_WITH_XPU
 #include "paddle/phi/backends/xpu/enforce_xpu.h"
@@ -435,66 +436,56 @@ typename std::enable_if<std::is_integral<T>::value>::type elementwise_add_to(
   }
 }
 
+// out row i = the sum of the value rows of the segment i
 template <typename T, typename DeviceContext>
 typename std::enable_if<std::is_same<T, phi::dtype::bfloat16>::value>::type
-add_sparse_inputs(const std::vector<const phi::SelectedRows*>& inputs,
-                  const std::unordered_map<int64_t, size_t>& rows_to_id,
-                  int64_t input_width,
-                  const DeviceContext& context,
-                  T* out_data) {
-#ifndef PADDLE_WITH_DNNL
+add_segments(const RowSegments& segments,
+             const std::vector<const T*>& value_rows,
+             int64_t input_width,
+             const DeviceContext& context,
+             T* out_data) {
+#ifdef PADDLE_WITH_DNNL
+  OneDNNContext onednn_context(context.GetPlace());
+  funcs::OneDNNAXPYHandler<T> axpy_handler(
+      input_width, T(1.f), onednn_context.GetEngine());
+#else
   auto blas = phi::funcs::GetBlas<DeviceContext, T>(context);
 #endif
-  for (auto* input : inputs) {
-    if (input->rows().empty()) {
-      continue;
-    }
-    auto* input_data = input->value().data<T>();
-    auto& input_rows = input->rows();
-
+  for (size_t i = 0; i < segments.size(); ++i) {
+    const T* first = value_rows[segments.order[segments.begin(i)]];
+    T* out_row = out_data + i * input_width;
+    std::copy(first, first + input_width, out_row);
+    for (int64_t k = segments.begin(i) + 1; k < segments.end(i); ++k) {
 #ifdef PADDLE_WITH_DNNL
-    OneDNNContext onednn_context(context.GetPlace());
-    funcs::OneDNNAXPYHandler<T> axpy_handler(
-        input_width, T(1.f), onednn_context.GetEngine());
-    for (size_t i = 0; i < input_rows.size(); i++) {
-      size_t out_i = rows_to_id.at(input_rows[i]);
-      axpy_handler(&input_data[i * input_width],
-                   &out_data[out_i * input_width]);
-    }
+      axpy_handler(value_rows[segments.order[k]], out_row);
 #else
-    for (size_t i = 0; i < input_rows.size(); i++) {
-      size_t out_i = rows_to_id.at(input_rows[i]);
       elementwise_add_to<T, DeviceContext>(&blas,
                                            static_cast<size_t>(input_width),
-                                           &input_data[i * input_width],
-                                           &out_data[out_i * input_width]);
-    }
+                                           value_rows[segments.order[k]],
+                                           out_row);
 #endif
+    }
   }
 }
 
 template <typename T, typename DeviceContext>
 typename std::enable_if<!std::is_same<T, phi::dtype::bfloat16>::value>::type
-add_sparse_inputs(const std::vector<const phi::SelectedRows*>& inputs,
-                  const std::unordered_map<int64_t, size_t>& rows_to_id,
-                  int64_t input_width,
-                  const DeviceContext& context,
-                  T* out_data) {
-  VLOG(4) << "[CPU] add_sparse_inputs <" << typeid(T).name();
+add_segments(const RowSegments& segments,
+             const std::vector<const T*>& value_rows,
+             int64_t input_width,
+             const DeviceContext& context,
+             T* out_data) {
+  VLOG(4) << "[CPU] add_segments <" << typeid(T).name();
   auto blas = phi::funcs::GetBlas<DeviceContext, T>(context);
-  for (auto* input : inputs) {
-    if (input->rows().empty()) {
-      continue;
-    }
-    auto* input_data = input->value().data<T>();
-    auto& input_rows = input->rows();
-
-    for (size_t i = 0; i < input_rows.size(); i++) {
-      size_t out_i = rows_to_id.at(input_rows[i]);
+  for (size_t i = 0; i < segments.size(); ++i) {
+    const T* first = value_rows[segments.order[segments.begin(i)]];
+    T* out_row = out_data + i * input_width;
+    std::copy(first, first + input_width, out_row);
+    for (int64_t k = segments.begin(i) + 1; k < segments.end(i); ++k) {
       elementwise_add_to<T, DeviceContext>(&blas,
                                            static_cast<size_t>(input_width),
-                                           &input_data[i * input_width],
-                                           &out_data[out_i * input_width]);
+                                           value_rows[segments.order[k]],
+                                           out_row);
     }
   }
 }
@@ -540,7 +531,6 @@ struct MergeAddImpl {
     auto input_width = has_value_input->value().dims()[1];
     auto input_height = has_value_input->height();
     phi::SelectedRows& out = *output;
-    std::set<int64_t> merged_row_set;
     size_t row_num = 0;
     for (auto* input : inputs) {
       if (input->rows().empty()) {
@@ -556,25 +546,37 @@ struct MergeAddImpl {
           input->height(),
           phi::errors::InvalidArgument("All inputs should have same height."));
       row_num += input->rows().size();
-      merged_row_set.insert(input->rows().begin(), input->rows().end());
     }
 
+    // concat the rows of the inputs, and sort them into the segments of the
+    // duplicated rows
+    std::vector<int64_t> concat_rows;
+    std::vector<const T*> value_rows;
+    concat_rows.reserve(row_num);
+    value_rows.reserve(row_num);
+    for (auto* in : inputs) {
+      if (in->rows().empty()) {
+        continue;
+      }
+      auto* in_data = in->value().data<T>();
+      for (size_t i = 0; i < in->rows().size(); ++i) {
+        concat_rows.push_back(in->rows()[i]);
+        value_rows.push_back(in_data + i * input_width);
+      }
+    }
+    RowSegments segments;
+    BuildRowSegments(
+        concat_rows.data(), static_cast<int64_t>(row_num), &segments);
+
     out.set_height(input_height);
     DenseTensor* out_tensor = out.mutable_value();
     out_tensor->Resize(common::make_ddim(
-        {static_cast<int64_t>(merged_row_set.size()), input_width}));
+        {static_cast<int64_t>(segments.size()), input_width}));
     auto* out_data = context.template Alloc<T>(out_tensor);
 
-    if (merged_row_set.size() == row_num && !sorted_result) {
+    if (segments.size() == row_num && !sorted_result) {
       // no duplicated ids, just concat the result together
-      std::vector<int64_t> merge_rows;
-      merge_rows.reserve(row_num);
-      // concat rows
-      for (auto* in : inputs) {
-        merge_rows.insert(
-            merge_rows.end(), in->rows().begin(), in->rows().end());
-      }
-      out.set_rows(merge_rows);
+      out.set_rows(concat_rows);
       auto in_place = inputs[0]->place();
       auto out_place = out.place();
       int64_t copied_numel = 0;
@@ -589,25 +591,11 @@ struct MergeAddImpl {
         copied_numel += static_cast<int64_t>(in_numel);
       }
     } else {
-      std::vector<int64_t> merge_rows(merged_row_set.begin(),
-                                      merged_row_set.end());
-
-      if (sorted_result) {
-        std::sort(merge_rows.begin(), merge_rows.end());
-      }
-
-      out.set_rows(merge_rows);
-
-      phi::funcs::SetConstant<DeviceContext, T> constant_functor;
-      constant_functor(context, out.mutable_value(), static_cast<T>(0.f));
-
-      std::unordered_map<int64_t, size_t> rows_to_id;
-      for (size_t i = 0; i < merge_rows.size(); ++i) {
-        rows_to_id[merge_rows[i]] = i;
-      }
-
-      add_sparse_inputs<T, DeviceContext>(
-          inputs, rows_to_id, input_width, context, out_data);
+      // the segments are sorted by their rows, reduce each of them into
+      // one output row
+      out.set_rows(segments.rows);
+      add_segments<T, DeviceContext>(
+          segments, value_rows, input_width, context, out_data);
     }
   }
 };
@@ -15,9 +15,18 @@ limitations under the License. */
 #include <set>
 #include <vector>
 
+#ifdef __NVCC__
+#include "cub/cub.cuh"
+#endif
+#ifdef __HIPCC__
+#include <hipcub/hipcub.hpp>
+namespace cub = hipcub;
+#endif
+
 #include "glog/logging.h"
 
 #include "paddle/phi/backends/gpu/gpu_primitives.h"
+#include "paddle/phi/common/memory_utils.h"
 #include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/common/float16.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
@@ -370,6 +379,34 @@ __global__ void MergeAddKernel(const T* input,
   }
 }
 
+__global__ void InitRowOrderKernel(int* order, int num) {
+  for (int i = blockIdx.x * blockDim.x + threadIdx.x; i < num;
+       i += blockDim.x * gridDim.x) {
+    order[i] = i;
+  }
+}
+
+// Each block reduces the input rows order[offsets[i]], ...,
+// order[offsets[i] + counts[i] - 1] of the segment i into the out row i.
+template <typename T, int block_size>
+__global__ void MergeSegmentsKernel(const T* input,
+                                    const int* order,
+                                    const int* offsets,
+                                    const int* counts,
+                                    T* out,
+                                    int64_t row_numel) {
+  const int begin = offsets[blockIdx.x];
+  const int end = begin + counts[blockIdx.x];
+  out += static_cast<int64_t>(blockIdx.x) * row_numel;
+  for (int64_t index = threadIdx.x; index < row_numel; index += block_size) {
+    T sum = input[order[begin] * row_numel + index];
+    for (int k = begin + 1; k < end; ++k) {
+      sum += input[order[k] * row_numel + index];
+    }
+    out[index] = sum;
+  }
+}
+
 template <typename DeviceContext, typename T>
 struct MergeAddImpl {
   phi::SelectedRows operator()(const DeviceContext& context,
@@ -389,40 +426,136 @@ struct MergeAddImpl {
       return;
     }
 
+    // Radix sort the rows with their input row indices, and run length encode
+    // the sorted rows into the segments of the duplicated rows, so that each
+    // output row is reduced by one block without atomics. The output rows are
+    // always sorted.
     phi::SelectedRows& out = *output;
-    std::set<int64_t> row_set(input_rows.begin(), input_rows.end());
-    std::vector<int64_t> merge_rows_cpu(row_set.begin(), row_set.end());
-    phi::Vector<int64_t> merge_rows(merge_rows_cpu);
-
     auto input_width = input.value().dims()[1];
+    const int num = static_cast<int>(input_rows.size());
+    auto stream = context.stream();
+    auto place = context.GetPlace();
+    auto alloc_temp = [&](size_t bytes) {
+      return phi::memory_utils::Alloc(
+          place, bytes, phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
+    };
 
-    out.set_rows(merge_rows);
-    out.set_height(input.height());
-    DenseTensor* out_tensor = out.mutable_value();
-    out_tensor->Resize(common::make_ddim(
-        {static_cast<int64_t>(merge_rows.size()), input_width}));
-    context.template Alloc<T>(out_tensor);
-
-    phi::funcs::SetConstant<DeviceContext, T> constant_functor;
-    constant_functor(context, out.mutable_value(), static_cast<T>(0));
-
-    auto* out_data = out.mutable_value()->data<T>();
-    auto* input_data = input.value().data<T>();
+    phi::MixVector<int64_t> mix_vector_input(&input_rows);
+    const int64_t* rows_data = mix_vector_input.CUDAData(place);
+    DenseTensor sorted_rows, unique_rows, order_in, order, counts, offsets;
+    DenseTensor num_runs;
+    sorted_rows.Resize({num});
+    unique_rows.Resize({num});
+    order_in.Resize({num});
+    order.Resize({num});
+    counts.Resize({num});
+    offsets.Resize({num});
+    num_runs.Resize({1});
+    int64_t* sorted_rows_data = context.template Alloc<int64_t>(&sorted_rows);
+    int64_t* unique_rows_data = context.template Alloc<int64_t>(&unique_rows);
+    int* order_in_data = context.template Alloc<int>(&order_in);
+    int* order_data = context.template Alloc<int>(&order);
+    int* counts_data = context.template Alloc<int>(&counts);
+    int* offsets_data = context.template Alloc<int>(&offsets);
+    int* num_runs_data = context.template Alloc<int>(&num_runs);
 
     const int block_size = 256;
-    dim3 threads(block_size, 1);
-    dim3 grid1(input_rows.size(), 1);
+    InitRowOrderKernel<<<(num + block_size - 1) / block_size,
+                         block_size,
+                         0,
+                         stream>>>(order_in_data, num);
+
+    // only the bits below the height need to be sorted
+    int end_bit = static_cast<int>(sizeof(int64_t) * 8);
+    if (input.height() > 0) {
+      end_bit = 1;
+      while (end_bit < 63 && (int64_t(1) << end_bit) < input.height()) {
+        ++end_bit;
+      }
+    }
+    size_t temp_bytes = 0;
+    cub::DeviceRadixSort::SortPairs(nullptr,
+                                    temp_bytes,
+                                    rows_data,
+                                    sorted_rows_data,
+                                    order_in_data,
+                                    order_data,
+                                    num,
+                                    0,
+                                    end_bit,
+                                    stream);
+    auto sort_temp = alloc_temp(temp_bytes);
+    cub::DeviceRadixSort::SortPairs(sort_temp->ptr(),
+                                    temp_bytes,
+                                    rows_data,
+                                    sorted_rows_data,
+                                    order_in_data,
+                                    order_data,
+                                    num,
+                                    0,
+                                    end_bit,
+                                    stream);
+
+    temp_bytes = 0;
+    cub::DeviceRunLengthEncode::Encode(nullptr,
+                                       temp_bytes,
+                                       sorted_rows_data,
+                                       unique_rows_data,
+                                       counts_data,
+                                       num_runs_data,
+                                       num,
+                                       stream);
+    auto encode_temp = alloc_temp(temp_bytes);
+    cub::DeviceRunLengthEncode::Encode(encode_temp->ptr(),
+                                       temp_bytes,
+                                       sorted_rows_data,
+                                       unique_rows_data,
+                                       counts_data,
+                                       num_runs_data,
+                                       num,
+                                       stream);
+    int num_runs_cpu = 0;
+    memory_utils::Copy(phi::CPUPlace(),
+                       &num_runs_cpu,
+                       place,
+                       num_runs_data,
+                       sizeof(int),
+                       stream);
+    context.Wait();
+
+    temp_bytes = 0;
+    cub::DeviceScan::ExclusiveSum(
+        nullptr, temp_bytes, counts_data, offsets_data, num_runs_cpu, stream);
+    auto scan_temp = alloc_temp(temp_bytes);
+    cub::DeviceScan::ExclusiveSum(scan_temp->ptr(),
+                                  temp_bytes,
+                                  counts_data,
+                                  offsets_data,
+                                  num_runs_cpu,
+                                  stream);
 
-    phi::MixVector<int64_t> mix_vector_input(&input_rows);
-    phi::MixVector<int64_t> mix_vector_out(out.mutable_rows());
-    MergeAddKernel<T, 256><<<grid1, threads, 0, context.stream()>>>(
-        input_data,
-        mix_vector_input.CUDAData(context.GetPlace()),
-        out_data,
-        mix_vector_out.CUDAMutableData(context.GetPlace()),
-        out.rows().size(),
-        input_width);
-    mix_vector_out.CopyToCPU();
+    out.set_height(input.height());
+    DenseTensor* out_tensor = out.mutable_value();
+    out_tensor->Resize(common::make_ddim(
+        {static_cast<int64_t>(num_runs_cpu), input_width}));
+    auto* out_data = context.template Alloc<T>(out_tensor);
+    MergeSegmentsKernel<T, block_size>
+        <<<num_runs_cpu, block_size, 0, stream>>>(input.value().data<T>(),
+                                                  order_data,
+                                                  offsets_data,
+                                                  counts_data,
+                                                  out_data,
+                                                  input_width);
+
+    std::vector<int64_t> merge_rows_cpu(num_runs_cpu);
+    memory_utils::Copy(phi::CPUPlace(),
+                       merge_rows_cpu.data(),
+                       place,
+                       unique_rows_data,
+                       num_runs_cpu * sizeof(int64_t),
+                       stream);
+    context.Wait();
+    out.set_rows(merge_rows_cpu);
   }
 
   void operator()(const DeviceContext& context,
@@ -0,0 +1,99 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
+namespace phi {
+namespace funcs {
+
+// The value rows of a SelectedRows grouped by their row ids, the segment i
+// is made of the value rows order[offsets[i]] ... order[offsets[i + 1] - 1],
+// whose id is rows[i]. The rows are sorted in ascending order, and the value
+// rows of a segment keep their original order, so that a segmented reduce
+// over them is deterministic.
+struct RowSegments {
+  std::vector<int64_t> rows;
+  std::vector<int64_t> offsets;
+  std::vector<int64_t> order;
+
+  size_t size() const { return rows.size(); }
+  int64_t begin(size_t i) const { return offsets[i]; }
+  int64_t end(size_t i) const { return offsets[i + 1]; }
+};
+
+// The ids less than it are sorted by one thread.
+constexpr int64_t kRowSegmentsParallelThreshold = 1 << 16;
+
+// Sort the (id, value row) pairs of the num ids, by chunks in parallel and
+// then merging them, and group the equal ids into the segments.
+inline void BuildRowSegments(const int64_t* ids,
+                             int64_t num,
+                             RowSegments* segments) {
+  std::vector<std::pair<int64_t, int64_t>> pairs(num);
+  for (int64_t i = 0; i < num; ++i) {
+    pairs[i] = std::make_pair(ids[i], i);
+  }
+
+  int chunk_num = 1;
+#ifdef PADDLE_WITH_MKLML
+  if (num >= kRowSegmentsParallelThreshold) {
+    chunk_num = std::max(omp_get_max_threads(), 1);
+  }
+#endif
+  std::vector<int64_t> bounds(chunk_num + 1);
+  for (int c = 0; c <= chunk_num; ++c) {
+    bounds[c] = num * c / chunk_num;
+  }
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for num_threads(chunk_num)
+#endif
+  for (int c = 0; c < chunk_num; ++c) {
+    std::sort(pairs.begin() + bounds[c], pairs.begin() + bounds[c + 1]);
+  }
+  // merge the sorted chunks pairwise, the merges of a level are independent
+  for (int step = 1; step < chunk_num; step *= 2) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int c = 0; c < chunk_num - step; c += 2 * step) {
+      int last = std::min(c + 2 * step, chunk_num);
+      std::inplace_merge(pairs.begin() + bounds[c],
+                         pairs.begin() + bounds[c + step],
+                         pairs.begin() + bounds[last]);
+    }
+  }
+
+  segments->rows.clear();
+  segments->offsets.clear();
+  segments->order.resize(num);
+  for (int64_t i = 0; i < num; ++i) {
+    if (i == 0 || pairs[i].first != pairs[i - 1].first) {
+      segments->rows.push_back(pairs[i].first);
+      segments->offsets.push_back(i);
+    }
+    segments->order[i] = pairs[i].second;
+  }
+  segments->offsets.push_back(num);
+}
+
+}  // namespace funcs
+}  // namespace phi
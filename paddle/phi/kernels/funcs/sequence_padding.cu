@@ -15,6 +15,7 @@ limitations under the License. */
 #include <algorithm>
 
 #include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/lod_utils.h"
 #include "paddle/phi/kernels/funcs/sequence_padding.h"
 
 namespace phi {
@@ -123,13 +124,14 @@ class PaddingLoDTensorFunctor<phi::GPUContext, T> {
     T* pad_data = pad_tensor->data<T>();
     const T* pad_value_data = pad_value.data<T>();
 
-    phi::MixVector<size_t> mix_vector_seq_offsets(&seq_offsets);
+    const size_t* seq_offsets_data =
+        phi::GetCachedDeviceLoDOffsets(context.GetPlace(), seq_offsets);
     SequencePaddingKernel<T, kSeqToPad><<<grid, threads, 0, context.stream()>>>(
         pad_data,
         seq_data,
         pad_value_data,
         pad_value.numel() == 1,
-        mix_vector_seq_offsets.CUDAData(context.GetPlace()),
+        seq_offsets_data,
         seq_num,
         pad_seq_len,
         step_width,
@@ -190,13 +192,14 @@ class UnpaddingLoDTensorFunctor<phi::GPUContext, T> {
     const T* pad_data = pad_tensor.data<T>();
     T* seq_data = seq_tensor->data<T>();
 
-    phi::MixVector<size_t> mixv_seq_offsets(&seq_offsets);
+    const size_t* seq_offsets_data =
+        phi::GetCachedDeviceLoDOffsets(context.GetPlace(), seq_offsets);
     SequencePaddingKernel<T, kPadToSeq><<<grid, threads, 0, context.stream()>>>(
         seq_data,
         pad_data,
         nullptr,
         false,
-        mixv_seq_offsets.CUDAData(context.GetPlace()),
+        seq_offsets_data,
         seq_num,
         pad_seq_len,
         step_width,
@@ -17,7 +17,7 @@ limitations under the License. */
 
 #include "paddle/common/macros.h"
 #include "paddle/phi/backends/gpu/gpu_primitives.h"
-#include "paddle/phi/core/mixed_vector.h"
+#include "paddle/phi/core/lod_utils.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 #include "paddle/phi/kernels/funcs/sequence_pooling.h"
 
@@ -203,14 +203,15 @@ class SequencePoolFunctor<phi::GPUContext, T> {
     const size_t item_dim = output->numel() / output->dims()[0];
     dim3 threads(1024, 1);
     dim3 grid(std::max(static_cast<int>(lod.size()) - 1, 1), 1);
-    phi::MixVector<size_t> mix_vector(&lod);
+    const size_t* lod_data =
+        phi::GetCachedDeviceLoDOffsets(context.GetPlace(), lod);
     if (pooltype == "MAX") {
       sequence_pool_kernel<T, MaxPoolFunctor<T>>
           <<<grid, threads, 0, context.stream()>>>(
               MaxPoolFunctor<T>(),
               input.data<T>(),
               pad_value,
-              mix_vector.CUDAData(context.GetPlace()),
+              lod_data,
               lod.size(),
               item_dim,
               context.template Alloc<T>(output),
@@ -221,7 +222,7 @@ class SequencePoolFunctor<phi::GPUContext, T> {
               AvgPoolFunctor<T>(),
               input.data<T>(),
               pad_value,
-              mix_vector.CUDAData(context.GetPlace()),
+              lod_data,
               lod.size(),
               item_dim,
               context.template Alloc<T>(output),
@@ -232,7 +233,7 @@ class SequencePoolFunctor<phi::GPUContext, T> {
               SumPoolFunctor<T>(),
               input.data<T>(),
               pad_value,
-              mix_vector.CUDAData(context.GetPlace()),
+              lod_data,
               lod.size(),
               item_dim,
               context.template Alloc<T>(output),
@@ -243,7 +244,7 @@ class SequencePoolFunctor<phi::GPUContext, T> {
               SqrtPoolFunctor<T>(),
               input.data<T>(),
               pad_value,
-              mix_vector.CUDAData(context.GetPlace()),
+              lod_data,
               lod.size(),
               item_dim,
               context.template Alloc<T>(output),
@@ -254,7 +255,7 @@ class SequencePoolFunctor<phi::GPUContext, T> {
               LastPoolFunctor<T>(),
               input.data<T>(),
               pad_value,
-              mix_vector.CUDAData(context.GetPlace()),
+              lod_data,
               lod.size(),
               item_dim,
               context.template Alloc<T>(output),
@@ -265,7 +266,7 @@ class SequencePoolFunctor<phi::GPUContext, T> {
               FirstPoolFunctor<T>(),
               input.data<T>(),
               pad_value,
-              mix_vector.CUDAData(context.GetPlace()),
+              lod_data,
               lod.size(),
               item_dim,
               context.template Alloc<T>(output),
@@ -421,13 +422,14 @@ class SequencePoolGradFunctor<phi::GPUContext, T> {
     const size_t item_dim = in_grad->numel() / in_grad->dims()[0];
     dim3 threads(1024, 1);
     dim3 grid(std::max(static_cast<int>(lod.size()) - 1, 1), 1);
-    phi::MixVector<size_t> mix_vector(&lod);
+    const size_t* lod_data =
+        phi::GetCachedDeviceLoDOffsets(context.GetPlace(), lod);
     if (pooltype == "MAX") {
       sequence_pool_grad_kernel<T, MaxPoolGradFunctor<T>>
           <<<grid, threads, 0, context.stream()>>>(
               MaxPoolGradFunctor<T>(),
               out_grad.data<T>(),
-              mix_vector.CUDAData(context.GetPlace()),
+              lod_data,
               lod.size(),
               item_dim,
               context.template Alloc<T>(in_grad),
@@ -437,7 +439,7 @@ class SequencePoolGradFunctor<phi::GPUContext, T> {
           <<<grid, threads, 0, context.stream()>>>(
               AvgPoolGradFunctor<T>(),
               out_grad.data<T>(),
-              mix_vector.CUDAData(context.GetPlace()),
+              lod_data,
               lod.size(),
               item_dim,
               context.template Alloc<T>(in_grad),
@@ -447,7 +449,7 @@ class SequencePoolGradFunctor<phi::GPUContext, T> {
           <<<grid, threads, 0, context.stream()>>>(
               SumPoolGradFunctor<T>(),
               out_grad.data<T>(),
-              mix_vector.CUDAData(context.GetPlace()),
+              lod_data,
               lod.size(),
               item_dim,
               context.template Alloc<T>(in_grad),
@@ -457,7 +459,7 @@ class SequencePoolGradFunctor<phi::GPUContext, T> {
           <<<grid, threads, 0, context.stream()>>>(
               SqrtPoolGradFunctor<T>(),
               out_grad.data<T>(),
-              mix_vector.CUDAData(context.GetPlace()),
+              lod_data,
               lod.size(),
               item_dim,
               context.template Alloc<T>(in_grad),
@@ -467,7 +469,7 @@ class SequencePoolGradFunctor<phi::GPUContext, T> {
           <<<grid, threads, 0, context.stream()>>>(
               LastPoolGradFunctor<T>(),
               out_grad.data<T>(),
-              mix_vector.CUDAData(context.GetPlace()),
+              lod_data,
               lod.size(),
               item_dim,
               context.template Alloc<T>(in_grad),
@@ -477,7 +479,7 @@ class SequencePoolGradFunctor<phi::GPUContext, T> {
           <<<grid, threads, 0, context.stream()>>>(
               FirstPoolGradFunctor<T>(),
               out_grad.data<T>(),
-              mix_vector.CUDAData(context.GetPlace()),
+              lod_data,
               lod.size(),
               item_dim,
               context.template Alloc<T>(in_grad),
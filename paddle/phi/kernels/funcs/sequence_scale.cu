@@ -15,7 +15,7 @@ limitations under the License. */
 #include "paddle/phi/kernels/funcs/sequence_scale.h"
 #include "paddle/phi/backends/gpu/gpu_context.h"
 #include "paddle/phi/backends/gpu/gpu_primitives.h"
-#include "paddle/phi/core/mixed_vector.h"
+#include "paddle/phi/core/lod_utils.h"
 
 namespace phi {
 namespace funcs {
@@ -24,7 +24,7 @@ using phi::PADDLE_CUDA_NUM_THREADS;
 
 template <typename T, int BlockSize>
 __global__ void SequenceScaleKernel(T* seq,
-                                    size_t* lod,
+                                    const size_t* lod,
                                     const T* scales,
                                     const size_t seq_width) {
   for (int i = threadIdx.x;
@@ -47,7 +47,8 @@ class ScaleLoDTensorFunctor<phi::GPUContext, T> {
     const size_t seq_width = seq->numel() / seq->dims()[0];
     auto abs_offset_lod = phi::ToAbsOffset(lod);
     T* seq_data = context.template Alloc<T>(seq);
-    phi::MixVector<size_t> mix_vector(&(abs_offset_lod[level]));
+    const size_t* lod_data = phi::GetCachedDeviceLoDOffsets(
+        context.GetPlace(), abs_offset_lod[level]);
 
 #ifdef PADDLE_WITH_HIP
     hipLaunchKernelGGL(
@@ -57,18 +58,17 @@ class ScaleLoDTensorFunctor<phi::GPUContext, T> {
         0,
         context.stream(),
         seq_data,
-        mix_vector.CUDAMutableData(context.GetPlace()),
+        lod_data,
         scales,
         seq_width);
 #else
     SequenceScaleKernel<T, PADDLE_CUDA_NUM_THREADS>
         <<<num_seq, PADDLE_CUDA_NUM_THREADS, 0, context.stream()>>>(
             seq_data,
-            mix_vector.CUDAMutableData(context.GetPlace()),
+            lod_data,
             scales,
             seq_width);
 #endif
-    mix_vector.CopyToCPU();
   }
 };
 
@@ -0,0 +1,182 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cfloat>
+#include <vector>
+
+#ifdef __NVCC__
+#include <cub/cub.cuh>
+#endif
+
+#ifdef __HIPCC__
+#include <hipcub/hipcub.hpp>
+namespace cub = hipcub;
+#endif
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/lod_utils.h"
+#include "paddle/phi/kernels/funcs/math.h"
+
+namespace phi {
+namespace funcs {
+
+// The segmented softmax of a ragged batch: the sequences are in a launch,
+// every block takes a sequence at a time by the LoD offsets, so neither the
+// batch is padded to the longest sequence nor a kernel is launched for every
+// sequence.
+template <typename T, int BlockDim>
+__global__ void SegmentedSoftmaxKernel(const T* in_data,
+                                       const size_t* ref_lod,
+                                       const size_t src_hight,
+                                       T* out_data) {
+  using BlockReduce = cub::BlockReduce<T, BlockDim>;
+  __shared__ typename BlockReduce::TempStorage temp_storage;
+  __shared__ T shared_max_data;
+  __shared__ T shared_sum_data;
+
+  for (int i = blockIdx.x; i < src_hight; i += gridDim.x) {
+    size_t start = ref_lod[i];
+    size_t span = ref_lod[i + 1] - start;
+
+    // Find the max ele
+    T max_ele = -FLT_MAX;
+    for (int tid = threadIdx.x; tid < span; tid += blockDim.x) {
+      T ele = in_data[start + tid];
+      max_ele = max_ele > ele ? max_ele : ele;
+    }
+    max_ele = BlockReduce(temp_storage).Reduce(max_ele, cub::Max());
+    if (threadIdx.x == 0) {
+      shared_max_data = max_ele;
+    }
+    __syncthreads();
+
+    // sum
+    T sum_data = 0;
+    for (int tid = threadIdx.x; tid < span; tid += blockDim.x) {
+      T ele = in_data[start + tid];
+      sum_data += phi::funcs::real_exp(ele - shared_max_data);
+    }
+    sum_data = BlockReduce(temp_storage).Reduce(sum_data, cub::Sum());
+    if (threadIdx.x == 0) {
+      shared_sum_data = sum_data;
+    }
+    __syncthreads();
+
+    // get final resit
+    for (int tid = threadIdx.x; tid < span; tid += blockDim.x) {
+      T ele = in_data[start + tid];
+      ele = phi::funcs::real_exp(ele - shared_max_data) / shared_sum_data;
+      out_data[start + tid] = ele;
+    }
+    __syncthreads();
+  }
+}
+
+template <typename T, int BlockDim>
+__global__ void SegmentedSoftmaxGradKernel(const T* softmax_grad_data,
+                                           const T* softmax_data,
+                                           const size_t* ref_lod,
+                                           const size_t src_hight,
+                                           T* dx_data) {
+  using BlockReduce = cub::BlockReduce<T, BlockDim>;
+  __shared__ typename BlockReduce::TempStorage temp_storage;
+  __shared__ T shared_data;
+
+  for (int i = blockIdx.x; i < src_hight; i += gridDim.x) {
+    size_t start = ref_lod[i];
+    size_t span = ref_lod[i + 1] - start;
+
+    T result = 0;
+    for (int tid = threadIdx.x; tid < span; tid += blockDim.x) {
+      size_t idx = start + tid;
+      T s_g_d = softmax_grad_data[idx];
+      T s_d = softmax_data[idx];
+      result += s_g_d * s_d;
+    }
+    result = BlockReduce(temp_storage).Reduce(result, cub::Sum());
+    if (threadIdx.x == 0) {
+      shared_data = result;
+    }
+    __syncthreads();
+
+    for (int tid = threadIdx.x; tid < span; tid += blockDim.x) {
+      size_t idx = start + tid;
+      T s_g_d = softmax_grad_data[idx];
+      T s_d = softmax_data[idx];
+      dx_data[idx] = (s_g_d - shared_data) * s_d;
+    }
+    __syncthreads();
+  }
+}
+
+// The long sequences take the wide blocks, the short ones the warps, by the
+// mean length of the batch.
+static constexpr size_t kWideSegmentLength = 256;
+
+template <typename T>
+void SegmentedSoftmax(const phi::GPUContext& context,
+                      const T* in_data,
+                      const std::vector<size_t>& ref_lod,
+                      T* out_data) {
+  const size_t height = ref_lod.size() - 1;
+  if (height == 0) return;
+  const size_t* lod_data =
+      phi::GetCachedDeviceLoDOffsets(context.GetPlace(), ref_lod);
+  const int max_threads = context.GetMaxPhysicalThreadCount();
+  if (ref_lod.back() / height >= kWideSegmentLength) {
+    constexpr int kThreadsPerBlock = 256;
+    int blocks = std::max(max_threads / kThreadsPerBlock, 1);
+    SegmentedSoftmaxKernel<T, kThreadsPerBlock>
+        <<<blocks, kThreadsPerBlock, 0, context.stream()>>>(
+            in_data, lod_data, height, out_data);
+  } else {
+    constexpr int kThreadsPerBlock = 32;
+    int blocks = std::max(max_threads / kThreadsPerBlock, 1);
+    SegmentedSoftmaxKernel<T, kThreadsPerBlock>
+        <<<blocks, kThreadsPerBlock, 0, context.stream()>>>(
+            in_data, lod_data, height, out_data);
+  }
+}
+
+template <typename T>
+void SegmentedSoftmaxGrad(const phi::GPUContext& context,
+                          const T* dout_data,
+                          const T* out_data,
+                          const std::vector<size_t>& ref_lod,
+                          T* dx_data) {
+  const size_t height = ref_lod.size() - 1;
+  if (height == 0) return;
+  const size_t* lod_data =
+      phi::GetCachedDeviceLoDOffsets(context.GetPlace(), ref_lod);
+  const int max_threads = context.GetMaxPhysicalThreadCount();
+  if (ref_lod.back() / height >= kWideSegmentLength) {
+    constexpr int kThreadsPerBlock = 256;
+    int blocks = std::max(max_threads / kThreadsPerBlock, 1);
+    SegmentedSoftmaxGradKernel<T, kThreadsPerBlock>
+        <<<blocks, kThreadsPerBlock, 0, context.stream()>>>(
+            dout_data, out_data, lod_data, height, dx_data);
+  } else {
+    constexpr int kThreadsPerBlock = 32;
+    int blocks = std::max(max_threads / kThreadsPerBlock, 1);
+    SegmentedSoftmaxGradKernel<T, kThreadsPerBlock>
+        <<<blocks, kThreadsPerBlock, 0, context.stream()>>>(
+            dout_data, out_data, lod_data, height, dx_data);
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
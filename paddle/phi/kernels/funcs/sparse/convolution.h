@@ -14,6 +14,10 @@ limitations under the License. */
 
 #pragma once
 
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include "paddle/common/ddim.h"
 #include "paddle/phi/core/tensor_utils.h"
 #include "paddle/phi/kernels/funcs/blas/blas.h"
@@ -243,6 +247,51 @@ inline const int* GetCounterPtr(const SparseCooTensor& coo,
   return counter.data<int>();
 }
 
+// The prefix of the keys of the rulebooks that the subm convs without a key
+// cache by themselves.
+constexpr char kAutoRulebookKeyPrefix[] = "__auto_rulebook_";
+
+inline bool IsAutoRulebookKey(const std::string& key) {
+  return key.compare(0, sizeof(kAutoRulebookKeyPrefix) - 1,
+                     kAutoRulebookKeyPrefix) == 0;
+}
+
+// The key of the rulebook of a subm conv of x, by the address of the indices
+// of x and the geometry of the conv but its channels. The subm convs share
+// the indices of x with out, so the layers of the same indices after it have
+// the same key.
+inline std::string AutoRulebookKey(const SparseCooTensor& x,
+                                   const std::vector<int>& kernel_sizes,
+                                   const std::vector<int>& dilations) {
+  std::ostringstream key;
+  key << kAutoRulebookKeyPrefix << x.indices().data() << "_" << x.nnz();
+  for (int i = 0; i < x.dims().size() - 1; ++i) {
+    key << "_" << x.dims()[i];
+  }
+  key << "_k";
+  for (size_t i = 0; i + 2 < kernel_sizes.size(); ++i) {
+    key << "_" << kernel_sizes[i];
+  }
+  key << "_d";
+  for (int dilation : dilations) {
+    key << "_" << dilation;
+  }
+  return key.str();
+}
+
+// The rulebook and the counter to the backward kernel.
+template <typename Context>
+inline void OutputRulebook(const Context& dev_ctx,
+                           const DenseTensor& in_rulebook,
+                           const DenseTensor& h_counter,
+                           DenseTensor* out_rulebook,
+                           DenseTensor* counter) {
+  *out_rulebook = in_rulebook;
+  counter->Resize({h_counter.numel()});
+  int* counter_ptr = dev_ctx.template HostAlloc<int>(counter);
+  memcpy(counter_ptr, h_counter.data<int>(), h_counter.numel() * sizeof(int));
+}
+
 template <typename T, typename IntT, typename Context>
 inline const IntT* PrepareSubm(const Context& dev_ctx,
                                const SparseCooTensor& x,
@@ -264,12 +313,9 @@ inline const IntT* PrepareSubm(const Context& dev_ctx,
 
     *rulebook_len = rulebook.dims()[1];
 
-    DenseTensor out_indices =
-        phi::EmptyLike<IntT>(dev_ctx, x.non_zero_indices());
+    // The indices of out are those of x, shared to find the rulebook again.
     DenseTensor out_values = phi::EmptyLike<T>(dev_ctx, x.non_zero_elements());
-    phi::Copy(
-        dev_ctx, x.non_zero_indices(), dev_ctx.GetPlace(), false, &out_indices);
-    out->SetMember(out_indices, out_values, out_dims, false);
+    out->SetMember(x.non_zero_indices(), out_values, out_dims, false);
     PrefixSum<int>(counter, offsets, counter_size);
     return rulebook.data<IntT>();
   }
@@ -286,13 +332,17 @@ inline void SaveToTable(const Context& dev_ctx,
                         DenseTensor* out_rulebook,
                         DenseTensor* counter) {
   out->SetIndicesDict(x.GetIndicesDict());
-  if (!key.empty()) {
-    out->SaveIndicesPairs(key, std::make_pair(in_rulebook, h_counter));
-  } else {
-    *out_rulebook = in_rulebook;
-    counter->Resize({h_counter.numel()});
-    int* counter_ptr = dev_ctx.template HostAlloc<int>(counter);
-    memcpy(counter_ptr, h_counter.data<int>(), h_counter.numel() * sizeof(int));
+  if (key.empty()) {
+    OutputRulebook(dev_ctx, in_rulebook, h_counter, out_rulebook, counter);
+    return;
+  }
+  out->SaveIndicesPairs(key, std::make_pair(in_rulebook, h_counter));
+  if (IsAutoRulebookKey(key)) {
+    // The table holds the indices of its key, whose address is then not of
+    // any other indices while the key is in the table.
+    out->SaveIndicesPairs(key + "_indices",
+                          std::make_pair(x.non_zero_indices(), DenseTensor()));
+    OutputRulebook(dev_ctx, in_rulebook, h_counter, out_rulebook, counter);
   }
 }
 
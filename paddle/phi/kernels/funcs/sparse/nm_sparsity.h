@@ -0,0 +1,152 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace phi {
+namespace funcs {
+namespace sparse {
+
+// N:M structured sparsity: in every group of m consecutive elements of a row
+// at most n elements are non-zero, e.g. the 2:4 sparsity accelerated by the
+// sparse tensor cores of Ampere. The matrices are row major [rows, cols], and
+// the groups are along the cols, which is the reduction dim of the matmul
+// x * W^T.
+
+inline void CheckNMShape(int64_t cols, int n, int m) {
+  PADDLE_ENFORCE_EQ(
+      n > 0 && n <= m,
+      true,
+      phi::errors::InvalidArgument(
+          "The N:M sparsity requires 0 < N <= M, but received N = %d, M = %d.",
+          n,
+          m));
+  PADDLE_ENFORCE_EQ(cols % m,
+                    0,
+                    phi::errors::InvalidArgument(
+                        "The cols of the N:M sparse matrix should be divisible "
+                        "by M, but received cols = %d, M = %d.",
+                        cols,
+                        m));
+}
+
+template <typename T>
+bool IsNMSparse(const T* data, int64_t rows, int64_t cols, int n, int m) {
+  CheckNMShape(cols, n, m);
+  for (int64_t i = 0; i < rows * cols; i += m) {
+    int nonzeros = 0;
+    for (int j = 0; j < m; ++j) {
+      if (static_cast<float>(data[i + j]) != 0.0f) ++nonzeros;
+    }
+    if (nonzeros > n) return false;
+  }
+  return true;
+}
+
+// Keep the n elements of the largest magnitude in each group, and zero the
+// others.
+template <typename T>
+void PruneNM(const T* in, int64_t rows, int64_t cols, int n, int m, T* out) {
+  CheckNMShape(cols, n, m);
+  std::vector<int> order(m);
+  for (int64_t i = 0; i < rows * cols; i += m) {
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+      return std::abs(static_cast<float>(in[i + a])) >
+             std::abs(static_cast<float>(in[i + b]));
+    });
+    for (int j = 0; j < m; ++j) {
+      out[i + j] = static_cast<T>(0);
+    }
+    for (int j = 0; j < n; ++j) {
+      out[i + order[j]] = in[i + order[j]];
+    }
+  }
+}
+
+// Compress a N:M sparse matrix into the values and their positions in the
+// groups, both of [rows, cols / m * n]. The groups of less than n non-zeros
+// are padded by zeros.
+template <typename T>
+void CompressNM(const T* in,
+                int64_t rows,
+                int64_t cols,
+                int n,
+                int m,
+                T* values,
+                uint8_t* indices) {
+  CheckNMShape(cols, n, m);
+  for (int64_t g = 0, k = 0; g < rows * cols; g += m, k += n) {
+    int kept = 0;
+    for (int j = 0; j < m; ++j) {
+      if (static_cast<float>(in[g + j]) != 0.0f) {
+        PADDLE_ENFORCE_LT(
+            kept,
+            n,
+            phi::errors::InvalidArgument(
+                "The matrix to be compressed is not %d:%d sparse.", n, m));
+        values[k + kept] = in[g + j];
+        indices[k + kept] = static_cast<uint8_t>(j);
+        ++kept;
+      }
+    }
+    for (; kept < n; ++kept) {
+      values[k + kept] = static_cast<T>(0);
+      indices[k + kept] = 0;
+    }
+  }
+}
+
+// out[batch, rows] = x[batch, cols] * W^T, with the compressed N:M sparse W
+// of [rows, cols]. Only the n of every m elements of x are multiplied.
+template <typename T>
+void NMSparseMatmul(const T* x,
+                    int64_t batch,
+                    const T* values,
+                    const uint8_t* indices,
+                    int64_t rows,
+                    int64_t cols,
+                    int n,
+                    int m,
+                    T* out) {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  CheckNMShape(cols, n, m);
+  const int64_t compressed_cols = cols / m * n;
+  for (int64_t b = 0; b < batch; ++b) {
+    const T* x_row = x + b * cols;
+    for (int64_t r = 0; r < rows; ++r) {
+      const T* w_values = values + r * compressed_cols;
+      const uint8_t* w_indices = indices + r * compressed_cols;
+      MT sum = static_cast<MT>(0);
+      for (int64_t k = 0; k < compressed_cols; ++k) {
+        sum += static_cast<MT>(x_row[k / n * m + w_indices[k]]) *
+               static_cast<MT>(w_values[k]);
+      }
+      out[b * rows + r] = static_cast<T>(sum);
+    }
+  }
+}
+
+}  // namespace sparse
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,255 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#ifdef PADDLE_WITH_CUSPARSELT
+#include <cuda.h>
+#endif
+
+#if defined(PADDLE_WITH_CUSPARSELT) && CUDA_VERSION >= 11020
+
+#include <limits>
+#include <string>
+
+#include "paddle/phi/backends/dynload/cusparseLt.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/float16.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace phi {
+namespace funcs {
+namespace sparse {
+
+#define PADDLE_ENFORCE_CUSPARSELT_SUCCESS(call)                          \
+  do {                                                                   \
+    cusparseStatus_t status = (call);                                    \
+    PADDLE_ENFORCE_EQ(status,                                            \
+                      CUSPARSE_STATUS_SUCCESS,                           \
+                      phi::errors::External("cuSPARSELt error code %d.", \
+                                            static_cast<int>(status)));  \
+  } while (0)
+
+template <typename T>
+struct SparseLtDataType;
+
+template <>
+struct SparseLtDataType<float> {
+  static constexpr cudaDataType_t kType = CUDA_R_32F;
+  static constexpr cusparseComputeType kCompute = CUSPARSE_COMPUTE_TF32;
+};
+
+template <>
+struct SparseLtDataType<phi::dtype::float16> {
+  static constexpr cudaDataType_t kType = CUDA_R_16F;
+  static constexpr cusparseComputeType kCompute = CUSPARSE_COMPUTE_16F;
+};
+
+// The 2:4 structured sparse GEMM of the sparse tensor cores by cuSPARSELt:
+// out[m, n] = act(x[m, k] * W^T + bias), where W is the [n, k] row major
+// weight of the 2:4 sparsity along k, compressed once by Compress.
+template <typename T>
+class SparseLtGemm {
+ public:
+  // The dims should be multiples of it for the 16 bytes aligned descriptors.
+  static constexpr int kAlignment = 16;
+
+  SparseLtGemm() {
+    PADDLE_ENFORCE_CUSPARSELT_SUCCESS(phi::dynload::cusparseLtInit(&handle_));
+  }
+
+  ~SparseLtGemm() { phi::dynload::cusparseLtDestroy(&handle_); }
+
+  // Whether cuSPARSELt supports the GEMM on the device.
+  static bool CanBeUsed(const phi::GPUContext& ctx, int m, int n, int k) {
+    return ctx.GetComputeCapability() >= 80 && m % kAlignment == 0 &&
+           n % kAlignment == 0 && k % kAlignment == 0;
+  }
+
+  // Compress the device weight of [n, k] into compressed.
+  void Compress(const phi::GPUContext& ctx,
+                const T* weight,
+                int n,
+                int k,
+                phi::Allocator::AllocationPtr* compressed) {
+    cusparseLtMatDescriptor_t mat_w;
+    InitWeightDescriptor(n, k, &mat_w);
+    size_t compressed_size = 0;
+    PADDLE_ENFORCE_CUSPARSELT_SUCCESS(
+        phi::dynload::cusparseLtSpMMACompressedSize2(
+            &handle_, &mat_w, &compressed_size));
+    *compressed = phi::memory_utils::Alloc(
+        ctx.GetPlace(),
+        compressed_size,
+        phi::Stream(reinterpret_cast<phi::StreamId>(ctx.stream())));
+    PADDLE_ENFORCE_CUSPARSELT_SUCCESS(
+        phi::dynload::cusparseLtSpMMACompress2(&handle_,
+                                               &mat_w,
+                                               0,
+                                               CUSPARSE_OPERATION_TRANSPOSE,
+                                               weight,
+                                               (*compressed)->ptr(),
+                                               ctx.stream()));
+    phi::dynload::cusparseLtMatDescriptorDestroy(&mat_w);
+  }
+
+  // The activation is "", "relu" or "gelu", the bias of [n] may be nullptr.
+  void Matmul(const phi::GPUContext& ctx,
+              const T* x,
+              const void* compressed,
+              int m,
+              int n,
+              int k,
+              const T* bias,
+              const std::string& activation,
+              T* out) {
+    constexpr cudaDataType_t type = SparseLtDataType<T>::kType;
+    cusparseLtMatDescriptor_t mat_x, mat_w, mat_out;
+    cusparseLtMatmulDescriptor_t matmul;
+    cusparseLtMatmulAlgSelection_t alg_sel;
+    cusparseLtMatmulPlan_t plan;
+    PADDLE_ENFORCE_CUSPARSELT_SUCCESS(
+        phi::dynload::cusparseLtDenseDescriptorInit(
+            &handle_, &mat_x, m, k, k, kAlignment, type, CUSPARSE_ORDER_ROW));
+    InitWeightDescriptor(n, k, &mat_w);
+    PADDLE_ENFORCE_CUSPARSELT_SUCCESS(
+        phi::dynload::cusparseLtDenseDescriptorInit(
+            &handle_, &mat_out, m, n, n, kAlignment, type, CUSPARSE_ORDER_ROW));
+    PADDLE_ENFORCE_CUSPARSELT_SUCCESS(
+        phi::dynload::cusparseLtMatmulDescriptorInit(
+            &handle_,
+            &matmul,
+            CUSPARSE_OPERATION_NON_TRANSPOSE,
+            CUSPARSE_OPERATION_TRANSPOSE,
+            &mat_x,
+            &mat_w,
+            &mat_out,
+            &mat_out,
+            SparseLtDataType<T>::kCompute));
+    SetEpilogue(&matmul, bias, activation);
+    PADDLE_ENFORCE_CUSPARSELT_SUCCESS(
+        phi::dynload::cusparseLtMatmulAlgSelectionInit(
+            &handle_, &alg_sel, &matmul, CUSPARSELT_MATMUL_ALG_DEFAULT));
+    size_t workspace_size = 0;
+    PADDLE_ENFORCE_CUSPARSELT_SUCCESS(
+        phi::dynload::cusparseLtMatmulGetWorkspace(
+            &handle_, &alg_sel, &workspace_size));
+    PADDLE_ENFORCE_CUSPARSELT_SUCCESS(phi::dynload::cusparseLtMatmulPlanInit(
+        &handle_, &plan, &matmul, &alg_sel, workspace_size));
+    auto workspace = phi::memory_utils::Alloc(
+        ctx.GetPlace(),
+        workspace_size,
+        phi::Stream(reinterpret_cast<phi::StreamId>(ctx.stream())));
+
+    float alpha = 1.0f;
+    float beta = 0.0f;
+    cudaStream_t stream = ctx.stream();
+    PADDLE_ENFORCE_CUSPARSELT_SUCCESS(
+        phi::dynload::cusparseLtMatmul(&handle_,
+                                       &plan,
+                                       &alpha,
+                                       x,
+                                       compressed,
+                                       &beta,
+                                       out,
+                                       out,
+                                       workspace->ptr(),
+                                       &stream,
+                                       1));
+    phi::dynload::cusparseLtMatmulPlanDestroy(&plan);
+    phi::dynload::cusparseLtMatDescriptorDestroy(&mat_out);
+    phi::dynload::cusparseLtMatDescriptorDestroy(&mat_w);
+    phi::dynload::cusparseLtMatDescriptorDestroy(&mat_x);
+  }
+
+ private:
+  void InitWeightDescriptor(int n, int k, cusparseLtMatDescriptor_t* mat_w) {
+    PADDLE_ENFORCE_CUSPARSELT_SUCCESS(
+        phi::dynload::cusparseLtStructuredDescriptorInit(
+            &handle_,
+            mat_w,
+            n,
+            k,
+            k,
+            kAlignment,
+            SparseLtDataType<T>::kType,
+            CUSPARSE_ORDER_ROW,
+            CUSPARSELT_SPARSITY_50_PERCENT));
+  }
+
+  void SetEpilogue(cusparseLtMatmulDescriptor_t* matmul,
+                   const T* bias,
+                   const std::string& activation) {
+    int true_value = 1;
+    if (activation == "relu") {
+      float relu_upper_bound = std::numeric_limits<float>::max();
+      float relu_threshold = 0.0f;
+      PADDLE_ENFORCE_CUSPARSELT_SUCCESS(
+          phi::dynload::cusparseLtMatmulDescSetAttribute(
+              &handle_,
+              matmul,
+              CUSPARSELT_MATMUL_ACTIVATION_RELU,
+              &true_value,
+              sizeof(true_value)));
+      PADDLE_ENFORCE_CUSPARSELT_SUCCESS(
+          phi::dynload::cusparseLtMatmulDescSetAttribute(
+              &handle_,
+              matmul,
+              CUSPARSELT_MATMUL_ACTIVATION_RELU_UPPERBOUND,
+              &relu_upper_bound,
+              sizeof(relu_upper_bound)));
+      PADDLE_ENFORCE_CUSPARSELT_SUCCESS(
+          phi::dynload::cusparseLtMatmulDescSetAttribute(
+              &handle_,
+              matmul,
+              CUSPARSELT_MATMUL_ACTIVATION_RELU_THRESHOLD,
+              &relu_threshold,
+              sizeof(relu_threshold)));
+    } else if (activation == "gelu") {
+      PADDLE_ENFORCE_CUSPARSELT_SUCCESS(
+          phi::dynload::cusparseLtMatmulDescSetAttribute(
+              &handle_,
+              matmul,
+              CUSPARSELT_MATMUL_ACTIVATION_GELU,
+              &true_value,
+              sizeof(true_value)));
+    } else {
+      PADDLE_ENFORCE_EQ(activation.empty(),
+                        true,
+                        phi::errors::InvalidArgument(
+                            "The activation of the 2:4 sparse GEMM should be "
+                            "relu, gelu or empty, but received %s.",
+                            activation));
+    }
+    if (bias != nullptr) {
+      const void* bias_ptr = bias;
+      PADDLE_ENFORCE_CUSPARSELT_SUCCESS(
+          phi::dynload::cusparseLtMatmulDescSetAttribute(
+              &handle_,
+              matmul,
+              CUSPARSELT_MATMUL_BIAS_POINTER,
+              &bias_ptr,
+              sizeof(bias_ptr)));
+    }
+  }
+
+  cusparseLtHandle_t handle_;
+};
+
+}  // namespace sparse
+}  // namespace funcs
+}  // namespace phi
+
+#endif
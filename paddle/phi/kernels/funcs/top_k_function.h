@@ -0,0 +1,197 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/backends/cpu/intra_op_thread_pool.h"
+
+namespace phi {
+namespace funcs {
+
+// Runs fn(begin, end) over the rows, on the intra op thread pool of the
+// context if it has one, or else by OpenMP.
+template <typename Fn>
+void ParallelForRows(const CPUContext& dev_ctx,
+                     int64_t rows,
+                     int64_t grain,
+                     const Fn& fn) {
+  auto* pool = dev_ctx.intra_op_thread_pool();
+  if (pool != nullptr && rows > grain) {
+    pool->ParallelFor(0, rows, grain, fn);
+    return;
+  }
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t i = 0; i < rows; ++i) {
+    fn(i, i + 1);
+  }
+}
+
+// The rows of about 64KB for a chunk of the row parallel loops.
+template <typename T>
+int64_t RowGrain(int64_t width) {
+  return std::max<int64_t>(
+      1, (64 << 10) / std::max<int64_t>(1, width * sizeof(T)));
+}
+
+// Whether a ranks before b. The NaNs rank as the largest values, and the ties
+// rank by the indices, so that the selection is deterministic.
+template <typename T>
+struct TopKBefore {
+  bool largest;
+
+  bool operator()(const std::pair<T, int64_t>& a,
+                  const std::pair<T, int64_t>& b) const {
+    const bool a_nan = std::isnan(static_cast<double>(a.first));
+    const bool b_nan = std::isnan(static_cast<double>(b.first));
+    if (a_nan != b_nan) return largest ? a_nan : b_nan;
+    if (!a_nan && a.first != b.first) {
+      return largest ? a.first > b.first : a.first < b.first;
+    }
+    return a.second < b.second;
+  }
+};
+
+// Selects the top k of the values pushed in blocks, by a heap whose front is
+// the k-th value. A block of the values is first compared to the k-th value
+// as a whole, in a loop without branches that the compiler vectorizes, so
+// that most of the blocks are skipped without touching the heap.
+template <typename T>
+class TopKSelector {
+ public:
+  static constexpr int64_t kBlock = 16;
+
+  TopKSelector(int k, bool largest) : k_(k), before_{largest} {
+    heap_.reserve(k);
+  }
+
+  void Reset() { heap_.clear(); }
+
+  // The number of the selected values, less than k only if fewer were pushed.
+  int64_t size() const { return static_cast<int64_t>(heap_.size()); }
+
+  // Pushes the values, whose indices start at offset.
+  void Push(const T* values, int64_t count, int64_t offset) {
+    int64_t i = 0;
+    while (i < count && static_cast<int>(heap_.size()) < k_) {
+      heap_.emplace_back(values[i], offset + i);
+      ++i;
+      if (static_cast<int>(heap_.size()) == k_) {
+        std::make_heap(heap_.begin(), heap_.end(), before_);
+      }
+    }
+    while (i < count) {
+      const T kth = heap_.front().first;
+      if (!std::isnan(static_cast<double>(kth)) && i + kBlock <= count) {
+        bool hit = false;
+        const T* block = values + i;
+        if (before_.largest) {
+          // Also true for a NaN, which ranks before the k-th value.
+          for (int64_t e = 0; e < kBlock; ++e) {
+            hit |= !(block[e] <= kth);
+          }
+        } else {
+          for (int64_t e = 0; e < kBlock; ++e) {
+            hit |= block[e] < kth;
+          }
+        }
+        if (!hit) {
+          i += kBlock;
+          continue;
+        }
+      }
+      const int64_t end = std::min(count, i + kBlock);
+      for (; i < end; ++i) {
+        std::pair<T, int64_t> candidate(values[i], offset + i);
+        if (before_(candidate, heap_.front())) {
+          std::pop_heap(heap_.begin(), heap_.end(), before_);
+          heap_.back() = candidate;
+          std::push_heap(heap_.begin(), heap_.end(), before_);
+        }
+      }
+    }
+  }
+
+  // Writes the selected values in the rank order.
+  void Finish(T* out_values, int64_t* out_indices) {
+    std::sort(heap_.begin(), heap_.end(), before_);
+    for (size_t j = 0; j < heap_.size(); ++j) {
+      out_values[j] = heap_[j].first;
+      out_indices[j] = heap_[j].second;
+    }
+  }
+
+ private:
+  int k_;
+  TopKBefore<T> before_;
+  std::vector<std::pair<T, int64_t>> heap_;
+};
+
+// The top k of a row in the rank order. The heap of TopKSelector is used when
+// k is small against the width, or else a selection over all the pairs.
+template <typename T>
+void TopKRow(const T* row,
+             int64_t width,
+             int k,
+             bool largest,
+             T* out_values,
+             int64_t* out_indices) {
+  if (static_cast<int64_t>(k) * TopKSelector<T>::kBlock <= width) {
+    TopKSelector<T> selector(k, largest);
+    selector.Push(row, width, 0);
+    selector.Finish(out_values, out_indices);
+    return;
+  }
+  std::vector<std::pair<T, int64_t>> pairs(width);
+  for (int64_t j = 0; j < width; ++j) {
+    pairs[j] = std::pair<T, int64_t>(row[j], j);
+  }
+  TopKBefore<T> before{largest};
+  std::nth_element(pairs.begin(), pairs.begin() + k - 1, pairs.end(), before);
+  std::sort(pairs.begin(), pairs.begin() + k, before);
+  for (int j = 0; j < k; ++j) {
+    out_values[j] = pairs[j].first;
+    out_indices[j] = pairs[j].second;
+  }
+}
+
+// Sorts a row, the ties stay in the order of the indices.
+template <typename T>
+void SortRow(const T* row,
+             int64_t width,
+             bool descending,
+             std::vector<std::pair<T, int64_t>>* pairs,
+             T* out_values,
+             int64_t* out_indices) {
+  pairs->resize(width);
+  for (int64_t j = 0; j < width; ++j) {
+    (*pairs)[j] = std::pair<T, int64_t>(row[j], j);
+  }
+  std::sort(pairs->begin(), pairs->end(), TopKBefore<T>{descending});
+  for (int64_t j = 0; j < width; ++j) {
+    out_values[j] = (*pairs)[j].first;
+    out_indices[j] = (*pairs)[j].second;
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -16,6 +16,7 @@ limitations under the License. */
 
 #include <assert.h>
 #include <stdint.h>
+#include <algorithm>
 #include <cmath>
 #include "paddle/phi/backends/gpu/gpu_context.h"
 #include "paddle/phi/common/amp_type_traits.h"
@@ -612,8 +613,9 @@ struct WeightOnlyScaleLoader {
     }
   }
 
-  __device__ __forceinline__ void advance() {
-    _offset += BlockSize * Details::kElemsPerThread / Details::kInterleave;
+  __device__ __forceinline__ void advance(int steps = 1) {
+    _offset +=
+        steps * BlockSize * Details::kElemsPerThread / Details::kInterleave;
   }
 
   __device__ __forceinline__ int offset() { return _offset; }
@@ -898,14 +900,17 @@ template <typename T,
           int NPerBlock,
           int Batch,
           int BlockSize>
-__global__ void weight_only_batched_gemv_multi_warp(const T* in,
-                                                    const int8_t* qweight,
-                                                    const T* bias,
-                                                    const T* scales,
-                                                    const T* zeros,
-                                                    T* out,
-                                                    const int n,
-                                                    const int k) {
+__global__ void weight_only_batched_gemv_multi_warp(
+    const T* in,
+    const int8_t* qweight,
+    const T* bias,
+    const T* scales,
+    const T* zeros,
+    T* out,
+    const int n,
+    const int k,
+    float* split_k_out,
+    const int k_iters_per_split) {
   static_assert(NPerBlock == 1 || (NPerBlock % 2 == 0),
                 "NPerBlock must be 1 or even in gemv multi warp kernel. ");
   using Details = WeightOnlyKernelDetails<QType>;
@@ -925,6 +930,10 @@ __global__ void weight_only_batched_gemv_multi_warp(const T* in,
   const int tid = threadIdx.x;
   const int bid = blockIdx.x;
   const int n_start_id = bid * NPerBlock * Interleave;
+  // every split of k is computed by a block of blockIdx.y
+  constexpr int kStepK = BlockSize * Details::kElemsPerThread;
+  const int k_begin = blockIdx.y * k_iters_per_split * kStepK;
+  const int k_end = min(k * Interleave, k_begin + k_iters_per_split * kStepK);
   using HALF_2_TYPE = typename CUDA_HALF_2_TYPE_TARIS<T>::type;
   // Calculate the n-dimensional index of the data processed by the current
   // thread in the interleave tile
@@ -932,6 +941,7 @@ __global__ void weight_only_batched_gemv_multi_warp(const T* in,
 
   qweight += n_start_id * k / Details::kElemsPerByte;
   ScaleLoader scale_loader(scales, zeros, n_start_id + interleave_n_id, n);
+  scale_loader.advance(blockIdx.y * k_iters_per_split);
 
   float(*sm)[Num * Interleave] =
       reinterpret_cast<float(*)[Num * Interleave]>(shmem);
@@ -944,8 +954,8 @@ __global__ void weight_only_batched_gemv_multi_warp(const T* in,
   }
 
   // Iteration in k dimensions
-  for (int local_k = tid * Details::kElemsPerThread; local_k < k * Interleave;
-       local_k += BlockSize * Details::kElemsPerThread) {
+  for (int local_k = k_begin + tid * Details::kElemsPerThread; local_k < k_end;
+       local_k += kStepK) {
     T weights_f16[Details::kElemsPerThread * NPerBlock];
     T scale[NPerBlock], zero[NPerBlock];
 #pragma unroll
@@ -1033,6 +1043,12 @@ __global__ void weight_only_batched_gemv_multi_warp(const T* in,
     for (int j = 0; j < BlockSize / WarpSize; ++j) {
       v += sm[j][i];
     }
+    int b = i / NPerBlock / Interleave;
+    if (split_k_out != nullptr) {
+      // the bias and activation are applied after all splits are summed
+      atomicAdd(split_k_out + b * n + n_start_id + nid, v);
+      continue;
+    }
     float bias_v = 0.f;
 #ifndef WIN32
     if constexpr (Bias) {
@@ -1041,11 +1057,104 @@ __global__ void weight_only_batched_gemv_multi_warp(const T* in,
 #endif
       bias_v = ConvertFloatFunc<T>::apply(bias[n_start_id + nid]);
     }
-    int b = i / NPerBlock / Interleave;
     out[b * n + n_start_id + nid] = ConvertDstFunc<T>::apply(
         GeluActivation<float, Gelu>::apply(v + bias_v));
   }
 }
+
+template <typename T, bool Gelu, bool Bias>
+__global__ void weight_only_gemv_split_k_epilogue(const float* split_k_out,
+                                                  const T* bias,
+                                                  T* out,
+                                                  const int m,
+                                                  const int n) {
+  for (int i = blockIdx.x * blockDim.x + threadIdx.x; i < m * n;
+       i += gridDim.x * blockDim.x) {
+    float v = split_k_out[i];
+#ifndef WIN32
+    if constexpr (Bias) {
+#else
+    if (Bias) {
+#endif
+      v += ConvertFloatFunc<T>::apply(bias[i % n]);
+    }
+    out[i] = ConvertDstFunc<T>::apply(GeluActivation<float, Gelu>::apply(v));
+  }
+}
+
+// Split k when the blocks along n can not fill the GPU, which is common for
+// the small n of decoding. The splits are summed by atomicAdd in float.
+int GetWeightOnlyGemvSplitK(int n_blocks, int k_iters, int sm_count) {
+  constexpr int kMaxSplitK = 8;
+  // two waves of blocks keep the memory bandwidth busy
+  int split_k = (2 * sm_count + n_blocks - 1) / n_blocks;
+  return std::max(1, std::min({split_k, k_iters, kMaxSplitK}));
+}
+
+template <typename T,
+          WeightOnlyQuantType QType,
+          typename WeightOnlyFlag,
+          bool Gelu,
+          bool Bias,
+          int NPerBlock,
+          int Batch,
+          int BlockSize>
+void launch_weight_only_gemv(const phi::GPUContext& dev_ctx,
+                             const T* input,
+                             const int8_t* weight,
+                             const T* bias,
+                             const T* scales,
+                             const int n,
+                             const int k,
+                             T* output) {
+  using Details = WeightOnlyKernelDetails<QType>;
+  constexpr int kInterleave = Details::kInterleave;
+  constexpr int kStepK = BlockSize * Details::kElemsPerThread;
+  auto stream = dev_ctx.stream();
+  dim3 grid(n / NPerBlock / kInterleave);
+  dim3 block(BlockSize);
+  int size = sizeof(float) * BlockSize / 32 * Batch * NPerBlock * kInterleave;
+
+  int k_iters = (k * kInterleave + kStepK - 1) / kStepK;
+  int split_k = GetWeightOnlyGemvSplitK(grid.x, k_iters, dev_ctx.GetSMCount());
+  int k_iters_per_split = (k_iters + split_k - 1) / split_k;
+  split_k = (k_iters + k_iters_per_split - 1) / k_iters_per_split;
+  grid.y = split_k;
+  DenseTensor split_k_buffer;
+  float* split_k_out = nullptr;
+  if (split_k > 1) {
+    split_k_buffer.Resize({Batch, n});
+    split_k_out = dev_ctx.template Alloc<float>(&split_k_buffer);
+    cudaMemsetAsync(split_k_out, 0, sizeof(float) * Batch * n, stream);
+  }
+
+  weight_only_batched_gemv_multi_warp<T,
+                                      QType,
+                                      WeightOnlyFlag,
+                                      Gelu,
+                                      false,
+                                      Bias,
+                                      NPerBlock,
+                                      Batch,
+                                      BlockSize>
+      <<<grid, block, size, stream>>>(input,
+                                      weight,
+                                      bias,
+                                      scales,
+                                      /*zeros*/ nullptr,
+                                      output,
+                                      n,
+                                      k,
+                                      split_k_out,
+                                      k_iters_per_split);
+  if (split_k > 1) {
+    constexpr int kEpilogueThreads = 256;
+    int epilogue_blocks = (Batch * n + kEpilogueThreads - 1) / kEpilogueThreads;
+    weight_only_gemv_split_k_epilogue<T, Gelu, Bias>
+        <<<epilogue_blocks, kEpilogueThreads, 0, stream>>>(
+            split_k_out, bias, output, Batch, n);
+  }
+}
 #endif
 
 template <typename T,
@@ -1054,87 +1163,77 @@ template <typename T,
           int NPerBlock,
           int Batch,
           int BlockSize>
-void select_activation_and_bias(const T* input,
+void select_activation_and_bias(const phi::GPUContext& dev_ctx,
+                                const T* input,
                                 const int8_t* weight,
                                 const T* bias,
                                 const T* scales,
-                                const int m,
                                 const int n,
                                 const int k,
                                 const std::string& act_method,
-                                T* output,
-                                cudaStream_t stream) {
+                                T* output) {
 #ifdef PADDLE_WITH_CUDA
-  static constexpr int kInterleave = WeightLayoutDetails<QType>::kInterleave;
-  dim3 grid(n / NPerBlock / kInterleave);
-  dim3 block(BlockSize);
-  int size = sizeof(float) * BlockSize / 32 * Batch * NPerBlock * kInterleave;
+  if (act_method != "gelu" && act_method != "None") {
+    PADDLE_THROW(
+        errors::InvalidArgument("Currently, weightonly GEMV act_method "
+                                "only support `gelu`, `None`. "));
+  }
+  bool gelu = act_method == "gelu";
   if (bias) {
-    if (act_method == "gelu") {
-      weight_only_batched_gemv_multi_warp<T,
-                                          QType,
-                                          WeightOnlyFlag,
-                                          true,
-                                          false,
-                                          true,
-                                          NPerBlock,
-                                          Batch,
-                                          BlockSize>
-          <<<grid, block, size, stream>>>(
-              input, weight, bias, scales, /*zeros*/ nullptr, output, n, k);
-    } else if (act_method == "None") {
-      weight_only_batched_gemv_multi_warp<T,
-                                          QType,
-                                          WeightOnlyFlag,
-                                          false,
-                                          false,
-                                          true,
-                                          NPerBlock,
-                                          Batch,
-                                          BlockSize>
-          <<<grid, block, size, stream>>>(
-              input, weight, bias, scales, /*zeros*/ nullptr, output, n, k);
+    if (gelu) {
+      launch_weight_only_gemv<T,
+                              QType,
+                              WeightOnlyFlag,
+                              true,
+                              true,
+                              NPerBlock,
+                              Batch,
+                              BlockSize>(
+          dev_ctx, input, weight, bias, scales, n, k, output);
     } else {
-      PADDLE_THROW(
-          errors::InvalidArgument("Currently, weightonly GEMV act_method "
-                                  "only support `gelu`, `None`. "));
+      launch_weight_only_gemv<T,
+                              QType,
+                              WeightOnlyFlag,
+                              false,
+                              true,
+                              NPerBlock,
+                              Batch,
+                              BlockSize>(
+          dev_ctx, input, weight, bias, scales, n, k, output);
     }
   } else {
-    if (act_method == "gelu") {
-      weight_only_batched_gemv_multi_warp<T,
-                                          QType,
-                                          WeightOnlyFlag,
-                                          true,
-                                          false,
-                                          false,
-                                          NPerBlock,
-                                          Batch,
-                                          BlockSize>
-          <<<grid, block, size, stream>>>(
-              input, weight, bias, scales, /*zeros*/ nullptr, output, n, k);
-    } else if (act_method == "None") {
-      weight_only_batched_gemv_multi_warp<T,
-                                          QType,
-                                          WeightOnlyFlag,
-                                          false,
-                                          false,
-                                          false,
-                                          NPerBlock,
-                                          Batch,
-                                          BlockSize>
-          <<<grid, block, size, stream>>>(
-              input, weight, bias, scales, /*zeros*/ nullptr, output, n, k);
+    if (gelu) {
+      launch_weight_only_gemv<T,
+                              QType,
+                              WeightOnlyFlag,
+                              true,
+                              false,
+                              NPerBlock,
+                              Batch,
+                              BlockSize>(
+          dev_ctx, input, weight, bias, scales, n, k, output);
     } else {
-      PADDLE_THROW(
-          errors::InvalidArgument("Currently, weightonly GEMV act_method "
-                                  "only support `gelu`, `None`. "));
+      launch_weight_only_gemv<T,
+                              QType,
+                              WeightOnlyFlag,
+                              false,
+                              false,
+                              NPerBlock,
+                              Batch,
+                              BlockSize>(
+          dev_ctx, input, weight, bias, scales, n, k, output);
     }
   }
 #endif
 }
 
+// The max batch of a gemv kernel, a larger batch runs in chunks that read the
+// weight again, mostly from the L2 cache.
+constexpr int kWeightOnlyGemvChunkBatch = 4;
+
 template <typename T, typename WeightOnlyFlag>
 void weight_only_batched_gemv_launcher(
+    const phi::GPUContext& dev_ctx,
     const T* input,
     const int8_t* weight,
     const T* bias,
@@ -1144,108 +1243,166 @@ void weight_only_batched_gemv_launcher(
     int k,
     const std::string& weight_only_quant_type,
     const std::string& act_method,
-    T* output,
-    cudaStream_t stream) {
+    T* output) {
 #ifdef PADDLE_WITH_CUDA
-  if (weight_only_quant_type == "int4") {
-    switch (m) {
-      case 1: {
-        select_activation_and_bias<T,
-                                   WeightOnlyQuantType::Int4b,
-                                   WeightOnlyFlag,
-                                   1,
-                                   1,
-                                   192>(
-            input, weight, bias, scales, m, n, k, act_method, output, stream);
-        break;
-      }
-      case 2: {
-        select_activation_and_bias<T,
-                                   WeightOnlyQuantType::Int4b,
-                                   WeightOnlyFlag,
-                                   2,
-                                   2,
-                                   128>(
-            input, weight, bias, scales, m, n, k, act_method, output, stream);
-        break;
-      }
-      case 3: {
-        select_activation_and_bias<T,
-                                   WeightOnlyQuantType::Int4b,
-                                   WeightOnlyFlag,
-                                   2,
-                                   3,
-                                   256>(
-            input, weight, bias, scales, m, n, k, act_method, output, stream);
-        break;
-      }
-      case 4: {
-        select_activation_and_bias<T,
-                                   WeightOnlyQuantType::Int4b,
-                                   WeightOnlyFlag,
-                                   4,
-                                   4,
-                                   256>(
-            input, weight, bias, scales, m, n, k, act_method, output, stream);
-        break;
-      }
-      default: {
-        throw std::runtime_error(
-            "Weight only cuda kernel only supported bs <= 4");
-        break;
-      }
-    }
-  } else if (weight_only_quant_type == "int8") {
-    switch (m) {
-      case 1: {
-        select_activation_and_bias<T,
-                                   WeightOnlyQuantType::Int8b,
-                                   WeightOnlyFlag,
-                                   2,
-                                   1,
-                                   256>(
-            input, weight, bias, scales, m, n, k, act_method, output, stream);
-        break;
-      }
-      case 2: {
-        select_activation_and_bias<T,
-                                   WeightOnlyQuantType::Int8b,
-                                   WeightOnlyFlag,
-                                   2,
-                                   2,
-                                   256>(
-            input, weight, bias, scales, m, n, k, act_method, output, stream);
-        break;
-      }
-      case 3: {
-        select_activation_and_bias<T,
-                                   WeightOnlyQuantType::Int8b,
-                                   WeightOnlyFlag,
-                                   2,
-                                   3,
-                                   256>(
-            input, weight, bias, scales, m, n, k, act_method, output, stream);
-        break;
-      }
-      case 4: {
-        select_activation_and_bias<T,
-                                   WeightOnlyQuantType::Int8b,
-                                   WeightOnlyFlag,
-                                   2,
-                                   4,
-                                   256>(
-            input, weight, bias, scales, m, n, k, act_method, output, stream);
-        break;
+  if (weight_only_quant_type != "int4" && weight_only_quant_type != "int8") {
+    PADDLE_THROW(phi::errors::InvalidArgument(
+        "WeightOnlyGemvKernel quant_type only support 'int4' or 'int8'."));
+  }
+  for (int m_offset = 0; m_offset < m;
+       m_offset += kWeightOnlyGemvChunkBatch) {
+    int batch = std::min(kWeightOnlyGemvChunkBatch, m - m_offset);
+    const T* chunk_input = input + static_cast<int64_t>(m_offset) * k;
+    T* chunk_output = output + static_cast<int64_t>(m_offset) * n;
+    if (weight_only_quant_type == "int4") {
+      switch (batch) {
+        case 1: {
+          select_activation_and_bias<T,
+                                     WeightOnlyQuantType::Int4b,
+                                     WeightOnlyFlag,
+                                     1,
+                                     1,
+                                     192>(dev_ctx,
+                                          chunk_input,
+                                          weight,
+                                          bias,
+                                          scales,
+                                          n,
+                                          k,
+                                          act_method,
+                                          chunk_output);
+          break;
+        }
+        case 2: {
+          select_activation_and_bias<T,
+                                     WeightOnlyQuantType::Int4b,
+                                     WeightOnlyFlag,
+                                     2,
+                                     2,
+                                     128>(dev_ctx,
+                                          chunk_input,
+                                          weight,
+                                          bias,
+                                          scales,
+                                          n,
+                                          k,
+                                          act_method,
+                                          chunk_output);
+          break;
+        }
+        case 3: {
+          select_activation_and_bias<T,
+                                     WeightOnlyQuantType::Int4b,
+                                     WeightOnlyFlag,
+                                     2,
+                                     3,
+                                     256>(dev_ctx,
+                                          chunk_input,
+                                          weight,
+                                          bias,
+                                          scales,
+                                          n,
+                                          k,
+                                          act_method,
+                                          chunk_output);
+          break;
+        }
+        case 4: {
+          select_activation_and_bias<T,
+                                     WeightOnlyQuantType::Int4b,
+                                     WeightOnlyFlag,
+                                     4,
+                                     4,
+                                     256>(dev_ctx,
+                                          chunk_input,
+                                          weight,
+                                          bias,
+                                          scales,
+                                          n,
+                                          k,
+                                          act_method,
+                                          chunk_output);
+          break;
+        }
+        default: {
+          break;
+        }
       }
-      default: {
-        throw std::runtime_error(
-            "Weight only cuda kernel only supported bs <= 4");
-        break;
+    } else {
+      switch (batch) {
+        case 1: {
+          select_activation_and_bias<T,
+                                     WeightOnlyQuantType::Int8b,
+                                     WeightOnlyFlag,
+                                     2,
+                                     1,
+                                     256>(dev_ctx,
+                                          chunk_input,
+                                          weight,
+                                          bias,
+                                          scales,
+                                          n,
+                                          k,
+                                          act_method,
+                                          chunk_output);
+          break;
+        }
+        case 2: {
+          select_activation_and_bias<T,
+                                     WeightOnlyQuantType::Int8b,
+                                     WeightOnlyFlag,
+                                     2,
+                                     2,
+                                     256>(dev_ctx,
+                                          chunk_input,
+                                          weight,
+                                          bias,
+                                          scales,
+                                          n,
+                                          k,
+                                          act_method,
+                                          chunk_output);
+          break;
+        }
+        case 3: {
+          select_activation_and_bias<T,
+                                     WeightOnlyQuantType::Int8b,
+                                     WeightOnlyFlag,
+                                     2,
+                                     3,
+                                     256>(dev_ctx,
+                                          chunk_input,
+                                          weight,
+                                          bias,
+                                          scales,
+                                          n,
+                                          k,
+                                          act_method,
+                                          chunk_output);
+          break;
+        }
+        case 4: {
+          select_activation_and_bias<T,
+                                     WeightOnlyQuantType::Int8b,
+                                     WeightOnlyFlag,
+                                     2,
+                                     4,
+                                     256>(dev_ctx,
+                                          chunk_input,
+                                          weight,
+                                          bias,
+                                          scales,
+                                          n,
+                                          k,
+                                          act_method,
+                                          chunk_output);
+          break;
+        }
+        default: {
+          break;
+        }
       }
     }
-  } else {
-    PADDLE_THROW(phi::errors::InvalidArgument(
-        "WeightOnlyGemvKernel quant_type only support 'int4' or 'int8'."));
   }
 #endif
 }
@@ -1274,6 +1431,7 @@ void WeightOnlyGemvWrapper(const Context& dev_ctx,
                           "group size must be -1 in per-channel mode."));
 
     weight_only_batched_gemv_launcher<DataType, WeightOnlyPerChannel>(
+        dev_ctx,
         reinterpret_cast<const DataType*>(input),
         reinterpret_cast<const int8_t*>(weight),
         reinterpret_cast<const DataType*>(bias),
@@ -1283,11 +1441,11 @@ void WeightOnlyGemvWrapper(const Context& dev_ctx,
         k,
         weight_only_quant_type,
         act_method,
-        reinterpret_cast<DataType*>(output),
-        dev_ctx.stream());
+        reinterpret_cast<DataType*>(output));
   } else if (weight_only_type == "group_wise") {
     if (group_size == 64) {
       weight_only_batched_gemv_launcher<DataType, WeightOnlyGroupWise<64>>(
+          dev_ctx,
           reinterpret_cast<const DataType*>(input),
           reinterpret_cast<const int8_t*>(weight),
           reinterpret_cast<const DataType*>(bias),
@@ -1297,10 +1455,10 @@ void WeightOnlyGemvWrapper(const Context& dev_ctx,
           k,
           weight_only_quant_type,
           act_method,
-          reinterpret_cast<DataType*>(output),
-          dev_ctx.stream());
+          reinterpret_cast<DataType*>(output));
     } else if (group_size == 128) {
       weight_only_batched_gemv_launcher<DataType, WeightOnlyGroupWise<128>>(
+          dev_ctx,
           reinterpret_cast<const DataType*>(input),
           reinterpret_cast<const int8_t*>(weight),
           reinterpret_cast<const DataType*>(bias),
@@ -1310,8 +1468,7 @@ void WeightOnlyGemvWrapper(const Context& dev_ctx,
           k,
           weight_only_quant_type,
           act_method,
-          reinterpret_cast<DataType*>(output),
-          dev_ctx.stream());
+          reinterpret_cast<DataType*>(output));
     } else {
       PADDLE_THROW(phi::errors::InvalidArgument(
           "WeightOnlyGemvKernel group_size only support 64 or 128."));
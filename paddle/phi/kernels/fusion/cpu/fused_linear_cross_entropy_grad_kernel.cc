@@ -0,0 +1,180 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+
+namespace phi {
+namespace fusion {
+
+template <typename T, typename LabelT>
+void FusedLinearCrossEntropyGradImpl(const CPUContext& dev_ctx,
+                                     const DenseTensor& x,
+                                     const DenseTensor& weight,
+                                     const DenseTensor& label,
+                                     const DenseTensor& lse,
+                                     const DenseTensor& loss_grad,
+                                     int64_t ignore_index,
+                                     int64_t chunk_size,
+                                     int64_t start_index,
+                                     DenseTensor* x_grad,
+                                     DenseTensor* weight_grad) {
+  const int64_t hidden = weight.dims()[0];
+  const int64_t vocab = weight.dims()[1];
+  const int64_t num = x.numel() / hidden;
+  const int64_t chunk = std::min(chunk_size, vocab);
+
+  T* x_grad_data = x_grad ? dev_ctx.template Alloc<T>(x_grad) : nullptr;
+  T* weight_grad_data =
+      weight_grad ? dev_ctx.template Alloc<T>(weight_grad) : nullptr;
+  if (num == 0) {
+    if (weight_grad) {
+      phi::funcs::SetConstant<CPUContext, T> set_zero;
+      set_zero(dev_ctx, weight_grad, static_cast<T>(0));
+    }
+    return;
+  }
+
+  std::vector<T> logits(num * chunk);
+  auto blas = phi::funcs::GetBlas<CPUContext, T>(dev_ctx);
+  const T* x_data = x.data<T>();
+  const T* weight_data = weight.data<T>();
+  const LabelT* label_data = label.data<LabelT>();
+  const float* lse_data = lse.data<float>();
+  const T* loss_grad_data = loss_grad.data<T>();
+  for (int64_t begin = 0; begin < vocab; begin += chunk) {
+    const int64_t width = std::min(chunk, vocab - begin);
+    blas.GEMM(false,
+              false,
+              num,
+              width,
+              hidden,
+              static_cast<T>(1),
+              x_data,
+              hidden,
+              weight_data + begin,
+              vocab,
+              static_cast<T>(0),
+              logits.data(),
+              width);
+    for (int64_t i = 0; i < num; ++i) {
+      T* row = logits.data() + i * width;
+      const int64_t index = static_cast<int64_t>(label_data[i]);
+      if (index == ignore_index) {
+        std::fill(row, row + width, static_cast<T>(0));
+        continue;
+      }
+      const float dloss = static_cast<float>(loss_grad_data[i]);
+      for (int64_t j = 0; j < width; ++j) {
+        float prob = std::exp(static_cast<float>(row[j]) - lse_data[i]);
+        if (index - start_index - begin == j) {
+          prob -= 1.0f;
+        }
+        row[j] = static_cast<T>(prob * dloss);
+      }
+    }
+    if (x_grad) {
+      blas.GEMM(false,
+                true,
+                num,
+                hidden,
+                width,
+                static_cast<T>(1),
+                logits.data(),
+                width,
+                weight_data + begin,
+                vocab,
+                static_cast<T>(begin > 0 ? 1 : 0),
+                x_grad_data,
+                hidden);
+    }
+    if (weight_grad) {
+      blas.GEMM(true,
+                false,
+                hidden,
+                width,
+                num,
+                static_cast<T>(1),
+                x_data,
+                hidden,
+                logits.data(),
+                width,
+                static_cast<T>(0),
+                weight_grad_data + begin,
+                vocab);
+    }
+  }
+}
+
+template <typename T, typename Context>
+void FusedLinearCrossEntropyGradKernel(const Context& dev_ctx,
+                                       const DenseTensor& x,
+                                       const DenseTensor& weight,
+                                       const DenseTensor& label,
+                                       const DenseTensor& lse,
+                                       const DenseTensor& loss_grad,
+                                       int64_t ignore_index,
+                                       int64_t chunk_size,
+                                       int64_t start_index,
+                                       DenseTensor* x_grad,
+                                       DenseTensor* weight_grad) {
+  const auto& label_type = label.dtype();
+  if (label_type == phi::DataType::INT32) {
+    FusedLinearCrossEntropyGradImpl<T, int32_t>(dev_ctx,
+                                                x,
+                                                weight,
+                                                label,
+                                                lse,
+                                                loss_grad,
+                                                ignore_index,
+                                                chunk_size,
+                                                start_index,
+                                                x_grad,
+                                                weight_grad);
+  } else if (label_type == phi::DataType::INT64) {
+    FusedLinearCrossEntropyGradImpl<T, int64_t>(dev_ctx,
+                                                x,
+                                                weight,
+                                                label,
+                                                lse,
+                                                loss_grad,
+                                                ignore_index,
+                                                chunk_size,
+                                                start_index,
+                                                x_grad,
+                                                weight_grad);
+  } else {
+    PADDLE_THROW(phi::errors::Unavailable(
+        "The label of fused_linear_cross_entropy_grad should be int32 or "
+        "int64, but received %s.",
+        label_type));
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_linear_cross_entropy_grad,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedLinearCrossEntropyGradKernel,
+                   float,
+                   double) {}
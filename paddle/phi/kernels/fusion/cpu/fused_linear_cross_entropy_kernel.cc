@@ -0,0 +1,156 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+
+namespace phi {
+namespace fusion {
+
+template <typename T, typename LabelT>
+void FusedLinearCrossEntropyImpl(const CPUContext& dev_ctx,
+                                 const DenseTensor& x,
+                                 const DenseTensor& weight,
+                                 const DenseTensor& label,
+                                 int64_t ignore_index,
+                                 int64_t chunk_size,
+                                 int64_t start_index,
+                                 DenseTensor* loss,
+                                 DenseTensor* lse) {
+  const int64_t hidden = weight.dims()[0];
+  const int64_t vocab = weight.dims()[1];
+  const int64_t num = x.numel() / hidden;
+  const int64_t chunk = std::min(chunk_size, vocab);
+
+  T* loss_data = dev_ctx.template Alloc<T>(loss);
+  float* lse_data = dev_ctx.template Alloc<float>(lse);
+  if (num == 0) return;
+
+  std::vector<float> max_value(num, -std::numeric_limits<float>::infinity());
+  std::vector<float> sum_exp(num, 0.0f);
+  std::vector<float> target(num, 0.0f);
+  std::vector<T> logits(num * chunk);
+
+  auto blas = phi::funcs::GetBlas<CPUContext, T>(dev_ctx);
+  const T* x_data = x.data<T>();
+  const T* weight_data = weight.data<T>();
+  const LabelT* label_data = label.data<LabelT>();
+  for (int64_t begin = 0; begin < vocab; begin += chunk) {
+    const int64_t width = std::min(chunk, vocab - begin);
+    blas.GEMM(false,
+              false,
+              num,
+              width,
+              hidden,
+              static_cast<T>(1),
+              x_data,
+              hidden,
+              weight_data + begin,
+              vocab,
+              static_cast<T>(0),
+              logits.data(),
+              width);
+    for (int64_t i = 0; i < num; ++i) {
+      const T* row = logits.data() + i * width;
+      float new_max = max_value[i];
+      for (int64_t j = 0; j < width; ++j) {
+        new_max = std::max(new_max, static_cast<float>(row[j]));
+      }
+      float sum = sum_exp[i] * std::exp(max_value[i] - new_max);
+      for (int64_t j = 0; j < width; ++j) {
+        sum += std::exp(static_cast<float>(row[j]) - new_max);
+      }
+      sum_exp[i] = sum;
+      max_value[i] = new_max;
+      int64_t index = static_cast<int64_t>(label_data[i]) - start_index - begin;
+      if (index >= 0 && index < width) {
+        target[i] = static_cast<float>(row[index]);
+      }
+    }
+  }
+
+  for (int64_t i = 0; i < num; ++i) {
+    lse_data[i] = max_value[i] + std::log(sum_exp[i]);
+    loss_data[i] = static_cast<int64_t>(label_data[i]) == ignore_index
+                       ? static_cast<T>(0)
+                       : static_cast<T>(lse_data[i] - target[i]);
+  }
+}
+
+template <typename T, typename Context>
+void FusedLinearCrossEntropyKernel(const Context& dev_ctx,
+                                   const DenseTensor& x,
+                                   const DenseTensor& weight,
+                                   const DenseTensor& label,
+                                   int64_t ignore_index,
+                                   int64_t chunk_size,
+                                   int64_t start_index,
+                                   int ring_id,
+                                   int nranks,
+                                   DenseTensor* loss,
+                                   DenseTensor* lse) {
+  PADDLE_ENFORCE_EQ(nranks,
+                    1,
+                    phi::errors::Unimplemented(
+                        "The vocab split over the ranks of "
+                        "fused_linear_cross_entropy is only supported on GPU, "
+                        "but received nranks = %d.",
+                        nranks));
+  const auto& label_type = label.dtype();
+  if (label_type == phi::DataType::INT32) {
+    FusedLinearCrossEntropyImpl<T, int32_t>(dev_ctx,
+                                            x,
+                                            weight,
+                                            label,
+                                            ignore_index,
+                                            chunk_size,
+                                            start_index,
+                                            loss,
+                                            lse);
+  } else if (label_type == phi::DataType::INT64) {
+    FusedLinearCrossEntropyImpl<T, int64_t>(dev_ctx,
+                                            x,
+                                            weight,
+                                            label,
+                                            ignore_index,
+                                            chunk_size,
+                                            start_index,
+                                            loss,
+                                            lse);
+  } else {
+    PADDLE_THROW(phi::errors::Unavailable(
+        "The label of fused_linear_cross_entropy should be int32 or int64, "
+        "but received %s.",
+        label_type));
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_linear_cross_entropy,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedLinearCrossEntropyKernel,
+                   float,
+                   double) {
+  kernel->OutputAt(1).SetDataType(phi::DataType::FLOAT32);
+}
@@ -0,0 +1,42 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/impl/fc_kernel_impl.h"
+
+namespace phi {
+namespace fusion {
+
+// The 2:4 pruned weight is multiplied as a dense one on CPU, whose blas is
+// faster than skipping the zeros.
+template <typename T, typename Context>
+void SparseFCKernel(const Context& dev_ctx,
+                    const DenseTensor& input,
+                    const DenseTensor& w,
+                    const paddle::optional<DenseTensor>& bias,
+                    const int in_num_col_dims,
+                    const std::string& activation_type,
+                    DenseTensor* out) {
+  FCKernel<T, Context>(
+      dev_ctx, input, w, bias, in_num_col_dims, activation_type, false, out);
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(
+    sparse_fc, CPU, ALL_LAYOUT, phi::fusion::SparseFCKernel, float, double) {}
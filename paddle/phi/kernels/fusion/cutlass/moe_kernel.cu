@@ -882,8 +882,223 @@ void MoeKernel(const Context& ctx,
                                       ctx.stream());
 }
 
+// Lays the experts of the tokens out by the expanded source rows
+// k_idx * num_rows + row, which initialize_moe_routing_kernel indexes by.
+__global__ void InitTopKRouteKernel(const int64_t* topk_ids,
+                                    int* expanded_experts,
+                                    int* expanded_source_rows,
+                                    const int num_rows,
+                                    const int k) {
+  for (int i = blockIdx.x * blockDim.x + threadIdx.x; i < num_rows * k;
+       i += gridDim.x * blockDim.x) {
+    const int expanded_source_row = (i % k) * num_rows + i / k;
+    expanded_experts[expanded_source_row] = static_cast<int>(topk_ids[i]);
+    expanded_source_rows[expanded_source_row] = expanded_source_row;
+  }
+}
+
+// The rows of an expert end at the first sorted expert greater than it.
+__global__ void ComputeTotalRowsBeforeExpertKernel(
+    const int* sorted_experts,
+    const int64_t num_sorted,
+    const int num_experts,
+    int64_t* total_rows_before_expert) {
+  const int expert = blockIdx.x * blockDim.x + threadIdx.x;
+  if (expert >= num_experts) return;
+  int64_t lo = 0, hi = num_sorted;
+  while (lo < hi) {
+    const int64_t mid = lo + (hi - lo) / 2;
+    if (sorted_experts[mid] > expert) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  total_rows_before_expert[expert] = lo;
+}
+
+// Un-permutes the rows of the experts and reduces the k of every token by
+// the weights of the gate, one block for a token.
+template <typename T>
+__global__ void FinalizeTopKMoeRoutingKernel(
+    const T* expanded_permuted_rows,
+    T* reduced_unpermuted_output,
+    const T* bias,
+    const T* topk_weights,
+    const int* expanded_source_row_to_expanded_dest_row,
+    const int64_t* topk_ids,
+    const int cols,
+    const int k) {
+  const int row = blockIdx.x;
+  const int num_rows = gridDim.x;
+  for (int tid = threadIdx.x; tid < cols; tid += blockDim.x) {
+    float thread_output = 0;
+    for (int k_idx = 0; k_idx < k; ++k_idx) {
+      const int64_t dest_row =
+          expanded_source_row_to_expanded_dest_row[k_idx * num_rows + row];
+      const int64_t k_offset = static_cast<int64_t>(row) * k + k_idx;
+      float value =
+          static_cast<float>(expanded_permuted_rows[dest_row * cols + tid]);
+      if (bias != nullptr) {
+        value += static_cast<float>(bias[topk_ids[k_offset] * cols + tid]);
+      }
+      thread_output += static_cast<float>(topk_weights[k_offset]) * value;
+    }
+    reduced_unpermuted_output[static_cast<int64_t>(row) * cols + tid] =
+        static_cast<T>(thread_output);
+  }
+}
+
+// The token-choice MoE of the local experts: the k expanded rows of the
+// tokens are sorted by their experts and permuted to be contiguous, the two
+// FFNs of all the experts are a grouped GEMM each over the rows of the
+// experts, so neither a launch for an expert nor a padding to the capacity is
+// needed, and the rows are un-permuted and combined by the gate weights.
+template <typename T, typename Context>
+void FusedMoeKernel(const Context& ctx,
+                    const DenseTensor& x,
+                    const DenseTensor& topk_ids,
+                    const DenseTensor& topk_weights,
+                    const DenseTensor& ffn1_weight,
+                    const DenseTensor& ffn1_bias,
+                    const DenseTensor& ffn2_weight,
+                    const paddle::optional<DenseTensor>& ffn2_bias,
+                    const std::string& act_type,
+                    DenseTensor* out) {
+  using DataT = std::conditional_t<std::is_same<T, phi::dtype::float16>::value,
+                                   __half,
+                                   T>;
+  T* out_data = ctx.template Alloc<T>(out);
+  const int hidden_size = ffn1_weight.dims()[1];
+  const int inter_size = ffn1_weight.dims()[2];
+  const int num_experts = ffn1_weight.dims()[0];
+  const int num_rows = topk_ids.dims()[0];
+  const int k = topk_ids.dims()[1];
+  const int num_expanded = num_rows * k;
+  if (num_rows == 0) return;
+  auto stream = ctx.stream();
+
+  DenseTensor expanded_experts = phi::Empty<int>(ctx, {2, num_expanded});
+  DenseTensor expanded_rows = phi::Empty<int>(ctx, {2, num_expanded});
+  int* experts_in = expanded_experts.data<int>();
+  int* experts_out = experts_in + num_expanded;
+  int* source_rows = expanded_rows.data<int>();
+  int* dest_row_to_source_row = source_rows + num_expanded;
+  DenseTensor source_row_to_dest_row_tensor =
+      phi::Empty<int>(ctx, {num_expanded});
+  int* source_row_to_dest_row = source_row_to_dest_row_tensor.data<int>();
+  DenseTensor total_rows_tensor = phi::Empty<int64_t>(ctx, {num_experts});
+  int64_t* total_rows_before_expert = total_rows_tensor.data<int64_t>();
+
+  const int threads = 256;
+  const int blocks = std::min((num_expanded + threads - 1) / threads, 65535);
+  InitTopKRouteKernel<<<blocks, threads, 0, stream>>>(
+      topk_ids.data<int64_t>(), experts_in, source_rows, num_rows, k);
+  // The radix sort is stable, so the rows of an expert keep their order.
+  CubKeyValueSorter sorter(num_experts);
+  const size_t sorter_bytes = sorter.getWorkspaceSize(num_expanded);
+  DenseTensor sorter_ws =
+      phi::Empty<int8_t>(ctx, {static_cast<int64_t>(sorter_bytes)});
+  sorter.run(sorter_ws.data<int8_t>(),
+             sorter_bytes,
+             experts_in,
+             experts_out,
+             source_rows,
+             dest_row_to_source_row,
+             num_expanded,
+             false,
+             stream);
+  ComputeTotalRowsBeforeExpertKernel<<<(num_experts + threads - 1) / threads,
+                                       threads,
+                                       0,
+                                       stream>>>(
+      experts_out, num_expanded, num_experts, total_rows_before_expert);
+
+  DenseTensor permuted_data =
+      phi::Empty<T>(ctx, {num_expanded, hidden_size});
+  constexpr int max_pack_size = 16 / sizeof(T);
+  if (hidden_size % max_pack_size == 0) {
+    initialize_moe_routing_kernel<T, max_pack_size>
+        <<<num_expanded,
+           std::min(hidden_size / max_pack_size, 1024),
+           0,
+           stream>>>(x.data<T>(),
+                     permuted_data.data<T>(),
+                     dest_row_to_source_row,
+                     source_row_to_dest_row,
+                     num_rows,
+                     num_expanded,
+                     hidden_size,
+                     k,
+                     0,
+                     false);
+  } else {
+    initialize_moe_routing_kernel<T, 1>
+        <<<num_expanded, std::min(hidden_size, 1024), 0, stream>>>(
+            x.data<T>(),
+            permuted_data.data<T>(),
+            dest_row_to_source_row,
+            source_row_to_dest_row,
+            num_rows,
+            num_expanded,
+            hidden_size,
+            k,
+            0,
+            false);
+  }
+
+  int sm = getSMVersion();
+  int multi_processor_count = phi::backends::gpu::GetGPUMultiProcessors(
+      phi::backends::gpu::GetCurrentDeviceId());
+  DenseTensor fc1_result = phi::Empty<T>(ctx, {num_expanded, inter_size});
+  DenseTensor fc2_result = phi::Empty<T>(ctx, {num_expanded, hidden_size});
+  gemm_bias_act<DataT>(
+      reinterpret_cast<const DataT*>(permuted_data.data<T>()),
+      reinterpret_cast<const DataT*>(ffn1_weight.data<T>()),
+      nullptr,
+      reinterpret_cast<const DataT*>(ffn1_bias.data<T>()),
+      reinterpret_cast<DataT*>(fc1_result.data<T>()),
+      total_rows_before_expert,
+      inter_size,
+      hidden_size,
+      num_experts,
+      sm,
+      multi_processor_count,
+      act_type,
+      stream);
+  gemm<DataT>(reinterpret_cast<const DataT*>(fc1_result.data<T>()),
+              reinterpret_cast<const DataT*>(ffn2_weight.data<T>()),
+              nullptr,
+              reinterpret_cast<DataT*>(fc2_result.data<T>()),
+              total_rows_before_expert,
+              hidden_size,
+              inter_size,
+              num_experts,
+              sm,
+              multi_processor_count,
+              stream);
+
+  FinalizeTopKMoeRoutingKernel<T>
+      <<<num_rows, std::min(hidden_size, 1024), 0, stream>>>(
+          fc2_result.data<T>(),
+          out_data,
+          ffn2_bias ? ffn2_bias->data<T>() : nullptr,
+          topk_weights.data<T>(),
+          source_row_to_dest_row,
+          topk_ids.data<int64_t>(),
+          hidden_size,
+          k);
+}
+
 }  // namespace fusion
 }  // namespace phi
 
 PD_REGISTER_KERNEL(
     moe, GPU, ALL_LAYOUT, phi::fusion::MoeKernel, float, phi::dtype::float16) {}
+
+PD_REGISTER_KERNEL(fused_moe,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedMoeKernel,
+                   float,
+                   phi::dtype::float16) {}
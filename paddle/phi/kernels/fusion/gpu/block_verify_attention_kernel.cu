@@ -0,0 +1,271 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/funcs/math_cuda_utils.h"
+
+namespace phi {
+namespace fusion {
+
+constexpr int kVerifyAttnBlockSize = 128;
+constexpr int kVerifyAttnMaxHeadDim = 128;
+
+// the batch of token t, cu_seqlens_q[b] <= t < cu_seqlens_q[b + 1]
+__device__ __forceinline__ int FindBatchId(const int* cu_seqlens_q,
+                                           int bsz,
+                                           int t) {
+  int lo = 0;
+  int hi = bsz - 1;
+  while (lo < hi) {
+    int mid = (lo + hi + 1) >> 1;
+    if (cu_seqlens_q[mid] <= t) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return lo;
+}
+
+// token i of batch b is written to position seq_lens_decoder[b] + i of the
+// pages in block_tables[b]
+template <typename T>
+__global__ void VerifyWriteCacheKernel(const T* qkv,
+                                       const int* seq_lens_decoder,
+                                       const int* cu_seqlens_q,
+                                       const int* block_tables,
+                                       int bsz,
+                                       int token_num,
+                                       int num_head,
+                                       int dim_head,
+                                       int block_size,
+                                       int max_blocks_per_seq,
+                                       T* key_cache,
+                                       T* value_cache) {
+  const int64_t hidden = static_cast<int64_t>(num_head) * dim_head;
+  const int64_t numel = token_num * hidden;
+  for (int64_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < numel;
+       idx += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    const int t = idx / hidden;
+    const int hi = (idx % hidden) / dim_head;
+    const int d = idx % dim_head;
+    const int b = FindBatchId(cu_seqlens_q, bsz, t);
+    const int pos = seq_lens_decoder[b] + t - cu_seqlens_q[b];
+    const int block_id =
+        block_tables[b * max_blocks_per_seq + pos / block_size];
+    const int64_t cache_idx =
+        ((static_cast<int64_t>(block_id) * num_head + hi) * block_size +
+         pos % block_size) *
+            dim_head +
+        d;
+    const T* src = qkv + t * 3 * hidden + hi * dim_head + d;
+    key_cache[cache_idx] = src[hidden];
+    value_cache[cache_idx] = src[2 * hidden];
+  }
+}
+
+// One block computes a head of a query token. Token i of batch b attends the
+// first seq_lens_decoder[b] + i + 1 positions of the pages, the draft tokens
+// before it and itself. The positions are scored a tile of blockDim.x at a
+// time, and the softmax of the tiles is merged online.
+template <typename T>
+__global__ void VerifyAttentionKernel(const T* qkv,
+                                      const T* key_cache,
+                                      const T* value_cache,
+                                      const int* seq_lens_decoder,
+                                      const int* cu_seqlens_q,
+                                      const int* block_tables,
+                                      int bsz,
+                                      int num_head,
+                                      int dim_head,
+                                      int block_size,
+                                      int max_blocks_per_seq,
+                                      float scale,
+                                      T* out) {
+  __shared__ float s_q[kVerifyAttnMaxHeadDim];
+  __shared__ float s_prob[kVerifyAttnBlockSize];
+  __shared__ int s_block_id[kVerifyAttnBlockSize];
+
+  const int t = blockIdx.x;
+  const int hi = blockIdx.y;
+  const int tid = threadIdx.x;
+  const int64_t hidden = static_cast<int64_t>(num_head) * dim_head;
+  const int b = FindBatchId(cu_seqlens_q, bsz, t);
+  const int kv_len = seq_lens_decoder[b] + t - cu_seqlens_q[b] + 1;
+  const int* block_table = block_tables + b * max_blocks_per_seq;
+
+  for (int d = tid; d < dim_head; d += blockDim.x) {
+    s_q[d] = static_cast<float>(qkv[t * 3 * hidden + hi * dim_head + d]);
+  }
+  __syncthreads();
+
+  float row_max = -INFINITY;
+  float row_sum = 0.0f;
+  float acc = 0.0f;
+  for (int tile = 0; tile < kv_len; tile += blockDim.x) {
+    const int j = tile + tid;
+    float score = -INFINITY;
+    if (j < kv_len) {
+      const int block_id = block_table[j / block_size];
+      s_block_id[tid] = block_id;
+      const T* k =
+          key_cache +
+          ((static_cast<int64_t>(block_id) * num_head + hi) * block_size +
+           j % block_size) *
+              dim_head;
+      float dot = 0.0f;
+      for (int d = 0; d < dim_head; ++d) {
+        dot += s_q[d] * static_cast<float>(k[d]);
+      }
+      score = dot * scale;
+    }
+    float tile_max = phi::funcs::BlockReduceMax<float>(score, FINAL_MASK);
+    float new_max = fmaxf(row_max, tile_max);
+    float prob = j < kv_len ? __expf(score - new_max) : 0.0f;
+    s_prob[tid] = prob;
+    __syncthreads();
+    float tile_sum = phi::funcs::BlockReduceSum<float>(prob, FINAL_MASK);
+    float rescale = __expf(row_max - new_max);
+    row_sum = row_sum * rescale + tile_sum;
+    acc *= rescale;
+    // thread d accumulates dim d of the values
+    if (tid < dim_head) {
+      const int tile_len = min(static_cast<int>(blockDim.x), kv_len - tile);
+      for (int p = 0; p < tile_len; ++p) {
+        const int pos = tile + p;
+        const T* v =
+            value_cache +
+            ((static_cast<int64_t>(s_block_id[p]) * num_head + hi) *
+                 block_size +
+             pos % block_size) *
+                dim_head;
+        acc += s_prob[p] * static_cast<float>(v[tid]);
+      }
+    }
+    row_max = new_max;
+    __syncthreads();
+  }
+  if (tid < dim_head) {
+    out[t * hidden + hi * dim_head + tid] = static_cast<T>(acc / row_sum);
+  }
+}
+
+// The verification attention of speculative decoding. Every sequence feeds
+// its last accepted token and the draft tokens as seq_lens_this_time query
+// tokens, whose k and v are appended to the paged caches, and each token
+// attends causally the cache of its sequence. qkv carries the rotary
+// embedding already.
+template <typename T, typename Context>
+void BlockVerifyAttentionKernel(const Context& dev_ctx,
+                                const DenseTensor& qkv,
+                                const DenseTensor& key_cache,
+                                const DenseTensor& value_cache,
+                                const DenseTensor& seq_lens_decoder,
+                                const DenseTensor& seq_lens_this_time,
+                                const DenseTensor& cu_seqlens_q,
+                                const DenseTensor& block_tables,
+                                float scale,
+                                DenseTensor* out,
+                                DenseTensor* key_cache_out,
+                                DenseTensor* value_cache_out) {
+  const int token_num = qkv.dims()[0];
+  const int num_head = key_cache.dims()[1];
+  const int block_size = key_cache.dims()[2];
+  const int dim_head = key_cache.dims()[3];
+  const int bsz = seq_lens_this_time.dims()[0];
+  const int max_blocks_per_seq = block_tables.dims()[1];
+  PADDLE_ENFORCE_LE(dim_head,
+                    kVerifyAttnMaxHeadDim,
+                    phi::errors::Unimplemented(
+                        "block_verify_attention supports dim_head <= %d, but "
+                        "got %d.",
+                        kVerifyAttnMaxHeadDim,
+                        dim_head));
+  if (scale <= 0.0f) {
+    scale = 1.0f / std::sqrt(static_cast<float>(dim_head));
+  }
+  dev_ctx.template Alloc<T>(out);
+  // the outputs of the out of place api start from the inputs
+  if (key_cache_out->data() != key_cache.data()) {
+    phi::Copy(dev_ctx, key_cache, dev_ctx.GetPlace(), false, key_cache_out);
+  }
+  if (value_cache_out->data() != value_cache.data()) {
+    phi::Copy(
+        dev_ctx, value_cache, dev_ctx.GetPlace(), false, value_cache_out);
+  }
+  T* key_cache_data = dev_ctx.template Alloc<T>(key_cache_out);
+  T* value_cache_data = dev_ctx.template Alloc<T>(value_cache_out);
+  if (token_num == 0) return;
+
+  auto config = phi::backends::gpu::GetGpuLaunchConfig1D(
+      dev_ctx, static_cast<int64_t>(token_num) * num_head * dim_head);
+  VerifyWriteCacheKernel<T><<<config.block_per_grid,
+                              config.thread_per_block,
+                              0,
+                              dev_ctx.stream()>>>(qkv.data<T>(),
+                                                  seq_lens_decoder.data<int>(),
+                                                  cu_seqlens_q.data<int>(),
+                                                  block_tables.data<int>(),
+                                                  bsz,
+                                                  token_num,
+                                                  num_head,
+                                                  dim_head,
+                                                  block_size,
+                                                  max_blocks_per_seq,
+                                                  key_cache_data,
+                                                  value_cache_data);
+
+  dim3 grid(token_num, num_head);
+  VerifyAttentionKernel<T>
+      <<<grid, kVerifyAttnBlockSize, 0, dev_ctx.stream()>>>(
+          qkv.data<T>(),
+          key_cache_data,
+          value_cache_data,
+          seq_lens_decoder.data<int>(),
+          cu_seqlens_q.data<int>(),
+          block_tables.data<int>(),
+          bsz,
+          num_head,
+          dim_head,
+          block_size,
+          max_blocks_per_seq,
+          scale,
+          out->data<T>());
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+#if CUDA_VERSION >= 11000 && defined(CUDA_BFLOAT16_AVALIABLE)
+PD_REGISTER_KERNEL(block_verify_attention,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::BlockVerifyAttentionKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
+#else
+PD_REGISTER_KERNEL(block_verify_attention,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::BlockVerifyAttentionKernel,
+                   float,
+                   phi::dtype::float16) {}
+#endif
@@ -28,12 +28,13 @@ namespace phi {
 namespace fusion {
 
 template <typename T, typename Context>
-void EmbeddingEltWiseLayerNormKernel(
+static void LaunchEmbeddingEltWiseLayerNorm(
     const Context& dev_ctx,
     const std::vector<const DenseTensor*>& ids,
     const std::vector<const DenseTensor*>& embs,
     const DenseTensor& bias,
     const DenseTensor& scale,
+    const int* cu_seqlens,
     const float epsilon,
     DenseTensor* out) {
   PADDLE_ENFORCE_GE(
@@ -119,8 +120,53 @@ void EmbeddingEltWiseLayerNormKernel(
                                output_d,
                                epsilon,
                                input_num,
-                               dev_ctx.stream());
+                               dev_ctx.stream(),
+                               cu_seqlens);
+  }
+}
+
+template <typename T, typename Context>
+void EmbeddingEltWiseLayerNormKernel(
+    const Context& dev_ctx,
+    const std::vector<const DenseTensor*>& ids,
+    const std::vector<const DenseTensor*>& embs,
+    const DenseTensor& bias,
+    const DenseTensor& scale,
+    const float epsilon,
+    DenseTensor* out) {
+  LaunchEmbeddingEltWiseLayerNorm<T, Context>(
+      dev_ctx, ids, embs, bias, scale, nullptr, epsilon, out);
+}
+
+// The embeddings of the padded ids are written for the tokens of the
+// sequences only, packed as by cu_seqlens, which the varlen FlashAttention
+// consumes directly.
+template <typename T, typename Context>
+void EmbeddingEltWiseLayerNormVarlenKernel(
+    const Context& dev_ctx,
+    const std::vector<const DenseTensor*>& ids,
+    const std::vector<const DenseTensor*>& embs,
+    const DenseTensor& bias,
+    const DenseTensor& scale,
+    const DenseTensor& cu_seqlens,
+    const float epsilon,
+    DenseTensor* out) {
+  const int batch = static_cast<int>(ids[0]->dims()[0]);
+  int total_tokens = 0;
+  phi::memory_utils::Copy(phi::CPUPlace{},
+                          &total_tokens,
+                          cu_seqlens.place(),
+                          cu_seqlens.data<int>() + batch,
+                          sizeof(int),
+                          dev_ctx.stream());
+  dev_ctx.Wait();
+  out->Resize(common::make_ddim({total_tokens, embs[0]->dims()[1]}));
+  if (total_tokens == 0) {
+    dev_ctx.template Alloc<T>(out);
+    return;
   }
+  LaunchEmbeddingEltWiseLayerNorm<T, Context>(
+      dev_ctx, ids, embs, bias, scale, cu_seqlens.data<int>(), epsilon, out);
 }
 
 }  // namespace fusion
@@ -133,10 +179,25 @@ PD_REGISTER_KERNEL(fused_embedding_eltwise_layernorm,
                    phi::fusion::EmbeddingEltWiseLayerNormKernel,
                    float,
                    phi::dtype::float16) {}
+PD_REGISTER_KERNEL(fused_embedding_eltwise_layernorm_varlen,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::EmbeddingEltWiseLayerNormVarlenKernel,
+                   float,
+                   phi::dtype::float16) {
+  kernel->InputAt(4).SetDataType(phi::DataType::INT32);
+}
 #else
 PD_REGISTER_KERNEL(fused_embedding_eltwise_layernorm,
                    GPU,
                    ALL_LAYOUT,
                    phi::fusion::EmbeddingEltWiseLayerNormKernel,
                    float) {}
+PD_REGISTER_KERNEL(fused_embedding_eltwise_layernorm_varlen,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::EmbeddingEltWiseLayerNormVarlenKernel,
+                   float) {
+  kernel->InputAt(4).SetDataType(phi::DataType::INT32);
+}
 #endif
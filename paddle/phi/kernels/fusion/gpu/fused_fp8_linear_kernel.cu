@@ -0,0 +1,280 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/common/float8_e4m3fn.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/tensor_utils.h"
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11080
+#include "paddle/phi/kernels/funcs/cublaslt.h"
+#include "paddle/phi/kernels/funcs/math_cuda_utils.h"
+#endif
+
+namespace phi {
+namespace fusion {
+
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11080
+constexpr int kFp8TransposeTile = 32;
+
+// amax is non-negative, so its float bits order like integers
+__device__ __forceinline__ void AtomicMaxNonNegative(float* addr, float val) {
+  atomicMax(reinterpret_cast<int*>(addr), __float_as_int(val));
+}
+
+template <typename T>
+__global__ void Fp8AmaxKernel(const T* x, int64_t numel, float* amax) {
+  float val = 0.0f;
+  for (int64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < numel;
+       i += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    val = fmaxf(val, fabsf(static_cast<float>(x[i])));
+  }
+  val = phi::funcs::BlockReduceMax<float>(val, FINAL_MASK);
+  if (threadIdx.x == 0) {
+    AtomicMaxNonNegative(amax, val);
+  }
+}
+
+template <typename T>
+__global__ void Fp8QuantizeKernel(const T* x,
+                                  const float* scale,
+                                  int64_t numel,
+                                  phi::dtype::float8_e4m3fn* out) {
+  float s = *scale;
+  for (int64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < numel;
+       i += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    out[i] = phi::dtype::float8_e4m3fn(static_cast<float>(x[i]) * s);
+  }
+}
+
+// weight[k, n] is quantized to out[n, k], the TN layout of the FP8 GEMM
+template <typename T>
+__global__ void Fp8QuantizeTransposeKernel(const T* weight,
+                                           const float* scale,
+                                           int k,
+                                           int n,
+                                           phi::dtype::float8_e4m3fn* out) {
+  __shared__ float tile[kFp8TransposeTile][kFp8TransposeTile + 1];
+  float s = *scale;
+  int row_begin = blockIdx.y * kFp8TransposeTile;
+  int col_begin = blockIdx.x * kFp8TransposeTile;
+  int col = col_begin + threadIdx.x;
+  for (int i = threadIdx.y; i < kFp8TransposeTile; i += blockDim.y) {
+    int row = row_begin + i;
+    if (row < k && col < n) {
+      tile[i][threadIdx.x] =
+          static_cast<float>(weight[static_cast<int64_t>(row) * n + col]);
+    }
+  }
+  __syncthreads();
+  int out_col = row_begin + threadIdx.x;
+  for (int i = threadIdx.y; i < kFp8TransposeTile; i += blockDim.y) {
+    int out_row = col_begin + i;
+    if (out_row < n && out_col < k) {
+      out[static_cast<int64_t>(out_row) * k + out_col] =
+          phi::dtype::float8_e4m3fn(tile[threadIdx.x][i] * s);
+    }
+  }
+}
+
+__global__ void Fp8ScaleInvKernel(const float* x_scale,
+                                  const float* weight_scale,
+                                  float* scale_inv) {
+  scale_inv[0] = 1.0f / *x_scale;
+  scale_inv[1] = 1.0f / *weight_scale;
+}
+
+// The delayed scaling of "FP8 Formats for Deep Learning": the amax of this
+// step is pushed to the history, and the scale of the next step maps the max
+// of the history to the largest FP8 value, divided by 2^margin. The scale is
+// kept when the history has no finite amax.
+__device__ void Fp8UpdateScalingState(float amax,
+                                      int history_len,
+                                      float fp8_max,
+                                      float margin,
+                                      float* amax_history,
+                                      float* scale) {
+  float history_max = amax;
+  for (int i = history_len - 1; i > 0; --i) {
+    amax_history[i] = amax_history[i - 1];
+    history_max = fmaxf(history_max, amax_history[i]);
+  }
+  amax_history[0] = amax;
+  if (history_max > 0.0f && isfinite(history_max)) {
+    *scale = fp8_max / history_max / exp2f(margin);
+  }
+}
+
+__global__ void Fp8UpdateScalingKernel(const float* amax,
+                                       int x_history_len,
+                                       int weight_history_len,
+                                       float fp8_max,
+                                       float margin,
+                                       float* x_amax_history,
+                                       float* x_scale,
+                                       float* weight_amax_history,
+                                       float* weight_scale) {
+  if (threadIdx.x == 0) {
+    Fp8UpdateScalingState(
+        amax[0], x_history_len, fp8_max, margin, x_amax_history, x_scale);
+  } else if (threadIdx.x == 1) {
+    Fp8UpdateScalingState(amax[1],
+                          weight_history_len,
+                          fp8_max,
+                          margin,
+                          weight_amax_history,
+                          weight_scale);
+  }
+}
+
+template <typename T>
+void LaunchFp8Amax(const phi::GPUContext& dev_ctx,
+                   const T* x,
+                   int64_t numel,
+                   float* amax) {
+  constexpr int kBlockSize = 512;
+  int64_t grid = std::min<int64_t>(
+      (numel + kBlockSize - 1) / kBlockSize,
+      static_cast<int64_t>(dev_ctx.GetSMCount()) * 4);
+  Fp8AmaxKernel<T><<<grid, kBlockSize, 0, dev_ctx.stream()>>>(x, numel, amax);
+}
+#endif
+
+// out = x * weight + bias of the E4M3 GEMM. x and weight are cast with the
+// scales of the last steps, and the scaling states are updated in place by
+// the amax of this step.
+template <typename T, typename Context>
+void FusedFp8LinearKernel(const Context& dev_ctx,
+                          const DenseTensor& x,
+                          const DenseTensor& weight,
+                          const paddle::optional<DenseTensor>& bias,
+                          const DenseTensor& x_scale,
+                          const DenseTensor& x_amax_history,
+                          const DenseTensor& weight_scale,
+                          const DenseTensor& weight_amax_history,
+                          float margin,
+                          DenseTensor* out,
+                          DenseTensor* x_scale_out,
+                          DenseTensor* x_amax_history_out,
+                          DenseTensor* weight_scale_out,
+                          DenseTensor* weight_amax_history_out) {
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11080
+  PADDLE_ENFORCE_GE(
+      dev_ctx.GetComputeCapability(),
+      89,
+      phi::errors::Unimplemented("fused_fp8_linear needs the FP8 tensor cores "
+                                 "of sm89 or later, but got sm%d.",
+                                 dev_ctx.GetComputeCapability()));
+  const int k = weight.dims()[0];
+  const int n = weight.dims()[1];
+  const int m = x.numel() / k;
+  dev_ctx.template Alloc<T>(out);
+  if (out->numel() == 0) return;
+
+  // the outputs of the out of place api start from the inputs
+  auto CopyState = [&](const DenseTensor& src, DenseTensor* dst) {
+    if (dst->data() != src.data()) {
+      phi::Copy(dev_ctx, src, dev_ctx.GetPlace(), false, dst);
+    }
+  };
+  CopyState(x_scale, x_scale_out);
+  CopyState(x_amax_history, x_amax_history_out);
+  CopyState(weight_scale, weight_scale_out);
+  CopyState(weight_amax_history, weight_amax_history_out);
+  float* x_scale_data = dev_ctx.template Alloc<float>(x_scale_out);
+  float* weight_scale_data = dev_ctx.template Alloc<float>(weight_scale_out);
+
+  // [x_amax, weight_amax, x_scale_inv, weight_scale_inv]
+  DenseTensor states;
+  states.Resize({4});
+  float* states_data = dev_ctx.template Alloc<float>(&states);
+  cudaStream_t stream = dev_ctx.stream();
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMemsetAsync(states_data, 0, 2 * sizeof(float), stream));
+  Fp8ScaleInvKernel<<<1, 1, 0, stream>>>(
+      x_scale_data, weight_scale_data, states_data + 2);
+
+  LaunchFp8Amax<T>(dev_ctx, x.data<T>(), x.numel(), states_data);
+  LaunchFp8Amax<T>(dev_ctx, weight.data<T>(), weight.numel(), states_data + 1);
+
+  DenseTensor x_fp8;
+  x_fp8.Resize({m, k});
+  auto* x_fp8_data = dev_ctx.template Alloc<phi::dtype::float8_e4m3fn>(&x_fp8);
+  auto config = phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, x.numel());
+  Fp8QuantizeKernel<T>
+      <<<config.block_per_grid, config.thread_per_block, 0, stream>>>(
+          x.data<T>(), x_scale_data, x.numel(), x_fp8_data);
+
+  DenseTensor weight_fp8;
+  weight_fp8.Resize({n, k});
+  auto* weight_fp8_data =
+      dev_ctx.template Alloc<phi::dtype::float8_e4m3fn>(&weight_fp8);
+  dim3 tile_grid((n + kFp8TransposeTile - 1) / kFp8TransposeTile,
+                 (k + kFp8TransposeTile - 1) / kFp8TransposeTile);
+  dim3 tile_block(kFp8TransposeTile, 8);
+  Fp8QuantizeTransposeKernel<T><<<tile_grid, tile_block, 0, stream>>>(
+      weight.data<T>(), weight_scale_data, k, n, weight_fp8_data);
+
+  size_t workspace_size = static_cast<size_t>(4) * 1024 * 1024;
+  auto workspace = phi::memory_utils::Alloc(
+      dev_ctx.GetPlace(),
+      workspace_size,
+      phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
+  CublasLtFp8Helper<T> helper(
+      m, k, n, bias.get_ptr() != nullptr, dev_ctx.cublaslt_handle());
+  helper.GEMM(x_fp8_data,
+              weight_fp8_data,
+              bias ? bias->data<T>() : nullptr,
+              states_data + 2,
+              states_data + 3,
+              out->data<T>(),
+              workspace->ptr(),
+              workspace_size,
+              stream);
+
+  Fp8UpdateScalingKernel<<<1, 2, 0, stream>>>(
+      states_data,
+      x_amax_history.numel(),
+      weight_amax_history.numel(),
+      static_cast<float>(
+          std::numeric_limits<phi::dtype::float8_e4m3fn>::max()),
+      margin,
+      dev_ctx.template Alloc<float>(x_amax_history_out),
+      x_scale_data,
+      dev_ctx.template Alloc<float>(weight_amax_history_out),
+      weight_scale_data);
+#else
+  PADDLE_THROW(phi::errors::Unimplemented(
+      "fused_fp8_linear needs paddle with cuda and cuda version >= 11.8"));
+#endif
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_fp8_linear,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedFp8LinearKernel,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->OutputAt(1).SetDataType(phi::DataType::FLOAT32);
+  kernel->OutputAt(2).SetDataType(phi::DataType::FLOAT32);
+  kernel->OutputAt(3).SetDataType(phi::DataType::FLOAT32);
+  kernel->OutputAt(4).SetDataType(phi::DataType::FLOAT32);
+}
@@ -0,0 +1,213 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/backends/gpu/gpu_primitives.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+
+namespace phi {
+namespace fusion {
+
+// Turn the logits of a chunk into their grad in place:
+// (softmax(logits) - onehot(label)) * loss_grad, by the lse of the forward.
+template <typename T, typename LabelT>
+__global__ void ChunkSoftmaxGradKernel(const LabelT* label,
+                                       const float* lse,
+                                       const T* loss_grad,
+                                       int64_t ignore_index,
+                                       int64_t chunk,
+                                       int64_t chunk_begin,
+                                       int64_t numel,
+                                       T* logits) {
+  CUDA_KERNEL_LOOP_TYPE(i, numel, int64_t) {
+    const int64_t row = i / chunk;
+    const int64_t col = i % chunk;
+    const LabelT index = label[row];
+    if (index == static_cast<LabelT>(ignore_index)) {
+      logits[i] = static_cast<T>(0);
+    } else {
+      float prob = __expf(static_cast<float>(logits[i]) - lse[row]);
+      if (static_cast<int64_t>(index) - chunk_begin == col) {
+        prob -= 1.0f;
+      }
+      logits[i] = static_cast<T>(prob * static_cast<float>(loss_grad[row]));
+    }
+  }
+}
+
+template <typename T, typename LabelT>
+void FusedLinearCrossEntropyGradImpl(const GPUContext& dev_ctx,
+                                     const DenseTensor& x,
+                                     const DenseTensor& weight,
+                                     const DenseTensor& label,
+                                     const DenseTensor& lse,
+                                     const DenseTensor& loss_grad,
+                                     int64_t ignore_index,
+                                     int64_t chunk_size,
+                                     int64_t start_index,
+                                     DenseTensor* x_grad,
+                                     DenseTensor* weight_grad) {
+  const int64_t hidden = weight.dims()[0];
+  const int64_t vocab = weight.dims()[1];
+  const int64_t num = x.numel() / hidden;
+  const int64_t chunk = std::min(chunk_size, vocab);
+
+  T* x_grad_data = x_grad ? dev_ctx.template Alloc<T>(x_grad) : nullptr;
+  T* weight_grad_data =
+      weight_grad ? dev_ctx.template Alloc<T>(weight_grad) : nullptr;
+  if (num == 0) {
+    if (weight_grad) {
+      phi::funcs::SetConstant<GPUContext, T> set_zero;
+      set_zero(dev_ctx, weight_grad, static_cast<T>(0));
+    }
+    return;
+  }
+
+  DenseTensor logits;
+  logits.Resize({num, chunk});
+  T* logits_data = dev_ctx.template Alloc<T>(&logits);
+
+  auto blas = phi::funcs::GetBlas<GPUContext, T>(dev_ctx);
+  const T* x_data = x.data<T>();
+  const T* weight_data = weight.data<T>();
+  auto stream = dev_ctx.stream();
+  // Recompute the logits of each chunk rather than keeping the softmax of the
+  // forward, the extra GEMM is the price of the memory of [num, vocab].
+  for (int64_t begin = 0; begin < vocab; begin += chunk) {
+    const int64_t width = std::min(chunk, vocab - begin);
+    blas.GEMM(false,
+              false,
+              num,
+              width,
+              hidden,
+              static_cast<T>(1),
+              x_data,
+              hidden,
+              weight_data + begin,
+              vocab,
+              static_cast<T>(0),
+              logits_data,
+              width);
+    auto config =
+        phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, num * width);
+    ChunkSoftmaxGradKernel<T, LabelT>
+        <<<config.block_per_grid, config.thread_per_block, 0, stream>>>(
+            label.data<LabelT>(),
+            lse.data<float>(),
+            loss_grad.data<T>(),
+            ignore_index,
+            width,
+            start_index + begin,
+            num * width,
+            logits_data);
+    if (x_grad) {
+      // x_grad += logits_grad * weight[:, begin : begin + width]^T
+      blas.GEMM(false,
+                true,
+                num,
+                hidden,
+                width,
+                static_cast<T>(1),
+                logits_data,
+                width,
+                weight_data + begin,
+                vocab,
+                static_cast<T>(begin > 0 ? 1 : 0),
+                x_grad_data,
+                hidden);
+    }
+    if (weight_grad) {
+      // weight_grad[:, begin : begin + width] = x^T * logits_grad
+      blas.GEMM(true,
+                false,
+                hidden,
+                width,
+                num,
+                static_cast<T>(1),
+                x_data,
+                hidden,
+                logits_data,
+                width,
+                static_cast<T>(0),
+                weight_grad_data + begin,
+                vocab);
+    }
+  }
+}
+
+// With the vocab split over the ranks, x_grad is the partial grad of the
+// local shard, which is summed by the backward of the c_identity before the
+// column parallel projection, as the grad of the logits of
+// c_softmax_with_cross_entropy.
+template <typename T, typename Context>
+void FusedLinearCrossEntropyGradKernel(const Context& dev_ctx,
+                                       const DenseTensor& x,
+                                       const DenseTensor& weight,
+                                       const DenseTensor& label,
+                                       const DenseTensor& lse,
+                                       const DenseTensor& loss_grad,
+                                       int64_t ignore_index,
+                                       int64_t chunk_size,
+                                       int64_t start_index,
+                                       DenseTensor* x_grad,
+                                       DenseTensor* weight_grad) {
+  const auto& label_type = label.dtype();
+  if (label_type == phi::DataType::INT32) {
+    FusedLinearCrossEntropyGradImpl<T, int32_t>(dev_ctx,
+                                                x,
+                                                weight,
+                                                label,
+                                                lse,
+                                                loss_grad,
+                                                ignore_index,
+                                                chunk_size,
+                                                start_index,
+                                                x_grad,
+                                                weight_grad);
+  } else if (label_type == phi::DataType::INT64) {
+    FusedLinearCrossEntropyGradImpl<T, int64_t>(dev_ctx,
+                                                x,
+                                                weight,
+                                                label,
+                                                lse,
+                                                loss_grad,
+                                                ignore_index,
+                                                chunk_size,
+                                                start_index,
+                                                x_grad,
+                                                weight_grad);
+  } else {
+    PADDLE_THROW(phi::errors::Unavailable(
+        "The label of fused_linear_cross_entropy_grad should be int32 or "
+        "int64, but received %s.",
+        label_type));
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_linear_cross_entropy_grad,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedLinearCrossEntropyGradKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
@@ -0,0 +1,280 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <limits>
+
+#ifdef __NVCC__
+#include "cub/cub.cuh"
+#endif
+#ifdef __HIPCC__
+#include <hipcub/hipcub.hpp>
+namespace cub = hipcub;
+#endif
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/backends/gpu/gpu_primitives.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+#include "paddle/phi/core/distributed/nccl_comm_context.h"
+#endif
+
+namespace phi {
+namespace fusion {
+
+static constexpr int kLseBlockDim = 256;
+
+// Fold the logits of a chunk of the vocab [chunk_begin, chunk_begin + chunk)
+// into the running max and sum of exp of each token, the online log-sum-exp,
+// and pick the logit of the label if it falls in the chunk.
+template <typename T, typename LabelT>
+__global__ void ChunkLogSumExpKernel(const T* logits,
+                                     const LabelT* label,
+                                     int64_t chunk,
+                                     int64_t chunk_begin,
+                                     float* max_value,
+                                     float* sum_exp,
+                                     float* target) {
+  using BlockReduce = cub::BlockReduce<float, kLseBlockDim>;
+  __shared__ typename BlockReduce::TempStorage temp_storage;
+  __shared__ float new_max;
+
+  const int64_t row = blockIdx.x;
+  const T* row_logits = logits + row * chunk;
+  float local_max = -INFINITY;
+  for (int64_t i = threadIdx.x; i < chunk; i += kLseBlockDim) {
+    local_max = max(local_max, static_cast<float>(row_logits[i]));
+  }
+  float chunk_max = BlockReduce(temp_storage).Reduce(local_max, cub::Max());
+  if (threadIdx.x == 0) {
+    new_max = max(max_value[row], chunk_max);
+  }
+  __syncthreads();
+
+  float local_sum = 0.0f;
+  for (int64_t i = threadIdx.x; i < chunk; i += kLseBlockDim) {
+    local_sum += __expf(static_cast<float>(row_logits[i]) - new_max);
+  }
+  float chunk_sum = BlockReduce(temp_storage).Sum(local_sum);
+  if (threadIdx.x == 0) {
+    sum_exp[row] = sum_exp[row] * __expf(max_value[row] - new_max) + chunk_sum;
+    max_value[row] = new_max;
+    int64_t index = static_cast<int64_t>(label[row]) - chunk_begin;
+    if (index >= 0 && index < chunk) {
+      target[row] = static_cast<float>(row_logits[index]);
+    }
+  }
+}
+
+// Rescale the local sum of exp of each token to the global max of the ranks.
+__global__ void RescaleSumExpKernel(const float* local_max,
+                                    const float* global_max,
+                                    int64_t num,
+                                    float* sum_exp) {
+  CUDA_KERNEL_LOOP_TYPE(i, num, int64_t) {
+    sum_exp[i] *= __expf(local_max[i] - global_max[i]);
+  }
+}
+
+template <typename T, typename LabelT>
+__global__ void CrossEntropyLossKernel(const float* max_value,
+                                       const float* sum_exp,
+                                       const float* target,
+                                       const LabelT* label,
+                                       int64_t ignore_index,
+                                       int64_t num,
+                                       T* loss,
+                                       float* lse) {
+  CUDA_KERNEL_LOOP_TYPE(i, num, int64_t) {
+    float value = max_value[i] + __logf(sum_exp[i]);
+    lse[i] = value;
+    loss[i] = static_cast<LabelT>(ignore_index) == label[i]
+                  ? static_cast<T>(0)
+                  : static_cast<T>(value - target[i]);
+  }
+}
+
+template <typename T, typename LabelT>
+void FusedLinearCrossEntropyImpl(const GPUContext& dev_ctx,
+                                 const DenseTensor& x,
+                                 const DenseTensor& weight,
+                                 const DenseTensor& label,
+                                 int64_t ignore_index,
+                                 int64_t chunk_size,
+                                 int64_t start_index,
+                                 int nranks,
+                                 DenseTensor* loss,
+                                 DenseTensor* lse) {
+  const int64_t hidden = weight.dims()[0];
+  const int64_t vocab = weight.dims()[1];
+  const int64_t num = x.numel() / hidden;
+  const int64_t chunk = std::min(chunk_size, vocab);
+
+  T* loss_data = dev_ctx.template Alloc<T>(loss);
+  float* lse_data = dev_ctx.template Alloc<float>(lse);
+  if (num == 0) return;
+
+  DenseTensor max_value, sum_exp, target, logits;
+  max_value.Resize({num});
+  sum_exp.Resize({num});
+  target.Resize({num});
+  logits.Resize({num, chunk});
+  dev_ctx.template Alloc<float>(&max_value);
+  dev_ctx.template Alloc<float>(&sum_exp);
+  dev_ctx.template Alloc<float>(&target);
+  T* logits_data = dev_ctx.template Alloc<T>(&logits);
+  phi::funcs::SetConstant<GPUContext, float> set_constant;
+  set_constant(dev_ctx, &max_value, -std::numeric_limits<float>::infinity());
+  set_constant(dev_ctx, &sum_exp, 0.0f);
+  set_constant(dev_ctx, &target, 0.0f);
+
+  auto blas = phi::funcs::GetBlas<GPUContext, T>(dev_ctx);
+  const T* x_data = x.data<T>();
+  const T* weight_data = weight.data<T>();
+  const LabelT* label_data = label.data<LabelT>();
+  auto stream = dev_ctx.stream();
+  // Only the logits of [num, chunk] live at a time, instead of [num, vocab].
+  for (int64_t begin = 0; begin < vocab; begin += chunk) {
+    const int64_t width = std::min(chunk, vocab - begin);
+    blas.GEMM(false,
+              false,
+              num,
+              width,
+              hidden,
+              static_cast<T>(1),
+              x_data,
+              hidden,
+              weight_data + begin,
+              vocab,
+              static_cast<T>(0),
+              logits_data,
+              width);
+    ChunkLogSumExpKernel<T, LabelT>
+        <<<num, kLseBlockDim, 0, stream>>>(logits_data,
+                                           label_data,
+                                           width,
+                                           start_index + begin,
+                                           max_value.data<float>(),
+                                           sum_exp.data<float>(),
+                                           target.data<float>());
+  }
+
+  auto config = phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, num);
+  if (nranks > 1) {
+    // The vocab is split over the ranks as c_embedding: merge the log-sum-exp
+    // of the shards, the label logit is only picked by the owner rank.
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+    auto comm_ctx =
+        static_cast<distributed::NCCLCommContext*>(dev_ctx.GetCommContext());
+    PADDLE_ENFORCE_NE(
+        comm_ctx,
+        nullptr,
+        errors::Unavailable("NCCLCommContext is nullptr, collective op should "
+                            "has ring_id attr."));
+    DenseTensor global_max;
+    global_max.Resize({num});
+    dev_ctx.template Alloc<float>(&global_max);
+    comm_ctx->AllReduce(&global_max, max_value, ncclMax, stream);
+    RescaleSumExpKernel<<<config.block_per_grid,
+                          config.thread_per_block,
+                          0,
+                          stream>>>(max_value.data<float>(),
+                                    global_max.data<float>(),
+                                    num,
+                                    sum_exp.data<float>());
+    comm_ctx->AllReduce(&sum_exp, sum_exp, ncclSum, stream);
+    comm_ctx->AllReduce(&target, target, ncclSum, stream);
+    max_value = global_max;
+#else
+    PADDLE_THROW(phi::errors::PreconditionNotMet(
+        "PaddlePaddle should compile with NCCL or RCCL when nranks > 1."));
+#endif
+  }
+  CrossEntropyLossKernel<T, LabelT>
+      <<<config.block_per_grid, config.thread_per_block, 0, stream>>>(
+          max_value.data<float>(),
+          sum_exp.data<float>(),
+          target.data<float>(),
+          label_data,
+          ignore_index,
+          num,
+          loss_data,
+          lse_data);
+}
+
+// loss = logsumexp(x * weight) - (x * weight)[label] of each token, where the
+// weight is the [hidden_size, vocab_size] (or its shard of the ranks) weight
+// of the vocab projection. The logits are computed by chunks of chunk_size
+// columns and reduced online, so that the full [tokens, vocab_size] logits
+// and softmax are never materialized.
+template <typename T, typename Context>
+void FusedLinearCrossEntropyKernel(const Context& dev_ctx,
+                                   const DenseTensor& x,
+                                   const DenseTensor& weight,
+                                   const DenseTensor& label,
+                                   int64_t ignore_index,
+                                   int64_t chunk_size,
+                                   int64_t start_index,
+                                   int ring_id,
+                                   int nranks,
+                                   DenseTensor* loss,
+                                   DenseTensor* lse) {
+  const auto& label_type = label.dtype();
+  if (label_type == phi::DataType::INT32) {
+    FusedLinearCrossEntropyImpl<T, int32_t>(dev_ctx,
+                                            x,
+                                            weight,
+                                            label,
+                                            ignore_index,
+                                            chunk_size,
+                                            start_index,
+                                            nranks,
+                                            loss,
+                                            lse);
+  } else if (label_type == phi::DataType::INT64) {
+    FusedLinearCrossEntropyImpl<T, int64_t>(dev_ctx,
+                                            x,
+                                            weight,
+                                            label,
+                                            ignore_index,
+                                            chunk_size,
+                                            start_index,
+                                            nranks,
+                                            loss,
+                                            lse);
+  } else {
+    PADDLE_THROW(phi::errors::Unavailable(
+        "The label of fused_linear_cross_entropy should be int32 or int64, "
+        "but received %s.",
+        label_type));
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_linear_cross_entropy,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedLinearCrossEntropyKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->OutputAt(1).SetDataType(phi::DataType::FLOAT32);
+}
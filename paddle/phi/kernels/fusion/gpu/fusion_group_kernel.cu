@@ -60,7 +60,9 @@ void FusionGroupKernel(const Context& dev_ctx,
   VLOG(3) << "func_name: " << func_name;
 
   if (type == 0) {
-    size_t n = ins[0]->numel();
+    // The outputs have the full dims, and the inputs broadcast along the
+    // trailing dims are read at idx % numel in the kernel.
+    size_t n = outs[0]->numel();
     std::vector<void*> args;
     args.push_back(&n);
     std::vector<const void*> ptrs(num_ins + num_outs);
@@ -0,0 +1,192 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/sparse/nm_sparsity.h"
+#include "paddle/phi/kernels/funcs/sparse/sparse_lt_gemm.h"
+#include "paddle/phi/kernels/impl/fc_kernel_impl.h"
+
+namespace phi {
+namespace fusion {
+
+#if defined(PADDLE_WITH_CUSPARSELT) && CUDA_VERSION >= 11020
+
+// The weight compressed for the sparse tensor cores, or not sparse if the
+// weight is not 2:4 sparse.
+template <typename T>
+struct SparseLtWeight {
+  bool sparse{false};
+  funcs::sparse::SparseLtGemm<T> gemm;
+  phi::Allocator::AllocationPtr compressed;
+};
+
+// sparse_fc is an inference op of the persistable 2:4 pruned weights, so the
+// weight is checked and compressed once, at its first run.
+template <typename T>
+std::shared_ptr<SparseLtWeight<T>> GetSparseLtWeight(
+    const phi::GPUContext& dev_ctx, const DenseTensor& w) {
+  static std::mutex mutex;
+  static std::unordered_map<const void*, std::shared_ptr<SparseLtWeight<T>>>
+      weights;
+  std::lock_guard<std::mutex> guard(mutex);
+  auto iter = weights.find(w.data());
+  if (iter != weights.end()) {
+    return iter->second;
+  }
+
+  auto weight = std::make_shared<SparseLtWeight<T>>();
+  const int k = static_cast<int>(w.dims()[0]);
+  const int n = static_cast<int>(w.dims()[1]);
+  // transpose w of [k, n] to [n, k], whose 2:4 groups are along k
+  std::vector<T> w_cpu(w.numel());
+  std::vector<T> w_t(w.numel());
+  memory_utils::Copy(phi::CPUPlace(),
+                     w_cpu.data(),
+                     dev_ctx.GetPlace(),
+                     w.data<T>(),
+                     w.numel() * sizeof(T),
+                     dev_ctx.stream());
+  dev_ctx.Wait();
+  for (int i = 0; i < k; ++i) {
+    for (int j = 0; j < n; ++j) {
+      w_t[j * k + i] = w_cpu[i * n + j];
+    }
+  }
+  weight->sparse =
+      k % 4 == 0 && funcs::sparse::IsNMSparse(w_t.data(), n, k, 2, 4);
+  if (weight->sparse) {
+    auto w_t_gpu = phi::memory_utils::Alloc(
+        dev_ctx.GetPlace(),
+        w.numel() * sizeof(T),
+        phi::Stream(reinterpret_cast<phi::StreamId>(dev_ctx.stream())));
+    memory_utils::Copy(dev_ctx.GetPlace(),
+                       w_t_gpu->ptr(),
+                       phi::CPUPlace(),
+                       w_t.data(),
+                       w.numel() * sizeof(T),
+                       dev_ctx.stream());
+    weight->gemm.Compress(dev_ctx,
+                          reinterpret_cast<const T*>(w_t_gpu->ptr()),
+                          n,
+                          k,
+                          &weight->compressed);
+    dev_ctx.Wait();
+  } else {
+    LOG(WARNING) << "The weight of sparse_fc in the shape [" << w.dims()
+                 << "] is not 2:4 sparse, and is multiplied as a dense one.";
+  }
+  weights[w.data()] = weight;
+  return weight;
+}
+
+template <typename T>
+struct SparseLtFC {
+  bool operator()(const phi::GPUContext& dev_ctx,
+                  const T* input,
+                  const DenseTensor& w,
+                  const T* bias,
+                  int m,
+                  bool with_relu,
+                  T* out) {
+    const int k = static_cast<int>(w.dims()[0]);
+    const int n = static_cast<int>(w.dims()[1]);
+    if (!funcs::sparse::SparseLtGemm<T>::CanBeUsed(dev_ctx, m, n, k)) {
+      return false;
+    }
+    auto weight = GetSparseLtWeight<T>(dev_ctx, w);
+    if (!weight->sparse) {
+      return false;
+    }
+    weight->gemm.Matmul(dev_ctx,
+                        input,
+                        weight->compressed->ptr(),
+                        m,
+                        n,
+                        k,
+                        bias,
+                        with_relu ? "relu" : "",
+                        out);
+    return true;
+  }
+};
+
+// cuSPARSELt has no 2:4 GEMM of double
+template <>
+struct SparseLtFC<double> {
+  bool operator()(const phi::GPUContext& dev_ctx UNUSED,
+                  const double* input UNUSED,
+                  const DenseTensor& w UNUSED,
+                  const double* bias UNUSED,
+                  int m UNUSED,
+                  bool with_relu UNUSED,
+                  double* out UNUSED) {
+    return false;
+  }
+};
+
+#endif
+
+// The fc of the 2:4 pruned weight, which runs on the sparse tensor cores of
+// Ampere by cuSPARSELt if the shapes are aligned, or as a dense fc otherwise.
+template <typename T, typename Context>
+void SparseFCKernel(const Context& dev_ctx,
+                    const DenseTensor& input,
+                    const DenseTensor& w,
+                    const paddle::optional<DenseTensor>& bias,
+                    const int in_num_col_dims,
+                    const std::string& activation_type,
+                    DenseTensor* out) {
+#if defined(PADDLE_WITH_CUSPARSELT) && CUDA_VERSION >= 11020
+  std::vector<int64_t> output_dims;
+  phi::funcs::FCOutputSize(
+      input.dims(), w.dims(), output_dims, in_num_col_dims, false);
+  out->Resize(common::make_ddim(output_dims));
+  out->set_lod(input.lod());
+  int m = static_cast<int>(common::product(out->dims()) / w.dims()[1]);
+  auto* out_data = dev_ctx.template Alloc<T>(out);
+  if (SparseLtFC<T>()(dev_ctx,
+                      input.data<T>(),
+                      w,
+                      bias ? bias->data<T>() : nullptr,
+                      m,
+                      activation_type == "relu",
+                      out_data)) {
+    return;
+  }
+#endif
+  FCKernel<T, Context>(
+      dev_ctx, input, w, bias, in_num_col_dims, activation_type, false, out);
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(sparse_fc,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::SparseFCKernel,
+                   float,
+                   double,
+                   phi::dtype::float16) {}
@@ -27,6 +27,7 @@
 #include "paddle/phi/core/tensor_utils.h"
 #include "paddle/phi/kernels/funcs/adam_functors.h"
 #include "paddle/phi/kernels/funcs/for_range.h"
+#include "paddle/phi/kernels/funcs/multi_tensor_apply.h"
 
 namespace phi {
 
@@ -310,6 +311,146 @@ void AdamDenseKernel(const Context& dev_ctx,
   }
 }
 
+// A block updates a chunk of one of the merged params, so that all the params
+// of a group are updated by a few launches instead of one launch per param.
+template <typename T,
+          typename TG,
+          typename MT,
+          bool IsMultiPrecision,
+          int N,
+          int MaxTensorSize,
+          int MaxBlockSize>
+struct MergedAdamMultiTensorFunctor {
+  __device__ __forceinline__ void operator()(
+      int chunk_size,
+      const funcs::TensorAndBlockInfo<N, MaxTensorSize, MaxBlockSize>& t_info,
+      MT beta1,
+      MT beta2,
+      MT epsilon,
+      MT beta1_pow,
+      MT beta2_pow,
+      const MT* learning_rate) const {
+    int chunk_id, tensor_id;
+    t_info.GetChunkIdAndTensorId(&chunk_id, &tensor_id);
+    int offset = chunk_id * chunk_size;
+    int n = min(t_info.sizes[tensor_id] - offset, chunk_size);
+    const TG* __restrict__ g_ptr =
+        static_cast<const TG*>(t_info.grads[tensor_id]) + offset;
+    T* __restrict__ p_ptr =
+        static_cast<T*>(t_info.tensor_addrs[0][tensor_id]) + offset;
+    MT* __restrict__ mom1_ptr =
+        static_cast<MT*>(t_info.tensor_addrs[1][tensor_id]) + offset;
+    MT* __restrict__ mom2_ptr =
+        static_cast<MT*>(t_info.tensor_addrs[2][tensor_id]) + offset;
+    MT* __restrict__ mp_ptr =
+        IsMultiPrecision
+            ? static_cast<MT*>(t_info.tensor_addrs[3][tensor_id]) + offset
+            : nullptr;
+
+    MT lr = *learning_rate;
+    for (int i = threadIdx.x; i < n; i += blockDim.x) {
+      MT p = IsMultiPrecision ? mp_ptr[i] : static_cast<MT>(p_ptr[i]);
+      MT g = static_cast<MT>(g_ptr[i]);
+      MT mom1 = beta1 * mom1_ptr[i] + (static_cast<MT>(1.0) - beta1) * g;
+      MT mom2 = beta2 * mom2_ptr[i] + (static_cast<MT>(1.0) - beta2) * g * g;
+      MT denom =
+          (sqrt(mom2) / sqrt(static_cast<MT>(1.0) - beta2_pow)) + epsilon;
+      p += (mom1 / denom) * (-(lr / (static_cast<MT>(1.0) - beta1_pow)));
+
+      mom1_ptr[i] = mom1;
+      mom2_ptr[i] = mom2;
+      p_ptr[i] = static_cast<T>(p);
+      if (IsMultiPrecision) {
+        mp_ptr[i] = p;
+      }
+    }
+  }
+};
+
+template <typename T, typename TG, typename MT, bool IsMultiPrecision>
+void LaunchMergedAdamMultiTensorKernel(
+    const GPUContext& dev_ctx,
+    const std::vector<std::vector<DenseTensor*>>& input_vector,
+    const std::vector<const DenseTensor*>& grad,
+    MT beta1,
+    MT beta2,
+    MT epsilon,
+    MT beta1_pow,
+    MT beta2_pow,
+    const MT* learning_rate) {
+  constexpr int kInputNum = IsMultiPrecision ? 5 : 4;
+  constexpr int kMaxTensorSize = IsMultiPrecision ? 48 : 60;
+  constexpr int kMaxBlockSize = 320;
+  constexpr int kBlockSize = 512;
+  constexpr int kChunkSize = 64 * kBlockSize;
+  MergedAdamMultiTensorFunctor<T,
+                               TG,
+                               MT,
+                               IsMultiPrecision,
+                               kInputNum,
+                               kMaxTensorSize,
+                               kMaxBlockSize>
+      functor;
+  funcs::LaunchMultiTensorApplyKernel<kInputNum, kMaxTensorSize, kMaxBlockSize>(
+      dev_ctx,
+      kBlockSize,
+      kChunkSize,
+      input_vector,
+      grad,
+      functor,
+      beta1,
+      beta2,
+      epsilon,
+      beta1_pow,
+      beta2_pow,
+      learning_rate);
+}
+
+// The merged params can be updated by multi tensor apply when they share the
+// learning rate and the values of the beta pows on the host, and are updated
+// in place. Otherwise each param is updated by its own launch.
+template <typename T, typename MT>
+static bool CanUseMergedAdamMultiTensor(
+    const GPUContext& dev_ctx,
+    const std::vector<const DenseTensor*>& param,
+    const std::vector<const DenseTensor*>& grad,
+    const std::vector<const DenseTensor*>& learning_rate,
+    const std::vector<const DenseTensor*>& moment1,
+    const std::vector<const DenseTensor*>& moment2,
+    const std::vector<const DenseTensor*>& beta1_pow,
+    const std::vector<const DenseTensor*>& beta2_pow,
+    const paddle::optional<std::vector<const DenseTensor*>>& master_param,
+    bool multi_precision,
+    const std::vector<DenseTensor*>& param_out,
+    const std::vector<DenseTensor*>& moment1_out,
+    const std::vector<DenseTensor*>& moment2_out,
+    const std::vector<DenseTensor*>& master_param_out) {
+  const MT beta1_pow_value = *beta1_pow[0]->data<MT>();
+  const MT beta2_pow_value = *beta2_pow[0]->data<MT>();
+  for (size_t idx = 0; idx < param.size(); idx++) {
+    if (param[idx]->numel() == 0 ||
+        grad[idx]->dtype() != grad[0]->dtype() ||
+        learning_rate[idx]->data<MT>() != learning_rate[0]->data<MT>() ||
+        beta1_pow[idx]->place() != CPUPlace() ||
+        beta2_pow[idx]->place() != CPUPlace() ||
+        *beta1_pow[idx]->data<MT>() != beta1_pow_value ||
+        *beta2_pow[idx]->data<MT>() != beta2_pow_value ||
+        dev_ctx.template Alloc<T>(param_out[idx]) != param[idx]->data<T>() ||
+        dev_ctx.template Alloc<MT>(moment1_out[idx]) !=
+            moment1[idx]->data<MT>() ||
+        dev_ctx.template Alloc<MT>(moment2_out[idx]) !=
+            moment2[idx]->data<MT>()) {
+      return false;
+    }
+    if (multi_precision &&
+        dev_ctx.template Alloc<MT>(master_param_out[idx]) !=
+            master_param.get()[idx]->data<MT>()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 template <typename T, typename Context>
 void MergedAdamKernel(
     const Context& dev_ctx,
@@ -340,6 +481,66 @@ void MergedAdamKernel(
 
   size_t param_num = param.size();
 
+  if (param_num > 0 &&
+      CanUseMergedAdamMultiTensor<T, MPDType>(dev_ctx,
+                                              param,
+                                              grad,
+                                              learning_rate,
+                                              moment1,
+                                              moment2,
+                                              beta1_pow,
+                                              beta2_pow,
+                                              master_param,
+                                              multi_precision,
+                                              param_out,
+                                              moment1_out,
+                                              moment2_out,
+                                              master_param_out)) {
+    VLOG(4) << "Update " << param_num << " params by multi tensor apply.";
+    std::vector<std::vector<DenseTensor*>> input_vector(
+        {param_out, moment1_out, moment2_out});
+    if (multi_precision) {
+      input_vector.push_back(master_param_out);
+    }
+    MPDType beta1_pow_value = *beta1_pow[0]->data<MPDType>();
+    MPDType beta2_pow_value = *beta2_pow[0]->data<MPDType>();
+    const MPDType* lr_data = learning_rate[0]->data<MPDType>();
+#define PD_LAUNCH_MERGED_ADAM_MULTI_TENSOR_KERNEL(__grad_type, __mp) \
+  LaunchMergedAdamMultiTensorKernel<T, __grad_type, MPDType, __mp>(  \
+      dev_ctx,                                                       \
+      input_vector,                                                  \
+      grad,                                                          \
+      beta1_,                                                        \
+      beta2_,                                                        \
+      epsilon_,                                                      \
+      beta1_pow_value,                                               \
+      beta2_pow_value,                                               \
+      lr_data)
+    if (grad[0]->dtype() == phi::DataType::FLOAT32) {
+      if (multi_precision) {
+        PD_LAUNCH_MERGED_ADAM_MULTI_TENSOR_KERNEL(float, true);
+      } else {
+        PD_LAUNCH_MERGED_ADAM_MULTI_TENSOR_KERNEL(float, false);
+      }
+    } else {
+      if (multi_precision) {
+        PD_LAUNCH_MERGED_ADAM_MULTI_TENSOR_KERNEL(T, true);
+      } else {
+        PD_LAUNCH_MERGED_ADAM_MULTI_TENSOR_KERNEL(T, false);
+      }
+    }
+#undef PD_LAUNCH_MERGED_ADAM_MULTI_TENSOR_KERNEL
+    if (!use_global_beta_pow) {
+      for (size_t idx = 0; idx < param_num; idx++) {
+        dev_ctx.template HostAlloc<MPDType>(beta1_pow_out[idx])[0] =
+            beta1_ * beta1_pow_value;
+        dev_ctx.template HostAlloc<MPDType>(beta2_pow_out[idx])[0] =
+            beta2_ * beta2_pow_value;
+      }
+    }
+    return;
+  }
+
   for (size_t idx = 0; idx < param_num; idx++) {
     const MPDType* master_in_data =
         multi_precision ? master_param.get()[idx]->data<MPDType>() : nullptr;
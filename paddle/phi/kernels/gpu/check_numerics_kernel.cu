@@ -589,6 +589,53 @@ void CheckNumericsKernel(const Context& ctx,
 #endif
 }
 
+template <typename T, typename MT>
+__global__ void FindNanInfAndSetFlag(const T* value_ptr,
+                                     const int64_t numel,
+                                     int64_t id,
+                                     int64_t* flag) {
+  bool has_nan_inf = false;
+  for (int64_t i = threadIdx.x + static_cast<int64_t>(blockIdx.x) * blockDim.x;
+       i < numel;
+       i += static_cast<int64_t>(blockDim.x) * gridDim.x) {
+    MT value = static_cast<MT>(value_ptr[i]);
+    has_nan_inf = has_nan_inf || isnan(value) || isinf(value);
+  }
+  // A single atomic for a block, the ids are not negative.
+  if (__syncthreads_or(has_nan_inf) && threadIdx.x == 0) {
+    atomicMin(reinterpret_cast<unsigned long long*>(flag),  // NOLINT
+              static_cast<unsigned long long>(id));         // NOLINT
+  }
+}
+
+template <typename T, typename Context>
+void CheckNumericsFlagKernel(const Context& ctx,
+                             const DenseTensor& tensor,
+                             int64_t id,
+                             int64_t* flag) {
+  if (tensor.numel() <= 0) return;
+
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  const size_t threads = 1024;
+  size_t blocks =
+      std::min(static_cast<size_t>(128),
+               static_cast<size_t>((tensor.numel() + threads - 1) / threads));
+  FindNanInfAndSetFlag<T, MT><<<blocks, threads, 0, ctx.stream()>>>(
+      tensor.data<T>(), tensor.numel(), id, flag);
+}
+
+#define INSTANTIATE_CHECK_NUMERICS_FLAG_KERNEL(T)       \
+  template void CheckNumericsFlagKernel<T, GPUContext>( \
+      const GPUContext&, const DenseTensor&, int64_t, int64_t*);
+
+INSTANTIATE_CHECK_NUMERICS_FLAG_KERNEL(float)
+INSTANTIATE_CHECK_NUMERICS_FLAG_KERNEL(double)
+INSTANTIATE_CHECK_NUMERICS_FLAG_KERNEL(phi::dtype::float16)
+INSTANTIATE_CHECK_NUMERICS_FLAG_KERNEL(phi::dtype::bfloat16)
+INSTANTIATE_CHECK_NUMERICS_FLAG_KERNEL(phi::dtype::complex<float>)
+INSTANTIATE_CHECK_NUMERICS_FLAG_KERNEL(phi::dtype::complex<double>)
+#undef INSTANTIATE_CHECK_NUMERICS_FLAG_KERNEL
+
 }  // namespace phi
 
 PD_REGISTER_KERNEL(check_numerics,
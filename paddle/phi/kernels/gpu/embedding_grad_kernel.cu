@@ -25,6 +25,7 @@
 #include "paddle/phi/core/mixed_vector.h"
 #include "paddle/phi/kernels/funcs/eigen/common.h"
 #include "paddle/phi/kernels/funcs/embedding_util.h"
+#include "paddle/phi/kernels/funcs/segmented_index_add.cu.h"
 #include "paddle/utils/flags.h"
 
 PD_DECLARE_int64(embedding_deterministic);
@@ -107,15 +108,16 @@ struct EmbeddingGradCUDAFunctor {
       if (FLAGS_embedding_deterministic == 1) {
         phi::funcs::LaunchEmbeddingGradDeterministicKernel<T, IdT>(
             dev_ctx_, ids, d_output, d_table, N, D, K);
+      } else if (FLAGS_embedding_deterministic > 1) {
+        // The grads of an id are summed in the order of the ids, as the
+        // single thread did.
+        VLOG(2) << "Run grad kernel of embedding by the sorted ids.";
+        phi::funcs::SegmentedIndexAdd<T, IdT>(
+            dev_ctx_, ids, K, d_output, 1, D, N, d_table);
       } else {
         const int gridx = 2 * dev_ctx_.GetSMCount();
         dim3 threads(128, 8);
         dim3 grids(gridx, 1);
-        if (FLAGS_embedding_deterministic > 1) {
-          VLOG(2) << "Run grad kernel of embedding with single thread.";
-          grids.x = 1;
-          threads.y = 1;
-        }
         EmbeddingGrad<T, IdT><<<grids, threads, 0, dev_ctx_.stream()>>>(
             d_table, d_output, ids, N, K, D);
       }
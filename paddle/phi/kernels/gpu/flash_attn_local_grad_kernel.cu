@@ -0,0 +1,197 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/flash_attn_grad_kernel.h"
+
+#include "glog/logging.h"  // For VLOG()
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/backends/gpu/gpu_primitives.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/gpu/flash_attn_local_utils.h"
+
+namespace phi {
+
+// A warp recomputes the probabilities of a query row by its lse, and
+//   dq_i  = scale * sum_j ds_ij * k_j
+//   dk_j += scale * ds_ij * q_i
+//   dv_j += p_ij * dout_i,
+// where ds_ij = p_ij * (dout_i * v_j - dout_i * out_i). The grads of the keys
+// are accumulated in float by atomics, over the queries of the windows, and
+// over the query heads of a group.
+template <typename T>
+__global__ void LocalAttnBwdKernel(LocalAttnParams<T> params,
+                                   const T* dout,
+                                   T* dq,
+                                   float* dk_accum,
+                                   float* dv_accum) {
+  const int warp = threadIdx.x / kLocalAttnWarpSize;
+  const int lane = threadIdx.x % kLocalAttnWarpSize;
+  const int64_t row_id =
+      static_cast<int64_t>(blockIdx.x) * kLocalAttnWarpsPerBlock + warp;
+  if (row_id >= params.total_q * params.num_heads) return;
+
+  const int64_t token = row_id / params.num_heads;
+  const int head = row_id % params.num_heads;
+  const int head_k = head / (params.num_heads / params.num_heads_k);
+  const int head_dim = params.head_dim;
+  const LocalAttnSeqInfo info = GetLocalAttnSeqInfo(params, token);
+  int64_t begin, end;
+  const int64_t pos = GetLocalAttnKeyRange(params, info, &begin, &end);
+  const float slope = params.alibi_slopes ? params.alibi_slopes[head] : 0.0f;
+  const float lse = params.softmax_lse[row_id];
+  const int64_t kv_stride =
+      static_cast<int64_t>(params.num_heads_k) * head_dim;
+  const int64_t kv_base =
+      info.kv_offset * kv_stride + static_cast<int64_t>(head_k) * head_dim;
+
+  float q_row[kLocalAttnMaxElemsPerLane];
+  float dout_row[kLocalAttnMaxElemsPerLane];
+  float out_row[kLocalAttnMaxElemsPerLane];
+  float dq_row[kLocalAttnMaxElemsPerLane];
+  LocalAttnLoadRow(params.q + row_id * head_dim, head_dim, lane, q_row);
+  LocalAttnLoadRow(dout + row_id * head_dim, head_dim, lane, dout_row);
+  LocalAttnLoadRow(params.out + row_id * head_dim, head_dim, lane, out_row);
+  float dout_dot_out = 0.0f;
+#pragma unroll
+  for (int e = 0; e < kLocalAttnMaxElemsPerLane; ++e) {
+    dout_dot_out += dout_row[e] * out_row[e];
+    dq_row[e] = 0.0f;
+  }
+  dout_dot_out = LocalAttnWarpSum(dout_dot_out);
+
+  for (int64_t j = begin; j < end; ++j) {
+    const T* k_row = params.k + kv_base + j * kv_stride;
+    const T* v_row = params.v + kv_base + j * kv_stride;
+    float score = LocalAttnDot(q_row, k_row, head_dim, lane) * params.scale -
+                  slope * fabsf(static_cast<float>(pos - j));
+    float p = __expf(score - lse);
+    float dp = LocalAttnDot(dout_row, v_row, head_dim, lane);
+    float ds = p * (dp - dout_dot_out) * params.scale;
+    float* dk_row = dk_accum + kv_base + j * kv_stride;
+    float* dv_row = dv_accum + kv_base + j * kv_stride;
+#pragma unroll
+    for (int e = 0; e < kLocalAttnMaxElemsPerLane; ++e) {
+      int d = lane + e * kLocalAttnWarpSize;
+      if (d < head_dim) {
+        dq_row[e] += ds * static_cast<float>(k_row[d]);
+        phi::CudaAtomicAdd(dk_row + d, ds * q_row[e]);
+        phi::CudaAtomicAdd(dv_row + d, p * dout_row[e]);
+      }
+    }
+  }
+
+  T* dq_out = dq + row_id * head_dim;
+#pragma unroll
+  for (int e = 0; e < kLocalAttnMaxElemsPerLane; ++e) {
+    int d = lane + e * kLocalAttnWarpSize;
+    if (d < head_dim) {
+      dq_out[d] = static_cast<T>(dq_row[e]);
+    }
+  }
+}
+
+template <typename T>
+__global__ void CastFloatGradKernel(const float* src, int64_t numel, T* dst) {
+  CUDA_KERNEL_LOOP_TYPE(i, numel, int64_t) { dst[i] = static_cast<T>(src[i]); }
+}
+
+template <typename T, typename Context>
+void FlashAttnLocalGradKernel(
+    const Context& ctx,
+    const DenseTensor& q,
+    const DenseTensor& k,
+    const DenseTensor& v,
+    const paddle::optional<DenseTensor>& cu_seqlens_q,
+    const paddle::optional<DenseTensor>& cu_seqlens_k,
+    const paddle::optional<DenseTensor>& alibi_slopes,
+    const DenseTensor& out,
+    const DenseTensor& softmax_lse,
+    const DenseTensor& dout,
+    int window_size_left,
+    int window_size_right,
+    bool causal,
+    float scale,
+    DenseTensor* dq,
+    DenseTensor* dk,
+    DenseTensor* dv) {
+  LocalAttnParams<T> params = MakeLocalAttnParams<T>(q,
+                                                     k,
+                                                     v,
+                                                     cu_seqlens_q.get_ptr(),
+                                                     cu_seqlens_k.get_ptr(),
+                                                     alibi_slopes.get_ptr(),
+                                                     window_size_left,
+                                                     window_size_right,
+                                                     causal,
+                                                     scale);
+  VLOG(10) << "[FlashAttnLocal Backward] q.shape=[" << q.dims()
+           << "], k.shape=[" << k.dims() << "], window_size=("
+           << params.window_size_left << ", " << params.window_size_right
+           << ")";
+  params.out = const_cast<T*>(out.data<T>());
+  params.softmax_lse = const_cast<float*>(softmax_lse.data<float>());
+
+  T* dq_data = ctx.template Alloc<T>(dq);
+  DenseTensor dk_accum, dv_accum;
+  dk_accum.Resize(k.dims());
+  dv_accum.Resize(v.dims());
+  ctx.template Alloc<float>(&dk_accum);
+  ctx.template Alloc<float>(&dv_accum);
+  phi::funcs::SetConstant<Context, float> set_zero;
+  set_zero(ctx, &dk_accum, 0.0f);
+  set_zero(ctx, &dv_accum, 0.0f);
+
+  const int64_t rows = params.total_q * params.num_heads;
+  if (rows > 0) {
+    const int64_t blocks =
+        (rows + kLocalAttnWarpsPerBlock - 1) / kLocalAttnWarpsPerBlock;
+    const int threads = kLocalAttnWarpsPerBlock * kLocalAttnWarpSize;
+    LocalAttnBwdKernel<T><<<blocks, threads, 0, ctx.stream()>>>(
+        params,
+        dout.data<T>(),
+        dq_data,
+        dk_accum.data<float>(),
+        dv_accum.data<float>());
+  }
+
+  if (dk) {
+    T* dk_data = ctx.template Alloc<T>(dk);
+    if (dk->numel() > 0) {
+      auto config = phi::backends::gpu::GetGpuLaunchConfig1D(ctx, dk->numel());
+      CastFloatGradKernel<T>
+          <<<config.block_per_grid, config.thread_per_block, 0, ctx.stream()>>>(
+              dk_accum.data<float>(), dk->numel(), dk_data);
+    }
+  }
+  if (dv) {
+    T* dv_data = ctx.template Alloc<T>(dv);
+    if (dv->numel() > 0) {
+      auto config = phi::backends::gpu::GetGpuLaunchConfig1D(ctx, dv->numel());
+      CastFloatGradKernel<T>
+          <<<config.block_per_grid, config.thread_per_block, 0, ctx.stream()>>>(
+              dv_accum.data<float>(), dv->numel(), dv_data);
+    }
+  }
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(flash_attn_local_grad,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::FlashAttnLocalGradKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
@@ -0,0 +1,172 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/flash_attn_kernel.h"
+
+#include "glog/logging.h"  // For VLOG()
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/backends/gpu/gpu_primitives.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/gpu/flash_attn_local_utils.h"
+
+namespace phi {
+
+template <typename T, typename Context>
+void FlashAttnLocalKernel(
+    const Context& ctx,
+    const DenseTensor& q,
+    const DenseTensor& k,
+    const DenseTensor& v,
+    const paddle::optional<DenseTensor>& cu_seqlens_q,
+    const paddle::optional<DenseTensor>& cu_seqlens_k,
+    const paddle::optional<DenseTensor>& alibi_slopes,
+    int window_size_left,
+    int window_size_right,
+    bool causal,
+    float scale,
+    DenseTensor* out,
+    DenseTensor* softmax_lse) {
+  LocalAttnParams<T> params = MakeLocalAttnParams<T>(q,
+                                                     k,
+                                                     v,
+                                                     cu_seqlens_q.get_ptr(),
+                                                     cu_seqlens_k.get_ptr(),
+                                                     alibi_slopes.get_ptr(),
+                                                     window_size_left,
+                                                     window_size_right,
+                                                     causal,
+                                                     scale);
+  VLOG(10) << "[FlashAttnLocal Forward] q.shape=[" << q.dims()
+           << "], k.shape=[" << k.dims() << "], window_size=("
+           << params.window_size_left << ", " << params.window_size_right
+           << "), alibi=" << (params.alibi_slopes != nullptr);
+
+  params.out = ctx.template Alloc<T>(out);
+  params.softmax_lse = ctx.template Alloc<float>(softmax_lse);
+  LaunchLocalAttnFwd<T>(ctx, params);
+}
+
+template <typename T>
+__global__ void AppendKVCacheKernel(const T* src,
+                                    const int32_t* seq_lens,
+                                    int64_t seqlen,
+                                    int64_t max_seqlen,
+                                    int64_t row_size,
+                                    int64_t numel,
+                                    T* cache) {
+  CUDA_KERNEL_LOOP_TYPE(i, numel, int64_t) {
+    const int64_t token = i / row_size;
+    const int64_t batch = token / seqlen;
+    const int64_t pos = seq_lens[batch] + token % seqlen;
+    // The tokens beyond the capacity of the cache are dropped.
+    if (pos < max_seqlen) {
+      cache[(batch * max_seqlen + pos) * row_size + i % row_size] = src[i];
+    }
+  }
+}
+
+template <typename T, typename Context>
+void FlashAttnKVCacheKernel(const Context& ctx,
+                            const DenseTensor& q,
+                            const DenseTensor& k,
+                            const DenseTensor& v,
+                            const DenseTensor& cache_k,
+                            const DenseTensor& cache_v,
+                            const DenseTensor& seq_lens,
+                            const paddle::optional<DenseTensor>& alibi_slopes,
+                            int window_size_left,
+                            float scale,
+                            DenseTensor* out,
+                            DenseTensor* cache_k_out,
+                            DenseTensor* cache_v_out) {
+  const auto& cache_dims = cache_k.dims();
+  PADDLE_ENFORCE_EQ(
+      cache_dims.size() == 4 && k.dims().size() == 4 &&
+          cache_dims[0] == k.dims()[0] && cache_dims[2] == k.dims()[2] &&
+          cache_dims[3] == k.dims()[3],
+      true,
+      phi::errors::InvalidArgument(
+          "The kv cache should be [batch_size, max_seqlen, num_heads_k, "
+          "head_dim] of the same batch_size, num_heads_k and head_dim as k, "
+          "but received the cache of [%s] and k of [%s].",
+          cache_dims,
+          k.dims()));
+  PADDLE_ENFORCE_EQ(
+      seq_lens.dtype() == DataType::INT32 && seq_lens.numel() == cache_dims[0],
+      true,
+      phi::errors::InvalidArgument(
+          "The seq_lens of the kv cache should be int32 of [batch_size]."));
+
+  // The outputs share the memory of the inputs of the cache.
+  T* cache_k_data = ctx.template Alloc<T>(cache_k_out);
+  T* cache_v_data = ctx.template Alloc<T>(cache_v_out);
+  const int64_t seqlen = k.dims()[1];
+  const int64_t max_seqlen = cache_dims[1];
+  const int64_t row_size = cache_dims[2] * cache_dims[3];
+  if (k.numel() > 0) {
+    auto config = phi::backends::gpu::GetGpuLaunchConfig1D(ctx, k.numel());
+    AppendKVCacheKernel<T>
+        <<<config.block_per_grid, config.thread_per_block, 0, ctx.stream()>>>(
+            k.data<T>(),
+            seq_lens.data<int32_t>(),
+            seqlen,
+            max_seqlen,
+            row_size,
+            k.numel(),
+            cache_k_data);
+    AppendKVCacheKernel<T>
+        <<<config.block_per_grid, config.thread_per_block, 0, ctx.stream()>>>(
+            v.data<T>(),
+            seq_lens.data<int32_t>(),
+            seqlen,
+            max_seqlen,
+            row_size,
+            v.numel(),
+            cache_v_data);
+  }
+
+  LocalAttnParams<T> params = MakeLocalAttnParams<T>(q,
+                                                     *cache_k_out,
+                                                     *cache_v_out,
+                                                     nullptr,
+                                                     nullptr,
+                                                     alibi_slopes.get_ptr(),
+                                                     window_size_left,
+                                                     0,
+                                                     true,
+                                                     scale);
+  params.seq_lens_k = seq_lens.data<int32_t>();
+  params.out = ctx.template Alloc<T>(out);
+  LaunchLocalAttnFwd<T>(ctx, params);
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(flash_attn_local,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::FlashAttnLocalKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->OutputAt(1).SetDataType(phi::DataType::FLOAT32);
+}
+
+PD_REGISTER_KERNEL(flash_attn_kv_cache,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::FlashAttnKVCacheKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
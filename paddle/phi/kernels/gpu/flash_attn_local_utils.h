@@ -0,0 +1,345 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cmath>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_device_function.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace phi {
+
+// The tiled attention of the local (sliding window) attention, the ALiBi
+// bias, the grouped query attention and the decoding on a kv cache, which
+// are not supported by the flash-attention library. A warp computes a query
+// row of a head with the online softmax over the keys of its window, so the
+// attention scores are never materialized.
+//
+// The query i of a sequence attends to the key j when
+//   i + seqlen_k - seqlen_q - window_size_left <= j
+//   j <= i + seqlen_k - seqlen_q + window_size_right,
+// where a negative window size is unlimited, i.e. the queries are aligned to
+// the end of the keys like the flash-attention. The ALiBi bias of the head h
+// is -alibi_slopes[h] * |i + seqlen_k - seqlen_q - j|.
+
+// Each lane keeps head_dim / 32 elements of the row.
+constexpr int kLocalAttnWarpSize = 32;
+constexpr int kLocalAttnMaxHeadDim = 256;
+constexpr int kLocalAttnMaxElemsPerLane =
+    kLocalAttnMaxHeadDim / kLocalAttnWarpSize;
+constexpr int kLocalAttnWarpsPerBlock = 4;
+
+template <typename T>
+struct LocalAttnParams {
+  const T* q;
+  const T* k;
+  const T* v;
+  T* out;
+  float* softmax_lse;
+
+  // The cumulative lengths of the packed sequences of [batch_size + 1], or
+  // nullptr for the padded [batch_size, seqlen, num_heads, head_dim] layout.
+  const int32_t* cu_seqlens_q;
+  const int32_t* cu_seqlens_k;
+  // The lengths of the kv cache before appending, the keys of the batch b
+  // are the first seq_lens_k[b] + seqlen_q tokens of the cache.
+  const int32_t* seq_lens_k;
+  const float* alibi_slopes;
+
+  int batch_size;
+  // The padded seqlen, or the capacity of the kv cache.
+  int64_t seqlen_q;
+  int64_t seqlen_k;
+  int64_t total_q;
+  int num_heads;
+  int num_heads_k;
+  int head_dim;
+  int window_size_left;
+  int window_size_right;
+  float scale;
+};
+
+struct LocalAttnSeqInfo {
+  int batch;
+  int64_t query;
+  int64_t seqlen_q;
+  int64_t seqlen_k;
+  int64_t kv_offset;
+};
+
+template <typename T>
+__device__ __forceinline__ LocalAttnSeqInfo
+GetLocalAttnSeqInfo(const LocalAttnParams<T>& params, int64_t token) {
+  LocalAttnSeqInfo info;
+  if (params.cu_seqlens_q) {
+    int lo = 0, hi = params.batch_size;
+    while (hi - lo > 1) {
+      int mid = (lo + hi) / 2;
+      if (params.cu_seqlens_q[mid] <= token) {
+        lo = mid;
+      } else {
+        hi = mid;
+      }
+    }
+    info.batch = lo;
+    info.query = token - params.cu_seqlens_q[lo];
+    info.seqlen_q = params.cu_seqlens_q[lo + 1] - params.cu_seqlens_q[lo];
+    info.seqlen_k = params.cu_seqlens_k[lo + 1] - params.cu_seqlens_k[lo];
+    info.kv_offset = params.cu_seqlens_k[lo];
+  } else {
+    info.batch = static_cast<int>(token / params.seqlen_q);
+    info.query = token % params.seqlen_q;
+    info.seqlen_q = params.seqlen_q;
+    info.seqlen_k =
+        params.seq_lens_k
+            ? min(params.seq_lens_k[info.batch] + params.seqlen_q,
+                  params.seqlen_k)
+            : params.seqlen_k;
+    info.kv_offset = info.batch * params.seqlen_k;
+  }
+  return info;
+}
+
+// The keys [*begin, *end) of the window of the query, and the position of
+// the query aligned to the keys.
+template <typename T>
+__device__ __forceinline__ int64_t
+GetLocalAttnKeyRange(const LocalAttnParams<T>& params,
+                     const LocalAttnSeqInfo& info,
+                     int64_t* begin,
+                     int64_t* end) {
+  const int64_t pos = info.query + info.seqlen_k - info.seqlen_q;
+  *begin = params.window_size_left < 0
+               ? 0
+               : max(pos - params.window_size_left, static_cast<int64_t>(0));
+  *end = params.window_size_right < 0
+             ? info.seqlen_k
+             : min(pos + params.window_size_right + 1, info.seqlen_k);
+  return pos;
+}
+
+__device__ __forceinline__ float LocalAttnWarpSum(float val) {
+#pragma unroll
+  for (int mask = kLocalAttnWarpSize / 2; mask > 0; mask >>= 1) {
+    val += phi::backends::gpu::CudaShuffleXorSync(0xffffffff, val, mask);
+  }
+  return val;
+}
+
+// The dot of a row kept by the lanes and the row of the head_dim elements.
+template <typename T>
+__device__ __forceinline__ float LocalAttnDot(const float* row,
+                                              const T* other,
+                                              int head_dim,
+                                              int lane) {
+  float sum = 0.0f;
+#pragma unroll
+  for (int e = 0; e < kLocalAttnMaxElemsPerLane; ++e) {
+    int d = lane + e * kLocalAttnWarpSize;
+    if (d < head_dim) {
+      sum += row[e] * static_cast<float>(other[d]);
+    }
+  }
+  return LocalAttnWarpSum(sum);
+}
+
+template <typename T>
+__device__ __forceinline__ void LocalAttnLoadRow(const T* src,
+                                                 int head_dim,
+                                                 int lane,
+                                                 float* row) {
+#pragma unroll
+  for (int e = 0; e < kLocalAttnMaxElemsPerLane; ++e) {
+    int d = lane + e * kLocalAttnWarpSize;
+    row[e] = d < head_dim ? static_cast<float>(src[d]) : 0.0f;
+  }
+}
+
+template <typename T>
+__global__ void LocalAttnFwdKernel(LocalAttnParams<T> params) {
+  const int warp = threadIdx.x / kLocalAttnWarpSize;
+  const int lane = threadIdx.x % kLocalAttnWarpSize;
+  const int64_t row_id =
+      static_cast<int64_t>(blockIdx.x) * kLocalAttnWarpsPerBlock + warp;
+  if (row_id >= params.total_q * params.num_heads) return;
+
+  const int64_t token = row_id / params.num_heads;
+  const int head = row_id % params.num_heads;
+  const int head_k = head / (params.num_heads / params.num_heads_k);
+  const int head_dim = params.head_dim;
+  const LocalAttnSeqInfo info = GetLocalAttnSeqInfo(params, token);
+  int64_t begin, end;
+  const int64_t pos = GetLocalAttnKeyRange(params, info, &begin, &end);
+  const float slope = params.alibi_slopes ? params.alibi_slopes[head] : 0.0f;
+  const int64_t kv_stride = static_cast<int64_t>(params.num_heads_k) * head_dim;
+  const T* k_base = params.k + info.kv_offset * kv_stride + head_k * head_dim;
+  const T* v_base = params.v + info.kv_offset * kv_stride + head_k * head_dim;
+
+  float q_row[kLocalAttnMaxElemsPerLane];
+  float acc[kLocalAttnMaxElemsPerLane];
+  LocalAttnLoadRow(params.q + row_id * head_dim, head_dim, lane, q_row);
+#pragma unroll
+  for (int e = 0; e < kLocalAttnMaxElemsPerLane; ++e) {
+    acc[e] = 0.0f;
+  }
+  float max_score = -INFINITY;
+  float sum_exp = 0.0f;
+  for (int64_t j = begin; j < end; ++j) {
+    float score = LocalAttnDot(q_row, k_base + j * kv_stride, head_dim, lane) *
+                      params.scale -
+                  slope * fabsf(static_cast<float>(pos - j));
+    float new_max = fmaxf(max_score, score);
+    float rescale = __expf(max_score - new_max);
+    float p = __expf(score - new_max);
+    sum_exp = sum_exp * rescale + p;
+    const T* v_row = v_base + j * kv_stride;
+#pragma unroll
+    for (int e = 0; e < kLocalAttnMaxElemsPerLane; ++e) {
+      int d = lane + e * kLocalAttnWarpSize;
+      if (d < head_dim) {
+        acc[e] = acc[e] * rescale + p * static_cast<float>(v_row[d]);
+      }
+    }
+    max_score = new_max;
+  }
+
+  // A query of no keys outputs zeros, and its lse is +inf so that the
+  // probabilities recomputed by the backward are zeros.
+  const float inv_sum = sum_exp > 0.0f ? 1.0f / sum_exp : 0.0f;
+  T* out_row = params.out + row_id * head_dim;
+#pragma unroll
+  for (int e = 0; e < kLocalAttnMaxElemsPerLane; ++e) {
+    int d = lane + e * kLocalAttnWarpSize;
+    if (d < head_dim) {
+      out_row[d] = static_cast<T>(acc[e] * inv_sum);
+    }
+  }
+  if (lane == 0 && params.softmax_lse) {
+    params.softmax_lse[row_id] =
+        sum_exp > 0.0f ? max_score + __logf(sum_exp) : INFINITY;
+  }
+}
+
+template <typename T>
+void LaunchLocalAttnFwd(const GPUContext& ctx,
+                        const LocalAttnParams<T>& params) {
+  const int64_t rows = params.total_q * params.num_heads;
+  if (rows == 0) return;
+  const int64_t blocks =
+      (rows + kLocalAttnWarpsPerBlock - 1) / kLocalAttnWarpsPerBlock;
+  const int threads = kLocalAttnWarpsPerBlock * kLocalAttnWarpSize;
+  LocalAttnFwdKernel<T><<<blocks, threads, 0, ctx.stream()>>>(params);
+}
+
+
+inline void CheckLocalAttnShape(int num_heads, int num_heads_k, int head_dim) {
+  PADDLE_ENFORCE_EQ(
+      num_heads % num_heads_k,
+      0,
+      phi::errors::InvalidArgument(
+          "The num_heads of q should be a multiple of the num_heads of k and "
+          "v for the grouped query attention, but received %d vs %d.",
+          num_heads,
+          num_heads_k));
+  PADDLE_ENFORCE_LE(head_dim,
+                    kLocalAttnMaxHeadDim,
+                    phi::errors::InvalidArgument(
+                        "The head_dim of the local attention should be at "
+                        "most %d, but received %d.",
+                        kLocalAttnMaxHeadDim,
+                        head_dim));
+}
+
+// The params of q, k, v of [batch_size, seqlen, num_heads, head_dim], or of
+// [total_seqlen, num_heads, head_dim] packed by cu_seqlens_q and cu_seqlens_k.
+template <typename T>
+LocalAttnParams<T> MakeLocalAttnParams(const DenseTensor& q,
+                                       const DenseTensor& k,
+                                       const DenseTensor& v,
+                                       const DenseTensor* cu_seqlens_q,
+                                       const DenseTensor* cu_seqlens_k,
+                                       const DenseTensor* alibi_slopes,
+                                       int window_size_left,
+                                       int window_size_right,
+                                       bool causal,
+                                       float scale) {
+  PADDLE_ENFORCE_EQ(
+      (cu_seqlens_q == nullptr) == (cu_seqlens_k == nullptr),
+      true,
+      phi::errors::InvalidArgument(
+          "cu_seqlens_q and cu_seqlens_k should be both set or both unset."));
+  const int rank = cu_seqlens_q ? 3 : 4;
+  const auto& dims = q.dims();
+  PADDLE_ENFORCE_EQ(dims.size(),
+                    rank,
+                    phi::errors::InvalidArgument(
+                        "The local attention receives q of %s, but received "
+                        "q of [%s].",
+                        cu_seqlens_q ? "[total_seqlen, num_heads, head_dim]"
+                                     : "[batch_size, seqlen, num_heads, "
+                                       "head_dim]",
+                        dims));
+
+  LocalAttnParams<T> params;
+  params.q = q.data<T>();
+  params.k = k.data<T>();
+  params.v = v.data<T>();
+  params.out = nullptr;
+  params.softmax_lse = nullptr;
+  params.cu_seqlens_q = cu_seqlens_q ? cu_seqlens_q->data<int32_t>() : nullptr;
+  params.cu_seqlens_k = cu_seqlens_k ? cu_seqlens_k->data<int32_t>() : nullptr;
+  params.seq_lens_k = nullptr;
+  params.alibi_slopes = nullptr;
+  params.num_heads = dims[rank - 2];
+  params.head_dim = dims[rank - 1];
+  params.num_heads_k = k.dims()[rank - 2];
+  if (cu_seqlens_q) {
+    params.batch_size = cu_seqlens_q->numel() - 1;
+    params.seqlen_q = 0;
+    params.seqlen_k = 0;
+    params.total_q = dims[0];
+  } else {
+    params.batch_size = dims[0];
+    params.seqlen_q = dims[1];
+    params.seqlen_k = k.dims()[1];
+    params.total_q = dims[0] * dims[1];
+  }
+  CheckLocalAttnShape(params.num_heads, params.num_heads_k, params.head_dim);
+  PADDLE_ENFORCE_EQ(v.dims()[rank - 1],
+                    params.head_dim,
+                    phi::errors::InvalidArgument(
+                        "The head_dim of v should be equal to that of q."));
+
+  if (alibi_slopes) {
+    PADDLE_ENFORCE_EQ(
+        alibi_slopes->dtype() == DataType::FLOAT32 &&
+            alibi_slopes->numel() == params.num_heads,
+        true,
+        phi::errors::InvalidArgument(
+            "The alibi_slopes should be float32 of [num_heads], but received "
+            "%s of [%s].",
+            alibi_slopes->dtype(),
+            alibi_slopes->dims()));
+    params.alibi_slopes = alibi_slopes->data<float>();
+  }
+  params.window_size_left = window_size_left;
+  params.window_size_right = causal ? 0 : window_size_right;
+  params.scale = scale > 0.0f ? scale : 1.0f / std::sqrt(params.head_dim);
+  return params;
+}
+
+}  // namespace phi
@@ -20,6 +20,7 @@
 #include "paddle/phi/backends/gpu/gpu_primitives.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/utils/data_type.h"
+#include "paddle/phi/kernels/funcs/segmented_index_add.cu.h"
 #include "paddle/utils/flags.h"
 
 PD_DECLARE_bool(cudnn_deterministic);
@@ -84,9 +85,28 @@ void IndexAddKernel(const Context& ctx,
   phi::Copy(ctx, x, ctx.GetPlace(), false, output);
 
   if (FLAGS_cudnn_deterministic) {
-    VLOG(2) << "Run grad kernel of index_add with single thread.";
-    block_dim = 1;
-    grid_dim.x = 1;
+    VLOG(2) << "Run index_add by the sorted index deterministically.";
+    int64_t outer = numel / (size * stride);
+    if (index_type == phi::DataType::INT64) {
+      phi::funcs::SegmentedIndexAdd<T, int64_t>(ctx,
+                                                index.data<int64_t>(),
+                                                size,
+                                                add_value_data,
+                                                outer,
+                                                stride,
+                                                input_dim[dim],
+                                                out_data);
+    } else {
+      phi::funcs::SegmentedIndexAdd<T, int>(ctx,
+                                            index.data<int>(),
+                                            size,
+                                            add_value_data,
+                                            outer,
+                                            stride,
+                                            input_dim[dim],
+                                            out_data);
+    }
+    return;
   }
 
   if (index_type == phi::DataType::INT64) {
@@ -21,6 +21,7 @@
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/utils/data_type.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/funcs/segmented_index_add.cu.h"
 #include "paddle/utils/flags.h"
 
 PD_DECLARE_bool(cudnn_deterministic);
@@ -94,9 +95,29 @@ void IndexSelectGradKernel(const Context& ctx,
   index_select_grad_init(ctx, x_grad, static_cast<T>(0));
 
   if (FLAGS_cudnn_deterministic) {
-    VLOG(2) << "Run grad kernel of index_select with single thread.";
-    block_dim = 1;
-    grid_dim.x = 1;
+    VLOG(2) << "Run grad kernel of index_select by the sorted index "
+               "deterministically.";
+    int64_t outer = out_nums / (size * stride);
+    if (index_type == phi::DataType::INT64) {
+      phi::funcs::SegmentedIndexAdd<T, int64_t>(ctx,
+                                                index.data<int64_t>(),
+                                                size,
+                                                output_grad_data,
+                                                outer,
+                                                stride,
+                                                input_dim[dim],
+                                                in_grad_data);
+    } else {
+      phi::funcs::SegmentedIndexAdd<T, int>(ctx,
+                                            index.data<int>(),
+                                            size,
+                                            output_grad_data,
+                                            outer,
+                                            stride,
+                                            input_dim[dim],
+                                            in_grad_data);
+    }
+    return;
   }
 
   if (index_type == phi::DataType::INT64) {
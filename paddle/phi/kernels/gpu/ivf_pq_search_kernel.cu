@@ -0,0 +1,250 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "paddle/phi/kernels/ivf_pq_kernel.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/common/scalar.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/top_k_kernel.h"
+
+namespace phi {
+
+// The candidates of a chunk of the queries, so that the scratch of the scores
+// and the positions stay below 48MB.
+static constexpr int64_t kMaxChunkCandidates = 1 << 22;
+
+template <typename T>
+__global__ void IvfPqCoarseKernel(const T* query,
+                                  const T* centroids,
+                                  int64_t num_queries,
+                                  int64_t nlist,
+                                  int64_t d,
+                                  T* out) {
+  CUDA_KERNEL_LOOP_TYPE(i, num_queries * nlist, int64_t) {
+    const T* q = query + (i / nlist) * d;
+    const T* c = centroids + (i % nlist) * d;
+    T sum = 0;
+    for (int64_t j = 0; j < d; ++j) {
+      const T diff = q[j] - c[j];
+      sum += diff * diff;
+    }
+    out[i] = sum;
+  }
+}
+
+// A block scans a probed list of a query. The distance table of the residual
+// of the query is built in the shared memory, then each thread sums the table
+// entries of the codes. The scores of the probe p of a query are at the slots
+// [p * max_list, p * max_list + size) of its row.
+template <typename T>
+__global__ void IvfPqScanKernel(const T* query,
+                                const T* centroids,
+                                const T* codebooks,
+                                const uint8_t* codes,
+                                const int64_t* offsets,
+                                const int64_t* probes,
+                                int64_t nprobe,
+                                int64_t d,
+                                int64_t m,
+                                int64_t ksub,
+                                int64_t dsub,
+                                int64_t max_list,
+                                int64_t width,
+                                T* scores,
+                                int64_t* positions) {
+  extern __shared__ char shared[];
+  T* table = reinterpret_cast<T*>(shared);
+  T* residual = table + m * ksub;
+  const int64_t q = blockIdx.x;
+  const int64_t p = blockIdx.y;
+  const int64_t list = probes[q * nprobe + p];
+  for (int64_t j = threadIdx.x; j < d; j += blockDim.x) {
+    residual[j] = query[q * d + j] - centroids[list * d + j];
+  }
+  __syncthreads();
+  for (int64_t t = threadIdx.x; t < m * ksub; t += blockDim.x) {
+    const T* sub = residual + (t / ksub) * dsub;
+    const T* codeword = codebooks + t * dsub;
+    T sum = 0;
+    for (int64_t s = 0; s < dsub; ++s) {
+      const T diff = sub[s] - codeword[s];
+      sum += diff * diff;
+    }
+    table[t] = sum;
+  }
+  __syncthreads();
+  const int64_t begin = offsets[list];
+  const int64_t size = offsets[list + 1] - begin;
+  T* out = scores + q * width + p * max_list;
+  int64_t* out_positions = positions + q * width + p * max_list;
+  for (int64_t i = threadIdx.x; i < size; i += blockDim.x) {
+    const uint8_t* code = codes + (begin + i) * m;
+    T sum = 0;
+    for (int64_t j = 0; j < m; ++j) sum += table[j * ksub + code[j]];
+    out[i] = sum;
+    out_positions[i] = begin + i;
+  }
+}
+
+template <typename T>
+__global__ void IvfPqGatherKernel(const T* top_scores,
+                                  const int64_t* top_slots,
+                                  const int64_t* positions,
+                                  const int64_t* ids,
+                                  int64_t rows,
+                                  int64_t k,
+                                  int64_t width,
+                                  T* distances,
+                                  int64_t* indices) {
+  CUDA_KERNEL_LOOP_TYPE(i, rows * k, int64_t) {
+    const int64_t pos = positions[(i / k) * width + top_slots[i]];
+    distances[i] = top_scores[i];
+    indices[i] = pos >= 0 ? ids[pos] : -1;
+  }
+}
+
+template <typename T, typename Context>
+void IvfPqSearchKernel(const Context& dev_ctx,
+                       const DenseTensor& query,
+                       const DenseTensor& centroids,
+                       const DenseTensor& codebooks,
+                       const DenseTensor& codes,
+                       const DenseTensor& list_offsets,
+                       const DenseTensor& ids,
+                       int k,
+                       int nprobe,
+                       DenseTensor* distances,
+                       DenseTensor* indices) {
+  const int64_t num_queries = query.dims()[0];
+  const int64_t d = query.dims()[1];
+  const int64_t nlist = centroids.dims()[0];
+  const int64_t m = codebooks.dims()[0];
+  const int64_t ksub = codebooks.dims()[1];
+  const int64_t dsub = codebooks.dims()[2];
+  T* dist_data = dev_ctx.template Alloc<T>(distances);
+  int64_t* indices_data = dev_ctx.template Alloc<int64_t>(indices);
+  if (num_queries == 0) return;
+
+  const size_t shared_bytes = (m * ksub + d) * sizeof(T);
+  PADDLE_ENFORCE_LE(
+      shared_bytes,
+      48 << 10,
+      errors::InvalidArgument(
+          "The distance tables of ivf_pq_search on GPU are kept in the "
+          "shared memory, m * ksub + d should be at most %d, but received "
+          "%d.",
+          (48 << 10) / sizeof(T),
+          m * ksub + d));
+
+  // The probed lists of the queries.
+  DenseTensor coarse;
+  coarse.Resize({num_queries, nlist});
+  dev_ctx.template Alloc<T>(&coarse);
+  auto config =
+      phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, num_queries * nlist);
+  IvfPqCoarseKernel<T>
+      <<<config.block_per_grid, config.thread_per_block, 0, dev_ctx.stream()>>>(
+          query.data<T>(),
+          centroids.data<T>(),
+          num_queries,
+          nlist,
+          d,
+          coarse.data<T>());
+  DenseTensor probe_dist, probes;
+  probe_dist.Resize({num_queries, nprobe});
+  probes.Resize({num_queries, nprobe});
+  TopkKernel<T, Context>(
+      dev_ctx, coarse, Scalar(nprobe), -1, false, true, &probe_dist, &probes);
+
+  // The longest list sizes the slots of a probe. The offsets are small, this
+  // is the only copy to the host.
+  DenseTensor host_offsets;
+  phi::Copy(dev_ctx, list_offsets, phi::CPUPlace(), true, &host_offsets);
+  const int64_t* offsets_data = host_offsets.data<int64_t>();
+  int64_t max_list = 0;
+  for (int64_t l = 0; l < nlist; ++l) {
+    max_list = std::max(max_list, offsets_data[l + 1] - offsets_data[l]);
+  }
+  const int64_t width = std::max<int64_t>(k, nprobe * max_list);
+  const int64_t chunk = std::max<int64_t>(1, kMaxChunkCandidates / width);
+
+  phi::funcs::SetConstant<Context, T> set_scores;
+  phi::funcs::SetConstant<Context, int64_t> set_positions;
+  for (int64_t begin = 0; begin < num_queries; begin += chunk) {
+    const int64_t rows = std::min(chunk, num_queries - begin);
+    DenseTensor scores, positions;
+    scores.Resize({rows, width});
+    positions.Resize({rows, width});
+    dev_ctx.template Alloc<T>(&scores);
+    dev_ctx.template Alloc<int64_t>(&positions);
+    set_scores(dev_ctx, &scores, std::numeric_limits<T>::infinity());
+    set_positions(dev_ctx, &positions, static_cast<int64_t>(-1));
+    if (max_list > 0) {
+      IvfPqScanKernel<T>
+          <<<dim3(rows, nprobe), 256, shared_bytes, dev_ctx.stream()>>>(
+              query.data<T>() + begin * d,
+              centroids.data<T>(),
+              codebooks.data<T>(),
+              codes.data<uint8_t>(),
+              list_offsets.data<int64_t>(),
+              probes.data<int64_t>() + begin * nprobe,
+              nprobe,
+              d,
+              m,
+              ksub,
+              dsub,
+              max_list,
+              width,
+              scores.data<T>(),
+              positions.data<int64_t>());
+    }
+    DenseTensor top_scores, top_slots;
+    top_scores.Resize({rows, k});
+    top_slots.Resize({rows, k});
+    TopkKernel<T, Context>(
+        dev_ctx, scores, Scalar(k), -1, false, true, &top_scores, &top_slots);
+    auto gather_config =
+        phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, rows * k);
+    IvfPqGatherKernel<T><<<gather_config.block_per_grid,
+                           gather_config.thread_per_block,
+                           0,
+                           dev_ctx.stream()>>>(top_scores.data<T>(),
+                                               top_slots.data<int64_t>(),
+                                               positions.data<int64_t>(),
+                                               ids.data<int64_t>(),
+                                               rows,
+                                               k,
+                                               width,
+                                               dist_data + begin * k,
+                                               indices_data + begin * k);
+  }
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(
+    ivf_pq_search, GPU, ALL_LAYOUT, phi::IvfPqSearchKernel, float) {
+  kernel->InputAt(3).SetDataType(phi::DataType::UINT8);
+  kernel->InputAt(4).SetDataType(phi::DataType::INT64);
+  kernel->InputAt(5).SetDataType(phi::DataType::INT64);
+  kernel->OutputAt(1).SetDataType(phi::DataType::INT64);
+}
@@ -0,0 +1,206 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/speculative_sampling_kernel.h"
+
+#ifdef PADDLE_WITH_HIP
+#include <hiprand_kernel.h>
+#include <hipcub/hipcub.hpp>
+namespace cub = hipcub;
+#else
+#include <curand_kernel.h>
+#include <cub/cub.cuh>
+#endif
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+namespace phi {
+
+constexpr int kSpeculativeSamplingBlockSize = 256;
+
+// the residual probs max(0, p - q) of a rejected draft token, or the target
+// probs p of the bonus token when q is nullptr
+template <typename T>
+__device__ __forceinline__ float ResidualProb(const T* p,
+                                              const T* q,
+                                              int64_t i) {
+  float prob = static_cast<float>(p[i]);
+  return q == nullptr ? prob : fmaxf(prob - static_cast<float>(q[i]), 0.0f);
+}
+
+template <typename T, int BlockSize>
+__global__ void SpeculativeSamplingCUDAKernel(const int64_t* draft_tokens,
+                                              const T* draft_probs,
+                                              const T* target_probs,
+                                              int num_draft,
+                                              int64_t vocab_size,
+                                              uint64_t seed,
+                                              uint64_t offset,
+                                              int64_t* accept_tokens,
+                                              int* accept_num) {
+  typedef cub::BlockScan<float, BlockSize> BlockScan;
+  __shared__ typename BlockScan::TempStorage temp_storage;
+  __shared__ int s_reject_pos;
+  __shared__ float s_uniform;
+  __shared__ int64_t s_token;
+
+  const int bid = blockIdx.x;
+  const int tid = threadIdx.x;
+  const int64_t* tokens = draft_tokens + bid * num_draft;
+  int64_t* out = accept_tokens + bid * (num_draft + 1);
+  if (tid == 0) {
+#ifdef PADDLE_WITH_HIP
+    hiprandStatePhilox4_32_10_t state;
+    hiprand_init(seed, bid, offset, &state);
+#else
+    curandStatePhilox4_32_10_t state;
+    curand_init(seed, bid, offset, &state);
+#endif
+    int pos = 0;
+    for (; pos < num_draft; ++pos) {
+      int64_t token = tokens[pos];
+      float q = static_cast<float>(
+          draft_probs[(bid * num_draft + pos) * vocab_size + token]);
+      float p = static_cast<float>(
+          target_probs[(bid * (num_draft + 1) + pos) * vocab_size + token]);
+#ifdef PADDLE_WITH_HIP
+      float r = hiprand_uniform(&state);
+#else
+      float r = curand_uniform(&state);
+#endif
+      // accepted with the probability min(1, p / q)
+      if (r * q > p) break;
+      out[pos] = token;
+    }
+    s_reject_pos = pos;
+#ifdef PADDLE_WITH_HIP
+    s_uniform = 1.0f - hiprand_uniform(&state);
+#else
+    s_uniform = 1.0f - curand_uniform(&state);
+#endif
+    s_token = -1;
+  }
+  __syncthreads();
+
+  const int pos = s_reject_pos;
+  const T* p = target_probs + (bid * (num_draft + 1) + pos) * vocab_size;
+  const T* q = pos < num_draft
+                   ? draft_probs + (bid * num_draft + pos) * vocab_size
+                   : nullptr;
+  // every thread sums a contiguous chunk, so the scan of the sums locates the
+  // chunk of the sampled token
+  const int64_t chunk = (vocab_size + BlockSize - 1) / BlockSize;
+  const int64_t begin = min(tid * chunk, vocab_size);
+  const int64_t end = min(begin + chunk, vocab_size);
+  for (int round = 0; round < 2; ++round) {
+    // p equals q in float, so the residual has no mass and p is sampled
+    if (round == 1) q = nullptr;
+    float local = 0.0f;
+    for (int64_t i = begin; i < end; ++i) {
+      local += ResidualProb(p, q, i);
+    }
+    float prefix = 0.0f;
+    float total = 0.0f;
+    BlockScan(temp_storage).ExclusiveSum(local, prefix, total);
+    if (total <= 0.0f) {
+      __syncthreads();
+      continue;
+    }
+    float target = s_uniform * total;
+    if (local > 0.0f && target >= prefix && target < prefix + local) {
+      float cumsum = prefix;
+      int64_t token = begin;
+      for (int64_t i = begin; i < end; ++i) {
+        float prob = ResidualProb(p, q, i);
+        if (prob <= 0.0f) continue;
+        token = i;
+        cumsum += prob;
+        if (target < cumsum) break;
+      }
+      s_token = token;
+    }
+    __syncthreads();
+    break;
+  }
+
+  if (tid == 0) {
+    int64_t token = s_token;
+    if (token < 0) {
+      // the rounding of the scan misses the last token of some mass
+      for (int64_t i = vocab_size - 1; i >= 0; --i) {
+        if (static_cast<float>(p[i]) > 0.0f) {
+          token = i;
+          break;
+        }
+      }
+      token = token < 0 ? 0 : token;
+    }
+    out[pos] = token;
+    for (int i = pos + 1; i <= num_draft; ++i) {
+      out[i] = -1;
+    }
+    accept_num[bid] = pos + 1;
+  }
+}
+
+template <typename T, typename Context>
+void SpeculativeSamplingKernel(const Context& dev_ctx,
+                               const DenseTensor& draft_tokens,
+                               const DenseTensor& draft_probs,
+                               const DenseTensor& target_probs,
+                               int seed,
+                               DenseTensor* accept_tokens,
+                               DenseTensor* accept_num) {
+  const int bsz = draft_tokens.dims()[0];
+  const int num_draft = draft_tokens.dims()[1];
+  const int64_t vocab_size = target_probs.dims()[2];
+  auto* accept_tokens_data = dev_ctx.template Alloc<int64_t>(accept_tokens);
+  auto* accept_num_data = dev_ctx.template Alloc<int>(accept_num);
+  if (bsz == 0) return;
+
+  uint64_t seed_data = seed;
+  uint64_t offset = 0;
+  if (seed == -1) {
+    auto gen_cuda = dev_ctx.GetGenerator();
+    // a Philox draw gives 4 numbers, num_draft + 1 are taken
+    auto seed_offset = gen_cuda->IncrementOffset((num_draft + 4) / 4 * 4);
+    seed_data = seed_offset.first;
+    offset = seed_offset.second;
+  }
+  SpeculativeSamplingCUDAKernel<T, kSpeculativeSamplingBlockSize>
+      <<<bsz, kSpeculativeSamplingBlockSize, 0, dev_ctx.stream()>>>(
+          draft_tokens.data<int64_t>(),
+          draft_probs.data<T>(),
+          target_probs.data<T>(),
+          num_draft,
+          vocab_size,
+          seed_data,
+          offset,
+          accept_tokens_data,
+          accept_num_data);
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(speculative_sampling,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::SpeculativeSamplingKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::INT64);
+  kernel->OutputAt(1).SetDataType(phi::DataType::INT32);
+}
@@ -0,0 +1,220 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/visit_type.h"
+#include "paddle/phi/kernels/cast_kernel.h"
+#include "paddle/phi/kernels/contiguous_kernel.h"
+#include "paddle/phi/kernels/elementwise_add_kernel.h"
+#include "paddle/phi/kernels/elementwise_divide_kernel.h"
+#include "paddle/phi/kernels/elementwise_multiply_kernel.h"
+#include "paddle/phi/kernels/elementwise_subtract_kernel.h"
+#include "paddle/phi/kernels/reduce_sum_kernel.h"
+
+namespace phi {
+
+// The strided elementwise kernels in funcs::ElementwiseKernel and
+// funcs::BroadcastKernel index the elements by 32 bits, so a larger view is
+// copied to be contiguous as the dense kernels expect.
+template <typename Context>
+static DenseTensor ContiguousIfLarge(const Context& dev_ctx,
+                                     const DenseTensor& x,
+                                     int64_t numel) {
+  if (x.meta().is_contiguous() ||
+      numel <= std::numeric_limits<int32_t>::max()) {
+    return x;
+  }
+  DenseTensor out;
+  PD_VISIT_ALL_TYPES(x.dtype(), "ContiguousIfLarge", ([&] {
+                       out = phi::Contiguous<data_t, Context>(dev_ctx, x);
+                     }));
+  return out;
+}
+
+#define DEFINE_BINARY_STRIDED_KERNEL(name)                           \
+  template <typename T, typename Context>                            \
+  void name##StridedKernel(const Context& dev_ctx,                   \
+                           const DenseTensor& x,                     \
+                           const DenseTensor& y,                     \
+                           DenseTensor* out) {                       \
+    out->set_strides(DenseTensorMeta::calc_strides(out->dims()));    \
+    DenseTensor new_x = ContiguousIfLarge(dev_ctx, x, out->numel()); \
+    DenseTensor new_y = ContiguousIfLarge(dev_ctx, y, out->numel()); \
+    phi::name##Kernel<T, Context>(dev_ctx, new_x, new_y, out);       \
+  }
+
+DEFINE_BINARY_STRIDED_KERNEL(Add)
+DEFINE_BINARY_STRIDED_KERNEL(Subtract)
+DEFINE_BINARY_STRIDED_KERNEL(Multiply)
+DEFINE_BINARY_STRIDED_KERNEL(Divide)
+#undef DEFINE_BINARY_STRIDED_KERNEL
+
+template <typename T, typename Context>
+void CastStridedKernel(const Context& dev_ctx,
+                       const DenseTensor& x,
+                       DataType out_dtype,
+                       DenseTensor* out) {
+  out->set_strides(DenseTensorMeta::calc_strides(out->dims()));
+  phi::CastKernel<T, Context>(
+      dev_ctx, ContiguousIfLarge(dev_ctx, x, x.numel()), out_dtype, out);
+}
+
+// Finds the contiguous tensor whose dims are permuted by x, where
+// x.dims()[i] = src->dims()[perm[i]]. The dims of 1 are of any strides.
+static bool GetPermutedSource(const DenseTensor& x,
+                              DenseTensor* src,
+                              std::vector<int>* perm) {
+  const int rank = x.dims().size();
+  std::vector<int> order(rank);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int l, int r) {
+    return x.strides()[l] > x.strides()[r];
+  });
+  std::vector<int64_t> src_dims(rank);
+  for (int i = 0; i < rank; ++i) {
+    src_dims[i] = x.dims()[order[i]];
+  }
+  auto src_strides = DenseTensorMeta::calc_strides(common::make_ddim(src_dims));
+  for (int i = 0; i < rank; ++i) {
+    if (src_dims[i] != 1 && src_strides[i] != x.strides()[order[i]]) {
+      return false;
+    }
+  }
+  perm->resize(rank);
+  for (int i = 0; i < rank; ++i) {
+    (*perm)[order[i]] = i;
+  }
+  auto meta = x.meta();
+  meta.dims = common::make_ddim(src_dims);
+  meta.strides = src_strides;
+  src->set_meta(meta);
+  src->ResetHolder(x.Holder());
+  return true;
+}
+
+// A transposed view is reduced on the contiguous tensor it permutes, instead
+// of a contiguous copy of it, as long as the kept dims are in the same order
+// in both, so that the outputs are of the same layout.
+template <typename T, typename Context>
+void SumStridedKernel(const Context& dev_ctx,
+                      const DenseTensor& x,
+                      const IntArray& dims,
+                      DataType out_dtype,
+                      bool keep_dim,
+                      DenseTensor* out) {
+  out->set_strides(DenseTensorMeta::calc_strides(out->dims()));
+  if (x.meta().is_contiguous()) {
+    phi::SumKernel<T, Context>(dev_ctx, x, dims, out_dtype, keep_dim, out);
+    return;
+  }
+
+  const int rank = x.dims().size();
+  std::vector<bool> reduced(rank, dims.size() == 0);
+  for (auto d : dims.GetData()) {
+    reduced[d < 0 ? d + rank : d] = true;
+  }
+  DenseTensor src;
+  std::vector<int> perm;
+  bool permuted = GetPermutedSource(x, &src, &perm);
+  for (int i = 0, last = -1; permuted && i < rank; ++i) {
+    if (!reduced[i] && x.dims()[i] != 1) {
+      permuted = perm[i] > last;
+      last = perm[i];
+    }
+  }
+  if (!permuted) {
+    DenseTensor contiguous_x;
+    PD_VISIT_ALL_TYPES(x.dtype(), "SumStridedKernel", ([&] {
+                         contiguous_x =
+                             phi::Contiguous<data_t, Context>(dev_ctx, x);
+                       }));
+    phi::SumKernel<T, Context>(
+        dev_ctx, contiguous_x, dims, out_dtype, keep_dim, out);
+    return;
+  }
+
+  std::vector<int64_t> src_axes;
+  for (int i = 0; i < rank; ++i) {
+    if (reduced[i]) {
+      src_axes.push_back(perm[i]);
+    }
+  }
+  std::sort(src_axes.begin(), src_axes.end());
+  DDim out_dims = out->dims();
+  DenseTensor src_out;
+  MetaTensor meta_src_out(&src_out);
+  SumInferMeta(src, IntArray(src_axes), out_dtype, keep_dim, &meta_src_out);
+  phi::SumKernel<T, Context>(
+      dev_ctx, src, IntArray(src_axes), out_dtype, keep_dim, &src_out);
+  out->ShareDataWith(src_out);
+  out->Resize(out_dims);
+  out->set_strides(DenseTensorMeta::calc_strides(out_dims));
+}
+
+}  // namespace phi
+
+#define PD_REGISTER_BINARY_STRIDED_KERNEL(name, func) \
+  PD_REGISTER_KERNEL(name,                            \
+                     GPU,                             \
+                     STRIDED,                         \
+                     func,                            \
+                     float,                           \
+                     double,                          \
+                     int,                             \
+                     int64_t,                         \
+                     phi::dtype::float16,             \
+                     phi::dtype::bfloat16) {}
+
+PD_REGISTER_BINARY_STRIDED_KERNEL(add, phi::AddStridedKernel)
+PD_REGISTER_BINARY_STRIDED_KERNEL(subtract, phi::SubtractStridedKernel)
+PD_REGISTER_BINARY_STRIDED_KERNEL(multiply, phi::MultiplyStridedKernel)
+PD_REGISTER_BINARY_STRIDED_KERNEL(divide, phi::DivideStridedKernel)
+
+PD_REGISTER_KERNEL(cast,
+                   GPU,
+                   STRIDED,
+                   phi::CastStridedKernel,
+                   float,
+                   double,
+                   int,
+                   int64_t,
+                   int16_t,
+                   bool,
+                   int8_t,
+                   uint8_t,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16,
+                   phi::dtype::complex<float>,
+                   phi::dtype::complex<double>) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::UNDEFINED);
+}
+
+PD_REGISTER_KERNEL(sum,
+                   GPU,
+                   STRIDED,
+                   phi::SumStridedKernel,
+                   bool,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16,
+                   int,
+                   int64_t) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::UNDEFINED);
+}
@@ -0,0 +1,302 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/w8a8_linear_kernel.h"
+
+#include <algorithm>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/core/kernel_registry.h"
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+#include "paddle/phi/kernels/funcs/aligned_vector.h"
+#include "paddle/phi/kernels/funcs/cublaslt.h"
+#include "paddle/phi/kernels/funcs/math_cuda_utils.h"
+#include "paddle/phi/kernels/fusion/gpu/fused_bias_act_utils.h"
+#endif
+
+namespace phi {
+
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+namespace {
+
+constexpr int kQuantBlockSize = 256;
+
+template <typename T>
+struct IdentityFunctor {
+  __device__ __forceinline__ T operator()(const T x) const { return x; }
+};
+
+// A block quantizes a token of x * smooth. The abs max of the token is
+// reduced first, and then the token, read again mostly from the L2 cache, is
+// quantized by x_scale = abs max / 127.
+template <typename T, int VecSize>
+__global__ void PerTokenQuantKernel(const T* x,
+                                    const T* smooth,
+                                    int64_t m,
+                                    int64_t k,
+                                    int8_t* quant_x,
+                                    float* x_scale) {
+  using Vec = phi::AlignedVector<T, VecSize>;
+  using QuantVec = phi::AlignedVector<int8_t, VecSize>;
+  for (int64_t row = blockIdx.x; row < m; row += gridDim.x) {
+    const T* x_row = x + row * k;
+    float local_max = 0.0f;
+    for (int64_t col = threadIdx.x * VecSize; col < k;
+         col += blockDim.x * VecSize) {
+      Vec in_vec, smooth_vec;
+      phi::Load<T, VecSize>(x_row + col, &in_vec);
+      if (smooth != nullptr) {
+        phi::Load<T, VecSize>(smooth + col, &smooth_vec);
+      }
+#pragma unroll
+      for (int i = 0; i < VecSize; ++i) {
+        float value = static_cast<float>(in_vec[i]);
+        if (smooth != nullptr) {
+          value *= static_cast<float>(smooth_vec[i]);
+        }
+        local_max = fmaxf(local_max, fabsf(value));
+      }
+    }
+    const float abs_max =
+        phi::funcs::BlockReduceMax<float>(local_max, FINAL_MASK);
+    const float inverse_scale = abs_max > 0.0f ? 127.0f / abs_max : 0.0f;
+    for (int64_t col = threadIdx.x * VecSize; col < k;
+         col += blockDim.x * VecSize) {
+      Vec in_vec, smooth_vec;
+      QuantVec out_vec;
+      phi::Load<T, VecSize>(x_row + col, &in_vec);
+      if (smooth != nullptr) {
+        phi::Load<T, VecSize>(smooth + col, &smooth_vec);
+      }
+#pragma unroll
+      for (int i = 0; i < VecSize; ++i) {
+        float value = static_cast<float>(in_vec[i]);
+        if (smooth != nullptr) {
+          value *= static_cast<float>(smooth_vec[i]);
+        }
+        out_vec[i] = static_cast<int8_t>(
+            lroundf(fmaxf(-127.0f, fminf(127.0f, value * inverse_scale))));
+      }
+      phi::Store<int8_t, VecSize>(out_vec, quant_x + row * k + col);
+    }
+    if (threadIdx.x == 0) {
+      x_scale[row] = abs_max / 127.0f;
+    }
+    // The shared memory of BlockReduceMax is written again by the next token.
+    __syncthreads();
+  }
+}
+
+// out = act(int_out * x_scale[row] * weight_scale[col] + bias[col]), the
+// epilogue of the int8 GEMM in one pass over its int32 output.
+template <typename T, typename ScaleT, typename Functor, int VecSize>
+__global__ void DequantBiasActKernel(const int32_t* int_out,
+                                     const float* x_scale,
+                                     const ScaleT* weight_scale,
+                                     const T* bias,
+                                     Functor act,
+                                     int64_t m,
+                                     int64_t n,
+                                     T* out) {
+  using IntVec = phi::AlignedVector<int32_t, VecSize>;
+  using Vec = phi::AlignedVector<T, VecSize>;
+  const int64_t numel = m * n;
+  for (int64_t idx =
+           (static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x) *
+           VecSize;
+       idx < numel;
+       idx += static_cast<int64_t>(gridDim.x) * blockDim.x * VecSize) {
+    const int64_t row = idx / n;
+    const int64_t col = idx - row * n;
+    IntVec in_vec;
+    Vec bias_vec, out_vec;
+    phi::Load<int32_t, VecSize>(int_out + idx, &in_vec);
+    if (bias != nullptr) {
+      phi::Load<T, VecSize>(bias + col, &bias_vec);
+    }
+    const float row_scale = x_scale[row];
+#pragma unroll
+    for (int i = 0; i < VecSize; ++i) {
+      float value = static_cast<float>(in_vec[i]) * row_scale *
+                    static_cast<float>(weight_scale[col + i]);
+      if (bias != nullptr) {
+        value += static_cast<float>(bias_vec[i]);
+      }
+      out_vec[i] = act(static_cast<T>(value));
+    }
+    phi::Store<T, VecSize>(out_vec, out + idx);
+  }
+}
+
+template <typename T, typename ScaleT, typename Functor>
+void LaunchDequantBiasAct(const GPUContext& dev_ctx,
+                          const int32_t* int_out,
+                          const float* x_scale,
+                          const ScaleT* weight_scale,
+                          const T* bias,
+                          Functor act,
+                          int64_t m,
+                          int64_t n,
+                          T* out) {
+  constexpr int VecSize = 16 / sizeof(T);
+  auto config =
+      phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, m * n / VecSize);
+  DequantBiasActKernel<T, ScaleT, Functor, VecSize>
+      <<<config.block_per_grid, config.thread_per_block, 0, dev_ctx.stream()>>>(
+          int_out, x_scale, weight_scale, bias, act, m, n, out);
+}
+
+template <typename T, typename ScaleT>
+void DequantBiasAct(const GPUContext& dev_ctx,
+                    const int32_t* int_out,
+                    const float* x_scale,
+                    const ScaleT* weight_scale,
+                    const T* bias,
+                    const std::string& act_method,
+                    int64_t m,
+                    int64_t n,
+                    T* out) {
+  if (act_method == "gelu") {
+    LaunchDequantBiasAct<T, ScaleT>(dev_ctx,
+                                    int_out,
+                                    x_scale,
+                                    weight_scale,
+                                    bias,
+                                    fusion::GeluFunctor<T>(),
+                                    m,
+                                    n,
+                                    out);
+  } else if (act_method == "relu") {
+    LaunchDequantBiasAct<T, ScaleT>(dev_ctx,
+                                    int_out,
+                                    x_scale,
+                                    weight_scale,
+                                    bias,
+                                    fusion::ReluFunctor<T>(),
+                                    m,
+                                    n,
+                                    out);
+  } else if (act_method == "swish") {
+    LaunchDequantBiasAct<T, ScaleT>(dev_ctx,
+                                    int_out,
+                                    x_scale,
+                                    weight_scale,
+                                    bias,
+                                    fusion::CudaSwishFunctor<T>(),
+                                    m,
+                                    n,
+                                    out);
+  } else {
+    LaunchDequantBiasAct<T, ScaleT>(dev_ctx,
+                                    int_out,
+                                    x_scale,
+                                    weight_scale,
+                                    bias,
+                                    IdentityFunctor<T>(),
+                                    m,
+                                    n,
+                                    out);
+  }
+}
+
+}  // namespace
+#endif
+
+template <typename T, typename Context>
+void W8A8LinearKernel(const Context& dev_ctx,
+                      const DenseTensor& x,
+                      const DenseTensor& weight,
+                      const paddle::optional<DenseTensor>& bias,
+                      const DenseTensor& weight_scale,
+                      const paddle::optional<DenseTensor>& smooth,
+                      const std::string& act_method,
+                      DenseTensor* out) {
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+  dev_ctx.template Alloc<T>(out);
+  const int k = weight.dims()[1];
+  const int n = weight.dims()[0];
+  const int m = x.numel() / k;
+  if (m == 0) {
+    return;
+  }
+
+  DenseTensor quant_x, x_scale, int_out;
+  quant_x.Resize({m, k});
+  x_scale.Resize({m});
+  int_out.Resize({m, n});
+  dev_ctx.template Alloc<int8_t>(&quant_x);
+  dev_ctx.template Alloc<float>(&x_scale);
+  dev_ctx.template Alloc<int32_t>(&int_out);
+
+  constexpr int VecSize = 16 / sizeof(T);
+  const int quant_grid =
+      std::min<int64_t>(m, dev_ctx.GetCUDAMaxGridDimSize()[0]);
+  PerTokenQuantKernel<T, VecSize>
+      <<<quant_grid, kQuantBlockSize, 0, dev_ctx.stream()>>>(
+          x.data<T>(),
+          smooth ? smooth->data<T>() : nullptr,
+          m,
+          k,
+          quant_x.data<int8_t>(),
+          x_scale.data<float>());
+
+  // mk * transpose(nk) = mn
+  CublasLtHelper helper(m, k, n, dev_ctx.cublaslt_handle());
+  helper.GEMM(quant_x.data<int8_t>(),
+              weight.data<int8_t>(),
+              int_out.data<int32_t>(),
+              dev_ctx.stream());
+
+  const T* bias_data = bias ? bias->data<T>() : nullptr;
+  if (weight_scale.dtype() == phi::DataType::FLOAT32) {
+    DequantBiasAct<T, float>(dev_ctx,
+                             int_out.data<int32_t>(),
+                             x_scale.data<float>(),
+                             weight_scale.data<float>(),
+                             bias_data,
+                             act_method,
+                             m,
+                             n,
+                             out->data<T>());
+  } else {
+    PADDLE_ENFORCE_EQ(weight_scale.dtype(),
+                      x.dtype(),
+                      phi::errors::InvalidArgument(
+                          "The weight_scale of w8a8_linear should be float32 "
+                          "or of the dtype of x, but got [%s].",
+                          weight_scale.dtype()));
+    DequantBiasAct<T, T>(dev_ctx,
+                         int_out.data<int32_t>(),
+                         x_scale.data<float>(),
+                         weight_scale.data<T>(),
+                         bias_data,
+                         act_method,
+                         m,
+                         n,
+                         out->data<T>());
+  }
+#else
+  PADDLE_THROW(phi::errors::Unimplemented(
+      "w8a8_linear op needs paddle with cuda and cuda version >= 11.2"));
+#endif
+}
+}  // namespace phi
+
+PD_REGISTER_KERNEL(w8a8_linear,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::W8A8LinearKernel,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
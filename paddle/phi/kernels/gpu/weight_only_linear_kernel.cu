@@ -55,8 +55,8 @@ void WeightOnlyLinearKernel(const Context& dev_ctx,
   int k = w_dims[1];
   int m = x.numel() / k;
 
-  // m > 3: run gemm.
-  if (m > 3 || (arch == 70)) {
+  // m > 16: run gemm, the split-k gemv is faster for the small m of decoding.
+  if (m > 16 || (arch == 70)) {
 /*
 Note(Zhengzekang):
 If using arch = 70, we always dispatch to weightonly Gemm,
@@ -162,7 +162,7 @@ we havenot support sm70 weightonly gemv, because sm70 weight layout is RowMajor.
     PADDLE_THROW(phi::errors::Unimplemented(
         "Please compile with cutlass to make cutlass available"));
 #endif
-  } else {  // m <= 3: gemv
+  } else {  // m <= 16: gemv
     if (weight_dtype == "int8") {
       WeightOnlyGemvWrapper<T, Context>(
           dev_ctx,
@@ -50,6 +50,12 @@ void ChooseAlgoByWorkspace(const std::vector<PerfT>& perf_results,
                            size_t workspace_limit,
                            SearchResult<AlgoT>* search_result) {
   int best_algo_idx = -1;
+  search_result->candidates.clear();
+  for (const auto& result : perf_results) {
+    if (result.status == CUDNN_STATUS_SUCCESS) {
+      search_result->candidates.emplace_back(result.algo, result.memory);
+    }
+  }
   for (size_t i = 0; i < perf_results.size(); ++i) {
     const auto& result = perf_results[i];
     if (result.status == CUDNN_STATUS_SUCCESS &&
@@ -233,6 +239,7 @@ struct SearchAlgorithmBase<ConvKind::kForward> {
         perf_results,
         returned_algo_count,
         workspace_size_limit);
+    perf_results.resize(returned_algo_count);
     ChooseAlgoByWorkspace<PerfT, AlgoT>(
         perf_results, workspace_size_limit, &result);
 
@@ -417,6 +424,7 @@ struct SearchAlgorithmBase<ConvKind::kBackwardData> {
         perf_results,
         returned_algo_count,
         workspace_size_limit);
+    perf_results.resize(returned_algo_count);
     ChooseAlgoByWorkspace<PerfT, AlgoT>(
         perf_results, workspace_size_limit, &result);
 
@@ -591,6 +599,7 @@ struct SearchAlgorithmBase<ConvKind::kBackwardFilter> {
           perf_results,
           returned_algo_count,
           workspace_size_limit);
+      perf_results.resize(returned_algo_count);
       ChooseAlgoByWorkspace<PerfT, AlgoT>(
           perf_results, workspace_size_limit, &result);
     } else {
@@ -696,6 +705,7 @@ struct SearchAlgorithm : public SearchAlgorithmBase<CK> {
         result.algo = static_cast<AlgoT>(t.algo);
         result.workspace_size = t.workspace_size;
         result.exhaustive_search = t.exhaustive_search;
+        FallbackByWorkspace(t, &result);
       }
       if (!result.exhaustive_search) {
         // In conv2d_transpose, enable_autotune is set to false because some
@@ -708,18 +718,10 @@ struct SearchAlgorithm : public SearchAlgorithmBase<CK> {
           result =
               SearchAlgorithmBase<CK>::template FindAlgoExhaustiveSearch<T>(
                   args, ctx);
-          cache.Set(key,
-                    phi::autotune::ConvAutoTuneResult(
-                        static_cast<int64_t>(result.algo),
-                        result.workspace_size,
-                        true));
+          cache.Set(key, ToConvAutoTuneResult(result, true));
         } else if (!find_in_cache) {
           result = SearchAlgorithmBase<CK>::FindAlgoHeuristic(args, ctx);
-          cache.Set(key,
-                    phi::autotune::ConvAutoTuneResult(
-                        static_cast<int64_t>(result.algo),
-                        result.workspace_size,
-                        false));
+          cache.Set(key, ToConvAutoTuneResult(result, false));
         }
       }
     }
@@ -18,6 +18,7 @@ limitations under the License. */
 #include <array>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "glog/logging.h"
@@ -77,8 +78,62 @@ struct SearchResult {
   float time = -1.f;
   size_t workspace_size = 0;
   bool exhaustive_search = false;
+  // The successful algorithms of the search with their workspace sizes, the
+  // fastest first.
+  std::vector<std::pair<AlgoT, size_t>> candidates;
 };
 
+// The algorithm cached by a search may need more workspace than the memory
+// free at run time, then the fastest candidate of the search fitting in it
+// runs instead. The cached algorithm is kept for the time the memory is
+// released. The workspace in the memory reserved by the allocator fits
+// without a query of the device.
+template <typename AlgoT>
+void FallbackByWorkspace(const phi::autotune::ConvAutoTuneResult& cached,
+                         SearchResult<AlgoT>* result) {
+  if (UseFixedWorkspace() || cached.candidates.empty()) {
+    return;
+  }
+  int device_id = phi::backends::gpu::GetCurrentDeviceId();
+  int64_t allocated =
+      memory_utils::DeviceMemoryStatCurrentValue("Allocated", device_id);
+  int64_t reserved =
+      memory_utils::DeviceMemoryStatCurrentValue("Reserved", device_id);
+  if (static_cast<int64_t>(result->workspace_size) <= reserved - allocated) {
+    return;
+  }
+  size_t workspace_limit = CalcWorkspaceLimitInBytes(false);
+  if (result->workspace_size <= workspace_limit) {
+    return;
+  }
+  for (const auto& candidate : cached.candidates) {
+    if (candidate.second <= workspace_limit) {
+      VLOG(3) << "Fall back to algo=" << candidate.first << " of workspace="
+              << ToMegaBytes(candidate.second) << " MB from algo="
+              << result->algo
+              << " of workspace=" << ToMegaBytes(result->workspace_size)
+              << " MB, the free memory is " << ToMegaBytes(workspace_limit)
+              << " MB.";
+      result->algo = static_cast<AlgoT>(candidate.first);
+      result->workspace_size = candidate.second;
+      return;
+    }
+  }
+}
+
+template <typename AlgoT>
+phi::autotune::ConvAutoTuneResult ToConvAutoTuneResult(
+    const SearchResult<AlgoT>& result, bool exhaustive_search) {
+  phi::autotune::ConvAutoTuneResult cached(static_cast<int64_t>(result.algo),
+                                           result.workspace_size,
+                                           exhaustive_search);
+  for (const auto& candidate : result.candidates) {
+    cached.candidates.emplace_back(static_cast<int64_t>(candidate.first),
+                                   candidate.second);
+  }
+  return cached;
+}
+
 template <typename T>
 static std::ostream& operator<<(std::ostream& out, const std::vector<T>& v) {
   out << "[";
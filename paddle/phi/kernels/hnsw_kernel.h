@@ -0,0 +1,64 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+
+// The tensors of an HNSW graph are described in funcs/hnsw.h.
+
+// Builds the graph over the rows of x, with m neighbors a node at the upper
+// levels and 2m at the level 0.
+template <typename T, typename Context>
+void HnswBuildKernel(const Context& dev_ctx,
+                     const DenseTensor& x,
+                     int m,
+                     int ef_construction,
+                     int seed,
+                     DenseTensor* neighbors,
+                     DenseTensor* offsets,
+                     DenseTensor* meta);
+
+// Inserts the rows of x after the nodes of the graph, x holds the rows of the
+// graph followed by the new rows.
+template <typename T, typename Context>
+void HnswAddKernel(const Context& dev_ctx,
+                   const DenseTensor& x,
+                   const DenseTensor& neighbors,
+                   const DenseTensor& offsets,
+                   const DenseTensor& meta,
+                   int ef_construction,
+                   int seed,
+                   DenseTensor* neighbors_out,
+                   DenseTensor* offsets_out,
+                   DenseTensor* meta_out);
+
+// The k nearest rows of x to each query, with the distances in the ascending
+// order. The missing results are padded by the distance inf and the id -1.
+template <typename T, typename Context>
+void HnswSearchKernel(const Context& dev_ctx,
+                      const DenseTensor& query,
+                      const DenseTensor& x,
+                      const DenseTensor& neighbors,
+                      const DenseTensor& offsets,
+                      const DenseTensor& meta,
+                      int k,
+                      int ef_search,
+                      DenseTensor* distances,
+                      DenseTensor* indices);
+
+}  // namespace phi
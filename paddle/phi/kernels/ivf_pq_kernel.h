@@ -0,0 +1,69 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+
+// The tensors of an IVF-PQ index are described in funcs/ivf_pq.h.
+
+// Trains the nlist coarse centroids and the m codebooks of ksub codewords on
+// x [n, d], and adds x to the index with the ids [0, n).
+template <typename T, typename Context>
+void IvfPqBuildKernel(const Context& dev_ctx,
+                      const DenseTensor& x,
+                      int nlist,
+                      int m,
+                      int ksub,
+                      int iters,
+                      int seed,
+                      DenseTensor* centroids,
+                      DenseTensor* codebooks,
+                      DenseTensor* codes,
+                      DenseTensor* list_offsets,
+                      DenseTensor* ids);
+
+// Adds x to the index with the ids following the ids of the index.
+template <typename T, typename Context>
+void IvfPqAddKernel(const Context& dev_ctx,
+                    const DenseTensor& x,
+                    const DenseTensor& centroids,
+                    const DenseTensor& codebooks,
+                    const DenseTensor& codes,
+                    const DenseTensor& list_offsets,
+                    const DenseTensor& ids,
+                    DenseTensor* codes_out,
+                    DenseTensor* list_offsets_out,
+                    DenseTensor* ids_out);
+
+// The k nearest codes of each query in its nprobe nearest lists, with the
+// distances in the ascending order. The missing results are padded by the
+// distance inf and the id -1.
+template <typename T, typename Context>
+void IvfPqSearchKernel(const Context& dev_ctx,
+                       const DenseTensor& query,
+                       const DenseTensor& centroids,
+                       const DenseTensor& codebooks,
+                       const DenseTensor& codes,
+                       const DenseTensor& list_offsets,
+                       const DenseTensor& ids,
+                       int k,
+                       int nprobe,
+                       DenseTensor* distances,
+                       DenseTensor* indices);
+
+}  // namespace phi
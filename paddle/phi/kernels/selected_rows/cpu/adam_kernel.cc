@@ -117,9 +117,21 @@ void AdamDenseParamSparseGradKernel(
     }
   }
 
+  bool use_multithread = false;
+#ifndef _WIN32
+  use_multithread = !lazy_mode && FLAGS_inner_op_parallelism > 1 &&
+                    min_row_size_to_use_multithread > 0 &&
+                    param.dims()[0] > min_row_size_to_use_multithread;
+#endif
+  // The unsorted grad is merged by the update itself, which sums the grad
+  // rows of each sorted segment on the fly. Only the multi thread update
+  // runs on the merged grad.
+  bool fuse_merge = !is_strict_sorted && !use_multithread;
+
   phi::SelectedRows tmp_grad_merge;
   const phi::SelectedRows* grad_merge_ptr = nullptr;
-  if (is_strict_sorted) {
+  funcs::RowSegments segments;
+  if (is_strict_sorted || fuse_merge) {
     grad_merge_ptr = &grad;
   } else {
     // merge duplicated rows if any.
@@ -128,14 +140,23 @@ void AdamDenseParamSparseGradKernel(
     merge_func(dev_ctx, grad, &tmp_grad_merge, true);
     grad_merge_ptr = &tmp_grad_merge;
   }
+  if (fuse_merge) {
+    funcs::BuildRowSegments(
+        cpu_rows.data(), static_cast<int64_t>(cpu_rows.size()), &segments);
+  }
 
   auto& grad_merge = *grad_merge_ptr;
   auto& grad_tensor = grad_merge.value();
   const T* grad_data = grad_tensor.template data<T>();
   auto* grad_merge_rows = &grad_merge.rows();
   phi::MixVector<int64_t> mixv_grad_merge_rows(grad_merge_rows);
-  const int64_t* rows = mixv_grad_merge_rows.Data(dev_ctx.GetPlace());
+  const int64_t* rows = fuse_merge
+                            ? segments.rows.data()
+                            : mixv_grad_merge_rows.Data(dev_ctx.GetPlace());
   auto row_numel = grad_tensor.numel() / grad_merge.rows().size();
+  int64_t row_count = fuse_merge
+                          ? static_cast<int64_t>(segments.size())
+                          : static_cast<int64_t>(grad_merge.rows().size());
 
   funcs::SparseAdamFunctor<T, funcs::CPUAdam> functor(
       beta1_,
@@ -153,7 +174,7 @@ void AdamDenseParamSparseGradKernel(
       dev_ctx.template Alloc<T>(param_out),
       rows,
       row_numel,
-      grad_merge.rows().size(),
+      row_count,
       lazy_mode);
   // update beta1 and beta2
   if (!use_global_beta_pow) {
@@ -162,7 +183,10 @@ void AdamDenseParamSparseGradKernel(
     dev_ctx.template Alloc<T>(beta2_pow_out)[0] =
         beta2_ * beta2_pow.data<T>()[0];
   }
-  if (lazy_mode) {
+  if (fuse_merge) {
+    VLOG(3) << "run cpu merge and update of " << segments.size() << " rows";
+    functor(param.numel(), segments, lazy_mode);
+  } else if (lazy_mode) {
     VLOG(3) << "run cpu lazy mode";
     size_t row_count = grad_merge.rows().size();
     std::vector<int64_t> cpu_rows(grad_merge.rows());
@@ -174,9 +198,7 @@ void AdamDenseParamSparseGradKernel(
     }
   }
 #ifndef _WIN32
-  else if (FLAGS_inner_op_parallelism > 1 &&  // NOLINT
-           min_row_size_to_use_multithread > 0 &&
-           param.dims()[0] > min_row_size_to_use_multithread) {
+  else if (use_multithread) {  // NOLINT
     VLOG(3) << "use multi thread, inner_op_parallelism="
             << FLAGS_inner_op_parallelism << " min_row_size_to_use_multithread="
             << min_row_size_to_use_multithread;
@@ -132,20 +132,34 @@ void Conv3dCooGPUKernel(const GPUContext& dev_ctx,
             << key;
   }
 
+  // The subm convs without a key reuse the rulebook of the same indices and
+  // geometry, built by the first of them.
+  const std::string rulebook_key =
+      subm && key.empty() && x.nnz() > 0
+          ? phi::funcs::sparse::AutoRulebookKey(x, kernel_sizes, dilations)
+          : key;
   int rulebook_len = 0;
   const IntT* rulebook_ptr = nullptr;
   bool need_product_rulebook = true;
-  if (subm && !key.empty()) {
+  if (subm && !rulebook_key.empty()) {
     rulebook_ptr = phi::funcs::sparse::PrepareSubm<T, IntT, GPUContext>(
         dev_ctx,
         x,
-        key,
+        rulebook_key,
         out_dims,
         out,
         h_counter.data<int>(),
         h_offsets.data<int>(),
         &rulebook_len,
         &need_product_rulebook);
+    if (!need_product_rulebook && key.empty()) {
+      const auto* indices_pairs = x.IndicesPairs(rulebook_key);
+      phi::funcs::sparse::OutputRulebook(dev_ctx,
+                                         indices_pairs->first,
+                                         indices_pairs->second,
+                                         rulebook,
+                                         counter);
+    }
   }
 
   if (need_product_rulebook) {
@@ -168,8 +182,14 @@ void Conv3dCooGPUKernel(const GPUContext& dev_ctx,
                                                         h_offsets_ptr);
     rulebook_ptr = tmp_rulebook.data<IntT>();
 
-    phi::funcs::sparse::SaveToTable(
-        dev_ctx, x, key, tmp_rulebook, h_counter, out, rulebook, counter);
+    phi::funcs::sparse::SaveToTable(dev_ctx,
+                                    x,
+                                    rulebook_key,
+                                    tmp_rulebook,
+                                    h_counter,
+                                    out,
+                                    rulebook,
+                                    counter);
   }
 
 #if defined(PADDLE_WITH_CUTLASS) && SPCONV_WITH_CUTLASS
@@ -0,0 +1,37 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+
+// The rejection sampling of speculative decoding. Every draft token is
+// accepted with the probability min(1, p(token) / q(token)) of the target
+// probs p and the draft probs q, until the first rejected one, which is
+// replaced by a token of the residual distribution max(0, p - q). When all
+// the draft tokens are accepted, a bonus token is sampled from the last
+// target probs. The accepted tokens and the sampled one are distributed as
+// the target model samples them.
+template <typename T, typename Context>
+void SpeculativeSamplingKernel(const Context& dev_ctx,
+                               const DenseTensor& draft_tokens,
+                               const DenseTensor& draft_probs,
+                               const DenseTensor& target_probs,
+                               int seed,
+                               DenseTensor* accept_tokens,
+                               DenseTensor* accept_num);
+
+}  // namespace phi
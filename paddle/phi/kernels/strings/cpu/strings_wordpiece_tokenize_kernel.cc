@@ -0,0 +1,80 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/strings/strings_wordpiece_tokenize_kernel.h"
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/strings/wordpiece_trie.h"
+
+namespace phi {
+namespace strings {
+
+template <typename ContextT>
+void StringsWordPieceTokenizeKernel(const ContextT& dev_ctx,
+                                    const StringTensor& x,
+                                    const StringTensor& vocab,
+                                    bool do_lower_case,
+                                    int max_seq_len,
+                                    int max_chars_per_word,
+                                    int64_t unk_token_id,
+                                    int64_t pad_token_id,
+                                    int64_t cls_token_id,
+                                    int64_t sep_token_id,
+                                    DenseTensor* ids,
+                                    DenseTensor* seq_lens) {
+  PADDLE_ENFORCE_GT(
+      max_seq_len,
+      0,
+      phi::errors::InvalidArgument(
+          "The max_seq_len of strings_wordpiece_tokenize should be positive, "
+          "but got %d.",
+          max_seq_len));
+  const int64_t num = x.numel();
+  ids->Resize({num, max_seq_len});
+  seq_lens->Resize({num});
+  int64_t* ids_data = dev_ctx.template Alloc<int64_t>(ids);
+  int64_t* seq_lens_data = dev_ctx.template Alloc<int64_t>(seq_lens);
+
+  auto trie = GetWordPieceTrie(vocab, WordPieceVocabHash(vocab));
+  const WordPieceTrieView view = trie->View();
+  const WordPieceOptions options = {do_lower_case,
+                                    max_seq_len,
+                                    max_chars_per_word,
+                                    unk_token_id,
+                                    pad_token_id,
+                                    cls_token_id,
+                                    sep_token_id};
+  const dtype::pstring* texts = x.data();
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t i = 0; i < num; ++i) {
+    seq_lens_data[i] = EncodeWordPiece(texts[i].data(),
+                                       texts[i].size(),
+                                       view,
+                                       options,
+                                       ids_data + i * max_seq_len);
+  }
+}
+
+}  // namespace strings
+}  // namespace phi
+
+PD_REGISTER_KERNEL_FOR_ALL_DTYPE(
+    strings_wordpiece_tokenize,
+    CPU,
+    ALL_LAYOUT,
+    phi::strings::StringsWordPieceTokenizeKernel<phi::CPUContext>) {}
@@ -0,0 +1,169 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/strings/strings_wordpiece_tokenize_kernel.h"
+
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/strings/wordpiece_trie.h"
+
+using pstring = ::phi::dtype::pstring;
+
+namespace phi {
+namespace strings {
+
+// The copy of a trie on a device, which lives as long as it is cached.
+struct DeviceWordPieceTrie {
+  Allocator::AllocationPtr child_begin;
+  Allocator::AllocationPtr child_bytes;
+  Allocator::AllocationPtr child_nodes;
+  Allocator::AllocationPtr token_ids;
+  WordPieceTrieView view;
+};
+
+template <typename T>
+static Allocator::AllocationPtr CopyToDevice(const phi::Place& place,
+                                             const std::vector<T>& host) {
+  auto allocation = memory_utils::Alloc(place, host.size() * sizeof(T));
+  if (!host.empty()) {
+    memory_utils::Copy(place,
+                       allocation->ptr(),
+                       phi::CPUPlace(),
+                       host.data(),
+                       host.size() * sizeof(T));
+  }
+  return allocation;
+}
+
+static std::shared_ptr<const DeviceWordPieceTrie> GetDeviceWordPieceTrie(
+    const phi::GPUContext& dev_ctx, const StringTensor& vocab) {
+  using Key = std::pair<uint64_t, int>;
+  // Never destroyed, the device memory may not be freed at exit.
+  static auto* tries =
+      new std::map<Key, std::shared_ptr<const DeviceWordPieceTrie>>();
+  static std::mutex mutex;
+
+  const phi::Place& place = dev_ctx.GetPlace();
+  const uint64_t hash = WordPieceVocabHash(vocab);
+  const Key key(hash, place.GetDeviceId());
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = tries->find(key);
+    if (it != tries->end()) return it->second;
+  }
+
+  auto host = GetWordPieceTrie(vocab, hash);
+  auto trie = std::make_shared<DeviceWordPieceTrie>();
+  trie->child_begin = CopyToDevice(place, host->child_begin());
+  trie->child_bytes = CopyToDevice(place, host->child_bytes());
+  trie->child_nodes = CopyToDevice(place, host->child_nodes());
+  trie->token_ids = CopyToDevice(place, host->token_ids());
+  trie->view = {static_cast<const int32_t*>(trie->child_begin->ptr()),
+                static_cast<const uint8_t*>(trie->child_bytes->ptr()),
+                static_cast<const int32_t*>(trie->child_nodes->ptr()),
+                static_cast<const int64_t*>(trie->token_ids->ptr()),
+                host->continuation_root()};
+
+  std::lock_guard<std::mutex> guard(mutex);
+  if (tries->size() >= 8) {
+    // The evicted tries may still be read by the kernels in flight.
+    dev_ctx.Wait();
+    tries->clear();
+  }
+  return tries->emplace(key, std::move(trie)).first->second;
+}
+
+// A thread tokenizes a string, the strings of a batch are of similar
+// lengths in practice.
+__global__ void StringsWordPieceTokenizeCUDAKernel(const pstring* texts,
+                                                   int64_t num,
+                                                   WordPieceTrieView trie,
+                                                   WordPieceOptions options,
+                                                   int64_t* ids,
+                                                   int64_t* seq_lens) {
+  CUDA_KERNEL_LOOP_TYPE(i, num, int64_t) {
+    seq_lens[i] = EncodeWordPiece(texts[i].data(),
+                                  texts[i].size(),
+                                  trie,
+                                  options,
+                                  ids + i * options.max_seq_len);
+  }
+}
+
+template <typename ContextT>
+void StringsWordPieceTokenizeKernel(const ContextT& dev_ctx,
+                                    const StringTensor& x,
+                                    const StringTensor& vocab,
+                                    bool do_lower_case,
+                                    int max_seq_len,
+                                    int max_chars_per_word,
+                                    int64_t unk_token_id,
+                                    int64_t pad_token_id,
+                                    int64_t cls_token_id,
+                                    int64_t sep_token_id,
+                                    DenseTensor* ids,
+                                    DenseTensor* seq_lens) {
+  PADDLE_ENFORCE_GT(
+      max_seq_len,
+      0,
+      phi::errors::InvalidArgument(
+          "The max_seq_len of strings_wordpiece_tokenize should be positive, "
+          "but got %d.",
+          max_seq_len));
+  PADDLE_ENFORCE_EQ(
+      vocab.place().GetType() == phi::AllocationType::CPU,
+      true,
+      phi::errors::InvalidArgument(
+          "The vocab of strings_wordpiece_tokenize should be on CPU."));
+  const int64_t num = x.numel();
+  ids->Resize({num, max_seq_len});
+  seq_lens->Resize({num});
+  int64_t* ids_data = dev_ctx.template Alloc<int64_t>(ids);
+  int64_t* seq_lens_data = dev_ctx.template Alloc<int64_t>(seq_lens);
+  if (num == 0) return;
+
+  auto trie = GetDeviceWordPieceTrie(dev_ctx, vocab);
+  const WordPieceOptions options = {do_lower_case,
+                                    max_seq_len,
+                                    max_chars_per_word,
+                                    unk_token_id,
+                                    pad_token_id,
+                                    cls_token_id,
+                                    sep_token_id};
+  auto config = phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, num);
+  StringsWordPieceTokenizeCUDAKernel<<<config.block_per_grid,
+                                       config.thread_per_block,
+                                       0,
+                                       dev_ctx.stream()>>>(
+      x.data(), num, trie->view, options, ids_data, seq_lens_data);
+}
+
+}  // namespace strings
+}  // namespace phi
+
+PD_REGISTER_KERNEL_FOR_ALL_DTYPE(
+    strings_wordpiece_tokenize,
+    GPU,
+    ALL_LAYOUT,
+    phi::strings::StringsWordPieceTokenizeKernel<phi::GPUContext>) {
+  kernel->InputAt(1).SetBackend(phi::Backend::CPU);
+}
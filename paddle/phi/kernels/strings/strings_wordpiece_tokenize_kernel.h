@@ -0,0 +1,47 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/string_tensor.h"
+
+namespace phi {
+namespace strings {
+
+// Tokenizes each string of x as BERT does: splits it by the whitespaces, the
+// punctuations and the CJK ideographs, and then splits each word into the
+// greedy longest WordPiece tokens of the vocab, whose ids are the indices in
+// the vocab. ids are [x.numel(), max_seq_len], truncated and padded by
+// pad_token_id, and seq_lens are the lengths without the paddings. The cls
+// and sep tokens wrap each sequence if the ids are not negative.
+//
+// do_lower_case only lowers ASCII, strings_lower with utf8 lowers the rest.
+// The vocab is on CPU, and its trie is cached on the device of the kernel.
+template <typename ContextT>
+void StringsWordPieceTokenizeKernel(const ContextT& dev_ctx,
+                                    const StringTensor& x,
+                                    const StringTensor& vocab,
+                                    bool do_lower_case,
+                                    int max_seq_len,
+                                    int max_chars_per_word,
+                                    int64_t unk_token_id,
+                                    int64_t pad_token_id,
+                                    int64_t cls_token_id,
+                                    int64_t sep_token_id,
+                                    DenseTensor* ids,
+                                    DenseTensor* seq_lens);
+
+}  // namespace strings
+}  // namespace phi
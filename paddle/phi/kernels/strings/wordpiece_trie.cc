@@ -0,0 +1,108 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/strings/wordpiece_trie.h"
+
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#include "paddle/phi/core/enforce.h"
+
+namespace phi {
+namespace strings {
+
+// The tries of the recent vocabs, a serving process rarely uses more.
+static constexpr size_t kMaxCachedWordPieceTries = 8;
+
+WordPieceTrie::WordPieceTrie(const dtype::pstring* vocab, int64_t size) {
+  // Builds the trie by the maps of the children first, and then lays the
+  // children of each node out contiguously.
+  std::vector<std::map<uint8_t, int32_t>> children(1);
+  token_ids_.assign(1, -1);
+  for (int64_t id = 0; id < size; ++id) {
+    int32_t node = 0;
+    for (char c : vocab[id]) {
+      auto& edges = children[node];
+      auto it = edges.find(static_cast<uint8_t>(c));
+      if (it == edges.end()) {
+        it = edges.emplace(static_cast<uint8_t>(c), children.size()).first;
+        children.emplace_back();
+        token_ids_.push_back(-1);
+      }
+      node = it->second;
+    }
+    // The first one of the duplicated tokens wins.
+    if (node != 0 && token_ids_[node] < 0) token_ids_[node] = id;
+  }
+
+  child_begin_.reserve(children.size() + 1);
+  child_bytes_.reserve(children.size() - 1);
+  child_nodes_.reserve(children.size() - 1);
+  for (const auto& edges : children) {
+    child_begin_.push_back(static_cast<int32_t>(child_bytes_.size()));
+    for (const auto& edge : edges) {
+      child_bytes_.push_back(edge.first);
+      child_nodes_.push_back(edge.second);
+    }
+  }
+  child_begin_.push_back(static_cast<int32_t>(child_bytes_.size()));
+
+  WordPieceTrieView view = View();
+  continuation_root_ = view.Next(0, '#');
+  if (continuation_root_ >= 0) {
+    continuation_root_ = view.Next(continuation_root_, '#');
+  }
+}
+
+WordPieceTrieView WordPieceTrie::View() const {
+  return {child_begin_.data(),
+          child_bytes_.data(),
+          child_nodes_.data(),
+          token_ids_.data(),
+          continuation_root_};
+}
+
+uint64_t WordPieceVocabHash(const StringTensor& vocab) {
+  // FNV-1a over the tokens and their lengths.
+  uint64_t hash = 1469598103934665603ULL;
+  auto mix = [&hash](uint64_t value) {
+    hash ^= value;
+    hash *= 1099511628211ULL;
+  };
+  const dtype::pstring* tokens = vocab.data();
+  for (int64_t i = 0; i < vocab.numel(); ++i) {
+    mix(tokens[i].size());
+    for (char c : tokens[i]) mix(static_cast<uint8_t>(c));
+  }
+  return hash;
+}
+
+std::shared_ptr<const WordPieceTrie> GetWordPieceTrie(
+    const StringTensor& vocab, uint64_t hash) {
+  static std::mutex mutex;
+  static std::unordered_map<uint64_t, std::shared_ptr<const WordPieceTrie>>
+      tries;
+  std::lock_guard<std::mutex> guard(mutex);
+  auto it = tries.find(hash);
+  if (it != tries.end()) return it->second;
+  if (tries.size() >= kMaxCachedWordPieceTries) tries.clear();
+  auto trie =
+      std::make_shared<const WordPieceTrie>(vocab.data(), vocab.numel());
+  tries.emplace(hash, trie);
+  return trie;
+}
+
+}  // namespace strings
+}  // namespace phi
@@ -0,0 +1,59 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "paddle/phi/common/pstring.h"
+#include "paddle/phi/core/string_tensor.h"
+#include "paddle/phi/kernels/strings/wordpiece_utils.h"
+
+namespace phi {
+namespace strings {
+
+// The byte trie of a WordPiece vocab on the host, the id of a token is its
+// index in the vocab.
+class WordPieceTrie {
+ public:
+  WordPieceTrie(const dtype::pstring* vocab, int64_t size);
+
+  WordPieceTrieView View() const;
+
+  const std::vector<int32_t>& child_begin() const { return child_begin_; }
+  const std::vector<uint8_t>& child_bytes() const { return child_bytes_; }
+  const std::vector<int32_t>& child_nodes() const { return child_nodes_; }
+  const std::vector<int64_t>& token_ids() const { return token_ids_; }
+  int32_t continuation_root() const { return continuation_root_; }
+
+ private:
+  std::vector<int32_t> child_begin_;
+  std::vector<uint8_t> child_bytes_;
+  std::vector<int32_t> child_nodes_;
+  std::vector<int64_t> token_ids_;
+  int32_t continuation_root_{-1};
+};
+
+// The fingerprint of the tokens of a vocab, by which its tries are cached.
+uint64_t WordPieceVocabHash(const StringTensor& vocab);
+
+// Returns the trie of the vocab, which is on the host, built once for the
+// same tokens.
+std::shared_ptr<const WordPieceTrie> GetWordPieceTrie(
+    const StringTensor& vocab, uint64_t hash);
+
+}  // namespace strings
+}  // namespace phi
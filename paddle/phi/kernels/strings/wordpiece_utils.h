@@ -0,0 +1,230 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "paddle/common/hostdevice.h"
+
+namespace phi {
+namespace strings {
+
+// The vocab of WordPiece as a byte trie in the CSR layout, so that it is
+// walked by the same code on the host and on the device. The children of a
+// node are sorted by their bytes.
+struct WordPieceTrieView {
+  const int32_t* child_begin;  // [num_nodes + 1]
+  const uint8_t* child_bytes;  // [num_edges]
+  const int32_t* child_nodes;  // [num_edges]
+  const int64_t* token_ids;    // [num_nodes], -1 if no token ends there
+  // The node of "##", where the pieces after the first one of a word start,
+  // -1 if the vocab has no such pieces.
+  int32_t continuation_root;
+
+  HOSTDEVICE inline int32_t Next(int32_t node, uint8_t byte) const {
+    int32_t lo = child_begin[node];
+    int32_t hi = child_begin[node + 1];
+    while (lo < hi) {
+      int32_t mid = lo + (hi - lo) / 2;
+      if (child_bytes[mid] < byte) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo < child_begin[node + 1] && child_bytes[lo] == byte
+               ? child_nodes[lo]
+               : -1;
+  }
+};
+
+struct WordPieceOptions {
+  bool do_lower_case;
+  int max_seq_len;
+  int max_chars_per_word;
+  int64_t unk_token_id;
+  int64_t pad_token_id;
+  // Prepended and appended to each sequence if not negative.
+  int64_t cls_token_id;
+  int64_t sep_token_id;
+};
+
+enum WordPieceCharKind {
+  kWordPieceSpace = 0,
+  kWordPieceControl = 1,
+  // Punctuations and CJK ideographs, each of which is a word.
+  kWordPieceSingle = 2,
+  kWordPieceWord = 3,
+};
+
+// Decodes a code point of UTF-8, an invalid byte is decoded as itself.
+HOSTDEVICE inline int DecodeUTF8(const char* text,
+                                 int64_t size,
+                                 uint32_t* code_point) {
+  const uint8_t lead = static_cast<uint8_t>(text[0]);
+  int len = lead < 0x80 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+  if (lead >= 0x80 && lead < 0xC0) len = 1;
+  if (len > size) len = 1;
+  if (len == 1) {
+    *code_point = lead;
+    return 1;
+  }
+  uint32_t cp = lead & (0x7F >> len);
+  for (int i = 1; i < len; ++i) {
+    cp = (cp << 6) | (static_cast<uint8_t>(text[i]) & 0x3F);
+  }
+  *code_point = cp;
+  return len;
+}
+
+// The classes of BERT's basic tokenizer, by the ranges of the code points.
+HOSTDEVICE inline WordPieceCharKind ClassifyWordPieceChar(uint32_t cp) {
+  if (cp == ' ' || cp == '\t' || cp == '\n' || cp == '\r' || cp == 0xA0 ||
+      cp == 0x1680 || (cp >= 0x2000 && cp <= 0x200A) || cp == 0x202F ||
+      cp == 0x205F || cp == 0x3000) {
+    return kWordPieceSpace;
+  }
+  if (cp == 0 || cp == 0xFFFD || cp < 0x20 || (cp >= 0x7F && cp < 0xA0)) {
+    return kWordPieceControl;
+  }
+  if ((cp >= 33 && cp <= 47) || (cp >= 58 && cp <= 64) ||
+      (cp >= 91 && cp <= 96) || (cp >= 123 && cp <= 126) ||
+      (cp >= 0x2010 && cp <= 0x206F) || (cp >= 0x3001 && cp <= 0x303F) ||
+      (cp >= 0xFF01 && cp <= 0xFF0F)) {
+    return kWordPieceSingle;
+  }
+  if ((cp >= 0x4E00 && cp <= 0x9FFF) || (cp >= 0x3400 && cp <= 0x4DBF) ||
+      (cp >= 0x20000 && cp <= 0x2A6DF) || (cp >= 0x2A700 && cp <= 0x2B81F) ||
+      (cp >= 0x2B820 && cp <= 0x2CEAF) || (cp >= 0xF900 && cp <= 0xFAFF) ||
+      (cp >= 0x2F800 && cp <= 0x2FA1F)) {
+    return kWordPieceSingle;
+  }
+  return kWordPieceWord;
+}
+
+HOSTDEVICE inline uint8_t WordPieceByte(char c, bool do_lower_case) {
+  uint8_t byte = static_cast<uint8_t>(c);
+  return do_lower_case && byte >= 'A' && byte <= 'Z' ? byte + ('a' - 'A')
+                                                     : byte;
+}
+
+// Appends the greedy longest match pieces of a word to ids[n, limit), or the
+// unk token if the word can not be split by the vocab. Returns the new n.
+HOSTDEVICE inline int64_t EncodeWordPieceWord(const char* word,
+                                              int64_t bytes,
+                                              int64_t chars,
+                                              const WordPieceTrieView& trie,
+                                              const WordPieceOptions& options,
+                                              int64_t n,
+                                              int64_t limit,
+                                              int64_t* ids) {
+  if (n >= limit) return n;
+  if (chars > options.max_chars_per_word) {
+    ids[n++] = options.unk_token_id;
+    return n;
+  }
+  const int64_t first = n;
+  int64_t start = 0;
+  while (start < bytes) {
+    int32_t node = start == 0 ? 0 : trie.continuation_root;
+    int64_t match_id = -1;
+    int64_t match_end = start;
+    for (int64_t i = start; i < bytes && node >= 0; ++i) {
+      node = trie.Next(node, WordPieceByte(word[i], options.do_lower_case));
+      if (node >= 0 && trie.token_ids[node] >= 0) {
+        match_id = trie.token_ids[node];
+        match_end = i + 1;
+      }
+    }
+    if (match_id < 0) {
+      ids[first] = options.unk_token_id;
+      return first + 1;
+    }
+    // Truncates the sequence in the middle of the word.
+    if (n >= limit) return n;
+    ids[n++] = match_id;
+    start = match_end;
+  }
+  return n;
+}
+
+// Splits the text by the whitespaces, the punctuations and the CJK
+// ideographs, and encodes the words by WordPiece into
+// ids[0, max_seq_len), padded by the pad token. Returns the length of the
+// sequence without the paddings.
+HOSTDEVICE inline int64_t EncodeWordPiece(const char* text,
+                                          int64_t size,
+                                          const WordPieceTrieView& trie,
+                                          const WordPieceOptions& options,
+                                          int64_t* ids) {
+  const int64_t max_seq_len = options.max_seq_len;
+  const int64_t limit = max_seq_len - (options.sep_token_id >= 0 ? 1 : 0);
+  int64_t n = 0;
+  if (options.cls_token_id >= 0 && n < limit) ids[n++] = options.cls_token_id;
+
+  int64_t word_begin = -1;
+  int64_t word_chars = 0;
+  int64_t pos = 0;
+  while (pos < size && n < limit) {
+    uint32_t cp;
+    int len = DecodeUTF8(text + pos, size - pos, &cp);
+    WordPieceCharKind kind = ClassifyWordPieceChar(cp);
+    if (kind == kWordPieceWord) {
+      if (word_begin < 0) {
+        word_begin = pos;
+        word_chars = 0;
+      }
+      ++word_chars;
+      pos += len;
+      continue;
+    }
+    if (word_begin >= 0) {
+      n = EncodeWordPieceWord(text + word_begin,
+                              pos - word_begin,
+                              word_chars,
+                              trie,
+                              options,
+                              n,
+                              limit,
+                              ids);
+      word_begin = -1;
+    }
+    if (kind == kWordPieceSingle) {
+      n = EncodeWordPieceWord(
+          text + pos, len, 1, trie, options, n, limit, ids);
+    }
+    pos += len;
+  }
+  if (word_begin >= 0) {
+    n = EncodeWordPieceWord(text + word_begin,
+                            pos - word_begin,
+                            word_chars,
+                            trie,
+                            options,
+                            n,
+                            limit,
+                            ids);
+  }
+  if (options.sep_token_id >= 0 && n < max_seq_len) {
+    ids[n++] = options.sep_token_id;
+  }
+  for (int64_t i = n; i < max_seq_len; ++i) {
+    ids[i] = options.pad_token_id;
+  }
+  return n;
+}
+
+}  // namespace strings
+}  // namespace phi
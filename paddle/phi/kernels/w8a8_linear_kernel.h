@@ -0,0 +1,34 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+
+// out = act(dequant(quant(x * smooth) * weight^T) + bias), where x is
+// quantized to int8 per token by its dynamic abs max, and weight is the int8
+// [n, k] of the per channel weight_scale, as quantized by the llm.int8 algo
+// of weight_quantize.
+template <typename T, typename Context>
+void W8A8LinearKernel(const Context& dev_ctx,
+                      const DenseTensor& x,
+                      const DenseTensor& weight,
+                      const paddle::optional<DenseTensor>& bias,
+                      const DenseTensor& weight_scale,
+                      const paddle::optional<DenseTensor>& smooth,
+                      const std::string& act_method,
+                      DenseTensor* out);
+}  // namespace phi
@@ -55,6 +55,16 @@ using InsertionPoint = std::pair<Block *, Block::Iterator>;
 ///
 class Builder {
  public:
+  ///
+  /// \brief The listener is notified of the operations inserted by the
+  /// builder, such as the rewriters tracking the changes of the IR.
+  ///
+  class Listener {
+   public:
+    virtual ~Listener() = default;
+    virtual void NotifyOperationInserted(Operation *op) = 0;
+  };
+
   Builder(IrContext *context,
           Block *block,
           Block::Iterator insertion_point,
@@ -117,6 +127,9 @@ class Builder {
 
   const InsertionPoint &insertion_point() const { return insertion_point_; }
 
+  void set_listener(Listener *listener) { listener_ = listener; }
+  Listener *listener() const { return listener_; }
+
   /// Creates an operation given the fields represented as an OperationState.
   IR_API Operation *Build(OperationArgument &&argument);
 
@@ -164,6 +177,8 @@ class Builder {
   InsertionPoint insertion_point_;
 
   bool forbid_insert_without_position_;
+
+  Listener *listener_{nullptr};
 };
 
 template <typename OpTy, typename... Args>
@@ -12,8 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <array>
 #include <cstdint>
+#include <mutex>
 #include <ostream>
+#include <vector>
 
 #include "paddle/common/enforce.h"
 #include "paddle/pir/core/block.h"
@@ -24,6 +27,7 @@
 #include "paddle/pir/core/operation.h"
 #include "paddle/pir/core/program.h"
 #include "paddle/pir/core/region.h"
+#include "paddle/pir/core/spin_lock.h"
 #include "paddle/pir/core/utils.h"
 
 namespace pir {
@@ -32,6 +36,99 @@ using detail::OpOperandImpl;
 using detail::OpOutlineResultImpl;
 using detail::OpResultImpl;
 
+namespace {
+// The pool of the memory of the operations. The memory of an op holds its
+// results, the op, the operands, the block operands and the regions. It is
+// carved out of large chunks by size classes of 8 bytes and recycled through
+// the free lists, so that building and cloning programs rarely calls malloc,
+// and the ops created one after another are adjacent in memory.
+class OperationMemoryPool {
+ public:
+  static OperationMemoryPool &Instance() {
+    // Never destroyed, the ops of the static programs are freed after it.
+    static auto *pool = new OperationMemoryPool();
+    return *pool;
+  }
+
+  void *Allocate(size_t size) {
+    size = AlignUp(size);
+    if (size > kMaxPooledSize) return aligned_malloc(size, kAlignment);
+    SizeClass &size_class = size_classes_[size / kAlignment - 1];
+    std::lock_guard<pir::SpinLock> guard(size_class.lock);
+    if (size_class.free_list) {
+      FreeNode *node = size_class.free_list;
+      size_class.free_list = node->next;
+      return node;
+    }
+    if (size_class.cursor + size > size_class.end) {
+      char *chunk =
+          reinterpret_cast<char *>(aligned_malloc(kChunkSize, kAlignment));
+      IR_ENFORCE(chunk != nullptr, "Allocate the memory of ops failed.");
+      size_class.chunks.push_back(chunk);
+      size_class.cursor = chunk;
+      size_class.end = chunk + kChunkSize;
+    }
+    void *ptr = size_class.cursor;
+    size_class.cursor += size;
+    return ptr;
+  }
+
+  void Deallocate(void *ptr, size_t size) {
+    size = AlignUp(size);
+    if (size > kMaxPooledSize) return aligned_free(ptr);
+    SizeClass &size_class = size_classes_[size / kAlignment - 1];
+    std::lock_guard<pir::SpinLock> guard(size_class.lock);
+    FreeNode *node = reinterpret_cast<FreeNode *>(ptr);
+    node->next = size_class.free_list;
+    size_class.free_list = node;
+  }
+
+ private:
+  static constexpr size_t kAlignment = 8;
+  static constexpr size_t kMaxPooledSize = 1024;
+  static constexpr size_t kChunkSize = 32 * 1024;
+
+  struct FreeNode {
+    FreeNode *next;
+  };
+
+  struct SizeClass {
+    pir::SpinLock lock;
+    FreeNode *free_list{nullptr};
+    char *cursor{nullptr};
+    char *end{nullptr};
+    std::vector<char *> chunks;
+  };
+
+  static size_t AlignUp(size_t size) {
+    return (size + kAlignment - 1) / kAlignment * kAlignment;
+  }
+
+  OperationMemoryPool() = default;
+
+  std::array<SizeClass, kMaxPooledSize / kAlignment> size_classes_;
+};
+
+size_t ResultMemSize(uint32_t num_results) {
+  uint32_t max_inline_result_num = MAX_INLINE_RESULT_IDX + 1;
+  return num_results > max_inline_result_num
+             ? sizeof(detail::OpOutlineResultImpl) *
+                       (num_results - max_inline_result_num) +
+                   sizeof(detail::OpInlineResultImpl) * max_inline_result_num
+             : sizeof(detail::OpInlineResultImpl) * num_results;
+}
+
+size_t OperationMemSize(uint32_t num_results,
+                        uint32_t num_operands,
+                        uint32_t num_regions,
+                        uint32_t num_successors) {
+  return ResultMemSize(num_results) + sizeof(Operation) +
+         sizeof(detail::OpOperandImpl) * num_operands +
+         sizeof(detail::BlockOperandImpl) * num_successors +
+         sizeof(Region) * num_regions;
+}
+}  // namespace
+
 Operation *Operation::Create(OperationArgument &&argument) {
   Operation *op = Create(argument.inputs,
                          argument.attributes,
@@ -62,20 +159,11 @@ Operation *Operation::Create(const std::vector<Value> &inputs,
   uint32_t num_operands = inputs.size();
   uint32_t num_successors = successors.size();
   uint32_t max_inline_result_num = MAX_INLINE_RESULT_IDX + 1;
-  size_t result_mem_size =
-      num_results > max_inline_result_num
-          ? sizeof(detail::OpOutlineResultImpl) *
-                    (num_results - max_inline_result_num) +
-                sizeof(detail::OpInlineResultImpl) * max_inline_result_num
-          : sizeof(detail::OpInlineResultImpl) * num_results;
-  size_t op_mem_size = sizeof(Operation);
-  size_t operand_mem_size = sizeof(detail::OpOperandImpl) * num_operands;
-  size_t block_operand_size = num_successors * sizeof(detail::BlockOperandImpl);
-  size_t region_mem_size = num_regions * sizeof(Region);
-  size_t base_size = result_mem_size + op_mem_size + operand_mem_size +
-                     region_mem_size + block_operand_size;
-  // 2. Malloc memory.
-  char *base_ptr = reinterpret_cast<char *>(aligned_malloc(base_size, 8));
+  size_t base_size = OperationMemSize(
+      num_results, num_operands, num_regions, num_successors);
+  // 2. Allocate memory from the pool.
+  char *base_ptr = reinterpret_cast<char *>(
+      OperationMemoryPool::Instance().Allocate(base_size));
 
   auto name = op_info ? op_info.name() : "";
   VLOG(10) << "Create Operation [" << name
@@ -180,6 +268,10 @@ Operation *Operation::Clone(IrMapping &ir_mapping, CloneOptions options) const {
 // sequence, and finally free memory.
 void Operation::Destroy() {
   VLOG(10) << "Destroy Operation [" << name() << "] ...";
+  void *aligned_ptr =
+      reinterpret_cast<char *>(this) - ResultMemSize(num_results_);
+  size_t base_size = OperationMemSize(
+      num_results_, num_operands_, num_regions_, num_successors_);
   // 1. Deconstruct Regions.
   if (num_regions_ > 0) {
     for (size_t idx = 0; idx < num_regions_; idx++) {
@@ -217,17 +309,9 @@ void Operation::Destroy() {
   }
 
   // 5. Free memory.
-  size_t result_mem_size =
-      num_results_ > OUTLINE_RESULT_IDX
-          ? sizeof(detail::OpOutlineResultImpl) *
-                    (num_results_ - OUTLINE_RESULT_IDX) +
-                sizeof(detail::OpInlineResultImpl) * OUTLINE_RESULT_IDX
-          : sizeof(detail::OpInlineResultImpl) * num_results_;
-  void *aligned_ptr = reinterpret_cast<char *>(this) - result_mem_size;
-
-  VLOG(10) << "Destroy Operation [" << name() << "]: {ptr = " << aligned_ptr
-           << ", size = " << result_mem_size << "} done.";
-  aligned_free(aligned_ptr);
+  VLOG(10) << "Destroy Operation: {ptr = " << aligned_ptr
+           << ", size = " << base_size << "} done.";
+  OperationMemoryPool::Instance().Deallocate(aligned_ptr, base_size);
 }
 
 IrContext *Operation::ir_context() const { return info_.ir_context(); }
@@ -14,6 +14,7 @@
 
 #include "paddle/pir/core/storage_manager.h"
 
+#include <array>
 #include <memory>
 #include <unordered_map>
 
@@ -21,7 +22,9 @@
 
 namespace pir {
 // This is a structure for creating, caching, and looking up Storage of
-// parametric types.
+// parametric types. The cache is split into shards by the hash value, each
+// guarded by its own lock, so that the storages of different parameters can
+// be created concurrently.
 struct ParametricStorageManager {
   using StorageBase = StorageManager::StorageBase;
 
@@ -29,10 +32,12 @@ struct ParametricStorageManager {
       : destroy_(destroy) {}
 
   ~ParametricStorageManager() {  // NOLINT
-    for (const auto &instance : parametric_instances_) {
-      destroy_(instance.second);
+    for (auto &shard : shards_) {
+      for (const auto &instance : shard.parametric_instances) {
+        destroy_(instance.second);
+      }
+      shard.parametric_instances.clear();
     }
-    parametric_instances_.clear();
   }
 
   // Get the storage of parametric type, if not in the cache, create and
@@ -40,8 +45,11 @@ struct ParametricStorageManager {
   StorageBase *GetOrCreate(std::size_t hash_value,
                            std::function<bool(StorageBase *)> equal_func,
                            std::function<StorageBase *()> constructor) {
-    if (parametric_instances_.count(hash_value) != 0) {
-      auto pr = parametric_instances_.equal_range(hash_value);
+    Shard &shard = shards_[hash_value % kNumShards];
+    std::lock_guard<pir::SpinLock> guard(shard.lock);
+    auto &parametric_instances = shard.parametric_instances;
+    if (parametric_instances.count(hash_value) != 0) {
+      auto pr = parametric_instances.equal_range(hash_value);
       while (pr.first != pr.second) {
         if (equal_func(pr.first->second)) {
           VLOG(10) << "Found a cached parametric storage of: [param_hash="
@@ -53,7 +61,7 @@ struct ParametricStorageManager {
       }
     }
     StorageBase *storage = constructor();
-    parametric_instances_.emplace(hash_value, storage);
+    parametric_instances.emplace(hash_value, storage);
     VLOG(10) << "No cache found, construct and cache a new parametric storage "
                 "of: [param_hash="
              << hash_value << ", storage_ptr=" << storage << "].";
@@ -61,9 +69,16 @@ struct ParametricStorageManager {
   }
 
  private:
-  // In order to prevent hash conflicts, the unordered_multimap data structure
-  // is used for storage.
-  std::unordered_multimap<size_t, StorageBase *> parametric_instances_;
+  static constexpr size_t kNumShards = 16;
+
+  struct Shard {
+    pir::SpinLock lock;
+    // In order to prevent hash conflicts, the unordered_multimap data
+    // structure is used for storage.
+    std::unordered_multimap<size_t, StorageBase *> parametric_instances;
+  };
+
+  std::array<Shard, kNumShards> shards_;
   std::function<void(StorageBase *)> destroy_;
 };
 
@@ -76,15 +91,21 @@ StorageManager::StorageBase *StorageManager::GetParametricStorageImpl(
     std::size_t hash_value,
     std::function<bool(const StorageBase *)> equal_func,
     std::function<StorageBase *()> constructor) {
-  std::lock_guard<pir::SpinLock> guard(parametric_instance_lock_);
   VLOG(10) << "Try to get a parametric storage of: [TypeId_hash="
            << std::hash<pir::TypeId>()(type_id) << ", param_hash=" << hash_value
            << "].";
-  if (parametric_instance_.find(type_id) == parametric_instance_.end()) {
-    IR_THROW("The input data pointer is null.");
+  ParametricStorageManager *parametric_storage = nullptr;
+  {
+    // Only the lookup is guarded, the storage is created under the lock of
+    // its shard.
+    std::lock_guard<pir::SpinLock> guard(parametric_instance_lock_);
+    auto it = parametric_instance_.find(type_id);
+    if (it == parametric_instance_.end()) {
+      IR_THROW("The input data pointer is null.");
+    }
+    parametric_storage = it->second.get();
   }
-  ParametricStorageManager &parametric_storage = *parametric_instance_[type_id];
-  return parametric_storage.GetOrCreate(hash_value, equal_func, constructor);
+  return parametric_storage->GetOrCreate(hash_value, equal_func, constructor);
 }
 
 StorageManager::StorageBase *StorageManager::GetParameterlessStorageImpl(
@@ -14,7 +14,18 @@
 
 #include "paddle/pir/pass/pass.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 #include "paddle/common/enforce.h"
+#include "paddle/pir/core/block_argument.h"
 #include "paddle/pir/core/ir_context.h"
 #include "paddle/pir/core/operation.h"
 #include "paddle/pir/core/program.h"
@@ -36,8 +47,15 @@ Pass::~Pass() = default;
 bool Pass::CanApplyOn(Operation* op) const { return op->num_regions() > 0; }
 
 detail::PassExecutionState& Pass::pass_state() {
-  IR_ENFORCE(pass_state_.has_value() == true, "pass state has no value");
-  return *pass_state_;
+  std::lock_guard<pir::SpinLock> guard(pass_states_lock_);
+  auto it = pass_states_.find(std::this_thread::get_id());
+  IR_ENFORCE(it != pass_states_.end(), "pass state has no value");
+  return it->second;
+}
+
+void Pass::set_pass_state(const detail::PassExecutionState& state) {
+  std::lock_guard<pir::SpinLock> guard(pass_states_lock_);
+  pass_states_.insert_or_assign(std::this_thread::get_id(), state);
 }
 
 //===----------------------------------------------------------------------===//
@@ -60,6 +78,8 @@ void PatternRewritePass::Run(Operation* op) {
   GreedyRewriteConfig cfg;
   cfg.use_top_down_traversal = true;
   cfg.max_iterations = 10;
+  cfg.use_incremental_worklist = true;
+  cfg.enable_pattern_statistics = VLOG_IS_ON(1);
   auto [_, num_rewrites] = ApplyPatternsGreedily(op, patterns_, cfg);
   AddStatistics(num_rewrites);
 }
@@ -74,6 +94,8 @@ void detail::PassAdaptor::Run(Operation* op, uint8_t opt_level, bool verify) {
 void detail::PassAdaptor::RunImpl(Operation* op,
                                   uint8_t opt_level,
                                   bool verify) {
+  if (RunParallel(op, opt_level, verify)) return;
+
   auto last_am = analysis_manager();
 
   for (size_t i = 0; i < op->num_regions(); ++i) {
@@ -89,6 +111,138 @@ void detail::PassAdaptor::RunImpl(Operation* op,
   return;
 }
 
+namespace {
+// Collect the values of the enclosing blocks used by the ops nested in op,
+// and the ops defining them, which a pass on op may rewrite as well.
+void CollectUsedOuterIr(Operation* op,
+                        std::vector<Value>* outer_values,
+                        std::vector<Operation*>* outer_ops) {
+  auto IsDefinedIn = [op](Value value) {
+    Operation* def_op = value.defining_op();
+    if (!def_op) {
+      auto arg = value.dyn_cast<BlockArgument>();
+      if (!arg) return false;
+      def_op = arg.owner()->GetParentOp();
+    }
+    for (; def_op; def_op = def_op->GetParentOp()) {
+      if (def_op == op) return true;
+    }
+    return false;
+  };
+  op->Walk([&](Operation* inner_op) {
+    if (inner_op == op) return;
+    for (uint32_t i = 0; i < inner_op->num_operands(); ++i) {
+      Value value = inner_op->operand_source(i);
+      if (!value || IsDefinedIn(value)) continue;
+      outer_values->push_back(value);
+      if (Operation* def_op = value.defining_op()) {
+        outer_ops->push_back(def_op);
+        for (uint32_t j = 0; j < def_op->num_operands(); ++j) {
+          if (def_op->operand_source(j)) {
+            outer_values->push_back(def_op->operand_source(j));
+          }
+        }
+      }
+    }
+  });
+}
+
+// The nested pipelines of a parallel run are not parallelized again.
+thread_local bool in_parallel_run = false;
+}  // namespace
+
+bool detail::PassAdaptor::RunParallel(Operation* op,
+                                      uint8_t opt_level,
+                                      bool verify) {
+  if (pm_->num_threads_ <= 1 || in_parallel_run) return false;
+  auto last_am = analysis_manager();
+  if (last_am.GetPassInstrumentor()) return false;
+  for (auto& pass : pm_->passes()) {
+    if (!pass->CanRunInParallel()) return false;
+  }
+
+  std::vector<Operation*> nested_ops;
+  for (size_t i = 0; i < op->num_regions(); ++i) {
+    for (auto& block : op->region(i)) {
+      for (auto& nested_op : block) {
+        if (nested_op.num_regions() > 0) nested_ops.push_back(&nested_op);
+      }
+    }
+  }
+  if (nested_ops.size() < 2) return false;
+
+  // The ops sharing the values or the ops of the enclosing blocks share
+  // their use lists, so they are grouped and run one by one.
+  std::vector<size_t> parent(nested_ops.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  std::function<size_t(size_t)> Find = [&](size_t i) {
+    return parent[i] == i ? i : parent[i] = Find(parent[i]);
+  };
+  std::unordered_map<Value, size_t> value_owner;
+  std::unordered_map<Operation*, size_t> op_owner;
+  for (size_t i = 0; i < nested_ops.size(); ++i) {
+    std::vector<Value> outer_values;
+    std::vector<Operation*> outer_ops;
+    CollectUsedOuterIr(nested_ops[i], &outer_values, &outer_ops);
+    for (auto& value : outer_values) {
+      auto it = value_owner.emplace(value, i).first;
+      parent[Find(it->second)] = Find(i);
+    }
+    for (auto* outer_op : outer_ops) {
+      auto it = op_owner.emplace(outer_op, i).first;
+      parent[Find(it->second)] = Find(i);
+    }
+  }
+  std::unordered_map<size_t, size_t> group_index;
+  std::vector<std::vector<Operation*>> groups;
+  for (size_t i = 0; i < nested_ops.size(); ++i) {
+    auto it = group_index.emplace(Find(i), groups.size()).first;
+    if (it->second == groups.size()) groups.emplace_back();
+    groups[it->second].push_back(nested_ops[i]);
+  }
+  if (groups.size() < 2) return false;
+  VLOG(4) << "Run the pipeline on " << nested_ops.size() << " ops in "
+          << groups.size() << " parallel groups.";
+
+  std::atomic<size_t> next_group{0};
+  std::atomic<bool> failed{false};
+  std::exception_ptr exception;
+  std::mutex exception_mutex;
+  auto RunGroups = [&]() {
+    in_parallel_run = true;
+    for (size_t i = next_group++; i < groups.size() && !failed;
+         i = next_group++) {
+      try {
+        for (auto* nested_op : groups[i]) {
+          AnalysisManagerHolder am(nested_op, nullptr);
+          if (!RunPipeline(*pm_, nested_op, am, opt_level, verify)) {
+            failed = true;
+            break;
+          }
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(exception_mutex);
+        if (!exception) exception = std::current_exception();
+        failed = true;
+      }
+    }
+    in_parallel_run = false;
+  };
+  size_t num_threads =
+      std::min(static_cast<size_t>(pm_->num_threads_), groups.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(RunGroups);
+  }
+  RunGroups();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (exception) std::rethrow_exception(exception);
+  if (failed) SignalPassFailure();
+  return true;
+}
+
 bool detail::PassAdaptor::RunPipeline(const PassManager& pm,
                                       Operation* op,
                                       AnalysisManager am,
@@ -126,7 +280,7 @@ bool detail::PassAdaptor::RunPass(Pass* pass,
                                   bool verify) {
   if (opt_level < pass->pass_info().opt_level) return true;
 
-  pass->pass_state_ = PassExecutionState(op, am);
+  pass->set_pass_state(PassExecutionState(op, am));
 
   PassInstrumentor* instrumentor = am.GetPassInstrumentor();
 
@@ -178,6 +332,12 @@ bool PassManager::Initialize(IrContext* context) {
   return true;
 }
 
+void PassManager::EnableParallelExecution(int num_threads) {
+  num_threads_ = num_threads > 0
+                     ? num_threads
+                     : static_cast<int>(std::thread::hardware_concurrency());
+}
+
 void PassManager::AddInstrumentation(std::unique_ptr<PassInstrumentation> pi) {
   if (!instrumentor_) instrumentor_ = std::make_unique<PassInstrumentor>();
 
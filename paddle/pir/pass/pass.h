@@ -16,11 +16,14 @@
 
 #include <any>
 #include <cstdint>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 #include "paddle/common/enforce.h"
+#include "paddle/pir/core/spin_lock.h"
 #include "paddle/pir/pass/analysis_manager.h"
 #include "paddle/pir/pattern_rewrite/frozen_rewrite_pattern_set.h"
 
@@ -165,16 +168,24 @@ class IR_API Pass {
 
   virtual bool Initialize(IrContext* context) { return true; }
 
+  // Whether the pass only changes the op it runs on and the ops nested in it,
+  // and only reads the attributes of the pass, so that the PassManager can
+  // run it on the sibling ops isolated from above at the same time.
+  virtual bool CanRunInParallel() const { return false; }
+
   void AddStatistics(int64_t match_count) {
+    std::lock_guard<pir::SpinLock> guard(statistics_lock_);
     Set<int64_t>("__match_count__", new int64_t{match_count});
   }
 
   void AddStatistics(int64_t match_count, int64_t all_count) {
+    std::lock_guard<pir::SpinLock> guard(statistics_lock_);
     Set<int64_t>("__match_count__", new int64_t{match_count});
     Set<int64_t>("__all_count__", new int64_t{all_count});
   }
 
   void AddStatistics(const std::string& custom_log) {
+    std::lock_guard<pir::SpinLock> guard(statistics_lock_);
     Set<std::string>("__custom_log__", new std::string{custom_log});
   }
 
@@ -185,9 +196,14 @@ class IR_API Pass {
   void SignalPassFailure() { pass_state().pass_failed = true; }
 
  private:
+  void set_pass_state(const detail::PassExecutionState& state);
+
   detail::PassInfo pass_info_;
 
-  std::optional<detail::PassExecutionState> pass_state_;
+  // The execution state of each thread running the pass.
+  std::unordered_map<std::thread::id, detail::PassExecutionState> pass_states_;
+  pir::SpinLock pass_states_lock_;
+  pir::SpinLock statistics_lock_;
 
   friend class PassManager;
   friend class detail::PassAdaptor;
@@ -210,6 +226,8 @@ class IR_API PatternRewritePass : public Pass {
 
   void Run(Operation* op) override;
 
+  bool CanRunInParallel() const override { return true; }
+
  private:
   FrozenRewritePatternSet patterns_;
 };
@@ -34,6 +34,10 @@ class PassAdaptor final : public Pass {
  private:
   void RunImpl(Operation* op, uint8_t opt_level, bool verify);
 
+  // Run the pipeline on the nested ops concurrently, return false if the
+  // pipeline can not run in parallel on them.
+  bool RunParallel(Operation* op, uint8_t opt_level, bool verify);
+
   static bool RunPass(Pass* pass,
                       Operation* op,
                       AnalysisManager am,
@@ -115,6 +115,11 @@ class IR_API PassManager {
 
   void AddInstrumentation(std::unique_ptr<PassInstrumentation> pi);
 
+  /// Run the pipeline on the sibling ops isolated from above with
+  /// `num_threads` threads, 0 for the hardware concurrency. It only applies
+  /// when every pass can run in parallel and no instrumentation is added.
+  void EnableParallelExecution(int num_threads = 0);
+
  private:
   bool Initialize(IrContext *context);
 
@@ -129,6 +134,8 @@ class IR_API PassManager {
 
   bool disable_log_{false};
 
+  int num_threads_{1};
+
   std::vector<std::unique_ptr<Pass>> passes_;
 
   std::unique_ptr<Pass> pass_adaptor_;
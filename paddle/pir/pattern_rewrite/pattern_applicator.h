@@ -48,6 +48,12 @@ class PatternApplicator {
     ApplyCostModel([](const Pattern& pattern) { return pattern.benefit(); });
   }
 
+  /// Whether any pattern may match the op, the ops of the types without
+  /// patterns are skipped by the rewrite driver.
+  bool HasPatterns(const Operation& op) const {
+    return !any_op_patterns_.empty() || patterns_.count(op.info()) > 0;
+  }
+
   void WalkAllPatterns(std::function<void(const Pattern&)> walk);
 
  private:
@@ -257,7 +257,7 @@ struct OpRewritePattern
 
 // This class provides a series of interfaces for modifying IR and tracking IR
 // changes. This class provides a unified API for IR modification.
-class RewriterBase : public Builder {
+class RewriterBase : public Builder, public Builder::Listener {
  public:
   // TODO(wilber): Supplementary methods of block and region.
 
@@ -291,7 +291,7 @@ class RewriterBase : public Builder {
                     std::function<bool(OpOperand&)> functor);
 
  protected:
-  explicit RewriterBase(IrContext* ctx) : Builder(ctx) {}
+  explicit RewriterBase(IrContext* ctx) : Builder(ctx) { set_listener(this); }
 
   virtual ~RewriterBase();
 
@@ -300,7 +300,7 @@ class RewriterBase : public Builder {
 
   virtual void NotifyOperationRemoved(Operation* op) {}
 
-  virtual void NotifyOperationInserted(Operation* op) {}
+  void NotifyOperationInserted(Operation* op) override {}
 
   virtual void StartRootUpdate(Operation* op) {}
 
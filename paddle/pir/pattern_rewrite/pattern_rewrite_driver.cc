@@ -15,8 +15,10 @@
 #include "paddle/pir/pattern_rewrite/pattern_rewrite_driver.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <iterator>
 #include <numeric>
 #include <unordered_map>
@@ -69,7 +71,7 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
 
       for (auto& block_item : region_) {
         for (auto& op_item : block_item) {
-          worklist_.push_back(&op_item);
+          if (matcher_.HasPatterns(op_item)) worklist_.push_back(&op_item);
         }
       }
       if (config_.use_top_down_traversal) {
@@ -83,8 +85,14 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
 
       num_rewrites = ProcessWorklist();
       sum_num_rewrites += num_rewrites;
+      // The ops affected by the rewrites have been revisited through the
+      // worklist, so the region is at a fixed point once it is empty.
+      if (config_.use_incremental_worklist && worklist_.empty()) {
+        num_rewrites = 0;
+      }
     } while (num_rewrites != 0);
     bool converged = num_rewrites == 0;
+    if (config_.enable_pattern_statistics) PrintPatternStatistics();
     return std::make_pair(converged, sum_num_rewrites);
   }
 
@@ -93,6 +101,22 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
   /// is reached. Return `true` if any IR was changed.
   int64_t ProcessWorklist() {
     int64_t num_rewrites = 0;
+    std::function<bool(const pir::Pattern&)> can_apply;
+    std::function<void(const pir::Pattern&)> on_failure;
+    std::function<bool(const pir::Pattern&)> on_success;
+    if (config_.enable_pattern_statistics) {
+      can_apply = [this](const pir::Pattern&) {
+        match_start_ = std::chrono::steady_clock::now();
+        return true;
+      };
+      on_failure = [this](const pir::Pattern& pattern) {
+        RecordPattern(pattern, false);
+      };
+      on_success = [this](const pir::Pattern& pattern) {
+        RecordPattern(pattern, true);
+        return true;
+      };
+    }
     while (!worklist_.empty() &&
            (num_rewrites < config_.max_num_rewrites ||
             config_.max_num_rewrites == pir::GreedyRewriteConfig::kNoLimit)) {
@@ -106,7 +130,8 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
       // TODO(wilber): fold logical.
       // ...
 
-      bool match_result = matcher_.MatchAndRewrite(op, *this);
+      bool match_result = matcher_.MatchAndRewrite(
+          op, *this, can_apply, on_failure, on_success);
       if (match_result) {
         ++num_rewrites;
       }
@@ -114,13 +139,19 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
     return num_rewrites;
   }
 
-  // TODO(wilber): OpResult support GetUsers method.
   void NotifyRootReplaced(pir::Operation* op,
                           const std::vector<pir::Value>& replacement) override {
-    //   for (uint32_t i = 0; i < op->num_results(); ++i) {
-    //     auto res = op->GetResultByIndex(i);
-    //   }
-    // }
+    // The users of the results are rewired to the replacement, which may let
+    // them match again.
+    for (uint32_t i = 0; i < op->num_results(); ++i) {
+      auto res = op->result(i);
+      for (auto it = res.use_begin(); it != res.use_end(); ++it) {
+        AddToWorklist(it.owner());
+      }
+    }
+    for (auto& value : replacement) {
+      if (value && value.defining_op()) AddToWorklist(value.defining_op());
+    }
   }
 
   void FinalizeRootUpdate(pir::Operation* op) override { AddToWorklist(op); }
@@ -149,6 +180,8 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
   }
 
   void NotifyOperationInserted(pir::Operation* op) override {
+    // The ops inserted into the nested regions are not driven by this region.
+    if (op->GetParentRegion() != &region_) return;
     if (config_.strict_mode == pir::GreedyRewriteStrictness::ExistingAndNewOps)
       strict_mode_filtered_ops_.insert(op);
     AddToWorklist(op);
@@ -156,6 +189,7 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
 
   /// Add the given operation to the worklist.
   void AddToWorklist(pir::Operation* op) {
+    if (!matcher_.HasPatterns(*op)) return;
     if (config_.strict_mode == pir::GreedyRewriteStrictness::AnyOp ||
         strict_mode_filtered_ops_.count(op)) {
       if (worklist_map_.count(op)) return;
@@ -189,6 +223,30 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
     return op;
   }
 
+  void RecordPattern(const pir::Pattern& pattern, bool success) {
+    auto& stats = pattern_stats_[&pattern];
+    ++stats.num_matches;
+    if (success) ++stats.num_rewrites;
+    stats.elapsed += std::chrono::steady_clock::now() - match_start_;
+  }
+
+  void PrintPatternStatistics() const {
+    std::vector<std::pair<const pir::Pattern*, PatternStatistics>> stats(
+        pattern_stats_.begin(), pattern_stats_.end());
+    std::sort(stats.begin(), stats.end(), [](const auto& a, const auto& b) {
+      return a.second.elapsed > b.second.elapsed;
+    });
+    for (auto& [pattern, stat] : stats) {
+      LOG(INFO) << "Pattern " << pattern->debug_name()
+                << ": benefit = " << pattern->benefit().benefit()
+                << ", matches = " << stat.num_matches
+                << ", rewrites = " << stat.num_rewrites << ", time = "
+                << std::chrono::duration<double, std::milli>(stat.elapsed)
+                       .count()
+                << " ms";
+    }
+  }
+
   /// If the specified operation is in the worklist, remove it.
   void RemoveFromWorklist(pir::Operation* op) {
     auto it = worklist_map_.find(op);
@@ -205,6 +263,14 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
   std::unordered_set<pir::Operation*> strict_mode_filtered_ops_;
   pir::Region& region_;
   pir::PatternApplicator matcher_;
+
+  struct PatternStatistics {
+    int64_t num_matches{0};
+    int64_t num_rewrites{0};
+    std::chrono::nanoseconds elapsed{0};
+  };
+  std::unordered_map<const pir::Pattern*, PatternStatistics> pattern_stats_;
+  std::chrono::steady_clock::time_point match_start_;
 };
 
 }  // namespace
@@ -57,6 +57,14 @@ class IR_API GreedyRewriteConfig {
   /// - ExistingOps: only pre-existing ops are added to the worklist.
   GreedyRewriteStrictness strict_mode = GreedyRewriteStrictness::AnyOp;
 
+  /// Stop after the first scan of the region once the worklist is empty. The
+  /// users and producers of the rewritten ops are revisited through the
+  /// worklist, so the region is not rescanned after the rewrites.
+  bool use_incremental_worklist = false;
+
+  /// Log the matches, rewrites and time of every pattern.
+  bool enable_pattern_statistics = false;
+
   static constexpr int64_t kNoLimit = -1;
 };
 
@@ -13,6 +13,10 @@
 // limitations under the License.
 
 #include "paddle/utils/pybind.h"
+
+#include <cstring>
+#include <vector>
+
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/phi/core/flags.h"
@@ -57,6 +61,47 @@ paddle::Tensor& CastPyArg2Tensor(PyObject* obj, Py_ssize_t arg_pos) {
   }
 }
 
+// The freed objects of the Tensor type, which wrap the outputs of the ops
+// again without the allocations of tp_alloc. The objects of the subclasses
+// are not kept, as they may be of other sizes, and the list is only accessed
+// with the GIL held. It is never destroyed, the objects may be freed at exit.
+static constexpr size_t kMaxFreeTensorObjects = 1024;
+
+static std::vector<PyObject*>* FreeTensorObjects() {
+  static auto* free_objects = new std::vector<PyObject*>();
+  return free_objects;
+}
+
+PyObject* NewTensorObject(PyTypeObject* type) {
+  PyObject* obj = nullptr;
+  auto* free_objects = FreeTensorObjects();
+  if (type == p_tensor_type && !free_objects->empty()) {
+    obj = free_objects->back();
+    free_objects->pop_back();
+    std::memset(static_cast<void*>(obj), 0, sizeof(TensorObject));
+    PyObject_Init(obj, type);
+  } else {
+    obj = type->tp_alloc(type, 0);
+  }
+  if (obj) {
+    new (&(reinterpret_cast<TensorObject*>(obj)->tensor)) paddle::Tensor();
+  }
+  return obj;
+}
+
+void FreeTensorObject(TensorObject* self) {
+  auto* obj = reinterpret_cast<PyObject*>(self);
+  if (self->weakrefs != nullptr) PyObject_ClearWeakRefs(obj);
+  self->tensor.~Tensor();
+  auto* free_objects = FreeTensorObjects();
+  if (Py_TYPE(obj) == p_tensor_type &&
+      free_objects->size() < kMaxFreeTensorObjects) {
+    free_objects->push_back(obj);
+    return;
+  }
+  Py_TYPE(obj)->tp_free(obj);
+}
+
 PyObject* ToPyObject(const paddle::Tensor& value,
                      bool return_py_none_if_not_initialize) {
   if (return_py_none_if_not_initialize && !value.initialized()) {
@@ -66,13 +111,12 @@ PyObject* ToPyObject(const paddle::Tensor& value,
   if (value.initialized() && value.is_string_tensor()) {
     // In order to return the core.eager.StringTensor, there is need
     // to use p_string_tensor_type to create a python obj.
-    obj = p_string_tensor_type->tp_alloc(p_string_tensor_type, 0);
+    obj = NewTensorObject(p_string_tensor_type);
   } else {
-    obj = p_tensor_type->tp_alloc(p_tensor_type, 0);
+    obj = NewTensorObject(p_tensor_type);
   }
   if (obj) {
     auto v = reinterpret_cast<TensorObject*>(obj);
-    new (&(v->tensor)) paddle::Tensor();
     v->tensor = value;
   } else {
     PADDLE_THROW(
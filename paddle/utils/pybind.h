@@ -50,6 +50,13 @@ paddle::Tensor& CastPyArg2Tensor(PyObject* obj, Py_ssize_t arg_pos);
 PyObject* ToPyObject(const paddle::Tensor& value,
                      bool return_py_none_if_not_initialize = false);
 
+// Internal use only, allocates a Python object of the type with an empty
+// Tensor, reusing the freed objects of the Tensor type.
+PyObject* NewTensorObject(PyTypeObject* type);
+
+// Internal use only, the tp_dealloc of the Tensor types.
+void FreeTensorObject(TensorObject* self);
+
 // Internal use only, switch tensor_operants_mode to phi
 void EnableTensorOperantsToPhiMode();
 
@@ -1224,6 +1224,83 @@ def monkey_patch_tensor():
         """
         return _C_ops.sparse_coalesce(self)
 
+    def __dlpack_device__(self):
+        """
+        Returns the DLPack device type and the device id of the Tensor, by the
+        DLPack protocol.
+        """
+        place = self.place
+        if place.is_gpu_place():
+            device_type = 10 if core.is_compiled_with_rocm() else 2
+            return (device_type, place.gpu_device_id())
+        if place.is_cuda_pinned_place():
+            return (3, 0)
+        return (1, 0)
+
+    def __dlpack__(self, stream=None, max_version=None):
+        """
+        Exports the Tensor by the DLPack protocol without a copy. For a GPU
+        Tensor, the consumer stream waits for the current stream of paddle by
+        an event, instead of a device sync.
+
+        Args:
+            stream (int, optional): The stream of the consumer. None is the legacy
+                default stream of CUDA, and -1 does no synchronization. Default: None.
+            max_version (tuple, optional): The max DLPack version of the consumer,
+                a versioned capsule is exported if it is at least (1, 0). Default: None.
+
+        Returns:
+            PyCapsule, the dltensor of the Tensor.
+
+        Examples:
+            .. code-block:: python
+
+                >>> import paddle
+                >>> x = paddle.to_tensor([1.0, 2.0])
+                >>> y = paddle.utils.dlpack.from_dlpack(x)
+                >>> print(y)
+                Tensor(shape=[2], dtype=float32, place=Place(cpu), stop_gradient=True,
+                [1., 2.])
+        """
+        if stream is None:
+            stream = 0 if core.is_compiled_with_rocm() else 1
+        if not self.place.is_gpu_place():
+            stream = -1
+        versioned = max_version is not None and max_version[0] >= 1
+        return self.value().get_tensor()._to_dlpack(
+            stream=stream, versioned=versioned
+        )
+
+    @property
+    def __cuda_array_interface__(self):
+        """
+        The CUDA Array Interface (version 3) of a GPU Tensor, with the current stream of
+        paddle as the stream the data is produced on.
+        """
+        if not self.place.is_gpu_place():
+            raise AttributeError(
+                "__cuda_array_interface__ is only provided by the GPU tensors."
+            )
+        if (
+            self.dtype not in _PADDLE_DTYPE_2_NUMPY_DTYPE
+            or self.dtype == core.VarDesc.VarType.BF16
+        ):
+            raise TypeError(
+                f"__cuda_array_interface__ does not support {self.dtype}."
+            )
+        typestr = np.dtype(_PADDLE_DTYPE_2_NUMPY_DTYPE[self.dtype]).str
+        stream = paddle.device.current_stream(
+            self.place
+        ).stream_base.cuda_stream
+        return {
+            "shape": tuple(self.shape),
+            "typestr": typestr,
+            "data": (self.data_ptr(), False),
+            "strides": None,
+            "version": 3,
+            "stream": stream if stream != 0 else 1,
+        }
+
     if not hasattr(core, "eager"):
         return
 
@@ -1266,6 +1343,9 @@ def monkey_patch_tensor():
         ("__hash__", __hash__),
         ("_use_gpudnn", _use_gpudnn),
         ("_md5sum", _md5sum),
+        ("__dlpack_device__", __dlpack_device__),
+        ("__dlpack__", __dlpack__),
+        ("__cuda_array_interface__", __cuda_array_interface__),
     ):
         setattr(core.eager.Tensor, method_name, method)
 
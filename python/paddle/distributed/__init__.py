@@ -89,6 +89,7 @@ from .auto_parallel.api import (
     Strategy,
     DistModel,
     unshard_dtensor,
+    reshard_state_dict,
 )
 
 from .fleet import BoxPSDataset  # noqa: F401
@@ -173,4 +174,5 @@ __all__ = [
     "Strategy",
     "DistModel",
     "unshard_dtensor",
+    "reshard_state_dict",
 ]
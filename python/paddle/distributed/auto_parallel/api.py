@@ -12,6 +12,7 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 import copy
+import time
 from collections import defaultdict
 from typing import Callable, List, Tuple, Union
 
@@ -1602,6 +1603,81 @@ def unshard_dtensor(dist_tensor):
         return dist_tensor
 
 
+def reshard_state_dict(
+    state_dict, mesh, placements_fn=None, store=None, key_prefix="reshard"
+):
+    """
+    Reshards the distributed tensors of a state dict to a new ``ProcessMesh``
+    online, e.g. the parameters and the optimizer states when an elastic job
+    scales to another number of processes, instead of saving and loading a
+    checkpoint. The shards are moved by p2p among the processes of the old
+    and the new meshes, so all of them should call it, in a communication
+    group of all of them. The tensors are resharded in place, i.e. the
+    parameters of the layer and the states of the optimizer sharing them are
+    also of the new mesh.
+
+    Args:
+        state_dict (dict[str, paddle.Tensor]): The tensors to be resharded,
+            e.g. the merged state dicts of a layer and its optimizer. The
+            non distributed tensors are skipped.
+        mesh (paddle.distributed.ProcessMesh): The new mesh of the tensors.
+        placements_fn (Callable, optional): The function takes the key and
+            the tensor, and returns the placements on the new mesh. Default:
+            None, the tensors keep their placements.
+        store (core.TCPStore, optional): The store to record the progress, in
+            which ``{key_prefix}/{rank}`` is the number of the tensors
+            resharded by a process, and all the processes wait for each
+            other to be done. Default: None.
+        key_prefix (str, optional): The prefix of the keys in the store.
+            Default: "reshard".
+
+    Returns:
+        dict[str, paddle.Tensor]: The state dict of the resharded tensors.
+
+    Examples:
+        .. code-block:: python
+
+            >>> import paddle
+            >>> import paddle.distributed as dist
+
+            >>> # doctest: +REQUIRES(env:DISTRIBUTED)
+            >>> old_mesh = dist.ProcessMesh([[0, 1], [2, 3]], dim_names=["x", "y"])
+            >>> layer = dist.shard_layer(paddle.nn.Linear(8, 8), old_mesh)
+            >>> new_mesh = dist.ProcessMesh([0, 1, 2], dim_names=["x"])
+            >>> state_dict = dist.reshard_state_dict(
+            ...     layer.state_dict(),
+            ...     new_mesh,
+            ...     lambda key, tensor: [dist.Shard(0)],
+            ... )
+    """
+    assert (
+        paddle.in_dynamic_mode()
+    ), "reshard_state_dict is only supported in dynamic mode."
+    process_ids = set(mesh.process_ids)
+    # The tensors are resharded by all the processes in the same order.
+    num_resharded = 0
+    for key in sorted(state_dict.keys()):
+        tensor = state_dict[key]
+        if not isinstance(tensor, paddle.Tensor) or not tensor.is_dist():
+            continue
+        process_ids.update(tensor.process_mesh.process_ids)
+        if placements_fn is None:
+            placements = tensor.placements
+        else:
+            placements = placements_fn(key, tensor)
+        resharded = reshard(tensor, mesh, placements)
+        resharded._share_underline_tensor_to(tensor)
+        num_resharded += 1
+        if store is not None:
+            store.set(f"{key_prefix}/{dist.get_rank()}", str(num_resharded))
+
+    if store is not None:
+        store.add(f"{key_prefix}/done", 1)
+        while store.add(f"{key_prefix}/done", 0) < len(process_ids):
+            time.sleep(0.01)
+    return state_dict
+
+
 class ShardDataloader:
     """
     ShardDataloader converts a dataloader to a new dataloader which provided two capabilities:
@@ -221,6 +221,18 @@ def new_group(ranks=None, backend=None, timeout=_default_timeout):
             )
         size = len(ranks)
         ranks = sorted(ranks)
+        if (
+            backend == 'nccl'
+            and size > 1
+            and int(os.getenv("FLAGS_nccl_comm_split", 0)) == 1
+        ):
+            # all the ranks derive the communicator of the group from the
+            # global one, instead of initializing it at its first collective
+            global_group.process_group.split_comm_context(
+                gid,
+                ranks.index(global_rank) if global_rank in ranks else -1,
+                size,
+            )
         if size > 1 and global_rank in ranks:
             rank = 0 if backend == 'heter' else ranks.index(global_rank)
             pg = _new_process_group_impl(
@@ -200,6 +200,19 @@ class Communicator:
     def pull_dense(self, context):
         self.communicator_.pull_dense(context)
 
+    def report_loss(self, loss):
+        """
+        Report the training loss of a step. In GEO mode, the sync is raised
+        while the loss diverges, see FLAGS_communicator_geo_loss_tolerance.
+
+        Args:
+            loss (float): The loss of the step.
+        """
+        if self.communicator_ is None:
+            print('you must call init_with_ctx first to init comm')
+            return
+        self.communicator_.report_loss(float(loss))
+
     def push_sparse_param(self, var_name, table_id=-1, scope=None):
         if scope is None:
             scope = paddle.static.global_scope()
@@ -1428,6 +1428,13 @@ class DistributedStrategy:
         recompute-offload requires that all checkpoint to be same shape, and every dimension
         specific here should be determined ("-1" is not allowed).
 
+        memory_budget_mb(float): the memory budget of the activations in MB. When no checkpoints
+        are given, the checkpoints are planned by the activation sizes of the forward ops, so
+        that the activations fit in the budget with the least recomputation. Default 0 disables it.
+
+        batch_size(int): the batch size that the dims of -1 of the activations take when planning
+        the checkpoints by memory_budget_mb.
+
         Examples:
             .. code-block:: python
 
@@ -1010,6 +1010,45 @@ class InMemoryDataset(DatasetBase):
         """
         self.dataset.local_shuffle()
 
+    def _set_streaming_shuffle(self, fleet=None, thread_num=12):
+        """
+        Send the instances to the trainers of global shuffle while they are
+        loaded, so load_into_memory and the exchange of global_shuffle
+        overlap. It should be called before load_into_memory, and
+        global_shuffle is still called after it. Only for distributed mode.
+
+        Args:
+            fleet(Fleet): fleet singleton. Default None.
+            thread_num(int): send thread num. Default is 12.
+
+        Examples:
+            .. code-block:: python
+
+                >>> # doctest: +SKIP('No files to read')
+                >>> import paddle
+                >>> paddle.enable_static()
+                >>> dataset = paddle.distributed.InMemoryDataset()
+                >>> dataset._set_streaming_shuffle(fleet)
+                >>> dataset.load_into_memory()
+                >>> dataset.global_shuffle(fleet)
+
+        """
+        trainer_num = 1
+        if fleet is not None:
+            fleet._role_maker.barrier_worker()
+            trainer_num = fleet.worker_num()
+        if self.fleet_send_batch_size is None:
+            self.fleet_send_batch_size = 1024
+        if self.fleet_send_sleep_seconds is None:
+            self.fleet_send_sleep_seconds = 0
+        self.dataset.register_client2client_msg_handler()
+        self.dataset.set_trainer_num(trainer_num)
+        self.dataset.set_fleet_send_batch_size(self.fleet_send_batch_size)
+        self.dataset.set_fleet_send_sleep_seconds(self.fleet_send_sleep_seconds)
+        self.dataset.set_streaming_shuffle(True, thread_num)
+        if fleet is not None:
+            fleet._role_maker.barrier_worker()
+
     def global_shuffle(self, fleet=None, thread_num=12):
         """
         :api_attr: Static Graph
@@ -11,6 +11,9 @@
 # WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 # See the License for the specific language governing permissions and
 
+import logging
+
+from paddle.framework import core
 from paddle.incubate.optimizer import RecomputeOptimizer as RO
 
 from .meta_optimizer_base import MetaOptimizerBase
@@ -38,27 +41,46 @@ class RecomputeOptimizer(MetaOptimizerBase):
             loss, role_maker, user_defined_optimizer, user_defined_strategy
         )
 
-    def _init_wrapped_opt(self):
+    def _init_wrapped_opt(self, loss):
         if self.wrapped_opt is not None:
             return
 
         configs = self.user_defined_strategy.recompute_configs
         self.wrapped_opt = RO(self.inner_opt)
-        self.wrapped_opt._set_checkpoints(list(configs["checkpoints"]))
+        checkpoints = list(configs["checkpoints"])
+        if len(checkpoints) == 0:
+            checkpoints = self._plan_checkpoints(configs, loss)
+        self.wrapped_opt._set_checkpoints(checkpoints)
         if configs["enable_offload"]:
             self.wrapped_opt._enable_offload()
             # TODO(JZ-LIANG) might found a way to infer the checkpoint shape automatically
             checkpoint_shapes = list(configs["checkpoint_shape"])
             self.wrapped_opt.checkpoint_shape = checkpoint_shapes
 
+    def _plan_checkpoints(self, configs, loss):
+        budget = configs["memory_budget_mb"] * 1024 * 1024
+        planner = core.RecomputePlanner(loss.block.program)
+        plan = planner.plan(budget, configs["batch_size"])
+        if not plan.fits:
+            logging.warning(
+                "The activations of %.1fMB at least exceed the recompute "
+                "memory budget of %.1fMB, the largest batch size that fits "
+                "is %d.",
+                plan.peak_memory_bytes / 1024 / 1024,
+                configs["memory_budget_mb"],
+                planner.max_batch_size(budget, configs["batch_size"]),
+            )
+        return list(plan.checkpoints)
+
     def _can_apply(self):
         if not self.role_maker._is_collective:
             return False
 
         if self.user_defined_strategy.recompute:
+            configs = self.user_defined_strategy.recompute_configs
             if (
-                len(self.user_defined_strategy.recompute_configs["checkpoints"])
-                == 0
+                len(configs["checkpoints"]) == 0
+                and configs["memory_budget_mb"] <= 0
             ):
                 return False
             else:
@@ -81,7 +103,7 @@ class RecomputeOptimizer(MetaOptimizerBase):
         callbacks=None,
     ):
         # maybe inner_opt of other meta optimizer
-        self._init_wrapped_opt()
+        self._init_wrapped_opt(loss)
         return self.wrapped_opt.backward(
             loss, startup_program, parameter_list, no_grad_set, callbacks
         )
@@ -97,7 +119,7 @@ class RecomputeOptimizer(MetaOptimizerBase):
     def minimize_impl(
         self, loss, startup_program=None, parameter_list=None, no_grad_set=None
     ):
-        self._init_wrapped_opt()
+        self._init_wrapped_opt(loss)
         optimize_ops, params_grads = self.wrapped_opt.minimize(
             loss, startup_program, parameter_list, no_grad_set
         )
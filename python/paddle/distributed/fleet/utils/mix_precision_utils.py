@@ -66,10 +66,11 @@ class MixPrecisionLayer(nn.Layer):
                         place=tmp_grad.place,
                         name="main_grad@" + param.name,
                     )
-                else:
-                    param.main_grad.add_(tmp_grad)
-
-                tmp_grad._clear_data()
+                    tmp_grad._clear_data()
+                # The later grads are added into main_grad in place by the
+                # accumulation node, main_grad may be replaced by a view of
+                # the fused buffer of the communication.
+                param._set_main_grad(param.main_grad)
 
         return param_hook
 
@@ -20,11 +20,15 @@ PythonFunc = namedtuple("PythonFunc", ["func", "args", "kwargs"])
 
 
 def _serialize(obj):
-    return pickle.dumps(obj)
+    # The out-of-band buffers, such as the data of the numpy arrays, are sent
+    # as the raw rpc attachment instead of being copied into the pickle.
+    buffers = []
+    data = pickle.dumps(obj, protocol=5, buffer_callback=buffers.append)
+    return data, [buffer.raw() for buffer in buffers]
 
 
-def _deserialize(obj):
-    return pickle.loads(obj)
+def _deserialize(obj, buffers=()):
+    return pickle.loads(obj, buffers=buffers)
 
 
 def _run_py_func(python_func):
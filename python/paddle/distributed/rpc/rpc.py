@@ -20,7 +20,7 @@ from collections import namedtuple
 
 from paddle.base import core
 from paddle.distributed.launch.context import Node
-from paddle.distributed.rpc.internal import PythonFunc, _serialize
+from paddle.distributed.rpc.internal import PythonFunc
 from paddle.distributed.utils.launch_utils import logger
 
 WorkerInfo = namedtuple("WorkerInfo", ["name", "rank", "ip", "port"])
@@ -224,13 +224,57 @@ def rpc_async(to, fn, args=None, kwargs=None, timeout=_DEFAULT_RPC_TIMEOUT):
     return _invoke_rpc(to, fn, args, kwargs, timeout)
 
 
+def rpc_async_batch(to, fn, args_list, timeout=_DEFAULT_RPC_TIMEOUT):
+    """
+    Make the non-blocking RPC calls of function ``fn`` on worker ``to``, one
+    call per argument tuple of ``args_list``. The calls are sent in one
+    request and run in order on the worker.
+
+    Args:
+        to (str): name of the destination worker.
+        fn (fn): a callable function, such as Python callables.
+        args_list (list): the argument tuples of the ``fn`` invocations.
+        timeout (int, optional): timeout in seconds to use for the calls. A
+                                   value less than or equal to 0 indicates an
+                                   infinite timeout. The default value is -1.
+
+    Returns:
+        Returns a list of :class:`FutureWrapper` objects, one per call.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:DISTRIBUTED)
+            >>> import paddle.distributed.rpc as rpc
+
+            >>> def add(a, b):
+            ...     return a + b
+
+            >>> rpc.init_rpc("worker0", rank=0, world_size=1,
+            ...         master_endpoint="127.0.0.1:8004")
+
+            >>> futs = rpc.rpc_async_batch("worker0", add, [(2, 3), (4, 5)])
+            >>> print([fut.wait() for fut in futs])
+            [5, 9]
+
+            >>> rpc.shutdown()
+
+    """
+    py_funcs = [PythonFunc(fn, tuple(args), {}) for args in args_list]
+    return core.invoke_rpc_batch(to, py_funcs, _timeout_ms(timeout))
+
+
+def _timeout_ms(timeout):
+    timeout_ms = timeout * 1000
+    return _MAX_RPC_TIMEOUT_MS if timeout_ms <= 0 else timeout_ms
+
+
 def _invoke_rpc(to, fn, args, kwargs, timeout):
     args = args if args else ()
     kwargs = kwargs if kwargs else {}
-    serial_obj = _serialize(PythonFunc(fn, args, kwargs))
-    timeout_ms = timeout * 1000
-    timeout_ms = _MAX_RPC_TIMEOUT_MS if timeout_ms <= 0 else timeout_ms
-    future = core.invoke_rpc(to, serial_obj, timeout_ms)
+    future = core.invoke_rpc(
+        to, PythonFunc(fn, args, kwargs), _timeout_ms(timeout)
+    )
     return future
 
 
@@ -46,6 +46,13 @@ from .optimizer import (
 from .passes import fuse_resnet_unit_pass  # noqa: F401
 from .tensor import (
     _npu_identity,  # noqa: F401
+    hnsw_add,
+    hnsw_build,
+    hnsw_search,
+    ivf_pq_add,
+    ivf_pq_build,
+    ivf_pq_search,
+    matmul_topk,
     segment_max,
     segment_mean,
     segment_min,
@@ -66,4 +73,11 @@ __all__ = [
     'segment_max',
     'segment_min',
     'identity_loss',
+    'matmul_topk',
+    'ivf_pq_build',
+    'ivf_pq_add',
+    'ivf_pq_search',
+    'hnsw_build',
+    'hnsw_add',
+    'hnsw_search',
 ]
@@ -31,6 +31,9 @@ def set_config(config=None):
 
     - enable(bool): Whether to enable kernel tuning.
     - tuning_range(list): Start and end iteration for auto-tuning. Default: [1, 10].
+    - cache_file(str): The file the tuned algorithms are loaded from at enabling and
+      saved to at the end of the tuning iterations, so the later runs on the same
+      device and library versions skip the tuning. Default: None.
 
     2. layout: When it is enabled, the best data layout such as NCHW or NHWC will be
     determined based on the device and data type. When the origin layout setting is
@@ -100,6 +103,17 @@ def set_config(config=None):
 
     if "kernel" in config_dict:
         kernel_config = config_dict["kernel"]
+        # the cache file is loaded when the kernel tuning is enabled
+        if "cache_file" in kernel_config:
+            if isinstance(kernel_config['cache_file'], str):
+                paddle.set_flags(
+                    {'FLAGS_autotune_cache_file': kernel_config['cache_file']}
+                )
+            else:
+                warnings.warn(
+                    "The auto-tuning configuration of the kernel is incorrect."
+                    "The `cache_file` should be str. Use default parameter instead."
+                )
         if "enable" in kernel_config:
             if isinstance(kernel_config['enable'], bool):
                 if kernel_config['enable']:
@@ -117,8 +117,14 @@ def _reduce_tensor(tensor):
         )
 
 
-def _rebuild_lodtensor_filename(cls, ipc_name, size, type_idx, dims, lod):
-    lodtensor = cls._new_shared_filename((ipc_name, size, type_idx, dims, lod))
+def _rebuild_lodtensor_filename(
+    cls, ipc_name, size, type_idx, dims, lod, offset=None
+):
+    # The tensors in the pooled shm segments are passed with their offsets.
+    metadata = (ipc_name, size, type_idx, dims, lod)
+    if offset is not None:
+        metadata += (offset,)
+    lodtensor = cls._new_shared_filename(metadata)
     lodtensor._shared_decref()
     return lodtensor
 
@@ -165,7 +171,7 @@ def _reduce_lodtensor(lodtensor):
         # Default use share filename stratege
         metadata = (
             lodtensor._share_filename()
-        )  # ipc_name, size, type_idx, dims, lod
+        )  # ipc_name, size, type_idx, dims, lod[, offset]
         rebuild = _rebuild_lodtensor_filename
         lodtensor._shared_incref()
         # TODO, maintain reference for lodtensor
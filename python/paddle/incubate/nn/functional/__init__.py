@@ -13,11 +13,13 @@
 # limitations under the License.
 
 from .block_multihead_attention import block_multihead_attention
+from .block_verify_attention import block_verify_attention
 from .fused_dot_product_attention import (
     fused_dot_product_attention,  # noqa: F401
 )
 from .fused_dropout_add import fused_dropout_add
 from .fused_ec_moe import fused_ec_moe
+from .fused_fp8_linear import fused_fp8_linear
 from .fused_gate_attention import fused_gate_attention  # noqa: F401
 from .fused_layer_norm import fused_layer_norm
 from .fused_matmul_bias import (
@@ -25,6 +27,7 @@ from .fused_matmul_bias import (
     fused_linear_activation,
     fused_matmul_bias,
 )
+from .fused_moe import fused_moe
 from .fused_rms_norm import fused_rms_norm
 from .fused_rotary_position_embedding import fused_rotary_position_embedding
 from .fused_transformer import (
@@ -34,6 +37,7 @@ from .fused_transformer import (
     fused_multi_transformer,
 )
 from .masked_multihead_attention import masked_multihead_attention
+from .speculative_sampling import speculative_sampling
 from .variable_length_memory_efficient_attention import (
     variable_length_memory_efficient_attention,
 )
@@ -54,4 +58,8 @@ __all__ = [
     "fused_layer_norm",
     "masked_multihead_attention",
     "block_multihead_attention",
+    "fused_fp8_linear",
+    "block_verify_attention",
+    "speculative_sampling",
+    "fused_moe",
 ]
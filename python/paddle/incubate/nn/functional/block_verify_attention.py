@@ -0,0 +1,109 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from paddle import _C_ops
+from paddle.framework import LayerHelper, in_dynamic_mode
+
+
+def block_verify_attention(
+    qkv,
+    key_cache,
+    value_cache,
+    seq_lens_decoder,
+    seq_lens_this_time,
+    cu_seqlens_q,
+    block_tables,
+    scale=-1.0,
+    name=None,
+):
+    """
+    The verification attention of speculative decoding over the paged kv
+    caches of block_multihead_attention. Sequence b feeds seq_lens_this_time[b]
+    tokens, its last accepted token and the draft tokens, at the positions
+    after its seq_lens_decoder[b] cached tokens. Their k and v are written to
+    the caches in place, and token i of the sequence attends the first
+    `seq_lens_decoder[b] + i + 1` positions, so every draft token is verified
+    by one forward of the target model.
+
+    Args:
+        qkv (Tensor): The qkv of shape [token_num, 3 * num_head * dim_head] with the rotary embedding applied, its dtype is float32, float16 or bfloat16.
+        key_cache (Tensor): The key cache of shape [max_block_num, num_head, block_size, dim_head]. It is updated in place.
+        value_cache (Tensor): The value cache of the shape of key_cache. It is updated in place.
+        seq_lens_decoder (Tensor): The int32 cached lengths of shape [bsz].
+        seq_lens_this_time (Tensor): The int32 numbers of the fed tokens of shape [bsz].
+        cu_seqlens_q (Tensor): The int32 prefix sums of seq_lens_this_time of shape [bsz + 1].
+        block_tables (Tensor): The int32 block tables of shape [bsz, max_blocks_per_seq].
+        scale (float, optional): The scale of the attention scores. Default is -1.0, which means `1 / sqrt(dim_head)`.
+        name (str, optional): For details, please refer to :ref:`api_guide_Name`. Generally, no setting is required. Default: None.
+
+    Returns:
+        Tensor, the output of shape [token_num, num_head * dim_head] and the dtype of qkv.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> from paddle.incubate.nn.functional import block_verify_attention
+
+            >>> paddle.device.set_device('gpu')
+            >>> num_head, dim_head, block_size = 2, 64, 16
+            >>> seq_lens_decoder = paddle.to_tensor([10, 20], dtype='int32')
+            >>> seq_lens_this_time = paddle.to_tensor([3, 3], dtype='int32')
+            >>> cu_seqlens_q = paddle.to_tensor([0, 3, 6], dtype='int32')
+            >>> block_tables = paddle.to_tensor([[0, 1], [2, 3]], dtype='int32')
+            >>> qkv = paddle.randn([6, 3 * num_head * dim_head], dtype='float16')
+            >>> key_cache = paddle.zeros([4, num_head, block_size, dim_head], dtype='float16')
+            >>> value_cache = paddle.zeros([4, num_head, block_size, dim_head], dtype='float16')
+            >>> out = block_verify_attention(
+            ...     qkv, key_cache, value_cache, seq_lens_decoder,
+            ...     seq_lens_this_time, cu_seqlens_q, block_tables
+            ... )
+            >>> print(out.shape)
+            [6, 128]
+    """
+    if in_dynamic_mode():
+        out, _, _ = _C_ops.block_verify_attention_(
+            qkv,
+            key_cache,
+            value_cache,
+            seq_lens_decoder,
+            seq_lens_this_time,
+            cu_seqlens_q,
+            block_tables,
+            scale,
+        )
+        return out
+
+    helper = LayerHelper('block_verify_attention', **locals())
+    out = helper.create_variable_for_type_inference(dtype=qkv.dtype)
+    helper.append_op(
+        type='block_verify_attention',
+        inputs={
+            'qkv': qkv,
+            'key_cache': key_cache,
+            'value_cache': value_cache,
+            'seq_lens_decoder': seq_lens_decoder,
+            'seq_lens_this_time': seq_lens_this_time,
+            'cu_seqlens_q': cu_seqlens_q,
+            'block_tables': block_tables,
+        },
+        outputs={
+            'out': out,
+            'key_cache_out': key_cache,
+            'value_cache_out': value_cache,
+        },
+        attrs={'scale': scale},
+    )
+    return out
@@ -0,0 +1,110 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from paddle import _C_ops
+from paddle.framework import LayerHelper, in_dynamic_mode
+
+
+def fused_fp8_linear(
+    x,
+    weight,
+    bias,
+    x_scale,
+    x_amax_history,
+    weight_scale,
+    weight_amax_history,
+    margin=0.0,
+    name=None,
+):
+    """
+    Linear of the FP8 tensor cores with delayed scaling. x and weight are cast
+    to float8_e4m3fn with the scales of the last steps, and the GEMM of the
+    casted tensors is dequantized to the dtype of x. Then the amax of x and
+    weight of this step is pushed to the front of their amax histories, and
+    every scale is updated in place to `448 / max(amax_history) / 2^margin`,
+    which the next step casts with.
+
+    It needs the GPU of compute capability 8.9 or later and CUDA 11.8.
+
+    Args:
+        x (Tensor): The input Tensor, its dtype is float16 or bfloat16 and its shape is [*, k].
+        weight (Tensor): The weight Tensor of the same dtype as x, its shape is [k, n]. k and n should be multiples of 16.
+        bias (Tensor|None): The bias Tensor of the same dtype as x, its shape is [n].
+        x_scale (Tensor): The float32 scale of x, its shape is [1]. It is updated in place.
+        x_amax_history (Tensor): The float32 amax history of x, its shape is [history_len]. It is updated in place.
+        weight_scale (Tensor): The float32 scale of weight, its shape is [1]. It is updated in place.
+        weight_amax_history (Tensor): The float32 amax history of weight, its shape is [history_len]. It is updated in place.
+        margin (float, optional): The scales leave 2^margin of headroom below the largest FP8 value. Default is 0.0.
+        name (str, optional): For details, please refer to :ref:`api_guide_Name`. Generally, no setting is required. Default: None.
+
+    Returns:
+        Tensor: The output Tensor of shape [*, n] and the dtype of x.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +SKIP('Only sm89 and later GPUs support the FP8 GEMM')
+            >>> import paddle
+            >>> from paddle.incubate.nn.functional import fused_fp8_linear
+
+            >>> x = paddle.randn([32, 64], dtype='bfloat16')
+            >>> weight = paddle.randn([64, 128], dtype='bfloat16')
+            >>> x_scale = paddle.ones([1], dtype='float32')
+            >>> x_amax_history = paddle.zeros([16], dtype='float32')
+            >>> weight_scale = paddle.ones([1], dtype='float32')
+            >>> weight_amax_history = paddle.zeros([16], dtype='float32')
+            >>> out = fused_fp8_linear(
+            ...     x, weight, None, x_scale, x_amax_history, weight_scale, weight_amax_history
+            ... )
+            >>> print(out.shape)
+            [32, 128]
+    """
+    if in_dynamic_mode():
+        out, _, _, _, _ = _C_ops.fused_fp8_linear_(
+            x,
+            weight,
+            bias,
+            x_scale,
+            x_amax_history,
+            weight_scale,
+            weight_amax_history,
+            margin,
+        )
+        return out
+
+    helper = LayerHelper('fused_fp8_linear', **locals())
+    out = helper.create_variable_for_type_inference(dtype=x.dtype)
+    inputs = {
+        'x': x,
+        'weight': weight,
+        'x_scale': x_scale,
+        'x_amax_history': x_amax_history,
+        'weight_scale': weight_scale,
+        'weight_amax_history': weight_amax_history,
+    }
+    if bias is not None:
+        inputs['bias'] = bias
+    helper.append_op(
+        type='fused_fp8_linear',
+        inputs=inputs,
+        outputs={
+            'out': out,
+            'x_scale_out': x_scale,
+            'x_amax_history_out': x_amax_history,
+            'weight_scale_out': weight_scale,
+            'weight_amax_history_out': weight_amax_history,
+        },
+        attrs={'margin': margin},
+    )
+    return out
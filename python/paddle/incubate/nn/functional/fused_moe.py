@@ -0,0 +1,107 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import paddle
+import paddle.nn.functional as F
+from paddle import _C_ops
+from paddle.framework import LayerHelper, in_dynamic_mode
+
+
+def fused_moe(
+    x,
+    gate,
+    ffn1_weight,
+    ffn1_bias,
+    ffn2_weight,
+    ffn2_bias=None,
+    top_k=2,
+    act_type="gelu",
+    name=None,
+):
+    """
+    The token-choice MoE of the local experts. Every token is routed to the
+    top_k experts of its gate probs, the rows of the tokens are permuted to be
+    contiguous by the experts, the FFNs of all the experts run as a grouped
+    GEMM each, and the outputs of the experts are un-permuted and combined by
+    the gate probs. So there is neither a launch for every expert nor a
+    padding of the experts to their capacity.
+    This method requires SM_ARCH in sm70, sm75, sm80, sm86.
+
+    Args:
+        x (Tensor): The input Tensor of shape [..., d_model], its dtype is float32 or float16.
+        gate (Tensor): The gate logits of shape [..., num_experts], where the leading dims are of x.
+        ffn1_weight (Tensor): The first FFN weight of shape [num_experts, d_model, d_feed_forward].
+        ffn1_bias (Tensor): The first FFN bias of shape [num_experts, 1, d_feed_forward].
+        ffn2_weight (Tensor): The second FFN weight of shape [num_experts, d_feed_forward, d_model].
+        ffn2_bias (Tensor, optional): The second FFN bias of shape [num_experts, 1, d_model]. Default is None.
+        top_k (int, optional): The number of the experts of a token. Default is 2.
+        act_type (str, optional): The activation of the first FFN, `gelu` or `relu`. Default is `gelu`.
+        name (str, optional): For details, please refer to :ref:`api_guide_Name`. Generally, no setting is required. Default: None.
+
+    Returns:
+        Tensor, the output Tensor of the shape and the dtype of x.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> from paddle.incubate.nn.functional import fused_moe
+
+            >>> paddle.device.set_device('gpu')
+            >>> x = paddle.randn([10, 128, 1024], dtype='float16')
+            >>> gate = paddle.randn([10, 128, 8], dtype='float16')
+            >>> ffn1_weight = paddle.randn([8, 1024, 4096], dtype='float16')
+            >>> ffn1_bias = paddle.randn([8, 1, 4096], dtype='float16')
+            >>> ffn2_weight = paddle.randn([8, 4096, 1024], dtype='float16')
+            >>> out = fused_moe(x, gate, ffn1_weight, ffn1_bias, ffn2_weight)
+            >>> print(out.shape)
+            [10, 128, 1024]
+    """
+    num_experts = gate.shape[-1]
+    probs = F.softmax(gate.reshape([-1, num_experts]).astype('float32'))
+    topk_weights, topk_ids = paddle.topk(probs, top_k, axis=-1)
+    topk_weights = topk_weights.astype(x.dtype)
+
+    if in_dynamic_mode():
+        return _C_ops.fused_moe(
+            x,
+            topk_ids,
+            topk_weights,
+            ffn1_weight,
+            ffn1_bias,
+            ffn2_weight,
+            ffn2_bias,
+            act_type,
+        )
+
+    helper = LayerHelper('fused_moe', **locals())
+    out = helper.create_variable_for_type_inference(dtype=x.dtype)
+    inputs = {
+        'x': x,
+        'topk_ids': topk_ids,
+        'topk_weights': topk_weights,
+        'ffn1_weight': ffn1_weight,
+        'ffn1_bias': ffn1_bias,
+        'ffn2_weight': ffn2_weight,
+    }
+    if ffn2_bias is not None:
+        inputs['ffn2_bias'] = ffn2_bias
+    helper.append_op(
+        type='fused_moe',
+        inputs=inputs,
+        outputs={'out': out},
+        attrs={'act_type': act_type},
+    )
+    return out
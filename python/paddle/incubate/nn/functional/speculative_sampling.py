@@ -0,0 +1,80 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from paddle import _C_ops
+from paddle.framework import LayerHelper, in_dynamic_mode
+
+
+def speculative_sampling(
+    draft_tokens, draft_probs, target_probs, seed=None, name=None
+):
+    """
+    The batched acceptance sampling of speculative decoding. Draft token i of
+    a row is accepted with the probability `min(1, p(x) / q(x))`, where q is
+    the draft probs and p the target probs of the token, until the first
+    rejection. The rejected position samples a token from the normalized
+    residual `max(0, p - q)`, and a row accepting every draft token samples a
+    bonus token from the last target probs. So the accepted tokens follow the
+    distribution of the target model.
+
+    Args:
+        draft_tokens (Tensor): The int64 draft tokens of shape [bsz, k].
+        draft_probs (Tensor): The probs of the draft model of shape [bsz, k, vocab_size], its dtype is float32, float16 or bfloat16.
+        target_probs (Tensor): The probs of the target model of shape [bsz, k + 1, vocab_size] and the dtype of draft_probs. Row i is the probs verifying draft token i, and row k gives the bonus token.
+        seed (int, optional): The random seed. Default is None, which takes the seed and offset of the global generator.
+        name (str, optional): For details, please refer to :ref:`api_guide_Name`. Generally, no setting is required. Default: None.
+
+    Returns:
+        tuple(Tensor), the int64 accept_tokens of shape [bsz, k + 1] padded by -1 after the accepted and the sampled token, and the int32 accept_num of shape [bsz], which counts the accepted tokens with the sampled one.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> import paddle.nn.functional as F
+            >>> from paddle.incubate.nn.functional import speculative_sampling
+
+            >>> paddle.device.set_device('gpu')
+            >>> draft_probs = F.softmax(paddle.randn([2, 4, 32]), axis=-1)
+            >>> target_probs = F.softmax(paddle.randn([2, 5, 32]), axis=-1)
+            >>> draft_tokens = paddle.randint(0, 32, [2, 4], dtype='int64')
+            >>> accept_tokens, accept_num = speculative_sampling(
+            ...     draft_tokens, draft_probs, target_probs
+            ... )
+            >>> print(accept_tokens.shape, accept_num.shape)
+            [2, 5] [2]
+    """
+    if seed is None:
+        seed = -1
+
+    if in_dynamic_mode():
+        return _C_ops.speculative_sampling(
+            draft_tokens, draft_probs, target_probs, seed
+        )
+
+    helper = LayerHelper('speculative_sampling', **locals())
+    accept_tokens = helper.create_variable_for_type_inference(dtype="int64")
+    accept_num = helper.create_variable_for_type_inference(dtype="int32")
+    helper.append_op(
+        type='speculative_sampling',
+        inputs={
+            'draft_tokens': draft_tokens,
+            'draft_probs': draft_probs,
+            'target_probs': target_probs,
+        },
+        outputs={'accept_tokens': accept_tokens, 'accept_num': accept_num},
+        attrs={'seed': seed},
+    )
+    return accept_tokens, accept_num
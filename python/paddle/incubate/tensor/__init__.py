@@ -12,8 +12,17 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+from .ann import (  # noqa: F401
+    hnsw_add,
+    hnsw_build,
+    hnsw_search,
+    ivf_pq_add,
+    ivf_pq_build,
+    ivf_pq_search,
+)
 from .manipulation import _npu_identity  # noqa: F401
 from .math import (  # noqa: F401
+    matmul_topk,
     segment_max,
     segment_mean,
     segment_min,
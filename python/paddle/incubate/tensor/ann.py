@@ -0,0 +1,309 @@
+# Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+The approximate nearest neighbor search by an IVF-PQ index or an HNSW graph.
+An index is a tuple of dense tensors, so that it is saved and loaded like the
+parameters, and a search is an op of the inference program.
+"""
+
+from paddle import _C_ops
+from paddle.base.data_feeder import check_variable_and_dtype
+from paddle.base.layer_helper import LayerHelper
+from paddle.framework import in_dynamic_or_pir_mode
+
+__all__ = []
+
+
+def _append_ann_op(op_type, inputs, output_dtypes, attrs):
+    helper = LayerHelper(op_type)
+    outputs = {
+        name: helper.create_variable_for_type_inference(dtype=dtype)
+        for name, dtype in output_dtypes
+    }
+    helper.append_op(
+        type=op_type, inputs=inputs, outputs=outputs, attrs=attrs
+    )
+    return tuple(outputs[name] for name, _ in output_dtypes)
+
+
+def ivf_pq_build(x, nlist, m, ksub=256, iters=10, seed=0, name=None):
+    r"""
+    Builds an IVF-PQ index of the rows of ``x``. The rows are clustered into
+    ``nlist`` inverted lists by a k-means, then the residuals to the centroids
+    are product quantized into ``m`` codes of a byte. The index is trained and
+    built on the CPU.
+
+    Args:
+        x (Tensor): The rows, a 2-D float32 tensor of shape [n, d].
+        nlist (int): The number of the inverted lists.
+        m (int): The number of the subspaces, which should divide d.
+        ksub (int, optional): The number of the codewords of a subspace, at
+            most 256. Default: 256.
+        iters (int, optional): The iterations of the k-means. Default: 10.
+        seed (int, optional): The seed of the k-means. Default: 0.
+        name (str, optional): Name for the operation (optional, default is None).
+            For more information, please refer to :ref:`api_guide_Name`.
+
+    Returns:
+        tuple(Tensor), the index ``(centroids, codebooks, codes, list_offsets,
+        ids)``, where the rows have the ids [0, n).
+
+    Examples:
+
+        .. code-block:: python
+
+            >>> import paddle
+            >>> x = paddle.rand([1000, 16])
+            >>> index = paddle.incubate.ivf_pq_build(x, nlist=8, m=4, ksub=16)
+            >>> distances, ids = paddle.incubate.ivf_pq_search(
+            ...     x[:2], *index, k=5, nprobe=8)
+            >>> print(ids.shape)
+            [2, 5]
+
+    """
+    if in_dynamic_or_pir_mode():
+        return _C_ops.ivf_pq_build(x, nlist, m, ksub, iters, seed)
+
+    check_variable_and_dtype(x, "x", ("float32",), "ivf_pq_build")
+    return _append_ann_op(
+        "ivf_pq_build",
+        {"x": x},
+        [
+            ("centroids", x.dtype),
+            ("codebooks", x.dtype),
+            ("codes", "uint8"),
+            ("list_offsets", "int64"),
+            ("ids", "int64"),
+        ],
+        {"nlist": nlist, "m": m, "ksub": ksub, "iters": iters, "seed": seed},
+    )
+
+
+def ivf_pq_add(x, centroids, codebooks, codes, list_offsets, ids, name=None):
+    r"""
+    Adds the rows of ``x`` to an IVF-PQ index, with the ids following the ids
+    of the index. The centroids and the codebooks are unchanged.
+
+    Args:
+        x (Tensor): The new rows, a 2-D float32 tensor of shape [n, d].
+        centroids, codebooks, codes, list_offsets, ids (Tensor): The index,
+            as returned by :ref:`ivf_pq_build`.
+        name (str, optional): Name for the operation (optional, default is None).
+            For more information, please refer to :ref:`api_guide_Name`.
+
+    Returns:
+        tuple(Tensor), the new ``(codes, list_offsets, ids)`` of the index.
+    """
+    if in_dynamic_or_pir_mode():
+        return _C_ops.ivf_pq_add(
+            x, centroids, codebooks, codes, list_offsets, ids
+        )
+
+    check_variable_and_dtype(x, "x", ("float32",), "ivf_pq_add")
+    return _append_ann_op(
+        "ivf_pq_add",
+        {
+            "x": x,
+            "centroids": centroids,
+            "codebooks": codebooks,
+            "codes": codes,
+            "list_offsets": list_offsets,
+            "ids": ids,
+        },
+        [
+            ("codes_out", "uint8"),
+            ("list_offsets_out", "int64"),
+            ("ids_out", "int64"),
+        ],
+        {},
+    )
+
+
+def ivf_pq_search(
+    query,
+    centroids,
+    codebooks,
+    codes,
+    list_offsets,
+    ids,
+    k=10,
+    nprobe=8,
+    name=None,
+):
+    r"""
+    Searches an IVF-PQ index for the ``k`` nearest rows of each query, in its
+    ``nprobe`` nearest lists, by the squared L2 distances to the quantized
+    rows. It runs on the CPU and on the GPU.
+
+    Args:
+        query (Tensor): The queries, a 2-D float32 tensor of shape [q, d].
+        centroids, codebooks, codes, list_offsets, ids (Tensor): The index,
+            as returned by :ref:`ivf_pq_build`.
+        k (int, optional): The number of the results of a query. Default: 10.
+        nprobe (int, optional): The number of the lists probed by a query.
+            Default: 8.
+        name (str, optional): Name for the operation (optional, default is None).
+            For more information, please refer to :ref:`api_guide_Name`.
+
+    Returns:
+        tuple(Tensor), the distances of shape [q, k] in the ascending order,
+        and the int64 ids of the rows. The missing results have the distance
+        inf and the id -1.
+    """
+    if in_dynamic_or_pir_mode():
+        return _C_ops.ivf_pq_search(
+            query, centroids, codebooks, codes, list_offsets, ids, k, nprobe
+        )
+
+    check_variable_and_dtype(query, "query", ("float32",), "ivf_pq_search")
+    return _append_ann_op(
+        "ivf_pq_search",
+        {
+            "query": query,
+            "centroids": centroids,
+            "codebooks": codebooks,
+            "codes": codes,
+            "list_offsets": list_offsets,
+            "ids": ids,
+        },
+        [("distances", query.dtype), ("indices", "int64")],
+        {"k": k, "nprobe": nprobe},
+    )
+
+
+def hnsw_build(x, m=16, ef_construction=200, seed=0, name=None):
+    r"""
+    Builds an HNSW graph over the rows of ``x`` on the CPU.
+
+    Args:
+        x (Tensor): The rows, a 2-D float32 tensor of shape [n, d].
+        m (int, optional): The number of the neighbors of a node at the upper
+            levels, a node has 2m at the level 0. Default: 16.
+        ef_construction (int, optional): The size of the candidate lists of
+            the insertions. Default: 200.
+        seed (int, optional): The seed of the levels of the nodes. Default: 0.
+        name (str, optional): Name for the operation (optional, default is None).
+            For more information, please refer to :ref:`api_guide_Name`.
+
+    Returns:
+        tuple(Tensor), the graph ``(neighbors, offsets, meta)``, whose nodes
+        are the rows of ``x``.
+
+    Examples:
+
+        .. code-block:: python
+
+            >>> import paddle
+            >>> x = paddle.rand([1000, 16])
+            >>> graph = paddle.incubate.hnsw_build(x, m=8)
+            >>> distances, ids = paddle.incubate.hnsw_search(x[:2], x, *graph, k=5)
+            >>> print(ids[:, 0])
+            Tensor(shape=[2], dtype=int64, place=Place(cpu), stop_gradient=True,
+            [0, 1])
+
+    """
+    if in_dynamic_or_pir_mode():
+        return _C_ops.hnsw_build(x, m, ef_construction, seed)
+
+    check_variable_and_dtype(x, "x", ("float32",), "hnsw_build")
+    return _append_ann_op(
+        "hnsw_build",
+        {"x": x},
+        [("neighbors", "int32"), ("offsets", "int64"), ("meta", "int64")],
+        {"m": m, "ef_construction": ef_construction, "seed": seed},
+    )
+
+
+def hnsw_add(
+    x, neighbors, offsets, meta, ef_construction=200, seed=0, name=None
+):
+    r"""
+    Inserts new rows into an HNSW graph. ``x`` holds the rows of the graph
+    followed by the new rows.
+
+    Args:
+        x (Tensor): The rows, a 2-D float32 tensor of shape [n, d].
+        neighbors, offsets, meta (Tensor): The graph of the first rows, as
+            returned by :ref:`hnsw_build`.
+        ef_construction (int, optional): The size of the candidate lists of
+            the insertions. Default: 200.
+        seed (int, optional): The seed of the levels of the nodes. Default: 0.
+        name (str, optional): Name for the operation (optional, default is None).
+            For more information, please refer to :ref:`api_guide_Name`.
+
+    Returns:
+        tuple(Tensor), the new graph ``(neighbors, offsets, meta)`` over all
+        the rows of ``x``.
+    """
+    if in_dynamic_or_pir_mode():
+        return _C_ops.hnsw_add(
+            x, neighbors, offsets, meta, ef_construction, seed
+        )
+
+    check_variable_and_dtype(x, "x", ("float32",), "hnsw_add")
+    return _append_ann_op(
+        "hnsw_add",
+        {"x": x, "neighbors": neighbors, "offsets": offsets, "meta": meta},
+        [
+            ("neighbors_out", "int32"),
+            ("offsets_out", "int64"),
+            ("meta_out", "int64"),
+        ],
+        {"ef_construction": ef_construction, "seed": seed},
+    )
+
+
+def hnsw_search(
+    query, x, neighbors, offsets, meta, k=10, ef_search=64, name=None
+):
+    r"""
+    Searches an HNSW graph for the ``k`` nearest rows of ``x`` to each query,
+    by the squared L2 distances, on the CPU.
+
+    Args:
+        query (Tensor): The queries, a 2-D float32 tensor of shape [q, d].
+        x (Tensor): The rows of the graph, a 2-D float32 tensor of shape
+            [n, d].
+        neighbors, offsets, meta (Tensor): The graph, as returned by
+            :ref:`hnsw_build`.
+        k (int, optional): The number of the results of a query. Default: 10.
+        ef_search (int, optional): The size of the candidate list of a query,
+            the larger the more accurate. Default: 64.
+        name (str, optional): Name for the operation (optional, default is None).
+            For more information, please refer to :ref:`api_guide_Name`.
+
+    Returns:
+        tuple(Tensor), the distances of shape [q, k] in the ascending order,
+        and the int64 ids of the rows. The missing results have the distance
+        inf and the id -1.
+    """
+    if in_dynamic_or_pir_mode():
+        return _C_ops.hnsw_search(
+            query, x, neighbors, offsets, meta, k, ef_search
+        )
+
+    check_variable_and_dtype(query, "query", ("float32",), "hnsw_search")
+    return _append_ann_op(
+        "hnsw_search",
+        {
+            "query": query,
+            "x": x,
+            "neighbors": neighbors,
+            "offsets": offsets,
+            "meta": meta,
+        },
+        [("distances", query.dtype), ("indices", "int64")],
+        {"k": k, "ef_search": ef_search},
+    )
@@ -292,3 +292,57 @@ def segment_max(data, segment_ids, name=None):
         attrs={"pooltype": "MAX"},
     )
     return out
+
+
+def matmul_topk(x, y, k=1, largest=True, name=None):
+    r"""
+    The top k of the scores :math:`x y^T` of each row of ``x``, computed by
+    tiles so that the full score matrix is never materialized. It is used to
+    rank a large set of candidates for the queries in the retrieval.
+
+    Args:
+        x (Tensor): The queries, a 2-D tensor of shape [m, d], available data
+            type float32, float64.
+        y (Tensor): The candidates, a 2-D tensor of shape [n, d], with the same
+            data type as ``x``.
+        k (int, optional): The number of the top scores of each query, at most
+            n. Default: 1.
+        largest (bool, optional): Whether the largest scores are selected, or
+            else the smallest. Default: True.
+        name (str, optional): Name for the operation (optional, default is None).
+            For more information, please refer to :ref:`api_guide_Name`.
+
+    Returns:
+        tuple(Tensor), the top k scores of shape [m, k] in the rank order, and
+        their int64 indices into the candidates.
+
+    Examples:
+
+        .. code-block:: python
+
+            >>> import paddle
+            >>> x = paddle.to_tensor([[1.0, 0.0], [0.0, 1.0]])
+            >>> y = paddle.to_tensor([[1.0, 2.0], [3.0, 1.0], [0.0, 4.0]])
+            >>> values, indices = paddle.incubate.matmul_topk(x, y, k=2)
+            >>> print(indices)
+            Tensor(shape=[2, 2], dtype=int64, place=Place(cpu), stop_gradient=True,
+            [[1, 0],
+             [2, 0]])
+
+    """
+    if in_dynamic_or_pir_mode():
+        return _C_ops.matmul_topk(x, y, k, largest)
+
+    check_variable_and_dtype(x, "x", ("float32", "float64"), "matmul_topk")
+    check_variable_and_dtype(y, "y", ("float32", "float64"), "matmul_topk")
+
+    helper = LayerHelper("matmul_topk", **locals())
+    values = helper.create_variable_for_type_inference(dtype=x.dtype)
+    indices = helper.create_variable_for_type_inference(dtype="int64")
+    helper.append_op(
+        type="matmul_topk",
+        inputs={"x": x, "y": y},
+        outputs={"out": values, "indices": indices},
+        attrs={"k": k, "largest": largest},
+    )
+    return values, indices
@@ -377,10 +377,35 @@ class TensorVariable(VariableBase):
     @check_guard
     def make_stringify_guard(self) -> list[StringifyExpression]:
         frame_value_tracer = self.tracker.trace_value_from_frame()
+        guard_str = self.origin_meta.guard_str()
+
+        if isinstance(
+            self.origin_meta.dtype, paddle.base.core.VarDesc.VarType
+        ):
+            # The meta is checked in C++, with the guard string as the
+            # fallback of the values out of its fast path.
+            guard_name = f"__tensor_meta_guard_{self.id}"
+            meta_guard = paddle.framework.core.TensorMetaMatchGuard(
+                self.origin_meta.shape,
+                self.origin_meta.dtype,
+                self.origin_meta.stop_gradient,
+                lambda value: MetaInfo.from_tensor(value).guard_str()
+                == guard_str,
+            )
+            return [
+                StringifyExpression(
+                    f"{guard_name}({{}})",
+                    [frame_value_tracer],
+                    union_free_vars(
+                        {guard_name: meta_guard},
+                        frame_value_tracer.free_vars,
+                    ),
+                )
+            ]
 
         return [
             StringifyExpression(
-                f"MetaInfo.from_tensor({{}}).guard_str() == '{self.origin_meta.guard_str()}'",
+                f"MetaInfo.from_tensor({{}}).guard_str() == '{guard_str}'",
                 [frame_value_tracer],
                 union_free_vars(
                     {"MetaInfo": MetaInfo},
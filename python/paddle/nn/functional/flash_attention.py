@@ -439,6 +439,187 @@ def flash_attn_unpadded(
     return out, softmax if return_softmax else None
 
 
+def flash_attn_local(
+    query,
+    key,
+    value,
+    window_size=(-1, -1),
+    alibi_slopes=None,
+    causal=False,
+    scale=None,
+    cu_seqlens_q=None,
+    cu_seqlens_k=None,
+    name=None,
+):
+    r"""
+    The local attention, where the query ``i`` only attends to the keys ``j``
+    of the sliding window
+    ``i + seqlen_k - seqlen_q - window_size[0] <= j <= i + seqlen_k - seqlen_q + window_size[1]``.
+    The ALiBi bias ``-alibi_slopes[h] * |i + seqlen_k - seqlen_q - j|`` is
+    added to the scores of the head ``h``. The key and value may have less
+    heads than the query for the grouped query attention. The scores are
+    computed by tiles with the online softmax and never materialized.
+
+    Args:
+        query(Tensor): The query tensor of [batch_size, seq_len, num_heads, head_dim],
+                        or the packed [total_seq_len, num_heads, head_dim] with cu_seqlens_q.
+                        The dtype can be float32, float16 or bfloat16.
+        key(Tensor): The key tensor of [batch_size, seq_len, num_heads_k, head_dim],
+                        or the packed [total_seq_len, num_heads_k, head_dim] with cu_seqlens_k.
+        value(Tensor): The value tensor of the same shape as key.
+        window_size(tuple, optional): The (left, right) size of the sliding window,
+                        -1 means unlimited. Default is (-1, -1).
+        alibi_slopes(Tensor, optional): The float32 ALiBi slopes of [num_heads].
+        causal(bool): Whether enable causal mode, i.e. the right window size is 0.
+        scale(float, optional): The scaling of QK^T, 1 / sqrt(head_dim) by default.
+        cu_seqlens_q(Tensor, optional): The int32 cumulative sequence lengths of the packed query.
+        cu_seqlens_k(Tensor, optional): The int32 cumulative sequence lengths of the packed key and value.
+        name(str, optional): The default value is None. Normally there is no need for user
+                        to set this property. For more information, please refer to
+                        :ref:`api_guide_Name`.
+
+    Returns:
+        out(Tensor): The attention tensor of the same shape as query.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +SKIP('flash_attn_local need GPU')
+            >>> import paddle
+            >>> q = paddle.rand((1, 128, 8, 16), dtype='float16')
+            >>> kv = paddle.rand((1, 128, 2, 16), dtype='float16')
+            >>> output = paddle.nn.functional.flash_attention.flash_attn_local(
+            ...     q, kv, kv, window_size=(32, 0)
+            ... )
+            >>> # doctest: -SKIP
+    """
+    window_size_left, window_size_right = window_size
+    scale = 0.0 if scale is None else scale
+    if in_dynamic_or_pir_mode():
+        return _C_ops.flash_attn_local(
+            query,
+            key,
+            value,
+            cu_seqlens_q,
+            cu_seqlens_k,
+            alibi_slopes,
+            window_size_left,
+            window_size_right,
+            causal,
+            scale,
+        )
+
+    helper = LayerHelper('flash_attn_local', **locals())
+    dtype = helper.input_dtype(input_param_name='q')
+    out = helper.create_variable_for_type_inference(dtype)
+    softmax_lse = helper.create_variable_for_type_inference(paddle.float32)
+    inputs = {
+        'q': query,
+        'k': key,
+        'v': value,
+        'cu_seqlens_q': cu_seqlens_q,
+        'cu_seqlens_k': cu_seqlens_k,
+        'alibi_slopes': alibi_slopes,
+    }
+    helper.append_op(
+        type='flash_attn_local',
+        inputs=inputs,
+        outputs={'out': out, 'softmax_lse': softmax_lse},
+        attrs={
+            'window_size_left': window_size_left,
+            'window_size_right': window_size_right,
+            'causal': causal,
+            'scale': scale,
+        },
+    )
+    return out
+
+
+def flash_attn_kv_cache(
+    query,
+    key,
+    value,
+    cache_k,
+    cache_v,
+    seq_lens,
+    window_size_left=-1,
+    alibi_slopes=None,
+    scale=None,
+    name=None,
+):
+    r"""
+    The decoding attention on a kv cache. The new key and value are appended
+    to the cache in place after the first ``seq_lens[b]`` tokens of the batch
+    ``b``, and the query attends to the cached keys causally. The seq_lens is
+    not updated, and the tokens beyond the capacity of the cache are dropped.
+
+    Args:
+        query(Tensor): The query tensor of [batch_size, seq_len, num_heads, head_dim].
+        key(Tensor): The new key of [batch_size, seq_len, num_heads_k, head_dim].
+        value(Tensor): The new value of the same shape as key.
+        cache_k(Tensor): The key cache of [batch_size, max_seq_len, num_heads_k, head_dim].
+        cache_v(Tensor): The value cache of the same shape as cache_k.
+        seq_lens(Tensor): The int32 lengths of [batch_size] of the cache before appending.
+        window_size_left(int, optional): The size of the sliding window, -1 means unlimited.
+        alibi_slopes(Tensor, optional): The float32 ALiBi slopes of [num_heads].
+        scale(float, optional): The scaling of QK^T, 1 / sqrt(head_dim) by default.
+        name(str, optional): The default value is None. Normally there is no need for user
+                        to set this property. For more information, please refer to
+                        :ref:`api_guide_Name`.
+
+    Returns:
+        out(Tensor): The attention tensor of the same shape as query.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +SKIP('flash_attn_kv_cache need GPU')
+            >>> import paddle
+            >>> q = paddle.rand((2, 1, 8, 16), dtype='float16')
+            >>> kv = paddle.rand((2, 1, 2, 16), dtype='float16')
+            >>> cache = paddle.zeros((2, 64, 2, 16), dtype='float16')
+            >>> lens = paddle.to_tensor([3, 7], dtype='int32')
+            >>> output = paddle.nn.functional.flash_attention.flash_attn_kv_cache(
+            ...     q, kv, kv, cache, cache.clone(), lens
+            ... )
+            >>> # doctest: -SKIP
+    """
+    scale = 0.0 if scale is None else scale
+    if in_dynamic_or_pir_mode():
+        out, _, _ = _C_ops.flash_attn_kv_cache_(
+            query,
+            key,
+            value,
+            cache_k,
+            cache_v,
+            seq_lens,
+            alibi_slopes,
+            window_size_left,
+            scale,
+        )
+        return out
+
+    helper = LayerHelper('flash_attn_kv_cache', **locals())
+    dtype = helper.input_dtype(input_param_name='q')
+    out = helper.create_variable_for_type_inference(dtype)
+    inputs = {
+        'q': query,
+        'k': key,
+        'v': value,
+        'cache_k': cache_k,
+        'cache_v': cache_v,
+        'seq_lens': seq_lens,
+        'alibi_slopes': alibi_slopes,
+    }
+    helper.append_op(
+        type='flash_attn_kv_cache',
+        inputs=inputs,
+        outputs={'out': out, 'cache_k_out': cache_k, 'cache_v_out': cache_v},
+        attrs={'window_size_left': window_size_left, 'scale': scale},
+    )
+    return out
+
+
 def scaled_dot_product_attention(
     query,
     key,
@@ -29,6 +29,7 @@ from .quant_layers import QuantStub  # noqa: F401
 from .quantized_linear import (  # noqa: F401
     apply_per_channel_scale,
     llm_int8_linear,
+    w8a8_linear,
     weight_dequantize,
     weight_only_linear,
     weight_quantize,
@@ -39,6 +40,7 @@ __all__ = [
     "Stub",
     "weight_only_linear",
     "llm_int8_linear",
+    "w8a8_linear",
     "weight_quantize",
     "weight_dequantize",
 ]
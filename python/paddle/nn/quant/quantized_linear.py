@@ -21,6 +21,7 @@ from paddle.framework import (
     in_dynamic_mode,
     in_dynamic_or_pir_mode,
 )
+from paddle.tensor.search import index_select
 
 
 def _get_arch_info():
@@ -157,6 +158,7 @@ def weight_only_linear(
     weight_dtype="int8",
     arch=None,
     group_size=-1,
+    act_order_perm=None,
 ):
     """
     Applies matrix multiplication of two tensors and then bias addition if provided.
@@ -171,6 +173,7 @@ def weight_only_linear(
         weight_dtype(str): The dtype of  weight Tensor, must be one of 'int8', 'int4', Defaulted to 'int8'.
         arch (int): The compute arch for target device. For example, A100 is 80, v100 is 70, if you do not assign arch, we will get arch from your device, default: None.
         group_size (int): The group size for weight quantization. -1 stands for default per-channel mode. Currently only support 64 or 128.
+        act_order_perm (Tensor|None): The int32 or int64 permutation of the in_features of an act-order (GPTQ desc_act) checkpoint, whose weight rows are quantized in the order of the permutation, so that the rows of a group are contiguous. If it is not None, the last dim of x is permuted in the same order before the multiplication. Default: None.
     Returns:
         Tensor: the output Tensor, the data type is the same as that of x.
 
@@ -200,6 +203,9 @@ def weight_only_linear(
         group_size == -1 or group_size == 64 or group_size == 128
     ), f"Currently weight_quantize only support group size of -1, 64 or 128. but got {group_size} "
 
+    if act_order_perm is not None:
+        x = index_select(x, act_order_perm, axis=-1)
+
     if in_dynamic_mode():
         out = _C_ops.weight_only_linear(
             x, weight, bias, weight_scale, weight_dtype, arch, group_size
@@ -303,6 +309,82 @@ def llm_int8_linear(
         return out
 
 
+def w8a8_linear(
+    x,
+    weight,
+    bias=None,
+    weight_scale=None,
+    smooth=None,
+    act_method="",
+):
+    """
+    Applies the int8 matrix multiplication of the activations quantized per token and the weight
+    quantized per channel, then the dequantization, the bias addition and the activation in one epilogue.
+    The activations are quantized dynamically by the abs max of every token, after being multiplied by
+    the SmoothQuant factors if smooth is provided. This method requires CUDA version >= 11.2.
+
+    Args:
+        x (Tensor): the first input Tensor to be multiplied, the data type is float16 or bfloat16.
+        weight (Tensor): the int8 weight of shape [out_features, in_features], quantized by weight_quantize of
+            the llm.int8 algo.
+        bias (Tensor|None): the input bias Tensor. If it is None, no bias addition would
+            be performed. Otherwise, the bias is added to the matrix multiplication result.
+        weight_scale (Tensor|None): the per channel scale Tensor of the weight for dequantization. Its rank must be 1.
+        smooth (Tensor|None): the per channel SmoothQuant factors the activations are multiplied by before the
+            quantization, as in apply_per_channel_scale. Its rank must be 1.
+        act_method (str): the activation after the bias addition, one of '', 'gelu', 'relu' and 'swish'.
+
+    Returns:
+        Tensor: the output Tensor, the data type is the same as that of x.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +SKIP('No testing required')
+            >>> import paddle
+            >>> from paddle.nn.quant import w8a8_linear, weight_quantize
+
+            >>> x = paddle.cast(paddle.randn([1, 2, 64]), dtype='float16')
+            >>> weight = paddle.cast(paddle.randn([64, 32]), dtype='float16')
+            >>> weight, scale = weight_quantize(weight, algo='llm.int8')
+            >>> bias = paddle.cast(paddle.randn([32]), dtype='float16')
+            >>> if paddle.device.cuda.get_device_capability()[0] >= 8:
+            ...    out = w8a8_linear(x, weight, bias=bias, weight_scale=scale, act_method='gelu')
+            ...    print(out.shape)
+            [1, 2, 32]
+    """
+    if in_dynamic_or_pir_mode():
+        out = _C_ops.w8a8_linear(
+            x, weight, bias, weight_scale, smooth, act_method
+        )
+        return out
+    else:
+        type = "w8a8_linear"
+        helper = LayerHelper(type, **locals())
+        dtype = x.dtype
+
+        inputs = {
+            'x': [x],
+            'weight': [weight],
+            'weight_scale': [weight_scale],
+        }
+        if bias is not None:
+            inputs["bias"] = [bias]
+        if smooth is not None:
+            inputs["smooth"] = [smooth]
+        attrs = {'act_method': act_method}
+
+        out = helper.create_variable_for_type_inference(dtype)
+
+        helper.append_op(
+            type=type,
+            inputs=inputs,
+            outputs={'out': out},
+            attrs=attrs,
+        )
+        return out
+
+
 def apply_per_channel_scale(x, scales):
     """
     Apply pre-quant per channel scale on activations
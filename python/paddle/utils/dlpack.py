@@ -20,11 +20,41 @@ from ..base.framework import in_dygraph_mode
 
 __all__ = [
     'to_dlpack',
+    'to_dlpack_list',
     'from_dlpack',
 ]
 
+# The device types of DLPack.
+_DL_CPU = 1
+_DL_CUDA = 2
+_DL_CUDA_HOST = 3
+_DL_ROCM = 10
 
-def to_dlpack(x):
+
+def _get_dense_tensor(x, name):
+    if in_dygraph_mode():
+        if not isinstance(x, (paddle.Tensor, paddle.base.core.eager.Tensor)):
+            raise TypeError(
+                f"The type of '{name}' in to_dlpack must be paddle.Tensor,"
+                f" but received {type(x)}."
+            )
+        return x.value().get_tensor()
+    check_type(x, name, (LoDTensor), 'to_dlpack')
+    return x
+
+
+def _current_stream_handle(device_id):
+    # The current stream of paddle on the device, by the stream argument of
+    # __dlpack__, where 1 is the legacy default stream of CUDA.
+    stream = paddle.device.current_stream(
+        paddle.CUDAPlace(device_id)
+    ).stream_base.cuda_stream
+    if stream == 0 and not paddle.is_compiled_with_rocm():
+        return 1
+    return stream
+
+
+def to_dlpack(x, stream=None):
     """
     Encodes a tensor to DLPack.
 
@@ -32,6 +62,10 @@ def to_dlpack(x):
         x (Tensor): The input tensor, and the data type can be `bool`, `float16`, `float32`,
                     `float64`, `int8`, `int16`, `int32`, `int64`, `uint8`, `complex64`,
                     `complex128`.
+        stream (int, optional): The stream of the consumer by the ``__dlpack__`` protocol,
+                                which waits for the producer of ``x`` on the device without a
+                                device sync. 1 and 2 are the legacy and the per-thread default
+                                streams of CUDA. None does no synchronization. Default: None.
 
     Returns:
         dltensor, and the data type is PyCapsule.
@@ -49,25 +83,47 @@ def to_dlpack(x):
             <capsule object "dltensor" at 0x7f6103c681b0>
     """
 
-    if in_dygraph_mode():
-        if not isinstance(x, (paddle.Tensor, paddle.base.core.eager.Tensor)):
-            raise TypeError(
-                "The type of 'x' in to_dlpack must be paddle.Tensor,"
-                f" but received {type(x)}."
-            )
+    return _get_dense_tensor(x, 'x')._to_dlpack(
+        stream=-1 if stream is None else stream
+    )
 
-        return x.value().get_tensor()._to_dlpack()
 
-    check_type(x, 'x', (LoDTensor), 'to_dlpack')
-    return x._to_dlpack()
+def to_dlpack_list(xs, stream=None):
+    """
+    Encodes a list of tensors to DLPack. The consumer stream waits for all the
+    tensors by a single event, rather than a sync per tensor.
+
+    Args:
+        xs (list[Tensor]): The input tensors, on one device.
+        stream (int, optional): The stream of the consumer, the same as ``stream`` of
+                                :ref:`api_paddle_utils_dlpack_to_dlpack`. Default: None.
+
+    Returns:
+        list[PyCapsule], the dltensors of the tensors.
+
+    Examples:
+        .. code-block:: python
+
+            >>> import paddle
+            >>> xs = [paddle.ones([2]), paddle.zeros([3])]
+            >>> dlpacks = paddle.utils.dlpack.to_dlpack_list(xs)
+            >>> print(len(dlpacks))
+            2
+    """
+    tensors = [_get_dense_tensor(x, 'xs') for x in xs]
+    return paddle.base.core._to_dlpack_list(
+        tensors, stream=-1 if stream is None else stream
+    )
 
 
 def from_dlpack(dlpack):
     """
-    Decodes a DLPack to a tensor.
+    Decodes a DLPack to a tensor, sharing the data without a copy.
 
     Args:
-        dlpack (PyCapsule): a PyCapsule object with the dltensor.
+        dlpack (PyCapsule|object): a PyCapsule object with the dltensor, or an object of
+                                   the other frameworks with ``__dlpack__``, which is asked
+                                   to order its data before the current stream of paddle.
 
     Returns:
         out (Tensor), a tensor decoded from DLPack. One thing to be noted, if we get
@@ -89,6 +145,16 @@ def from_dlpack(dlpack):
                     [0.10000000, 0.20000000, 0.60000002, 0.69999999]])
     """
 
+    if hasattr(dlpack, '__dlpack__'):
+        device_type, device_id = dlpack.__dlpack_device__()
+        stream = None
+        if device_type in (_DL_CUDA, _DL_ROCM):
+            stream = _current_stream_handle(device_id)
+        try:
+            dlpack = dlpack.__dlpack__(stream=stream, max_version=(1, 0))
+        except TypeError:
+            dlpack = dlpack.__dlpack__(stream=stream)
+
     t = type(dlpack)
     dlpack_flag = t.__module__ == 'builtins' and t.__name__ == 'PyCapsule'
     if not dlpack_flag:
@@ -99,7 +165,7 @@ def from_dlpack(dlpack):
 
     if in_dygraph_mode():
         out = paddle.base.core.from_dlpack(dlpack)
-        out = paddle.to_tensor(out)
+        out = paddle.to_tensor(out, place=out._place())
         return out
 
     out = paddle.base.core.from_dlpack(dlpack)
@@ -0,0 +1,99 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+
+import numpy as np
+
+import paddle
+import paddle.distributed as dist
+
+
+class TestReshardElastic:
+    def __init__(self):
+        self._shape = eval(os.getenv("shape"))
+        self._dtype = os.getenv("dtype")
+        self._seeds = eval(os.getenv("seeds"))
+        self._backend = os.getenv("backend")
+
+    def test_scale_up(self):
+        paddle.seed(self._seeds)
+        value = paddle.uniform(self._shape, self._dtype)
+
+        in_mesh = dist.ProcessMesh([0], dim_names=["x"])
+        input_tensor = dist.shard_tensor(value, in_mesh, [dist.Shard(1)])
+
+        out_mesh = dist.ProcessMesh([0, 1], dim_names=["x"])
+        out = dist.reshard(input_tensor, out_mesh, [dist.Shard(0)])
+
+        expected = paddle.split(value, num_or_sections=2, axis=0)
+        np.testing.assert_equal(
+            out._local_value().numpy(), expected[dist.get_rank()].numpy()
+        )
+
+    def test_diff_nd_mesh_shard(self):
+        paddle.seed(self._seeds)
+        value = paddle.uniform(self._shape, self._dtype)
+
+        in_mesh = dist.ProcessMesh([0, 1], dim_names=["x"])
+        input_tensor = dist.shard_tensor(value, in_mesh, [dist.Shard(0)])
+
+        out_mesh_list = [[1], [0]]
+        out_mesh = dist.ProcessMesh(out_mesh_list, dim_names=["x", "y"])
+        out = dist.reshard(
+            input_tensor, out_mesh, [dist.Shard(1), dist.Replicate()]
+        )
+
+        index = [row[0] for row in out_mesh_list].index(dist.get_rank())
+        expected = paddle.split(value, num_or_sections=2, axis=1)
+        np.testing.assert_equal(
+            out._local_value().numpy(), expected[index].numpy()
+        )
+
+    def test_reshard_state_dict(self):
+        paddle.seed(self._seeds)
+        old_mesh = dist.ProcessMesh([[0, 1]], dim_names=["x", "y"])
+        layer = paddle.nn.Linear(self._shape[-1], self._shape[-1])
+        expected = {
+            key: tensor.numpy() for key, tensor in layer.state_dict().items()
+        }
+        state_dict = {
+            key: dist.shard_tensor(
+                tensor, old_mesh, [dist.Replicate(), dist.Shard(0)]
+            )
+            for key, tensor in layer.state_dict().items()
+        }
+
+        new_mesh = dist.ProcessMesh([1, 0], dim_names=["x"])
+        dist.reshard_state_dict(
+            state_dict, new_mesh, lambda key, tensor: [dist.Shard(0)]
+        )
+        for key, tensor in state_dict.items():
+            # The tensors are resharded in place.
+            assert tensor.process_mesh == new_mesh
+            np.testing.assert_equal(
+                dist.unshard_dtensor(tensor).numpy(), expected[key]
+            )
+
+    def run_test_case(self):
+        if self._backend == "cpu":
+            paddle.set_device("cpu")
+
+        self.test_scale_up()
+        self.test_diff_nd_mesh_shard()
+        self.test_reshard_state_dict()
+
+
+if __name__ == '__main__':
+    TestReshardElastic().run_test_case()
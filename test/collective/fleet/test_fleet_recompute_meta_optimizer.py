@@ -40,6 +40,27 @@ class TestFleetRecomputeMetaOptimizer(TestFleetMetaOptimizer):
         ]
         self.assertIn('subprog', ''.join(outs))
 
+    def test_recompute_optimizer_memory_budget(self):
+        """test recompute optimizer with the planned checkpoints"""
+        train_prog, startup_prog = base.Program(), base.Program()
+        avg_cost, strategy = self.net(train_prog, startup_prog)
+
+        strategy.recompute = True
+        strategy.recompute_configs = {
+            "memory_budget_mb": 0.01,
+            "batch_size": 32,
+        }
+        opt = paddle.optimizer.Momentum(learning_rate=0.001, momentum=0.9)
+        opt = RecomputeOptimizer(opt)
+        opt.user_defined_strategy = strategy
+        params_grads = opt.backward(avg_cost, startup_prog)
+
+        self.assertTrue(len(opt.wrapped_opt._checkpoints) > 0)
+        outs = [
+            name for op in avg_cost.block.ops for name in op.output_arg_names
+        ]
+        self.assertIn('subprog', ''.join(outs))
+
     def test_recompute_optimizer_backward_gradients(self):
         """test recompute optimizer backward + gradients"""
         train_prog, startup_prog = base.Program(), base.Program()
@@ -84,6 +84,26 @@ class TestProcessGroupFp32(unittest.TestCase):
 
         print("test allreduce max api ok")
 
+        # test allreduce sum by the shared memory, of several chunks
+        paddle.set_flags({'FLAGS_gloo_shm_allreduce_min_bytes': 1})
+        x = np.random.random((3, 1 << 18)).astype(self.dtype)
+        tensor_x = paddle.to_tensor(x)
+        y = np.random.random((3, 1 << 18)).astype(self.dtype)
+        tensor_y = paddle.to_tensor(y)
+
+        sum_result = x + y
+        if rank == 0:
+            task = pg.allreduce(tensor_x)
+            task.wait()
+            np.testing.assert_allclose(tensor_x, sum_result)
+        else:
+            task = pg.allreduce(tensor_y)
+            task.wait()
+            np.testing.assert_allclose(tensor_y, sum_result)
+        paddle.set_flags({'FLAGS_gloo_shm_allreduce_min_bytes': 0})
+
+        print("test allreduce sum by shared memory api ok")
+
         # test broadcast
         # rank 0
         x = np.random.random(self.shape).astype(self.dtype)
@@ -0,0 +1,83 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_planner.h"
+
+#include "gtest/gtest.h"
+
+#include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
+
+namespace phi {
+namespace distributed {
+namespace tests {
+
+static TensorDistAttr MakeDistAttr(const std::vector<int64_t>& dims_mapping,
+                                   const std::vector<int64_t>& partial_dims) {
+  ProcessMesh mesh({2, 2}, {0, 1, 2, 3}, {"x", "y"});
+  TensorDistAttr dist_attr(std::vector<int64_t>{8, 8});
+  dist_attr.set_process_mesh(mesh);
+  dist_attr.set_dims_mapping(dims_mapping);
+  if (!partial_dims.empty()) {
+    dist_attr.set_partial_status(partial_dims);
+  }
+  return dist_attr;
+}
+
+TEST(reshard_planner, s_to_s_by_all_to_all) {
+  auto steps = PlanNdMeshReshard(
+      DDim({8, 8}), MakeDistAttr({0, -1}, {}), MakeDistAttr({-1, 0}, {}));
+  ASSERT_EQ(steps.size(), 1UL);
+  EXPECT_EQ(steps[0].mesh_axis, 0);
+  EXPECT_EQ(steps[0].in_status, 0);
+  EXPECT_EQ(steps[0].out_status, 1);
+  // a rank keeps 32 elements and sends half of them
+  EXPECT_DOUBLE_EQ(steps[0].comm_volume, 16.0);
+}
+
+TEST(reshard_planner, p_to_s_by_reduce_scatter) {
+  auto steps = PlanNdMeshReshard(
+      DDim({8, 8}), MakeDistAttr({-1, 1}, {0}), MakeDistAttr({0, 1}, {}));
+  ASSERT_EQ(steps.size(), 1UL);
+  EXPECT_EQ(steps[0].mesh_axis, 0);
+  EXPECT_EQ(steps[0].in_status, kReshardPartial);
+  EXPECT_EQ(steps[0].out_status, 0);
+  EXPECT_DOUBLE_EQ(steps[0].comm_volume, 16.0);
+}
+
+TEST(reshard_planner, swap_shard_axes) {
+  auto steps = PlanNdMeshReshard(
+      DDim({8, 8}), MakeDistAttr({0, 1}, {}), MakeDistAttr({1, 0}, {}));
+  double volume = 0.0;
+  for (const auto& step : steps) {
+    volume += step.comm_volume;
+  }
+  // an all-gather of 16 elements, then an all-to-all of 32 elements, the
+  // replication of both axes would take 16 + 32 elements before the slices
+  ASSERT_EQ(steps.size(), 3UL);
+  EXPECT_DOUBLE_EQ(volume, 32.0);
+}
+
+TEST(reshard_planner, keep_partial) {
+  auto steps = PlanNdMeshReshard(
+      DDim({8, 8}), MakeDistAttr({-1, -1}, {0}), MakeDistAttr({1, -1}, {0}));
+  ASSERT_EQ(steps.size(), 1UL);
+  EXPECT_EQ(steps[0].mesh_axis, 1);
+  EXPECT_EQ(steps[0].in_status, kReshardReplicated);
+  EXPECT_EQ(steps[0].out_status, 0);
+  EXPECT_DOUBLE_EQ(steps[0].comm_volume, 0.0);
+}
+
+}  // namespace tests
+}  // namespace distributed
+}  // namespace phi
@@ -12,6 +12,7 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include "paddle/phi/core/distributed/auto_parallel/dist_cache.h"
 #include "test/cpp/auto_parallel/spmd_rule_test_util.h"
 
 namespace paddle {
@@ -57,6 +58,41 @@ TEST(Tile, Ctor) {
   check_dim_mapping(backward_spmd_info.second[0], {-1, -1, 1});
   check_partial_dims(backward_spmd_info.second[0], {0});
 }
+
+TEST(Tile, CachedInferSpmd) {
+  ProcessMesh process_mesh({2, 2}, {0, 1, 2, 3}, {"x", "y"});
+  TensorDistAttr t_dist_attr = TensorDistAttr();
+  t_dist_attr.set_process_mesh(process_mesh);
+  t_dist_attr.set_dims_mapping({0, -1, 1});
+  t_dist_attr.set_dynamic_dims({false, false, false});
+  phi::distributed::DistMetaTensor x = phi::distributed::DistMetaTensor(
+      common::make_ddim({6, 8, 10}), t_dist_attr);
+  std::vector<int64_t> repeat_times = {2, 2, 1, 1};
+
+  int num_inferred = 0;
+  auto infer_spmd = [&]() {
+    ++num_inferred;
+    return phi::distributed::TileInferSpmd(x, repeat_times);
+  };
+  auto spmd_info = phi::distributed::CachedInferSpmd(
+      "TileInferSpmd", infer_spmd, x, repeat_times);
+  auto cached_spmd_info = phi::distributed::CachedInferSpmd(
+      "TileInferSpmd", infer_spmd, x, repeat_times);
+  EXPECT_EQ(num_inferred, 1);
+  check_dim_mapping(cached_spmd_info.first[0], {-1, -1, 1});
+  check_dim_mapping(cached_spmd_info.second[0], {-1, -1, -1, 1});
+  EXPECT_EQ(PADDLE_GET_CONST(TensorDistAttr, spmd_info.second[0]),
+            PADDLE_GET_CONST(TensorDistAttr, cached_spmd_info.second[0]));
+
+  // Another placement of the input is inferred again.
+  t_dist_attr.set_dims_mapping({-1, 0, 1});
+  x = phi::distributed::DistMetaTensor(common::make_ddim({6, 8, 10}),
+                                       t_dist_attr);
+  spmd_info = phi::distributed::CachedInferSpmd(
+      "TileInferSpmd", infer_spmd, x, repeat_times);
+  EXPECT_EQ(num_inferred, 2);
+  check_dim_mapping(spmd_info.second[0], {-1, -1, 0, 1});
+}
 }  // namespace auto_parallel
 }  // namespace distributed
 }  // namespace paddle
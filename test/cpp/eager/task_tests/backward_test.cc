@@ -24,12 +24,14 @@
 #include "paddle/fluid/eager/autograd_meta.h"
 #include "paddle/fluid/eager/grad_node_info.h"
 #include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/flags.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_meta.h"
 #include "test/cpp/eager/test_utils.h"
 
 PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(add, CPU, ALL_LAYOUT);
+PHI_DECLARE_int32(eager_backward_num_threads);
 
 namespace egr {
 
@@ -232,7 +234,7 @@ Node0   Node1
   |      |
  inp0   inp1
 */
-TEST(Backward, WithAccumulation) {
+static void RunBackwardWithAccumulation() {
   // Prepare Device Contexts
   eager_test::InitEnv(paddle::platform::CPUPlace());
 
@@ -342,4 +344,12 @@ TEST(Backward, WithAccumulation) {
   eager_test::CompareGradTensorWithValue<float>(leaf_tensor, 2500.0);
 }
 
+TEST(Backward, WithAccumulation) { RunBackwardWithAccumulation(); }
+
+TEST(Backward, ParallelWithAccumulation) {
+  FLAGS_eager_backward_num_threads = 4;
+  RunBackwardWithAccumulation();
+  FLAGS_eager_backward_num_threads = 0;
+}
+
 }  // namespace egr
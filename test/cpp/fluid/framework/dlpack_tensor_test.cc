@@ -126,6 +126,32 @@ void TestMainLoop() {
     }
   }
 }
+TEST(dlpack, TensorFromDLPackNoCopy) {
+  phi::DenseTensor src;
+  src.Resize({2, 3});
+  float *data = src.mutable_data<float>(platform::CPUPlace());
+  for (int i = 0; i < 6; ++i) data[i] = static_cast<float>(i);
+
+  phi::DenseTensor dst;
+  TensorFromDLPackNoCopy(toDLPack(src), &dst);
+  CHECK_EQ(dst.data<float>(), data);
+  CHECK_EQ(dst.dims(), src.dims());
+  CHECK_EQ(dst.dtype(), phi::DataType::FLOAT32);
+
+  phi::DenseTensor versioned;
+  DLManagedTensorVersioned *dmt = toDLPackVersioned(src);
+  CHECK_EQ(dmt->version.major, kDLPackMajorVersion);
+  TensorFromDLPackNoCopy(dmt, &versioned);
+  CHECK_EQ(versioned.data<float>(), data);
+
+  // The managed tensors hold src, which outlives its own handle.
+  auto *holder = src.Holder().get();
+  src.clear();
+  dst.clear();
+  CHECK_EQ(versioned.data<float>(), holder->ptr());
+  CHECK_EQ(versioned.data<float>()[5], 5.0f);
+}
+
 TEST(dlpack, test_all) {
 #define TestCallback(cpp_type, proto_type) TestMainLoop<cpp_type>()
 
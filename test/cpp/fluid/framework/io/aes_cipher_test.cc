@@ -115,5 +115,37 @@ TEST_F(AESTest, encrypt_to_file) {
   }
 }
 
+TEST_F(AESTest, chunked) {
+  std::ofstream fout("aes_test.conf");
+  fout << "cipher_name : AES_GCM_NoPadding" << std::endl;
+  fout << "chunk_size : 100" << std::endl;
+  fout << "num_threads : 4" << std::endl;
+  fout.close();
+  auto cipher = CipherFactory::CreateCipher("aes_test.conf");
+  std::string plaintext(1050, 'a');
+  for (size_t i = 0; i < plaintext.size(); ++i) {
+    plaintext[i] = static_cast<char>(i % 251);
+  }
+  std::string ciphertext = cipher->Encrypt(plaintext, AESTest::key);
+  EXPECT_EQ(cipher->Decrypt(ciphertext, AESTest::key), plaintext);
+  EXPECT_EQ(cipher->Decrypt(cipher->Encrypt("", AESTest::key), AESTest::key),
+            "");
+
+  // A modified or truncated chunk fails the integrity check.
+  std::string modified = ciphertext;
+  modified[modified.size() / 2] ^= 1;
+  EXPECT_ANY_THROW(cipher->Decrypt(modified, AESTest::key));
+  EXPECT_ANY_THROW(cipher->Decrypt(
+      ciphertext.substr(0, ciphertext.size() - 1), AESTest::key));
+
+  // The unchunked ciphertext is still decrypted.
+  AESTest::GenConfigFile("AES_GCM_NoPadding");
+  auto unchunked = CipherFactory::CreateCipher("aes_test.conf");
+  EXPECT_EQ(cipher->Decrypt(unchunked->Encrypt(plaintext, AESTest::key),
+                            AESTest::key),
+            plaintext);
+  EXPECT_EQ(unchunked->Decrypt(ciphertext, AESTest::key), plaintext);
+}
+
 }  // namespace framework
 }  // namespace paddle
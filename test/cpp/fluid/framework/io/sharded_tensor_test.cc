@@ -0,0 +1,83 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/framework/io/sharded_tensor.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+
+namespace paddle {
+namespace framework {
+
+TEST(ShardedTensor, SaveLoad) {
+  std::string dir = "sharded_tensor_test_" + std::to_string(getpid());
+  phi::DenseTensor x;
+  x.Resize(common::make_ddim({1000, 8}));
+  float* data = reinterpret_cast<float*>(
+      x.mutable_data(phi::CPUPlace(), phi::DataType::FLOAT32));
+  for (int i = 0; i < 1000 * 8; ++i) {
+    // compressible rows then random rows
+    data[i] = i < 4000 ? static_cast<float>(i / 8) : 0.37f * i * i;
+  }
+  phi::LoD lod = {{0, 400, 1000}};
+  x.set_lod(lod);
+
+  ShardedTensorOptions options;
+  // 100 rows a chunk
+  options.chunk_bytes = 100 * 8 * sizeof(float);
+  options.thread_num = 4;
+  SaveShardedTensor(x, dir, options);
+
+  phi::DenseTensor y;
+  LoadShardedTensor(dir, &y, 3);
+  ASSERT_EQ(y.dims(), x.dims());
+  ASSERT_EQ(y.dtype(), x.dtype());
+  ASSERT_EQ(y.lod(), lod);
+  const float* y_data = reinterpret_cast<const float*>(y.data());
+  for (int i = 0; i < 1000 * 8; ++i) {
+    ASSERT_EQ(y_data[i], data[i]);
+  }
+
+  phi::DenseTensor z;
+  LoadShardedTensorRows(dir, 150, 420, &z, 2);
+  ASSERT_EQ(z.dims(), common::make_ddim({270, 8}));
+  const float* z_data = reinterpret_cast<const float*>(z.data());
+  for (int i = 0; i < 270 * 8; ++i) {
+    ASSERT_EQ(z_data[i], data[150 * 8 + i]);
+  }
+  ASSERT_ANY_THROW(LoadShardedTensorRows(dir, 900, 1001, &z, 2));
+
+  // a damaged chunk is detected
+  std::string chunk = dir + "/chunk_00007";
+  FILE* fp = fopen(chunk.c_str(), "r+");
+  ASSERT_NE(fp, nullptr);
+  fputc(0x5a, fp);
+  fclose(fp);
+  ASSERT_ANY_THROW(LoadShardedTensor(dir, &y, 3));
+  ASSERT_NO_THROW(LoadShardedTensorRows(dir, 0, 700, &z, 2));
+
+  for (int i = 0; i < 10; ++i) {
+    char name[32];
+    snprintf(name, sizeof(name), "/chunk_%05d", i);
+    unlink((dir + name).c_str());
+  }
+  unlink((dir + "/" + kShardedTensorManifest).c_str());
+  rmdir(dir.c_str());
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,45 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/new_executor/interpreter/interpreter_util.h"
+
+TEST(CriticalPath, TestComputeCriticalPathRanks) {
+  using paddle::framework::interpreter::ComputeCriticalPathRanks;
+  // 0 -> 1 -> 3
+  // 0 -> 2 -> 3, 2 is expensive
+  // 4 is isolated
+  std::map<size_t, std::set<size_t>> downstream_map = {
+      {0, {1, 2}}, {1, {3}}, {2, {3}}};
+  std::vector<double> op_costs = {1.0, 1.0, 5.0, 2.0, 3.0};
+  std::vector<double> ranks =
+      ComputeCriticalPathRanks(downstream_map, op_costs);
+  ASSERT_EQ(ranks.size(), 5u);
+  EXPECT_DOUBLE_EQ(ranks[3], 2.0);
+  EXPECT_DOUBLE_EQ(ranks[2], 7.0);
+  EXPECT_DOUBLE_EQ(ranks[1], 3.0);
+  EXPECT_DOUBLE_EQ(ranks[0], 8.0);
+  EXPECT_DOUBLE_EQ(ranks[4], 3.0);
+}
+
+TEST(CriticalPath, TestCycleIsRejected) {
+  using paddle::framework::interpreter::ComputeCriticalPathRanks;
+  std::map<size_t, std::set<size_t>> downstream_map = {{0, {1}}, {1, {0}}};
+  std::vector<double> op_costs = {1.0, 1.0};
+  EXPECT_ANY_THROW(ComputeCriticalPathRanks(downstream_map, op_costs));
+}
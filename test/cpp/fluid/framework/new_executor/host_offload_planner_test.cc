@@ -0,0 +1,72 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/new_executor/interpreter/host_offload.h"
+
+using paddle::framework::interpreter::HostOffloadPlanner;
+using paddle::framework::interpreter::OffloadAction;
+using paddle::framework::interpreter::OffloadCandidate;
+
+TEST(HostOffloadPlanner, TestOnlyLongGapsAreOffloaded) {
+  // var 0 is used by the forward op 2 and the backward op 30, var 1 is used
+  // by two ops close to each other
+  std::vector<OffloadCandidate> candidates = {{0, {2, 30}, false},
+                                              {1, {5, 8}, false}};
+  auto actions = HostOffloadPlanner(8, 4).Plan(candidates, 40);
+  ASSERT_EQ(actions.size(), 1u);
+  EXPECT_EQ(actions[0].var_id, 0u);
+  EXPECT_EQ(actions[0].offload_after, 2u);
+  EXPECT_EQ(actions[0].prefetch_before, 26u);
+  EXPECT_EQ(actions[0].wait_before, 30u);
+  EXPECT_FALSE(actions[0].cross_run);
+}
+
+TEST(HostOffloadPlanner, TestPrefetchNotBeforeOffload) {
+  std::vector<OffloadCandidate> candidates = {{0, {0, 10}, false}};
+  auto actions = HostOffloadPlanner(8, 16).Plan(candidates, 20);
+  ASSERT_EQ(actions.size(), 1u);
+  EXPECT_EQ(actions[0].prefetch_before, 1u);
+  EXPECT_EQ(actions[0].wait_before, 10u);
+}
+
+TEST(HostOffloadPlanner, TestPersistableAcrossRuns) {
+  // an optimizer state used by op 90 only, it is idle from op 91 of this run
+  // to op 89 of the next run
+  std::vector<OffloadCandidate> candidates = {{0, {90}, true}};
+  auto actions = HostOffloadPlanner(8, 4).Plan(candidates, 100);
+  ASSERT_EQ(actions.size(), 1u);
+  EXPECT_EQ(actions[0].offload_after, 90u);
+  EXPECT_EQ(actions[0].prefetch_before, 86u);
+  EXPECT_EQ(actions[0].wait_before, 90u);
+  EXPECT_TRUE(actions[0].cross_run);
+
+  // the prefetch wraps around to the end of this run
+  candidates = {{1, {2, 95}, true}};
+  actions = HostOffloadPlanner(4, 4).Plan(candidates, 100);
+  ASSERT_EQ(actions.size(), 2u);
+  EXPECT_FALSE(actions[0].cross_run);
+  EXPECT_TRUE(actions[1].cross_run);
+  EXPECT_EQ(actions[1].offload_after, 95u);
+  EXPECT_EQ(actions[1].prefetch_before, 98u);
+  EXPECT_EQ(actions[1].wait_before, 2u);
+}
+
+TEST(HostOffloadPlanner, TestShortRunNotOffloaded) {
+  std::vector<OffloadCandidate> candidates = {{0, {1, 3}, true}};
+  auto actions = HostOffloadPlanner(8, 4).Plan(candidates, 6);
+  EXPECT_TRUE(actions.empty());
+}
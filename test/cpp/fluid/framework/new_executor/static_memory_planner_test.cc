@@ -0,0 +1,59 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/new_executor/interpreter/static_memory_planner.h"
+
+using paddle::framework::interpreter::BufferLifetime;
+using paddle::framework::interpreter::StaticMemoryPlanner;
+
+TEST(StaticMemoryPlanner, TestSequentialBuffersShareMemory) {
+  // 0 -> 1 -> 2 -> 3, buffer i is written by op i and last read by op i + 1
+  auto happens_before = [](size_t prior, size_t posterior) {
+    return prior < posterior;
+  };
+  std::vector<BufferLifetime> buffers = {
+      {256, 0, {1}}, {200, 1, {2}}, {256, 2, {3}}};
+  std::vector<size_t> offsets;
+  size_t arena_size =
+      StaticMemoryPlanner(256).Plan(buffers, happens_before, &offsets);
+  ASSERT_EQ(offsets.size(), 3u);
+  // buffer 0 and buffer 2 never coexist
+  EXPECT_EQ(offsets[0], offsets[2]);
+  EXPECT_NE(offsets[0], offsets[1]);
+  EXPECT_EQ(arena_size, 512u);
+}
+
+TEST(StaticMemoryPlanner, TestConcurrentBuffersDoNotOverlap) {
+  // no dependency at all, every buffer may coexist with the others
+  auto happens_before = [](size_t, size_t) { return false; };
+  std::vector<BufferLifetime> buffers = {
+      {100, 0, {3}}, {300, 1, {3}}, {10, 2, {3}}};
+  std::vector<size_t> offsets;
+  size_t arena_size =
+      StaticMemoryPlanner(64).Plan(buffers, happens_before, &offsets);
+  ASSERT_EQ(offsets.size(), 3u);
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    EXPECT_EQ(offsets[i] % 64, 0u);
+    for (size_t j = i + 1; j < buffers.size(); ++j) {
+      bool disjoint = offsets[i] + buffers[i].size <= offsets[j] ||
+                      offsets[j] + buffers[j].size <= offsets[i];
+      EXPECT_TRUE(disjoint);
+    }
+  }
+  EXPECT_EQ(arena_size, 320u + 128u + 64u);
+}
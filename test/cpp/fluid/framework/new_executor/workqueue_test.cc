@@ -204,3 +204,34 @@ TEST(WorkQueue, TestWorkQueueGroup) {
   queue_group.reset();
   waiter_thread.join();
 }
+
+TEST(WorkQueue, TestWorkerStatistics) {
+  using paddle::framework::CreateMultiThreadedWorkQueue;
+  using paddle::framework::EventsWaiter;
+  using paddle::framework::WorkerStatistics;
+  using paddle::framework::WorkQueueOptions;
+  constexpr unsigned kTaskNum = 1000;
+  EventsWaiter events_waiter;
+  WorkQueueOptions options(/*name*/ "WorkerStatisticsForTesting",
+                           /*num_threads*/ 4,
+                           /*allow_spinning*/ true,
+                           /*always_spinning*/ false,
+                           /*track_task*/ true,
+                           /*detached*/ true,
+                           &events_waiter);
+  auto work_queue = CreateMultiThreadedWorkQueue(options);
+  std::atomic<unsigned> counter{0};
+  for (unsigned i = 0; i < kTaskNum; ++i) {
+    work_queue->AddTask([&counter]() { ++counter; });
+  }
+  EXPECT_EQ(events_waiter.WaitEvent(), paddle::framework::kQueueEmptyEvent);
+  EXPECT_EQ(counter.load(), kTaskNum);
+  std::vector<WorkerStatistics> stats = work_queue->GetWorkerStatistics();
+  EXPECT_EQ(stats.size(), 4u);
+  uint64_t executed = 0;
+  for (const auto& stat : stats) {
+    EXPECT_LE(stat.stolen_tasks, stat.executed_tasks);
+    executed += stat.executed_tasks;
+  }
+  EXPECT_EQ(executed, kTaskNum);
+}
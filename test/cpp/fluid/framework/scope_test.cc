@@ -14,6 +14,9 @@ limitations under the License. */
 
 #include "paddle/fluid/framework/scope.h"
 
+#include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 namespace paddle {
@@ -64,6 +67,34 @@ TEST(Scope, FindScope) {
   EXPECT_EQ(&s, ss.FindScope("a"));
 }
 
+TEST(Scope, Freeze) {
+  Scope s;
+  std::vector<Variable*> vars;
+  for (int i = 0; i < 100; ++i) {
+    vars.push_back(s.Var("param_" + std::to_string(i)));
+  }
+  s.Freeze();
+  EXPECT_TRUE(s.IsFrozen());
+
+  Scope& ss = s.NewScope();
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(vars[i], s.FindVar("param_" + std::to_string(i)));
+    EXPECT_EQ(vars[i], ss.FindVar("param_" + std::to_string(i)));
+  }
+  EXPECT_EQ(nullptr, s.FindVar("b"));
+  EXPECT_EQ(vars[0], s.Var("param_0"));
+
+  // The kid scopes shadow the variables of the frozen scope.
+  Variable* v = ss.Var("param_0");
+  EXPECT_NE(vars[0], v);
+  EXPECT_EQ(v, ss.FindVar("param_0"));
+  EXPECT_EQ(vars[0], s.FindVar("param_0"));
+
+  EXPECT_ANY_THROW(s.Var("b"));
+  EXPECT_ANY_THROW(s.EraseVars({"param_0"}));
+  EXPECT_ANY_THROW(s.Rename("param_0", "b"));
+}
+
 TEST(Scope, GetAllNames) {
   Scope s;
   Variable* v = s.Var("a");
@@ -0,0 +1,122 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/slot_record_file.h"
+
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace framework {
+
+TEST(SlotRecordFile, RoundTrip) {
+  std::string path =
+      "slot_record_file_test_" + std::to_string(getpid()) + ".slotbin";
+  ASSERT_TRUE(IsSlotRecordFile(path));
+  ASSERT_FALSE(IsSlotRecordFile(path + ".gz"));
+
+  std::vector<std::string> names = {"slot_a", "slot_b", "slot_c"};
+  SlotRecordFileWriter writer;
+  // 2 uint64 slots and 1 float slot, 3 instances a block
+  ASSERT_TRUE(writer.Open(path, names, 2, 1, 3));
+  for (uint32_t i = 0; i < 10; ++i) {
+    std::vector<uint64_t> uint64_values;
+    for (uint32_t k = 0; k < i % 4 + 1; ++k) {
+      uint64_values.push_back(i * 100 + k);
+    }
+    std::vector<uint32_t> uint64_offsets = {
+        0, 1, static_cast<uint32_t>(uint64_values.size())};
+    std::vector<float> float_values(i % 3, 0.5f * i);
+    std::vector<uint32_t> float_offsets = {
+        0, static_cast<uint32_t>(float_values.size())};
+    if (i == 7) {
+      // the slots are all empty
+      uint64_offsets.clear();
+      float_offsets.clear();
+    }
+    ASSERT_TRUE(writer.Append(i,
+                              i + 1,
+                              i + 2,
+                              "ins_" + std::to_string(i),
+                              uint64_offsets,
+                              uint64_values.data(),
+                              float_offsets,
+                              float_values.data()));
+  }
+  ASSERT_TRUE(writer.Close());
+
+  SlotRecordFileReader reader;
+  ASSERT_TRUE(reader.Open(path));
+  ASSERT_EQ(reader.slot_names(), names);
+  ASSERT_EQ(reader.uint64_slot_num(), 2U);
+  ASSERT_EQ(reader.float_slot_num(), 1U);
+  SlotRecordBlockView view;
+  uint32_t ins = 0;
+  int ret = 0;
+  std::string ins_id;
+  std::vector<uint64_t> uint64_values;
+  std::vector<float> float_values;
+  std::vector<uint32_t> offsets;
+  while ((ret = reader.Next(&view)) > 0) {
+    ASSERT_LE(view.ins_num, 3U);
+    for (uint32_t j = 0; j < view.ins_num; ++j, ++ins) {
+      ASSERT_EQ(view.search_id(j), ins);
+      ASSERT_EQ(view.rank(j), ins + 1);
+      ASSERT_EQ(view.cmatch(j), ins + 2);
+      view.ins_id(j, &ins_id);
+      ASSERT_EQ(ins_id, "ins_" + std::to_string(ins));
+
+      view.uint64_feasigns(j, &uint64_values, &offsets);
+      ASSERT_EQ(offsets.size(), 3U);
+      ASSERT_EQ(offsets[0], 0U);
+      if (ins == 7) {
+        ASSERT_TRUE(uint64_values.empty());
+      } else {
+        ASSERT_EQ(offsets[1], 1U);
+        ASSERT_EQ(uint64_values.size(), ins % 4 + 1);
+        for (size_t k = 0; k < uint64_values.size(); ++k) {
+          ASSERT_EQ(uint64_values[k], ins * 100 + k);
+        }
+      }
+
+      view.float_feasigns(j, &float_values, &offsets);
+      ASSERT_EQ(offsets.size(), 2U);
+      ASSERT_EQ(float_values.size(), ins == 7 ? 0U : ins % 3);
+      for (float value : float_values) {
+        ASSERT_EQ(value, 0.5f * ins);
+      }
+    }
+  }
+  ASSERT_EQ(ret, 0);
+  ASSERT_EQ(ins, 10U);
+  reader.Close();
+
+  // truncated file
+  ASSERT_EQ(truncate(path.c_str(), 100), 0);
+  ASSERT_TRUE(reader.Open(path));
+  while ((ret = reader.Next(&view)) > 0) {
+  }
+  ASSERT_EQ(ret, -1);
+  reader.Close();
+  unlink(path.c_str());
+
+  ASSERT_FALSE(reader.Open(path));
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -17,6 +17,7 @@ limitations under the License. */
 #include "gtest/gtest.h"
 #include "paddle/fluid/memory/allocation/allocator_facade.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/funcs/selected_rows_segments.h"
 
 TEST(selected_rows_functor, cpu_add) {
   paddle::platform::CPUPlace cpu_place;
@@ -431,6 +432,71 @@ TEST(selected_rows_functor, cpu_merge_add_multi_noduplicated) {
   }
 }
 
+TEST(selected_rows_functor, cpu_merge_add_sorted) {
+  paddle::platform::CPUPlace cpu_place;
+  phi::CPUContext ctx(cpu_place);
+  ctx.SetAllocator(paddle::memory::allocation::AllocatorFacade::Instance()
+                       .GetAllocator(cpu_place)
+                       .get());
+  int64_t height = 10;
+  int64_t row_numel = 4;
+
+  std::vector<int64_t> rows{7, 1, 9, 1, 7, 1};
+  std::unique_ptr<phi::SelectedRows> selected_rows{
+      new phi::SelectedRows(rows, height)};
+  auto* in_value = selected_rows->mutable_value();
+  auto* in_data = in_value->mutable_data<float>(
+      common::make_ddim({static_cast<int64_t>(rows.size()), row_numel}),
+      cpu_place);
+  // the value of the i-th input row is i
+  for (size_t i = 0; i < rows.size(); ++i) {
+    for (int64_t j = 0; j < row_numel; ++j) {
+      in_data[i * row_numel + j] = static_cast<float>(i);
+    }
+  }
+
+  std::unique_ptr<phi::SelectedRows> output{new phi::SelectedRows()};
+  phi::funcs::scatter::MergeAdd<phi::CPUContext, float> merge_add_functor;
+  merge_add_functor(ctx, *selected_rows, output.get(), true);
+
+  std::vector<int64_t> ret_rows{1, 7, 9};
+  std::vector<float> ret_values{1 + 3 + 5, 0 + 4, 2};
+  EXPECT_EQ(output->rows(), ret_rows);
+  EXPECT_EQ(output->value().dims(), common::make_ddim({3, row_numel}));
+  auto* out_data = output->value().data<float>();
+  for (size_t i = 0; i < ret_rows.size(); ++i) {
+    for (int64_t j = 0; j < row_numel; ++j) {
+      EXPECT_EQ(out_data[i * row_numel + j], ret_values[i]);
+    }
+  }
+}
+
+TEST(selected_rows_functor, cpu_build_row_segments) {
+  // more ids than the parallel threshold, in the descending order
+  int64_t num = phi::funcs::kRowSegmentsParallelThreshold * 3 + 5;
+  int64_t id_num = 1000;
+  std::vector<int64_t> ids(num);
+  for (int64_t i = 0; i < num; ++i) {
+    ids[i] = id_num - 1 - i % id_num;
+  }
+
+  phi::funcs::RowSegments segments;
+  phi::funcs::BuildRowSegments(ids.data(), num, &segments);
+
+  EXPECT_EQ(segments.size(), static_cast<size_t>(id_num));
+  EXPECT_EQ(segments.offsets.back(), num);
+  for (size_t i = 0; i < segments.size(); ++i) {
+    EXPECT_EQ(segments.rows[i], static_cast<int64_t>(i));
+    for (int64_t k = segments.begin(i); k < segments.end(i); ++k) {
+      EXPECT_EQ(ids[segments.order[k]], segments.rows[i]);
+      // the value rows of a segment keep their order
+      if (k > segments.begin(i)) {
+        EXPECT_LT(segments.order[k - 1], segments.order[k]);
+      }
+    }
+  }
+}
+
 TEST(selected_rows_functor, cpu_sum_to) {
   paddle::platform::CPUPlace cpu_place;
   phi::CPUContext ctx(cpu_place);
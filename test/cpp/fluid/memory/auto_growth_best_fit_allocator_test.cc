@@ -171,6 +171,38 @@ TEST(test_auto_growth_allocator, test_free_when_no_cache_hit) {
   TestFreeWhenNoCacheHit(true);
 }
 
+TEST(test_auto_growth_allocator, test_fragmentation_info) {
+  FLAGS_free_idle_chunk = false;
+  FLAGS_free_when_no_cache_hit = false;
+  auto recorded_allocator = std::make_shared<RecordedAllocator>();
+  size_t alignment = 1024;
+  size_t chunk_size = 16384;
+  auto ag_allocator = std::make_shared<AutoGrowthBestFitAllocator>(
+      recorded_allocator, alignment, chunk_size);
+  ag_allocator->SetOwner("test");
+
+  // the blocks are split from the end of the chunk:
+  // [free 12288][c 1024][b 2048][a 1024]
+  auto a = ag_allocator->Allocate(1024);
+  auto b = ag_allocator->Allocate(2048);
+  auto c = ag_allocator->Allocate(1024);
+  b.reset();
+
+  auto infos = AutoGrowthBestFitAllocator::CollectFragmentationInfo(
+      platform::CPUPlace());
+  ASSERT_EQ(infos.size(), 1UL);
+  const auto &info = infos[0];
+  EXPECT_EQ(info.owner, "test");
+  EXPECT_EQ(info.num_chunks, 1UL);
+  EXPECT_EQ(info.reserved_size, chunk_size);
+  EXPECT_EQ(info.allocated_size, 2048UL);
+  EXPECT_EQ(info.free_size, 14336UL);
+  EXPECT_EQ(info.largest_free_block, 12288UL);
+  ASSERT_EQ(info.free_block_histogram.size(), 14UL);
+  EXPECT_EQ(info.free_block_histogram[11], 1UL);
+  EXPECT_EQ(info.free_block_histogram[13], 1UL);
+}
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
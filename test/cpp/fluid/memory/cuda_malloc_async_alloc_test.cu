@@ -0,0 +1,99 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cuda.h>
+#include <cuda_runtime.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/memory/allocation/allocator_facade.h"
+#include "paddle/fluid/memory/memory.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/phi/core/stream.h"
+
+#if CUDA_VERSION >= 11020
+#include "paddle/fluid/memory/allocation/cuda_malloc_async_allocator.h"
+
+namespace paddle {
+namespace memory {
+
+__global__ void fill_kernel(int *x, int value, int n) {
+  int thread_num = gridDim.x * blockDim.x;
+  int thread_id = blockIdx.x * blockDim.x + threadIdx.x;
+  for (int i = thread_id; i < n; i += thread_num) {
+    x[i] = value;
+  }
+}
+
+TEST(CUDAMallocAsyncAllocatorTest, ReuseOnStream) {
+  platform::CUDAPlace place = platform::CUDAPlace(0);
+  gpuStream_t stream;
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamCreate(&stream));
+  allocation::CUDAMallocAsyncAllocator allocator(place, stream);
+
+  const int n = 1 << 20;
+  auto allocation = allocator.Allocate(n * sizeof(int));
+  void *address = allocation->ptr();
+  fill_kernel<<<32, 256, 0, stream>>>(static_cast<int *>(address), 1, n);
+  allocation.reset();
+
+  // The memory freed on the stream is reused by it without a synchronization.
+  allocation = allocator.Allocate(n * sizeof(int));
+  EXPECT_EQ(allocation->ptr(), address);
+  fill_kernel<<<32, 256, 0, stream>>>(
+      static_cast<int *>(allocation->ptr()), 2, n);
+  std::vector<int> host(n);
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(host.data(),
+                                             allocation->ptr(),
+                                             n * sizeof(int),
+                                             cudaMemcpyDeviceToHost,
+                                             stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
+  for (int i = 0; i < n; ++i) {
+    ASSERT_EQ(host[i], 2);
+  }
+  allocation.reset();
+
+  EXPECT_GE(allocator.Release(place), static_cast<uint64_t>(n * sizeof(int)));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamDestroy(stream));
+}
+
+TEST(CUDAMallocAsyncAllocatorTest, FacadeAlloc) {
+  platform::CUDAPlace place = platform::CUDAPlace(0);
+  gpuStream_t default_stream =
+      dynamic_cast<phi::GPUContext *>(
+          paddle::platform::DeviceContextPool::Instance().Get(place))
+          ->stream();
+  gpuStream_t other_stream;
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamCreate(&other_stream));
+
+  auto allocation = AllocShared(place, 256);
+  EXPECT_NE(allocation->ptr(), nullptr);
+  auto other_allocation = AllocShared(
+      place, 256, phi::Stream(reinterpret_cast<phi::StreamId>(other_stream)));
+  EXPECT_NE(other_allocation->ptr(), allocation->ptr());
+  RecordStream(allocation, other_stream);
+  allocation.reset();
+  other_allocation.reset();
+
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(default_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(other_stream));
+  Release(place);
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamDestroy(other_stream));
+}
+
+}  // namespace memory
+}  // namespace paddle
+#endif
@@ -0,0 +1,139 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/lifetime_pool_allocator.h"
+
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+class CountingAllocator : public Allocator {
+ public:
+  bool IsAllocThreadSafe() const override { return true; }
+
+  size_t AllocateTimes() const { return allocate_times_; }
+  size_t FreeTimes() const { return free_times_; }
+
+ protected:
+  phi::Allocation *AllocateImpl(size_t size) override {
+    ++allocate_times_;
+    return new Allocation(new uint8_t[size], size, platform::CPUPlace());
+  }
+
+  void FreeImpl(phi::Allocation *allocation) override {
+    ++free_times_;
+    delete[] static_cast<uint8_t *>(allocation->ptr());
+    delete allocation;
+  }
+
+ private:
+  std::atomic<size_t> allocate_times_{0};
+  std::atomic<size_t> free_times_{0};
+};
+
+constexpr size_t kAlignment = 256;
+constexpr size_t kChunkSize = 64 * kAlignment;
+
+TEST(LifetimePoolAllocator, PersistentAndLarge) {
+  auto underlying = std::make_shared<CountingAllocator>();
+  LifetimePoolAllocator allocator(underlying, kAlignment, kChunkSize);
+
+  allocator.Allocate(100);
+  EXPECT_EQ(underlying->AllocateTimes(), 1u);
+  EXPECT_EQ(underlying->FreeTimes(), 1u);
+
+  AllocationLifetimeGuard guard(AllocationLifetime::kMicroBatch);
+  auto large = allocator.Allocate(kChunkSize / 2);
+  EXPECT_EQ(large->size(), kChunkSize / 2);
+  EXPECT_EQ(underlying->AllocateTimes(), 2u);
+  EXPECT_EQ(allocator.NumChunks(AllocationLifetime::kMicroBatch), 0u);
+}
+
+TEST(LifetimePoolAllocator, Guard) {
+  EXPECT_EQ(CurrentAllocationLifetime(), AllocationLifetime::kPersistent);
+  {
+    AllocationLifetimeGuard step_guard(AllocationLifetime::kStep);
+    {
+      AllocationLifetimeGuard micro_batch_guard(
+          AllocationLifetime::kMicroBatch);
+      EXPECT_EQ(CurrentAllocationLifetime(), AllocationLifetime::kMicroBatch);
+    }
+    EXPECT_EQ(CurrentAllocationLifetime(), AllocationLifetime::kStep);
+  }
+  EXPECT_EQ(CurrentAllocationLifetime(), AllocationLifetime::kPersistent);
+}
+
+TEST(LifetimePoolAllocator, BumpAndReset) {
+  auto underlying = std::make_shared<CountingAllocator>();
+  LifetimePoolAllocator allocator(underlying, kAlignment, kChunkSize);
+  AllocationLifetimeGuard guard(AllocationLifetime::kMicroBatch);
+
+  for (int micro_batch = 0; micro_batch < 8; ++micro_batch) {
+    std::vector<AllocationPtr> blocks;
+    // Three chunks of blocks.
+    for (int i = 0; i < 3 * 64; ++i) {
+      blocks.push_back(allocator.Allocate(kAlignment - 1));
+      EXPECT_EQ(blocks.back()->size(), kAlignment - 1);
+    }
+    if (micro_batch == 0) {
+      EXPECT_EQ(static_cast<uint8_t *>(blocks[1]->ptr()),
+                static_cast<uint8_t *>(blocks[0]->ptr()) + kAlignment);
+    }
+    // The chunks are reset and reused by the next micro-batch.
+    EXPECT_EQ(allocator.NumChunks(AllocationLifetime::kMicroBatch), 3u);
+  }
+  EXPECT_EQ(underlying->AllocateTimes(), 3u);
+  EXPECT_EQ(allocator.NumFreeChunks(AllocationLifetime::kMicroBatch), 2u);
+  EXPECT_EQ(allocator.NumChunks(AllocationLifetime::kStep), 0u);
+
+  allocator.Release(platform::CPUPlace());
+  EXPECT_EQ(allocator.NumChunks(AllocationLifetime::kMicroBatch), 0u);
+  EXPECT_EQ(underlying->FreeTimes(), 3u);
+}
+
+TEST(LifetimePoolAllocator, Straggler) {
+  auto underlying = std::make_shared<CountingAllocator>();
+  LifetimePoolAllocator allocator(underlying, kAlignment, kChunkSize);
+  AllocationLifetimeGuard guard(AllocationLifetime::kMicroBatch);
+
+  std::vector<AllocationPtr> stragglers;
+  for (int micro_batch = 0; micro_batch < 8; ++micro_batch) {
+    std::vector<AllocationPtr> blocks;
+    for (int i = 0; i < 64; ++i) {
+      blocks.push_back(allocator.Allocate(kAlignment));
+    }
+    // A block outliving its micro-batch pins its chunk only.
+    stragglers.push_back(std::move(blocks.front()));
+  }
+  EXPECT_EQ(allocator.NumChunks(AllocationLifetime::kMicroBatch), 8u);
+  EXPECT_EQ(allocator.NumFreeChunks(AllocationLifetime::kMicroBatch), 0u);
+
+  stragglers.clear();
+  EXPECT_EQ(allocator.NumFreeChunks(AllocationLifetime::kMicroBatch), 7u);
+  std::vector<AllocationPtr> blocks;
+  for (int i = 0; i < 8 * 64; ++i) {
+    blocks.push_back(allocator.Allocate(kAlignment));
+  }
+  EXPECT_EQ(allocator.NumChunks(AllocationLifetime::kMicroBatch), 8u);
+  EXPECT_EQ(underlying->AllocateTimes(), 8u);
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,76 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/memory_attribution.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/memory/allocation/cpu_allocator.h"
+#include "paddle/fluid/memory/allocation/stat_allocator.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+TEST(MemoryAttribution, PeakAndTimeline) {
+  FLAGS_enable_memory_attribution = true;
+  auto& attribution = MemoryAttribution::Instance();
+  attribution.Reset();
+  auto allocator =
+      std::make_shared<StatAllocator>(std::make_shared<CPUAllocator>());
+  const phi::Place place = phi::CPUPlace();
+
+  AllocationPtr a, b, c;
+  {
+    MemoryAttributionGuard guard(0, "fill");
+    a = allocator->Allocate(1024);
+    b = allocator->Allocate(2048);
+  }
+  attribution.TagVariable(a->ptr(), "x");
+  {
+    MemoryAttributionGuard guard(1, "relu");
+    c = allocator->Allocate(4096);
+    b.reset();
+  }
+  {
+    MemoryAttributionGuard guard(2, "scale");
+    a.reset();
+  }
+
+  EXPECT_EQ(attribution.Peak(place), 7168);
+  auto blocks = attribution.AliveAtPeak(place);
+  ASSERT_EQ(blocks.size(), 3UL);
+  EXPECT_EQ(blocks[0].size, 4096UL);
+  EXPECT_EQ(blocks[0].instr_id, 1);
+  EXPECT_EQ(blocks[0].op_type, "relu");
+  EXPECT_EQ(blocks[2].var_name, "x");
+
+  auto timeline = attribution.Timeline();
+  ASSERT_EQ(timeline.size(), 3UL);
+  EXPECT_EQ(timeline[0].allocated, 3072);
+  EXPECT_EQ(timeline[1].freed, 2048);
+  EXPECT_EQ(timeline[1].current, 5120);
+  EXPECT_EQ(timeline[2].current, 4096);
+  EXPECT_EQ(timeline[2].peak, 7168);
+  EXPECT_NE(attribution.PeakReport().find("relu"), std::string::npos);
+
+  c.reset();
+  attribution.Reset();
+  FLAGS_enable_memory_attribution = false;
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -17,6 +17,9 @@
 #include "paddle/fluid/memory/allocation/mmap_allocator.h"
 
 #include "gtest/gtest.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_int64(shm_segment_size_mb);
 
 namespace paddle {
 namespace memory {
@@ -46,6 +49,38 @@ TEST(MemoryMapAllocation, test_allocation_base) {
   }
 }
 
+TEST(SharedMemorySegmentPool, test_reuse_segment) {
+  FLAGS_shm_segment_size_mb = 1;
+  auto& pool = SharedMemorySegmentPool::Instance();
+  ASSERT_EQ(pool.Allocate(2UL << 20), nullptr);
+
+  auto first = pool.Allocate(1000);
+  auto second = pool.Allocate(1000);
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  ASSERT_EQ(first->ipc_name(), second->ipc_name());
+  ASSERT_EQ(second->offset(), first->offset() + 1024);
+
+  // The blocks are passed by the offsets in the segment.
+  static_cast<int32_t*>(second->ptr())[0] = 7;
+  auto rebuilt =
+      pool.Rebuild(second->ipc_name(), second->offset(), second->size());
+  ASSERT_EQ(static_cast<int32_t*>(rebuilt->ptr())[0], 7);
+
+  // The segment is reused from the start once all the blocks are dropped.
+  const std::string ipc_name = first->ipc_name();
+  first.reset();
+  second.reset();
+  rebuilt.reset();
+  auto reused = pool.Allocate(1000);
+  ASSERT_EQ(reused->ipc_name(), ipc_name);
+  ASSERT_EQ(reused->offset(), 0UL);
+
+  reused.reset();
+  pool.Clear();
+  FLAGS_shm_segment_size_mb = 0;
+}
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
@@ -0,0 +1,172 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/thread_cached_allocator.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+class CountingAllocator : public Allocator {
+ public:
+  bool IsAllocThreadSafe() const override { return true; }
+
+  size_t AllocateTimes() const { return allocate_times_; }
+  size_t FreeTimes() const { return free_times_; }
+
+ protected:
+  phi::Allocation *AllocateImpl(size_t size) override {
+    ++allocate_times_;
+    return new Allocation(new uint8_t[size], size, platform::CPUPlace());
+  }
+
+  void FreeImpl(phi::Allocation *allocation) override {
+    ++free_times_;
+    delete[] static_cast<uint8_t *>(allocation->ptr());
+    delete allocation;
+  }
+
+ private:
+  std::atomic<size_t> allocate_times_{0};
+  std::atomic<size_t> free_times_{0};
+};
+
+TEST(ThreadCachedAllocator, SizeClass) {
+  EXPECT_EQ(ThreadCachedAllocator::SizeClassOf(1), 0);
+  EXPECT_EQ(ThreadCachedAllocator::ClassSize(0), 256u);
+  EXPECT_EQ(ThreadCachedAllocator::SizeClassOf(257), 1);
+  EXPECT_EQ(ThreadCachedAllocator::ClassSize(1), 320u);
+  EXPECT_EQ(ThreadCachedAllocator::SizeClassOf(512), 4);
+  EXPECT_EQ(ThreadCachedAllocator::ClassSize(4), 512u);
+  EXPECT_EQ(ThreadCachedAllocator::SizeClassOf(
+                ThreadCachedAllocator::kMaxCachedSize),
+            ThreadCachedAllocator::NumSizeClasses() - 1);
+  EXPECT_EQ(ThreadCachedAllocator::SizeClassOf(
+                ThreadCachedAllocator::kMaxCachedSize + 1),
+            -1);
+  for (size_t size = 1; size <= ThreadCachedAllocator::kMaxCachedSize;
+       size = size * 3 / 2 + 1) {
+    int size_class = ThreadCachedAllocator::SizeClassOf(size);
+    EXPECT_GE(ThreadCachedAllocator::ClassSize(size_class), size);
+    if (size_class > 0) {
+      EXPECT_LT(ThreadCachedAllocator::ClassSize(size_class - 1), size);
+    }
+  }
+}
+
+TEST(ThreadCachedAllocator, ReuseInSameThread) {
+  auto underlying_allocator = std::make_shared<CountingAllocator>();
+  auto allocator =
+      std::make_shared<ThreadCachedAllocator>(underlying_allocator, 1 << 20);
+
+  void *ptr = nullptr;
+  {
+    auto allocation = allocator->Allocate(1000);
+    ASSERT_GE(allocation->size(), 1000u);
+    ptr = allocation->ptr();
+  }
+  for (int i = 0; i < 10; ++i) {
+    auto allocation = allocator->Allocate(1000);
+    EXPECT_EQ(allocation->ptr(), ptr);
+  }
+  EXPECT_EQ(underlying_allocator->AllocateTimes(), 1u);
+  EXPECT_EQ(underlying_allocator->FreeTimes(), 0u);
+
+  // not cached
+  allocator->Allocate(ThreadCachedAllocator::kMaxCachedSize + 1);
+  EXPECT_EQ(underlying_allocator->AllocateTimes(), 2u);
+  EXPECT_EQ(underlying_allocator->FreeTimes(), 1u);
+
+  allocator->Release(platform::CPUPlace());
+  EXPECT_EQ(underlying_allocator->FreeTimes(), 2u);
+}
+
+TEST(ThreadCachedAllocator, BoundedCache) {
+  auto underlying_allocator = std::make_shared<CountingAllocator>();
+  // at most 4 blocks of 256 bytes are cached in one thread
+  auto allocator =
+      std::make_shared<ThreadCachedAllocator>(underlying_allocator, 1024);
+
+  std::vector<AllocationPtr> allocations;
+  for (int i = 0; i < 8; ++i) {
+    allocations.emplace_back(allocator->Allocate(100));
+  }
+  allocations.clear();
+  EXPECT_EQ(underlying_allocator->AllocateTimes(), 8u);
+  EXPECT_EQ(underlying_allocator->FreeTimes(), 4u);
+}
+
+TEST(ThreadCachedAllocator, ReturnToDepotAtThreadExit) {
+  auto underlying_allocator = std::make_shared<CountingAllocator>();
+  auto allocator =
+      std::make_shared<ThreadCachedAllocator>(underlying_allocator, 1 << 20);
+
+  std::thread producer([&] {
+    std::vector<AllocationPtr> allocations;
+    for (int i = 0; i < 4; ++i) {
+      allocations.emplace_back(allocator->Allocate(4096));
+    }
+  });
+  producer.join();
+  EXPECT_EQ(underlying_allocator->AllocateTimes(), 4u);
+  EXPECT_EQ(underlying_allocator->FreeTimes(), 0u);
+
+  // blocks cached by the exited thread are reused by another thread
+  std::thread consumer([&] {
+    std::vector<AllocationPtr> allocations;
+    for (int i = 0; i < 4; ++i) {
+      allocations.emplace_back(allocator->Allocate(4096));
+    }
+  });
+  consumer.join();
+  EXPECT_EQ(underlying_allocator->AllocateTimes(), 4u);
+
+  allocator->Release(platform::CPUPlace());
+  EXPECT_EQ(underlying_allocator->FreeTimes(), 4u);
+}
+
+TEST(ThreadCachedAllocator, MultiThread) {
+  auto underlying_allocator = std::make_shared<CountingAllocator>();
+  auto allocator =
+      std::make_shared<ThreadCachedAllocator>(underlying_allocator, 1 << 20);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < 1000; ++i) {
+        size_t size = 64 + (i * 37 + t * 101) % 8192;
+        auto allocation = allocator->Allocate(size);
+        ASSERT_GE(allocation->size(), size);
+        std::memset(allocation->ptr(), t, size);
+      }
+    });
+  }
+  for (auto &th : threads) {
+    th.join();
+  }
+  allocator->Release(platform::CPUPlace());
+  EXPECT_EQ(underlying_allocator->AllocateTimes(),
+            underlying_allocator->FreeTimes());
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
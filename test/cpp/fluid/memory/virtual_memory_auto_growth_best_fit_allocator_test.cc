@@ -0,0 +1,129 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/virtual_memory_auto_growth_best_fit_allocator.h"
+
+#include <cstdlib>
+
+#include "gtest/gtest.h"
+
+PD_DECLARE_bool(virtual_memory_defragmentation);
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+// Hands out the addresses of a reserved buffer in order, like
+// CUDAVirtualMemAllocator, and fails when the total size of the living
+// allocations exceeds the capacity, like the physical memory does.
+class SequentialAllocator : public Allocator {
+ public:
+  SequentialAllocator(size_t reserved_size, size_t capacity)
+      : base_(static_cast<uint8_t *>(
+            std::aligned_alloc(kAlignment, AlignedSize(reserved_size)))),
+        reserved_size_(reserved_size),
+        capacity_(capacity) {}
+
+  ~SequentialAllocator() override { std::free(base_); }  // NOLINT
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  size_t AllocatedSize() const { return allocated_size_; }
+
+ protected:
+  static constexpr size_t kAlignment = 4096;
+
+  static size_t AlignedSize(size_t size) {
+    return (size + kAlignment - 1) / kAlignment * kAlignment;
+  }
+
+  phi::Allocation *AllocateImpl(size_t size) override {
+    if (allocated_size_ + size > capacity_ ||
+        offset_ + size > reserved_size_) {
+      PADDLE_THROW_BAD_ALLOC(platform::errors::ResourceExhausted(
+          "Here is a test exception, out of capacity."));
+    }
+    void *ptr = base_ + offset_;
+    offset_ += size;
+    allocated_size_ += size;
+    return new Allocation(ptr, size, platform::CUDAPlace(0));
+  }
+
+  void FreeImpl(phi::Allocation *allocation) override {
+    allocated_size_ -= allocation->size();
+    delete allocation;
+  }
+
+ private:
+  uint8_t *base_;
+  size_t reserved_size_;
+  size_t capacity_;
+  size_t offset_{0};
+  size_t allocated_size_{0};
+};
+
+TEST(VirtualMemoryAutoGrowthBestFitAllocator, Defragmentation) {
+  FLAGS_virtual_memory_defragmentation = true;
+  size_t alignment = 256;
+  size_t size = 1 << 20;
+  // each underlying allocation has alignment more bytes for AlignedAllocator
+  size_t chunk_size = size + alignment;
+  auto underlying_allocator =
+      std::make_shared<SequentialAllocator>(8 * chunk_size, 3 * chunk_size);
+  auto allocator = std::make_shared<VirtualMemoryAutoGrowthBestFitAllocator>(
+      underlying_allocator, alignment, platform::CUDAPlace(0));
+
+  auto a = allocator->Allocate(size);
+  auto b = allocator->Allocate(size);
+  auto c = allocator->Allocate(size);
+  void *b_ptr = b->ptr();
+  a.reset();
+  c.reset();
+  ASSERT_EQ(underlying_allocator->AllocatedSize(), 3 * chunk_size);
+
+  // the free blocks are separated by b, the physical memory of them is
+  // released and remapped for d
+  auto d = allocator->Allocate(2 * size);
+  ASSERT_GE(d->size(), 2 * size);
+  EXPECT_EQ(b->ptr(), b_ptr);
+  EXPECT_EQ(underlying_allocator->AllocatedSize(),
+            chunk_size + 2 * size + alignment);
+
+  d.reset();
+  EXPECT_EQ(allocator->Release(platform::CUDAPlace(0)), 2 * size + alignment);
+  EXPECT_EQ(underlying_allocator->AllocatedSize(), chunk_size);
+}
+
+TEST(VirtualMemoryAutoGrowthBestFitAllocator, NoDefragmentation) {
+  FLAGS_virtual_memory_defragmentation = false;
+  size_t alignment = 256;
+  size_t size = 1 << 20;
+  size_t chunk_size = size + alignment;
+  auto underlying_allocator =
+      std::make_shared<SequentialAllocator>(8 * chunk_size, 3 * chunk_size);
+  auto allocator = std::make_shared<VirtualMemoryAutoGrowthBestFitAllocator>(
+      underlying_allocator, alignment, platform::CUDAPlace(0));
+
+  auto a = allocator->Allocate(size);
+  auto b = allocator->Allocate(size);
+  auto c = allocator->Allocate(size);
+  a.reset();
+  c.reset();
+  EXPECT_THROW(allocator->Allocate(2 * size), BadAlloc);
+  EXPECT_EQ(allocator->Release(platform::CUDAPlace(0)), 0UL);
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
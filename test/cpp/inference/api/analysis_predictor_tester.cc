@@ -20,18 +20,29 @@
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <map>
+#include <numeric>
 #include <thread>  // NOLINT
 
 #include "paddle/fluid/framework/ir/pass.h"
+#include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/tensor.h"
 #include "paddle/fluid/inference/api/helper.h"
 #include "paddle/fluid/inference/api/paddle_api.h"
+#include "paddle/fluid/inference/api/paddle_batching_predictor.h"
+#include "paddle/fluid/inference/api/paddle_generation_scheduler.h"
+#include "paddle/fluid/inference/api/paddle_kv_block_manager.h"
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
+#include "paddle/fluid/inference/api/paddle_speculative_decoder.h"
+#include "paddle/fluid/inference/io.h"
 #include "paddle/fluid/inference/utils/io_utils.h"
 #include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/core/flags.h"
 #include "test/cpp/inference/api/tester_helper.h"
 
 PD_DEFINE_string(dirname, "", "dirname to tests.");
+PHI_DECLARE_int32(inference_gpu_handle_pool_size);
 
 namespace paddle {
 
@@ -141,6 +152,45 @@ TEST(AnalysisPredictor, save_optimized_model_on) {
 }
 #endif
 
+#ifndef _WIN32
+TEST(AnalysisPredictor, LoadCombinedParamsByMmap) {
+  std::string params_file = "mmap_params_test.pdiparams";
+  std::vector<std::string> names = {"a", "b", "c"};
+  std::vector<phi::DenseTensor> tensors(names.size());
+  {
+    std::ofstream fout(params_file, std::ios::binary);
+    for (size_t i = 0; i < names.size(); ++i) {
+      auto& t = tensors[i];
+      t.Resize(common::make_ddim({static_cast<int64_t>(i + 2), 3}));
+      float* data = t.mutable_data<float>(platform::CPUPlace());
+      for (int64_t k = 0; k < t.numel(); ++k) {
+        data[k] = 0.5f * k + i;
+      }
+      if (i == 1) {
+        t.set_lod({{0, 1, 3}});
+      }
+      framework::SerializeToStream(fout, t);
+    }
+  }
+
+  framework::Scope scope;
+  ASSERT_TRUE(inference::LoadCombinedParamsByMmap(&scope, names, params_file));
+  for (size_t i = 0; i < names.size(); ++i) {
+    auto& t = scope.FindVar(names[i])->Get<phi::DenseTensor>();
+    ASSERT_EQ(t.dims(), tensors[i].dims());
+    ASSERT_EQ(t.lod(), tensors[i].lod());
+    for (int64_t k = 0; k < t.numel(); ++k) {
+      ASSERT_EQ(t.data<float>()[k], tensors[i].data<float>()[k]);
+    }
+  }
+  // the parameters do not match the file
+  framework::Scope scope1;
+  ASSERT_ANY_THROW(inference::LoadCombinedParamsByMmap(
+      &scope1, {"a", "b"}, params_file));
+  std::remove(params_file.c_str());
+}
+#endif
+
 TEST(AnalysisPredictor, ZeroCopy) {
   AnalysisConfig config;
   config.SetModel(FLAGS_dirname);
@@ -475,6 +525,336 @@ TEST(Predictor, Run) {
   predictor->TryShrinkMemory();
 }
 
+TEST(PredictorPool, Run) {
+  Config config;
+  config.SetModel(FLAGS_dirname);
+  const size_t pool_size = 2;
+  services::PredictorPool pool(config, pool_size);
+  ASSERT_EQ(pool.size(), pool_size);
+
+  auto task = [](Predictor* predictor) {
+    auto input_names = predictor->GetInputNames();
+    for (auto& name : input_names) {
+      auto input = predictor->GetInputHandle(name);
+      input->Reshape({4, 1});
+      auto* data = input->mutable_data<int64_t>(PlaceType::kCPU);
+      for (int i = 0; i < 4; i++) {
+        data[i] = i;
+      }
+    }
+    return predictor->Run();
+  };
+
+  const int num_threads = 4;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([&pool, &task] {
+      for (int j = 0; j < 5; j++) {
+        ASSERT_TRUE(pool.Run(task));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  auto stats = pool.GetStats();
+  ASSERT_EQ(stats.size(), pool_size);
+  uint64_t run_num = 0;
+  for (auto& stat : stats) {
+    run_num += stat.run_num;
+    ASSERT_GE(stat.total_run_ms, stat.max_run_ms);
+    ASSERT_GE(stat.total_queue_ms, stat.max_queue_ms);
+  }
+  ASSERT_EQ(run_num, static_cast<uint64_t>(num_threads * 5));
+
+  ASSERT_ANY_THROW(pool.Run([](Predictor*) -> bool {
+    PADDLE_THROW(paddle::platform::errors::Unavailable("fake error"));
+  }));
+  // the predictor is back to the pool after the exception
+  ASSERT_TRUE(pool.Run(task));
+}
+
+TEST(BatchingPredictor, Run) {
+  Config config;
+  config.SetModel(FLAGS_dirname);
+  services::BatchingConfig batching_config;
+  batching_config.max_batch_size = 4;
+  batching_config.max_wait_us = 10000;
+  services::BatchingPredictor predictor(config, batching_config);
+
+  const int num_threads = 6;
+  std::vector<std::vector<paddle::PaddleTensor>> outputs(num_threads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([&predictor, &outputs, i] {
+      int64_t data[1] = {i};
+      std::vector<paddle::PaddleTensor> inputs;
+      for (auto name : {"firstw", "secondw", "thirdw", "forthw"}) {
+        paddle::PaddleTensor tensor;
+        tensor.name = name;
+        tensor.shape = std::vector<int>({1, 1});
+        tensor.data.Reset(data, sizeof(data));
+        tensor.dtype = paddle::PaddleDType::INT64;
+        inputs.push_back(tensor);
+      }
+      ASSERT_TRUE(predictor.Run(inputs, &outputs[i]));
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (auto& output : outputs) {
+    ASSERT_EQ(output.size(), 1UL);
+    ASSERT_EQ(output[0].shape[0], 1);
+  }
+}
+
+TEST(KVBlockManager, PrefixSharing) {
+  Config config;
+  config.SetModel(FLAGS_dirname);
+  auto predictor = CreatePredictor(config);
+  // a fake cache of one value per block
+  std::vector<int64_t> cache_data = {0, 1, 2, 3, 4, 5, 6, 7};
+  auto cache = predictor->GetInputHandle("thirdw");
+  cache->Reshape({8, 1});
+  cache->CopyFromCpu(cache_data.data());
+
+  services::KVBlockManagerConfig kv_config;
+  kv_config.num_blocks = 8;
+  kv_config.block_size = 4;
+  kv_config.cache_names = {"thirdw"};
+  kv_config.block_tables_name = "firstw";
+  services::KVBlockManager manager(kv_config);
+
+  std::vector<int64_t> prompt = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  ASSERT_EQ(manager.AddSequence(0, prompt), 0);
+  manager.PrepareRun(predictor.get(), {0});
+  // the blocks of sequence 0 are not shared before its run is done
+  ASSERT_EQ(manager.AddSequence(1, prompt), 0);
+  manager.PrepareRun(predictor.get(), {0, 1});
+  ASSERT_EQ(manager.AddSequence(2, prompt), 8);
+  auto table0 = manager.GetBlockTable(0);
+  auto table2 = manager.GetBlockTable(2);
+  ASSERT_EQ(table0[0], table2[0]);
+  ASSERT_EQ(table0[1], table2[1]);
+  ASSERT_NE(table0[2], table2[2]);
+
+  // the shared last block is copied on write
+  manager.ForkSequence(0, 3);
+  manager.AppendToken(0, 11);
+  auto new_table0 = manager.GetBlockTable(0);
+  ASSERT_NE(new_table0[2], table0[2]);
+  ASSERT_EQ(manager.GetBlockTable(3)[2], table0[2]);
+  ASSERT_EQ(manager.NumFreeBlocks(), 0);
+  manager.PrepareRun(predictor.get(), {0, 3});
+  cache->CopyToCpu(cache_data.data());
+  ASSERT_EQ(cache_data[new_table0[2]], table0[2]);
+  auto block_tables = predictor->GetInputHandle("firstw");
+  ASSERT_EQ(block_tables->shape(), std::vector<int>({2, 3}));
+  ASSERT_ANY_THROW(manager.AddSequence(5, prompt));
+
+  for (int64_t seq_id : {0, 1, 2, 3}) {
+    manager.RemoveSequence(seq_id);
+  }
+  ASSERT_EQ(manager.NumFreeBlocks(), 8);
+  // the cached prefix is kept after its sequences are removed
+  ASSERT_EQ(manager.AddSequence(4, prompt), 8);
+}
+
+TEST(GenerationScheduler, Schedule) {
+  services::KVBlockManagerConfig kv_config;
+  kv_config.num_blocks = 6;
+  kv_config.block_size = 4;
+  services::KVBlockManager manager(kv_config);
+  services::GenerationSchedulerConfig scheduler_config;
+  scheduler_config.max_batch_size = 3;
+  scheduler_config.max_num_batched_tokens = 12;
+  services::GenerationScheduler scheduler(&manager, scheduler_config);
+
+  const int num_requests = 5;
+  std::vector<std::vector<int64_t>> outputs(num_requests);
+  std::vector<bool> finished(num_requests, false);
+  for (int i = 0; i < num_requests; ++i) {
+    services::GenerationRequest request;
+    request.id = i;
+    request.prompt = std::vector<int64_t>(5 + i, 100 * i);
+    request.max_new_tokens = 6 + i;
+    request.on_token = [&](int64_t id, int64_t token, bool done) {
+      ASSERT_FALSE(finished[id]);
+      outputs[id].push_back(token);
+      finished[id] = done;
+    };
+    scheduler.AddRequest(request);
+  }
+
+  // a fake model whose next token is the last token plus 1
+  int step_num = 0;
+  while (scheduler.HasUnfinishedRequests()) {
+    auto step = scheduler.Schedule();
+    ASSERT_FALSE(step.sequences.empty());
+    ASSERT_LE(step.sequences.size(), 3UL);
+    std::vector<int64_t> next_tokens;
+    for (auto& seq : step.sequences) {
+      next_tokens.push_back(seq.tokens.back() + 1);
+    }
+    scheduler.Update(next_tokens);
+    ASSERT_LT(++step_num, 100);
+  }
+  // the preempted requests continue from their generated tokens
+  for (int i = 0; i < num_requests; ++i) {
+    ASSERT_TRUE(finished[i]);
+    ASSERT_EQ(outputs[i].size(), static_cast<size_t>(6 + i));
+    for (size_t j = 0; j < outputs[i].size(); ++j) {
+      ASSERT_EQ(outputs[i][j], static_cast<int64_t>(100 * i + 1 + j));
+    }
+  }
+  ASSERT_EQ(manager.NumFreeBlocks(), 6);
+}
+
+TEST(KVBlockManager, TruncateSequence) {
+  Config config;
+  config.SetModel(FLAGS_dirname);
+  auto predictor = CreatePredictor(config);
+  services::KVBlockManagerConfig kv_config;
+  kv_config.num_blocks = 6;
+  kv_config.block_size = 4;
+  kv_config.block_tables_name = "firstw";
+  services::KVBlockManager manager(kv_config);
+
+  std::vector<int64_t> prompt = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  ASSERT_EQ(manager.AddSequence(0, prompt), 0);
+  auto table = manager.GetBlockTable(0);
+  manager.TruncateSequence(0, 5);
+  ASSERT_EQ(manager.GetBlockTable(0).size(), 2UL);
+  ASSERT_EQ(manager.NumFreeBlocks(), 4);
+  // the owned last block is written on again
+  manager.AppendToken(0, 100);
+  ASSERT_EQ(manager.GetBlockTable(0), std::vector<int>({table[0], table[1]}));
+  ASSERT_ANY_THROW(manager.TruncateSequence(0, 7));
+
+  // the truncated block is hashed by its new tokens
+  manager.AppendToken(0, 101);
+  manager.AppendToken(0, 102);
+  manager.PrepareRun(predictor.get(), {0});
+  manager.PrepareRun(predictor.get(), {0});
+  ASSERT_EQ(manager.AddSequence(1, prompt), 4);
+  ASSERT_EQ(manager.AddSequence(2, {1, 2, 3, 4, 5, 100, 101, 102, 103}), 8);
+
+  // the shared last block is copied on write after the truncation
+  manager.ForkSequence(0, 3);
+  manager.TruncateSequence(3, 6);
+  manager.AppendToken(3, 200);
+  auto table0 = manager.GetBlockTable(0);
+  auto table3 = manager.GetBlockTable(3);
+  ASSERT_EQ(table3.size(), 2UL);
+  ASSERT_EQ(table3[0], table0[0]);
+  ASSERT_NE(table3[1], table0[1]);
+
+  for (int64_t seq_id : {0, 1, 2, 3}) {
+    manager.RemoveSequence(seq_id);
+  }
+  ASSERT_EQ(manager.NumFreeBlocks(), 6);
+}
+
+TEST(SpeculativeDecoder, Step) {
+  Config config;
+  config.SetModel(FLAGS_dirname);
+  auto draft_predictor = CreatePredictor(config);
+  auto target_predictor = CreatePredictor(config);
+  services::KVBlockManagerConfig kv_config;
+  kv_config.num_blocks = 16;
+  kv_config.block_size = 4;
+  kv_config.block_tables_name = "firstw";
+  services::KVBlockManager draft_manager(kv_config);
+  services::KVBlockManager target_manager(kv_config);
+  const int vocab_size = 8;
+  services::SpeculativeDecoderConfig decoder_config;
+  decoder_config.num_draft_tokens = 3;
+  decoder_config.vocab_size = vocab_size;
+  services::SpeculativeDecoder decoder(draft_predictor.get(),
+                                       &draft_manager,
+                                       target_predictor.get(),
+                                       &target_manager,
+                                       decoder_config);
+
+  // fake models with the KV caches of the fed tokens, the next token of the
+  // target model is the sum of the tokens and their number modulo
+  // vocab_size - 1, and the draft model proposes 0 instead of 5
+  using Cache = std::map<int64_t, std::vector<int64_t>>;
+  auto MakeModel = [&](Cache* caches, bool is_draft) {
+    return [&decoder, caches, is_draft](Predictor*,
+                                        const services::GenerationStep& step,
+                                        std::vector<float>* probs) {
+      for (auto& seq : step.sequences) {
+        auto& cache = (*caches)[seq.id];
+        // the tokens before start_pos are in the cache
+        EXPECT_LE(static_cast<size_t>(seq.start_pos), cache.size());
+        auto& tokens = decoder.GetTokens(seq.id);
+        size_t valid = std::min<size_t>(seq.start_pos, tokens.size());
+        EXPECT_TRUE(std::equal(
+            tokens.begin(), tokens.begin() + valid, cache.begin()));
+        cache.resize(seq.start_pos);
+        for (size_t i = 0; i < seq.tokens.size(); ++i) {
+          cache.push_back(seq.tokens[i]);
+          if (is_draft && i + 1 < seq.tokens.size()) continue;
+          int64_t sum = std::accumulate(
+              cache.begin(), cache.end(), static_cast<int64_t>(0));
+          int64_t next = (sum + cache.size()) % (vocab_size - 1);
+          if (is_draft && next == 5) next = 0;
+          std::vector<float> row(vocab_size, 0.0f);
+          row[next] = 1.0f;
+          probs->insert(probs->end(), row.begin(), row.end());
+        }
+      }
+      return true;
+    };
+  };
+  Cache draft_caches;
+  Cache target_caches;
+  auto draft = MakeModel(&draft_caches, true);
+  auto verify = MakeModel(&target_caches, false);
+
+  decoder.AddSequence(0, {1, 2, 3});
+  decoder.AddSequence(1, {4, 5});
+  std::vector<std::vector<int64_t>> new_tokens;
+  bool fail = false;
+  auto failing = [&](Predictor* p,
+                     const services::GenerationStep& step,
+                     std::vector<float>* probs) {
+    return !fail && verify(p, step, probs);
+  };
+  for (int step = 0; step < 6; ++step) {
+    // a failed step keeps the sequences
+    fail = step == 2;
+    ASSERT_EQ(decoder.Step({0, 1}, draft, failing, &new_tokens), !fail);
+    if (fail) continue;
+    ASSERT_EQ(new_tokens.size(), 2UL);
+    for (auto& tokens : new_tokens) {
+      ASSERT_GE(tokens.size(), 1UL);
+      ASSERT_LE(tokens.size(), 4UL);
+    }
+  }
+  // the tokens follow the target model
+  for (int64_t seq_id : {0, 1}) {
+    auto& tokens = decoder.GetTokens(seq_id);
+    size_t prompt_len = 3 - seq_id;
+    ASSERT_GT(tokens.size(), prompt_len + 5);
+    int64_t sum = std::accumulate(
+        tokens.begin(), tokens.begin() + prompt_len, static_cast<int64_t>(0));
+    for (size_t i = prompt_len; i < tokens.size(); ++i) {
+      ASSERT_EQ(tokens[i], static_cast<int64_t>((sum + i) % (vocab_size - 1)));
+      sum += tokens[i];
+    }
+  }
+  ASSERT_GT(decoder.AcceptanceRate(), 0.0);
+  ASSERT_LT(decoder.AcceptanceRate(), 1.0);
+  decoder.RemoveSequence(0);
+  decoder.RemoveSequence(1);
+  ASSERT_EQ(draft_manager.NumFreeBlocks(), 16);
+  ASSERT_EQ(target_manager.NumFreeBlocks(), 16);
+}
+
 TEST(Predictor, EnableONNXRuntime) {
   Config config;
   config.SetModel(FLAGS_dirname);
@@ -516,6 +896,52 @@ TEST(Tensor, CpuShareExternalData) {
   predictor->TryShrinkMemory();
 }
 
+TEST(Predictor, BindBuffer) {
+  Config config;
+  config.SetModel(FLAGS_dirname);
+  auto predictor = CreatePredictor(config);
+  auto names = predictor->GetInputNames();
+
+  std::vector<int64_t> input_data = {0, 1, 2, 3};
+  for (auto& name : names) {
+    auto input = predictor->GetInputHandle(name);
+    input->Reshape({4, 1});
+    input->CopyFromCpu(input_data.data());
+  }
+  predictor->Run();
+  auto out = predictor->GetOutputHandle("fc_1.tmp_2");
+  auto out_shape = out->shape();
+  std::vector<float> expected(std::accumulate(
+      out_shape.begin(), out_shape.end(), 1, std::multiplies<int>()));
+  out->CopyToCpu(expected.data());
+
+  std::vector<std::vector<int64_t>> inputs(names.size(), input_data);
+  for (size_t i = 0; i < names.size(); ++i) {
+    predictor->BindBuffer(names[i],
+                          inputs[i].data(),
+                          inputs[i].size() * sizeof(int64_t),
+                          PlaceType::kCPU);
+  }
+  std::vector<float> out_data(expected.size());
+  int filled = 0;
+  predictor->BindBuffer(
+      "fc_1.tmp_2",
+      out_data.data(),
+      out_data.size() * sizeof(float),
+      PlaceType::kCPU,
+      [](void* filled) { ++*static_cast<int*>(filled); },
+      &filled);
+  for (int run = 1; run <= 2; ++run) {
+    std::fill(out_data.begin(), out_data.end(), 0.0f);
+    predictor->Run();
+    ASSERT_EQ(filled, run);
+    for (size_t i = 0; i < expected.size(); ++i) {
+      ASSERT_NEAR(out_data[i], expected[i], 1e-6);
+    }
+  }
+  predictor->UnbindBuffer("fc_1.tmp_2");
+}
+
 #if defined(PADDLE_WITH_CUDA)
 TEST(Tensor, GpuShareExternalData) {
   Config config;
@@ -661,6 +1087,66 @@ TEST(Predictor, Streams) {
   }
 }
 
+TEST(GPUHandlePool, LendHandles) {
+  FLAGS_inference_gpu_handle_pool_size = 1;
+  auto& pool = GPUHandlePool::Instance();
+  const auto kind = GPUHandlePool::Kind::kBlas;
+  phi::GPUPlace place(0);
+  blasHandle_t handle = nullptr;
+  {
+    GPUContextResource resource(place, nullptr);
+    handle = resource.GetBlasHandleCreator()();
+  }
+  ASSERT_EQ(pool.IdleSize(0, kind), 1UL);
+
+  // The next resources borrow the idle handle, and create their own ones after
+  // it is lent.
+  {
+    GPUContextResource resource(place, nullptr);
+    GPUContextResource resource2(place, nullptr);
+    EXPECT_EQ(resource.GetBlasHandleCreator()(), handle);
+    EXPECT_EQ(pool.IdleSize(0, kind), 0UL);
+    EXPECT_NE(resource2.GetBlasHandleCreator()(), handle);
+  }
+  // One of the two handles is kept in the pool of the size 1.
+  EXPECT_EQ(pool.IdleSize(0, kind), 1UL);
+  FLAGS_inference_gpu_handle_pool_size = 0;
+}
+
+static std::vector<float> RunWord2Vec(int auto_multi_stream_num) {
+  Config config;
+  config.SetModel(FLAGS_dirname);
+  config.EnableUseGpu(100, 0);
+  config.EnableNewExecutor();
+  config.EnableAutoMultiStream(auto_multi_stream_num);
+  auto predictor = CreatePredictor(config);
+
+  std::vector<int64_t> input_data = {0, 1, 2, 3};
+  for (auto& name : predictor->GetInputNames()) {
+    auto input = predictor->GetInputHandle(name);
+    input->Reshape({4, 1});
+    input->CopyFromCpu(input_data.data());
+  }
+  predictor->Run();
+
+  auto out = predictor->GetOutputHandle("fc_1.tmp_2");
+  auto out_shape = out->shape();
+  std::vector<float> out_data(std::accumulate(
+      out_shape.begin(), out_shape.end(), 1, std::multiplies<int>()));
+  out->CopyToCpu(out_data.data());
+  return out_data;
+}
+
+TEST(Predictor, AutoMultiStream) {
+  // The independent branches on the streams give the same result as a stream.
+  std::vector<float> expected = RunWord2Vec(0);
+  std::vector<float> out = RunWord2Vec(3);
+  ASSERT_EQ(out.size(), expected.size());
+  for (size_t i = 0; i < out.size(); ++i) {
+    EXPECT_FLOAT_EQ(out[i], expected[i]);
+  }
+}
+
 TEST(Tensor, RunWithExternalStream) {
   Config config;
   config.SetModel(FLAGS_dirname);
@@ -88,6 +88,44 @@ void PD_run() {
 }
 TEST(PD_Tensor, PD_run) { PD_run(); }
 
+static void CountRun(PD_Bool success, void* user_data) {
+  EXPECT_TRUE(success);
+  ++*static_cast<int*>(user_data);
+}
+
+TEST(PD_Tensor, run_async) {
+  auto model_dir = FLAGS_infer_model;
+  PD_Config* config = PD_ConfigCreate();
+  PD_ConfigSetModel(config,
+                    (model_dir + "/__model__").c_str(),
+                    (model_dir + "/__params__").c_str());
+  PD_Predictor* predictor = PD_PredictorCreate(config);
+  PD_OneDimArrayCstr* input_names = PD_PredictorGetInputNames(predictor);
+  PD_Tensor* tensor =
+      PD_PredictorGetInputHandle(predictor, input_names->data[0]);
+
+  int32_t shapes[4] = {1, 3, 300, 300};
+  std::vector<float> input(1 * 3 * 300 * 300, 0);
+  PD_TensorShareExternalDataFloat(
+      tensor, input.data(), 4, shapes, PD_PLACE_CPU);
+  int32_t size;
+  PD_PlaceType place;
+  EXPECT_EQ(PD_TensorDataFloat(tensor, &place, &size), input.data());
+
+  int num_runs = 0;
+  PD_RunRequest* first = PD_PredictorRunAsync(predictor, CountRun, &num_runs);
+  PD_RunRequest* second = PD_PredictorRunAsync(predictor, CountRun, &num_runs);
+  EXPECT_TRUE(PD_RunRequestWait(second));
+  EXPECT_TRUE(PD_RunRequestPoll(first));
+  EXPECT_EQ(num_runs, 2);
+
+  PD_RunRequestDestroy(first);
+  PD_RunRequestDestroy(second);
+  PD_TensorDestroy(tensor);
+  PD_OneDimArrayCstrDestroy(input_names);
+  PD_PredictorDestroy(predictor);
+}
+
 TEST(PD_Tensor, int32) {
   auto model_dir = FLAGS_infer_model;
   PD_Config* config = PD_ConfigCreate();
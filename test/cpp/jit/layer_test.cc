@@ -14,6 +14,7 @@
 
 #include <cmath>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -30,6 +31,7 @@
 #include "paddle/fluid/jit/function.h"
 #include "paddle/fluid/jit/function_utils.h"
 #include "paddle/fluid/jit/layer.h"
+#include "paddle/fluid/jit/prepared_function.h"
 #include "paddle/fluid/jit/serializer.h"
 
 USE_OP_ITSELF(elementwise_add);
@@ -159,6 +161,29 @@ TEST(CpuLayerTest, Clone) {
   EXPECT_NEAR(out_data[0], pow(1.41562390, 2.0), 1e-6);
 }
 
+TEST(CpuLayerTest, PreparedFunction) {
+  auto place = phi::CPUPlace();
+  std::string path = "./multi_program_load/export";
+  auto layer = jit::Load(path, place);
+  auto forward = layer.Prepare("forward");
+  auto inputs = utils::ToDenseTensors(PrepareInputs(place));
+
+  auto run = [&] {
+    std::vector<DenseTensor> outputs;
+    (*forward)(inputs, &outputs);
+    EXPECT_NEAR(outputs[0].data<float>()[0], 0.02194316, 1e-6);
+    const void* buffer = outputs[0].data();
+    for (int i = 0; i < 3; ++i) {
+      (*forward)(inputs, &outputs);
+      EXPECT_EQ(outputs[0].data(), buffer);
+      EXPECT_NEAR(outputs[0].data<float>()[0], 0.02194316, 1e-6);
+    }
+  };
+  std::thread other(run);
+  run();
+  other.join();
+}
+
 #if defined(PADDLE_WITH_CUDA)
 TEST(GpuLayerTest, Construct) {
   auto place = phi::GPUPlace();
@@ -0,0 +1,82 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmark for the submission path of WorkQueue: many threads outside
+// the queue add tiny tasks concurrently, which is the case when predictor
+// threads share one WorkQueueGroup.
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/new_executor/workqueue/workqueue.h"
+#include "paddle/fluid/framework/new_executor/workqueue/workqueue_utils.h"
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+constexpr size_t kNumProducers = 16;
+constexpr size_t kNumTasksPerProducer = 20000;
+
+double RunSubmissionBenchmark(bool lock_free_submission) {
+  EventsWaiter events_waiter;
+  WorkQueueOptions options(/*name*/ "SubmissionBenchmark",
+                           /*num_threads*/ 4,
+                           /*allow_spinning*/ true,
+                           /*always_spinning*/ false,
+                           /*track_task*/ true,
+                           /*detached*/ true,
+                           &events_waiter);
+  options.lock_free_submission = lock_free_submission;
+  auto work_queue = CreateMultiThreadedWorkQueue(options);
+
+  std::atomic<size_t> counter{0};
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> producers;
+  for (size_t i = 0; i < kNumProducers; ++i) {
+    producers.emplace_back([&work_queue, &counter]() {
+      for (size_t j = 0; j < kNumTasksPerProducer; ++j) {
+        work_queue->AddTask(
+            [&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  events_waiter.WaitEvent();
+  double elapsed_ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+  EXPECT_EQ(counter.load(), kNumProducers * kNumTasksPerProducer);
+  return elapsed_ms;
+}
+
+}  // namespace
+
+TEST(WorkQueueSubmissionBenchmark, LockedVsLockFree) {
+  double locked_ms = RunSubmissionBenchmark(/*lock_free_submission*/ false);
+  double lock_free_ms = RunSubmissionBenchmark(/*lock_free_submission*/ true);
+  LOG(INFO) << kNumProducers << " producers x " << kNumTasksPerProducer
+            << " tasks, locked submission: " << locked_ms
+            << " ms, lock-free submission: " << lock_free_ms << " ms";
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,61 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/backends/gpu/gpu_event_pool.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/gpu/gpu_info.h"
+
+namespace phi {
+namespace backends {
+namespace gpu {
+
+TEST(GpuEventPool, Recycle) {
+  auto& pool = GpuEventPool::Instance();
+  const unsigned int flags = cudaEventDisableTiming;
+  size_t free_size = pool.FreeSize(0, flags);
+  gpuEvent_t event = pool.Acquire(0, flags);
+  pool.Release(0, flags, event);
+  EXPECT_EQ(pool.FreeSize(0, flags), free_size + 1);
+  EXPECT_EQ(pool.Acquire(0, flags), event);
+  pool.Release(0, flags, event);
+}
+
+TEST(StreamCallbackPoller, RunInOrder) {
+  GPUDeviceGuard guard(0);
+  cudaStream_t stream;
+  ASSERT_EQ(cudaStreamCreate(&stream), cudaSuccess);
+  std::vector<int> order;
+  {
+    StreamCallbackPoller poller(0);
+    for (int i = 0; i < 64; ++i) {
+      poller.AddCallback(stream, [&order, i] { order.push_back(i); });
+    }
+    poller.Wait();
+    ASSERT_EQ(order.size(), 64UL);
+    for (int i = 0; i < 64; ++i) {
+      EXPECT_EQ(order[i], i);
+    }
+    // The callbacks added before the destruction are run too.
+    poller.AddCallback(stream, [&order] { order.push_back(64); });
+  }
+  EXPECT_EQ(order.size(), 65UL);
+  cudaStreamDestroy(stream);
+}
+
+}  // namespace gpu
+}  // namespace backends
+}  // namespace phi
@@ -0,0 +1,84 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/onednn/onednn_primitive_cache.h"
+#include "paddle/utils/flags.h"
+
+PD_DECLARE_int64(onednn_primitive_cache_capacity);
+
+namespace phi {
+namespace tests {
+
+TEST(OneDNNPrimitiveCache, lru) {
+  FLAGS_onednn_primitive_cache_capacity = 2;
+  auto& cache = OneDNNPrimitiveCache::Instance();
+  cache.Clear();
+  ASSERT_TRUE(OneDNNPrimitiveCache::Enabled());
+
+  const int64_t hits = cache.HitCount();
+  const int64_t misses = cache.MissCount();
+  EXPECT_EQ(cache.Get("a"), nullptr);
+  cache.Set("a", std::make_shared<int>(1));
+  cache.Set("b", std::make_shared<int>(2));
+  // "a" is used recently, so "b" is evicted
+  EXPECT_EQ(*std::static_pointer_cast<int>(cache.Get("a")), 1);
+  cache.Set("c", std::make_shared<int>(3));
+  EXPECT_EQ(cache.Size(), 2UL);
+  EXPECT_EQ(cache.Get("b"), nullptr);
+  EXPECT_EQ(*std::static_pointer_cast<int>(cache.Get("c")), 3);
+  EXPECT_EQ(cache.HitCount() - hits, 2);
+  EXPECT_EQ(cache.MissCount() - misses, 2);
+
+  cache.Clear();
+  FLAGS_onednn_primitive_cache_capacity = 0;
+  EXPECT_FALSE(OneDNNPrimitiveCache::Enabled());
+}
+
+TEST(OneDNNPrimitiveCache, shared_by_threads) {
+  FLAGS_onednn_primitive_cache_capacity = 16;
+  auto& cache = OneDNNPrimitiveCache::Instance();
+  cache.Clear();
+
+  constexpr int kThreads = 8;
+  std::vector<std::shared_ptr<void>> values(kThreads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&cache, &values, i] {
+      auto value = cache.Get("conv@fwd_p");
+      if (value == nullptr) {
+        value = cache.Set("conv@fwd_p", std::make_shared<int>(i));
+      }
+      values[i] = value;
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // all the threads get the one set first
+  for (int i = 0; i < kThreads; ++i) {
+    EXPECT_EQ(values[i], values[0]);
+  }
+  EXPECT_EQ(cache.Size(), 1UL);
+
+  cache.Clear();
+  FLAGS_onednn_primitive_cache_capacity = 0;
+}
+
+}  // namespace tests
+}  // namespace phi
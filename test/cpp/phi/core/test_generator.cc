@@ -0,0 +1,63 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <set>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/core/generator.h"
+
+namespace phi {
+namespace tests {
+
+TEST(generator, sub_stream_seed) {
+  // A pure function of the seed, the stream and the step.
+  EXPECT_EQ(Generator::SubStreamSeed(1, 2, 3),
+            Generator::SubStreamSeed(1, 2, 3));
+  std::set<uint64_t> seeds;
+  for (uint64_t stream = 0; stream < 16; ++stream) {
+    for (uint64_t step = 0; step < 16; ++step) {
+      seeds.insert(Generator::SubStreamSeed(2023, stream, step));
+    }
+  }
+  EXPECT_EQ(seeds.size(), 256UL);
+  EXPECT_NE(Generator::SubStreamSeed(1, 2, 3),
+            Generator::SubStreamSeed(2, 2, 3));
+}
+
+TEST(generator, sub_stream_guard) {
+  uint64_t stream_id = 0;
+  EXPECT_FALSE(Generator::GetActiveSubStream(&stream_id));
+  {
+    Generator::SubStreamGuard guard(7);
+    EXPECT_TRUE(Generator::GetActiveSubStream(&stream_id));
+    EXPECT_EQ(stream_id, 7UL);
+    {
+      Generator::SubStreamGuard inner(9);
+      EXPECT_TRUE(Generator::GetActiveSubStream(&stream_id));
+      EXPECT_EQ(stream_id, 9UL);
+    }
+    EXPECT_TRUE(Generator::GetActiveSubStream(&stream_id));
+    EXPECT_EQ(stream_id, 7UL);
+    // The sub-stream is active on its thread only.
+    std::thread([] {
+      uint64_t id = 0;
+      EXPECT_FALSE(Generator::GetActiveSubStream(&id));
+    }).join();
+  }
+  EXPECT_FALSE(Generator::GetActiveSubStream(&stream_id));
+}
+
+}  // namespace tests
+}  // namespace phi
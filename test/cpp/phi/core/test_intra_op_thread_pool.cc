@@ -0,0 +1,60 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/cpu/intra_op_thread_pool.h"
+
+namespace phi {
+namespace tests {
+
+TEST(IntraOpThreadPool, ParallelForCoversRange) {
+  IntraOpThreadPool pool(4);
+  std::vector<int> hits(1000, 0);
+  pool.ParallelFor(0, 1000, 7, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) ++hits[i];
+  });
+  for (int hit : hits) {
+    EXPECT_EQ(hit, 1);
+  }
+}
+
+TEST(IntraOpThreadPool, NestedLoopRunsSerially) {
+  IntraOpThreadPool pool(4);
+  std::atomic<int64_t> sum{0};
+  pool.ParallelFor(0, 8, 1, [&](int64_t begin, int64_t end) {
+    pool.ParallelFor(0, 100, 1, [&](int64_t b, int64_t e) { sum += e - b; });
+  });
+  EXPECT_EQ(sum.load(), 800);
+}
+
+TEST(IntraOpThreadPool, RethrowsException) {
+  IntraOpThreadPool pool(3);
+  EXPECT_THROW(pool.ParallelFor(0,
+                                100,
+                                1,
+                                [](int64_t begin, int64_t end) {
+                                  if (begin == 50) {
+                                    throw std::runtime_error("chunk 50");
+                                  }
+                                }),
+               std::runtime_error);
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -72,6 +72,49 @@ TEST(KernelRegistry, SetFP32Input) {
   EXPECT_EQ(output_defs.at(0).dtype, phi::DataType::FLOAT16);
 }
 
+static int lazy_kernel_args_def_calls = 0;
+
+TEST(KernelFactory, LazyKernelOverride) {
+  phi::KernelKey kernel_key(
+      phi::Backend::CPU, phi::DataLayout::ALL_LAYOUT, phi::DataType::FLOAT32);
+  auto& factory = phi::KernelFactory::Instance();
+  auto args_def_fn = [](const phi::KernelKey& kernel_key,
+                        phi::Kernel* kernel) {
+    ++lazy_kernel_args_def_calls;
+    kernel->OutputAt(0).SetDataType(phi::DataType::INT64);
+  };
+  auto override_args_def_fn = [](const phi::KernelKey& kernel_key,
+                                 phi::Kernel* kernel) {
+    ++lazy_kernel_args_def_calls;
+    kernel->OutputAt(0).SetDataType(phi::DataType::INT32);
+  };
+  factory.RegisterLazyKernel("test_lazy",
+                             kernel_key,
+                             phi::KernelArgsParseFunctor<decltype(
+                                 &TestKernel<float, phi::CPUContext>)>::Parse,
+                             args_def_fn,
+                             PHI_KERNEL(TestKernel<float, phi::CPUContext>),
+                             PHI_VARIADIC_KERNEL(
+                                 TestKernel<float, phi::CPUContext>));
+  factory.RegisterLazyKernel("test_lazy",
+                             kernel_key,
+                             phi::KernelArgsParseFunctor<decltype(
+                                 &TestKernel<float, phi::CPUContext>)>::Parse,
+                             override_args_def_fn,
+                             PHI_KERNEL(TestKernel<float, phi::CPUContext>),
+                             PHI_VARIADIC_KERNEL(
+                                 TestKernel<float, phi::CPUContext>));
+  EXPECT_TRUE(factory.HasKernel("test_lazy", kernel_key));
+  const auto& kernel = factory.SelectKernel("test_lazy", kernel_key);
+  EXPECT_TRUE(kernel.IsValid());
+  EXPECT_EQ(kernel.args_def().input_defs().size(), 2UL);
+  EXPECT_EQ(kernel.args_def().output_defs().at(0).dtype,
+            phi::DataType::INT32);
+  // Every registration is built only once.
+  factory.SelectKernel("test_lazy", kernel_key);
+  EXPECT_EQ(lazy_kernel_args_def_calls, 2);
+}
+
 TEST(AttributeType, OStream) {
   std::ostringstream oss;
   oss << phi::AttributeType::UNDEFINED;
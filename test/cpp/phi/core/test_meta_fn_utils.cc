@@ -46,5 +46,30 @@ TEST(MetaFnFactory, EmptyVectorInputInferMetaFn) {
   PD_INFER_META(TestEmptyVectorInputInferMeta)(&ctx);
 }
 
+TEST(InferMetaCache, RestoreOutputMetas) {
+  phi::DenseTensor dense_x;
+  dense_x.Resize(common::make_ddim({3, 4}));
+  phi::DenseTensor dense_out;
+  phi::InferMetaContext ctx;
+  ctx.EmplaceBackInput(MetaTensor(&dense_x));
+  ctx.EmplaceBackOutput(MetaTensor(&dense_out));
+
+  phi::InferMetaCache cache;
+  ASSERT_FALSE(cache.Restore(&ctx));
+  PD_INFER_META(phi::UnchangedInferMeta)(&ctx);
+  cache.Record(ctx);
+
+  dense_out.Resize(common::make_ddim({1}));
+  ASSERT_TRUE(cache.Restore(&ctx));
+  ASSERT_EQ(dense_out.dims(), common::make_ddim({3, 4}));
+
+  dense_x.Resize(common::make_ddim({5, 4}));
+  ASSERT_FALSE(cache.Restore(&ctx));
+  PD_INFER_META(phi::UnchangedInferMeta)(&ctx);
+  cache.Record(ctx);
+  ASSERT_TRUE(cache.Restore(&ctx));
+  ASSERT_EQ(dense_out.dims(), common::make_ddim({5, 4}));
+}
+
 }  // namespace tests
 }  // namespace phi
@@ -0,0 +1,67 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/core/metrics.h"
+
+namespace phi {
+namespace tests {
+
+using phi::metrics::MetricsRegistry;
+
+TEST(metrics, counter_from_threads) {
+  auto* counter = MetricsRegistry::Instance().GetCounter(
+      "test_counter_total", "A test counter.", {{"op", "add"}});
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([counter] {
+      for (int j = 0; j < 1000; ++j) counter->Add();
+    });
+  }
+  for (auto& t : threads) t.join();
+  EXPECT_EQ(counter->Value(), 8000);
+  // The same labels get the same counter.
+  EXPECT_EQ(MetricsRegistry::Instance().GetCounter(
+                "test_counter_total", "A test counter.", {{"op", "add"}}),
+            counter);
+}
+
+TEST(metrics, histogram_and_export) {
+  auto* histogram = MetricsRegistry::Instance().GetHistogram(
+      "test_latency_seconds", "A test histogram.", {}, {0.1, 1});
+  histogram->Observe(0.05);
+  histogram->Observe(0.5);
+  histogram->Observe(5);
+  auto counts = histogram->BucketCounts();
+  ASSERT_EQ(counts.size(), 3u);
+  EXPECT_EQ(counts[0], 1u);
+  EXPECT_EQ(counts[1], 1u);
+  EXPECT_EQ(counts[2], 1u);
+  EXPECT_DOUBLE_EQ(histogram->Sum(), 5.55);
+
+  MetricsRegistry::Instance().RegisterCallbackGauge(
+      "test_gauge", "A test gauge.", {{"device", "0"}}, [] { return 42.0; });
+  std::string text = MetricsRegistry::Instance().ExportPrometheusText();
+  EXPECT_NE(text.find("# TYPE test_latency_seconds histogram"),
+            std::string::npos);
+  EXPECT_NE(text.find("test_latency_seconds_bucket{le=\"+Inf\"} 3"),
+            std::string::npos);
+  EXPECT_NE(text.find("test_gauge{device=\"0\"} 42"), std::string::npos);
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -25,7 +25,9 @@
 #include "gtest/gtest.h"
 #include "paddle/phi/backends/context_pool.h"
 #include "paddle/phi/backends/gpu/gpu_info.h"
+#include "paddle/phi/common/memory_utils.h"
 #include "paddle/phi/common/place.h"
+#include "paddle/phi/core/lod_utils.h"
 #include "paddle/phi/core/mixed_vector.h"
 
 template <typename T>
@@ -109,3 +111,26 @@ TEST(mixed_vector, MultiGPU) {
     ASSERT_EQ(tmp[i], i * 100);
   }
 }
+
+TEST(lod_utils, CachedDeviceLoDOffsets) {
+  phi::GPUPlace gpu(0);
+  std::vector<size_t> offsets = {0, 3, 4, 9};
+  const size_t* ptr = phi::GetCachedDeviceLoDOffsets(gpu, offsets);
+  // The same offsets are read from the cache.
+  std::vector<size_t> same_offsets = offsets;
+  ASSERT_EQ(phi::GetCachedDeviceLoDOffsets(gpu, same_offsets), ptr);
+
+  std::vector<size_t> other_offsets = {0, 3, 4, 10};
+  const size_t* other_ptr = phi::GetCachedDeviceLoDOffsets(gpu, other_offsets);
+  ASSERT_NE(other_ptr, ptr);
+
+  std::vector<size_t> host(offsets.size());
+  phi::memory_utils::Copy(phi::CPUPlace(),
+                          host.data(),
+                          gpu,
+                          other_ptr,
+                          host.size() * sizeof(size_t),
+                          GetCUDAStream(gpu));
+  phi::DeviceContextPool::Instance().Get(gpu)->Wait();
+  ASSERT_EQ(host, other_offsets);
+}
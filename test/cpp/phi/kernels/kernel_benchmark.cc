@@ -0,0 +1,392 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+// A benchmark of the phi kernels, which runs the kernels selected from the
+// KernelFactory over sweeps of shapes, dtypes and layouts, reports the
+// achieved bandwidth and throughput, and compares the time to a baseline.
+//
+//   phi_kernel_benchmark --cases=add,matmul --dtypes=float32,float16 \
+//       --place=gpu --baseline=baseline.txt [--update_baseline]
+//
+// The shapes of a case are given as --shapes=add:1024x1024;4096x4096 to
+// override the default sweep, where a matmul shape is MxNxK.
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/fluid/memory/allocation/allocator_strategy.h"
+#include "paddle/fluid/platform/init.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/compat/convert_utils.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/kernel_context.h"
+#include "paddle/phi/core/kernel_factory.h"
+#include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/core/visit_type.h"
+#include "paddle/utils/flags.h"
+#include "paddle/utils/string/split.h"
+
+#ifdef PADDLE_WITH_CUDA
+#include <cuda_runtime.h>
+#endif
+
+PD_DEFINE_string(cases, "", "The cases to run, all cases if empty.");
+PD_DEFINE_string(dtypes, "float32", "The dtypes to sweep.");
+PD_DEFINE_string(layout, "ANYLAYOUT", "The layout of the kernels.");
+PD_DEFINE_string(place, "cpu", "The place to run, cpu or gpu.");
+PD_DEFINE_string(shapes, "", "The shapes to sweep, as case:AxB;CxD,case:..");
+PD_DEFINE_int32(burning, 10, "Burning times.");
+PD_DEFINE_int32(repeat, 100, "Repeat times.");
+PD_DEFINE_double(peak_gbps, 0, "The peak bandwidth, queried if 0.");
+PD_DEFINE_double(peak_tflops, 0, "The peak throughput of the device.");
+PD_DEFINE_string(baseline, "", "The file of the baseline to compare.");
+PD_DEFINE_bool(update_baseline, false, "Write the results to the baseline.");
+PD_DEFINE_double(threshold, 0.1, "The slowdown reported as a regression.");
+
+namespace phi {
+namespace benchmark {
+
+using Shape = std::vector<int64_t>;
+
+// The tensors of a case, and the bytes it moves and the flops it computes.
+struct BenchInputs {
+  std::vector<std::shared_ptr<DenseTensor>> inputs;
+  std::vector<std::shared_ptr<DenseTensor>> outputs;
+  std::function<void(KernelContext*)> emplace_attrs = [](KernelContext*) {};
+  double bytes = 0;
+  double flops = 0;
+};
+
+struct BenchCase {
+  std::string name;
+  std::string kernel_name;
+  std::vector<Shape> default_shapes;
+  std::function<BenchInputs(const DeviceContext&, DataType, const Shape&)>
+      prepare;
+};
+
+template <typename T>
+static void FillRandom(DenseTensor* t) {
+  std::mt19937 rng(2023);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  T* data = t->data<T>();
+  for (int64_t i = 0; i < t->numel(); ++i) {
+    data[i] = static_cast<T>(dist(rng));
+  }
+}
+
+static std::shared_ptr<DenseTensor> RandomTensor(const DeviceContext& dev_ctx,
+                                                 DataType dtype,
+                                                 const Shape& shape) {
+  DenseTensor host;
+  host.Resize(common::make_ddim(shape));
+  host.set_type(dtype);
+  auto* cpu_ctx = DeviceContextPool::Instance().Get(CPUPlace());
+  cpu_ctx->Alloc(&host, dtype);
+  PD_VISIT_FLOATING_AND_HALF_TYPES(
+      dtype, "RandomTensor", ([&] { FillRandom<data_t>(&host); }));
+  auto t = std::make_shared<DenseTensor>();
+  Copy(dev_ctx, host, dev_ctx.GetPlace(), true, t.get());
+  return t;
+}
+
+static std::shared_ptr<DenseTensor> EmptyTensor(DataType dtype,
+                                                const Shape& shape) {
+  auto t = std::make_shared<DenseTensor>();
+  t->Resize(common::make_ddim(shape));
+  t->set_type(dtype);
+  return t;
+}
+
+static int64_t Numel(const Shape& shape) {
+  int64_t numel = 1;
+  for (auto d : shape) numel *= d;
+  return numel;
+}
+
+static std::vector<BenchCase> AllCases() {
+  std::vector<BenchCase> cases;
+  cases.push_back(
+      {"add",
+       "add",
+       {{1 << 20}, {1024, 1024}, {4096, 4096}},
+       [](const DeviceContext& dev_ctx, DataType dtype, const Shape& shape) {
+         BenchInputs b;
+         b.inputs = {RandomTensor(dev_ctx, dtype, shape),
+                     RandomTensor(dev_ctx, dtype, shape)};
+         b.outputs = {EmptyTensor(dtype, shape)};
+         b.bytes = 3.0 * Numel(shape) * SizeOf(dtype);
+         b.flops = Numel(shape);
+         return b;
+       }});
+  cases.push_back(
+      {"relu",
+       "relu",
+       {{1 << 20}, {1024, 1024}, {4096, 4096}},
+       [](const DeviceContext& dev_ctx, DataType dtype, const Shape& shape) {
+         BenchInputs b;
+         b.inputs = {RandomTensor(dev_ctx, dtype, shape)};
+         b.outputs = {EmptyTensor(dtype, shape)};
+         b.bytes = 2.0 * Numel(shape) * SizeOf(dtype);
+         b.flops = Numel(shape);
+         return b;
+       }});
+  cases.push_back(
+      {"softmax",
+       "softmax",
+       {{128, 1024}, {4096, 1024}, {1024, 32000}},
+       [](const DeviceContext& dev_ctx, DataType dtype, const Shape& shape) {
+         BenchInputs b;
+         b.inputs = {RandomTensor(dev_ctx, dtype, shape)};
+         b.outputs = {EmptyTensor(dtype, shape)};
+         b.emplace_attrs = [](KernelContext* ctx) {
+           ctx->EmplaceBackAttr(-1);
+         };
+         b.bytes = 2.0 * Numel(shape) * SizeOf(dtype);
+         // max, sub, exp, sum and div of each element.
+         b.flops = 5.0 * Numel(shape);
+         return b;
+       }});
+  cases.push_back(
+      {"matmul",
+       "matmul",
+       {{1024, 1024, 1024}, {4096, 4096, 4096}, {8192, 1024, 4096}},
+       [](const DeviceContext& dev_ctx, DataType dtype, const Shape& shape) {
+         PADDLE_ENFORCE_EQ(
+             shape.size(),
+             3,
+             errors::InvalidArgument("The shape of matmul should be MxNxK."));
+         const int64_t m = shape[0], n = shape[1], k = shape[2];
+         BenchInputs b;
+         b.inputs = {RandomTensor(dev_ctx, dtype, {m, k}),
+                     RandomTensor(dev_ctx, dtype, {k, n})};
+         b.outputs = {EmptyTensor(dtype, {m, n})};
+         b.emplace_attrs = [](KernelContext* ctx) {
+           ctx->EmplaceBackAttr(false);
+           ctx->EmplaceBackAttr(false);
+         };
+         b.bytes = static_cast<double>(m * k + k * n + m * n) * SizeOf(dtype);
+         b.flops = 2.0 * m * n * k;
+         return b;
+       }});
+  return cases;
+}
+
+static DataType ParseDataType(const std::string& str) {
+  static const std::map<std::string, DataType> kDataTypes = {
+      {"float32", DataType::FLOAT32},
+      {"float64", DataType::FLOAT64},
+      {"float16", DataType::FLOAT16},
+      {"bfloat16", DataType::BFLOAT16}};
+  auto iter = kDataTypes.find(str);
+  PADDLE_ENFORCE_EQ(
+      iter != kDataTypes.end(),
+      true,
+      errors::InvalidArgument("The dtype %s is not supported.", str));
+  return iter->second;
+}
+
+static Shape ParseShape(const std::string& str) {
+  Shape shape;
+  for (auto& d : paddle::string::Split(str, 'x')) {
+    shape.push_back(std::stoll(d));
+  }
+  return shape;
+}
+
+// Parses --shapes=add:1024x1024;4096x4096,matmul:1024x1024x1024.
+static std::map<std::string, std::vector<Shape>> ParseShapes(
+    const std::string& str) {
+  std::map<std::string, std::vector<Shape>> shapes;
+  if (str.empty()) return shapes;
+  for (auto& item : paddle::string::Split(str, ',')) {
+    auto pos = item.find(':');
+    PADDLE_ENFORCE_NE(pos,
+                      std::string::npos,
+                      errors::InvalidArgument(
+                          "The shapes should be given as case:AxB;CxD, but "
+                          "received %s.",
+                          item));
+    for (auto& s : paddle::string::Split(item.substr(pos + 1), ';')) {
+      shapes[item.substr(0, pos)].push_back(ParseShape(s));
+    }
+  }
+  return shapes;
+}
+
+static std::string ShapeToString(const Shape& shape) {
+  std::ostringstream os;
+  for (size_t i = 0; i < shape.size(); ++i) {
+    os << (i ? "x" : "") << shape[i];
+  }
+  return os.str();
+}
+
+static double PeakGBps(const Place& place) {
+  if (FLAGS_peak_gbps > 0) return FLAGS_peak_gbps;
+#ifdef PADDLE_WITH_CUDA
+  if (place.GetType() == AllocationType::GPU) {
+    int clock_khz = 0, bus_width = 0;
+    cudaDeviceGetAttribute(
+        &clock_khz, cudaDevAttrMemoryClockRate, place.GetDeviceId());
+    cudaDeviceGetAttribute(
+        &bus_width, cudaDevAttrGlobalMemoryBusWidth, place.GetDeviceId());
+    // Double data rate.
+    return 2.0 * clock_khz * 1e3 * (bus_width / 8) / 1e9;
+  }
+#endif
+  return 0;
+}
+
+// The baseline is a text file of "key time_us" lines.
+static std::map<std::string, double> LoadBaseline(const std::string& path) {
+  std::map<std::string, double> baseline;
+  std::ifstream fin(path);
+  std::string key;
+  double time_us;
+  while (fin >> key >> time_us) {
+    baseline[key] = time_us;
+  }
+  return baseline;
+}
+
+static double TimeKernel(const DeviceContext& dev_ctx,
+                         const Kernel& kernel,
+                         KernelContext* ctx) {
+  for (int i = 0; i < FLAGS_burning; ++i) {
+    kernel(ctx);
+  }
+  dev_ctx.Wait();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < FLAGS_repeat; ++i) {
+    kernel(ctx);
+  }
+  dev_ctx.Wait();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() /
+         FLAGS_repeat;
+}
+
+int RunAllBenchmarks() {
+  Place place = FLAGS_place == "gpu" ? Place(GPUPlace(0)) : Place(CPUPlace());
+  Backend backend = TransToPhiBackend(place);
+  DataLayout layout = common::StringToDataLayout(FLAGS_layout);
+  const auto& dev_ctx = *DeviceContextPool::Instance().Get(place);
+  const double peak_gbps = PeakGBps(place);
+  auto shapes = ParseShapes(FLAGS_shapes);
+  auto case_names = paddle::string::Split(FLAGS_cases, ',');
+  auto baseline = LoadBaseline(FLAGS_baseline);
+  std::map<std::string, double> results;
+  int regressions = 0;
+
+  std::cout << std::left << std::setw(44) << "case" << std::right
+            << std::setw(12) << "time(us)" << std::setw(10) << "GB/s"
+            << std::setw(10) << "TFLOP/s" << std::setw(10) << "%peak"
+            << std::setw(12) << "baseline" << std::endl;
+  for (auto& bench : AllCases()) {
+    if (!FLAGS_cases.empty() &&
+        std::find(case_names.begin(), case_names.end(), bench.name) ==
+            case_names.end()) {
+      continue;
+    }
+    auto iter = shapes.find(bench.name);
+    const auto& sweep =
+        iter == shapes.end() ? bench.default_shapes : iter->second;
+    for (auto& dtype_str : paddle::string::Split(FLAGS_dtypes, ',')) {
+      DataType dtype = ParseDataType(dtype_str);
+      KernelKey key(backend, layout, dtype);
+      if (!KernelFactory::Instance().HasKernel(bench.kernel_name, key)) {
+        LOG(WARNING) << "Skip " << bench.name << ", no kernel of " << key;
+        continue;
+      }
+      const auto& kernel =
+          KernelFactory::Instance().SelectKernel(bench.kernel_name, key);
+      for (auto& shape : sweep) {
+        BenchInputs b = bench.prepare(dev_ctx, dtype, shape);
+        KernelContext ctx(const_cast<DeviceContext*>(&dev_ctx));
+        for (auto& t : b.inputs) ctx.EmplaceBackInput(t.get());
+        b.emplace_attrs(&ctx);
+        for (auto& t : b.outputs) ctx.EmplaceBackOutput(t.get());
+
+        double time_us = TimeKernel(dev_ctx, kernel, &ctx);
+        double gbps = b.bytes / time_us / 1e3;
+        double tflops = b.flops / time_us / 1e6;
+        // The kernel is bound by the memory or the compute, whichever is
+        // closer to its peak.
+        double percent = 0;
+        if (peak_gbps > 0) percent = gbps / peak_gbps * 100;
+        if (FLAGS_peak_tflops > 0) {
+          percent = std::max(percent, tflops / FLAGS_peak_tflops * 100);
+        }
+        std::string name = bench.name + "." + dtype_str + "." + FLAGS_layout +
+                           "." + FLAGS_place + "." + ShapeToString(shape);
+        results[name] = time_us;
+
+        std::cout << std::left << std::setw(44) << name << std::right
+                  << std::fixed << std::setprecision(2) << std::setw(12)
+                  << time_us << std::setw(10) << gbps << std::setw(10)
+                  << tflops << std::setw(10) << percent;
+        auto base = baseline.find(name);
+        if (base != baseline.end()) {
+          bool regressed = time_us > base->second * (1 + FLAGS_threshold);
+          regressions += regressed;
+          std::cout << std::setw(12) << base->second
+                    << (regressed ? "  REGRESSION" : "");
+        }
+        std::cout << std::endl;
+      }
+    }
+  }
+
+  if (FLAGS_update_baseline && !FLAGS_baseline.empty()) {
+    for (auto& item : results) {
+      baseline[item.first] = item.second;
+    }
+    std::ofstream fout(FLAGS_baseline);
+    for (auto& item : baseline) {
+      fout << item.first << " " << item.second << "\n";
+    }
+    LOG(INFO) << "Write " << results.size() << " results to "
+              << FLAGS_baseline;
+  }
+  if (regressions > 0) {
+    LOG(ERROR) << regressions << " cases are slower than the baseline by "
+               << FLAGS_threshold * 100 << "%.";
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace benchmark
+}  // namespace phi
+
+int main(int argc, char* argv[]) {
+  paddle::flags::ParseCommandLineFlags(&argc, &argv);
+  google::InitGoogleLogging(argv[0]);
+  paddle::framework::InitMemoryMethod();
+  paddle::framework::InitDevices();
+  return phi::benchmark::RunAllBenchmarks();
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/funcs/batched_memcpy.h"
+
+namespace phi {
+namespace tests {
+
+TEST(BatchedMemcpy, SmallAndLargeCopies) {
+  phi::CPUPlace cpu_place;
+  phi::GPUPlace gpu_place(0);
+  auto* context = reinterpret_cast<phi::GPUContext*>(
+      phi::DeviceContextPool::Instance().Get(gpu_place));
+
+  // The copies of the aligned, unaligned, empty and large sizes, and one
+  // of the host memory.
+  const std::vector<size_t> sizes = {
+      64, 3, 0, 1000, funcs::kBatchedMemcpyMaxKernelBytes + 5, 17};
+  const std::vector<size_t> offsets = {0, 1, 0, 7, 0, 3};
+  size_t total = 0;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    total += sizes[i] + offsets[i] + 16;
+  }
+
+  phi::DenseTensor host_src, src, dst, host_dst;
+  host_src.Resize({static_cast<int64_t>(total)});
+  uint8_t* host_src_ptr = context->HostAlloc<uint8_t>(&host_src);
+  for (size_t i = 0; i < total; ++i) {
+    host_src_ptr[i] = static_cast<uint8_t>(i * 7 + 1);
+  }
+  phi::Copy(*context, host_src, gpu_place, true, &src);
+  dst.Resize({static_cast<int64_t>(total)});
+  context->Alloc<uint8_t>(&dst);
+
+  std::vector<void*> dsts;
+  std::vector<const void*> srcs;
+  size_t begin = 0;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    dsts.push_back(dst.data<uint8_t>() + begin + offsets[i]);
+    srcs.push_back(i + 1 == sizes.size()
+                       ? host_src_ptr + begin
+                       : src.data<uint8_t>() + begin + offsets[i]);
+    begin += sizes[i] + offsets[i] + 16;
+  }
+  funcs::BatchedMemcpyAsync(gpu_place, context->stream(), dsts, srcs, sizes);
+  phi::Copy(*context, dst, cpu_place, true, &host_dst);
+
+  const uint8_t* host_dst_ptr = host_dst.data<uint8_t>();
+  begin = 0;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    const size_t dst_begin = begin + offsets[i];
+    const size_t src_begin = i + 1 == sizes.size() ? begin : dst_begin;
+    for (size_t j = 0; j < sizes[i]; ++j) {
+      ASSERT_EQ(host_dst_ptr[dst_begin + j], host_src_ptr[src_begin + j]);
+    }
+    begin += sizes[i] + offsets[i] + 16;
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -15,6 +15,8 @@
 #include <gtest/gtest.h>
 
 #include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <functional>
 
 #include "paddle/phi/kernels/autotune/cache.h"
@@ -66,3 +68,58 @@ TEST(AlgosCache, AlgosCache) {
   EXPECT_EQ(autotune_cache.CacheMisses(), 2);
   EXPECT_LT(std::abs(cache_hit_rate - autotune_cache.CacheHitRate()), 1e-5);
 }
+
+TEST(AlgosCache, SaveAndLoad) {
+  auto& autotune_cache = phi::autotune::AutoTuneCache::Instance();
+  autotune_cache.Clean();
+  auto& conv_cache =
+      autotune_cache.GetConv(phi::autotune::AlgorithmType::kConvForward);
+  auto& transpose_cache =
+      autotune_cache.Get(phi::autotune::AlgorithmType::kTranspose);
+
+  phi::DataType dtype = phi::CppTypeToDataType<float>::Type();
+  phi::autotune::ConvCacheKey key(
+      {4, 224, 224, 3}, {32, 3, 3, 3}, {2, 2}, {0, 0}, {1, 1}, dtype, 1, 0);
+  phi::autotune::ConvCacheKey heuristic_key(
+      {4, 128, 128, 3}, {32, 3, 3, 3}, {2, 2}, {0, 0}, {1, 1}, dtype, 1, 0);
+  phi::autotune::ConvAutoTuneResult searched(
+      static_cast<int64_t>(ConvAlgos::CuDNNKernel_2), 64, true);
+  searched.candidates = {{ConvAlgos::CuDNNKernel_2, 64},
+                         {ConvAlgos::GEMMKernel, 16}};
+  conv_cache.Set(key, searched);
+  conv_cache.Set(heuristic_key,
+                 phi::autotune::ConvAutoTuneResult(
+                     static_cast<int64_t>(ConvAlgos::CuDNNKernel_1), 0, false));
+  transpose_cache.Set(1234, 3);
+  autotune_cache.GetMatmul().Set(5678, 2);
+
+  const std::string path = "./autotune_cache_test";
+  EXPECT_TRUE(autotune_cache.SaveToFile(path));
+  autotune_cache.Clean();
+  EXPECT_EQ(conv_cache.Size(), 0);
+  EXPECT_TRUE(autotune_cache.LoadFromFile(path));
+
+  // only the exhaustive search results of conv are saved
+  EXPECT_EQ(conv_cache.Size(), 1);
+  EXPECT_TRUE(conv_cache.Find(key));
+  EXPECT_FALSE(conv_cache.Find(heuristic_key));
+  auto result = conv_cache.Get(key);
+  EXPECT_EQ(result.algo, ConvAlgos::CuDNNKernel_2);
+  EXPECT_EQ(result.workspace_size, 64UL);
+  EXPECT_TRUE(result.exhaustive_search);
+  EXPECT_EQ(result.candidates, searched.candidates);
+  EXPECT_TRUE(transpose_cache.Find(1234));
+  EXPECT_EQ(transpose_cache.Get(1234), 3);
+  EXPECT_EQ(autotune_cache.GetMatmul().Get(5678), 2);
+
+  // the broken file is not loaded
+  {
+    std::ofstream fout(path, std::ios::app);
+    fout << "conv 1 2\n";
+  }
+  autotune_cache.Clean();
+  EXPECT_FALSE(autotune_cache.LoadFromFile(path));
+  EXPECT_EQ(conv_cache.Size(), 0);
+  EXPECT_FALSE(autotune_cache.LoadFromFile("./autotune_cache_not_exist"));
+  std::remove(path.c_str());
+}
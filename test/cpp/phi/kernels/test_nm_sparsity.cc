@@ -0,0 +1,79 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/kernels/funcs/sparse/nm_sparsity.h"
+
+namespace phi {
+namespace tests {
+
+TEST(nm_sparsity, prune_and_check) {
+  std::vector<float> in{1, -4, 2, 3, 0.5, 0, -0.1, 0.2};
+  std::vector<float> out(in.size());
+  EXPECT_FALSE(funcs::sparse::IsNMSparse(in.data(), 1, 8, 2, 4));
+  funcs::sparse::PruneNM(in.data(), 1, 8, 2, 4, out.data());
+  std::vector<float> ret{0, -4, 0, 3, 0.5, 0, 0, 0.2};
+  EXPECT_EQ(out, ret);
+  EXPECT_TRUE(funcs::sparse::IsNMSparse(out.data(), 1, 8, 2, 4));
+}
+
+TEST(nm_sparsity, compressed_matmul) {
+  const int batch = 3, rows = 5, cols = 16;
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  std::vector<float> x(batch * cols), w(rows * cols), pruned(rows * cols);
+  for (auto& v : x) v = dist(rng);
+  for (auto& v : w) v = dist(rng);
+  funcs::sparse::PruneNM(w.data(), rows, cols, 2, 4, pruned.data());
+
+  std::vector<float> values(rows * cols / 2);
+  std::vector<uint8_t> indices(rows * cols / 2);
+  funcs::sparse::CompressNM(
+      pruned.data(), rows, cols, 2, 4, values.data(), indices.data());
+  std::vector<float> out(batch * rows);
+  funcs::sparse::NMSparseMatmul(x.data(),
+                                batch,
+                                values.data(),
+                                indices.data(),
+                                rows,
+                                cols,
+                                2,
+                                4,
+                                out.data());
+
+  // the same as the dense matmul of the pruned weight
+  for (int b = 0; b < batch; ++b) {
+    for (int r = 0; r < rows; ++r) {
+      float ref = 0.f;
+      for (int c = 0; c < cols; ++c) {
+        ref += x[b * cols + c] * pruned[r * cols + c];
+      }
+      EXPECT_NEAR(out[b * rows + r], ref, 1e-5);
+    }
+  }
+}
+
+TEST(nm_sparsity, compress_not_sparse) {
+  std::vector<float> in{1, 2, 3, 0};
+  std::vector<float> values(2);
+  std::vector<uint8_t> indices(2);
+  EXPECT_ANY_THROW(funcs::sparse::CompressNM(
+      in.data(), 1, 4, 2, 4, values.data(), indices.data()));
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,95 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "paddle/phi/api/lib/utils/allocator.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/pstring.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/string_tensor.h"
+#include "paddle/phi/kernels/strings/strings_wordpiece_tokenize_kernel.h"
+
+namespace phi {
+namespace tests {
+
+using pstring = ::phi::dtype::pstring;
+
+static StringTensor MakeStringTensor(const std::vector<std::string>& strs) {
+  static const auto string_allocator =
+      std::make_unique<paddle::experimental::DefaultAllocator>(phi::CPUPlace());
+  StringTensor tensor(string_allocator.get(),
+                      StringTensorMeta({static_cast<int64_t>(strs.size())}));
+  auto* dev_ctx = phi::DeviceContextPool::Instance().Get(phi::CPUPlace());
+  pstring* data = dev_ctx->template Alloc<pstring>(&tensor);
+  for (size_t i = 0; i < strs.size(); ++i) {
+    data[i] = strs[i];
+  }
+  return tensor;
+}
+
+TEST(DEV_API, strings_wordpiece_tokenize) {
+  StringTensor vocab = MakeStringTensor({"[PAD]",
+                                         "[UNK]",
+                                         "[CLS]",
+                                         "[SEP]",
+                                         "hello",
+                                         "world",
+                                         "##s",
+                                         "un",
+                                         "##aff",
+                                         "##able",
+                                         ",",
+                                         "\xe4\xb8\xad",
+                                         "\xe6\x96\x87"});
+  std::string repeated;
+  for (int i = 0; i < 20; ++i) repeated += "hello ";
+  StringTensor x = MakeStringTensor(
+      {"Hello worlds, unaffable \xe4\xb8\xad\xe6\x96\x87 xyz", repeated});
+
+  auto* dev_ctx = static_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  DenseTensor ids, seq_lens;
+  phi::strings::StringsWordPieceTokenizeKernel<phi::CPUContext>(
+      *dev_ctx, x, vocab, true, 16, 100, 1, 0, 2, 3, &ids, &seq_lens);
+
+  ASSERT_EQ(ids.dims(), common::make_ddim({2, 16}));
+  const int64_t* ids_data = ids.data<int64_t>();
+  const int64_t* seq_lens_data = seq_lens.data<int64_t>();
+
+  // hello world ##s , un ##aff ##able 中 文 [UNK], wrapped and padded.
+  std::vector<int64_t> expected = {2, 4, 5, 6, 10, 7, 8, 9, 11, 12, 1, 3};
+  ASSERT_EQ(seq_lens_data[0], static_cast<int64_t>(expected.size()));
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(ids_data[i], expected[i]);
+  }
+  for (int64_t i = expected.size(); i < 16; ++i) {
+    ASSERT_EQ(ids_data[i], 0);
+  }
+
+  // Truncated to 14 words, and still ended by [SEP].
+  ASSERT_EQ(seq_lens_data[1], 16);
+  ASSERT_EQ(ids_data[16], 2);
+  for (int64_t i = 1; i < 15; ++i) {
+    ASSERT_EQ(ids_data[16 + i], 4);
+  }
+  ASSERT_EQ(ids_data[31], 3);
+}
+
+}  // namespace tests
+}  // namespace phi
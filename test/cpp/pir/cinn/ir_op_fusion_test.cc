@@ -24,6 +24,8 @@
 #include "paddle/pir/core/ir_context.h"
 #include "paddle/pir/core/program.h"
 
+PD_DECLARE_bool(cinn_fuse_independent_groups);
+
 std::vector<pir::Value> BuildInput(
     ::pir::Builder* builder,
     const std::vector<std::vector<int64_t>>& vec_shapes) {
@@ -621,3 +623,38 @@ TEST(IROpFusionPass, layer_norm2) {
   ASSERT_EQ(new_group.size(), 1u);
   ASSERT_EQ(new_group[0]->ops.size(), program.block()->size());
 }
+
+TEST(IROpFusionPass, independent_groups) {
+  ::pir::IrContext* ctx = ::pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<cinn::dialect::OperatorDialect>();
+  ::pir::Program program_base(ctx);
+  ::pir::Builder builder_base = ::pir::Builder(ctx, program_base.block());
+
+  auto inputs = BuildInput(&builder_base, {{16, 16}, {16, 16}, {32, 32}});
+
+  ::pir::Program program(ctx);
+  ::pir::Builder builder = ::pir::Builder(ctx, program.block());
+
+  // two slot branches of the same size and one of another size
+  auto relu = builder.Build<paddle::dialect::ReluOp>(inputs[0]).result(0);
+  builder.Build<paddle::dialect::ExpOp>(relu);
+  auto tanh = builder.Build<paddle::dialect::TanhOp>(inputs[1]).result(0);
+  builder.Build<paddle::dialect::ExpOp>(tanh);
+  builder.Build<paddle::dialect::ReluOp>(inputs[2]);
+
+  std::vector<pir::Operation*> vec_op;
+  for (auto& op : *program.block()) {
+    vec_op.push_back(&op);
+  }
+
+  auto res = cinn::dialect::ir::OpFusionPassInternal(vec_op);
+  ASSERT_EQ(res.size(), 3u);
+  ASSERT_EQ(cinn::dialect::ir::GeneralFusionMergePassInternal(res).size(), 3u);
+
+  FLAGS_cinn_fuse_independent_groups = true;
+  auto new_group = cinn::dialect::ir::GeneralFusionMergePassInternal(
+      cinn::dialect::ir::OpFusionPassInternal(vec_op));
+  FLAGS_cinn_fuse_independent_groups = false;
+  ASSERT_EQ(new_group.size(), 2u);
+}
@@ -25,6 +25,7 @@
 #include "paddle/cinn/hlir/dialect/operator/ir/op_dialect.h"
 #include "paddle/cinn/hlir/dialect/runtime/ir/jit_kernel_op.h"
 #include "paddle/cinn/hlir/dialect/runtime/ir/runtime_dialect.h"
+#include "paddle/cinn/hlir/framework/pir/compilation_cache.h"
 #include "paddle/cinn/hlir/framework/pir_compiler.h"
 #include "paddle/cinn/utils/data_util.h"
 #include "paddle/fluid/framework/new_executor/interpretercore.h"
@@ -274,6 +275,35 @@ TEST(PirCompier, CompileGroupOps) {
   }
 }
 
+TEST(PirCompier, GroupSignature) {
+  ::pir::IrContext* ctx = ::pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ::pir::Program program(ctx);
+  ::pir::Builder builder = ::pir::Builder(ctx, program.block());
+
+  auto BuildTanRelu = [&](const std::vector<int64_t>& shape) {
+    auto full_op = builder.Build<paddle::dialect::FullOp>(
+        shape, 1.0f, phi::DataType::FLOAT32, phi::GPUPlace());
+    auto tan_op = builder.Build<paddle::dialect::TanOp>(full_op->result(0));
+    auto relu_op = builder.Build<paddle::dialect::ReluOp>(tan_op->result(0));
+    auto group =
+        std::make_shared<Group>(std::initializer_list<::pir::Operation*>(
+            {tan_op.operation(), relu_op.operation()}));
+    group->output_ops.insert(relu_op.operation());
+    return cinn::hlir::framework::pir::BuildGroupSignature(group);
+  };
+  auto signature_x = BuildTanRelu({64, 128});
+  auto signature_y = BuildTanRelu({64, 128});
+  auto signature_z = BuildTanRelu({32, 128});
+
+  // the groups of the same ops and shapes share a kernel
+  EXPECT_EQ(signature_x.Key(), signature_y.Key());
+  EXPECT_EQ(signature_x.values.size(), 3u);
+  // a group of new shapes only differs in the shapes
+  EXPECT_EQ(signature_x.structure, signature_z.structure);
+  EXPECT_NE(signature_x.shapes, signature_z.shapes);
+}
+
 TEST(RuntimeDialect, CompilerAndRun) {
   // Step 1: Construct pir::Program
   auto prog_info = BuildProgram();
@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
@@ -300,3 +302,30 @@ TEST(type_test, get_type_name) {
   auto name = pir::get_type_name<TestNamespace::TestClass>();
   EXPECT_EQ(name, "TestNamespace::TestClass");
 }
+
+TEST(type_test, concurrent_uniquing) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  pir::Type fp32_dtype = pir::Float32Type::get(ctx);
+
+  // The threads create the vector types of the same parameters at the same
+  // time, every parameter should be uniqued to one storage.
+  constexpr int kNumThreads = 8;
+  constexpr int kNumTypes = 64;
+  std::vector<std::vector<pir::Type>> types(kNumThreads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      for (int j = 0; j < kNumTypes; ++j) {
+        types[i].push_back(pir::VectorType::get(
+            ctx, std::vector<pir::Type>(j + 1, fp32_dtype)));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int i = 1; i < kNumThreads; ++i) {
+    EXPECT_EQ(types[i], types[0]);
+  }
+}
@@ -426,6 +426,47 @@ TEST(pattern_rewrite, Patterns) {
   EXPECT_EQ(program.block()->size(), 17u);
 }
 
+TEST(pattern_rewrite, IncrementalWorklist) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+
+  pir::Program program(ctx);
+  pir::Builder builder = pir::Builder(ctx, program.block());
+  auto full_op =
+      builder.Build<paddle::dialect::FullOp>(std::vector<int64_t>{2, 3, 4},
+                                             1.5,
+                                             phi::DataType::FLOAT32,
+                                             phi::CPUPlace());
+  auto transpose1_op = builder.Build<paddle::dialect::TransposeOp>(
+      full_op.out(), std::vector<int>{1, 2, 0});
+  auto transpose2_op = builder.Build<paddle::dialect::TransposeOp>(
+      transpose1_op.out(), std::vector<int>{1, 2, 0});
+  auto transpose3_op = builder.Build<paddle::dialect::TransposeOp>(
+      transpose2_op.out(), std::vector<int>{1, 2, 0});
+  auto fetch_op =
+      builder.Build<paddle::dialect::FetchOp>(transpose3_op.out(), "out", 0);
+
+  pir::RewritePatternSet ps(ctx);
+  ps.Add<RedundantTransposeFusePattern>(ctx);
+  pir::FrozenRewritePatternSet patterns(std::move(ps));
+
+  // The transpose fused from the first two is revisited through the
+  // worklist, so the chain is folded without rescanning the block.
+  pir::GreedyRewriteConfig cfg;
+  cfg.use_top_down_traversal = true;
+  cfg.use_incremental_worklist = true;
+  cfg.enable_pattern_statistics = true;
+  auto [converged, num_rewrites] =
+      pir::ApplyPatternsGreedily(program.module_op(), patterns, cfg);
+  EXPECT_TRUE(converged);
+  EXPECT_EQ(num_rewrites, 2);
+
+  auto *last_op = pir::GetDefiningOpForInput(fetch_op, 0);
+  EXPECT_TRUE(last_op->isa<paddle::dialect::TransposeOp>());
+  EXPECT_EQ(pir::GetDefiningOpForInput(last_op, 0), full_op.operation());
+}
+
 void BuildConstantFoldingProgram(pir::Program *program,
                                  pir::IrContext *ctx,
                                  paddle::framework::Scope *scope) {
@@ -0,0 +1,100 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/transforms/transfer_layout_pass.h"
+#include "paddle/pir/core/builtin_attribute.h"
+#include "paddle/pir/core/builtin_dialect.h"
+#include "paddle/pir/pass/pass_manager.h"
+
+// full(x) -> conv2d -> add(bias) -> relu -> conv2d -> fetch
+void BuildProgram(pir::Builder &builder, phi::DataType dtype) {  // NOLINT
+  auto x = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{1, 64, 56, 56}, 1.0, dtype, phi::GPUPlace());
+  auto filter1 = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{64, 64, 3, 3}, 1.0, dtype, phi::GPUPlace());
+  auto bias = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{1, 64, 1, 1}, 1.0, dtype, phi::GPUPlace());
+  auto conv1 =
+      builder.Build<paddle::dialect::Conv2dOp>(x.out(), filter1.out());
+  auto add = builder.Build<paddle::dialect::AddOp>(conv1.out(), bias.out());
+  auto relu = builder.Build<paddle::dialect::ReluOp>(add.out());
+  auto filter2 = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{64, 64, 3, 3}, 1.0, dtype, phi::GPUPlace());
+  auto conv2 =
+      builder.Build<paddle::dialect::Conv2dOp>(relu.out(), filter2.out());
+  builder.Build<paddle::dialect::FetchOp>(conv2.out(), "out", 0);
+}
+
+int CountTranspose(const pir::Program &program) {
+  int count = 0;
+  for (auto &op : *program.block()) {
+    if (op.isa<paddle::dialect::TransposeOp>()) ++count;
+  }
+  return count;
+}
+
+TEST(TransferLayoutPass, fp16_conv_chain) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  pir::Program program(ctx);
+  pir::Builder builder = pir::Builder(ctx, program.block());
+  BuildProgram(builder, phi::DataType::FLOAT16);
+  EXPECT_EQ(program.block()->size(), 9u);
+
+  pir::PassManager pm(ctx);
+  pm.AddPass(pir::CreateTransferLayoutPass());
+  CHECK_EQ(pm.Run(&program), true);
+
+  // the transposes are only at the boundaries: x, bias and the fetched out
+  EXPECT_EQ(CountTranspose(program), 3);
+  EXPECT_EQ(program.block()->size(), 12u);
+  for (auto &op : *program.block()) {
+    if (op.isa<paddle::dialect::Conv2dOp>()) {
+      EXPECT_EQ(op.attribute<pir::StrAttribute>("data_format").AsString(),
+                "NHWC");
+      auto type =
+          op.result(0).type().dyn_cast<paddle::dialect::DenseTensorType>();
+      EXPECT_EQ(type.dims()[3], 64);
+    }
+    if (op.isa<paddle::dialect::FetchOp>()) {
+      auto type = op.operand_source(0)
+                      .type()
+                      .dyn_cast<paddle::dialect::DenseTensorType>();
+      EXPECT_EQ(type.dims()[1], 64);
+    }
+  }
+}
+
+TEST(TransferLayoutPass, fp32_not_transferred) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  pir::Program program(ctx);
+  pir::Builder builder = pir::Builder(ctx, program.block());
+  BuildProgram(builder, phi::DataType::FLOAT32);
+
+  pir::PassManager pm(ctx);
+  pm.AddPass(pir::CreateTransferLayoutPass());
+  CHECK_EQ(pm.Run(&program), true);
+
+  EXPECT_EQ(CountTranspose(program), 0);
+  EXPECT_EQ(program.block()->size(), 9u);
+}
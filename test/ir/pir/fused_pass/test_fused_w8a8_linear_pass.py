@@ -0,0 +1,101 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+from pass_test import PassTest
+
+import paddle
+from paddle.base import core
+from paddle.pir.core import create_parameter
+
+np.random.seed(2013)
+
+import os
+import re
+
+
+def get_cuda_version():
+    result = os.popen("nvcc --version").read()
+    regex = r'release (\S+),'
+    match = re.search(regex, result)
+    if match:
+        num = str(match.group(1))
+        integer, decimal = num.split('.')
+        return int(integer) * 1000 + int(float(decimal) * 10)
+    else:
+        return -1
+
+
+def is_sm_supported():
+    major, minor = paddle.device.cuda.get_device_capability()
+    return major * 10 + minor in [75, 80, 86]
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda()
+    or get_cuda_version() < 11020
+    or not is_sm_supported(),
+    "w8a8_linear requires CUDA >= 11.2 and the int8 GEMM of SM 75, 80 or 86",
+)
+class TestFusedW8A8LinearPass(PassTest):
+    def setUp(self):
+        self.places.append(paddle.CUDAPlace(0))
+
+    def sample_program(self):
+        for act in [None, "relu", "gelu"]:
+            with paddle.pir_utils.IrGuard():
+                start_prog = paddle.static.Program()
+                main_prog = paddle.static.Program()
+                with paddle.pir.core.program_guard(main_prog, start_prog):
+                    x = paddle.static.data(
+                        name='x', shape=[3, 64, 64], dtype='float16'
+                    )
+                    w = create_parameter(
+                        shape=[64, 128],
+                        dtype='float16',
+                        initializer=paddle.nn.initializer.Normal(0.0, 0.02),
+                    )
+                    bias = paddle.static.data(
+                        name="bias", shape=[128], dtype='float16'
+                    )
+                    out = paddle.add(paddle.matmul(x=x, y=w), bias)
+                    if act == "relu":
+                        out = paddle.nn.functional.relu(out)
+                    elif act == "gelu":
+                        out = paddle.nn.functional.gelu(out)
+                    out = paddle.assign(out)
+                    self.pass_list = ['fused_w8a8_linear_pass']
+                    self.feeds = {
+                        "x": np.random.random((3, 64, 64)).astype('float16'),
+                        "bias": np.random.random([128]).astype('float16'),
+                    }
+                    self.fetch_list = [out]
+                    self.valid_op_map = {
+                        "pd_op.w8a8_linear": 1,
+                        "pd_op.weight_quantize": 1,
+                        "pd_op.matmul": 0,
+                        "pd_op.add": 0,
+                        "pd_op.relu": 0,
+                        "pd_op.gelu": 0,
+                    }
+                    yield [main_prog, start_prog], False
+
+    def test_check_output(self):
+        self.check_pass_correct(atol=1e-1, rtol=1e-2)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -123,6 +123,22 @@ class FusionGroupPassInplaceTest(FusionGroupPassTest):
         self.fetch_list = [tmp_3]
 
 
+class FusionGroupPassBroadcastTest(FusionGroupPassTest):
+    def build_program(self, dtype):
+        with base.program_guard(self.main_program, self.startup_program):
+            self.feed_vars = self._prepare_feed_vars([32, 128], dtype, 2)
+            self.feed_vars.append(
+                paddle.static.data(name="data2", shape=[128], dtype=dtype)
+            )
+
+            # subgraph with 3 op nodes, data2 is broadcast along the rows
+            tmp_0 = self.feed_vars[0] * self.feed_vars[1]
+            tmp_1 = paddle.nn.functional.relu(tmp_0 + self.feed_vars[2])
+
+        self.num_fused_ops = 1
+        self.fetch_list = [tmp_1]
+
+
 class FusionGroupPassTestFP64(FusionGroupPassTest):
     def setUp(self):
         self.build_program("float64")
@@ -0,0 +1,126 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+
+
+def brute_force(query, x, k):
+    dist = ((query[:, None, :] - x[None, :, :]) ** 2).sum(-1)
+    ids = np.argsort(dist, axis=1, kind="stable")[:, :k]
+    return np.take_along_axis(dist, ids, axis=1), ids
+
+
+def recall(ids, ref_ids):
+    hits = sum(len(set(a) & set(b)) for a, b in zip(ids, ref_ids))
+    return hits / ref_ids.size
+
+
+def reconstruct(centroids, codebooks, codes, list_offsets):
+    # The rows of the codes decoded to centroid + codewords.
+    m = codebooks.shape[0]
+    rows = np.concatenate(
+        [codebooks[j][codes[:, j]] for j in range(m)], axis=1
+    )
+    lists = np.repeat(np.arange(len(centroids)), np.diff(list_offsets))
+    return rows + centroids[lists]
+
+
+class TestIvfPq(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        np.random.seed(2023)
+        self.x = np.random.randn(3000, 16).astype("float32")
+        self.query = np.random.randn(20, 16).astype("float32")
+
+    def build(self):
+        paddle.set_device("cpu")
+        index = paddle.incubate.ivf_pq_build(
+            paddle.to_tensor(self.x[:2000]), nlist=8, m=4, ksub=32, iters=5
+        )
+        codes, list_offsets, ids = paddle.incubate.ivf_pq_add(
+            paddle.to_tensor(self.x[2000:]), *index
+        )
+        return [index[0], index[1], codes, list_offsets, ids]
+
+    def test_build_and_add(self):
+        centroids, codebooks, codes, list_offsets, ids = self.build()
+        self.assertEqual(codes.shape, [3000, 4])
+        self.assertEqual(str(codes.dtype), "paddle.uint8")
+        np.testing.assert_array_equal(np.sort(ids.numpy()), np.arange(3000))
+        self.assertEqual(list_offsets.numpy()[-1], 3000)
+
+    def check_search(self, place):
+        index = self.build()
+        paddle.set_device(place)
+        if place == "gpu":
+            index = [t.cuda() for t in index]
+        distances, ids = paddle.incubate.ivf_pq_search(
+            paddle.to_tensor(self.query), *index, k=10, nprobe=8
+        )
+        # With all the lists probed, the results are the nearest of the
+        # quantized rows.
+        centroids, codebooks, codes, list_offsets, row_ids = (
+            t.numpy() for t in index
+        )
+        rows = reconstruct(centroids, codebooks, codes, list_offsets)
+        ref_dist, ref_pos = brute_force(self.query, rows, 10)
+        np.testing.assert_allclose(
+            distances.numpy(), ref_dist, rtol=1e-4, atol=1e-4
+        )
+        self.assertGreater(recall(ids.numpy(), row_ids[ref_pos]), 0.95)
+
+    def test_search_cpu(self):
+        self.check_search("cpu")
+
+    @unittest.skipIf(
+        not paddle.is_compiled_with_cuda(), "ivf_pq_search on GPU needs CUDA"
+    )
+    def test_search_gpu(self):
+        self.check_search("gpu")
+
+    def test_search_padding(self):
+        index = self.build()
+        distances, ids = paddle.incubate.ivf_pq_search(
+            paddle.to_tensor(self.query), *index, k=3000, nprobe=1
+        )
+        self.assertTrue(np.any(ids.numpy() == -1))
+        self.assertTrue(np.all(np.isinf(distances.numpy()[ids.numpy() == -1])))
+
+
+class TestHnsw(unittest.TestCase):
+    def test_build_add_search(self):
+        paddle.disable_static()
+        paddle.set_device("cpu")
+        np.random.seed(2023)
+        x = np.random.randn(2000, 16).astype("float32")
+        query = np.random.randn(50, 16).astype("float32")
+        graph = paddle.incubate.hnsw_build(paddle.to_tensor(x[:1000]), m=16)
+        graph = paddle.incubate.hnsw_add(paddle.to_tensor(x), *graph)
+        self.assertEqual(graph[1].shape, [2001])
+        distances, ids = paddle.incubate.hnsw_search(
+            paddle.to_tensor(query), paddle.to_tensor(x), *graph, k=10
+        )
+        ref_dist, ref_ids = brute_force(query, x, 10)
+        self.assertGreater(recall(ids.numpy(), ref_ids), 0.95)
+        np.testing.assert_allclose(
+            distances.numpy()[:, 0], ref_dist[:, 0], rtol=1e-4, atol=1e-4
+        )
+
+
+if __name__ == "__main__":
+    unittest.main()
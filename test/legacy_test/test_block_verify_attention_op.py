@@ -0,0 +1,142 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.framework import core
+from paddle.incubate.nn.functional import block_verify_attention
+
+np.random.seed(2023)
+
+
+def verify_attention_ref(
+    qkv, key_cache, value_cache, seq_lens_decoder, seq_lens_this_time, tables
+):
+    num_head, block_size, dim_head = key_cache.shape[1:]
+    hidden = num_head * dim_head
+    key_cache = key_cache.copy()
+    value_cache = value_cache.copy()
+    out = np.zeros([qkv.shape[0], hidden], dtype='float32')
+    t = 0
+    for b, (dec_len, this_len) in enumerate(
+        zip(seq_lens_decoder, seq_lens_this_time)
+    ):
+        for i in range(this_len):
+            pos = dec_len + i
+            block = tables[b][pos // block_size]
+            k = qkv[t + i, hidden : 2 * hidden].reshape(num_head, dim_head)
+            v = qkv[t + i, 2 * hidden :].reshape(num_head, dim_head)
+            key_cache[block, :, pos % block_size] = k
+            value_cache[block, :, pos % block_size] = v
+        for i in range(this_len):
+            kv_len = dec_len + i + 1
+            blocks = [tables[b][j // block_size] for j in range(kv_len)]
+            offsets = [j % block_size for j in range(kv_len)]
+            q = qkv[t + i, :hidden].reshape(num_head, dim_head)
+            for h in range(num_head):
+                k = key_cache[blocks, h, offsets]
+                v = value_cache[blocks, h, offsets]
+                s = k @ q[h] / np.sqrt(dim_head)
+                p = np.exp(s - s.max())
+                out[t + i, h * dim_head : (h + 1) * dim_head] = (
+                    p / p.sum()
+                ) @ v
+        t += this_len
+    return out, key_cache, value_cache
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestBlockVerifyAttentionOp(unittest.TestCase):
+    def setUp(self):
+        self.num_head = 4
+        self.dim_head = 64
+        self.block_size = 16
+        self.max_blocks_per_seq = 12
+        # the second sequence has more than a tile of cached positions
+        self.seq_lens_decoder = [5, 150, 31]
+        self.seq_lens_this_time = [4, 4, 1]
+        self.dtype = 'float32'
+        self.atol = 1e-4
+        paddle.disable_static()
+        paddle.set_device('gpu')
+
+    def test_verify_attention(self):
+        bsz = len(self.seq_lens_decoder)
+        num_blocks = bsz * self.max_blocks_per_seq
+        tables = (
+            np.random.permutation(num_blocks)
+            .reshape(bsz, self.max_blocks_per_seq)
+            .astype('int32')
+        )
+        cache_shape = [
+            num_blocks,
+            self.num_head,
+            self.block_size,
+            self.dim_head,
+        ]
+        key_cache = np.random.uniform(-1, 1, cache_shape).astype(self.dtype)
+        value_cache = np.random.uniform(-1, 1, cache_shape).astype(self.dtype)
+        token_num = sum(self.seq_lens_this_time)
+        qkv = np.random.uniform(
+            -1, 1, [token_num, 3 * self.num_head * self.dim_head]
+        ).astype(self.dtype)
+        cu_seqlens_q = np.cumsum([0, *self.seq_lens_this_time]).astype('int32')
+
+        ref_out, ref_key_cache, ref_value_cache = verify_attention_ref(
+            qkv.astype('float32'),
+            key_cache.astype('float32'),
+            value_cache.astype('float32'),
+            self.seq_lens_decoder,
+            self.seq_lens_this_time,
+            tables,
+        )
+        key_cache_tensor = paddle.to_tensor(key_cache)
+        value_cache_tensor = paddle.to_tensor(value_cache)
+        out = block_verify_attention(
+            paddle.to_tensor(qkv),
+            key_cache_tensor,
+            value_cache_tensor,
+            paddle.to_tensor(self.seq_lens_decoder, dtype='int32'),
+            paddle.to_tensor(self.seq_lens_this_time, dtype='int32'),
+            paddle.to_tensor(cu_seqlens_q),
+            paddle.to_tensor(tables),
+        )
+        np.testing.assert_allclose(
+            out.numpy().astype('float32'), ref_out, rtol=0, atol=self.atol
+        )
+        np.testing.assert_allclose(
+            key_cache_tensor.numpy().astype('float32'), ref_key_cache
+        )
+        np.testing.assert_allclose(
+            value_cache_tensor.numpy().astype('float32'), ref_value_cache
+        )
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestBlockVerifyAttentionOpFp16(TestBlockVerifyAttentionOp):
+    def setUp(self):
+        super().setUp()
+        self.dtype = 'float16'
+        self.atol = 5e-3
+
+
+if __name__ == '__main__':
+    unittest.main()
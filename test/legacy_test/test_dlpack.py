@@ -122,11 +122,41 @@ class TestDLPack(unittest.TestCase):
             x = paddle.rand([3, 5])
             dlpack = paddle.utils.dlpack.to_dlpack(x)
 
+    def test_from_dlpack_no_copy(self):
+        paddle.disable_static()
+        x = paddle.rand([3, 5])
+        out = paddle.utils.dlpack.from_dlpack(paddle.utils.dlpack.to_dlpack(x))
+        self.assertEqual(x.data_ptr(), out.data_ptr())
+
+    def test_dlpack_protocol(self):
+        paddle.disable_static()
+        x = paddle.rand([3, 5])
+        device_type = 2 if x.place.is_gpu_place() else 1
+        self.assertEqual(x.__dlpack_device__()[0], device_type)
+        out = paddle.utils.dlpack.from_dlpack(x)
+        self.assertEqual(x.data_ptr(), out.data_ptr())
+
+        data = np.random.rand(4, 6).astype('float32')
+        out = paddle.utils.dlpack.from_dlpack(data)
+        np.testing.assert_array_equal(out.numpy(), data)
+
+    def test_to_dlpack_list(self):
+        paddle.disable_static()
+        xs = [paddle.rand([3, 5]), paddle.rand([2]), paddle.rand([4, 1])]
+        stream = None
+        if paddle.is_compiled_with_cuda():
+            xs = [x.cuda() for x in xs]
+            stream = paddle.device.Stream().stream_base.cuda_stream
+        dlpacks = paddle.utils.dlpack.to_dlpack_list(xs, stream=stream)
+        for x, dlpack in zip(xs, dlpacks):
+            out = paddle.utils.dlpack.from_dlpack(dlpack)
+            np.testing.assert_array_equal(out.numpy(), x.numpy())
+
 
 class TestRaiseError(unittest.TestCase):
     def test_from_dlpack_raise_type_error(self):
         self.assertRaises(
-            TypeError, paddle.utils.dlpack.from_dlpack, np.zeros(5)
+            TypeError, paddle.utils.dlpack.from_dlpack, [0.0] * 5
         )
 
     def test_to_dlpack_raise_type_error(self):
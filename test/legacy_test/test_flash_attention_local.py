@@ -0,0 +1,184 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+import paddle.nn.functional as F
+from paddle.nn.functional.flash_attention import (
+    flash_attn_kv_cache,
+    flash_attn_local,
+)
+
+
+def attention_ref(q, k, v, window_size, alibi_slopes, causal):
+    # q [batch, seqlen_q, heads, dim], k and v [batch, seqlen_k, heads_k, dim]
+    seqlen_q, num_heads, head_dim = q.shape[1], q.shape[2], q.shape[3]
+    seqlen_k, num_heads_k = k.shape[1], k.shape[2]
+    group = num_heads // num_heads_k
+    k = paddle.repeat_interleave(k, group, axis=2)
+    v = paddle.repeat_interleave(v, group, axis=2)
+    scores = paddle.einsum("bqhd,bkhd->bhqk", q, k) / np.sqrt(head_dim)
+
+    pos = np.arange(seqlen_q)[:, None] + seqlen_k - seqlen_q
+    key = np.arange(seqlen_k)[None, :]
+    left, right = window_size
+    if causal:
+        right = 0
+    mask = np.zeros([seqlen_q, seqlen_k], dtype=bool)
+    if left >= 0:
+        mask |= key < pos - left
+    if right >= 0:
+        mask |= key > pos + right
+    bias = np.where(mask, -np.inf, 0.0)[None, None, :, :]
+    if alibi_slopes is not None:
+        bias = bias - alibi_slopes[None, :, None, None] * np.abs(pos - key)
+    scores = scores + paddle.to_tensor(bias.astype("float32"))
+    probs = F.softmax(scores, axis=-1)
+    return paddle.einsum("bhqk,bkhd->bqhd", probs, v)
+
+
+@unittest.skipIf(
+    not paddle.is_compiled_with_cuda(), "flash_attn_local needs CUDA"
+)
+class TestFlashAttnLocal(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        paddle.set_device("gpu")
+        np.random.seed(2023)
+        self.shape_q = [2, 33, 8, 32]
+        self.shape_k = [2, 33, 2, 32]
+        self.window_size = (7, 0)
+        self.alibi = None
+        self.causal = False
+
+    def random(self, shape):
+        return paddle.to_tensor(
+            np.random.uniform(-1, 1, shape).astype("float32"),
+            stop_gradient=False,
+        )
+
+    def test_local(self):
+        q = self.random(self.shape_q)
+        k = self.random(self.shape_k)
+        v = self.random(self.shape_k)
+        alibi = (
+            None
+            if self.alibi is None
+            else paddle.to_tensor(self.alibi.astype("float32"))
+        )
+        out = flash_attn_local(
+            q, k, v, self.window_size, alibi, causal=self.causal
+        )
+        dout = paddle.rand(out.shape)
+        grads = paddle.grad(out, [q, k, v], dout)
+
+        ref = attention_ref(q, k, v, self.window_size, self.alibi, self.causal)
+        ref_grads = paddle.grad(ref, [q, k, v], dout)
+        np.testing.assert_allclose(
+            out.numpy(), ref.numpy(), rtol=1e-4, atol=1e-4
+        )
+        for grad, ref_grad in zip(grads, ref_grads):
+            np.testing.assert_allclose(
+                grad.numpy(), ref_grad.numpy(), rtol=1e-4, atol=1e-4
+            )
+
+
+class TestFlashAttnLocalAlibiCausal(TestFlashAttnLocal):
+    def setUp(self):
+        super().setUp()
+        self.shape_q = [2, 17, 4, 64]
+        self.shape_k = [2, 40, 4, 64]
+        self.window_size = (-1, -1)
+        self.alibi = np.array([0.5, 0.25, 0.125, 0.0625])
+        self.causal = True
+
+
+@unittest.skipIf(
+    not paddle.is_compiled_with_cuda(), "flash_attn_local needs CUDA"
+)
+class TestFlashAttnLocalPacked(unittest.TestCase):
+    def test_packed(self):
+        paddle.disable_static()
+        paddle.set_device("gpu")
+        lens = [5, 12, 9]
+        cu_seqlens = paddle.to_tensor(np.cumsum([0, *lens]), dtype="int32")
+        q = paddle.rand([sum(lens), 4, 16])
+        k = paddle.rand([sum(lens), 2, 16])
+        v = paddle.rand([sum(lens), 2, 16])
+        out = flash_attn_local(
+            q,
+            k,
+            v,
+            (3, 0),
+            cu_seqlens_q=cu_seqlens,
+            cu_seqlens_k=cu_seqlens,
+        )
+        begin = 0
+        for length in lens:
+            end = begin + length
+            ref = attention_ref(
+                q[begin:end].unsqueeze(0),
+                k[begin:end].unsqueeze(0),
+                v[begin:end].unsqueeze(0),
+                (3, 0),
+                None,
+                False,
+            )
+            np.testing.assert_allclose(
+                out[begin:end].numpy(), ref[0].numpy(), rtol=1e-4, atol=1e-4
+            )
+            begin = end
+
+
+@unittest.skipIf(
+    not paddle.is_compiled_with_cuda(), "flash_attn_kv_cache needs CUDA"
+)
+class TestFlashAttnKVCache(unittest.TestCase):
+    def test_decode(self):
+        paddle.disable_static()
+        paddle.set_device("gpu")
+        lens = [3, 10]
+        cache_k = paddle.rand([2, 16, 2, 32])
+        cache_v = paddle.rand([2, 16, 2, 32])
+        q = paddle.rand([2, 1, 4, 32])
+        k = paddle.rand([2, 1, 2, 32])
+        v = paddle.rand([2, 1, 2, 32])
+        ref_cache_k = cache_k.numpy()
+        ref_cache_v = cache_v.numpy()
+        out = flash_attn_kv_cache(
+            q,
+            k,
+            v,
+            cache_k,
+            cache_v,
+            paddle.to_tensor(lens, dtype="int32"),
+        )
+        for b, length in enumerate(lens):
+            ref_cache_k[b, length] = k[b, 0].numpy()
+            ref_cache_v[b, length] = v[b, 0].numpy()
+            keys = paddle.to_tensor(ref_cache_k[b : b + 1, : length + 1])
+            values = paddle.to_tensor(ref_cache_v[b : b + 1, : length + 1])
+            ref = attention_ref(q[b : b + 1], keys, values, (-1, 0), None, True)
+            np.testing.assert_allclose(
+                out[b : b + 1].numpy(), ref.numpy(), rtol=1e-4, atol=1e-4
+            )
+        np.testing.assert_allclose(cache_k.numpy(), ref_cache_k)
+        np.testing.assert_allclose(cache_v.numpy(), ref_cache_v)
+
+
+if __name__ == "__main__":
+    unittest.main()
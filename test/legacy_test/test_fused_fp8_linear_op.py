@@ -0,0 +1,147 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import re
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.framework import core
+from paddle.incubate.nn.functional import fused_fp8_linear
+
+np.random.seed(2023)
+
+E4M3_MAX = 448.0
+
+
+def get_cuda_version():
+    result = os.popen("nvcc --version").read()
+    regex = r'release (\S+),'
+    match = re.search(regex, result)
+    if match:
+        num = str(match.group(1))
+        integer, decimal = num.split('.')
+        return int(integer) * 1000 + int(float(decimal) * 10)
+    else:
+        return -1
+
+
+def is_fp8_supported():
+    if not core.is_compiled_with_cuda() or get_cuda_version() < 11080:
+        return False
+    major, minor = paddle.device.cuda.get_device_capability()
+    return major * 10 + minor >= 89
+
+
+def quant_e4m3(x):
+    # round to the 3 mantissa bits of E4M3, ties to even, saturated
+    x = np.clip(x, -E4M3_MAX, E4M3_MAX)
+    _, exp = np.frexp(x)
+    step = np.ldexp(1.0, np.maximum(exp, -5) - 4)
+    return np.round(x / step) * step
+
+
+def fp8_linear_ref(x, weight, bias, x_scale, weight_scale):
+    x_fp8 = quant_e4m3(x * x_scale) / x_scale
+    weight_fp8 = quant_e4m3(weight * weight_scale) / weight_scale
+    out = np.matmul(x_fp8, weight_fp8)
+    if bias is not None:
+        out = out + bias
+    return out
+
+
+@unittest.skipIf(
+    not is_fp8_supported(),
+    "fused_fp8_linear needs CUDA 11.8 and the GPU of sm89 or later",
+)
+class TestFusedFp8LinearOp(unittest.TestCase):
+    def setUp(self):
+        self.m = 32
+        self.k = 64
+        self.n = 128
+        self.history_len = 4
+        self.margin = 0.0
+        self.dtype = 'float16'
+        self.has_bias = True
+
+    def test_delayed_scaling(self):
+        paddle.disable_static()
+        x_scale = paddle.ones([1], dtype='float32')
+        x_amax_history = paddle.zeros([self.history_len], dtype='float32')
+        weight_scale = paddle.ones([1], dtype='float32')
+        weight_amax_history = paddle.zeros(
+            [self.history_len], dtype='float32'
+        )
+        x_amaxes = []
+        for step in range(self.history_len + 2):
+            x_np = np.random.uniform(
+                -4.0 * (step + 1), 4.0 * (step + 1), [self.m, self.k]
+            ).astype(self.dtype)
+            weight_np = np.random.uniform(-1, 1, [self.k, self.n]).astype(
+                self.dtype
+            )
+            bias_np = (
+                np.random.uniform(-1, 1, [self.n]).astype(self.dtype)
+                if self.has_bias
+                else None
+            )
+            ref = fp8_linear_ref(
+                x_np.astype('float32'),
+                weight_np.astype('float32'),
+                bias_np.astype('float32') if self.has_bias else None,
+                x_scale.numpy()[0],
+                weight_scale.numpy()[0],
+            )
+            out = fused_fp8_linear(
+                paddle.to_tensor(x_np),
+                paddle.to_tensor(weight_np),
+                paddle.to_tensor(bias_np) if self.has_bias else None,
+                x_scale,
+                x_amax_history,
+                weight_scale,
+                weight_amax_history,
+                self.margin,
+            )
+            np.testing.assert_allclose(
+                out.numpy().astype('float32'), ref, rtol=1e-2, atol=1e-2
+            )
+
+            # the amax of this step scales the next step
+            x_amaxes.insert(0, np.abs(x_np.astype('float32')).max())
+            x_amaxes = x_amaxes[: self.history_len]
+            np.testing.assert_allclose(
+                x_amax_history.numpy()[: len(x_amaxes)], x_amaxes, rtol=1e-6
+            )
+            np.testing.assert_allclose(
+                x_scale.numpy()[0],
+                E4M3_MAX / max(x_amaxes) / 2**self.margin,
+                rtol=1e-6,
+            )
+
+
+@unittest.skipIf(
+    not is_fp8_supported(),
+    "fused_fp8_linear needs CUDA 11.8 and the GPU of sm89 or later",
+)
+class TestFusedFp8LinearOpMargin(TestFusedFp8LinearOp):
+    def setUp(self):
+        super().setUp()
+        self.margin = 1.0
+        self.has_bias = False
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,97 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+import paddle.nn.functional as F
+from paddle import _C_ops
+
+
+def places():
+    res = [paddle.CPUPlace()]
+    if paddle.is_compiled_with_cuda():
+        res.append(paddle.CUDAPlace(0))
+    return res
+
+
+class TestFusedLinearCrossEntropy(unittest.TestCase):
+    def setUp(self):
+        self.tokens = 13
+        self.hidden = 16
+        self.vocab = 37
+        self.chunk_size = 8
+        self.ignore_index = -100
+        np.random.seed(2023)
+        self.x = np.random.uniform(-1, 1, [self.tokens, self.hidden]).astype(
+            "float32"
+        )
+        self.weight = np.random.uniform(
+            -1, 1, [self.hidden, self.vocab]
+        ).astype("float32")
+        self.label = np.random.randint(
+            0, self.vocab, [self.tokens, 1]
+        ).astype("int64")
+        self.label[3] = self.ignore_index
+
+    def run_ground_truth(self):
+        x = paddle.to_tensor(self.x, stop_gradient=False)
+        weight = paddle.to_tensor(self.weight, stop_gradient=False)
+        logits = paddle.matmul(x, weight)
+        loss = F.cross_entropy(
+            logits,
+            paddle.to_tensor(self.label),
+            reduction="none",
+            ignore_index=self.ignore_index,
+        )
+        loss.sum().backward()
+        return loss.numpy(), x.grad.numpy(), weight.grad.numpy()
+
+    def run_fused(self):
+        x = paddle.to_tensor(self.x, stop_gradient=False)
+        weight = paddle.to_tensor(self.weight, stop_gradient=False)
+        loss = _C_ops.fused_linear_cross_entropy(
+            x,
+            weight,
+            paddle.to_tensor(self.label),
+            self.ignore_index,
+            self.chunk_size,
+            0,
+            -1,
+            1,
+        )
+        loss.sum().backward()
+        return loss.numpy(), x.grad.numpy(), weight.grad.numpy()
+
+    def test_chunked(self):
+        for place in places():
+            paddle.set_device(
+                "cpu" if isinstance(place, paddle.CPUPlace) else "gpu"
+            )
+            expected = self.run_ground_truth()
+            actual = self.run_fused()
+            for e, a in zip(expected, actual):
+                np.testing.assert_allclose(
+                    a.reshape(e.shape), e, rtol=1e-5, atol=1e-5
+                )
+
+    def test_chunk_larger_than_vocab(self):
+        self.chunk_size = 1024
+        self.test_chunked()
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,84 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.framework import core
+from paddle.incubate.nn.functional import fused_moe
+
+np.random.seed(2023)
+
+
+def fused_moe_ref(x, gate, w1, b1, w2, b2, top_k):
+    x = x.reshape([-1, x.shape[-1]])
+    gate = gate.reshape([x.shape[0], -1])
+    probs = np.exp(gate - gate.max(axis=-1, keepdims=True))
+    probs /= probs.sum(axis=-1, keepdims=True)
+    out = np.zeros_like(x)
+    for t in range(x.shape[0]):
+        for e in np.argsort(-probs[t], kind='stable')[:top_k]:
+            h = np.maximum(x[t] @ w1[e] + b1[e, 0], 0)
+            out[t] += probs[t, e] * (h @ w2[e] + b2[e, 0])
+    return out
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestFusedMoeOp(unittest.TestCase):
+    def setUp(self):
+        self.num_tokens = 37
+        self.num_experts = 8
+        self.d_model = 64
+        self.d_feed_forward = 128
+        self.top_k = 2
+        self.dtype = 'float32'
+        self.atol = 1e-4
+        paddle.disable_static()
+        paddle.set_device('gpu')
+
+    def test_fused_moe(self):
+        e, d, f = self.num_experts, self.d_model, self.d_feed_forward
+        x = np.random.randn(self.num_tokens, d).astype('float32') * 0.1
+        # the distinct gate logits keep the top_k experts of a token unique
+        gate = np.random.permutation(self.num_tokens * e).astype('float32')
+        gate = gate.reshape([self.num_tokens, e]) / gate.size
+        w1 = np.random.randn(e, d, f).astype('float32') * 0.1
+        b1 = np.random.randn(e, 1, f).astype('float32') * 0.1
+        w2 = np.random.randn(e, f, d).astype('float32') * 0.1
+        b2 = np.random.randn(e, 1, d).astype('float32') * 0.1
+
+        tensors = [
+            paddle.to_tensor(v, dtype=self.dtype)
+            for v in (x, gate, w1, b1, w2, b2)
+        ]
+        out = fused_moe(*tensors, top_k=self.top_k, act_type='relu')
+        ref = fused_moe_ref(x, gate, w1, b1, w2, b2, self.top_k)
+        np.testing.assert_allclose(
+            out.astype('float32').numpy(), ref, rtol=self.atol, atol=self.atol
+        )
+
+
+class TestFusedMoeOpFp16(TestFusedMoeOp):
+    def setUp(self):
+        super().setUp()
+        self.dtype = 'float16'
+        self.atol = 1e-2
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,82 @@
+#   Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+from op_test import OpTest
+
+
+class TestFusedMultiEmbeddingSeqPoolOp(OpTest):
+    def setUp(self):
+        self.op_type = "fused_multi_embedding_seq_pool"
+        self.emb_size = 16
+        self.table_height = 20
+        self.padding_idx = -1
+        self.lods = [[2, 0, 3], [1, 1, 1], [3, 2, 1]]
+        self.table = np.random.random(
+            (self.table_height, self.emb_size)
+        ).astype("float64")
+
+        ids = []
+        outs = []
+        for slot, lod in enumerate(self.lods):
+            slot_ids = np.random.randint(
+                0, self.table_height, (sum(lod), 1)
+            ).astype("int64")
+            ids.append(('ids' + str(slot), (slot_ids, [lod])))
+            offset = 0
+            pooled = []
+            for length in lod:
+                seq = slot_ids[offset : offset + length].flatten()
+                seq = seq[seq != self.padding_idx]
+                pooled.append(self.table[seq].sum(axis=0))
+                offset += length
+            outs.append(np.array(pooled).reshape([len(lod), self.emb_size]))
+
+        self.attrs = {'padding_idx': self.padding_idx, 'is_sparse': False}
+        self.inputs = {'W': self.table, 'Ids': ids}
+        self.outputs = {'Out': np.concatenate(outs, axis=1)}
+
+    def test_check_output(self):
+        # TODO(wangzhongpu): support lod in dygraph mode
+        self.check_output(check_dygraph=False)
+
+    def test_check_grad(self):
+        # TODO(wangzhongpu): support lod in dygraph mode
+        self.check_grad(['W'], 'Out', no_grad_set=['Ids'], check_dygraph=False)
+
+
+class TestFusedMultiEmbeddingSeqPoolOpWithPadding(
+    TestFusedMultiEmbeddingSeqPoolOp
+):
+    def setUp(self):
+        super().setUp()
+        self.padding_idx = int(self.inputs['Ids'][0][1][0][0][0])
+        self.attrs['padding_idx'] = self.padding_idx
+        outs = []
+        for _, (slot_ids, lod) in self.inputs['Ids']:
+            offset = 0
+            pooled = []
+            for length in lod[0]:
+                seq = slot_ids[offset : offset + length].flatten()
+                seq = seq[seq != self.padding_idx]
+                pooled.append(self.table[seq].sum(axis=0))
+                offset += length
+            outs.append(np.array(pooled).reshape([len(lod[0]), self.emb_size]))
+        self.outputs = {'Out': np.concatenate(outs, axis=1)}
+
+
+if __name__ == "__main__":
+    unittest.main()
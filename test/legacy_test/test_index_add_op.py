@@ -361,6 +361,35 @@ class TestIndexAddAPICase5(TestIndexAddAPI):
         self.add_value_shape = (10, 4)
 
 
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestIndexAddDeterministic(unittest.TestCase):
+    def test_dynamic(self):
+        paddle.disable_static(paddle.CUDAPlace(0))
+        x_np = np.random.random((3, 10, 4)).astype("float32")
+        index_np = np.random.randint(0, 10, (50,)).astype("int64")
+        value_np = np.random.random((3, 50, 4)).astype("float32")
+        paddle.set_flags({"FLAGS_cudnn_deterministic": True})
+        try:
+            outs = [
+                paddle.index_add(
+                    paddle.to_tensor(x_np),
+                    paddle.to_tensor(index_np),
+                    1,
+                    paddle.to_tensor(value_np),
+                ).numpy()
+                for _ in range(2)
+            ]
+        finally:
+            paddle.set_flags({"FLAGS_cudnn_deterministic": False})
+        ref_out = compute_index_add_ref(
+            1, x_np.shape, x_np, value_np.shape, value_np, 50, index_np
+        )
+        np.testing.assert_allclose(outs[0], ref_out, rtol=1e-5, atol=1e-5)
+        np.testing.assert_array_equal(outs[0], outs[1])
+
+
 # class TestIndexAddAPIError(unittest.TestCase):
 
 #     def test_errors(self):
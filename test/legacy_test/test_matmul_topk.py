@@ -0,0 +1,84 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+
+
+def matmul_topk_ref(x, y, k, largest):
+    scores = x @ y.T
+    order = np.argsort(-scores if largest else scores, axis=1, kind="stable")
+    indices = order[:, :k]
+    return np.take_along_axis(scores, indices, axis=1), indices
+
+
+class TestMatmulTopk(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        paddle.set_device("cpu")
+        np.random.seed(2023)
+        self.m, self.n, self.d = 70, 9000, 16
+        self.k = 10
+        self.largest = True
+        self.dtype = "float32"
+
+    def test_matmul_topk(self):
+        x = np.random.uniform(-1, 1, [self.m, self.d]).astype(self.dtype)
+        y = np.random.uniform(-1, 1, [self.n, self.d]).astype(self.dtype)
+        values, indices = paddle.incubate.matmul_topk(
+            paddle.to_tensor(x), paddle.to_tensor(y), self.k, self.largest
+        )
+        ref_values, ref_indices = matmul_topk_ref(x, y, self.k, self.largest)
+        np.testing.assert_allclose(
+            values.numpy(), ref_values, rtol=1e-5, atol=1e-5
+        )
+        np.testing.assert_array_equal(indices.numpy(), ref_indices)
+
+
+class TestMatmulTopkSmallest(TestMatmulTopk):
+    def setUp(self):
+        super().setUp()
+        self.m, self.n, self.d = 3, 50, 8
+        self.k = 50
+        self.largest = False
+        self.dtype = "float64"
+
+
+class TestTopkLargeWidth(unittest.TestCase):
+    def test_topk_matches_argsort(self):
+        paddle.disable_static()
+        paddle.set_device("cpu")
+        x = np.random.uniform(-1, 1, [17, 5000]).astype("float32")
+        x[3, 100] = np.nan
+        for largest in [True, False]:
+            values, indices = paddle.topk(
+                paddle.to_tensor(x), k=8, largest=largest
+            )
+            sorted_values = paddle.sort(paddle.to_tensor(x), descending=largest)
+            sorted_indices = paddle.argsort(
+                paddle.to_tensor(x), descending=largest
+            )
+            np.testing.assert_array_equal(
+                indices.numpy(), sorted_indices.numpy()[:, :8]
+            )
+            np.testing.assert_array_equal(
+                values.numpy(), sorted_values.numpy()[:, :8]
+            )
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -274,6 +274,28 @@ class TestNanInfCheckResult(TestNanInfBase):
                 use_cuda=True, dtype="float16", level=level
             )
 
+    def test_check_nan_inf_async(self):
+        if not paddle.base.core.is_compiled_with_cuda():
+            return
+        paddle.set_flags(
+            {
+                "FLAGS_check_nan_inf": 1,
+                "FLAGS_check_nan_inf_level": 0,
+                "FLAGS_check_nan_inf_async_interval": 1024,
+            }
+        )
+        paddle.device.set_device("gpu:0")
+        x = paddle.to_tensor(np.array([1.0, 2.0], dtype="float32"))
+        y = paddle.to_tensor(np.array([-1.0, 1.0], dtype="float32"))
+        out = paddle.exp(x) + paddle.log(y)
+        # The tensors are checked without synchronizing and are reported
+        # when the flags are read.
+        with self.assertRaises(Exception) as context:
+            paddle.base.core.check_nan_inf_flags()
+        self.assertIn("log", str(context.exception))
+        paddle.base.core.check_nan_inf_flags()
+        paddle.set_flags({"FLAGS_check_nan_inf_async_interval": 0})
+
 
 class TestCheckNumericsAPI(TestNanInfBase):
     def test_eager(self):
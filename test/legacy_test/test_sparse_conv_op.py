@@ -130,6 +130,38 @@ class TestSparseConv(unittest.TestCase):
             sparse_x.indices().numpy(), y.indices().numpy()
         )
 
+    def test_subm_conv3d_auto_rulebook(self):
+        if not core.is_compiled_with_cuda():
+            return
+        paddle.seed(0)
+        x = paddle.randn([1, 4, 4, 4, 3])
+        weights = [paddle.randn((3, 3, 3, 3, 3)) for _ in range(3)]
+
+        def run(key):
+            sp_x = x.to_sparse_coo(4)
+            sp_x.stop_gradient = False
+            y = sp_x
+            for weight in weights:
+                y = paddle.sparse.nn.functional.subm_conv3d(
+                    y, weight, key=key
+                )
+            y.to_dense().sum().backward()
+            return y, sp_x.grad
+
+        # The keyless layers of the same indices reuse the rulebook of the
+        # first of them, as the keyed layers do.
+        auto_out, auto_grad = run(None)
+        key_out, key_grad = run('subm_conv')
+        np.testing.assert_array_equal(
+            auto_out.indices().numpy(), key_out.indices().numpy()
+        )
+        np.testing.assert_allclose(
+            auto_out.values().numpy(), key_out.values().numpy(), rtol=1e-5
+        )
+        np.testing.assert_allclose(
+            auto_grad.values().numpy(), key_grad.values().numpy(), rtol=1e-5
+        )
+
     def test_Conv2D(self):
         # (3, non_zero_num), 3-D:(N, H, W)
         indices = [[0, 0, 0, 0], [0, 0, 1, 2], [1, 3, 2, 3]]
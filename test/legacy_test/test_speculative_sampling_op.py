@@ -0,0 +1,104 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.framework import core
+from paddle.incubate.nn.functional import speculative_sampling
+
+np.random.seed(2023)
+
+
+def random_probs(shape):
+    x = np.random.uniform(0.1, 1.0, shape).astype('float32')
+    return x / x.sum(axis=-1, keepdims=True)
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestSpeculativeSamplingOp(unittest.TestCase):
+    def setUp(self):
+        self.bsz = 4
+        self.num_draft = 3
+        self.vocab_size = 1000
+        paddle.disable_static()
+        paddle.set_device('gpu')
+
+    def test_accept_all(self):
+        # the draft of the target distribution is never rejected
+        probs = random_probs([self.bsz, self.num_draft + 1, self.vocab_size])
+        draft_tokens = np.random.randint(
+            0, self.vocab_size, [self.bsz, self.num_draft]
+        ).astype('int64')
+        accept_tokens, accept_num = speculative_sampling(
+            paddle.to_tensor(draft_tokens),
+            paddle.to_tensor(probs[:, : self.num_draft]),
+            paddle.to_tensor(probs),
+            seed=2023,
+        )
+        np.testing.assert_array_equal(
+            accept_num.numpy(), [self.num_draft + 1] * self.bsz
+        )
+        np.testing.assert_array_equal(
+            accept_tokens.numpy()[:, : self.num_draft], draft_tokens
+        )
+
+    def test_reject(self):
+        # the target puts all the mass on token 7, so the first draft token
+        # not 7 is rejected and 7 is sampled from the residual
+        draft_probs = random_probs([self.bsz, self.num_draft, self.vocab_size])
+        target_probs = np.zeros(
+            [self.bsz, self.num_draft + 1, self.vocab_size], dtype='float32'
+        )
+        target_probs[:, :, 7] = 1.0
+        draft_tokens = np.full([self.bsz, self.num_draft], 7, dtype='int64')
+        draft_tokens[:, 1] = 8
+        accept_tokens, accept_num = speculative_sampling(
+            paddle.to_tensor(draft_tokens),
+            paddle.to_tensor(draft_probs),
+            paddle.to_tensor(target_probs),
+        )
+        np.testing.assert_array_equal(accept_num.numpy(), [2] * self.bsz)
+        expected = np.full([self.bsz, self.num_draft + 1], -1, dtype='int64')
+        expected[:, :2] = 7
+        np.testing.assert_array_equal(accept_tokens.numpy(), expected)
+
+    def test_distribution(self):
+        # the first token follows the target probs whatever the draft is
+        bsz = 20000
+        vocab_size = 4
+        draft_probs = np.tile(
+            np.array([0.7, 0.1, 0.1, 0.1], dtype='float32'), [bsz, 1, 1]
+        )
+        target = np.array([0.1, 0.2, 0.3, 0.4], dtype='float32')
+        target_probs = np.tile(target, [bsz, 2, 1])
+        draft_tokens = np.random.choice(
+            vocab_size, [bsz, 1], p=draft_probs[0, 0]
+        )
+        accept_tokens, _ = speculative_sampling(
+            paddle.to_tensor(draft_tokens.astype('int64')),
+            paddle.to_tensor(draft_probs),
+            paddle.to_tensor(target_probs),
+            seed=7,
+        )
+        freq = np.bincount(accept_tokens.numpy()[:, 0], minlength=vocab_size)
+        np.testing.assert_allclose(freq / bsz, target, atol=0.02)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -595,6 +595,49 @@ class TestStride(unittest.TestCase):
 
         self.assertTrue(np.allclose(out_c.numpy(), np_out))
 
+    def call_compute_on_views(self):
+        x_np = np.random.random(size=[2, 3, 4, 5]).astype('float32')
+        y_np = np.random.random(size=[5, 3, 4]).astype('float32')
+        x = paddle.to_tensor(x_np)
+        y = paddle.to_tensor(y_np)
+
+        x_t = paddle.transpose(x, perm=[0, 3, 1, 2])
+        x_np_t = x_np.transpose(0, 3, 1, 2)
+        self.assertFalse(x_t.is_contiguous())
+        y_s = y[:, 1:, ::2]
+        y_np_s = y_np[:, 1:, ::2]
+        self.assertFalse(y_s.is_contiguous())
+
+        out = x_t + y
+        self.assertTrue(np.allclose(out.numpy(), x_np_t + y_np))
+        self.assertTrue(out.is_contiguous())
+        out = x_t - y
+        self.assertTrue(np.allclose(out.numpy(), x_np_t - y_np))
+        out = x_t[:, :, 1:, ::2] * y_s
+        self.assertTrue(
+            np.allclose(out.numpy(), x_np_t[:, :, 1:, ::2] * y_np_s)
+        )
+        out = y_s / (x_t[0, :, 1:, ::2] + 1)
+        self.assertTrue(
+            np.allclose(out.numpy(), y_np_s / (x_np_t[0, :, 1:, ::2] + 1))
+        )
+
+        out = paddle.cast(x_t, 'float64')
+        self.assertTrue(np.allclose(out.numpy(), x_np_t.astype('float64')))
+        self.assertTrue(out.is_contiguous())
+
+        out = paddle.sum(x_t, axis=1)
+        self.assertTrue(np.allclose(out.numpy(), x_np_t.sum(axis=1)))
+        self.assertTrue(out.is_contiguous())
+        out = paddle.sum(x_t, axis=[2, 3], keepdim=True)
+        self.assertTrue(
+            np.allclose(out.numpy(), x_np_t.sum(axis=(2, 3), keepdims=True))
+        )
+        out = paddle.sum(x_t, axis=0)
+        self.assertTrue(np.allclose(out.numpy(), x_np_t.sum(axis=0)))
+        out = paddle.sum(y_s)
+        self.assertTrue(np.allclose(out.numpy(), y_np_s.sum()))
+
     def call_stride(self):
         self.call_transpose()
         self.call_diagonal()
@@ -620,6 +663,7 @@ class TestStride(unittest.TestCase):
         self.call_view2()
         self.call_view_as()
         self.call_unfold()
+        self.call_compute_on_views()
 
 
 class TestStrideCPU(TestStride):
@@ -0,0 +1,221 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+from test_weight_only_linear import convert_uint16_to_float, get_cuda_version
+
+import paddle
+import paddle.nn.quant as Q
+from paddle import base
+from paddle.base import core
+from paddle.framework import set_default_dtype
+from paddle.pir_utils import test_with_pir_api
+
+np.random.seed(123)
+paddle.seed(42)
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda()
+    or get_cuda_version() < 11020
+    or paddle.device.cuda.get_device_capability()[0] < 8,
+    "quantized_matmul requires CUDA >= 11.2 and CUDA_ARCH >= 8",
+)
+class W8A8LinearTestCase(unittest.TestCase):
+    def config(self):
+        self.dtype = 'float16'
+        self.rtol = 1e-5
+        self.atol = 1e-1
+        self.bias = True
+        self.smooth = False
+        self.act_method = ""
+        self.batch = 1
+        self.token = 32
+        self.in_features = 64
+        self.out_features = 256
+        self.static = False
+
+    def setUp(self):
+        self.config()
+        x = np.random.random((self.batch, self.token, self.in_features))
+        self.x = paddle.to_tensor(x, dtype=self.dtype)
+        if self.bias:
+            bias_attr = base.ParamAttr(
+                trainable=False,
+                regularizer=None,
+                initializer=paddle.nn.initializer.Constant(value=1.0),
+            )
+        else:
+            bias_attr = None
+        set_default_dtype(self.dtype)
+        self.linear = paddle.nn.Linear(
+            self.in_features, self.out_features, bias_attr=bias_attr
+        )
+        if self.smooth:
+            smooth = np.random.uniform(0.5, 2.0, (self.in_features,))
+            self.smooth = paddle.to_tensor(smooth, dtype=self.dtype)
+        else:
+            self.smooth = None
+
+        self.bias = self.linear.bias
+        self.weight, self.weight_scale = Q.weight_quantize(
+            self.linear.weight, algo="llm.int8"
+        )
+
+    def get_linear_out(self):
+        x = self.x if self.smooth is None else self.x * self.smooth
+        out = self.linear(x)
+        if self.act_method == "gelu":
+            out = paddle.nn.functional.gelu(out)
+        elif self.act_method == "relu":
+            out = paddle.nn.functional.relu(out)
+        elif self.act_method == "swish":
+            out = paddle.nn.functional.swish(out)
+        return out.numpy()
+
+    def get_w8a8_linear_out(self):
+        out = Q.w8a8_linear(
+            self.x,
+            self.weight,
+            bias=self.bias,
+            weight_scale=self.weight_scale,
+            smooth=self.smooth,
+            act_method=self.act_method,
+        )
+        return out.numpy()
+
+    @test_with_pir_api
+    def get_w8a8_linear_out_static(self):
+        paddle.enable_static()
+        main = base.static.Program()
+        start = base.static.Program()
+        with base.static.program_guard(main, start):
+            x = paddle.static.data("x", self.x.shape, dtype=self.x.dtype)
+            weight = paddle.static.data(
+                "weight", self.weight.shape, dtype=self.weight.dtype
+            )
+            weight_scale = paddle.static.data(
+                "weight_scale",
+                self.weight_scale.shape,
+                dtype=self.weight_scale.dtype,
+            )
+            feed_dict = {
+                'x': self.x.numpy(),
+                'weight': self.weight.numpy(),
+                'weight_scale': self.weight_scale.numpy(),
+            }
+            bias = None
+            if self.bias is not None:
+                bias = paddle.static.data(
+                    "bias", self.bias.shape, dtype=self.bias.dtype
+                )
+                feed_dict['bias'] = self.bias.numpy()
+
+            out = Q.w8a8_linear(
+                x,
+                weight,
+                bias,
+                weight_scale,
+                act_method=self.act_method,
+            )
+            exe = base.Executor(paddle.CUDAPlace(0))
+            exe.run(start)
+            (out,) = exe.run(main, feed=feed_dict, fetch_list=[out])
+        paddle.disable_static()
+        return out
+
+    def test_w8a8_linear(self):
+        out_expect = self.get_linear_out()
+        if self.static:
+            out_real = self.get_w8a8_linear_out_static()
+        else:
+            out_real = self.get_w8a8_linear_out()
+
+        if self.dtype == "bfloat16":
+            out_real = convert_uint16_to_float(out_real)
+            out_expect = convert_uint16_to_float(out_expect)
+        np.testing.assert_allclose(
+            out_real, out_expect, rtol=self.rtol, atol=self.atol
+        )
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda()
+    or get_cuda_version() < 11020
+    or paddle.device.cuda.get_device_capability()[0] < 8,
+    "quantized_matmul requires CUDA >= 11.2 and CUDA_ARCH >= 8",
+)
+class W8A8LinearTestCase1(W8A8LinearTestCase):
+    def config(self):
+        super().config()
+        self.bias = False
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda()
+    or get_cuda_version() < 11020
+    or paddle.device.cuda.get_device_capability()[0] < 8,
+    "quantized_matmul requires CUDA >= 11.2 and CUDA_ARCH >= 8",
+)
+class W8A8LinearTestCase2(W8A8LinearTestCase):
+    def config(self):
+        super().config()
+        self.smooth = True
+        self.act_method = "gelu"
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda()
+    or get_cuda_version() < 11020
+    or paddle.device.cuda.get_device_capability()[0] < 8,
+    "quantized_matmul requires CUDA >= 11.2 and CUDA_ARCH >= 8",
+)
+class W8A8LinearTestCase3(W8A8LinearTestCase):
+    def config(self):
+        super().config()
+        self.act_method = "relu"
+        self.batch = 1
+        self.token = 1
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda()
+    or get_cuda_version() < 11020
+    or paddle.device.cuda.get_device_capability()[0] < 8
+    or not core.is_bfloat16_supported(core.CUDAPlace(0)),
+    "quantized_matmul requires CUDA >= 11.2 and CUDA_ARCH >= 8 or core is not support bfloat16",
+)
+class W8A8LinearTestCase4(W8A8LinearTestCase):
+    def config(self):
+        super().config()
+        self.dtype = 'bfloat16'
+        self.act_method = "swish"
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda()
+    or get_cuda_version() < 11020
+    or paddle.device.cuda.get_device_capability()[0] < 8,
+    "quantized_matmul requires CUDA >= 11.2 and CUDA_ARCH >= 8",
+)
+class W8A8LinearTestCase5(W8A8LinearTestCase):
+    def config(self):
+        super().config()
+        self.static = True
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -650,6 +650,83 @@ class WeightOnlyLinearTestCase29(WeightOnlyLinearTestCase):
         self.group_size = 128
 
 
+@unittest.skipIf(
+    not core.is_compiled_with_cuda()
+    or get_cuda_version() < 11020
+    or paddle.device.cuda.get_device_capability()[0] < 8,
+    "quantized_matmul requires CUDA >= 11.2 and CUDA_ARCH >= 8",
+)
+class WeightOnlyLinearTestCase30(WeightOnlyLinearTestCase):
+    def config(self):
+        super().config()
+        self.dtype = 'float16'
+        self.weight_dtype = "int4"
+        self.batch = 1
+        self.token = 12
+        self.in_features = 4096
+        self.group_size = 128
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda()
+    or get_cuda_version() < 11020
+    or paddle.device.cuda.get_device_capability()[0] < 8,
+    "quantized_matmul requires CUDA >= 11.2 and CUDA_ARCH >= 8",
+)
+class WeightOnlyLinearTestCase31(WeightOnlyLinearTestCase):
+    def config(self):
+        super().config()
+        self.dtype = 'float16'
+        self.weight_dtype = "int8"
+        self.atol = 5e-2
+        self.bias = False
+        self.batch = 2
+        self.token = 8
+        self.in_features = 8192
+        self.group_size = 64
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda()
+    or get_cuda_version() < 11020
+    or paddle.device.cuda.get_device_capability()[0] < 8,
+    "quantized_matmul requires CUDA >= 11.2 and CUDA_ARCH >= 8",
+)
+class WeightOnlyLinearActOrderTestCase(WeightOnlyLinearTestCase):
+    def config(self):
+        super().config()
+        self.dtype = 'float16'
+        self.weight_dtype = "int4"
+        self.batch = 1
+        self.token = 1
+        self.in_features = 256
+        self.group_size = 128
+
+    def setUp(self):
+        super().setUp()
+        # the rows of the weight are quantized in the act order
+        self.perm = paddle.to_tensor(
+            np.random.permutation(self.in_features).astype('int32')
+        )
+        self.weight, self.weight_scale = Q.weight_quantize(
+            paddle.index_select(self.float_weight, self.perm, axis=0).cpu(),
+            algo="weight_only_int4",
+            group_size=self.group_size,
+        )
+
+    def get_weight_only_linear_out(self):
+        out = Q.weight_only_linear(
+            self.x,
+            self.weight,
+            bias=self.bias,
+            weight_scale=self.weight_scale,
+            weight_dtype=self.weight_dtype,
+            group_size=self.group_size,
+            act_order_perm=self.perm,
+        )
+        return out.numpy()
+
+
 @unittest.skipIf(
     not core.is_compiled_with_cuda() or get_cuda_version() < 11020,
     "quantized_matmul requires CUDA >= 11.2 and CUDA_ARCH >= 8",
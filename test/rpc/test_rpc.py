@@ -104,6 +104,18 @@ class TestSingleProcessRpc(RpcTestBase):
         out = dist.rpc.rpc_async(worker_name(0), paddle_add, args=args).wait()
         np.testing.assert_allclose(out, res, rtol=1e-05)
 
+    def test_async_batch_rpc_paddle_add(self):
+        args_list = [
+            (np.random.random((10, 100)), np.random.random((10, 100)))
+            for _ in range(4)
+        ]
+        futs = dist.rpc.rpc_async_batch(worker_name(0), paddle_add, args_list)
+        self.assertEqual(len(futs), len(args_list))
+        for fut, (a, b) in zip(futs, args_list):
+            out = fut.wait()
+            self.assertTrue(fut.done())
+            np.testing.assert_allclose(out, np.add(a, b), rtol=1e-05)
+
     def test_get_worker_info(self):
         info = dist.rpc.get_worker_info(worker_name(0))
         self.assertEqual(info.name, worker_name(0))
@@ -0,0 +1,71 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+from test_case_base import (
+    TestCaseBase,
+    test_instruction_translator_cache_context,
+)
+
+import paddle
+from paddle.jit.sot import symbolic_translate
+
+
+def add_one(x):
+    return x + 1
+
+
+class TestTensorMetaMatchGuard(unittest.TestCase):
+    def test_check(self):
+        fallback_values = []
+
+        def fallback(value):
+            fallback_values.append(value)
+            return False
+
+        x = paddle.ones([2, 3], dtype="float32")
+        guard = paddle.framework.core.TensorMetaMatchGuard(
+            [2, 3], x.dtype, True, fallback
+        )
+        self.assertTrue(guard(x))
+        self.assertFalse(guard(paddle.ones([3, 2], dtype="float32")))
+        self.assertFalse(guard(paddle.ones([2, 3], dtype="int32")))
+        y = paddle.ones([2, 3], dtype="float32")
+        y.stop_gradient = False
+        self.assertFalse(guard(y))
+        self.assertEqual(fallback_values, [])
+
+        self.assertFalse(guard(1))
+        self.assertEqual(fallback_values, [1])
+
+
+class TestTensorMetaGuardCache(TestCaseBase):
+    def test_cache(self):
+        with test_instruction_translator_cache_context() as ctx:
+            x = paddle.ones([2, 3], dtype="float32")
+            self.assert_results(add_one, x)
+            self.assertEqual(ctx.translate_count, 1)
+            self.assert_results(add_one, paddle.zeros([2, 3]))
+            self.assertEqual(ctx.translate_count, 1)
+            self.assert_results(add_one, paddle.ones([4, 3]))
+            self.assertEqual(ctx.translate_count, 2)
+            y = paddle.ones([2, 3], dtype="float32")
+            y.stop_gradient = False
+            symbolic_translate(add_one)(y)
+            self.assertEqual(ctx.translate_count, 3)
+
+
+if __name__ == "__main__":
+    unittest.main()
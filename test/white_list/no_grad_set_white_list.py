@@ -46,6 +46,7 @@ NEED_TO_FIX_OP_LIST = [
     'fused_elemwise_activation',
     'fused_emb_seq_pool',
     'fused_embedding_seq_pool',
+    'fused_multi_embedding_seq_pool',
     'gru_unit',
     'hierarchical_sigmoid',
     'hsigmoid',